@@ -17,31 +17,12 @@
 #include "eventinfo.h"
 
 
-/* Accumulator Constants */
-#define OS_ACM_EXPIRE_ELM      120
-#define OS_ACM_PURGE_INTERVAL  300
-#define OS_ACM_PURGE_COUNT     200
-
 /* Accumulator Max Values */
 #define OS_ACM_MAXKEY 256
 #define OS_ACM_MAXELM 81
 
-/**
- * @brief Struct to save data from events sharing the same ID
- */
-typedef struct _OS_ACM_Store {
-    time_t timestamp;
-    char *dstuser;
-    char *srcuser;
-    char *dstip;
-    char *srcip;
-    char *dstport;
-    char *srcport;
-    char *data;
-} OS_ACM_Store;
 
-
-OSHash *os_analysisd_acm_store;
+OS_ACM_Hash *os_analysisd_acm_store;
 
 int os_analysisd_acm_lookups;
 
@@ -66,22 +47,41 @@ static OS_ACM_Store *InitACMStore(void);
  */
 static void FreeACMStore(OS_ACM_Store *obj);
 
+/**
+ * @brief Move an object to the end of the expiration list, as the most recently updated
+ * @param acm_store accumulator storage
+ * @param obj object to move, it may be out of the list
+ */
+static void acm_list_touch(OS_ACM_Hash *acm_store, OS_ACM_Store *obj);
+
+/**
+ * @brief Take an object out of the expiration list
+ * @param acm_store accumulator storage
+ * @param obj object to remove from the list
+ */
+static void acm_list_unlink(OS_ACM_Hash *acm_store, OS_ACM_Store *obj);
+
 
 /* Start the Accumulator module */
-int Accumulate_Init(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
+int Accumulate_Init(OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
 {
     struct timeval tp;
 
     *acm_lookups = 0;
 
     /* Create store data */
-    *acm_store = OSHash_Create();
-    if (!(*acm_store)) {
+    os_calloc(1, sizeof(OS_ACM_Hash), *acm_store);
+
+    (*acm_store)->entries = OSHash_Create();
+    if (!(*acm_store)->entries) {
         merror(LIST_ERROR);
+        os_free(*acm_store);
         return (0);
     }
-    if (!OSHash_setSize(*acm_store, 2048)) {
+    if (!OSHash_setSize((*acm_store)->entries, 2048)) {
         merror(LIST_ERROR);
+        OSHash_Free((*acm_store)->entries);
+        os_free(*acm_store);
         return (0);
     }
 
@@ -94,7 +94,7 @@ int Accumulate_Init(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
 }
 
 /* Accumulate data from events sharing the same ID */
-Eventinfo *Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
+Eventinfo *Accumulate(Eventinfo *lf, OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
 {
     int result;
     int do_update = 0;
@@ -140,13 +140,14 @@ Eventinfo *Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_
     }
 
     /* Check if acm is already present */
-    if ((stored_data = (OS_ACM_Store *)OSHash_Get_ex(*acm_store, _key)) != NULL) {
+    if ((stored_data = (OS_ACM_Store *)OSHash_Get_ex((*acm_store)->entries, _key)) != NULL) {
         mdebug2("accumulator: DEBUG: Lookup for '%s' found a stored value!", _key);
 
         if ( stored_data->timestamp > 0 && stored_data->timestamp < current_ts - OS_ACM_EXPIRE_ELM ) {
-            if (OSHash_Delete_ex(*acm_store, _key) != NULL) {
+            if (OSHash_Delete_ex((*acm_store)->entries, _key) != NULL) {
                 mdebug1("accumulator: DEBUG: Deleted expired hash entry for '%s'", _key);
                 /* Clear this memory */
+                acm_list_unlink(*acm_store, stored_data);
                 FreeACMStore(stored_data);
                 /* Reallocate what we need */
                 stored_data = InitACMStore();
@@ -219,33 +220,33 @@ Eventinfo *Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_
     /* Update or Add to the hash */
     if (do_update == 1) {
         /* Update the hash entry */
-        if (result = OSHash_Update_ex(*acm_store, _key, stored_data), result != 1) {
+        if (result = OSHash_Update_ex((*acm_store)->entries, _key, stored_data), result != 1) {
             merror("accumulator: ERROR: Update of stored data for %s failed (%d).", _key, result);
         } else {
             mdebug1("accumulator: DEBUG: Updated stored data for %s", _key);
         }
+        acm_list_touch(*acm_store, stored_data);
     } else {
-        if (result = OSHash_Add_ex(*acm_store, _key, stored_data), result != 2) {
+        if (result = OSHash_Add_ex((*acm_store)->entries, _key, stored_data), result != 2) {
             FreeACMStore(stored_data);
             merror("accumulator: ERROR: Addition of stored data for %s failed (%d).", _key, result);
         } else {
             mdebug1("accumulator: DEBUG: Added stored data for %s", _key);
+            os_strdup(_key, stored_data->key);
+            acm_list_touch(*acm_store, stored_data);
         }
     }
 
     return lf;
 }
 
-void Accumulate_CleanUp(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
+void Accumulate_CleanUp(OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts)
 {
     struct timeval tp;
     time_t current_ts = 0;
     int expired = 0;
 
-    OSHashNode *curr;
     OS_ACM_Store *stored_data;
-    char *key;
-    unsigned int ti;
 
     /* Keep track of how many times we're called */
     (*acm_lookups)++;
@@ -254,7 +255,7 @@ void Accumulate_CleanUp(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_
     current_ts = tp.tv_sec;
 
     /* Do we really need to purge? */
-    if (*acm_lookups < OS_ACM_PURGE_COUNT && *acm_purge_ts < current_ts + OS_ACM_PURGE_INTERVAL) {
+    if (*acm_lookups < OS_ACM_PURGE_COUNT && current_ts < *acm_purge_ts + OS_ACM_PURGE_INTERVAL) {
         return;
     }
     mdebug1("accumulator: DEBUG: Accumulator_CleanUp() running .. ");
@@ -263,36 +264,64 @@ void Accumulate_CleanUp(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_
     *acm_lookups = 0;
     *acm_purge_ts = current_ts;
 
-    /* Loop through the hash */
-    for (ti = 0; ti < (*acm_store)->rows; ti++) {
-        curr = (*acm_store)->table[ti];
-        while ( curr != NULL ) {
-            /* Get the Key and Data */
-            key  = (char *) curr->key;
-            stored_data = (OS_ACM_Store *) curr->data;
-            /* Increment to the next element */
-            curr = curr->next;
-
-            mdebug2("accumulator: DEBUG: CleanUp() evaluating cached key: %s ", key);
-            /* Check for a valid element */
-            if ( stored_data != NULL ) {
-                /* Check for expiration */
-                mdebug2("accumulator: DEBUG: CleanUp() elm:%ld, curr:%ld", (long int)stored_data->timestamp, (long int)current_ts);
-                if ( stored_data->timestamp < current_ts - OS_ACM_EXPIRE_ELM ) {
-                    mdebug2("accumulator: DEBUG: CleanUp() Expiring '%s'", key);
-                    if (OSHash_Delete_ex(*acm_store, key) != NULL) {
-                        FreeACMStore(stored_data);
-                        expired++;
-                    } else {
-                        mdebug1("accumulator: DEBUG: CleanUp() failed to find key '%s'", key);
-                    }
-                }
-            }
+    /* The list is sorted by the last update, so only the expired entries are visited */
+    while (stored_data = (*acm_store)->oldest, stored_data != NULL) {
+        mdebug2("accumulator: DEBUG: CleanUp() elm:%ld, curr:%ld", (long int)stored_data->timestamp, (long int)current_ts);
+        if (stored_data->timestamp >= current_ts - OS_ACM_EXPIRE_ELM) {
+            break;
+        }
+
+        mdebug2("accumulator: DEBUG: CleanUp() Expiring '%s'", stored_data->key);
+        acm_list_unlink(*acm_store, stored_data);
+
+        if (OSHash_Delete_ex((*acm_store)->entries, stored_data->key) != NULL) {
+            FreeACMStore(stored_data);
+            expired++;
+        } else {
+            mdebug1("accumulator: DEBUG: CleanUp() failed to find key '%s'", stored_data->key);
         }
     }
     mdebug1("accumulator: DEBUG: Expired %d elements", expired);
 }
 
+void acm_list_touch(OS_ACM_Hash *acm_store, OS_ACM_Store *obj)
+{
+    if (acm_store->newest == obj) {
+        return;
+    }
+
+    acm_list_unlink(acm_store, obj);
+
+    obj->prev = acm_store->newest;
+    obj->next = NULL;
+
+    if (acm_store->newest) {
+        acm_store->newest->next = obj;
+    } else {
+        acm_store->oldest = obj;
+    }
+
+    acm_store->newest = obj;
+}
+
+void acm_list_unlink(OS_ACM_Hash *acm_store, OS_ACM_Store *obj)
+{
+    if (obj->prev) {
+        obj->prev->next = obj->next;
+    } else if (acm_store->oldest == obj) {
+        acm_store->oldest = obj->next;
+    }
+
+    if (obj->next) {
+        obj->next->prev = obj->prev;
+    } else if (acm_store->newest == obj) {
+        acm_store->newest = obj->prev;
+    }
+
+    obj->prev = NULL;
+    obj->next = NULL;
+}
+
 /* Initialize a storage object */
 OS_ACM_Store *InitACMStore()
 {
@@ -300,6 +329,7 @@ OS_ACM_Store *InitACMStore()
     os_calloc(1, sizeof(OS_ACM_Store), obj);
 
     obj->timestamp = 0;
+    obj->key = NULL;
     obj->srcuser = NULL;
     obj->dstuser = NULL;
     obj->srcip = NULL;
@@ -307,6 +337,8 @@ OS_ACM_Store *InitACMStore()
     obj->srcport = NULL;
     obj->dstport = NULL;
     obj->data = NULL;
+    obj->prev = NULL;
+    obj->next = NULL;
 
     return obj;
 }
@@ -316,6 +348,7 @@ void FreeACMStore(OS_ACM_Store *obj)
 {
     if ( obj != NULL ) {
         mdebug2("accumulator: DEBUG: Freeing an accumulator struct.");
+        os_free(obj->key);
         os_free(obj->dstuser);
         os_free(obj->srcuser);
         os_free(obj->dstip);
@@ -328,10 +361,10 @@ void FreeACMStore(OS_ACM_Store *obj)
 }
 
 /* Free accumulate */
-void w_analysisd_accumulate_free(OSHash **acm_store) {
-    (*acm_store)->free_data_function = (void (*)(void *)) FreeACMStore;
-    OSHash_Free(*acm_store);
-    *acm_store = NULL;
+void w_analysisd_accumulate_free(OS_ACM_Hash **acm_store) {
+    (*acm_store)->entries->free_data_function = (void (*)(void *)) FreeACMStore;
+    OSHash_Free((*acm_store)->entries);
+    os_free(*acm_store);
 }
 
 int acm_str_replace(char **dst, const char *src)
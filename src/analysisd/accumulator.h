@@ -13,6 +13,47 @@
 
 #include "eventinfo.h"
 
+/* Accumulator Constants */
+#define OS_ACM_EXPIRE_ELM      120
+#define OS_ACM_PURGE_INTERVAL  300
+#define OS_ACM_PURGE_COUNT     200
+
+/**
+ * @brief Struct to save data from events sharing the same ID
+ */
+typedef struct _OS_ACM_Store {
+    time_t timestamp;
+    char *key;
+    char *dstuser;
+    char *srcuser;
+    char *dstip;
+    char *srcip;
+    char *dstport;
+    char *srcport;
+    char *data;
+    struct _OS_ACM_Store *prev;
+    struct _OS_ACM_Store *next;
+} OS_ACM_Store;
+
+/**
+ * @brief Accumulator storage
+ *
+ * Entries are also linked from the least to the most recently updated,
+ * so the clean up only visits the expired ones
+ */
+typedef struct _OS_ACM_Hash {
+    OSHash *entries;        ///< Stored data indexed by accumulator key
+    OS_ACM_Store *oldest;   ///< Least recently updated entry, the first one to expire
+    OS_ACM_Store *newest;   ///< Most recently updated entry
+} OS_ACM_Hash;
+
+/**
+ * @brief Hash to save data which have the same id
+ *
+ * Only for Analysisd use
+ */
+extern OS_ACM_Hash *os_analysisd_acm_store;
+
 /**
  * @brief Counter of the number of times purged
  *
@@ -34,7 +75,7 @@ extern time_t os_analysisd_acm_purge_ts;
  * @param acm_purge_ts counter of interval time since the last purge
  * @return 1 on succes, otherwise 0
  */
-int Accumulate_Init(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
+int Accumulate_Init(OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
 
 /**
  * @brief Accumulate data from events sharing the same ID
@@ -44,7 +85,7 @@ int Accumulate_Init(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
  * @param acm_purge_ts counter of interval time since the last purge
  * @return EventInfo passed from input
  */
-Eventinfo *Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
+Eventinfo *Accumulate(Eventinfo *lf, OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
 
 /**
  * @brief Purge the cache as needed
@@ -52,13 +93,13 @@ Eventinfo *Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_
  * @param acm_lookups counter of the number of times purged
  * @param acm_purge_ts counter of interval time since the last purge
  */
-void Accumulate_CleanUp(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
+void Accumulate_CleanUp(OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts);
 
 /**
  * @brief Free accumulate hash table
  * 
  * @param acm_store accumulate hash table to free
  */
-void w_analysisd_accumulate_free(OSHash **acm_store);
+void w_analysisd_accumulate_free(OS_ACM_Hash **acm_store);
 
 #endif /* ACCUMULATOR_H */
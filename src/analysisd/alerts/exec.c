@@ -28,7 +28,20 @@
 #define STATIC static
 #endif
 
+/* Length of the header of the messages to remoted, without the agent IDs */
+#define AR_HEADER_LEN 32
+
+/* Message formats of the active responses, depending on the agent version */
+enum {
+    AR_FORMAT_STRING,       // Agents prior to 4.2.0
+    AR_FORMAT_JSON_ESCAPED, // Agents from 4.2.0 to 4.2.4, that need the extra arguments escaped
+    AR_FORMAT_JSON,         // Agents from 4.2.5
+    AR_FORMAT_MAX
+};
+
 STATIC const char *get_ip(const Eventinfo *lf);
+STATIC int get_agent_ar_format(int agent_id, int *sock);
+STATIC void send_exec_msg_to_agents(int *arq, const active_response *ar, const int *agent_ids, size_t count, const char *msg, char *exec_msg);
 int conn_error_sent = 0;
 
 void OS_Exec(int *execq, int *arq, int *sock, const Eventinfo *lf, const active_response *ar) {
@@ -92,6 +105,9 @@ void OS_Exec(int *execq, int *arq, int *sock, const Eventinfo *lf, const active_
         if (ar->location & ALL_AGENTS) {
 
             int *id_array = NULL;
+            int *format_ids[AR_FORMAT_MAX] = { NULL };
+            size_t format_count[AR_FORMAT_MAX] = { 0 };
+            size_t agent_count;
 
             id_array = wdb_get_agents_by_connection_status(AGENT_CS_ACTIVE, sock);
             if(!id_array) {
@@ -99,93 +115,44 @@ void OS_Exec(int *execq, int *arq, int *sock, const Eventinfo *lf, const active_
                 goto cleanup;
             }
 
-            for (size_t i = 0; id_array[i] != -1; i++) {
-                cJSON *json_agt_info = NULL;
-                cJSON *json_agt_version = NULL;
-                char c_agent_id[OS_SIZE_16];
-                wlabel_t *agt_labels = NULL;
-                char *agt_version = NULL;
-
-                memset(exec_msg, 0, OS_MAXSTR + 1);
-                memset(msg, 0, OS_MAXSTR + 1);
-
-                snprintf(c_agent_id, OS_SIZE_16, "%.3d", id_array[i]);
-
-                agt_labels = labels_find(c_agent_id, sock);
-                agt_version = labels_get(agt_labels, "_wazuh_version");
-
-                if (!agt_version) {
-                    json_agt_info = wdb_get_agent_info(id_array[i], sock);
-                    if (!json_agt_info) {
-                        merror("Failed to get agent '%d' information from Wazuh DB.", id_array[i]);
-
-                        if (agt_labels != Config.labels) {
-                            labels_free(agt_labels);
-                        }
-
-                        continue;
-                    }
-
-                    json_agt_version = cJSON_GetObjectItem(json_agt_info->child, "version");
+            for (agent_count = 0; id_array[agent_count] != -1; agent_count++);
 
-                    if(cJSON_IsString(json_agt_version) && json_agt_version->valuestring != NULL) {
-                        agt_version = json_agt_version->valuestring;
-                    } else {
-                        mdebug2("Failed to get agent '%d' version.", id_array[i]);
+            /* Group the agents by message format, so that each message is built once */
+            for (int format = 0; format < AR_FORMAT_MAX; format++) {
+                os_calloc(agent_count + 1, sizeof(int), format_ids[format]);
+            }
 
-                        if (agt_labels != Config.labels) {
-                            labels_free(agt_labels);
-                        }
+            for (size_t i = 0; id_array[i] != -1; i++) {
+                int format = get_agent_ar_format(id_array[i], sock);
 
-                        cJSON_Delete(json_agt_info);
-                        continue;
-                    }
+                if (format != OS_INVALID) {
+                    format_ids[format][format_count[format]++] = id_array[i];
                 }
+            }
 
-                // New AR mechanism is not supported in versions prior to 4.2.0
-                char *save_ptr = NULL;
-                strtok_r(agt_version, "v", &save_ptr);
-                char *major = strtok_r(NULL, ".", &save_ptr);
-                char *minor = strtok_r(NULL, ".", &save_ptr);
-                char *patch = strtok_r(NULL, ".", &save_ptr);
-                if (!major || !minor || !patch) {
-                    merror("Unable to read agent version.");
-
-                    if (agt_labels != Config.labels) {
-                        labels_free(agt_labels);
-                    }
+            for (int format = 0; format < AR_FORMAT_MAX; format++) {
+                if (format_count[format] > 0) {
+                    memset(msg, 0, OS_MAXSTR + 1);
 
-                    cJSON_Delete(json_agt_info);
-                    continue;
-                } else {
-                    if (atoi(major) < 4 || (atoi(major) == 4 && atoi(minor) < 2)) {
+                    if (format == AR_FORMAT_STRING) {
                         getActiveResponseInString(lf, ar, ip, user, filename, extra_args, msg);
                     } else {
-                        bool escape = atoi(major) == 4 && atoi(minor) == 2 && atoi(patch) < 5;
-                        getActiveResponseInJSON(lf, ar, ar->ar_cmd->extra_args, msg, escape);
+                        getActiveResponseInJSON(lf, ar, ar->ar_cmd->extra_args, msg, format == AR_FORMAT_JSON_ESCAPED);
                     }
-                }
 
-                if (agt_labels != Config.labels) {
-                    labels_free(agt_labels);
+                    send_exec_msg_to_agents(arq, ar, format_ids[format], format_count[format], msg, exec_msg);
                 }
 
-                cJSON_Delete(json_agt_info);
-
-                get_exec_msg(ar, c_agent_id, msg, exec_msg);
-                send_exec_msg(arq, ARQUEUE, exec_msg);
+                os_free(format_ids[format]);
             }
 
             os_free(id_array);
 
         } else {
 
-            cJSON *json_agt_info = NULL;
-            cJSON *json_agt_version = NULL;
             char c_agent_id[OS_SIZE_16];
-            wlabel_t *agt_labels = NULL;
-            char *agt_version = NULL;
             int agt_id = OS_INVALID;
+            int format;
 
             if (ar->location & SPECIFIC_AGENT) {
                 agt_id = atoi(ar->agent_id);
@@ -201,67 +168,16 @@ void OS_Exec(int *execq, int *arq, int *sock, const Eventinfo *lf, const active_
 
             snprintf(c_agent_id, OS_SIZE_16, "%.3d", agt_id);
 
-            agt_labels = labels_find(c_agent_id, sock);
-            agt_version = labels_get(agt_labels, "_wazuh_version");
-
-            if (!agt_version) {
-                json_agt_info = wdb_get_agent_info(agt_id, sock);
-                if (!json_agt_info) {
-                    merror("Failed to get agent '%d' information from Wazuh DB.", agt_id);
-
-                    if (agt_labels != Config.labels) {
-                        labels_free(agt_labels);
-                    }
-
-                    goto cleanup;
-                }
-
-                json_agt_version = cJSON_GetObjectItem(json_agt_info->child, "version");
-
-                if(cJSON_IsString(json_agt_version) && json_agt_version->valuestring != NULL) {
-                    agt_version = json_agt_version->valuestring;
-                } else {
-                    mdebug2("Failed to get agent '%d' version.", agt_id);
-
-                    if (agt_labels != Config.labels) {
-                        labels_free(agt_labels);
-                    }
-
-                    cJSON_Delete(json_agt_info);
-                    goto cleanup;
-                }
-            }
-
-            // New AR mechanism is not supported in versions prior to 4.2.0
-            char *save_ptr = NULL;
-            strtok_r(agt_version, "v", &save_ptr);
-            char *major = strtok_r(NULL, ".", &save_ptr);
-            char *minor = strtok_r(NULL, ".", &save_ptr);
-            char *patch = strtok_r(NULL, ".", &save_ptr);
-            if (!major || !minor || !patch) {
-                merror("Unable to read agent version.");
-
-                if (agt_labels != Config.labels) {
-                    labels_free(agt_labels);
-                }
-
-                cJSON_Delete(json_agt_info);
+            if (format = get_agent_ar_format(agt_id, sock), format == OS_INVALID) {
                 goto cleanup;
-            } else {
-                if (atoi(major) < 4 || (atoi(major) == 4 && atoi(minor) < 2)) {
-                    getActiveResponseInString(lf, ar, ip, user, filename, extra_args, msg);
-                } else {
-                    bool escape = atoi(major) == 4 && atoi(minor) == 2 && atoi(patch) < 5;
-                    getActiveResponseInJSON(lf, ar, ar->ar_cmd->extra_args, msg, escape);
-                }
             }
 
-            if (agt_labels != Config.labels) {
-                labels_free(agt_labels);
+            if (format == AR_FORMAT_STRING) {
+                getActiveResponseInString(lf, ar, ip, user, filename, extra_args, msg);
+            } else {
+                getActiveResponseInJSON(lf, ar, ar->ar_cmd->extra_args, msg, format == AR_FORMAT_JSON_ESCAPED);
             }
 
-            cJSON_Delete(json_agt_info);
-
             get_exec_msg(ar, c_agent_id, msg, exec_msg);
             send_exec_msg(arq, ARQUEUE, exec_msg);
         }
@@ -319,6 +235,119 @@ STATIC const char* get_ip(const Eventinfo *lf)
     return ip;
 }
 
+/**
+ * @brief Get the active response message format supported by an agent.
+ *
+ * @param[in] agent_id Agent ID.
+ * @param[in] sock Wazuh DB socket.
+ * @return AR_FORMAT_* value on success or OS_INVALID on failure.
+ */
+STATIC int get_agent_ar_format(int agent_id, int *sock)
+{
+    cJSON *json_agt_info = NULL;
+    cJSON *json_agt_version = NULL;
+    char c_agent_id[OS_SIZE_16];
+    wlabel_t *agt_labels = NULL;
+    char *agt_version = NULL;
+    int format = OS_INVALID;
+
+    snprintf(c_agent_id, OS_SIZE_16, "%.3d", agent_id);
+
+    agt_labels = labels_find(c_agent_id, sock);
+    agt_version = labels_get(agt_labels, "_wazuh_version");
+
+    if (!agt_version) {
+        json_agt_info = wdb_get_agent_info(agent_id, sock);
+        if (!json_agt_info) {
+            merror("Failed to get agent '%d' information from Wazuh DB.", agent_id);
+            goto end;
+        }
+
+        json_agt_version = cJSON_GetObjectItem(json_agt_info->child, "version");
+
+        if(cJSON_IsString(json_agt_version) && json_agt_version->valuestring != NULL) {
+            agt_version = json_agt_version->valuestring;
+        } else {
+            mdebug2("Failed to get agent '%d' version.", agent_id);
+            goto end;
+        }
+    }
+
+    // New AR mechanism is not supported in versions prior to 4.2.0
+    char *save_ptr = NULL;
+    strtok_r(agt_version, "v", &save_ptr);
+    char *major = strtok_r(NULL, ".", &save_ptr);
+    char *minor = strtok_r(NULL, ".", &save_ptr);
+    char *patch = strtok_r(NULL, ".", &save_ptr);
+    if (!major || !minor || !patch) {
+        merror("Unable to read agent version.");
+    } else if (atoi(major) < 4 || (atoi(major) == 4 && atoi(minor) < 2)) {
+        format = AR_FORMAT_STRING;
+    } else if (atoi(major) == 4 && atoi(minor) == 2 && atoi(patch) < 5) {
+        format = AR_FORMAT_JSON_ESCAPED;
+    } else {
+        format = AR_FORMAT_JSON;
+    }
+
+end:
+    if (agt_labels != Config.labels) {
+        labels_free(agt_labels);
+    }
+
+    cJSON_Delete(json_agt_info);
+
+    return format;
+}
+
+/**
+ * @brief Send the same message to a set of agents, as few requests as the list of IDs fits in.
+ *
+ * Remoted expands the comma-separated list of IDs and delivers the message to each agent.
+ *
+ * @param[in] arq Active Response queue.
+ * @param[in] ar Active Response information.
+ * @param[in] agent_ids Target agents.
+ * @param[in] count Number of target agents.
+ * @param[in] msg Message that can be in JSON or string format.
+ * @param[out] exec_msg Buffer for the complete message, OS_MAXSTR + 1 bytes long.
+ * @return void.
+ */
+STATIC void send_exec_msg_to_agents(int *arq, const active_response *ar, const int *agent_ids, size_t count, const char *msg, char *exec_msg)
+{
+    /* Room left for the IDs by the header and the message */
+    size_t msg_len = strlen(msg) + AR_HEADER_LEN;
+    size_t room = msg_len < OS_MAXSTR ? OS_MAXSTR - msg_len : 0;
+    char c_agent_id[OS_SIZE_16];
+    char *targets = NULL;
+    size_t len = 0;
+
+    os_calloc(OS_MAXSTR + 1, sizeof(char), targets);
+
+    for (size_t i = 0; i < count; i++) {
+        int n = snprintf(c_agent_id, OS_SIZE_16, "%s%.3d", len > 0 ? "," : "", agent_ids[i]);
+
+        if (len > 0 && len + n > room) {
+            memset(exec_msg, 0, OS_MAXSTR + 1);
+            get_exec_msg(ar, targets, msg, exec_msg);
+            send_exec_msg(arq, ARQUEUE, exec_msg);
+
+            n = snprintf(c_agent_id, OS_SIZE_16, "%.3d", agent_ids[i]);
+            len = 0;
+        }
+
+        memcpy(targets + len, c_agent_id, n + 1);
+        len += n;
+    }
+
+    if (len > 0) {
+        memset(exec_msg, 0, OS_MAXSTR + 1);
+        get_exec_msg(ar, targets, msg, exec_msg);
+        send_exec_msg(arq, ARQUEUE, exec_msg);
+    }
+
+    os_free(targets);
+}
+
 /**
  * @brief Build the string message
  *
@@ -356,26 +385,23 @@ void getActiveResponseInString( const Eventinfo *lf,
  * @brief Add the header to the message to send to remoted
  *
  * @param[in] ar Active Response information.
- * @param[in] agent_id Agent ID to identify where the AR will be executed.
+ * @param[in] agent_id Agent ID, or comma-separated agent IDs, to identify where the AR will be executed.
  * @param[in] msg Message that can be in JSON or string format
  * @param[out] exec_msg Complete massage containing the message and the header.
  * @pre exec_msg is OS_MAXSTR + 1 or more bytes long.
  * @return void.
  */
 void get_exec_msg(const active_response *ar, char *agent_id, const char *msg, char *exec_msg) {
-    char temp_msg[OS_SIZE_1024 + 1] = "\0";
-
     /* As now there are 2 different message formats (the JSON and the string)
     * ALL_AGENTS are not available, instead of that, we need to send a SPECIFIC
-    * message to each agent after checking the agent version. */
-    snprintf(temp_msg, OS_SIZE_1024,
-            "(local_source) [] %c%c%c %s",
+    * message to the agents that share the format after checking their version. */
+    os_snprintf(exec_msg, OS_MAXSTR + 1,
+            "(local_source) [] %c%c%c %s %s",
             NONE_C,
             (ar->location & REMOTE_AGENT) ? REMOTE_AGENT_C : NONE_C,
             (ar->location & SPECIFIC_AGENT || ar->location & ALL_AGENTS) ? SPECIFIC_AGENT_C : NONE_C,
-            agent_id);
-
-    os_snprintf(exec_msg, OS_MAXSTR + 1, "%s %s", temp_msg, msg);
+            agent_id,
+            msg);
 }
 
 /**
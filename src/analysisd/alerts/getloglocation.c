@@ -34,8 +34,18 @@ static char __flogfile[OS_FLSIZE + 1];
 static char __jlogfile[OS_FLSIZE + 1];
 static char __ejlogfile[OS_FLSIZE + 1];
 
+/* Output buffers of the log files, kept across rotations */
+static char * __elogbuf;
+static char * __alogbuf;
+static char * __flogbuf;
+static char * __jlogbuf;
+static char * __ejlogbuf;
+
+/* Rotated logs pending to be compressed */
+static w_queue_t * __compress_queue;
+
 // Open a valid log or die. No return on error.
-static FILE * openlog(FILE * fp, char path[OS_FLSIZE + 1], const char * logdir, int year, const char * month, const char * tag, int day, const char * ext, const char * lname, int * counter, int rotate);
+static FILE * openlog(FILE * fp, char path[OS_FLSIZE + 1], const char * logdir, int year, const char * month, const char * tag, int day, const char * ext, const char * lname, int * counter, int rotate, char ** buffer);
 
 void OS_InitLog()
 {
@@ -73,22 +83,24 @@ int OS_GetLogLocation(int day,int year,char *mon)
      */
 
     /* For the events */
-    _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, FALSE);
+    _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, FALSE, &__elogbuf);
 
     /* For the events in JSON */
     if (Config.logall_json) {
-        _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, FALSE);
+        _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, FALSE, &__ejlogbuf);
     }
 
-    /* For the alerts logs */
-    _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, FALSE);
+    /* For the alerts logs. The additional instances forward their alerts to the main one */
+    if (!Config.instance) {
+        _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, FALSE, &__alogbuf);
 
-    if (Config.jsonout_output) {
-        _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, FALSE);
+        if (Config.jsonout_output) {
+            _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, FALSE, &__jlogbuf);
+        }
     }
 
     /* For the firewall events */
-    _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, FALSE);
+    _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, FALSE, &__flogbuf);
 
     /* Setting the new day */
     __crt_day = day;
@@ -97,14 +109,45 @@ int OS_GetLogLocation(int day,int year,char *mon)
     return (0);
 }
 
+// Check whether a log file was already compressed after a rotation
+
+static int log_compressed(const char * path) {
+    char path_gz[OS_FLSIZE + 1];
+
+    snprintf(path_gz, OS_FLSIZE + 1, "%s.gz", path);
+    return !IsFile(path_gz);
+}
+
 // Open a valid log or die. No return on error.
 
-FILE * openlog(FILE * fp, char * path, const char * logdir, int year, const char * month, const char * tag, int day, const char * ext, const char * lname, int * counter, int rotate) {
+FILE * openlog(FILE * fp, char * path, const char * logdir, int year, const char * month, const char * tag, int day, const char * ext, const char * lname, int * counter, int rotate, char ** buffer) {
     char next[OS_FLSIZE + 1];
+    char instance_tag[OS_FLSIZE + 1];
+    char instance_lname[OS_FLSIZE + 1];
+    const char * lname_ext;
+
+    // The additional analysisd instances write their own files and links
+    if (Config.instance) {
+        snprintf(instance_tag, OS_FLSIZE + 1, "%s-%d", tag, Config.instance);
+        tag = instance_tag;
+
+        lname_ext = strrchr(lname, '.');
+        snprintf(instance_lname, OS_FLSIZE + 1, "%.*s-%d%s", lname_ext ? (int)(lname_ext - lname) : (int)strlen(lname), lname, Config.instance, lname_ext ? lname_ext : "");
+        lname = instance_lname;
+    }
 
     if (fp) {
         if (ftell(fp) == 0) {
             unlink(path);
+        } else if (rotate && __compress_queue) {
+            // The rotated file won't be written again: compress it now instead of at the end of the day
+            char * rotated;
+            os_strdup(path, rotated);
+
+            if (queue_push_ex(__compress_queue, rotated) < 0) {
+                mdebug1("Compression queue is full. Log '%s' will be compressed by monitord.", rotated);
+                os_free(rotated);
+            }
         }
 
         fclose(fp);
@@ -129,8 +172,8 @@ FILE * openlog(FILE * fp, char * path, const char * logdir, int year, const char
     } else {
         snprintf(path, OS_FLSIZE + 1, "%s/%d/%s/ossec-%s-%02d.%s", logdir, year, month, tag, day, ext);
 
-        // While this file is bigger than maximum or there is a next file
-        for (*counter = 0; snprintf(next, OS_FLSIZE + 1, "%s/%d/%s/ossec-%s-%02d-%.3d.%s", logdir, year, month, tag, day, *counter + 1, ext), !IsFile(next) || (Config.max_output_size && FileSize(path) > Config.max_output_size); (*counter)++) {
+        // While this file is bigger than maximum, it was already compressed or there is a next file
+        for (*counter = 0; snprintf(next, OS_FLSIZE + 1, "%s/%d/%s/ossec-%s-%02d-%.3d.%s", logdir, year, month, tag, day, *counter + 1, ext), !IsFile(next) || log_compressed(next) || log_compressed(path) || (Config.max_output_size && FileSize(path) > Config.max_output_size); (*counter)++) {
             strncpy(path, next, OS_FLSIZE);
             path[OS_FLSIZE] = '\0';
         }
@@ -140,6 +183,17 @@ FILE * openlog(FILE * fp, char * path, const char * logdir, int year, const char
         merror_exit("Error opening logfile: '%s': (%d) %s", path, errno, strerror(errno));
     }
 
+    // Let the writers batch many records into a single write
+    if (Config.log_buffer_size > 0) {
+        if (*buffer == NULL) {
+            os_malloc(Config.log_buffer_size, *buffer);
+        }
+
+        if (setvbuf(fp, *buffer, _IOFBF, Config.log_buffer_size) != 0) {
+            mwarn("Unable to set the output buffer of '%s'.", path);
+        }
+    }
+
     // Create a symlink
     unlink(lname);
 
@@ -155,23 +209,23 @@ void OS_RotateLogs(int day,int year,char *mon) {
     if (Config.rotate_interval && c_time - __crt_rsec > Config.rotate_interval) {
         // If timespan exceeded the rotation time and the file isn't empty
         if (_eflog && ftell(_eflog) > 0) {
-            _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, TRUE);
+            _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, TRUE, &__elogbuf);
         }
 
         if (_ejflog && ftell(_ejflog) > 0) {
-            _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, TRUE);
+            _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, TRUE, &__ejlogbuf);
         }
 
         if (_aflog && ftell(_aflog) > 0) {
-            _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, TRUE);
+            _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, TRUE, &__alogbuf);
         }
 
         if (_jflog && ftell(_jflog) > 0) {
-            _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, TRUE);
+            _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, TRUE, &__jlogbuf);
         }
 
         if (_fflog && ftell(_fflog) > 0) {
-            _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, TRUE);
+            _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, TRUE, &__flogbuf);
         }
 
         __crt_rsec = c_time;
@@ -179,28 +233,84 @@ void OS_RotateLogs(int day,int year,char *mon) {
         // Or if timespan from last rotation is enough and the file is too big
 
         if (_eflog && ftell(_eflog) > Config.max_output_size) {
-            _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, TRUE);
+            _eflog = openlog(_eflog, __elogfile, EVENTS, year, mon, "archive", day, "log", EVENTS_DAILY, &__ecounter, TRUE, &__elogbuf);
             __crt_rsec = c_time;
         }
 
         if (_ejflog && ftell(_ejflog) > Config.max_output_size) {
-            _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, TRUE);
+            _ejflog = openlog(_ejflog, __ejlogfile, EVENTS, year, mon, "archive", day, "json", EVENTSJSON_DAILY, &__ejcounter, TRUE, &__ejlogbuf);
             __crt_rsec = c_time;
         }
 
         if (_aflog && ftell(_aflog) > Config.max_output_size) {
-            _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, TRUE);
+            _aflog = openlog(_aflog, __alogfile, ALERTS, year, mon, "alerts", day, "log", ALERTS_DAILY, &__acounter, TRUE, &__alogbuf);
             __crt_rsec = c_time;
         }
 
         if (_jflog && ftell(_jflog) > Config.max_output_size) {
-            _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, TRUE);
+            _jflog = openlog(_jflog, __jlogfile, ALERTS, year, mon, "alerts", day, "json", ALERTSJSON_DAILY, &__jcounter, TRUE, &__jlogbuf);
             __crt_rsec = c_time;
         }
 
         if (_fflog && ftell(_fflog) > Config.max_output_size) {
-            _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, TRUE);
+            _fflog = openlog(_fflog, __flogfile, FWLOGS, year, mon, "firewall", day, "log", FWLOGS_DAILY, &__fcounter, TRUE, &__flogbuf);
             __crt_rsec = c_time;
         }
     }
 }
+
+void OS_StartLogCompression() {
+    __compress_queue = queue_init(OS_SIZE_128);
+    w_create_thread(w_log_compress_thread, NULL);
+}
+
+void * w_log_compress_thread(__attribute__((unused)) void * args) {
+    char path_gz[OS_FLSIZE + 1];
+    char path_tmp[OS_FLSIZE + 1];
+    char * path;
+
+    while (1) {
+        if (path = queue_pop_ex(__compress_queue), path) {
+            // monitord may compress the same log at once: each process writes its own
+            // temporary file, and the complete one replaces the .gz atomically
+            snprintf(path_gz, OS_FLSIZE + 1, "%s.gz", path);
+            snprintf(path_tmp, OS_FLSIZE + 1, "%s.gz.%d", path, (int)getpid());
+
+            if (w_compress_gzfile(path, path_tmp) == 0) {
+                if (rename(path_tmp, path_gz) == -1) {
+                    merror(RENAME_ERROR, path_tmp, path_gz, errno, strerror(errno));
+                    unlink(path_tmp);
+                } else {
+                    mdebug2("Rotated log '%s' compressed.", path);
+
+                    if (unlink(path) == -1 && errno != ENOENT) {
+                        merror(DELETE_ERROR, path, errno, strerror(errno));
+                    }
+                }
+            } else {
+                // Don't leave a partial file, monitord compresses the log later
+                unlink(path_tmp);
+            }
+
+            os_free(path);
+        }
+    }
+
+    return NULL;
+}
+
+void OS_SyncLogs() {
+    /* The alerts streams of an additional instance are memory buffers, only open while the writers hold their lock */
+    FILE * logs[] = { _eflog, _ejflog, Config.instance ? NULL : _aflog, Config.instance ? NULL : _jflog, _fflog };
+
+    for (unsigned int i = 0; i < sizeof(logs) / sizeof(FILE *); i++) {
+        if (!logs[i]) {
+            continue;
+        }
+
+        /* Data still in the stream buffer is not seen by fsync() */
+        if (fflush(logs[i]) != 0 || fsync(fileno(logs[i])) < 0) {
+            mdebug1("Unable to sync log file: %s (%d)", strerror(errno), errno);
+        }
+    }
+}
@@ -33,4 +33,13 @@ extern FILE *_ejflog;
 
 void OS_RotateLogs(int day,int year,char *mon);
 
+/* Flush the open log files and write their data to disk */
+void OS_SyncLogs(void);
+
+/* Start compressing the logs right after they are rotated */
+void OS_StartLogCompression(void);
+
+/* Compress the rotated logs queued by OS_RotateLogs */
+void * w_log_compress_thread(void * args);
+
 #endif /* GETLL_H */
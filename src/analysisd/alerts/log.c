@@ -378,6 +378,10 @@ void OS_CustomLog_Flush(){
     fflush(_aflog);
 }
 
+void FW_Log_Flush(){
+    fflush(_fflog);
+}
+
 void OS_InitFwLog()
 {
     /* Initialize fw log regexes */
@@ -461,7 +465,5 @@ int FW_Log(Eventinfo *lf)
             lf->dstip,
             lf->dstport);
 
-    fflush(_fflog);
-
     return (1);
 }
@@ -23,6 +23,7 @@ void OS_CustomLog(const Eventinfo *lf, const char *format);
 void OS_Store(const Eventinfo *lf);
 void OS_Log_Flush();
 void OS_CustomLog_Flush();
+void FW_Log_Flush();
 void OS_Store_Flush();
 int FW_Log(Eventinfo *lf);
 
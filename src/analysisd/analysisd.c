@@ -42,6 +42,7 @@
 #include "state.h"
 #include "syscheck_op.h"
 #include "lists_make.h"
+#include "ruleset.h"
 
 #ifdef PRELUDE_OUTPUT_ENABLED
 #include "output/prelude.h"
@@ -65,9 +66,11 @@ int DecodeCiscat(Eventinfo *lf, int *socket);
 int DecodeWinevt(Eventinfo *lf);
 int DecodeSCA(Eventinfo *lf, int *socket);
 void DispatchDBSync(dbsync_context_t * ctx, Eventinfo * lf);
+void DispatchDBSyncFlush(dbsync_context_t * ctx);
 
 // Init sdb and decoder struct
 void sdb_init(_sdb *localsdb, OSDecoderInfo *fim_decoder);
+void fim_db_flush(_sdb *sdb); // Read the pending responses from wazuh-db
 
 /* For stats */
 static void DumpLogstats(void);
@@ -75,6 +78,15 @@ static void DumpLogstats(void);
 // Message handler thread
 void * ad_input_main(void * args);
 
+/* Queue a message received from the input socket into its decoder queue */
+static void ad_input_dispatch(char * buffer, int recv);
+
+/* Benchmark thread: replay a recorded event file and report the throughput */
+static void * ad_replay_main(void * args);
+
+/* Recorded events to replay (-B), instead of reading the input socket */
+static FILE * benchmark_fp;
+
 /** Global definitions **/
 int today;
 int thishour;
@@ -86,6 +98,8 @@ struct timespec c_timespec;
 char __shost[512];
 OSDecoderInfo *NULL_Decoder;
 int num_rule_matching_threads;
+int num_rule_matching_shards;
+int num_dispatch_dbsync_shards;
 OSHash *analysisd_agents_state;
 
 extern analysisd_state_t analysisd_state;
@@ -106,6 +120,9 @@ void * w_writer_thread(__attribute__((unused)) void * args );
 /* Alerts log writer thread */
 void * w_writer_log_thread(__attribute__((unused)) void * args );
 
+/* Receiver of the alerts of the additional instances */
+static void * w_alerts_receiver_thread(void * args);
+
 /* Statistical writer thread */
 void * w_writer_log_statistical_thread(__attribute__((unused)) void * args );
 
@@ -139,12 +156,27 @@ void * w_decode_event_thread(__attribute__((unused)) void * args);
 /* Process decoded event - rule matching threads */
 void * w_process_event_thread(__attribute__((unused)) void * id);
 
+/* Shard of an agent ID of 'length' bytes: the same agent always gets the same one */
+static int w_get_agent_shard(const char * agent_id, size_t length, int shards);
+
+/* Shard of a decoded event: events from the same agent always get the same one */
+static int w_get_event_shard(const Eventinfo * lf);
+
+/* Shard of a raw database synchronization message, by the agent ID of its header */
+static int w_get_dbsync_shard(const char * msg);
+
+/* Queue a decoded event for rule matching */
+static int w_push_decoded_event(Eventinfo * lf);
+
 /* Do log rotation thread */
 void * w_log_rotate_thread(__attribute__((unused)) void * args);
 
 /* Decode winevt threads */
 void * w_decode_winevt_thread(__attribute__((unused)) void * args);
 
+/* Shared decoding threads, they help the most backlogged decode queues */
+void * w_decode_shared_thread(__attribute__((unused)) void * args);
+
 /* Database synchronization thread */
 static void * w_dispatch_dbsync_thread(void * args);
 
@@ -165,6 +197,37 @@ typedef struct _osmatch_exec {
     RuleInfo *rule;
 } _osmatch_execute;
 
+/* State kept by a decoding thread between batches. The shared decoding
+ * threads set up each part the first time they decode its kind of event.
+ */
+typedef struct _decode_state {
+    _sdb *sdb;                      ///< Integrity database of the syscheck decoder
+    OSDecoderInfo *fim_decoder;     ///< Decoder assigned to the FIM events
+    int syscollector_sock;          ///< wazuh-db socket of the syscollector decoder
+    int sca_sock;                   ///< wazuh-db socket of the SCA decoder
+} decode_state;
+
+#define DECODE_STATE_INIT { NULL, NULL, -1, -1 }
+
+/* Decode queue that the shared decoding threads can serve */
+typedef struct _decode_class {
+    const char *name;
+    w_queue_t **queue;
+    void (*decode)(decode_state *state, void **batch, size_t batch_len);
+    int helpers;                    ///< Shared threads decoding it now
+} decode_class;
+
+/* Decode a batch of messages of each decode queue */
+static void w_decode_syscheck_batch(decode_state * state, void ** batch, size_t batch_len);
+static void w_decode_syscollector_batch(decode_state * state, void ** batch, size_t batch_len);
+static void w_decode_rootcheck_batch(decode_state * state, void ** batch, size_t batch_len);
+static void w_decode_sca_batch(decode_state * state, void ** batch, size_t batch_len);
+static void w_decode_hostinfo_batch(decode_state * state, void ** batch, size_t batch_len);
+static void w_decode_winevt_batch(decode_state * state, void ** batch, size_t batch_len);
+
+/* Pick the decode queue a shared decoding thread should help, NULL if none is backlogged */
+static decode_class * w_decode_shared_pick();
+
 /* Archives writer queue */
 w_queue_t * writer_queue;
 
@@ -192,21 +255,41 @@ w_queue_t * decode_queue_sca_input;
 /* Decode hostinfo input queue */
 w_queue_t * decode_queue_hostinfo_input;
 
-/* Decode event input queue */
-w_queue_t * decode_queue_event_input;
+/* Decode event input queue, a class per priority */
+w_prio_queue_t * decode_queue_event_input;
 
 /* Decode pending event output */
 w_queue_t * decode_queue_event_output;
 
+/* Decode pending event output, one queue per rule matching thread */
+w_queue_t ** decode_queue_event_shards;
+
 /* Decode windows event input queue */
 w_queue_t * decode_queue_winevt_input;
 
 /* Database synchronization input queue */
 w_queue_t * dispatch_dbsync_input;
 
+/* Database synchronization input, one queue per dispatcher thread */
+w_queue_t ** dispatch_dbsync_shards;
+
 /* Upgrade module decoder  */
 w_queue_t * upgrade_module_input;
 
+/* Decode queues served by the shared decoding threads */
+static decode_class decode_classes[] = {
+    { "syscheck", &decode_queue_syscheck_input, w_decode_syscheck_batch, 0 },
+    { "syscollector", &decode_queue_syscollector_input, w_decode_syscollector_batch, 0 },
+    { "rootcheck", &decode_queue_rootcheck_input, w_decode_rootcheck_batch, 0 },
+    { "sca", &decode_queue_sca_input, w_decode_sca_batch, 0 },
+    { "hostinfo", &decode_queue_hostinfo_input, w_decode_hostinfo_batch, 0 },
+    { "winevt", &decode_queue_winevt_input, w_decode_winevt_batch, 0 },
+};
+
+/* Shared decoding threads that may help the same decode queue at once */
+static int decode_shared_limit;
+static pthread_mutex_t decode_shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* Hourly firewall mutex */
 static pthread_mutex_t hourly_firewall_mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -248,7 +331,7 @@ __attribute__((noreturn))
 static void help_analysisd(char * home_path)
 {
     print_header();
-    print_out("  %s: -[Vhdtf] [-u user] [-g group] [-c config] [-D dir]", ARGV0);
+    print_out("  %s: -[Vhdtf] [-u user] [-g group] [-c config] [-D dir] [-B file] [-n instance]", ARGV0);
     print_out("    -V          Version and license message");
     print_out("    -h          This help message");
     print_out("    -d          Execute in debug mode. This parameter");
@@ -260,6 +343,10 @@ static void help_analysisd(char * home_path)
     print_out("    -g <group>  Group to run as (default: %s)", GROUPGLOBAL);
     print_out("    -c <config> Configuration file to use (default: %s)", OSSECCONF);
     print_out("    -D <dir>    Directory to chroot and chdir into (default: %s)", home_path);
+    print_out("    -B <file>   Replay the queue messages of a file at full speed and print the");
+    print_out("                throughput. The daemon must be stopped. Runs in foreground.");
+    print_out("    -n <number> Run as an additional instance, decoding the agents that remoted");
+    print_out("                forwards to it (1 to %d, see remoted.analysisd_instances).", ANALYSISD_INSTANCES_MAX - 1);
     print_out(" ");
     os_free(home_path);
     exit(1);
@@ -283,6 +370,8 @@ int main_analysisd(int argc, char **argv)
     gid_t gid;
 
     const char *cfg = OSSECCONF;
+    static char instance_name[OS_FLSIZE];
+    char queue_path[PATH_MAX];
 
     /* Set the name */
     OS_SetName(ARGV0);
@@ -303,7 +392,7 @@ int main_analysisd(int argc, char **argv)
     geoipdb = NULL;
 #endif
 
-    while ((c = getopt(argc, argv, "Vtdhfu:g:D:c:")) != -1) {
+    while ((c = getopt(argc, argv, "Vtdhfu:g:D:c:B:n:")) != -1) {
         switch (c) {
             case 'V':
                 print_version();
@@ -345,6 +434,27 @@ int main_analysisd(int argc, char **argv)
             case 't':
                 test_config = 1;
                 break;
+            case 'B':
+                if (!optarg) {
+                    merror_exit("-B needs an argument");
+                }
+                /* Opened before the chroot */
+                if (benchmark_fp = wfopen(optarg, "r"), !benchmark_fp) {
+                    merror_exit(FOPEN_ERROR, optarg, errno, strerror(errno));
+                }
+                run_foreground = 1;
+                break;
+            case 'n':
+                if (!optarg) {
+                    merror_exit("-n needs an argument");
+                }
+                if (Config.instance = atoi(optarg), Config.instance < 1 || Config.instance >= ANALYSISD_INSTANCES_MAX) {
+                    merror_exit("Invalid instance number '%s'. It must be between 1 and %d.", optarg, ANALYSISD_INSTANCES_MAX - 1);
+                }
+                /* The instance keeps its own name, PID and state files */
+                snprintf(instance_name, sizeof(instance_name), "%s_%d", ARGV0, Config.instance);
+                OS_SetName(instance_name);
+                break;
             default:
                 help_analysisd(home_path);
                 break;
@@ -402,6 +512,12 @@ int main_analysisd(int argc, char **argv)
 
     mdebug1(READ_CONFIG);
 
+    /* The hourly stats are stored for the whole node, only the main instance keeps them */
+    if (Config.instance && Config.stats) {
+        minfo("Hourly stats disabled in the additional instance %d.", Config.instance);
+        Config.stats = 0;
+    }
+
     if (!(Config.alerts_log || Config.jsonout_output)) {
         mwarn("All alert formats are disabled. Mail reporting, Syslog client and Integrator won't work properly.");
     }
@@ -411,7 +527,7 @@ int main_analysisd(int argc, char **argv)
 
     /* Opening GeoIP DB */
     if(Config.geoipdb_file) {
-        geoipdb = GeoIP_open(Config.geoipdb_file, GEOIP_INDEX_CACHE);
+        geoipdb = GeoIP_open(Config.geoipdb_file, GEOIP_MMAP_CACHE);
         if (geoipdb == NULL)
         {
             merror("Unable to open GeoIP database from: %s (disabling GeoIP).", Config.geoipdb_file);
@@ -461,6 +577,17 @@ int main_analysisd(int argc, char **argv)
         num_rule_matching_threads = cpu_cores;
     }
 
+    /* Every shard is served by its own rule matching thread */
+    num_rule_matching_shards = getDefine_Int("analysisd", "rule_matching_shards", 0, 32);
+
+    if (num_rule_matching_shards > 0 && num_rule_matching_shards != num_rule_matching_threads) {
+        minfo("Using %d rule matching threads, one per shard.", num_rule_matching_shards);
+        num_rule_matching_threads = num_rule_matching_shards;
+    }
+
+    /* Every shard is served by its own database synchronization dispatcher */
+    num_dispatch_dbsync_shards = getDefine_Int("analysisd", "dbsync_shards", 0, 32);
+
     /* Continuing in Daemon mode */
     if (!test_config && !run_foreground) {
         nowDaemon();
@@ -507,16 +634,25 @@ int main_analysisd(int argc, char **argv)
 
     if (!test_config) {
         /* Signal manipulation */
-        StartSIG(ARGV0);
+        StartSIG(__local_name);
 
-        /* Create the PID file */
-        if (CreatePID(ARGV0, getpid()) < 0) {
-            merror_exit(PID_ERROR);
-        }
+        /* A benchmark reads its own file, the input socket is left alone */
+        if (!benchmark_fp) {
+            /* Create the PID file */
+            if (CreatePID(__local_name, getpid()) < 0) {
+                merror_exit(PID_ERROR);
+            }
+
+            /* Set the queue */
+            if (Config.instance) {
+                snprintf(queue_path, sizeof(queue_path), ANALYSISD_INSTANCE_QUEUE, Config.instance);
+            } else {
+                strcpy(queue_path, DEFAULTQUEUE);
+            }
 
-        /* Set the queue */
-        if ((m_queue = StartMQ(DEFAULTQUEUE, READ, 0)) < 0) {
-            merror_exit(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
+            if ((m_queue = StartMQ(queue_path, READ, 0)) < 0) {
+                merror_exit(QUEUE_ERROR, queue_path, strerror(errno));
+            }
         }
     }
 
@@ -591,6 +727,11 @@ int main_analysisd(int argc, char **argv)
 
             /* Load decoders */
             SetDecodeXML(list_msg, &os_analysisd_decoder_store, &os_analysisd_decoderlist_nopn, &os_analysisd_decoderlist_pn);
+
+            /* Index the parent decoders to skip impossible candidates */
+            OS_BuildDecoderIndex(os_analysisd_decoderlist_pn);
+            OS_BuildDecoderIndex(os_analysisd_decoderlist_nopn);
+
             node_log_msg = OSList_GetFirstNode(list_msg);
             while (node_log_msg) {
                 os_analysisd_log_msg_t * data_msg = node_log_msg->data;
@@ -748,8 +889,14 @@ int main_analysisd(int argc, char **argv)
             merror_exit(MEM_ERROR, errno, strerror(errno));
         }
         AddHash_Rule(tmp_node);
+
+        /* Index the children of each rule to skip impossible candidates */
+        OS_BuildRuleIndex(tmp_node);
     }
 
+    /* Publish the loaded ruleset as the first generation */
+    w_ruleset_init();
+
     /* Check if log_fw is enabled */
     Config.logfw = (u_int8_t) getDefine_Int("analysisd",
                                  "log_fw",
@@ -815,8 +962,10 @@ int main_analysisd(int argc, char **argv)
     /* Load Mitre JSON File and Mitre hash table */
     mitre_load();
 
-    /* Initialize Logtest */
-    w_create_thread(w_logtest_init, NULL);
+    /* Initialize Logtest, served by the main instance */
+    if (!Config.instance) {
+        w_create_thread(w_logtest_init, NULL);
+    }
 
     /* Going to main loop */
     OS_ReadMSG(m_queue);
@@ -920,6 +1069,7 @@ void OS_ReadMSG_analysisd(int m_queue)
 
     Config.label_cache_maxage = getDefine_Int("analysisd", "label_cache_maxage", 0, 60);
     Config.show_hidden_labels = getDefine_Int("analysisd", "show_hidden_labels", 0, 1);
+    Config.wdb_binary_protocol = getDefine_Int("analysisd", "wdb_binary_protocol", 0, 1);
 
     if (Config.custom_alert_output) {
         mdebug1("Custom output found.!");
@@ -927,6 +1077,9 @@ void OS_ReadMSG_analysisd(int m_queue)
 
     w_init_queues();
 
+    /* Keep released events to reuse them */
+    w_event_pool_init((size_t)getDefine_Int("analysisd", "event_pool_size", 0, 2000000));
+
     int num_decode_event_threads = getDefine_Int("analysisd", "event_threads", 0, 32);
     int num_decode_syscheck_threads = getDefine_Int("analysisd", "syscheck_threads", 0, 32);
     int num_decode_syscollector_threads = getDefine_Int("analysisd", "syscollector_threads", 0, 32);
@@ -935,6 +1088,8 @@ void OS_ReadMSG_analysisd(int m_queue)
     int num_decode_hostinfo_threads = getDefine_Int("analysisd", "hostinfo_threads", 0, 32);
     int num_decode_winevt_threads = getDefine_Int("analysisd", "winevt_threads", 0, 32);
     int num_dispatch_dbsync_threads = getDefine_Int("analysisd", "dbsync_threads", 0, 32);
+    int num_decode_shared_threads = getDefine_Int("analysisd", "decode_shared_threads", 0, 32);
+    decode_shared_limit = getDefine_Int("analysisd", "decode_shared_limit", 1, 32);
 
     if(num_decode_event_threads == 0){
         num_decode_event_threads = cpu_cores;
@@ -966,6 +1121,11 @@ void OS_ReadMSG_analysisd(int m_queue)
 
     num_dispatch_dbsync_threads = (num_dispatch_dbsync_threads > 0) ? num_dispatch_dbsync_threads : cpu_cores;
 
+    if (num_dispatch_dbsync_shards > 0 && num_dispatch_dbsync_shards != num_dispatch_dbsync_threads) {
+        minfo("Using %d database synchronization threads, one per shard.", num_dispatch_dbsync_shards);
+        num_dispatch_dbsync_threads = num_dispatch_dbsync_shards;
+    }
+
     /* Initiate the FTS list */
     if (!FTS_Init(num_rule_matching_threads, &os_analysisd_fts_list, &os_analysisd_fts_store)) {
         merror_exit(FTS_LIST_ERROR);
@@ -988,8 +1148,20 @@ void OS_ReadMSG_analysisd(int m_queue)
     /* Initialize EPS limits */
     load_limits(Config.eps.maximum, Config.eps.timeframe, Config.eps.maximum_found);
 
+    /* Create the agent labels refresher thread */
+    w_create_thread(labels_refresh_thread, NULL);
+
     /* Create message handler thread */
-    w_create_thread(ad_input_main, &m_queue);
+    if (benchmark_fp) {
+        /* Report the stage latencies even if tracing is disabled */
+        if (!Config.latency_sample) {
+            Config.latency_sample = 100;
+        }
+
+        w_create_thread(ad_replay_main, benchmark_fp);
+    } else {
+        w_create_thread(ad_input_main, &m_queue);
+    }
 
     /* Create archives writer thread */
     w_create_thread(w_writer_thread, NULL);
@@ -997,6 +1169,11 @@ void OS_ReadMSG_analysisd(int m_queue)
     /* Create alerts log writer thread */
     w_create_thread(w_writer_log_thread, NULL);
 
+    /* The main instance writes the alerts of the additional ones */
+    if (!Config.instance && getDefine_Int("remoted", "analysisd_instances", 1, ANALYSISD_INSTANCES_MAX) > 1) {
+        w_create_thread(w_alerts_receiver_thread, NULL);
+    }
+
     /* Create statistical log writer thread */
     w_create_thread(w_writer_log_statistical_thread, NULL);
 
@@ -1009,6 +1186,11 @@ void OS_ReadMSG_analysisd(int m_queue)
     /* Create log rotation thread */
     w_create_thread(w_log_rotate_thread, NULL);
 
+    /* Create rotated logs compression thread */
+    if (Config.compress_rotated) {
+        OS_StartLogCompression();
+    }
+
     /* Create decode syscheck threads */
     for(i = 0; i < num_decode_syscheck_threads;i++){
         w_create_thread(w_decode_syscheck_thread, NULL);
@@ -1049,9 +1231,14 @@ void OS_ReadMSG_analysisd(int m_queue)
         w_create_thread(w_decode_winevt_thread, NULL);
     }
 
+    /* Create the shared decoding threads */
+    for (i = 0; i < num_decode_shared_threads; i++){
+        w_create_thread(w_decode_shared_thread, NULL);
+    }
+
     /* Create database synchronization dispatcher threads */
     for (i = 0; i < num_dispatch_dbsync_threads; i++){
-        w_create_thread(w_dispatch_dbsync_thread, NULL);
+        w_create_thread(w_dispatch_dbsync_thread, (void *) (intptr_t)i);
     }
 
     /* Create upgrade module dispatcher thread */
@@ -1100,6 +1287,7 @@ static void LoopRule(RuleNode *curr_node, FILE *flog)
 static void DumpLogstats()
 {
     RuleNode *rulenode_pt;
+    w_ruleset_t *ruleset;
     char logfile[OS_FLSIZE + 1];
     FILE *flog;
 
@@ -1133,7 +1321,9 @@ static void DumpLogstats()
         return;
     }
 
-    rulenode_pt = OS_GetFirstRule();
+    /* Hold the ruleset so a reload does not free it while it is walked */
+    ruleset = w_ruleset_acquire();
+    rulenode_pt = ruleset ? ruleset->rule_list : NULL;
 
     if (!rulenode_pt) {
         merror_exit("Rules in an inconsistent state. Exiting.");
@@ -1144,6 +1334,8 @@ static void DumpLogstats()
         LoopRule(rulenode_pt, flog);
     } while ((rulenode_pt = rulenode_pt->next) != NULL);
 
+    w_ruleset_release(ruleset);
+
     /* Print total for the hour */
     fprintf(flog, "%d--%d--%d--%d--%d\n\n",
             thishour,
@@ -1160,9 +1352,6 @@ static void DumpLogstats()
 void * ad_input_main(void * args) {
     int m_queue = *(int *)args;
     char buffer[OS_MAXSTR + 1] = "";
-    char *copy;
-    char *msg;
-    int result;
     int recv = 0;
 
     mdebug1("Input message handler thread started.");
@@ -1170,549 +1359,1068 @@ void * ad_input_main(void * args) {
     while (1) {
         if (recv = OS_RecvUnix(m_queue, OS_MAXSTR, buffer), recv) {
             buffer[recv] = '\0';
-            msg = buffer;
-
-            /* Get the time we received the event */
-            gettime(&c_timespec);
-
-            /* Check for a valid message */
-            if (strlen(msg) < 4) {
-                merror(IMSG_ERROR, msg);
-                continue;
-            }
+            ad_input_dispatch(buffer, recv);
+        }
+    }
 
-            w_add_recv((unsigned long) recv);
-            w_inc_received_events();
+    return NULL;
+}
 
-            result = -1;
+/* Priority class of an event for the events input queue, by the location it was read from */
+static unsigned int ad_event_priority(const char * msg) {
+    char location[OS_SIZE_8192 + OS_SIZE_256 + 3];
+    const char * module;
+    const char * end;
+    size_t length;
 
-            if (msg[0] == SYSCHECK_MQ) {
-                if (!queue_full(decode_queue_syscheck_input)) {
-                    os_strdup(buffer, copy);
+    if (!Config.priority[EVENT_PRIORITY_HIGH].location && !Config.priority[EVENT_PRIORITY_LOW].location) {
+        return EVENT_PRIORITY_NORMAL;
+    }
 
-                    result = queue_push_ex(decode_queue_syscheck_input, copy);
+    if (end = wstr_chr_escape(msg + 2, ':', '|'), end == NULL || (length = end - msg - 2) >= sizeof(location)) {
+        return EVENT_PRIORITY_NORMAL;
+    }
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                        hourly_syscheck++;
-                    }
-                }
+    memcpy(location, msg + 2, length);
+    location[length] = '\0';
 
-                if (result == -1) {
-                    w_inc_modules_syscheck_dropped_events();
+    if (memchr(location, '|', length) != NULL) {
+        char escaped[sizeof(location)];
+        memcpy(escaped, location, length + 1);
 
-                    if (!reported_syscheck) {
-                        mwarn("Syscheck decoder queue is full.");
-                        reported_syscheck = 1;
-                    }
-                }
-            } else if (msg[0] == ROOTCHECK_MQ) {
-                if (!queue_full(decode_queue_rootcheck_input)) {
-                    os_strdup(buffer, copy);
+        if (wstr_unescape(location, sizeof(location), escaped, '|') == OS_INVALID) {
+            return EVENT_PRIORITY_NORMAL;
+        }
+    }
 
-                    result = queue_push_ex(decode_queue_rootcheck_input, copy);
+    module = extract_module_from_location(location);
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+    if (Config.priority[EVENT_PRIORITY_HIGH].location && OSMatch_Execute(module, strlen(module), Config.priority[EVENT_PRIORITY_HIGH].location)) {
+        return EVENT_PRIORITY_HIGH;
+    }
 
-                if (result == -1) {
-                    w_inc_modules_rootcheck_dropped_events();
+    if (Config.priority[EVENT_PRIORITY_LOW].location && OSMatch_Execute(module, strlen(module), Config.priority[EVENT_PRIORITY_LOW].location)) {
+        return EVENT_PRIORITY_LOW;
+    }
 
-                    if (!reported_rootcheck) {
-                        mwarn("Rootcheck decoder queue is full.");
-                        reported_rootcheck = 1;
-                    }
-                }
-            } else if (msg[0] == SCA_MQ) {
-                if (!queue_full(decode_queue_sca_input)) {
-                    os_strdup(buffer, copy);
+    return EVENT_PRIORITY_NORMAL;
+}
 
-                    result = queue_push_ex(decode_queue_sca_input, copy);
+static void ad_input_dispatch(char * buffer, int recv) {
+    char *copy;
+    char *msg = buffer;
+    int result;
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+    /* Get the time we received the event */
+    gettime(&c_timespec);
 
-                if (result == -1) {
-                    w_inc_modules_sca_dropped_events();
+    /* Check for a valid message */
+    if (strlen(msg) < 4) {
+        merror(IMSG_ERROR, msg);
+        return;
+    }
 
-                    if (!reported_sca) {
-                        mwarn("Security Configuration Assessment decoder queue is full.");
-                        reported_sca = 1;
-                    }
-                }
-            } else if (msg[0] == SYSCOLLECTOR_MQ) {
-                if (!queue_full(decode_queue_syscollector_input)) {
-                    os_strdup(buffer, copy);
+    w_add_recv((unsigned long) recv);
+    w_inc_received_events();
 
-                    result = queue_push_ex(decode_queue_syscollector_input, copy);
+    result = -1;
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+    if (msg[0] == SYSCHECK_MQ) {
+        if (!queue_full(decode_queue_syscheck_input)) {
+            os_strdup(buffer, copy);
 
-                if (result == -1) {
-                    w_inc_modules_syscollector_dropped_events();
+            result = queue_push_ex(decode_queue_syscheck_input, copy);
 
-                    if (!reported_syscollector) {
-                        mwarn("Syscollector decoder queue is full.");
-                        reported_syscollector = 1;
-                    }
-                }
-            } else if (msg[0] == HOSTINFO_MQ) {
-                if (!queue_full(decode_queue_hostinfo_input)) {
-                    os_strdup(buffer, copy);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
+                hourly_syscheck++;
+            }
+        }
 
-                    result = queue_push_ex(decode_queue_hostinfo_input, copy);
+        if (result == -1) {
+            w_inc_modules_syscheck_dropped_events();
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+            if (!reported_syscheck) {
+                mwarn("Syscheck decoder queue is full.");
+                reported_syscheck = 1;
+            }
+        }
+    } else if (msg[0] == ROOTCHECK_MQ) {
+        if (!queue_full(decode_queue_rootcheck_input)) {
+            os_strdup(buffer, copy);
 
-                if (result == -1) {
-                    w_inc_modules_logcollector_others_dropped_events();
+            result = queue_push_ex(decode_queue_rootcheck_input, copy);
 
-                    if (!reported_hostinfo) {
-                        mwarn("Hostinfo decoder queue is full.");
-                        reported_hostinfo = 1;
-                    }
-                }
-            } else if (msg[0] == WIN_EVT_MQ) {
-                if (!queue_full(decode_queue_winevt_input)) {
-                    os_strdup(buffer, copy);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
+            }
+        }
 
-                    result = queue_push_ex(decode_queue_winevt_input, copy);
+        if (result == -1) {
+            w_inc_modules_rootcheck_dropped_events();
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+            if (!reported_rootcheck) {
+                mwarn("Rootcheck decoder queue is full.");
+                reported_rootcheck = 1;
+            }
+        }
+    } else if (msg[0] == SCA_MQ) {
+        if (!queue_full(decode_queue_sca_input)) {
+            os_strdup(buffer, copy);
 
-                if (result == -1) {
-                    w_inc_modules_logcollector_eventchannel_dropped_events();
+            result = queue_push_ex(decode_queue_sca_input, copy);
 
-                    if (!reported_winevt) {
-                        mwarn("Windows eventchannel decoder queue is full.");
-                        reported_winevt = 1;
-                    }
-                }
-            } else if (msg[0] == DBSYNC_MQ) {
-                if (!queue_full(dispatch_dbsync_input)) {
-                    os_strdup(buffer, copy);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
+            }
+        }
 
-                    result = queue_push_ex(dispatch_dbsync_input, copy);
+        if (result == -1) {
+            w_inc_modules_sca_dropped_events();
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+            if (!reported_sca) {
+                mwarn("Security Configuration Assessment decoder queue is full.");
+                reported_sca = 1;
+            }
+        }
+    } else if (msg[0] == SYSCOLLECTOR_MQ) {
+        if (!queue_full(decode_queue_syscollector_input)) {
+            os_strdup(buffer, copy);
 
-                if (result == -1) {
-                    w_inc_dbsync_dropped_events();
+            result = queue_push_ex(decode_queue_syscollector_input, copy);
 
-                    if (!reported_dbsync) {
-                        mwarn("Database synchronization decoder queue is full.");
-                        reported_dbsync = 1;
-                    }
-                }
-            } else if (msg[0] == UPGRADE_MQ) {
-                if (!queue_full(upgrade_module_input)) {
-                    os_strdup(buffer, copy);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
+            }
+        }
 
-                    result = queue_push_ex(upgrade_module_input, copy);
+        if (result == -1) {
+            w_inc_modules_syscollector_dropped_events();
 
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+            if (!reported_syscollector) {
+                mwarn("Syscollector decoder queue is full.");
+                reported_syscollector = 1;
+            }
+        }
+    } else if (msg[0] == HOSTINFO_MQ) {
+        if (!queue_full(decode_queue_hostinfo_input)) {
+            os_strdup(buffer, copy);
 
-                if (result == -1) {
-                    w_inc_modules_upgrade_dropped_events();
+            result = queue_push_ex(decode_queue_hostinfo_input, copy);
 
-                    if (!reported_upgrade_module) {
-                        mwarn("Upgrade module decoder queue is full.");
-                        reported_upgrade_module = 1;
-                    }
-                }
+            if (result == -1) {
+                free(copy);
             } else {
-                if (!queue_full(decode_queue_event_input)) {
-                    os_strdup(buffer, copy);
-
-                    result = queue_push_ex(decode_queue_event_input, copy);
-
-                    if (result == -1) {
-                        free(copy);
-                    } else {
-                        hourly_events++;
-                    }
-                }
+                hourly_events++;
+            }
+        }
 
-                if (result == -1) {
-                    if (msg[0] == CISCAT_MQ) {
-                        w_inc_modules_ciscat_dropped_events();
-                    } else if (msg[0] == SYSLOG_MQ) {
-                        w_inc_syslog_dropped_events();
-                    } else if (msg[0] == LOCALFILE_MQ) {
-                        w_inc_dropped_by_component_events(extract_module_from_message(msg));
-                    }
+        if (result == -1) {
+            w_inc_modules_logcollector_others_dropped_events();
 
-                    if (!reported_event) {
-                        mwarn("Input queue is full.");
-                        reported_event = 1;
-                    }
-                }
+            if (!reported_hostinfo) {
+                mwarn("Hostinfo decoder queue is full.");
+                reported_hostinfo = 1;
             }
+        }
+    } else if (msg[0] == WIN_EVT_MQ) {
+        if (!queue_full(decode_queue_winevt_input)) {
+            os_strdup(buffer, copy);
+
+            result = queue_push_ex(decode_queue_winevt_input, copy);
 
             if (result == -1) {
-                if (!reported_eps_drop) {
-                    if (limit_reached(NULL)) {
-                        reported_eps_drop = 1;
-                        if (!reported_eps_drop_hourly) {
-                            mwarn("Queues are full and no EPS credits, dropping events.");
-                        } else {
-                            mdebug2("Queues are full and no EPS credits, dropping events.");
-                        }
-                        w_inc_eps_events_dropped();
-                    }
-                } else {
-                    w_inc_eps_events_dropped();
-                }
+                free(copy);
             } else {
-                if (reported_eps_drop) {
-                    reported_eps_drop = 0;
-                    if (!reported_eps_drop_hourly) {
-                        minfo("Queues back to normal and EPS credits, no dropping events.");
-                        reported_eps_drop_hourly = 1;
-                    } else {
-                        mdebug2("Queues back to normal and EPS credits, no dropping events.");
-                    }
-                }
+                hourly_events++;
             }
         }
-    }
 
-    return NULL;
-}
+        if (result == -1) {
+            w_inc_modules_logcollector_eventchannel_dropped_events();
 
-void * w_writer_thread(__attribute__((unused)) void * args ){
-    Eventinfo *lf = NULL;
+            if (!reported_winevt) {
+                mwarn("Windows eventchannel decoder queue is full.");
+                reported_winevt = 1;
+            }
+        }
+    } else if (msg[0] == DBSYNC_MQ) {
+        w_queue_t * dbsync_queue = num_dispatch_dbsync_shards > 0 ? dispatch_dbsync_shards[w_get_dbsync_shard(msg)] : dispatch_dbsync_input;
 
-    while(1){
-        /* Receive message from queue */
-        if (lf = queue_pop_ex(writer_queue), lf) {
+        if (!queue_full(dbsync_queue)) {
+            os_strdup(buffer, copy);
 
-            w_mutex_lock(&writer_threads_mutex);
-            w_inc_archives_written(lf->agent_id);
+            result = queue_push_ex(dbsync_queue, copy);
 
-            /* If configured to log all, do it */
-            if (Config.logall) {
-                OS_Store(lf);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
             }
-            if (Config.logall_json) {
-                jsonout_output_archive(lf);
+        }
+
+        if (result == -1) {
+            w_inc_dbsync_dropped_events();
+
+            if (!reported_dbsync) {
+                mwarn("Database synchronization decoder queue is full.");
+                reported_dbsync = 1;
             }
+        }
+    } else if (msg[0] == UPGRADE_MQ) {
+        if (!queue_full(upgrade_module_input)) {
+            os_strdup(buffer, copy);
 
-            Free_Eventinfo(lf);
-            w_mutex_unlock(&writer_threads_mutex);
+            result = queue_push_ex(upgrade_module_input, copy);
+
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
+            }
         }
-    }
-}
 
-void * w_writer_log_thread(__attribute__((unused)) void * args ){
-    Eventinfo *lf = NULL;
+        if (result == -1) {
+            w_inc_modules_upgrade_dropped_events();
 
-    while(1){
-        /* Receive message from queue */
-        if (lf = queue_pop_ex(writer_queue_log), lf) {
+            if (!reported_upgrade_module) {
+                mwarn("Upgrade module decoder queue is full.");
+                reported_upgrade_module = 1;
+            }
+        }
+    } else {
+        unsigned int priority = ad_event_priority(msg);
 
-            w_mutex_lock(&writer_threads_mutex);
-            w_inc_alerts_written(lf->agent_id);
+        if (!prio_queue_full(decode_queue_event_input, priority)) {
+            os_strdup(buffer, copy);
+
+            result = prio_queue_push_ex(decode_queue_event_input, priority, copy);
 
-            if (Config.custom_alert_output) {
-                __crt_ftell = ftell(_aflog);
-                OS_CustomLog(lf, Config.custom_alert_output_format);
-            } else if (Config.alerts_log) {
-                __crt_ftell = ftell(_aflog);
-                OS_Log(lf, _aflog);
-            } else if (Config.jsonout_output) {
-                __crt_ftell = ftell(_jflog);
+            if (result == -1) {
+                free(copy);
+            } else {
+                hourly_events++;
             }
-            /* Log to json file */
-            if (Config.jsonout_output) {
-                jsonout_output_event(lf);
+        }
+
+        if (result == -1) {
+            w_inc_priority_dropped_events(priority);
+
+            if (msg[0] == CISCAT_MQ) {
+                w_inc_modules_ciscat_dropped_events();
+            } else if (msg[0] == SYSLOG_MQ) {
+                w_inc_syslog_dropped_events();
+            } else if (msg[0] == LOCALFILE_MQ) {
+                w_inc_dropped_by_component_events(extract_module_from_message(msg));
             }
 
-#ifdef PRELUDE_OUTPUT_ENABLED
-            /* Log to prelude */
-            if (Config.prelude) {
-                RuleInfo *rule = lf->generated_rule;
+            if (!reported_event) {
+                mwarn("Input queue is full.");
+                reported_event = 1;
+            }
+        }
+    }
 
-                if (rule && Config.prelude_log_level <= rule->level) {
-                    OS_PreludeLog(lf);
+    if (result == -1) {
+        if (!reported_eps_drop) {
+            if (limit_reached(NULL)) {
+                reported_eps_drop = 1;
+                if (!reported_eps_drop_hourly) {
+                    mwarn("Queues are full and no EPS credits, dropping events.");
+                } else {
+                    mdebug2("Queues are full and no EPS credits, dropping events.");
                 }
+                w_inc_eps_events_dropped();
             }
-#endif
-
-#ifdef ZEROMQ_OUTPUT_ENABLED
-            /* Log to zeromq */
-            if (Config.zeromq_output) {
-                zeromq_output_event(lf);
+        } else {
+            w_inc_eps_events_dropped();
+        }
+    } else {
+        if (reported_eps_drop) {
+            reported_eps_drop = 0;
+            if (!reported_eps_drop_hourly) {
+                minfo("Queues back to normal and EPS credits, no dropping events.");
+                reported_eps_drop_hourly = 1;
+            } else {
+                mdebug2("Queues back to normal and EPS credits, no dropping events.");
             }
-#endif
-            w_mutex_unlock(&writer_threads_mutex);
-            Free_Eventinfo(lf);
         }
     }
 }
 
-void * w_decode_syscheck_thread(__attribute__((unused)) void * args){
-    Eventinfo *lf = NULL;
-    char *msg = NULL;
-    _sdb sdb;
-    OSDecoderInfo *fim_decoder = NULL;
-
-    os_calloc(1, sizeof(OSDecoderInfo), fim_decoder);
+/* Queue that receives a message, to wait for room before replaying it. NULL for the events queue. */
+static w_queue_t * ad_input_queue(const char * msg) {
+    switch (msg[0]) {
+    case SYSCHECK_MQ:
+        return decode_queue_syscheck_input;
+    case ROOTCHECK_MQ:
+        return decode_queue_rootcheck_input;
+    case SCA_MQ:
+        return decode_queue_sca_input;
+    case SYSCOLLECTOR_MQ:
+        return decode_queue_syscollector_input;
+    case HOSTINFO_MQ:
+        return decode_queue_hostinfo_input;
+    case WIN_EVT_MQ:
+        return decode_queue_winevt_input;
+    case DBSYNC_MQ:
+        return num_dispatch_dbsync_shards > 0 ? dispatch_dbsync_shards[w_get_dbsync_shard(msg)] : dispatch_dbsync_input;
+    case UPGRADE_MQ:
+        return upgrade_module_input;
+    default:
+        return NULL;
+    }
+}
 
-    /* Initialize the integrity database */
-    sdb_init(&sdb, fim_decoder);
+/* Check if the queue that receives a message is full */
+static bool ad_input_full(const char * msg) {
+    w_queue_t * queue = ad_input_queue(msg);
+    return queue ? queue_full(queue) : prio_queue_full(decode_queue_event_input, ad_event_priority(msg));
+}
 
-    while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_syscheck_input), msg) {
-            get_eps_credit();
+/* Queues of the replayed events, each stage before the ones it feeds */
+static void ad_replay_queues(w_queue_t *** queues, size_t * count) {
+    w_queue_t * inputs[] = {
+        decode_queue_syscheck_input, decode_queue_rootcheck_input, decode_queue_sca_input,
+        decode_queue_syscollector_input, decode_queue_hostinfo_input, decode_queue_winevt_input,
+        dispatch_dbsync_input, upgrade_module_input, decode_queue_event_output
+    };
+    w_queue_t * writers[] = {
+        writer_queue, writer_queue_log, writer_queue_log_statistical, writer_queue_log_firewall, writer_queue_log_fts
+    };
+    size_t n = 0;
+    int i;
 
-            int res = 0;
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+    os_calloc(array_size(inputs) + array_size(writers) + num_rule_matching_shards + num_dispatch_dbsync_shards, sizeof(w_queue_t *), *queues);
 
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
+    for (i = 0; i < (int)array_size(inputs); i++) {
+        (*queues)[n++] = inputs[i];
+    }
 
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
-            }
+    for (i = 0; i < num_dispatch_dbsync_shards; i++) {
+        (*queues)[n++] = dispatch_dbsync_shards[i];
+    }
 
-            free(msg);
+    for (i = 0; i < num_rule_matching_shards; i++) {
+        (*queues)[n++] = decode_queue_event_shards[i];
+    }
 
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+    for (i = 0; i < (int)array_size(writers); i++) {
+        (*queues)[n++] = writers[i];
+    }
 
-            w_inc_modules_syscheck_decoded_events(lf->agent_id);
+    *count = n;
+}
 
-            lf->decoder_info = fim_decoder;
+/* Wait until every replayed event has been processed. A consumer feeds the next stage before
+ * it reports its batch as done, so once a stage is idle, the ones it feeds have all its
+ * events and the stages can be checked in order. */
+static void ad_replay_wait(w_queue_t ** queues, size_t count) {
+    size_t i;
 
-            // If the event comes in JSON format agent version is >= 3.11. Therefore we decode, alert and update DB entry.
-            if (*lf->log == '{') {
-                res = decode_fim_event(&sdb, lf);
-            } else {
-                res = DecodeSyscheck(lf, &sdb);
-            }
+    while (!prio_queue_idle(decode_queue_event_input)) {
+        usleep(10000);
+    }
 
-            if (res == 1 && queue_push_ex_block(decode_queue_event_output, lf) == 0) {
-                continue;
-            } else {
-                /* We don't process syscheck events further */
-                w_free_event_info(lf);
-            }
+    for (i = 0; i < count; i++) {
+        while (queues[i] && !queue_idle(queues[i])) {
+            usleep(10000);
         }
     }
 }
 
-void * w_decode_syscollector_thread(__attribute__((unused)) void * args){
+static void * ad_replay_main(void * args) {
+    FILE * fp = args;
+    char buffer[OS_MAXSTR + 1];
+    struct timespec start;
+    struct timespec end;
+    struct rusage usage;
+    unsigned long events = 0;
+    double elapsed;
+    size_t length;
+    cJSON * state_json;
+    cJSON * report = cJSON_CreateObject();
+    char * output;
+    w_queue_t ** queues;
+    size_t count;
+    size_t i;
+
+    /* Count the batches in process, the replay is over when they are done */
+    ad_replay_queues(&queues, &count);
+    prio_queue_track_busy(decode_queue_event_input);
+
+    for (i = 0; i < count; i++) {
+        if (queues[i]) {
+            queue_track_busy(queues[i]);
+        }
+    }
+
+    minfo("Replaying the benchmark events.");
+    gettime(&start);
+
+    /* One queue message per line, as in "1:location:log" */
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        if (length = strcspn(buffer, "\r\n"), length == 0) {
+            continue;
+        }
+
+        buffer[length] = '\0';
+
+        /* Wait for room instead of dropping the event */
+        while (length >= 4 && ad_input_full(buffer)) {
+            usleep(1000);
+        }
+
+        ad_input_dispatch(buffer, length);
+        events++;
+    }
+
+    fclose(fp);
+
+    /* Wait for the events in flight */
+    ad_replay_wait(queues, count);
+    os_free(queues);
+
+    gettime(&end);
+    elapsed = time_diff(&start, &end);
+    getrusage(RUSAGE_SELF, &usage);
+
+    cJSON_AddNumberToObject(report, "events", events);
+    cJSON_AddNumberToObject(report, "seconds", elapsed);
+    cJSON_AddNumberToObject(report, "eps", elapsed > 0 ? events / elapsed : 0);
+    cJSON_AddNumberToObject(report, "max_rss_kb", usage.ru_maxrss);
+
+    if (state_json = asys_create_state_json(), state_json) {
+        cJSON * metrics = cJSON_GetObjectItem(state_json, "metrics");
+
+        cJSON_AddItemToObject(report, "events_breakdown", cJSON_DetachItemFromObject(metrics, "events"));
+        cJSON_AddItemToObject(report, "latency", cJSON_DetachItemFromObject(metrics, "latency"));
+        cJSON_Delete(state_json);
+    }
+
+    output = cJSON_Print(report);
+    print_out("%s", output);
+    cJSON_free(output);
+    cJSON_Delete(report);
+
+    exit(0);
+}
+
+void * w_writer_thread(__attribute__((unused)) void * args ){
     Eventinfo *lf = NULL;
-    char *msg = NULL;
-    int socket = -1;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
 
-    while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_syscollector_input), msg) {
-            get_eps_credit();
+    while(1){
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(writer_queue, batch, AD_QUEUE_BATCH_SIZE);
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        w_mutex_lock(&writer_threads_mutex);
 
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            lf = batch[batch_pos];
+            w_inc_archives_written(lf->agent_id);
 
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
+            /* If configured to log all, do it */
+            if (Config.logall) {
+                OS_Store(lf);
+            }
+            if (Config.logall_json) {
+                jsonout_output_archive(lf);
             }
 
-            free(msg);
+            Free_Eventinfo(lf);
+        }
 
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+        w_mutex_unlock(&writer_threads_mutex);
+        queue_done(writer_queue, batch_len);
+    }
+}
 
-            w_inc_modules_syscollector_decoded_events(lf->agent_id);
+/* Write an alert in the alerts log and JSON files. Writer threads mutex must be held */
+static void w_write_alert(Eventinfo * lf) {
+    if (Config.custom_alert_output) {
+        __crt_ftell = ftell(_aflog);
+        OS_CustomLog(lf, Config.custom_alert_output_format);
+    } else if (Config.alerts_log) {
+        __crt_ftell = ftell(_aflog);
+        OS_Log(lf, _aflog);
+    } else if (Config.jsonout_output) {
+        __crt_ftell = ftell(_jflog);
+    }
+    /* Log to json file */
+    if (Config.jsonout_output) {
+        jsonout_output_event(lf);
+    }
+}
 
-            if (!DecodeSyscollector(lf, &socket)) {
-                /* We don't process syscollector events further */
-                w_free_event_info(lf);
+/* Send an alert record to the main instance, waiting for it while it's not listening */
+static void w_forward_alert_record(const char * record, size_t length) {
+    static int sock = -1;
+    static unsigned int dropped = 0;
+    bool warned = false;
+
+    /* Nothing but the record type */
+    if (length <= 1) {
+        return;
+    }
+
+    if (length > ALERTS_FORWARD_MAXSIZE) {
+        mwarn("Alert of %zu bytes too large to be forwarded to the main instance (%u dropped).", length, ++dropped);
+        return;
+    }
+
+    while (sock < 0 || OS_SendSecureTCP(sock, length, record) != 0) {
+        if (sock >= 0) {
+            close(sock);
+        }
+
+        if (sock = OS_ConnectUnixDomain(ALERTS_FORWARD_SOCK, SOCK_STREAM, OS_MAXSTR), sock < 0) {
+            if (!warned) {
+                mwarn("Unable to forward the alerts to the main instance at '%s': %s (%d). Retrying.", ALERTS_FORWARD_SOCK, strerror(errno), errno);
+                warned = true;
             }
-            else {
-                if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
-                    w_free_event_info(lf);
+
+            sleep(1);
+        }
+    }
+}
+
+/* The additional instances don't open the alerts files: the alert is written into memory as
+ * it would be written to them, and the main instance appends it to alerts.log and alerts.json,
+ * the files that filebeat, integratord, maild and csyslogd read. Writer threads mutex must be held */
+static void w_forward_alert(Eventinfo * lf) {
+    char * text = NULL;
+    char * json = NULL;
+    size_t text_length = 0;
+    size_t json_length = 0;
+
+    if (_aflog = open_memstream(&text, &text_length), !_aflog) {
+        merror_exit(MEM_ERROR, errno, strerror(errno));
+    }
+
+    if (_jflog = open_memstream(&json, &json_length), !_jflog) {
+        merror_exit(MEM_ERROR, errno, strerror(errno));
+    }
+
+    fputc(ALERTS_FORWARD_LOG, _aflog);
+    fputc(ALERTS_FORWARD_JSON, _jflog);
+    w_write_alert(lf);
+
+    fclose(_aflog);
+    fclose(_jflog);
+    _aflog = NULL;
+    _jflog = NULL;
+
+    w_forward_alert_record(text, text_length);
+    w_forward_alert_record(json, json_length);
+
+    os_free(text);
+    os_free(json);
+}
+
+/* Append the alerts of an additional instance until it disconnects */
+static void * w_alerts_receiver_peer(void * args) {
+    int peer = (intptr_t)args;
+    char * buffer;
+    ssize_t length;
+
+    os_malloc(ALERTS_FORWARD_MAXSIZE, buffer);
+
+    while (length = OS_RecvSecureTCP(peer, buffer, ALERTS_FORWARD_MAXSIZE), length > 1) {
+        w_mutex_lock(&writer_threads_mutex);
+
+        if (buffer[0] == ALERTS_FORWARD_LOG && _aflog && (Config.custom_alert_output || Config.alerts_log)) {
+            fwrite(buffer + 1, 1, length - 1, _aflog);
+        } else if (buffer[0] == ALERTS_FORWARD_JSON && _jflog && Config.jsonout_output) {
+            fwrite(buffer + 1, 1, length - 1, _jflog);
+        }
+
+        w_mutex_unlock(&writer_threads_mutex);
+    }
+
+    if (length == OS_SOCKTERR) {
+        merror("Alert from an additional instance larger than %d bytes.", ALERTS_FORWARD_MAXSIZE);
+    }
+
+    close(peer);
+    os_free(buffer);
+    return NULL;
+}
+
+/* Main instance: receive the alerts of the additional ones */
+static void * w_alerts_receiver_thread(__attribute__((unused)) void * args) {
+    int sock;
+    int peer;
+
+    if (sock = OS_BindUnixDomain(ALERTS_FORWARD_SOCK, SOCK_STREAM, OS_MAXSTR), sock < 0) {
+        merror("Unable to bind to socket '%s': (%d) '%s'", ALERTS_FORWARD_SOCK, errno, strerror(errno));
+        return NULL;
+    }
+
+    while (1) {
+        if (peer = accept(sock, NULL, NULL), peer < 0) {
+            if (errno != EINTR) {
+                merror("At accept(): '%s'", strerror(errno));
+            }
+            continue;
+        }
+
+        w_create_thread(w_alerts_receiver_peer, (void *)(intptr_t)peer);
+    }
+
+    return NULL;
+}
+
+void * w_writer_log_thread(__attribute__((unused)) void * args ){
+    Eventinfo *lf = NULL;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
+
+    while(1){
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(writer_queue_log, batch, AD_QUEUE_BATCH_SIZE);
+
+        w_mutex_lock(&writer_threads_mutex);
+
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            lf = batch[batch_pos];
+            w_inc_alerts_written(lf->agent_id);
+            lf->trace_time = w_add_event_latency(LATENCY_ALERTS_QUEUE, lf->trace_time);
+
+            if (Config.instance) {
+                w_forward_alert(lf);
+            } else {
+                w_write_alert(lf);
+            }
+
+#ifdef PRELUDE_OUTPUT_ENABLED
+            /* Log to prelude */
+            if (Config.prelude) {
+                RuleInfo *rule = lf->generated_rule;
+
+                if (rule && Config.prelude_log_level <= rule->level) {
+                    OS_PreludeLog(lf);
                 }
             }
+#endif
+
+#ifdef ZEROMQ_OUTPUT_ENABLED
+            /* Log to zeromq */
+            if (Config.zeromq_output) {
+                zeromq_output_event(lf);
+            }
+#endif
+            w_add_event_latency(LATENCY_ALERTS_WRITE, lf->trace_time);
+            Free_Eventinfo(lf);
         }
+
+        w_mutex_unlock(&writer_threads_mutex);
+        queue_done(writer_queue_log, batch_len);
     }
 }
 
-void * w_decode_rootcheck_thread(__attribute__((unused)) void * args){
+static void w_decode_syscheck_batch(decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
     Eventinfo *lf = NULL;
     char *msg = NULL;
 
-    while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_rootcheck_input), msg) {
-            get_eps_credit();
+    if (!state->sdb) {
+        os_calloc(1, sizeof(OSDecoderInfo), state->fim_decoder);
+        os_calloc(1, sizeof(_sdb), state->sdb);
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        /* Initialize the integrity database */
+        sdb_init(state->sdb, state->fim_decoder);
+    }
 
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
 
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
-            }
+        int res = 0;
+        /* Default values for the log info */
+        lf = w_event_new();
 
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
             free(msg);
+            continue;
+        }
 
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+        free(msg);
+
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
 
-            w_inc_modules_rootcheck_decoded_events(lf->agent_id);
+        w_inc_modules_syscheck_decoded_events(lf->agent_id);
+
+        lf->decoder_info = state->fim_decoder;
+
+        // If the event comes in JSON format agent version is >= 3.11. Therefore we decode, alert and update DB entry.
+        if (*lf->log == '{') {
+            res = decode_fim_event(state->sdb, lf);
+        } else {
+            res = DecodeSyscheck(lf, state->sdb);
+        }
 
-            if (!DecodeRootcheck(lf)) {
-                /* We don't process rootcheck events further */
+        if (res == 1 && w_push_decoded_event(lf) == 0) {
+            continue;
+        } else {
+            /* We don't process syscheck events further */
+            w_free_event_info(lf);
+        }
+    }
+}
+
+static void w_decode_syscollector_batch(decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
+    Eventinfo *lf = NULL;
+    char *msg = NULL;
+
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
+
+        /* Default values for the log info */
+        lf = w_event_new();
+
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
+            free(msg);
+            continue;
+        }
+
+        free(msg);
+
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+
+        w_inc_modules_syscollector_decoded_events(lf->agent_id);
+
+        if (!DecodeSyscollector(lf, &state->syscollector_sock)) {
+            /* We don't process syscollector events further */
+            w_free_event_info(lf);
+        }
+        else {
+            if (w_push_decoded_event(lf) < 0) {
                 w_free_event_info(lf);
             }
-            else {
-                if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
-                    w_free_event_info(lf);
-                }
-            }
         }
     }
 }
 
-void * w_decode_sca_thread(__attribute__((unused)) void * args){
+static void w_decode_rootcheck_batch(__attribute__((unused)) decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
     Eventinfo *lf = NULL;
     char *msg = NULL;
-    int socket = -1;
 
-    while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_sca_input), msg) {
-            get_eps_credit();
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        /* Default values for the log info */
+        lf = w_event_new();
 
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
+            free(msg);
+            continue;
+        }
 
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
+        free(msg);
+
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+
+        w_inc_modules_rootcheck_decoded_events(lf->agent_id);
+
+        if (!DecodeRootcheck(lf)) {
+            /* We don't process rootcheck events further */
+            w_free_event_info(lf);
+        }
+        else {
+            if (w_push_decoded_event(lf) < 0) {
+                w_free_event_info(lf);
             }
+        }
+    }
+}
 
+static void w_decode_sca_batch(decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
+    Eventinfo *lf = NULL;
+    char *msg = NULL;
+
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
+
+        /* Default values for the log info */
+        lf = w_event_new();
+
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
             free(msg);
+            continue;
+        }
 
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+        free(msg);
+
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
 
-            w_inc_modules_sca_decoded_events(lf->agent_id);
+        w_inc_modules_sca_decoded_events(lf->agent_id);
 
-            if (!DecodeSCA(lf, &socket)) {
-                /* We don't process rootcheck events further */
+        if (!DecodeSCA(lf, &state->sca_sock)) {
+            /* We don't process rootcheck events further */
+            w_free_event_info(lf);
+        }
+        else {
+            if (w_push_decoded_event(lf) < 0) {
                 w_free_event_info(lf);
             }
-            else {
-                if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
-                    w_free_event_info(lf);
-                }
-            }
         }
     }
 }
 
-void * w_decode_hostinfo_thread(__attribute__((unused)) void * args){
+static void w_decode_hostinfo_batch(__attribute__((unused)) decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
     Eventinfo *lf = NULL;
-    char * msg = NULL;
+    char *msg = NULL;
 
-    while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_hostinfo_input), msg) {
-            get_eps_credit();
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        /* Default values for the log info */
+        lf = w_event_new();
 
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
+            free(msg);
+            continue;
+        }
 
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
+        free(msg);
+
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+
+        w_inc_modules_logcollector_others_decoded_events(lf->agent_id);
+
+        if (!DecodeHostinfo(lf)) {
+            /* We don't process syscheck events further */
+            w_free_event_info(lf);
+        }
+        else {
+            if (w_push_decoded_event(lf) < 0) {
+                w_free_event_info(lf);
             }
+        }
+    }
+}
+
+static void w_decode_winevt_batch(__attribute__((unused)) decode_state * state, void ** batch, size_t batch_len) {
+    size_t batch_pos;
+    Eventinfo *lf = NULL;
+    char *msg = NULL;
+
+    for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+        msg = batch[batch_pos];
+        get_eps_credit();
+
+        /* Default values for the log info */
+        lf = w_event_new();
 
+        if (OS_CleanMSG(msg, lf) < 0) {
+            merror(IMSG_ERROR, msg);
+            Free_Eventinfo(lf);
             free(msg);
+            continue;
+        }
 
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
+        free(msg);
 
-            w_inc_modules_logcollector_others_decoded_events(lf->agent_id);
+        /* Msg cleaned */
+        DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
 
-            if (!DecodeHostinfo(lf)) {
-                /* We don't process syscheck events further */
+        w_inc_modules_logcollector_eventchannel_decoded_events(lf->agent_id);
+
+        if (DecodeWinevt(lf)) {
+            /* We don't process windows events further */
+            w_free_event_info(lf);
+        }
+        else {
+            if (w_push_decoded_event(lf) < 0) {
                 w_free_event_info(lf);
             }
-            else {
-                if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
-                    w_free_event_info(lf);
-                }
+        }
+    }
+}
+
+void * w_decode_syscheck_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+
+    while(1) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_syscheck_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_syscheck_batch(&state, batch, batch_len);
+
+        /* Check the database responses while there is no other work */
+        if (queue_empty(decode_queue_syscheck_input)) {
+            fim_db_flush(state.sdb);
+        }
+
+        /* After the flush, so that an idle queue has no response pending */
+        queue_done(decode_queue_syscheck_input, batch_len);
+    }
+}
+
+void * w_decode_syscollector_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+
+    while(1) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_syscollector_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_syscollector_batch(&state, batch, batch_len);
+        queue_done(decode_queue_syscollector_input, batch_len);
+    }
+}
+
+void * w_decode_rootcheck_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+
+    while(1) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_rootcheck_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_rootcheck_batch(&state, batch, batch_len);
+        queue_done(decode_queue_rootcheck_input, batch_len);
+    }
+}
+
+void * w_decode_sca_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+
+    while(1) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_sca_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_sca_batch(&state, batch, batch_len);
+        queue_done(decode_queue_sca_input, batch_len);
+    }
+}
+
+void * w_decode_hostinfo_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+
+    while(1) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_hostinfo_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_hostinfo_batch(&state, batch, batch_len);
+        queue_done(decode_queue_hostinfo_input, batch_len);
+    }
+}
+
+static decode_class * w_decode_shared_pick() {
+    decode_class * best = NULL;
+    unsigned int best_score = 0;
+    unsigned int score;
+    w_queue_t * queue;
+    size_t i;
+
+    w_mutex_lock(&decode_shared_mutex);
+
+    for (i = 0; i < array_size(decode_classes); i++) {
+        queue = *decode_classes[i].queue;
+
+        if (decode_classes[i].helpers >= decode_shared_limit) {
+            continue;
+        }
+
+        /* Fill percentage, shared with the helpers the queue already has. Read without
+         * the queue lock: it only weighs the choice of the queue. */
+        score = (unsigned int)(queue->elements * 100 / queue->size) / (decode_classes[i].helpers + 1);
+
+        if (score >= DECODE_SHARED_BACKLOG && score > best_score) {
+            best = &decode_classes[i];
+            best_score = score;
+        }
+    }
+
+    if (best) {
+        best->helpers++;
+    }
+
+    w_mutex_unlock(&decode_shared_mutex);
+
+    return best;
+}
+
+void * w_decode_shared_thread(__attribute__((unused)) void * args) {
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
+    decode_class * class;
+    const struct timespec no_wait = { 0, 0 };
+    size_t decoded;
+    int runs;
+
+    while (1) {
+        if (class = w_decode_shared_pick(), !class) {
+            usleep(DECODE_SHARED_IDLE);
+            continue;
+        }
+
+        /* A few batches before choosing again, so every backlogged queue gets its turn */
+        for (runs = 0, decoded = 0; runs < DECODE_SHARED_RUNS; runs++) {
+            if (batch_len = queue_pop_batch_ex_timedwait(*class->queue, batch, AD_QUEUE_BATCH_SIZE, &no_wait), batch_len == 0) {
+                break;
             }
+
+            class->decode(&state, batch, batch_len);
+            decoded += batch_len;
         }
+
+        if (class->decode == w_decode_syscheck_batch && state.sdb) {
+            fim_db_flush(state.sdb);
+        }
+
+        queue_done(*class->queue, decoded);
+
+        w_mutex_lock(&decode_shared_mutex);
+        class->helpers--;
+        w_mutex_unlock(&decode_shared_mutex);
     }
 }
 
 void * w_decode_event_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
     Eventinfo *lf = NULL;
     OSDecoderNode *node;
     char * msg = NULL;
@@ -1721,15 +2429,16 @@ void * w_decode_event_thread(__attribute__((unused)) void * args){
     int sock = -1;
 
     while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_event_input), msg) {
-            get_eps_credit();
+        /* Receive messages from queue */
+        batch_len = prio_queue_pop_batch_ex(decode_queue_event_input, batch, AD_QUEUE_BATCH_SIZE);
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            msg = batch[batch_pos];
+            get_eps_credit();
 
             /* Default values for the log info */
-            Zero_Eventinfo(lf);
+            lf = w_event_new();
+            lf->trace_time = w_latency_sample(Config.latency_sample) ? w_latency_now() : 0;
 
             if (OS_CleanMSG(msg, lf) < 0) {
                 merror(IMSG_ERROR, msg);
@@ -1751,8 +2460,12 @@ void * w_decode_event_thread(__attribute__((unused)) void * args){
                 } else if (msg[0] == LOCALFILE_MQ) {
                     w_inc_decoded_by_component_events(extract_module_from_location(lf->location), lf->agent_id);
                 }
-                node = OS_GetFirstOSDecoder(lf->program_name);
-                DecodeEvent(lf, Config.g_rules_hash, &decoder_match, node);
+                /* The event keeps the generation of its decoder until it is freed */
+                lf->ruleset = w_ruleset_acquire();
+                node = lf->program_name ? lf->ruleset->decoderlist_pn : lf->ruleset->decoderlist_nopn;
+                W_PROBE(decode__start);
+                DecodeEvent(lf, lf->ruleset->rules_hash, &decoder_match, node);
+                W_PROBE1(decode__done, lf->decoder_info->id);
             }
 
             free(msg);
@@ -1760,67 +2473,48 @@ void * w_decode_event_thread(__attribute__((unused)) void * args){
             /* Msg cleaned */
             DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
 
-            if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
+            lf->trace_time = w_add_event_latency(LATENCY_DECODE, lf->trace_time);
+
+            if (w_push_decoded_event(lf) < 0) {
                 Free_Eventinfo(lf);
             }
         }
+
+        prio_queue_done(decode_queue_event_input, batch_len);
     }
 }
 
-void * w_decode_winevt_thread(__attribute__((unused)) void * args) {
-    Eventinfo *lf = NULL;
-    char * msg = NULL;
+void * w_decode_winevt_thread(__attribute__((unused)) void * args){
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    decode_state state = DECODE_STATE_INIT;
 
     while(1) {
-        /* Receive message from queue */
-        if (msg = queue_pop_ex(decode_queue_winevt_input), msg) {
-            get_eps_credit();
-
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
-
-            /* Default values for the log info */
-            Zero_Eventinfo(lf);
-
-            if (OS_CleanMSG(msg, lf) < 0) {
-                merror(IMSG_ERROR, msg);
-                Free_Eventinfo(lf);
-                free(msg);
-                continue;
-            }
-
-            free(msg);
-
-            /* Msg cleaned */
-            DEBUG_MSG("%s: DEBUG: Msg cleanup: %s ", ARGV0, lf->log);
-
-            w_inc_modules_logcollector_eventchannel_decoded_events(lf->agent_id);
-
-            if (DecodeWinevt(lf)) {
-                /* We don't process windows events further */
-                w_free_event_info(lf);
-            }
-            else {
-                if (queue_push_ex_block(decode_queue_event_output, lf) < 0) {
-                    w_free_event_info(lf);
-                }
-            }
-        }
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(decode_queue_winevt_input, batch, AD_QUEUE_BATCH_SIZE);
+        w_decode_winevt_batch(&state, batch, batch_len);
+        queue_done(decode_queue_winevt_input, batch_len);
     }
 }
 
-void * w_dispatch_dbsync_thread(__attribute__((unused)) void * args) {
+void * w_dispatch_dbsync_thread(void * args) {
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
     char * msg;
     Eventinfo * lf;
-    dbsync_context_t ctx = { .db_sock = -1, .ar_sock = -1 };
+    dbsync_context_t ctx = { .db_sock = -1, .ar_sock = -1, .pipeline = { .name = "dbsync", .size = DBSYNC_PIPELINE_SIZE } };
+    w_queue_t * input = num_dispatch_dbsync_shards > 0 ? dispatch_dbsync_shards[(intptr_t)args] : dispatch_dbsync_input;
 
     for (;;) {
-        if (msg = queue_pop_ex(dispatch_dbsync_input), msg) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(input, batch, AD_QUEUE_BATCH_SIZE);
+
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            msg = batch[batch_pos];
             get_eps_credit();
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
-            Zero_Eventinfo(lf);
+            lf = w_event_new();
 
             if (OS_CleanMSG(msg, lf) < 0) {
                 merror(IMSG_ERROR, msg);
@@ -1836,22 +2530,34 @@ void * w_dispatch_dbsync_thread(__attribute__((unused)) void * args) {
             DispatchDBSync(&ctx, lf);
             Free_Eventinfo(lf);
         }
+
+        /* Check the database responses while there is no other work */
+        if (queue_empty(input)) {
+            DispatchDBSyncFlush(&ctx);
+        }
+
+        queue_done(input, batch_len);
     }
 
     return NULL;
 }
 
 void * w_dispatch_upgrade_module_thread(__attribute__((unused)) void * args) {
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
     char * msg;
     Eventinfo * lf;
 
     while (true) {
-        if (msg = queue_pop_ex(upgrade_module_input), msg) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(upgrade_module_input, batch, AD_QUEUE_BATCH_SIZE);
+
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            msg = batch[batch_pos];
             get_eps_credit();
 
-            os_calloc(1, sizeof(Eventinfo), lf);
-            os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
-            Zero_Eventinfo(lf);
+            lf = w_event_new();
 
             if (OS_CleanMSG(msg, lf) < 0) {
                 merror(IMSG_ERROR, msg);
@@ -1896,21 +2602,80 @@ void * w_dispatch_upgrade_module_thread(__attribute__((unused)) void * args) {
 
             Free_Eventinfo(lf);
         }
+
+        queue_done(upgrade_module_input, batch_len);
     }
 
     return NULL;
 }
 
+static int w_get_agent_shard(const char * agent_id, size_t length, int shards) {
+    unsigned long id = 0;
+    unsigned int hash = 5381;
+    bool numeric = length > 0;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = hash * 33 + (unsigned char)agent_id[i];
+
+        if (isdigit((unsigned char)agent_id[i])) {
+            id = id * 10 + (agent_id[i] - '0');
+        } else {
+            numeric = false;
+        }
+    }
+
+    /* Agent IDs are sequential numbers, the modulo spreads them evenly */
+    return (int)((numeric ? id : hash) % (unsigned long)shards);
+}
+
+static int w_get_event_shard(const Eventinfo * lf) {
+    if (num_rule_matching_shards <= 1 || !lf->agent_id) {
+        return 0;
+    }
+
+    return w_get_agent_shard(lf->agent_id, strlen(lf->agent_id), num_rule_matching_shards);
+}
+
+static int w_get_dbsync_shard(const char * msg) {
+    const char * id = msg + 2;
+    const char * end;
+
+    if (num_dispatch_dbsync_shards <= 1) {
+        return 0;
+    }
+
+    /* The header is "q:[id] (name) ip->location" for agents, local messages belong to the manager */
+    if (*id != '[' || (end = strchr(++id, ']'), !end)) {
+        return w_get_agent_shard("000", 3, num_dispatch_dbsync_shards);
+    }
+
+    return w_get_agent_shard(id, end - id, num_dispatch_dbsync_shards);
+}
+
+static int w_push_decoded_event(Eventinfo * lf) {
+    if (num_rule_matching_shards > 0) {
+        return queue_push_ex_block(decode_queue_event_shards[w_get_event_shard(lf)], lf);
+    }
+
+    return queue_push_ex_block(decode_queue_event_output, lf);
+}
+
 void * w_process_event_thread(__attribute__((unused)) void * id){
     Eventinfo *lf = NULL;
     RuleInfo *t_currently_rule = NULL;
     int result;
     int t_id = (intptr_t)id;
+    uint64_t trace_time;
     regex_matching rule_match;
     memset(&rule_match, 0, sizeof(regex_matching));
     Eventinfo *lf_cpy = NULL;
     Eventinfo *lf_logall = NULL;
     int sock = -1;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len = 0;
+    size_t batch_pos = 0;
+    w_queue_t * input = num_rule_matching_shards > 0 ? decode_queue_event_shards[t_id] : decode_queue_event_output;
 
     /* Stats */
     RuleInfo *stats_rule = NULL;
@@ -1933,13 +2698,18 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
         RuleNode *rulenode_pt;
         lf_logall = NULL;
 
-        /* Extract decoded event from the queue */
-        if (lf = queue_pop_ex(decode_queue_event_output), !lf) {
-            continue;
+        /* Extract decoded events from the queue, one batch at a time */
+        if (batch_pos == batch_len) {
+            queue_done(input, batch_len);
+            batch_len = queue_pop_batch_ex(input, batch, AD_QUEUE_BATCH_SIZE);
+            batch_pos = 0;
         }
 
+        lf = batch[batch_pos++];
+
         lf->tid = t_id;
         t_currently_rule = NULL;
+        trace_time = w_add_event_latency(LATENCY_DECODED_QUEUE, lf->trace_time);
 
         lf->size = strlen(lf->log);
 
@@ -2014,8 +2784,13 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
 
         w_inc_processed_events(lf->agent_id);
 
+        /* Events not decoded by the ruleset take the current generation to be matched */
+        if (!lf->ruleset) {
+            lf->ruleset = w_ruleset_acquire();
+        }
+
         /* Loop over all the rules */
-        rulenode_pt = OS_GetFirstRule();
+        rulenode_pt = lf->ruleset->rule_list;
         if (!rulenode_pt) {
             merror_exit("Rules in an inconsistent state. Exiting.");
         }
@@ -2035,7 +2810,7 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
             }
 
             /* Check each rule */
-            else if (t_currently_rule = OS_CheckIfRuleMatch(lf, os_analysisd_last_events, &os_analysisd_cdblists,
+            else if (t_currently_rule = OS_CheckIfRuleMatch(lf, os_analysisd_last_events, &lf->ruleset->cdblists,
                      rulenode_pt, &rule_match, &os_analysisd_fts_list, &os_analysisd_fts_store, true, NULL), !t_currently_rule) {
 
                 continue;
@@ -2089,6 +2864,7 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
             if (t_currently_rule->alert_opts & DO_LOGALERT) {
                 os_calloc(1, sizeof(Eventinfo), lf_cpy);
                 w_copy_event_for_log(lf, lf_cpy);
+                lf_cpy->trace_time = trace_time ? w_latency_now() : 0;
                 if (queue_push_ex_block(writer_queue_log, lf_cpy) < 0) {
                     Free_Eventinfo(lf_cpy);
                 }
@@ -2128,6 +2904,7 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
                 } else {
                     lf->sid_node_to_delete = node;
                 }
+                OS_AddCorrelationEvent(t_currently_rule, lf);
                 w_mutex_unlock(&t_currently_rule->mutex);
             }
             /* Group list */
@@ -2157,6 +2934,9 @@ void * w_process_event_thread(__attribute__((unused)) void * id){
 
         } while ((rulenode_pt = rulenode_pt->next) != NULL);
 
+        /* The event may already be in the last events list: use the local copy of its trace */
+        w_add_event_latency(LATENCY_RULES, trace_time);
+
         if (Config.logall || Config.logall_json){
             if (!lf_logall) {
                 os_calloc(1, sizeof(Eventinfo), lf_logall);
@@ -2185,6 +2965,7 @@ void * w_log_rotate_thread(__attribute__((unused)) void * args){
     int year = 0;
     struct tm tm_result = { .tm_sec = 0 };
     char mon[4] = {0};
+    time_t last_sync = time(NULL);
 
     while(1){
         time(&current_time);
@@ -2231,56 +3012,68 @@ void * w_log_rotate_thread(__attribute__((unused)) void * args){
 
         OS_RotateLogs(day, year, mon);
         w_mutex_unlock(&writer_threads_mutex);
+
+        /* Durability policy: the files are only closed by this thread, so they are synced out of the lock */
+        if (Config.fsync_interval && c_time - last_sync >= Config.fsync_interval) {
+            OS_SyncLogs();
+            last_sync = c_time;
+        }
+
         sleep(1);
     }
 }
 
 void * w_writer_log_statistical_thread(__attribute__((unused)) void * args ){
     Eventinfo *lf = NULL;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
 
     while(1){
-        /* Receive message from queue */
-        if (lf = queue_pop_ex(writer_queue_log_statistical), lf) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(writer_queue_log_statistical, batch, AD_QUEUE_BATCH_SIZE);
 
-            w_mutex_lock(&writer_threads_mutex);
-            w_inc_stats_written();
+        w_mutex_lock(&writer_threads_mutex);
 
-            if (Config.custom_alert_output) {
-                __crt_ftell = ftell(_aflog);
-                OS_CustomLog(lf, Config.custom_alert_output_format);
-            } else if (Config.alerts_log) {
-                __crt_ftell = ftell(_aflog);
-                OS_Log(lf, _aflog);
-            } else if (Config.jsonout_output) {
-                __crt_ftell = ftell(_jflog);
-            }
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            lf = batch[batch_pos];
+            w_inc_stats_written();
 
-            /* Log to json file */
-            if (Config.jsonout_output) {
-                jsonout_output_event(lf);
+            if (Config.instance) {
+                w_forward_alert(lf);
+            } else {
+                w_write_alert(lf);
             }
 
-            w_mutex_unlock(&writer_threads_mutex);
-
             Free_Eventinfo(lf);
         }
+
+        w_mutex_unlock(&writer_threads_mutex);
+        queue_done(writer_queue_log_statistical, batch_len);
     }
 }
 
 void * w_writer_log_firewall_thread(__attribute__((unused)) void * args ){
     Eventinfo *lf = NULL;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
 
     while(1){
-        /* Receive message from queue */
-        if (lf = queue_pop_ex(writer_queue_log_firewall), lf) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(writer_queue_log_firewall, batch, AD_QUEUE_BATCH_SIZE);
 
-            w_mutex_lock(&writer_threads_mutex);
+        w_mutex_lock(&writer_threads_mutex);
+
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            lf = batch[batch_pos];
             w_inc_firewall_written(lf->agent_id);
             FW_Log(lf);
-            w_mutex_unlock(&writer_threads_mutex);
-
             Free_Eventinfo(lf);
         }
+
+        w_mutex_unlock(&writer_threads_mutex);
+        queue_done(writer_queue_log_firewall, batch_len);
     }
 }
 
@@ -2295,37 +3088,49 @@ void w_log_flush(){
         jsonout_output_archive_flush();
     }
 
-    /* Flush alerts.json */
-    if (Config.jsonout_output) {
+    /* Flush alerts.json. The additional instances don't open the alerts files */
+    if (Config.jsonout_output && _jflog) {
         jsonout_output_event_flush();
     }
 
-    if (Config.custom_alert_output) {
+    if (Config.custom_alert_output && _aflog) {
         OS_CustomLog_Flush();
     }
 
-    if (Config.alerts_log) {
+    if (Config.alerts_log && _aflog) {
         OS_Log_Flush();
     }
 
+    /* Flush firewall.log */
+    if (Config.logfw) {
+        FW_Log_Flush();
+    }
+
     FTS_Flush();
 
 }
 
 void * w_writer_log_fts_thread(__attribute__((unused)) void * args ){
     char * line;
+    void * batch[AD_QUEUE_BATCH_SIZE];
+    size_t batch_len;
+    size_t batch_pos;
 
     while(1){
-        /* Receive message from queue */
-        if (line = queue_pop_ex(writer_queue_log_fts), line) {
+        /* Receive messages from queue */
+        batch_len = queue_pop_batch_ex(writer_queue_log_fts, batch, AD_QUEUE_BATCH_SIZE);
 
-            w_mutex_lock(&writer_threads_mutex);
+        w_mutex_lock(&writer_threads_mutex);
+
+        for (batch_pos = 0; batch_pos < batch_len; batch_pos++) {
+            line = batch[batch_pos];
             w_inc_fts_written();
             FTS_Fprintf(line);
-            w_mutex_unlock(&writer_threads_mutex);
-
             free(line);
         }
+
+        w_mutex_unlock(&writer_threads_mutex);
+        queue_done(writer_queue_log_fts, batch_len);
     }
 }
 
@@ -2363,14 +3168,55 @@ void w_init_queues(){
     /* Init the decode winevt queue input */
     decode_queue_winevt_input = queue_init(getDefine_Int("analysisd", "decode_winevt_queue_size", 128, 2000000));
 
-    /* Init the decode event queue input */
-    decode_queue_event_input = queue_init(getDefine_Int("analysisd", "decode_event_queue_size", 128, 2000000));
+    /* Init the decode event queue input, the classes with locations take their reserve */
+    {
+        size_t queue_size = getDefine_Int("analysisd", "decode_event_queue_size", 128, 2000000);
+        size_t sizes[EVENT_PRIORITY_CLASSES] = { 0 };
+        unsigned int weights[EVENT_PRIORITY_CLASSES];
+
+        for (int i = 0; i < EVENT_PRIORITY_CLASSES; i++) {
+            if (Config.priority[i].location) {
+                sizes[i] = queue_size * Config.priority[i].reserve / 100;
+
+                // A buffer of a single slot holds nothing, its events go to the normal class
+                if (sizes[i] < 2) {
+                    mwarn("The %s priority class reserves no room in the events queue, its events will be queued as normal ones.",
+                          i == EVENT_PRIORITY_HIGH ? "high" : "low");
+                    OSMatch_FreePattern(Config.priority[i].location);
+                    os_free(Config.priority[i].location);
+                    sizes[i] = 0;
+                }
+            }
+            weights[i] = Config.priority[i].weight;
+        }
+
+        sizes[EVENT_PRIORITY_NORMAL] = queue_size - sizes[EVENT_PRIORITY_HIGH] - sizes[EVENT_PRIORITY_LOW];
+        decode_queue_event_input = prio_queue_init(sizes, weights);
 
-    /* Init the decode event queue output */
-    decode_queue_event_output = queue_init(getDefine_Int("analysisd", "decode_output_queue_size", 128, 2000000));
+        mdebug1("Events queue classes: high=%zu normal=%zu low=%zu", sizes[EVENT_PRIORITY_HIGH], sizes[EVENT_PRIORITY_NORMAL], sizes[EVENT_PRIORITY_LOW]);
+    }
 
-    /* Initialize database synchronization message queue */
-    dispatch_dbsync_input = queue_init(getDefine_Int("analysisd", "dbsync_queue_size", 128, 2000000));
+    /* Init the decode event queue output, or a queue per shard */
+    if (num_rule_matching_shards > 0) {
+        os_calloc(num_rule_matching_shards, sizeof(w_queue_t *), decode_queue_event_shards);
+
+        for (int i = 0; i < num_rule_matching_shards; i++) {
+            decode_queue_event_shards[i] = queue_init(getDefine_Int("analysisd", "decode_output_queue_size", 128, 2000000));
+        }
+    } else {
+        decode_queue_event_output = queue_init(getDefine_Int("analysisd", "decode_output_queue_size", 128, 2000000));
+    }
+
+    /* Initialize database synchronization message queue, or a queue per shard */
+    if (num_dispatch_dbsync_shards > 0) {
+        os_calloc(num_dispatch_dbsync_shards, sizeof(w_queue_t *), dispatch_dbsync_shards);
+
+        for (int i = 0; i < num_dispatch_dbsync_shards; i++) {
+            dispatch_dbsync_shards[i] = queue_init(getDefine_Int("analysisd", "dbsync_queue_size", 128, 2000000));
+        }
+    } else {
+        dispatch_dbsync_input = queue_init(getDefine_Int("analysisd", "dbsync_queue_size", 128, 2000000));
+    }
 
     /* Initialize upgrade module message queue */
     upgrade_module_input = queue_init(getDefine_Int("analysisd", "upgrade_queue_size", 128, 2000000));
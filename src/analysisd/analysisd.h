@@ -49,6 +49,18 @@ extern ListNode *os_analysisd_cdblists;
  */
 extern ListRule *os_analysisd_cdbrules;
 
+/* Maximum number of elements taken from a queue per lock acquisition */
+#define AD_QUEUE_BATCH_SIZE 64
+
+/* Fill percentage from which a decode queue gets help from the shared decoding threads */
+#define DECODE_SHARED_BACKLOG 25
+
+/* Batches a shared decoding thread takes from a queue before choosing again */
+#define DECODE_SHARED_RUNS 16
+
+/* Wait of an idle shared decoding thread before checking the queues again (microseconds) */
+#define DECODE_SHARED_IDLE 100000
+
 /* Archives writer queue */
 extern w_queue_t * writer_queue;
 
@@ -76,18 +88,24 @@ extern w_queue_t * decode_queue_sca_input;
 /* Decode hostinfo input queue */
 extern w_queue_t * decode_queue_hostinfo_input;
 
-/* Decode event input queue */
-extern w_queue_t * decode_queue_event_input;
+/* Decode event input queue, a class per priority */
+extern w_prio_queue_t * decode_queue_event_input;
 
 /* Decode pending event output */
 extern w_queue_t * decode_queue_event_output;
 
+/* Decode pending event output, sharded by agent (rule_matching_shards) */
+extern w_queue_t ** decode_queue_event_shards;
+
 /* Decode windows event input queue */
 extern w_queue_t * decode_queue_winevt_input;
 
 /* Database synchronization input queue */
 extern w_queue_t * dispatch_dbsync_input;
 
+/* Database synchronization input, sharded by agent (dbsync_shards) */
+extern w_queue_t ** dispatch_dbsync_shards;
+
 /* Upgrade module decoder  */
 extern w_queue_t * upgrade_module_input;
 
@@ -103,6 +121,8 @@ void w_init_queues();
 
 extern OSHash *fim_agentinfo;
 extern int num_rule_matching_threads;
+extern int num_rule_matching_shards;
+extern int num_dispatch_dbsync_shards;
 
 #define FIM_MAX_WAZUH_DB_ATTEMPS 5
 #define SYS_MAX_WAZUH_DB_ATTEMPS 5
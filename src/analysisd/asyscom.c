@@ -20,6 +20,7 @@
 #include "analysisd.h"
 #include "state.h"
 #include "config.h"
+#include "ruleset.h"
 
 typedef enum _error_codes {
     ERROR_OK = 0,
@@ -33,7 +34,9 @@ typedef enum _error_codes {
     ERROR_INVALID_AGENTS,
     ERROR_EMPTY_AGENTS,
     ERROR_EMPTY_LASTID,
-    ERROR_TOO_MANY_AGENTS
+    ERROR_TOO_MANY_AGENTS,
+    ERROR_RELOAD_RULESET,
+    ERROR_PROFILE_DISABLED
 } error_codes;
 
 const char * error_messages[] = {
@@ -48,7 +51,9 @@ const char * error_messages[] = {
     [ERROR_INVALID_AGENTS] = "Invalid agents parameter",
     [ERROR_EMPTY_AGENTS] = "Error getting agents from DB",
     [ERROR_EMPTY_LASTID] = "Empty last id",
-    [ERROR_TOO_MANY_AGENTS] = "Too many agents"
+    [ERROR_TOO_MANY_AGENTS] = "Too many agents",
+    [ERROR_RELOAD_RULESET] = "Unable to reload the ruleset",
+    [ERROR_PROFILE_DISABLED] = "Ruleset profiling is disabled"
 };
 
 /**
@@ -101,6 +106,7 @@ STATIC size_t asyscom_dispatch(char* request, char** output) {
     int *agents_ids;
     int count;
     int sock = -1;
+    unsigned int generation;
 
     if (request_json = cJSON_ParseWithOpts(request, &json_err, 0), !request_json) {
         *output = asyscom_output_builder(ERROR_INVALID_INPUT, error_messages[ERROR_INVALID_INPUT], NULL);
@@ -163,6 +169,25 @@ STATIC size_t asyscom_dispatch(char* request, char** output) {
             } else {
                 *output = asyscom_output_builder(ERROR_EMPTY_PARAMATERS, error_messages[ERROR_EMPTY_PARAMATERS], NULL);
             }
+        } else if (strcmp(command_json->valuestring, "reload") == 0) {
+            if (generation = w_ruleset_reload(), generation > 0) {
+                cJSON *ruleset_json = cJSON_CreateObject();
+                cJSON_AddNumberToObject(ruleset_json, "generation", generation);
+                *output = asyscom_output_builder(ERROR_OK, error_messages[ERROR_OK], ruleset_json);
+            } else {
+                *output = asyscom_output_builder(ERROR_RELOAD_RULESET, error_messages[ERROR_RELOAD_RULESET], NULL);
+            }
+        } else if (strcmp(command_json->valuestring, "getprofile") == 0) {
+            if (Config.profile_ruleset) {
+                cJSON *limit_json = cJSON_GetObjectItem(cJSON_GetObjectItem(request_json, "parameters"), "limit");
+                unsigned int limit = cJSON_IsNumber(limit_json) && limit_json->valueint > 0 ? limit_json->valueint : 0;
+                w_ruleset_t *ruleset = w_ruleset_acquire();
+
+                *output = asyscom_output_builder(ERROR_OK, error_messages[ERROR_OK], ruleset ? w_profile_report(ruleset, limit) : NULL);
+                w_ruleset_release(ruleset);
+            } else {
+                *output = asyscom_output_builder(ERROR_PROFILE_DISABLED, error_messages[ERROR_PROFILE_DISABLED], NULL);
+            }
         } else {
             *output = asyscom_output_builder(ERROR_UNRECOGNIZED_COMMAND, error_messages[ERROR_UNRECOGNIZED_COMMAND], NULL);
         }
@@ -200,6 +225,9 @@ STATIC cJSON* asyscom_getconfig(const char* section) {
     else if (strcmp(section, "labels") == 0) {
         return getManagerLabelsConfig();
     }
+    else if (strcmp(section, "drop_filters") == 0) {
+        return getDropFiltersConfig();
+    }
     else if (strcmp(section, "rule_test") == 0) {
         return getRuleTestConfig();
     }
@@ -214,10 +242,13 @@ void * asyscom_main(__attribute__((unused)) void * arg) {
     ssize_t length;
     fd_set fdset;
 
+    char path_buffer[PATH_MAX];
+    const char * path = w_analysisd_instance_path(ANLSYS_LOCAL_SOCK, path_buffer, sizeof(path_buffer));
+
     mdebug1("Local requests thread ready");
 
-    if (sock = OS_BindUnixDomain(ANLSYS_LOCAL_SOCK, SOCK_STREAM, OS_MAXSTR), sock < 0) {
-        merror("Unable to bind to socket '%s': (%d) '%s'", ANLSYS_LOCAL_SOCK, errno, strerror(errno));
+    if (sock = OS_BindUnixDomain(path, SOCK_STREAM, OS_MAXSTR), sock < 0) {
+        merror("Unable to bind to socket '%s': (%d) '%s'", path, errno, strerror(errno));
         return NULL;
     }
 
@@ -59,14 +59,11 @@ int cdb_read(struct cdb *c, char *buf, unsigned int len, uint32 pos)
         }
         memcpy(buf, c->map + pos, len);
     } else {
-        if (lseek(c->fd, pos, SEEK_SET) == -1) {
-            return -1;
-        }
-        /* if (seek_set(c->fd,pos) == -1) return -1; */
+        /* pread does not move the file offset, so readers can share the fd */
         while (len > 0) {
-            int r;
+            ssize_t r;
             do {
-                r = read(c->fd, buf, len);
+                r = pread(c->fd, buf, len, pos);
             } while ((r == -1) && (errno == EINTR));
             if (r == -1) {
                 return -1;
@@ -75,6 +72,7 @@ int cdb_read(struct cdb *c, char *buf, unsigned int len, uint32 pos)
                 goto FORMAT;
             }
             buf += r;
+            pos += r;
             len -= r;
         }
     }
@@ -85,7 +83,7 @@ FORMAT:
     return -1;
 }
 
-static int match(struct cdb *c, char *key, unsigned int len, uint32 pos)
+static int match(struct cdb *c, const char *key, unsigned int len, uint32 pos)
 {
     char buf[32];
     unsigned int n;
@@ -178,3 +176,58 @@ int cdb_find(struct cdb *c, char *key, unsigned int len)
     cdb_findstart(c);
     return cdb_findnext(c, key, len);
 }
+
+int cdb_find_r(struct cdb *c, const char *key, unsigned int len, uint32 *dpos, uint32 *dlen)
+{
+    char buf[8];
+    uint32 hpos;
+    uint32 hslots;
+    uint32 khash;
+    uint32 kpos;
+    uint32 loop;
+    uint32 pos;
+    uint32 u;
+
+    khash = cdb_hash((char *)key, len);
+    if (cdb_read(c, buf, 8, (khash << 3) & 2047) == -1) {
+        return -1;
+    }
+    uint32_unpack(buf + 4, &hslots);
+    if (!hslots) {
+        return 0;
+    }
+    uint32_unpack(buf, &hpos);
+    kpos = hpos + (((khash >> 8) % hslots) << 3);
+
+    for (loop = 0; loop < hslots; loop++) {
+        if (cdb_read(c, buf, 8, kpos) == -1) {
+            return -1;
+        }
+        uint32_unpack(buf + 4, &pos);
+        if (!pos) {
+            return 0;
+        }
+        kpos += 8;
+        if (kpos == hpos + (hslots << 3)) {
+            kpos = hpos;
+        }
+        uint32_unpack(buf, &u);
+        if (u == khash) {
+            if (cdb_read(c, buf, 8, pos) == -1) {
+                return -1;
+            }
+            uint32_unpack(buf, &u);
+            if (u == len) {
+                switch (match(c, key, len, pos + 8)) {
+                    case -1:
+                        return -1;
+                    case 1:
+                        uint32_unpack(buf + 4, dlen);
+                        *dpos = pos + 8 + len;
+                        return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -36,6 +36,11 @@ extern void cdb_findstart(struct cdb *);
 extern int cdb_findnext(struct cdb *, char *, unsigned int);
 extern int cdb_find(struct cdb *, char *, unsigned int);
 
+/* Reentrant lookup: the data position and length are returned in dpos and
+ * dlen instead of being stored in the cdb, so no lock is needed.
+ */
+extern int cdb_find_r(struct cdb *, const char *, unsigned int, uint32 *dpos, uint32 *dlen);
+
 #define cdb_datapos(c) ((c)->dpos)
 #define cdb_datalen(c) ((c)->dlen)
 
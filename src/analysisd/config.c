@@ -63,6 +63,13 @@ int GlobalConf(const char *cfgfile)
     Config.eps.maximum = EPS_LIMITS_MIN_EPS;
     Config.eps.timeframe = 0;
 
+    /* Priority classes are only reserved when they have locations */
+    Config.priority[EVENT_PRIORITY_HIGH].reserve = 20;
+    Config.priority[EVENT_PRIORITY_HIGH].weight = 4;
+    Config.priority[EVENT_PRIORITY_NORMAL].weight = 2;
+    Config.priority[EVENT_PRIORITY_LOW].reserve = 20;
+    Config.priority[EVENT_PRIORITY_LOW].weight = 1;
+
     /* Default actions -- only log above level 1 */
     Config.mailbylevel = 7;
     Config.logbylevel  = 1;
@@ -99,6 +106,15 @@ int GlobalConf(const char *cfgfile)
 
     Config.min_rotate_interval = getDefine_Int("analysisd", "min_rotate_interval", 10, 86400);
 
+    /* Rotated logs are only compressed when monitord would compress them at the end of the day */
+    Config.compress_rotated = getDefine_Int("analysisd", "compress_rotated", 0, 1) && getDefine_Int("monitord", "compress", 0, 1);
+
+    Config.log_buffer_size = (size_t)getDefine_Int("analysisd", "log_buffer_size", 0, 65536) * 1024;
+    Config.fsync_interval = getDefine_Int("analysisd", "fsync_interval", 0, 3600);
+    Config.latency_sample = getDefine_Int("analysisd", "latency_sample", 0, 1000000);
+    Config.profile_ruleset = getDefine_Int("analysisd", "profile_ruleset", 0, 1);
+    Config.decode_unused_fields = getDefine_Int("analysisd", "decode_unused_fields", 0, 1);
+
     /* Minimum memory size */
     if (Config.memorysize < 2048) {
         Config.memorysize = 2048;
@@ -166,6 +182,27 @@ cJSON *getGlobalConfig(void) {
     cJSON_AddNumberToObject(eps, "maximum", Config.eps.maximum);
     cJSON_AddNumberToObject(eps, "timeframe", Config.eps.timeframe);
     cJSON_AddItemToObject(global, "eps", eps);
+    cJSON *priority = cJSON_CreateObject();
+    const char *priority_names[EVENT_PRIORITY_CLASSES] = { "high", "normal", "low" };
+    unsigned int reserve[EVENT_PRIORITY_CLASSES] = { 0 };
+    for (i = 0; i < EVENT_PRIORITY_CLASSES; i++) {
+        reserve[i] = Config.priority[i].location ? Config.priority[i].reserve : 0;
+    }
+    reserve[EVENT_PRIORITY_NORMAL] = 100 - reserve[EVENT_PRIORITY_HIGH] - reserve[EVENT_PRIORITY_LOW];
+    for (i = 0; i < EVENT_PRIORITY_CLASSES; i++) {
+        cJSON *class = cJSON_CreateObject();
+        if (Config.priority[i].location) {
+            cJSON *locations = cJSON_CreateArray();
+            for (char **pattern = Config.priority[i].location->patterns; pattern && *pattern; pattern++) {
+                cJSON_AddItemToArray(locations, cJSON_CreateString(*pattern));
+            }
+            cJSON_AddItemToObject(class, "location", locations);
+        }
+        cJSON_AddNumberToObject(class, "reserve", reserve[i]);
+        cJSON_AddNumberToObject(class, "weight", Config.priority[i].weight);
+        cJSON_AddItemToObject(priority, priority_names[i], class);
+    }
+    cJSON_AddItemToObject(global, "priority", priority);
 
 #ifdef LIBGEOIP_ENABLED
     if (Config.geoip_db_path) cJSON_AddStringToObject(global, "geoip_db_path", Config.geoip_db_path);
@@ -263,6 +300,7 @@ cJSON *getAnalysisInternalOptions(void) {
     cJSON_AddNumberToObject(analysisd, "stats_percent_diff", percent_diff);
     cJSON_AddNumberToObject(analysisd, "fts_list_size", fts_list_size);
     cJSON_AddNumberToObject(analysisd, "fts_min_size_for_str", fts_minsize_for_str);
+    cJSON_AddNumberToObject(analysisd, "fts_store_max_size", fts_store_max_size);
     cJSON_AddNumberToObject(analysisd, "log_fw", Config.logfw);
     cJSON_AddNumberToObject(analysisd, "decoder_order_size", Config.decoder_order_size);
     cJSON_AddNumberToObject(analysisd, "label_cache_maxage", Config.label_cache_maxage);
@@ -311,6 +349,21 @@ cJSON *getRulesConfig(void) {
 }
 
 
+cJSON *getDropFiltersConfig(void) {
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON *list = cJSON_CreateArray();
+
+    if (os_analysisd_rulelist) {
+        _getDropFiltersJSON(os_analysisd_rulelist, list);
+    }
+
+    cJSON_AddItemToObject(root, "drop_filters", list);
+
+    return root;
+}
+
+
 cJSON *getManagerLabelsConfig(void) {
 
     cJSON *root = cJSON_CreateObject();
@@ -331,3 +384,12 @@ cJSON *getManagerLabelsConfig(void) {
 
     return root;
 }
+
+const char * w_analysisd_instance_path(const char * path, char * buffer, size_t size) {
+    if (Config.instance == 0) {
+        return path;
+    }
+
+    snprintf(buffer, size, "%s-%d", path, Config.instance);
+    return buffer;
+}
@@ -30,6 +30,18 @@ extern GeoIP *geoipdb;
 
 int GlobalConf(const char *cfgfile);
 
+/**
+ * @brief Get the path of a file or socket of this analysisd instance
+ *
+ * The additional instances append their number to the paths of the main one.
+ *
+ * @param path Path used by the main instance.
+ * @param buffer Buffer for the path of an additional instance.
+ * @param size Size of the buffer.
+ * @return The path itself in the main instance, or the buffer.
+ */
+const char * w_analysisd_instance_path(const char * path, char * buffer, size_t size);
+
 // Read config
 cJSON *getGlobalConfig(void);
 cJSON *getARManagerConfig(void);
@@ -38,6 +50,8 @@ cJSON *getAlertsConfig(void);
 cJSON *getDecodersConfig(void);
 void _getDecodersListJSON(OSDecoderNode *list, cJSON *array);
 cJSON *getRulesConfig(void);
+cJSON *getDropFiltersConfig(void);
+void _getDropFiltersJSON(RuleNode *list, cJSON *array);
 void _getRulesListJSON(RuleNode *list, cJSON *array);
 cJSON *getAnalysisInternalOptions(void);
 cJSON *getManagerLabelsConfig(void);
@@ -74,7 +74,7 @@ void _getDecodersListJSON(OSDecoderNode *list, cJSON *array) {
                 else if (node->osdecoder->order[i] == SystemName_FP) {
                     cJSON_AddItemToArray(_list,cJSON_CreateString("system_name"));
                 }
-                else if (node->osdecoder->order[i] == DynamicField_FP) {
+                else if (node->osdecoder->order[i] == DynamicField_FP || node->osdecoder->order[i] == UnusedField_FP) {
                     cJSON_AddItemToArray(_list,cJSON_CreateString(node->osdecoder->fields[i]));
                 }
             }
@@ -187,6 +187,100 @@ void _getDecodersListJSON(OSDecoderNode *list, cJSON *array) {
 }
 
 
+/* Check whether the agents can drop the events of a rule marked with agent_drop.
+ * It must be a level 0 root rule, with no rule depending on it, and its only conditions
+ * must be a location and a match that the agents can test on the pre-decoded log. */
+static bool _ruleAgentDroppable(const RuleNode *node, bool root) {
+
+    const RuleInfo *rule = node->ruleinfo;
+    const w_expression_t * conditions[] = { rule->location, rule->match };
+    unsigned i;
+
+    if (rule->level != 0 || !root || node->child || (!rule->location && !rule->match)) {
+        return false;
+    }
+
+    /* Every parent, or decoder condition, is one the agents can't test */
+    if (rule->if_sid || rule->if_group || rule->if_level || rule->decoded_as || rule->category != SYSLOG) {
+        return false;
+    }
+
+    /* Correlation rules need to see the events, as the rules referencing them */
+    if (rule->if_matched_sid || rule->if_matched_group || rule->if_matched_regex || rule->frequency ||
+        rule->sid_prev_matched || rule->group_prev_matched || rule->sid_correlated_sz) {
+        return false;
+    }
+
+    if (rule->regex || rule->srcip || rule->dstip || rule->srcgeoip || rule->dstgeoip ||
+        rule->srcport || rule->dstport || rule->user || rule->url || rule->id || rule->status ||
+        rule->hostname || rule->program_name || rule->data || rule->extra_data ||
+        rule->system_name || rule->protocol || rule->action || rule->fields || rule->lists ||
+        rule->day_time || rule->week_day || rule->event_search) {
+        return false;
+    }
+
+    for (i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++) {
+        if (conditions[i] && (conditions[i]->negate || conditions[i]->exp_type == EXP_TYPE_STRING ||
+                              conditions[i]->exp_type == EXP_TYPE_OSIP_ARRAY)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static cJSON * _getDropFilterExpressionJSON(w_expression_t *expression) {
+
+    cJSON *object = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(object, "pattern", w_expression_get_regex_pattern(expression));
+    cJSON_AddStringToObject(object, "type", w_expression_get_regex_type(expression));
+
+    return object;
+}
+
+
+static void _getDropFiltersTreeJSON(RuleNode *list, cJSON *array, bool root) {
+
+    RuleNode *node = NULL;
+
+    for (node = list; node; node = node->next) {
+        if (node->child) {
+            _getDropFiltersTreeJSON(node->child, array, false);
+        }
+
+        if (!(node->ruleinfo->alert_opts & AGENT_DROP)) {
+            continue;
+        }
+
+        if (!_ruleAgentDroppable(node, root)) {
+            mdebug1("Rule %d can't be dropped by the agents: it must be a root rule of level 0, "
+                    "not referenced by other rules, with only location and match conditions.", node->ruleinfo->sigid);
+            continue;
+        }
+
+        cJSON *filter = cJSON_CreateObject();
+        cJSON_AddNumberToObject(filter, "rule", node->ruleinfo->sigid);
+
+        if (node->ruleinfo->location) {
+            cJSON_AddItemToObject(filter, "location", _getDropFilterExpressionJSON(node->ruleinfo->location));
+        }
+
+        if (node->ruleinfo->match) {
+            cJSON_AddItemToObject(filter, "match", _getDropFilterExpressionJSON(node->ruleinfo->match));
+        }
+
+        cJSON_AddItemToArray(array, filter);
+    }
+}
+
+
+void _getDropFiltersJSON(RuleNode *list, cJSON *array) {
+    _getDropFiltersTreeJSON(list, array, true);
+}
+
+
 void _getRulesListJSON(RuleNode *list, cJSON *array) {
 
     RuleNode *node = NULL;
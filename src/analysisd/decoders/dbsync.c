@@ -28,6 +28,10 @@ extern void mock_assert(const int result, const char* const expression,
     mock_assert((int)(expression), #expression, __FILE__, __LINE__);
 #endif
 
+static void dispatch_send_query(dbsync_context_t * ctx, const char * query) {
+    wdbc_pipeline_send(&ctx->db_sock, &ctx->pipeline, query);
+}
+
 static void dispatch_send_local(dbsync_context_t * ctx, const char * query) {
     int sock;
 
@@ -128,6 +132,9 @@ static void dispatch_check(dbsync_context_t * ctx, const char * command) {
         goto end;
     }
 
+    // The answer depends on this response: read the pending ones first
+    wdbc_pipeline_recv(&ctx->db_sock, &ctx->pipeline, 0);
+
     switch (wdbc_query_ex(&ctx->db_sock, query, response, OS_MAXSTR)) {
     case -2:
         merror("dbsync: Cannot communicate with database.");
@@ -167,42 +174,20 @@ static void dispatch_state(dbsync_context_t * ctx) {
 
     char * data_plain = cJSON_PrintUnformatted(ctx->data);
     char * query;
-    char * response;
-    char * arg;
 
     os_malloc(OS_MAXSTR, query);
-    os_malloc(OS_MAXSTR, response);
 
     if (snprintf(query, OS_MAXSTR, "agent %s %s save2 %s", ctx->agent_id, ctx->component, data_plain) >= OS_MAXSTR) {
         merror("dbsync: Cannot build save query: input is too long.");
         goto end;
     }
 
-    switch (wdbc_query_ex(&ctx->db_sock, query, response, OS_MAXSTR)) {
-    case -2:
-        merror("dbsync: Cannot communicate with database.");
-        goto end;
-    case -1:
-        merror("dbsync: Cannot get response from database.");
-        goto end;
-    }
-
-    switch (wdbc_parse_result(response, &arg)) {
-    case WDBC_OK:
-        break;
-    case WDBC_ERROR:
-        if (strcmp(arg, "Agent not found") != 0) {
-            merror("dbsync: Bad response from database: %s", arg);
-        }
-        // Fallthrough
-    default:
-        goto end;
-    }
+    // The response is only checked for errors, it's read later
+    dispatch_send_query(ctx, query);
 
 end:
     free(data_plain);
     free(query);
-    free(response);
 }
 
 static void dispatch_clear(dbsync_context_t * ctx) {
@@ -213,42 +198,26 @@ static void dispatch_clear(dbsync_context_t * ctx) {
 
     char * data_plain = cJSON_PrintUnformatted(ctx->data);
     char * query;
-    char * response;
-    char * arg;
 
     os_malloc(OS_MAXSTR, query);
-    os_malloc(OS_MAXSTR, response);
 
     if (snprintf(query, OS_MAXSTR, "agent %s %s integrity_clear %s", ctx->agent_id, ctx->component, data_plain) >= OS_MAXSTR) {
         merror("dbsync: Cannot build clear query: input is too long.");
         goto end;
     }
 
-    switch (wdbc_query_ex(&ctx->db_sock, query, response, OS_MAXSTR)) {
-    case -2:
-        merror("dbsync: Cannot communicate with database.");
-        goto end;
-    case -1:
-        merror("dbsync: Cannot get response from database.");
-        goto end;
-    }
-
-    switch (wdbc_parse_result(response, &arg)) {
-    case WDBC_OK:
-        break;
-    case WDBC_ERROR:
-        if (strcmp(arg, "Agent not found") != 0) {
-            merror("dbsync: Bad response from database: %s", arg);
-        }
-        // Fallthrough
-    default:
-        goto end;
-    }
+    // The response is only checked for errors, it's read later
+    dispatch_send_query(ctx, query);
 
 end:
     free(data_plain);
     free(query);
-    free(response);
+}
+
+void DispatchDBSyncFlush(dbsync_context_t * ctx) {
+    assert(ctx != NULL);
+
+    wdbc_pipeline_recv(&ctx->db_sock, &ctx->pipeline, 0);
 }
 
 void DispatchDBSync(dbsync_context_t * ctx, Eventinfo * lf) {
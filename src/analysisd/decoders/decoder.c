@@ -14,13 +14,68 @@
 #include "eventinfo.h"
 #include "decoder.h"
 #include "config.h"
+#include "ruleset.h"
 
 
+/* Get the next parent marked as candidate, starting at *pos */
+static OSDecoderNode *OS_NextDecoderCandidate(const OSDecoderIndex *index, const unsigned char *candidates,
+                                              unsigned int *pos)
+{
+    const unsigned char *next;
+
+    if (*pos >= index->size) {
+        return NULL;
+    }
+
+    next = memchr(candidates + *pos, 1, index->size - *pos);
+    if (!next) {
+        *pos = index->size;
+        return NULL;
+    }
+
+    *pos = (unsigned int)(next - candidates) + 1;
+    return index->nodes[*pos - 1];
+}
+
+/* Evaluate an expression of a decoder, accounting its time when profiling */
+static bool OS_DecoderExpressionMatch(OSDecoderInfo *decoder, w_expression_t *expression, const char *str,
+                                      const char **end, regex_matching *decoder_match)
+{
+    uint64_t start;
+    bool matches;
+
+    if (!Config.profile_ruleset) {
+        return w_expression_match_spans(expression, str, end, decoder_match);
+    }
+
+    start = w_profile_now();
+    matches = w_expression_match_spans(expression, str, end, decoder_match);
+    w_profile_add(&decoder->profile.regex_ns, start);
+    w_profile_add(&decoder->profile.total_ns, start);
+
+    return matches;
+}
+
+/* Account a decoder tried on the event when profiling */
+static void OS_DecoderTried(OSDecoderInfo *decoder, bool matched)
+{
+    if (Config.profile_ruleset) {
+        decoder->profile.evaluations++;
+
+        if (matched) {
+            decoder->profile.matches++;
+        }
+    }
+}
+
 /* Use the osdecoders to decode the received event */
 void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *decoder_match, OSDecoderNode *node)
 {
     OSDecoderNode *child_node;
     OSDecoderInfo *nnode;
+    const OSDecoderIndex *index = NULL;
+    unsigned char candidates[DECODER_INDEX_MAX_PARENTS];
+    unsigned int pos = 0;
 
     const char *llog = NULL;
     const char *pmatch = NULL;
@@ -38,12 +93,20 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
     }
 #endif
 
-    do {
+    /* Only try the parents that may match the event */
+    if (node->index && OS_GetDecoderCandidates(node->index, lf, candidates)) {
+        index = node->index;
+        node = OS_NextDecoderCandidate(index, candidates, &pos);
+    }
+
+    for (; node; node = index ? OS_NextDecoderCandidate(index, candidates, &pos) : node->next) {
         nnode = node->osdecoder;
+        lf->decoders_tried++;
 
         /* First check program name */
         if (lf->program_name) {
-            if (!w_expression_match(nnode->program_name, lf->program_name, NULL, decoder_match)) {
+            if (!OS_DecoderExpressionMatch(nnode, nnode->program_name, lf->program_name, NULL, decoder_match)) {
+                OS_DecoderTried(nnode, false);
                 continue;
             }
             pmatch = lf->log;
@@ -51,7 +114,8 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
 
         /* If prematch fails, go to the next osdecoder in the list */
         if (nnode->prematch) {
-            if (!w_expression_match(nnode->prematch, lf->log, &pmatch, decoder_match)) {
+            if (!OS_DecoderExpressionMatch(nnode, nnode->prematch, lf->log, &pmatch, decoder_match)) {
+                OS_DecoderTried(nnode, false);
                 continue;
             }
 
@@ -67,6 +131,7 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
         }
 #endif
 
+        OS_DecoderTried(nnode, true);
         lf->decoder_info = nnode;
         lf->log_after_prematch = pmatch;
         child_node = node->child;
@@ -97,19 +162,23 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
                         llog2 = lf->log;
                     }
 
-                    if (w_expression_match(nnode->prematch, llog2, &cmatch, decoder_match)) {
+                    if (OS_DecoderExpressionMatch(nnode, nnode->prematch, llog2, &cmatch, decoder_match)) {
 
                         if (*cmatch != '\0') {
                             cmatch++;
                         }
 
+                        OS_DecoderTried(nnode, true);
                         lf->decoder_info = nnode;
                         lf->log_after_parent = pmatch;
                         lf->log_after_prematch = cmatch;
 
                         break;
                     }
+
+                    OS_DecoderTried(nnode, false);
                 } else {
+                    OS_DecoderTried(nnode, true);
                     cmatch = pmatch;
                     break;
                 }
@@ -144,7 +213,13 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
         while (child_node) {
             /* If we have an external decoder, execute it */
             if (nnode->plugindecoder) {
-                nnode->plugindecoder(lf, rules_hash, decoder_match);
+                if (Config.profile_ruleset) {
+                    uint64_t start = w_profile_now();
+                    nnode->plugindecoder(lf, rules_hash, decoder_match);
+                    w_profile_add(&nnode->profile.total_ns, start);
+                } else {
+                    nnode->plugindecoder(lf, rules_hash, decoder_match);
+                }
             } else if (nnode->regex) {
                 int i;
 
@@ -172,7 +247,7 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
                 }
 
                 /* If Regex does not match, return */
-                if (!w_expression_match(nnode->regex, llog, &result, decoder_match)) {
+                if (!OS_DecoderExpressionMatch(nnode, nnode->regex, llog, &result, decoder_match)) {
                     if (nnode->get_next) {
                         child_node = child_node->next;
                         nnode = child_node->osdecoder;
@@ -193,14 +268,30 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
                     return;
                 }
 
-                for (i = 0; decoder_match->sub_strings[i]; i++) {
-                    if (nnode->order[i])
-                        nnode->order[i](lf, decoder_match->sub_strings[i], nnode->fields[i]);
-                    else
-                        /* We do not free any memory used above */
-                        free(decoder_match->sub_strings[i]);
+                if (decoder_match->spans) {
+                    /* OSRegex captures: only the stored fields are copied */
+                    for (i = 0; decoder_match->spans[2 * i] && decoder_match->spans[2 * i + 1]; i++) {
+                        if (nnode->order[i] && nnode->order[i] != UnusedField_FP) {
+                            const size_t length = decoder_match->spans[2 * i + 1] - decoder_match->spans[2 * i];
+                            char *field;
+
+                            os_malloc(length + 1, field);
+                            memcpy(field, decoder_match->spans[2 * i], length);
+                            field[length] = '\0';
 
-                    decoder_match->sub_strings[i] = NULL;
+                            nnode->order[i](lf, field, nnode->fields[i]);
+                        }
+                    }
+                } else {
+                    for (i = 0; decoder_match->sub_strings[i]; i++) {
+                        if (nnode->order[i])
+                            nnode->order[i](lf, decoder_match->sub_strings[i], nnode->fields[i]);
+                        else
+                            /* We do not free any memory used above */
+                            free(decoder_match->sub_strings[i]);
+
+                        decoder_match->sub_strings[i] = NULL;
+                    }
                 }
             } else {
                 /* If we don't have a regex, we may leave now */
@@ -218,7 +309,7 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
 
         /* ok to return  */
         return;
-    } while ((node = node->next) != NULL);
+    }
 
 #ifdef TESTRULE
     if (!alert_only) {
@@ -230,10 +321,85 @@ void DecodeEvent(struct _Eventinfo *lf, OSHash *rules_hash, regex_matching *deco
 
 /* Find index of a dynamic field. Returns NULL if not found. */
 
+/* Case-insensitive FNV-1a hash of a field name */
+static unsigned int w_field_hash(const char *key) {
+    unsigned int hash = 2166136261u;
+
+    for (; *key != '\0'; key++) {
+        hash = (hash ^ (unsigned char)tolower((unsigned char)*key)) * 16777619u;
+    }
+
+    return hash;
+}
+
+bool w_field_used(const Eventinfo *lf, const char *key) {
+    char name[OS_SIZE_256];
+    size_t i;
+
+    if (lf->ruleset == NULL || lf->ruleset->fields_used == NULL) {
+        return true;
+    }
+
+    for (i = 0; key[i] != '\0'; i++) {
+        if (i == sizeof(name) - 1) {
+            return true;
+        }
+
+        name[i] = (char)tolower((unsigned char)key[i]);
+    }
+
+    name[i] = '\0';
+
+    return OSHash_Get(lf->ruleset->fields_used, name) != NULL;
+}
+
+void w_field_index_add(Eventinfo *lf) {
+    const char *key;
+    unsigned int slot;
+    u_int32_t entry;
+
+    /* Only a contiguous prefix of the fields is indexed */
+    if (lf->field_index == NULL || lf->field_indexed != lf->nfields - 1) {
+        return;
+    }
+
+    key = lf->fields[lf->field_indexed].key;
+
+    for (slot = w_field_hash(key) & (lf->field_index_size - 1);
+         entry = lf->field_index[slot], (entry >> 16) == lf->field_index_gen;
+         slot = (slot + 1) & (lf->field_index_size - 1)) {
+
+        /* A repeated name keeps pointing to its first field */
+        if (!strcasecmp(lf->fields[(entry & 0xFFFF) - 1].key, key)) {
+            lf->field_indexed++;
+            return;
+        }
+    }
+
+    lf->field_index[slot] = (u_int32_t)lf->field_index_gen << 16 | (u_int32_t)(lf->field_indexed + 1);
+    lf->field_indexed++;
+}
+
 const char* FindField(const Eventinfo *lf, const char *key) {
-    int i;
+    int i = 0;
+
+    if (lf->field_index != NULL && lf->field_indexed > 0) {
+        unsigned int slot;
+        u_int32_t entry;
 
-    for (i = 0; i < lf->nfields; i++)
+        for (slot = w_field_hash(key) & (lf->field_index_size - 1);
+             entry = lf->field_index[slot], (entry >> 16) == lf->field_index_gen;
+             slot = (slot + 1) & (lf->field_index_size - 1)) {
+
+            if (!strcasecmp(lf->fields[(entry & 0xFFFF) - 1].key, key)) {
+                return lf->fields[(entry & 0xFFFF) - 1].value;
+            }
+        }
+
+        i = lf->field_indexed;
+    }
+
+    for (; i < lf->nfields; i++)
         if (!strcasecmp(lf->fields[i].key, key))
             return lf->fields[i].value;
 
@@ -457,5 +623,13 @@ void *DynamicField_FP(Eventinfo *lf, char *field, const char *order)
 
     os_strdup(order, lf->fields[lf->nfields].key);
     lf->fields[lf->nfields++].value = field;
+    w_field_index_add(lf);
+    return (NULL);
+}
+
+/* Dynamic field that no rule reads, see OS_SkipUnusedDecodersFields() */
+void *UnusedField_FP(__attribute__((unused)) Eventinfo *lf, char *field, __attribute__((unused)) const char *order)
+{
+    os_free(field);
     return (NULL);
 }
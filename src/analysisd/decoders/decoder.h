@@ -12,8 +12,10 @@
 #define DECODER_H
 
 #include "shared.h"
+#include "wazuhdb_op.h"
 #include "../logmsg.h"
 #include "expression.h"
+#include "../profile.h"
 
 #define AFTER_PARENT    0x001   /* 1   */
 #define AFTER_PREMATCH  0x002   /* 2   */
@@ -72,19 +74,69 @@ typedef struct {
     void* (**order)(struct _Eventinfo *, char *, const char *);
 
     bool internal_saving;      ///< Used to free decoderinfo structure in wazuh-logtest
+    w_profile_t profile;       ///< Cost of the decoder, updated when the ruleset profiling is enabled
 } OSDecoderInfo;
 
+/* Parent decoder index limits */
+#define DECODER_INDEX_MIN_PARENTS   8
+#define DECODER_INDEX_MAX_PARENTS   8192
+
+/**
+ * @brief Literal-prefix trie node of a decoder index
+ *
+ * Keys are stored in lower case, the same way OSMatch and OSRegex compare.
+ */
+typedef struct _OSDecoderTrie {
+    unsigned int n_children;
+    unsigned char *bytes;               ///< Byte of each child, sorted
+    struct _OSDecoderTrie **children;   ///< Child of each byte
+    unsigned int n_prefix;
+    unsigned int *prefix;               ///< Parents whose subject must start with this key
+    unsigned int n_exact;
+    unsigned int *exact;                ///< Parents whose subject must be this key
+} OSDecoderTrie;
+
+/**
+ * @brief Literal keys indexed over one event field
+ */
+typedef struct _OSDecoderKeys {
+    OSDecoderTrie *anchored;            ///< Prefix and exact keys
+    bool has_literals;                  ///< True if literals have any key
+    OSMultiMatch literals;              ///< Substring keys, identified by parent position
+} OSDecoderKeys;
+
+/**
+ * @brief Candidate index over the parent decoders of a list
+ *
+ * Each parent is keyed by literals that its program_name (or, if that can't
+ * be indexed, its prematch) requires. Parents that can't be keyed are always
+ * candidates. Candidates are still tried in their original order.
+ */
+typedef struct _OSDecoderIndex {
+    unsigned int size;                  ///< Number of parents
+    struct _OSDecoderNode **nodes;      ///< Parents in list order
+    unsigned char *fallback;            ///< Parents that are always candidates (one byte per parent)
+    unsigned int n_program_name;        ///< Number of parents keyed by program_name
+    OSDecoderKeys program_name;         ///< Keys over the event program_name
+    OSDecoderKeys log;                  ///< Keys over the event log
+} OSDecoderIndex;
+
 /* List structure */
 typedef struct _OSDecoderNode {
     struct _OSDecoderNode *next;
     struct _OSDecoderNode *child;
     OSDecoderInfo *osdecoder;
+    OSDecoderIndex *index;      ///< Parent candidate index, only set on the first node of a list
 } OSDecoderNode;
 
+// Queries sent to wazuh-db before waiting for the oldest response
+#define DBSYNC_PIPELINE_SIZE 64
+
 typedef struct dbsync_context_t {
     // Persistent data (per dispatcher)
     int db_sock;
     int ar_sock;
+    wdbc_pipeline pipeline; // Queries sent to wazuh-db whose response hasn't been read
     // Ephimeral data (per message)
     char * agent_id;
     char * component;
@@ -143,13 +195,6 @@ extern OSDecoderNode *os_analysisd_decoderlist_pn;
  */
 extern OSDecoderNode *os_analysisd_decoderlist_nopn;
 
-/**
- * @brief Hash to save data which have the same id
- *
- * Only for Analysisd use
- */
-extern OSHash *os_analysisd_acm_store;
-
 /**
  * @brief Decoder list to save internals decoders
  */
@@ -193,6 +238,13 @@ int getDecoderfromlist(const char *name, OSStore **decoder_store);
 
 char *GetGeoInfobyIP(char *ip_addr);
 
+/**
+ * @brief Get the GeoIP lookup cache counters
+ * @param hits Lookups answered by the cache
+ * @param misses Lookups that queried the database
+ */
+void GeoIP_CacheStats(uint64_t *hits, uint64_t *misses);
+
 /**
  * @brief Add internal decoders to decoder_list and set ids to xml decoders
  * @param log_msg list to save log messages.
@@ -246,6 +298,48 @@ void os_remove_decoders_list(OSDecoderNode *decoderlist_pn, OSDecoderNode *decod
  */
 void os_remove_decodernode(OSDecoderNode *node, OSDecoderInfo **decoders, int *pos, int *max_size);
 
+/**
+ * @brief Build the parent candidate index of a decoder list
+ *
+ * Lists with less than DECODER_INDEX_MIN_PARENTS parents are not indexed.
+ * A previous index is rebuilt.
+ * @param list first node of the decoder list
+ */
+void OS_BuildDecoderIndex(OSDecoderNode *list);
+
+/**
+ * @brief Add the dynamic fields read by the FTS of a decoder list to a hash
+ *
+ * The names are added in lower case.
+ * @param fields hash of field names
+ * @param list first node of the decoder list
+ */
+void OS_AddDecodersFields(OSHash *fields, OSDecoderNode *list);
+
+/**
+ * @brief Stop storing the dynamic fields of a decoder list that are not in a hash
+ *
+ * Their order is set to UnusedField_FP, so their captures are not copied.
+ * @param fields hash of the field names read by the ruleset, in lower case
+ * @param list first node of the decoder list
+ */
+void OS_SkipUnusedDecodersFields(const OSHash *fields, OSDecoderNode *list);
+
+/**
+ * @brief Get the parent decoders of an index that may match an event
+ * @param index decoder index
+ * @param lf event to decode
+ * @param candidates array of index->size bytes. Position i is set to 1 if parent i must be tried
+ * @return true on success; false if every parent must be tried
+ */
+bool OS_GetDecoderCandidates(const OSDecoderIndex *index, const struct _Eventinfo *lf, unsigned char *candidates);
+
+/**
+ * @brief Remove a decoder index
+ * @param index index to remove
+ */
+void os_remove_decoder_index(OSDecoderIndex *index);
+
 /**
  * @brief Count the number of decoders in a list
  * @param node the first node of the list
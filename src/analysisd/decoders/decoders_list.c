@@ -17,6 +17,7 @@
 #include "error_messages/error_messages.h"
 #include "error_messages/debug_messages.h"
 #include "analysisd.h"
+#include "eventinfo.h"
 
 #ifdef WAZUH_UNIT_TESTING
 // Remove STATIC qualifier from tests
@@ -30,6 +31,19 @@ OSDecoderNode *os_analysisd_decoderlist_nopn;
 OSStore *os_analysisd_decoder_store;
 
 STATIC OSDecoderNode *_OS_AddOSDecoder(OSDecoderNode *s_node, OSDecoderInfo *pi, OSList* log_msg);
+STATIC OSDecoderIndex *_OS_BuildDecoderIndex(OSDecoderNode *list);
+STATIC bool _OS_AddDecoderKeys(OSDecoderKeys *keys, const w_expression_t *expression, unsigned int pos);
+STATIC bool _OS_AddDecoderKey(OSDecoderKeys *keys, const char *literal, size_t size, int kind, unsigned int pos);
+STATIC void _OS_GetKeyCandidates(const OSDecoderKeys *keys, const char *str, unsigned char *candidates);
+STATIC void _OS_RemoveDecoderTrie(OSDecoderTrie *node);
+
+/* Kinds of decoder index keys */
+#define DECODER_KEY_PREFIX      0
+#define DECODER_KEY_EXACT       1
+#define DECODER_KEY_SUBSTRING   2
+
+/* Lower case the same way OSMatch and OSRegex do */
+#define KEY_LOWER(c) ((unsigned char)(((c) >= 'A' && (c) <= 'Z') ? (c) + ('a' - 'A') : (c)))
 
 /* Create the Event List */
 void OS_CreateOSDecoderList() {
@@ -241,6 +255,7 @@ void os_remove_decodernode(OSDecoderNode *node, OSDecoderInfo **decoders, int *p
             (*pos)++;
         }
 
+        os_remove_decoder_index(tmp_node->index);
         os_free(tmp_node);
     }
 }
@@ -258,3 +273,353 @@ void os_count_decoders(OSDecoderNode *node, int *num_decoders) {
         node = node->next;
     }
 }
+
+void OS_BuildDecoderIndex(OSDecoderNode *list) {
+
+    if (!list) {
+        return;
+    }
+
+    os_remove_decoder_index(list->index);
+    list->index = _OS_BuildDecoderIndex(list);
+}
+
+void OS_AddDecodersFields(OSHash *fields, OSDecoderNode *list) {
+
+    OSDecoderNode *node;
+    OSDecoderInfo *decoder;
+    int i;
+
+    for (node = list; node; node = node->next) {
+        decoder = node->osdecoder;
+
+        for (i = 0; decoder->fields && decoder->fts_fields && i < Config.decoder_order_size; i++) {
+            if (decoder->fts_fields[i] && decoder->fields[i]) {
+                OSHash_Add_ins(fields, decoder->fields[i], decoder);
+            }
+        }
+
+        OS_AddDecodersFields(fields, node->child);
+    }
+}
+
+void OS_SkipUnusedDecodersFields(const OSHash *fields, OSDecoderNode *list) {
+
+    OSDecoderNode *node;
+    OSDecoderInfo *decoder;
+    int i;
+
+    for (node = list; node; node = node->next) {
+        decoder = node->osdecoder;
+
+        for (i = 0; decoder->order && decoder->fields && i < Config.decoder_order_size; i++) {
+            if (decoder->order[i] == DynamicField_FP && !OSHash_Get_ins(fields, decoder->fields[i])) {
+                decoder->order[i] = UnusedField_FP;
+            }
+        }
+
+        OS_SkipUnusedDecodersFields(fields, node->child);
+    }
+}
+
+STATIC OSDecoderIndex *_OS_BuildDecoderIndex(OSDecoderNode *list) {
+
+    OSDecoderIndex *index = NULL;
+    OSDecoderNode *node;
+    unsigned int size = 0;
+    unsigned int pos;
+
+    for (node = list; node; node = node->next) {
+        size++;
+    }
+
+    if (size < DECODER_INDEX_MIN_PARENTS || size > DECODER_INDEX_MAX_PARENTS) {
+        return NULL;
+    }
+
+    os_calloc(1, sizeof(OSDecoderIndex), index);
+    os_calloc(size, sizeof(OSDecoderNode *), index->nodes);
+    os_calloc(size, sizeof(unsigned char), index->fallback);
+    os_calloc(1, sizeof(OSDecoderTrie), index->program_name.anchored);
+    os_calloc(1, sizeof(OSDecoderTrie), index->log.anchored);
+    OSMultiMatch_Init(&index->program_name.literals);
+    OSMultiMatch_Init(&index->log.literals);
+    index->size = size;
+
+    for (node = list, pos = 0; node; node = node->next, pos++) {
+        OSDecoderInfo *pi = node->osdecoder;
+
+        index->nodes[pos] = node;
+
+        /* The program name is checked first, so its keys are preferred */
+        if (pi->program_name && _OS_AddDecoderKeys(&index->program_name, pi->program_name, pos)) {
+            index->n_program_name++;
+        } else if (!pi->prematch || !_OS_AddDecoderKeys(&index->log, pi->prematch, pos)) {
+            index->fallback[pos] = 1;
+        }
+    }
+
+    if ((index->program_name.has_literals && !OSMultiMatch_Compile(&index->program_name.literals)) ||
+        (index->log.has_literals && !OSMultiMatch_Compile(&index->log.literals))) {
+        mdebug1("Could not build the literal index for decoder '%s'", list->osdecoder->name);
+        os_remove_decoder_index(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Add the literal keys that an expression requires to an index
+ *
+ * Only affirmative osmatch and osregex expressions are indexed. Every
+ * alternative must yield a key: the literal an osmatch alternative is made
+ * of, or the literal an osregex alternative starts with.
+ *
+ * @param keys keys to update
+ * @param expression expression to get the keys from
+ * @param pos position of the parent in the index
+ * @return true if the parent can only match when one of its keys is found, false otherwise
+ */
+STATIC bool _OS_AddDecoderKeys(OSDecoderKeys *keys, const w_expression_t *expression, unsigned int pos) {
+
+    const char *raw;
+    int round;
+
+    if (expression->negate) {
+        return false;
+    }
+
+    if (expression->exp_type == EXP_TYPE_OSMATCH && expression->match && !expression->match->negate) {
+        raw = expression->match->raw;
+    } else if (expression->exp_type == EXP_TYPE_OSREGEX && expression->regex) {
+        raw = expression->regex->raw;
+    } else {
+        return false;
+    }
+
+    if (!raw || *raw == '!') {
+        return false;
+    }
+
+    /* The first round only validates the alternatives, the second one adds them */
+    for (round = 0; round < 2; round++) {
+        const char *pt = raw;
+        bool last = false;
+
+        while (!last) {
+            const char *begin = pt;
+            const char *end;
+            bool anchored = false;
+            bool whole = true;
+            int kind;
+
+            if (*pt == '^') {
+                anchored = true;
+                begin = ++pt;
+            }
+
+            if (expression->exp_type == EXP_TYPE_OSMATCH) {
+                while (*pt != '\0' && *pt != '|') {
+                    pt++;
+                }
+            } else {
+                /* Stop at the first operator */
+                while (*pt != '\0' && *pt != '|' && *pt != '\\' && *pt != '(' && *pt != ')') {
+                    pt++;
+                }
+                whole = (*pt == '\0' || *pt == '|');
+            }
+
+            end = pt;
+
+            if (whole && end > begin && *(end - 1) == '$') {
+                end--;
+                kind = anchored ? DECODER_KEY_EXACT : DECODER_KEY_SUBSTRING;
+            } else {
+                kind = anchored ? DECODER_KEY_PREFIX : DECODER_KEY_SUBSTRING;
+            }
+
+            /* An empty key matches any string */
+            if (end == begin && kind != DECODER_KEY_EXACT) {
+                return false;
+            }
+
+            if (round == 1 && !_OS_AddDecoderKey(keys, begin, (size_t)(end - begin), kind, pos)) {
+                return false;
+            }
+
+            /* Skip the rest of the alternative */
+            while (*pt != '\0' && *pt != '|') {
+                pt += (*pt == '\\' && *(pt + 1) != '\0') ? 2 : 1;
+            }
+
+            if (*pt == '|') {
+                pt++;
+            } else {
+                last = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add one literal key to an index
+ *
+ * @param keys keys to update
+ * @param literal key (any case)
+ * @param size length of the key
+ * @param kind DECODER_KEY_PREFIX, DECODER_KEY_EXACT or DECODER_KEY_SUBSTRING
+ * @param pos position of the parent in the index
+ * @return true on success, false otherwise
+ */
+STATIC bool _OS_AddDecoderKey(OSDecoderKeys *keys, const char *literal, size_t size, int kind, unsigned int pos) {
+
+    OSDecoderTrie *node = keys->anchored;
+    size_t i;
+
+    if (kind == DECODER_KEY_SUBSTRING) {
+        if (!OSMultiMatch_AddPattern(&keys->literals, literal, size, (int)pos)) {
+            return false;
+        }
+        keys->has_literals = true;
+        return true;
+    }
+
+    for (i = 0; i < size; i++) {
+        unsigned char byte = KEY_LOWER((unsigned char)literal[i]);
+        unsigned int j;
+
+        /* Children are kept sorted by byte */
+        for (j = 0; j < node->n_children && node->bytes[j] < byte; j++);
+
+        if (j == node->n_children || node->bytes[j] != byte) {
+            os_realloc(node->bytes, (node->n_children + 1) * sizeof(unsigned char), node->bytes);
+            os_realloc(node->children, (node->n_children + 1) * sizeof(OSDecoderTrie *), node->children);
+            memmove(node->bytes + j + 1, node->bytes + j, node->n_children - j);
+            memmove(node->children + j + 1, node->children + j, (node->n_children - j) * sizeof(OSDecoderTrie *));
+            node->bytes[j] = byte;
+            os_calloc(1, sizeof(OSDecoderTrie), node->children[j]);
+            node->n_children++;
+        }
+
+        node = node->children[j];
+    }
+
+    if (kind == DECODER_KEY_EXACT) {
+        os_realloc(node->exact, (node->n_exact + 1) * sizeof(unsigned int), node->exact);
+        node->exact[node->n_exact++] = pos;
+    } else {
+        os_realloc(node->prefix, (node->n_prefix + 1) * sizeof(unsigned int), node->prefix);
+        node->prefix[node->n_prefix++] = pos;
+    }
+
+    return true;
+}
+
+bool OS_GetDecoderCandidates(const OSDecoderIndex *index, const Eventinfo *lf, unsigned char *candidates) {
+
+    /* Without program name, DecodeEvent does not check it at all */
+    if (!lf->program_name && index->n_program_name > 0) {
+        return false;
+    }
+
+    memcpy(candidates, index->fallback, index->size);
+
+    if (lf->program_name) {
+        _OS_GetKeyCandidates(&index->program_name, lf->program_name, candidates);
+    }
+
+    if (lf->log) {
+        _OS_GetKeyCandidates(&index->log, lf->log, candidates);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Mark the parents whose keys are found in a string
+ *
+ * @param keys keys to search
+ * @param str event field
+ * @param candidates candidates array to update
+ */
+STATIC void _OS_GetKeyCandidates(const OSDecoderKeys *keys, const char *str, unsigned char *candidates) {
+
+    const OSDecoderTrie *node = keys->anchored;
+    const char *pt = str;
+    unsigned int i;
+
+    while (node) {
+        unsigned int low = 0;
+        unsigned int high = node->n_children;
+        unsigned char byte;
+
+        for (i = 0; i < node->n_prefix; i++) {
+            candidates[node->prefix[i]] = 1;
+        }
+
+        if (*pt == '\0') {
+            for (i = 0; i < node->n_exact; i++) {
+                candidates[node->exact[i]] = 1;
+            }
+            break;
+        }
+
+        byte = KEY_LOWER((unsigned char)*pt);
+        pt++;
+
+        /* Binary search of the next byte */
+        while (low < high) {
+            unsigned int mid = (low + high) / 2;
+
+            if (node->bytes[mid] < byte) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        node = (low < node->n_children && node->bytes[low] == byte) ? node->children[low] : NULL;
+    }
+
+    if (keys->has_literals) {
+        OSMultiMatch_Execute(str, &keys->literals, candidates);
+    }
+}
+
+void os_remove_decoder_index(OSDecoderIndex *index) {
+
+    if (!index) {
+        return;
+    }
+
+    _OS_RemoveDecoderTrie(index->program_name.anchored);
+    _OS_RemoveDecoderTrie(index->log.anchored);
+    OSMultiMatch_FreePattern(&index->program_name.literals);
+    OSMultiMatch_FreePattern(&index->log.literals);
+    os_free(index->nodes);
+    os_free(index->fallback);
+    os_free(index);
+}
+
+STATIC void _OS_RemoveDecoderTrie(OSDecoderTrie *node) {
+
+    unsigned int i;
+
+    if (!node) {
+        return;
+    }
+
+    for (i = 0; i < node->n_children; i++) {
+        _OS_RemoveDecoderTrie(node->children[i]);
+    }
+
+    os_free(node->bytes);
+    os_free(node->children);
+    os_free(node->prefix);
+    os_free(node->exact);
+    os_free(node);
+}
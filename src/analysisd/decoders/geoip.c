@@ -25,24 +25,180 @@
 #include "GeoIP.h"
 #include "GeoIPCity.h"
 
+#define GEOIP_CACHE_SHARDS      16      /* Power of two */
+#define GEOIP_CACHE_SHARD_SIZE  4096    /* Entries per shard */
+
+/* Cached result of a lookup, NULL geodata caches an unknown IP */
+typedef struct _geoip_cache_entry {
+    char *ip;
+    char *geodata;
+    struct _geoip_cache_entry *prev;
+    struct _geoip_cache_entry *next;
+} geoip_cache_entry;
+
+/* Each shard is an LRU list: the most recently used entry goes first */
+typedef struct _geoip_cache_shard {
+    pthread_mutex_t mutex;
+    OSHash *entries;
+    geoip_cache_entry *first;
+    geoip_cache_entry *last;
+    unsigned int count;
+    uint64_t hits;
+    uint64_t misses;
+} geoip_cache_shard;
+
+static geoip_cache_shard geoip_cache[GEOIP_CACHE_SHARDS];
+static pthread_once_t geoip_cache_once = PTHREAD_ONCE_INIT;
+
+static char *GeoIP_Lookup(const char *ip_addr);
+
+
+static void GeoIP_CacheInit(void)
+{
+    int i;
+
+    for (i = 0; i < GEOIP_CACHE_SHARDS; i++) {
+        w_mutex_init(&geoip_cache[i].mutex, NULL);
+        geoip_cache[i].entries = OSHash_Create();
+    }
+}
+
+static geoip_cache_shard *GeoIP_CacheShard(const char *ip_addr)
+{
+    unsigned int hash = 2166136261u;
+
+    for (; *ip_addr; ip_addr++) {
+        hash = (hash ^ (unsigned char)*ip_addr) * 16777619u;
+    }
+
+    return &geoip_cache[hash & (GEOIP_CACHE_SHARDS - 1)];
+}
+
+static void GeoIP_CacheUnlink(geoip_cache_shard *shard, geoip_cache_entry *entry)
+{
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        shard->first = entry->next;
+    }
+
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        shard->last = entry->prev;
+    }
+
+    entry->prev = entry->next = NULL;
+}
+
+static void GeoIP_CachePush(geoip_cache_shard *shard, geoip_cache_entry *entry)
+{
+    entry->next = shard->first;
+
+    if (shard->first) {
+        shard->first->prev = entry;
+    } else {
+        shard->last = entry;
+    }
+
+    shard->first = entry;
+}
+
+/* Store a result in the shard, dropping the least recently used entry if full */
+static void GeoIP_CacheAdd(geoip_cache_shard *shard, const char *ip_addr, const char *geodata)
+{
+    geoip_cache_entry *entry;
+
+    if (shard->count >= GEOIP_CACHE_SHARD_SIZE && (entry = shard->last)) {
+        GeoIP_CacheUnlink(shard, entry);
+        OSHash_Delete(shard->entries, entry->ip);
+        shard->count--;
+        os_free(entry->ip);
+        os_free(entry->geodata);
+        os_free(entry);
+    }
+
+    os_calloc(1, sizeof(geoip_cache_entry), entry);
+    os_strdup(ip_addr, entry->ip);
+    w_strdup(geodata, entry->geodata);
+
+    if (OSHash_Add(shard->entries, entry->ip, entry) != 2) {
+        os_free(entry->ip);
+        os_free(entry->geodata);
+        os_free(entry);
+        return;
+    }
+
+    GeoIP_CachePush(shard, entry);
+    shard->count++;
+}
 
 char *GetGeoInfobyIP(char *ip_addr)
 {
-    GeoIPRecord *geoiprecord;
+    geoip_cache_shard *shard;
+    geoip_cache_entry *entry;
     char *geodata = NULL;
-    char geobuffer[256 +1];
 
-    if(!geoipdb)
+    if(!geoipdb || !ip_addr)
     {
         return(NULL);
     }
 
-    if(!ip_addr)
-    {
-        return(NULL);
+    pthread_once(&geoip_cache_once, GeoIP_CacheInit);
+    shard = GeoIP_CacheShard(ip_addr);
+
+    w_mutex_lock(&shard->mutex);
+
+    if (shard->entries && (entry = OSHash_Get(shard->entries, ip_addr))) {
+        shard->hits++;
+        GeoIP_CacheUnlink(shard, entry);
+        GeoIP_CachePush(shard, entry);
+        w_strdup(entry->geodata, geodata);
+        w_mutex_unlock(&shard->mutex);
+        return(geodata);
     }
 
-    geoiprecord = GeoIP_record_by_name(geoipdb, (const char *)ip_addr);
+    shard->misses++;
+    w_mutex_unlock(&shard->mutex);
+
+    /* The database is looked up out of the lock, it's shared by all the threads */
+    geodata = GeoIP_Lookup(ip_addr);
+
+    w_mutex_lock(&shard->mutex);
+
+    if (shard->entries && !OSHash_Get(shard->entries, ip_addr)) {
+        GeoIP_CacheAdd(shard, ip_addr, geodata);
+    }
+
+    w_mutex_unlock(&shard->mutex);
+
+    return(geodata);
+}
+
+void GeoIP_CacheStats(uint64_t *hits, uint64_t *misses)
+{
+    int i;
+
+    *hits = 0;
+    *misses = 0;
+
+    pthread_once(&geoip_cache_once, GeoIP_CacheInit);
+
+    for (i = 0; i < GEOIP_CACHE_SHARDS; i++) {
+        w_mutex_lock(&geoip_cache[i].mutex);
+        *hits += geoip_cache[i].hits;
+        *misses += geoip_cache[i].misses;
+        w_mutex_unlock(&geoip_cache[i].mutex);
+    }
+}
+
+static char *GeoIP_Lookup(const char *ip_addr)
+{
+    GeoIPRecord *geoiprecord;
+    char *geodata = NULL;
+    char geobuffer[256 +1];
+
+    geoiprecord = GeoIP_record_by_name(geoipdb, ip_addr);
     if(geoiprecord == NULL)
     {
         return(NULL);
@@ -32,6 +32,8 @@ void *OSSECAlert_Decoder_Exec(Eventinfo *lf, OSHash *rules_hash, regex_matching
 /* Plugin for JSON */
 void *JSON_Decoder_Init(void);
 void *JSON_Decoder_Exec(Eventinfo *lf, regex_matching *decoder_match);
+/* Decode the fields of an already parsed JSON object */
+void JSON_Decoder_Read(cJSON *logJSON, Eventinfo *lf);
 void fillData(Eventinfo *lf, const char *key, const char *value);
 
 /* List of plugins. All three lists must be in the same order */
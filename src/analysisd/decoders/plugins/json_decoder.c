@@ -183,6 +183,10 @@ void fillData(Eventinfo *lf, const char *key, const char *value)
     }
 
     // Dynamic fields
+    if (!w_field_used(lf, key)) {
+        return;
+    }
+
     if (lf->nfields >= Config.decoder_order_size) {
         merror("Too many fields for JSON decoder.");
         return;
@@ -196,34 +200,58 @@ void fillData(Eventinfo *lf, const char *key, const char *value)
     os_strdup(key, lf->fields[lf->nfields].key);
     os_strdup(value, lf->fields[lf->nfields].value);
     lf->nfields++;
+    w_field_index_add(lf);
+
+}
+
+/* Buffers reused while the fields of an event are read */
+typedef struct json_read_t {
+    char *key;          ///< Flattened name of the current field ("a.b.c")
+    size_t key_size;    ///< Size of key
+    char *value;        ///< CSV string of the current array, OS_MAXSTR bytes
+} json_read_t;
+
+/* Append the name of an item to the name of its parent, which takes the first key_len bytes.
+ * Returns the length of the new name.
+ */
+static size_t setJSONKey(json_read_t *buffers, size_t key_len, const char *name)
+{
+    const size_t name_len = strlen(name);
+    const size_t size = key_len + name_len + 2;
 
+    if (size > buffers->key_size) {
+        os_realloc(buffers->key, size, buffers->key);
+        buffers->key_size = size;
+    }
+
+    if (key_len) {
+        buffers->key[key_len++] = '.';
+    }
+
+    memcpy(buffers->key + key_len, name, name_len + 1);
+    return key_len + name_len;
 }
 
-static void readJSON (cJSON *logJSON, char *parent, Eventinfo *lf)
+static void readJSON (cJSON *logJSON, json_read_t *buffers, size_t parent_len, Eventinfo *lf)
 {
     static const char * VALUE_NULL = "null";
     static const char * VALUE_TRUE = "true";
     static const char * VALUE_FALSE = "false";
     static const char * VALUE_COMMA = ",";
 
-    cJSON *next, *array;
-    char *key = NULL;
+    cJSON *array;
+    const char *key;
     char *value = NULL;
-    size_t  n;
+    char value_char[64];
+    size_t key_len;
 
-    while (logJSON) {
-        next = logJSON->next;
+    for (; logJSON; logJSON = logJSON->next) {
         if (logJSON->string) {
-            if (parent) {
-                n = strlen(parent);
-                os_calloc(n + strlen(logJSON->string) + 2, sizeof(char), key);
-                strcpy(key, parent);
-                key[n++] = '.';
-                strcpy(key + n, logJSON->string);
-            }
-            else {
-                os_strdup(logJSON->string, key);
-            }
+            key_len = setJSONKey(buffers, parent_len, logJSON->string);
+            key = buffers->key;
+        } else {
+            key_len = 0;
+            key = NULL;
         }
 
         switch ((logJSON->type)&255) {
@@ -234,20 +262,25 @@ static void readJSON (cJSON *logJSON, char *parent, Eventinfo *lf)
 
             case cJSON_Number:
                 if ((double)logJSON->valueint == logJSON->valuedouble){
-                    char value_char[64];
                     snprintf(value_char, 64, "%i", logJSON->valueint);
-                    fillData(lf, key, value_char);
                 }
                 else{
-                    char value_char[64];
                     snprintf(value_char, 64, "%f", logJSON->valuedouble);
-                    fillData(lf, key, value_char);
                 }
+                fillData(lf, key, value_char);
                 break;
 
             case cJSON_Array:
+                /* Values without a name are never stored */
+                if (!key) {
+                    break;
+                }
+
                 if (lf->decoder_info->flags & JSON_TREAT_ARRAY_AS_CSV_STRING) {
-                    os_malloc(OS_MAXSTR, value);
+                    if (!buffers->value) {
+                        os_malloc(OS_MAXSTR, buffers->value);
+                    }
+                    value = buffers->value;
                     *value = '\0';
                     size_t n = 0;
                     size_t z;
@@ -263,7 +296,6 @@ static void readJSON (cJSON *logJSON, char *parent, Eventinfo *lf)
                             }
                         }
                         else if (array->type == cJSON_Number) {
-                            char value_char[64];
                             z = (double)array->valueint == array->valuedouble ? snprintf(value_char, 64, "%i", array->valueint) : snprintf(value_char, 64, "%f", array->valuedouble);
 
                             if (n + z < OS_MAXSTR) {
@@ -320,15 +352,19 @@ static void readJSON (cJSON *logJSON, char *parent, Eventinfo *lf)
                             n += z;
                         }
                     }
+
+                    if (*value != '\0') {
+                        fillData(lf, key, value);
+                    }
                 } else if (lf->decoder_info->flags & JSON_TREAT_ARRAY_AS_ARRAY) {
                     value = cJSON_Print(logJSON);
-                }
 
-                if (value && *value != '\0') {
-                    fillData(lf, key, value);
-                }
+                    if (value && *value != '\0') {
+                        fillData(lf, key, value);
+                    }
 
-                os_free(value);
+                    os_free(value);
+                }
                 break;
 
             case cJSON_NULL:
@@ -346,15 +382,23 @@ static void readJSON (cJSON *logJSON, char *parent, Eventinfo *lf)
                 break;
 
             case cJSON_Object:
-                readJSON (logJSON->child, key, lf);
+                readJSON (logJSON->child, buffers, key_len, lf);
                 break;
 
         } // switch
-        logJSON = next;
-        free (key);
-        key = NULL;
-    } // while
+    } // for
+
+}
+
+/* Read the fields of a JSON event with one set of buffers for the whole tree */
+static void readJSONEvent(cJSON *logJSON, Eventinfo *lf)
+{
+    json_read_t buffers = { NULL, 0, NULL };
+
+    readJSON(logJSON, &buffers, 0, lf);
 
+    os_free(buffers.key);
+    os_free(buffers.value);
 }
 
 void *JSON_Decoder_Init()
@@ -363,6 +407,11 @@ void *JSON_Decoder_Init()
     return (NULL);
 }
 
+void JSON_Decoder_Read(cJSON *logJSON, Eventinfo *lf)
+{
+    readJSONEvent(logJSON, lf);
+}
+
 void *JSON_Decoder_Exec(Eventinfo *lf, __attribute__((unused)) regex_matching *decoder_match)
 {
     cJSON *logJSON;
@@ -395,7 +444,7 @@ void *JSON_Decoder_Exec(Eventinfo *lf, __attribute__((unused)) regex_matching *d
             mdebug2("Malformed JSON string '%s'", input);
         else
         {
-            readJSON (logJSON, NULL, lf);
+            readJSONEvent(logJSON, lf);
             cJSON_Delete (logJSON);
         }
     }
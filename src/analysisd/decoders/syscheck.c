@@ -85,8 +85,14 @@ static void fim_send_db_save(_sdb * sdb, const char * agent_id, cJSON * data);
 // Send delete query to Wazuh DB
 void fim_send_db_delete(_sdb * sdb, const char * agent_id, const char * path);
 
-// Send a query to Wazuh DB
-void fim_send_db_query(int * sock, const char * query);
+// Send a query to Wazuh DB without waiting for the response
+void fim_send_db_query(_sdb * sdb, const char * query);
+
+// Read all the pending responses from Wazuh DB
+void fim_db_flush(_sdb * sdb);
+
+// Set the start time of the last scan of an agent
+static void fim_set_scan_start(const char * agent_id, long timestamp);
 
 // Build change comment
 static size_t fim_generate_comment(char * str, long size, const char * format, const char * a1, const char * a2);
@@ -110,6 +116,9 @@ static void fim_adjust_checksum(sk_sum_t *newsum, char **checksum);
 */
 static char *perm_json_to_old_format(cJSON *perm_json);
 
+// Queries sent to Wazuh DB before waiting for the oldest response
+#define FIM_DB_PIPELINE_SIZE 64
+
 // Mutexes
 static pthread_mutex_t control_msg_mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -133,12 +142,15 @@ static fim_decoders_t *fim_decoders[] = {
     [REGISTRY_VALUE_DECODER] = &registry_value_decoders,
 };
 OSHash *fim_agentinfo;
+OSHash *fim_scan_start;
 
 // Initialize the necessary information to process the syscheck information
 // LCOV_EXCL_START
 int fim_init(void) {
     //Create hash table for agent information
     fim_agentinfo = OSHash_Create();
+    //Create hash table for the start time of the last scan
+    fim_scan_start = OSHash_Create();
     fim_decoders[FILE_DECODER]->add_id = getDecoderfromlist(FIM_NEW, &os_analysisd_decoder_store);
     fim_decoders[FILE_DECODER]->add_name = FIM_NEW;
     fim_decoders[FILE_DECODER]->modify_id = getDecoderfromlist(FIM_MOD, &os_analysisd_decoder_store);
@@ -157,7 +169,7 @@ int fim_init(void) {
     fim_decoders[REGISTRY_VALUE_DECODER]->modify_name = FIM_REG_VAL_MOD;
     fim_decoders[REGISTRY_VALUE_DECODER]->delete_id = getDecoderfromlist(FIM_REG_VAL_DEL, &os_analysisd_decoder_store);
     fim_decoders[REGISTRY_VALUE_DECODER]->delete_name = FIM_REG_VAL_DEL;
-    if (fim_agentinfo == NULL) return 0;
+    if (fim_agentinfo == NULL || fim_scan_start == NULL) return 0;
     return 1;
 }
 
@@ -165,6 +177,7 @@ int fim_init(void) {
 void sdb_init(_sdb *localsdb, OSDecoderInfo *fim_decoder) {
     localsdb->db_err = 0;
     localsdb->socket = -1;
+    localsdb->pipeline = (wdbc_pipeline) { .name = "FIM decoder", .size = FIM_DB_PIPELINE_SIZE };
 
     sdb_clean(localsdb);
 
@@ -280,6 +293,9 @@ int DecodeSyscheck(Eventinfo *lf, _sdb *sdb)
 
     sdb_clean(sdb);
 
+    // The queries below wait for their response: read the pending ones first
+    fim_db_flush(sdb);
+
     f_name = wstr_chr(lf->log, ' ');
     if (f_name == NULL) {
         mdebug2("Scan's control message agent '%s': '%s'", lf->log, lf->agent_id);
@@ -958,6 +974,10 @@ int fim_control_msg(char *key, time_t value, Eventinfo *lf, _sdb *sdb) {
             return db_result;
         }
 
+        if (strcmp(key, HC_FIM_DB_SS) == 0) {
+            fim_set_scan_start(lf->agent_id, value);
+        }
+
         // If end first scan store timestamp in a hash table
         w_mutex_lock(&control_msg_mutex);
         if(strcmp(key, HC_FIM_DB_EFS) == 0 || strcmp(key, HC_FIM_DB_ES) == 0 ||
@@ -1090,6 +1110,23 @@ int fim_get_scantime (long *ts, Eventinfo *lf, _sdb *sdb, const char* param) {
     char *response = NULL;
     char *output;
     int db_result;
+    long *start;
+
+    // The start time of the scans is kept to avoid asking the database
+    if (strcmp(param, "start_scan") == 0) {
+        w_mutex_lock(&control_msg_mutex);
+
+        if (start = (long *) OSHash_Get_ex(fim_scan_start, lf->agent_id), start) {
+            *ts = *start;
+        }
+
+        w_mutex_unlock(&control_msg_mutex);
+
+        if (start) {
+            mdebug2("Agent '%s' FIM %s '%ld'", lf->agent_id, param, *ts);
+            return (1);
+        }
+    }
 
     os_calloc(OS_SIZE_6144 + 1, sizeof(char), wazuhdb_query);
 
@@ -1122,12 +1159,36 @@ int fim_get_scantime (long *ts, Eventinfo *lf, _sdb *sdb, const char* param) {
     *(output++) = '\0';
     *ts = atol(output);
 
+    if (strcmp(param, "start_scan") == 0) {
+        fim_set_scan_start(lf->agent_id, *ts);
+    }
+
     mdebug2("Agent '%s' FIM %s '%ld'", lf->agent_id, param, *ts);
 
     os_free(wazuhdb_query);
     os_free(response);
     return (1);
 }
+
+void fim_set_scan_start(const char * agent_id, long timestamp) {
+    long *start;
+
+    w_mutex_lock(&control_msg_mutex);
+
+    if (start = (long *) OSHash_Get_ex(fim_scan_start, agent_id), start) {
+        *start = timestamp;
+    } else {
+        os_calloc(1, sizeof(long), start);
+        *start = timestamp;
+
+        if (OSHash_Add_ex(fim_scan_start, agent_id, start) != 2) {
+            os_free(start);
+            mdebug1("Unable to add the scan start time to hash table for agent: %s", agent_id);
+        }
+    }
+
+    w_mutex_unlock(&control_msg_mutex);
+}
 // LCOV_EXCL_STOP
 
 int decode_fim_event(_sdb *sdb, Eventinfo *lf) {
@@ -1408,7 +1469,7 @@ void fim_send_db_save(_sdb * sdb, const char * agent_id, cJSON * data) {
         goto end;
     }
 
-    fim_send_db_query(&sdb->socket, query);
+    fim_send_db_query(sdb, query);
 
 end:
     free(data_plain);
@@ -1423,40 +1484,16 @@ void fim_send_db_delete(_sdb * sdb, const char * agent_id, const char * path) {
         return;
     }
 
-    fim_send_db_query(&sdb->socket, query);
+    fim_send_db_query(sdb, query);
 }
 
-void fim_send_db_query(int * sock, const char * query) {
-    char * response;
-    char * arg;
-
-    os_malloc(OS_MAXSTR, response);
-
-    switch (wdbc_query_ex(sock, query, response, OS_MAXSTR)) {
-    case -2:
-        merror("FIM decoder: Cannot communicate with database.");
-        goto end;
-    case -1:
-        merror("FIM decoder: Cannot get response from database.");
-        goto end;
-    }
-
-    switch (wdbc_parse_result(response, &arg)) {
-    case WDBC_OK:
-        break;
-    case WDBC_ERROR:
-        if (strcmp(arg, "Agent not found") != 0) {
-            merror("FIM decoder: Bad response from database: %s", arg);
-        }
-        // Fallthrough
-    default:
-        goto end;
-    }
-
-end:
-    free(response);
+void fim_send_db_query(_sdb * sdb, const char * query) {
+    sdb->db_err += wdbc_pipeline_send(&sdb->socket, &sdb->pipeline, query);
 }
 
+void fim_db_flush(_sdb * sdb) {
+    sdb->db_err += wdbc_pipeline_recv(&sdb->socket, &sdb->pipeline, 0);
+}
 
 static int fim_generate_alert(Eventinfo *lf, syscheck_event_t event_type, cJSON *attributes, cJSON *old_attributes, cJSON *audit) {
     static const char *ENTRY_TYPE_FILE = "File";
@@ -1673,7 +1710,7 @@ void fim_process_scan_info(_sdb * sdb, const char * agent_id, fim_scan_event eve
         return;
     }
 
-    fim_send_db_query(&sdb->socket, query);
+    fim_send_db_query(sdb, query);
 }
 
 int fim_fetch_attributes(cJSON *new_attrs, cJSON *old_attrs, Eventinfo *lf) {
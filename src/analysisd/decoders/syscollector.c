@@ -21,6 +21,7 @@
 #include "buffer_op.h"
 #include <time.h>
 #include "wazuhdb_op.h"
+#include "wazuhdb_bin.h"
 #include "wazuh_db/wdb.h"
 
 #ifdef WAZUH_UNIT_TESTING
@@ -2116,18 +2117,28 @@ static int decode_dbsync(Eventinfo * lf,   /* Event information */
                     delta_map_values(type, data_object);                            /* Map field's values if applies */
                     char * operation = operation_object->valuestring;               /* Operation is the operation to be
                                                                                        performed in the table. */                    
-                    char * data = cJSON_PrintUnformatted(data_object);              /* Data is the JSON object with the
+                    char * data = NULL;                                             /* Data is the JSON object with the
                                                                                        values to be processed. */
-                    if (NULL != data) {
-                        const size_t data_len = strlen(data) + 1;                   /* Data length is the size of the
-                                                                                       data string. */
-                        char *response = NULL;                                      /* Response is the string that will
+                    char * response = NULL;                                         /* Response is the string that will
                                                                                        contain the response from
                                                                                        wazuh-db. */
-                        char * msg = NULL;                                          /* Message is the string that will
+                    char * msg = NULL;                                              /* Message is the string that will
                                                                                        be sent to wazuh-db. */
+                    ssize_t msg_len = OS_INVALID;                                   /* Length of the binary message. */
 
-                        os_calloc(OS_SIZE_1024, sizeof(char), response);
+                    if (Config.wdb_binary_protocol) {
+                        /* Binary encoding skips printing and parsing the data, deltas that don't fit go as text. */
+                        os_malloc(OS_MAXSTR, msg);
+                        msg_len = wdb_bin_encode_dbsync(msg, OS_MAXSTR, atoi(lf->agent_id), type, operation, data_object);
+
+                        if (msg_len < 0) {
+                            os_free(msg);
+                        }
+                    }
+
+                    if (NULL == msg && NULL != (data = cJSON_PrintUnformatted(data_object))) {
+                        const size_t data_len = strlen(data) + 1;                   /* Data length is the size of the
+                                                                                       data string. */
                         os_calloc(data_len + OS_SIZE_256, sizeof(char), msg);
                         snprintf(msg,
                                  data_len + OS_SIZE_256 - 1,
@@ -2137,10 +2148,18 @@ static int decode_dbsync(Eventinfo * lf,   /* Event information */
                                  operation,
                                  data);                                             /* Header size is the real size of
                                                                                        the header string. */
+                    }
+
+                    if (NULL != msg) {
+                        os_calloc(OS_SIZE_1024, sizeof(char), response);
 
                         fill_event_alert(lf, field_list, operation, data_object);
 
-                        ret_val = wdbc_query_ex(socket, msg, response, OS_SIZE_1024);
+                        if (msg_len >= 0) {
+                            ret_val = wdbc_query_bin_ex(socket, msg, msg_len, response, OS_SIZE_1024);
+                        } else {
+                            ret_val = wdbc_query_ex(socket, msg, response, OS_SIZE_1024);
+                        }
 
                         if (ret_val == 0) {
                             if (strncmp(response, "err", 3) == 0) {
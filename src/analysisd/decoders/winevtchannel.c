@@ -72,7 +72,13 @@ char *replace_win_format(char *str, int message){
     return result;
 }
 
-/* Special decoder for Windows eventchannel */
+/* Special decoder for Windows eventchannel
+ * The event XML is still walked with os_xml into a cJSON object, which is
+ * printed once for full_log and read directly by the JSON decoder. Writing
+ * the fields straight from the XML in one pass would have to replicate the
+ * category and audit policy lookups, the attribute-named Data items and the
+ * extra sections handled below, so it was left out.
+ */
 int DecodeWinevt(Eventinfo *lf){
     OS_XML xml;
     int xml_init = 0;
@@ -95,7 +101,6 @@ int DecodeWinevt(Eventinfo *lf){
     char *filtered_string = NULL;
     char *level = NULL;
     char *keywords = NULL;
-    char *msg_from_prov = NULL;
     char *returned_event = NULL;
     char *event = NULL;
     char *find_msg = NULL;
@@ -104,7 +109,6 @@ int DecodeWinevt(Eventinfo *lf){
     char *join_data2 = NULL;
     lf->decoder_info = winevt_decoder;
 
-    os_calloc(OS_MAXSTR, sizeof(char), msg_from_prov);
     os_calloc(OS_MAXSTR, sizeof(char), join_data);
 
     const char *jsonErrPtr;
@@ -723,7 +727,8 @@ int DecodeWinevt(Eventinfo *lf){
     lf->log = lf->full_log;
     lf->decoder_info = winevt_decoder;
 
-    JSON_Decoder_Exec(lf, NULL);
+    /* The fields are taken from the event built here, instead of parsing it again */
+    JSON_Decoder_Read(final_event, lf);
 
 cleanup:
     os_free(level);
@@ -733,7 +738,6 @@ cleanup:
     os_free(join_data2);
     os_free(filtered_string);
     os_free(keywords);
-    os_free(msg_from_prov);
     os_free(returned_event);
     os_free(categoryId);
     os_free(subcategoryId);
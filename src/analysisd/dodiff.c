@@ -11,6 +11,108 @@
 #include "rules.h"
 #include "eventinfo.h"
 #include "shared.h"
+#include "os_crypto/sha1/sha1_op.h"
+
+/* Maximum number of last outputs whose hash is kept in memory */
+#define DODIFF_CACHE_SIZE 16384
+
+/* Hash of the last output of a rule for an agent, linked by recent use */
+typedef struct dodiff_entry_t {
+    char * key;
+    os_sha1 hash;
+    struct dodiff_entry_t * prev;
+    struct dodiff_entry_t * next;
+} dodiff_entry_t;
+
+/* Protected by do_diff_mutex, like the last files */
+static OSHash * dodiff_cache;
+static dodiff_entry_t * dodiff_newest;
+static dodiff_entry_t * dodiff_oldest;
+static unsigned int dodiff_entries;
+
+static void _dodiff_unlink(dodiff_entry_t * entry)
+{
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        dodiff_newest = entry->next;
+    }
+
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        dodiff_oldest = entry->prev;
+    }
+
+    entry->prev = entry->next = NULL;
+}
+
+static void _dodiff_push(dodiff_entry_t * entry)
+{
+    entry->next = dodiff_newest;
+
+    if (dodiff_newest) {
+        dodiff_newest->prev = entry;
+    } else {
+        dodiff_oldest = entry;
+    }
+
+    dodiff_newest = entry;
+}
+
+/* Get the cached hash of a last file, and mark it as recently used */
+static dodiff_entry_t * _dodiff_get(const char * key)
+{
+    dodiff_entry_t * entry;
+
+    if (!dodiff_cache || (entry = OSHash_Get(dodiff_cache, key), !entry)) {
+        return NULL;
+    }
+
+    _dodiff_unlink(entry);
+    _dodiff_push(entry);
+    return entry;
+}
+
+/* Store the hash of a last file, evicting the least recently used one if full */
+static void _dodiff_set(const char * key, const os_sha1 hash)
+{
+    dodiff_entry_t * entry;
+
+    if (!dodiff_cache) {
+        if (dodiff_cache = OSHash_Create(), !dodiff_cache) {
+            merror(MEM_ERROR, errno, strerror(errno));
+            return;
+        }
+
+        OSHash_setSize(dodiff_cache, DODIFF_CACHE_SIZE);
+    }
+
+    if (entry = _dodiff_get(key), !entry) {
+        if (dodiff_entries >= DODIFF_CACHE_SIZE) {
+            entry = dodiff_oldest;
+            _dodiff_unlink(entry);
+            OSHash_Delete(dodiff_cache, entry->key);
+            os_free(entry->key);
+        } else {
+            os_calloc(1, sizeof(dodiff_entry_t), entry);
+            dodiff_entries++;
+        }
+
+        os_strdup(key, entry->key);
+
+        if (OSHash_Add(dodiff_cache, entry->key, entry) != 2) {
+            os_free(entry->key);
+            os_free(entry);
+            dodiff_entries--;
+            return;
+        }
+
+        _dodiff_push(entry);
+    }
+
+    memcpy(entry->hash, hash, sizeof(os_sha1));
+}
 
 static int _add2last(const char *str, size_t strsize, const char *file)
 {
@@ -71,6 +173,8 @@ int doDiff(RuleInfo *rule, struct _Eventinfo *lf)
     char *htpt = NULL;
     char flastfile[OS_SIZE_2048 + 1];
     char flastcontent[OS_SIZE_65536 + 1];
+    dodiff_entry_t * entry;
+    os_sha1 hash;
 
     /* Clean up global */
     flastcontent[0] = '\0';
@@ -106,6 +210,13 @@ int doDiff(RuleInfo *rule, struct _Eventinfo *lf)
         return (0);
     }
 
+    /* Nothing changed since the last output, no need to read it */
+    OS_SHA1_Str(lf->log, strlen(lf->log), hash);
+
+    if (entry = _dodiff_get(flastfile), entry && strcmp(entry->hash, hash) == 0) {
+        return (0);
+    }
+
     /* Check if last diff exists */
     date_of_change = File_DateofChange(flastfile);
     if (date_of_change <= 0) {
@@ -113,6 +224,7 @@ int doDiff(RuleInfo *rule, struct _Eventinfo *lf)
             merror("Unable to create last file: %s", flastfile);
             return (0);
         }
+        _dodiff_set(flastfile, hash);
         return (0);
     } else {
         FILE *fp;
@@ -137,11 +249,14 @@ int doDiff(RuleInfo *rule, struct _Eventinfo *lf)
 
     /* Nothing changed */
     if (strcmp(flastcontent, lf->log) == 0) {
+        _dodiff_set(flastfile, hash);
         return (0);
     }
 
     if (!_add2last(lf->log, lf->size, flastfile)) {
         merror("Unable to create last file: %s", flastfile);
+    } else {
+        _dodiff_set(flastfile, hash);
     }
 
     add_lastevt(lf->last_events, 0, "Previous output:");
@@ -11,6 +11,7 @@
 #include "config.h"
 #include "analysisd.h"
 #include "eventinfo.h"
+#include "ruleset.h"
 #include "os_regex/os_regex.h"
 
 /* Global definitions */
@@ -23,6 +24,14 @@ int alert_only;
 
 time_t current_time = 0;
 
+/* Released events, kept with their fields array to be reused */
+static Eventinfo **event_pool;
+static size_t event_pool_size;
+static size_t event_pool_len;
+static pthread_mutex_t event_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool w_event_pool_put(Eventinfo *lf);
+
 size_t field_offset[] = {
     offsetof(Eventinfo, srcip),
     offsetof(Eventinfo, id),
@@ -83,41 +92,195 @@ bool different_loop(RuleInfo *rule, Eventinfo *lf, Eventinfo *my_lf) {
     return TRUE;
 }
 
-/* Search last times a signature fired
- * Will look for only that specific signature.
+/* Append a length prefixed value to a correlation key.
+ * Returns false if it does not fit.
  */
-Eventinfo *Search_LastSids(Eventinfo *my_lf, __attribute__((unused)) EventList *last_events, RuleInfo *rule, __attribute__((unused)) regex_matching *rule_match)
+static bool w_correlation_key_add(char *key, size_t size, size_t *len, const char *value) {
+
+    int written = snprintf(key + *len, size - *len, "%zu:%s|", strlen(value), value);
+
+    if (written < 0 || (size_t)written >= size - *len) {
+        return false;
+    }
+
+    *len += written;
+    return true;
+}
+
+/* Build the correlation key of an event for a rule: the values the rule
+ * requires to be the same in every correlated event.
+ * Returns 1 on success, 0 if the event lacks one of the values (it can't be
+ * correlated) or -1 if the rule has no key or the key does not fit.
+ */
+static int w_correlation_key(RuleInfo *rule, Eventinfo *lf, char *key, size_t size) {
+
+    const char * value;
+    u_int32_t same;
+    size_t len = 0;
+    int i;
+
+    *key = '\0';
+
+    if (!(rule->context_opts & FIELD_GFREQUENCY)) {
+        if (!lf->agent_id) {
+            return 0;
+        }
+        if (!w_correlation_key_add(key, size, &len, lf->agent_id)) {
+            return -1;
+        }
+    }
+
+    if (rule->same_field & FIELD_ID) {
+        if (!lf->id) {
+            return 0;
+        }
+        if (!w_correlation_key_add(key, size, &len, lf->id)) {
+            return -1;
+        }
+    }
+
+    if (rule->same_field & FIELD_SRCIP) {
+        if (!lf->srcip) {
+            return 0;
+        }
+        if (!w_correlation_key_add(key, size, &len, lf->srcip)) {
+            return -1;
+        }
+    }
+
+    if (rule->same_field & FIELD_DYNAMICS) {
+        if (lf->nfields == 0) {
+            return 0;
+        }
+
+        for (i = 0; rule->same_fields && rule->same_fields[i]; ++i) {
+            if (value = FindField(lf, rule->same_fields[i]), !value) {
+                return 0;
+            }
+            if (!w_correlation_key_add(key, size, &len, value)) {
+                return -1;
+            }
+        }
+    }
+
+    /* Same fields checked by same_loop() */
+    if (rule->alert_opts & SAME_EXTRAINFO) {
+        same = rule->same_field >> 2;
+
+        for (i = 2; same != 0 && i < N_FIELDS; i++, same >>= 1) {
+            if ((same & 1) == 1) {
+                if (value = *(char **)((void *)lf + field_offset[i]), !value) {
+                    return 0;
+                }
+                if (!w_correlation_key_add(key, size, &len, value)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return len > 0 ? 1 : -1;
+}
+
+/* Release a bucket if it has no events left. Call it with the index locked. */
+static void w_correlation_bucket_release(RuleCorrelationIndex *index, RuleCorrelationBucket *bucket) {
+
+    if (bucket->events->currently_size == 0) {
+        OSHash_Delete(index->buckets, bucket->key);
+        os_remove_correlation_bucket(bucket);
+    }
+}
+
+void OS_AddCorrelationEvent(RuleInfo *rule, Eventinfo *lf) {
+
+    RuleCorrelationIndex *index;
+    RuleCorrelationBucket *bucket;
+    char key[OS_SIZE_2048];
+    unsigned int i;
+
+    if (rule->sid_correlated_sz == 0 || lf->sid_index_slots) {
+        return;
+    }
+
+    os_calloc(rule->sid_correlated_sz, sizeof(RuleCorrelationSlot), lf->sid_index_slots);
+
+    for (i = 0; i < rule->sid_correlated_sz; i++) {
+        if (w_correlation_key(rule->sid_correlated[i], lf, key, sizeof(key)) != 1) {
+            continue;
+        }
+
+        index = rule->sid_correlated[i]->sid_index;
+        w_rwlock_wrlock(&index->mutex);
+
+        if (bucket = OSHash_Get(index->buckets, key), !bucket) {
+            os_calloc(1, sizeof(RuleCorrelationBucket), bucket);
+            os_strdup(key, bucket->key);
+
+            if (bucket->events = OSList_Create(), !bucket->events) {
+                merror_exit(MEM_ERROR, errno, strerror(errno));
+            }
+
+            if (OSHash_Add(index->buckets, bucket->key, bucket) != 2) {
+                merror("Unable to add data to correlation index.");
+                os_remove_correlation_bucket(bucket);
+                w_rwlock_unlock(&index->mutex);
+                continue;
+            }
+        }
+
+        if (lf->sid_index_slots[i].node = OSList_AddData(bucket->events, lf), lf->sid_index_slots[i].node) {
+            lf->sid_index_slots[i].bucket = bucket;
+        } else {
+            merror("Unable to add data to correlation index.");
+            w_correlation_bucket_release(index, bucket);
+        }
+
+        w_rwlock_unlock(&index->mutex);
+    }
+}
+
+void OS_RemoveCorrelationEvent(Eventinfo *lf) {
+
+    RuleCorrelationIndex *index;
+    RuleCorrelationSlot *slot;
+    unsigned int i;
+
+    if (!lf->sid_index_slots) {
+        return;
+    }
+
+    for (i = 0; i < lf->generated_rule->sid_correlated_sz; i++) {
+        slot = &lf->sid_index_slots[i];
+
+        if (!slot->bucket) {
+            continue;
+        }
+
+        index = lf->generated_rule->sid_correlated[i]->sid_index;
+        w_rwlock_wrlock(&index->mutex);
+        OSList_DeleteThisNode(slot->bucket->events, slot->node);
+        w_correlation_bucket_release(index, slot->bucket);
+        w_rwlock_unlock(&index->mutex);
+    }
+
+    os_free(lf->sid_index_slots);
+}
+
+/* Look for the event that completes the frequency of a rule, walking back
+ * the list of events that fired the if_matched_sid signature from lf_node.
+ */
+static Eventinfo *Search_LastSids_From(Eventinfo *my_lf, RuleInfo *rule, OSListNode *lf_node)
 {
     Eventinfo *lf = NULL;
     Eventinfo *first_matched = NULL;
-    OSListNode *lf_node;
     int frequency_count = 0;
     int i;
     int found;
     const char * my_field;
     const char * field;
 
-    /* Checking if sid search is valid */
-    if (!rule->sid_search) {
-        merror("No sid search.");
-        return NULL;
-    }
-
-    while (1) {
-        w_mutex_lock(&rule->sid_search->mutex);
-            if (!rule->sid_search->pending_remove) {
-                rule->sid_search->count++;
-                w_mutex_unlock(&rule->sid_search->mutex);
-                break;
-            }
-        w_mutex_unlock(&rule->sid_search->mutex);
-    }
-
-    /* Get last node */
-    lf_node = OSList_GetLastNode(rule->sid_search);
     if (!lf_node) {
-        lf = NULL;
-        goto end;
+        return NULL;
     }
 
     do {
@@ -129,8 +292,7 @@ Eventinfo *Search_LastSids(Eventinfo *my_lf, __attribute__((unused)) EventList *
 
         /* If time is outside the timeframe, return */
         if ((current_time - lf->generate_time) > rule->timeframe) {
-            lf = NULL;
-            goto end;
+            return NULL;
         }
 
         if (!(rule->context_opts & FIELD_GFREQUENCY)) {
@@ -223,8 +385,7 @@ Eventinfo *Search_LastSids(Eventinfo *my_lf, __attribute__((unused)) EventList *
          * or rules with a lower level.
          */
         if (lf->matched >= rule->level) {
-            lf = NULL;
-            goto end;
+            return NULL;
         }
 
         /* Check if the number of matches worked */
@@ -246,11 +407,59 @@ Eventinfo *Search_LastSids(Eventinfo *my_lf, __attribute__((unused)) EventList *
         if (first_matched) { // To protect from a possible frequency 0
             first_matched->matched = rule->level;
         }
-        goto end;
+        return lf;
     } while ((lf_node = lf_node->prev) != NULL);
 
-    lf = NULL;
-end:
+    return NULL;
+}
+
+/* Search last times a signature fired
+ * Will look for only that specific signature.
+ */
+Eventinfo *Search_LastSids(Eventinfo *my_lf, __attribute__((unused)) EventList *last_events, RuleInfo *rule, __attribute__((unused)) regex_matching *rule_match)
+{
+    RuleCorrelationBucket *bucket;
+    Eventinfo *lf = NULL;
+    char key[OS_SIZE_2048];
+
+    /* Checking if sid search is valid */
+    if (!rule->sid_search) {
+        merror("No sid search.");
+        return NULL;
+    }
+
+    /* Only the events with the same correlation key can match */
+    if (rule->sid_index) {
+        switch (w_correlation_key(rule, my_lf, key, sizeof(key))) {
+        case 0:
+            return NULL;
+
+        case 1:
+            w_rwlock_rdlock(&rule->sid_index->mutex);
+            if (bucket = OSHash_Get(rule->sid_index->buckets, key), bucket) {
+                lf = Search_LastSids_From(my_lf, rule, bucket->events->last_node);
+            }
+            w_rwlock_unlock(&rule->sid_index->mutex);
+            return lf;
+
+        default:
+            break;
+        }
+    }
+
+    while (1) {
+        w_mutex_lock(&rule->sid_search->mutex);
+            if (!rule->sid_search->pending_remove) {
+                rule->sid_search->count++;
+                w_mutex_unlock(&rule->sid_search->mutex);
+                break;
+            }
+        w_mutex_unlock(&rule->sid_search->mutex);
+    }
+
+    /* Get last node */
+    lf = Search_LastSids_From(my_lf, rule, OSList_GetLastNode(rule->sid_search));
+
     w_mutex_lock(&rule->sid_search->mutex);
     rule->sid_search->count--;
     w_mutex_unlock(&rule->sid_search->mutex);
@@ -630,6 +839,77 @@ end:
     return lf;
 }
 
+void w_event_pool_init(size_t size) {
+
+    os_free(event_pool);
+    event_pool_len = 0;
+    event_pool_size = size;
+
+    if (size > 0) {
+        os_calloc(size, sizeof(Eventinfo *), event_pool);
+    }
+}
+
+Eventinfo * w_event_new(void) {
+
+    Eventinfo *lf = NULL;
+
+    if (event_pool_size > 0) {
+        w_mutex_lock(&event_pool_mutex);
+        if (event_pool_len > 0) {
+            lf = event_pool[--event_pool_len];
+        }
+        w_mutex_unlock(&event_pool_mutex);
+    }
+
+    if (!lf) {
+        os_calloc(1, sizeof(Eventinfo), lf);
+        os_calloc(Config.decoder_order_size, sizeof(DynamicField), lf->fields);
+        lf->pooled = true;
+
+        /* Keep the field index at most half full */
+        for (lf->field_index_size = 1; lf->field_index_size < 2 * Config.decoder_order_size; lf->field_index_size <<= 1);
+        os_calloc(lf->field_index_size, sizeof(u_int32_t), lf->field_index);
+    }
+
+    Zero_Eventinfo(lf);
+
+    return lf;
+}
+
+/* Give an event already released by Free_Eventinfo back to the pool.
+ * Returns false if the event must be freed.
+ */
+static bool w_event_pool_put(Eventinfo *lf) {
+
+    DynamicField *fields = lf->fields;
+    u_int32_t *field_index = lf->field_index;
+    unsigned int field_index_size = lf->field_index_size;
+    u_int16_t field_index_gen = lf->field_index_gen;
+    bool stored = false;
+
+    if (!lf->pooled || event_pool_size == 0) {
+        return false;
+    }
+
+    /* Zero_Eventinfo clears the fields array when the event is reused */
+    memset(lf, 0, sizeof(Eventinfo));
+    lf->fields = fields;
+    lf->field_index = field_index;
+    lf->field_index_size = field_index_size;
+    lf->field_index_gen = field_index_gen;
+    lf->pooled = true;
+
+    w_mutex_lock(&event_pool_mutex);
+    if (event_pool_len < event_pool_size) {
+        event_pool[event_pool_len++] = lf;
+        stored = true;
+    }
+    w_mutex_unlock(&event_pool_mutex);
+
+    return stored;
+}
+
 /* Zero the loginfo structure */
 void Zero_Eventinfo(Eventinfo *lf)
 {
@@ -671,6 +951,13 @@ void Zero_Eventinfo(Eventinfo *lf)
 
     lf->nfields = 0;
 
+    /* A new generation invalidates the slots of the previous event */
+    lf->field_indexed = 0;
+    if (lf->field_index && ++lf->field_index_gen == 0) {
+        memset(lf->field_index, 0, sizeof(u_int32_t) * lf->field_index_size);
+        lf->field_index_gen = 1;
+    }
+
     lf->time.tv_sec = 0;
     lf->time.tv_nsec = 0;
     lf->matched = 0;
@@ -683,6 +970,8 @@ void Zero_Eventinfo(Eventinfo *lf)
     lf->generated_rule = NULL;
     lf->sid_node_to_delete = NULL;
     lf->group_node_to_delete = NULL;
+    lf->sid_index_slots = NULL;
+    lf->ruleset = NULL;
     lf->decoder_info = NULL_Decoder;
 
     lf->previous = NULL;
@@ -692,13 +981,51 @@ void Zero_Eventinfo(Eventinfo *lf)
     lf->last_events = NULL;
     lf->r_firedtimes = -1;
     lf->queue_added = 0;
+    lf->decoders_tried = 0;
     lf->rootcheck_fts = 0;
     lf->decoder_syscheck_id = 0;
     lf->tid = -1;
+    lf->trace_time = 0;
 
     return;
 }
 
+size_t w_event_memory(const Eventinfo *lf)
+{
+    const char * strings[] = { lf->full_log, lf->agent_id, lf->location, lf->hostname, lf->comment,
+                               lf->srcip, lf->srcgeoip, lf->dstip, lf->dstgeoip, lf->srcport, lf->dstport,
+                               lf->protocol, lf->action, lf->srcuser, lf->dstuser, lf->id, lf->status,
+                               lf->url, lf->data, lf->extra_data, lf->systemname, lf->previous };
+    size_t memory = w_mem_size(lf) + w_mem_size(lf->fields) + w_mem_size(lf->field_index)
+                    + w_mem_size(lf->sid_index_slots);
+    unsigned int i;
+
+    for (i = 0; i < array_size(strings); i++) {
+        memory += w_mem_size(strings[i]);
+    }
+
+    for (i = 0; i < (unsigned int)lf->nfields; i++) {
+        memory += w_mem_size(lf->fields[i].key) + w_mem_size(lf->fields[i].value);
+    }
+
+    /* The program name and the timestamp belong to the original event */
+    if (lf->is_a_copy) {
+        memory += w_mem_size(lf->program_name) + w_mem_size(lf->dec_timestamp);
+    }
+
+    if (lf->last_events) {
+        char **lasts;
+
+        for (lasts = lf->last_events; *lasts; lasts++) {
+            memory += w_mem_size(*lasts);
+        }
+
+        memory += w_mem_size(lf->last_events);
+    }
+
+    return memory;
+}
+
 /* Free the loginfo structure */
 void Free_Eventinfo(Eventinfo *lf)
 {
@@ -717,6 +1044,8 @@ void Free_Eventinfo(Eventinfo *lf)
 
     // Free node to delete
     if(!lf->is_a_copy){
+        OS_RemoveCorrelationEvent(lf);
+
         if (lf->sid_node_to_delete) {
             w_mutex_lock(&lf->generated_rule->sid_prev_matched->mutex);
             lf->generated_rule->sid_prev_matched->pending_remove = 1;
@@ -850,8 +1179,6 @@ void Free_Eventinfo(Eventinfo *lf)
             free(lf->fields[i].key);
             free(lf->fields[i].value);
         }
-
-        free(lf->fields);
     }
 
     if (lf->previous) {
@@ -879,7 +1206,16 @@ void Free_Eventinfo(Eventinfo *lf)
      * fts
      * comment
      */
-    os_free(lf);
+
+    /* The rules and decoder of the event are no longer referenced */
+    w_ruleset_release(lf->ruleset);
+    lf->ruleset = NULL;
+
+    if (!w_event_pool_put(lf)) {
+        os_free(lf->fields);
+        os_free(lf->field_index);
+        os_free(lf);
+    }
 
     return;
 }
@@ -987,6 +1323,7 @@ char* ParseRuleComment(Eventinfo *lf) {
 
 void w_copy_event_for_log(Eventinfo *lf,Eventinfo *lf_cpy){
 
+    lf_cpy->ruleset = w_ruleset_hold(lf->ruleset);
 
     if(lf->full_log){
         os_strdup(lf->full_log,lf_cpy->full_log);
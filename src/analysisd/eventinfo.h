@@ -23,19 +23,28 @@ typedef struct _DynamicField {
     char *value;
 } DynamicField;
 
-/* Event Information structure */
+/* Event Information structure
+ *
+ * The members read while the rules are checked come first, so they share the
+ * first cache lines of the event. The rest is only used by the decoders, the
+ * outputs and the event lists. Keep the small members together to avoid padding.
+ */
 typedef struct _Eventinfo {
+    /* Pointer to the decoder that matched */
+    OSDecoderInfo *decoder_info;
+    u_int16_t decoder_syscheck_id;
+    u_int16_t field_index_gen;      ///< Generation of the slots of field_index that belong to this event
+    int nfields;
+    DynamicField *fields;
+    u_int32_t *field_index;         ///< Hash index of the first field_indexed fields, NULL if the event has none
+    unsigned int field_index_size;  ///< Number of slots of field_index, a power of two
+    int field_indexed;              ///< Number of fields reachable through field_index
+
     /* Extracted from the event */
     char *log;
-    char *full_log;
-    const char * log_after_parent;
-    const char * log_after_prematch;
-    char *agent_id;
     char *location;
     char *hostname;
     char *program_name;
-    char *comment;
-    char *dec_timestamp;
 
     /* Extracted from the decoders */
     char *srcip;
@@ -54,14 +63,26 @@ typedef struct _Eventinfo {
     char *data;
     char *extra_data;
     char *systemname;
-    DynamicField *fields;
-    int nfields;
+
+    /* Ruleset generation the decoder and rules belong to */
+    struct _w_ruleset_t *ruleset;
+
+    /* Extract when the event fires a rule */
+    size_t size;
+    char hour[10];
+    char mon[4];
+    int rootcheck_fts;
 
     /* Pointer to the rule that generated it */
     RuleInfo *generated_rule;
 
-    /* Pointer to the decoder that matched */
-    OSDecoderInfo *decoder_info;
+    /* Extracted from the event, not read by the rules */
+    char *full_log;
+    const char * log_after_parent;
+    const char * log_after_prematch;
+    char *agent_id;
+    char *comment;
+    char *dec_timestamp;
 
     /* Sid node to delete */
     OSListNode *sid_node_to_delete;
@@ -69,34 +90,32 @@ typedef struct _Eventinfo {
     /* Group node to delete */
     OSListNode **group_node_to_delete;
 
-    /* Extract when the event fires a rule */
-    size_t size;
+    /* Position in the correlation index of every generated_rule->sid_correlated rule */
+    RuleCorrelationSlot *sid_index_slots;
+
     size_t p_name_size;
 
     /* Other internal variables */
-    int matched;
-
     time_t generate_time;
     struct timespec time;
     int day;
     int year;
-    char hour[10];
-    char mon[4];
+    int matched;
+    int is_a_copy;
 
     char *previous;
     wlabel_t *labels;
-
-    u_int16_t decoder_syscheck_id;
-    int rootcheck_fts;
-    int is_a_copy;
     char **last_events;
     int r_firedtimes;
     int queue_added;
+    int decoders_tried;         ///< Parent decoders tried by DecodeEvent
+    bool pooled;                ///< Allocated by w_event_new, gets back to the event pool when freed
 
-    // Node reference
-    EventNode *node;
     // Process thread id
     int tid;
+    // Node reference
+    EventNode *node;
+    uint64_t trace_time;        ///< Start of the current stage of a traced event, 0 if the event isn't traced
 } Eventinfo;
 
 /* Events List structure */
@@ -106,6 +125,7 @@ struct _EventNode {
     volatile int count;
     EventNode *next;
     EventNode *prev;
+    size_t memory;              ///< Memory of the event, accounted to os_analysisd_mem_eventlist
 };
 
 struct EventList {
@@ -156,9 +176,42 @@ Eventinfo *Search_LastEvents(Eventinfo *my_lf, EventList *last_events, RuleInfo
 Eventinfo *Search_LastSids(Eventinfo *my_lf, EventList *last_events, RuleInfo *currently_rule, regex_matching *rule_match);
 Eventinfo *Search_LastGroups(Eventinfo *my_lf, EventList *last_events, RuleInfo *currently_rule, regex_matching *rule_match);
 
+/**
+ * @brief Add an event to the correlation index of the rules searching its rule
+ *
+ * Call it when the event is added to rule->sid_prev_matched.
+ *
+ * @param rule rule matched by the event
+ * @param lf event to add
+ */
+void OS_AddCorrelationEvent(RuleInfo *rule, Eventinfo *lf);
+
+/**
+ * @brief Remove an event from all the correlation indexes it was added to
+ * @param lf event to remove
+ */
+void OS_RemoveCorrelationEvent(Eventinfo *lf);
+
 /* Zero the eventinfo structure */
 void Zero_Eventinfo(Eventinfo *lf);
 
+/**
+ * @brief Set the number of released events kept to be reused by w_event_new
+ *
+ * Must be called before any event is allocated.
+ * @param size maximum number of idle events. 0 disables the pool
+ */
+void w_event_pool_init(size_t size);
+
+/**
+ * @brief Get a zeroed event with its dynamic fields array
+ *
+ * The event and its fields array are reused from the event pool when
+ * possible. Free_Eventinfo gives them back to the pool.
+ * @return event ready to be filled
+ */
+Eventinfo * w_event_new(void);
+
 /**
  * @brief Free the eventinfo structure
  * @param lf event to remove
@@ -172,6 +225,19 @@ void Free_Eventinfo(Eventinfo *lf);
  */
 void w_free_event_info(Eventinfo *lf);
 
+/**
+ * @brief Memory of the events kept in the lists of previous events
+ */
+extern w_mem_tag_t os_analysisd_mem_eventlist;
+
+/**
+ * @brief Get the memory held by an event: the structure, its fields and its strings
+ *
+ * @param lf Event
+ * @return Size in bytes
+ */
+size_t w_event_memory(const Eventinfo *lf);
+
 /* Add and event to the list of previous events */
 void OS_AddEvent(Eventinfo *lf, EventList *list);
 
@@ -190,6 +256,24 @@ void OS_CreateEventList(int maxsize, EventList *list);
 /* Find index of a dynamic field. Returns -1 if not found. */
 const char* FindField(const Eventinfo *lf, const char *name);
 
+/**
+ * @brief Add the last dynamic field of an event to its field index
+ *
+ * Must be called right after a field is appended to lf->fields. The fields
+ * set any other way are found by a linear scan.
+ * @param lf event being decoded
+ */
+void w_field_index_add(Eventinfo *lf);
+
+/**
+ * @brief Check if the ruleset an event is decoded with reads a dynamic field
+ *
+ * @param lf event being decoded
+ * @param key field name
+ * @return false if the field can be left out, true otherwise
+ */
+bool w_field_used(const Eventinfo *lf, const char *key);
+
 /* Parse rule comment with dynamic fields */
 char* ParseRuleComment(Eventinfo *lf);
 
@@ -231,6 +315,7 @@ void *Extra_Data_FP(Eventinfo *lf, char *field, const char *order);
 void *Status_FP(Eventinfo *lf, char *field, const char *order);
 void *SystemName_FP(Eventinfo *lf, char *field, const char *order);
 void *DynamicField_FP(Eventinfo *lf, char *field, const char *order);
+void *UnusedField_FP(Eventinfo *lf, char *field, const char *order);
 
 /* Copy Eventinfo for writing log */
 void w_copy_event_for_log(Eventinfo *lf,Eventinfo *lf_cpy);
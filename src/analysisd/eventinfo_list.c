@@ -12,6 +12,14 @@
 #include "eventinfo.h"
 #include "rules.h"
 
+w_mem_tag_t os_analysisd_mem_eventlist = W_MEM_TAG_INITIALIZER("eventlist");
+
+/* Account an event node and its event to the history memory */
+static void os_account_event_node(EventNode *node, int sign)
+{
+    w_mem_tag_add(&os_analysisd_mem_eventlist, sign * (int64_t)(node->memory + w_mem_size(node)), sign);
+}
+
 /* Create the Event List */
 void OS_CreateEventList(int maxsize, EventList *list)
 {
@@ -71,6 +79,7 @@ void OS_AddEvent(Eventinfo *lf, EventList *list)
                 list->last_node->next = NULL;
 
                 /* Free event info */
+                os_account_event_node(oldlast, -1);
                 Free_Eventinfo(oldlast->event);
                 free(oldlast);
 
@@ -104,6 +113,8 @@ void OS_AddEvent(Eventinfo *lf, EventList *list)
     lf->node = list->last_added_node;
     list->last_added_node->count = 0;
     list->last_added_node->mutex = (pthread_mutex_t) PTHREAD_MUTEX_INITIALIZER;
+    list->last_added_node->memory = w_event_memory(lf);
+    os_account_event_node(list->last_added_node, 1);
 
     w_mutex_unlock(&list->event_mutex);
 
@@ -117,6 +128,7 @@ void os_remove_eventlist(EventList *list) {
     while (list->first_node) {
         tmp = list->first_node;
         if (tmp->event) {
+            os_account_event_node(tmp, -1);
             tmp->event->node = NULL;
             Free_Eventinfo(tmp->event);
             w_mutex_destroy(&tmp->mutex);
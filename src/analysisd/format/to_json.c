@@ -21,9 +21,49 @@
 #define is_win_permission(x) (strchr(x, '|'))
 #define print_before_field(x, y) (x && *x && (!y || strcmp(x, y)))
 void add_json_attrs(const char *attrs_str, cJSON *file_diff, char after);
+static cJSON * Eventinfo_to_json(const Eventinfo* lf, bool force_full_log, OSList * list_msg);
 
 /* Convert Eventinfo to json */
 char* Eventinfo_to_jsonstr(const Eventinfo* lf, bool force_full_log, OSList * list_msg)
+{
+    cJSON* root = Eventinfo_to_json(lf, force_full_log, list_msg);
+    char* out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+/* Convert Eventinfo to json into a caller-owned reusable buffer */
+long Eventinfo_to_jsonbuf(const Eventinfo* lf, bool force_full_log, OSList * list_msg, char ** buffer, size_t * size)
+{
+    cJSON* root = Eventinfo_to_json(lf, force_full_log, list_msg);
+    long length = -1;
+
+    if (*buffer && *size > JSON_BUFFER_SLACK && cJSON_PrintPreallocated(root, *buffer, (int)(*size - JSON_BUFFER_SLACK), FALSE)) {
+        length = (long)strlen(*buffer);
+    } else {
+        /* The alert does not fit: print it once and grow the buffer to hold it */
+        char* out = cJSON_PrintUnformatted(root);
+
+        if (out) {
+            size_t out_len = strlen(out);
+
+            if (out_len + JSON_BUFFER_SLACK >= *size) {
+                *size = out_len + JSON_BUFFER_SLACK + 1;
+                os_realloc(*buffer, *size, *buffer);
+            }
+
+            memcpy(*buffer, out, out_len + 1);
+            length = (long)out_len;
+            free(out);
+        }
+    }
+
+    cJSON_Delete(root);
+    return length;
+}
+
+/* Build the JSON tree of an Eventinfo */
+static cJSON * Eventinfo_to_json(const Eventinfo* lf, bool force_full_log, OSList * list_msg)
 {
     cJSON* root;
     cJSON* rule = NULL;
@@ -34,7 +74,6 @@ char* Eventinfo_to_jsonstr(const Eventinfo* lf, bool force_full_log, OSList * li
     cJSON* data;
     cJSON* cluster;
     char manager_name[512];
-    char* out;
     int i;
     char * saveptr;
 
@@ -600,9 +639,7 @@ char* Eventinfo_to_jsonstr(const Eventinfo* lf, bool force_full_log, OSList * li
     }
 
     W_ParseJSON(root, lf);
-    out = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return out;
+    return root;
 }
 
 void add_json_attrs(const char *attrs_str, cJSON *file_diff, char after) {
@@ -15,4 +15,22 @@
 
 #define add_json_field(obj, name, string, filter) if (string && strcmp(string, filter)) { if (!obj) obj = cJSON_CreateObject(); cJSON_AddStringToObject(obj, name, string); }
 char *Eventinfo_to_jsonstr(const Eventinfo *lf, bool force_full_log, OSList * list_msg);
+
+/* Bytes kept free at the end of the buffer, cJSON_PrintPreallocated may underestimate numbers */
+#define JSON_BUFFER_SLACK 8
+
+/**
+ * @brief Serialize an Eventinfo into a reusable buffer
+ *
+ * Produces the same text as Eventinfo_to_jsonstr() but avoids allocating a new
+ * string per event. The buffer is grown (never shrunk) when the event does not fit.
+ *
+ * @param lf Event to serialize.
+ * @param force_full_log Include full_log even if the rule disables it.
+ * @param list_msg List of messages for logtest, or NULL.
+ * @param buffer Pointer to the buffer. May point to NULL initially.
+ * @param size Pointer to the size of the buffer.
+ * @return Length of the JSON string written into *buffer, or -1 on error.
+ */
+long Eventinfo_to_jsonbuf(const Eventinfo *lf, bool force_full_log, OSList * list_msg, char ** buffer, size_t * size);
 #endif /* TO_JSON_H */
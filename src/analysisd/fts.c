@@ -17,22 +17,38 @@
 /* Local variables */
 unsigned int fts_minsize_for_str = 0;
 int fts_list_size;
+int fts_store_max_size;
 
 static FILE *fp_list = NULL;
 static FILE **fp_ignore = NULL;
 
 OSList *os_analysisd_fts_list;
 OSHash *os_analysisd_fts_store;
+w_mem_tag_t os_analysisd_mem_fts = W_MEM_TAG_INITIALIZER("fts");
 
 /* Multiple readers / one write mutex */
 static pthread_rwlock_t file_update_rwlock;
 static pthread_mutex_t fts_write_lock;
 
+/* Account a stored entry: the value, the copy of the key and the hash node */
+static void FTS_Account(const char *entry)
+{
+    w_mem_tag_add(&os_analysisd_mem_fts, 2 * w_mem_size(entry) + sizeof(OSHashNode), 1);
+}
+
 /* Start the FTS module */
 int FTS_Init(int threads, OSList **fts_list, OSHash **fts_store)
 {
     char _line[OS_FLSIZE + 1];
+    char **kept = NULL;
+    unsigned int total = 0;
+    unsigned int skip = 0;
+    unsigned int loaded = 0;
     int i;
+    char fts_buffer[PATH_MAX];
+    char ig_buffer[PATH_MAX];
+    const char * fts_queue = w_analysisd_instance_path(FTS_QUEUE, fts_buffer, sizeof(fts_buffer));
+    const char * ig_queue = w_analysisd_instance_path(IG_QUEUE, ig_buffer, sizeof(ig_buffer));
 
     _line[OS_FLSIZE] = '\0';
 
@@ -72,46 +88,69 @@ int FTS_Init(int threads, OSList **fts_list, OSHash **fts_store)
                           "fts_min_size_for_str",
                           6, 128);
 
+    /* Get the maximum number of entries loaded from the queue (0 means unlimited) */
+    fts_store_max_size = getDefine_Int("analysisd",
+                                       "fts_store_max_size",
+                                       0, 10000000);
+
     if (!OSList_SetMaxSize(*fts_list, fts_list_size)) {
         merror(LIST_SIZE_ERROR);
         return (0);
     }
 
     /* Create fts list */
-    fp_list = fopen(FTS_QUEUE, "r+");
+    fp_list = fopen(fts_queue, "r+");
     if (!fp_list) {
         /* Create the file if we cant open it */
-        fp_list = fopen(FTS_QUEUE, "w+");
+        fp_list = fopen(fts_queue, "w+");
         if (fp_list) {
             fclose(fp_list);
         }
 
-        if (chmod(FTS_QUEUE, 0640) == -1) {
-            merror(CHMOD_ERROR, FTS_QUEUE, errno, strerror(errno));
+        if (chmod(fts_queue, 0640) == -1) {
+            merror(CHMOD_ERROR, fts_queue, errno, strerror(errno));
             return 0;
         }
 
         uid_t uid = Privsep_GetUser(USER);
         gid_t gid = Privsep_GetGroup(GROUPGLOBAL);
         if (uid != (uid_t) - 1 && gid != (gid_t) - 1) {
-            if (chown(FTS_QUEUE, uid, gid) == -1) {
-                merror(CHOWN_ERROR, FTS_QUEUE, errno, strerror(errno));
+            if (chown(fts_queue, uid, gid) == -1) {
+                merror(CHOWN_ERROR, fts_queue, errno, strerror(errno));
                 return (0);
             }
         }
 
-        fp_list = fopen(FTS_QUEUE, "r+");
+        fp_list = fopen(fts_queue, "r+");
         if (!fp_list) {
-            merror(FOPEN_ERROR, FTS_QUEUE, errno, strerror(errno));
+            merror(FOPEN_ERROR, fts_queue, errno, strerror(errno));
             return (0);
         }
     }
 
+    /* Only the newest entries are kept when the queue exceeds its limit */
+    if (fts_store_max_size > 0) {
+        fseek(fp_list, 0, SEEK_SET);
+        while (fgets(_line, sizeof(_line), fp_list) != NULL) {
+            total++;
+        }
+
+        if (total > (unsigned int)fts_store_max_size) {
+            skip = total - fts_store_max_size;
+            os_calloc(fts_store_max_size, sizeof(char *), kept);
+        }
+    }
+
     /* Add content from the files to memory */
     fseek(fp_list, 0, SEEK_SET);
     while (fgets(_line, sizeof(_line), fp_list) != NULL) {
         char *tmp_s;
 
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+
         /* Remove newlines */
         tmp_s = strchr(_line, '\n');
         if (tmp_s) {
@@ -122,6 +161,12 @@ int FTS_Init(int threads, OSList **fts_list, OSHash **fts_store)
         if (OSHash_Add(*fts_store, tmp_s, tmp_s) != 2) {
             free(tmp_s);
             merror(LIST_ADD_ERROR);
+        } else {
+            FTS_Account(tmp_s);
+
+            if (kept && loaded < (unsigned int)fts_store_max_size) {
+                kept[loaded++] = tmp_s;
+            }
         }
 
         /* Reset pointer addresses before using strdup() again */
@@ -129,38 +174,58 @@ int FTS_Init(int threads, OSList **fts_list, OSHash **fts_store)
         tmp_s = NULL;
     }
 
+    /* Rewrite the queue with the entries loaded, dropping the oldest ones */
+    if (kept) {
+        if (fp_list = freopen(fts_queue, "w+", fp_list), !fp_list) {
+            merror(FOPEN_ERROR, fts_queue, errno, strerror(errno));
+            os_free(kept);
+            return (0);
+        }
+
+        for (i = 0; i < (int)loaded; i++) {
+            fprintf(fp_list, "%s\n", kept[i]);
+        }
+
+        fflush(fp_list);
+        minfo("FTS queue compacted: %u old entries discarded.", total - loaded);
+        os_free(kept);
+    }
+
+    /* New entries are always appended, so the stream is positioned only once */
+    fseek(fp_list, 0, SEEK_END);
+
     /* Create ignore list */
-    *fp_ignore = fopen(IG_QUEUE, "r+");
+    *fp_ignore = fopen(ig_queue, "r+");
     if (!*fp_ignore) {
         /* Create the file if we cannot open it */
-        *fp_ignore = fopen(IG_QUEUE, "w+");
+        *fp_ignore = fopen(ig_queue, "w+");
         if (*fp_ignore) {
             fclose(*fp_ignore);
         }
 
-        if (chmod(IG_QUEUE, 0640) == -1) {
-            merror(CHMOD_ERROR, IG_QUEUE, errno, strerror(errno));
+        if (chmod(ig_queue, 0640) == -1) {
+            merror(CHMOD_ERROR, ig_queue, errno, strerror(errno));
             return (0);
         }
 
         uid_t uid = Privsep_GetUser(USER);
         gid_t gid = Privsep_GetGroup(GROUPGLOBAL);
         if (uid != (uid_t) - 1 && gid != (gid_t) - 1) {
-            if (chown(IG_QUEUE, uid, gid) == -1) {
-                merror(CHOWN_ERROR, IG_QUEUE, errno, strerror(errno));
+            if (chown(ig_queue, uid, gid) == -1) {
+                merror(CHOWN_ERROR, ig_queue, errno, strerror(errno));
                 return (0);
             }
         }
 
-        *fp_ignore = fopen(IG_QUEUE, "r+");
+        *fp_ignore = fopen(ig_queue, "r+");
         if (!*fp_ignore) {
-            merror(FOPEN_ERROR, IG_QUEUE, errno, strerror(errno));
+            merror(FOPEN_ERROR, ig_queue, errno, strerror(errno));
             return (0);
         }
     }
 
     for (i = 1; i < threads; i++) {
-        fp_ignore[i] = fopen(IG_QUEUE, "r+");
+        fp_ignore[i] = fopen(ig_queue, "r+");
     }
 
     return (1);
@@ -366,13 +431,14 @@ char * FTS(Eventinfo *lf, OSList **fts_list, OSHash **fts_store)
         return NULL;
     }
 
+    FTS_Account(line_for_list);
+
     return _line;
 }
 
 void FTS_Fprintf(char * _line){
     /* Save to fts fp */
     w_mutex_lock(&fts_write_lock);
-    fseek(fp_list, 0, SEEK_END);
     fprintf(fp_list, "%s\n", _line);
     w_mutex_unlock(&fts_write_lock);
 }
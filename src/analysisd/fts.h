@@ -27,6 +27,11 @@ extern OSList *os_analysisd_fts_list;
  */
 extern OSHash *os_analysisd_fts_store;
 
+/**
+ * @brief Memory of the fts values stored
+ */
+extern w_mem_tag_t os_analysisd_mem_fts;
+
 
 /**
  * @brief Initialize FTS engine
@@ -79,5 +84,6 @@ void FTS_Flush();
 /* Global variables */
 extern unsigned int fts_minsize_for_str;
 extern int fts_list_size;
+extern int fts_store_max_size;
 
 #endif /* FTS_H */
@@ -15,8 +15,21 @@
 #include "config.h"
 #include "labels.h"
 
-static OSHash *label_cache;
+#ifdef WAZUH_UNIT_TESTING
+// Remove static qualifier when unit testing
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+STATIC OSHash *label_cache;
 static pthread_mutex_t label_cache_mutex;
+STATIC w_queue_t *label_refresh_queue;
+
+static int labels_request(const char *agent_id, int *sock, wlabel_t **labels);
+static wlabel_data_t * labels_cache_store(const char *agent_id, wlabel_t *labels);
+STATIC void labels_refresh(const char *agent_id, int *sock);
+STATIC void labels_prefetch(int *sock);
 
 /* Free label cache */
 void free_label_cache(wlabel_data_t *data) {
@@ -43,24 +56,29 @@ void labels_finalize() {
     OSHash_Free(label_cache);
 }
 
-wlabel_data_t * labels_cache_update(char *agent_id, int *sock) {
-    wlabel_t *labels = NULL;
-    wlabel_data_t *data = NULL;
-
-    // Requesting labels to Wazuh DB
+/* Request the labels of an agent to Wazuh DB. Returns 0 on success or -1 on error */
+static int labels_request(const char *agent_id, int *sock, wlabel_t **labels) {
     cJSON *labels_json = wdb_get_agent_labels(atoi(agent_id), sock);
 
     if (labels_json == NULL) {
-        return NULL;
+        return -1;
     }
 
-    labels = labels_parse(labels_json);
+    *labels = labels_parse(labels_json);
     cJSON_Delete(labels_json);
+    return 0;
+}
+
+/* Replace the cached labels of an agent. Call it with label_cache_mutex locked */
+static wlabel_data_t * labels_cache_store(const char *agent_id, wlabel_t *labels) {
+    wlabel_data_t *data = NULL;
 
-    // Cleaning labels from cache
-    if (data = OSHash_Delete(label_cache, agent_id), data) {
+    if (data = (wlabel_data_t*)OSHash_Get(label_cache, agent_id), data) {
         labels_free(data->labels);
-        os_free(data);
+        data->labels = labels;
+        data->mtime = time(NULL);
+        data->refreshing = 0;
+        return data;
     }
 
     // Adding new labels to the cache
@@ -76,9 +94,86 @@ wlabel_data_t * labels_cache_update(char *agent_id, int *sock) {
     return data;
 }
 
+wlabel_data_t * labels_cache_update(char *agent_id, int *sock) {
+    wlabel_t *labels = NULL;
+
+    // Requesting labels to Wazuh DB
+    if (labels_request(agent_id, sock, &labels) < 0) {
+        return NULL;
+    }
+
+    return labels_cache_store(agent_id, labels);
+}
+
+/* Refresh the cached labels of an agent, out of the cache lock */
+STATIC void labels_refresh(const char *agent_id, int *sock) {
+    wlabel_t *labels = NULL;
+    wlabel_data_t *data = NULL;
+    int retval = labels_request(agent_id, sock, &labels);
+
+    w_mutex_lock(&label_cache_mutex);
+
+    if (retval == 0) {
+        labels_cache_store(agent_id, labels);
+    } else if (data = (wlabel_data_t*)OSHash_Get(label_cache, agent_id), data) {
+        // Keep the stale labels, the next event will request them again
+        data->refreshing = 0;
+    }
+
+    w_mutex_unlock(&label_cache_mutex);
+}
+
+/* Load the labels of every agent, so that the first events don't wait for Wazuh DB */
+STATIC void labels_prefetch(int *sock) {
+    char agent_id[OS_SIZE_16];
+    int *agents = wdb_get_all_agents(false, sock);
+    int cached;
+    int i;
+
+    if (agents == NULL) {
+        mdebug1("Unable to get the agent list to prefetch their labels.");
+        return;
+    }
+
+    for (i = 0; agents[i] != -1; i++) {
+        snprintf(agent_id, sizeof(agent_id), "%03d", agents[i]);
+
+        w_mutex_lock(&label_cache_mutex);
+        cached = OSHash_Get(label_cache, agent_id) != NULL;
+        w_mutex_unlock(&label_cache_mutex);
+
+        if (!cached) {
+            labels_refresh(agent_id, sock);
+        }
+    }
+
+    mdebug1("Labels of %d agents prefetched.", i);
+    os_free(agents);
+}
+
+void * labels_refresh_thread(__attribute__((unused)) void * args) {
+    char *agent_id;
+    int sock = -1;
+
+    labels_prefetch(&sock);
+
+    w_mutex_lock(&label_cache_mutex);
+    label_refresh_queue = queue_init(LABELS_REFRESH_QUEUE_SIZE);
+    w_mutex_unlock(&label_cache_mutex);
+
+    while (1) {
+        agent_id = queue_pop_ex(label_refresh_queue);
+        labels_refresh(agent_id, &sock);
+        os_free(agent_id);
+    }
+
+    return NULL;
+}
+
 wlabel_t * labels_find(char *agent_id, int *sock) {
     wlabel_t *ret_labels = NULL;
     wlabel_data_t *data = NULL;
+    char *refresh_id = NULL;
 
     if (strcmp(agent_id, "000") == 0) {
         return Config.labels;
@@ -86,8 +181,19 @@ wlabel_t * labels_find(char *agent_id, int *sock) {
 
     w_mutex_lock(&label_cache_mutex);
     data = (wlabel_data_t*)OSHash_Get(label_cache, agent_id);
-    if (data == NULL || (time(NULL) > data->mtime + Config.label_cache_maxage)) {
+
+    if (data == NULL) {
         data = labels_cache_update(agent_id, sock);
+    } else if (!data->refreshing && time(NULL) > data->mtime + Config.label_cache_maxage) {
+        // Serve the expired labels while they are refreshed in the background
+        os_strdup(agent_id, refresh_id);
+
+        if (label_refresh_queue != NULL && queue_push_ex(label_refresh_queue, refresh_id) == 0) {
+            data->refreshing = 1;
+        } else {
+            os_free(refresh_id);
+            data = labels_cache_update(agent_id, sock);
+        }
     }
 
     if (data != NULL) {
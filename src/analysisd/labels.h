@@ -14,9 +14,12 @@
 
 #include <pthread.h>
 
+#define LABELS_REFRESH_QUEUE_SIZE 4096
+
 typedef struct wlabel_data_t {
     wlabel_t *labels;
     time_t mtime;
+    unsigned int refreshing:1;  // A background refresh is pending
 } wlabel_data_t;
 
 /* Initialize label cache */
@@ -34,4 +37,15 @@ void labels_finalize();
  */
 wlabel_t* labels_find(char *agent_id, int *sock);
 
+/**
+ * @brief Thread that refreshes the expired labels in the background.
+ *
+ * It starts loading the labels of every agent. Until it's running,
+ * expired labels are requested from the event processing threads.
+ *
+ * @param args Unused.
+ * @return Never returns.
+ */
+void * labels_refresh_thread(void * args);
+
 #endif
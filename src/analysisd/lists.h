@@ -28,7 +28,7 @@
  * @brief Struct to save the CDB lists
  */
 typedef struct ListNode {
-    int loaded;
+    _Atomic(int) loaded;
     char *cdb_filename;
     char *txt_filename;
     struct cdb cdb;
@@ -40,7 +40,7 @@ typedef struct ListNode {
  * @brief Struct to asociate rules and CDB lists
  */
 typedef struct ListRule {
-    int loaded;
+    _Atomic(int) loaded;
     int field;
     int lookup_type;
     OSMatch *matcher;
@@ -51,6 +51,11 @@ typedef struct ListRule {
     pthread_mutex_t mutex;
 } ListRule;
 
+/**
+ * @brief Memory of the cdb lists loaded
+ */
+extern w_mem_tag_t os_analysisd_mem_lists;
+
 /**
  * @brief Create the rule list
  */
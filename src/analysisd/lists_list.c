@@ -18,6 +18,7 @@
 
 ListNode *os_analysisd_cdblists;
 ListRule *os_analysisd_cdbrules;
+w_mem_tag_t os_analysisd_mem_lists = W_MEM_TAG_INITIALIZER("lists");
 
 /* Create the ListRule */
 void OS_CreateListsList() {
@@ -121,153 +122,132 @@ ListRule *OS_AddListRule(ListRule *first_rule_list, int lookup_type, int field,
 static int _OS_CDBOpen(ListNode *lnode)
 {
     int fd;
+
+    /* Lists are opened once, the lookups after that don't lock */
+    if (lnode->loaded == 1) {
+        return 0;
+    }
+
+    /* A list can be used by many rules */
+    w_mutex_lock(&lnode->mutex);
     if (lnode->loaded != 1) {
         if ((fd = open(lnode->cdb_filename, O_RDONLY)) == -1) {
+            w_mutex_unlock(&lnode->mutex);
             merror(OPEN_ERROR, lnode->cdb_filename, errno, strerror (errno));
             return -1;
         }
         cdb_init(&lnode->cdb, fd);
+
+        /* The lists are mapped, their pages count once they are read */
+        if (lnode->cdb.map) {
+            w_mem_tag_add(&os_analysisd_mem_lists, lnode->cdb.size, 1);
+        }
+
+        /* Published once the cdb is ready */
         lnode->loaded = 1;
     }
+    w_mutex_unlock(&lnode->mutex);
+    return 0;
+}
+
+/* Match the value stored at vpos against the rule matcher.
+ * Short values are copied into the stack, so most lookups don't allocate.
+ */
+static int _OS_DBMatchValue(ListRule *lrule, uint32 vpos, uint32 vlen)
+{
+    char buffer[OS_SIZE_1024];
+    char *val = buffer;
+    int result;
+
+    if (vlen >= sizeof(buffer)) {
+        os_calloc(vlen + 1, sizeof(char), val);
+    }
+
+    if (cdb_read(&lrule->db->cdb, val, vlen, vpos) == -1) {
+        memset(val, 0, vlen);
+    }
+    val[vlen] = '\0';
+
+    result = OSMatch_Execute(val, vlen, lrule->matcher);
+
+    if (val != buffer) {
+        free(val);
+    }
+    return result;
+}
+
+/* Look for an address or, if it is not in the list, for the longest of
+ * its prefixes ending in a dot (e.g. "192.168.1." for "192.168.1.10").
+ * Returns 1 if found, 0 otherwise.
+ */
+static int _OS_DBFindAddress(ListRule *lrule, const char *key, uint32 *vpos, uint32 *vlen)
+{
+    size_t len = strlen(key);
+
+    if (cdb_find_r(&lrule->db->cdb, key, len, vpos, vlen) > 0) {
+        return 1;
+    }
+
+    for (; len > 0; len--) {
+        if (key[len - 1] == '.' && cdb_find_r(&lrule->db->cdb, key, len, vpos, vlen) > 0) {
+            return 1;
+        }
+    }
     return 0;
 }
 
 static int OS_DBSearchKeyValue(ListRule *lrule, char *key)
 {
-    int result = -1;
-    char *val;
-    unsigned vlen, vpos;
-    w_mutex_lock(&lrule->mutex);
+    uint32 vlen, vpos;
     if (lrule->db != NULL) {
         if (_OS_CDBOpen(lrule->db) == -1) {
-            w_mutex_unlock(&lrule->mutex);
             return 0;
         }
-        if (cdb_find(&lrule->db->cdb, key, strlen(key)) > 0 ) {
-            vpos = cdb_datapos(&lrule->db->cdb);
-            vlen = cdb_datalen(&lrule->db->cdb);
-            val = (char *) calloc(vlen + 1, sizeof(char));
-
-            w_mutex_unlock(&lrule->mutex);
-            if (!val){
-                return 0;
-            }
-
-            w_mutex_lock(&lrule->db->cdb.mutex)
-            cdb_read(&lrule->db->cdb, val, vlen, vpos);
-            w_mutex_unlock(&lrule->db->cdb.mutex);
-            result = OSMatch_Execute(val, vlen, lrule->matcher);
-            free(val);
-            return result;
-        } else {
-            w_mutex_unlock(&lrule->mutex);
-            return 0;
+        if (cdb_find_r(&lrule->db->cdb, key, strlen(key), &vpos, &vlen) > 0) {
+            return _OS_DBMatchValue(lrule, vpos, vlen);
         }
     }
-    w_mutex_unlock(&lrule->mutex);
     return 0;
 }
 
 static int OS_DBSeachKey(ListRule *lrule, char *key)
 {
-    w_mutex_lock(&lrule->mutex);
+    uint32 vlen, vpos;
     if (lrule->db != NULL) {
         if (_OS_CDBOpen(lrule->db) == -1) {
-            w_mutex_unlock(&lrule->mutex);
             return -1;
         }
-        w_mutex_unlock(&lrule->mutex);
-        if ( cdb_find(&lrule->db->cdb, key, strlen(key)) > 0 ) {
+        if (cdb_find_r(&lrule->db->cdb, key, strlen(key), &vpos, &vlen) > 0) {
             return 1;
         }
-    }else {
-        w_mutex_unlock(&lrule->mutex);
     }
     return 0;
 }
 
 static int OS_DBSeachKeyAddress(ListRule *lrule, char *key)
 {
-    w_mutex_lock(&lrule->mutex);
+    uint32 vlen, vpos;
     if (lrule->db != NULL) {
         if (_OS_CDBOpen(lrule->db) == -1) {
-            w_mutex_unlock(&lrule->mutex);
             return -1;
         }
-        w_mutex_unlock(&lrule->mutex);
-        if ( cdb_find(&lrule->db->cdb, key, strlen(key)) > 0 ) {
-            return 1;
-        } else {
-            char *tmpkey;
-            os_strdup(key, tmpkey);
-            while (strlen(tmpkey) > 0) {
-                if (tmpkey[strlen(tmpkey) - 1] == '.') {
-                    if ( cdb_find(&lrule->db->cdb, tmpkey, strlen(tmpkey)) > 0 ) {
-                        free(tmpkey);
-                        return 1;
-                    }
-                }
-                tmpkey[strlen(tmpkey) - 1] = '\0';
-            }
-            free(tmpkey);
-        }
-    }else{
-        w_mutex_unlock(&lrule->mutex);
+        return _OS_DBFindAddress(lrule, key, &vpos, &vlen);
     }
     return 0;
 }
 
 static int OS_DBSearchKeyAddressValue(ListRule *lrule, char *key)
 {
-    int result = -1;
-    char *val;
-    unsigned vlen, vpos;
-    w_mutex_lock(&lrule->mutex);
+    uint32 vlen, vpos;
     if (lrule->db != NULL) {
         if (_OS_CDBOpen(lrule->db) == -1) {
-            w_mutex_unlock(&lrule->mutex);
             return 0;
         }
 
-        w_mutex_unlock(&lrule->mutex);
-
-        /* First lookup for a single IP address */
-        if (cdb_find(&lrule->db->cdb, key, strlen(key)) > 0 ) {
-            vpos = cdb_datapos(&lrule->db->cdb);
-            vlen = cdb_datalen(&lrule->db->cdb);
-            os_calloc(vlen, sizeof(char), val);
-            w_mutex_lock(&lrule->db->cdb.mutex)
-            cdb_read(&lrule->db->cdb, val, vlen, vpos);
-            w_mutex_unlock(&lrule->db->cdb.mutex)
-            result = OSMatch_Execute(val, vlen, lrule->matcher);
-            free(val);
-            return result;
-        } else {
-            /* IP address not found, look for matching subnets */
-            char *tmpkey;
-            os_strdup(key, tmpkey);
-            while (strlen(tmpkey) > 0) {
-                if (tmpkey[strlen(tmpkey) - 1] == '.') {
-                    if ( cdb_find(&lrule->db->cdb, tmpkey, strlen(tmpkey)) > 0 ) {
-                        vpos = cdb_datapos(&lrule->db->cdb);
-                        vlen = cdb_datalen(&lrule->db->cdb);
-                        os_calloc(vlen, sizeof(char), val);
-                        w_mutex_lock(&lrule->db->cdb.mutex)
-                        cdb_read(&lrule->db->cdb, val, vlen, vpos);
-                        w_mutex_unlock(&lrule->db->cdb.mutex)
-                        result = OSMatch_Execute(val, vlen, lrule->matcher);
-                        free(val);
-                        free(tmpkey);
-                        return result;
-                    }
-                }
-                tmpkey[strlen(tmpkey) - 1] = '\0';
-            }
-            free(tmpkey);
-            return 0;
+        /* Look for a single IP address, then for matching subnets */
+        if (_OS_DBFindAddress(lrule, key, &vpos, &vlen)) {
+            return _OS_DBMatchValue(lrule, vpos, vlen);
         }
-    }else{
-        w_mutex_unlock(&lrule->mutex);
     }
     return 0;
 }
@@ -275,12 +255,15 @@ static int OS_DBSearchKeyAddressValue(ListRule *lrule, char *key)
 int OS_DBSearch(ListRule *lrule, char *key, ListNode **l_node)
 {
     //XXX - god damn hack!!! Jeremy Rossi
-    w_mutex_lock(&lrule->mutex);
+    /* The list of the rule is resolved once, db is set before loaded */
     if (lrule->loaded == 0) {
-        lrule->db = OS_FindList(lrule->filename, l_node);
-        lrule->loaded = 1;
+        w_mutex_lock(&lrule->mutex);
+        if (lrule->loaded == 0) {
+            lrule->db = OS_FindList(lrule->filename, l_node);
+            lrule->loaded = 1;
+        }
+        w_mutex_unlock(&lrule->mutex);
     }
-    w_mutex_unlock(&lrule->mutex);
 
     switch (lrule->lookup_type) {
         case LR_STRING_MATCH:
@@ -325,6 +308,14 @@ void os_remove_cdblist(ListNode **l_node) {
         tmp = *l_node;
         *l_node = (*l_node)->next;
 
+        if (tmp->loaded == 1) {
+            if (tmp->cdb.map) {
+                w_mem_tag_add(&os_analysisd_mem_lists, -(int64_t)tmp->cdb.size, -1);
+            }
+            cdb_free(&tmp->cdb);
+            close(tmp->cdb.fd);
+        }
+
         os_free(tmp->cdb_filename);
         os_free(tmp->txt_filename);
         os_free(tmp);
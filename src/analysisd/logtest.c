@@ -12,6 +12,8 @@
 
 
 OSHash *w_logtest_sessions;
+w_logtest_decoders_t *w_logtest_shared_decoders;
+static pthread_mutex_t w_logtest_decoders_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
 void *w_logtest_init() {
@@ -199,6 +201,7 @@ cJSON * w_logtest_process_log(cJSON * request, w_logtest_session_t * session,
 
     /* Decoding */
     w_logtest_decoding_phase(lf, session);
+    extra_data->decoders_tried = lf->decoders_tried;
 
     /* Run accumulator */
     if (lf->decoder_info->accumulate == 1) {
@@ -367,6 +370,7 @@ int w_logtest_rulesmatching_phase(Eventinfo * lf, w_logtest_session_t * session,
             } else {
                 lf->sid_node_to_delete = ruleinformation->sid_prev_matched->last_node;
             }
+            OS_AddCorrelationEvent(ruleinformation, lf);
         }
 
         /* Group list */
@@ -425,22 +429,7 @@ w_logtest_session_t * w_logtest_initialize_session(OSList * list_msg) {
     }
 
     /* Load decoders */
-    session->decoderlist_forpname = NULL;
-    session->decoderlist_nopname = NULL;
-    session->decoder_store = NULL;
-
-    files = ruleset_config.decoders;
-
-    while (files != NULL && *files != NULL) {
-        if (ReadDecodeXML(*files, &session->decoderlist_forpname,
-            &session->decoderlist_nopname, &session->decoder_store, list_msg) == 0) {
-            goto cleanup;
-        }
-        files++;
-    }
-
-    if (SetDecodeXML(list_msg, &session->decoder_store, &session->decoderlist_nopname,
-                     &session->decoderlist_forpname) == 0) {
+    if (!w_logtest_decoders_load(session, ruleset_config.decoders, list_msg)) {
         goto cleanup;
     }
 
@@ -485,6 +474,9 @@ w_logtest_session_t * w_logtest_initialize_session(OSList * list_msg) {
 
     AddHash_Rule(session->rule_list);
 
+    /* Index the children of each rule */
+    OS_BuildRuleIndex(session->rule_list);
+
     /* Initiate the FTS list */
     if (!w_logtest_fts_init(&session->fts_list, &session->fts_store)) {
         goto cleanup;
@@ -518,9 +510,13 @@ cleanup:
         }
 
         /* Remove decoder lists */
-        os_remove_decoders_list(session->decoderlist_forpname, session->decoderlist_nopname);
-        if (session->decoder_store != NULL) {
-            OSStore_Free(session->decoder_store);
+        if (session->decoders != NULL) {
+            w_logtest_decoders_release(session->decoders);
+        } else {
+            os_remove_decoders_list(session->decoderlist_forpname, session->decoderlist_nopname);
+            if (session->decoder_store != NULL) {
+                OSStore_Free(session->decoder_store);
+            }
         }
 
         /* Remove cdblistnode and cdblistrule */
@@ -535,7 +531,7 @@ cleanup:
 
         /* Remove accumulator hash */
         if (session->acm_store) {
-            OSHash_Free(session->acm_store);
+            w_analysisd_accumulate_free(&session->acm_store);
         }
 
         /* Free memory allocated in OSRegex execution */
@@ -573,8 +569,12 @@ void w_logtest_remove_session(char *token) {
     OSHash_Free(session->g_rules_hash);
 
     /* Remove decoder lists */
-    os_remove_decoders_list(session->decoderlist_forpname, session->decoderlist_nopname);
-    OSStore_Free(session->decoder_store);
+    if (session->decoders != NULL) {
+        w_logtest_decoders_release(session->decoders);
+    } else {
+        os_remove_decoders_list(session->decoderlist_forpname, session->decoderlist_nopname);
+        OSStore_Free(session->decoder_store);
+    }
 
     /* Remove cdblistnode and cdblistrule */
     os_remove_cdblist(&session->cdblistnode);
@@ -602,6 +602,126 @@ void w_logtest_remove_session(char *token) {
 }
 
 
+char * w_logtest_decoders_signature(char ** files) {
+
+    char * signature = NULL;
+    char entry[PATH_MAX + OS_SIZE_64];
+    struct stat file_stat;
+
+    if (files == NULL) {
+        return NULL;
+    }
+
+    for (; *files != NULL; files++) {
+        if (stat(*files, &file_stat) != 0) {
+            os_free(signature);
+            return NULL;
+        }
+
+        snprintf(entry, sizeof(entry), "%s:%lld:%lld", *files, (long long) file_stat.st_size,
+                 (long long) file_stat.st_mtime);
+        wm_strcat(&signature, entry, '|');
+    }
+
+    return signature;
+}
+
+bool w_logtest_decoders_read(w_logtest_session_t * session, char ** files, OSList * list_msg) {
+
+    session->decoderlist_forpname = NULL;
+    session->decoderlist_nopname = NULL;
+    session->decoder_store = NULL;
+    session->decoders = NULL;
+
+    while (files != NULL && *files != NULL) {
+        if (ReadDecodeXML(*files, &session->decoderlist_forpname,
+            &session->decoderlist_nopname, &session->decoder_store, list_msg) == 0) {
+            return false;
+        }
+        files++;
+    }
+
+    if (SetDecodeXML(list_msg, &session->decoder_store, &session->decoderlist_nopname,
+                     &session->decoderlist_forpname) == 0) {
+        return false;
+    }
+
+    /* Index the parent decoders */
+    OS_BuildDecoderIndex(session->decoderlist_forpname);
+    OS_BuildDecoderIndex(session->decoderlist_nopname);
+
+    return true;
+}
+
+bool w_logtest_decoders_load(w_logtest_session_t * session, char ** files, OSList * list_msg) {
+
+    w_logtest_decoders_t * old_decoders = NULL;
+    w_logtest_decoders_t * decoders = NULL;
+    char * signature = NULL;
+
+    /* Decoders whose files can't be checked are never shared */
+    if (signature = w_logtest_decoders_signature(files), signature == NULL) {
+        return w_logtest_decoders_read(session, files, list_msg);
+    }
+
+    w_mutex_lock(&w_logtest_decoders_mutex);
+
+    if (w_logtest_shared_decoders != NULL && strcmp(w_logtest_shared_decoders->signature, signature) == 0) {
+        os_free(signature);
+    } else if (!w_logtest_decoders_read(session, files, list_msg)) {
+        w_mutex_unlock(&w_logtest_decoders_mutex);
+        os_free(signature);
+        return false;
+    } else {
+        /* The sessions still using the previous decoders keep them until they are removed */
+        os_calloc(1, sizeof(w_logtest_decoders_t), decoders);
+        decoders->decoderlist_forpname = session->decoderlist_forpname;
+        decoders->decoderlist_nopname = session->decoderlist_nopname;
+        decoders->decoder_store = session->decoder_store;
+        decoders->signature = signature;
+        decoders->references = 1;
+
+        old_decoders = w_logtest_shared_decoders;
+        w_logtest_shared_decoders = decoders;
+    }
+
+    decoders = w_logtest_shared_decoders;
+    decoders->references++;
+
+    session->decoderlist_forpname = decoders->decoderlist_forpname;
+    session->decoderlist_nopname = decoders->decoderlist_nopname;
+    session->decoder_store = decoders->decoder_store;
+    session->decoders = decoders;
+
+    w_mutex_unlock(&w_logtest_decoders_mutex);
+
+    if (old_decoders != NULL) {
+        w_logtest_decoders_release(old_decoders);
+    }
+
+    return true;
+}
+
+void w_logtest_decoders_release(w_logtest_decoders_t * decoders) {
+
+    bool unused;
+
+    w_mutex_lock(&w_logtest_decoders_mutex);
+    unused = --decoders->references == 0;
+    w_mutex_unlock(&w_logtest_decoders_mutex);
+
+    if (!unused) {
+        return;
+    }
+
+    os_remove_decoders_list(decoders->decoderlist_forpname, decoders->decoderlist_nopname);
+    if (decoders->decoder_store != NULL) {
+        OSStore_Free(decoders->decoder_store);
+    }
+    os_free(decoders->signature);
+    os_free(decoders);
+}
+
 void *w_logtest_check_inactive_sessions(w_logtest_connection_t * connection) {
 
     OSHashNode *hash_node;
@@ -1063,7 +1183,7 @@ int w_logtest_process_request_log_processing(cJSON * json_request, cJSON * json_
 
     cJSON * json_log_processed = NULL;
 
-    w_logtest_extra_data_t extra_data = {.alert_generated = false, .rules_debug_list = NULL};
+    w_logtest_extra_data_t extra_data = {.alert_generated = false, .rules_debug_list = NULL, .decoders_tried = 0};
 
     /* Search an active session */
     cJSON * j_token;
@@ -1138,6 +1258,7 @@ int w_logtest_process_request_log_processing(cJSON * json_request, cJSON * json_
 
     if (extra_data.rules_debug_list != NULL) {
         cJSON_AddItemToObject(json_response, W_LOGTEST_JSON_OPT_RULES_DEBUG, extra_data.rules_debug_list);
+        cJSON_AddNumberToObject(json_response, W_LOGTEST_JSON_DECODERS_TRIED, extra_data.decoders_tried);
     }
 
     /* Generate response */
@@ -52,6 +52,7 @@
 #define W_LOGTEST_JSON_OUTPUT                  "output"   ///< Output field name of json output
 #define W_LOGTEST_JSON_OPT                    "options"   ///< Requests options
 #define W_LOGTEST_JSON_OPT_RULES_DEBUG    "rules_debug"   ///< Enables rules debug option
+#define W_LOGTEST_JSON_DECODERS_TRIED  "decoders_tried"   ///< Parent decoders tried, reported with rules debug
 
 
 /* Commands allowed */
@@ -78,6 +79,21 @@
 #define valid_str_session(x,y) (cJSON_IsString(x) && x->valuestring && strlen(x->valuestring) == y) ? 1 : 0)
 
 
+/**
+ * @brief Decoders shared by the sessions created from the same decoder files
+ *
+ * Decoders aren't modified after being loaded, each session keeps its own matching state
+ */
+typedef struct w_logtest_decoders_t {
+
+    OSDecoderNode *decoderlist_forpname;    ///< Decoder list to match logs which have a program name
+    OSDecoderNode *decoderlist_nopname;     ///< Decoder list to match logs which haven't a program name
+    OSStore *decoder_store;                 ///< Decoder list to save internals decoders
+    char *signature;                        ///< Files, sizes and modification times the decoders were loaded from
+    unsigned int references;                ///< Sessions using the decoders, plus one while they are the latest ones
+
+} w_logtest_decoders_t;
+
 /**
  * @brief A w_logtest_session_t instance represents a client
  */
@@ -91,13 +107,14 @@ typedef struct w_logtest_session_t {
     OSDecoderNode *decoderlist_forpname;    ///< Decoder list to match logs which have a program name
     OSDecoderNode *decoderlist_nopname;     ///< Decoder list to match logs which haven't a program name
     OSStore *decoder_store;                 ///< Decoder list to save internals decoders
+    w_logtest_decoders_t *decoders;         ///< Shared decoders, NULL if the session owns its decoder lists
     ListNode *cdblistnode;                  ///< List of CDB lists
     ListRule *cdblistrule;                  ///< List to attach rules and CDB lists
     EventList *eventlist;                   ///< Previous events list
     OSHash *g_rules_hash;                   ///< Hash table of rules
     OSList *fts_list;                       ///< Save FTS previous events
     OSHash *fts_store;                      ///< Save FTS values processed
-    OSHash *acm_store;                      ///< Hash to save data which have the same id
+    OS_ACM_Hash *acm_store;                 ///< Hash to save data which have the same id
     int acm_lookups;                        ///< Counter of the number of times purged. Option accumulate
     time_t acm_purge_ts;                    ///< Counter of the time interval of last purge. Option accumulate
     regex_matching decoder_match;           ///< Used for decoding phase
@@ -112,6 +129,7 @@ typedef struct w_logtest_session_t {
 typedef struct {
     bool alert_generated;         ///< It is set to true when an alert is generated
     cJSON * rules_debug_list;     ///< It contains a list of the processed rules messages if the verbose mode is enabled
+    int decoders_tried;           ///< Number of parent decoders tried for the event
 } w_logtest_extra_data_t;
 
 /**
@@ -119,6 +137,11 @@ typedef struct {
  */
 extern OSHash *w_logtest_sessions;
 
+/**
+ * @brief Latest decoders loaded, reused by new sessions while their files don't change
+ */
+extern w_logtest_decoders_t *w_logtest_shared_decoders;
+
 /**
  * @brief An instance of w_logtest_connection allow managing the connections with the logtest socket
  */
@@ -215,6 +238,40 @@ w_logtest_session_t *w_logtest_initialize_session(OSList * list_msg);
  */
 void w_logtest_remove_session(char * token);
 
+/**
+ * @brief Get a signature of the decoder files
+ * @param files decoder files
+ * @return NULL if any file can't be checked, otherwise the paths, sizes and modification times of the files
+ */
+char * w_logtest_decoders_signature(char ** files);
+
+/**
+ * @brief Read, set and index the decoders of a session
+ * @param session client session, it owns the decoder lists
+ * @param files decoder files
+ * @param list_msg list of error/warn/info messages
+ * @return true on success, otherwise false
+ */
+bool w_logtest_decoders_read(w_logtest_session_t * session, char ** files, OSList * list_msg);
+
+/**
+ * @brief Load the decoders of a session
+ *
+ * The latest decoders are reused if they were loaded from the same files and these haven't changed.
+ * Otherwise, the decoders are loaded and, if their files can be checked, shared with the next sessions
+ * @param session client session
+ * @param files decoder files
+ * @param list_msg list of error/warn/info messages
+ * @return true on success, otherwise false. On failure the session owns the decoders loaded so far
+ */
+bool w_logtest_decoders_load(w_logtest_session_t * session, char ** files, OSList * list_msg);
+
+/**
+ * @brief Release a reference to shared decoders, they are freed when nobody uses them
+ * @param decoders shared decoders
+ */
+void w_logtest_decoders_release(w_logtest_decoders_t * decoders);
+
 /**
  * @brief Check the inactive logtest sessions
  *
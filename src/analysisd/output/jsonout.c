@@ -12,27 +12,41 @@
 #include "alerts/getloglocation.h"
 #include "format/to_json.h"
 
+/* Serialization buffers, reused across events. Several writer threads use them, always with writer_threads_mutex held. */
+static char *alert_buffer;
+static size_t alert_buffer_size;
+static char *archive_buffer;
+static size_t archive_buffer_size;
+
 void jsonout_output_event(const Eventinfo *lf)
 {
-    char *json_alert = Eventinfo_to_jsonstr(lf, false, NULL);
+    long json_len = Eventinfo_to_jsonbuf(lf, false, NULL, &alert_buffer, &alert_buffer_size);
 
-    fprintf(_jflog,
-            "%s\n",
-            json_alert);
-    if (strstr(json_alert,"gcp")) {
-        mdebug2("Sending gcp event: %s", json_alert);
+    if (json_len < 0) {
+        return;
+    }
+
+    /* The buffer always keeps room for the trailing newline */
+    alert_buffer[json_len] = '\n';
+    fwrite(alert_buffer, 1, json_len + 1, _jflog);
+    alert_buffer[json_len] = '\0';
+
+    if (strstr(alert_buffer, "gcp")) {
+        mdebug2("Sending gcp event: %s", alert_buffer);
     }
-    free(json_alert);
     return;
 }
 void jsonout_output_archive(const Eventinfo *lf)
 {
-    char *json_alert;
+    long json_len;
 
     if (strcmp(lf->location, "ossec-keepalive") && !strstr(lf->location, "->ossec-keepalive")) {
-        json_alert = Eventinfo_to_jsonstr(lf, true, NULL);
-        fprintf(_ejflog, "%s\n", json_alert);
-        free(json_alert);
+        json_len = Eventinfo_to_jsonbuf(lf, true, NULL, &archive_buffer, &archive_buffer_size);
+
+        if (json_len >= 0) {
+            archive_buffer[json_len] = '\n';
+            fwrite(archive_buffer, 1, json_len + 1, _ejflog);
+        }
     }
 }
 
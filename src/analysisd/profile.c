@@ -0,0 +1,197 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifdef WAZUH_UNIT_TESTING
+// Remove static qualifier when unit testing
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#include "shared.h"
+#include "profile.h"
+#include "ruleset.h"
+
+/* Element of the report: a rule or a decoder with a copy of its counters */
+typedef struct {
+    const void * item;
+    uint64_t evaluations;
+    uint64_t matches;
+    uint64_t total_ns;
+    uint64_t regex_ns;
+    uint64_t lists_ns;
+} w_profile_entry_t;
+
+typedef struct {
+    w_profile_entry_t * entries;
+    size_t size;
+    size_t capacity;
+} w_profile_list_t;
+
+/**
+ * @brief Append a rule or a decoder to the report list
+ * @param list Report list
+ * @param item Rule or decoder
+ * @param profile Its profile
+ */
+STATIC void w_profile_list_add(w_profile_list_t * list, const void * item, w_profile_t * profile);
+
+/**
+ * @brief Sort the report list by total time and remove the repeated items
+ *
+ * A rule with several parents (or a decoder of both lists) is reached more than once.
+ * @param list Report list
+ */
+STATIC void w_profile_list_sort(w_profile_list_t * list);
+
+uint64_t w_profile_now() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void w_profile_add(_Atomic(uint64_t) * counter, uint64_t start) {
+    *counter += w_profile_now() - start;
+}
+
+void w_profile_evaluation(w_profile_t * profile, uint64_t start, bool matched) {
+    w_profile_add(&profile->total_ns, start);
+    profile->evaluations++;
+
+    if (matched) {
+        profile->matches++;
+    }
+}
+
+STATIC void w_profile_list_add(w_profile_list_t * list, const void * item, w_profile_t * profile) {
+    w_profile_entry_t * entry;
+
+    if (profile->evaluations == 0) {
+        return;
+    }
+
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : OS_SIZE_128;
+        os_realloc(list->entries, list->capacity * sizeof(w_profile_entry_t), list->entries);
+    }
+
+    entry = &list->entries[list->size++];
+    entry->item = item;
+    entry->evaluations = profile->evaluations;
+    entry->matches = profile->matches;
+    entry->total_ns = profile->total_ns;
+    entry->regex_ns = profile->regex_ns;
+    entry->lists_ns = profile->lists_ns;
+}
+
+static int w_profile_compare_item(const void * a, const void * b) {
+    const w_profile_entry_t * x = a;
+    const w_profile_entry_t * y = b;
+
+    return x->item < y->item ? -1 : x->item > y->item;
+}
+
+static int w_profile_compare_time(const void * a, const void * b) {
+    const w_profile_entry_t * x = a;
+    const w_profile_entry_t * y = b;
+
+    return x->total_ns > y->total_ns ? -1 : x->total_ns < y->total_ns;
+}
+
+STATIC void w_profile_list_sort(w_profile_list_t * list) {
+    size_t i;
+    size_t size = 0;
+
+    if (list->size == 0) {
+        return;
+    }
+
+    qsort(list->entries, list->size, sizeof(w_profile_entry_t), w_profile_compare_item);
+
+    for (i = 0; i < list->size; i++) {
+        if (size == 0 || list->entries[size - 1].item != list->entries[i].item) {
+            list->entries[size++] = list->entries[i];
+        }
+    }
+
+    list->size = size;
+    qsort(list->entries, list->size, sizeof(w_profile_entry_t), w_profile_compare_time);
+}
+
+static void w_profile_add_rules(w_profile_list_t * list, RuleNode * node) {
+    for (; node; node = node->next) {
+        w_profile_list_add(list, node->ruleinfo, &node->ruleinfo->profile);
+        w_profile_add_rules(list, node->child);
+    }
+}
+
+static void w_profile_add_decoders(w_profile_list_t * list, OSDecoderNode * node) {
+    for (; node; node = node->next) {
+        w_profile_list_add(list, node->osdecoder, &node->osdecoder->profile);
+        w_profile_add_decoders(list, node->child);
+    }
+}
+
+static cJSON * w_profile_entry_json(const w_profile_entry_t * entry) {
+    cJSON * json = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(json, "evaluations", entry->evaluations);
+    cJSON_AddNumberToObject(json, "matches", entry->matches);
+    cJSON_AddNumberToObject(json, "total_us", entry->total_ns / 1000);
+    cJSON_AddNumberToObject(json, "avg_ns", entry->total_ns / entry->evaluations);
+    cJSON_AddNumberToObject(json, "regex_us", entry->regex_ns / 1000);
+
+    return json;
+}
+
+cJSON * w_profile_report(w_ruleset_t * ruleset, unsigned int limit) {
+    w_profile_list_t rules = { .entries = NULL };
+    w_profile_list_t decoders = { .entries = NULL };
+    cJSON * report = cJSON_CreateObject();
+    cJSON * rules_json = cJSON_CreateArray();
+    cJSON * decoders_json = cJSON_CreateArray();
+    size_t i;
+
+    cJSON_AddNumberToObject(report, "generation", ruleset->generation);
+    cJSON_AddItemToObject(report, "rules", rules_json);
+    cJSON_AddItemToObject(report, "decoders", decoders_json);
+
+    w_profile_add_rules(&rules, ruleset->rule_list);
+    w_profile_list_sort(&rules);
+
+    for (i = 0; i < rules.size && (limit == 0 || i < limit); i++) {
+        const RuleInfo * rule = rules.entries[i].item;
+        cJSON * json = w_profile_entry_json(&rules.entries[i]);
+
+        cJSON_AddNumberToObject(json, "lists_us", rules.entries[i].lists_ns / 1000);
+        cJSON_AddNumberToObject(json, "id", rule->sigid);
+        cJSON_AddNumberToObject(json, "level", rule->level);
+        cJSON_AddStringToObject(json, "file", rule->file ? rule->file : "");
+        cJSON_AddItemToArray(rules_json, json);
+    }
+
+    w_profile_add_decoders(&decoders, ruleset->decoderlist_pn);
+    w_profile_add_decoders(&decoders, ruleset->decoderlist_nopn);
+    w_profile_list_sort(&decoders);
+
+    for (i = 0; i < decoders.size && (limit == 0 || i < limit); i++) {
+        const OSDecoderInfo * decoder = decoders.entries[i].item;
+        cJSON * json = w_profile_entry_json(&decoders.entries[i]);
+
+        cJSON_AddStringToObject(json, "name", decoder->name);
+        cJSON_AddStringToObject(json, "parent", decoder->parent ? decoder->parent : "");
+        cJSON_AddItemToArray(decoders_json, json);
+    }
+
+    os_free(rules.entries);
+    os_free(decoders.entries);
+
+    return report;
+}
@@ -0,0 +1,62 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef PROFILE_A_H
+#define PROFILE_A_H
+
+#include "shared.h"
+
+/**
+ * @brief Cost accounting of a rule or a decoder
+ *
+ * Only updated when the ruleset profiling is enabled (analysisd.profile_ruleset).
+ * The counters are shared by every rule matching thread.
+ */
+typedef struct {
+    _Atomic(uint64_t) evaluations;      ///< Times the rule or decoder was tried
+    _Atomic(uint64_t) matches;          ///< Times it matched
+    _Atomic(uint64_t) total_ns;         ///< Time spent checking it, without its children
+    _Atomic(uint64_t) regex_ns;         ///< Time spent in its expressions (osmatch, osregex, pcre2...)
+    _Atomic(uint64_t) lists_ns;         ///< Time spent in its CDB list lookups
+} w_profile_t;
+
+struct _w_ruleset_t;
+
+/**
+ * @brief Get a monotonic timestamp to measure a profiled section
+ * @return Nanoseconds
+ */
+uint64_t w_profile_now();
+
+/**
+ * @brief Add the time elapsed since start to a profile counter
+ * @param counter Counter to update
+ * @param start Value returned by w_profile_now()
+ */
+void w_profile_add(_Atomic(uint64_t) * counter, uint64_t start);
+
+/**
+ * @brief Account an evaluation of a rule or a decoder
+ * @param profile Profile to update
+ * @param start Value returned by w_profile_now() when the evaluation started
+ * @param matched Whether the rule or decoder matched
+ */
+void w_profile_evaluation(w_profile_t * profile, uint64_t start, bool matched);
+
+/**
+ * @brief Create the profiling report of a ruleset generation
+ *
+ * Rules and decoders are sorted by total time, most expensive first.
+ * @param ruleset Generation held by the caller
+ * @param limit Maximum number of rules and decoders to report, 0 means all
+ * @return JSON object with the "rules" and "decoders" arrays
+ */
+cJSON * w_profile_report(struct _w_ruleset_t * ruleset, unsigned int limit);
+
+#endif /* PROFILE_A_H */
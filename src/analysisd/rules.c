@@ -54,6 +54,14 @@ STATIC int doesRuleExist(int sid, RuleNode *r_node);
 STATIC void Rule_AddAR(RuleInfo *config_rule);
 STATIC char *loadmemory(char *at, const char *str, OSList* log_msg);
 STATIC void printRuleinfo(const RuleInfo *rule, int node);
+STATIC u_int16_t OS_GetRuleIndexFields(const struct _Eventinfo *lf);
+STATIC RuleInfo * OS_CheckIfIndexedRuleMatch(struct _Eventinfo *lf, EventList *last_events,
+                                             ListNode **cdblists, const RuleIndex *index,
+                                             regex_matching *rule_match, OSList **fts_list,
+                                             OSHash **fts_store, const bool save_fts_value);
+STATIC bool OS_CheckRuleConditions(struct _Eventinfo *lf, EventList *last_events, ListNode **cdblists,
+                                   RuleInfo *rule, regex_matching *rule_match, OSList **fts_list,
+                                   OSHash **fts_store, const bool save_fts_value);
 
 /**
  * @brief Free the rules_tmp_params_t structure members
@@ -1337,6 +1345,8 @@ int Rules_OP_ReadRules(const char *rulefile, RuleNode **r_node, ListNode **l_nod
                             config_ruleinfo->alert_opts |= NO_FULL_LOG;
                         } else if (strcmp("no_counter", rule_tmp_params.rule_arr_opt[k]->content) == 0) {
                             config_ruleinfo->alert_opts |= NO_COUNTER;
+                        } else if (strcmp("agent_drop", rule_tmp_params.rule_arr_opt[k]->content) == 0) {
+                            config_ruleinfo->alert_opts |= AGENT_DROP;
                         } else {
                             smerror(log_msg, XML_VALUEERR, xml_options, rule_tmp_params.rule_arr_opt[k]->content);
                             smerror(log_msg, "Invalid option '%s' for rule '%d'.", rule_tmp_params.rule_arr_opt[k]->element,
@@ -2169,6 +2179,9 @@ RuleInfo *zerorulemember(int id, int level, int maxsize, int frequency,
     ruleinfo_pt->group_prev_matched = NULL;
 
     ruleinfo_pt->sid_search = NULL;
+    ruleinfo_pt->sid_index = NULL;
+    ruleinfo_pt->sid_correlated = NULL;
+    ruleinfo_pt->sid_correlated_sz = 0;
     ruleinfo_pt->group_search = NULL;
 
     ruleinfo_pt->event_search = NULL;
@@ -2484,6 +2497,12 @@ STATIC void printRuleinfo(const RuleInfo *rule, int node)
 
 /* Add rule to hash */
 int AddHash_Rule(RuleNode *node)
+{
+    return OS_AddRulesHash(Config.g_rules_hash, node);
+}
+
+/* Add every rule of a tree to a hash */
+int OS_AddRulesHash(OSHash *hash, RuleNode *node)
 {
     char id_key[15] = {'\0'};
 
@@ -2492,12 +2511,12 @@ int AddHash_Rule(RuleNode *node)
 
         /* Add key to hash */
         /* Ignore if the key is already stored */
-        if (!OSHash_Add(Config.g_rules_hash, id_key, node->ruleinfo)) {
+        if (!OSHash_Add(hash, id_key, node->ruleinfo)) {
             merror("At AddHash_Rule(): OSHash_Add() failed");
             break;
         }
 
-        if (node->child) AddHash_Rule(node->child);
+        if (node->child) OS_AddRulesHash(hash, node->child);
 
         node = node->next;
     }
@@ -2505,6 +2524,78 @@ int AddHash_Rule(RuleNode *node)
     return (0);
 }
 
+/* Assign the active responses to every rule of a tree */
+void OS_AddRulesAR(RuleNode *node)
+{
+    while (node) {
+        /* A rule with several parents is reached once per parent */
+        if (!node->ruleinfo->ar) {
+            Rule_AddAR(node->ruleinfo);
+        }
+
+        if (node->child) {
+            OS_AddRulesAR(node->child);
+        }
+
+        node = node->next;
+    }
+}
+
+/* Add the names of a NULL terminated list of dynamic fields */
+static void _OS_AddFieldNames(OSHash *fields, char **names, void *rule)
+{
+    for (; names && *names; names++) {
+        OSHash_Add_ins(fields, *names, rule);
+    }
+}
+
+void OS_AddRulesFields(OSHash *fields, RuleNode *node)
+{
+    char *comment;
+    RuleInfo *rule;
+    ListRule *list;
+    char *var;
+    char *end;
+    int i;
+
+    while (node) {
+        rule = node->ruleinfo;
+
+        for (i = 0; rule->fields && rule->fields[i]; i++) {
+            OSHash_Add_ins(fields, rule->fields[i]->name, rule);
+        }
+
+        for (list = rule->lists; list; list = list->next) {
+            if (list->dfield) {
+                OSHash_Add_ins(fields, list->dfield, rule);
+            }
+        }
+
+        _OS_AddFieldNames(fields, rule->same_fields, rule);
+        _OS_AddFieldNames(fields, rule->not_same_fields, rule);
+        _OS_AddFieldNames(fields, rule->ignore_fields, rule);
+        _OS_AddFieldNames(fields, rule->ckignore_fields, rule);
+
+        /* The static field names are added too, that is harmless */
+        if (rule->comment) {
+            os_strdup(rule->comment, comment);
+
+            for (var = comment; (var = strstr(var, "$(")) && (end = strchr(var + 2, ')')); var = end + 1) {
+                *end = '\0';
+                OSHash_Add_ins(fields, var + 2, rule);
+            }
+
+            os_free(comment);
+        }
+
+        if (node->child) {
+            OS_AddRulesFields(fields, node->child);
+        }
+
+        node = node->next;
+    }
+}
+
 int _setlevels(RuleNode *node, int nnode)
 {
     int l_size = 0;
@@ -2561,154 +2652,215 @@ STATIC int doesRuleExist(int sid, RuleNode *r_node)
     return (0);
 }
 
-/* Checks if the current_rule matches the event information */
-RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
-                               ListNode **cdblists, RuleNode *curr_node,
-                               regex_matching *rule_match, OSList **fts_list,
-                               OSHash **fts_store, const bool save_fts_value,
-                               cJSON * rules_debug_list) {
+/**
+ * @brief Get the static fields present in an event
+ *
+ * @param lf event
+ * @return RULE_REQ_* mask of the fields that are set
+ */
+STATIC u_int16_t OS_GetRuleIndexFields(const struct _Eventinfo *lf) {
+    u_int16_t present = 0;
+
+    present |= lf->program_name ? RULE_REQ_PROGRAM_NAME : 0;
+    present |= lf->id ? RULE_REQ_ID : 0;
+    present |= lf->systemname ? RULE_REQ_SYSTEM_NAME : 0;
+    present |= lf->protocol ? RULE_REQ_PROTOCOL : 0;
+    present |= lf->action ? RULE_REQ_ACTION : 0;
+    present |= lf->url ? RULE_REQ_URL : 0;
+    present |= lf->location ? RULE_REQ_LOCATION : 0;
+
+    return present;
+}
 
-    /* We check for:
-     * decoded_as,
-     * fts,
-     * word match (fast regex),
-     * regex,
-     * url,
-     * id,
-     * user,
-     * maxsize,
-     * protocol,
-     * srcip,
-     * dstip,
-     * srcport,
-     * dstport,
-     * time,
-     * weekday,
-     * status,
-     */
-    RuleInfo *rule = curr_node->ruleinfo;
-    int i;
-    const char *field;
-    /* Can't be null */
-    if (!rule) {
-        merror("Inconsistent state. currently rule NULL");
-        return (NULL);
+/* Checks the candidate children of an indexed rule node, in order */
+STATIC RuleInfo * OS_CheckIfIndexedRuleMatch(struct _Eventinfo *lf, EventList *last_events,
+                                             ListNode **cdblists, const RuleIndex *index,
+                                             regex_matching *rule_match, OSList **fts_list,
+                                             OSHash **fts_store, const bool save_fts_value) {
+
+    unsigned char found[RULE_INDEX_MAX_GATED];
+    bool scanned = false;
+    u_int16_t decoder_id = lf->decoder_syscheck_id != 0 ? lf->decoder_syscheck_id : lf->decoder_info->id;
+    u_int16_t present = OS_GetRuleIndexFields(lf);
+    RuleInfo *child_rule;
+    unsigned int i;
+
+    for (i = 0; i < index->size; i++) {
+        const RuleIndexEntry *entry = &index->entries[i];
+
+        if (entry->decoded_as && entry->decoded_as != decoder_id) {
+            continue;
+        }
+
+        if (entry->required & ~present) {
+            continue;
+        }
+
+        if (entry->gated) {
+            /* Search the literals of all children at once, only when needed */
+            if (!scanned) {
+                memset(found, 0, index->size < RULE_INDEX_MAX_GATED ? index->size : RULE_INDEX_MAX_GATED);
+                OSMultiMatch_Execute(lf->log, &index->literals, found);
+                scanned = true;
+            }
+
+            if (!found[i]) {
+                continue;
+            }
+        }
+
+        child_rule = OS_CheckIfRuleMatch(lf, last_events, cdblists, entry->node, rule_match,
+                                         fts_list, fts_store, save_fts_value, NULL);
+        if (child_rule != NULL) {
+            return (child_rule);
+        }
     }
 
-#ifdef TESTRULE
-    if (full_output && !alert_only) {
-        print_out("    Trying rule: %d - %s", rule->sigid,
-                  rule->comment);
+    return (NULL);
+}
+
+/* Evaluates an expression of a rule, accounting its time when profiling */
+static bool OS_RuleExpressionMatch(RuleInfo *rule, w_expression_t *expression, const char *str,
+                                   regex_matching *rule_match) {
+    uint64_t start;
+    bool matches;
+
+    if (!Config.profile_ruleset) {
+        return w_expression_match_spans(expression, str, NULL, rule_match);
     }
-#endif
 
-    if (rules_debug_list != NULL) {
-        char rule_str[RULES_DEBUG_MSG_I_MAX_LEN];
-        snprintf(rule_str, RULES_DEBUG_MSG_I_MAX_LEN, RULES_DEBUG_MSG_I, rule->sigid, rule->comment);
-        cJSON_AddItemToArray(rules_debug_list, cJSON_CreateString(rule_str));
+    start = w_profile_now();
+    matches = w_expression_match_spans(expression, str, NULL, rule_match);
+    w_profile_add(&rule->profile.regex_ns, start);
+
+    return matches;
+}
+
+/* Searches a value in a CDB list of a rule, accounting its time when profiling */
+static int OS_RuleListSearch(RuleInfo *rule, ListRule *list_holder, char *key, ListNode **cdblists) {
+    uint64_t start;
+    int found;
+
+    if (!Config.profile_ruleset) {
+        return OS_DBSearch(list_holder, key, cdblists);
     }
 
+    start = w_profile_now();
+    found = OS_DBSearch(list_holder, key, cdblists);
+    w_profile_add(&rule->profile.lists_ns, start);
+
+    return found;
+}
+
+/* Checks the conditions of a rule, without its children */
+STATIC bool OS_CheckRuleConditions(struct _Eventinfo *lf, EventList *last_events, ListNode **cdblists,
+                                   RuleInfo *rule, regex_matching *rule_match, OSList **fts_list,
+                                   OSHash **fts_store, const bool save_fts_value) {
+
+    int i;
+    const char *field;
+
     /* Check if any decoder pre-matched here for syscheck event */
     if(lf->decoder_syscheck_id != 0 && (rule->decoded_as &&
             rule->decoded_as != lf->decoder_syscheck_id)){
-        return (NULL);
+        return false;
     }
     /* Check if any decoder pre-matched here for non-syscheck events*/
     else if (lf->decoder_syscheck_id == 0 && (rule->decoded_as &&
             rule->decoded_as != lf->decoder_info->id)) {
-        return (NULL);
+        return false;
     }
 
     /* Check program name */
     if (rule->program_name) {
         if (!lf->program_name) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->program_name, lf->program_name, NULL, rule_match)
+        if (OS_RuleExpressionMatch(rule, rule->program_name, lf->program_name, rule_match)
             == rule->program_name->negate) {
-            return (NULL);
+            return false;
         }
     }
 
     /* Check for the ID */
     if (rule->id) {
         if (!lf->id) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->id, lf->id, NULL, rule_match) == rule->id->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->id, lf->id, rule_match) == rule->id->negate) {
+            return false;
         }
     }
 
     /* Check for the system name */
     if (rule->system_name) {
         if (!lf->systemname) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->system_name, lf->systemname, NULL, rule_match)
+        if (OS_RuleExpressionMatch(rule, rule->system_name, lf->systemname, rule_match)
             == rule->system_name->negate) {
-            return (NULL);
+            return false;
         }
     }
 
     /* Check for the protocol */
     if (rule->protocol) {
         if (!lf->protocol) {
-            return (NULL);
+            return false;
         }
-        if (w_expression_match(rule->protocol, lf->protocol, NULL, rule_match) == rule->protocol->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->protocol, lf->protocol, rule_match) == rule->protocol->negate) {
+            return false;
         }
     }
 
     /* Check if any word to match exists */
     if (rule->match) {
-        if (w_expression_match(rule->match, lf->log, NULL, rule_match) == rule->match->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->match, lf->log, rule_match) == rule->match->negate) {
+            return false;
         }
     }
 
     /* Check if exist any regex for this rule */
     if (rule->regex) {
-        bool matches = w_expression_match(rule->regex, lf->log, NULL, rule_match);
+        bool matches = OS_RuleExpressionMatch(rule, rule->regex, lf->log, rule_match);
         if (matches == rule->regex->negate) {
-            return NULL;
+            return false;
         }
     }
 
     /* Check for actions */
     if (rule->action) {
         if (!lf->action) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->action, lf->action, NULL, rule_match) == rule->action->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->action, lf->action, rule_match) == rule->action->negate) {
+            return false;
         }
     }
 
     /* Checking for the URL */
     if (rule->url) {
         if (!lf->url) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->url, lf->url, NULL, rule_match) == rule->url->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->url, lf->url, rule_match) == rule->url->negate) {
+            return false;
         }
     }
 
     /* Checking for the URL */
     if (rule->location) {
         if (!lf->location) {
-            return (NULL);
+            return false;
         }
 
-        if (w_expression_match(rule->location, lf->location, NULL, rule_match) == rule->location->negate) {
-            return (NULL);
+        if (OS_RuleExpressionMatch(rule, rule->location, lf->location, rule_match) == rule->location->negate) {
+            return false;
         }
     }
 
@@ -2716,12 +2868,12 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
     for (i = 0; i < Config.decoder_order_size && rule->fields[i]; i++) {
 
         if (field = FindField(lf, rule->fields[i]->name), !field) {
-            return NULL;
+            return false;
         }
 
-        bool matches = w_expression_match(rule->fields[i]->regex, field, NULL, rule_match);
+        bool matches = OS_RuleExpressionMatch(rule, rule->fields[i]->regex, field, rule_match);
         if (matches == rule->fields[i]->regex->negate) {
-            return NULL;
+            return false;
         }
     }
 
@@ -2730,41 +2882,41 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
         /* Check for the srcip */
         if (rule->srcip) {
             if (!lf->srcip) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->srcip, lf->srcip, NULL, rule_match) == rule->srcip->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->srcip, lf->srcip, rule_match) == rule->srcip->negate) {
+                return false;
             }
         }
 
         /* Check for the dstip */
         if (rule->dstip) {
             if (!lf->dstip) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->dstip, lf->dstip, NULL, rule_match) == rule->dstip->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->dstip, lf->dstip, rule_match) == rule->dstip->negate) {
+                return false;
             }
         }
 
         if (rule->srcport) {
             if (!lf->srcport) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->srcport, lf->srcport, NULL, rule_match) == rule->srcport->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->srcport, lf->srcport, rule_match) == rule->srcport->negate) {
+                return false;
             }
         }
         if (rule->dstport) {
             if (!lf->dstport) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->dstport, lf->dstport, NULL, rule_match) == rule->dstport->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->dstport, lf->dstport, rule_match) == rule->dstport->negate) {
+                return false;
             }
         }
     } /* END PACKET_INFO */
@@ -2774,45 +2926,45 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
         /* Check compiled rule */
         if (rule->compiled_rule) {
             if (!rule->compiled_rule(lf)) {
-                return (NULL);
+                return false;
             }
         }
 
         /* Checking if exist any user to match */
         if (rule->user) {
             if (lf->dstuser) {
-                if (w_expression_match(rule->user, lf->dstuser, NULL, rule_match) == rule->user->negate) {
-                    return (NULL);
+                if (OS_RuleExpressionMatch(rule, rule->user, lf->dstuser, rule_match) == rule->user->negate) {
+                    return false;
                 }
             } else if (lf->srcuser) {
-                if (w_expression_match(rule->user, lf->srcuser, NULL, rule_match) == rule->user->negate) {
-                    return (NULL);
+                if (OS_RuleExpressionMatch(rule, rule->user, lf->srcuser, rule_match) == rule->user->negate) {
+                    return false;
                 }
             } else {
                 /* no user set */
-                return (NULL);
+                return false;
             }
         }
 
         /* Adding checks for geoip. */
         if(rule->srcgeoip) {
             if (!lf->srcgeoip) {
-                return NULL;
+                return false;
             }
 
-            if (w_expression_match(rule->srcgeoip, lf->srcgeoip, NULL, rule_match) == rule->srcgeoip->negate) {
-                return NULL;
+            if (OS_RuleExpressionMatch(rule, rule->srcgeoip, lf->srcgeoip, rule_match) == rule->srcgeoip->negate) {
+                return false;
             }
         }
 
 
         if(rule->dstgeoip) {
             if (!lf->dstgeoip) {
-                return NULL;
+                return false;
             }
 
-            if (w_expression_match(rule->dstgeoip, lf->dstgeoip, NULL, rule_match) == rule->dstgeoip->negate) {
-                return NULL;
+            if (OS_RuleExpressionMatch(rule, rule->dstgeoip, lf->dstgeoip, rule_match) == rule->dstgeoip->negate) {
+                return false;
             }
         }
 
@@ -2820,31 +2972,31 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
         /* Check if any rule related to the size exist */
         if (rule->maxsize) {
             if (lf->size < rule->maxsize) {
-                return (NULL);
+                return false;
             }
         }
 
         /* Check if we are in the right time */
         if (rule->day_time) {
             if (!OS_IsonTime(lf->hour, rule->day_time)) {
-                return (NULL);
+                return false;
             }
         }
 
         /* Check week day */
         if (rule->week_day) {
             if (!OS_IsonDay(__crt_wday, rule->week_day)) {
-                return (NULL);
+                return false;
             }
         }
 
         /* Check for the data */
         if (rule->data) {
             if (!lf->data) {
-                return (NULL);
+                return false;
             }
-            if (w_expression_match(rule->data, lf->data, NULL, rule_match) == rule->data->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->data, lf->data, rule_match) == rule->data->negate) {
+                return false;
             }
         }
 
@@ -2854,31 +3006,31 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
                 return(NULL);
             }
 
-            if (w_expression_match(rule->extra_data, lf->extra_data, NULL, rule_match)
+            if (OS_RuleExpressionMatch(rule, rule->extra_data, lf->extra_data, rule_match)
                 == rule->extra_data->negate) {
-                return (NULL);
+                return false;
             }
         }
 
         /* Check hostname */
         if (rule->hostname) {
             if (!lf->hostname) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->hostname, lf->hostname, NULL, rule_match) == rule->hostname->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->hostname, lf->hostname, rule_match) == rule->hostname->negate) {
+                return false;
             }
         }
 
         /* Check for status */
         if (rule->status) {
             if (!lf->status) {
-                return (NULL);
+                return false;
             }
 
-            if (w_expression_match(rule->status, lf->status, NULL, rule_match) == rule->status->negate) {
-                return (NULL);
+            if (OS_RuleExpressionMatch(rule, rule->status, lf->status, rule_match) == rule->status->negate) {
+                return false;
             }
         }
 
@@ -2888,7 +3040,7 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             w_mutex_lock(&do_diff_mutex);
             if (!doDiff(rule, lf)) {
                 w_mutex_unlock(&do_diff_mutex);
-                return (NULL);
+                return false;
             }
             w_mutex_unlock(&do_diff_mutex);
         }
@@ -2906,7 +3058,7 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             if ((lf->decoder_info->fts & FTS_DONE) || (lf->rootcheck_fts & FTS_DONE)) {
                 /* We already did the fts in here */
             } else if (_line = FTS(lf, fts_list, fts_store), _line == NULL) {
-                return NULL;
+                return false;
             }
 
             if (_line && save_fts_value) {
@@ -2919,7 +3071,7 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             os_free(_line);
 
         } else {
-            return NULL;
+            return false;
         }
     }
 
@@ -2930,138 +3082,138 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             switch (list_holder->field) {
                 case RULE_SRCIP:
                     if (!lf->srcip) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->srcip, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->srcip, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_SRCPORT:
                     if (!lf->srcport) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->srcport, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->srcport, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_DSTIP:
                     if (!lf->dstip) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->dstip, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->dstip, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_DSTPORT:
                     if (!lf->dstport) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->dstport, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->dstport, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_USER:
                     if (lf->srcuser) {
-                        if (!OS_DBSearch(list_holder, lf->srcuser, cdblists)) {
-                            return (NULL);
+                        if (!OS_RuleListSearch(rule, list_holder, lf->srcuser, cdblists)) {
+                            return false;
                         }
                     } else if (lf->dstuser) {
-                        if (!OS_DBSearch(list_holder, lf->dstuser, cdblists)) {
-                            return (NULL);
+                        if (!OS_RuleListSearch(rule, list_holder, lf->dstuser, cdblists)) {
+                            return false;
                         }
                     } else {
-                        return (NULL);
+                        return false;
                     }
                     break;
                 case RULE_URL:
                     if (!lf->url) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->url, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->url, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_ID:
                     if (!lf->id) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->id, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->id, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_HOSTNAME:
                     if (!lf->hostname) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->hostname, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->hostname, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_PROGRAM_NAME:
                     if (!lf->program_name) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->program_name, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->program_name, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_STATUS:
                     if (!lf->status) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->status, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->status, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_ACTION:
                     if (!lf->action) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->action, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->action, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_SYSTEMNAME:
                     if (!lf->systemname) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->systemname, cdblists)){
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->systemname, cdblists)){
+                        return false;
                     }
                     break;
                 case RULE_PROTOCOL:
                     if (!lf->protocol) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->protocol, cdblists)){
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->protocol, cdblists)){
+                        return false;
                     }
                     break;
                 case RULE_DATA:
                     if (!lf->data) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->data, cdblists)){
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->data, cdblists)){
+                        return false;
                     }
                     break;
                 case RULE_EXTRA_DATA:
                     if (!lf->extra_data) {
-                        return (NULL);
+                        return false;
                     }
-                    if (!OS_DBSearch(list_holder, lf->extra_data, cdblists)) {
-                        return (NULL);
+                    if (!OS_RuleListSearch(rule, list_holder, lf->extra_data, cdblists)) {
+                        return false;
                     }
                     break;
                 case RULE_DYNAMIC:
                     field = FindField(lf, list_holder->dfield);
 
-                    if (!(field &&OS_DBSearch(list_holder, (char*)field, cdblists)))
-                        return NULL;
+                    if (!(field &&OS_RuleListSearch(rule, list_holder, (char*)field, cdblists)))
+                        return false;
 
                     break;
                 default:
-                    return (NULL);
+                    return false;
             }
 
             list_holder = list_holder->next;
@@ -3074,12 +3226,80 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             if (rule->event_search) {
                 if (!rule->event_search(lf, last_events, rule, rule_match)) {
                     w_FreeArray(lf->last_events);
-                    return (NULL);
+                    return false;
                 }
             }
         }
     }
 
+    return true;
+}
+
+/* Checks if the current_rule matches the event information */
+RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
+                               ListNode **cdblists, RuleNode *curr_node,
+                               regex_matching *rule_match, OSList **fts_list,
+                               OSHash **fts_store, const bool save_fts_value,
+                               cJSON * rules_debug_list) {
+
+    /* We check for:
+     * decoded_as,
+     * fts,
+     * word match (fast regex),
+     * regex,
+     * url,
+     * id,
+     * user,
+     * maxsize,
+     * protocol,
+     * srcip,
+     * dstip,
+     * srcport,
+     * dstport,
+     * time,
+     * weekday,
+     * status,
+     */
+    RuleInfo *rule = curr_node->ruleinfo;
+    bool matched;
+    /* Can't be null */
+    if (!rule) {
+        merror("Inconsistent state. currently rule NULL");
+        return (NULL);
+    }
+
+#ifdef TESTRULE
+    if (full_output && !alert_only) {
+        print_out("    Trying rule: %d - %s", rule->sigid,
+                  rule->comment);
+    }
+#endif
+
+    if (rules_debug_list != NULL) {
+        char rule_str[RULES_DEBUG_MSG_I_MAX_LEN];
+        snprintf(rule_str, RULES_DEBUG_MSG_I_MAX_LEN, RULES_DEBUG_MSG_I, rule->sigid, rule->comment);
+        cJSON_AddItemToArray(rules_debug_list, cJSON_CreateString(rule_str));
+    }
+
+    /* Check the conditions of the rule itself, its children are accounted apart */
+    W_PROBE1(rule__check, rule->sigid);
+
+    if (Config.profile_ruleset) {
+        uint64_t start = w_profile_now();
+        matched = OS_CheckRuleConditions(lf, last_events, cdblists, rule, rule_match, fts_list, fts_store,
+                                         save_fts_value);
+        w_profile_evaluation(&rule->profile, start, matched);
+    } else {
+        matched = OS_CheckRuleConditions(lf, last_events, cdblists, rule, rule_match, fts_list, fts_store,
+                                         save_fts_value);
+    }
+
+    W_PROBE2(rule__checked, rule->sigid, matched);
+
+    if (!matched) {
+        return (NULL);
+    }
+
 #ifdef TESTRULE
     if (full_output && !alert_only) {
         print_out("       *Rule %d matched.", rule->sigid);
@@ -3106,6 +3326,25 @@ RuleInfo * OS_CheckIfRuleMatch(struct _Eventinfo *lf, EventList *last_events,
             cJSON_AddItemToArray(rules_debug_list, cJSON_CreateString(RULES_DEBUG_MSG_III));
         }
 
+        /* Trace every child when debugging so the output is not altered by the index */
+        if (curr_node->child_index && rules_debug_list == NULL
+#ifdef TESTRULE
+            && !full_output
+#endif
+        ) {
+            child_rule = OS_CheckIfIndexedRuleMatch(lf, last_events, cdblists,
+                                                    curr_node->child_index, rule_match,
+                                                    fts_list, fts_store, save_fts_value);
+            if (child_rule != NULL) {
+                if (!child_rule->prev_rule) {
+                    child_rule->prev_rule = rule;
+                }
+                return (child_rule);
+            }
+
+            child_node = NULL;
+        }
+
         while (child_node) {
             child_rule = OS_CheckIfRuleMatch(lf, last_events, cdblists,
                                              child_node, rule_match, fts_list,
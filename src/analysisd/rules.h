@@ -18,6 +18,7 @@
 #include "active-response.h"
 #include "lists.h"
 #include "logmsg.h"
+#include "profile.h"
 
 
 /* Event fields - stored on a u_int32_t */
@@ -57,6 +58,7 @@
 #define DO_EXTRAINFO    0x0100
 #define SAME_EXTRAINFO  0x0200
 #define NO_FULL_LOG     0x0400
+#define AGENT_DROP      0x0800
 #define NO_COUNTER      0x1000
 
 #define RULE_MASTER     1
@@ -146,6 +148,13 @@ typedef struct _RuleInfo {
     /* Pointer to a list (points to sid_prev_matched of if_matched_sid */
     OSList *sid_search;
 
+    /* Events of sid_search grouped by correlation key (if_matched_sid) */
+    struct _RuleCorrelationIndex *sid_index;
+
+    /* Rules whose sid_search points to sid_prev_matched */
+    struct _RuleInfo **sid_correlated;
+    unsigned int sid_correlated_sz;
+
     /* List of previously matched events in this group.
      * Every rule that has if_matched_group will have this
      * list. Every rule that matches this group, it going to
@@ -223,6 +232,8 @@ typedef struct _RuleInfo {
 
     /* Pointers to the rules which this one overwrites if it exists */
     OSList * rule_overwrite;
+
+    w_profile_t profile;       ///< Cost of the rule, updated when the ruleset profiling is enabled
 } RuleInfo;
 
 typedef struct _rules_tmp_params_t {
@@ -252,10 +263,78 @@ typedef struct _rules_tmp_params_t {
 
 } rules_tmp_params_t;
 
+/* Rule node index */
+#define RULE_INDEX_MIN_CHILDREN 8       ///< Minimum number of children to index a rule node
+#define RULE_INDEX_MAX_GATED    1024    ///< Only the first children can be gated by literals
+
+/* Static event fields a rule requires before evaluating any expression */
+#define RULE_REQ_PROGRAM_NAME   0x0001
+#define RULE_REQ_ID             0x0002
+#define RULE_REQ_SYSTEM_NAME    0x0004
+#define RULE_REQ_PROTOCOL       0x0008
+#define RULE_REQ_ACTION         0x0010
+#define RULE_REQ_URL            0x0020
+#define RULE_REQ_LOCATION       0x0040
+
+/**
+ * @brief Prefilter entry of a child rule
+ */
+typedef struct _RuleIndexEntry {
+    struct _RuleNode *node;     ///< Child rule node
+    u_int16_t decoded_as;       ///< Decoder the rule requires (0 if any)
+    u_int16_t required;         ///< RULE_REQ_* fields the rule requires
+    bool gated;                 ///< True if the rule can only match when one of its match literals is in the log
+} RuleIndexEntry;
+
+/**
+ * @brief Candidate index over the children of a rule node
+ *
+ * Children keep their evaluation order. The index lets OS_CheckIfRuleMatch
+ * skip children that can't match the event without evaluating them.
+ */
+typedef struct _RuleIndex {
+    unsigned int size;          ///< Number of children
+    RuleIndexEntry *entries;    ///< One entry per child, in evaluation order
+    bool has_literals;          ///< True if any child is gated
+    OSMultiMatch literals;      ///< Match literals of the gated children, identified by entry position
+} RuleIndex;
+
+/* Correlation index */
+#define RULE_CORRELATION_INDEX_ROWS 1024    ///< Rows of the correlation keys hash table
+
+/**
+ * @brief Events sharing the same correlation key
+ */
+typedef struct _RuleCorrelationBucket {
+    char *key;                  ///< Correlation key
+    OSList *events;             ///< Events, oldest first
+} RuleCorrelationBucket;
+
+/**
+ * @brief Correlation index of a rule with if_matched_sid
+ *
+ * Events stored in sid_search are also stored here, grouped by the values the
+ * rule requires to be the same (agent, id, srcip, same_* and dynamic fields).
+ * Search_LastSids only walks the events that share the key of the new event.
+ */
+typedef struct _RuleCorrelationIndex {
+    OSHash *buckets;            ///< Correlation key -> RuleCorrelationBucket
+    pthread_rwlock_t mutex;     ///< Searches read, adding and removing events write
+} RuleCorrelationIndex;
+
+/**
+ * @brief Position of an event in a correlation index
+ */
+typedef struct _RuleCorrelationSlot {
+    RuleCorrelationBucket *bucket;  ///< Bucket of the event (NULL if not indexed)
+    OSListNode *node;               ///< Node of the event in the bucket
+} RuleCorrelationSlot;
+
 typedef struct _RuleNode {
     RuleInfo *ruleinfo;
     struct _RuleNode *next;
     struct _RuleNode *child;
+    RuleIndex *child_index;     ///< Prefilter over child, built once the ruleset is loaded
 } RuleNode;
 
 /**
@@ -400,6 +479,74 @@ int Rules_OP_ReadRules(const char *rulefile, RuleNode **r_node, ListNode **l_nod
 
 int AddHash_Rule(RuleNode *node);
 
+/**
+ * @brief Add every rule of a rule tree to a hash table indexed by rule ID
+ * @param hash hash table
+ * @param node first node of the rule tree
+ * @return 0
+ */
+int OS_AddRulesHash(OSHash *hash, RuleNode *node);
+
+/**
+ * @brief Assign the configured active responses to every rule of a rule tree
+ *
+ * Rules_OP_ReadRules() only does it for the rule list loaded at startup.
+ * It must be called before _setlevels().
+ *
+ * @param node first node of the rule tree
+ */
+void OS_AddRulesAR(RuleNode *node);
+
+/**
+ * @brief Add the dynamic fields read by the rules of a rule tree to a hash
+ *
+ * Covers the field and list options, the same and different fields, the FTS
+ * ignore fields and the fields printed in the rule descriptions.
+ * The names are added in lower case.
+ *
+ * @param fields hash of field names
+ * @param node first node of the rule tree
+ */
+void OS_AddRulesFields(OSHash *fields, RuleNode *node);
+
+/**
+ * @brief Build the children candidate index of every node in a rule tree
+ *
+ * Nodes with less than RULE_INDEX_MIN_CHILDREN children are not indexed.
+ * Previous indexes are rebuilt.
+ *
+ * @param node first node of the rule list
+ */
+void OS_BuildRuleIndex(RuleNode *node);
+
+/**
+ * @brief Free a rule node index
+ * @param index index to free
+ */
+void os_remove_rule_index(RuleIndex *index);
+
+/**
+ * @brief Register a rule with if_matched_sid as a searcher of the events of a rule
+ *
+ * The searcher gets a correlation index, filled with the events matched by rule.
+ *
+ * @param rule rule whose sid_prev_matched is searched
+ * @param searcher rule with if_matched_sid pointing to rule
+ */
+void OS_AddCorrelatedRule(RuleInfo *rule, RuleInfo *searcher);
+
+/**
+ * @brief Free a correlation bucket
+ * @param bucket bucket to free
+ */
+void os_remove_correlation_bucket(RuleCorrelationBucket *bucket);
+
+/**
+ * @brief Free a correlation index
+ * @param index index to free
+ */
+void os_remove_correlation_index(RuleCorrelationIndex *index);
+
 int _setlevels(RuleNode *node, int nnode);
 
 int doDiff(RuleInfo *rule, struct _Eventinfo *lf);
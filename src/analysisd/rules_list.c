@@ -25,6 +25,8 @@
 STATIC RuleNode *_OS_AddRule(RuleNode *_rulenode, RuleInfo *read_rule);
 STATIC int _AddtoRule(int sid, int level, int none, const char *group,
                RuleNode *r_node, RuleInfo *read_rule);
+STATIC RuleIndex * _OS_BuildRuleIndex(RuleNode *first_child);
+STATIC bool _OS_AddRuleIndexLiterals(RuleIndex *index, const RuleInfo *rule, unsigned int pos);
 
 
 RuleNode *os_analysisd_rulelist;
@@ -511,6 +513,7 @@ int OS_MarkID(RuleNode *r_node, RuleInfo *orig_rule)
 
             /* Assign the parent pointer to it */
             orig_rule->sid_search = r_node->ruleinfo->sid_prev_matched;
+            OS_AddCorrelatedRule(r_node->ruleinfo, orig_rule);
         }
 
         /* Check if the child has a rule */
@@ -568,6 +571,52 @@ int OS_MarkGroup(RuleNode *r_node, RuleInfo *orig_rule)
     return (0);
 }
 
+void OS_AddCorrelatedRule(RuleInfo *rule, RuleInfo *searcher) {
+
+    for (unsigned int i = 0; i < rule->sid_correlated_sz; i++) {
+        if (rule->sid_correlated[i] == searcher) {
+            return;
+        }
+    }
+
+    if (!searcher->sid_index) {
+        os_calloc(1, sizeof(RuleCorrelationIndex), searcher->sid_index);
+
+        if (searcher->sid_index->buckets = OSHash_Create(), !searcher->sid_index->buckets) {
+            merror_exit(MEM_ERROR, errno, strerror(errno));
+        }
+
+        OSHash_setSize(searcher->sid_index->buckets, RULE_CORRELATION_INDEX_ROWS);
+        OSHash_SetFreeDataPointer(searcher->sid_index->buckets, (void (*)(void *))os_remove_correlation_bucket);
+        w_rwlock_init(&searcher->sid_index->mutex, NULL);
+    }
+
+    os_realloc(rule->sid_correlated, (rule->sid_correlated_sz + 1) * sizeof(RuleInfo *), rule->sid_correlated);
+    rule->sid_correlated[rule->sid_correlated_sz++] = searcher;
+}
+
+void os_remove_correlation_bucket(RuleCorrelationBucket *bucket) {
+
+    if (!bucket) {
+        return;
+    }
+
+    OSList_Destroy(bucket->events);
+    os_free(bucket->key);
+    os_free(bucket);
+}
+
+void os_remove_correlation_index(RuleCorrelationIndex *index) {
+
+    if (!index) {
+        return;
+    }
+
+    OSHash_Free(index->buckets);
+    w_rwlock_destroy(&index->mutex);
+    os_free(index);
+}
+
 void os_remove_rules_list(RuleNode *node) {
 
     RuleInfo **rules;
@@ -601,6 +650,8 @@ void os_remove_rulenode(RuleNode *node, RuleInfo **rules, int *pos, int *max_siz
         tmp = node;
         node = node->next;
 
+        os_remove_rule_index(tmp->child_index);
+
         if (tmp->ruleinfo->internal_saving == false && *pos <= *max_size) {
 
             tmp->ruleinfo->internal_saving = true;
@@ -626,6 +677,8 @@ void os_remove_ruleinfo(RuleInfo *ruleinfo) {
     }
 
     os_free(ruleinfo->sid_prev_matched);
+    os_remove_correlation_index(ruleinfo->sid_index);
+    os_free(ruleinfo->sid_correlated);
     os_free(ruleinfo->group_prev_matched);
 
     os_free(ruleinfo->group);
@@ -718,3 +771,126 @@ void os_count_rules(RuleNode *node, int *num_rules) {
         node = node->next;
     }
 }
+
+void OS_BuildRuleIndex(RuleNode *node) {
+
+    while (node) {
+
+        if (node->child) {
+            OS_BuildRuleIndex(node->child);
+        }
+
+        os_remove_rule_index(node->child_index);
+        node->child_index = _OS_BuildRuleIndex(node->child);
+
+        node = node->next;
+    }
+}
+
+STATIC RuleIndex * _OS_BuildRuleIndex(RuleNode *first_child) {
+
+    RuleIndex *index = NULL;
+    RuleNode *child;
+    unsigned int size = 0;
+    unsigned int pos;
+
+    for (child = first_child; child; child = child->next) {
+        size++;
+    }
+
+    if (size < RULE_INDEX_MIN_CHILDREN) {
+        return NULL;
+    }
+
+    os_calloc(1, sizeof(RuleIndex), index);
+    os_calloc(size, sizeof(RuleIndexEntry), index->entries);
+    index->size = size;
+    OSMultiMatch_Init(&index->literals);
+
+    for (child = first_child, pos = 0; child; child = child->next, pos++) {
+        RuleIndexEntry *entry = &index->entries[pos];
+        RuleInfo *rule = child->ruleinfo;
+
+        entry->node = child;
+        entry->decoded_as = rule->decoded_as;
+
+        entry->required |= rule->program_name ? RULE_REQ_PROGRAM_NAME : 0;
+        entry->required |= rule->id ? RULE_REQ_ID : 0;
+        entry->required |= rule->system_name ? RULE_REQ_SYSTEM_NAME : 0;
+        entry->required |= rule->protocol ? RULE_REQ_PROTOCOL : 0;
+        entry->required |= rule->action ? RULE_REQ_ACTION : 0;
+        entry->required |= rule->url ? RULE_REQ_URL : 0;
+        entry->required |= rule->location ? RULE_REQ_LOCATION : 0;
+
+        if (pos < RULE_INDEX_MAX_GATED && _OS_AddRuleIndexLiterals(index, rule, pos)) {
+            entry->gated = true;
+            index->has_literals = true;
+        }
+    }
+
+    if (index->has_literals && !OSMultiMatch_Compile(&index->literals)) {
+        /* Without the automaton no child can be skipped by its literals */
+        mdebug1("Could not build the literal index for the children of rule %d",
+                first_child->ruleinfo->sigid);
+
+        for (pos = 0; pos < size; pos++) {
+            index->entries[pos].gated = false;
+        }
+        index->has_literals = false;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Add the literals of a rule <match> to a rule index
+ *
+ * Only affirmative osmatch expressions are used: every alternative is a
+ * literal that must appear in the log for the rule to match.
+ *
+ * @param index index to update
+ * @param rule rule to get the literals from
+ * @param pos position of the rule in the index
+ * @return true if the rule can be gated by its literals, false otherwise
+ */
+STATIC bool _OS_AddRuleIndexLiterals(RuleIndex *index, const RuleInfo *rule, unsigned int pos) {
+
+    OSMatch *match;
+    int i;
+
+    if (!rule->match || rule->match->exp_type != EXP_TYPE_OSMATCH || rule->match->negate) {
+        return false;
+    }
+
+    match = rule->match->match;
+
+    if (!match || match->negate || !match->patterns || !match->patterns[0]) {
+        return false;
+    }
+
+    /* An empty alternative matches any log */
+    for (i = 0; match->patterns[i]; i++) {
+        if (match->size[i] == 0) {
+            return false;
+        }
+    }
+
+    for (i = 0; match->patterns[i]; i++) {
+        if (!OSMultiMatch_AddPattern(&index->literals, match->patterns[i], match->size[i], (int)pos)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void os_remove_rule_index(RuleIndex *index) {
+
+    if (!index) {
+        return;
+    }
+
+    OSMultiMatch_FreePattern(&index->literals);
+    os_free(index->entries);
+    os_free(index);
+}
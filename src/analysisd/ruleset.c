@@ -0,0 +1,402 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifdef WAZUH_UNIT_TESTING
+// Remove static qualifier when unit testing
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#include "shared.h"
+#include "ruleset.h"
+#include "config.h"
+#include "analysisd.h"
+#include "logtest.h"
+#include "lists_make.h"
+
+/* Internal decoders, their IDs are cached by the decoding threads at startup */
+static const char * internal_decoders[] = {
+    ROOTCHECK_MOD, FIM_MOD, FIM_NEW, FIM_DEL, FIM_REG_KEY_MOD, FIM_REG_KEY_NEW, FIM_REG_KEY_DEL,
+    FIM_REG_VAL_MOD, FIM_REG_VAL_NEW, FIM_REG_VAL_DEL, HOSTINFO_NEW, HOSTINFO_MOD, SYSCOLLECTOR_MOD,
+    CISCAT_MOD, WINEVT_MOD, SCA_MOD, NULL
+};
+
+/* Current generation. The mutex only serializes a reload with the threads that acquire a generation for the first time */
+static w_ruleset_t * ruleset_current;
+static pthread_mutex_t ruleset_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Every thread that acquires a generation keeps a reference to the last one it used. A reload gives the new
+ * generation one reference for each of those threads, and a thread moves to it by releasing its old one, so
+ * neither the events nor the reload wait for each other. */
+static pthread_key_t ruleset_thread_key;
+static pthread_once_t ruleset_thread_once = PTHREAD_ONCE_INIT;
+static unsigned int ruleset_threads;
+
+/**
+ * @brief Build a new ruleset generation from the configuration files
+ * @param ruleset_config Files of the ruleset
+ * @param list_msg List to save log messages
+ * @return New generation, or NULL on error
+ */
+STATIC w_ruleset_t * w_ruleset_build(_Config * ruleset_config, OSList * list_msg);
+
+/**
+ * @brief Check that the internal decoders keep their IDs in a new generation
+ * @param ruleset New generation
+ * @param current Current generation
+ * @param list_msg List to save log messages
+ * @return true if every internal decoder keeps its ID
+ */
+STATIC bool w_ruleset_check_internal_decoders(w_ruleset_t * ruleset, w_ruleset_t * current, OSList * list_msg);
+
+/**
+ * @brief Find the dynamic fields read by a generation and stop decoding the rest
+ *
+ * Only done when analysisd.decode_unused_fields is disabled and the archives
+ * are not written in JSON format.
+ * @param ruleset Generation with its decoders and rules loaded
+ */
+STATIC void w_ruleset_set_fields_used(w_ruleset_t * ruleset);
+
+/**
+ * @brief Free a ruleset generation
+ * @param ruleset Generation to free
+ */
+STATIC void w_ruleset_free(w_ruleset_t * ruleset);
+
+/**
+ * @brief Write and clean the log messages of a ruleset load
+ * @param list_msg List of messages
+ */
+STATIC void w_ruleset_log_messages(OSList * list_msg);
+
+/**
+ * @brief Release the generation of a thread that exits, and the references left to it by the reloads
+ * @param data Last generation used by the thread
+ */
+static void w_ruleset_thread_exit(void * data);
+
+static void w_ruleset_thread_key_init() {
+    pthread_key_create(&ruleset_thread_key, w_ruleset_thread_exit);
+}
+
+
+void w_ruleset_init() {
+
+    w_ruleset_t * ruleset;
+
+    os_calloc(1, sizeof(w_ruleset_t), ruleset);
+
+    ruleset->generation = 1;
+    ruleset->refs = 1;
+    ruleset->rule_list = os_analysisd_rulelist;
+    ruleset->rules_hash = Config.g_rules_hash;
+    ruleset->decoderlist_pn = os_analysisd_decoderlist_pn;
+    ruleset->decoderlist_nopn = os_analysisd_decoderlist_nopn;
+    ruleset->decoder_store = os_analysisd_decoder_store;
+    ruleset->cdblists = os_analysisd_cdblists;
+    ruleset->cdbrules = os_analysisd_cdbrules;
+
+    w_ruleset_set_fields_used(ruleset);
+
+    w_mutex_lock(&ruleset_mutex);
+    ruleset_current = ruleset;
+    w_mutex_unlock(&ruleset_mutex);
+}
+
+w_ruleset_t * w_ruleset_acquire() {
+
+    w_ruleset_t * ruleset;
+    w_ruleset_t * next;
+
+    pthread_once(&ruleset_thread_once, w_ruleset_thread_key_init);
+
+    if (ruleset = pthread_getspecific(ruleset_thread_key), !ruleset) {
+        /* First call of this thread: the reloads give it a reference from now on */
+        w_mutex_lock(&ruleset_mutex);
+
+        if (ruleset = ruleset_current, ruleset) {
+            __atomic_add_fetch(&ruleset->refs, 1, __ATOMIC_RELAXED);
+            ruleset_threads++;
+        }
+
+        w_mutex_unlock(&ruleset_mutex);
+
+        if (!ruleset) {
+            return NULL;
+        }
+    }
+
+    /* Each newer generation holds a reference for this thread, so it's alive until the thread moves past it */
+    while (next = __atomic_load_n(&ruleset->next, __ATOMIC_ACQUIRE), next) {
+        w_ruleset_release(ruleset);
+        ruleset = next;
+    }
+
+    pthread_setspecific(ruleset_thread_key, ruleset);
+
+    return w_ruleset_hold(ruleset);
+}
+
+w_ruleset_t * w_ruleset_hold(w_ruleset_t * ruleset) {
+
+    if (ruleset) {
+        __atomic_add_fetch(&ruleset->refs, 1, __ATOMIC_RELAXED);
+    }
+
+    return ruleset;
+}
+
+void w_ruleset_release(w_ruleset_t * ruleset) {
+
+    if (!ruleset) {
+        return;
+    }
+
+    if (__atomic_sub_fetch(&ruleset->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        mdebug1("Removing ruleset generation %u.", ruleset->generation);
+        w_ruleset_free(ruleset);
+    }
+}
+
+static void w_ruleset_thread_exit(void * data) {
+
+    w_ruleset_t * ruleset = data;
+    w_ruleset_t * next;
+
+    /* A reload can't add a generation for this thread while it leaves */
+    w_mutex_lock(&ruleset_mutex);
+
+    for (; ruleset; ruleset = next) {
+        next = __atomic_load_n(&ruleset->next, __ATOMIC_ACQUIRE);
+        w_ruleset_release(ruleset);
+    }
+
+    ruleset_threads--;
+    w_mutex_unlock(&ruleset_mutex);
+}
+
+unsigned int w_ruleset_reload() {
+
+    _Config ruleset_config = {0};
+    w_ruleset_t * ruleset = NULL;
+    w_ruleset_t * previous;
+    unsigned int generation = 0;
+
+    OSList * list_msg = OSList_Create();
+    OSList_SetMaxSize(list_msg, ERRORLIST_MAXSIZE);
+    OSList_SetFreeDataPointer(list_msg, (void (*)(void *))os_analysisd_free_log_msg);
+
+    if (!ruleset_current) {
+        merror("The ruleset cannot be reloaded before it is loaded.");
+        goto end;
+    }
+
+    minfo("Reloading the ruleset.");
+
+    if (!w_logtest_ruleset_load(&ruleset_config, list_msg)) {
+        goto end;
+    }
+
+    if (ruleset = w_ruleset_build(&ruleset_config, list_msg), !ruleset) {
+        goto end;
+    }
+
+    /* Only the reload thread replaces the current generation */
+    if (!w_ruleset_check_internal_decoders(ruleset, ruleset_current, list_msg)) {
+        w_ruleset_free(ruleset);
+        goto end;
+    }
+
+    w_mutex_lock(&ruleset_mutex);
+
+    /* One reference while it is the current generation, and one for each thread still on an older one */
+    previous = ruleset_current;
+    ruleset->generation = previous->generation + 1;
+    ruleset->refs = 1 + ruleset_threads;
+    ruleset_current = ruleset;
+    __atomic_store_n(&previous->next, ruleset, __ATOMIC_RELEASE);
+
+    /* Keep the globals pointing to the current generation for the configuration queries */
+    os_analysisd_rulelist = ruleset->rule_list;
+    Config.g_rules_hash = ruleset->rules_hash;
+    os_analysisd_decoderlist_pn = ruleset->decoderlist_pn;
+    os_analysisd_decoderlist_nopn = ruleset->decoderlist_nopn;
+    os_analysisd_decoder_store = ruleset->decoder_store;
+    os_analysisd_cdblists = ruleset->cdblists;
+    os_analysisd_cdbrules = ruleset->cdbrules;
+
+    w_mutex_unlock(&ruleset_mutex);
+
+    generation = ruleset->generation;
+    w_ruleset_release(previous);
+
+end:
+    w_ruleset_log_messages(list_msg);
+    OSList_Destroy(list_msg);
+    w_logtest_ruleset_free_config(&ruleset_config);
+
+    if (generation) {
+        minfo("Ruleset generation %u loaded.", generation);
+    } else {
+        merror("Unable to reload the ruleset. The current ruleset remains active.");
+    }
+
+    return generation;
+}
+
+STATIC w_ruleset_t * w_ruleset_build(_Config * ruleset_config, OSList * list_msg) {
+
+    w_ruleset_t * ruleset;
+    char ** files;
+    int total_rules;
+
+    os_calloc(1, sizeof(w_ruleset_t), ruleset);
+
+    /* Load decoders */
+    for (files = ruleset_config->decoders; files && *files; files++) {
+        mdebug1("Reading decoder file %s.", *files);
+        if (!ReadDecodeXML(*files, &ruleset->decoderlist_pn, &ruleset->decoderlist_nopn,
+                           &ruleset->decoder_store, list_msg)) {
+            goto error;
+        }
+    }
+
+    if (!SetDecodeXML(list_msg, &ruleset->decoder_store, &ruleset->decoderlist_nopn, &ruleset->decoderlist_pn)) {
+        goto error;
+    }
+
+    OS_BuildDecoderIndex(ruleset->decoderlist_pn);
+    OS_BuildDecoderIndex(ruleset->decoderlist_nopn);
+
+    /* Load CDB lists */
+    for (files = ruleset_config->lists; files && *files; files++) {
+        mdebug1("Reading the lists file: '%s'", *files);
+        if (Lists_OP_LoadList(*files, &ruleset->cdblists, list_msg) < 0) {
+            goto error;
+        }
+    }
+
+    Lists_OP_MakeAll(0, 0, &ruleset->cdblists);
+
+    /* Load rules */
+    for (files = ruleset_config->includes; files && *files; files++) {
+        mdebug1("Reading rules file: '%s'", *files);
+        if (Rules_OP_ReadRules(*files, &ruleset->rule_list, &ruleset->cdblists,
+                               &os_analysisd_last_events, &ruleset->decoder_store, list_msg) < 0) {
+            goto error;
+        }
+    }
+
+    if (!ruleset->rule_list) {
+        smerror(list_msg, "No rules loaded.");
+        goto error;
+    }
+
+    OS_ListLoadRules(&ruleset->cdblists, &ruleset->cdbrules);
+
+    /* Active responses go by the level read from the file, before fixing the levels */
+    OS_AddRulesAR(ruleset->rule_list);
+
+    total_rules = _setlevels(ruleset->rule_list, 0);
+    minfo("Total rules enabled: '%d'", total_rules);
+
+    if (ruleset->rules_hash = OSHash_Create(), !ruleset->rules_hash) {
+        merror_exit(MEM_ERROR, errno, strerror(errno));
+    }
+
+    OS_AddRulesHash(ruleset->rules_hash, ruleset->rule_list);
+    OS_BuildRuleIndex(ruleset->rule_list);
+
+    w_ruleset_set_fields_used(ruleset);
+
+    return ruleset;
+
+error:
+    w_ruleset_free(ruleset);
+    return NULL;
+}
+
+STATIC bool w_ruleset_check_internal_decoders(w_ruleset_t * ruleset, w_ruleset_t * current, OSList * list_msg) {
+
+    for (int i = 0; internal_decoders[i]; i++) {
+        if (getDecoderfromlist(internal_decoders[i], &ruleset->decoder_store)
+            != getDecoderfromlist(internal_decoders[i], &current->decoder_store)) {
+
+            smerror(list_msg, "The decoder changes shift the ID of the internal decoder '%s'. "
+                    "Restart analysisd to apply them.", internal_decoders[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+STATIC void w_ruleset_set_fields_used(w_ruleset_t * ruleset) {
+
+    if (Config.decode_unused_fields || Config.logall_json) {
+        return;
+    }
+
+    if (ruleset->fields_used = OSHash_Create(), !ruleset->fields_used) {
+        merror_exit(MEM_ERROR, errno, strerror(errno));
+    }
+
+    OS_AddRulesFields(ruleset->fields_used, ruleset->rule_list);
+    OS_AddDecodersFields(ruleset->fields_used, ruleset->decoderlist_pn);
+    OS_AddDecodersFields(ruleset->fields_used, ruleset->decoderlist_nopn);
+
+    OS_SkipUnusedDecodersFields(ruleset->fields_used, ruleset->decoderlist_pn);
+    OS_SkipUnusedDecodersFields(ruleset->fields_used, ruleset->decoderlist_nopn);
+
+    mdebug1("Decoding only the %u dynamic fields read by the ruleset.", OSHash_Get_Elem_ex(ruleset->fields_used));
+}
+
+STATIC void w_ruleset_free(w_ruleset_t * ruleset) {
+
+    os_remove_rules_list(ruleset->rule_list);
+    if (ruleset->rules_hash) {
+        OSHash_Free(ruleset->rules_hash);
+    }
+
+    if (ruleset->fields_used) {
+        OSHash_Free(ruleset->fields_used);
+    }
+
+    os_remove_decoders_list(ruleset->decoderlist_pn, ruleset->decoderlist_nopn);
+    if (ruleset->decoder_store) {
+        OSStore_Free(ruleset->decoder_store);
+    }
+
+    os_remove_cdblist(&ruleset->cdblists);
+    os_remove_cdbrules(&ruleset->cdbrules);
+
+    os_free(ruleset);
+}
+
+STATIC void w_ruleset_log_messages(OSList * list_msg) {
+
+    OSListNode * node_log_msg;
+    char * msg;
+
+    while (node_log_msg = OSList_GetFirstNode(list_msg), node_log_msg) {
+        os_analysisd_log_msg_t * data_msg = node_log_msg->data;
+        msg = os_analysisd_string_log_msg(data_msg);
+
+        if (data_msg->level == LOGLEVEL_WARNING) {
+            mwarn("%s", msg);
+        } else if (data_msg->level == LOGLEVEL_ERROR) {
+            merror("%s", msg);
+        }
+        os_free(msg);
+        os_analysisd_free_log_msg(data_msg);
+        OSList_DeleteCurrentlyNode(list_msg);
+    }
+}
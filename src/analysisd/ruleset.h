@@ -0,0 +1,84 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef RULESET_H
+#define RULESET_H
+
+#include "rules.h"
+#include "lists.h"
+#include "decoders/decoder.h"
+
+/**
+ * @brief Generation of the ruleset: decoders, CDB lists and rules loaded together
+ *
+ * Every event holds a reference to the generation it was decoded with, so a
+ * reload can publish a new generation while the events in flight (or kept in
+ * the correlation lists) still point to the decoders and rules of the old one.
+ * A generation is freed when its last reference is released. Each thread also
+ * keeps the last generation it acquired, until its next call moves it forward.
+ */
+typedef struct _w_ruleset_t {
+    unsigned int generation;            ///< Generation number, the ruleset loaded at startup is 1
+    unsigned int refs;                  ///< References from events, plus one while it is the current generation and one for each thread that has not moved past it
+    struct _w_ruleset_t *next;          ///< Generation that replaced this one, NULL while it is the current generation
+    RuleNode *rule_list;                ///< Rule list
+    OSHash *rules_hash;                 ///< Rules by ID, used to decode alerts from other managers
+    OSDecoderNode *decoderlist_pn;      ///< Decoder list to match logs which have a program name
+    OSDecoderNode *decoderlist_nopn;    ///< Decoder list to match logs which haven't a program name
+    OSStore *decoder_store;             ///< Decoder names and IDs
+    ListNode *cdblists;                 ///< List of CDB lists
+    ListRule *cdbrules;                 ///< Rules which depend on a CDB list
+    OSHash *fields_used;                ///< Dynamic fields read by the ruleset, NULL if every field is decoded
+} w_ruleset_t;
+
+/**
+ * @brief Publish the ruleset loaded at startup as the first generation
+ *
+ * Takes the global decoder, CDB and rule lists already loaded by analysisd.
+ */
+void w_ruleset_init();
+
+/**
+ * @brief Get a reference to the current ruleset generation
+ *
+ * @return Current generation, or NULL if w_ruleset_init() was not called.
+ *         It must be released with w_ruleset_release().
+ */
+w_ruleset_t * w_ruleset_acquire();
+
+/**
+ * @brief Get one more reference to a generation already held
+ *
+ * @param ruleset Generation held by the caller. May be NULL.
+ * @return The same generation.
+ */
+w_ruleset_t * w_ruleset_hold(w_ruleset_t * ruleset);
+
+/**
+ * @brief Release a reference to a ruleset generation
+ *
+ * The generation is freed when it is no longer the current one and its last
+ * reference is released.
+ *
+ * @param ruleset Generation to release. May be NULL.
+ */
+void w_ruleset_release(w_ruleset_t * ruleset);
+
+/**
+ * @brief Load the ruleset from the configuration and publish it as a new generation
+ *
+ * The new generation is built while the current one keeps processing events.
+ * The global event list and the FTS state are shared by every generation, so
+ * they survive the reload.
+ *
+ * @return Number of the new generation, or 0 if the ruleset could not be loaded.
+ */
+unsigned int w_ruleset_reload();
+
+#endif /* RULESET_H */
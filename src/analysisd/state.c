@@ -17,6 +17,8 @@
 #include "state.h"
 #include "config.h"
 #include "limits.h"
+#include "fts.h"
+#include "lists.h"
 
 #ifdef WAZUH_UNIT_TESTING
 // Remove STATIC qualifier from tests
@@ -30,17 +32,43 @@ queue_status_t queue_status;
 static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t agents_state_mutex = PTHREAD_MUTEX_INITIALIZER;
+static w_latency_t event_latency[LATENCY_STAGES] = {
+    W_LATENCY_INITIALIZER, W_LATENCY_INITIALIZER, W_LATENCY_INITIALIZER, W_LATENCY_INITIALIZER, W_LATENCY_INITIALIZER
+};
 static int w_analysisd_write_state();
 static int interval;
 
 extern OSHash *analysisd_agents_state;
 
+/**
+ * @brief Per-agent counters incremented by a thread, indexed by agent ID
+ *
+ * They are merged into analysisd_agents_state when the agents state is read.
+ */
+typedef struct agents_state_slab_t {
+    analysisd_agent_state_t * agents;   ///< Counters by agent ID. A zero uptime means an empty slot
+    size_t size;                        ///< Number of slots
+    bool pending;                       ///< Some counter was incremented since the last merge
+    pthread_mutex_t mutex;              ///< Only contended while the slab is merged
+    struct agents_state_slab_t * next;
+} agents_state_slab_t;
+
+static agents_state_slab_t * agents_state_slabs;
+static pthread_key_t agents_state_key;
+static pthread_once_t agents_state_once = PTHREAD_ONCE_INIT;
+
 /**
  * @brief Get the number of elements divided by the size of queues
  * Values are save in state's variables
  */
 static void w_get_queues_size();
 
+/**
+ * @brief Get the usage and the shards imbalance of the rule matching queues
+ * Values are save in state's variables
+ */
+static void w_get_processed_queues_usage();
+
 /**
  * @brief Obtains analysisd's queues sizes
  * Values are save in state's variables
@@ -60,6 +88,20 @@ STATIC analysisd_agent_state_t * get_node(const char *agent_id);
  */
 STATIC void w_analysisd_clean_agents_state(int *sock);
 
+/**
+ * @brief Get the counters of an agent in the slab of the calling thread
+ * @param agent_id Id of the agent that corresponds to the event
+ * @param slab [out] Slab of the thread, returned locked
+ * @return Agent counters, valid until the slab is unlocked
+ */
+static analysisd_agent_state_t * w_lock_agent_slot(const char *agent_id, agents_state_slab_t ** slab);
+
+/**
+ * @brief Add the counters of the thread slabs to analysisd_agents_state
+ * @pre agents_state_mutex must be locked
+ */
+STATIC void w_analysisd_merge_agents_state();
+
 /**
  * @brief Increment agent decoded events counter for agents
  * @param agent_id Id of the agent that corresponds to the event
@@ -399,6 +441,9 @@ int w_analysisd_write_state() {
         "# Rule matching queue size\n"
         "rule_matching_queue_size='%zu'\n"
         "\n"
+        "# Rule matching shards imbalance\n"
+        "rule_matching_queue_imbalance='%.2f'\n"
+        "\n"
         "# Alerts log queue\n"
         "alerts_queue_usage='%.2f'\n"
         "\n"
@@ -476,6 +521,7 @@ int w_analysisd_write_state() {
         queue_status.events_queue_usage, queue_status.events_queue_size,
         queue_status.processed_queue_usage,
         queue_status.processed_queue_size,
+        queue_status.processed_queue_imbalance,
         queue_status.alerts_queue_usage,
         queue_status.alerts_queue_size,
         queue_status.firewall_queue_usage,
@@ -498,6 +544,32 @@ int w_analysisd_write_state() {
    return 0;
 }
 
+void w_get_processed_queues_usage() {
+    size_t elements = 0;
+    size_t max_elements = 0;
+    size_t size = 0;
+
+    if (num_rule_matching_shards == 0) {
+        queue_status.processed_queue_usage = ((decode_queue_event_output->elements / (float)decode_queue_event_output->size));
+        queue_status.processed_queue_imbalance = decode_queue_event_output->elements ? 1 : 0;
+        return;
+    }
+
+    for (int i = 0; i < num_rule_matching_shards; i++) {
+        elements += decode_queue_event_shards[i]->elements;
+        size += decode_queue_event_shards[i]->size;
+
+        if (decode_queue_event_shards[i]->elements > max_elements) {
+            max_elements = decode_queue_event_shards[i]->elements;
+        }
+    }
+
+    queue_status.processed_queue_usage = elements / (float)size;
+
+    /* Fullest shard over the mean: 1 if balanced, the number of shards if a single one is used */
+    queue_status.processed_queue_imbalance = elements ? max_elements * num_rule_matching_shards / (float)elements : 0;
+}
+
 void w_get_queues_size() {
     queue_status.syscheck_queue_usage = ((decode_queue_syscheck_input->elements / (float)decode_queue_syscheck_input->size));
     queue_status.syscollector_queue_usage = ((decode_queue_syscollector_input->elements / (float)decode_queue_syscollector_input->size));
@@ -505,10 +577,24 @@ void w_get_queues_size() {
     queue_status.sca_queue_usage = ((decode_queue_sca_input->elements / (float)decode_queue_sca_input->size));
     queue_status.hostinfo_queue_usage = ((decode_queue_hostinfo_input->elements / (float)decode_queue_hostinfo_input->size));
     queue_status.winevt_queue_usage = ((decode_queue_winevt_input->elements / (float)decode_queue_winevt_input->size));
-    queue_status.dbsync_queue_usage = ((dispatch_dbsync_input->elements / (float)dispatch_dbsync_input->size));
+    if (num_dispatch_dbsync_shards > 0) {
+        size_t elements = 0;
+        size_t size = 0;
+        for (int i = 0; i < num_dispatch_dbsync_shards; i++) {
+            elements += dispatch_dbsync_shards[i]->elements;
+            size += dispatch_dbsync_shards[i]->size;
+        }
+        queue_status.dbsync_queue_usage = elements / (float)size;
+    } else {
+        queue_status.dbsync_queue_usage = ((dispatch_dbsync_input->elements / (float)dispatch_dbsync_input->size));
+    }
     queue_status.upgrade_queue_usage = ((upgrade_module_input->elements / (float)upgrade_module_input->size));
     queue_status.events_queue_usage = ((decode_queue_event_input->elements / (float)decode_queue_event_input->size));
-    queue_status.processed_queue_usage = ((decode_queue_event_output->elements / (float)decode_queue_event_output->size));
+    for (int i = 0; i < PRIO_QUEUE_CLASSES; i++) {
+        w_queue_t * class = decode_queue_event_input->classes[i];
+        queue_status.events_priority_usage[i] = class ? class->elements / (float)class->size : 0;
+    }
+    w_get_processed_queues_usage();
     queue_status.alerts_queue_usage = ((writer_queue_log->elements / (float)writer_queue_log->size));
     queue_status.archives_queue_usage = ((writer_queue->elements / (float)writer_queue->size));
     queue_status.firewall_queue_usage = ((writer_queue_log_firewall->elements / (float)writer_queue_log_firewall->size));
@@ -523,10 +609,27 @@ void w_get_initial_queues_size() {
     queue_status.sca_queue_size = decode_queue_sca_input->size;
     queue_status.hostinfo_queue_size = decode_queue_hostinfo_input->size;
     queue_status.winevt_queue_size = decode_queue_winevt_input->size;
-    queue_status.dbsync_queue_size = dispatch_dbsync_input->size;
+    if (num_dispatch_dbsync_shards > 0) {
+        queue_status.dbsync_queue_size = 0;
+        for (int i = 0; i < num_dispatch_dbsync_shards; i++) {
+            queue_status.dbsync_queue_size += dispatch_dbsync_shards[i]->size;
+        }
+    } else {
+        queue_status.dbsync_queue_size = dispatch_dbsync_input->size;
+    }
     queue_status.upgrade_queue_size = upgrade_module_input->size;
     queue_status.events_queue_size = decode_queue_event_input->size;
-    queue_status.processed_queue_size = decode_queue_event_output->size;
+    for (int i = 0; i < PRIO_QUEUE_CLASSES; i++) {
+        queue_status.events_priority_size[i] = decode_queue_event_input->classes[i] ? decode_queue_event_input->classes[i]->size : 0;
+    }
+    if (num_rule_matching_shards > 0) {
+        queue_status.processed_queue_size = 0;
+        for (int i = 0; i < num_rule_matching_shards; i++) {
+            queue_status.processed_queue_size += decode_queue_event_shards[i]->size;
+        }
+    } else {
+        queue_status.processed_queue_size = decode_queue_event_output->size;
+    }
     queue_status.alerts_queue_size = writer_queue_log->size;
     queue_status.archives_queue_size = writer_queue->size;
     queue_status.firewall_queue_size = writer_queue_log_firewall->size;
@@ -547,18 +650,137 @@ STATIC analysisd_agent_state_t * get_node(const char *agent_id) {
     }
 }
 
+static void w_analysisd_agents_state_key_init() {
+    pthread_key_create(&agents_state_key, NULL);
+}
+
+static analysisd_agent_state_t * w_lock_agent_slot(const char *agent_id, agents_state_slab_t ** slab) {
+    int id = atoi(agent_id);
+    analysisd_agent_state_t * slot;
+
+    pthread_once(&agents_state_once, w_analysisd_agents_state_key_init);
+
+    /* The slabs live as long as the decoder threads */
+    if (*slab = pthread_getspecific(agents_state_key), *slab == NULL) {
+        os_calloc(1, sizeof(agents_state_slab_t), *slab);
+        w_mutex_init(&(*slab)->mutex, NULL);
+        pthread_setspecific(agents_state_key, *slab);
+
+        w_mutex_lock(&agents_state_mutex);
+        (*slab)->next = agents_state_slabs;
+        agents_state_slabs = *slab;
+        w_mutex_unlock(&agents_state_mutex);
+    }
+
+    if (id < 0) {
+        id = 0;
+    }
+
+    w_mutex_lock(&(*slab)->mutex);
+
+    if ((size_t)id >= (*slab)->size) {
+        size_t size = (*slab)->size ? (*slab)->size : 64;
+
+        while ((size_t)id >= size) {
+            size *= 2;
+        }
+
+        os_realloc((*slab)->agents, size * sizeof(analysisd_agent_state_t), (*slab)->agents);
+        memset((*slab)->agents + (*slab)->size, 0, (size - (*slab)->size) * sizeof(analysisd_agent_state_t));
+        (*slab)->size = size;
+    }
+
+    slot = &(*slab)->agents[id];
+
+    if (slot->uptime == 0) {
+        slot->uptime = time(NULL);
+    }
+
+    (*slab)->pending = true;
+    return slot;
+}
+
+static void w_add_agent_state(analysisd_agent_state_t * dst, const analysisd_agent_state_t * src) {
+    const events_t * src_events = &src->events_decoded_breakdown;
+    events_t * dst_events = &dst->events_decoded_breakdown;
+
+    if (src->uptime < dst->uptime) {
+        dst->uptime = src->uptime;
+    }
+
+    dst->events_processed += src->events_processed;
+    dst->alerts_written += src->alerts_written;
+    dst->archives_written += src->archives_written;
+    dst->firewall_written += src->firewall_written;
+
+    dst_events->agent += src_events->agent;
+    dst_events->agentless += src_events->agentless;
+    dst_events->dbsync += src_events->dbsync;
+    dst_events->monitor += src_events->monitor;
+    dst_events->remote += src_events->remote;
+    dst_events->syslog += src_events->syslog;
+    dst_events->integrations.virustotal += src_events->integrations.virustotal;
+    dst_events->modules.aws += src_events->modules.aws;
+    dst_events->modules.azure += src_events->modules.azure;
+    dst_events->modules.ciscat += src_events->modules.ciscat;
+    dst_events->modules.command += src_events->modules.command;
+    dst_events->modules.docker += src_events->modules.docker;
+    dst_events->modules.gcp += src_events->modules.gcp;
+    dst_events->modules.github += src_events->modules.github;
+    dst_events->modules.office365 += src_events->modules.office365;
+    dst_events->modules.oscap += src_events->modules.oscap;
+    dst_events->modules.osquery += src_events->modules.osquery;
+    dst_events->modules.rootcheck += src_events->modules.rootcheck;
+    dst_events->modules.sca += src_events->modules.sca;
+    dst_events->modules.syscheck += src_events->modules.syscheck;
+    dst_events->modules.syscollector += src_events->modules.syscollector;
+    dst_events->modules.upgrade += src_events->modules.upgrade;
+    dst_events->modules.vulnerability += src_events->modules.vulnerability;
+    dst_events->modules.logcollector.eventchannel += src_events->modules.logcollector.eventchannel;
+    dst_events->modules.logcollector.eventlog += src_events->modules.logcollector.eventlog;
+    dst_events->modules.logcollector.macos += src_events->modules.logcollector.macos;
+    dst_events->modules.logcollector.others += src_events->modules.logcollector.others;
+}
+
+STATIC void w_analysisd_merge_agents_state() {
+    char agent_id[OS_SIZE_16];
+
+    for (agents_state_slab_t * slab = agents_state_slabs; slab != NULL; slab = slab->next) {
+        w_mutex_lock(&slab->mutex);
+
+        if (slab->pending) {
+            for (size_t i = 0; i < slab->size; i++) {
+                if (slab->agents[i].uptime != 0) {
+                    snprintf(agent_id, OS_SIZE_16, "%.3zu", i);
+                    w_add_agent_state(get_node(agent_id), &slab->agents[i]);
+                    memset(&slab->agents[i], 0, sizeof(analysisd_agent_state_t));
+                }
+            }
+
+            slab->pending = false;
+        }
+
+        w_mutex_unlock(&slab->mutex);
+    }
+}
+
 STATIC void w_analysisd_clean_agents_state(int *sock) {
     int *active_agents = NULL;
     OSHashNode *hash_node;
     unsigned int inode_it = 0;
 
+    w_mutex_lock(&agents_state_mutex);
+    w_analysisd_merge_agents_state();
+
     hash_node = OSHash_Begin(analysisd_agents_state, &inode_it);
 
     if (hash_node == NULL) {
+        w_mutex_unlock(&agents_state_mutex);
         return;
     }
 
     if (active_agents = wdb_get_agents_ids_of_current_node(AGENT_CS_ACTIVE, sock, 0, -1), active_agents == NULL) {
+        w_mutex_unlock(&agents_state_mutex);
         return;
     }
 
@@ -585,210 +807,211 @@ STATIC void w_analysisd_clean_agents_state(int *sock) {
     }
 
     os_free(active_agents);
+    w_mutex_unlock(&agents_state_mutex);
     return;
 }
 
 static void w_inc_agents_agent_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.agent++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_dbsync_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.dbsync++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_monitor_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.monitor++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_remote_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.remote++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_integrations_virustotal_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.integrations.virustotal++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_aws_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.aws++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_azure_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.azure++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_ciscat_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.ciscat++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_command_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.command++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_docker_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.docker++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_gcp_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.gcp++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_github_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.github++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_office365_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.office365++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_oscap_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.oscap++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_osquery_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.osquery++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_rootcheck_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.rootcheck++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_sca_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.sca++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_syscheck_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.syscheck++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_syscollector_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.syscollector++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_upgrade_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.upgrade++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_vulnerability_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.vulnerability++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_logcollector_eventchannel_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.logcollector.eventchannel++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_logcollector_eventlog_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.logcollector.eventlog++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_logcollector_macos_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.logcollector.macos++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_modules_logcollector_others_decoded_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_decoded_breakdown.modules.logcollector.others++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_processed_events(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->events_processed++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_alerts_written(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->alerts_written++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_archives_written(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->archives_written++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 static void w_inc_agents_firewall_written(const char *agent_id) {
-    w_mutex_lock(&agents_state_mutex);
-    analysisd_agent_state_t *agent_node = get_node(agent_id);
+    agents_state_slab_t *slab;
+    analysisd_agent_state_t *agent_node = w_lock_agent_slot(agent_id, &slab);
     agent_node->firewall_written++;
-    w_mutex_unlock(&agents_state_mutex);
+    w_mutex_unlock(&slab->mutex);
 }
 
 void w_add_recv(unsigned long bytes) {
@@ -1209,6 +1432,14 @@ void w_inc_syslog_dropped_events() {
     w_mutex_unlock(&state_mutex);
 }
 
+void w_inc_priority_dropped_events(unsigned int priority) {
+    if (priority < PRIO_QUEUE_CLASSES) {
+        w_mutex_lock(&state_mutex);
+        analysisd_state.events_priority_dropped[priority]++;
+        w_mutex_unlock(&state_mutex);
+    }
+}
+
 void w_inc_integrations_virustotal_dropped_events() {
     w_mutex_lock(&state_mutex);
     analysisd_state.events_dropped_breakdown.integrations.virustotal++;
@@ -1550,6 +1781,41 @@ cJSON* asys_create_state_json() {
     cJSON_AddNumberToObject(_written_breakdown, "fts", state_cpy.events_written_breakdown.fts_written);
     cJSON_AddNumberToObject(_written_breakdown, "stats", state_cpy.events_written_breakdown.stats_written);
 
+#ifdef LIBGEOIP_ENABLED
+    if (geoipdb) {
+        uint64_t geoip_hits;
+        uint64_t geoip_misses;
+
+        cJSON *_geoip = cJSON_CreateObject();
+        cJSON_AddItemToObject(_metrics, "geoip", _geoip);
+
+        GeoIP_CacheStats(&geoip_hits, &geoip_misses);
+
+        cJSON_AddNumberToObject(_geoip, "cache_hits", geoip_hits);
+        cJSON_AddNumberToObject(_geoip, "cache_misses", geoip_misses);
+    }
+#endif
+
+    if (Config.latency_sample) {
+        cJSON *_latency = cJSON_CreateObject();
+        cJSON_AddItemToObject(_metrics, "latency", _latency);
+
+        cJSON_AddItemToObject(_latency, "decode", w_latency_to_json(&event_latency[LATENCY_DECODE]));
+        cJSON_AddItemToObject(_latency, "decoded_queue", w_latency_to_json(&event_latency[LATENCY_DECODED_QUEUE]));
+        cJSON_AddItemToObject(_latency, "rules", w_latency_to_json(&event_latency[LATENCY_RULES]));
+        cJSON_AddItemToObject(_latency, "alerts_queue", w_latency_to_json(&event_latency[LATENCY_ALERTS_QUEUE]));
+        cJSON_AddItemToObject(_latency, "alerts_write", w_latency_to_json(&event_latency[LATENCY_ALERTS_WRITE]));
+    }
+
+    w_mem_tag_t * const mem_tags[] = { &os_analysisd_mem_eventlist, &os_analysisd_mem_fts, &os_analysisd_mem_lists, NULL };
+    cJSON *_memory = w_mem_tags_to_json(mem_tags);
+    cJSON *_heap = w_mem_heap_to_json();
+    cJSON_AddItemToObject(_metrics, "memory", _memory);
+
+    if (_heap) {
+        cJSON_AddItemToObject(_memory, "heap", _heap);
+    }
+
     cJSON *_queues = cJSON_CreateObject();
     cJSON_AddItemToObject(_metrics, "queues", _queues);
 
@@ -1601,11 +1867,25 @@ cJSON* asys_create_state_json() {
     cJSON_AddNumberToObject(_others_q, "size", queue_cpy.events_queue_size);
     cJSON_AddNumberToObject(_others_q, "usage", queue_cpy.events_queue_usage);
 
+    cJSON *_priorities = cJSON_CreateObject();
+    cJSON_AddItemToObject(_others_q, "priority", _priorities);
+
+    for (int i = 0; i < PRIO_QUEUE_CLASSES; i++) {
+        static const char * names[PRIO_QUEUE_CLASSES] = { "high", "normal", "low" };
+        cJSON *_priority = cJSON_CreateObject();
+        cJSON_AddItemToObject(_priorities, names[i], _priority);
+
+        cJSON_AddNumberToObject(_priority, "size", queue_cpy.events_priority_size[i]);
+        cJSON_AddNumberToObject(_priority, "usage", queue_cpy.events_priority_usage[i]);
+        cJSON_AddNumberToObject(_priority, "dropped", state_cpy.events_priority_dropped[i]);
+    }
+
     cJSON *_processed_q = cJSON_CreateObject();
     cJSON_AddItemToObject(_queues, "processed", _processed_q);
 
     cJSON_AddNumberToObject(_processed_q, "size", queue_cpy.processed_queue_size);
     cJSON_AddNumberToObject(_processed_q, "usage", queue_cpy.processed_queue_usage);
+    cJSON_AddNumberToObject(_processed_q, "imbalance", queue_cpy.processed_queue_imbalance);
 
     cJSON *_rootcheck_q = cJSON_CreateObject();
     cJSON_AddItemToObject(_queues, "rootcheck", _rootcheck_q);
@@ -1656,6 +1936,7 @@ cJSON* asys_create_agents_state_json(int* agents_ids) {
     cJSON_AddStringToObject(asys_state_json, "name", ARGV0);
 
     w_mutex_lock(&agents_state_mutex);
+    w_analysisd_merge_agents_state();
 
     if (agents_ids != NULL) {
         for (int i = 0; agents_ids[i] != -1; i++) {
@@ -1740,3 +2021,7 @@ cJSON* asys_create_agents_state_json(int* agents_ids) {
 
     return asys_state_json;
 }
+
+uint64_t w_add_event_latency(latency_stage_t stage, uint64_t start) {
+    return w_latency_add(&event_latency[stage], start);
+}
@@ -38,8 +38,11 @@ typedef struct _queue_status_t {
     size_t upgrade_queue_size;
     float events_queue_usage;
     size_t events_queue_size;
+    float events_priority_usage[PRIO_QUEUE_CLASSES];
+    size_t events_priority_size[PRIO_QUEUE_CLASSES];
     float processed_queue_usage;
     size_t processed_queue_size;
+    float processed_queue_imbalance;
     float alerts_queue_usage;
     size_t alerts_queue_size;
     float archives_queue_usage;
@@ -116,6 +119,7 @@ typedef struct _analysisd_state_t {
     events_t events_dropped_breakdown;
     written_t events_written_breakdown;
     eps_state_t eps_state_breakdown;
+    uint64_t events_priority_dropped[PRIO_QUEUE_CLASSES];
 } analysisd_state_t;
 
 typedef struct _analysisd_agent_state_t {
@@ -325,6 +329,12 @@ void w_inc_remote_dropped_events();
  */
 void w_inc_syslog_dropped_events();
 
+/**
+ * @brief Increment the dropped events counter of a priority class of the events queue
+ * @param priority Priority class of the dropped event
+ */
+void w_inc_priority_dropped_events(unsigned int priority);
+
 /**
  * @brief Increment integrations virustotal dropped events counter
  */
@@ -474,6 +484,26 @@ void w_inc_eps_events_dropped();
  */
 void w_inc_eps_seconds_over_limit();
 
+/**
+ * @brief Stages of a traced event
+ */
+typedef enum {
+    LATENCY_DECODE,         ///< Decoding, from the input queue to the decoded queue
+    LATENCY_DECODED_QUEUE,  ///< Waiting in the decoded queue
+    LATENCY_RULES,          ///< Rule matching
+    LATENCY_ALERTS_QUEUE,   ///< Waiting in the alerts writer queue
+    LATENCY_ALERTS_WRITE,   ///< Writing the alert
+    LATENCY_STAGES
+} latency_stage_t;
+
+/**
+ * @brief Add the latency of a stage of a traced event
+ * @param stage Stage finished
+ * @param start Start time of the stage, 0 if the event isn't traced
+ * @return Current time, to start the next stage. 0 if the event isn't traced
+ */
+uint64_t w_add_event_latency(latency_stage_t stage, uint64_t start);
+
 /**
  * @brief Create a JSON object with all the analysisd state information
  * @return JSON object
@@ -163,7 +163,7 @@ int main(int argc, char **argv)
 
     /* Opening GeoIP DB */
     if(Config.geoipdb_file) {
-        geoipdb = GeoIP_open(Config.geoipdb_file, GEOIP_INDEX_CACHE);
+        geoipdb = GeoIP_open(Config.geoipdb_file, GEOIP_MMAP_CACHE);
         if (geoipdb == NULL)
         {
             merror("Unable to open GeoIP database from: %s (disabling GeoIP).", Config.geoipdb_file);
@@ -327,6 +327,11 @@ int main(int argc, char **argv)
 
             /* Load decoders */
             SetDecodeXML(list_msg, &os_analysisd_decoder_store, &os_analysisd_decoderlist_nopn, &os_analysisd_decoderlist_pn);
+
+            /* Index the parent decoders to skip impossible candidates */
+            OS_BuildDecoderIndex(os_analysisd_decoderlist_pn);
+            OS_BuildDecoderIndex(os_analysisd_decoderlist_nopn);
+
             node_log_msg = OSList_GetFirstNode(list_msg);
             while (node_log_msg) {
                 os_analysisd_log_msg_t * data_msg = node_log_msg->data;
@@ -462,6 +467,9 @@ int main(int argc, char **argv)
             merror_exit(MEM_ERROR, errno, strerror(errno));
         }
         AddHash_Rule(tmp_node);
+
+        /* Index the children of each rule to skip impossible candidates */
+        OS_BuildRuleIndex(tmp_node);
     }
 
     if (test_config == 1) {
@@ -723,6 +731,7 @@ void OS_ReadMSG(char *ut_str)
                         lf->sid_node_to_delete =
                             currently_rule->sid_prev_matched->last_node;
                     }
+                    OS_AddCorrelationEvent(currently_rule, lf);
                 }
 
                 /* Group list */
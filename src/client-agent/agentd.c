@@ -116,6 +116,8 @@ void AgentdStart(int uid, int gid, const char *user, const char *group)
         minfo(DISABLED_BUFFER);
     }
 
+    w_agentd_ring_init();
+
     /* Configure and start statistics */
     w_agentd_state_init();
     w_create_thread(state_main, NULL);
@@ -26,6 +26,9 @@
 #define empty(i, j) (i == j)
 #define forward(x, n) x = (x + 1) % (n)
 
+/* Events that don't fit into the buffer */
+#define BUFFER_SPILL_DIR "queue/agentd/buffer"
+
 /* Buffer statuses */
 #define NORMAL 0
 #define WARNING 1
@@ -47,6 +50,9 @@ void AgentdStart(int uid, int gid, const char *user, const char *group) __attrib
 /* Event Forwarder */
 void *EventForward(void);
 
+/* Advertise the rings that the modules may send the events through */
+void w_agentd_ring_init();
+
 /* Receiver messages */
 int receive_msg(void);
 
@@ -61,6 +67,16 @@ void buffer_init();
 /* Send message to a buffer with the aim to avoid flooding issues */
 int buffer_append(const char *msg);
 
+/**
+ * @brief Adapt the event rate to the usage of the manager queue
+ *
+ * The rate goes down by half when the manager queue is busy, and up to the
+ * configured events per second when it is idle.
+ *
+ * @param ack_info Information attached to the ack from the manager. May be NULL.
+ */
+void buffer_flow_control(const cJSON * ack_info);
+
 /* Thread to dispatch messages from the buffer */
 #ifdef WIN32
 DWORD WINAPI dispatch_buffer(LPVOID arg);
@@ -107,6 +123,9 @@ int try_enroll_to_server(const char *server_rip, uint32_t network_interface);
 /* Notify server */
 void run_notify(void);
 
+/* Send the full metadata in the next keepalive, right away */
+void request_full_keepalive(void);
+
 /* Format labels from config into string. Return 0 on success or -1 on error. */
 int format_labels(char *str, size_t size);
 
@@ -148,6 +167,9 @@ extern int win_debug_level;
 extern int warn_level;
 extern int normal_level;
 extern int tolerance;
+extern int spill_size;
+extern int spill_age;
+extern int queue_ring_size;
 extern int rotate_log;
 extern int request_pool;
 extern int rto_sec;
@@ -162,6 +184,8 @@ extern int timeout;
 extern int interval;
 extern int remote_conf;
 extern int min_eps;
+extern volatile int event_batch_enabled;
+extern volatile int compact_keepalive_enabled;
 
 
 /* Global variables. Only modified during startup. */
@@ -25,6 +25,19 @@
 #define STATIC static
 #endif
 
+/* Maximum size of a batch of events, and room for the length of each event */
+#define EVENT_BATCH_SIZE    OS_SIZE_20480
+#define EVENT_FRAME_SIZE    8
+
+/* Disk spill: size of each segment, events moved to the buffer at once and events read between checkpoints */
+#define SPILL_SEGMENT_SIZE  OS_SIZE_1048576
+#define SPILL_REFILL_EVENTS 64
+#define SPILL_CHECKPOINT_EVENTS 256
+
+/* Usage of the manager queue (percentage) to decrease or increase the event rate */
+#define FLOW_HIGH_USAGE     70
+#define FLOW_LOW_USAGE      30
+
 STATIC volatile int i = 0;
 STATIC volatile int j = 0;
 static volatile int state = NORMAL;
@@ -32,6 +45,8 @@ static volatile int state = NORMAL;
 int warn_level;
 int normal_level;
 int tolerance;
+int spill_size;
+int spill_age;
 
 struct{
   unsigned int full:1;
@@ -46,14 +61,92 @@ static pthread_cond_t cond_no_empty;
 
 static time_t start, end;
 
+/*
+ * Events that did not fit into the buffer, in append-only segments. The events
+ * are read in order from the first segment, whose read offset is checkpointed,
+ * and written to the last one. Both offsets match when the spill is empty.
+ */
+STATIC const char * spill_dir = BUFFER_SPILL_DIR;
+STATIC struct {
+    unsigned int first;
+    long offset;
+    unsigned int last;
+    long write_offset;
+    long size;
+    unsigned int unsaved;
+    FILE * reader;
+    FILE * writer;
+} spill;
+
+/* Event rate and token bucket to send the events */
+STATIC volatile int eps_rate;
+static double eps_tokens;
+static struct timespec eps_refill;
+
+/**
+ * @brief Sleep according to the event rate
+ *
+ * Takes the events from a token bucket refilled at the current rate. With flow
+ * control the bucket holds one second of events, so the agent sends a burst
+ * after being idle. Otherwise it holds a single event.
+ *
+ * @param count Number of events sent in the loop.
+ */
+static void delay(int count);
+
+/**
+ * @brief Pack the following events of the buffer into a batch with the first one
+ *
+ * Takes events from the buffer while the batch fits into EVENT_BATCH_SIZE.
+ * It must be called with the buffer locked.
+ *
+ * @param first First event of the batch, already taken from the buffer.
+ * @param count Number of events in the batch.
+ * @return Batch to send, or NULL if no other event fits with the first one.
+ */
+STATIC char * buffer_pack(const char * first, int * count);
+
+/**
+ * @brief Find the segments and the checkpoint left in the spill directory
+ *
+ * @return 0 on success, -1 if the directory can't be used.
+ */
+STATIC int spill_init();
+
+/**
+ * @brief Append an event to the last segment of the spill
+ *
+ * It must be called with the buffer locked.
+ *
+ * @param msg Event to store.
+ * @return 0 on success, -1 if the event exceeds the quota or can't be written.
+ */
+STATIC int spill_write(const char * msg);
+
+/**
+ * @brief Take the oldest event of the spill
+ *
+ * Drains and removes the segments older than the age limit. It must be called
+ * with the buffer locked.
+ *
+ * @return Event allocated, or NULL if the spill is empty.
+ */
+STATIC char * spill_read();
+
 /**
- * @brief Sleep according to max_eps parameter
+ * @brief Move events of the spill into the buffer while it has room
  *
- * Sleep (1 / max_eps) - ts_loop
+ * It must be called with the buffer locked.
  *
- * @param ts_loop Loop time.
+ * @return Number of events moved.
  */
-static void delay(struct timespec * ts_loop);
+STATIC int spill_refill();
+
+/* The spill holds no event */
+#define spill_empty() (spill.first == spill.last && spill.offset == spill.write_offset)
+
+/* The buffer counts as full while it has no room or the events go to the spill */
+#define saturated() (full(i, j, agt->buflength + 1) || !spill_empty())
 
 /* Create agent buffer */
 void buffer_init(){
@@ -61,10 +154,14 @@ void buffer_init(){
     if (!buffer)
         os_calloc(agt->buflength+1, sizeof(char *), buffer);
 
+    eps_rate = agt->events_persec;
+
     /* Read internal configuration */
     warn_level = getDefine_Int("agent", "warn_level", 1, 100);
     normal_level = getDefine_Int("agent", "normal_level", 0, warn_level-1);
     tolerance = getDefine_Int("agent", "tolerance", 0, 600);
+    spill_size = getDefine_Int("agent", "buffer_spill_size", 0, 4096);
+    spill_age = getDefine_Int("agent", "buffer_spill_age", 0, 2592000);
 
     w_mutex_init(&mutex_lock, NULL);
     w_cond_init(&cond_no_empty, NULL);
@@ -72,6 +169,11 @@ void buffer_init(){
     if (tolerance == 0)
         mwarn(TOLERANCE_TIME);
 
+    if (spill_size > 0 && spill_init() < 0) {
+        mwarn("The agent buffer won't be spilled to disk.");
+        spill_size = 0;
+    }
+
     mdebug1("Agent buffer created.");
 }
 
@@ -84,7 +186,7 @@ int buffer_append(const char *msg){
     switch (state) {
 
         case NORMAL:
-            if (full(i, j, agt->buflength + 1)){
+            if (saturated()){
                 buff.full = 1;
                 state = FULL;
                 start = time(0);
@@ -95,7 +197,7 @@ int buffer_append(const char *msg){
             break;
 
         case WARNING:
-            if (full(i, j, agt->buflength + 1)){
+            if (saturated()){
                 buff.full = 1;
                 state = FULL;
                 start = time(0);
@@ -116,6 +218,25 @@ int buffer_append(const char *msg){
 
     w_agentd_state_update(INCREMENT_MSG_COUNT, NULL);
 
+    /* Once an event is spilled to disk, the next ones follow it until the spill is drained */
+
+    if (spill_size > 0 && (!spill_empty() || full(i, j, agt->buflength + 1))) {
+
+        int result = spill_write(msg);
+
+        if (result == 0) {
+            w_cond_signal(&cond_no_empty);
+        }
+
+        w_mutex_unlock(&mutex_lock);
+
+        if (result < 0) {
+            mdebug2("Unable to store new packet: Disk buffer is full.");
+        }
+
+        return result;
+    }
+
     /* When buffer is full, event is dropped */
 
     if (full(i, j, agt->buflength + 1)){
@@ -147,53 +268,54 @@ void *dispatch_buffer(__attribute__((unused)) void * arg){
     char normal_msg[OS_MAXSTR];
 
     char warn_str[OS_SIZE_2048];
-    struct timespec ts0;
-    struct timespec ts1;
 
     while(1){
-        gettime(&ts0);
-
         w_mutex_lock(&mutex_lock);
 
-        while(empty(i, j)){
+        while(empty(i, j) && spill_refill() == 0){
             w_cond_wait(&cond_no_empty, &mutex_lock);
         }
-        /* Check if buffer usage reaches any lower level */
-        switch (state) {
-
-            case NORMAL:
-                break;
-
-            case WARNING:
-                if (normal(i, j)){
-                    state = NORMAL;
-                    buff.normal = 1;
-                }
-                break;
-
-            case FULL:
-                if (nowarn(i, j))
-                    state = WARNING;
-
-                if (normal(i, j)){
-                    state = NORMAL;
-                    buff.normal = 1;
-                }
-                break;
-
-            case FLOOD:
-                if (nowarn(i, j))
-                    state = WARNING;
-
-                if (normal(i, j)){
-                    state = NORMAL;
-                    buff.normal = 1;
-                }
-                break;
+        /* Check if buffer usage reaches any lower level, it can't while the spill holds events */
+        if (spill_empty()) {
+            switch (state) {
+
+                case NORMAL:
+                    break;
+
+                case WARNING:
+                    if (normal(i, j)){
+                        state = NORMAL;
+                        buff.normal = 1;
+                    }
+                    break;
+
+                case FULL:
+                    if (nowarn(i, j))
+                        state = WARNING;
+
+                    if (normal(i, j)){
+                        state = NORMAL;
+                        buff.normal = 1;
+                    }
+                    break;
+
+                case FLOOD:
+                    if (nowarn(i, j))
+                        state = WARNING;
+
+                    if (normal(i, j)){
+                        state = NORMAL;
+                        buff.normal = 1;
+                    }
+                    break;
+            }
         }
 
         char * msg_output = buffer[j];
         forward(j, agt->buflength + 1);
+
+        int count = 1;
+        char * batch = event_batch_enabled ? buffer_pack(msg_output, &count) : NULL;
         w_mutex_unlock(&mutex_lock);
 
         if (buff.warn){
@@ -230,35 +352,434 @@ void *dispatch_buffer(__attribute__((unused)) void * arg){
         }
 
         os_wait();
-        send_msg(msg_output, -1);
+        send_msg(batch ? batch : msg_output, -1);
+        free(batch);
         free(msg_output);
 
-        gettime(&ts1);
-        time_sub(&ts1, &ts0);
+        delay(count);
+    }
+}
+
+STATIC char * buffer_pack(const char * first, int * count) {
+    char * batch = NULL;
+    size_t first_length = strlen(first);
+    size_t length = strlen(CONTROL_HEADER HC_BATCH) + EVENT_FRAME_SIZE + first_length;
+    size_t event_length;
+
+    *count = 1;
+
+    while (!empty(i, j)) {
+        event_length = strlen(buffer[j]);
+
+        if (length + EVENT_FRAME_SIZE + event_length > EVENT_BATCH_SIZE) {
+            break;
+        }
+
+        if (batch == NULL) {
+            os_malloc(EVENT_BATCH_SIZE + 1, batch);
+            length = snprintf(batch, EVENT_BATCH_SIZE + 1, "%s%zu\n%s", CONTROL_HEADER HC_BATCH, first_length, first);
+        }
+
+        length += snprintf(batch + length, EVENT_BATCH_SIZE + 1 - length, "%zu\n%s", event_length, buffer[j]);
+        os_free(buffer[j]);
+        forward(j, agt->buflength + 1);
+        (*count)++;
+    }
+
+    return batch;
+}
+
+/* Path of a spill segment */
+static void spill_path(char * path, size_t size, unsigned int segment) {
+    snprintf(path, size, "%s/%010u.seg", spill_dir, segment);
+}
+
+/* Number of a segment from its file name, 0 if the file is not a segment */
+static unsigned int spill_segment(const char * name) {
+    char * end;
+    unsigned int segment = strtoul(name, &end, 10);
+
+    return end == name || strcmp(end, ".seg") ? 0 : segment;
+}
+
+/* First segment from 'from' to the last one that exists, the segments in between are missing.
+ * The size of the spill is counted again from the segments left. */
+static unsigned int spill_find_segment(unsigned int from) {
+    char path[PATH_MAX];
+    unsigned int found = spill.last;
+    unsigned int segment;
+    long size = 0;
+    struct dirent * entry;
+    struct stat buf;
+    DIR * dir;
+
+    if (dir = opendir(spill_dir), !dir) {
+        return found;
+    }
 
-        if (ts1.tv_sec >= 0) {
-            delay(&ts1);
+    while (entry = readdir(dir), entry) {
+        if (segment = spill_segment(entry->d_name), segment < from || segment > spill.last) {
+            continue;
         }
+
+        spill_path(path, sizeof(path), segment);
+
+        if (stat(path, &buf) < 0) {
+            continue;
+        }
+
+        found = segment < found ? segment : found;
+        size += buf.st_size;
+    }
+
+    closedir(dir);
+
+    spill.size = size;
+    return found;
+}
+
+/* Save the read position, the events after it are sent again after a restart */
+static void spill_checkpoint() {
+    char path[PATH_MAX];
+    FILE * fp;
+
+    snprintf(path, sizeof(path), "%s/checkpoint", spill_dir);
+
+    if (fp = fopen(path, "w"), fp) {
+        fprintf(fp, "%u %ld\n", spill.first, spill.offset);
+        fclose(fp);
+    } else {
+        mdebug1(FOPEN_ERROR, path, errno, strerror(errno));
     }
+
+    spill.unsaved = 0;
 }
 
-void delay(struct timespec * ts_loop) {
-    long interval_ns = 1000000000 / agt->events_persec;
-    struct timespec ts_timeout = { interval_ns / 1000000000, interval_ns % 1000000000 };
-    time_sub(&ts_timeout, ts_loop);
+/* Remove the first segment and move to the next one */
+static void spill_next_segment(long segment_size) {
+    char path[PATH_MAX];
+
+    if (spill.reader) {
+        fclose(spill.reader);
+        spill.reader = NULL;
+    }
+
+    spill_path(path, sizeof(path), spill.first);
+
+    if (unlink(path) < 0 && errno != ENOENT) {
+        mdebug1(DELETE_ERROR, path, errno, strerror(errno));
+    }
+
+    spill.size -= segment_size;
+    spill.first++;
+    spill.offset = 0;
+    spill_checkpoint();
+}
+
+STATIC int spill_init() {
+    char path[PATH_MAX];
+    unsigned int segment;
+    unsigned int checkpoint = 0;
+    long offset = 0;
+    struct dirent * entry;
+    struct stat buf;
+    DIR * dir;
+    FILE * fp;
+
+    if (mkdir_ex(spill_dir) < 0) {
+        return -1;
+    }
+
+    if (dir = opendir(spill_dir), !dir) {
+        merror("Couldn't open directory '%s': %s", spill_dir, strerror(errno));
+        return -1;
+    }
+
+    spill.first = UINT_MAX;
+    spill.last = 0;
+    spill.size = 0;
 
-    if (ts_timeout.tv_sec >= 0) {
+    while (entry = readdir(dir), entry) {
+        if (segment = spill_segment(entry->d_name), segment == 0) {
+            continue;
+        }
+
+        spill_path(path, sizeof(path), segment);
+
+        if (stat(path, &buf) < 0) {
+            continue;
+        }
+
+        spill.first = segment < spill.first ? segment : spill.first;
+
+        if (segment >= spill.last) {
+            spill.last = segment;
+            spill.write_offset = buf.st_size;
+        }
+
+        spill.size += buf.st_size;
+    }
+
+    closedir(dir);
+
+    if (spill.first == UINT_MAX) {
+        spill.first = spill.last = 1;
+        spill.write_offset = 0;
+    }
+
+    spill.offset = 0;
+
+    snprintf(path, sizeof(path), "%s/checkpoint", spill_dir);
+
+    if (fp = fopen(path, "r"), fp) {
+        if (fscanf(fp, "%u %ld", &checkpoint, &offset) == 2 && checkpoint == spill.first && offset >= 0) {
+            spill.offset = offset;
+        }
+
+        fclose(fp);
+    }
+
+    if (spill.first == spill.last && spill.offset > spill.write_offset) {
+        spill.offset = spill.write_offset;
+    }
+
+    if (!spill_empty()) {
+        minfo("Agent buffer: %ld bytes of events stored on disk since the last run.", spill.size - spill.offset);
+    }
+
+    mdebug1("Agent buffer spilled to '%s', up to %d MiB.", spill_dir, spill_size);
+
+    return 0;
+}
+
+STATIC int spill_write(const char * msg) {
+    char path[PATH_MAX];
+    size_t length = strlen(msg);
+    int written;
+
+    if (spill.size + (long)(length + EVENT_FRAME_SIZE) > (long)spill_size * OS_SIZE_1048576) {
+        return -1;
+    }
+
+    if (spill.write_offset >= SPILL_SEGMENT_SIZE) {
+        if (spill.writer) {
+            fclose(spill.writer);
+            spill.writer = NULL;
+        }
+
+        spill.last++;
+        spill.write_offset = 0;
+    }
+
+    if (!spill.writer) {
+        spill_path(path, sizeof(path), spill.last);
+
+        if (spill.writer = fopen(path, "ab"), !spill.writer) {
+            mdebug1(FOPEN_ERROR, path, errno, strerror(errno));
+            return -1;
+        }
+    }
+
+    // The event is readable as soon as it's written
+    written = fprintf(spill.writer, "%zu\n", length);
+
+    if (written < 0 || fwrite(msg, 1, length, spill.writer) != length || fflush(spill.writer) != 0) {
+        mdebug1("Couldn't write the event into the disk buffer: %s.", strerror(errno));
+        return -1;
+    }
+
+    spill.write_offset += written + length;
+    spill.size += written + length;
+
+    return 0;
+}
+
+STATIC char * spill_read() {
+    char path[PATH_MAX];
+    char header[EVENT_FRAME_SIZE + 1];
+    char * msg;
+    char * end;
+    size_t length;
+    struct stat buf;
+
+    while (!spill_empty()) {
+        if (!spill.reader) {
+            spill_path(path, sizeof(path), spill.first);
+
+            // The last segment is still being written
+            if (spill_age > 0 && spill.first < spill.last && stat(path, &buf) == 0 && time(NULL) - buf.st_mtime > spill_age) {
+                mwarn("Agent buffer: dropping the events of '%s', older than %d seconds.", path, spill_age);
+                spill_next_segment(buf.st_size);
+                continue;
+            }
+
+            // The segments are numbered in order, but some may have been removed from the directory
+            if (spill.reader = fopen(path, "rb"), !spill.reader && errno == ENOENT) {
+                if (spill.first == spill.last) {
+                    mwarn("Agent buffer: segment %u is missing, its events are lost.", spill.first);
+                    spill.offset = spill.write_offset;
+                    break;
+                }
+
+                unsigned int next = spill_find_segment(spill.first + 1);
+
+                mwarn("Agent buffer: segment %u is missing, reading from segment %u.", spill.first, next);
+                spill.first = next;
+                spill.offset = 0;
+                spill_checkpoint();
+                continue;
+            }
+
+            if (!spill.reader || fseek(spill.reader, spill.offset, SEEK_SET) < 0) {
+                mdebug1(FOPEN_ERROR, path, errno, strerror(errno));
+                spill_next_segment(stat(path, &buf) == 0 ? buf.st_size : 0);
+                continue;
+            }
+        } else if (spill.first == spill.last) {
+            // Discard the end of file read before the writer appended more events
+            fseek(spill.reader, spill.offset, SEEK_SET);
+        }
+
+        if (!fgets(header, sizeof(header), spill.reader)) {
+            if (spill.first < spill.last) {
+                spill_next_segment(spill.offset);
+                continue;
+            }
+
+            return NULL;
+        }
+
+        length = strtoul(header, &end, 10);
+
+        if (*end != '\n') {
+            merror("Agent buffer: corrupted segment %u at offset %ld, skipping it.", spill.first, spill.offset);
+
+            if (spill.first < spill.last) {
+                spill_path(path, sizeof(path), spill.first);
+                spill_next_segment(stat(path, &buf) == 0 ? buf.st_size : spill.offset);
+                continue;
+            }
+
+            spill.offset = spill.write_offset;
+            break;
+        }
+
+        os_malloc(length + 1, msg);
+
+        if (fread(msg, 1, length, spill.reader) != length) {
+            // Read it again from the offset
+            fclose(spill.reader);
+            spill.reader = NULL;
+            os_free(msg);
+            return NULL;
+        }
+
+        msg[length] = '\0';
+        spill.offset += (end - header) + 1 + length;
+
+        if (++spill.unsaved >= SPILL_CHECKPOINT_EVENTS) {
+            spill_checkpoint();
+        }
+
+        return msg;
+    }
+
+    // Drained: start a new segment and release the disk
+    if (spill_empty() && (spill.offset > 0 || spill.writer)) {
+        if (spill.writer) {
+            fclose(spill.writer);
+            spill.writer = NULL;
+        }
+
+        spill.last++;
+        spill.write_offset = 0;
+        spill_next_segment(spill.offset);
+    }
+
+    return NULL;
+}
+
+STATIC int spill_refill() {
+    char * msg;
+    int count = 0;
+
+    if (spill_size <= 0) {
+        return 0;
+    }
+
+    while (count < SPILL_REFILL_EVENTS && !full(i, j, agt->buflength + 1) && (msg = spill_read(), msg)) {
+        buffer[i] = msg;
+        forward(i, agt->buflength + 1);
+        count++;
+    }
+
+    // Release the segment as soon as the spill is drained
+    if (spill_empty()) {
+        spill_read();
+    }
+
+    return count;
+}
+
+void delay(int count) {
+    double rate = eps_rate;
+    double capacity = agt->flags.flow_control ? rate : 1;
+    double elapsed;
+    struct timespec now;
+
+    gettime(&now);
+    elapsed = (now.tv_sec - eps_refill.tv_sec) + (now.tv_nsec - eps_refill.tv_nsec) / 1e9;
+    eps_refill = now;
+
+    if (elapsed > 0) {
+        eps_tokens += elapsed * rate;
+    }
+
+    if (eps_tokens > capacity) {
+        eps_tokens = capacity;
+    }
+
+    eps_tokens -= count;
+
+    if (eps_tokens < 0) {
+        double wait = -eps_tokens / rate;
+        struct timespec ts_timeout = { (time_t)wait, (long)((wait - (time_t)wait) * 1e9) };
         nanosleep(&ts_timeout, NULL);
     }
 }
 
+void buffer_flow_control(const cJSON * ack_info) {
+    const cJSON * usage = cJSON_GetObjectItem(ack_info, "queue");
+    int rate = eps_rate;
+    int lowest = min_eps > 0 ? min_eps : 1;
+
+    if (!cJSON_IsNumber(usage)) {
+        /* The manager does not send its queue usage: keep the configured rate */
+        eps_rate = agt->events_persec;
+        return;
+    }
+
+    if (usage->valueint >= FLOW_HIGH_USAGE) {
+        rate = rate / 2 > lowest ? rate / 2 : lowest;
+    } else if (usage->valueint < FLOW_LOW_USAGE) {
+        rate += agt->events_persec / 10 > 0 ? agt->events_persec / 10 : 1;
+        rate = rate < agt->events_persec ? rate : agt->events_persec;
+    }
+
+    if (rate != eps_rate) {
+        mdebug1("Manager queue usage: %d%%. Event rate set to %d eps.", usage->valueint, rate);
+        eps_rate = rate;
+    }
+}
+
 int w_agentd_get_buffer_lenght() {
 
     int retval = -1;
 
     if (agt->buffer > 0) {
         w_mutex_lock(&mutex_lock);
-        retval = (i - j) % (agt->buflength + 1);
+        // The events spilled to disk don't fit into the buffer
+        retval = spill_empty() ? (i - j) % (agt->buflength + 1) : agt->buflength;
         w_mutex_unlock(&mutex_lock);
 
         retval = (retval < 0) ? (retval + agt->buflength + 1) : retval;
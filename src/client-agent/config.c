@@ -74,6 +74,10 @@ int ClientConf(const char *cfgfile)
         agt->events_persec = min_eps;
     }
 
+    agt->flags.event_batch = getDefine_Int("agent", "event_batch", 0, 1);
+    agt->flags.flow_control = getDefine_Int("agent", "flow_control", 0, 1);
+    agt->flags.compact_keepalive = getDefine_Int("agent", "compact_keepalive", 0, 1);
+
     return (1);
 }
 
@@ -215,9 +219,15 @@ cJSON *getAgentInternalOptions(void) {
     cJSON_AddNumberToObject(agent,"warn_level",warn_level);
     cJSON_AddNumberToObject(agent,"normal_level",normal_level);
     cJSON_AddNumberToObject(agent,"tolerance",tolerance);
+    cJSON_AddNumberToObject(agent,"buffer_spill_size",spill_size);
+    cJSON_AddNumberToObject(agent,"buffer_spill_age",spill_age);
+    cJSON_AddNumberToObject(agent,"queue_ring_size",queue_ring_size);
     cJSON_AddNumberToObject(agent,"recv_timeout",timeout);
     cJSON_AddNumberToObject(agent,"state_interval",interval);
     cJSON_AddNumberToObject(agent,"min_eps",min_eps);
+    cJSON_AddNumberToObject(agent,"event_batch",agt->flags.event_batch);
+    cJSON_AddNumberToObject(agent,"flow_control",agt->flags.flow_control);
+    cJSON_AddNumberToObject(agent,"compact_keepalive",agt->flags.compact_keepalive);
 #ifdef CLIENT
     cJSON_AddNumberToObject(agent,"remote_conf",remote_conf);
 #endif
@@ -13,6 +13,25 @@
 #include "os_net/os_net.h"
 #include "sec.h"
 
+/* Size of the rings the modules may send the events through (KiB) */
+int queue_ring_size;
+
+#ifdef __linux__
+/**
+ * @brief Serve the events of a ring announced by a module until the module closes it
+ *
+ * @param arg Ring attached.
+ */
+static void * w_agentd_ring_reader(void * arg);
+
+/**
+ * @brief Attach a ring announced through the queue and start its reader
+ *
+ * @param name Name of the ring.
+ */
+static void w_agentd_ring_start(const char * name);
+#endif
+
 
 /* Receive a message locally on the agent and forward it to the manager */
 void *EventForward()
@@ -27,6 +46,14 @@ void *EventForward()
 
     while ((recv_b = recv(agt->m_queue, msg, OS_MAXSTR, MSG_DONTWAIT)) > 0) {
         msg[recv_b] = '\0';
+
+#ifdef __linux__
+        if (!strncmp(msg, MQ_RING_HEADER, strlen(MQ_RING_HEADER))) {
+            w_agentd_ring_start(msg + strlen(MQ_RING_HEADER));
+            continue;
+        }
+#endif
+
         if (agt->buffer){
             if (buffer_append(msg) < 0) {
                 break;
@@ -43,3 +70,65 @@ void *EventForward()
 
     return (NULL);
 }
+
+/* Advertise the ring size to the modules, the rings need the buffer to be served by several threads */
+void w_agentd_ring_init() {
+    FILE * fp;
+
+    queue_ring_size = getDefine_Int("agent", "queue_ring_size", 0, 65536);
+
+#ifdef __linux__
+    if (queue_ring_size > 0 && agt->buffer) {
+        if (fp = fopen(MQ_RING_ADVERT, "w"), fp) {
+            fprintf(fp, "%zu\n", (size_t)queue_ring_size * 1024);
+            fclose(fp);
+            mdebug1("Modules may send the events through rings of %d KiB.", queue_ring_size);
+            return;
+        }
+
+        merror(FOPEN_ERROR, MQ_RING_ADVERT, errno, strerror(errno));
+    }
+
+    if (unlink(MQ_RING_ADVERT) < 0 && errno != ENOENT) {
+        mdebug1(DELETE_ERROR, MQ_RING_ADVERT, errno, strerror(errno));
+    }
+#else
+    (void)fp;
+#endif
+}
+
+#ifdef __linux__
+
+static void w_agentd_ring_start(const char * name) {
+    mq_ring_t * ring;
+
+    if (queue_ring_size <= 0 || !agt->buffer) {
+        mdebug1("Ignoring the ring '%s': rings are disabled.", name);
+        return;
+    }
+
+    if (ring = mq_ring_attach(name), ring) {
+        mdebug1("Serving the events of the ring '%s'.", name);
+        w_create_thread(w_agentd_ring_reader, ring);
+    }
+}
+
+static void * w_agentd_ring_reader(void * arg) {
+    mq_ring_t * ring = arg;
+    char msg[OS_MAXSTR + 1];
+    ssize_t length;
+
+    while (length = mq_ring_pop(ring, msg, sizeof(msg), 1000), length >= 0) {
+        if (length > 0) {
+            // The event is dropped if the buffer is full, as the socket does
+            buffer_append(msg);
+        }
+    }
+
+    mdebug1("Ring released by its module.");
+    mq_ring_detach(ring);
+
+    return NULL;
+}
+
+#endif
@@ -17,6 +17,9 @@
 static char *g_shared_mg_file_hash = NULL;
 /* Keeps the timestamp of the last notification. */
 static time_t g_saved_time = 0;
+/* Hash of the last full keepalive, and sequence of the compact ones sent after it */
+static os_md5 g_keepalive_sum = "";
+static unsigned long g_keepalive_seq = 0;
 
 /* Return the names of the files in a directory */
 char *getsharedfiles()
@@ -81,6 +84,11 @@ void clear_merged_hash_cache() {
     os_free(g_shared_mg_file_hash);
 }
 
+void request_full_keepalive() {
+    g_keepalive_sum[0] = '\0';
+    g_saved_time = 0;
+}
+
 /* Periodically send notification to server */
 void run_notify()
 {
@@ -200,6 +208,23 @@ void run_notify()
         }
     }
 
+    /* Send only the hash of the metadata while it doesn't change */
+    if (compact_keepalive_enabled) {
+        os_md5 msg_sum;
+        // The manager hashes the message once its UTF-8 is filtered, so are the bytes hashed here
+        char * clean = w_utf8_filter(tmp_msg + strlen(CONTROL_HEADER), true);
+
+        OS_MD5_Str(clean, -1, msg_sum);
+        os_free(clean);
+
+        if (strcmp(msg_sum, g_keepalive_sum) == 0) {
+            snprintf(tmp_msg, OS_MAXSTR - OS_HEADER_SIZE, "%s%s%lu %s", CONTROL_HEADER, HC_KEEPALIVE, ++g_keepalive_seq, msg_sum);
+        } else {
+            strcpy(g_keepalive_sum, msg_sum);
+            g_keepalive_seq = 0;
+        }
+    }
+
     /* Send status message */
     mdebug2("Sending keep alive: %s", tmp_msg);
     send_msg(tmp_msg, -1);
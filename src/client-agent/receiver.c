@@ -24,6 +24,10 @@ static FILE *fp = NULL;
 static char file_sum[34] = "";
 static char file[OS_SIZE_1024 + 1] = "";
 static const char * IGNORE_LIST[] = { SHAREDCFG_FILENAME, NULL };
+/* Shared files only loaded at startup, the rest are read again by their modules */
+static const char * RESTART_LIST[] = { "agent.conf", DEFAULTAR_FILE, NULL };
+
+static void remove_stale_shared_files(char ** unmerged, char *** changed);
 #ifdef WIN32
 w_queue_t * winexec_queue;
 #endif
@@ -152,7 +156,18 @@ int receive_msg()
             }
 
             /* Ack from server */
-            else if (strcmp(tmp_msg, HC_ACK) == 0) {
+            else if (strncmp(tmp_msg, HC_ACK, strlen(HC_ACK)) == 0) {
+                if (tmp_msg[strlen(HC_ACK)] != '\0') {
+                    cJSON * ack_info = cJSON_Parse(tmp_msg + strlen(HC_ACK));
+                    buffer_flow_control(ack_info);
+
+                    /* The manager doesn't know the metadata of the compact keepalive */
+                    if (cJSON_IsTrue(cJSON_GetObjectItem(ack_info, "metadata"))) {
+                        request_full_keepalive();
+                    }
+
+                    cJSON_Delete(ack_info);
+                }
                 continue;
             }
 
@@ -275,19 +290,31 @@ int receive_msg()
                         final_file = strrchr(file, '/');
                         if (final_file) {
                             if (strcmp(final_file + 1, SHAREDCFG_FILENAME) == 0) {
-                                if (cldir_ex_ignore(SHAREDCFG_DIR, IGNORE_LIST)) {
-                                    mwarn("Could not clean up shared directory.");
-                                }
+                                char ** unmerged = NULL;
+                                char ** changed = NULL;
 
-                                if(!UnmergeFiles(file, SHAREDCFG_DIR, OS_TEXT)){
+                                if(!UnmergeFiles_ex(file, SHAREDCFG_DIR, OS_TEXT, &unmerged, &changed)){
                                     char msg_output[OS_MAXSTR];
 
                                     snprintf(msg_output, OS_MAXSTR, "%c:%s:%s",  LOCALFILE_MQ, "wazuh-agent", AG_IN_UNMERGE);
                                     send_msg(msg_output, -1);
                                 }
                                 else {
+                                    remove_stale_shared_files(unmerged, &changed);
                                     clear_merged_hash_cache();
-                                    if (agt->flags.remote_conf && !verifyRemoteConf()) {
+
+                                    for (int i = 0; changed[i]; i++) {
+                                        mdebug1("Shared file updated: '%s'", changed[i]);
+                                    }
+
+                                    /* Only the changes in the files loaded at startup need a restart */
+                                    int restart = 0;
+
+                                    for (int i = 0; RESTART_LIST[i]; i++) {
+                                        restart |= w_str_in_array(RESTART_LIST[i], (const char **)changed);
+                                    }
+
+                                    if (restart && agt->flags.remote_conf && !verifyRemoteConf()) {
                                         if (agt->flags.auto_restart) {
                                             minfo("Agent is restarting due to shared configuration changes.");
                                             restartAgent();
@@ -296,6 +323,9 @@ int receive_msg()
                                         }
                                     }
                                 }
+
+                                free_strarray(unmerged);
+                                free_strarray(changed);
                             }
                         } else {
                             /* Remove file */
@@ -381,3 +411,41 @@ DWORD WINAPI receiver_thread(__attribute__((unused)) LPVOID none)
     return 0;
 }
 #endif
+
+/* Remove the shared files that are no longer in the merged file, adding them to the changed list */
+static void remove_stale_shared_files(char ** unmerged, char *** changed) {
+    DIR * dir;
+    struct dirent * dirent;
+    char path[PATH_MAX + 1];
+    size_t count;
+
+    if (dir = opendir(SHAREDCFG_DIR), !dir) {
+        mwarn("Could not clean up shared directory.");
+        return;
+    }
+
+    for (count = 0; (*changed)[count]; count++);
+
+    while (dirent = readdir(dir), dirent) {
+        if (dirent->d_name[0] == '.' && (dirent->d_name[1] == '\0' || (dirent->d_name[1] == '.' && dirent->d_name[2] == '\0'))) {
+            continue;
+        }
+
+        if (w_str_in_array(dirent->d_name, IGNORE_LIST) || w_str_in_array(dirent->d_name, (const char **)unmerged)) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", SHAREDCFG_DIR, dirent->d_name);
+
+        if (rmdir_ex(path) < 0) {
+            mwarn("Could not clean up shared directory.");
+            continue;
+        }
+
+        os_realloc(*changed, (count + 2) * sizeof(char *), *changed);
+        os_strdup(dirent->d_name, (*changed)[count]);
+        (*changed)[++count] = NULL;
+    }
+
+    closedir(dir);
+}
@@ -30,6 +30,8 @@
 #define ENROLLMENT_RETRY_TIME_DELTA 5
 
 int timeout;    //timeout in seconds waiting for a server reply
+volatile int event_batch_enabled;   // the server accepts batches of events
+volatile int compact_keepalive_enabled; // the server accepts compact keepalives
 
 static ssize_t receive_message(char *buffer, unsigned int max_lenght);
 static void w_agentd_keys_init (void);
@@ -334,6 +336,15 @@ static bool agent_handshake_to_server(int server_id, bool is_startup) {
 
     cJSON* agent_info = cJSON_CreateObject();
     cJSON_AddStringToObject(agent_info, "version", __ossec_version);
+    if (agt->flags.event_batch) {
+        cJSON_AddTrueToObject(agent_info, "batch");
+    }
+    if (agt->flags.flow_control) {
+        cJSON_AddTrueToObject(agent_info, "flow");
+    }
+    if (agt->flags.compact_keepalive) {
+        cJSON_AddTrueToObject(agent_info, "keepalive");
+    }
     char *agent_info_string = cJSON_PrintUnformatted(agent_info);
     cJSON_Delete(agent_info);
 
@@ -356,9 +367,18 @@ static bool agent_handshake_to_server(int server_id, bool is_startup) {
                 /* Check for commands */
                 if (IsValidHeader(tmp_msg)) {
                     /* If it is an ack reply */
-                    if (strcmp(tmp_msg, HC_ACK) == 0) {
+                    if (strncmp(tmp_msg, HC_ACK, strlen(HC_ACK)) == 0) {
                         available_server = time(0);
 
+                        /* The manager tells whether it accepts batches of events */
+                        cJSON *ack_info = cJSON_Parse(tmp_msg + strlen(HC_ACK));
+                        event_batch_enabled = cJSON_IsTrue(cJSON_GetObjectItem(ack_info, "batch"));
+                        compact_keepalive_enabled = cJSON_IsTrue(cJSON_GetObjectItem(ack_info, "keepalive"));
+                        /* The first keepalive of a connection carries the full metadata */
+                        request_full_keepalive();
+                        buffer_flow_control(ack_info);
+                        cJSON_Delete(ack_info);
+
                         minfo(AG_CONNECTED, agt->server[server_id].rip,
                                 agt->server[server_id].port, agt->server[server_id].protocol == IPPROTO_UDP ? "udp" : "tcp");
 
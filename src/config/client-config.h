@@ -16,6 +16,9 @@
 typedef struct agent_flags_t {
     unsigned int auto_restart:1;
     unsigned int remote_conf:1;
+    unsigned int event_batch:1;
+    unsigned int flow_control:1;
+    unsigned int compact_keepalive:1;
 } agent_flags_t;
 
 typedef struct agent_server {
@@ -21,8 +21,15 @@ typedef struct _SyslogConfig {
     unsigned int *rule_id;
     unsigned int priority;
     unsigned int use_fqdn;
+    unsigned int protocol;
     int socket;
 
+    char *buffer;           /* Octet-counted frames pending to be sent (TCP) */
+    size_t buffer_len;
+    unsigned int buffer_count;  /* Number of frames in the buffer */
+    time_t buffer_time;     /* Time of the oldest frame in the buffer */
+    unsigned long dropped;  /* Buffered messages lost on a disconnection */
+
     char *server;
     OSMatch *group;
     OSMatch *location;
@@ -18,6 +18,7 @@
 #ifndef CLIENT
 int Read_Global_limits(const OS_XML *xml, XML_NODE node, _Config *Config);
 int Read_Global_limits_eps(XML_NODE node, _Config *Config);
+int Read_Global_limits_priority(XML_NODE node, _Config *Config);
 #endif
 
 int Read_GlobalSK(XML_NODE node, void *configp, __attribute__((unused)) void *mailp)
@@ -793,6 +794,13 @@ void config_free(_Config *config) {
         OSHash_Free(config->g_rules_hash);
     }
 
+    for (int i = 0; i < EVENT_PRIORITY_CLASSES; i++) {
+        if (config->priority[i].location) {
+            OSMatch_FreePattern(config->priority[i].location);
+            os_free(config->priority[i].location);
+        }
+    }
+
     if (config->hostname_white_list) {
         int i = 0;
         while (config->hostname_white_list[i]) {
@@ -830,6 +838,7 @@ void config_free(_Config *config) {
 int Read_Global_limits(const OS_XML *xml, XML_NODE node, _Config *Config) {
     /* XML definitions */
     const char *xml_eps = "eps";
+    const char *xml_priority = "priority";
 
     for (int i = 0; node[i]; i++) {
         // eps
@@ -845,6 +854,19 @@ int Read_Global_limits(const OS_XML *xml, XML_NODE node, _Config *Config) {
             }
             OS_ClearNode(chld_node);
         }
+        // priority
+        else if (strcmp(node[i]->element, xml_priority) == 0) {
+            XML_NODE chld_node = NULL;
+            if (!(chld_node = OS_GetElementsbyNode(xml, node[i]))) {
+                merror(XML_INVELEM, node[i]->element);
+                return (OS_INVALID);
+            }
+            if (Read_Global_limits_priority(chld_node, Config) < 0) {
+                OS_ClearNode(chld_node);
+                return (OS_INVALID);
+            }
+            OS_ClearNode(chld_node);
+        }
     }
     return OS_SUCCESS;
 }
@@ -895,4 +917,74 @@ int Read_Global_limits_eps(XML_NODE node, _Config *Config) {
 
     return OS_SUCCESS;
 }
+
+int Read_Global_limits_priority(XML_NODE node, _Config *Config) {
+    /* XML definitions */
+    static const char *xml_classes[EVENT_PRIORITY_CLASSES] = { "high", "normal", "low" };
+    static const char *xml_reserve = "reserve";
+    static const char *xml_weight = "weight";
+    int priority;
+
+    for (int i = 0; node[i]; i++) {
+        for (priority = 0; priority < EVENT_PRIORITY_CLASSES && strcmp(node[i]->element, xml_classes[priority]); priority++);
+
+        if (priority == EVENT_PRIORITY_CLASSES) {
+            merror(XML_INVELEM, node[i]->element);
+            return (OS_INVALID);
+        }
+
+        for (int j = 0; node[i]->attributes && node[i]->attributes[j]; j++) {
+            if (!OS_StrIsNum(node[i]->values[j])) {
+                merror(XML_VALUEERR, node[i]->attributes[j], node[i]->values[j]);
+                return (OS_INVALID);
+            }
+
+            // The normal class takes the room the others leave
+            if (strcmp(node[i]->attributes[j], xml_reserve) == 0 && priority != EVENT_PRIORITY_NORMAL) {
+                if (atoi(node[i]->values[j]) > 100) {
+                    merror(XML_VALUEERR, node[i]->attributes[j], node[i]->values[j]);
+                    return (OS_INVALID);
+                }
+                if (Config) {
+                    Config->priority[priority].reserve = (unsigned int) atoi(node[i]->values[j]);
+                }
+            } else if (strcmp(node[i]->attributes[j], xml_weight) == 0) {
+                if (atoi(node[i]->values[j]) < 1 || atoi(node[i]->values[j]) > 100) {
+                    merror(XML_VALUEERR, node[i]->attributes[j], node[i]->values[j]);
+                    return (OS_INVALID);
+                }
+                if (Config) {
+                    Config->priority[priority].weight = (unsigned int) atoi(node[i]->values[j]);
+                }
+            } else {
+                merror(XML_INVATTR, node[i]->attributes[j], node[i]->element);
+                return (OS_INVALID);
+            }
+        }
+
+        // The normal class takes the unmatched events, so it has no locations
+        if (priority == EVENT_PRIORITY_NORMAL || !Config || !node[i]->content || *node[i]->content == '\0') {
+            continue;
+        }
+
+        if (Config->priority[priority].location) {
+            OSMatch_FreePattern(Config->priority[priority].location);
+            os_free(Config->priority[priority].location);
+        }
+
+        os_calloc(1, sizeof(OSMatch), Config->priority[priority].location);
+
+        if (!OSMatch_Compile(node[i]->content, Config->priority[priority].location, 0)) {
+            merror(REGEX_COMPILE, node[i]->content, Config->priority[priority].location->error);
+            return (OS_INVALID);
+        }
+    }
+
+    if (Config && Config->priority[EVENT_PRIORITY_HIGH].reserve + Config->priority[EVENT_PRIORITY_LOW].reserve > 90) {
+        merror("The high and low priority classes cannot reserve more than 90%% of the events queue.");
+        return (OS_INVALID);
+    }
+
+    return OS_SUCCESS;
+}
 #endif
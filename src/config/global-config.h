@@ -26,6 +26,21 @@ typedef struct __eps {
     bool maximum_found;
 } _eps;
 
+/* Priority classes of the events input queue, by decreasing priority */
+#define EVENT_PRIORITY_HIGH 0
+#define EVENT_PRIORITY_NORMAL 1
+#define EVENT_PRIORITY_LOW 2
+#define EVENT_PRIORITY_CLASSES PRIO_QUEUE_CLASSES
+
+typedef struct __priority {
+    // Locations of the class, the normal class takes the events that match none
+    OSMatch *location;
+    // Percentage of the events queue reserved for the class
+    unsigned int reserve;
+    // Share of the decoding batches when every class is backlogged
+    unsigned int weight;
+} _priority;
+
 /* Configuration structure */
 typedef struct __Config {
     u_int8_t logall;
@@ -117,6 +132,7 @@ typedef struct __Config {
     wlabel_t *labels; /* null-ended label set */
     int label_cache_maxage;
     int show_hidden_labels;
+    int wdb_binary_protocol;
 
     // Cluster configuration
     char *cluster_name;
@@ -127,10 +143,20 @@ typedef struct __Config {
     int rotate_interval;
     int min_rotate_interval;
     ssize_t max_output_size;
+    int compress_rotated;
+    size_t log_buffer_size;
+    int fsync_interval;
+    unsigned int latency_sample;
+    int profile_ruleset;
+    int decode_unused_fields;
+    int instance;               ///< Number of this analysisd instance (-n), 0 for the main one
     long queue_size;
 
     // EPS limits configuration
     _eps eps;
+
+    // Priority classes of the events queue
+    _priority priority[EVENT_PRIORITY_CLASSES];
 } _Config;
 
 
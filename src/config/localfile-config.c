@@ -111,6 +111,7 @@ int Read_Localfile(XML_NODE node, void *d1, __attribute__((unused)) void *d2)
     logf[pl].future = 1;
     logf[pl].reconnect_time = DEFAULT_EVENTCHANNEL_REC_TIME;
     logf[pl].regex_ignore = NULL;
+    logf[pl].regex_ignore_pcre2 = NULL;
     logf[pl].regex_restrict = NULL;
 
     /* Search for entries related to files */
@@ -366,6 +367,7 @@ int Read_Localfile(XML_NODE node, void *d1, __attribute__((unused)) void *d2)
 
             } else if (strcmp(logf[pl].logformat, EVENTLOG) == 0) {
             } else if (strcmp(logf[pl].logformat, EVENTCHANNEL) == 0) {
+            } else if (strcmp(logf[pl].logformat, JOURNALD_LOG) == 0) {
             } else if (strcmp(logf[pl].logformat, MACOS) == 0) {
 #if defined(Darwin) || (defined(__linux__) && defined(WAZUH_UNIT_TESTING))
                 os_calloc(1, sizeof(w_macos_log_config_t), logf[pl].macos_log);
@@ -527,6 +529,9 @@ int Read_Localfile(XML_NODE node, void *d1, __attribute__((unused)) void *d2)
         i++;
     }
 
+    /* Evaluate all the PCRE2 ignore expressions in a single match */
+    logf[pl].regex_ignore_pcre2 = w_expression_combine_pcre2(logf[pl].regex_ignore);
+
     if (logf[pl].target == NULL) {
         os_calloc(2, sizeof(char*), logf[pl].target);
         os_strdup("agent", logf[pl].target[0]);
@@ -544,6 +549,9 @@ int Read_Localfile(XML_NODE node, void *d1, __attribute__((unused)) void *d2)
             mwarn(LOGCOLLECTOR_MISSING_LOCATION_MACOS);
             // Neceesary to check duplicated blocks
             os_strdup(MACOS, logf[pl].file);
+        } else if (strcmp(logf[pl].logformat, JOURNALD_LOG) == 0) {
+            // Neceesary to check duplicated blocks
+            os_strdup(JOURNALD_LOG, logf[pl].file);
         } else {
             merror(MISS_FILE);
             os_strdup("", logf[pl].file);
@@ -587,6 +595,13 @@ int Read_Localfile(XML_NODE node, void *d1, __attribute__((unused)) void *d2)
             mwarn(LOGCOLLECTOR_OPTION_IGNORED, MACOS, xml_localfile_alias);
         }
     }
+    /* Verify journald config */
+    if (strcmp(logf[pl].logformat, JOURNALD_LOG) == 0 && strcmp(logf[pl].file, JOURNALD_LOG) != 0) {
+        mwarn(LOGCOLLECTOR_INV_JOURNALD, logf[pl].file);
+        os_free(logf[pl].file);
+        w_strdup(JOURNALD_LOG, logf[pl].file);
+    }
+
     /* Verify Multiline Regex Config */
     if (strcmp(logf[pl].logformat, MULTI_LINE_REGEX) == 0) {
 
@@ -821,6 +836,9 @@ void Free_Logreader(logreader * logf) {
             OSList_Destroy(logf->regex_ignore);
             logf->regex_ignore = NULL;
         }
+        if (logf->regex_ignore_pcre2) {
+            w_free_expression_t(&logf->regex_ignore_pcre2);
+        }
         if (logf->regex_restrict) {
             OSList_Destroy(logf->regex_restrict);
             logf->regex_restrict = NULL;
@@ -834,7 +852,13 @@ void Free_Logreader(logreader * logf) {
             free(logf->target);
         }
 
-        os_free(logf->log_target);
+        if (logf->log_target) {
+            for (i = 0; logf->log_target[i].log_socket; i++) {
+                log_format_free(logf->log_target[i].compiled_format);
+            }
+
+            os_free(logf->log_target);
+        }
 
         labels_free(logf->labels);
 
@@ -14,6 +14,7 @@
 #define EVENTLOG     "eventlog"
 #define EVENTCHANNEL "eventchannel"
 #define MACOS        "macos"
+#define JOURNALD_LOG "journald"
 #define MULTI_LINE_REGEX              "multi-line-regex"
 #define MULTI_LINE_REGEX_TIMEOUT      5
 #define MULTI_LINE_REGEX_MAX_TIMEOUT  120
@@ -69,6 +70,7 @@ typedef struct _outformat {
 
 typedef struct _logtarget {
     char * format;
+    struct log_format_t * compiled_format;  ///< Format parsed by log_builder_compile()
     logsocket * log_socket;
 } logtarget;
 
@@ -177,6 +179,7 @@ typedef struct _logreader {
     DWORD fd;
 #else
     ino_t fd;
+    int wd;             ///< inotify watch descriptor, 0 if the file is polled
 #endif
 
     /* ffile - format file is only used when
@@ -188,6 +191,7 @@ typedef struct _logreader {
     char *logformat;
     w_multiline_config_t * multiline; ///< Multiline regex config & state
     w_macos_log_config_t * macos_log;   ///< macOS log config & state
+    bool journal_log;                   ///< True if the entries are read from the systemd journal
     long linecount;
     char *djb_program_name;
     char * channel_str;
@@ -207,9 +211,12 @@ typedef struct _logreader {
     int duplicated;
     char *exclude;
     OSList *regex_ignore;
+    w_expression_t *regex_ignore_pcre2; ///< PCRE2 ignore expressions combined, NULL if evaluated one by one
     OSList *regex_restrict;
     wlabel_t *labels;
     pthread_mutex_t mutex;
+    int thread_id;          ///< Input thread that reads this file
+    uint64_t read_bytes;    ///< Bytes read since the last rebalance of the input threads
     int exists;
     unsigned int age;
     char *age_str;
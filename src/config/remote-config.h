@@ -41,8 +41,12 @@ typedef struct _remoted {
     os_ip **denyips;
 
     int m_queue;
+    int *m_queues;      ///< Queues of the additional analysisd instances, by instance number
+    int analysisd_instances; ///< Number of analysisd instances decoding the agent events
     int tcp_sock;       ///< This socket is used to receive requests over TCP
     int udp_sock;       ///< This socket is used to receive requests over UDP
+    int *udp_socks;     ///< Additional UDP sockets bound to the same port, one per UDP listener thread
+    int udp_listeners;  ///< Number of UDP sockets, including udp_sock
     int position;       ///< This allows the childs to access its corresponding remoted parameters (unique per child)
     int nocmerged;
     socklen_t peer_size;
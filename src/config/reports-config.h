@@ -35,6 +35,8 @@ typedef struct _monitor_config {
     int keep_log_days;
     unsigned long size_rotate;
     int daily_rotations;
+    unsigned long compress_rate;
+    int analysisd_instances;    ///< Analysisd instances writing their own alerts and archives
 
     char *smtpserver;
     char *emailfrom;
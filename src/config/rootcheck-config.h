@@ -38,6 +38,7 @@ typedef struct _rkconfig {
     int disabled;
     short skip_nfs;
     int tsleep;
+    int skip_unchanged; /* Don't read again the files whose metadata didn't change */
 
     int time;
     int queue;
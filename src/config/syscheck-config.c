@@ -67,6 +67,7 @@ int initialize_syscheck_configuration(syscheck_config *syscheck) {
     syscheck->rootcheck                       = 0;
     syscheck->disabled                        = SK_CONF_UNPARSED;
     syscheck->database_store                  = FIM_DB_DISK;
+    syscheck->db_memory_limit                 = 64;
     syscheck->skip_fs.nfs                     = 1;
     syscheck->skip_fs.dev                     = 1;
     syscheck->skip_fs.sys                     = 1;
@@ -122,12 +123,15 @@ int initialize_syscheck_configuration(syscheck_config *syscheck) {
     syscheck->sync_queue_size                 = 16384;
     syscheck->max_eps                         = 100;
     syscheck->max_files_per_second            = 0;
+    syscheck->skip_unchanged_hash             = false;
+    syscheck->hash_verify_scans               = 7;
     syscheck->allow_remote_prefilter_cmd      = false;
     syscheck->disk_quota_enabled              = true;
     syscheck->disk_quota_limit                = 1024 * 1024; // 1 GB
     syscheck->file_size_enabled               = true;
     syscheck->file_size_limit                 = 50 * 1024;   // 50 MB
     syscheck->diff_folder_size                = 0;
+    syscheck->diff_size_reconcile             = 1;
     syscheck->comp_estimation_perc            = 0.9;         // 90%
     syscheck->disk_quota_full_msg             = true;
     syscheck->audit_key                       = NULL;
@@ -1630,6 +1634,8 @@ int Read_Syscheck(const OS_XML *xml, XML_NODE node, void *configp, __attribute__
     const char *xml_restart_audit = "restart_audit";
     const char *xml_windows_audit_interval = "windows_audit_interval";
     const char *xml_max_files_per_second = "max_files_per_second";
+    const char *xml_skip_unchanged_hash = "skip_unchanged_hash";
+    const char *xml_hash_verify_scans = "hash_verify_scans";
 #ifdef WIN32
     const char *xml_arch = "arch";
     const char *xml_32bit = "32bit";
@@ -1705,7 +1711,7 @@ int Read_Syscheck(const OS_XML *xml, XML_NODE node, void *configp, __attribute__
 #endif
         }
 
-        /*  Store database in memory or in disk.
+        /*  Store database in memory, in disk or in disk with a memory cache.
         *   By default disk.
         */
         else if (strcmp(node[i]->element, xml_database) == 0) {
@@ -1715,6 +1721,9 @@ int Read_Syscheck(const OS_XML *xml, XML_NODE node, void *configp, __attribute__
             else if (strcmp(node[i]->content, "disk") == 0){
                 syscheck->database_store = FIM_DB_DISK;
             }
+            else if (strcmp(node[i]->content, "hybrid") == 0){
+                syscheck->database_store = FIM_DB_HYBRID;
+            }
         }
 
         /* Get frequency */
@@ -2160,6 +2169,24 @@ int Read_Syscheck(const OS_XML *xml, XML_NODE node, void *configp, __attribute__
             }
             syscheck->max_files_per_second = atoi(node[i]->content);
 
+        }
+        else if (strcmp(node[i]->element, xml_skip_unchanged_hash) == 0) {
+            if (strcmp(node[i]->content, "yes") == 0) {
+                syscheck->skip_unchanged_hash = true;
+            } else if (strcmp(node[i]->content, "no") == 0) {
+                syscheck->skip_unchanged_hash = false;
+            } else {
+                merror(XML_VALUEERR, node[i]->element, node[i]->content);
+                return (OS_INVALID);
+            }
+        }
+        else if (strcmp(node[i]->element, xml_hash_verify_scans) == 0) {
+            if (!OS_StrIsNum(node[i]->content) || atoi(node[i]->content) < 1) {
+                merror(XML_VALUEERR, node[i]->element, node[i]->content);
+                return (OS_INVALID);
+            }
+            syscheck->hash_verify_scans = atoi(node[i]->content);
+
         } else {
             mwarn(XML_INVELEM, node[i]->element);
         }
@@ -2419,7 +2446,9 @@ void Free_Syscheck(syscheck_config * config) {
                 OSHash_Free(config->realtime->dirtb);
             }
 #ifdef WIN32
-            CloseEventLog(config->realtime->evt);
+            if (config->realtime->iocp) {
+                CloseHandle(config->realtime->iocp);
+            }
 #endif
             free(config->realtime);
         }
@@ -134,6 +134,7 @@ typedef enum fdb_stmt {
 
 #define FIM_DB_MEMORY       1
 #define FIM_DB_DISK         0
+#define FIM_DB_HYBRID       2
 
 //Max allowed value for recursion
 #define MAX_DEPTH_ALLOWED 320
@@ -153,6 +154,7 @@ typedef struct whodata_dir_status whodata_dir_status;
 #ifndef WIN32
 typedef struct _rtfim {
     unsigned int queue_overflow:1;
+    unsigned int fanotify:1;                    /* fd is a fanotify descriptor with filesystem marks */
     OSHash *dirtb;
     int fd;
 } rtfim;
@@ -162,7 +164,7 @@ typedef struct _rtfim {
 typedef struct _rtfim {
     unsigned int queue_overflow:1;
     OSHash *dirtb;
-    HANDLE evt;
+    HANDLE iocp;                                /* Completion port shared by every directory */
 } rtfim;
 
 typedef struct _win32rtfim {
@@ -170,7 +172,8 @@ typedef struct _win32rtfim {
     OVERLAPPED overlap;
 
     char *dir;
-    TCHAR buffer[65536];
+    char *buffer;                               /* Change records, grown on overflow */
+    DWORD buffer_size;
     unsigned int watch_status;
 } win32rtfim;
 
@@ -235,6 +238,7 @@ typedef struct whodata_evt {
     unsigned int process_id;
 #else
     unsigned __int64 process_id;
+    time_t last_event; // Last event of the handle, to expire the ones that are never closed
     unsigned int mask;
     char scan_directory;
 #endif
@@ -369,6 +373,8 @@ typedef struct _config {
 
     fs_set skip_fs;
     int rt_delay;                                      /* Delay before real-time dispatching (ms) */
+    int rt_coalesce_window;                            /* Quiet time before checking a path with real-time events (ms) */
+    int rt_fanotify;                                   /* Use fanotify filesystem marks instead of inotify watches */
 
     int time;                                          /* frequency (secs) for syscheck to run */
     int queue;                                         /* file descriptor of socket to write to queue */
@@ -395,10 +401,15 @@ typedef struct _config {
     int file_size_enabled;                             /* Enable diff file size limit */
     int file_size_limit;                               /* Avoids generating a backup from a file bigger than this limit (in KB) */
     float diff_folder_size;                            /* Save size of queue/diff/local folder */
+    unsigned int diff_size_reconcile;                  /* Scans between two walks of the diff folder to reconcile its size */
     float comp_estimation_perc;                        /* Estimation of the percentage of compression each file will have */
     uint16_t disk_quota_full_msg;                      /* Specify if the full disk_quota message can be written (Once per scan) */
+    unsigned int diff_chunking;                        /* Store report_changes versions as deduplicated chunks (not on Windows) */
 
     unsigned int max_files_per_second;                 /* Max number of files read per second. */
+    unsigned int skip_unchanged_hash;                  /* Reuse the stored hashes of files whose metadata did not change */
+    unsigned int hash_verify_scans;                    /* Scans between two full hash verifications of an unchanged file */
+    unsigned int scan_threads;                         /* Number of threads walking and hashing files in scheduled scans */
 
     char **nodiff;                                     /* list of files/dirs to never output diff */
     OSMatch **nodiff_regex;                            /* regex of files/dirs to never output diff */
@@ -426,6 +437,7 @@ typedef struct _config {
     registry_ignore_regex *registry_nodiff_regex;      /* regex of values/registries to never output diff */
 #endif
     int max_audit_entries;                             /* Maximum entries for Audit (whodata) */
+    int audit_process_cache;                           /* Maximum parent processes cached by whodata */
     char **audit_key;                                  /* Listen audit keys */
     int audit_healthcheck;                             /* Startup health-check for whodata */
     int sym_checker_interval;
@@ -439,6 +451,7 @@ typedef struct _config {
     rtfim *realtime;
     fdb_t *database;
     int database_store;
+    unsigned int db_memory_limit;                      /* Memory used to cache the hybrid database (in MB) */
 
     char **prefilter_cmd;
     int process_priority; // Adjusts the priority of the process (or threads in Windows)
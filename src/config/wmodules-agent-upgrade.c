@@ -21,6 +21,7 @@ static const char *XML_CA_STORE = "ca_store";
 #else
 static const char *XML_WPK_REPOSITORY = "wpk_repository";
 static const char *XML_CHUNK_SIZE = "chunk_size";
+static const char *XML_WINDOW_SIZE = "window_size";
 static const char *XML_MAX_THREADS = "max_threads";
 #endif
 
@@ -50,6 +51,7 @@ int wm_agent_upgrade_read(__attribute__((unused)) const OS_XML *xml, xml_node **
         #else
         data->manager_config.max_threads = WM_UPGRADE_MAX_THREADS;
         data->manager_config.chunk_size = WM_UPGRADE_CHUNK_SIZE;
+        data->manager_config.window_size = WM_UPGRADE_WINDOW_SIZE;
         data->manager_config.wpk_repository = NULL;
         #endif
         module->data = data;
@@ -158,6 +160,19 @@ int wm_agent_upgrade_read(__attribute__((unused)) const OS_XML *xml, xml_node **
 
             data->manager_config.chunk_size = chunk;
 
+        } else if (!strcmp(nodes[i]->element, XML_WINDOW_SIZE)) {
+            if (!OS_StrIsNum(nodes[i]->content)) {
+                merror("Invalid content for tag '%s' at module '%s'.", XML_WINDOW_SIZE, WM_AGENT_UPGRADE_CONTEXT.name);
+                return (OS_INVALID);
+            }
+            int window;
+            if (window = atoi(nodes[i]->content), window < 1 || window > 64) {
+                merror("Invalid content for tag '%s' at module '%s'.", XML_WINDOW_SIZE, WM_AGENT_UPGRADE_CONTEXT.name);
+                return (OS_INVALID);
+            }
+
+            data->manager_config.window_size = window;
+
         } else if (!strcmp(nodes[i]->element, XML_MAX_THREADS)) {
             if (!OS_StrIsNum(nodes[i]->content)) {
                 merror("Invalid content for tag '%s' at module '%s'.", XML_MAX_THREADS, WM_AGENT_UPGRADE_CONTEXT.name);
@@ -13,6 +13,7 @@
 #include "wazuh_modules/wmodules.h"
 
 static const char *XML_INTERVAL = "interval";
+static const char *XML_CHANGES_INTERVAL = "changes_interval";
 static const char *XML_SCAN_ON_START = "scan_on_start";
 static const char *XML_DISABLED = "disabled";
 static const char *XML_NETWORK = "network";
@@ -27,8 +28,12 @@ static const char *XML_SYNC = "synchronization";
 static void parse_synchronization_section(wm_sys_t * syscollector, XML_NODE node) {
     const char *XML_DB_SYNC_MAX_EPS = "max_eps";
     const int XML_DB_SYNC_MAX_EPS_SIZE = 7;
+    const char *XML_DB_SYNC_MAX_BPS = "max_bps";
+    const int XML_DB_SYNC_MAX_BPS_SIZE = 7;
     const int MIN_SYNC_MESSAGES_THROUGHPUT = 0; // It means disabled
     const int MAX_SYNC_MESSAGES_THROUGHPUT = 1000000;
+    const long MIN_SYNC_BYTES_THROUGHPUT = 0; // It means no limit
+    const long MAX_SYNC_BYTES_THROUGHPUT = 1000000000;
     for (int i = 0; node[i]; ++i) {
         if (strncmp(node[i]->element, XML_DB_SYNC_MAX_EPS, XML_DB_SYNC_MAX_EPS_SIZE) == 0) {
             char * end;
@@ -39,6 +44,15 @@ static void parse_synchronization_section(wm_sys_t * syscollector, XML_NODE node
             } else {
                 syscollector->sync.sync_max_eps = value;
             }
+        } else if (strncmp(node[i]->element, XML_DB_SYNC_MAX_BPS, XML_DB_SYNC_MAX_BPS_SIZE) == 0) {
+            char * end;
+            const long value = strtol(node[i]->content, &end, 10);
+
+            if (value < MIN_SYNC_BYTES_THROUGHPUT || value > MAX_SYNC_BYTES_THROUGHPUT || *end) {
+                mwarn(XML_VALUEERR, node[i]->element, node[i]->content);
+            } else {
+                syscollector->sync.sync_max_bps = value;
+            }
         } else {
             mwarn(XML_INVELEM, node[i]->element);
         }
@@ -55,6 +69,7 @@ int wm_syscollector_read(const OS_XML *xml, XML_NODE node, wmodule *module) {
         // System provider config values
         syscollector->flags.enabled = 1;
         syscollector->interval = WM_SYSCOLLECTOR_DEFAULT_INTERVAL;
+        syscollector->changes_interval = WM_SYSCOLLECTOR_DEFAULT_CHANGES_INTERVAL;
         syscollector->flags.scan_on_start = 1;
         syscollector->flags.netinfo = 1;
         syscollector->flags.osinfo = 1;
@@ -69,6 +84,7 @@ int wm_syscollector_read(const OS_XML *xml, XML_NODE node, wmodule *module) {
 
         // Database synchronization config values
         syscollector->sync.sync_max_eps = 10;
+        syscollector->sync.sync_max_bps = 0;
 
         module->context = &WM_SYS_CONTEXT;
         module->tag = strdup(module->context->name);
@@ -112,6 +128,29 @@ int wm_syscollector_read(const OS_XML *xml, XML_NODE node, wmodule *module) {
                 merror("Invalid interval at module '%s'", WM_SYS_CONTEXT.name);
                 return OS_INVALID;
             }
+        } else if (!strcmp(node[i]->element, XML_CHANGES_INTERVAL)) {
+            char *endptr;
+            syscollector->changes_interval = strtoul(node[i]->content, &endptr, 0);
+
+            if (syscollector->changes_interval == UINT_MAX) {
+                merror("Invalid changes interval at module '%s'", WM_SYS_CONTEXT.name);
+                return OS_INVALID;
+            }
+
+            switch (*endptr) {
+            case 'h':
+                syscollector->changes_interval *= W_HOUR_SECONDS;
+                break;
+            case 'm':
+                syscollector->changes_interval *= W_MINUTE_SECONDS;
+                break;
+            case 's':
+            case '\0':
+                break;
+            default:
+                merror("Invalid changes interval at module '%s'", WM_SYS_CONTEXT.name);
+                return OS_INVALID;
+            }
         } else if (!strcmp(node[i]->element, XML_SCAN_ON_START)) {
             if (!strcmp(node[i]->content, "yes"))
                 syscollector->flags.scan_on_start = 1;
@@ -214,7 +253,7 @@ int wm_syscollector_read(const OS_XML *xml, XML_NODE node, wmodule *module) {
             }
         } else if (!strcmp(node[i]->element, XML_SYNC)) {
             // Synchronization section - Let's get the children node and iterate
-            // the values (at the moment there is only one: max_eps)
+            // the values (max_eps and max_bps)
             xml_node **children = OS_GetElementsbyNode(xml, node[i]);
             if (children) {
                 parse_synchronization_section(syscollector, children);
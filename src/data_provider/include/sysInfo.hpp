@@ -44,6 +44,7 @@ public:
     nlohmann::json ports();
     void packages(std::function<void(nlohmann::json &)>);
     void processes(std::function<void(nlohmann::json &)>);
+    nlohmann::json packagesSources();
     nlohmann::json hotfixes();
 private:
     virtual std::string getSerialNumber() const;
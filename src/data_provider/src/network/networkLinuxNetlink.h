@@ -0,0 +1,356 @@
+/*
+ * Wazuh SYSINFO
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _NETWORK_LINUX_NETLINK_H
+#define _NETWORK_LINUX_NETLINK_H
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "inetworkInterface.h"
+#include "networkHelper.h"
+#include "sharedDefs.h"
+
+#ifndef NLM_F_DUMP_INTR
+#define NLM_F_DUMP_INTR 0x10    /* Dump was inconsistent due to sequence change */
+#endif
+
+// RFC 2863 operational states, as sysfs prints them in operstate.
+static const std::map<int, std::string> NETWORK_OPERATIONAL_STATE =
+{
+    { 0,    "unknown"           },
+    { 1,    "notpresent"        },
+    { 2,    "down"              },
+    { 3,    "lowerlayerdown"    },
+    { 4,    "testing"           },
+    { 5,    "dormant"           },
+    { 6,    "up"                },
+};
+
+struct NetlinkLink
+{
+    std::string name;
+    int type { -1 };                 /* ARPHRD_* code */
+    std::string state { UNKNOWN_VALUE };
+    std::string MAC;
+    uint32_t mtu { 0 };
+    LinkStats stats {};
+    std::string gateway { UNKNOWN_VALUE };
+    std::string metrics;
+};
+
+/**
+ * @brief Links and IPv4 routes of the host, read with two rtnetlink dumps.
+ *
+ * It replaces the sysfs and /proc/net reads done for every interface address, the whole
+ * snapshot takes a few syscalls whatever the number of interfaces.
+ */
+class NetworkLinuxNetlink final
+{
+        std::map<int, NetlinkLink> m_links;
+        std::map<std::string, int> m_indexes;
+
+        static std::string formatMAC(const unsigned char* address, const size_t size)
+        {
+            std::string retVal;
+            char octet[4] {};
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                snprintf(octet, sizeof(octet), i ? ":%02x" : "%02x", address[i]);
+                retVal += octet;
+            }
+
+            return retVal;
+        }
+
+        template <class T>
+        static void copyStats(const T& kernelStats, LinkStats& stats)
+        {
+            // Same counters as /proc/net/dev, which adds the missed packets to the dropped ones.
+            stats.rxPackets = static_cast<unsigned int>(kernelStats.rx_packets);
+            stats.txPackets = static_cast<unsigned int>(kernelStats.tx_packets);
+            stats.rxBytes = static_cast<unsigned int>(kernelStats.rx_bytes);
+            stats.txBytes = static_cast<unsigned int>(kernelStats.tx_bytes);
+            stats.rxErrors = static_cast<unsigned int>(kernelStats.rx_errors);
+            stats.txErrors = static_cast<unsigned int>(kernelStats.tx_errors);
+            stats.rxDropped = static_cast<unsigned int>(kernelStats.rx_dropped + kernelStats.rx_missed_errors);
+            stats.txDropped = static_cast<unsigned int>(kernelStats.tx_dropped);
+        }
+
+        // Sends a dump request and passes every answer to the callback, the dump only succeeds if
+        // the kernel completes it without changes in the middle.
+        static bool request(const int fd,
+                            const uint16_t type,
+                            const void* payload,
+                            const size_t size,
+                            const uint32_t sequence,
+                            const std::function<void(const nlmsghdr*)>& callback)
+        {
+            auto ret { false };
+            std::vector<char> message(NLMSG_SPACE(size));
+            const auto header { reinterpret_cast<nlmsghdr*>(message.data()) };
+
+            header->nlmsg_len = NLMSG_LENGTH(size);
+            header->nlmsg_type = type;
+            header->nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+            header->nlmsg_seq = sequence;
+            std::memcpy(NLMSG_DATA(header), payload, size);
+
+            sockaddr_nl kernel {};
+            kernel.nl_family = AF_NETLINK;
+
+            if (sendto(fd, message.data(), header->nlmsg_len, 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) >= 0)
+            {
+                // nlmsghdr aligned buffer, large enough for the link messages with all their attributes.
+                std::vector<nlmsghdr> buffer(65536 / sizeof(nlmsghdr));
+                const auto bufferSize { buffer.size() * sizeof(nlmsghdr) };
+                auto done { false };
+
+                while (!done)
+                {
+                    auto length { recv(fd, buffer.data(), bufferSize, MSG_TRUNC) };
+
+                    if (length < 0 && EINTR == errno)
+                    {
+                        continue;
+                    }
+
+                    if (length <= 0 || static_cast<size_t>(length) > bufferSize)
+                    {
+                        break;
+                    }
+
+                    for (auto answer { buffer.data() }; !done && NLMSG_OK(answer, length); answer = NLMSG_NEXT(answer, length))
+                    {
+                        if (answer->nlmsg_seq != sequence)
+                        {
+                            continue;
+                        }
+
+                        if (answer->nlmsg_flags & NLM_F_DUMP_INTR || NLMSG_ERROR == answer->nlmsg_type)
+                        {
+                            done = true;
+                        }
+                        else if (NLMSG_DONE == answer->nlmsg_type)
+                        {
+                            ret = true;
+                            done = true;
+                        }
+                        else
+                        {
+                            callback(answer);
+                        }
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+    public:
+        NetworkLinuxNetlink() = default;
+        // LCOV_EXCL_START
+        ~NetworkLinuxNetlink() = default;
+        // LCOV_EXCL_STOP
+
+        /**
+         * @brief Reads the links, and then the routes of the main table.
+         *
+         * @return false if a dump couldn't be completed, the caller must then read the
+         * interface data from sysfs and /proc/net.
+         */
+        bool dump()
+        {
+            auto ret { false };
+            const auto fd { socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE) };
+
+            if (fd >= 0)
+            {
+                ifinfomsg link {};
+                link.ifi_family = AF_UNSPEC;
+
+                rtmsg route {};
+                route.rtm_family = AF_INET;
+
+                ret = request(fd, RTM_GETLINK, &link, sizeof(link), 1, [this](const nlmsghdr * header)
+                {
+                    addLink(header);
+                }) &&
+                request(fd, RTM_GETROUTE, &route, sizeof(route), 2, [this](const nlmsghdr * header)
+                {
+                    addRoute(header);
+                });
+
+                close(fd);
+            }
+
+            return ret;
+        }
+
+        void addLink(const nlmsghdr* header)
+        {
+            if (RTM_NEWLINK == header->nlmsg_type && header->nlmsg_len >= NLMSG_LENGTH(sizeof(ifinfomsg)))
+            {
+                const auto info { static_cast<const ifinfomsg*>(NLMSG_DATA(header)) };
+                int length { static_cast<int>(IFLA_PAYLOAD(header)) };
+                NetlinkLink link {};
+                auto hasStats64 { false };
+
+                link.type = info->ifi_type;
+
+                for (auto attribute { IFLA_RTA(info) }; RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length))
+                {
+                    const auto data { static_cast<const unsigned char*>(RTA_DATA(attribute)) };
+                    const auto size { RTA_PAYLOAD(attribute) };
+
+                    switch (attribute->rta_type)
+                    {
+                        case IFLA_IFNAME:
+                            link.name.assign(reinterpret_cast<const char*>(data), strnlen(reinterpret_cast<const char*>(data), size));
+                            break;
+
+                        case IFLA_MTU:
+                            if (size >= sizeof(uint32_t))
+                            {
+                                std::memcpy(&link.mtu, data, sizeof(uint32_t));
+                            }
+
+                            break;
+
+                        case IFLA_ADDRESS:
+                            link.MAC = formatMAC(data, size);
+                            break;
+
+                        case IFLA_OPERSTATE:
+                            if (size >= sizeof(uint8_t))
+                            {
+                                const auto it { NETWORK_OPERATIONAL_STATE.find(*data) };
+                                link.state = NETWORK_OPERATIONAL_STATE.end() != it ? it->second : UNKNOWN_VALUE;
+                            }
+
+                            break;
+
+                        case IFLA_STATS64:
+                            if (size >= sizeof(rtnl_link_stats64))
+                            {
+                                rtnl_link_stats64 stats {};
+                                std::memcpy(&stats, data, sizeof(stats));
+                                copyStats(stats, link.stats);
+                                hasStats64 = true;
+                            }
+
+                            break;
+
+                        case IFLA_STATS:
+                            if (!hasStats64 && size >= sizeof(rtnl_link_stats))
+                            {
+                                rtnl_link_stats stats {};
+                                std::memcpy(&stats, data, sizeof(stats));
+                                copyStats(stats, link.stats);
+                            }
+
+                            break;
+
+                        default:
+                            break;
+                    }
+                }
+
+                if (!link.name.empty())
+                {
+                    m_indexes[link.name] = info->ifi_index;
+                    m_links[info->ifi_index] = std::move(link);
+                }
+            }
+        }
+
+        // Same choice as the /proc/net/route parser: the first route of the interface with a
+        // gateway, or the metric of its last route if none has one.
+        void addRoute(const nlmsghdr* header)
+        {
+            const auto route { static_cast<const rtmsg*>(NLMSG_DATA(header)) };
+
+            if (RTM_NEWROUTE == header->nlmsg_type &&
+                    header->nlmsg_len >= NLMSG_LENGTH(sizeof(rtmsg)) &&
+                    AF_INET == route->rtm_family &&
+                    !(route->rtm_flags & RTM_F_CLONED))
+            {
+                int length { static_cast<int>(RTM_PAYLOAD(header)) };
+                uint32_t table { route->rtm_table };
+                uint32_t priority { 0 };
+                int oif { 0 };
+                in_addr gateway {};
+
+                for (auto attribute { RTM_RTA(route) }; RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length))
+                {
+                    const auto data { RTA_DATA(attribute) };
+                    const auto size { RTA_PAYLOAD(attribute) };
+
+                    if (RTA_TABLE == attribute->rta_type && size >= sizeof(table))
+                    {
+                        std::memcpy(&table, data, sizeof(table));
+                    }
+                    else if (RTA_OIF == attribute->rta_type && size >= sizeof(oif))
+                    {
+                        std::memcpy(&oif, data, sizeof(oif));
+                    }
+                    else if (RTA_PRIORITY == attribute->rta_type && size >= sizeof(priority))
+                    {
+                        std::memcpy(&priority, data, sizeof(priority));
+                    }
+                    else if (RTA_GATEWAY == attribute->rta_type && size >= sizeof(gateway))
+                    {
+                        std::memcpy(&gateway, data, sizeof(gateway));
+                    }
+                }
+
+                const auto it { m_links.find(oif) };
+
+                if (RT_TABLE_MAIN == table && m_links.end() != it && UNKNOWN_VALUE == it->second.gateway)
+                {
+                    it->second.metrics = std::to_string(priority);
+
+                    if (gateway.s_addr)
+                    {
+                        it->second.gateway = Utils::NetworkHelper::IAddressToBinary(AF_INET, &gateway);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Data of a link by name.
+         *
+         * @return nullptr if the link wasn't in the dump.
+         */
+        const NetlinkLink* link(const std::string& name) const
+        {
+            const NetlinkLink* retVal { nullptr };
+            const auto it { m_indexes.find(name) };
+
+            if (m_indexes.end() != it)
+            {
+                retVal = &m_links.at(it->second);
+            }
+
+            return retVal;
+        }
+};
+
+#endif // _NETWORK_LINUX_NETLINK_H
@@ -16,6 +16,7 @@
 #include <net/if_arp.h>
 #include <sys/socket.h>
 #include "inetworkWrapper.h"
+#include "networkLinuxNetlink.h"
 #include "networkHelper.h"
 #include "filesystemHelper.h"
 #include "stringHelper.h"
@@ -194,6 +195,8 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
         ifaddrs* m_interfaceAddress;
         std::string m_gateway;
         std::string m_metrics;
+        std::shared_ptr<const NetworkLinuxNetlink> m_netlink;
+        const NetlinkLink* m_link;
 
         static std::string getNameInfo(const sockaddr* inputData, const socklen_t socketLen)
         {
@@ -253,14 +256,26 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
         }
 
     public:
-        explicit NetworkLinuxInterface(ifaddrs* addrs)
+        /**
+         * @param addrs Interface address.
+         * @param netlink Links and routes of the scan. The links missing from it, or all of
+         * them if it's nullptr, are read from sysfs and /proc/net.
+         */
+        explicit NetworkLinuxInterface(ifaddrs* addrs, const std::shared_ptr<const NetworkLinuxNetlink>& netlink = nullptr)
             : m_interfaceAddress{ addrs }
             , m_gateway{UNKNOWN_VALUE}
+            , m_netlink{ netlink }
+            , m_link{ nullptr }
         {
             if (!addrs)
             {
                 throw std::runtime_error { "Nullptr instances of network interface" };
             }
+            else if (m_netlink && (m_link = m_netlink->link(this->name())))
+            {
+                m_gateway = m_link->gateway;
+                m_metrics = m_link->metrics;
+            }
             else
             {
                 auto fileData { Utils::getFileContent(std::string(WM_SYS_NET_DIR) + "route") };
@@ -449,11 +464,19 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
         uint32_t mtu() const override
         {
             uint32_t retVal { 0 };
-            const auto mtuFileContent { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/mtu") };
 
-            if (!mtuFileContent.empty())
+            if (m_link)
+            {
+                retVal = m_link->mtu;
+            }
+            else
             {
-                retVal =  std::stol(Utils::splitIndex(mtuFileContent, '\n', 0));
+                const auto mtuFileContent { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/mtu") };
+
+                if (!mtuFileContent.empty())
+                {
+                    retVal =  std::stol(Utils::splitIndex(mtuFileContent, '\n', 0));
+                }
             }
 
             return retVal;
@@ -463,44 +486,51 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
         {
             LinkStats retVal {};
 
-            try
+            if (m_link)
             {
-                const auto devData { Utils::getFileContent(std::string(WM_SYS_NET_DIR) + "dev") };
-
-                if (!devData.empty())
+                retVal = m_link->stats;
+            }
+            else
+            {
+                try
                 {
-                    auto lines { Utils::split(devData, '\n') };
-                    lines.erase(lines.begin());
-                    lines.erase(lines.begin());
+                    const auto devData { Utils::getFileContent(std::string(WM_SYS_NET_DIR) + "dev") };
 
-                    for (auto& line : lines)
+                    if (!devData.empty())
                     {
-                        line = Utils::trim(line);
-                        Utils::replaceAll(line, "\t", " ");
-                        Utils::replaceAll(line, "  ", " ");
-                        Utils::replaceAll(line, ": ", " ");
-                        const auto fields { Utils::split(line, ' ') };
+                        auto lines { Utils::split(devData, '\n') };
+                        lines.erase(lines.begin());
+                        lines.erase(lines.begin());
 
-                        if (NetDevFileFields::FieldsQuantity == fields.size())
+                        for (auto& line : lines)
                         {
-                            if (fields.at(NetDevFileFields::Iface).compare(this->name()) == 0)
+                            line = Utils::trim(line);
+                            Utils::replaceAll(line, "\t", " ");
+                            Utils::replaceAll(line, "  ", " ");
+                            Utils::replaceAll(line, ": ", " ");
+                            const auto fields { Utils::split(line, ' ') };
+
+                            if (NetDevFileFields::FieldsQuantity == fields.size())
                             {
-                                retVal.rxBytes = std::stoul(fields.at(NetDevFileFields::RxBytes));
-                                retVal.txBytes = std::stoul(fields.at(NetDevFileFields::TxBytes));
-                                retVal.rxPackets = std::stoul(fields.at(NetDevFileFields::RxPackets));
-                                retVal.txPackets = std::stoul(fields.at(NetDevFileFields::TxPackets));
-                                retVal.rxErrors = std::stoul(fields.at(NetDevFileFields::RxErrors));
-                                retVal.txErrors = std::stoul(fields.at(NetDevFileFields::TxErrors));
-                                retVal.rxDropped = std::stoul(fields.at(NetDevFileFields::RxDropped));
-                                retVal.txDropped = std::stoul(fields.at(NetDevFileFields::TxDropped));
-                                break;
+                                if (fields.at(NetDevFileFields::Iface).compare(this->name()) == 0)
+                                {
+                                    retVal.rxBytes = std::stoul(fields.at(NetDevFileFields::RxBytes));
+                                    retVal.txBytes = std::stoul(fields.at(NetDevFileFields::TxBytes));
+                                    retVal.rxPackets = std::stoul(fields.at(NetDevFileFields::RxPackets));
+                                    retVal.txPackets = std::stoul(fields.at(NetDevFileFields::TxPackets));
+                                    retVal.rxErrors = std::stoul(fields.at(NetDevFileFields::RxErrors));
+                                    retVal.txErrors = std::stoul(fields.at(NetDevFileFields::TxErrors));
+                                    retVal.rxDropped = std::stoul(fields.at(NetDevFileFields::RxDropped));
+                                    retVal.txDropped = std::stoul(fields.at(NetDevFileFields::TxDropped));
+                                    break;
+                                }
                             }
                         }
                     }
                 }
-            }
-            catch (...)
-            {
+                catch (...)
+                {
+                }
             }
 
             return retVal;
@@ -508,12 +538,20 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
 
         std::string type() const override
         {
-            const auto networkTypeCode { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/type") };
             std::string type { UNKNOWN_VALUE };
 
-            if (!networkTypeCode.empty())
+            if (m_link)
             {
-                type = Utils::NetworkHelper::getNetworkTypeStringCode(std::stoi(networkTypeCode), NETWORK_INTERFACE_TYPE);
+                type = Utils::NetworkHelper::getNetworkTypeStringCode(m_link->type, NETWORK_INTERFACE_TYPE);
+            }
+            else
+            {
+                const auto networkTypeCode { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/type") };
+
+                if (!networkTypeCode.empty())
+                {
+                    type = Utils::NetworkHelper::getNetworkTypeStringCode(std::stoi(networkTypeCode), NETWORK_INTERFACE_TYPE);
+                }
             }
 
             return type;
@@ -521,13 +559,20 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
 
         std::string state() const override
         {
-            const std::string operationalState { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/operstate") };
-
             std::string state { UNKNOWN_VALUE };
 
-            if (!operationalState.empty())
+            if (m_link)
+            {
+                state = m_link->state;
+            }
+            else
             {
-                state = Utils::splitIndex(operationalState, '\n', 0);
+                const std::string operationalState { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/operstate") };
+
+                if (!operationalState.empty())
+                {
+                    state = Utils::splitIndex(operationalState, '\n', 0);
+                }
             }
 
             return state;
@@ -535,13 +580,20 @@ class NetworkLinuxInterface final : public INetworkInterfaceWrapper
 
         std::string MAC() const override
         {
-            const std::string macContent { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/address")};
-
             std::string mac { UNKNOWN_VALUE };
 
-            if (!macContent.empty())
+            if (m_link)
             {
-                mac = Utils::splitIndex(macContent, '\n', 0);
+                mac = m_link->MAC;
+            }
+            else
+            {
+                const std::string macContent { Utils::getFileContent(std::string(WM_SYS_IFDATA_DIR) + this->name() + "/address")};
+
+                if (!macContent.empty())
+                {
+                    mac = Utils::splitIndex(macContent, '\n', 0);
+                }
             }
 
             return mac;
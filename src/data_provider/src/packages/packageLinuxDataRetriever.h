@@ -17,6 +17,7 @@
 #include "sharedDefs.h"
 #include "filesystemHelper.h"
 #include "utilsWrapperLinux.hpp"
+#include "packageSourcesHelper.h"
 
 /**
  * @brief Fills a JSON object with all available pacman-related information
@@ -27,9 +28,10 @@ void getPacmanInfo(const std::string& libPath, std::function<void(nlohmann::json
 
 /**
  * @brief Fills a JSON object with all available rpm-related information
+ * @param libPath  Path to rpm's database directory
  * @param callback Callback to be called for every single element being found
  */
-void getRpmInfo(std::function<void(nlohmann::json&)> callback);
+void getRpmInfo(const std::string& libPath, std::function<void(nlohmann::json&)> callback);
 
 /**
  * @brief Fills a JSON object with all available rpm-related information for legacy Linux.
@@ -73,25 +75,41 @@ class FactoryPackagesCreator<LinuxType::STANDARD> final
     public:
         static void getPackages(std::function<void(nlohmann::json&)> callback)
         {
+            PackageSources sources;
+
             if (Utils::existsDir(DPKG_PATH))
             {
-                getDpkgInfo(DPKG_STATUS_PATH, callback);
+                sources.add("dpkg", [](PackagesCallback sourceCallback)
+                {
+                    getDpkgInfo(DPKG_STATUS_PATH, sourceCallback);
+                });
             }
 
             if (Utils::existsDir(PACMAN_PATH))
             {
-                getPacmanInfo(PACMAN_PATH, callback);
+                sources.add("pacman", [](PackagesCallback sourceCallback)
+                {
+                    getPacmanInfo(PACMAN_PATH, sourceCallback);
+                });
             }
 
             if (Utils::existsDir(RPM_PATH))
             {
-                getRpmInfo(callback);
+                sources.add("rpm", [](PackagesCallback sourceCallback)
+                {
+                    getRpmInfo(RPM_PATH, sourceCallback);
+                });
             }
 
             if (Utils::existsDir(APK_PATH))
             {
-                getApkInfo(APK_DB_PATH, callback);
+                sources.add("apk", [](PackagesCallback sourceCallback)
+                {
+                    getApkInfo(APK_DB_PATH, sourceCallback);
+                });
             }
+
+            sources.run(callback);
         }
 };
 
@@ -102,10 +120,17 @@ class FactoryPackagesCreator<LinuxType::LEGACY> final
     public:
         static void getPackages(std::function<void(nlohmann::json&)> callback)
         {
+            PackageSources sources;
+
             if (Utils::existsDir(RPM_PATH))
             {
-                getRpmInfoLegacy(callback);
+                sources.add("rpm", [](PackagesCallback sourceCallback)
+                {
+                    getRpmInfoLegacy(sourceCallback);
+                });
             }
+
+            sources.run(callback);
         }
 };
 
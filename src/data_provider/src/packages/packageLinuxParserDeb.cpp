@@ -11,40 +11,299 @@
 
 #include "sharedDefs.h"
 #include "packageLinuxParserHelper.h"
-#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <mutex>
 
-void getDpkgInfo(const std::string& fileName, std::function<void(nlohmann::json&)> callback)
+namespace
 {
-    std::fstream file{fileName, std::ios_base::in};
+    constexpr auto DPKG_INSTALLED_STATUS {"install ok installed"};
+
+    // Fields of the status file that are reported for each package.
+    enum DpkgField
+    {
+        DPKG_PACKAGE,
+        DPKG_STATUS,
+        DPKG_PRIORITY,
+        DPKG_SECTION,
+        DPKG_INSTALLED_SIZE,
+        DPKG_MULTIARCH,
+        DPKG_ARCHITECTURE,
+        DPKG_SOURCE,
+        DPKG_VERSION,
+        DPKG_MAINTAINER,
+        DPKG_DESCRIPTION,
+        DPKG_FIELDS_COUNT
+    };
+
+    constexpr const char* DPKG_FIELD_NAMES[DPKG_FIELDS_COUNT]
+    {
+        "Package",
+        "Status",
+        "Priority",
+        "Section",
+        "Installed-Size",
+        "Multi-Arch",
+        "Architecture",
+        "Source",
+        "Version",
+        "Maintainer",
+        "Description"
+    };
+
+    // Range of the mapped file, nothing is copied until a package is known to be installed.
+    struct TextRange
+    {
+        const char* data { nullptr };
+        size_t size { 0 };
+
+        bool equals(const char* str) const
+        {
+            return size == std::strlen(str) && std::memcmp(data, str, size) == 0;
+        }
+
+        std::string str() const
+        {
+            return std::string(data, size);
+        }
+    };
+
+    struct DpkgPackage
+    {
+        std::string name;
+        std::string priority;
+        std::string groups;
+        std::string multiarch;
+        std::string architecture;
+        std::string source;
+        std::string version;
+        std::string vendor;
+        std::string description;
+        int size { 0 };
+    };
+
+    // Identifies a version of the status file, dpkg replaces it on every change.
+    struct DpkgFileStamp
+    {
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        time_t mtime;
+        long mtimeNsec;
+
+        bool operator==(const DpkgFileStamp& other) const
+        {
+            return device == other.device && inode == other.inode && size == other.size &&
+                   mtime == other.mtime && mtimeNsec == other.mtimeNsec;
+        }
+    };
+
+    struct DpkgCache
+    {
+        std::string fileName;
+        DpkgFileStamp stamp {};
+        std::vector<DpkgPackage> packages;
+    };
 
-    if (file.is_open())
+    TextRange trim(const char* begin, const char* end)
     {
-        while (file.good())
+        while (begin < end && (*begin == ' ' || *begin == '\t'))
+        {
+            ++begin;
+        }
+
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
         {
-            std::string line;
-            std::vector<std::string> data;
+            --end;
+        }
+
+        return TextRange{begin, static_cast<size_t>(end - begin)};
+    }
+
+    void storePackage(const TextRange (&fields)[DPKG_FIELDS_COUNT],
+                      const TextRange& synopsis,
+                      std::vector<DpkgPackage>& packages)
+    {
+        if (fields[DPKG_PACKAGE].size == 0 || !fields[DPKG_STATUS].equals(DPKG_INSTALLED_STATUS))
+        {
+            return;
+        }
 
-            do
+        DpkgPackage package;
+        package.name = fields[DPKG_PACKAGE].str();
+        package.priority = fields[DPKG_PRIORITY].str();
+        package.groups = fields[DPKG_SECTION].str();
+        package.multiarch = fields[DPKG_MULTIARCH].str();
+        package.architecture = fields[DPKG_ARCHITECTURE].str();
+        package.source = fields[DPKG_SOURCE].str();
+        package.version = fields[DPKG_VERSION].str();
+        package.vendor = fields[DPKG_MAINTAINER].str();
+        // Only the synopsis, the extended description is in the continuation lines.
+        package.description = synopsis.size ? synopsis.str() : fields[DPKG_DESCRIPTION].str();
+        package.size = static_cast<int>(std::strtol(fields[DPKG_INSTALLED_SIZE].str().c_str(), nullptr, 10));
+        packages.push_back(std::move(package));
+    }
+
+    std::vector<DpkgPackage> parseStatus(const char* data, const size_t size)
+    {
+        std::vector<DpkgPackage> packages;
+        TextRange fields[DPKG_FIELDS_COUNT] {};
+        // Untrimmed synopsis of a multiline description, kept as the line-based parser reported it.
+        TextRange synopsis {};
+        TextRange descriptionLine {};
+        auto lastField { DPKG_FIELDS_COUNT };
+        auto stanzaEmpty { true };
+        const auto end { data + size };
+
+        for (auto line { data }; line < end;)
+        {
+            auto lineEnd { static_cast<const char*>(std::memchr(line, '\n', end - line)) };
+
+            if (!lineEnd)
             {
-                std::getline(file, line);
+                lineEnd = end;
+            }
 
-                if (line.front() == ' ') //additional info
+            if (lineEnd == line || (lineEnd - line == 1 && *line == '\r'))
+            {
+                // End of a package stanza.
+                if (!stanzaEmpty)
                 {
-                    data.back() = data.back() + line + "\n";
+                    storePackage(fields, synopsis, packages);
+                    std::fill(std::begin(fields), std::end(fields), TextRange{});
+                    synopsis = TextRange{};
+                    lastField = DPKG_FIELDS_COUNT;
+                    stanzaEmpty = true;
                 }
-                else
+            }
+            else if (*line == ' ' || *line == '\t')
+            {
+                if (lastField == DPKG_DESCRIPTION && !synopsis.size)
                 {
-                    data.push_back(line + "\n");
+                    synopsis = descriptionLine;
                 }
             }
-            while (!line.empty()); //end of package item info
+            else
+            {
+                // Continuation lines are skipped, none of the reported fields need them.
+                const auto colon { static_cast<const char*>(std::memchr(line, ':', lineEnd - line)) };
+
+                if (colon)
+                {
+                    const auto key { trim(line, colon) };
+                    lastField = DPKG_FIELDS_COUNT;
+
+                    for (auto i { 0 }; i < DPKG_FIELDS_COUNT; ++i)
+                    {
+                        if (key.equals(DPKG_FIELD_NAMES[i]))
+                        {
+                            fields[i] = trim(colon + 1, lineEnd);
+                            lastField = static_cast<DpkgField>(i);
+                            break;
+                        }
+                    }
+
+                    if (lastField == DPKG_DESCRIPTION)
+                    {
+                        const auto value { fields[DPKG_DESCRIPTION].data };
+                        descriptionLine = TextRange{value, static_cast<size_t>(lineEnd - value)};
+                    }
+
+                    stanzaEmpty = false;
+                }
+            }
+
+            line = lineEnd + 1;
+        }
+
+        if (!stanzaEmpty)
+        {
+            storePackage(fields, synopsis, packages);
+        }
+
+        return packages;
+    }
+
+    nlohmann::json packageToJson(const DpkgPackage& package)
+    {
+        nlohmann::json ret;
+        ret["name"]         = package.name;
+        ret["priority"]     = package.priority;
+        ret["groups"]       = package.groups;
+        ret["size"]         = package.size;
+        ret["multiarch"]    = package.multiarch;
+        ret["architecture"] = package.architecture;
+        ret["source"]       = package.source;
+        ret["version"]      = package.version;
+        ret["format"]       = "deb";
+        ret["vendor"]       = package.vendor;
+        ret["description"]  = package.description;
+        return ret;
+    }
+
+    // Parses the status file only if it changed since the previous call.
+    bool updateCache(const std::string& fileName, DpkgCache& cache)
+    {
+        auto ret { false };
+        const auto fd { open(fileName.c_str(), O_RDONLY | O_CLOEXEC) };
 
-            auto packageInfo = PackageLinuxHelper::parseDpkg(data);
+        if (fd >= 0)
+        {
+            struct stat info {};
 
-            if (!packageInfo.empty())
+            if (fstat(fd, &info) == 0)
             {
-                callback(packageInfo);
+                const DpkgFileStamp stamp { info.st_dev, info.st_ino, info.st_size, info.st_mtim.tv_sec, info.st_mtim.tv_nsec };
+
+                if (cache.fileName == fileName && cache.stamp == stamp)
+                {
+                    ret = true;
+                }
+                else if (info.st_size == 0)
+                {
+                    cache = DpkgCache{fileName, stamp, {}};
+                    ret = true;
+                }
+                else
+                {
+                    const auto size { static_cast<size_t>(info.st_size) };
+                    const auto data { mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+
+                    if (data != MAP_FAILED)
+                    {
+                        madvise(data, size, MADV_SEQUENTIAL);
+                        cache = DpkgCache{fileName, stamp, parseStatus(static_cast<const char*>(data), size)};
+                        munmap(data, size);
+                        ret = true;
+                    }
+                }
             }
+
+            close(fd);
+        }
+
+        return ret;
+    }
+}
+
+void getDpkgInfo(const std::string& fileName, std::function<void(nlohmann::json&)> callback)
+{
+    static std::mutex s_mutex;
+    static DpkgCache s_cache;
+    std::lock_guard<std::mutex> lock{s_mutex};
+
+    if (updateCache(fileName, s_cache))
+    {
+        for (const auto& package : s_cache.packages)
+        {
+            auto packageInfo = packageToJson(package);
+            callback(packageInfo);
         }
     }
 }
@@ -18,8 +18,9 @@
 #include "filesystemHelper.h"
 #include "stringHelper.h"
 #include "rpmlib.h"
+#include "rpmDbReader.h"
 
-void getRpmInfo(std::function<void(nlohmann::json&)> callback)
+void getRpmInfo(const std::string& libPath, std::function<void(nlohmann::json&)> callback)
 {
 
     const auto rpmDefaultQuery
@@ -47,7 +48,26 @@ void getRpmInfo(std::function<void(nlohmann::json&)> callback)
 
     if (!UtilsWrapper::existsRegular(RPM_DATABASE))
     {
-        // We are probably using RPM >= 4.16 – get the packages from librpm.
+        // We are probably using RPM >= 4.16 – read the sqlite or ndb database directly, librpm is
+        // only needed when it can't be read.
+        const auto nativeRead
+        {
+            RpmDbReader::getPackages(libPath, [&callback](const RpmPackageManager::Package & p)
+            {
+                auto packageJson = PackageLinuxHelper::parseRpm(p);
+
+                if (!packageJson.empty())
+                {
+                    callback(packageJson);
+                }
+            })
+        };
+
+        if (nativeRead)
+        {
+            return;
+        }
+
         try
         {
             RpmPackageManager rpm{std::make_shared<RpmLib>()};
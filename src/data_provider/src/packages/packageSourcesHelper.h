@@ -0,0 +1,177 @@
+/*
+ * Wazuh SYSINFO
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _PACKAGE_SOURCES_HELPER_H
+#define _PACKAGE_SOURCES_HELPER_H
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+using PackagesCallback = std::function<void(nlohmann::json&)>;
+
+/**
+ * @brief Collects independent package sources concurrently. Their packages are reported in the
+ *        order the sources were added, so a package found by several sources is always taken
+ *        from the same one.
+ */
+class PackageSources final
+{
+        struct Source
+        {
+            std::string name;
+            std::function<void(PackagesCallback)> collect;
+        };
+
+        struct SourceResult
+        {
+            std::vector<nlohmann::json> packages;
+            std::chrono::milliseconds elapsed;
+            std::exception_ptr error;
+        };
+
+        std::vector<Source> m_sources;
+
+        static std::mutex& lastRunMutex()
+        {
+            static std::mutex s_mutex;
+            return s_mutex;
+        }
+
+        static nlohmann::json& lastRunData()
+        {
+            static nlohmann::json s_lastRun = nlohmann::json::array();
+            return s_lastRun;
+        }
+
+        static SourceResult collect(const Source& source)
+        {
+            SourceResult result {};
+            const auto start { std::chrono::steady_clock::now() };
+
+            try
+            {
+                source.collect([&result](nlohmann::json & package)
+                {
+                    result.packages.push_back(std::move(package));
+                });
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+
+            result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            return result;
+        }
+
+        // Fields of the packages table primary key.
+        static std::string packageKey(const nlohmann::json& package)
+        {
+            std::string key;
+
+            for (const auto& field : {"name", "version", "architecture"})
+            {
+                const auto it { package.find(field) };
+
+                if (it != package.end() && it->is_string())
+                {
+                    key += it->get_ref<const std::string&>();
+                }
+
+                key += '\0';
+            }
+
+            return key;
+        }
+
+    public:
+        void add(const std::string& name, std::function<void(PackagesCallback)> collect)
+        {
+            m_sources.push_back({name, std::move(collect)});
+        }
+
+        /**
+         * @brief Collects all the sources and reports their packages, skipping duplicated ones.
+         *        The error of a failed source is rethrown once the packages of the previous
+         *        sources were reported.
+         * @param callback Callback to be called for every single package.
+         */
+        void run(PackagesCallback callback) const
+        {
+            std::vector<std::future<SourceResult>> results;
+
+            for (const auto& source : m_sources)
+            {
+                // A single source doesn't need a thread.
+                results.push_back(std::async(m_sources.size() > 1 ? std::launch::async : std::launch::deferred, &PackageSources::collect, std::cref(source)));
+            }
+
+            auto times = nlohmann::json::array();
+            std::set<std::string> keys;
+            std::exception_ptr error;
+
+            for (auto i = 0ul; i < m_sources.size(); ++i)
+            {
+                auto result = results[i].get();
+
+                times.push_back(
+                {
+                    {"source", m_sources[i].name},
+                    {"packages", result.packages.size()},
+                    {"elapsed_ms", result.elapsed.count()}
+                });
+
+                if (!error)
+                {
+                    error = result.error;
+                }
+
+                if (!error)
+                {
+                    for (auto& package : result.packages)
+                    {
+                        if (keys.insert(packageKey(package)).second)
+                        {
+                            callback(package);
+                        }
+                    }
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{lastRunMutex()};
+                lastRunData() = std::move(times);
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         * @brief Returns the sources of the last run, with the number of packages and the time each one took.
+         */
+        static nlohmann::json lastRun()
+        {
+            std::lock_guard<std::mutex> lock{lastRunMutex()};
+            return lastRunData();
+        }
+};
+
+#endif // _PACKAGE_SOURCES_HELPER_H
@@ -0,0 +1,458 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include "rpmDbReader.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "byteArrayHelper.h"
+#include "sqlite3.h"
+
+namespace
+{
+    // Header tags reported for each package, as defined in rpmtag.h.
+    enum RpmHeaderTag
+    {
+        RPM_HEADER_TAG_NAME         = 1000,
+        RPM_HEADER_TAG_VERSION      = 1001,
+        RPM_HEADER_TAG_RELEASE      = 1002,
+        RPM_HEADER_TAG_EPOCH        = 1003,
+        RPM_HEADER_TAG_SUMMARY      = 1004,
+        RPM_HEADER_TAG_DESCRIPTION  = 1005,
+        RPM_HEADER_TAG_INSTALLTIME  = 1008,
+        RPM_HEADER_TAG_SIZE         = 1009,
+        RPM_HEADER_TAG_VENDOR       = 1011,
+        RPM_HEADER_TAG_GROUP        = 1016,
+        RPM_HEADER_TAG_ARCH         = 1022,
+        RPM_HEADER_TAG_SOURCE       = 1044,
+        RPM_HEADER_TAG_LONGSIZE     = 5009
+    };
+
+    enum RpmHeaderType
+    {
+        RPM_HEADER_TYPE_INT32        = 4,
+        RPM_HEADER_TYPE_INT64        = 5,
+        RPM_HEADER_TYPE_STRING       = 6,
+        RPM_HEADER_TYPE_STRING_ARRAY = 8,
+        RPM_HEADER_TYPE_I18NSTRING   = 9
+    };
+
+    constexpr size_t RPM_HEADER_PREAMBLE_SIZE { 8 };
+    constexpr size_t RPM_HEADER_ENTRY_SIZE { 16 };
+    // Same limit as header.c.
+    constexpr uint32_t RPM_HEADER_TAGS_MAX { 65535 };
+
+    constexpr auto SQLITE_BUSY_TIMEOUT_MS { 1000 };
+
+    // ndb layout, as written by rpmpkg.c. All its fields are little endian.
+    constexpr uint32_t NDB_MAGIC { 'R' | 'p' << 8 | 'm' << 16 | 'P' << 24 };
+    constexpr uint32_t NDB_SLOT_MAGIC { 'S' | 'l' << 8 | 'o' << 16 | 't' << 24 };
+    constexpr uint32_t NDB_BLOB_MAGIC { 'B' | 'l' << 8 | 'b' << 16 | 'S' << 24 };
+    constexpr uint32_t NDB_VERSION { 0 };
+    constexpr size_t NDB_HEADER_SIZE { 32 };
+    constexpr size_t NDB_PAGE_SIZE { 4096 };
+    constexpr size_t NDB_SLOT_SIZE { 16 };
+    constexpr size_t NDB_BLOCK_SIZE { 16 };
+    constexpr size_t NDB_BLOB_HEAD_SIZE { 16 };
+    constexpr size_t NDB_BLOB_TAIL_SIZE { 12 };
+
+    // Identifies a version of a database file.
+    struct RpmDbFileStamp
+    {
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        time_t mtime;
+        long mtimeNsec;
+
+        bool operator==(const RpmDbFileStamp& other) const
+        {
+            return device == other.device && inode == other.inode && size == other.size &&
+                   mtime == other.mtime && mtimeNsec == other.mtimeNsec;
+        }
+    };
+
+    struct RpmDbCache
+    {
+        std::string fileName;
+        std::vector<RpmDbFileStamp> stamps;
+        std::vector<RpmPackageManager::Package> packages;
+    };
+
+    uint32_t toUInt32BE(const uint8_t* bytes)
+    {
+        return static_cast<uint32_t>(Utils::toInt32BE(bytes));
+    }
+
+    uint32_t toUInt32LE(const uint8_t* bytes)
+    {
+        return static_cast<uint32_t>(Utils::toInt32LE(bytes));
+    }
+
+    bool fileStamp(const std::string& fileName, RpmDbFileStamp& stamp)
+    {
+        struct stat info {};
+        const auto ret { stat(fileName.c_str(), &info) == 0 && S_ISREG(info.st_mode) };
+
+        if (ret)
+        {
+            stamp = RpmDbFileStamp{ info.st_dev, info.st_ino, info.st_size, info.st_mtim.tv_sec, info.st_mtim.tv_nsec };
+        }
+
+        return ret;
+    }
+
+    // The first string of the entry, it is the untranslated one of an i18n string.
+    void readString(const uint8_t* value, const size_t available, const uint32_t type, std::string& output)
+    {
+        if (type == RPM_HEADER_TYPE_STRING || type == RPM_HEADER_TYPE_STRING_ARRAY || type == RPM_HEADER_TYPE_I18NSTRING)
+        {
+            const auto end { static_cast<const uint8_t*>(std::memchr(value, '\0', available)) };
+
+            if (end)
+            {
+                output.assign(reinterpret_cast<const char*>(value), end - value);
+            }
+        }
+    }
+
+    bool readNumber(const uint8_t* value, const size_t available, const uint32_t type, uint64_t& output)
+    {
+        auto ret { false };
+
+        if (type == RPM_HEADER_TYPE_INT32 && available >= sizeof(uint32_t))
+        {
+            output = toUInt32BE(value);
+            ret = true;
+        }
+        else if (type == RPM_HEADER_TYPE_INT64 && available >= sizeof(uint64_t))
+        {
+            output = static_cast<uint64_t>(toUInt32BE(value)) << 32 | toUInt32BE(value + sizeof(uint32_t));
+            ret = true;
+        }
+
+        return ret;
+    }
+
+    bool readSqlite(const std::string& fileName, std::vector<RpmPackageManager::Package>& packages)
+    {
+        auto ret { false };
+        sqlite3* db { nullptr };
+
+        if (sqlite3_open_v2(fileName.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK)
+        {
+            sqlite3_stmt* stmt { nullptr };
+            // rpm holds the write lock during a transaction.
+            sqlite3_busy_timeout(db, SQLITE_BUSY_TIMEOUT_MS);
+
+            if (sqlite3_prepare_v2(db, "SELECT blob FROM Packages ORDER BY hnum;", -1, &stmt, nullptr) == SQLITE_OK)
+            {
+                auto result { SQLITE_ROW };
+
+                while ((result = sqlite3_step(stmt)) == SQLITE_ROW)
+                {
+                    const auto blob { static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0)) };
+                    const auto size { sqlite3_column_bytes(stmt, 0) };
+                    RpmPackageManager::Package package;
+
+                    if (blob && RpmDbReader::parseHeader(blob, static_cast<size_t>(size), package))
+                    {
+                        packages.push_back(std::move(package));
+                    }
+                }
+
+                ret = result == SQLITE_DONE;
+                sqlite3_finalize(stmt);
+            }
+        }
+
+        sqlite3_close(db);
+        return ret;
+    }
+
+    bool parseNdb(const uint8_t* data, const size_t size, std::vector<RpmPackageManager::Package>& packages)
+    {
+        if (size < NDB_HEADER_SIZE || toUInt32LE(data) != NDB_MAGIC || toUInt32LE(data + 4) != NDB_VERSION)
+        {
+            return false;
+        }
+
+        const auto slotsEnd { static_cast<uint64_t>(toUInt32LE(data + 12)) * NDB_PAGE_SIZE };
+
+        if (slotsEnd == 0 || slotsEnd > size)
+        {
+            return false;
+        }
+
+        std::vector<std::pair<uint32_t, RpmPackageManager::Package>> slots;
+
+        // The database header takes the first slots of the first page.
+        for (auto slot { data + NDB_HEADER_SIZE }; slot + NDB_SLOT_SIZE <= data + slotsEnd; slot += NDB_SLOT_SIZE)
+        {
+            if (toUInt32LE(slot) != NDB_SLOT_MAGIC)
+            {
+                return false;
+            }
+
+            const auto packageIndex { toUInt32LE(slot + 4) };
+
+            if (!packageIndex)
+            {
+                // Free slot.
+                continue;
+            }
+
+            const auto blobOffset { static_cast<uint64_t>(toUInt32LE(slot + 8)) * NDB_BLOCK_SIZE };
+            const auto blockCount { toUInt32LE(slot + 12) };
+
+            if (blobOffset < slotsEnd || static_cast<uint64_t>(blockCount) * NDB_BLOCK_SIZE < NDB_BLOB_HEAD_SIZE + NDB_BLOB_TAIL_SIZE ||
+                    blobOffset + static_cast<uint64_t>(blockCount) * NDB_BLOCK_SIZE > size)
+            {
+                return false;
+            }
+
+            const auto blob { data + blobOffset };
+            const auto blobSize { toUInt32LE(blob + 12) };
+
+            if (toUInt32LE(blob) != NDB_BLOB_MAGIC || toUInt32LE(blob + 4) != packageIndex ||
+                    (blobSize + NDB_BLOB_HEAD_SIZE + NDB_BLOB_TAIL_SIZE + NDB_BLOCK_SIZE - 1) / NDB_BLOCK_SIZE != blockCount)
+            {
+                return false;
+            }
+
+            RpmPackageManager::Package package;
+
+            if (RpmDbReader::parseHeader(blob + NDB_BLOB_HEAD_SIZE, blobSize, package))
+            {
+                slots.emplace_back(packageIndex, std::move(package));
+            }
+        }
+
+        // Same order librpm reports them.
+        std::sort(slots.begin(), slots.end(), [](const auto & left, const auto & right)
+        {
+            return left.first < right.first;
+        });
+
+        for (auto& slot : slots)
+        {
+            packages.push_back(std::move(slot.second));
+        }
+
+        return true;
+    }
+
+    bool readNdb(const std::string& fileName, std::vector<RpmPackageManager::Package>& packages)
+    {
+        auto ret { false };
+        const auto fd { open(fileName.c_str(), O_RDONLY | O_CLOEXEC) };
+
+        if (fd >= 0)
+        {
+            struct stat info {};
+
+            // rpm takes the exclusive lock to write, librpm is left to wait for it.
+            if (flock(fd, LOCK_SH | LOCK_NB) == 0 && fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                const auto size { static_cast<size_t>(info.st_size) };
+                const auto data { mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+
+                if (data != MAP_FAILED)
+                {
+                    ret = parseNdb(static_cast<const uint8_t*>(data), size, packages);
+                    munmap(data, size);
+                }
+            }
+
+            close(fd);
+        }
+
+        return ret;
+    }
+
+    bool updateCache(const std::string& libPath, RpmDbCache& cache)
+    {
+        auto ret { false };
+        const auto sqliteFileName { libPath + RPM_SQLITE_DATABASE };
+        const auto ndbFileName { libPath + RPM_NDB_DATABASE };
+        RpmDbFileStamp stamp {};
+        std::vector<RpmPackageManager::Package> packages;
+
+        // The stamps are taken before reading, a change in between is read again on the next call.
+        if (fileStamp(sqliteFileName, stamp))
+        {
+            // Committed transactions can stay in the write-ahead log until a checkpoint.
+            RpmDbFileStamp walStamp {};
+            fileStamp(sqliteFileName + "-wal", walStamp);
+            const std::vector<RpmDbFileStamp> stamps { stamp, walStamp };
+
+            if (cache.fileName == sqliteFileName && cache.stamps == stamps)
+            {
+                ret = true;
+            }
+            else if (readSqlite(sqliteFileName, packages))
+            {
+                cache = RpmDbCache{sqliteFileName, stamps, std::move(packages)};
+                ret = true;
+            }
+        }
+        else if (fileStamp(ndbFileName, stamp))
+        {
+            const std::vector<RpmDbFileStamp> stamps { stamp };
+
+            if (cache.fileName == ndbFileName && cache.stamps == stamps)
+            {
+                ret = true;
+            }
+            else if (readNdb(ndbFileName, packages))
+            {
+                cache = RpmDbCache{ndbFileName, stamps, std::move(packages)};
+                ret = true;
+            }
+        }
+
+        return ret;
+    }
+}
+
+bool RpmDbReader::parseHeader(const uint8_t* blob, const size_t size, RpmPackageManager::Package& package)
+{
+    if (size < RPM_HEADER_PREAMBLE_SIZE)
+    {
+        return false;
+    }
+
+    const auto indexCount { toUInt32BE(blob) };
+    const auto dataSize { toUInt32BE(blob + sizeof(uint32_t)) };
+
+    if (indexCount == 0 || indexCount > RPM_HEADER_TAGS_MAX ||
+            RPM_HEADER_PREAMBLE_SIZE + static_cast<uint64_t>(indexCount) * RPM_HEADER_ENTRY_SIZE + dataSize > size)
+    {
+        return false;
+    }
+
+    const auto entries { blob + RPM_HEADER_PREAMBLE_SIZE };
+    const auto data { entries + indexCount * RPM_HEADER_ENTRY_SIZE };
+    auto hasSize { false };
+    uint64_t longSize { 0 };
+    uint64_t installTime { 0 };
+
+    package = RpmPackageManager::Package{};
+
+    for (auto entry { entries }; entry < data; entry += RPM_HEADER_ENTRY_SIZE)
+    {
+        const auto tag { toUInt32BE(entry) };
+        const auto type { toUInt32BE(entry + 4) };
+        const auto offset { toUInt32BE(entry + 8) };
+
+        if (offset >= dataSize)
+        {
+            continue;
+        }
+
+        const auto value { data + offset };
+        const auto available { static_cast<size_t>(dataSize - offset) };
+
+        switch (tag)
+        {
+            case RPM_HEADER_TAG_NAME:
+                readString(value, available, type, package.name);
+                break;
+
+            case RPM_HEADER_TAG_VERSION:
+                readString(value, available, type, package.version);
+                break;
+
+            case RPM_HEADER_TAG_RELEASE:
+                readString(value, available, type, package.release);
+                break;
+
+            case RPM_HEADER_TAG_EPOCH:
+                readNumber(value, available, type, package.epoch);
+                break;
+
+            case RPM_HEADER_TAG_SUMMARY:
+                readString(value, available, type, package.summary);
+                break;
+
+            case RPM_HEADER_TAG_DESCRIPTION:
+                readString(value, available, type, package.description);
+                break;
+
+            case RPM_HEADER_TAG_INSTALLTIME:
+                readNumber(value, available, type, installTime);
+                break;
+
+            case RPM_HEADER_TAG_SIZE:
+                hasSize = readNumber(value, available, type, package.size);
+                break;
+
+            case RPM_HEADER_TAG_LONGSIZE:
+                readNumber(value, available, type, longSize);
+                break;
+
+            case RPM_HEADER_TAG_VENDOR:
+                readString(value, available, type, package.vendor);
+                break;
+
+            case RPM_HEADER_TAG_GROUP:
+                readString(value, available, type, package.group);
+                break;
+
+            case RPM_HEADER_TAG_ARCH:
+                readString(value, available, type, package.architecture);
+                break;
+
+            case RPM_HEADER_TAG_SOURCE:
+                readString(value, available, type, package.source);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // Packages bigger than 4GB only have the 64 bits size.
+    if (!hasSize)
+    {
+        package.size = longSize;
+    }
+
+    package.installTime = std::to_string(installTime);
+    return true;
+}
+
+bool RpmDbReader::getPackages(const std::string& libPath,
+                              std::function<void(const RpmPackageManager::Package&)> callback)
+{
+    static std::mutex s_mutex;
+    static RpmDbCache s_cache;
+    std::lock_guard<std::mutex> lock{s_mutex};
+
+    const auto ret { updateCache(libPath, s_cache) };
+
+    if (ret)
+    {
+        for (const auto& package : s_cache.packages)
+        {
+            callback(package);
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,48 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#ifndef _RPM_DB_READER_H
+#define _RPM_DB_READER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "rpmPackageManager.h"
+
+constexpr auto RPM_SQLITE_DATABASE {"rpmdb.sqlite"};
+constexpr auto RPM_NDB_DATABASE {"Packages.db"};
+
+// Reads the installed packages straight from the rpmdb files, decoding only the header tags that
+// are reported, without going through librpm.
+class RpmDbReader final
+{
+    public:
+        /**
+         * @brief Reports the packages of the sqlite (rpm >= 4.16) or ndb (SUSE) database of a
+         *        directory. The packages are decoded again only when the database changes.
+         * @param libPath  Path to the rpm database directory.
+         * @param callback Callback to be called for every single package.
+         * @return false if there is no such database or it couldn't be read, nothing is reported then.
+         */
+        static bool getPackages(const std::string& libPath,
+                                std::function<void(const RpmPackageManager::Package&)> callback);
+
+        /**
+         * @brief Decodes a package from a header blob as stored in the rpmdb.
+         * @param blob    Header blob, starting with the index and data sizes.
+         * @param size    Size of the blob.
+         * @param package Decoded package.
+         * @return false if the blob is not a valid header.
+         */
+        static bool parseHeader(const uint8_t* blob, const size_t size, RpmPackageManager::Package& package);
+};
+
+#endif // _RPM_DB_READER_H
@@ -0,0 +1,212 @@
+/*
+ * Wazuh SYSINFO
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _PORT_LINUX_DIAG_WRAPPER_H
+#define _PORT_LINUX_DIAG_WRAPPER_H
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <cstring>
+#include <functional>
+#include "portLinuxWrapper.h"
+
+// Socket states to request, as a bit mask of (1 << state).
+constexpr uint32_t SOCK_DIAG_ALL_STATES { 0xFFFFFFFF };
+
+class LinuxPortDiagWrapper final : public IPortWrapper
+{
+        PortType m_type;
+        inet_diag_msg m_message;
+
+        std::string address(const __be32 (&rawAddress)[4]) const
+        {
+            std::string retVal;
+
+            if (IPVERSION_TYPE.at(m_type) == IPV4)
+            {
+                in_addr addr {};
+                std::memcpy(&addr, rawAddress, sizeof(addr));
+                retVal = Utils::NetworkHelper::IAddressToBinary(AF_INET, &addr);
+            }
+            else
+            {
+                in6_addr addr {};
+                std::memcpy(&addr, rawAddress, sizeof(addr));
+                retVal = Utils::NetworkHelper::IAddressToBinary(AF_INET6, &addr);
+            }
+
+            return retVal;
+        }
+
+    public:
+        explicit LinuxPortDiagWrapper(const PortType type, const inet_diag_msg& message)
+            : m_type { type }
+            , m_message ( message )
+        { }
+
+        ~LinuxPortDiagWrapper() = default;
+
+        // Reads the sockets of a type from the kernel through NETLINK_SOCK_DIAG, the dump is only
+        // reported when it completes so a failure can fall back to /proc/net.
+        static bool getSockets(const PortType type,
+                               const uint32_t states,
+                               std::function<void(const inet_diag_msg&)> callback)
+        {
+            auto ret { false };
+            const auto fd { socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG) };
+
+            if (fd >= 0)
+            {
+                struct
+                {
+                    nlmsghdr header;
+                    inet_diag_req_v2 request;
+                } message {};
+
+                message.header.nlmsg_len = sizeof(message);
+                message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+                message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+                message.request.sdiag_family = IPVERSION_TYPE.at(type) == IPV4 ? AF_INET : AF_INET6;
+                message.request.sdiag_protocol = PROTOCOL_TYPE.at(type) == TCP ? IPPROTO_TCP : IPPROTO_UDP;
+                message.request.idiag_states = states;
+
+                sockaddr_nl kernel {};
+                kernel.nl_family = AF_NETLINK;
+
+                if (sendto(fd, &message, sizeof(message), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) >= 0)
+                {
+                    std::vector<inet_diag_msg> sockets;
+                    // nlmsghdr aligned buffer.
+                    std::vector<nlmsghdr> buffer(32768 / sizeof(nlmsghdr));
+                    auto done { false };
+
+                    while (!done)
+                    {
+                        auto length { recv(fd, buffer.data(), buffer.size() * sizeof(nlmsghdr), 0) };
+
+                        if (length <= 0)
+                        {
+                            break;
+                        }
+
+                        for (auto header { buffer.data() }; !done && NLMSG_OK(header, length); header = NLMSG_NEXT(header, length))
+                        {
+                            if (header->nlmsg_type == NLMSG_DONE)
+                            {
+                                ret = true;
+                                done = true;
+                            }
+                            else if (header->nlmsg_type == NLMSG_ERROR)
+                            {
+                                // Unsupported family or protocol, e.g. the udp_diag module is not available.
+                                done = true;
+                            }
+                            else if (header->nlmsg_type == SOCK_DIAG_BY_FAMILY &&
+                                     header->nlmsg_len >= NLMSG_LENGTH(sizeof(inet_diag_msg)))
+                            {
+                                sockets.push_back(*static_cast<const inet_diag_msg*>(NLMSG_DATA(header)));
+                            }
+                        }
+                    }
+
+                    if (ret)
+                    {
+                        for (const auto& socketInfo : sockets)
+                        {
+                            callback(socketInfo);
+                        }
+                    }
+                }
+
+                close(fd);
+            }
+
+            return ret;
+        }
+
+        std::string protocol() const override
+        {
+            std::string retVal;
+
+            const auto it { PORTS_TYPE.find(m_type) };
+
+            if (PORTS_TYPE.end() != it)
+            {
+                retVal = it->second;
+            }
+
+            return retVal;
+        }
+
+        std::string localIp() const override
+        {
+            return address(m_message.id.idiag_src);
+        }
+        int32_t localPort() const override
+        {
+            return ntohs(m_message.id.idiag_sport);
+        }
+        std::string remoteIP() const override
+        {
+            return address(m_message.id.idiag_dst);
+        }
+        int32_t remotePort() const override
+        {
+            return ntohs(m_message.id.idiag_dport);
+        }
+        int32_t txQueue() const override
+        {
+            // The kernel reports the maximum backlog of a listening socket here, /proc/net shows 0.
+            return (PROTOCOL_TYPE.at(m_type) == TCP && m_message.idiag_state == TCP_LISTEN) ? 0 : static_cast<int32_t>(m_message.idiag_wqueue);
+        }
+        int32_t rxQueue() const override
+        {
+            return static_cast<int32_t>(m_message.idiag_rqueue);
+        }
+        int64_t inode() const override
+        {
+            return static_cast<int64_t>(m_message.idiag_inode);
+        }
+        std::string state() const override
+        {
+            std::string retVal;
+
+            if (PROTOCOL_TYPE.at(m_type) == TCP)
+            {
+                const auto itState { STATE_TYPE.find(m_message.idiag_state) };
+
+                if (STATE_TYPE.end() != itState)
+                {
+                    retVal = itState->second;
+                }
+            }
+
+            return retVal;
+        }
+
+        std::string processName() const override
+        {
+            return {};
+        }
+
+        int32_t pid() const override
+        {
+            return {};
+        }
+};
+
+
+#endif //_PORT_LINUX_DIAG_WRAPPER_H
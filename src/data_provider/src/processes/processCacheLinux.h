@@ -0,0 +1,97 @@
+/*
+ * Wazuh SYSINFO
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _PROCESS_CACHE_LINUX_H
+#define _PROCESS_CACHE_LINUX_H
+
+#include <array>
+#include <map>
+#include <string>
+#include <utility>
+
+// Process fields that are expensive to read and can't change without an exec or a credentials change.
+struct ProcessCacheEntry
+{
+    // An exec keeps the pid and the start time but replaces the name.
+    std::string name;
+    std::array<int, 4> uids;
+    std::array<int, 4> gids;
+    std::string cmd;
+    std::string argvs;
+    std::string euser;
+    std::string ruser;
+    std::string suser;
+    std::string egroup;
+    std::string rgroup;
+    std::string sgroup;
+    std::string fgroup;
+};
+
+/**
+ * @brief Stable fields of the processes found by the previous scan, keyed by pid and start time.
+ *
+ * A pid reused by a new process has another start time, so it never gets the entry of the
+ * process that exited.
+ */
+class ProcessCache final
+{
+        using Key = std::pair<int, unsigned long long>;
+        std::map<Key, ProcessCacheEntry> m_entries;
+        std::map<Key, ProcessCacheEntry> m_scan;
+
+    public:
+        /**
+         * @brief Entry of a process found by the previous scan, kept for the next one.
+         *
+         * @return nullptr if the process is new, or if its name or its ids changed.
+         */
+        const ProcessCacheEntry* find(const int pid,
+                                      const unsigned long long startTime,
+                                      const char* name,
+                                      const std::array<int, 4>& uids,
+                                      const std::array<int, 4>& gids)
+        {
+            const ProcessCacheEntry* retVal { nullptr };
+            const auto it { m_entries.find({ pid, startTime }) };
+
+            if (m_entries.end() != it && it->second.name == name && it->second.uids == uids && it->second.gids == gids)
+            {
+                retVal = &(m_scan[it->first] = std::move(it->second));
+                m_entries.erase(it);
+            }
+
+            return retVal;
+        }
+
+        /**
+         * @brief Adds the entry of a process read by the current scan.
+         */
+        const ProcessCacheEntry& add(const int pid, const unsigned long long startTime, ProcessCacheEntry entry)
+        {
+            return m_scan[ { pid, startTime }] = std::move(entry);
+        }
+
+        /**
+         * @brief Ends the scan, the processes it didn't find are dropped.
+         */
+        void commit()
+        {
+            m_entries = std::move(m_scan);
+            m_scan.clear();
+        }
+
+        size_t size() const
+        {
+            return m_entries.size();
+        }
+};
+
+#endif // _PROCESS_CACHE_LINUX_H
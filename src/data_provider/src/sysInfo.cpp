@@ -11,6 +11,7 @@
 #include "sysInfo.hpp"
 #include "sysInfo.h"
 #include "cjsonSmartDeleter.hpp"
+#include "packages/packageSourcesHelper.h"
 
 nlohmann::json SysInfo::hardware()
 {
@@ -58,6 +59,11 @@ void SysInfo::packages(std::function<void(nlohmann::json&)> callback)
     getPackages(callback);
 }
 
+nlohmann::json SysInfo::packagesSources()
+{
+    return PackageSources::lastRun();
+}
+
 nlohmann::json SysInfo::hotfixes()
 {
     return getHotfixes();
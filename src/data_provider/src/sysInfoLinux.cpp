@@ -11,6 +11,7 @@
 #include <fstream>
 #include <iostream>
 #include <regex>
+#include <mutex>
 #include "sharedDefs.h"
 #include "stringHelper.h"
 #include "filesystemHelper.h"
@@ -24,9 +25,17 @@
 #include "network/networkLinuxWrapper.h"
 #include "network/networkFamilyDataAFactory.h"
 #include "ports/portLinuxWrapper.h"
+// Legacy kernel headers (CentOS 5) predate NETLINK_SOCK_DIAG, ports are only read from /proc/net there.
+#if defined(__has_include)
+#if __has_include(<linux/sock_diag.h>)
+#define SOCK_DIAG_ENABLED
+#include "ports/portLinuxDiagWrapper.h"
+#endif
+#endif
 #include "ports/portImpl.h"
 #include "packages/berkeleyRpmDbHelper.h"
 #include "packages/packageLinuxDataRetriever.h"
+#include "processes/processCacheLinux.h"
 
 #include "linuxInfoHelper.h"
 
@@ -77,61 +86,73 @@ static bool getSystemInfo(const std::string& fileName, const std::string& separa
     return ret;
 }
 
-static nlohmann::json getProcessInfo(const SysInfoProcess& process)
+static ProcessCacheEntry getProcessCacheEntry(const proc_t& process)
 {
-    nlohmann::json jsProcessInfo{};
-    // Current process information
-    jsProcessInfo["pid"]        = std::to_string(process->tid);
-    jsProcessInfo["name"]       = process->cmd;
-    jsProcessInfo["state"]      = &process->state;
-    jsProcessInfo["ppid"]       = process->ppid;
-    jsProcessInfo["utime"]      = process->utime;
-    jsProcessInfo["stime"]      = process->stime;
-    std::string commandLine;
-    std::string commandLineArgs;
-
-    if (process->cmdline && process->cmdline[0])
+    ProcessCacheEntry entry
+    {
+        process.cmd,
+        { process.euid, process.ruid, process.suid, process.fuid },
+        { process.egid, process.rgid, process.sgid, process.fgid },
+        {}, {},
+        process.euser, process.ruser, process.suser,
+        process.egroup, process.rgroup, process.sgroup, process.fgroup
+    };
+
+    if (process.cmdline && process.cmdline[0])
     {
-        commandLine = process->cmdline[0];
+        entry.cmd = process.cmdline[0];
 
-        for (int idx = 1; process->cmdline[idx]; ++idx)
+        for (int idx = 1; process.cmdline[idx]; ++idx)
         {
-            const auto cmdlineArgSize { sizeof(process->cmdline[idx]) };
+            const auto cmdlineArgSize { sizeof(process.cmdline[idx]) };
 
-            if (strnlen(process->cmdline[idx], cmdlineArgSize) != 0)
+            if (strnlen(process.cmdline[idx], cmdlineArgSize) != 0)
             {
-                commandLineArgs += process->cmdline[idx];
+                entry.argvs += process.cmdline[idx];
 
-                if (process->cmdline[idx + 1])
+                if (process.cmdline[idx + 1])
                 {
-                    commandLineArgs += " ";
+                    entry.argvs += " ";
                 }
             }
         }
     }
 
-    jsProcessInfo["cmd"]        = commandLine;
-    jsProcessInfo["argvs"]      = commandLineArgs;
-    jsProcessInfo["euser"]      = process->euser;
-    jsProcessInfo["ruser"]      = process->ruser;
-    jsProcessInfo["suser"]      = process->suser;
-    jsProcessInfo["egroup"]     = process->egroup;
-    jsProcessInfo["rgroup"]     = process->rgroup;
-    jsProcessInfo["sgroup"]     = process->sgroup;
-    jsProcessInfo["fgroup"]     = process->fgroup;
-    jsProcessInfo["priority"]   = process->priority;
-    jsProcessInfo["nice"]       = process->nice;
-    jsProcessInfo["size"]       = process->size;
-    jsProcessInfo["vm_size"]    = process->vm_size;
-    jsProcessInfo["resident"]   = process->resident;
-    jsProcessInfo["share"]      = process->share;
-    jsProcessInfo["start_time"] = Utils::timeTick2unixTime(process->start_time);
-    jsProcessInfo["pgrp"]       = process->pgrp;
-    jsProcessInfo["session"]    = process->session;
-    jsProcessInfo["tgid"]       = process->tgid;
-    jsProcessInfo["tty"]        = process->tty;
-    jsProcessInfo["processor"]  = process->processor;
-    jsProcessInfo["nlwp"]       = process->nlwp;
+    return entry;
+}
+
+static nlohmann::json getProcessInfo(const proc_t& process, const ProcessCacheEntry& entry)
+{
+    nlohmann::json jsProcessInfo{};
+    // Current process information
+    jsProcessInfo["pid"]        = std::to_string(process.tid);
+    jsProcessInfo["name"]       = process.cmd;
+    jsProcessInfo["state"]      = std::string(1, process.state);
+    jsProcessInfo["ppid"]       = process.ppid;
+    jsProcessInfo["utime"]      = process.utime;
+    jsProcessInfo["stime"]      = process.stime;
+    jsProcessInfo["cmd"]        = entry.cmd;
+    jsProcessInfo["argvs"]      = entry.argvs;
+    jsProcessInfo["euser"]      = entry.euser;
+    jsProcessInfo["ruser"]      = entry.ruser;
+    jsProcessInfo["suser"]      = entry.suser;
+    jsProcessInfo["egroup"]     = entry.egroup;
+    jsProcessInfo["rgroup"]     = entry.rgroup;
+    jsProcessInfo["sgroup"]     = entry.sgroup;
+    jsProcessInfo["fgroup"]     = entry.fgroup;
+    jsProcessInfo["priority"]   = process.priority;
+    jsProcessInfo["nice"]       = process.nice;
+    jsProcessInfo["size"]       = process.size;
+    jsProcessInfo["vm_size"]    = process.vm_size;
+    jsProcessInfo["resident"]   = process.resident;
+    jsProcessInfo["share"]      = process.share;
+    jsProcessInfo["start_time"] = Utils::timeTick2unixTime(process.start_time);
+    jsProcessInfo["pgrp"]       = process.pgrp;
+    jsProcessInfo["session"]    = process.session;
+    jsProcessInfo["tgid"]       = process.tgid;
+    jsProcessInfo["tty"]        = process.tty;
+    jsProcessInfo["processor"]  = process.processor;
+    jsProcessInfo["nlwp"]       = process.nlwp;
     return jsProcessInfo;
 }
 
@@ -380,13 +401,22 @@ nlohmann::json SysInfo::getNetworks() const
     std::map<std::string, std::vector<ifaddrs*>> networkInterfaces;
     Utils::NetworkUnixHelper::getNetworks(interfacesAddress, networkInterfaces);
 
+    // One rtnetlink dump for the links and routes of all the interfaces, sysfs and /proc/net are
+    // only read if the kernel refuses it.
+    auto netlink { std::make_shared<NetworkLinuxNetlink>() };
+
+    if (!netlink->dump())
+    {
+        netlink.reset();
+    }
+
     for (const auto& interface : networkInterfaces)
     {
         nlohmann::json ifaddr {};
 
         for (auto addr : interface.second)
         {
-            const auto networkInterfacePtr { FactoryNetworkFamilyCreator<OSType::LINUX>::create(std::make_shared<NetworkLinuxInterface>(addr)) };
+            const auto networkInterfacePtr { FactoryNetworkFamilyCreator<OSType::LINUX>::create(std::make_shared<NetworkLinuxInterface>(addr, netlink)) };
 
             if (networkInterfacePtr)
             {
@@ -406,6 +436,24 @@ nlohmann::json SysInfo::getPorts() const
 
     for (const auto& portType : PORTS_TYPE)
     {
+#ifdef SOCK_DIAG_ENABLED
+        const auto fromKernel
+        {
+            LinuxPortDiagWrapper::getSockets(portType.first, SOCK_DIAG_ALL_STATES, [&ports, &portType](const inet_diag_msg & message)
+            {
+                nlohmann::json port {};
+                std::make_unique<PortImpl>(std::make_shared<LinuxPortDiagWrapper>(portType.first, message))->buildPortData(port);
+                ports.push_back(port);
+            })
+        };
+
+        if (fromKernel)
+        {
+            continue;
+        }
+
+#endif
+
         const auto fileContent { Utils::getFileContent(WM_SYS_NET_DIR + portType.second) };
         const auto rows { Utils::split(fileContent, '\n') };
         auto fileBody { false };
@@ -432,21 +480,68 @@ nlohmann::json SysInfo::getPorts() const
 
 void SysInfo::getProcessesInfo(std::function<void(nlohmann::json&)> callback) const
 {
+    static std::mutex s_mutex;
+    static ProcessCache s_cache;
+    std::lock_guard<std::mutex> lock{s_mutex};
+    std::vector<pid_t> newProcesses;
 
-    const SysInfoProcessesTable spProcTable
+    // First pass, only /proc/<pid>/stat, statm and status are read.
     {
-        openproc(PROC_FILLMEM | PROC_FILLSTAT | PROC_FILLSTATUS | PROC_FILLARG | PROC_FILLGRP | PROC_FILLUSR | PROC_FILLCOM | PROC_FILLENV)
-    };
+        const SysInfoProcessesTable spProcTable
+        {
+            openproc(PROC_FILLMEM | PROC_FILLSTAT | PROC_FILLSTATUS)
+        };
 
-    SysInfoProcess spProcInfo { readproc(spProcTable.get(), nullptr) };
+        SysInfoProcess spProcInfo { readproc(spProcTable.get(), nullptr) };
+
+        while (nullptr != spProcInfo)
+        {
+            const auto entry
+            {
+                s_cache.find(spProcInfo->tid, spProcInfo->start_time, spProcInfo->cmd,
+                { spProcInfo->euid, spProcInfo->ruid, spProcInfo->suid, spProcInfo->fuid },
+                { spProcInfo->egid, spProcInfo->rgid, spProcInfo->sgid, spProcInfo->fgid })
+            };
+
+            if (entry)
+            {
+                auto processInfo = getProcessInfo(*spProcInfo, *entry);
+                callback(processInfo);
+            }
+            else
+            {
+                newProcesses.push_back(spProcInfo->tid);
+            }
 
-    while (nullptr != spProcInfo)
+            spProcInfo.reset(readproc(spProcTable.get(), nullptr));
+        }
+    }
+
+    // Second pass, the command line and user and group names are only read for new processes.
+    if (!newProcesses.empty())
     {
-        // Get process information object and push it to the caller
-        auto processInfo = getProcessInfo(spProcInfo);
-        callback(processInfo);
-        spProcInfo.reset(readproc(spProcTable.get(), nullptr));
+        newProcesses.push_back(0);
+
+        const SysInfoProcessesTable spProcTable
+        {
+            openproc(PROC_FILLMEM | PROC_FILLSTAT | PROC_FILLSTATUS | PROC_FILLARG | PROC_FILLGRP | PROC_FILLUSR | PROC_FILLCOM | PROC_PID,
+                     newProcesses.data())
+        };
+
+        SysInfoProcess spProcInfo { readproc(spProcTable.get(), nullptr) };
+
+        while (nullptr != spProcInfo)
+        {
+            // Processes that exited after the first pass are not returned by readproc.
+            const auto& entry { s_cache.add(spProcInfo->tid, spProcInfo->start_time, getProcessCacheEntry(*spProcInfo)) };
+            auto processInfo = getProcessInfo(*spProcInfo, entry);
+            callback(processInfo);
+            spProcInfo.reset(readproc(spProcTable.get(), nullptr));
+        }
     }
+
+    // Exited processes are dropped from the cache, their rows are deleted by the caller's transaction.
+    s_cache.commit();
 }
 
 void SysInfo::getPackages(std::function<void(nlohmann::json&)> callback) const
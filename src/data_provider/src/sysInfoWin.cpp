@@ -17,6 +17,8 @@
 #include <iphlpapi.h>
 #include <memory>
 #include <list>
+#include <map>
+#include <mutex>
 #include <set>
 #include <system_error>
 #include <winternl.h>
@@ -39,6 +41,7 @@
 #include "packages/packagesWindowsParserHelper.h"
 #include "packages/packagesWindows.h"
 #include "packages/appxWindowsWrapper.h"
+#include "packages/packageSourcesHelper.h"
 
 constexpr auto CENTRAL_PROCESSOR_REGISTRY {"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0"};
 const std::string UNINSTALL_REGISTRY{"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall"};
@@ -309,87 +312,133 @@ static nlohmann::json getProcessInfo(const PROCESSENTRY32& processEntry)
     return jsProcessInfo;
 }
 
-static void getPackagesFromReg(const HKEY key, const std::string& subKey, std::function<void(nlohmann::json&)> returnCallback, const REGSAM access = 0)
+// Package read from an uninstall subkey, kept while the subkey and its values are not written again.
+struct RegistryPackageCacheEntry
 {
-    try
+    ULONGLONG lastWriteTime;
+    nlohmann::json package;
+};
+
+using RegistryPackagesCache = std::map<std::string, RegistryPackageCacheEntry>;
+
+static nlohmann::json getPackageFromReg(const HKEY key, const std::string& subKey, const std::string& package, const REGSAM access)
+{
+    std::string value;
+    nlohmann::json packageJson;
+    Utils::Registry packageReg{key, subKey + "\\" + package, access | KEY_READ};
+
+    std::string name;
+    std::string version;
+    std::string vendor;
+    std::string install_time;
+    std::string location;
+    std::string architecture;
+
+    if (packageReg.string("DisplayName", value))
     {
-        const auto callback
+        name = value;
+    }
+
+    if (packageReg.string("DisplayVersion", value))
+    {
+        version = value;
+    }
+
+    if (packageReg.string("Publisher", value))
+    {
+        vendor = value;
+    }
+
+    if (packageReg.string("InstallDate", value))
+    {
+        install_time = value;
+    }
+    else
+    {
+        install_time = packageReg.keyModificationDate();
+    }
+
+    if (packageReg.string("InstallLocation", value))
+    {
+        location = value;
+    }
+
+    if (!name.empty())
+    {
+        if (access & KEY_WOW64_32KEY)
         {
-            [&](const std::string & package)
-            {
-                std::string value;
-                nlohmann::json packageJson;
-                Utils::Registry packageReg{key, subKey + "\\" + package, access | KEY_READ};
-
-                std::string name;
-                std::string version;
-                std::string vendor;
-                std::string install_time;
-                std::string location;
-                std::string architecture;
-
-                if (packageReg.string("DisplayName", value))
-                {
-                    name = value;
-                }
+            architecture = "i686";
+        }
+        else if (access & KEY_WOW64_64KEY)
+        {
+            architecture = "x86_64";
+        }
+        else
+        {
+            architecture = UNKNOWN_VALUE;
+        }
 
-                if (packageReg.string("DisplayVersion", value))
-                {
-                    version = value;
-                }
+        packageJson["name"]         = std::move(name);
+        packageJson["version"]      = std::move(version);
+        packageJson["vendor"]       = std::move(vendor);
+        packageJson["install_time"] = std::move(install_time);
+        packageJson["location"]     = std::move(location);
+        packageJson["architecture"] = std::move(architecture);
+        packageJson["format"]       = "win";
+    }
 
-                if (packageReg.string("Publisher", value))
-                {
-                    vendor = value;
-                }
+    return packageJson;
+}
 
-                if (packageReg.string("InstallDate", value))
-                {
-                    install_time = value;
-                }
-                else
-                {
-                    install_time = packageReg.keyModificationDate();
-                }
+static void getPackagesFromReg(const HKEY key, const std::string& subKey, std::function<void(nlohmann::json&)> returnCallback, const REGSAM access = 0)
+{
+    static std::mutex s_mutex;
+    static std::map<std::string, RegistryPackagesCache> s_caches;
+    const auto cacheId { std::to_string(reinterpret_cast<uintptr_t>(key)) + "\\" + subKey + "\\" + std::to_string(access) };
+    RegistryPackagesCache previous;
+    RegistryPackagesCache current;
 
-                if (packageReg.string("InstallLocation", value))
-                {
-                    location = value;
-                }
+    {
+        // The sources run concurrently, each one takes its cache while it is enumerated.
+        std::lock_guard<std::mutex> lock{s_mutex};
+        const auto it { s_caches.find(cacheId) };
 
-                if (!name.empty())
-                {
-                    if (access & KEY_WOW64_32KEY)
-                    {
-                        architecture = "i686";
-                    }
-                    else if (access & KEY_WOW64_64KEY)
-                    {
-                        architecture = "x86_64";
-                    }
-                    else
-                    {
-                        architecture = UNKNOWN_VALUE;
-                    }
+        if (it != s_caches.end())
+        {
+            previous = std::move(it->second);
+            s_caches.erase(it);
+        }
+    }
 
-                    packageJson["name"]         = std::move(name);
-                    packageJson["version"]      = std::move(version);
-                    packageJson["vendor"]       = std::move(vendor);
-                    packageJson["install_time"] = std::move(install_time);
-                    packageJson["location"]     = std::move(location);
-                    packageJson["architecture"] = std::move(architecture);
-                    packageJson["format"]       = "win";
+    try
+    {
+        const auto callback
+        {
+            [&](const std::string & package, const ULONGLONG lastWriteTime)
+            {
+                const auto it { previous.find(package) };
+                auto packageJson = it != previous.end() && it->second.lastWriteTime == lastWriteTime
+                                   ? std::move(it->second.package)
+                                   : getPackageFromReg(key, subKey, package, access);
 
-                    returnCallback(packageJson);
+                if (!packageJson.empty())
+                {
+                    auto packageInfo = packageJson;
+                    returnCallback(packageInfo);
                 }
+
+                current[package] = RegistryPackageCacheEntry{lastWriteTime, std::move(packageJson)};
             }
         };
         Utils::Registry root{key, subKey, access | KEY_ENUMERATE_SUB_KEYS | KEY_READ};
-        root.enumerate(callback);
+        root.enumerateWithLastWriteTime(callback);
     }
     catch (...)
     {
     }
+
+    std::lock_guard<std::mutex> lock{s_mutex};
+    s_caches[cacheId] = std::move(current);
 }
 
 static void getStorePackages(const HKEY key, const std::string& user, std::function<void(nlohmann::json&)> returnCallback)
@@ -772,21 +821,73 @@ void SysInfo::getPackages(std::function<void(nlohmann::json&)> callback) const
         }
     };
 
-    getPackagesFromReg(HKEY_LOCAL_MACHINE, UNINSTALL_REGISTRY, fillList, KEY_WOW64_64KEY);
-    getPackagesFromReg(HKEY_LOCAL_MACHINE, UNINSTALL_REGISTRY, fillList, KEY_WOW64_32KEY);
+    PackageSources sources;
 
-    for (const auto& user : Utils::Registry{HKEY_USERS, "", KEY_READ | KEY_ENUMERATE_SUB_KEYS}.enumerate())
+    sources.add("registry_x64", [](PackagesCallback sourceCallback)
+    {
+        getPackagesFromReg(HKEY_LOCAL_MACHINE, UNINSTALL_REGISTRY, sourceCallback, KEY_WOW64_64KEY);
+    });
+    sources.add("registry_x86", [](PackagesCallback sourceCallback)
+    {
+        getPackagesFromReg(HKEY_LOCAL_MACHINE, UNINSTALL_REGISTRY, sourceCallback, KEY_WOW64_32KEY);
+    });
+    sources.add("users", [](PackagesCallback sourceCallback)
     {
-        getPackagesFromReg(HKEY_USERS, user + "\\" + UNINSTALL_REGISTRY, fillList);
-        getStorePackages(HKEY_USERS, user, fillList);
+        for (const auto& user : Utils::Registry{HKEY_USERS, "", KEY_READ | KEY_ENUMERATE_SUB_KEYS}.enumerate())
+        {
+            getPackagesFromReg(HKEY_USERS, user + "\\" + UNINSTALL_REGISTRY, sourceCallback);
+            getStorePackages(HKEY_USERS, user, sourceCallback);
+        }
+    });
+
+    sources.run(fillList);
+}
+
+// The hotfixes of these keys come from their subkey names, so they only change when a subkey is
+// added or removed, which updates the key's last write time.
+static void getCachedHotfixes(const std::string& subKey,
+                              const std::function<void(const HKEY, const std::string&, std::set<std::string>&)>& read,
+                              std::set<std::string>& hotfixes)
+{
+    static std::mutex s_mutex;
+    static std::map<std::string, std::pair<ULONGLONG, std::set<std::string>>> s_cache;
+    ULONGLONG lastWriteTime { 0 };
+    auto known { false };
+
+    try
+    {
+        known = Utils::Registry{HKEY_LOCAL_MACHINE, subKey, KEY_WOW64_64KEY | KEY_READ}.lastWriteTime(lastWriteTime);
+    }
+    catch (...)
+    {
+    }
+
+    std::lock_guard<std::mutex> lock{s_mutex};
+    const auto it { s_cache.find(subKey) };
+
+    if (known && it != s_cache.end() && it->second.first == lastWriteTime)
+    {
+        hotfixes.insert(it->second.second.begin(), it->second.second.end());
+    }
+    else
+    {
+        std::set<std::string> keyHotfixes;
+        read(HKEY_LOCAL_MACHINE, subKey, keyHotfixes);
+        hotfixes.insert(keyHotfixes.begin(), keyHotfixes.end());
+
+        if (known)
+        {
+            s_cache[subKey] = std::make_pair(lastWriteTime, std::move(keyHotfixes));
+        }
     }
 }
 
 nlohmann::json SysInfo::getHotfixes() const
 {
     std::set<std::string> hotfixes;
-    PackageWindowsHelper::getHotFixFromReg(HKEY_LOCAL_MACHINE, PackageWindowsHelper::WIN_REG_HOTFIX, hotfixes);
-    PackageWindowsHelper::getHotFixFromRegNT(HKEY_LOCAL_MACHINE, PackageWindowsHelper::VISTA_REG_HOTFIX, hotfixes);
+    getCachedHotfixes(PackageWindowsHelper::WIN_REG_HOTFIX, PackageWindowsHelper::getHotFixFromReg, hotfixes);
+    getCachedHotfixes(PackageWindowsHelper::VISTA_REG_HOTFIX, PackageWindowsHelper::getHotFixFromRegNT, hotfixes);
+    // Their hotfixes are in nested subkeys, which don't update the key's last write time.
     PackageWindowsHelper::getHotFixFromRegWOW(HKEY_LOCAL_MACHINE, PackageWindowsHelper::WIN_REG_WOW_HOTFIX, hotfixes);
     PackageWindowsHelper::getHotFixFromRegProduct(HKEY_LOCAL_MACHINE, PackageWindowsHelper::WIN_REG_PRODUCT_HOTFIX, hotfixes);
 
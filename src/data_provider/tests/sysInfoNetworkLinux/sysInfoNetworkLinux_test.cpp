@@ -9,8 +9,10 @@
  * Foundation.
  */
 #include <ifaddrs.h>
+#include <arpa/inet.h>
 #include "sysInfoNetworkLinux_test.h"
 #include "network/networkInterfaceLinux.h"
+#include "network/networkLinuxWrapper.h"
 #include "network/networkFamilyDataAFactory.h"
 
 void SysInfoNetworkLinuxTest::SetUp() {};
@@ -184,3 +186,171 @@ TEST_F(SysInfoNetworkLinuxTest, Test_Gateway_7546)
     EXPECT_EQ(1500, ifaddr.at("mtu").get<int32_t>());
     EXPECT_EQ("A12BA8C0", ifaddr.at("gateway").get_ref<const std::string&>());
 }
+
+// Builds a rtnetlink message with its attributes, as the kernel answers a dump.
+class NetlinkMessageBuilder final
+{
+        std::vector<nlmsghdr> m_buffer;
+        nlmsghdr* m_header;
+
+    public:
+        template <class T>
+        NetlinkMessageBuilder(const uint16_t type, const T& payload)
+            : m_buffer(4096 / sizeof(nlmsghdr))
+            , m_header { m_buffer.data() }
+        {
+            m_header->nlmsg_type = type;
+            m_header->nlmsg_len = NLMSG_LENGTH(sizeof(T));
+            std::memcpy(NLMSG_DATA(m_header), &payload, sizeof(T));
+        }
+
+        NetlinkMessageBuilder& attribute(const uint16_t type, const void* data, const size_t size)
+        {
+            auto attr { reinterpret_cast<rtattr*>(reinterpret_cast<char*>(m_header) + NLMSG_ALIGN(m_header->nlmsg_len)) };
+            attr->rta_type = type;
+            attr->rta_len = RTA_LENGTH(size);
+            std::memcpy(RTA_DATA(attr), data, size);
+            m_header->nlmsg_len = NLMSG_ALIGN(m_header->nlmsg_len) + RTA_ALIGN(attr->rta_len);
+            return *this;
+        }
+
+        const nlmsghdr* header() const
+        {
+            return m_header;
+        }
+};
+
+TEST_F(SysInfoNetworkLinuxTest, Netlink_Link)
+{
+    NetworkLinuxNetlink netlink;
+    ifinfomsg info {};
+    info.ifi_index = 3;
+    info.ifi_type = ARPHRD_ETHER;
+    const uint32_t mtu { 1500 };
+    const unsigned char mac[] { 0x00, 0xa0, 0xc9, 0x14, 0xc8, 0x29 };
+    const uint8_t operState { 6 };
+    rtnl_link_stats64 stats {};
+    stats.rx_packets = 10;
+    stats.tx_packets = 11;
+    stats.rx_bytes = 12;
+    stats.tx_bytes = 13;
+    stats.rx_errors = 14;
+    stats.tx_errors = 15;
+    stats.rx_dropped = 16;
+    stats.tx_dropped = 17;
+    stats.rx_missed_errors = 2;
+
+    netlink.addLink(NetlinkMessageBuilder(RTM_NEWLINK, info)
+                    .attribute(IFLA_IFNAME, "eth01", sizeof("eth01"))
+                    .attribute(IFLA_MTU, &mtu, sizeof(mtu))
+                    .attribute(IFLA_ADDRESS, mac, sizeof(mac))
+                    .attribute(IFLA_OPERSTATE, &operState, sizeof(operState))
+                    .attribute(IFLA_STATS64, &stats, sizeof(stats))
+                    .header());
+
+    const auto link { netlink.link("eth01") };
+    ASSERT_NE(nullptr, link);
+    EXPECT_EQ(nullptr, netlink.link("eth02"));
+    EXPECT_EQ(ARPHRD_ETHER, link->type);
+    EXPECT_EQ(1500u, link->mtu);
+    EXPECT_EQ("00:a0:c9:14:c8:29", link->MAC);
+    EXPECT_EQ("up", link->state);
+    EXPECT_EQ(10u, link->stats.rxPackets);
+    EXPECT_EQ(11u, link->stats.txPackets);
+    EXPECT_EQ(12u, link->stats.rxBytes);
+    EXPECT_EQ(13u, link->stats.txBytes);
+    EXPECT_EQ(14u, link->stats.rxErrors);
+    EXPECT_EQ(15u, link->stats.txErrors);
+    // /proc/net/dev adds the missed packets to the dropped ones.
+    EXPECT_EQ(18u, link->stats.rxDropped);
+    EXPECT_EQ(17u, link->stats.txDropped);
+    EXPECT_EQ(UNKNOWN_VALUE, link->gateway);
+}
+
+TEST_F(SysInfoNetworkLinuxTest, Netlink_Gateway)
+{
+    NetworkLinuxNetlink netlink;
+    ifinfomsg info {};
+    info.ifi_index = 3;
+    netlink.addLink(NetlinkMessageBuilder(RTM_NEWLINK, info).attribute(IFLA_IFNAME, "eth01", sizeof("eth01")).header());
+
+    const int oif { 3 };
+    const uint32_t localTable { RT_TABLE_LOCAL };
+    const uint32_t priority { 100 };
+    in_addr gateway {};
+    rtmsg route {};
+    route.rtm_family = AF_INET;
+    route.rtm_table = RT_TABLE_MAIN;
+
+    // Routes of other tables are ignored.
+    inet_pton(AF_INET, "10.0.0.1", &gateway);
+    netlink.addRoute(NetlinkMessageBuilder(RTM_NEWROUTE, route)
+                     .attribute(RTA_TABLE, &localTable, sizeof(localTable))
+                     .attribute(RTA_OIF, &oif, sizeof(oif))
+                     .attribute(RTA_GATEWAY, &gateway, sizeof(gateway))
+                     .header());
+    EXPECT_EQ(UNKNOWN_VALUE, netlink.link("eth01")->gateway);
+
+    // A route without gateway only sets the metric.
+    netlink.addRoute(NetlinkMessageBuilder(RTM_NEWROUTE, route).attribute(RTA_OIF, &oif, sizeof(oif)).header());
+    EXPECT_EQ(UNKNOWN_VALUE, netlink.link("eth01")->gateway);
+    EXPECT_EQ("0", netlink.link("eth01")->metrics);
+
+    inet_pton(AF_INET, "10.2.2.50", &gateway);
+    netlink.addRoute(NetlinkMessageBuilder(RTM_NEWROUTE, route)
+                     .attribute(RTA_OIF, &oif, sizeof(oif))
+                     .attribute(RTA_PRIORITY, &priority, sizeof(priority))
+                     .attribute(RTA_GATEWAY, &gateway, sizeof(gateway))
+                     .header());
+
+    // The first gateway is kept.
+    inet_pton(AF_INET, "10.2.2.51", &gateway);
+    netlink.addRoute(NetlinkMessageBuilder(RTM_NEWROUTE, route)
+                     .attribute(RTA_OIF, &oif, sizeof(oif))
+                     .attribute(RTA_GATEWAY, &gateway, sizeof(gateway))
+                     .header());
+
+    EXPECT_EQ("10.2.2.50", netlink.link("eth01")->gateway);
+    EXPECT_EQ("100", netlink.link("eth01")->metrics);
+}
+
+TEST_F(SysInfoNetworkLinuxTest, Netlink_Wrapper)
+{
+    auto netlink { std::make_shared<NetworkLinuxNetlink>() };
+    ifinfomsg info {};
+    info.ifi_index = 3;
+    info.ifi_type = ARPHRD_LOOPBACK;
+    const uint32_t mtu { 65536 };
+    const uint8_t operState { 2 };
+    netlink->addLink(NetlinkMessageBuilder(RTM_NEWLINK, info)
+                     .attribute(IFLA_IFNAME, "eth01", sizeof("eth01"))
+                     .attribute(IFLA_MTU, &mtu, sizeof(mtu))
+                     .attribute(IFLA_OPERSTATE, &operState, sizeof(operState))
+                     .header());
+
+    char name[] { "eth01:1" };
+    ifaddrs address {};
+    address.ifa_name = name;
+    const NetworkLinuxInterface wrapper { &address, netlink };
+
+    EXPECT_EQ("eth01", wrapper.name());
+    EXPECT_EQ(AF_PACKET, wrapper.family());
+    EXPECT_EQ(65536u, wrapper.mtu());
+    EXPECT_EQ("down", wrapper.state());
+    EXPECT_EQ("", wrapper.MAC());
+    EXPECT_EQ(UNKNOWN_VALUE, wrapper.gateway());
+}
+
+TEST_F(SysInfoNetworkLinuxTest, Netlink_Dump)
+{
+    NetworkLinuxNetlink netlink;
+
+    // Hosts that refuse the dump fall back to sysfs and /proc/net.
+    if (netlink.dump())
+    {
+        const auto loopback { netlink.link("lo") };
+        ASSERT_NE(nullptr, loopback);
+        EXPECT_EQ(ARPHRD_LOOPBACK, loopback->type);
+        EXPECT_NE(0u, loopback->mtu);
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include "sysInfoPackageLinuxParserDeb_test.hpp"
+#include "packages/packageLinuxDataRetriever.h"
+#include <fstream>
+#include <cstdio>
+
+constexpr auto TEST_STATUS_FILE {"test_dpkg_status"};
+
+constexpr auto TEST_STATUS_CONTENT
+{
+    "Package: zlib1g-dev\n"
+    "Status: install ok installed\n"
+    "Priority: optional\n"
+    "Section: libdevel\n"
+    "Installed-Size: 591\n"
+    "Maintainer: Ubuntu Developers <ubuntu-devel-discuss@lists.ubuntu.com>\n"
+    "Architecture: amd64\n"
+    "Multi-Arch: same\n"
+    "Source: zlib\n"
+    "Version: 1:1.2.11.dfsg-2ubuntu1.2\n"
+    "Depends: zlib1g (= 1:1.2.11.dfsg-2ubuntu1.2), libc6-dev | libc-dev\n"
+    "Description: compression library - development\n"
+    " zlib is a library implementing the deflate compression method found\n"
+    " in gzip and PKZIP.  This package includes the development support\n"
+    " files.\n"
+    "\n"
+    "Package: removed-package\n"
+    "Status: deinstall ok config-files\n"
+    "Version: 1.0\n"
+    "\n"
+    "Package: bash\n"
+    "Status: install ok installed\n"
+    "Installed-Size: 1864\n"
+    "Version: 5.0-6ubuntu1.2\n"
+    "Description: GNU Bourne Again SHell\n"
+};
+
+void SysInfoPackagesLinuxParserDebTest::SetUp()
+{
+    std::ofstream file{TEST_STATUS_FILE};
+    file << TEST_STATUS_CONTENT;
+};
+
+void SysInfoPackagesLinuxParserDebTest::TearDown()
+{
+    std::remove(TEST_STATUS_FILE);
+};
+
+static std::vector<nlohmann::json> getPackages(const std::string& fileName)
+{
+    std::vector<nlohmann::json> packages;
+    getDpkgInfo(fileName, [&packages](nlohmann::json & data)
+    {
+        packages.push_back(data);
+    });
+    return packages;
+}
+
+TEST_F(SysInfoPackagesLinuxParserDebTest, installedPackages)
+{
+    const auto packages = getPackages(TEST_STATUS_FILE);
+
+    ASSERT_EQ(2u, packages.size());
+    EXPECT_EQ("zlib1g-dev", packages[0]["name"]);
+    EXPECT_EQ("optional", packages[0]["priority"]);
+    EXPECT_EQ(591, packages[0]["size"]);
+    EXPECT_EQ("libdevel", packages[0]["groups"]);
+    EXPECT_EQ("same", packages[0]["multiarch"]);
+    EXPECT_EQ("1:1.2.11.dfsg-2ubuntu1.2", packages[0]["version"]);
+    EXPECT_EQ("amd64", packages[0]["architecture"]);
+    EXPECT_EQ("deb", packages[0]["format"]);
+    EXPECT_EQ("Ubuntu Developers <ubuntu-devel-discuss@lists.ubuntu.com>", packages[0]["vendor"]);
+    EXPECT_EQ("compression library - development", packages[0]["description"]);
+    EXPECT_EQ("zlib", packages[0]["source"]);
+
+    EXPECT_EQ("bash", packages[1]["name"]);
+    EXPECT_EQ(1864, packages[1]["size"]);
+    EXPECT_EQ("", packages[1]["source"]);
+    EXPECT_EQ("GNU Bourne Again SHell", packages[1]["description"]);
+}
+
+TEST_F(SysInfoPackagesLinuxParserDebTest, unchangedFileIsNotParsedAgain)
+{
+    const auto first = getPackages(TEST_STATUS_FILE);
+    const auto second = getPackages(TEST_STATUS_FILE);
+
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(SysInfoPackagesLinuxParserDebTest, changedFileIsParsedAgain)
+{
+    EXPECT_EQ(2u, getPackages(TEST_STATUS_FILE).size());
+
+    {
+        std::ofstream file{TEST_STATUS_FILE, std::ios_base::app};
+        file << "\nPackage: curl\nStatus: install ok installed\nVersion: 7.68.0-1ubuntu2.18\n";
+    }
+
+    const auto packages = getPackages(TEST_STATUS_FILE);
+    ASSERT_EQ(3u, packages.size());
+    EXPECT_EQ("curl", packages[2]["name"]);
+}
+
+TEST_F(SysInfoPackagesLinuxParserDebTest, missingFile)
+{
+    EXPECT_TRUE(getPackages("missing_dpkg_status").empty());
+}
@@ -25,6 +25,9 @@ using ::testing::DoAll;
 using ::testing::SetArgPointee;
 using ::testing::AnyNumber;
 
+// No sqlite or ndb database, librpm is used.
+constexpr auto TEST_RPM_PATH {"missing_rpm_path/"};
+
 class UtilsMock
 {
     public:
@@ -333,7 +336,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFromBerkleyDB)
 
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & packageInfo)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & packageInfo)
     {
         wrapper.callbackMock(packageInfo);
     });
@@ -389,7 +392,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFromLibRPM)
 
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -415,7 +418,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFallbackFromLibRPM)
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
     EXPECT_CALL(wrapper, callbackMock(expectedPackage2)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -442,7 +445,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFallbackFromBerkleyDBConfigError)
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
     EXPECT_CALL(wrapper, callbackMock(expectedPackage2)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -478,7 +481,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFallbackFromBerkleyDBOpenError)
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
     EXPECT_CALL(wrapper, callbackMock(expectedPackage2)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -516,7 +519,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, rpmFallbackFromBerkleyDBCursorError)
     EXPECT_CALL(wrapper, callbackMock(expectedPackage1)).Times(1);
     EXPECT_CALL(wrapper, callbackMock(expectedPackage2)).Times(1);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -538,7 +541,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, emptyRpmFallback)
     EXPECT_CALL(*utils_mock, exec(_, _)).Times(1).WillOnce(Return(""));
     EXPECT_CALL(wrapper, callbackMock(_)).Times(0);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
@@ -560,7 +563,7 @@ TEST(SysInfoPackageLinuxParserRPM_test, invalidPackageParsingRpmFallback)
     EXPECT_CALL(*utils_mock, exec(_, _)).Times(1).WillOnce(Return("this is not a valid rpm -qa output"));
     EXPECT_CALL(wrapper, callbackMock(_)).Times(0);
 
-    getRpmInfo([&wrapper](nlohmann::json & data)
+    getRpmInfo(TEST_RPM_PATH, [&wrapper](nlohmann::json & data)
     {
         wrapper.callbackMock(data);
     });
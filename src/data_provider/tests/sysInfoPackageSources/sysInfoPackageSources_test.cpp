@@ -0,0 +1,100 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#include <thread>
+#include "sysInfoPackageSources_test.h"
+#include "packages/packageSourcesHelper.h"
+
+void SysInfoPackageSourcesTest::SetUp() {};
+
+void SysInfoPackageSourcesTest::TearDown()
+{
+};
+
+static std::function<void(PackagesCallback)> fakeSource(const nlohmann::json& packages, const std::chrono::milliseconds& delay)
+{
+    return [packages, delay](PackagesCallback callback)
+    {
+        std::this_thread::sleep_for(delay);
+
+        for (auto package : packages)
+        {
+            callback(package);
+        }
+    };
+}
+
+TEST_F(SysInfoPackageSourcesTest, packagesInSourceOrder)
+{
+    PackageSources sources;
+    std::vector<std::string> names;
+    // The slowest source is still reported first.
+    sources.add("first", fakeSource(R"([{"name":"a","version":"1","architecture":"amd64","format":"deb"}])"_json, std::chrono::milliseconds{50}));
+    sources.add("second", fakeSource(R"([{"name":"b","version":"1","architecture":"amd64","format":"rpm"},
+                                         {"name":"c","version":"2","architecture":"amd64","format":"rpm"}])"_json, std::chrono::milliseconds{0}));
+
+    sources.run([&names](nlohmann::json & package)
+    {
+        names.push_back(package.at("name"));
+    });
+
+    EXPECT_EQ(names, (std::vector<std::string> {"a", "b", "c"}));
+}
+
+TEST_F(SysInfoPackageSourcesTest, duplicatedPackagesFromFirstSource)
+{
+    PackageSources sources;
+    nlohmann::json reported = nlohmann::json::array();
+    sources.add("dpkg", fakeSource(R"([{"name":"a","version":"1","architecture":"amd64","format":"deb"}])"_json, std::chrono::milliseconds{0}));
+    sources.add("rpm", fakeSource(R"([{"name":"a","version":"1","architecture":"amd64","format":"rpm"},
+                                      {"name":"a","version":"1","architecture":"i386","format":"rpm"}])"_json, std::chrono::milliseconds{0}));
+
+    sources.run([&reported](nlohmann::json & package)
+    {
+        reported.push_back(package);
+    });
+
+    ASSERT_EQ(reported.size(), 2ull);
+    EXPECT_EQ(reported[0].at("format"), "deb");
+    EXPECT_EQ(reported[1].at("architecture"), "i386");
+}
+
+TEST_F(SysInfoPackageSourcesTest, lastRunTimes)
+{
+    PackageSources sources;
+    sources.add("dpkg", fakeSource(R"([{"name":"a","version":"1","architecture":"amd64"}])"_json, std::chrono::milliseconds{20}));
+    sources.run([](nlohmann::json&) {});
+
+    const auto lastRun = PackageSources::lastRun();
+    ASSERT_EQ(lastRun.size(), 1ull);
+    EXPECT_EQ(lastRun[0].at("source"), "dpkg");
+    EXPECT_EQ(lastRun[0].at("packages"), 1);
+    EXPECT_GE(lastRun[0].at("elapsed_ms").get<long long>(), 20);
+}
+
+TEST_F(SysInfoPackageSourcesTest, failedSourceAfterPreviousOnes)
+{
+    PackageSources sources;
+    std::vector<std::string> names;
+    sources.add("dpkg", fakeSource(R"([{"name":"a","version":"1","architecture":"amd64"}])"_json, std::chrono::milliseconds{0}));
+    sources.add("pacman", [](PackagesCallback)
+    {
+        throw std::runtime_error {"alpm_initialize failure"};
+    });
+    sources.add("rpm", fakeSource(R"([{"name":"b","version":"1","architecture":"amd64"}])"_json, std::chrono::milliseconds{0}));
+
+    EXPECT_THROW(sources.run([&names](nlohmann::json & package)
+    {
+        names.push_back(package.at("name"));
+    }), std::runtime_error);
+
+    EXPECT_EQ(names, (std::vector<std::string> {"a"}));
+    EXPECT_EQ(PackageSources::lastRun().size(), 3ull);
+}
@@ -0,0 +1,105 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#include <arpa/inet.h>
+#include "sysInfoPortsLinux_test.h"
+#include <map>
+#include <algorithm>
+#include "stringHelper.h"
+#include "networkHelper.h"
+#include "ports/portImpl.h"
+#include "ports/portLinuxDiagWrapper.h"
+
+void SysInfoPortsLinuxTest::SetUp() {};
+
+void SysInfoPortsLinuxTest::TearDown()
+{
+};
+
+TEST_F(SysInfoPortsLinuxTest, tcpListeningSocket)
+{
+    inet_diag_msg message {};
+    message.idiag_family = AF_INET;
+    message.idiag_state = TCP_LISTEN;
+    message.idiag_rqueue = 2;
+    message.idiag_wqueue = 128;
+    message.idiag_inode = 12345;
+    message.id.idiag_sport = htons(1514);
+    message.id.idiag_src[0] = htonl(INADDR_LOOPBACK);
+    nlohmann::json port {};
+
+    EXPECT_NO_THROW(std::make_unique<PortImpl>(std::make_shared<LinuxPortDiagWrapper>(TCP_IPV4, message))->buildPortData(port));
+    EXPECT_EQ("tcp", port.at("protocol").get_ref<const std::string&>());
+    EXPECT_EQ("127.0.0.1", port.at("local_ip").get_ref<const std::string&>());
+    EXPECT_EQ(1514, port.at("local_port").get<int32_t>());
+    EXPECT_EQ("0.0.0.0", port.at("remote_ip").get_ref<const std::string&>());
+    EXPECT_EQ(0, port.at("remote_port").get<int32_t>());
+    // The maximum backlog is not reported as the transmit queue.
+    EXPECT_EQ(0, port.at("tx_queue").get<int32_t>());
+    EXPECT_EQ(2, port.at("rx_queue").get<int32_t>());
+    EXPECT_EQ(12345, port.at("inode").get<int64_t>());
+    EXPECT_EQ("listening", port.at("state").get_ref<const std::string&>());
+}
+
+TEST_F(SysInfoPortsLinuxTest, udp6Socket)
+{
+    inet_diag_msg message {};
+    message.idiag_family = AF_INET6;
+    message.idiag_state = TCP_CLOSE;
+    message.idiag_rqueue = 3;
+    message.idiag_wqueue = 4;
+    message.idiag_inode = 54321;
+    message.id.idiag_sport = htons(53);
+    message.id.idiag_dport = htons(4000);
+    inet_pton(AF_INET6, "fe80::1", message.id.idiag_src);
+    inet_pton(AF_INET6, "2001:db8::2", message.id.idiag_dst);
+    nlohmann::json port {};
+
+    EXPECT_NO_THROW(std::make_unique<PortImpl>(std::make_shared<LinuxPortDiagWrapper>(UDP_IPV6, message))->buildPortData(port));
+    EXPECT_EQ("udp6", port.at("protocol").get_ref<const std::string&>());
+    EXPECT_EQ("fe80::1", port.at("local_ip").get_ref<const std::string&>());
+    EXPECT_EQ(53, port.at("local_port").get<int32_t>());
+    EXPECT_EQ("2001:db8::2", port.at("remote_ip").get_ref<const std::string&>());
+    EXPECT_EQ(4000, port.at("remote_port").get<int32_t>());
+    EXPECT_EQ(4, port.at("tx_queue").get<int32_t>());
+    EXPECT_EQ(3, port.at("rx_queue").get<int32_t>());
+    EXPECT_EQ(54321, port.at("inode").get<int64_t>());
+    EXPECT_TRUE(port.at("state").get_ref<const std::string&>().empty());
+}
+
+TEST_F(SysInfoPortsLinuxTest, getListeningSocket)
+{
+    const auto fd { socket(AF_INET, SOCK_STREAM, 0) };
+    ASSERT_GE(fd, 0);
+
+    sockaddr_in address {};
+    socklen_t length { sizeof(address) };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    ASSERT_EQ(0, listen(fd, 1));
+    ASSERT_EQ(0, getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length));
+
+    auto found { false };
+    const auto ret
+    {
+        LinuxPortDiagWrapper::getSockets(TCP_IPV4, SOCK_DIAG_ALL_STATES, [&](const inet_diag_msg & message)
+        {
+            found |= message.id.idiag_sport == address.sin_port && message.idiag_state == TCP_LISTEN;
+        })
+    };
+    close(fd);
+
+    // Kernels without NETLINK_SOCK_DIAG fall back to /proc/net.
+    if (ret)
+    {
+        EXPECT_TRUE(found);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#include "sysInfoProcessCacheLinux_test.h"
+#include "processes/processCacheLinux.h"
+
+void SysInfoProcessCacheLinuxTest::SetUp() {};
+
+void SysInfoProcessCacheLinuxTest::TearDown()
+{
+};
+
+static const std::array<int, 4> ROOT_IDS { 0, 0, 0, 0 };
+static const std::array<int, 4> USER_IDS { 1000, 1000, 1000, 1000 };
+
+static ProcessCacheEntry cacheEntry(const std::string& name, const std::array<int, 4>& ids, const std::string& cmd)
+{
+    return ProcessCacheEntry { name, ids, ids, cmd, "", "root", "root", "root", "root", "root", "root", "root" };
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, newProcess)
+{
+    ProcessCache cache;
+
+    EXPECT_EQ(nullptr, cache.find(10, 500, "sshd", ROOT_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, knownProcess)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("sshd", ROOT_IDS, "/usr/sbin/sshd"));
+    cache.commit();
+
+    const auto entry { cache.find(10, 500, "sshd", ROOT_IDS, ROOT_IDS) };
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ("/usr/sbin/sshd", entry->cmd);
+    cache.commit();
+
+    // Kept for the next scan
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_NE(nullptr, cache.find(10, 500, "sshd", ROOT_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, reusedPid)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("sshd", ROOT_IDS, "/usr/sbin/sshd"));
+    cache.commit();
+
+    // Same pid and name, but another process
+    EXPECT_EQ(nullptr, cache.find(10, 900, "sshd", ROOT_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, execProcess)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("bash", ROOT_IDS, "/bin/bash"));
+    cache.commit();
+
+    EXPECT_EQ(nullptr, cache.find(10, 500, "sleep", ROOT_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, credentialsChange)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("sshd", ROOT_IDS, "/usr/sbin/sshd"));
+    cache.commit();
+
+    EXPECT_EQ(nullptr, cache.find(10, 500, "sshd", USER_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, exitedProcess)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("sshd", ROOT_IDS, "/usr/sbin/sshd"));
+    cache.add(11, 600, cacheEntry("cron", ROOT_IDS, "/usr/sbin/cron"));
+    cache.commit();
+
+    // The next scan only finds the second one
+    EXPECT_NE(nullptr, cache.find(11, 600, "cron", ROOT_IDS, ROOT_IDS));
+    cache.commit();
+
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(nullptr, cache.find(10, 500, "sshd", ROOT_IDS, ROOT_IDS));
+}
+
+TEST_F(SysInfoProcessCacheLinuxTest, replacedEntry)
+{
+    ProcessCache cache;
+
+    cache.add(10, 500, cacheEntry("sshd", ROOT_IDS, "/usr/sbin/sshd"));
+    cache.commit();
+
+    // Read again after a credentials change
+    EXPECT_EQ(nullptr, cache.find(10, 500, "sshd", USER_IDS, USER_IDS));
+    cache.add(10, 500, cacheEntry("sshd", USER_IDS, "/usr/sbin/sshd -D"));
+    cache.commit();
+
+    const auto entry { cache.find(10, 500, "sshd", USER_IDS, USER_IDS) };
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ("/usr/sbin/sshd -D", entry->cmd);
+}
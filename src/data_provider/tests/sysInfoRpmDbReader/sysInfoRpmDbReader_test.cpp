@@ -0,0 +1,281 @@
+/*
+ * Wazuh SysInfo
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include "sysInfoRpmDbReader_test.hpp"
+#include "packages/rpmDbReader.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "sqlite3.h"
+
+constexpr auto TEST_RPMDB_PATH {"test_rpmdb/"};
+constexpr auto TEST_SQLITE_FILE {"test_rpmdb/rpmdb.sqlite"};
+constexpr auto TEST_NDB_FILE {"test_rpmdb/Packages.db"};
+
+struct TestHeaderEntry
+{
+    uint32_t tag;
+    uint32_t type;
+    std::string value;
+};
+
+static void appendUInt32(std::string& output, const uint32_t value, const bool bigEndian = true)
+{
+    for (auto i = 0; i < 4; ++i)
+    {
+        output += static_cast<char>(value >> (bigEndian ? 24 - i * 8 : i * 8));
+    }
+}
+
+static std::string int32Value(const uint32_t value)
+{
+    std::string ret;
+    appendUInt32(ret, value);
+    return ret;
+}
+
+static std::string stringValue(const std::string& value)
+{
+    return value + '\0';
+}
+
+static std::string buildHeader(const std::vector<TestHeaderEntry>& entries)
+{
+    std::string index;
+    std::string data;
+
+    for (const auto& entry : entries)
+    {
+        appendUInt32(index, entry.tag);
+        appendUInt32(index, entry.type);
+        appendUInt32(index, data.size());
+        appendUInt32(index, 1);
+        data += entry.value;
+    }
+
+    std::string blob;
+    appendUInt32(blob, entries.size());
+    appendUInt32(blob, data.size());
+    return blob + index + data;
+}
+
+static std::string packageHeader(const std::string& name, const std::string& version)
+{
+    return buildHeader(
+    {
+        {1000, 6, stringValue(name)},
+        {1001, 6, stringValue(version)},
+        {1002, 6, stringValue("6.el9")},
+        // i18n strings start with the untranslated one.
+        {1004, 9, stringValue("The GNU Bourne Again shell") + stringValue("La shell GNU Bourne Again")},
+        {1005, 9, stringValue("The GNU Bourne Again shell (Bash) is a shell.")},
+        {1008, 4, int32Value(1690000000)},
+        {1009, 4, int32Value(7738634)},
+        {1011, 6, stringValue("Red Hat, Inc.")},
+        {1016, 9, stringValue("Unspecified")},
+        {1022, 6, stringValue("x86_64")}
+    });
+}
+
+static std::vector<RpmPackageManager::Package> getPackages(const std::string& libPath, bool& result)
+{
+    std::vector<RpmPackageManager::Package> packages;
+    result = RpmDbReader::getPackages(libPath, [&packages](const RpmPackageManager::Package & package)
+    {
+        packages.push_back(package);
+    });
+    return packages;
+}
+
+static void createSqliteDatabase(const std::vector<std::string>& headers)
+{
+    sqlite3* db { nullptr };
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(TEST_SQLITE_FILE, &db));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS Packages (hnum INTEGER PRIMARY KEY AUTOINCREMENT, blob BLOB NOT NULL);", nullptr, nullptr, nullptr));
+
+    for (const auto& header : headers)
+    {
+        sqlite3_stmt* stmt { nullptr };
+        ASSERT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, "INSERT INTO Packages (blob) VALUES (?);", -1, &stmt, nullptr));
+        sqlite3_bind_blob(stmt, 1, header.data(), header.size(), SQLITE_TRANSIENT);
+        EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_close(db);
+}
+
+// Builds an ndb database with one slot page, each header goes to its package index.
+static void createNdbDatabase(const std::vector<std::pair<uint32_t, std::string>>& headers, const bool validSlots = true)
+{
+    constexpr auto PAGE_SIZE { 4096u };
+    std::string slots;
+    std::string blobs;
+
+    appendUInt32(slots, 'R' | 'p' << 8 | 'm' << 16 | 'P' << 24, false);
+    appendUInt32(slots, 0, false);
+    appendUInt32(slots, 1, false);
+    appendUInt32(slots, 1, false);
+    slots.resize(32);
+
+    for (const auto& header : headers)
+    {
+        std::string blob;
+        appendUInt32(blob, 'B' | 'l' << 8 | 'b' << 16 | 'S' << 24, false);
+        appendUInt32(blob, header.first, false);
+        appendUInt32(blob, 1, false);
+        appendUInt32(blob, header.second.size(), false);
+        blob += header.second;
+        blob.resize((blob.size() + 12 + 15) / 16 * 16);
+
+        appendUInt32(slots, validSlots ? 'S' | 'l' << 8 | 'o' << 16 | 't' << 24 : 0, false);
+        appendUInt32(slots, header.first, false);
+        appendUInt32(slots, (PAGE_SIZE + blobs.size()) / 16, false);
+        appendUInt32(slots, blob.size() / 16, false);
+        blobs += blob;
+    }
+
+    while (slots.size() < PAGE_SIZE)
+    {
+        // Free slots.
+        appendUInt32(slots, 'S' | 'l' << 8 | 'o' << 16 | 't' << 24, false);
+        appendUInt32(slots, 0, false);
+        appendUInt32(slots, 0, false);
+        appendUInt32(slots, 0, false);
+    }
+
+    std::ofstream file{TEST_NDB_FILE, std::ios_base::binary};
+    file << slots << blobs;
+}
+
+void SysInfoRpmDbReaderTest::SetUp()
+{
+    mkdir(TEST_RPMDB_PATH, 0700);
+};
+
+void SysInfoRpmDbReaderTest::TearDown()
+{
+    std::remove(TEST_SQLITE_FILE);
+    std::remove(TEST_NDB_FILE);
+    rmdir(TEST_RPMDB_PATH);
+};
+
+TEST_F(SysInfoRpmDbReaderTest, parseHeader)
+{
+    const auto header { packageHeader("bash", "5.1.8") };
+    RpmPackageManager::Package package;
+
+    ASSERT_TRUE(RpmDbReader::parseHeader(reinterpret_cast<const uint8_t*>(header.data()), header.size(), package));
+    EXPECT_EQ("bash", package.name);
+    EXPECT_EQ("5.1.8", package.version);
+    EXPECT_EQ("6.el9", package.release);
+    EXPECT_EQ(0u, package.epoch);
+    EXPECT_EQ("The GNU Bourne Again shell", package.summary);
+    EXPECT_EQ("The GNU Bourne Again shell (Bash) is a shell.", package.description);
+    EXPECT_EQ("1690000000", package.installTime);
+    EXPECT_EQ(7738634u, package.size);
+    EXPECT_EQ("Red Hat, Inc.", package.vendor);
+    EXPECT_EQ("Unspecified", package.group);
+    EXPECT_EQ("x86_64", package.architecture);
+    EXPECT_EQ("", package.source);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, parseHeaderLongSize)
+{
+    const auto header
+    {
+        buildHeader(
+        {
+            {1000, 6, stringValue("texlive")},
+            {1003, 4, int32Value(7)},
+            {5009, 5, int32Value(1) + int32Value(2)}
+        })
+    };
+    RpmPackageManager::Package package;
+
+    ASSERT_TRUE(RpmDbReader::parseHeader(reinterpret_cast<const uint8_t*>(header.data()), header.size(), package));
+    EXPECT_EQ("texlive", package.name);
+    EXPECT_EQ(7u, package.epoch);
+    EXPECT_EQ(0x100000002u, package.size);
+    EXPECT_EQ("0", package.installTime);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, invalidHeader)
+{
+    const auto header { packageHeader("bash", "5.1.8") };
+    const auto bytes { reinterpret_cast<const uint8_t*>(header.data()) };
+    const uint8_t empty[8] {};
+    RpmPackageManager::Package package;
+
+    EXPECT_FALSE(RpmDbReader::parseHeader(bytes, header.size() - 1, package));
+    EXPECT_FALSE(RpmDbReader::parseHeader(bytes, 4, package));
+    EXPECT_FALSE(RpmDbReader::parseHeader(empty, sizeof(empty), package));
+}
+
+TEST_F(SysInfoRpmDbReaderTest, sqliteDatabase)
+{
+    createSqliteDatabase({packageHeader("bash", "5.1.8"), packageHeader("curl", "7.76.1")});
+    auto result { false };
+    const auto packages { getPackages(TEST_RPMDB_PATH, result) };
+
+    EXPECT_TRUE(result);
+    ASSERT_EQ(2u, packages.size());
+    EXPECT_EQ("bash", packages[0].name);
+    EXPECT_EQ("curl", packages[1].name);
+    EXPECT_EQ("7.76.1", packages[1].version);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, changedSqliteDatabaseIsReadAgain)
+{
+    createSqliteDatabase({packageHeader("bash", "5.1.8")});
+    auto result { false };
+    EXPECT_EQ(1u, getPackages(TEST_RPMDB_PATH, result).size());
+    EXPECT_EQ(1u, getPackages(TEST_RPMDB_PATH, result).size());
+
+    createSqliteDatabase({packageHeader("curl", "7.76.1")});
+    const auto packages { getPackages(TEST_RPMDB_PATH, result) };
+
+    EXPECT_TRUE(result);
+    ASSERT_EQ(2u, packages.size());
+    EXPECT_EQ("curl", packages[1].name);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, ndbDatabase)
+{
+    createNdbDatabase({{2, packageHeader("curl", "7.76.1")}, {1, packageHeader("bash", "5.1.8")}});
+    auto result { false };
+    const auto packages { getPackages(TEST_RPMDB_PATH, result) };
+
+    EXPECT_TRUE(result);
+    ASSERT_EQ(2u, packages.size());
+    EXPECT_EQ("bash", packages[0].name);
+    EXPECT_EQ("curl", packages[1].name);
+    EXPECT_EQ("1690000000", packages[1].installTime);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, corruptedNdbDatabase)
+{
+    createNdbDatabase({{1, packageHeader("bash", "5.1.8")}}, false);
+    auto result { true };
+
+    EXPECT_TRUE(getPackages(TEST_RPMDB_PATH, result).empty());
+    EXPECT_FALSE(result);
+}
+
+TEST_F(SysInfoRpmDbReaderTest, missingDatabase)
+{
+    auto result { true };
+
+    EXPECT_TRUE(getPackages(TEST_RPMDB_PATH, result).empty());
+    EXPECT_FALSE(result);
+}
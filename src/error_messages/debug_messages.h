@@ -86,6 +86,8 @@
 #define VU_AGENT_FINISH       "(5471): Finished vulnerability assessment for agent '%.3d'"
 #define VU_END_SCAN           "(5472): Vulnerability scan finished."
 #define VU_HOTFIX_NOT_SYNCED  "(5473): Hotfixes data not synchronized in agent '%.3d' database."
+#define VU_NVD_PREFETCH       "(5474): Downloading the year '%d' of the NVD feed while the previous one is indexed."
+#define VU_NVD_PREFETCH_USED  "(5475): Using the prefetched year '%d' of the NVD feed."
 #define VU_NO_SRC_VERSION     "(5480): Unable to get the source '%s' version for agent '%.3d'"
 #define VU_NO_SRC_NAME        "(5481): Unable to get the source '%s' name for agent '%.3d'"
 #define VU_VULN_SEND_AG_FEED  "(5482): A total of '%d' vulnerabilities have been reported for agent '%.3d' thanks to the '%s' feed."
@@ -102,6 +104,10 @@
 #define VU_DEP_FLAG           "(5493): Dependency '%s' is installed on agent '%.3d': Version (%s) '%s' '%s'"
 #define VU_DEP_PRESCAN_START  "(5494): Starting SUSE dependency analysis for agent '%.3d'"
 #define VU_DEP_PRESCAN_FINISH "(5495): Finished SUSE dependency analysis for agent '%.3d'"
+#define VU_FEED_GROUP_TIME    "(5496): Scanned %d agents of the '%s' feed in %ld seconds (%.2f agents/s)."
+#define VU_MATCH_CACHE_HIT    "(5497): Agent '%.3d' has the same inventory as an agent already scanned. Reusing its vulnerable packages."
+#define VU_NVD_DELTA          "(5498): NVD feed (%d): %d CVEs inserted, %d updated, %d removed and %d unchanged."
+#define VU_AG_NO_CHANGES      "(5499): Agent '%.3d' has no inventory changes since the last scan. Skipping the partial scan."
 
 /* File integrity monitoring debug messages */
 #define FIM_DIFF_SKIPPED                    "(6200): Diff execution skipped for containing insecure characters."
@@ -276,6 +282,15 @@
 #define FIM_WHODATA_SUCCESS_POLICY          "(6369): Found Audit %s subcategory configured to success. GUID: %s"
 #define FIM_REGISTRY_LIMIT_VALUE            "(6370): Maximum number of registry values to be monitored: '%u'"
 #define FIM_REGISTRY_VALUES_ENTRIES_INFO    "(6371): Fim registry values entries count: '%d'"
+#define FIM_REALTIME_COALESCE_STATS         "(6372): Real-time events received: %u. Checks done: %u (%.2f events per check). Pending paths: %u."
+#define FIM_FANOTIFY_MARK                   "(6373): Unable to add fanotify mark for the filesystem of '%s' (%d): '%s'"
+#define FIM_FANOTIFY_NEW_FILESYSTEM         "(6374): Filesystem of '%s' added for real time monitoring."
+#define FIM_DIFF_CHUNKS_MANIFEST_INVALID    "(6375): Invalid chunk list '%s'. The stored version will be discarded."
+#define FIM_DIFF_CHUNK_MISSING              "(6376): Stored chunk '%s' is missing or damaged. The stored version will be discarded."
+#define FIM_DIFF_CHUNKS_COLLECTED           "(6377): Removed %u unused diff chunks (%.5f KB)."
+#define FIM_DB_STORAGE_INFO                 "(6378): Fim database size: '%llu' KB, cached in memory: '%llu' KB"
+#define FIM_REALTIME_BUFFER_SIZE            "(6379): Real time buffer for '%s' increased to %lu bytes."
+#define FIM_WHODATA_HANDLES_EXPIRED         "(6380): %u whodata handles without close event expired."
 
 /* Modules messages */
 #define WM_UPGRADE_RESULT_AGENT_INFO         "(8151): Agent Information obtained: '%s'"
@@ -296,6 +311,8 @@
 #define WM_UPGRADE_REQUEST_RECEIVE_MESSAGE   "(8166): Receiving message from agent: '%s'"
 #define WM_UPGRADE_UPGRADE_FILE_AGENT        "(8167): Upgrade result file has been successfully erased from the agent."
 #define WM_UPGRADE_TASK_SEND_CLUSTER_MESSAGE "(8168): Sending sendsync message to task manager in master node: '%s'"
+#define WM_UPGRADE_WPK_RESUME_TRANSFER       "(8169): WPK transfer to agent '%.3d' interrupted, resuming from offset %zu."
+#define WM_UPGRADE_WPK_SENT_TIMES            "(8170): WPK sent to agent '%.3d'. Open: %.3f s, write: %.3f s, close and SHA1: %.3f s, upgrade: %.3f s."
 
 #define MOD_TASK_START                      "(8200): Module Task Manager started."
 #define MOD_TASK_FINISH                     "(8201): Module Task Manager finished."
@@ -313,6 +330,7 @@
 /* Logcollector */
 
 #define LOGCOLLECTOR_FILE_NOT_EXIST           "(9000): File '%s' no longer exists."
+#define LOGCOLLECTOR_INOTIFY_WATCH            "(9003): Unable to watch file '%s' (%d): '%s'. The file will be polled."
 
 /* Analysisd */
 
@@ -319,6 +319,7 @@
 /* Syslog output */
 #define XML_INV_CSYSLOG    "(5301): Invalid client-syslog configuration."
 #define ERROR_SENDING_MSG  "(5302): Error sending message to '%s'."
+#define CSYSLOG_DROPPED    "(5303): Dropped %u buffered messages for '%s' (%lu since start)."
 
 /* Integrator daemon */
 #define XML_INV_INTEGRATOR "(5310): Invalid integratord configuration."
@@ -451,11 +452,13 @@
 #define FIM_ERROR_INOTIFY_INITIALIZE                "(6607): Unable to initialize inotify."
 #define FIM_ERROR_NFS_INOTIFY                       "(6608): '%s' NFS Directories do not support iNotify."
 #define FIM_ERROR_GENDIFF_COMMAND                   "(6609): Unable to run diff command '%s'"
-#define FIM_ERROR_REALTIME_WAITSINGLE_OBJECT        "(6610): WaitForSingleObjectEx failed (for real time file integrity monitoring)."
+#define FIM_ERROR_REALTIME_WAITSINGLE_OBJECT        "(6610): GetQueuedCompletionStatus failed (for real time file integrity monitoring)."
 #define FIM_ERROR_REALTIME_ADDDIR_FAILED            "(6611): 'realtime_adddir' failed, the directory '%s' couldn't be added to real time mode."
 #define FIM_ERROR_REALTIME_READ_BUFFER              "(6612): Unable to read from real time buffer."
 #define FIM_ERROR_REALTIME_WINDOWS_CALLBACK         "(6613): Real time Windows callback process: '%s' (%lx)."
 #define FIM_ERROR_REALTIME_WINDOWS_CALLBACK_EMPTY   "(6614): Real time call back called, but hash is empty."
+#define FIM_ERROR_REALTIME_PORT                     "(6615): Unable to create the real time completion port (%lu)."
+#define FIM_ERROR_WHODATA_SIGNAL                    "(6616): Unable to create the whodata signal event (%lu)."
 
 #define FIM_ERROR_AUDIT_MODE                        "(6617): Unable to get audit mode: %s (%d)."
 #define FIM_ERROR_REALTIME_INITIALIZE               "(6618): Unable to initialize real time file monitoring."
@@ -557,6 +560,7 @@
 #define FIM_ERROR_EXPAND_ENV_VAR                    "(6718): Could not expand the environment variable %s (%ld)."
 #endif
 #define FIM_ERROR_TRANSACTION                       "(6719): Could not start DBSync transaction (%s)"
+#define FIM_ERROR_SCAN_THREAD                       "(6720): Could not start a scan thread: %s. The scan continues with the started ones."
 
 /* Wazuh Logtest error messsages */
 #define LOGTEST_ERROR_BIND_SOCK                     "(7300): Unable to bind to socket '%s'. Errno: (%d) %s"
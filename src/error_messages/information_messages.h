@@ -64,6 +64,9 @@
 #define FIM_DISK_QUOTA_LIMIT_DISABLED       "(6043): Disk quota limit disabled."
 #define FIM_NO_DIFF_REGISTRY                "(6044): Option nodiff enabled for %s '%s'."
 #define FIM_AUDIT_CREATED_RULE_FILE         "(6045): Created audit rules file, due to audit immutable mode rules will be loaded in the next reboot."
+#define FIM_HASH_SCAN_SUMMARY               "(6046): Files hashed during the scan: %u. Files with unchanged metadata not hashed: %u."
+#define FIM_REALTIME_FANOTIFY               "(6047): Real-time monitoring uses fanotify filesystem marks."
+#define FIM_REGISTRY_SCAN_SUMMARY           "(6048): Registry keys whose values were read: %u. Unchanged keys whose stored values were reused: %u."
 
 /* wazuh-logtest information messages */
 #define LOGTEST_INITIALIZED                 "(7200): Logtest started"
@@ -77,5 +80,6 @@
 /* Logcollector info messages */
 #define LOGCOLLECTOR_INVALID_HANDLE_VALUE   "(9200): File '%s' can not be handled."
 #define LOGCOLLECTOR_ONLY_MACOS             "(9201): 'macos' log format is only supported on macOS."
+#define LOGCOLLECTOR_ONLY_JOURNALD          "(9202): 'journald' log format is only supported on Linux."
 
 #endif /* INFO_MESSAGES_H */
@@ -71,6 +71,10 @@
 #define FIM_WHODATA_POLICY_CHANGE_CHECKER       "(6952): Audit policy change detected. Switching directories to realtime."
 #define FIM_WHODATA_POLICY_CHANGE_CHANNEL       "(6953): Event 4719 received due to changes in audit policy. Switching directories to realtime."
 #define FIM_EMPTY_CHANGED_ATTRIBUTES            "(6954): Entry '%s' does not have any modified fields. No event will be generated."
+#define FIM_WARN_FANOTIFY_INITIALIZE            "(6955): Unable to initialize fanotify (%d): '%s'. Using inotify for real-time monitoring."
+#define FIM_WARN_FANOTIFY_UNSUPPORTED           "(6956): fanotify is not supported by this build. Using inotify for real-time monitoring."
+#define FIM_WARN_REALTIME_OVERFLOW_DIR          "(6957): Real time buffer overflow for '%s'. Scanning the directory again."
+#define FIM_WARN_WHODATA_EVENT_NEXT             "(6958): Unable to read the whodata events (%lu)."
 
 /* Monitord warning messages */
 #define ROTATE_LOG_LONG_PATH                    "(7500): The path of the rotated log is too long."
@@ -138,6 +142,11 @@
 #define LOGCOLLECTOR_MISSING_LOCATION_MACOS     "(8006): Missing 'location' element when using 'macos' as " \
                                                 "'log_format'. Default value will be used."
 #define LOGCOLLECTOR_DEFAULT_REGEX_TYPE         "(8007): Invalid type in '%s' regex '%s', setting by default PCRE2 regex."
+#define LOGCOLLECTOR_INOTIFY_INIT               "(8008): Unable to initialize inotify (%d): '%s'. Files will be polled."
+#define LOGCOLLECTOR_INV_JOURNALD               "(8009): Invalid location value '%s' when using 'journald' as " \
+                                                "'log_format'. Default value will be used."
+#define LOGCOLLECTOR_JOURNAL_LIB                "(8010): Unable to open the systemd journal: '%s'. It will not be read."
+#define LOGCOLLECTOR_JOURNAL_READ               "(8011): Unable to read the systemd journal (%d): '%s'."
 
 /* Remoted */
 #define REMOTED_NET_PROTOCOL_ERROR              "(9000): Error getting protocol. Default value (%s) will be used."
@@ -117,6 +117,17 @@ https://www.gnu.org/licenses/gpl.html\n"
 /* Default queue */
 #define DEFAULTQUEUE    "queue/sockets/queue"
 
+/* Queue of the additional analysisd instances, followed by the instance number */
+#define ANALYSISD_INSTANCE_QUEUE DEFAULTQUEUE "-%d"
+#define ANALYSISD_INSTANCES_MAX 16
+
+/* The additional instances send their alerts to the main one, which writes them in alerts.log and alerts.json.
+ * Each record starts with its type: a line of alerts.log or of alerts.json */
+#define ALERTS_FORWARD_SOCK "queue/sockets/alerts"
+#define ALERTS_FORWARD_MAXSIZE (OS_MAXSTR * 4)
+#define ALERTS_FORWARD_LOG  'L'
+#define ALERTS_FORWARD_JSON 'J'
+
 // Authd local socket
 #define AUTH_LOCAL_SOCK "queue/sockets/auth"
 
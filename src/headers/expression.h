@@ -14,6 +14,7 @@
 
 #include "external/libpcre2/include/pcre2.h"
 #include "os_regex/os_regex.h"
+#include "list_op.h"
 
 #define OSMATCH_STR  "osmatch"
 #define OSREGEX_STR  "osregex"
@@ -99,6 +100,8 @@ bool w_expression_compile(w_expression_t * expression, char * pattern, int flags
 
 /**
  * @brief Test match a compiled pattern to string
+ *
+ * PCRE2 patterns are matched with the match data and JIT stack of the calling thread.
  * @param expression expression with compiled pattern
  * @param str_test string to test
  * @param regex_match Structure to manage pattern matches. NULL is accepted
@@ -108,6 +111,31 @@ bool w_expression_compile(w_expression_t * expression, char * pattern, int flags
 bool w_expression_match(w_expression_t * expression, const char * str_test, const char ** end_match,
                         regex_matching * regex_match);
 
+/**
+ * @brief Test match a compiled pattern to string, without copying the OSRegex captures
+ *
+ * Same as w_expression_match, but an OSRegex expression leaves its captures as begin/end
+ * pairs into str_test in regex_match->spans, and regex_match->sub_strings empty.
+ * PCRE2 expressions still fill regex_match->sub_strings.
+ * @param expression expression with compiled pattern
+ * @param str_test string to test
+ * @param end_match if match, returns end of matched (Only PCRE2 & OSRegex). NULL is accepted
+ * @param regex_match Structure to manage pattern matches. NULL is accepted
+ * @return true if match. false otherwise
+ */
+bool w_expression_match_spans(w_expression_t * expression, const char * str_test, const char ** end_match,
+                              regex_matching * regex_match);
+
+/**
+ * @brief Combine the PCRE2 expressions of a list into a single alternation
+ *
+ * The result matches a string if any of the PCRE2 expressions of the list matches it.
+ * @param expressions list of w_expression_t
+ * @return JIT-compiled expression, or NULL if the list has less than two PCRE2
+ *         expressions or they can't be combined
+ */
+w_expression_t * w_expression_combine_pcre2(OSList * expressions);
+
 /**
  * @brief Fill a match_data with PCRE2 result
  * @param captured_groups number of matches of PCRE2 execute
@@ -26,6 +26,12 @@ typedef struct _file_queue {
 
     FILE *fp;
     struct stat f_status;
+
+    /* jqueue_wait() watch on the file, set up on first use */
+    int notify_ready;
+    int notify_fd;
+    int notify_wd;
+    ino_t notify_ino;
 } file_queue;
 
 #include "read-alert.h"
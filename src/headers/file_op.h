@@ -221,6 +221,19 @@ int MergeAppendFile(FILE *finalfp, const char *files, int path_offset) __attribu
 int UnmergeFiles(const char *finalpath, const char *optdir, int mode) __attribute__((nonnull(1)));
 
 
+/**
+ * @brief Unmerge file, writing only the members that differ from the files on disk.
+ *
+ * @param finalpath Path of the merged file.
+ * @param optdir Path of the folder to unmerge the files. If not specified, the files will be unmerged in the current working directory.
+ * @param mode Indicates if the merged file must be readed as a binary file  or not. Use `#OS_TEXT`, `#OS_BINARY`.
+ * @param[out] unmerged_files NULL-terminated array with the name of every member. It may be NULL.
+ * @param[out] changed_files NULL-terminated array with the name of the members written. It may be NULL.
+ * @return 1 if the file was unmerged, 0 on error.
+ */
+int UnmergeFiles_ex(const char *finalpath, const char *optdir, int mode, char ***unmerged_files, char ***changed_files) __attribute__((nonnull(1)));
+
+
 /**
  * @brief Check if the merged file is valid.
  *
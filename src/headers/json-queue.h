@@ -31,6 +31,18 @@ cJSON * jqueue_next(file_queue * queue);
 // Close queue
 void jqueue_close(file_queue * queue);
 
+/**
+ * @brief Wait until the alerts file is written, or up to a timeout
+ *
+ * Meant to be called when jqueue_next() returns no alert. Where inotify is
+ * available the file is watched so that new alerts are read right away,
+ * otherwise it sleeps the whole timeout.
+ *
+ * @param queue pointer to the file_queue struct
+ * @param timeout maximum time to wait, in seconds
+ */
+void jqueue_wait(file_queue * queue, unsigned int timeout);
+
 /**
  * @brief Read and validate a JSON alert from the file queue
  *
@@ -55,4 +55,48 @@ void json_strip(char * json);
  * */
 int* json_parse_agents(const cJSON* agents);
 
+/**
+ * @brief Install the cJSON hooks that serve the parse arenas.
+ *
+ * Call it once at startup, before creating the threads that parse JSON. Without it,
+ * json_arena_parse() allocates with malloc() like cJSON_ParseWithOpts().
+ */
+void json_arena_init();
+
+/**
+ * @brief Parse a JSON string into the arena of the calling thread.
+ *
+ * The tree may be modified and deleted as usual, cJSON_Delete() doesn't release its nodes.
+ * They are released at once by json_arena_reset(), so the tree and the pointers to its
+ * strings must not outlive the request, nor be deleted by another thread.
+ *
+ * @param string JSON string.
+ * @param end Set to the last parsed byte, or to the error position.
+ * @param require_null Fail if the string has data after the JSON value.
+ * @return Parsed tree, or NULL on error.
+ */
+cJSON * json_arena_parse(const char * string, const char ** end, cJSON_bool require_null);
+
+/**
+ * @brief Release the trees parsed by the calling thread.
+ *
+ * The first chunk of the arena is kept for the next request.
+ */
+void json_arena_reset();
+
+/**
+ * @brief Print a JSON tree unformatted into a buffer, after a prefix.
+ *
+ * The tree is printed in place with cJSON_PrintPreallocated(), so no print buffer is allocated.
+ * With the arena hooks installed, cJSON can't realloc() the buffers of cJSON_Print() and copies
+ * them every time they grow, and once more to return the string.
+ *
+ * @param buffer Output buffer.
+ * @param size Size of the buffer.
+ * @param prefix String written before the tree.
+ * @param item JSON tree.
+ * @return 0 on success, -1 if the output was truncated to size.
+ */
+int json_snprint(char * buffer, size_t size, const char * prefix, const cJSON * item);
+
 #endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * @file latency_op.h
+ * @brief Latency histograms for sampled events
+ */
+
+#ifndef LATENCY_OP_H
+#define LATENCY_OP_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define W_LATENCY_BUCKETS 24    ///< Bucket i counts the samples under 2^i microseconds, the last one the rest
+
+#define W_LATENCY_INITIALIZER { .mutex = PTHREAD_MUTEX_INITIALIZER }
+
+/**
+ * @brief Latency of a processing stage
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    uint64_t count;                         ///< Number of samples
+    uint64_t total;                         ///< Sum of the samples (microseconds)
+    uint64_t max;                           ///< Longest sample (microseconds)
+    uint64_t buckets[W_LATENCY_BUCKETS];    ///< Histogram in powers of two
+} w_latency_t;
+
+/**
+ * @brief Decide whether to trace the current event
+ *
+ * @param rate Trace one of each 'rate' events. 0 disables tracing
+ * @return true if the event must be traced
+ */
+bool w_latency_sample(unsigned int rate);
+
+/**
+ * @brief Get a timestamp to measure latencies
+ *
+ * @return Current time in microseconds
+ */
+uint64_t w_latency_now();
+
+/**
+ * @brief Add a sample to a stage, from a timestamp up to now
+ *
+ * @param latency Stage latency
+ * @param start Timestamp when the stage started, from w_latency_now(). 0 means not traced
+ * @return Current timestamp, to start the next stage. 0 if the event is not traced
+ */
+uint64_t w_latency_add(w_latency_t * latency, uint64_t start);
+
+/**
+ * @brief Get the latency of a stage as JSON
+ *
+ * @param latency Stage latency
+ * @return cJSON object with the count, average, maximum and histogram (microseconds)
+ */
+cJSON * w_latency_to_json(w_latency_t * latency);
+
+#endif /* LATENCY_OP_H */
@@ -30,6 +30,40 @@ typedef struct {
     rwlock_t rwlock;                            ///< Read-write lock
 } log_builder_t;
 
+/**
+ * @brief Log format field type
+ */
+typedef enum {
+    LOG_FIELD_TEXT,                 ///< Constant text
+    LOG_FIELD_LOG,                  ///< $(log) or $(output)
+    LOG_FIELD_LOCATION,             ///< $(location) or $(command)
+    LOG_FIELD_TIMESTAMP,            ///< $(timestamp) or $(timestamp <format>)
+    LOG_FIELD_HOSTNAME,             ///< $(hostname)
+    LOG_FIELD_HOST_IP,              ///< $(host_ip)
+    LOG_FIELD_JSON_ESCAPED_LOG,     ///< $(json_escaped_log)
+    LOG_FIELD_BASE64_LOG            ///< $(base64_log)
+} log_field_t;
+
+/**
+ * @brief Log format token
+ */
+typedef struct {
+    log_field_t type;       ///< Field type
+    char * text;            ///< Constant text, or timestamp format (NULL for RFC3164)
+    size_t length;          ///< Length of the text
+} log_token_t;
+
+/**
+ * @brief Log format compiled from a pattern
+ *
+ * The pattern is parsed once, so a log is built in a single pass over the tokens.
+ */
+typedef struct log_format_t {
+    log_token_t * tokens;   ///< Tokens in order
+    size_t size;            ///< Number of tokens
+    size_t constant_length; ///< Length of the constant text, the shortest output
+} log_format_t;
+
 /**
  * @brief Initialize a log builder structure
  *
@@ -74,4 +108,34 @@ int log_builder_update(log_builder_t * builder);
  */
 char * log_builder_build(log_builder_t * builder, const char * pattern, const char * logmsg, const char * location);
 
+/**
+ * @brief Compile a log format
+ *
+ * The invalid parameters are reported and dropped.
+ *
+ * @param pattern String holding the log format, as in log_builder_build().
+ * @return Pointer to a new compiled format.
+ */
+log_format_t * log_builder_compile(const char * pattern);
+
+/**
+ * @brief Free a compiled log format
+ *
+ * @param format Pointer to a compiled format, or NULL.
+ */
+void log_format_free(log_format_t * format);
+
+/**
+ * @brief Build a log string into a buffer from a compiled format
+ *
+ * @param builder Pointer to a log builder structure.
+ * @param format Compiled log format.
+ * @param logmsg String containing the input log.
+ * @param location String representing the log location.
+ * @param output Destination buffer.
+ * @param size Size of the destination buffer.
+ * @return Length of the output log. If it doesn't fit, the output is the input log, truncated.
+ */
+size_t log_builder_format(log_builder_t * builder, const log_format_t * format, const char * logmsg, const char * location, char * output, size_t size);
+
 #endif // LOG_BUILDER_H
@@ -0,0 +1,38 @@
+/*
+ * Log header parser
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef LOG_HEADER_OP_H
+#define LOG_HEADER_OP_H
+
+/**
+ * @brief Fields of a log header, pointing into the parsed copy of the log
+ */
+typedef struct {
+    char * log;             ///< Message after the header
+    char * dec_timestamp;   ///< Header date, NULL if the log has no known header
+    char * hostname;        ///< Header hostname, or NULL
+    char * program_name;    ///< Header program name, or NULL
+    size_t p_name_size;     ///< Length of the program name
+} w_log_header_t;
+
+/**
+ * @brief Cut the date, hostname and program name of the known log formats (syslog, snort, apache...)
+ *
+ * This is the analysisd pre-decoding, the agents use it too so that they see the log the rules match.
+ * The header is detected on raw, and the copy is split with null characters.
+ *
+ * @param raw Log to check. It may be modified (non-ASCII months are repaired).
+ * @param loglen Length of the log, including the terminating null character.
+ * @param header header->log must point to a copy of raw, the fields are set into that copy.
+ */
+void w_log_header_parse(char * raw, size_t loglen, w_log_header_t * header);
+
+#endif /* LOG_HEADER_OP_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * @file mem_stats.h
+ * @brief Memory accounting per subsystem
+ */
+
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define W_MEM_TAG_INITIALIZER(tag_name) { .name = tag_name }
+
+/**
+ * @brief Memory held by a subsystem
+ */
+typedef struct {
+    const char * name;                  ///< Subsystem name, as shown in the statistics
+    _Atomic(int64_t) bytes;             ///< Bytes currently allocated
+    _Atomic(int64_t) allocations;       ///< Blocks currently allocated
+} w_mem_tag_t;
+
+/* Allocation wrappers that account the block to a tag. The block must be freed with os_free_tag() */
+#define os_calloc_tag(tag,x,y,z) do { os_calloc(x,y,z); w_mem_tag_alloc(tag, z); } while (0)
+#define os_malloc_tag(tag,x,y) do { os_malloc(x,y); w_mem_tag_alloc(tag, y); } while (0)
+#define os_strdup_tag(tag,x,y) do { os_strdup(x,y); w_mem_tag_alloc(tag, y); } while (0)
+#define os_free_tag(tag,x) if (x) { w_mem_tag_free(tag, x); free(x); x = NULL; }
+
+/**
+ * @brief Get the size of an allocated block
+ *
+ * @param ptr Block returned by malloc(), calloc(), realloc() or strdup()
+ * @return Usable size of the block. 0 if ptr is NULL or the platform can't tell it
+ */
+size_t w_mem_size(const void * ptr);
+
+/**
+ * @brief Account a block allocated for a tag
+ *
+ * @param tag Subsystem tag
+ * @param ptr Allocated block
+ */
+void w_mem_tag_alloc(w_mem_tag_t * tag, const void * ptr);
+
+/**
+ * @brief Remove a block from a tag, before freeing it
+ *
+ * @param tag Subsystem tag
+ * @param ptr Block to be freed
+ */
+void w_mem_tag_free(w_mem_tag_t * tag, const void * ptr);
+
+/**
+ * @brief Add (or remove, if negative) memory measured by the subsystem itself
+ *
+ * @param tag Subsystem tag
+ * @param bytes Bytes to add
+ * @param allocations Blocks to add
+ */
+void w_mem_tag_add(w_mem_tag_t * tag, int64_t bytes, int64_t allocations);
+
+/**
+ * @brief Get the memory of some tags as JSON
+ *
+ * @param tags NULL-terminated array of tags
+ * @return cJSON object with the bytes and blocks of each tag, keyed by its name
+ */
+cJSON * w_mem_tags_to_json(w_mem_tag_t * const * tags);
+
+/**
+ * @brief Get the state of the process heap as JSON
+ *
+ * The difference between the heap size and the bytes in use is the
+ * memory kept free by the allocator, that is, fragmentation.
+ * @return cJSON object with the heap, in use, free and mmap bytes. NULL if the allocator doesn't tell it
+ */
+cJSON * w_mem_heap_to_json(void);
+
+#endif /* MEM_STATS_H */
@@ -0,0 +1,108 @@
+/**
+ * @file mq_ring_op.h
+ * @brief Shared memory ring to send the events of a queue
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (C) 2015 Wazuh, Inc.
+ */
+
+/*
+ * This program is a free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef MQ_RING_OP_H
+#define MQ_RING_OP_H
+
+#include <shared.h>
+
+/// Message sent by a writer over the queue socket to announce its ring
+#define MQ_RING_HEADER "#!-ring "
+
+/// File with the ring size, created by a reader that accepts rings
+#define MQ_RING_ADVERT DEFAULTQUEUE ".ring"
+
+/// Seconds without news from the reader to go back to the socket
+#define MQ_RING_TIMEOUT 10
+
+/**
+ * @brief Single-reader ring in shared memory
+ *
+ * The writer side is serialized by a mutex of the writer process. The reader
+ * and the writers only share atomic counters, and the reader sleeps on a futex
+ * when the ring is empty.
+ */
+typedef struct mq_ring_t mq_ring_t;
+
+#ifdef __linux__
+
+/**
+ * @brief Create a ring as a writer
+ *
+ * @param size Maximum size of the data, rounded down to a power of two.
+ * @param name Buffer to store the name to announce to the reader.
+ * @param name_size Size of the name buffer.
+ * @return Ring, or NULL on error.
+ */
+mq_ring_t * mq_ring_create(size_t size, char * name, size_t name_size);
+
+/**
+ * @brief Check whether a reader is serving the ring
+ *
+ * @param ring Ring created by mq_ring_create().
+ * @retval true The reader attached the ring and is alive.
+ * @retval false The events must be sent through the socket.
+ */
+bool mq_ring_ready(mq_ring_t * ring);
+
+/**
+ * @brief Append a message to the ring
+ *
+ * @param ring Ring created by mq_ring_create().
+ * @param msg Message.
+ * @param length Message length.
+ * @retval 0 Message stored.
+ * @retval -1 The ring is full.
+ */
+int mq_ring_push(mq_ring_t * ring, const char * msg, size_t length);
+
+/**
+ * @brief Close the writer side of a ring
+ *
+ * The reader consumes the remaining messages and releases the ring.
+ *
+ * @param ring Ring created by mq_ring_create().
+ */
+void mq_ring_close(mq_ring_t * ring);
+
+/**
+ * @brief Attach a ring as the reader
+ *
+ * @param name Name announced by the writer.
+ * @return Ring, or NULL on error.
+ */
+mq_ring_t * mq_ring_attach(const char * name);
+
+/**
+ * @brief Take the next message of the ring
+ *
+ * @param ring Ring attached by mq_ring_attach().
+ * @param buffer Destination buffer, the message is zero-terminated.
+ * @param size Size of the buffer.
+ * @param timeout Maximum time to wait for a message (milliseconds).
+ * @return Message length, 0 on timeout, or -1 if the writer is gone and the ring is empty.
+ */
+ssize_t mq_ring_pop(mq_ring_t * ring, char * buffer, size_t size, int timeout);
+
+/**
+ * @brief Release a ring attached by mq_ring_attach()
+ *
+ * @param ring Ring to release.
+ */
+void mq_ring_detach(mq_ring_t * ring);
+
+#endif // __linux__
+
+#endif // MQ_RING_OP_H
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * @file probe_op.h
+ * @brief Static tracing probes at the hot paths
+ *
+ * Builds made with USE_USDT=yes place a USDT probe of the "wazuh" provider
+ * at every W_PROBE point. A probe is a single nop until a tracer attaches to
+ * it, so they are always compiled in, e.g.:
+ *
+ *   bpftrace -e 'usdt:/var/ossec/bin/wazuh-analysisd:wazuh:rule__check { @[arg0] = count(); }'
+ *
+ * The names follow the DTrace convention: "__" is shown as "-" by the tools.
+ * Start probes are paired with a done probe so a tracer can time the span
+ * between them. Arguments must be cheap to compute, as they are evaluated
+ * even when nobody is tracing.
+ */
+
+#ifndef PROBE_OP_H
+#define PROBE_OP_H
+
+#if defined(USDT_ENABLED) && defined(__linux__)
+#include <sys/sdt.h>
+
+#define W_PROBE(name)                   DTRACE_PROBE(wazuh, name)
+#define W_PROBE1(name, a1)              DTRACE_PROBE1(wazuh, name, a1)
+#define W_PROBE2(name, a1, a2)          DTRACE_PROBE2(wazuh, name, a1, a2)
+#define W_PROBE3(name, a1, a2, a3)      DTRACE_PROBE3(wazuh, name, a1, a2, a3)
+#else
+#define W_PROBE(name)                   do { } while (0)
+#define W_PROBE1(name, a1)              do { } while (0)
+#define W_PROBE2(name, a1, a2)          do { } while (0)
+#define W_PROBE3(name, a1, a2, a3)      do { } while (0)
+#endif
+
+#endif /* PROBE_OP_H */
@@ -31,6 +31,8 @@ typedef struct w_queue_s {
     pthread_cond_t available; ///> condition variable when queue is empty
     pthread_cond_t available_not_empty; ///> Condition variable when queue is full
     unsigned int elements; ///> counts the number of elements stored in the queue
+    unsigned int busy; ///> elements popped and not yet reported as done, see queue_track_busy()
+    int track_busy; ///> whether the batch pops count the busy elements
 } w_queue_t;
 
 /**
@@ -123,4 +125,74 @@ void * queue_pop_ex(w_queue_t * queue);
  * */
 void * queue_pop_ex_timedwait(w_queue_t * queue, const struct timespec * abstime);
 
+/**
+ * @brief Inserts up to n elements into the queue taking the lock once.
+ * Elements that don't fit are left to the caller (they are not inserted).
+ *
+ * @param queue the queue
+ * @param data array of elements to be inserted
+ * @param n number of elements in the array
+ * @return number of elements inserted, from the beginning of the array
+ * */
+size_t queue_push_batch_ex(w_queue_t * queue, void ** data, size_t n);
+
+/**
+ * @brief Same as queue_push_batch_ex but if queue gets full will
+ * wait until there is space for the remaining elements (THREAD BLOCK)
+ *
+ * @param queue the queue
+ * @param data array of elements to be inserted
+ * @param n number of elements in the array
+ * @return n always
+ * */
+size_t queue_push_batch_ex_block(w_queue_t * queue, void ** data, size_t n);
+
+/**
+ * @brief Retrieves up to max elements from the queue taking the lock once.
+ * If queue is empty THREAD WILL BLOCK until at least one element is available
+ *
+ * @param queue the queue
+ * @param data output array, must fit max elements
+ * @param max maximum number of elements to retrieve
+ * @return number of elements retrieved (at least 1)
+ * */
+size_t queue_pop_batch_ex(w_queue_t * queue, void ** data, size_t max);
+
+/**
+ * @brief Same as queue_pop_batch_ex but with a configured timeout for the
+ * wait. If queue is empty THREAD WILL BLOCK
+ *
+ * @param queue the queue
+ * @param data output array, must fit max elements
+ * @param max maximum number of elements to retrieve
+ * @param abstime timeout specification
+ * @return number of elements retrieved, 0 on timeout
+ * */
+size_t queue_pop_batch_ex_timedwait(w_queue_t * queue, void ** data, size_t max, const struct timespec * abstime);
+
+/**
+ * @brief Makes the batch pops count the retrieved elements as busy until the
+ * consumer calls queue_done(), so that queue_idle() covers the batches in process
+ *
+ * @param queue the queue
+ * */
+void queue_track_busy(w_queue_t * queue);
+
+/**
+ * @brief Reports that n elements retrieved by a batch pop were processed.
+ * It does nothing if the queue doesn't track the busy elements
+ *
+ * @param queue the queue
+ * @param n number of elements processed
+ * */
+void queue_done(w_queue_t * queue, size_t n);
+
+/**
+ * @brief Evaluates whether the queue is empty and no popped element is in process
+ *
+ * @param queue the queue
+ * @return 1 if true, 0 if false
+ * */
+int queue_idle(w_queue_t * queue);
+
 #endif // QUEUE_OP_H
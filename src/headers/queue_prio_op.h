@@ -0,0 +1,122 @@
+/*
+ * Weighted priority queue
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * Library that keeps one circular buffer per priority class behind a single
+ * lock. Every class has its own capacity, so a flood in one class cannot take
+ * the room of the others, and the consumers pop batches that share the classes
+ * by weight.
+ * */
+#ifndef QUEUE_PRIO_OP_H
+#define QUEUE_PRIO_OP_H
+
+#include <pthread.h>
+
+#define PRIO_QUEUE_CLASSES 3
+
+/**
+ * priority queue main structure
+ * */
+typedef struct w_prio_queue_s {
+    w_queue_t * classes[PRIO_QUEUE_CLASSES]; ///> Buffer of each class, by decreasing priority, NULL if the class has no room
+    unsigned int weights[PRIO_QUEUE_CLASSES]; ///> Relative share of each class in a pop batch
+    unsigned int total_weight; ///> Sum of the weights of the classes with room
+    size_t size; ///> Sum of the sizes of the classes
+    unsigned int elements; ///> Counts the number of elements stored in every class
+    unsigned int busy; ///> Elements popped and not yet reported as done, see prio_queue_track_busy()
+    int track_busy; ///> Whether the batch pops count the busy elements
+    pthread_mutex_t mutex; ///> Mutex for mutual exclusion
+    pthread_cond_t available; ///> Condition variable when every class is empty
+} w_prio_queue_t;
+
+/**
+ * @brief Initializes a new priority queue structure
+ *
+ * @param sizes size of the circular buffer of each class (fits size - 1 elements), 0 disables the class
+ * @param weights relative share of each class in a pop batch, 0 is taken as 1
+ * @return initialized priority queue structure
+ */
+w_prio_queue_t * prio_queue_init(const size_t sizes[PRIO_QUEUE_CLASSES], const unsigned int weights[PRIO_QUEUE_CLASSES]);
+
+/**
+ * @brief Frees an existing priority queue. The stored elements are not freed.
+ *
+ * @param queue priority queue to be freed
+ */
+void prio_queue_free(w_prio_queue_t * queue);
+
+/**
+ * @brief Evaluates whether a class of the queue is full. This function is not thread safe.
+ *
+ * @param queue the priority queue
+ * @param priority class to check
+ * @return 1 if the class is full or disabled, 0 otherwise
+ */
+int prio_queue_full(const w_prio_queue_t * queue, unsigned int priority);
+
+/**
+ * @brief Evaluates whether every class of the queue is empty. This function is not thread safe.
+ *
+ * @param queue the priority queue
+ * @return 1 if empty, 0 otherwise
+ */
+int prio_queue_empty(const w_prio_queue_t * queue);
+
+/**
+ * @brief Inserts an element into a class of the queue
+ *
+ * @param queue the priority queue
+ * @param priority class of the element
+ * @param data element to be inserted
+ * @return 0 on success, -1 if the class is full or disabled
+ */
+int prio_queue_push_ex(w_prio_queue_t * queue, unsigned int priority, void * data);
+
+/**
+ * @brief Retrieves up to max elements from the queue taking the lock once (THREAD BLOCK)
+ *
+ * Each class gets its weighted share of the batch first, by decreasing
+ * priority, and the room left is filled from the classes that still have
+ * elements, so the batch is only short when the queue runs out.
+ *
+ * @param queue the priority queue
+ * @param data output array, must fit max elements
+ * @param max maximum number of elements to retrieve
+ * @return number of elements retrieved (at least 1)
+ */
+size_t prio_queue_pop_batch_ex(w_prio_queue_t * queue, void ** data, size_t max);
+
+/**
+ * @brief Makes the batch pops count the retrieved elements as busy until the
+ * consumer calls prio_queue_done(), so that prio_queue_idle() covers the batches in process
+ *
+ * @param queue the priority queue
+ */
+void prio_queue_track_busy(w_prio_queue_t * queue);
+
+/**
+ * @brief Reports that n elements retrieved by a batch pop were processed.
+ * It does nothing if the queue doesn't track the busy elements
+ *
+ * @param queue the priority queue
+ * @param n number of elements processed
+ */
+void prio_queue_done(w_prio_queue_t * queue, size_t n);
+
+/**
+ * @brief Evaluates whether every class is empty and no popped element is in process
+ *
+ * @param queue the priority queue
+ * @return 1 if idle, 0 otherwise
+ */
+int prio_queue_idle(w_prio_queue_t * queue);
+
+#endif
@@ -30,6 +30,8 @@
 #define HC_STARTUP                      "agent startup "
 #define HC_SHUTDOWN                     "agent shutdown "
 #define HC_ACK                          "agent ack "
+#define HC_KEEPALIVE                    "agent keepalive "
+#define HC_BATCH                        "batch "
 #define HC_SK_DB_COMPLETED              "syscheck-db-completed"
 #define HC_SK_RESTART                   "syscheck restart"
 #define HC_REQUEST                      "req "
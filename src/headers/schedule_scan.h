@@ -24,6 +24,7 @@ typedef struct _sched_scan_config {
     time_t next_scheduled_scan_time;/* Absolute time next scheduled event will occur */
     time_t time_start;      /* Do not write, used by the modules          */
     int daylight;
+    bool jittered;          /* The first scheduled run was already delayed */
 } sched_scan_config;
 
 /**
@@ -105,6 +106,36 @@ unsigned long int get_time_to_day(int wday, const char * hour, const unsigned in
  * */
 unsigned long int get_time_to_month_day(int month_day, const char* hour, int num_of_months);
 
+/**
+ * @brief Sets the limits of the scheduled jobs of the process
+ *
+ * @param max_jobs Maximum number of scheduled jobs running at once. 0 means no limit.
+ * @param max_jitter Maximum delay of the first scheduled run of a job (seconds). The delay of each module
+ *                   is derived from the host name, so it differs between agents but not between runs.
+ * @param max_load Load average per CPU (percent) above which the jobs are deferred. 0 disables it.
+ */
+void sched_scan_set_limits(unsigned int max_jobs, unsigned int max_jitter, unsigned int max_load);
+
+/**
+ * @brief Waits until a scheduled job of a module can start
+ *
+ * The pending jobs take the free slots in the order they were scheduled.
+ * A job is deferred while the system load is above the limit, up to five minutes.
+ * Only the first scheduled run is delayed: the next ones keep the same offset from
+ * the schedule, since they are computed from the end of the previous run.
+ * Each call must be followed by sched_scan_job_end() once the job finishes.
+ *
+ * @param config Scheduling configuration of the job
+ * @param MODULE_TAG String to identify module, also used to derive its delay
+ * @param jitter Delay the job, false for the runs on start
+ */
+void sched_scan_job_begin(sched_scan_config *config, const char *MODULE_TAG, bool jitter);
+
+/**
+ * @brief Releases the slot taken by sched_scan_job_begin()
+ */
+void sched_scan_job_end();
+
 void sched_scan_dump(const sched_scan_config* scan_config, cJSON *cjson_object);
 int is_sched_tag(const char* tag);
 #endif /* SCHED_SCAN_H */
@@ -64,6 +64,8 @@ typedef struct _keyentry {
     _Atomic (crypt_method) crypto_method;
 
     w_linked_queue_node_t *rids_node;
+    bool rids_pending;                  ///< The counter in memory has not been saved into the rids file yet
+    bool flow_control;                  ///< The agent adapts its event rate to the queue usage sent in the acks
 } keyentry;
 
 /* Key storage */
@@ -86,6 +88,9 @@ typedef struct _keystore {
     /* ID counter */
     int id_counter;
 
+    /* Number of deleted keys. A deletion moves the last key, so the keys file can't be appended */
+    unsigned int deleted;
+
     keystore_flags_t flags;
 
     /* Removed keys storage */
@@ -105,7 +110,7 @@ typedef enum key_states {
     KS_ENCKEY
 } key_states;
 
-#define KEYSTORE_INITIALIZER { NULL, NULL, NULL, NULL, 0, 0, 0, 0, { 0, 0 }, NULL, 0, NULL, PTHREAD_MUTEX_INITIALIZER }
+#define KEYSTORE_INITIALIZER { NULL, NULL, NULL, NULL, 0, 0, 0, 0, 0, { 0, 0 }, NULL, 0, NULL, PTHREAD_MUTEX_INITIALIZER }
 
 /** Function prototypes -- key management **/
 
@@ -126,12 +131,24 @@ int OS_CheckUpdateKeys(const keystore *keys) __attribute((nonnull));
 /* Update the keys if they changed on the system */
 void OS_UpdateKeys(keystore *keys) __attribute((nonnull));
 
+/* Read the keys file into a new keystore, with the same flags as keys.
+ * It does not modify keys, so it can run without holding the keystore lock. */
+keystore * OS_LoadKeys(const keystore *keys) __attribute((nonnull));
+
+/* Replace keys with new_keys, moving the network data and counters of the agents that remain.
+ * new_keys gets the previous keys, to be released with OS_FreeKeys() once the lock is dropped. */
+void OS_SwapKeys(keystore *keys, keystore *new_keys) __attribute((nonnull));
+
 /* Start counter for all agents */
 void OS_StartCounter(keystore *keys) __attribute((nonnull));
 
 /* Remove counter for id */
 void OS_RemoveCounter(const char *id) __attribute((nonnull));
 
+/* Save the counters updated in memory since the last flush.
+ * The manager defers these writes, so it must be called periodically with the keystore read lock held. */
+void OS_FlushCounters(keystore *keys) __attribute((nonnull));
+
 /* Configure to pass if keys file is empty */
 void OS_PassEmptyKeyfile();
 
@@ -144,6 +161,9 @@ int OS_DeleteKey(keystore *keys, const char *id, int purge);
 /* Write keystore on client keys file */
 int OS_WriteKeys(const keystore *keys);
 
+/* Append the keys from index 'first' on to the client keys file */
+int OS_AppendKeys(const keystore *keys, unsigned int first);
+
 /* Duplicate keystore except key hashes and file pointer */
 keystore* OS_DupKeys(const keystore *keys);
 
@@ -184,6 +204,17 @@ int OS_ReadTimestamps(keystore * keys);
  */
 int OS_WriteTimestamps(keystore * keys);
 
+/**
+ * @brief Append the timestamps of the keys from index 'first' on to the timestamps file
+ *
+ * @param keys Pointer to a keystore structure.
+ * @param first Index of the first key to append.
+ * @return Status of the operation.
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int OS_AppendTimestamps(const keystore * keys, unsigned int first);
+
 /** Function prototypes -- send/recv messages **/
 
 /* Decrypt and decompress a remote message */
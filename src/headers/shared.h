@@ -258,6 +258,7 @@ extern const char *__local_name;
 #include "mem_op.h"
 #include "math_op.h"
 #include "mq_op.h"
+#include "mq_ring_op.h"
 #include "privsep_op.h"
 #include "pthreads_op.h"
 #include "regex_op.h"
@@ -266,6 +267,7 @@ extern const char *__local_name;
 #include "hash_op.h"
 #include "rbtree_op.h"
 #include "queue_op.h"
+#include "queue_prio_op.h"
 #include "queue_linked_op.h"
 #include "bqueue_op.h"
 #include "store_op.h"
@@ -280,9 +282,13 @@ extern const char *__local_name;
 #include "randombytes.h"
 #include "labels_op.h"
 #include "time_op.h"
+#include "latency_op.h"
+#include "probe_op.h"
+#include "mem_stats.h"
 #include "vector_op.h"
 #include "exec_op.h"
 #include "json_op.h"
+#include "log_header_op.h"
 #include "notify_op.h"
 #include "version_op.h"
 #include "utf8_op.h"
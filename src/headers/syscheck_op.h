@@ -72,6 +72,7 @@ extern const char *SYSCHECK_EVENT_STRINGS[];
 #include "../syscheckd/include/syscheck.h"
 #include "analysisd/eventinfo.h"
 #include "os_net/os_net.h"
+#include "wazuhdb_op.h"
 
 #define FILE_ATTRIBUTE_INTEGRITY_STREAM         0x00008000
 #define FILE_ATTRIBUTE_NO_SCRUB_DATA            0x00020000
@@ -165,6 +166,7 @@ typedef struct __sdb {
 
     int db_err;
     int socket;
+    wdbc_pipeline pipeline; // Queries sent to wazuh-db whose response hasn't been read
 } _sdb; /* syscheck db information */
 
 typedef struct sk_sum_wdata {
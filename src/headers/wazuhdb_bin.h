@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef WDBBIN_H
+#define WDBBIN_H
+
+#include "shared.h"
+
+/*
+ * Binary messages to Wazuh DB
+ *
+ * A binary message starts with a zero byte, that no text command can use,
+ * followed by the protocol version and the command code. The payload is a
+ * sequence of values, each one introduced by its type tag:
+ *
+ * - Integers are zigzag-encoded base-128 varints.
+ * - Doubles are 8 bytes, little endian.
+ * - Strings are a varint length followed by the bytes, without terminator.
+ * - Arrays and objects are a varint count followed by the items. Each object
+ *   item is a string key followed by a value.
+ *
+ * Wazuh DB answers binary messages with the same text responses.
+ */
+
+#define WDB_BIN_MAGIC       0x00
+#define WDB_BIN_VERSION     0x01
+#define WDB_BIN_HEADER_SIZE 3
+#define WDB_BIN_MAX_DEPTH   16
+
+/// Commands that have a binary encoding.
+typedef enum wdb_bin_command {
+    WDB_BIN_DBSYNC = 1      ///< Syscollector delta: agent dbsync <table> <operation> <data>
+} wdb_bin_command;
+
+/// Type tags of the binary values.
+typedef enum wdb_bin_type {
+    WDB_BIN_NULL,
+    WDB_BIN_FALSE,
+    WDB_BIN_TRUE,
+    WDB_BIN_INT,
+    WDB_BIN_DOUBLE,
+    WDB_BIN_STRING,
+    WDB_BIN_ARRAY,
+    WDB_BIN_OBJECT
+} wdb_bin_type;
+
+/// Decoded binary dbsync message.
+typedef struct wdb_bin_dbsync_t {
+    int agent_id;               ///< Agent ID
+    char table[OS_SIZE_256];    ///< Table key, like "osinfo" or "packages"
+    char operation[OS_SIZE_32]; ///< INSERTED, MODIFIED or DELETED
+    cJSON * data;               ///< Fields of the delta, owned by the caller
+} wdb_bin_dbsync_t;
+
+/**
+ * @brief Tell whether a message to Wazuh DB uses the binary encoding
+ *
+ * @param buffer Message.
+ * @param length Length of the message.
+ * @return true if the message has a binary header.
+ */
+bool wdb_bin_is_binary(const char * buffer, size_t length);
+
+/**
+ * @brief Get the command code of a binary message
+ *
+ * @param buffer Message, checked with wdb_bin_is_binary().
+ * @return Command code, or OS_INVALID if the version is not supported.
+ */
+int wdb_bin_get_command(const char * buffer);
+
+/**
+ * @brief Encode a JSON value
+ *
+ * @param buffer Output buffer.
+ * @param size Size of the buffer.
+ * @param value Value to encode.
+ * @return Bytes written, or OS_INVALID if the buffer is too small.
+ */
+ssize_t wdb_bin_encode_json(char * buffer, size_t size, const cJSON * value);
+
+/**
+ * @brief Decode a JSON value
+ *
+ * The strings are terminated in place while they are copied, so the buffer
+ * is modified temporarily and must hold one more byte after the input.
+ *
+ * @param buffer Input buffer.
+ * @param length Length of the input.
+ * @param value Decoded value, to be freed with cJSON_Delete().
+ * @return Bytes read, or OS_INVALID if the input is truncated or malformed.
+ */
+ssize_t wdb_bin_decode_json(char * buffer, size_t length, cJSON ** value);
+
+/**
+ * @brief Encode a dbsync delta
+ *
+ * @param buffer Output buffer.
+ * @param size Size of the buffer.
+ * @param agent_id Agent ID.
+ * @param table Table key.
+ * @param operation Operation of the delta.
+ * @param data Fields of the delta.
+ * @return Length of the message, or OS_INVALID if the buffer is too small.
+ */
+ssize_t wdb_bin_encode_dbsync(char * buffer, size_t size, int agent_id, const char * table, const char * operation, const cJSON * data);
+
+/**
+ * @brief Decode a dbsync delta
+ *
+ * @param buffer Message, checked with wdb_bin_get_command(). It is modified
+ *               temporarily and must hold one more byte after the message.
+ * @param length Length of the message.
+ * @param msg Decoded message. On success, msg->data must be freed by the caller.
+ * @return OS_SUCCESS, or OS_INVALID if the message is malformed.
+ */
+int wdb_bin_decode_dbsync(char * buffer, size_t length, wdb_bin_dbsync_t * msg);
+
+#endif
@@ -30,13 +30,49 @@ typedef enum wdbc_result {
 
 extern const char* WDBC_RESULT[];
 
+/// Queries sent through a Wazuh DB connection whose responses are read later, in order.
+typedef struct wdbc_pipeline {
+    const char *name;       ///< Component named in the log messages
+    unsigned int size;      ///< Queries sent before waiting for the oldest response
+    unsigned int pending;   ///< Queries whose response hasn't been read
+    unsigned int dropped;   ///< Responses lost with a broken connection, in total
+} wdbc_pipeline;
+
 int wdbc_connect();
 int wdbc_query(const int sock, const char *query, char *response, const int len);
 int wdbc_query_ex(int *sock, const char *query, char *response, const int len);
+int wdbc_query_bin(const int sock, const char *query, size_t size, char *response, const int len);
+int wdbc_query_bin_ex(int *sock, const char *query, size_t size, char *response, const int len);
+int wdbc_send_ex(int *sock, const char *query);
+int wdbc_recv(const int sock, char *response, const int len);
 int wdbc_parse_result(char *result, char **payload);
 cJSON * wdbc_query_parse_json(int *sock, const char *query, char *response, const int len);
 wdbc_result wdbc_query_parse(int *sock, const char *query, char *response, const int len, char** payload);
 
+/**
+ * @brief Send a query through a pipeline, waiting for the oldest response if it's full.
+ *
+ * If the connection is broken, its pending responses are dropped and the query is sent
+ * once through a new connection.
+ *
+ * @param[in,out] sock Pointer to the client socket descriptor.
+ * @param[in,out] pipeline Pipeline of the connection.
+ * @param[in] query Query to be sent to Wazuh-DB.
+ * @return Number of failed queries: error or dropped responses, and this query if it couldn't be sent.
+ */
+int wdbc_pipeline_send(int *sock, wdbc_pipeline *pipeline, const char *query);
+
+/**
+ * @brief Read the responses of a pipeline until only some of them are pending.
+ *
+ * @param[in,out] sock Pointer to the client socket descriptor.
+ * @param[in,out] pipeline Pipeline of the connection.
+ * @param[in] keep Maximum pending responses to leave, 0 reads all of them.
+ * @post If a response can't be read, the socket is closed and the pending responses are dropped.
+ * @return Number of failed queries: error or dropped responses.
+ */
+int wdbc_pipeline_recv(int *sock, wdbc_pipeline *pipeline, unsigned int keep);
+
 /**
  * @brief Closes a socket connection if exists
  *
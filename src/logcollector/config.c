@@ -52,6 +52,9 @@ int LogCollectorConfig(const char *cfgfile)
     reload_delay = getDefine_Int("logcollector", "reload_delay", 0, 30000);
     free_excluded_files_interval = getDefine_Int("logcollector", "exclude_files_interval", 1, 172800);
     state_interval = getDefine_Int("logcollector", "state_interval", 0, 3600);
+#ifdef INOTIFY_ENABLED
+    use_inotify = getDefine_Int("logcollector", "inotify", 0, 1);
+#endif
 
     /* Current and total files counter */
     total_files = 0;
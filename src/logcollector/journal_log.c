@@ -0,0 +1,311 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#ifdef __linux__
+
+#include <dlfcn.h>
+#include "shared.h"
+#include "logcollector.h"
+#include "journal_log.h"
+
+#ifdef WAZUH_UNIT_TESTING
+// Remove STATIC qualifier from tests
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#define JOURNAL_FIELD_SIZE  OS_SIZE_256
+
+/**
+ * @brief Gets a field of the current journal entry
+ *
+ * @warning The value is not null-terminated and it's only valid until the next call
+ * @param field Field name
+ * @param [out] value Field value
+ * @param [out] length Field value length
+ * @return true if the entry contains the field, false otherwise
+ */
+STATIC bool w_journald_get_field(const char * field, const char ** value, int * length);
+
+/**
+ * @brief Copies a field of the current journal entry into a null-terminated buffer
+ *
+ * @param field Field name
+ * @param [out] buffer Destination buffer, empty if the entry doesn't contain the field
+ * @param size Buffer size
+ * @return true if the entry contains the field, false otherwise
+ */
+STATIC bool w_journald_copy_field(const char * field, char * buffer, size_t size);
+
+/**
+ * @brief Formats a journal entry as a syslog line
+ *
+ * @param [out] buffer Destination buffer
+ * @param size Buffer size
+ * @param timestamp Entry timestamp
+ * @param hostname Entry hostname
+ * @param identifier Syslog identifier, or the command name of the process
+ * @param pid Process ID, empty to skip it
+ * @param message Entry message, it doesn't need to be null-terminated
+ * @param message_len Entry message length
+ * @return Length of the formatted line
+ */
+STATIC int w_journald_format(char * buffer, size_t size, time_t timestamp, const char * hostname,
+                             const char * identifier, const char * pid, const char * message, int message_len);
+
+STATIC w_journal_lib_t journal_lib;
+STATIC sd_journal * journal = NULL;
+STATIC w_journal_vault_t journal_vault = { .mutex = PTHREAD_RWLOCK_INITIALIZER, .cursor = NULL };
+
+#define JOURNAL_SYMBOL(member, name)                                           \
+    if (journal_lib.member = dlsym(journal_lib.handle, name), !journal_lib.member) { \
+        mwarn(LOGCOLLECTOR_JOURNAL_LIB, dlerror());                              \
+        w_journald_release();                                                  \
+        return false;                                                          \
+    }
+
+bool w_journald_init(void) {
+
+    char * cursor = NULL;
+    int retval;
+
+    if (journal != NULL) {
+        return true;
+    }
+
+    if (journal_lib.handle = dlopen(JOURNAL_LIB_NAME, RTLD_LAZY), !journal_lib.handle) {
+        mwarn(LOGCOLLECTOR_JOURNAL_LIB, dlerror());
+        return false;
+    }
+
+    JOURNAL_SYMBOL(open, "sd_journal_open");
+    JOURNAL_SYMBOL(close, "sd_journal_close");
+    JOURNAL_SYMBOL(next, "sd_journal_next");
+    JOURNAL_SYMBOL(previous, "sd_journal_previous");
+    JOURNAL_SYMBOL(seek_tail, "sd_journal_seek_tail");
+    JOURNAL_SYMBOL(seek_cursor, "sd_journal_seek_cursor");
+    JOURNAL_SYMBOL(test_cursor, "sd_journal_test_cursor");
+    JOURNAL_SYMBOL(get_cursor, "sd_journal_get_cursor");
+    JOURNAL_SYMBOL(get_data, "sd_journal_get_data");
+    JOURNAL_SYMBOL(get_realtime_usec, "sd_journal_get_realtime_usec");
+
+    if (retval = journal_lib.open(&journal, JOURNAL_LOCAL_ONLY), retval < 0) {
+        mwarn(LOGCOLLECTOR_JOURNAL_LIB, strerror(-retval));
+        journal = NULL;
+        w_journald_release();
+        return false;
+    }
+
+    /* Resume after the last entry sent, or read only the new entries */
+    if (cursor = w_journald_get_cursor(), cursor != NULL
+        && journal_lib.seek_cursor(journal, cursor) >= 0 && journal_lib.next(journal) > 0) {
+
+        /* The saved entry was rotated out: the current one hasn't been read yet */
+        if (journal_lib.test_cursor(journal, cursor) <= 0) {
+            journal_lib.previous(journal);
+        }
+    } else {
+        journal_lib.seek_tail(journal);
+        journal_lib.previous(journal);
+    }
+
+    os_free(cursor);
+
+    return true;
+}
+
+void w_journald_release(void) {
+
+    if (journal != NULL) {
+        journal_lib.close(journal);
+        journal = NULL;
+    }
+
+    if (journal_lib.handle != NULL) {
+        dlclose(journal_lib.handle);
+    }
+
+    memset(&journal_lib, 0, sizeof(w_journal_lib_t));
+}
+
+void * read_journald(logreader * lf, int * rc, __attribute__((unused)) int drop_it) {
+
+    const int MAX_LINE_LEN = OS_MAXSTR - OS_LOG_HEADER;
+    char buffer[OS_MAXSTR];
+    char hostname[JOURNAL_FIELD_SIZE];
+    char identifier[JOURNAL_FIELD_SIZE];
+    char pid[JOURNAL_FIELD_SIZE];
+    const char * message;
+    int message_len;
+    uint64_t usec;
+    char * cursor = NULL;
+    int count_logs = 0;
+    int retval = 0;
+    int size;
+
+    *rc = 0;
+
+    if (journal == NULL || can_read() == 0) {
+        return NULL;
+    }
+
+    while ((maximum_lines == 0 || count_logs < maximum_lines) && can_read()
+           && (retval = journal_lib.next(journal)) > 0) {
+
+        count_logs++;
+
+        if (journal_lib.get_realtime_usec(journal, &usec) < 0) {
+            usec = (uint64_t) time(NULL) * 1000000;
+        }
+
+        /* Only the forwarded fields are taken from the entry, the message goes last */
+        w_journald_copy_field("_HOSTNAME", hostname, sizeof(hostname));
+
+        if (!w_journald_copy_field("SYSLOG_IDENTIFIER", identifier, sizeof(identifier))) {
+            w_journald_copy_field("_COMM", identifier, sizeof(identifier));
+        }
+
+        w_journald_copy_field("_PID", pid, sizeof(pid));
+
+        if (!w_journald_get_field("MESSAGE", &message, &message_len)) {
+            continue;
+        }
+
+        size = w_journald_format(buffer, MAX_LINE_LEN, (time_t) (usec / 1000000), hostname, identifier, pid,
+                                 message, message_len);
+
+        /* Check ignore and restrict log regex, if configured. */
+        if (check_ignore_and_restrict(lf->regex_ignore_pcre2, lf->regex_ignore, lf->regex_restrict, buffer)) {
+            continue;
+        }
+
+        mdebug2("Reading journal message: '%.*s'%s", sample_log_length, buffer, size > sample_log_length ? "..." : "");
+        w_msg_hash_queues_push(buffer, JOURNALD_LOG_NAME, size + 1, lf->log_target, LOCALFILE_MQ);
+    }
+
+    if (retval < 0) {
+        mwarn(LOGCOLLECTOR_JOURNAL_READ, -retval, strerror(-retval));
+    }
+
+    /* The cursor is saved once per call instead of once per entry */
+    if (count_logs > 0 && journal_lib.get_cursor(journal, &cursor) >= 0) {
+        w_journald_set_cursor(cursor);
+        free(cursor);
+    }
+
+    return NULL;
+}
+
+STATIC bool w_journald_get_field(const char * field, const char ** value, int * length) {
+
+    const void * data = NULL;
+    size_t data_len = 0;
+    size_t prefix_len = strlen(field) + 1;
+
+    /* Data is returned as FIELD=value */
+    if (journal_lib.get_data(journal, field, &data, &data_len) < 0 || data_len < prefix_len) {
+        return false;
+    }
+
+    *value = (const char *) data + prefix_len;
+    *length = (data_len - prefix_len) > INT_MAX ? INT_MAX : (int) (data_len - prefix_len);
+
+    return true;
+}
+
+STATIC bool w_journald_copy_field(const char * field, char * buffer, size_t size) {
+
+    const char * value;
+    int length;
+
+    *buffer = '\0';
+
+    if (!w_journald_get_field(field, &value, &length)) {
+        return false;
+    }
+
+    if ((size_t) length >= size) {
+        length = size - 1;
+    }
+
+    memcpy(buffer, value, length);
+    buffer[length] = '\0';
+
+    return true;
+}
+
+STATIC int w_journald_format(char * buffer, size_t size, time_t timestamp, const char * hostname,
+                             const char * identifier, const char * pid, const char * message, int message_len) {
+
+    char date[OS_SIZE_32];
+    struct tm tm_result = { .tm_sec = 0 };
+    int length;
+
+    localtime_r(&timestamp, &tm_result);
+    strftime(date, sizeof(date), "%b %e %T", &tm_result);
+
+    if (*pid != '\0') {
+        length = snprintf(buffer, size, "%s %s %s[%s]: %.*s", date, hostname, identifier, pid, message_len, message);
+    } else {
+        length = snprintf(buffer, size, "%s %s %s: %.*s", date, hostname, identifier, message_len, message);
+    }
+
+    if (length < 0) {
+        *buffer = '\0';
+        return 0;
+    }
+
+    return (size_t) length >= size ? (int) size - 1 : length;
+}
+
+void w_journald_set_cursor(const char * cursor) {
+
+    w_rwlock_wrlock(&journal_vault.mutex);
+    os_free(journal_vault.cursor);
+    w_strdup(cursor, journal_vault.cursor);
+    w_rwlock_unlock(&journal_vault.mutex);
+}
+
+char * w_journald_get_cursor(void) {
+
+    char * cursor = NULL;
+
+    w_rwlock_rdlock(&journal_vault.mutex);
+    w_strdup(journal_vault.cursor, cursor);
+    w_rwlock_unlock(&journal_vault.mutex);
+
+    return cursor;
+}
+
+cJSON * w_journald_get_status_as_JSON(void) {
+
+    cJSON * journald_log = NULL;
+    char * cursor = w_journald_get_cursor();
+
+    if (cursor != NULL) {
+        journald_log = cJSON_CreateObject();
+        cJSON_AddStringToObject(journald_log, OS_LOGCOLLECTOR_JSON_CURSOR, cursor);
+    }
+    os_free(cursor);
+
+    return journald_log;
+}
+
+void w_journald_set_status_from_JSON(cJSON * global_json) {
+
+    cJSON * journald_log = cJSON_GetObjectItem(global_json, OS_LOGCOLLECTOR_JSON_JOURNALD);
+    char * cursor = cJSON_GetStringValue(cJSON_GetObjectItem(journald_log, OS_LOGCOLLECTOR_JSON_CURSOR));
+
+    if (cursor != NULL) {
+        w_journald_set_cursor(cursor);
+    }
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#ifndef JOURNAL_LOG_H
+#define JOURNAL_LOG_H
+
+/* ******************  INCLUDES  ****************** */
+
+#include "shared.h"
+#include "config/localfile-config.h"
+
+/* ******************  DEFINES  ****************** */
+
+#define JOURNALD_LOG_NAME       "journald"          ///< Name to be displayed in the localfile' statistics
+#define JOURNAL_LIB_NAME        "libsystemd.so.0"   ///< Library loaded at runtime to read the journal
+#define JOURNAL_LOCAL_ONLY      (0x1 << 0)          ///< SD_JOURNAL_LOCAL_ONLY flag of sd_journal_open()
+
+///< JSON fields for file_status related to journald
+#define OS_LOGCOLLECTOR_JSON_JOURNALD   JOURNALD_LOG_NAME
+#define OS_LOGCOLLECTOR_JSON_CURSOR     "cursor"
+
+/* ******************  DATATYPES  ****************** */
+
+typedef struct sd_journal sd_journal;
+
+/**
+ * @brief libsystemd functions used to read the journal, resolved with dlsym()
+ */
+typedef struct {
+    void * handle;                                                          ///< dlopen() handle
+    int (*open)(sd_journal ** ret, int flags);                              ///< sd_journal_open
+    void (*close)(sd_journal * j);                                          ///< sd_journal_close
+    int (*next)(sd_journal * j);                                            ///< sd_journal_next
+    int (*previous)(sd_journal * j);                                        ///< sd_journal_previous
+    int (*seek_tail)(sd_journal * j);                                       ///< sd_journal_seek_tail
+    int (*seek_cursor)(sd_journal * j, const char * cursor);                ///< sd_journal_seek_cursor
+    int (*test_cursor)(sd_journal * j, const char * cursor);                ///< sd_journal_test_cursor
+    int (*get_cursor)(sd_journal * j, char ** cursor);                      ///< sd_journal_get_cursor
+    int (*get_data)(sd_journal * j, const char * field, const void ** data, size_t * length); ///< sd_journal_get_data
+    int (*get_realtime_usec)(sd_journal * j, uint64_t * usec);              ///< sd_journal_get_realtime_usec
+} w_journal_lib_t;
+
+/**
+ * @brief Stores the cursor of the last entry read, to resume after a restart
+ */
+typedef struct {
+    pthread_rwlock_t mutex; ///< Prevent the RC on this structure
+    char * cursor;          ///< Cursor of the last entry sent
+} w_journal_vault_t;
+
+/* ******************  PROTOTYPES  ****************** */
+
+/**
+ * @brief Load libsystemd and open the local journal, positioned after the saved cursor
+ *
+ * Without a saved cursor, only the entries written from now on are read.
+ * @return true on success, false if the library or the journal aren't available
+ */
+bool w_journald_init(void);
+
+/**
+ * @brief Close the journal and unload libsystemd
+ */
+void w_journald_release(void);
+
+/**
+ * @brief Set the cursor of the last entry read
+ *
+ * @param cursor journal cursor
+ */
+void w_journald_set_cursor(const char * cursor);
+
+/**
+ * @brief Get the cursor of the last entry read
+ *
+ * @return Allocated cursor. NULL if no entry has been read
+ */
+char * w_journald_get_cursor(void);
+
+/**
+ * @brief Get journald vault as JSON
+ *
+ * @return cJSON* journald vault, NULL if there is no cursor
+ */
+cJSON * w_journald_get_status_as_JSON(void);
+
+/**
+ * @brief Set journald vault from JSON
+ *
+ * @param global_json JSON object containing journald vault information
+ */
+void w_journald_set_status_from_JSON(cJSON * global_json);
+
+#endif /* JOURNAL_LOG_H */
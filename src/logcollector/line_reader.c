@@ -0,0 +1,133 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+/* Block-buffered line reader shared by the line-oriented readers */
+
+#include "shared.h"
+#include "logcollector.h"
+
+#ifndef WIN32
+/* Hash the bytes returned to the caller up to the buffer index 'limit' */
+static void w_line_reader_hash(w_line_reader_t *reader, size_t limit) {
+    if (reader->context && limit > reader->hashed) {
+        SHA1_Update(reader->context, reader->buffer + reader->hashed, limit - reader->hashed);
+        reader->hashed = limit;
+    }
+}
+
+/* Discard the returned bytes and read the next block after the pending ones */
+static void w_line_reader_fill(w_line_reader_t *reader) {
+    size_t request;
+    size_t rbytes;
+
+    w_line_reader_hash(reader, reader->start);
+
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->hashed -= reader->start;
+        reader->start = 0;
+    }
+
+    request = W_LINE_READER_SIZE - reader->end;
+    rbytes = fread(reader->buffer + reader->end, 1, request, reader->fp);
+    reader->end += rbytes;
+
+    /* A short read means that the end of file (or an error) was reached */
+    if (rbytes < request) {
+        reader->eof = true;
+    }
+}
+#endif
+
+void w_line_reader_init(w_line_reader_t *reader, FILE *fp, int64_t position, SHA_CTX *context) {
+    memset(reader, 0, sizeof(w_line_reader_t));
+    reader->fp = fp;
+    reader->position = position;
+    reader->context = context;
+#ifndef WIN32
+    os_malloc(W_LINE_READER_SIZE, reader->buffer);
+#endif
+}
+
+int64_t w_line_reader_gets(w_line_reader_t *reader, char *str, size_t size) {
+    int64_t rbytes;
+
+    if (size < 2) {
+        return 0;
+    }
+
+#ifndef WIN32
+    size_t max_bytes = size - 1;
+    size_t available;
+    char *newline;
+
+    for (;;) {
+        available = reader->end - reader->start;
+
+        if (newline = memchr(reader->buffer + reader->start, '\n', available < max_bytes ? available : max_bytes), newline) {
+            rbytes = newline - (reader->buffer + reader->start) + 1;
+            break;
+        }
+
+        /* Line too long, or last line without a line feed */
+        if (available >= max_bytes || reader->eof) {
+            rbytes = available < max_bytes ? available : max_bytes;
+            break;
+        }
+
+        w_line_reader_fill(reader);
+    }
+
+    memcpy(str, reader->buffer + reader->start, rbytes);
+    str[rbytes] = '\0';
+    reader->start += rbytes;
+#else
+    /* Keep taking the offsets from the stream on Windows */
+    if (!fgets(str, size, reader->fp)) {
+        reader->eof = true;
+        return 0;
+    }
+
+    if (rbytes = w_ftell(reader->fp) - reader->position, rbytes <= 0) {
+        return 0;
+    }
+
+    reader->eof = feof(reader->fp);
+
+    if (reader->context && (str[strlen(str) - 1] == '\n' || strlen(str) == size - 1)) {
+        OS_SHA1_Stream(reader->context, NULL, str);
+    }
+#endif
+
+    reader->position += rbytes;
+    return rbytes;
+}
+
+void w_line_reader_release(w_line_reader_t *reader, int64_t position) {
+#ifndef WIN32
+    int64_t index = (int64_t)reader->start - (reader->position - position);
+
+    /* Only the lines up to 'position' were consumed */
+    if (index >= 0 && index <= (int64_t)reader->end) {
+        w_line_reader_hash(reader, (size_t)index);
+    }
+
+    /* Move the stream back from the block read ahead */
+    if (position >= 0) {
+        w_fseek(reader->fp, position, SEEK_SET);
+    }
+
+    os_free(reader->buffer);
+#else
+    if (position >= 0 && position != reader->position) {
+        w_fseek(reader->fp, position, SEEK_SET);
+    }
+#endif
+}
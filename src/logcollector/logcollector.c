@@ -15,6 +15,10 @@
 #include <pthread.h>
 #include "sysinfo_utils.h"
 
+#ifdef INOTIFY_ENABLED
+#include <sys/inotify.h>
+#endif
+
 // Remove STATIC qualifier from tests
 #ifdef WAZUH_UNIT_TESTING
 #define STATIC
@@ -83,6 +87,51 @@ STATIC int64_t w_set_to_pos(logreader *lf, int64_t pos, int mode);
  */
 STATIC int w_update_hash_node(char * path, int64_t pos);
 
+/**
+ * @brief Assign the files to the input threads, balancing the bytes read since the last call
+ */
+STATIC void w_rebalance_input_threads();
+
+#ifdef INOTIFY_ENABLED
+/**
+ * @brief Initialize the inotify instance used to wake up the input threads
+ */
+static void w_inotify_init();
+
+/**
+ * @brief Watch a regular file opened by handle_file
+ * @param lf logreader whose file has just been opened
+ * @param st status of the opened file
+ */
+static void w_inotify_watch(logreader *lf, const struct stat *st);
+
+/**
+ * @brief Remove the watch of a file, and its pending event
+ * @param lf logreader whose file is being closed or reopened
+ */
+STATIC void w_inotify_unwatch(logreader *lf);
+
+/**
+ * @brief Wait for inotify events, or up to the timeout, and mark the files that received them
+ * @param timeout Maximum time to wait
+ * @return The return value of select()
+ */
+static int w_inotify_wait(struct timeval *timeout);
+
+/**
+ * @brief Check whether a file must be read, consuming its pending event
+ * @param lf logreader to check
+ * @return 1 if the file is polled or has new events, 0 otherwise
+ */
+STATIC int w_inotify_ready(logreader *lf);
+
+/**
+ * @brief Mark a file as ready, so that the next iteration checks it again
+ * @param lf logreader to mark
+ */
+STATIC void w_inotify_set_ready(logreader *lf);
+#endif
+
 /* Global variables */
 int loop_timeout;
 int logr_queue;
@@ -104,6 +153,8 @@ OSHash * msg_queues_table;
 OSHash * files_status;
 ///< Use for log messages
 char *files_status_name = "file_status";
+///< Content of the status file written by the last save
+STATIC char * files_status_saved = NULL;
 static int _cday = 0;
 int N_INPUT_THREADS = N_MIN_INPUT_THREADS;
 int OUTPUT_QUEUE_SIZE = OUTPUT_MIN_QUEUE_SIZE;
@@ -127,19 +178,54 @@ static rwlock_t files_update_rwlock;
 static OSHash *excluded_files = NULL;
 static OSHash *excluded_binaries = NULL;
 
+/* Drop filters compiled by the manager from its agent_drop rules */
+typedef struct {
+    int rule;
+    w_expression_t * location;
+    w_expression_t * match;
+} w_drop_filter_t;
+
+STATIC w_drop_filter_t * drop_filters = NULL;
+STATIC unsigned int drop_filters_size = 0;
+/* Prefix that the manager gives to the locations of this agent: "(name) ip->" */
+STATIC char * drop_filters_prefix = NULL;
+/* The filters are replaced when the shared file changes */
+static rwlock_t drop_filters_rwlock;
+static struct stat drop_filters_stat;
+
+#ifdef INOTIFY_ENABLED
+int use_inotify;
+/* inotify instance shared by the input threads, -1 means polling */
+STATIC int lc_inotify_fd = -1;
+/* Watch descriptors with events pending to be read */
+STATIC OSHash *lc_ready_wds = NULL;
+/* Every file is read until this time, set when the event queue overflows */
+STATIC time_t lc_inotify_rescan = 0;
+#endif
+
 #if defined(Darwin) || (defined(__linux__) && defined(WAZUH_UNIT_TESTING))
 
 STATIC w_macos_log_procceses_t * macos_processes = NULL;
 
 #endif
 
-int check_ignore_and_restrict(OSList * ignore_exp_list, OSList * restrict_exp_list, const char *log_line) {
+int check_ignore_and_restrict(w_expression_t * ignore_pcre2, OSList * ignore_exp_list, OSList * restrict_exp_list, const char *log_line) {
     OSListNode *node_it;
     w_expression_t *exp_it;
 
+    /* Check all the PCRE2 ignore regexes at once */
+    if (ignore_pcre2 && w_expression_match(ignore_pcre2, log_line, NULL, NULL)) {
+        mdebug2(LF_MATCH_REGEX, log_line, "ignore", w_expression_get_regex_pattern(ignore_pcre2));
+        return true;
+    }
+
     if (ignore_exp_list) {
         OSList_foreach(node_it, ignore_exp_list) {
             exp_it = node_it->data;
+            /* Already checked in the combined expression */
+            if (ignore_pcre2 && exp_it->exp_type == EXP_TYPE_PCRE2) {
+                continue;
+            }
             /* Check ignore regex, if it matches, do not process the log */
             if (w_expression_match(exp_it, log_line, NULL, NULL)) {
                 mdebug2(LF_MATCH_REGEX, log_line, "ignore", w_expression_get_regex_pattern(exp_it));
@@ -162,6 +248,205 @@ int check_ignore_and_restrict(OSList * ignore_exp_list, OSList * restrict_exp_li
     return false;
 }
 
+/* Compile a condition of a drop filter. A missing condition leaves the expression NULL */
+static bool w_drop_filter_expression(const cJSON * object, w_expression_t ** expression) {
+    const cJSON * pattern = cJSON_GetObjectItem(object, "pattern");
+    const cJSON * type = cJSON_GetObjectItem(object, "type");
+    w_exp_type_t exp_type;
+
+    *expression = NULL;
+
+    if (!object) {
+        return true;
+    }
+
+    if (!cJSON_IsString(pattern) || !cJSON_IsString(type)) {
+        return false;
+    }
+
+    if (strcmp(type->valuestring, OSMATCH_STR) == 0) {
+        exp_type = EXP_TYPE_OSMATCH;
+    } else if (strcmp(type->valuestring, OSREGEX_STR) == 0) {
+        exp_type = EXP_TYPE_OSREGEX;
+    } else if (strcmp(type->valuestring, PCRE2_STR) == 0) {
+        exp_type = EXP_TYPE_PCRE2;
+    } else {
+        return false;
+    }
+
+    w_calloc_expression_t(expression, exp_type);
+
+    if (!w_expression_compile(*expression, pattern->valuestring, 0)) {
+        w_free_expression_t(expression);
+        return false;
+    }
+
+    return true;
+}
+
+/* Location prefix of the events of this agent, as remoted builds it from its key */
+static char * w_drop_filters_agent_prefix() {
+    char buffer[OS_BUFFER_SIZE + 1];
+    char * prefix = NULL;
+    char ** parts;
+    FILE * fp;
+
+    if (fp = wfopen(KEYS_FILE, "r"), !fp) {
+        return NULL;
+    }
+
+    while (!prefix && fgets(buffer, OS_BUFFER_SIZE, fp)) {
+        if (buffer[0] == '#' || buffer[0] == ' ' || !(parts = OS_StrBreak(' ', buffer, 4))) {
+            continue;
+        }
+
+        if (parts[0] && parts[1] && parts[2] && parts[3] && parts[1][0] != '!') {
+            os_malloc(strlen(parts[1]) + strlen(parts[2]) + 6, prefix);
+            sprintf(prefix, "(%s) %s->", parts[1], parts[2]);
+        }
+
+        free_strarray(parts);
+    }
+
+    fclose(fp);
+    return prefix;
+}
+
+static void w_drop_filters_free(w_drop_filter_t * filters, unsigned int size) {
+    unsigned int i;
+
+    for (i = 0; i < size; i++) {
+        w_free_expression_t(&filters[i].location);
+        w_free_expression_t(&filters[i].match);
+    }
+
+    os_free(filters);
+}
+
+int w_drop_filters_load(const char * path) {
+    cJSON * root = NULL;
+    cJSON * list = NULL;
+    cJSON * item;
+    w_drop_filter_t filter;
+    w_drop_filter_t * filters = NULL;
+    unsigned int size = 0;
+    char * prefix = NULL;
+    w_drop_filter_t * old_filters;
+    unsigned int old_size;
+
+    if (stat(path, &drop_filters_stat) < 0) {
+        memset(&drop_filters_stat, 0, sizeof(drop_filters_stat));
+    } else if (root = json_fread(path, 0), !root) {
+        mwarn("Invalid drop filters file '%s'.", path);
+    } else {
+        list = cJSON_GetObjectItem(root, "drop_filters");
+        prefix = w_drop_filters_agent_prefix();
+    }
+
+    cJSON_ArrayForEach(item, list) {
+        const cJSON * rule = cJSON_GetObjectItem(item, "rule");
+
+        filter.rule = cJSON_IsNumber(rule) ? rule->valueint : 0;
+
+        /* The rules test the location that the manager sees, which needs the agent key */
+        if (cJSON_GetObjectItem(item, "location") && !prefix) {
+            mwarn("Ignoring the drop filter of rule %d, the agent key is unavailable.", filter.rule);
+            continue;
+        }
+
+        if (!w_drop_filter_expression(cJSON_GetObjectItem(item, "location"), &filter.location)) {
+            mwarn("Invalid location of the drop filter of rule %d.", filter.rule);
+            continue;
+        }
+
+        if (!w_drop_filter_expression(cJSON_GetObjectItem(item, "match"), &filter.match)) {
+            mwarn("Invalid match of the drop filter of rule %d.", filter.rule);
+            w_free_expression_t(&filter.location);
+            continue;
+        }
+
+        if (!filter.location && !filter.match) {
+            continue;
+        }
+
+        os_realloc(filters, (size + 1) * sizeof(w_drop_filter_t), filters);
+        filters[size++] = filter;
+    }
+
+    cJSON_Delete(root);
+
+    rwlock_lock_write(&drop_filters_rwlock);
+    old_filters = drop_filters;
+    old_size = drop_filters_size;
+    drop_filters = filters;
+    drop_filters_size = size;
+    os_free(drop_filters_prefix);
+    drop_filters_prefix = prefix;
+    rwlock_unlock(&drop_filters_rwlock);
+
+    w_drop_filters_free(old_filters, old_size);
+
+    if (size > 0 || old_size > 0) {
+        minfo("Loaded %u drop filters from '%s'.", size, path);
+    }
+
+    return size;
+}
+
+void w_drop_filters_check(const char * path) {
+    struct stat current;
+
+    if (stat(path, &current) < 0) {
+        memset(&current, 0, sizeof(current));
+    }
+
+    if (current.st_mtime != drop_filters_stat.st_mtime || current.st_size != drop_filters_stat.st_size ||
+        current.st_ino != drop_filters_stat.st_ino) {
+        w_drop_filters_load(path);
+    }
+}
+
+bool w_drop_filters_match(const char * location, const char * log_line) {
+    char full_location[OS_SIZE_8192];
+    w_log_header_t header = { .log = NULL };
+    char * buffer = NULL;
+    bool dropped = false;
+    size_t loglen;
+    unsigned int i;
+
+    rwlock_lock_read(&drop_filters_rwlock);
+
+    if (drop_filters_size > 0) {
+        /* The rules match the log without its header, as the manager pre-decodes it */
+        loglen = strlen(log_line) + 1;
+        os_malloc(2 * loglen, buffer);
+        memcpy(buffer, log_line, loglen);
+        header.log = buffer + loglen;
+        memcpy(header.log, log_line, loglen);
+        w_log_header_parse(buffer, loglen, &header);
+
+        snprintf(full_location, sizeof(full_location), "%s%s", drop_filters_prefix ? drop_filters_prefix : "", location);
+    }
+
+    for (i = 0; i < drop_filters_size && !dropped; i++) {
+        if (drop_filters[i].location && !w_expression_match(drop_filters[i].location, full_location, NULL, NULL)) {
+            continue;
+        }
+
+        if (drop_filters[i].match && !w_expression_match(drop_filters[i].match, header.log, NULL, NULL)) {
+            continue;
+        }
+
+        mdebug2("Log '%s' dropped by the filter of rule %d.", log_line, drop_filters[i].rule);
+        dropped = true;
+    }
+
+    rwlock_unlock(&drop_filters_rwlock);
+    os_free(buffer);
+
+    return dropped;
+}
+
 /* Handle file management */
 void LogCollectorStart()
 {
@@ -208,6 +493,10 @@ void LogCollectorStart()
     }
 
 
+    /* The events that the manager discards are not sent */
+    rwlock_init(&drop_filters_rwlock);
+    w_drop_filters_load(DROP_FILTERS_FILE);
+
     /* Create the state thread */
 #ifndef WIN32
     w_create_thread(w_logcollector_state_main, (void *) &state_interval);
@@ -402,6 +691,30 @@ void LogCollectorStart()
             os_free(current->fp);
         }
 
+        else if (strcmp(current->logformat, JOURNALD_LOG) == 0) {
+#ifdef __linux__
+            if (w_journald_init()) {
+                current->read = read_journald;
+                current->journal_log = true;
+                minfo("Monitoring the systemd journal.");
+                w_logcollector_state_add_file(JOURNALD_LOG_NAME);
+
+                if (atexit(w_journald_release)) {
+                    merror(ATEXIT_ERROR);
+                }
+
+                for (int tg_idx = 0; current->target[tg_idx]; tg_idx++) {
+                    mdebug1("Socket target for '%s' -> %s", JOURNALD_LOG_NAME, current->target[tg_idx]);
+                    w_logcollector_state_add_target(JOURNALD_LOG_NAME, current->target[tg_idx]);
+                }
+            }
+#else
+            minfo(LOGCOLLECTOR_ONLY_JOURNALD);
+#endif
+            os_free(current->file);
+            os_free(current->command);
+        }
+
         else if (j < 0) {
             set_read(current, i, j);
             if (current->file) {
@@ -911,6 +1224,10 @@ void LogCollectorStart()
             /* Check for ASCII, UTF-8 */
             check_text_only();
 
+            /* Move files between the input threads according to their load */
+            if (N_INPUT_THREADS > 1) {
+                w_rebalance_input_threads();
+            }
 
             rwlock_unlock(&files_update_rwlock);
 
@@ -921,6 +1238,9 @@ void LogCollectorStart()
             //Save status localfiles to disk
             w_save_file_status();
 
+            /* The manager may have pushed new drop filters */
+            w_drop_filters_check(DROP_FILTERS_FILE);
+
             f_check = 0;
 
             if (mq_log_builder_update() == -1) {
@@ -1087,6 +1407,10 @@ int handle_file(int i, int j, __attribute__((unused)) int do_fseek, int do_log)
     }
 #endif
 
+#ifdef INOTIFY_ENABLED
+    w_inotify_watch(lf, &stat_fd);
+#endif
+
     /* Set ignore to zero */
     lf->ign = 0;
     lf->exists = 1;
@@ -1156,8 +1480,160 @@ void close_file(logreader * lf) {
 #ifdef WIN32
     lf->h = NULL;
 #endif
+
+#ifdef INOTIFY_ENABLED
+    /* A watch descriptor may be reused by the kernel for another file */
+    w_inotify_unwatch(lf);
+#endif
+}
+
+#ifdef INOTIFY_ENABLED
+static void w_inotify_init() {
+    int flags;
+
+    if (!use_inotify) {
+        return;
+    }
+
+    if (lc_ready_wds = OSHash_Create(), !lc_ready_wds) {
+        merror(LIST_ERROR);
+        return;
+    }
+
+    if (lc_inotify_fd = inotify_init(), lc_inotify_fd < 0) {
+        mwarn(LOGCOLLECTOR_INOTIFY_INIT, errno, strerror(errno));
+        goto error;
+    }
+
+    if (flags = fcntl(lc_inotify_fd, F_GETFL, 0), flags < 0 || fcntl(lc_inotify_fd, F_SETFL, flags | O_NONBLOCK) < 0
+        || fcntl(lc_inotify_fd, F_SETFD, FD_CLOEXEC) < 0) {
+        mwarn(LOGCOLLECTOR_INOTIFY_INIT, errno, strerror(errno));
+        close(lc_inotify_fd);
+        lc_inotify_fd = -1;
+        goto error;
+    }
+
+    return;
+
+error:
+    OSHash_Free(lc_ready_wds);
+    lc_ready_wds = NULL;
+}
+
+static void w_inotify_watch(logreader *lf, const struct stat *st) {
+    struct stat path_stat;
+
+    if (lc_inotify_fd < 0) {
+        return;
+    }
+
+    /* The file may have been rotated: drop the watch of the previous inode */
+    w_inotify_unwatch(lf);
+
+    /* Multiline regex logs flush on timeout, and network file systems don't
+     * report remote changes: keep polling them.
+     */
+    if (!S_ISREG(st->st_mode) || lf->multiline || IsNFS(lf->file) == 1) {
+        return;
+    }
+
+    if (lf->wd = inotify_add_watch(lc_inotify_fd, lf->file, IN_MODIFY), lf->wd < 0) {
+        mdebug1(LOGCOLLECTOR_INOTIFY_WATCH, lf->file, errno, strerror(errno));
+        lf->wd = 0;
+        return;
+    }
+
+    /* The path must still point to the opened file */
+    if (stat(lf->file, &path_stat) < 0 || path_stat.st_ino != st->st_ino || path_stat.st_dev != st->st_dev) {
+        inotify_rm_watch(lc_inotify_fd, lf->wd);
+        lf->wd = 0;
+        return;
+    }
+
+    /* Read what was written before the watch was added */
+    w_inotify_set_ready(lf);
 }
 
+STATIC void w_inotify_unwatch(logreader *lf) {
+    char key[OS_SIZE_32];
+
+    if (lc_inotify_fd < 0 || lf->wd <= 0) {
+        return;
+    }
+
+    snprintf(key, sizeof(key), "%d", lf->wd);
+    OSHash_Delete_ex(lc_ready_wds, key);
+    inotify_rm_watch(lc_inotify_fd, lf->wd);
+    lf->wd = 0;
+}
+
+static int w_inotify_wait(struct timeval *timeout) {
+    char buffer[OS_SIZE_8192] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct inotify_event *event;
+    char key[OS_SIZE_32];
+    fd_set fdset;
+    ssize_t len;
+    char *ptr;
+    int r;
+
+    if (lc_inotify_fd < 0) {
+        return select(0, NULL, NULL, NULL, timeout);
+    }
+
+    FD_ZERO(&fdset);
+    FD_SET(lc_inotify_fd, &fdset);
+
+    if (r = select(lc_inotify_fd + 1, &fdset, NULL, NULL, timeout), r <= 0) {
+        return r;
+    }
+
+    /* Several threads may wake up at once: the fd is non-blocking */
+    while (len = read(lc_inotify_fd, buffer, sizeof(buffer)), len > 0) {
+        for (ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + event->len) {
+            event = (struct inotify_event *)ptr;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                lc_inotify_rescan = time(NULL) + loop_timeout;
+            } else if (event->wd > 0 && !(event->mask & IN_IGNORED)) {
+                snprintf(key, sizeof(key), "%d", event->wd);
+                OSHash_Add_ex(lc_ready_wds, key, (void *)1);
+            }
+        }
+    }
+
+    return r;
+}
+
+STATIC int w_inotify_ready(logreader *lf) {
+    char key[OS_SIZE_32];
+
+    if (lc_inotify_fd < 0 || lf->wd <= 0) {
+        return 1;
+    }
+
+    snprintf(key, sizeof(key), "%d", lf->wd);
+
+    /* Consume the event before reading, so that later writes mark it again */
+    if (OSHash_Delete_ex(lc_ready_wds, key) != NULL) {
+        return 1;
+    }
+
+    /* Events were lost: read everything */
+    return time(NULL) < lc_inotify_rescan;
+}
+
+STATIC void w_inotify_set_ready(logreader *lf) {
+    char key[OS_SIZE_32];
+
+    if (lc_inotify_fd < 0 || lf->wd <= 0) {
+        return;
+    }
+
+    snprintf(key, sizeof(key), "%d", lf->wd);
+    OSHash_Add_ex(lc_ready_wds, key, (void *)1);
+}
+#endif
+
 #ifdef WIN32
 
 /* Remove newlines and replace tabs in the argument fields with spaces */
@@ -1836,6 +2312,13 @@ static void set_sockets() {
                     }
                 }
             }
+
+            // Parse the formats once
+            for (k = 0; current->target[k]; k++) {
+                if (current->log_target[k].format) {
+                    current->log_target[k].compiled_format = log_builder_compile(current->log_target[k].format);
+                }
+            }
         }
     }
 }
@@ -1910,6 +2393,12 @@ int w_msg_hash_queues_push(const char *str, char *file, unsigned long size, logt
 
     w_logcollector_state_update_file(file, size);
 
+    /* Dropped events are accounted as drops of their own target */
+    if (w_drop_filters_match(file, str)) {
+        w_logcollector_state_update_target(file, DROP_FILTERS_TARGET, true);
+        return 0;
+    }
+
     for (i = 0; targets[i].log_socket; i++)
     {
         w_mutex_lock(&mutex);
@@ -1984,15 +2473,99 @@ w_message_t * w_msg_queue_pop(w_msg_queue_t * msg){
     return message;
 }
 
+size_t w_msg_queue_pop_batch(w_msg_queue_t * msg, w_message_t ** messages, size_t max) {
+    size_t n = 0;
+    w_mutex_lock(&msg->mutex);
+
+    while (queue_empty(msg->msg_queue)) {
+        w_cond_wait(&msg->available, &msg->mutex);
+    }
+
+    while (n < max && (messages[n] = (w_message_t *)queue_pop(msg->msg_queue))) {
+        n++;
+    }
+
+    w_mutex_unlock(&msg->mutex);
+    return n;
+}
+
+/* Send a message to its target and account it in the state */
+static void w_output_send(w_message_t *message) {
+    int sleep_time = 5;
+    int result;
+
+    if (strcmp(message->log_target->log_socket->name, "agent") == 0) {
+        // When dealing with this type of messages we don't want any of them to be lost
+        // Continuously attempt to reconnect to the queue and send the message.
+        result = SendMSGtoSCK(logr_queue, message->buffer, message->file,
+                              message->queue_mq, message->log_target);
+        if (result != 0) {
+            if (result != 1) {
+#ifdef CLIENT
+                merror("Unable to send message to '%s' (wazuh-agentd might be down). Attempting to reconnect.", DEFAULTQUEUE);
+#else
+                merror("Unable to send message to '%s' (wazuh-analysisd might be down). Attempting to reconnect.", DEFAULTQUEUE);
+#endif
+            }
+            // Retry to connect infinitely.
+            logr_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS);
+
+            minfo("Successfully reconnected to '%s'", DEFAULTQUEUE);
+
+            if (result = SendMSGtoSCK(logr_queue, message->buffer, message->file, message->queue_mq, message->log_target),
+                result != 0) {
+                // We reconnected but are still unable to send the message, notify it and go on.
+                if (result != 1) {
+                    merror("Unable to send message to '%s' after a successfull reconnection...", DEFAULTQUEUE);
+                }
+                result = 1;
+            }
+        }
+
+        w_logcollector_state_update_target(message->file,
+                                           message->log_target->log_socket->name,
+                                           result == 1);
+
+    } else {
+        const int MAX_RETRIES = 3;
+        int retries = 0;
+        result = 1;
+        while (retries < MAX_RETRIES) {
+            result = SendMSGtoSCK(logr_queue, message->buffer, message->file,
+                                  message->queue_mq, message->log_target);
+            if (result < 0) {
+                merror(QUEUE_SEND);
+
+                sleep(sleep_time);
+
+                // If we failed, we will wait longer before reattempting to connect
+                sleep_time += 5;
+                retries++;
+            } else {
+                break;
+            }
+        }
+
+        w_logcollector_state_update_target(message->file,
+                                           message->log_target->log_socket->name,
+                                           result == 1);
+
+        if (retries == MAX_RETRIES) {
+            merror(SEND_ERROR, message->log_target->log_socket->location, message->buffer);
+        }
+    }
+}
+
 #ifdef WIN32
 DWORD WINAPI w_output_thread(void * args) {
 #else
 void * w_output_thread(void * args){
 #endif
     char *queue_name = args;
-    w_message_t *message;
+    w_message_t *messages[OUTPUT_MAX_BATCH];
     w_msg_queue_t *msg_queue;
-    int result;
+    size_t n_messages;
+    size_t i;
 
     if (msg_queue = OSHash_Get(msg_queues_table, queue_name), !msg_queue) {
         mwarn("Could not found the '%s'.", queue_name);
@@ -2005,73 +2578,16 @@ void * w_output_thread(void * args){
 
     while(1)
     {
-        int sleep_time = 5;
-        /* Pop message from the queue */
-        message = w_msg_queue_pop(msg_queue);
-
-        if (strcmp(message->log_target->log_socket->name, "agent") == 0) {
-            // When dealing with this type of messages we don't want any of them to be lost
-            // Continuously attempt to reconnect to the queue and send the message.
-            result = SendMSGtoSCK(logr_queue, message->buffer, message->file,
-                                  message->queue_mq, message->log_target);
-            if (result != 0) {
-                if (result != 1) {
-#ifdef CLIENT
-                    merror("Unable to send message to '%s' (wazuh-agentd might be down). Attempting to reconnect.", DEFAULTQUEUE);
-#else
-                    merror("Unable to send message to '%s' (wazuh-analysisd might be down). Attempting to reconnect.", DEFAULTQUEUE);
-#endif
-                }
-                // Retry to connect infinitely.
-                logr_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS);
+        /* Pop all the pending messages, up to a batch, in a single lock */
+        n_messages = w_msg_queue_pop_batch(msg_queue, messages, OUTPUT_MAX_BATCH);
 
-                minfo("Successfully reconnected to '%s'", DEFAULTQUEUE);
+        for (i = 0; i < n_messages; i++) {
+            w_output_send(messages[i]);
 
-                if (result = SendMSGtoSCK(logr_queue, message->buffer, message->file, message->queue_mq, message->log_target),
-                    result != 0) {
-                    // We reconnected but are still unable to send the message, notify it and go on.
-                    if (result != 1) {
-                        merror("Unable to send message to '%s' after a successfull reconnection...", DEFAULTQUEUE);
-                    }
-                    result = 1;
-                }
-            }
-
-            w_logcollector_state_update_target(message->file,
-                                               message->log_target->log_socket->name,
-                                               result == 1);
-
-        } else {
-            const int MAX_RETRIES = 3;
-            int retries = 0;
-            result = 1;
-            while (retries < MAX_RETRIES) {
-                result = SendMSGtoSCK(logr_queue, message->buffer, message->file,
-                                      message->queue_mq, message->log_target);
-                if (result < 0) {
-                    merror(QUEUE_SEND);
-
-                    sleep(sleep_time);
-
-                    // If we failed, we will wait longer before reattempting to connect
-                    sleep_time += 5;
-                    retries++;
-                } else {
-                    break;
-                }
-            }
-
-            w_logcollector_state_update_target(message->file,
-                                               message->log_target->log_socket->name,
-                                               result == 1);
-
-            if (retries == MAX_RETRIES) {
-                merror(SEND_ERROR, message->log_target->log_socket->location, message->buffer);
-            }
+            free(messages[i]->file);
+            free(messages[i]->buffer);
+            free(messages[i]);
         }
-        free(message->file);
-        free(message->buffer);
-        free(message);
     }
 
 #ifndef WIN32
@@ -2105,14 +2621,17 @@ void w_create_output_threads(){
 }
 
 #ifdef WIN32
-DWORD WINAPI w_input_thread(__attribute__((unused)) void * t_id) {
+DWORD WINAPI w_input_thread(void * t_id) {
 #else
-void * w_input_thread(__attribute__((unused)) void * t_id){
+void * w_input_thread(void * t_id){
 #endif
     logreader *current;
     int i = 0, r = 0, j = -1;
     IT_control f_control = 0;
     time_t curr_time = 0;
+    int thread_id = (int)(intptr_t)t_id;
+    int64_t offset;
+    int64_t read_offset;
 #ifndef WIN32
     int int_error = 0;
     struct timeval fp_timeout;
@@ -2129,7 +2648,11 @@ void * w_input_thread(__attribute__((unused)) void * t_id){
         fp_timeout.tv_usec = 0;
 
         /* Wait for the select timeout */
+#ifdef INOTIFY_ENABLED
+        if ((r = w_inotify_wait(&fp_timeout)) < 0) {
+#else
         if ((r = select(0, NULL, NULL, NULL, &fp_timeout)) < 0) {
+#endif
             merror(SELECT_ERROR, errno, strerror(errno));
             int_error++;
 
@@ -2165,6 +2688,13 @@ void * w_input_thread(__attribute__((unused)) void * t_id){
                 }
             }
 
+            /* Every file is read by a single thread, see w_rebalance_input_threads() */
+            if (current->thread_id != thread_id) {
+                rwlock_unlock(&files_update_rwlock);
+                continue;
+            }
+
+            /* The previous owner may still be reading the file after a rebalance */
             if (pthread_mutex_trylock(&current->mutex) == 0){
 
                 if (!current->fp) {
@@ -2181,6 +2711,12 @@ void * w_input_thread(__attribute__((unused)) void * t_id){
                     else if (current->macos_log != NULL && current->macos_log->state != LOG_NOT_RUNNING) {
                         current->read(current, &r, 0);
                     }
+#endif
+#ifdef __linux__
+                    /* Read the systemd journal */
+                    else if (current->journal_log) {
+                        current->read(current, &r, 0);
+                    }
 #endif
                     w_mutex_unlock(&current->mutex);
                     rwlock_unlock(&files_update_rwlock);
@@ -2214,6 +2750,15 @@ void * w_input_thread(__attribute__((unused)) void * t_id){
                     }
                 }
 
+#ifdef INOTIFY_ENABLED
+                /* Skip watched files that got no events since the last read */
+                if (!w_inotify_ready(current)) {
+                    w_mutex_unlock(&current->mutex);
+                    rwlock_unlock(&files_update_rwlock);
+                    continue;
+                }
+#endif
+
                 /* We check for the end of file. If is returns EOF,
                 * we don't attempt to read it.
                 * Excluding multiline_regex log format which has its own handler.
@@ -2305,7 +2850,17 @@ void * w_input_thread(__attribute__((unused)) void * t_id){
             }
 #endif
                 /* Finally, send to the function pointer to read it */
+                offset = w_ftell(current->fp);
                 current->read(current, &r, 0);
+
+                /* Account the bytes read to balance the input threads */
+                if (offset >= 0 && (read_offset = w_ftell(current->fp)) > offset) {
+                    current->read_bytes += read_offset - offset;
+                }
+#ifdef INOTIFY_ENABLED
+                /* The reader may stop at max_lines: check the file again until EOF */
+                w_inotify_set_ready(current);
+#endif
                 /* Check for error */
                 if (!ferror(current->fp)) {
                     /* Clear EOF */
@@ -2396,20 +2951,87 @@ void w_create_input_threads(){
     w_mutexattr_destroy(&win_el_mutex_attr);
 #endif
 
+#ifdef INOTIFY_ENABLED
+    w_inotify_init();
+#endif
+
+    w_rebalance_input_threads();
+
     for(i = 0; i < N_INPUT_THREADS; i++) {
 #ifndef WIN32
-        w_create_thread(w_input_thread,NULL);
+        w_create_thread(w_input_thread, (void *)(intptr_t)i);
 #else
         w_create_thread(NULL,
                      0,
                      w_input_thread,
-                     NULL,
+                     (void *)(intptr_t)i,
                      0,
                      NULL);
 #endif
     }
 }
 
+/* Sort the files by bytes read, in descending order */
+static int w_input_load_cmp(const void * a, const void * b) {
+    const logreader * lf_a = *(logreader * const *)a;
+    const logreader * lf_b = *(logreader * const *)b;
+
+    return (lf_a->read_bytes < lf_b->read_bytes) - (lf_a->read_bytes > lf_b->read_bytes);
+}
+
+STATIC void w_rebalance_input_threads() {
+    logreader *current;
+    logreader **files = NULL;
+    uint64_t *load = NULL;
+    int *count = NULL;
+    IT_control f_control;
+    int n_files = 0;
+    int i, j, k, t;
+
+    for (i = 0, j = -1;; i++) {
+        if (f_control = update_current(&current, &i, &j), f_control) {
+            if (f_control == NEXT_IT) {
+                continue;
+            } else {
+                break;
+            }
+        }
+
+        os_realloc(files, (n_files + 1) * sizeof(logreader *), files);
+        files[n_files++] = current;
+    }
+
+    if (n_files == 0) {
+        return;
+    }
+
+    /* The busiest files go first to the least loaded thread, the number of files breaks ties */
+    qsort(files, n_files, sizeof(logreader *), w_input_load_cmp);
+    os_calloc(N_INPUT_THREADS, sizeof(uint64_t), load);
+    os_calloc(N_INPUT_THREADS, sizeof(int), count);
+
+    for (k = 0; k < n_files; k++) {
+        for (i = 1, t = 0; i < N_INPUT_THREADS; i++) {
+            if (load[i] < load[t] || (load[i] == load[t] && count[i] < count[t])) {
+                t = i;
+            }
+        }
+
+        if (files[k]->thread_id != t) {
+            mdebug2("File '%s' assigned to input thread %d.", files[k]->file ? files[k]->file : files[k]->logformat, t);
+        }
+
+        files[k]->thread_id = t;
+        load[t] += files[k]->read_bytes;
+        count[t]++;
+        files[k]->read_bytes = 0;
+    }
+
+    os_free(files);
+    os_free(load);
+    os_free(count);
+}
+
 void files_lock_init()
 {
     rwlock_init(&files_update_rwlock);
@@ -2634,7 +3256,7 @@ int can_read() {
 int w_update_file_status(const char * path, int64_t pos, SHA_CTX * context) {
 
     os_file_status_t * data;
-    os_malloc(sizeof(os_file_status_t), data);
+    os_calloc(1, sizeof(os_file_status_t), data);
 
     data->context = *context;
 
@@ -2696,20 +3318,36 @@ STATIC void w_save_file_status() {
         return;
     }
 
+    /* Nothing to write if no file moved since the last save */
+    if (files_status_saved != NULL && strcmp(str, files_status_saved) == 0) {
+        os_free(str);
+        return;
+    }
+
     FILE * fd = NULL;
     size_t size_str = strlen(str);
 
-    if (fd = wfopen(LOCALFILE_STATUS, "w"), fd != NULL) {
+    /* Write a temporary file and rename it, a crash never leaves a truncated status file */
+    if (fd = wfopen(LOCALFILE_STATUS_TMP, "w"), fd != NULL) {
         if (fwrite(str, 1, size_str, fd) == 0) {
-            merror(FWRITE_ERROR, LOCALFILE_STATUS, errno, strerror(errno));
+            merror(FWRITE_ERROR, LOCALFILE_STATUS_TMP, errno, strerror(errno));
             clearerr(fd);
+            fclose(fd);
+            os_free(str);
+            return;
         }
         fclose(fd);
+
+        if (rename_ex(LOCALFILE_STATUS_TMP, LOCALFILE_STATUS) != 0) {
+            os_free(str);
+            return;
+        }
     } else {
-        merror_exit(FOPEN_ERROR, LOCALFILE_STATUS, errno, strerror(errno));
+        merror_exit(FOPEN_ERROR, LOCALFILE_STATUS_TMP, errno, strerror(errno));
     }
 
-    os_free(str);
+    os_free(files_status_saved);
+    files_status_saved = str;
 }
 
 STATIC void w_load_files_status(cJSON * global_json) {
@@ -2770,19 +3408,11 @@ STATIC void w_load_files_status(cJSON * global_json) {
 
         os_file_status_t * data;
 
-        os_malloc(sizeof(os_file_status_t), data);
+        /* The prefix is hashed once, when the file is opened and its position is checked */
+        os_calloc(1, sizeof(os_file_status_t), data);
         memcpy(data->hash, hash_str, sizeof(os_sha1));
         data->offset = value_offset;
-
-        SHA_CTX context;
-        os_sha1 output;
-
-        if (OS_SHA1_File_Nbytes(path_str, &context, output, OS_BINARY, value_offset) < 0) {
-            mdebug1(LOGCOLLECTOR_FILE_NOT_EXIST, path_str);
-            os_free(data);
-            return;
-        }
-        data->context = context;
+        data->pending = true;
 
         if (OSHash_Update_ex(files_status, path_str, data) != 1) {
             if (OSHash_Add_ex(files_status, path_str, data) != 2) {
@@ -2795,6 +3425,11 @@ STATIC void w_load_files_status(cJSON * global_json) {
 
    w_macos_set_status_from_JSON(global_json);
 
+#endif
+#ifdef __linux__
+
+    w_journald_set_status_from_JSON(global_json);
+
 #endif
 
 }
@@ -2846,6 +3481,17 @@ STATIC char * w_save_files_status_to_cJSON() {
         cJSON_AddItemToObject(global_json, OS_LOGCOLLECTOR_JSON_MACOS, macos_status);
     }
 
+#endif
+#ifdef __linux__
+
+    cJSON * journald_status = w_journald_get_status_as_JSON();
+    if (journald_status != NULL) {
+        if (global_json == NULL) {
+            global_json = cJSON_CreateObject();
+        }
+        cJSON_AddItemToObject(global_json, OS_LOGCOLLECTOR_JSON_JOURNALD, journald_status);
+    }
+
 #endif
 
     if (global_json != NULL) {
@@ -2894,6 +3540,9 @@ STATIC int w_set_to_last_line_read(logreader * lf) {
     } else if (stat_fd.st_size - data->offset > lf->diff_max_size) {
         result = w_set_to_pos(lf, 0, SEEK_END);
     } else {
+        /* Keep the context just computed, the reader continues from it */
+        data->context = context;
+        data->pending = false;
         return w_set_to_pos(lf, data->offset, SEEK_SET);
     }
 
@@ -2914,7 +3563,7 @@ STATIC int w_update_hash_node(char * path, int64_t pos) {
         return -1;
     }
 
-    os_malloc(sizeof(os_file_status_t), data);
+    os_calloc(1, sizeof(os_file_status_t), data);
 
     data->offset = pos;
 
@@ -2959,7 +3608,7 @@ bool w_get_hash_context(logreader *lf, SHA_CTX * context, int64_t position) {
 
     os_file_status_t * data = (os_file_status_t *) OSHash_Get_ex(files_status, lf->file);
 
-    if (data == NULL) {
+    if (data == NULL || data->pending) {
         os_sha1 output;
         if (OS_SHA1_File_Nbytes_with_fp_check(lf->file, context, output, OS_BINARY, position, lf->fd) < 0) {
             return false;
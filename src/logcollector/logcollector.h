@@ -18,6 +18,7 @@
 #define N_MIN_INPUT_THREADS 1
 #define N_OUPUT_THREADS 1
 #define OUTPUT_MIN_QUEUE_SIZE 128
+#define OUTPUT_MAX_BATCH 128
 #define WIN32_MAX_FILES 200
 
 ///< Size of hash table to save the status file
@@ -29,8 +30,12 @@
 #else
 #define LOCALFILE_STATUS        "queue/logcollector/file_status.json"
 #endif
+#define LOCALFILE_STATUS_TMP    LOCALFILE_STATUS ".tmp" ///< Written first and renamed to LOCALFILE_STATUS
 
 ///< JSON fields for file_status
+#define DROP_FILTERS_FILE       SHAREDCFG_DIR "/drop_filters.json" ///< Filters of the manager's agent_drop rules
+#define DROP_FILTERS_TARGET     "drop_filters"  ///< Target that counts the events dropped by the filters
+
 #define OS_LOGCOLLECTOR_JSON_FILES      "files"
 #define OS_LOGCOLLECTOR_JSON_PATH       "path"
 #define OS_LOGCOLLECTOR_JSON_HASH       "hash"
@@ -42,6 +47,22 @@
 #include "config/config.h"
 #include "os_crypto/sha1/sha1_op.h"
 #include "macos_log.h"
+#include "journal_log.h"
+
+///< Bytes read ahead by the line reader, enough for a full line
+#define W_LINE_READER_SIZE (OS_MAXSTR * 2)
+
+/* Block-buffered line reader */
+typedef struct w_line_reader_t {
+    FILE *fp;               ///< Stream to read from
+    char *buffer;           ///< Block read ahead from the stream
+    size_t start;           ///< Buffer index of the first byte not returned yet
+    size_t end;             ///< Bytes in the buffer
+    size_t hashed;          ///< Buffer index of the first byte not hashed yet
+    int64_t position;       ///< File offset of the first byte not returned yet
+    bool eof;               ///< The end of file was reached
+    SHA_CTX *context;       ///< Hash context, or NULL
+} w_line_reader_t;
 
 
 /*** Function prototypes ***/
@@ -66,6 +87,37 @@ int reload_file(logreader * lf);
 /* Close file and save position */
 void close_file(logreader * lf);
 
+/**
+ * @brief Initialize a block-buffered line reader
+ *
+ * The reader reads the file ahead, so w_line_reader_release() must be called
+ * to move the stream to the last consumed position before returning.
+ *
+ * @param reader Reader to initialize
+ * @param fp Stream to read from
+ * @param position Current offset of the stream
+ * @param context Hash context to update with the consumed bytes, or NULL
+ */
+void w_line_reader_init(w_line_reader_t *reader, FILE *fp, int64_t position, SHA_CTX *context);
+
+/**
+ * @brief Get the next line, with the same semantics as fgets()
+ *
+ * @param reader Line reader
+ * @param str Output buffer
+ * @param size Size of the output buffer
+ * @return Number of bytes read, including the line feed and any zero byte, 0 at end of file
+ */
+int64_t w_line_reader_gets(w_line_reader_t *reader, char *str, size_t size);
+
+/**
+ * @brief Hash the bytes consumed up to a position, set the stream there and free the reader
+ *
+ * @param reader Line reader
+ * @param position Offset right after the last line processed
+ */
+void w_line_reader_release(w_line_reader_t *reader, int64_t position);
+
 /* Read syslog file */
 void *read_syslog(logreader *lf, int *rc, int drop_it);
 
@@ -101,12 +153,40 @@ void *read_multiline(logreader *lf, int *rc, int drop_it);
 /**
  * @brief Check if any logs should be ignored
  *
+ * @param ignore_pcre2 PCRE2 ignore expressions combined, NULL if they are in ignore_exp
  * @param ignore_exp List of ignore regex expressions to be checked
  * @param restrict_exp List of restrict regex expressions to be checked
  * @param log_line Log where to search for a match
  * @return 0 if log should be processed, 1 if log should be ignored
  */
-int check_ignore_and_restrict(OSList * ignore_exp, OSList * restrict_exp, const char *log_line);
+int check_ignore_and_restrict(w_expression_t * ignore_pcre2, OSList * ignore_exp, OSList * restrict_exp, const char *log_line);
+
+/**
+ * @brief Load the drop filters that the manager compiles from its agent_drop rules
+ *
+ * @param path JSON file with the filters, received in the shared configuration
+ * @return Number of filters loaded
+ */
+int w_drop_filters_load(const char * path);
+
+/**
+ * @brief Load the drop filters again if their file changed since the last load
+ *
+ * @param path JSON file with the filters
+ */
+void w_drop_filters_check(const char * path);
+
+/**
+ * @brief Check if a log matches a drop filter, so the manager would discard it
+ *
+ * The location is tested with the prefix that remoted adds to it, and the log without
+ * the header that the manager's pre-decoding removes.
+ *
+ * @param location File path or localfile location value
+ * @param log_line Log where to search for a match
+ * @return true if the log should be dropped
+ */
+bool w_drop_filters_match(const char * location, const char * log_line);
 
 /**
  * @brief Read multi line logs with variable lenght
@@ -131,6 +211,18 @@ void *read_macos(logreader *lf, int *rc, int drop_it);
 
 #endif
 
+#ifdef __linux__
+/**
+ * @brief Read the entries of the systemd journal
+ *
+ * @param lf status and configuration of the journald instance
+ * @param rc output parameter, returns zero
+ * @param drop_it if drop_it is different from 0, the logs will be read and discarded
+ * @return NULL
+ */
+void *read_journald(logreader *lf, int *rc, int drop_it);
+#endif
+
 /* Read DJB multilog format */
 /* Initializes multilog */
 int init_djbmultilog(logreader *lf);
@@ -177,6 +269,9 @@ extern int reload_interval;
 extern int reload_delay;
 extern int free_excluded_files_interval;
 extern int state_interval;
+#ifdef INOTIFY_ENABLED
+extern int use_inotify;
+#endif
 
 typedef enum {
     CONTINUE_IT,
@@ -218,6 +313,7 @@ typedef struct file_status {
     int64_t offset;  ///< Position to read
     SHA_CTX context;    ///< It stores the hashed data calculated so far
     os_sha1 hash;       ///< Content file SHA1 hash
+    bool pending;       ///< Loaded from the status file, the context isn't calculated yet
 } os_file_status_t;
 
 extern w_input_range_t *w_input_threads_range;
@@ -237,6 +333,9 @@ int w_msg_queue_push(w_msg_queue_t * msg, const char * buffer, char *file, unsig
 /* Pop message from the queue */
 w_message_t * w_msg_queue_pop(w_msg_queue_t * queue);
 
+/* Pop up to max messages from the queue, waiting until there is at least one */
+size_t w_msg_queue_pop_batch(w_msg_queue_t * queue, w_message_t ** messages, size_t max);
+
 /* Output processing thread*/
 #ifdef WIN32
 DWORD WINAPI w_output_thread(void * args);
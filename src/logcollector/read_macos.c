@@ -130,7 +130,7 @@ void * read_macos(logreader * lf, int * rc, __attribute__((unused)) int drop_it)
         size = strlen(read_buffer);
         if (size > 0) {
             /* Check ignore and restrict log regex, if configured. */
-            if (check_ignore_and_restrict(lf->regex_ignore, lf->regex_restrict, read_buffer)) {
+            if (check_ignore_and_restrict(lf->regex_ignore_pcre2, lf->regex_ignore, lf->regex_restrict, read_buffer)) {
                 continue;
             }
 
@@ -372,31 +372,32 @@ STATIC INLINE void w_macos_log_ctxt_clean(w_macos_log_ctxt_t * ctxt) {
 
 STATIC INLINE void w_macos_log_ctxt_backup(char * buffer, w_macos_log_ctxt_t * ctxt) {
 
-    /* Backup */
-    strncpy(ctxt->buffer, buffer, OS_MAXSTR - 1);
+    /* Backup only the used part, strncpy() would pad the whole buffer for every line */
+    size_t size = strnlen(buffer, OS_MAXSTR - 1);
+
+    memcpy(ctxt->buffer, buffer, size);
+    ctxt->buffer[size] = '\0';
     ctxt->timestamp = time(NULL);
 }
 
 STATIC char * w_macos_log_get_last_valid_line(char * str) {
 
-    char * retval = NULL;
-    char ignored_char = '\0';
     size_t size = 0;
 
     if (str == NULL || *str == '\0') {
-        return retval;
+        return NULL;
     }
 
-    /* Ignores the last character */
+    /* Ignores the last character and looks backwards, the last line is the shortest path */
     size = strlen(str);
 
-    ignored_char = str[size - 1];
-    str[size - 1] = '\0';
-
-    retval = strrchr(str, '\n');
-    str[size - 1] = ignored_char;
+    for (size_t i = size - 1; i > 0; i--) {
+        if (str[i - 1] == '\n') {
+            return str + i - 1;
+        }
+    }
 
-    return retval;
+    return NULL;
 }
 
 STATIC bool w_macos_is_log_header(w_macos_log_config_t * macos_log_cfg, char * buffer) {
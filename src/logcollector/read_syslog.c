@@ -22,8 +22,8 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
     char str[OS_MAXSTR + 1];
     int64_t current_position = 0;
     int lines = 0;
-    int64_t offset = 0;
     int64_t rbytes = 0;
+    w_line_reader_t reader;
 
     str[OS_MAXSTR] = '\0';
     *rc = 0;
@@ -34,20 +34,15 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
     SHA_CTX context;
     bool is_valid_context_file = w_get_hash_context(lf, &context, current_position);
 
-    for (offset = w_ftell(lf->fp); can_read() && fgets(str, OS_MAXSTR - OS_LOG_HEADER, lf->fp) != NULL && (!maximum_lines || lines < maximum_lines) && offset >= 0; offset += rbytes) {
-        rbytes = w_ftell(lf->fp) - offset;
-        lines++;
+    w_line_reader_init(&reader, lf->fp, current_position, is_valid_context_file ? &context : NULL);
 
-        /* Flow control */
-        if (rbytes <= 0) {
-            break;
-        }
+    while (can_read() && (!maximum_lines || lines < maximum_lines) && current_position >= 0 &&
+           (rbytes = w_line_reader_gets(&reader, str, OS_MAXSTR - OS_LOG_HEADER)) > 0) {
+        current_position = reader.position;
+        lines++;
 
         /* Get the last occurrence of \n */
         if (str[rbytes - 1] == '\n') {
-            if (is_valid_context_file) {
-                OS_SHA1_Stream(&context, NULL, str);
-            }
             str[rbytes - 1] = '\0';
 
             if ((int64_t)strlen(str) != rbytes - 1)
@@ -63,20 +58,15 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
         else if (rbytes == OS_MAXSTR - OS_LOG_HEADER - 1) {
             /* Message size > maximum allowed */
             __ms = 1;
-            if (is_valid_context_file) {
-                OS_SHA1_Stream(&context, NULL, str);
-            }
             str[rbytes - 1] = '\0';
         } else {
             /* We may not have gotten a line feed
              * because we reached EOF.
              */
-             if (feof(lf->fp)) {
+             if (reader.eof) {
                 /* Message not complete. Return. */
                 mdebug2("Message not complete from '%s'. Trying again: '%.*s'%s", lf->file, sample_log_length, str, rbytes > sample_log_length ? "..." : "");
-                if(current_position >= 0) {
-                    w_fseek(lf->fp, current_position, SEEK_SET);
-                }
+                current_position -= rbytes;
                 break;
             }
         }
@@ -90,13 +80,11 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
 
         /* Look for empty string (only on Windows) */
         if (rbytes <= 2) {
-            current_position = w_ftell(lf->fp);
             continue;
         }
 
         /* Windows can have comment on their logs */
         if (str[0] == '#') {
-            current_position = w_ftell(lf->fp);
             continue;
         }
 #endif
@@ -104,7 +92,7 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
         mdebug2("Reading syslog message: '%.*s'%s", sample_log_length, str, rbytes > sample_log_length ? "..." : "");
 
         /* Check ignore and restrict log regex, if configured. */
-        if (drop_it == 0 && !check_ignore_and_restrict(lf->regex_ignore, lf->regex_restrict, str)) {
+        if (drop_it == 0 && !check_ignore_and_restrict(lf->regex_ignore_pcre2, lf->regex_ignore, lf->regex_restrict, str)) {
             /* Send message to queue */
             w_msg_hash_queues_push(str, lf->file, rbytes, lf->log_target, LOCALFILE_MQ);
         }
@@ -121,28 +109,20 @@ void *read_syslog(logreader *lf, int *rc, int drop_it) {
                 mdebug2("Large message size from file '%s' (length = " FTELL_TT "): '%.*s'...", lf->file, FTELL_INT64 rbytes, sample_log_length, str);
             }
 
-            for (offset += rbytes; fgets(str, OS_MAXSTR - 2, lf->fp) != NULL; offset += rbytes) {
-                rbytes = w_ftell(lf->fp) - offset;
-
-                /* Flow control */
-                if (rbytes <= 0) {
-                    break;
-                }
-
-                if (is_valid_context_file) {
-                    OS_SHA1_Stream(&context, NULL, str);
-                }
-
-                /* Get the last occurrence of \n */
+            /* Discard the rest of the line */
+            while (rbytes = w_line_reader_gets(&reader, str, OS_MAXSTR - 2), rbytes > 0) {
                 if (str[rbytes - 1] == '\n') {
                     break;
                 }
             }
             __ms = 0;
         }
-        current_position = w_ftell(lf->fp);
+        current_position = reader.position;
     }
 
+    /* The stream was read ahead: set it after the last line processed */
+    w_line_reader_release(&reader, current_position);
+
     if (is_valid_context_file) {
         w_update_file_status(lf->file, current_position, &context);
     }
@@ -122,7 +122,7 @@ void *read_ucs2_be(logreader *lf, int *rc, int drop_it) {
                 continue;
             }
 
-            if (!check_ignore_and_restrict(lf->regex_ignore, lf->regex_restrict, utf8_string)) {
+            if (!check_ignore_and_restrict(lf->regex_ignore_pcre2, lf->regex_ignore, lf->regex_restrict, utf8_string)) {
                 w_msg_hash_queues_push(utf8_string, lf->file, utf8_bytes, lf->log_target, LOCALFILE_MQ);
             }
 
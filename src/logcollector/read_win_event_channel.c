@@ -20,6 +20,12 @@
 /* Bookmarks directory */
 #define BOOKMARKS_DIR "bookmarks"
 
+/* Maximum number of events fetched by each EvtNext() call */
+#define EVT_BATCH_SIZE 128
+
+/* Milliseconds to wait for new events before polling the subscription */
+#define EVT_WAIT_TIMEOUT 5000
+
 /* Logging levels */
 #define WINEVENT_AUDIT		0
 #define WINEVENT_CRITICAL	1
@@ -66,6 +72,9 @@ typedef struct _os_channel {
     char *query;
     int reconnect_time;
     EVT_HANDLE subscription;
+    HANDLE signal;          ///< Signaled by the service when new events are available
+    wchar_t *render_buffer; ///< Buffer reused to render the events
+    DWORD render_size;      ///< Size in bytes of render_buffer
 } os_channel;
 
 static char *get_message(EVT_HANDLE evt, LPCWSTR provider_name, DWORD flags);
@@ -379,9 +388,7 @@ cleanup:
 void send_channel_event(EVT_HANDLE evt, os_channel *channel)
 {
     DWORD buffer_length = 0;
-    PEVT_VARIANT properties_values = NULL;
     DWORD count = 0;
-    int result = 0;
     wchar_t *wprovider_name = NULL;
     char *msg_sent = NULL;
     char *provider_name = NULL;
@@ -396,44 +403,40 @@ void send_channel_event(EVT_HANDLE evt, os_channel *channel)
 
     os_malloc(OS_MAXSTR, provider_name);
 
-    result = EvtRender(NULL,
-                       evt,
-                       EvtRenderEventXml,
-                       0,
-                       NULL,
-                       &buffer_length,
-                       &count);
-    if (result != FALSE || GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
-        merror(
-            "Could not EvtRender() to determine buffer size for (%s) which returned (%lu)",
-            channel->evt_log,
-            GetLastError());
-        goto cleanup;
-    }
-
-    if ((properties_values = malloc(buffer_length)) == NULL) {
-        merror(
-            "Could not malloc() memory to process event (%s) which returned [(%d)-(%s)]",
-            channel->evt_log,
-            errno,
-            strerror(errno));
-        goto cleanup;
-    }
-
+    /* Render into the channel buffer, it only grows when an event doesn't fit */
     if (!EvtRender(NULL,
                    evt,
                    EvtRenderEventXml,
-                   buffer_length,
-                   properties_values,
+                   channel->render_size,
+                   channel->render_buffer,
                    &buffer_length,
                    &count)) {
-        merror(
-            "Could not EvtRender() for (%s) which returned (%lu)",
-            channel->evt_log,
-            GetLastError());
-        goto cleanup;
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+            merror(
+                "Could not EvtRender() for (%s) which returned (%lu)",
+                channel->evt_log,
+                GetLastError());
+            goto cleanup;
+        }
+
+        os_realloc(channel->render_buffer, buffer_length, channel->render_buffer);
+        channel->render_size = buffer_length;
+
+        if (!EvtRender(NULL,
+                       evt,
+                       EvtRenderEventXml,
+                       channel->render_size,
+                       channel->render_buffer,
+                       &buffer_length,
+                       &count)) {
+            merror(
+                "Could not EvtRender() for (%s) which returned (%lu)",
+                channel->evt_log,
+                GetLastError());
+            goto cleanup;
+        }
     }
-    xml_event = convert_windows_string((LPCWSTR) properties_values);
+    xml_event = convert_windows_string(channel->render_buffer);
 
     if (!xml_event) {
         goto cleanup;
@@ -490,15 +493,10 @@ void send_channel_event(EVT_HANDLE evt, os_channel *channel)
         w_logcollector_state_update_target(channel->evt_log, "agent", false);
     }
 
-    if (channel->bookmark_enabled) {
-        update_bookmark(evt, channel);
-    }
-
 cleanup:
     os_free(msg_from_prov);
     os_free(xml_event);
     os_free(msg_sent);
-    os_free(properties_values);
     os_free(provider_name);
     os_free(wprovider_name);
     cJSON_Delete(event_json);
@@ -509,7 +507,8 @@ cleanup:
 /**
  * @brief Destroy os_channel structure
  *
- * This function closes the subscription and frees the tructure, including bookmark_name.
+ * This function closes the subscription and frees the tructure, including bookmark_name
+ * and the render buffer.
  * Nothing happens if channel is NULL.
  *
  * @param channel Pointer to an os_channel structure.
@@ -524,28 +523,71 @@ void os_channel_destroy(os_channel * channel) {
             }
         }
 
+        if (channel->signal != NULL) {
+            CloseHandle(channel->signal);
+        }
+
+        free(channel->render_buffer);
         free(channel);
     }
 }
 
-DWORD WINAPI event_channel_callback(EVT_SUBSCRIBE_NOTIFY_ACTION action, os_channel *channel, EVT_HANDLE evt)
+/**
+ * @brief Read the events of a pull subscription
+ *
+ * Events are fetched in batches of EVT_BATCH_SIZE and the bookmark is saved once per batch.
+ * If the eventlog service goes down, the channel is subscribed again and this thread exits.
+ *
+ * @param arg Pointer to the os_channel structure.
+ */
+DWORD WINAPI event_channel_thread(void * arg)
 {
-    if (action == EvtSubscribeActionDeliver) {
-        send_channel_event(evt, channel);
-    } else {
-        mwarn("The eventlog service is down. Unable to collect logs from '%s' channel.", channel->evt_log);
-
-        while(1) {
-            /* Try to restart EventChannel */
-            if (win_start_event_channel(channel->evt_log, !channel->bookmark_enabled, channel->query, channel->reconnect_time) == -1) {
-                mdebug1("Trying to reconnect %s channel in %i seconds.", channel->evt_log, channel->reconnect_time );
-                sleep(channel->reconnect_time);
-            } else {
-                minfo("'%s' channel has been reconnected succesfully.", channel->evt_log);
-                os_channel_destroy(channel);
-                break;
+    os_channel *channel = (os_channel *)arg;
+    EVT_HANDLE events[EVT_BATCH_SIZE];
+    DWORD returned = 0;
+    DWORD i;
+
+    while (1) {
+        /* The wait expires to check that the service is still alive */
+        if (WaitForSingleObject(channel->signal, EVT_WAIT_TIMEOUT) == WAIT_FAILED) {
+            merror("Could not WaitForSingleObject() for (%s) which returned (%lu)", channel->evt_log, GetLastError());
+            break;
+        }
+
+        /* Events delivered from now on signal again */
+        ResetEvent(channel->signal);
+
+        while (EvtNext(channel->subscription, EVT_BATCH_SIZE, events, INFINITE, 0, &returned)) {
+            for (i = 0; i < returned; i++) {
+                send_channel_event(events[i], channel);
+            }
+
+            if (channel->bookmark_enabled && returned > 0) {
+                update_bookmark(events[returned - 1], channel);
+            }
+
+            for (i = 0; i < returned; i++) {
+                EvtClose(events[i]);
             }
         }
+
+        if (GetLastError() != ERROR_NO_MORE_ITEMS) {
+            break;
+        }
+    }
+
+    mwarn("The eventlog service is down. Unable to collect logs from '%s' channel.", channel->evt_log);
+
+    while(1) {
+        /* Try to restart EventChannel */
+        if (win_start_event_channel(channel->evt_log, !channel->bookmark_enabled, channel->query, channel->reconnect_time) == -1) {
+            mdebug1("Trying to reconnect %s channel in %i seconds.", channel->evt_log, channel->reconnect_time );
+            sleep(channel->reconnect_time);
+        } else {
+            minfo("'%s' channel has been reconnected succesfully.", channel->evt_log);
+            os_channel_destroy(channel);
+            break;
+        }
     }
 
     return (0);
@@ -622,23 +664,32 @@ int win_start_event_channel(char *evt_log, char future, char *query, int reconne
         }
     }
 
+    /* Pull subscription: the service signals this event when there are new events */
+    if ((channel->signal = CreateEvent(NULL, TRUE, TRUE, NULL)) == NULL) {
+        merror(
+            "Could not CreateEvent() for (%s) which returned (%lu)",
+            channel->evt_log,
+            GetLastError());
+        goto cleanup;
+    }
+
     channel->subscription = EvtSubscribe(NULL,
-                          NULL,
+                          channel->signal,
                           wchannel,
                           wquery,
                           bookmark,
-                          channel,
-                          (EVT_SUBSCRIBE_CALLBACK)event_channel_callback,
+                          NULL,
+                          NULL,
                           flags);
 
     if (channel->subscription == NULL && flags == EvtSubscribeStartAfterBookmark) {
         channel->subscription = EvtSubscribe(NULL,
-                              NULL,
+                              channel->signal,
                               wchannel,
                               wquery,
                               NULL,
-                              channel,
-                              (EVT_SUBSCRIBE_CALLBACK)event_channel_callback,
+                              NULL,
+                              NULL,
                               EvtSubscribeToFutureEvents);
     }
 
@@ -656,6 +707,13 @@ int win_start_event_channel(char *evt_log, char future, char *query, int reconne
     w_logcollector_state_add_file(channel->evt_log);
     w_logcollector_state_add_target(channel->evt_log, "agent");
 
+    w_create_thread(NULL,
+                 0,
+                 event_channel_thread,
+                 channel,
+                 0,
+                 NULL);
+
     /* Success */
     status = 1;
 
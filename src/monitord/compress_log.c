@@ -12,59 +12,139 @@
 #include "monitord.h"
 #include "../external/zlib/zlib.h"
 
+/* Size of the blocks read from the log file */
+#define COMPRESS_CHUNK  OS_SIZE_65536
+
+/* Read rate while compressing (bytes per second, 0 means no limit) */
+static unsigned long compress_rate = 0;
+
+void OS_CompressLog_SetRate(unsigned long rate)
+{
+    compress_rate = rate;
+}
+
+/* Wait until the compression rate allows processing 'size' bytes more */
+static void compress_rate_wait(size_t size, size_t *window_bytes, struct timespec *window_start)
+{
+    struct timespec now;
+    double elapsed;
+    double expected;
+
+    if (compress_rate == 0) {
+        return;
+    }
+
+    *window_bytes += size;
+
+    gettime(&now);
+    elapsed = time_diff(window_start, &now);
+    expected = (double)*window_bytes / compress_rate;
+
+    if (expected > elapsed) {
+        w_time_delay((unsigned long)((expected - elapsed) * 1000));
+    }
+
+    /* Start a new window every second, so that the read rate doesn't build up after a pause */
+    if (elapsed >= 1) {
+        gettime(window_start);
+        *window_bytes = 0;
+    }
+}
 
 /* gzip a log file */
 void OS_CompressLog(const char *logfile)
+{
+    OS_CompressLog_ex(logfile, NULL, NULL);
+}
+
+int OS_CompressLog_ex(const char *logfile, void (*callback)(const void *data, size_t len, void *arg), void *arg)
 {
     FILE *log;
     gzFile zlog;
 
     char logfileGZ[OS_FLSIZE + 1];
+    char logfileTMP[OS_FLSIZE + 1];
     int len, err;
 
-    char buf[OS_MAXSTR + 1];
+    char *buf;
+    size_t window_bytes = 0;
+    struct timespec window_start;
 
     /* Clear memory */
     memset(logfileGZ, '\0', OS_FLSIZE + 1);
-    memset(buf, '\0', OS_MAXSTR + 1);
 
     /* Set umask */
     umask(0027);
 
-    /* Create the gzip file name */
+    /* Create the gzip file name. analysisd may compress the rotated logs at the same time,
+     * so each process writes its own temporary file and renames it when complete */
     snprintf(logfileGZ, OS_FLSIZE, "%s.gz", logfile);
+    snprintf(logfileTMP, OS_FLSIZE, "%s.gz.%d", logfile, (int)getpid());
 
     /* Read log file */
     log = fopen(logfile, "r");
     if (!log) {
         /* Do not warn in here, since the alert file may not exist */
-        return;
+        return -1;
     }
 
     /* Open compressed file */
-    zlog = gzopen(logfileGZ, "w");
+    zlog = gzopen(logfileTMP, "w");
     if (!zlog) {
-        fclose(log);
-        merror(FOPEN_ERROR, logfileGZ, errno, strerror(errno));
-        return;
+        merror(FOPEN_ERROR, logfileTMP, errno, strerror(errno));
+
+        /* The file is still read if the caller needs its contents */
+        if (!callback) {
+            fclose(log);
+            return -1;
+        }
+    } else {
+        gzbuffer(zlog, COMPRESS_CHUNK);
     }
 
+    os_malloc(COMPRESS_CHUNK, buf);
+    gettime(&window_start);
+
     for (;;) {
-        len = (int) fread(buf, 1, OS_MAXSTR, log);
+        len = (int) fread(buf, 1, COMPRESS_CHUNK, log);
         if (len <= 0) {
             break;
         }
-        if (gzwrite(zlog, buf, (unsigned)len) != len) {
+
+        /* The checksums are computed in the same pass as the compression */
+        if (callback) {
+            callback(buf, (size_t)len, arg);
+        }
+
+        if (zlog && gzwrite(zlog, buf, (unsigned)len) != len) {
             merror("Compression error: %s", gzerror(zlog, &err));
         }
+
+        compress_rate_wait((size_t)len, &window_bytes, &window_start);
     }
 
+    os_free(buf);
     fclose(log);
-    gzclose(zlog);
 
-    /* Remove uncompressed file */
-    if ( unlink(logfile) == -1)
+    if (!zlog) {
+        return 0;
+    }
+
+    if (gzclose(zlog) != Z_OK) {
+        merror("Compression error: %s", logfileTMP);
+        unlink(logfileTMP);
+        return -1;
+    }
+
+    if (rename(logfileTMP, logfileGZ) == -1) {
+        merror(RENAME_ERROR, logfileTMP, logfileGZ, errno, strerror(errno));
+        unlink(logfileTMP);
+        return -1;
+    }
+
+    /* Remove uncompressed file, unless analysisd already did */
+    if (unlink(logfile) == -1 && errno != ENOENT)
         merror("Unable to delete '%s' due to '%s'", logfile, strerror(errno));
 
-    return;
+    return 0;
 }
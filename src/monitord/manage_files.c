@@ -33,27 +33,31 @@ void manage_files(int cday, int cmon, int cyear)
     manage_log(ALERTS, cday, cmon, cyear, &tm_result, "alerts", "log");
     manage_log(ALERTS, cday, cmon, cyear, &tm_result, "alerts", "json");
     manage_log(FWLOGS, cday, cmon, cyear, &tm_result, "firewall", "log");
+
+    /* The additional analysisd instances append their number to the tags */
+    for (int i = 1; i < mond.analysisd_instances; i++) {
+        char tag[OS_SIZE_32];
+
+        snprintf(tag, sizeof(tag), "archive-%d", i);
+        manage_log(EVENTS, cday, cmon, cyear, &tm_result, tag, "log");
+        manage_log(EVENTS, cday, cmon, cyear, &tm_result, tag, "json");
+
+        snprintf(tag, sizeof(tag), "alerts-%d", i);
+        manage_log(ALERTS, cday, cmon, cyear, &tm_result, tag, "log");
+        manage_log(ALERTS, cday, cmon, cyear, &tm_result, tag, "json");
+
+        snprintf(tag, sizeof(tag), "firewall-%d", i);
+        manage_log(FWLOGS, cday, cmon, cyear, &tm_result, tag, "log");
+    }
 }
 
 void manage_log(const char * logdir, int cday, int cmon, int cyear, const struct tm * pp_old, const char * tag, const char * ext) {
-    int i;
     char logfile[OS_FLSIZE + 1];
-    char logfile_r[OS_FLSIZE + 1];
     char logfile_old[OS_FLSIZE + 1];
 
     snprintf(logfile, OS_FLSIZE + 1, "%s/%d/%s/ossec-%s-%02d", logdir, cyear, months[cmon], tag, cday);
     snprintf(logfile_old, OS_FLSIZE + 1, "%s/%d/%s/ossec-%s-%02d", logdir, pp_old->tm_year + 1900, months[pp_old->tm_mon], tag, pp_old->tm_mday);
 
-    OS_SignLog(logfile, logfile_old, ext);
-
-    if (mond.compress) {
-        os_snprintf(logfile_r, OS_FLSIZE + 1, "%s.%s", logfile, ext);
-        OS_CompressLog(logfile_r);
-
-        for (i = 1; !IsFile(logfile_r) && FileSize(logfile_r) > 0; i++) {
-            if (os_snprintf(logfile_r, OS_FLSIZE + 1, "%s-%.3d.%s", logfile, i, ext) < OS_FLSIZE + 1) {
-                OS_CompressLog(logfile_r);
-            }
-        }
-    }
+    /* Signing reads the files once, compressing them in the same pass */
+    OS_SignLog(logfile, logfile_old, ext, mond.compress);
 }
@@ -113,6 +113,7 @@ cJSON *getMonitorInternalOptions(void) {
     cJSON_AddNumberToObject(monconf,"rotate_log",mond.rotate_log);
     cJSON_AddNumberToObject(monconf,"size_rotate",mond.size_rotate);
     cJSON_AddNumberToObject(monconf,"daily_rotations",mond.daily_rotations);
+    cJSON_AddNumberToObject(monconf,"compress_rate",mond.compress_rate);
     cJSON_AddNumberToObject(monconf,"delete_old_agents",mond.delete_old_agents);
 
     cJSON_AddItemToObject(root,"monitord",monconf);
@@ -178,6 +179,9 @@ int MonitordConfig(const char *cfg, monitor_config *mond, int no_agents, short d
     mond->keep_log_days = getDefine_Int("monitord", "keep_log_days", 0, 500);
     mond->size_rotate = (unsigned long) getDefine_Int("monitord", "size_rotate", 0, 4096) * 1024 * 1024;
     mond->daily_rotations = getDefine_Int("monitord", "daily_rotations", 1, 256);
+    mond->compress_rate = (unsigned long) getDefine_Int("monitord", "compress_rate", 0, 1048576) * 1024;
+    OS_CompressLog_SetRate(mond->compress_rate);
+    mond->analysisd_instances = getDefine_Int("remoted", "analysisd_instances", 1, ANALYSISD_INSTANCES_MAX);
     mond->delete_old_agents = (unsigned int)getDefine_Int("monitord", "delete_old_agents", 0, 9600);
 
     mond->agents = NULL;
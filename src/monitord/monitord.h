@@ -28,8 +28,26 @@
 void Monitord(void) __attribute__((noreturn));
 void manage_files(int cday, int cmon, int cyear);
 void generate_reports(int cday, int cmon, int cyear, const struct tm *p);
-void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext);
+void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext, int compress);
 void OS_CompressLog(const char *logfile);
+
+/**
+ * @brief gzip a log file and remove it, passing its contents to a callback in the same read
+ *
+ * @param logfile Path of the log file
+ * @param callback Function called with each block read, NULL to skip it
+ * @param arg Argument for the callback
+ * @retval 0 The file was read, even if it couldn't be compressed
+ * @retval -1 The file couldn't be read
+ */
+int OS_CompressLog_ex(const char *logfile, void (*callback)(const void *data, size_t len, void *arg), void *arg);
+
+/**
+ * @brief Set the read rate while compressing log files
+ *
+ * @param rate Bytes per second, 0 means no limit
+ */
+void OS_CompressLog_SetRate(unsigned long rate);
 void w_rotate_log(int compress, int keep_log_days, int new_day, int rotate_json, int daily_rotations);
 int delete_old_agent(const char *agent_id);
 int MonitordConfig(const char *cfg, monitor_config *mond, int no_agents, short day_wait);
@@ -13,11 +13,92 @@
 #include "os_crypto/sha1/sha1_op.h"
 #include "os_crypto/sha256/sha256_op.h"
 #include "monitord.h"
+#include "../external/zlib/zlib.h"
 #include <openssl/md5.h>
 #include <openssl/sha.h>
 
+/* Checksums of the log file being signed */
+typedef struct {
+    MD5_CTX md5;
+    SHA_CTX sha1;
+    SHA256_CTX sha256;
+} sign_ctx_t;
+
+/* Update the checksums with a block of the log file */
+static void sign_log_update(const void *data, size_t len, void *arg)
+{
+    sign_ctx_t *ctx = (sign_ctx_t *)arg;
+
+    SHA1_Update(&ctx->sha1, data, len);
+    MD5_Update(&ctx->md5, data, (unsigned long)len);
+    SHA256_Update(&ctx->sha256, data, len);
+}
+
+/* Read a log file already compressed by analysisd into the checksums */
+static int sign_log_file_gz(const char *path, sign_ctx_t *ctx)
+{
+    char path_gz[OS_FLSIZE + 1];
+    char buffer[OS_SIZE_8192];
+    gzFile zlog;
+    int n;
+
+    snprintf(path_gz, OS_FLSIZE + 1, "%s.gz", path);
+
+    if (zlog = gzopen(path_gz, "rb"), !zlog) {
+        return -1;
+    }
+
+    while (n = gzread(zlog, buffer, sizeof(buffer)), n > 0) {
+        sign_log_update(buffer, (size_t)n, ctx);
+    }
+
+    gzclose(zlog);
+    return 0;
+}
+
+/* Check whether a log file exists, either plain or compressed after its rotation */
+static int sign_log_exists(const char *path)
+{
+    char path_gz[OS_FLSIZE + 1];
+
+    if (!IsFile(path) && FileSize(path) > 0) {
+        return 1;
+    }
+
+    snprintf(path_gz, OS_FLSIZE + 1, "%s.gz", path);
+    return !IsFile(path_gz);
+}
+
+/* Read a log file into the checksums, compressing it in the same pass if requested */
+static int sign_log_file(const char *path, sign_ctx_t *ctx, int compress)
+{
+    char buffer[OS_SIZE_8192];
+    FILE *fp;
+    size_t n;
+
+    /* The rotated files may have been compressed by analysisd already */
+    if (IsFile(path)) {
+        return sign_log_file_gz(path, ctx);
+    }
+
+    if (compress) {
+        return OS_CompressLog_ex(path, sign_log_update, ctx);
+    }
+
+    if (fp = fopen(path, "r"), !fp) {
+        return -1;
+    }
+
+    while (n = fread(buffer, 1, sizeof(buffer), fp), n > 0) {
+        sign_log_update(buffer, n, ctx);
+    }
+
+    fclose(fp);
+    return 0;
+}
+
 /* Sign a log file */
-void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext)
+void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext, int compress)
 {
     int i;
     size_t n;
@@ -31,14 +112,11 @@ void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext)
     os_sha256 sf256_sum;
     os_sha256 sf256_sum_old;
 
-    SHA_CTX sha1_ctx;
-    MD5_CTX md5_ctx;
-    SHA256_CTX sha256_ctx;
+    sign_ctx_t ctx;
 
     char logfilesum[OS_FLSIZE + 1];
     char logfilesum_old[OS_FLSIZE + 1];
     char logfile_r[OS_FLSIZE + 1];
-    char buffer[4096];
 
     FILE *fp;
 
@@ -58,9 +136,9 @@ void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext)
     os_snprintf(logfilesum, OS_FLSIZE, "%s.sum", logfile_r);
     snprintf(logfilesum_old, OS_FLSIZE, "%s.%s.sum", logfile_old, ext);
 
-    MD5_Init(&md5_ctx);
-    SHA1_Init(&sha1_ctx);
-    SHA256_Init(&sha256_ctx);
+    MD5_Init(&ctx.md5);
+    SHA1_Init(&ctx.sha1);
+    SHA256_Init(&ctx.sha256);
 
     /* Generate MD5 of the old file */
     if (OS_MD5_File(logfilesum_old, mf_sum_old, OS_TEXT) < 0) {
@@ -85,47 +163,32 @@ void OS_SignLog(const char *logfile, const char *logfile_old, const char * ext)
 
     /* Generate MD5, SHA-1, and SHA-256 of the current file */
 
-    if (fp = fopen(logfile_r, "r"), fp) {
-        while (n = fread(buffer, 1, 2048, fp), n > 0) {
-            SHA1_Update(&sha1_ctx, buffer, n);
-            MD5_Update(&md5_ctx, buffer, (unsigned long)n);
-            SHA256_Update(&sha256_ctx, buffer, n);
-        }
-
-        fclose(fp);
+    if (sign_log_file(logfile_r, &ctx, compress) == 0) {
 
         // Include rotated files
 
-        for (i = 1; snprintf(logfile_r, OS_FLSIZE + 1, "%s-%.3d.%s", logfile, i, ext), !IsFile(logfile_r) && FileSize(logfile_r) > 0; i++) {
-            if (fp = fopen(logfile_r, "r"), fp) {
-                while (n = fread(buffer, 1, 2048, fp), n > 0) {
-                    SHA1_Update(&sha1_ctx, buffer, n);
-                    MD5_Update(&md5_ctx, buffer, (unsigned long)n);
-                    SHA256_Update(&sha256_ctx, buffer, n);
-                }
-
-                fclose(fp);
-            } else {
+        for (i = 1; snprintf(logfile_r, OS_FLSIZE + 1, "%s-%.3d.%s", logfile, i, ext), sign_log_exists(logfile_r); i++) {
+            if (sign_log_file(logfile_r, &ctx, compress) < 0) {
                 merror(FOPEN_ERROR, logfile_r, errno, strerror(errno));
                 break;
             }
         }
 
-        MD5_Final(md5_digest, &md5_ctx);
+        MD5_Final(md5_digest, &ctx.md5);
         char *mpos = mf_sum;
         for (n = 0; n < 16; n++) {
             snprintf(mpos, 3, "%02x", md5_digest[n]);
             mpos += 2;
         }
 
-        SHA1_Final(&(md[0]), &sha1_ctx);
+        SHA1_Final(&(md[0]), &ctx.sha1);
         char *spos = sf_sum;
         for (n = 0; n < SHA_DIGEST_LENGTH; n++) {
             snprintf(spos, 3, "%02x", md[n]);
             spos += 2;
         }
 
-        SHA256_Final(&(md256[0]), &sha256_ctx);
+        SHA256_Final(&(md256[0]), &ctx.sha256);
         char *sspos = sf256_sum;
         for (n = 0; n < SHA256_DIGEST_LENGTH; n++) {
             snprintf(sspos, 3, "%02x", md256[n]);
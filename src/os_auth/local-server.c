@@ -59,9 +59,33 @@ static const struct {
 // Dispatch local request
 static char* local_dispatch(const char *input);
 
+// Parse the force insertion options of an add request, returns -1 on success or the error index
+static int local_parse_force(cJSON *force, authd_force_options_t *force_options);
+
+// Add an agent, the caller must hold mutex_keys and wake up the writer
+static cJSON* local_add_locked(const char *id,
+                               const char *name,
+                               const char *ip,
+                               const char *groups,
+                               const char *key,
+                               const char *key_hash,
+                               authd_force_options_t *force_options);
+
+// Add an array of agents holding the keys lock once
+static cJSON* local_add_bulk(cJSON *agents, authd_force_options_t *force_options);
+
 // Remove an agent
 static cJSON* local_remove(const char *id, int purge);
 
+// Remove an agent, the caller must hold mutex_keys and wake up the writer
+static cJSON* local_remove_locked(const char *id, int purge);
+
+// Remove an array of agents holding the keys lock once
+static cJSON* local_remove_bulk(cJSON *ids, int purge);
+
+// Generates a bulk response with the result of every item
+static cJSON* local_create_bulk_response(cJSON *results);
+
 // Get agent data
 static cJSON* local_get(const char *id);
 
@@ -197,7 +221,6 @@ char* local_dispatch(const char *input) {
         if (!strcmp(function->valuestring, "add")) {
             cJSON *item = NULL;
             cJSON *force = NULL;
-            cJSON *disconnected_time = NULL;
             char *id = NULL;
             char *name = NULL;
             char *ip = NULL;
@@ -236,51 +259,53 @@ char* local_dispatch(const char *input) {
             key = (item = cJSON_GetObjectItem(arguments, "key"), item) ? item->valuestring : NULL;
 
             if (force = cJSON_GetObjectItem(arguments, "force"), force) {
-                if (item = cJSON_GetObjectItem(force, "enabled"), !item) {
-                    ierror = EJSON;
+                if (ierror = local_parse_force(force, &force_options), ierror >= 0) {
                     goto fail;
                 }
-                force_options.enabled = (bool)item->valueint;
+            }
 
-                if (item = cJSON_GetObjectItem(force, "key_mismatch"), !item) {
-                    ierror = EJSON;
-                    goto fail;
-                }
-                force_options.key_mismatch = (bool)item->valueint;
+            response = local_add(id, name, ip, groups, key, key_hash, force ? &force_options : &config.force_options);
 
-                if (disconnected_time = cJSON_GetObjectItem(force, "disconnected_time"), !disconnected_time) {
-                    ierror = EJSON;
-                    goto fail;
-                }
+            os_free(groups);
+        } else if (!strcmp(function->valuestring, "add_bulk")) {
+            cJSON *agents;
+            cJSON *force;
+            authd_force_options_t force_options = {0};
 
-                if (item = cJSON_GetObjectItem(disconnected_time, "enabled"), !item) {
-                    ierror = EJSON;
-                    goto fail;
-                }
-                force_options.disconnected_time_enabled = (bool)item->valueint;
+            if (arguments = cJSON_GetObjectItem(request, "arguments"), !arguments) {
+                ierror = ENOARGUMENT;
+                goto fail;
+            }
 
-                item = cJSON_GetObjectItem(disconnected_time, "value");
-                if(cJSON_IsNumber(item)) {
-                    force_options.disconnected_time = item->valueint;
-                }
-                else if (!cJSON_IsString(item) || get_time_interval(item->valuestring, &force_options.disconnected_time)) {
-                    ierror = EJSON;
-                    goto fail;
-                }
+            if (agents = cJSON_GetObjectItem(arguments, "agents"), !cJSON_IsArray(agents)) {
+                ierror = ENOARGUMENT;
+                goto fail;
+            }
 
-                item = cJSON_GetObjectItem(force, "after_registration_time");
-                if(cJSON_IsNumber(item)) {
-                    force_options.after_registration_time = item->valueint;
-                }
-                else if (!cJSON_IsString(item) || get_time_interval(item->valuestring, &force_options.after_registration_time)) {
-                    ierror = EJSON;
+            if (force = cJSON_GetObjectItem(arguments, "force"), force) {
+                if (ierror = local_parse_force(force, &force_options), ierror >= 0) {
                     goto fail;
                 }
             }
 
-            response = local_add(id, name, ip, groups, key, key_hash, force ? &force_options : &config.force_options);
+            response = local_add_bulk(agents, force ? &force_options : &config.force_options);
+        } else if (!strcmp(function->valuestring, "remove_bulk")) {
+            cJSON *ids;
+            int purge;
 
-            os_free(groups);
+            if (arguments = cJSON_GetObjectItem(request, "arguments"), !arguments) {
+                ierror = ENOARGUMENT;
+                goto fail;
+            }
+
+            if (ids = cJSON_GetObjectItem(arguments, "ids"), !cJSON_IsArray(ids)) {
+                ierror = ENOID;
+                goto fail;
+            }
+
+            purge = cJSON_IsTrue(cJSON_GetObjectItem(arguments, "purge"));
+
+            response = local_remove_bulk(ids, purge);
         } else if (!strcmp(function->valuestring, "remove")) {
             cJSON *item;
             int purge;
@@ -342,6 +367,49 @@ fail:
     return output;
 }
 
+// Parse the force insertion options of an add request
+int local_parse_force(cJSON *force, authd_force_options_t *force_options) {
+    cJSON *item;
+    cJSON *disconnected_time;
+
+    if (item = cJSON_GetObjectItem(force, "enabled"), !item) {
+        return EJSON;
+    }
+    force_options->enabled = (bool)item->valueint;
+
+    if (item = cJSON_GetObjectItem(force, "key_mismatch"), !item) {
+        return EJSON;
+    }
+    force_options->key_mismatch = (bool)item->valueint;
+
+    if (disconnected_time = cJSON_GetObjectItem(force, "disconnected_time"), !disconnected_time) {
+        return EJSON;
+    }
+
+    if (item = cJSON_GetObjectItem(disconnected_time, "enabled"), !item) {
+        return EJSON;
+    }
+    force_options->disconnected_time_enabled = (bool)item->valueint;
+
+    item = cJSON_GetObjectItem(disconnected_time, "value");
+    if(cJSON_IsNumber(item)) {
+        force_options->disconnected_time = item->valueint;
+    }
+    else if (!cJSON_IsString(item) || get_time_interval(item->valuestring, &force_options->disconnected_time)) {
+        return EJSON;
+    }
+
+    item = cJSON_GetObjectItem(force, "after_registration_time");
+    if(cJSON_IsNumber(item)) {
+        force_options->after_registration_time = item->valueint;
+    }
+    else if (!cJSON_IsString(item) || get_time_interval(item->valuestring, &force_options->after_registration_time)) {
+        return EJSON;
+    }
+
+    return -1;
+}
+
 cJSON* local_add(const char *id,
                  const char *name,
                  const char *ip,
@@ -349,6 +417,28 @@ cJSON* local_add(const char *id,
                  const char *key,
                  const char *key_hash,
                  authd_force_options_t *force_options) {
+    cJSON *response = NULL;
+
+    w_mutex_lock(&mutex_keys);
+
+    response = local_add_locked(id, name, ip, groups, key, key_hash, force_options);
+
+    if (write_pending) {
+        w_cond_signal(&cond_pending);
+    }
+
+    w_mutex_unlock(&mutex_keys);
+    return response;
+}
+
+// Add an agent, the caller must hold mutex_keys and wake up the writer
+cJSON* local_add_locked(const char *id,
+                        const char *name,
+                        const char *ip,
+                        const char *groups,
+                        const char *key,
+                        const char *key_hash,
+                        authd_force_options_t *force_options) {
     int index;
     cJSON *response = NULL;
     int ierror;
@@ -356,7 +446,6 @@ cJSON* local_add(const char *id,
     char _ip[IPSIZE + 1] = {0};
 
     mdebug2("add(%s)", name);
-    w_mutex_lock(&mutex_keys);
 
     /* Check if groups are valid to be aggregated */
     if (groups) {
@@ -430,46 +519,125 @@ cJSON* local_add(const char *id,
     /* Add pending key to write */
     add_insert(keys.keyentries[index],groups);
     write_pending = 1;
-    w_cond_signal(&cond_pending);
 
     response = local_create_agent_response(keys.keyentries[index]->id, name, _ip, keys.keyentries[index]->raw_key);
-    w_mutex_unlock(&mutex_keys);
 
     minfo("Agent key generated for agent '%s' (requested locally)", name);
     os_free(str_result);
     return response;
 
 fail:
-    w_mutex_unlock(&mutex_keys);
     response = local_create_error_response(ERRORS[ierror].code, ERRORS[ierror].message);
     os_free(str_result);
     return response;
 }
 
+// Add an array of agents holding the keys lock once
+cJSON* local_add_bulk(cJSON *agents, authd_force_options_t *force_options) {
+    cJSON *results = cJSON_CreateArray();
+    cJSON *agent;
+    cJSON *item;
+    char *name;
+    char *ip;
+    char *groups;
+    int ierror;
+
+    mdebug2("add_bulk(%d)", cJSON_GetArraySize(agents));
+
+    /* Every agent is validated and inserted in the same critical section,
+     * so the writer flushes the keys file once for the whole request */
+    w_mutex_lock(&mutex_keys);
+
+    cJSON_ArrayForEach(agent, agents) {
+        groups = NULL;
+
+        if (name = cJSON_GetStringValue(cJSON_GetObjectItem(agent, "name")), !name) {
+            ierror = ENONAME;
+        } else if (ip = cJSON_GetStringValue(cJSON_GetObjectItem(agent, "ip")), !ip) {
+            ierror = ENOIP;
+        } else if (item = cJSON_GetObjectItem(agent, "groups"), item && !(groups = wstr_delete_repeated_groups(item->valuestring))) {
+            ierror = EINVGROUP;
+        } else {
+            cJSON_AddItemToArray(results, local_add_locked(cJSON_GetStringValue(cJSON_GetObjectItem(agent, "id")),
+                                                           name, ip, groups,
+                                                           cJSON_GetStringValue(cJSON_GetObjectItem(agent, "key")),
+                                                           cJSON_GetStringValue(cJSON_GetObjectItem(agent, "key_hash")),
+                                                           force_options));
+            os_free(groups);
+            continue;
+        }
+
+        mdebug1("Error %d: %s.", ERRORS[ierror].code, ERRORS[ierror].message);
+        cJSON_AddItemToArray(results, local_create_error_response(ERRORS[ierror].code, ERRORS[ierror].message));
+    }
+
+    if (write_pending) {
+        w_cond_signal(&cond_pending);
+    }
+
+    w_mutex_unlock(&mutex_keys);
+    return local_create_bulk_response(results);
+}
+
 // Remove an agent
 cJSON* local_remove(const char *id, int purge) {
-    int index;
     cJSON *response = NULL;
 
-    mdebug2("local_remove(id='%s', purge=%d)", id, purge);
-
     w_mutex_lock(&mutex_keys);
 
+    response = local_remove_locked(id, purge);
+
+    if (write_pending) {
+        w_cond_signal(&cond_pending);
+    }
+
+    w_mutex_unlock(&mutex_keys);
+    return response;
+}
+
+// Remove an agent, the caller must hold mutex_keys and wake up the writer
+cJSON* local_remove_locked(const char *id, int purge) {
+    int index;
+
+    mdebug2("local_remove(id='%s', purge=%d)", id, purge);
+
     if (index = OS_IsAllowedID(&keys, id), index < 0) {
         mdebug1("Error %d: %s.", ERRORS[ENOAGENT].code, ERRORS[ENOAGENT].message);
-        response = local_create_error_response(ERRORS[ENOAGENT].code, ERRORS[ENOAGENT].message);
-    } else {
-        minfo("Agent '%s' (%s) deleted (requested locally)", id, keys.keyentries[index]->name);
-        /* Add pending key to write */
-        add_remove(keys.keyentries[index]);
-        OS_DeleteKey(&keys, id, purge);
-        write_pending = 1;
+        return local_create_error_response(ERRORS[ENOAGENT].code, ERRORS[ENOAGENT].message);
+    }
+
+    minfo("Agent '%s' (%s) deleted (requested locally)", id, keys.keyentries[index]->name);
+    /* Add pending key to write */
+    add_remove(keys.keyentries[index]);
+    OS_DeleteKey(&keys, id, purge);
+    write_pending = 1;
+
+    return local_create_agent_delete_response();
+}
+
+// Remove an array of agents holding the keys lock once
+cJSON* local_remove_bulk(cJSON *ids, int purge) {
+    cJSON *results = cJSON_CreateArray();
+    cJSON *item;
+
+    mdebug2("remove_bulk(%d)", cJSON_GetArraySize(ids));
+    w_mutex_lock(&mutex_keys);
+
+    cJSON_ArrayForEach(item, ids) {
+        if (!cJSON_IsString(item)) {
+            mdebug1("Error %d: %s.", ERRORS[ENOID].code, ERRORS[ENOID].message);
+            cJSON_AddItemToArray(results, local_create_error_response(ERRORS[ENOID].code, ERRORS[ENOID].message));
+        } else {
+            cJSON_AddItemToArray(results, local_remove_locked(item->valuestring, purge));
+        }
+    }
+
+    if (write_pending) {
         w_cond_signal(&cond_pending);
-        response = local_create_agent_delete_response();
     }
 
     w_mutex_unlock(&mutex_keys);
-    return response;
+    return local_create_bulk_response(results);
 }
 
 // Get agent data
@@ -519,6 +687,17 @@ static cJSON* local_create_agent_delete_response(void) {
     return response;
 }
 
+// Generates a bulk response with the result of every item
+cJSON* local_create_bulk_response(cJSON *results) {
+    cJSON *response = NULL;
+
+    response = cJSON_CreateObject();
+    cJSON_AddNumberToObject(response, "error", 0);
+    cJSON_AddItemToObject(response, "data", results);
+
+    return response;
+}
+
 // Generates an error json response
 static cJSON* local_create_error_response(int code, const char *message) {
     cJSON *response = NULL;
@@ -60,6 +60,7 @@ static int remote_sock = -1;
 
 /* client queue */
 static w_queue_t *client_queue = NULL;
+static int dispatcher_threads = 1;
 
 volatile int write_pending = 0;
 volatile int running = 1;
@@ -131,13 +132,14 @@ int main(int argc, char **argv)
     int debug_level = 0;
     int test_config = 0;
     int status;
+    int i;
     int run_foreground = 0;
     gid_t gid;
     const char *group = GROUPGLOBAL;
     char buf[4096 + 1];
 
     pthread_t thread_local_server = 0;
-    pthread_t thread_dispatcher = 0;
+    pthread_t *thread_dispatcher = NULL;
     pthread_t thread_remote_server = 0;
     pthread_t thread_writer = 0;
     pthread_t thread_key_request = 0;
@@ -394,6 +396,8 @@ int main(int argc, char **argv)
             merror_exit(CONFIG_ERROR, OSSECCONF);
         }
 
+        dispatcher_threads = getDefine_Int("auth", "dispatcher_threads", 1, 64);
+
         // Overwrite arguments
 
         if (use_pass) {
@@ -595,10 +599,13 @@ int main(int argc, char **argv)
 
     if (config.flags.remote_enrollment) {
         client_queue = queue_init(AUTH_POOL);
+        os_calloc(dispatcher_threads, sizeof(pthread_t), thread_dispatcher);
 
-        if (status = pthread_create(&thread_dispatcher, NULL, (void *)&run_dispatcher, NULL), status != 0) {
-            merror("Couldn't create thread: %s", strerror(status));
-            return EXIT_FAILURE;
+        for (i = 0; i < dispatcher_threads; i++) {
+            if (status = pthread_create(&thread_dispatcher[i], NULL, (void *)&run_dispatcher, NULL), status != 0) {
+                merror("Couldn't create thread: %s", strerror(status));
+                return EXIT_FAILURE;
+            }
         }
 
         if (status = pthread_create(&thread_remote_server, NULL, (void *)&run_remote_server, NULL), status != 0) {
@@ -626,8 +633,12 @@ int main(int argc, char **argv)
     /* Join threads */
     pthread_join(thread_local_server, NULL);
     if (config.flags.remote_enrollment) {
-        pthread_join(thread_dispatcher, NULL);
+        for (i = 0; i < dispatcher_threads; i++) {
+            pthread_join(thread_dispatcher[i], NULL);
+        }
+        os_free(thread_dispatcher);
         pthread_join(thread_remote_server, NULL);
+        SSL_CTX_free(ctx);
     }
     if (!config.worker_node) {
         /* Send signal to writer thread */
@@ -786,14 +797,17 @@ void* run_dispatcher(__attribute__((unused)) void *arg) {
                     merror("Agent key not saved for %s", agentname);
                     ERR_print_errors_fp(stderr);
                     w_mutex_lock(&mutex_keys);
-                    OS_DeleteKey(&keys, keys.keyentries[keys.keysize - 1]->id, 1);
+                    OS_DeleteKey(&keys, new_id, 1);
                     w_mutex_unlock(&mutex_keys);
                 } else {
-                    /* Add pending key to write */
+                    /* Add pending key to write. Other threads may have added keys since this one */
                     w_mutex_lock(&mutex_keys);
-                    add_insert(keys.keyentries[keys.keysize - 1], centralized_group);
-                    write_pending = 1;
-                    w_cond_signal(&cond_pending);
+                    int index = OS_IsAllowedID(&keys, new_id);
+                    if (index >= 0) {
+                        add_insert(keys.keyentries[index], centralized_group);
+                        write_pending = 1;
+                        w_cond_signal(&cond_pending);
+                    }
                     w_mutex_unlock(&mutex_keys);
                 }
             }
@@ -822,7 +836,6 @@ void* run_dispatcher(__attribute__((unused)) void *arg) {
 
     mdebug1("Dispatch thread finished");
 
-    SSL_CTX_free(ctx);
     return NULL;
 }
 
@@ -923,6 +936,9 @@ void* run_writer(__attribute__((unused)) void *arg) {
     char wdbquery[OS_SIZE_128];
     char wdboutput[128];
     int wdb_sock = -1;
+    /* Keys known to be in client.keys. New keys are appended while nothing is removed */
+    unsigned int keys_written = 0;
+    unsigned int keys_deleted = 0;
 
     authd_sigblock();
 
@@ -955,25 +971,52 @@ void* run_writer(__attribute__((unused)) void *arg) {
         write_pending = 0;
         w_mutex_unlock(&mutex_keys);
 
+        for (cur = copy_insert; cur; cur = cur->next) {
+            inserted_agents++;
+        }
+
         gettime(&t0);
 
-        if (OS_WriteKeys(copy_keys) < 0) {
-            merror("Couldn't write file client.keys");
-            sleep(1);
-        }
+        /* Only new keys: append them instead of rewriting the files. Any deletion, even of a key
+         * that was never written, moves the last key to its slot, so the files are rewritten */
+        if (keys_written > 0 && !copy_remove && copy_keys->deleted == keys_deleted &&
+            copy_keys->keysize == keys_written + inserted_agents) {
+            if (OS_AppendKeys(copy_keys, keys_written) < 0 || OS_AppendTimestamps(copy_keys, keys_written) < 0) {
+                merror("Couldn't append keys to client.keys");
+                keys_written = 0;
+                sleep(1);
+            } else {
+                keys_written = copy_keys->keysize;
+            }
 
-        gettime(&t1);
-        mdebug2("[Writer] OS_WriteKeys(): %d µs.", (int)(1000000. * (double)time_diff(&t0, &t1)));
+            gettime(&t1);
+            mdebug2("[Writer] OS_AppendKeys(): %d µs.", (int)(1000000. * (double)time_diff(&t0, &t1)));
+        } else {
+            keys_written = copy_keys->keysize;
+            keys_deleted = copy_keys->deleted;
 
-        gettime(&t0);
+            if (OS_WriteKeys(copy_keys) < 0) {
+                merror("Couldn't write file client.keys");
+                keys_written = 0;
+                sleep(1);
+            }
+
+            gettime(&t1);
+            mdebug2("[Writer] OS_WriteKeys(): %d µs.", (int)(1000000. * (double)time_diff(&t0, &t1)));
 
-        if (OS_WriteTimestamps(copy_keys) < 0) {
-            merror("Couldn't write file agents-timestamp.");
-            sleep(1);
+            gettime(&t0);
+
+            if (OS_WriteTimestamps(copy_keys) < 0) {
+                merror("Couldn't write file agents-timestamp.");
+                keys_written = 0;
+                sleep(1);
+            }
+
+            gettime(&t1);
+            mdebug2("[Writer] OS_WriteTimestamps(): %d µs.", (int)(1000000. * (double)time_diff(&t0, &t1)));
         }
 
-        gettime(&t1);
-        mdebug2("[Writer] OS_WriteTimestamps(): %d µs.", (int)(1000000. * (double)time_diff(&t0, &t1)));
+        inserted_agents = 0;
 
         OS_FreeKeys(copy_keys);
         os_free(copy_keys);
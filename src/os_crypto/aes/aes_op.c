@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <openssl/conf.h>
 #include <openssl/evp.h>
@@ -19,6 +20,36 @@
 
 typedef unsigned char uchar;
 
+/* Cipher context of the calling thread, the key schedule buffers are reused across calls */
+static pthread_key_t aes_ctx_key;
+static pthread_once_t aes_ctx_once = PTHREAD_ONCE_INIT;
+
+static void aes_ctx_key_init()
+{
+    pthread_key_create(&aes_ctx_key, (void (*)(void *))EVP_CIPHER_CTX_free);
+}
+
+static EVP_CIPHER_CTX *aes_get_ctx()
+{
+    EVP_CIPHER_CTX *ctx;
+
+    pthread_once(&aes_ctx_once, aes_ctx_key_init);
+
+    if (ctx = pthread_getspecific(aes_ctx_key), !ctx) {
+        if (ctx = EVP_CIPHER_CTX_new(), ctx) {
+            pthread_setspecific(aes_ctx_key, ctx);
+        }
+    }
+
+    return ctx;
+}
+
+/* The cipher is only set the first time, so that the context keeps its buffers */
+static const EVP_CIPHER *aes_get_cipher(EVP_CIPHER_CTX *ctx)
+{
+    return EVP_CIPHER_CTX_cipher(ctx) ? NULL : EVP_aes_256_cbc();
+}
+
 
 int OS_AES_Str(const char *input, char *output, const char *charkey,
               long size, short int action)
@@ -42,11 +73,11 @@ int encrypt_AES(const unsigned char *plaintext, int plaintext_len, unsigned char
 	int len;
 	int ciphertext_len = 0;
 
-	if (!(ctx = EVP_CIPHER_CTX_new())) {
-        goto end;
+	if (!(ctx = aes_get_ctx())) {
+        return 0;
     }
 
-	if (1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv)) {
+	if (1 != EVP_EncryptInit_ex(ctx, aes_get_cipher(ctx), NULL, key, iv)) {
         goto end;
     }
 
@@ -64,7 +95,6 @@ int encrypt_AES(const unsigned char *plaintext, int plaintext_len, unsigned char
 	ciphertext_len += len;
 
 end:
-	EVP_CIPHER_CTX_free(ctx);
 	return ciphertext_len;
 }
 
@@ -75,11 +105,11 @@ int decrypt_AES(const unsigned char *ciphertext, int ciphertext_len, unsigned ch
 	int len;
 	int plaintext_len = 0;
 
-	if (!(ctx = EVP_CIPHER_CTX_new())) {
-        goto end;
+	if (!(ctx = aes_get_ctx())) {
+        return 0;
     }
 
-	if (1 != EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv)) {
+	if (1 != EVP_DecryptInit_ex(ctx, aes_get_cipher(ctx), NULL, key, iv)) {
         goto end;
     }
 
@@ -97,6 +127,5 @@ int decrypt_AES(const unsigned char *ciphertext, int ciphertext_len, unsigned ch
 	plaintext_len += len;
 
 end:
-	EVP_CIPHER_CTX_free(ctx);
 	return plaintext_len;
 }
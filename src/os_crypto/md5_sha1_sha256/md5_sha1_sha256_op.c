@@ -13,10 +13,14 @@
 #include <string.h>
 
 #include "md5_sha1_sha256_op.h"
-#include <openssl/md5.h>
-#include <openssl/sha.h>
+#include <openssl/evp.h>
 #include "headers/defs.h"
 
+/* Files are read in big chunks, so most of the time is spent in the digest routines */
+#define OS_HASH_BUFFER_SIZE OS_SIZE_65536
+
+#define OS_HASH_DIGESTS 3
+
 
 int OS_MD5_SHA1_SHA256_File(const char *fname,
                             char **prefilter_cmd,
@@ -28,21 +32,28 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
 {
     size_t n, read = 0;
     FILE *fp;
-    wfd_t *wfd;
-    unsigned char buf[OS_BUFFER_SIZE + 2];
-    unsigned char sha1_digest[SHA_DIGEST_LENGTH];
-    unsigned char md5_digest[16];
-    unsigned char sha256_digest[SHA256_DIGEST_LENGTH];
-
-    SHA_CTX sha1_ctx;
-    MD5_CTX md5_ctx;
-    SHA256_CTX sha256_ctx;
+    wfd_t *wfd = NULL;
+    unsigned char *buf = NULL;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len;
+    int result = -1;
+    int i;
+
+    /* The digests are computed only for the given outputs */
+    char *output[OS_HASH_DIGESTS] = { md5output, sha1output, sha256output };
+    const EVP_MD *algorithm[OS_HASH_DIGESTS] = { EVP_md5(), EVP_sha1(), EVP_sha256() };
+    EVP_MD_CTX *ctx[OS_HASH_DIGESTS] = { NULL, NULL, NULL };
 
     /* Clear the memory */
-    md5output[0] = '\0';
-    sha1output[0] = '\0';
-    sha256output[0] = '\0';
-    buf[OS_BUFFER_SIZE + 1] = '\0';
+    for (i = 0; i < OS_HASH_DIGESTS; i++) {
+        if (output[i] != NULL) {
+            output[i][0] = '\0';
+        }
+    }
+
+    if (md5output == NULL && sha1output == NULL && sha256output == NULL) {
+        return (0);
+    }
 
     /* Use prefilter_cmd if set */
     if (prefilter_cmd == NULL) {
@@ -73,56 +84,68 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
         fp = wfd->file_out;
     }
 
-    /* Initialize both hashes */
-    MD5_Init(&md5_ctx);
-    SHA1_Init(&sha1_ctx);
-    SHA256_Init(&sha256_ctx);
+    /* Initialize the hashes. EVP picks the fastest implementation for the CPU (SHA-NI, AVX2...) */
+    for (i = 0; i < OS_HASH_DIGESTS; i++) {
+        if (output[i] != NULL) {
+            ctx[i] = EVP_MD_CTX_create();
+
+            if (ctx[i] == NULL || EVP_DigestInit_ex(ctx[i], algorithm[i], NULL) != 1) {
+                goto end;
+            }
+        }
+    }
+
+    os_malloc(OS_HASH_BUFFER_SIZE, buf);
 
-    /* Update for each one */
-    while ((n = fread(buf, 1, OS_BUFFER_SIZE, fp)) > 0) {
+    /* Update for each one in a single pass over the file */
+    while ((n = fread(buf, 1, OS_HASH_BUFFER_SIZE, fp)) > 0) {
 
         if (max_size > 0) {
             read = read + n;
             if (read >= max_size) {     // Maximum filesize error
                 mwarn("'%s' filesize is larger than the maximum allowed (%d MB). File skipped.", fname, (int)max_size/1048576); // max_size is in bytes
-                if (prefilter_cmd == NULL) {
-                    fclose(fp);
-                } else {
-                    wpclose(wfd);
-                }
-                return (-1);
+                goto end;
             }
         }
 
-        buf[n] = '\0';
-
-        SHA1_Update(&sha1_ctx, buf, n);
-        SHA256_Update(&sha256_ctx, buf, n);
-        MD5_Update(&md5_ctx, buf, (unsigned)n);
+        for (i = 0; i < OS_HASH_DIGESTS; i++) {
+            if (ctx[i] != NULL) {
+                EVP_DigestUpdate(ctx[i], buf, n);
+            }
+        }
     }
 
-    SHA1_Final(&(sha1_digest[0]), &sha1_ctx);
-    SHA256_Final(&(sha256_digest[0]), &sha256_ctx);
-    MD5_Final(md5_digest, &md5_ctx);
+    /* Set the outputs */
+    for (i = 0; i < OS_HASH_DIGESTS; i++) {
+        if (ctx[i] == NULL) {
+            continue;
+        }
 
-    /* Set output for MD5 */
-    for (n = 0; n < 16; n++) {
-        snprintf(md5output, 3, "%02x", md5_digest[n]);
-        md5output += 2;
-    }
+        if (EVP_DigestFinal_ex(ctx[i], digest, &digest_len) != 1) {
+            goto end;
+        }
 
-    /* Set output for SHA-1 */
-    for (n = 0; n < SHA_DIGEST_LENGTH; n++) {
-        snprintf(sha1output, 3, "%02x", sha1_digest[n]);
-        sha1output += 2;
+        for (n = 0; n < digest_len; n++) {
+            snprintf(output[i] + 2 * n, 3, "%02x", digest[n]);
+        }
     }
 
-    /* Set output for SHA-256 */
-    for (n = 0; n < SHA256_DIGEST_LENGTH; n++) {
-        snprintf(sha256output, 3, "%02x", sha256_digest[n]);
-        sha256output += 2;
+    result = 0;
+
+end:
+    for (i = 0; i < OS_HASH_DIGESTS; i++) {
+        if (ctx[i] != NULL) {
+            EVP_MD_CTX_destroy(ctx[i]);
+        }
+
+        /* Don't leave partial digests on error */
+        if (result != 0 && output[i] != NULL) {
+            output[i][0] = '\0';
+        }
     }
 
+    os_free(buf);
+
     /* Close it */
     if (prefilter_cmd == NULL) {
         fclose(fp);
@@ -130,5 +153,5 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
         wpclose(wfd);
     }
 
-    return (0);
+    return (result);
 }
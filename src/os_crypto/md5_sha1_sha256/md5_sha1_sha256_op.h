@@ -16,12 +16,24 @@
 #include "../sha256/sha256_op.h"
 
 
+/**
+ * @brief Calculates the MD5, SHA-1 and SHA-256 of a file in a single pass.
+ *
+ * @param fname Path of the file.
+ * @param prefilter_cmd Command whose output is hashed instead of the file, or NULL.
+ * @param md5output Buffer for the MD5. If NULL, the digest is not calculated.
+ * @param sha1output Buffer for the SHA-1. If NULL, the digest is not calculated.
+ * @param sha256output Buffer for the SHA-256. If NULL, the digest is not calculated.
+ * @param mode OS_BINARY or OS_TEXT.
+ * @param max_size Maximum size of the file in bytes. 0 means no limit.
+ * @return 0 on success, -1 on error or if the file is bigger than max_size.
+ */
 int OS_MD5_SHA1_SHA256_File(const char *fname,
                             char **prefilter_cmd,
                             os_md5 md5output,
                             os_sha1 sha1output,
                             os_sha256 sha256output,
                             int mode,
-                            size_t max_size) __attribute((nonnull(1, 3, 4)));
+                            size_t max_size) __attribute((nonnull(1)));
 
 #endif /* MD5SHA1SHA256_OP_H */
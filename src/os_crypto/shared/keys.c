@@ -27,7 +27,7 @@ static void __memclear(char *id, char *name, char *ip, char *key, size_t size)
     memset(ip, '\0', size);
 }
 
-static void move_netdata(keystore *keys, const keystore *old_keys)
+static void move_netdata(keystore *keys, const keystore *old_keys, bool counters)
 {
     unsigned int i;
     int keyid;
@@ -39,8 +39,16 @@ static void move_netdata(keystore *keys, const keystore *old_keys)
         if (keyid >= 0 && !strcmp(keys->keyentries[keyid]->ip->ip, old_keys->keyentries[i]->ip->ip)) {
             keys->keyentries[keyid]->rcvd = old_keys->keyentries[i]->rcvd;
             keys->keyentries[keyid]->sock = old_keys->keyentries[i]->sock;
+            keys->keyentries[keyid]->flow_control = old_keys->keyentries[i]->flow_control;
             memcpy(&keys->keyentries[keyid]->peer_info, &old_keys->keyentries[i]->peer_info, sizeof(struct sockaddr_storage));
 
+            /* The counters in memory are newer than the ones flushed to the rids files */
+            if (counters) {
+                keys->keyentries[keyid]->global = old_keys->keyentries[i]->global;
+                keys->keyentries[keyid]->local = old_keys->keyentries[i]->local;
+                keys->keyentries[keyid]->rids_pending = old_keys->keyentries[i]->rids_pending;
+            }
+
             snprintf(strsock, sizeof(strsock), "%d", keys->keyentries[keyid]->sock);
             rbtree_insert(keys->keytree_sock, strsock, keys->keyentries[keyid]);
         }
@@ -106,6 +114,8 @@ int OS_AddKey(keystore *keys, const char *id, const char *name, const char *ip,
     keys->keyentries[keys->keysize]->time_added = time_added;
     keys->keyentries[keys->keysize]->updating_time = 0;
     keys->keyentries[keys->keysize]->rids_node = NULL;
+    keys->keyentries[keys->keysize]->rids_pending = false;
+    keys->keyentries[keys->keysize]->flow_control = false;
     w_mutex_init(&keys->keyentries[keys->keysize]->mutex, NULL);
 
     if (keys->flags.key_mode == W_RAW_KEY || keys->flags.key_mode == W_DUAL_KEY) {
@@ -446,7 +456,7 @@ void OS_UpdateKeys(keystore *keys)
     OS_StartCounter(keys);
 
     mdebug2("move_netdata");
-    move_netdata(keys, old_keys);
+    move_netdata(keys, old_keys, false);
 
     OS_FreeKeys(old_keys);
     free(old_keys);
@@ -454,6 +464,62 @@ void OS_UpdateKeys(keystore *keys)
     mdebug1("Key reloading completed");
 }
 
+/* Read the keys file into a new keystore */
+keystore * OS_LoadKeys(const keystore *keys)
+{
+    keystore *new_keys;
+
+    mdebug1("Loading keys");
+
+    os_calloc(1, sizeof(keystore), new_keys);
+
+    minfo(ENC_READ);
+    OS_ReadKeys(new_keys, keys->flags.key_mode, keys->flags.save_removed);
+    OS_StartCounter(new_keys);
+
+    return new_keys;
+}
+
+/* Replace the keys with the ones loaded by OS_LoadKeys */
+void OS_SwapKeys(keystore *keys, keystore *new_keys)
+{
+    keystore old_keys;
+
+    mdebug2("move_netdata");
+    move_netdata(new_keys, keys, true);
+
+    /* Exchange every field but the mutex, which belongs to each structure */
+    old_keys = *keys;
+
+    keys->keyentries = new_keys->keyentries;
+    keys->keytree_id = new_keys->keytree_id;
+    keys->keytree_ip = new_keys->keytree_ip;
+    keys->keytree_sock = new_keys->keytree_sock;
+    keys->keysize = new_keys->keysize;
+    keys->file_change = new_keys->file_change;
+    keys->inode = new_keys->inode;
+    keys->id_counter = new_keys->id_counter;
+    keys->flags = new_keys->flags;
+    keys->removed_keys = new_keys->removed_keys;
+    keys->removed_keys_size = new_keys->removed_keys_size;
+    keys->opened_fp_queue = new_keys->opened_fp_queue;
+
+    new_keys->keyentries = old_keys.keyentries;
+    new_keys->keytree_id = old_keys.keytree_id;
+    new_keys->keytree_ip = old_keys.keytree_ip;
+    new_keys->keytree_sock = old_keys.keytree_sock;
+    new_keys->keysize = old_keys.keysize;
+    new_keys->file_change = old_keys.file_change;
+    new_keys->inode = old_keys.inode;
+    new_keys->id_counter = old_keys.id_counter;
+    new_keys->flags = old_keys.flags;
+    new_keys->removed_keys = old_keys.removed_keys;
+    new_keys->removed_keys_size = old_keys.removed_keys_size;
+    new_keys->opened_fp_queue = old_keys.opened_fp_queue;
+
+    mdebug1("Key reloading completed");
+}
+
 /* Check if an IP address is allowed to connect */
 int OS_IsAllowedIP(keystore *keys, const char *srcip)
 {
@@ -559,6 +625,7 @@ int OS_DeleteKey(keystore *keys, const char *id, int purge) {
 
     OS_FreeKey(keys->keyentries[i]);
     keys->keysize--;
+    keys->deleted++;
 
     if (i < (int)keys->keysize) {
         keys->keyentries[i] = keys->keyentries[keys->keysize];
@@ -569,6 +636,41 @@ int OS_DeleteKey(keystore *keys, const char *id, int purge) {
     return i;
 }
 
+/* Append the keys from index 'first' on to the client keys file */
+int OS_AppendKeys(const keystore *keys, unsigned int first) {
+    if (keys->flags.key_mode != W_RAW_KEY && keys->flags.key_mode != W_DUAL_KEY) {
+        merror("Wrong key store usage, it should have been initialized in RAW or DUAL mode");
+        return -1;
+    }
+
+    unsigned int i;
+    FILE *fp;
+    char cidr[IPSIZE + 1];
+    int r = 0;
+
+    if (fp = wfopen(KEYS_FILE, "a"), !fp) {
+        merror(FOPEN_ERROR, KEYS_FILE, errno, strerror(errno));
+        return -1;
+    }
+
+    for (i = first; i < keys->keysize; i++) {
+        keyentry *entry = keys->keyentries[i];
+
+        if (fprintf(fp, "%s %s %s %s\n", entry->id, entry->name, OS_CIDRtoStr(entry->ip, cidr, IPSIZE) ? entry->ip->ip : cidr, entry->raw_key) < 0) {
+            merror(FWRITE_ERROR, KEYS_FILE, errno, strerror(errno));
+            r = -1;
+            break;
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        merror(FCLOSE_ERROR, KEYS_FILE, errno, strerror(errno));
+        r = -1;
+    }
+
+    return r;
+}
+
 /* Write keystore on client keys file */
 int OS_WriteKeys(const keystore *keys) {
     if (keys->flags.key_mode != W_RAW_KEY && keys->flags.key_mode != W_DUAL_KEY) {
@@ -633,6 +735,7 @@ keystore* OS_DupKeys(const keystore *keys) {
     copy->file_change = keys->file_change;
     copy->inode = keys->inode;
     copy->id_counter = keys->id_counter;
+    copy->deleted = keys->deleted;
     w_mutex_init(&copy->keytree_sock_mutex, NULL);
 
     for (i = 0; i <= keys->keysize; i++) {
@@ -690,6 +793,7 @@ keyentry * OS_DupKeyEntry(const keyentry * key) {
     }
 
     copy->sock = key->sock;
+    copy->flow_control = key->flow_control;
     copy->time_added = key->time_added;
     w_mutex_init(&copy->mutex, NULL);
     copy->peer_info = key->peer_info;
@@ -798,6 +902,45 @@ int OS_ReadTimestamps(keystore * keys) {
     return 0;
 }
 
+// Append the timestamps of the keys from index 'first' on to the timestamps file
+
+int OS_AppendTimestamps(const keystore * keys, unsigned int first) {
+    FILE *fp;
+    int r = 0;
+
+    if (fp = wfopen(TIMESTAMP_FILE, "a"), !fp) {
+        merror(FOPEN_ERROR, TIMESTAMP_FILE, errno, strerror(errno));
+        return -1;
+    }
+
+    for (unsigned i = first; i < keys->keysize; i++) {
+        keyentry *entry = keys->keyentries[i];
+
+        if (entry->time_added == 0) {
+            continue;
+        }
+
+        char timestamp[40];
+        char cidr[IPSIZE + 1];
+        struct tm tm_result = { .tm_sec = 0 };
+
+        strftime(timestamp, 40, "%Y-%m-%d %H:%M:%S", localtime_r(&entry->time_added, &tm_result));
+
+        if (fprintf(fp, "%s %s %s %s\n", entry->id, entry->name, OS_CIDRtoStr(entry->ip, cidr, IPSIZE) ? entry->ip->ip : cidr, timestamp) < 0) {
+            merror(FWRITE_ERROR, TIMESTAMP_FILE, errno, strerror(errno));
+            r = -1;
+            break;
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        merror(FCLOSE_ERROR, TIMESTAMP_FILE, errno, strerror(errno));
+        r = -1;
+    }
+
+    return r;
+}
+
 // Write the agent timestamp data into the timestamps file
 
 int OS_WriteTimestamps(keystore * keys) {
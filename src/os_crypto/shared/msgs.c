@@ -23,6 +23,8 @@
 /* Prototypes */
 static void StoreSenderCounter(const keystore *keys, unsigned int global, unsigned int local) __attribute((nonnull));
 static void StoreCounter(const keystore *keys, int id, unsigned int global, unsigned int local) __attribute((nonnull));
+static void SaveCounter(const keystore *keys, int id, unsigned int global, unsigned int local) __attribute((nonnull));
+static void SaveSenderCounter(const keystore *keys, unsigned int global, unsigned int local) __attribute((nonnull));
 static void ReloadCounter(const keystore *keys, unsigned int id, const char * cid) __attribute((nonnull));
 static char *CheckSum(char *msg, size_t length) __attribute((nonnull));
 
@@ -30,6 +32,11 @@ static char *CheckSum(char *msg, size_t length) __attribute((nonnull));
 static _Atomic (unsigned int) global_count = 0;
 static _Atomic (unsigned int) local_count  = 0;
 
+#ifndef CLIENT
+/* Global sender count saved into the rids file */
+static unsigned int saved_global_count = 0;
+#endif
+
 /* Average compression rates */
 static _Atomic (unsigned int) evt_count = 0;
 static _Atomic (unsigned int) rcv_count = 0;
@@ -117,10 +124,22 @@ void OS_StartCounter(keystore *keys)
             }
 
             if (i == keys->keysize) {
+#ifndef CLIENT
+                saved_global_count = g_c;
+
+                /* Keep the counter in memory when reloading the keys, it is newer than the saved one.
+                 * On startup, skip the local counts that might have been sent without saving them. */
+                if (g_c > global_count || (g_c == global_count && l_c > local_count)) {
+                    mdebug1("Assigning sender counter: %u:%u", g_c + 1, 0);
+                    global_count = g_c + 1;
+                    local_count = 0;
+                }
+#else
                 mdebug1("Assigning sender counter: %u:%u",
                         g_c, l_c);
                 global_count = g_c;
                 local_count = l_c;
+#endif
             } else {
                 mdebug1("Assigning counter for agent %s: '%u:%u'.",
                         keys->keyentries[i]->name, g_c, l_c);
@@ -168,15 +187,45 @@ void OS_RemoveCounter(const char *id)
 
 /* Store sender counter */
 static void StoreSenderCounter(const keystore *keys, unsigned int global, unsigned int local)
+{
+#ifndef CLIENT
+    /* The global count is saved right away, so that a restart can skip the unsaved local counts */
+    if (global == saved_global_count) {
+        keys->keyentries[keys->keysize]->rids_pending = true;
+        return;
+    }
+
+    saved_global_count = global;
+#endif
+
+    SaveSenderCounter(keys, global, local);
+}
+
+/* Save sender counter into its rids file */
+static void SaveSenderCounter(const keystore *keys, unsigned int global, unsigned int local)
 {
     /* Write to the beginning of the file */
     fseek(keys->keyentries[keys->keysize]->fp, 0, SEEK_SET);
     fprintf(keys->keyentries[keys->keysize]->fp, "%u:%u:", global, local);
     fflush(keys->keyentries[keys->keysize]->fp);
+    keys->keyentries[keys->keysize]->rids_pending = false;
 }
 
 /* Store the global and local count of events */
 static void StoreCounter(const keystore *keys, int id, unsigned int global, unsigned int local)
+{
+#ifdef CLIENT
+    SaveCounter(keys, id, global, local);
+#else
+    /* The manager leaves the write to OS_FlushCounters() */
+    keys->keyentries[id]->global = global;
+    keys->keyentries[id]->local = local;
+    keys->keyentries[id]->rids_pending = true;
+#endif
+}
+
+/* Save the global and local count of events into the rids file */
+static void SaveCounter(const keystore *keys, int id, unsigned int global, unsigned int local)
 {
     if (!keys->keyentries[id]->fp) {
         char rids_file[OS_FLSIZE + 1];
@@ -198,6 +247,7 @@ static void StoreCounter(const keystore *keys, int id, unsigned int global, unsi
     fseek(keys->keyentries[id]->fp, 0, SEEK_SET);
     fprintf(keys->keyentries[id]->fp, "%u:%u:", global, local);
     fflush(keys->keyentries[id]->fp);
+    keys->keyentries[id]->rids_pending = false;
 
     keys->keyentries[id]->updating_time = time(0);
     if (!keys->keyentries[id]->rids_node) {
@@ -209,6 +259,31 @@ static void StoreCounter(const keystore *keys, int id, unsigned int global, unsi
     }
 }
 
+/* Save the counters updated in memory since the last flush */
+void OS_FlushCounters(keystore *keys)
+{
+    unsigned int i;
+    keyentry *key;
+
+    for (i = 0; i < keys->keysize; i++) {
+        key = keys->keyentries[i];
+
+        w_mutex_lock(&key->mutex);
+        if (key->rids_pending) {
+            SaveCounter(keys, i, key->global, key->local);
+        }
+        w_mutex_unlock(&key->mutex);
+    }
+
+    key = keys->keyentries[keys->keysize];
+
+    w_mutex_lock(&key->mutex);
+    if (key->rids_pending) {
+        SaveSenderCounter(keys, global_count, local_count);
+    }
+    w_mutex_unlock(&key->mutex);
+}
+
 /* Reload the global and local count of events */
 static void ReloadCounter(const keystore *keys, unsigned int id, const char * cid)
 {
@@ -15,6 +15,116 @@
 #include "os_net/os_net.h"
 
 
+/* Connect to the syslog server if the socket is not valid
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Connect(SyslogConfig *syslog_config) {
+    const char *ip;
+
+    if (syslog_config->socket >= 0) {
+        return (0);
+    }
+
+    resolve_hostname(&syslog_config->server, 5);
+    ip = get_ip_from_resolved_hostname(syslog_config->server);
+
+    if (syslog_config->protocol == IPPROTO_TCP) {
+        syslog_config->socket = OS_ConnectTCP(syslog_config->port, ip, 0, 0);
+    } else {
+        syslog_config->socket = OS_ConnectUDP(syslog_config->port, ip, 0, 0);
+    }
+
+    if (syslog_config->socket < 0) {
+        return (-1);
+    }
+
+    mdebug2(SUCCESSFULLY_RECONNECTED_SOCKET, syslog_config->server);
+    return (0);
+}
+
+/* Drop the connection after a failed send, along with the buffered messages */
+static void OS_CSyslog_Disconnect(SyslogConfig *syslog_config) {
+    OS_CloseSocket(syslog_config->socket);
+    syslog_config->socket = -1;
+    merror(ERROR_SENDING_MSG, syslog_config->server);
+
+    if (syslog_config->buffer_count > 0) {
+        syslog_config->dropped += syslog_config->buffer_count;
+        merror(CSYSLOG_DROPPED, syslog_config->buffer_count, syslog_config->server, syslog_config->dropped);
+    }
+
+    syslog_config->buffer_len = 0;
+    syslog_config->buffer_count = 0;
+}
+
+/* Send a syslog message
+ * On TCP, messages are framed with their length (RFC 6587 octet counting)
+ * and buffered, so that several of them are written with a single send().
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Send(SyslogConfig *syslog_config, const char *msg, size_t size) {
+    char header[OS_SIZE_32];
+    size_t header_len;
+
+    if (syslog_config->protocol != IPPROTO_TCP) {
+        if (OS_SendUDPbySize(syslog_config->socket, size, msg) != 0) {
+            OS_CSyslog_Disconnect(syslog_config);
+            return (-1);
+        }
+
+        return (0);
+    }
+
+    header_len = (size_t)snprintf(header, sizeof(header), "%zu ", size);
+
+    if (header_len + size > CSYSLOG_BUFFER_SIZE) {
+        size = CSYSLOG_BUFFER_SIZE - header_len;
+        header_len = (size_t)snprintf(header, sizeof(header), "%zu ", size);
+    }
+
+    if (syslog_config->buffer_len + header_len + size > CSYSLOG_BUFFER_SIZE) {
+        /* If the flush fails, this message is reported as dropped along with the buffer */
+        syslog_config->buffer_count++;
+
+        if (OS_CSyslog_Flush(syslog_config) < 0) {
+            return (-1);
+        }
+    }
+
+    if (!syslog_config->buffer) {
+        os_malloc(CSYSLOG_BUFFER_SIZE, syslog_config->buffer);
+    }
+
+    if (syslog_config->buffer_len == 0) {
+        syslog_config->buffer_time = time(NULL);
+    }
+
+    memcpy(syslog_config->buffer + syslog_config->buffer_len, header, header_len);
+    memcpy(syslog_config->buffer + syslog_config->buffer_len + header_len, msg, size);
+    syslog_config->buffer_len += header_len + size;
+    syslog_config->buffer_count++;
+
+    return (0);
+}
+
+/* Send the messages buffered for a TCP server
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Flush(SyslogConfig *syslog_config) {
+    if (syslog_config->buffer_len == 0) {
+        return (0);
+    }
+
+    if (syslog_config->socket < 0 || OS_SendTCPbySize(syslog_config->socket, syslog_config->buffer_len, syslog_config->buffer) != 0) {
+        OS_CSyslog_Disconnect(syslog_config);
+        return (-1);
+    }
+
+    syslog_config->buffer_len = 0;
+    syslog_config->buffer_count = 0;
+    return (0);
+}
+
 /* Send an alert via syslog
  * Returns 1 on success or 0 on error
  */
@@ -26,14 +136,8 @@ int OS_Alert_SendSyslog(alert_data *al_data, SyslogConfig *syslog_config) {
 
 
     /* Invalid socket, reconnect */
-    if (syslog_config->socket < 0) {
-        resolve_hostname(&syslog_config->server, 5);
-
-        syslog_config->socket = OS_ConnectUDP(syslog_config->port, get_ip_from_resolved_hostname(syslog_config->server), 0, 0);
-        if (syslog_config->socket < 0) {
-            return (0);
-        }
-        mdebug2(SUCCESSFULLY_RECONNECTED_SOCKET, syslog_config->server);
+    if (OS_CSyslog_Connect(syslog_config) < 0) {
+        return (0);
     }
 
     /* Clear the memory before insert */
@@ -310,11 +414,7 @@ int OS_Alert_SendSyslog(alert_data *al_data, SyslogConfig *syslog_config) {
         field_add_truncated(syslog_msg, OS_SIZE_61440, " message=\"%s\"", al_data->log[0], 2 );
     }
 
-    if (OS_SendUDPbySize(syslog_config->socket, strlen(syslog_msg), syslog_msg) != 0) {
-        OS_CloseSocket(syslog_config->socket);
-        syslog_config->socket = -1;
-        merror(ERROR_SENDING_MSG, syslog_config->server);
-    }
+    OS_CSyslog_Send(syslog_config, syslog_msg, strlen(syslog_msg));
 
     return (1);
 }
@@ -432,22 +532,13 @@ int OS_Alert_SendSyslog_JSON(cJSON *json_data, SyslogConfig *syslog_config) {
             );
 
     /* Invalid socket, reconnect */
-    if (syslog_config->socket < 0) {
-        resolve_hostname(&syslog_config->server, 5);
-
-        syslog_config->socket = OS_ConnectUDP(syslog_config->port, get_ip_from_resolved_hostname(syslog_config->server), 0, 0);
-        if (syslog_config->socket < 0) {
-            return (0);
-        }
-        mdebug2(SUCCESSFULLY_RECONNECTED_SOCKET, syslog_config->server);
+    if (OS_CSyslog_Connect(syslog_config) < 0) {
+        free(string);
+        return (0);
     }
 
     mdebug2("OS_Alert_SendSyslog_JSON(): sending '%s'", msg);
-    if (OS_SendUDPbySize(syslog_config->socket, strlen(msg), msg) != 0) {
-        OS_CloseSocket(syslog_config->socket);
-        syslog_config->socket = -1;
-        merror(ERROR_SENDING_MSG, syslog_config->server);
-    }
+    OS_CSyslog_Send(syslog_config, msg, strlen(msg));
     free(string);
 
     return 1;
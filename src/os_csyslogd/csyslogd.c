@@ -85,13 +85,19 @@ void OS_CSyslogD(SyslogConfig **syslog_config)
         mdebug2("Resolving server hostname: %s", syslog_config[s]->server);
         resolve_hostname(&syslog_config[s]->server, 5);
 
-        syslog_config[s]->socket = OS_ConnectUDP(syslog_config[s]->port, get_ip_from_resolved_hostname(syslog_config[s]->server), 0, 0);
+        const char *protocol = syslog_config[s]->protocol == IPPROTO_TCP ? "tcp" : "udp";
+
+        if (syslog_config[s]->protocol == IPPROTO_TCP) {
+            syslog_config[s]->socket = OS_ConnectTCP(syslog_config[s]->port, get_ip_from_resolved_hostname(syslog_config[s]->server), 0, 0);
+        } else {
+            syslog_config[s]->socket = OS_ConnectUDP(syslog_config[s]->port, get_ip_from_resolved_hostname(syslog_config[s]->server), 0, 0);
+        }
 
         if (syslog_config[s]->socket < 0) {
-            merror(CONNS_ERROR, syslog_config[s]->server, syslog_config[s]->port, "udp", strerror(errno));
+            merror(CONNS_ERROR, syslog_config[s]->server, syslog_config[s]->port, protocol, strerror(errno));
         } else {
-            minfo("Forwarding alerts via syslog to: '%s:%d'.",
-                   syslog_config[s]->server, syslog_config[s]->port);
+            minfo("Forwarding alerts via syslog to: '%s:%d/%s'.",
+                   syslog_config[s]->server, syslog_config[s]->port, protocol);
         }
     }
 
@@ -109,6 +115,11 @@ void OS_CSyslogD(SyslogConfig **syslog_config)
         if (sources.alert_json) {
             mdebug2("jqueue_next()");
             json_data = jqueue_next(&jfileq);
+
+            /* Read_FileMon() already waits when the plain alerts are read */
+            if (!json_data && !sources.alert_log) {
+                jqueue_wait(&jfileq, 1);
+            }
         }
 
         /* Send via syslog */
@@ -123,6 +134,15 @@ void OS_CSyslogD(SyslogConfig **syslog_config)
             }
         }
 
+        /* Send the buffered TCP messages when idle, or when they've waited too long */
+
+        for (s = 0; syslog_config[s]; s++) {
+            if (syslog_config[s]->buffer_len > 0 &&
+                ((!al_data && !json_data) || tm - syslog_config[s]->buffer_time >= CSYSLOG_FLUSH_INTERVAL)) {
+                OS_CSyslog_Flush(syslog_config[s]);
+            }
+        }
+
         /* Clear the memory */
 
         if (al_data) {
@@ -16,6 +16,11 @@
 
 #define OS_CSYSLOGD_MAX_TRIES 10
 
+/* Size of the TCP send buffer of each server */
+#define CSYSLOG_BUFFER_SIZE     (OS_MAXSTR * 2)
+/* Maximum time (in seconds) a message waits in the TCP send buffer */
+#define CSYSLOG_FLUSH_INTERVAL  1
+
 /** Prototypes **/
 
 /* Read syslog config */
@@ -37,6 +42,21 @@ int OS_Alert_SendSyslog(alert_data *al_data, SyslogConfig *syslog_config);
  */
 int OS_Alert_SendSyslog_JSON(cJSON *json_data, SyslogConfig *syslog_config);
 
+/* Connect to the syslog server if the socket is not valid
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Connect(SyslogConfig *syslog_config);
+
+/* Send a syslog message, buffered on TCP
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Send(SyslogConfig *syslog_config, const char *msg, size_t size);
+
+/* Send the messages buffered for a TCP server
+ * Returns 0 on success or -1 on error
+ */
+int OS_CSyslog_Flush(SyslogConfig *syslog_config);
+
 /* Database inserting main function */
 void OS_CSyslogD(SyslogConfig **syslog_config) __attribute__((noreturn));
 
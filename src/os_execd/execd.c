@@ -29,8 +29,12 @@ time_t pending_upg = 0;
 
 STATIC OSList *timeout_list;
 STATIC OSListNode *timeout_node;
+STATIC OSHash *timeout_hash;
 STATIC OSHash *repeated_hash;
 
+/* Earliest time when a timeout entry expires, 0 if not known */
+STATIC time_t timeout_next;
+
 #ifdef WIN32
 #ifdef WAZUH_UNIT_TESTING
     #include "unit_tests/wrappers/windows/libc/stdio_wrappers.h"
@@ -80,6 +84,28 @@ void FreeTimeoutList() {
         timeout_node = OSList_GetCurrentlyNode(timeout_list);
     }
     os_free(timeout_list);
+
+    if (timeout_hash) {
+        OSHash_Free(timeout_hash);
+        timeout_hash = NULL;
+    }
+    timeout_next = 0;
+}
+
+/* Create the timeout list and its index by alert keys
+ */
+void CreateTimeoutList() {
+    timeout_list = OSList_Create();
+    if (!timeout_list) {
+        merror_exit(LIST_ERROR);
+    }
+
+    timeout_hash = OSHash_Create();
+    if (!timeout_hash) {
+        merror_exit(HASH_ERROR);
+    }
+
+    timeout_next = 0;
 }
 
 #ifdef WIN32
@@ -129,16 +155,24 @@ void ExecdTimeoutRun(int *childcount)
 #endif
 {
     time_t curr_time = time(NULL);
+    time_t next = 0;
+
+    /* Nothing expires until the earliest timeout */
+    if (timeout_next > 0 && curr_time <= timeout_next) {
+        return;
+    }
 
     /* Check if there is any timed out command to execute */
     timeout_node = OSList_GetFirstNode(timeout_list);
     while (timeout_node) {
         timeout_data *list_entry;
+        time_t expiration;
 
         list_entry = (timeout_data *)timeout_node->data;
+        expiration = list_entry->time_of_addition + list_entry->time_to_block;
 
         /* Timed out */
-        if ((curr_time - list_entry->time_of_addition) > list_entry->time_to_block) {
+        if (curr_time > expiration) {
 
             mdebug1("Executing command '%s %s' after a timeout of '%ds'",
                 list_entry->command[0],
@@ -160,6 +194,10 @@ void ExecdTimeoutRun(int *childcount)
             OSList_DeleteCurrentlyNode(timeout_list);
             timeout_node = OSList_GetCurrentlyNode(timeout_list);
 
+            if (timeout_hash && list_entry->rkey) {
+                OSHash_Delete(timeout_hash, list_entry->rkey);
+            }
+
             /* Clear the memory */
             FreeTimeoutEntry(list_entry);
 
@@ -167,9 +205,15 @@ void ExecdTimeoutRun(int *childcount)
             (*childcount)++;
 #endif
         } else {
+            if (next == 0 || expiration < next) {
+                next = expiration;
+            }
+
             timeout_node = OSList_GetNextNode(timeout_list);
         }
     }
+
+    timeout_next = next;
 }
 
 #ifdef WIN32
@@ -336,24 +380,19 @@ void ExecdRun(char *exec_msg, int *childcount)
             }
 
             /* Check if this command was already executed */
-            timeout_node = OSList_GetFirstNode(timeout_list);
-            while (timeout_node) {
-                timeout_data *list_entry;
-
-                list_entry = (timeout_data *)timeout_node->data;
-                if (strcmp(list_entry->rkey, rkey) == 0) {
-                    /* Means we executed this command before and we don't need to add it again */
-                    added_before = 1;
-
-                    /* Update the timeout */
-                    mdebug1("Command already received, updating time of addition to now.");
-                    list_entry->time_of_addition = curr_time;
-                    list_entry->time_to_block = timeout_value;
-                    break;
+            timeout_data *list_entry = timeout_hash ? (timeout_data *)OSHash_Get(timeout_hash, rkey) : NULL;
+            if (list_entry) {
+                /* Means we executed this command before and we don't need to add it again */
+                added_before = 1;
+
+                /* Update the timeout */
+                mdebug1("Command already received, updating time of addition to now.");
+                list_entry->time_of_addition = curr_time;
+                list_entry->time_to_block = timeout_value;
+
+                if (timeout_next == 0 || curr_time + timeout_value < timeout_next) {
+                    timeout_next = curr_time + timeout_value;
                 }
-
-                /* Continue with the next entry in timeout list */
-                timeout_node = OSList_GetNextNode(timeout_list);
             }
 
             /* If it wasn't added before, do it now */
@@ -381,6 +420,14 @@ void ExecdRun(char *exec_msg, int *childcount)
                 if (!OSList_AddData(timeout_list, timeout_entry)) {
                     merror(LIST_ADD_ERROR);
                     FreeTimeoutEntry(timeout_entry);
+                } else {
+                    if (timeout_hash && OSHash_Add(timeout_hash, timeout_entry->rkey, timeout_entry) != 2) {
+                        merror("At ExecdRun: OSHash_Add() failed");
+                    }
+
+                    if (timeout_next == 0 || curr_time + timeout_value < timeout_next) {
+                        timeout_next = curr_time + timeout_value;
+                    }
                 }
             }
         }
@@ -431,10 +478,7 @@ void ExecdStart(int q)
 
 #ifndef WAZUH_UNIT_TESTING
     /* Create list for timeout */
-    timeout_list = OSList_Create();
-    if (!timeout_list) {
-        merror_exit(LIST_ERROR);
-    }
+    CreateTimeoutList();
 #endif
 
     if (repeated_offenders_timeout[0] != 0) {
@@ -521,10 +565,7 @@ int WinExecdStart()
     }
 
     /* Create list for timeout */
-    timeout_list = OSList_Create();
-    if (!timeout_list) {
-        merror_exit(LIST_ERROR);
-    }
+    CreateTimeoutList();
 
     if (repeated_offenders_timeout[0] != 0) {
         repeated_hash = OSHash_Create();
@@ -87,5 +87,6 @@ typedef struct _timeout_data {
 
 void FreeTimeoutEntry(timeout_data *timeout_entry);
 void FreeTimeoutList();
+void CreateTimeoutList();
 
 #endif /* EXECD_H */
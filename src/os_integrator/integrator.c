@@ -13,6 +13,84 @@
 #include <external/cJSON/cJSON.h>
 #include "os_net/os_net.h"
 
+#ifndef WIN32
+#include <poll.h>
+#endif
+
+/**
+ * @brief Integration launched and not waited for yet
+ */
+typedef struct {
+    wfd_t *wfd;                     ///< Running process
+    const char *name;               ///< Integration name
+    char tmp_file[2048 + 1];        ///< Alert file passed to the integration
+    int temp_file_created;          ///< The alert file must be removed when the integration finishes
+    char cmd[4096 + 1];             ///< Command line, for the log messages
+} integrator_child_t;
+
+/* Maximum number of integrations running at the same time */
+int integrator_max_running = 1;
+
+static integrator_child_t *integrator_children;
+static int integrator_running;
+
+/**
+ * @brief Wait for a running integration, log its result and remove its alert file
+ * @param index position of the integration in integrator_children
+ */
+static void integrator_reap(int index) {
+    integrator_child_t *child = &integrator_children[index];
+    char buffer[4096] = "";
+
+    while (fgets(buffer, sizeof(buffer), child->wfd->file_out)) {
+        mdebug2("integratord: %s", buffer);
+    }
+    int wp_closefd = wpclose(child->wfd);
+    if ( WIFEXITED(wp_closefd) ) {
+        int wstatus = WEXITSTATUS(wp_closefd);
+        if (wstatus == 127) {
+            // 127 means error in exec
+            merror("Couldn't execute command (%s). Check file and permissions.", child->cmd);
+        } else if(wstatus != 0){
+            merror("Unable to run integration for %s -> %s",  child->name, INTEGRATORDIR);
+            merror("While running %s -> %s. Output: %s ",  child->name, INTEGRATORDIR, buffer);
+            merror("Exit status was: %d", wstatus);
+        } else {
+            mdebug1("Command ran successfully.");
+        }
+    } else {
+        merror("Command (%s) execution exited abnormally.", child->cmd);
+    }
+
+    if(child->temp_file_created == 1) {
+        unlink(child->tmp_file);
+    }
+
+    integrator_running--;
+    memmove(child, child + 1, (integrator_running - index) * sizeof(integrator_child_t));
+}
+
+/**
+ * @brief Wait for the running integrations that already closed their output
+ */
+static void integrator_reap_finished() {
+#ifndef WIN32
+    struct pollfd pfd;
+    int i = 0;
+
+    while (i < integrator_running) {
+        pfd.fd = fileno(integrator_children[i].wfd->file_out);
+        pfd.events = POLLIN;
+
+        if (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLHUP)) {
+            integrator_reap(i);
+        } else {
+            i++;
+        }
+    }
+#endif
+}
+
 
 void OS_IntegratorD(IntegratorConfig **integrator_config)
 {
@@ -38,6 +116,9 @@ void OS_IntegratorD(IntegratorConfig **integrator_config)
     exec_tmp_file[2048] = 0;
     exec_full_cmd[4096] = 0;
 
+    os_calloc(integrator_max_running, sizeof(integrator_child_t), integrator_children);
+    integrator_running = 0;
+
     /* Initing file queue JSON - to read the alerts */
     jqueue_init(&jfileq);
 
@@ -135,7 +216,8 @@ void OS_IntegratorD(IntegratorConfig **integrator_config)
         mdebug2("jqueue_next()");
         al_json = jqueue_next(&jfileq);
         if(!al_json) {
-            sleep(1);
+            integrator_reap_finished();
+            jqueue_wait(&jfileq, 1);
             continue;
         }
 
@@ -398,31 +480,24 @@ void OS_IntegratorD(IntegratorConfig **integrator_config)
             mdebug1("Running: %s", exec_full_cmd);
 
             char **cmd = OS_StrBreak(' ', exec_full_cmd, 5);
+            int launched = 0;
 
             if(cmd) {
                 wfd_t * wfd = wpopenv(integrator_config[s]->path, cmd, W_BIND_STDOUT | W_BIND_STDERR | W_CHECK_WRITE);
                 if(wfd){
-                    char buffer[4096];
-                    while (fgets(buffer, sizeof(buffer), wfd->file_out)) {
-                        mdebug2("integratord: %s", buffer);
-                    }
-                    int wp_closefd = wpclose(wfd);
-                    if ( WIFEXITED(wp_closefd) ) {
-                        int wstatus = WEXITSTATUS(wp_closefd);
-                        if (wstatus == 127) {
-                            // 127 means error in exec
-                            merror("Couldn't execute command (%s). Check file and permissions.", exec_full_cmd);
-                        } else if(wstatus != 0){
-                            merror("Unable to run integration for %s -> %s",  integrator_config[s]->name, INTEGRATORDIR);
-                            merror("While running %s -> %s. Output: %s ",  integrator_config[s]->name, INTEGRATORDIR, buffer);
-                            merror("Exit status was: %d", wstatus);
-                        } else {
-                            mdebug1("Command ran successfully.");
-                        }
-                    } else {
-                        merror("Command (%s) execution exited abnormally.", exec_full_cmd);
+                    integrator_child_t *child = &integrator_children[integrator_running++];
+
+                    child->wfd = wfd;
+                    child->name = integrator_config[s]->name;
+                    child->temp_file_created = temp_file_created;
+                    snprintf(child->tmp_file, sizeof(child->tmp_file), "%s", exec_tmp_file);
+                    snprintf(child->cmd, sizeof(child->cmd), "%s", exec_full_cmd);
+                    launched = 1;
+
+                    /* Wait for the oldest integration when the limit is reached */
+                    if (integrator_running == integrator_max_running) {
+                        integrator_reap(0);
                     }
-
                 } else {
                     merror("Could not launch command %s (%d)", strerror(errno), errno);
                 }
@@ -430,11 +505,11 @@ void OS_IntegratorD(IntegratorConfig **integrator_config)
             }
             s++;
 
-            /* Clearing the memory */
-            if(temp_file_created == 1) {
+            /* Clearing the memory, the running integrations remove their file when they finish */
+            if(temp_file_created == 1 && !launched) {
                 unlink(exec_tmp_file);
-                temp_file_created = 0;
             }
+            temp_file_created = 0;
 
         }
 
@@ -442,4 +517,9 @@ void OS_IntegratorD(IntegratorConfig **integrator_config)
             cJSON_Delete(al_json);
         }
     }
+
+    while (integrator_running > 0) {
+        integrator_reap(0);
+    }
+    os_free(integrator_children);
 }
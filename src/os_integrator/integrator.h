@@ -24,6 +24,9 @@ void OS_IntegratorD(IntegratorConfig **integrator_config);
 
 extern IntegratorConfig **integrator_config;
 
+/* Maximum number of integrations running at the same time */
+extern int integrator_max_running;
+
 // Read config
 cJSON *getIntegratorConfig(void);
 
@@ -105,6 +105,9 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Get the number of integrations that may run at the same time */
+    integrator_max_running = getDefine_Int("integrator", "max_running", 1, 64);
+
     /* Check if the user/group given are valid */
     uid = Privsep_GetUser(user);
     gid = Privsep_GetGroup(group);
@@ -27,7 +27,7 @@
 #endif
 
 /* Prototypes */
-static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, int ipv6);
+static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, int ipv6, bool reuse_port);
 static int OS_Connect(u_int16_t _port, unsigned int protocol, const char *_ip, int ipv6, uint32_t network_interface);
 
 /* Unix socket -- not for windows */
@@ -47,12 +47,22 @@ static int OS_Connect(u_int16_t _port, unsigned int protocol, const char *_ip, i
 
 #endif /* WIN32*/
 
+#ifndef WIN32
+#include <sys/uio.h>
+
+#ifdef IOV_MAX
+#define OS_IOV_MAX IOV_MAX
+#else
+#define OS_IOV_MAX 1024
+#endif
+#endif /* WIN32 */
+
 #define RECV_SOCK 0
 #define SEND_SOCK 1
 
 
 /* Bind a specific port */
-static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, int ipv6)
+static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, int ipv6, bool reuse_port)
 {
     int ossock;
     struct sockaddr_in server;
@@ -78,6 +88,20 @@ static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, in
         return (OS_INVALID);
     }
 
+    if (reuse_port) {
+#ifdef SO_REUSEPORT
+        int flag = 1;
+
+        if (setsockopt(ossock, SOL_SOCKET, SO_REUSEPORT, (char *)&flag, sizeof(flag)) < 0) {
+            OS_CloseSocket(ossock);
+            return (OS_SOCKTERR);
+        }
+#else
+        OS_CloseSocket(ossock);
+        return (OS_SOCKTERR);
+#endif
+    }
+
     if (ipv6) {
         memset(&server6, 0, sizeof(server6));
         server6.sin6_family = AF_INET6;
@@ -123,13 +147,19 @@ static int OS_Bindport(u_int16_t _port, unsigned int _proto, const char *_ip, in
 /* Bind a TCP port, using the OS_Bindport */
 int OS_Bindporttcp(u_int16_t _port, const char *_ip, int ipv6)
 {
-    return (OS_Bindport(_port, IPPROTO_TCP, _ip, ipv6));
+    return (OS_Bindport(_port, IPPROTO_TCP, _ip, ipv6, false));
 }
 
 /* Bind a UDP port, using the OS_Bindport */
 int OS_Bindportudp(u_int16_t _port, const char *_ip, int ipv6)
 {
-    return (OS_Bindport(_port, IPPROTO_UDP, _ip, ipv6));
+    return (OS_Bindport(_port, IPPROTO_UDP, _ip, ipv6, false));
+}
+
+/* Bind a UDP port that other sockets can share, using the OS_Bindport */
+int OS_BindportudpReuse(u_int16_t _port, const char *_ip, int ipv6)
+{
+    return (OS_Bindport(_port, IPPROTO_UDP, _ip, ipv6, true));
 }
 
 #ifndef WIN32
@@ -672,6 +702,127 @@ int OS_SendSecureTCP(int sock, uint32_t size, const void * msg) {
     return retval;
 }
 
+// Send a buffer of secure TCP messages
+
+int OS_SendSecureTCPFrames(int sock, size_t size, const void * frames) {
+    const char * data = frames;
+    ssize_t sent;
+
+    if (sock < 0) {
+        return OS_SOCKTERR;
+    }
+
+    errno = 0;
+
+    while (size > 0) {
+        if (sent = send(sock, data, size, 0), sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+
+            return OS_SOCKTERR;
+        }
+
+        data += sent;
+        size -= sent;
+    }
+
+    return 0;
+}
+// Send a batch of secure TCP messages with one system call
+
+int OS_SendSecureTCPv(int sock, const os_frame_t * frames, size_t count) {
+    uint32_t * headers = NULL;
+    int retval = 0;
+    size_t i;
+
+    if (sock < 0) {
+        return OS_SOCKTERR;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    os_malloc(count * sizeof(uint32_t), headers);
+
+    for (i = 0; i < count; i++) {
+        headers[i] = wnet_order(frames[i].size);
+    }
+
+#ifndef WIN32
+    struct iovec * iov = NULL;
+    size_t iovcnt = 2 * count;
+    size_t first = 0;
+    ssize_t sent;
+
+    os_malloc(iovcnt * sizeof(struct iovec), iov);
+
+    for (i = 0; i < count; i++) {
+        iov[2 * i].iov_base = &headers[i];
+        iov[2 * i].iov_len = sizeof(uint32_t);
+        iov[2 * i + 1].iov_base = (void *)frames[i].data;
+        iov[2 * i + 1].iov_len = frames[i].size;
+    }
+
+    errno = 0;
+
+    for (;;) {
+        while (first < iovcnt && iov[first].iov_len == 0) {
+            first++;
+        }
+
+        if (first == iovcnt) {
+            break;
+        }
+
+        if (sent = writev(sock, iov + first, iovcnt - first > OS_IOV_MAX ? OS_IOV_MAX : iovcnt - first), sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+
+            retval = OS_SOCKTERR;
+            break;
+        }
+
+        // Skip the buffers already sent, and the part sent of the last one
+        while (sent > 0) {
+            if ((size_t)sent >= iov[first].iov_len) {
+                sent -= iov[first].iov_len;
+                iov[first++].iov_len = 0;
+            } else {
+                iov[first].iov_base = (char *)iov[first].iov_base + sent;
+                iov[first].iov_len -= sent;
+                sent = 0;
+            }
+        }
+    }
+
+    os_free(iov);
+#else
+    // No writev() on Windows: the messages are copied into a single buffer
+    char * buffer = NULL;
+    size_t size = 0;
+
+    for (i = 0; i < count; i++) {
+        size += sizeof(uint32_t) + frames[i].size;
+    }
+
+    os_malloc(size, buffer);
+
+    for (i = 0, size = 0; i < count; i++) {
+        memcpy(buffer + size, &headers[i], sizeof(uint32_t));
+        memcpy(buffer + size + sizeof(uint32_t), frames[i].data, frames[i].size);
+        size += sizeof(uint32_t) + frames[i].size;
+    }
+
+    retval = OS_SendSecureTCPFrames(sock, size, buffer);
+    os_free(buffer);
+#endif
+
+    os_free(headers);
+    return retval;
+}
 
 /* Receive secure TCP message
  * This function reads a header containing message size as 4-byte little-endian unsigned integer.
@@ -713,6 +864,113 @@ int OS_RecvSecureTCP(int sock, char * ret, uint32_t size) {
     return recvb;
 }
 
+// Initialize a buffered reader
+
+void OS_FrameReaderInit(os_frame_reader_t * reader, int sock, size_t size, size_t max_size) {
+    if (size < sizeof(uint32_t)) {
+        size = sizeof(uint32_t);
+    }
+
+    os_malloc(size + 1, reader->buffer);
+    reader->size = size;
+    reader->min_size = size;
+    reader->max_size = max_size;
+    OS_FrameReaderReset(reader, sock);
+}
+
+// Attach a reader to another socket, dropping the data it holds
+
+void OS_FrameReaderReset(os_frame_reader_t * reader, int sock) {
+    reader->sock = sock;
+    reader->begin = 0;
+    reader->end = 0;
+    reader->saved = '\0';
+    reader->terminated = false;
+}
+
+// Free the buffer of a reader
+
+void OS_FrameReaderFree(os_frame_reader_t * reader) {
+    os_free(reader->buffer);
+    reader->size = 0;
+    OS_FrameReaderReset(reader, -1);
+}
+
+// Check whether a reader holds data that has not been returned yet
+
+bool OS_FrameReaderPending(const os_frame_reader_t * reader) {
+    return reader->end > reader->begin;
+}
+
+// Receive the next secure TCP message through a reader
+
+ssize_t OS_RecvSecureTCPFrame(os_frame_reader_t * reader, char ** frame) {
+    uint32_t msgsize;
+    size_t available;
+    size_t needed;
+    ssize_t recvb;
+
+    if (reader->terminated) {
+        reader->buffer[reader->begin] = reader->saved;
+        reader->terminated = false;
+    }
+
+    for (;;) {
+        available = reader->end - reader->begin;
+        needed = sizeof(uint32_t);
+
+        if (available >= sizeof(uint32_t)) {
+            memcpy(&msgsize, reader->buffer + reader->begin, sizeof(uint32_t));
+            msgsize = wnet_order(msgsize);
+
+            if (msgsize > reader->max_size) {
+                /* Error: the payload length is too long */
+                return OS_SOCKTERR;
+            }
+
+            needed += msgsize;
+
+            if (available >= needed) {
+                *frame = reader->buffer + reader->begin + sizeof(uint32_t);
+                reader->begin += needed;
+
+                // Terminate the message with the first byte of the next one, which is restored later
+                reader->saved = reader->buffer[reader->begin];
+                reader->terminated = reader->begin < reader->end;
+                reader->buffer[reader->begin] = '\0';
+                return msgsize;
+            }
+        }
+
+        // Move the partial message to the start of the buffer, and fit the buffer to it
+        if (reader->begin > 0) {
+            memmove(reader->buffer, reader->buffer + reader->begin, available);
+            reader->begin = 0;
+            reader->end = available;
+        }
+
+        if (needed > reader->size) {
+            os_realloc(reader->buffer, needed + 1, reader->buffer);
+            reader->size = needed;
+        } else if (available == 0 && reader->size > reader->min_size) {
+            os_realloc(reader->buffer, reader->min_size + 1, reader->buffer);
+            reader->size = reader->min_size;
+        }
+
+        recvb = recv(reader->sock, reader->buffer + reader->end, reader->size - reader->end, 0);
+
+        if (recvb <= 0) {
+            if (recvb < 0 && errno == EINTR) {
+                continue;
+            }
+
+            return recvb;
+        }
+
+        reader->end += recvb;
+    }
+}
+
 // Byte ordering
 
 uint32_t wnet_order(uint32_t value) {
@@ -25,6 +25,12 @@
 int OS_Bindporttcp(u_int16_t _port, const char *_ip, int ipv6);
 int OS_Bindportudp(u_int16_t _port, const char *_ip, int ipv6);
 
+/* OS_BindportudpReuse
+ * Bind a UDP port with SO_REUSEPORT, so that several sockets receive
+ * datagrams on the same port. Fails if the system does not support it.
+ */
+int OS_BindportudpReuse(u_int16_t _port, const char *_ip, int ipv6);
+
 /* OS_BindUnixDomain
  * Bind to a specific file, using the "mode" permissions in
  * a Unix Domain socket.
@@ -118,12 +124,120 @@ int OS_SetSendTimeout(int socket, int seconds);
  */
 int OS_SendSecureTCP(int sock, uint32_t size, const void * msg);
 
+/**
+ * @brief Send a buffer of secure TCP messages
+ *
+ * Every message in the buffer must be already prepended with the header of
+ * OS_SendSecureTCP(), so that many messages are sent with a single call.
+ *
+ * @param sock Socket file descriptor.
+ * @param size Buffer length, in bytes.
+ * @param frames Pointer to the messages.
+ * @retval 0 on success.
+ * @retval OS_SOCKTERR on error.
+ */
+int OS_SendSecureTCPFrames(int sock, size_t size, const void * frames);
+
+/**
+ * @brief Message of a batch sent by OS_SendSecureTCPv()
+ */
+typedef struct os_frame_t {
+    const void * data;  ///< Message content
+    uint32_t size;      ///< Message length, in bytes
+} os_frame_t;
+
+/**
+ * @brief Send a batch of secure TCP messages with one system call
+ *
+ * Every message gets the header of OS_SendSecureTCP(). The headers and the
+ * contents are gathered with writev(), so nothing is copied. The messages
+ * may be larger than OS_MAXSTR.
+ *
+ * @param sock Socket file descriptor.
+ * @param frames Array of messages.
+ * @param count Number of messages.
+ * @retval 0 on success.
+ * @retval OS_SOCKTERR on error.
+ */
+int OS_SendSecureTCPv(int sock, const os_frame_t * frames, size_t count);
+
 /* Receive secure TCP message
  * This function reads a header containing message size as 4-byte little-endian unsigned integer.
  * Return recvval on success or OS_SOCKTERR on error.
  */
 int OS_RecvSecureTCP(int sock, char * ret,uint32_t size);
 
+/**
+ * @brief Buffered reader of secure TCP messages
+ *
+ * A single recv() fills the buffer with as many messages as the peer has sent,
+ * and OS_RecvSecureTCPFrame() returns them one by one. The buffer grows for the
+ * messages that do not fit in it, up to max_size, and shrinks back once they
+ * have been read.
+ */
+typedef struct os_frame_reader_t {
+    int sock;           ///< Socket file descriptor
+    char * buffer;      ///< Received data
+    size_t size;        ///< Buffer capacity, the terminating byte excluded
+    size_t min_size;    ///< Initial capacity
+    size_t max_size;    ///< Largest message accepted
+    size_t begin;       ///< Offset of the first byte not returned yet
+    size_t end;         ///< Offset past the last byte received
+    char saved;         ///< Byte overwritten to terminate the last message
+    bool terminated;    ///< Whether the byte at begin must be restored
+} os_frame_reader_t;
+
+/**
+ * @brief Initialize a buffered reader
+ *
+ * @param reader Reader to initialize.
+ * @param sock Socket file descriptor.
+ * @param size Initial buffer capacity, in bytes.
+ * @param max_size Largest message accepted, in bytes.
+ */
+void OS_FrameReaderInit(os_frame_reader_t * reader, int sock, size_t size, size_t max_size);
+
+/**
+ * @brief Attach a reader to another socket, dropping the data it holds
+ *
+ * @param reader Buffered reader.
+ * @param sock Socket file descriptor.
+ */
+void OS_FrameReaderReset(os_frame_reader_t * reader, int sock);
+
+/**
+ * @brief Free the buffer of a reader
+ *
+ * @param reader Reader to free.
+ */
+void OS_FrameReaderFree(os_frame_reader_t * reader);
+
+/**
+ * @brief Check whether a reader holds data that has not been returned yet
+ *
+ * A reader with pending data must keep reading the same socket, otherwise
+ * the messages already received would be lost.
+ *
+ * @param reader Buffered reader.
+ * @return true if there is a whole or a partial message buffered.
+ */
+bool OS_FrameReaderPending(const os_frame_reader_t * reader);
+
+/**
+ * @brief Receive the next secure TCP message through a reader
+ *
+ * The message is returned from the reader buffer, followed by a null byte,
+ * and it is valid until the next call.
+ *
+ * @param reader Buffered reader.
+ * @param frame Pointer to the message content.
+ * @return Message length on success.
+ * @retval 0 if the peer closed the connection.
+ * @retval -1 on socket error.
+ * @retval OS_SOCKTERR if the message is larger than max_size.
+ */
+ssize_t OS_RecvSecureTCPFrame(os_frame_reader_t * reader, char ** frame);
+
 /**
  * @brief Send secure TCP Cluster message
  * @param sock Socket to write on
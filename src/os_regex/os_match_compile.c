@@ -17,6 +17,53 @@
 #include "os_regex_internal.h"
 
 
+/* Build the automaton of the substring alternatives when there are
+ * at least OS_MATCH_MULTI_MIN of them.
+ * Alternatives with upper case characters (OS_CASE_SENSITIVE) never
+ * match, so they are left out.
+ * Returns 1 on success or 0 on error.
+ */
+static int _OSMatch_CompileLiterals(OSMatch *reg)
+{
+    size_t i;
+    size_t j;
+    size_t count = 0;
+
+    for (i = 0; reg->patterns[i]; i++) {
+        if (reg->match_fp[i] == _OS_Match) {
+            count++;
+        }
+    }
+
+    if (count < OS_MATCH_MULTI_MIN) {
+        return (1);
+    }
+
+    if (reg->literals = (OSMultiMatch *) calloc(1, sizeof(OSMultiMatch)), !reg->literals) {
+        return (0);
+    }
+
+    OSMultiMatch_Init(reg->literals);
+
+    for (i = 0; reg->patterns[i]; i++) {
+        if (reg->match_fp[i] != _OS_Match) {
+            continue;
+        }
+
+        for (j = 0; j < reg->size[i] && (uchar)reg->patterns[i][j] == charmap[(uchar)reg->patterns[i][j]]; j++);
+
+        if (j < reg->size[i]) {
+            continue;
+        }
+
+        if (!OSMultiMatch_AddPattern(reg->literals, reg->patterns[i], reg->size[i], (int)i)) {
+            return (0);
+        }
+    }
+
+    return (OSMultiMatch_Compile(reg->literals));
+}
+
 /* Compile a pattern to be used later
  * Allowed flags are:
  *      - OS_CASE_SENSITIVE
@@ -45,6 +92,7 @@ int OSMatch_Compile(const char *pattern, OSMatch *reg, int flags)
     reg->match_fp = NULL;
     reg->negate = 0;
     reg->raw = NULL;
+    reg->literals = NULL;
 
     /* The pattern can't be null */
     if (pattern == NULL) {
@@ -179,6 +227,11 @@ int OSMatch_Compile(const char *pattern, OSMatch *reg, int flags)
 
     } while (!end_of_string);
 
+    if (!_OSMatch_CompileLiterals(reg)) {
+        reg->error = OS_REGEX_OUTOFMEMORY;
+        goto compile_error;
+    }
+
     /* Success return */
     free(new_str_free);
     return (1);
@@ -16,15 +16,72 @@
 #include "os_regex_internal.h"
 
 
+/* Find the first position of str whose lower case version is c.
+ * Patterns are stored in lower case, so an upper case c never matches.
+ * memchr does the actual scanning, once per possible case.
+ */
+const char *_os_find_first(const char *str, size_t str_len, unsigned char c)
+{
+    const char *lower;
+    const char *upper;
+
+    if (c >= 'a' && c <= 'z') {
+        lower = memchr(str, c, str_len);
+        upper = memchr(str, c - ('a' - 'A'), lower ? (size_t)(lower - str) : str_len);
+        return (upper ? upper : lower);
+    }
+
+    if (c >= 'A' && c <= 'Z') {
+        return (NULL);
+    }
+
+    return (memchr(str, c, str_len));
+}
+
+/* Compare size bytes of str against the pattern, ignoring the case of str.
+ * Returns TRUE on match.
+ */
+int _os_literal_cmp(const char *pattern, const char *str, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        if ((uchar)pattern[i] != charmap[(uchar)str[i]]) {
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
 int _OS_Match(const char *pattern, const char *str, size_t str_len, size_t size)
 {
     size_t i = 0, j;
     const char *pt = pattern;
+    const char *st;
+    const char *last;
 
     if (str_len < size) {
         return (FALSE);
     }
 
+    /* Jump between candidates for the first character */
+    if (size > 0) {
+        last = str + (str_len - size);
+
+        for (st = str; st <= last; st++) {
+            st = _os_find_first(st, (size_t)(last - st) + 1, (uchar)*pattern);
+            if (!st) {
+                return (FALSE);
+            }
+            if (_os_literal_cmp(pattern + 1, st + 1, size - 1)) {
+                return (TRUE);
+            }
+        }
+
+        return (FALSE);
+    }
+
     size = str_len - size;
 
     /* Look to match the first pattern */
@@ -112,8 +169,18 @@ int OSMatch_Execute(const char *str, size_t str_len, OSMatch *reg)
         return (0);
     }
 
+    /* The substring alternatives are searched all at once */
+    if (reg->literals && OSMultiMatch_Search(str, str_len, reg->literals)) {
+        return(reg->negate == 0?1:0);
+    }
+
     /* Loop over all sub patterns */
     while (reg->patterns[i]) {
+        if (reg->literals && reg->match_fp[i] == _OS_Match) {
+            i++;
+            continue;
+        }
+
         if (reg->match_fp[i](reg->patterns[i],
                              str,
                              str_len,
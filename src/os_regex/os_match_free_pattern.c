@@ -34,6 +34,11 @@ void OSMatch_FreePattern(OSMatch *reg)
         reg->patterns = NULL;
     }
 
+    if (reg->literals) {
+        OSMultiMatch_FreePattern(reg->literals);
+        os_free(reg->literals);
+    }
+
     os_free(reg->size);
     os_free(reg->match_fp);
     os_free(reg->raw);
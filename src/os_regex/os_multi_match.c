@@ -0,0 +1,350 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "os_regex.h"
+#include "os_regex_internal.h"
+
+/* State 0 is the root. Transitions to it are never reported as "missing"
+ * since goto(root, c) falls back to the root itself.
+ */
+#define MM_ROOT 0
+#define MM_NONE ((unsigned int)-1)
+
+
+void OSMultiMatch_Init(OSMultiMatch *mm)
+{
+    memset(mm, 0, sizeof(OSMultiMatch));
+}
+
+int OSMultiMatch_AddPattern(OSMultiMatch *mm, const char *pattern, size_t size, int id)
+{
+    char **patterns;
+    int *ids;
+    size_t i;
+
+    if (mm->compiled || id < 0) {
+        mm->error = OS_REGEX_BADREGEX;
+        return (0);
+    }
+
+    if (size == 0) {
+        mm->error = OS_REGEX_PATTERN_NULL;
+        return (0);
+    }
+
+    if (size > OS_PATTERN_MAXSIZE) {
+        mm->error = OS_REGEX_MAXSIZE;
+        return (0);
+    }
+
+    patterns = (char **) realloc(mm->patterns, (mm->n_patterns + 1) * sizeof(char *));
+    if (!patterns) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        return (0);
+    }
+    mm->patterns = patterns;
+
+    ids = (int *) realloc(mm->ids, (mm->n_patterns + 1) * sizeof(int));
+    if (!ids) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        return (0);
+    }
+    mm->ids = ids;
+
+    if (mm->patterns[mm->n_patterns] = (char *) malloc(size + 1), !mm->patterns[mm->n_patterns]) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        return (0);
+    }
+
+    for (i = 0; i < size; i++) {
+        mm->patterns[mm->n_patterns][i] = (char) charmap[(uchar) pattern[i]];
+    }
+    mm->patterns[mm->n_patterns][size] = '\0';
+    mm->ids[mm->n_patterns] = id;
+    mm->n_patterns++;
+
+    return (1);
+}
+
+/* Release the literals kept until compilation */
+static void _OSMultiMatch_FreeLiterals(OSMultiMatch *mm)
+{
+    size_t i;
+
+    for (i = 0; i < mm->n_patterns; i++) {
+        free(mm->patterns[i]);
+    }
+
+    free(mm->patterns);
+    free(mm->ids);
+    mm->patterns = NULL;
+    mm->ids = NULL;
+    mm->n_patterns = 0;
+}
+
+int OSMultiMatch_Compile(OSMultiMatch *mm)
+{
+    size_t max_states = 1;
+    size_t i, j, c;
+    size_t n_outputs = 0;
+    unsigned int *fail = NULL;
+    unsigned int *queue = NULL;
+    size_t *own_start = NULL;
+    size_t *own_count = NULL;
+    int *own = NULL;
+    int *last_state = NULL;
+    size_t head = 0, tail = 0;
+
+    if (mm->compiled) {
+        return (1);
+    }
+
+    /* Input classes: every byte used by a literal gets its own class,
+     * the rest of bytes share class 0.
+     */
+    memset(mm->classes, 0, sizeof(mm->classes));
+    mm->n_classes = 1;
+
+    for (i = 0; i < mm->n_patterns; i++) {
+        for (j = 0; mm->patterns[i][j] != '\0'; j++) {
+            uchar b = (uchar) mm->patterns[i][j];
+
+            if (mm->classes[b] == 0) {
+                mm->classes[b] = (unsigned char) mm->n_classes++;
+            }
+        }
+        max_states += j;
+    }
+
+    /* Upper-case input bytes share the class of their lower-case form */
+    for (c = 0; c < 256; c++) {
+        mm->classes[c] = mm->classes[charmap[c]];
+    }
+
+    mm->delta = (unsigned int *) malloc(max_states * mm->n_classes * sizeof(unsigned int));
+    fail = (unsigned int *) calloc(max_states, sizeof(unsigned int));
+    queue = (unsigned int *) malloc(max_states * sizeof(unsigned int));
+    own_count = (size_t *) calloc(max_states, sizeof(size_t));
+
+    if (!mm->delta || !fail || !queue || !own_count) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        goto error;
+    }
+
+    for (i = 0; i < max_states * mm->n_classes; i++) {
+        mm->delta[i] = MM_NONE;
+    }
+
+    /* Build the trie */
+    mm->n_states = 1;
+
+    if (last_state = (int *) malloc(mm->n_patterns * sizeof(int) + 1), !last_state) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        goto error;
+    }
+
+    for (i = 0; i < mm->n_patterns; i++) {
+        unsigned int state = MM_ROOT;
+
+        for (j = 0; mm->patterns[i][j] != '\0'; j++) {
+            unsigned int *next = &mm->delta[state * mm->n_classes + mm->classes[(uchar) mm->patterns[i][j]]];
+
+            if (*next == MM_NONE) {
+                *next = (unsigned int) mm->n_states++;
+            }
+            state = *next;
+        }
+
+        last_state[i] = (int) state;
+        own_count[state]++;
+    }
+
+    /* Own outputs of each state, grouped by state */
+    own_start = (size_t *) calloc(mm->n_states + 1, sizeof(size_t));
+    own = (int *) malloc(mm->n_patterns * sizeof(int) + 1);
+
+    if (!own_start || !own) {
+        free(last_state);
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        goto error;
+    }
+
+    for (i = 0; i < mm->n_states; i++) {
+        own_start[i + 1] = own_start[i] + own_count[i];
+        own_count[i] = 0;
+    }
+
+    for (i = 0; i < mm->n_patterns; i++) {
+        size_t state = (size_t) last_state[i];
+        own[own_start[state] + own_count[state]++] = mm->ids[i];
+    }
+
+    free(last_state);
+
+    /* Breadth-first traversal: compute failure links and complete the
+     * transition table so that the search never needs to backtrack.
+     */
+    for (c = 0; c < mm->n_classes; c++) {
+        unsigned int *next = &mm->delta[MM_ROOT * mm->n_classes + c];
+
+        if (*next == MM_NONE) {
+            *next = MM_ROOT;
+        } else {
+            fail[*next] = MM_ROOT;
+            queue[tail++] = *next;
+        }
+    }
+
+    while (head < tail) {
+        unsigned int state = queue[head++];
+
+        for (c = 0; c < mm->n_classes; c++) {
+            unsigned int *next = &mm->delta[state * mm->n_classes + c];
+            unsigned int fallback = mm->delta[fail[state] * mm->n_classes + c];
+
+            if (*next == MM_NONE) {
+                *next = fallback;
+            } else {
+                fail[*next] = fallback;
+                queue[tail++] = *next;
+            }
+        }
+    }
+
+    /* Outputs: a state reports its own literals plus the ones of its
+     * failure state. The queue holds the states in BFS order, so every
+     * failure state is resolved before the states pointing to it.
+     */
+    if (mm->out_start = (size_t *) calloc(mm->n_states + 1, sizeof(size_t)), !mm->out_start) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        goto error;
+    }
+
+    {
+        size_t *total;
+
+        if (total = (size_t *) calloc(mm->n_states, sizeof(size_t)), !total) {
+            mm->error = OS_REGEX_OUTOFMEMORY;
+            goto error;
+        }
+
+        for (i = 0; i < tail; i++) {
+            unsigned int state = queue[i];
+            total[state] = (own_start[state + 1] - own_start[state]) + total[fail[state]];
+        }
+
+        for (i = 0; i < mm->n_states; i++) {
+            mm->out_start[i + 1] = mm->out_start[i] + total[i];
+        }
+
+        n_outputs = mm->out_start[mm->n_states];
+        free(total);
+    }
+
+    if (mm->out = (int *) malloc(n_outputs * sizeof(int) + 1), !mm->out) {
+        mm->error = OS_REGEX_OUTOFMEMORY;
+        goto error;
+    }
+
+    for (i = 0; i < tail; i++) {
+        unsigned int state = queue[i];
+        size_t pos = mm->out_start[state];
+        size_t own_n = own_start[state + 1] - own_start[state];
+        size_t inherited = mm->out_start[fail[state] + 1] - mm->out_start[fail[state]];
+
+        memcpy(mm->out + pos, own + own_start[state], own_n * sizeof(int));
+        memcpy(mm->out + pos + own_n, mm->out + mm->out_start[fail[state]], inherited * sizeof(int));
+    }
+
+    free(fail);
+    free(queue);
+    free(own_start);
+    free(own_count);
+    free(own);
+    _OSMultiMatch_FreeLiterals(mm);
+    mm->compiled = 1;
+
+    return (1);
+
+error:
+
+    free(fail);
+    free(queue);
+    free(own_start);
+    free(own_count);
+    free(own);
+    OSMultiMatch_FreePattern(mm);
+
+    return (0);
+}
+
+size_t OSMultiMatch_Execute(const char *str, const OSMultiMatch *mm, unsigned char *found)
+{
+    const unsigned int *delta = mm->delta;
+    const size_t n_classes = mm->n_classes;
+    unsigned int state = MM_ROOT;
+    size_t hits = 0;
+    size_t i;
+
+    if (!mm->compiled || mm->n_states <= 1) {
+        return (0);
+    }
+
+    for (; *str != '\0'; str++) {
+        state = delta[state * n_classes + mm->classes[(uchar) *str]];
+
+        for (i = mm->out_start[state]; i < mm->out_start[state + 1]; i++) {
+            found[mm->out[i]] = 1;
+            hits++;
+        }
+    }
+
+    return (hits);
+}
+
+int OSMultiMatch_Search(const char *str, size_t str_len, const OSMultiMatch *mm)
+{
+    const unsigned int *delta = mm->delta;
+    const size_t n_classes = mm->n_classes;
+    unsigned int state = MM_ROOT;
+    size_t i;
+
+    if (!mm->compiled || mm->n_states <= 1) {
+        return (0);
+    }
+
+    for (i = 0; i < str_len && str[i] != '\0'; i++) {
+        state = delta[state * n_classes + mm->classes[(uchar) str[i]]];
+
+        if (mm->out_start[state] < mm->out_start[state + 1]) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+void OSMultiMatch_FreePattern(OSMultiMatch *mm)
+{
+    _OSMultiMatch_FreeLiterals(mm);
+
+    free(mm->delta);
+    free(mm->out_start);
+    free(mm->out);
+
+    mm->delta = NULL;
+    mm->out_start = NULL;
+    mm->out = NULL;
+    mm->n_states = 0;
+    mm->compiled = 0;
+}
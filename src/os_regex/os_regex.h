@@ -45,6 +45,7 @@ typedef struct regex_dynamic_size {
 typedef struct regex_matching {
     char **sub_strings;
     const char ***prts_str;
+    const char **spans;         // Begin/end pairs of the captures in the matched string, owned by prts_str
     regex_dynamic_size d_size;
 } regex_matching;
 
@@ -70,8 +71,28 @@ typedef struct _OSMatch {
     size_t *size;
     char **patterns;
     int (**match_fp)(const char *str, const char *str2, size_t str_len, size_t size);
+    struct _OSMultiMatch *literals; ///< Automaton of the substring alternatives, NULL if they are few
 } OSMatch;
 
+/* OSMultiMatch structure.
+ * Aho-Corasick automaton that finds, in a single pass, which of a set
+ * of literals appear in a string. Comparison is case insensitive, the
+ * same way OSMatch works.
+ */
+typedef struct _OSMultiMatch {
+    int error;
+    int compiled;
+    size_t n_patterns;          ///< Number of added literals
+    char **patterns;            ///< Added literals (lower case), freed on compile
+    int *ids;                   ///< Identifier reported for each literal
+    unsigned char classes[256]; ///< Byte to input class map
+    size_t n_classes;           ///< Number of input classes
+    size_t n_states;            ///< Number of automaton states
+    unsigned int *delta;        ///< Transition table (n_states * n_classes)
+    size_t *out_start;          ///< First output of each state (n_states + 1 entries)
+    int *out;                   ///< Identifiers reported by each state
+} OSMultiMatch;
+
 /*** Prototypes ***/
 
 /* Compile a regular expression to be used later
@@ -110,6 +131,21 @@ const char *OSRegex_Execute(const char *str, OSRegex *reg) __attribute__((nonnul
  */
  const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *regex_match) __attribute__((nonnull(2)));
 
+/**
+ * @brief Compares an already compiled OSRegex regular expression with a string, without copying the captures
+ *
+ * Same as `OSRegex_Execute_ex` with an external context, but `regex_match->sub_strings` is left empty.
+ * On success, `regex_match->spans` holds the captures as begin/end pairs into `str`: the capture `i`
+ * goes from `spans[2 * i]` to `spans[2 * i + 1]`, and the list ends with a NULL begin. The spans are
+ * valid until the next call with the same `regex_match`, and as long as `str` is.
+ *
+ * @param str string to test
+ * @param reg compiled pattern
+ * @param regex_match Structure to manage pattern matches
+ * @return Returns the end of the string on success or NULL otherwise
+ */
+const char *OSRegex_Execute_spans(const char *str, OSRegex *reg, regex_matching *regex_match) __attribute__((nonnull(2, 3)));
+
 /* Release all the memory created by the compilation/execution phases */
 void OSRegex_FreePattern(OSRegex *reg) __attribute__((nonnull));
 
@@ -139,6 +175,63 @@ void OSMatch_FreePattern(OSMatch *reg) __attribute__((nonnull));
 
 int OS_Match2(const char *pattern, const char *str)  __attribute__((nonnull(2)));
 
+/**
+ * @brief Initialize an empty OSMultiMatch structure
+ *
+ * @param mm structure to initialize
+ */
+void OSMultiMatch_Init(OSMultiMatch *mm) __attribute__((nonnull));
+
+/**
+ * @brief Add a literal to an OSMultiMatch automaton before compiling it
+ *
+ * @param mm automaton
+ * @param pattern literal to search (no special characters are parsed)
+ * @param size length of the literal
+ * @param id identifier reported when the literal is found (must be >= 0)
+ * @return 1 on success or 0 on error. The error code is set on mm->error
+ */
+int OSMultiMatch_AddPattern(OSMultiMatch *mm, const char *pattern, size_t size, int id) __attribute__((nonnull));
+
+/**
+ * @brief Build the automaton from the literals added so far
+ *
+ * @param mm automaton
+ * @return 1 on success or 0 on error. The error code is set on mm->error
+ */
+int OSMultiMatch_Compile(OSMultiMatch *mm) __attribute__((nonnull));
+
+/**
+ * @brief Search all the literals of a compiled automaton in a string
+ *
+ * Thread safe: the automaton is not modified.
+ *
+ * @param str string to search into
+ * @param mm compiled automaton
+ * @param found array indexed by identifier. Position id is set to 1 for every literal found
+ * @return number of literal occurrences found
+ */
+size_t OSMultiMatch_Execute(const char *str, const OSMultiMatch *mm, unsigned char *found) __attribute__((nonnull));
+
+/**
+ * @brief Check if any literal of a compiled automaton appears in a string
+ *
+ * Thread safe: the automaton is not modified. The search stops at the first literal found.
+ *
+ * @param str string to search into
+ * @param str_len number of bytes of str to search
+ * @param mm compiled automaton
+ * @return 1 if a literal was found or 0 otherwise
+ */
+int OSMultiMatch_Search(const char *str, size_t str_len, const OSMultiMatch *mm) __attribute__((nonnull));
+
+/**
+ * @brief Release all the memory held by an OSMultiMatch structure
+ *
+ * @param mm automaton
+ */
+void OSMultiMatch_FreePattern(OSMultiMatch *mm) __attribute__((nonnull));
+
 /* Searches for pattern in the string */
 int OS_WordMatch(const char *pattern, const char *str) __attribute__((nonnull));
 #define OS_Match OS_WordMatch
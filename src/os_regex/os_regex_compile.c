@@ -240,6 +240,11 @@ int OSRegex_Compile(const char *pattern, OSRegex *reg, int flags)
 
             }
 
+            /* Sub patterns without operators skip the interpreter */
+            if (*reg->patterns[i] != '\0' && !strpbrk(reg->patterns[i], "\\(")) {
+                reg->flags[i] |= LITERAL_SET;
+            }
+
             /* Set the parenthesis closures */
             /* The parenthesis closure if set */
             if (reg->prts_closure) {
@@ -18,6 +18,9 @@
 /* Internal prototypes */
 static const char *_OS_Regex(const char *pattern, const char *str, const char **prts_closure,
                              const char **prts_str, int flags) __attribute__((nonnull(1, 2)));
+static const char *_OS_Regex_Literal(const char *pattern, const char *str, int flags) __attribute__((nonnull));
+static const char *_OSRegex_Execute(const char *str, OSRegex *reg, regex_matching *regex_match,
+                                    bool copy_captures) __attribute__((nonnull(2)));
 
 
 const char *OSRegex_Execute(const char *str, OSRegex *reg)
@@ -26,6 +29,20 @@ const char *OSRegex_Execute(const char *str, OSRegex *reg)
 }
 
 const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *regex_match)
+{
+    return _OSRegex_Execute(str, reg, regex_match, true);
+}
+
+const char *OSRegex_Execute_spans(const char *str, OSRegex *reg, regex_matching *regex_match)
+{
+    return _OSRegex_Execute(str, reg, regex_match, false);
+}
+
+/* Match the sub patterns of reg against str. The captures are always left
+ * as begin/end pairs in prts_str, and copied into sub_strings only when
+ * copy_captures is set.
+ */
+static const char *_OSRegex_Execute(const char *str, OSRegex *reg, regex_matching *regex_match, bool copy_captures)
 {
     char ***sub_strings;
     const char ****prts_str;
@@ -57,6 +74,10 @@ const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *re
     }
     w_FreeArray(*sub_strings);
 
+    if (external_context) {
+        regex_match->spans = NULL;
+    }
+
     if (external_context && prts_str) {
         if (str_sizes->prts_str_alloc_size < reg->d_size.prts_str_alloc_size) {
             os_realloc(*prts_str, reg->d_size.prts_str_alloc_size, *prts_str);
@@ -108,12 +129,21 @@ const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *re
             /* Clean the prts_str */
             memset((void*)(*prts_str)[i], 0, (str_sizes) ? str_sizes->prts_str_size[i] : reg->d_size.prts_str_size[i]);
 
-            if ((ret = _OS_Regex(reg->patterns[i], str, reg->prts_closure[i],
-                                 (*prts_str)[i], reg->flags[i]))) {
+            if (reg->flags[i] & LITERAL_SET) {
+                ret = _OS_Regex_Literal(reg->patterns[i], str, reg->flags[i]);
+            } else {
+                ret = _OS_Regex(reg->patterns[i], str, reg->prts_closure[i], (*prts_str)[i], reg->flags[i]);
+            }
+
+            if (ret) {
                 j = 0;
 
+                if (external_context) {
+                    regex_match->spans = (*prts_str)[i];
+                }
+
                 /* We must always have the open and the close */
-                while ((*prts_str)[i][j] && (*prts_str)[i][j + 1]) {
+                while (copy_captures && (*prts_str)[i][j] && (*prts_str)[i][j + 1]) {
                     size_t length = (size_t) ((*prts_str)[i][j + 1] - (*prts_str)[i][j]);
                     if (*sub_strings == NULL) {
                         if (!external_context) {
@@ -157,7 +187,13 @@ const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *re
 
     /* Loop on all sub patterns */
     for (i = 0; reg->patterns[i]; i++) {
-        if ((ret = _OS_Regex(reg->patterns[i], str, NULL, NULL, reg->flags[i]))) {
+        if (reg->flags[i] & LITERAL_SET) {
+            ret = _OS_Regex_Literal(reg->patterns[i], str, reg->flags[i]);
+        } else {
+            ret = _OS_Regex(reg->patterns[i], str, NULL, NULL, reg->flags[i]);
+        }
+
+        if (ret) {
             if (!external_context) {
                 w_mutex_unlock((pthread_mutex_t *)&reg->mutex);
             }
@@ -171,6 +207,48 @@ const char *OSRegex_Execute_ex(const char *str, OSRegex *reg, regex_matching *re
     return (NULL);
 }
 
+/* Match a sub pattern made only of plain characters.
+ * Gives the same result as _OS_Regex: on success, returns a pointer to the
+ * last character of the leftmost match (the last character of the string
+ * if END_SET is set). A first-character scan skips most of the string.
+ */
+static const char *_OS_Regex_Literal(const char *pattern, const char *str, int flags)
+{
+    const size_t size = strlen(pattern);
+    const size_t str_len = strlen(str);
+    const char *st;
+    const char *last;
+
+    if (str_len < size) {
+        return (NULL);
+    }
+
+    if (flags & BEGIN_SET) {
+        if (((flags & END_SET) && str_len != size) || !_os_literal_cmp(pattern, str, size)) {
+            return (NULL);
+        }
+        return (str + size - 1);
+    }
+
+    if (flags & END_SET) {
+        return (_os_literal_cmp(pattern, str + str_len - size, size) ? str + str_len - 1 : NULL);
+    }
+
+    last = str + (str_len - size);
+
+    for (st = str; st <= last; st++) {
+        st = _os_find_first(st, (size_t)(last - st) + 1, (uchar)*pattern);
+        if (!st) {
+            return (NULL);
+        }
+        if (_os_literal_cmp(pattern + 1, st + 1, size - 1)) {
+            return (st + size - 1);
+        }
+    }
+
+    return (NULL);
+}
+
 #define PRTS(x) ((prts(*x) && x++) || 1)
 #define ENDOFFILE(x) ( PRTS(x) && (*x == '\0'))
 
@@ -18,6 +18,10 @@ int _os_strcmp_last(const char *pattern, const char *str, size_t str_len, size_t
 int _os_strcmp(const char *pattern, const char *str, size_t str_len, size_t size) __attribute__((nonnull));
 int _os_strmatch(const char *pattern, const char *str, size_t str_len, size_t size) __attribute__((nonnull));
 
+/* Literal scanning helpers shared by OSMatch and OSRegex */
+const char *_os_find_first(const char *str, size_t str_len, unsigned char c) __attribute__((nonnull));
+int _os_literal_cmp(const char *pattern, const char *str, size_t size) __attribute__((nonnull));
+
 #define BACKSLASH   '\\'
 #define ENDSTR      '\0'
 #define ENDLINE     '\n'
@@ -29,9 +33,15 @@ int _os_strmatch(const char *pattern, const char *str, size_t str_len, size_t si
 #define TRUE         1
 #define FALSE        0
 
+/* Substring alternatives of an OSMatch from which they are searched
+ * with an OSMultiMatch automaton instead of one by one.
+ */
+#define OS_MATCH_MULTI_MIN  8
+
 /* Pattern flags */
 #define BEGIN_SET   0000200
 #define END_SET     0000400
+#define LITERAL_SET 0001000 /* Sub pattern has no regex operators */
 
 /* uchar */
 typedef unsigned char uchar;
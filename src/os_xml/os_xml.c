@@ -14,6 +14,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <ctype.h>
 
 #include "os_xml.h"
@@ -47,7 +48,12 @@ static int _xml_fgetc(FILE *fp, OS_XML *_lxml)
     int c;
 
     // If there is any character in the stash, get it
+#ifndef WIN32
+    // The stream is only used by the parser, no need to lock it on every character
+    c = (_lxml->stash_i > 0) ? _lxml->stash[--_lxml->stash_i] : getc_unlocked(fp);
+#else
     c = (_lxml->stash_i > 0) ? _lxml->stash[--_lxml->stash_i] : fgetc(fp);
+#endif
 
     if (c == '\n') { /* add newline */
         _lxml->line++;
@@ -62,11 +68,12 @@ int _xml_sgetc(OS_XML *_lxml){
     if (_lxml->stash_i > 0) {
         c = _lxml->stash[--_lxml->stash_i];
     }
-    else if (_lxml->string) {
+    else if (_lxml->string && *_lxml->string) {
         c = *(_lxml->string++);
     }
     else {
-        c = -1;
+        // The end of the string is not consumed
+        c = EOF;
     }
 
     if (c == '\n') { /* add newline */
@@ -76,6 +83,38 @@ int _xml_sgetc(OS_XML *_lxml){
     return c;
 }
 
+/**
+ * @brief Take the run of plain characters of the XML string at once.
+ *
+ * A plain character doesn't change the parser state: it's not a tag start, an escape
+ * character, a new line or the end of the string.
+ *
+ * @param _lxml XML structure.
+ * @param dst Buffer to copy the characters to, or NULL to skip them.
+ * @param max Maximum number of characters to take.
+ * @return Number of characters taken.
+ */
+static size_t _xml_sspan(OS_XML *_lxml, char *dst, size_t max)
+{
+    const char *str = _lxml->string;
+    size_t n = 0;
+
+    if (_lxml->fp || !str || _lxml->stash_i > 0) {
+        return 0;
+    }
+
+    while (n < max && str[n] != _R_CONFS && str[n] != '\\' && str[n] != '\n' && str[n] != '\0') {
+        n++;
+    }
+
+    if (dst) {
+        memcpy(dst, str, n);
+    }
+
+    _lxml->string += n;
+    return n;
+}
+
 static int _xml_ungetc(int c, OS_XML *_lxml)
 {
     // If stash is full, give up
@@ -112,6 +151,7 @@ void OS_ClearXML(OS_XML *_lxml)
         free(_lxml->ct[i]);
     }
     _lxml->cur = 0;
+    _lxml->size = 0;
     _lxml->fol = 0;
     _lxml->err_line = 0;
 
@@ -202,6 +242,8 @@ int OS_ReadXMLString(const char *string, OS_XML *_lxml){
 /* Read a XML file and generate the necessary structs */
 int OS_ReadXML_Ex(const char *file, OS_XML *_lxml, bool flag_truncate) {
     FILE *fp;
+    long size;
+    char *buffer;
 
     /* Initialize xml structure */
     memset(_lxml, 0, sizeof(OS_XML));
@@ -212,8 +254,30 @@ int OS_ReadXML_Ex(const char *file, OS_XML *_lxml, bool flag_truncate) {
         return (-2);
     }
     w_file_cloexec(fp);
-    _lxml->fp = fp;
-    _lxml->string = NULL;
+
+    /* Load the whole file to parse it in memory, or read it as a stream if its size is unknown */
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_SET) == 0 &&
+        (buffer = malloc(size + 1)) != NULL) {
+        // The text mode may read fewer bytes than the file size
+        size_t length = fread(buffer, 1, size, fp);
+
+        if (ferror(fp)) {
+            xml_error(_lxml, "XMLERR: Cannot read file '%s'.", file);
+            free(buffer);
+            fclose(fp);
+            return (-2);
+        }
+
+        buffer[length] = '\0';
+        fclose(fp);
+
+        _lxml->fp = NULL;
+        _lxml->string = buffer;
+    } else {
+        rewind(fp);
+        _lxml->fp = fp;
+        _lxml->string = NULL;
+    }
 
     return ParseXML(_lxml, flag_truncate);
 }
@@ -256,7 +320,6 @@ static int _ReadElem(unsigned int parent, OS_XML *_lxml, unsigned int recursion_
     unsigned int count = 0;
     unsigned int _currentlycont = 0;
     short int location = -1;
-    int cmp = 0;
     int retval = -1;
     bool ignore_content = false;
 
@@ -271,22 +334,44 @@ static int _ReadElem(unsigned int parent, OS_XML *_lxml, unsigned int recursion_
         return -1;
     }
 
-    elem = calloc(XML_MAXSIZE + 1, sizeof(char));
-    cont = calloc(XML_MAXSIZE + 1, sizeof(char));
-    closedelim = calloc(XML_MAXSIZE + 1, sizeof(char));
-
-    if (elem == NULL || cont == NULL || closedelim == NULL) {
+    /* The buffers are always terminated before use, they don't need to be zeroed */
+    if (elem = malloc(3 * (XML_MAXSIZE + 1)), elem == NULL) {
         goto end;
     }
 
+    cont = elem + XML_MAXSIZE + 1;
+    closedelim = cont + XML_MAXSIZE + 1;
+    *elem = *cont = *closedelim = '\0';
+
     if (_lxml->fp){
-        cmp = EOF;
         _lxml->string = NULL;
-    } else if (_lxml->string){
-        cmp = '\0';
     }
 
-    while ((c = xml_getc_fun(_lxml->fp, _lxml)) != cmp) {
+    for (;;) {
+        /* Take the text between and inside the elements in bulk */
+        if (location == -1) {
+            if (_xml_sspan(_lxml, NULL, SIZE_MAX) > 0) {
+                prevv = 1;
+            }
+        } else if (location == 1) {
+            if (ignore_content) {
+                if (_xml_sspan(_lxml, NULL, SIZE_MAX) > 0) {
+                    prevv = 1;
+                }
+            } else if (count < XML_MAXSIZE) {
+                size_t n = _xml_sspan(_lxml, cont + count, XML_MAXSIZE - count);
+
+                if (n > 0) {
+                    count += n;
+                    prevv = 1;
+                }
+            }
+        }
+
+        if ((c = xml_getc_fun(_lxml->fp, _lxml)) == EOF) {
+            break;
+        }
+
         if (c == '\\') {
             prevv *= -1;
         } else if (c != _R_CONFS && prevv == -1){
@@ -360,10 +445,6 @@ static int _ReadElem(unsigned int parent, OS_XML *_lxml, unsigned int recursion_
                 count = 0;
                 location = -1;
 
-                memset(elem, '\0', XML_MAXSIZE);
-                memset(closedelim, '\0', XML_MAXSIZE);
-                memset(cont, '\0', XML_MAXSIZE);
-
                 if (parent > 0) {
                     retval = 0;
                     goto end;
@@ -384,9 +465,6 @@ static int _ReadElem(unsigned int parent, OS_XML *_lxml, unsigned int recursion_
                 goto end;
             }
             _lxml->ck[_currentlycont] = 1;
-            memset(elem, '\0', XML_MAXSIZE);
-            memset(closedelim, '\0', XML_MAXSIZE);
-            memset(cont, '\0', XML_MAXSIZE);
             _currentlycont = 0;
             count = 0;
             location = -1;
@@ -430,18 +508,7 @@ static int _ReadElem(unsigned int parent, OS_XML *_lxml, unsigned int recursion_
     xml_error(_lxml, "XMLERR: End of file and some elements were not closed.");
 
 end:
-    if (elem) {
-        free(elem);
-    }
-
-    if (cont) {
-        free(cont);
-    }
-
-    if (closedelim) {
-        free(closedelim);
-    }
-
+    free(elem);
     return retval;
 }
 
@@ -453,56 +520,61 @@ static int _writememory(const char *str, XML_TYPE type, size_t size,
     unsigned int *tmp3;
     XML_TYPE *tmp4;
 
-    /* Allocate for the element */
-    tmp = (char **)realloc(_lxml->el, (_lxml->cur + 1) * sizeof(char *));
-    if (tmp == NULL) {
-        goto fail;
+    /* Grow the arrays geometrically instead of one item per element */
+    if (_lxml->cur >= _lxml->size) {
+        unsigned int new_size = _lxml->size ? _lxml->size * 2 : XML_INITIAL_SIZE;
+
+        tmp = (char **)realloc(_lxml->el, new_size * sizeof(char *));
+        if (tmp == NULL) {
+            goto fail;
+        }
+        _lxml->el = tmp;
+
+        tmp = (char **)realloc(_lxml->ct, new_size * sizeof(char *));
+        if (tmp == NULL) {
+            goto fail;
+        }
+        _lxml->ct = tmp;
+
+        tmp4 = (XML_TYPE *) realloc(_lxml->tp, new_size * sizeof(XML_TYPE));
+        if (tmp4 == NULL) {
+            goto fail;
+        }
+        _lxml->tp = tmp4;
+
+        tmp3 = (unsigned int *) realloc(_lxml->rl, new_size * sizeof(unsigned int));
+        if (tmp3 == NULL) {
+            goto fail;
+        }
+        _lxml->rl = tmp3;
+
+        tmp2 = (int *) realloc(_lxml->ck, new_size * sizeof(int));
+        if (tmp2 == NULL) {
+            goto fail;
+        }
+        _lxml->ck = tmp2;
+
+        tmp3 = (unsigned int *) realloc(_lxml->ln, new_size * sizeof(unsigned int));
+        if (tmp3 == NULL) {
+            goto fail;
+        }
+        _lxml->ln = tmp3;
+
+        _lxml->size = new_size;
     }
-    _lxml->el = tmp;
-    _lxml->el[_lxml->cur] = (char *)calloc(size, sizeof(char));
+
+    /* Allocate for the element */
+    _lxml->el[_lxml->cur] = (char *)malloc(size);
     if (_lxml->el[_lxml->cur] == NULL) {
         goto fail;
     }
     strncpy(_lxml->el[_lxml->cur], str, size - 1);
+    _lxml->el[_lxml->cur][size - 1] = '\0';
 
-    /* Allocate for the content */
-    tmp = (char **)realloc(_lxml->ct, (_lxml->cur + 1) * sizeof(char *));
-    if (tmp == NULL) {
-        goto fail;
-    }
-    _lxml->ct = tmp;
     _lxml->ct[_lxml->cur] = NULL;
-
-    /* Allocate for the type */
-    tmp4 = (XML_TYPE *) realloc(_lxml->tp, (_lxml->cur + 1) * sizeof(XML_TYPE));
-    if (tmp4 == NULL) {
-        goto fail;
-    }
-    _lxml->tp = tmp4;
     _lxml->tp[_lxml->cur] = type;
-
-    /* Allocate for the relation */
-    tmp3 = (unsigned int *) realloc(_lxml->rl, (_lxml->cur + 1) * sizeof(unsigned int));
-    if (tmp3 == NULL) {
-        goto fail;
-    }
-    _lxml->rl = tmp3;
     _lxml->rl[_lxml->cur] = parent;
-
-    /* Allocate for the "check" */
-    tmp2 = (int *) realloc(_lxml->ck, (_lxml->cur + 1) * sizeof(int));
-    if (tmp2 == NULL) {
-        goto fail;
-    }
-    _lxml->ck = tmp2;
     _lxml->ck[_lxml->cur] = 0;
-
-    /* Allocate for the line */
-    tmp3 = (unsigned int *) realloc(_lxml->ln, (_lxml->cur + 1) * sizeof(unsigned int));
-    if (tmp3 == NULL) {
-        goto fail;
-    }
-    _lxml->ln = tmp3;
     _lxml->ln[_lxml->cur] = _lxml->line;
 
     /* Attributes does not need to be closed */
@@ -546,8 +618,8 @@ static int _getattributes(unsigned int parent, OS_XML *_lxml)
     char attr[XML_MAXSIZE + 1];
     char value[XML_MAXSIZE + 1];
 
-    memset(attr, '\0', XML_MAXSIZE + 1);
-    memset(value, '\0', XML_MAXSIZE + 1);
+    /* Both buffers are terminated before use */
+    attr[0] = value[0] = '\0';
 
     while ((c = xml_getc_fun(_lxml->fp, _lxml)) != EOF) {
         if (count >= XML_MAXSIZE) {
@@ -563,6 +635,7 @@ static int _getattributes(unsigned int parent, OS_XML *_lxml)
                           attr);
                 return (-1);
             } else if ((location == 0) && (count > 0)) {
+                attr[count] = '\0';
                 xml_error(_lxml, "XMLERR: Attribute '%s' has no value.",
                           attr);
                 return (-1);
@@ -620,6 +693,7 @@ static int _getattributes(unsigned int parent, OS_XML *_lxml)
             if (count == 0) {
                 continue;
             } else {
+                attr[count] = '\0';
                 xml_error(_lxml, "XMLERR: Attribute '%s' has no value.", attr);
                 return (-1);
             }
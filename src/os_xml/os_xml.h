@@ -27,12 +27,14 @@ typedef struct _xml_node {
 
 #define XML_ERR_LENGTH  128
 #define XML_STASH_LEN   2
+#define XML_INITIAL_SIZE 64     /* Items allocated the first time, the arrays double when they are full */
 #define xml_getc_fun(x,y) (x)? _xml_fgetc(x,y) : _xml_sgetc(y)
 typedef enum _XML_TYPE { XML_ATTR, XML_ELEM, XML_VARIABLE_BEGIN = '$' } XML_TYPE;
 
 /* XML structure */
 typedef struct _OS_XML {
     unsigned int cur;           /* Current position (and last after reading) */
+    unsigned int size;          /* Number of items allocated */
     int fol;                    /* Current position for the xml_access */
     XML_TYPE *tp;               /* Item type */
     unsigned int *rl;           /* Relation in the XML */
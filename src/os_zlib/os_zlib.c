@@ -8,6 +8,9 @@
  * Foundation
  */
 
+#include <pthread.h>
+#include <stdlib.h>
+
 #include "os_zlib.h"
 
 #include "../external/zlib/zlib.h"
@@ -28,16 +31,66 @@ unsigned long int os_zlib_compress(const char *src, char *dst,
     return (0);
 }
 
+/* Inflate stream of the calling thread, it is reset on every call */
+static pthread_key_t inflate_key;
+static pthread_once_t inflate_once = PTHREAD_ONCE_INIT;
+
+static void inflate_stream_free(void *stream)
+{
+    inflateEnd((z_stream *)stream);
+    free(stream);
+}
+
+static void inflate_key_init()
+{
+    pthread_key_create(&inflate_key, inflate_stream_free);
+}
+
+static z_stream *inflate_get_stream()
+{
+    z_stream *stream;
+
+    pthread_once(&inflate_once, inflate_key_init);
+
+    if (stream = pthread_getspecific(inflate_key), stream) {
+        return (inflateReset(stream) == Z_OK ? stream : NULL);
+    }
+
+    if (stream = calloc(1, sizeof(z_stream)), !stream) {
+        return (NULL);
+    }
+
+    if (inflateInit(stream) != Z_OK) {
+        free(stream);
+        return (NULL);
+    }
+
+    pthread_setspecific(inflate_key, stream);
+    return (stream);
+}
+
 unsigned long int os_zlib_uncompress(const char *src, char *dst,
                                      unsigned long int src_size,
                                      unsigned long int dst_size)
 {
-    if (uncompress((Bytef *)dst,
-                   &dst_size,
-                   (const Bytef *)src,
-                   src_size) == Z_OK) {
-        dst[dst_size] = '\0';
-        return (dst_size);
+    z_stream *stream;
+
+    if (!src || !dst || !src_size || !dst_size) {
+        return (0);
+    }
+
+    if (stream = inflate_get_stream(), !stream) {
+        return (0);
+    }
+
+    stream->next_in = (Bytef *)src;
+    stream->avail_in = (uInt)src_size;
+    stream->next_out = (Bytef *)dst;
+    stream->avail_out = (uInt)dst_size;
+
+    if (inflate(stream, Z_FINISH) == Z_STREAM_END) {
+        dst[stream->total_out] = '\0';
+        return (stream->total_out);
     }
 
     return (0);
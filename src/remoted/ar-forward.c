@@ -15,6 +15,56 @@
 #include "state.h"
 #include "os_net/os_net.h"
 
+/* Separator of the agent IDs in a broadcast request */
+#define AR_AGENT_SEPARATOR ","
+
+/* Active responses sent per second among all the agents (0 means no limit) */
+static int ar_rate = 0;
+static int ar_rate_count = 0;
+static time_t ar_rate_window = 0;
+
+/**
+ * @brief Wait until the active response rate allows sending a message
+ */
+static void ar_rate_wait(void)
+{
+    struct timespec now;
+
+    if (ar_rate == 0) {
+        return;
+    }
+
+    while (1) {
+        gettime(&now);
+
+        if (now.tv_sec != ar_rate_window) {
+            ar_rate_window = now.tv_sec;
+            ar_rate_count = 0;
+        }
+
+        if (ar_rate_count < ar_rate) {
+            ar_rate_count++;
+            return;
+        }
+
+        w_time_delay((1000000000 - now.tv_nsec) / 1000000 + 1);
+    }
+}
+
+/**
+ * @brief Send an active response to an agent, within the rate limit
+ *
+ * @param agent_id Agent ID
+ * @param msg_to_send Message to send
+ */
+static void ar_send(const char *agent_id, const char *msg_to_send)
+{
+    ar_rate_wait();
+
+    if (send_msg(agent_id, msg_to_send, -1) >= 0) {
+        rem_inc_send_ar(agent_id);
+    }
+}
 
 /* Start of a new thread. Only returns on unrecoverable errors. */
 void *AR_Forward(__attribute__((unused)) void *arg)
@@ -26,9 +76,15 @@ void *AR_Forward(__attribute__((unused)) void *arg)
     os_calloc(OS_MAXSTR, sizeof(char), msg_to_send);
     char *msg;
     os_calloc(OS_MAXSTR, sizeof(char), msg);
+    char *last_msg;
+    os_calloc(OS_MAXSTR, sizeof(char), last_msg);
+    time_t last_time = 0;
     char *ar_agent_id = NULL;
     char *tmp_str = NULL;
 
+    ar_rate = getDefine_Int("remoted", "ar_rate", 0, 100000);
+    int ar_dedupe_time = getDefine_Int("remoted", "ar_dedupe_time", 0, 3600);
+
     /* Create the unix queue */
     if ((arq = StartMQ(path, READ, 0)) < 0) {
         merror_exit(QUEUE_ERROR, path, strerror(errno));
@@ -40,6 +96,19 @@ void *AR_Forward(__attribute__((unused)) void *arg)
 
             mdebug2("Active response request received: %s", msg);
 
+            /* Drop the copies of a request that is still being delivered */
+            if (ar_dedupe_time > 0) {
+                time_t now = time(0);
+
+                if (now - last_time < ar_dedupe_time && strcmp(msg, last_msg) == 0) {
+                    mdebug2("Discarding duplicated active response request.");
+                    continue;
+                }
+
+                strncpy(last_msg, msg, OS_MAXSTR - 1);
+                last_time = now;
+            }
+
             /* Always zero the location */
             ar_location = 0;
 
@@ -110,9 +179,7 @@ void *AR_Forward(__attribute__((unused)) void *arg)
                     if (keys.keyentries[i]->rcvd >= (time(0) - logr.global.agents_disconnection_time)) {
                         strncpy(agent_id, keys.keyentries[i]->id, KEYSIZE);
                         key_unlock();
-                        if (send_msg(agent_id, msg_to_send, -1) >= 0) {
-                            rem_inc_send_ar(agent_id);
-                        }
+                        ar_send(agent_id, msg_to_send);
                         key_lock_read();
                     }
                 }
@@ -120,10 +187,13 @@ void *AR_Forward(__attribute__((unused)) void *arg)
                 key_unlock();
             }
 
-            /* Send to the remote agent that generated the event or to a pre-defined agent */
+            /* Send to the remote agent that generated the event or to the pre-defined agents */
             else if (ar_location & (REMOTE_AGENT | SPECIFIC_AGENT)) {
-                if (send_msg(ar_agent_id, msg_to_send, -1) >= 0) {
-                    rem_inc_send_ar(ar_agent_id);
+                char *save_ptr = NULL;
+
+                for (tmp_str = strtok_r(ar_agent_id, AR_AGENT_SEPARATOR, &save_ptr); tmp_str;
+                     tmp_str = strtok_r(NULL, AR_AGENT_SEPARATOR, &save_ptr)) {
+                    ar_send(tmp_str, msg_to_send);
                 }
             }
         }
@@ -23,6 +23,7 @@ unsigned send_chunk;
 unsigned send_buffer_size;
 int send_timeout_to_retry;
 int buffer_relax;
+unsigned latency_sample;
 
 /* Read the config file (the remote access) */
 int RemotedConfig(const char *cfgfile, remoted *cfg)
@@ -43,6 +44,7 @@ int RemotedConfig(const char *cfgfile, remoted *cfg)
     buffer_relax = getDefine_Int("remoted", "buffer_relax", 0, 2);
     send_buffer_size = (unsigned)getDefine_Int("remoted", "send_buffer_size", 65536, 1048576);
     send_timeout_to_retry = getDefine_Int("remoted", "send_timeout_to_retry", 1, 60);
+    latency_sample = (unsigned)getDefine_Int("remoted", "latency_sample", 0, 1000000);
 
     /* Setting default values for global parameters */
     cfg->global.agents_disconnection_time = 600;
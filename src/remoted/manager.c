@@ -39,10 +39,17 @@ typedef struct _file_time {
     time_t m_time;
 } file_time;
 
+typedef struct _file_stat {
+    ino_t inode;
+    off_t size;
+    time_t m_time;
+} file_stat;
+
 typedef struct group_t {
     char *name;
     OSHash *f_time;
     os_md5 merged_sum;
+    file_stat merged_stat;
     bool has_changed;
     bool exists;
 } group_t;
@@ -58,21 +65,23 @@ static const char *IGNORE_LIST[] = { SHAREDCFG_FILENAME, NULL };
  * @param group Group name
  * @param _f_time File time table to update
  * @param _merged_sum Merged sum to update
+ * @param _merged_stat Attributes of the merged.mg file the sum was computed from
  * @param sharedcfg_dir Group directory
  * @param create_merged Flag indicating if merged.mg needs to be created
  * @param is_multigroup Flag indicating if this is a multigroup
  */
-STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, char *sharedcfg_dir, bool create_merged, bool is_multigroup);
+STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, file_stat *_merged_stat, char *sharedcfg_dir, bool create_merged, bool is_multigroup);
 
 /**
  * @brief Process multigroup, update file time structure and create merged.mg file
  * @param multi_group Multigroup name
  * @param _f_time File time table to update
  * @param _merged_sum Merged sum to update
+ * @param _merged_stat Attributes of the merged.mg file the sum was computed from
  * @param hash_multigroup Multigroup hash
  * @param create_merged Flag indicating if merged.mg needs to be created
  */
-STATIC void c_multi_group(char *multi_group, OSHash **_f_time, os_md5 *_merged_sum, char *hash_multigroup, bool create_merged);
+STATIC void c_multi_group(char *multi_group, OSHash **_f_time, os_md5 *_merged_sum, file_stat *_merged_stat, char *hash_multigroup, bool create_merged);
 
 /**
  * @brief Process groups and multigroups files
@@ -125,6 +134,14 @@ STATIC group_t* find_group_from_sum(const char * md5, char group_name[OS_SIZE_65
  */
 STATIC group_t* find_multi_group_from_sum(const char * md5, char multigroup_name[OS_SIZE_65536]);
 
+/**
+ * @brief Index the groups and multigroups by their merged sum
+ * @param table Groups or multigroups table
+ * @param index Index to replace, it's created if NULL
+ * @return The new index
+ */
+STATIC OSHash * index_groups_by_sum(OSHash * table, OSHash * index);
+
 /**
  * @brief Compare and check if the file time has changed
  * @param old_time File time table of previous scan
@@ -134,6 +151,15 @@ STATIC group_t* find_multi_group_from_sum(const char * md5, char multigroup_name
  */
 STATIC bool ftime_changed(OSHash *old_time, OSHash *new_time);
 
+/**
+ * @brief Check if a file is the same one whose attributes were saved
+ * @param saved Attributes saved when the file was hashed
+ * @param attrib Current attributes of the file
+ * @return true Same inode, size and modification time
+ * @return false The file may have changed
+ */
+STATIC bool file_stat_equal(const file_stat *saved, const struct stat *attrib);
+
 /**
  * @brief Check if any group of a given multigroup has changed
  * @param multi_group Multigroup name
@@ -201,10 +227,50 @@ STATIC void copy_directory(const char *src_path, const char *dst_path, char *gro
  */
 STATIC void send_wrong_version_response(const char *agent_id, char *msg, agent_status_code_t status_code, char *version, int *wdb_sock);
 
+/**
+ * @brief Queue the keepalive of an agent to be saved in the next batch
+ * @param agent_id ID of the agent
+ */
+STATIC void push_keepalive(int agent_id);
+
+/**
+ * @brief Drop the queued keepalive of an agent, so that it does not overwrite a new connection status
+ * @param agent_id ID of the agent
+ */
+STATIC void drop_keepalive(int agent_id);
+
+/**
+ * @brief Send the reply to a control message
+ * @param key Agent key entry
+ * @param is_batch The agent sends batches of events
+ * @param is_compact The agent sends compact keepalives
+ * @param request_metadata Ask the agent for its full keepalive
+ */
+STATIC void send_control_ack(const keyentry * key, int is_batch, int is_compact, int request_metadata);
+
+/**
+ * @brief Get the metadata of a compact keepalive from the last full keepalive of the agent
+ * @param key Agent key entry
+ * @param payload Compact keepalive: "<sequence> <metadata hash>"
+ * @return Copy of the last full keepalive. NULL if the hash does not match it
+ */
+STATIC char * expand_keepalive(const keyentry * key, const char * payload);
+
+/**
+ * @brief Wait until the shared files bandwidth allows sending a chunk
+ * @param size Size of the chunk to send
+ */
+STATIC void shared_rate_wait(size_t size);
+
 /* Groups structures */
 static OSHash *groups;
 static OSHash *multi_groups;
 
+/* Groups and multigroups by merged sum, rebuilt on the first lookup after a scan */
+static OSHash *groups_by_sum;
+static OSHash *multi_groups_by_sum;
+static bool groups_by_sum_outdated = true;
+
 static time_t _stime;
 int INTERVAL;
 
@@ -219,12 +285,32 @@ OSHash *pending_data;
 static pthread_mutex_t lastmsg_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t files_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* Keepalives to be saved in the next batch */
+static int *keepalive_ids;
+static size_t keepalive_count;
+static size_t keepalive_size;
+static pthread_mutex_t keepalive_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t keepalive_flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Seconds between full updates of the agent data while the keepalive message does not change */
+static int agent_data_refresh = 0;
+
 /* Hash table for multigroups */
 OSHash *m_hash;
 
 /* Interval polling */
 static int poll_interval_time = 0;
 
+/* Size of the shared file chunks, UDP keeps smaller chunks to fit in a datagram */
+#define SHARED_CHUNK_UDP    900
+#define SHARED_CHUNK_TCP    OS_SIZE_8192
+
+/* Bandwidth for shared files among all the agents (bytes per second, 0 means no limit) */
+static size_t shared_rate = 0;
+static size_t shared_rate_bytes = 0;
+static time_t shared_rate_window = 0;
+static pthread_mutex_t shared_rate_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* This variable is used to prevent flooding when group files exceed the maximum size */
 static int reported_path_size_exceeded = 0;
 
@@ -248,7 +334,6 @@ void free_file_time(void *data) {
  */
 void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *wdb_sock)
 {
-    char msg_ack[OS_FLSIZE + 1] = "";
     char *msg = NULL;
     char *end = NULL;
     pending_data_t *data = NULL;
@@ -257,8 +342,11 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
     const char * manager_label = "#\"_manager_hostname\":";
     const char * node_label = "#\"_node_name\":";
     const char * version_label = "#\"_wazuh_version\":";
+    char *expanded = NULL;
     int is_startup = 0;
     int is_shutdown = 0;
+    int is_batch = 0;
+    int is_compact = 0;
     int agent_id = 0;
     int result = 0;
 
@@ -280,8 +368,20 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
         return;
     }
 
+    /* A compact keepalive stands for the last full one while the metadata does not change */
+    if (strncmp(r_msg, HC_KEEPALIVE, strlen(HC_KEEPALIVE)) == 0) {
+        if (expanded = expand_keepalive(key, r_msg + strlen(HC_KEEPALIVE)), !expanded) {
+            send_control_ack(key, 0, 0, 1);
+            rem_inc_recv_ctrl_keepalive(key->id);
+            return;
+        }
+
+        r_msg = expanded;
+    }
+
     /* Filter UTF-8 characters */
     char * clean = w_utf8_filter(r_msg, true);
+    os_free(expanded);
     r_msg = clean;
 
     if ((strncmp(r_msg, HC_STARTUP, strlen(HC_STARTUP)) == 0) || (strcmp(r_msg, HC_SHUTDOWN) == 0)) {
@@ -315,6 +415,9 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
                     os_free(clean);
                     return;
                 }
+                /* The agent can send several events in a single message */
+                is_batch = cJSON_IsTrue(cJSON_GetObjectItem(agent_info, "batch"));
+                is_compact = cJSON_IsTrue(cJSON_GetObjectItem(agent_info, "keepalive"));
                 cJSON_Delete(agent_info);
             }
             is_startup = 1;
@@ -343,25 +446,18 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
 
     if (is_shutdown == 0) {
         /* Reply to the agent except on shutdown message*/
-        snprintf(msg_ack, OS_FLSIZE, "%s%s", CONTROL_HEADER, HC_ACK);
-        if (send_msg(key->id, msg_ack, -1) >= 0) {
-            rem_inc_send_ack(key->id);
-        }
+        send_control_ack(key, is_batch, is_compact, 0);
     }
 
     w_mutex_lock(&lastmsg_mutex);
 
-    /* Check if there is a keep alive already for this agent */
-    if (data = OSHash_Get(pending_data, key->id), data && data->changed && data->message && msg && strcmp(data->message, msg) == 0) {
+    /* Check if there is a keep alive already for this agent.
+     * The metadata did not change, so only the keepalive is saved. */
+    if (data = OSHash_Get(pending_data, key->id), data && data->message && msg && strcmp(data->message, msg) == 0
+        && (data->changed || time(NULL) - data->updated < agent_data_refresh)) {
         w_mutex_unlock(&lastmsg_mutex);
 
-        agent_id = atoi(key->id);
-
-        result = wdb_update_agent_keepalive(agent_id, AGENT_CS_ACTIVE, logr.worker_node ? "syncreq" : "synced", wdb_sock);
-
-        if (OS_SUCCESS != result) {
-            mwarn("Unable to save last keepalive and set connection status as active for agent: %s", key->id);
-        }
+        push_keepalive(atoi(key->id));
     } else {
         if (!data) {
             os_calloc(1, sizeof(pending_data_t), data);
@@ -376,9 +472,12 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
         }
 
         if (is_startup) {
+            /* Refresh the agent data with its next keepalive */
+            data->updated = 0;
             w_mutex_unlock(&lastmsg_mutex);
 
             agent_id = atoi(key->id);
+            drop_keepalive(agent_id);
 
             result = wdb_update_agent_keepalive(agent_id, AGENT_CS_PENDING, logr.worker_node ? "syncreq" : "synced", wdb_sock);
 
@@ -389,6 +488,7 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
             w_mutex_unlock(&lastmsg_mutex);
 
             agent_id = atoi(key->id);
+            drop_keepalive(agent_id);
 
             result = wdb_update_agent_connection_status(agent_id, AGENT_CS_DISCONNECTED, logr.worker_node ? "syncreq" : "synced", wdb_sock, HC_SHUTDOWN_RECV);
 
@@ -429,6 +529,9 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
             memset(&data->merged_sum, 0, sizeof(os_md5));
 
             os_strdup(msg, data->message);
+            // The agent hashes the same UTF-8 filtered bytes for its compact keepalives
+            OS_MD5_Str(data->message, -1, data->message_sum);
+            data->keepalive_seq = 0;
 
             if (OS_SUCCESS == lookfor_agent_group(key->id, data->message, &data->group, wdb_sock)) {
                 group_t *aux = NULL;
@@ -511,6 +614,7 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
                 os_strdup("synced", agent_data->group_config_status);
             }
 
+            data->updated = time(NULL);
             w_mutex_unlock(&lastmsg_mutex);
 
             // Updating version and keepalive in global.db
@@ -527,6 +631,78 @@ void save_controlmsg(const keyentry * key, char *r_msg, size_t msg_length, int *
     os_free(clean);
 }
 
+STATIC void send_control_ack(const keyentry * key, int is_batch, int is_compact, int request_metadata)
+{
+    char msg_ack[OS_FLSIZE + 1] = "";
+    cJSON * ack_info = NULL;
+    char * ack_str = NULL;
+
+    if (is_batch || is_compact || request_metadata || key->flow_control) {
+        ack_info = cJSON_CreateObject();
+
+        if (is_batch) {
+            cJSON_AddTrueToObject(ack_info, "batch");
+        }
+
+        if (is_compact) {
+            cJSON_AddTrueToObject(ack_info, "keepalive");
+        }
+
+        if (request_metadata) {
+            cJSON_AddTrueToObject(ack_info, "metadata");
+        }
+
+        /* Usage of the message queue, so that the agent adapts its event rate */
+        if (key->flow_control) {
+            size_t queue_size = rem_get_tsize();
+            cJSON_AddNumberToObject(ack_info, "queue", queue_size ? rem_get_qsize() * 100 / queue_size : 0);
+        }
+
+        ack_str = cJSON_PrintUnformatted(ack_info);
+        cJSON_Delete(ack_info);
+    }
+
+    snprintf(msg_ack, OS_FLSIZE, "%s%s%s", CONTROL_HEADER, HC_ACK, ack_str ? ack_str : "");
+    os_free(ack_str);
+
+    if (send_msg(key->id, msg_ack, -1) >= 0) {
+        rem_inc_send_ack(key->id);
+    }
+}
+
+STATIC char * expand_keepalive(const keyentry * key, const char * payload)
+{
+    pending_data_t *data = NULL;
+    unsigned long seq = 0;
+    char sum[sizeof(os_md5)] = "";
+    char *message = NULL;
+
+    if (sscanf(payload, "%lu %32s", &seq, sum) != 2) {
+        mdebug1("Invalid compact keepalive from agent '%s'", key->id);
+        return NULL;
+    }
+
+    w_mutex_lock(&lastmsg_mutex);
+
+    if (data = OSHash_Get(pending_data, key->id), data && data->message && strcmp(data->message_sum, sum) == 0) {
+        if (seq <= data->keepalive_seq) {
+            mdebug2("Compact keepalive %lu from agent '%s' out of order", seq, key->id);
+        } else {
+            data->keepalive_seq = seq;
+        }
+
+        os_strdup(data->message, message);
+    }
+
+    w_mutex_unlock(&lastmsg_mutex);
+
+    if (!message) {
+        mdebug2("Unknown metadata in the keepalive of agent '%s', requesting it", key->id);
+    }
+
+    return message;
+}
+
 /* Assign a group to an agent without group */
 cJSON *assign_group_to_agent(const char *agent_id, const char *md5) {
     cJSON *result = NULL;
@@ -600,7 +776,7 @@ STATIC cJSON *assign_group_to_agent_worker(const char *agent_id, const char *md5
 }
 
 /* Generate merged file for groups */
-STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, char *sharedcfg_dir, bool create_merged, bool is_multigroup) {
+STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, file_stat *_merged_stat, char *sharedcfg_dir, bool create_merged, bool is_multigroup) {
     os_md5 md5sum;
     os_md5 md5sum_tmp;
     struct stat attrib;
@@ -759,12 +935,21 @@ STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, ch
         }
     }
 
-    if (OS_MD5_File(merged, md5sum, OS_TEXT) == 0) {
+    int merged_found = stat(merged, &attrib) == 0;
+
+    if (!create_merged && merged_found && (*_merged_sum)[0] && file_stat_equal(_merged_stat, &attrib)) {
+        // Same file the sum was computed from, do not read it again
+        ftime_add(_f_time, SHAREDCFG_FILENAME, attrib.st_mtime);
+    } else if (OS_MD5_File(merged, md5sum, OS_TEXT) == 0) {
         snprintf((*_merged_sum), sizeof((*_merged_sum)), "%s", md5sum);
 
-        if (stat(merged, &attrib) != 0) {
+        if (!merged_found) {
             merror("Unable to get entry attributes '%s'", merged);
+            memset(_merged_stat, 0, sizeof(file_stat));
         } else {
+            _merged_stat->inode = attrib.st_ino;
+            _merged_stat->size = attrib.st_size;
+            _merged_stat->m_time = attrib.st_mtime;
             ftime_add(_f_time, SHAREDCFG_FILENAME, attrib.st_mtime);
         }
     } else if (create_merged) {
@@ -773,7 +958,7 @@ STATIC void c_group(const char *group, OSHash **_f_time, os_md5 *_merged_sum, ch
 }
 
 /* Generate merged file for multigroups */
-STATIC void c_multi_group(char *multi_group, OSHash **_f_time, os_md5 *_merged_sum, char *hash_multigroup, bool create_merged) {
+STATIC void c_multi_group(char *multi_group, OSHash **_f_time, os_md5 *_merged_sum, file_stat *_merged_stat, char *hash_multigroup, bool create_merged) {
     DIR *dp;
     char *group;
     char *save_ptr = NULL;
@@ -821,7 +1006,7 @@ STATIC void c_multi_group(char *multi_group, OSHash **_f_time, os_md5 *_merged_s
         return;
     }
 
-    c_group(hash_multigroup, _f_time, _merged_sum, MULTIGROUPS_DIR, create_merged, true);
+    c_group(hash_multigroup, _f_time, _merged_sum, _merged_stat, MULTIGROUPS_DIR, create_merged, true);
 
     closedir(dp);
 
@@ -850,6 +1035,9 @@ STATIC void c_files(bool initial_scan)
     /* Delete residual multigroups */
     process_deleted_multi_groups(initial_scan);
 
+    /* The merged sums may have changed */
+    groups_by_sum_outdated = true;
+
     w_mutex_unlock(&files_mutex);
 
     if (!reported_path_size_exceeded) {
@@ -897,19 +1085,19 @@ STATIC void process_groups() {
                 merror("Couldn't add group '%s' to hash table 'groups'", entry->d_name);
             } else {
                 group->name = strdup(entry->d_name);
-                c_group(entry->d_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, !logr.nocmerged, false);
+                c_group(entry->d_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, !logr.nocmerged, false);
                 group->has_changed = true;
                 group->exists = true;
             }
         } else {
             OSHash *old_time = group->f_time;
             group->f_time = NULL;
-            c_group(entry->d_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, false, false);
+            c_group(entry->d_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, false, false);
             if (ftime_changed(old_time, group->f_time)) {
                 // Group has changed
                 if (!logr.nocmerged) {
                     OSHash_Clean(group->f_time, free_file_time);
-                    c_group(entry->d_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+                    c_group(entry->d_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
                 }
                 group->has_changed = true;
                 mdebug2("Group '%s' has changed.", group->name);
@@ -1011,25 +1199,25 @@ STATIC void process_multi_groups() {
                 merror("Couldn't add multigroup '%s' to hash table 'multi_groups'", key);
             } else {
                 multigroup->name = strdup(key);
-                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, data, !logr.nocmerged);
+                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, &multigroup->merged_stat, data, !logr.nocmerged);
                 multigroup->exists = true;
             }
         } else {
             if (group_changed(key)) {
                 // Multigroup needs to be updated
                 OSHash_Clean(multigroup->f_time, free_file_time);
-                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, data, !logr.nocmerged);
+                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, &multigroup->merged_stat, data, !logr.nocmerged);
                 mdebug2("Multigroup '%s' has changed.", multigroup->name);
 
             } else {
                 OSHash *old_time = multigroup->f_time;
                 multigroup->f_time = NULL;
-                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, data, false);
+                c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, &multigroup->merged_stat, data, false);
                 if (ftime_changed(old_time, multigroup->f_time)) {
                     // Multigroup was modified from outside
                     if (!logr.nocmerged) {
                         OSHash_Clean(multigroup->f_time, free_file_time);
-                        c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, data, true);
+                        c_multi_group(key, &multigroup->f_time, &multigroup->merged_sum, &multigroup->merged_stat, data, true);
                         mwarn("Multigroup '%s' was modified from outside, so it was regenerated.", multigroup->name);
                     } else {
                         mdebug2("Multigroup '%s' was modified from outside.", multigroup->name);
@@ -1343,46 +1531,66 @@ STATIC void ftime_add(OSHash **_f_time, const char *name, const time_t m_time) {
     }
 }
 
-STATIC group_t* find_group_from_sum(const char * md5, char group_name[OS_SIZE_65536]) {
+STATIC OSHash * index_groups_by_sum(OSHash * table, OSHash * index) {
     group_t *group;
     OSHashNode *my_node;
     unsigned int i;
 
-    my_node = OSHash_Begin(groups, &i);
+    if (index) {
+        OSHash_Free(index);
+    }
+
+    if (index = OSHash_Create(), !index) {
+        merror_exit("OSHash_Create() failed");
+    }
+
+    my_node = OSHash_Begin(table, &i);
 
     while (my_node) {
         group = my_node->data;
 
-        if (!strcmp(group->merged_sum, md5)) {
-            snprintf(group_name, OS_SIZE_65536, "%s", group->name);
-            return group;
+        // Groups sharing a sum keep the one found first, like a scan would
+        if (group->merged_sum[0]) {
+            OSHash_Add(index, group->merged_sum, group);
         }
 
-        my_node = OSHash_Next(groups, &i, my_node);
+        my_node = OSHash_Next(table, &i, my_node);
     }
 
-    return NULL;
+    return index;
 }
 
-STATIC group_t* find_multi_group_from_sum(const char * md5, char multigroup_name[OS_SIZE_65536]) {
-    group_t *multigroup;
-    OSHashNode *my_node;
-    unsigned int i;
+/* Rebuild the indexes if a scan ran since the last lookup. Needs files_mutex */
+static void update_groups_by_sum() {
+    if (groups_by_sum_outdated) {
+        groups_by_sum = index_groups_by_sum(groups, groups_by_sum);
+        multi_groups_by_sum = index_groups_by_sum(multi_groups, multi_groups_by_sum);
+        groups_by_sum_outdated = false;
+    }
+}
 
-    my_node = OSHash_Begin(multi_groups, &i);
+STATIC group_t* find_group_from_sum(const char * md5, char group_name[OS_SIZE_65536]) {
+    group_t *group;
 
-    while (my_node) {
-        multigroup = my_node->data;
+    update_groups_by_sum();
 
-        if (!strcmp(multigroup->merged_sum, md5)) {
-            snprintf(multigroup_name, OS_SIZE_65536, "%s", multigroup->name);
-            return multigroup;
-        }
+    if (group = OSHash_Get(groups_by_sum, md5), group) {
+        snprintf(group_name, OS_SIZE_65536, "%s", group->name);
+    }
 
-        my_node = OSHash_Next(multi_groups, &i, my_node);
+    return group;
+}
+
+STATIC group_t* find_multi_group_from_sum(const char * md5, char multigroup_name[OS_SIZE_65536]) {
+    group_t *multigroup;
+
+    update_groups_by_sum();
+
+    if (multigroup = OSHash_Get(multi_groups_by_sum, md5), multigroup) {
+        snprintf(multigroup_name, OS_SIZE_65536, "%s", multigroup->name);
     }
 
-    return NULL;
+    return multigroup;
 }
 
 STATIC bool ftime_changed(OSHash *old_time, OSHash *new_time) {
@@ -1428,6 +1636,10 @@ STATIC bool ftime_changed(OSHash *old_time, OSHash *new_time) {
     return false;
 }
 
+STATIC bool file_stat_equal(const file_stat *saved, const struct stat *attrib) {
+    return saved->inode == attrib->st_ino && saved->size == attrib->st_size && saved->m_time == attrib->st_mtime;
+}
+
 STATIC bool group_changed(const char *multi_group) {
     char **mgroups = NULL;
     unsigned int i;
@@ -1570,8 +1782,9 @@ static int send_file_toagent(const char *agent_id, const char *group, const char
 {
     int i = 0;
     size_t n = 0;
+    size_t chunk;
     char file[OS_SIZE_1024 + 1];
-    char buf[OS_SIZE_1024 + 1];
+    char buf[SHARED_CHUNK_TCP + 1];
     FILE *fp;
     os_sha256 multi_group_hash;
     int protocol = -1; // Agent client net protocol
@@ -1584,6 +1797,17 @@ static int send_file_toagent(const char *agent_id, const char *group, const char
         snprintf(file, OS_SIZE_1024, "%s/%s/%s", sharedcfg_dir, group, name);
     }
 
+    /* The following code is used to get the protocol that the client is using in order to answer accordingly */
+    key_lock_read();
+    protocol = w_get_agent_net_protocol_from_keystore(&keys, agent_id);
+    key_unlock();
+    if (protocol < 0) {
+        merror(AR_NOAGENT_ERROR, agent_id);
+        return OS_INVALID;
+    }
+
+    chunk = (protocol == REMOTED_NET_PROTOCOL_UDP) ? SHARED_CHUNK_UDP : SHARED_CHUNK_TCP;
+
     fp = fopen(file, "r");
     if (!fp) {
         mdebug1(FOPEN_ERROR, file, errno, strerror(errno));
@@ -1601,19 +1825,12 @@ static int send_file_toagent(const char *agent_id, const char *group, const char
         rem_inc_send_shared(agent_id);
     }
 
-    /* The following code is used to get the protocol that the client is using in order to answer accordingly */
-    key_lock_read();
-    protocol = w_get_agent_net_protocol_from_keystore(&keys, agent_id);
-    key_unlock();
-    if (protocol < 0) {
-        merror(AR_NOAGENT_ERROR, agent_id);
-        return OS_INVALID;
-    }
-
     /* Send the file contents */
-    while ((n = fread(buf, 1, 900, fp)) > 0) {
+    while ((n = fread(buf, 1, chunk, fp)) > 0) {
         buf[n] = '\0';
 
+        shared_rate_wait(n);
+
         if (send_msg(agent_id, buf, -1) < 0) {
             fclose(fp);
             return OS_INVALID;
@@ -1646,6 +1863,37 @@ static int send_file_toagent(const char *agent_id, const char *group, const char
     return OS_SUCCESS;
 }
 
+STATIC void shared_rate_wait(size_t size)
+{
+    struct timespec now;
+
+    if (shared_rate == 0) {
+        return;
+    }
+
+    /* Every second allows sending up to the bandwidth, the chunk that exceeds it waits for the next second */
+    while (1) {
+        gettime(&now);
+
+        w_mutex_lock(&shared_rate_mutex);
+
+        if (now.tv_sec != shared_rate_window) {
+            shared_rate_window = now.tv_sec;
+            shared_rate_bytes = 0;
+        }
+
+        if (shared_rate_bytes < shared_rate) {
+            shared_rate_bytes += size;
+            w_mutex_unlock(&shared_rate_mutex);
+            return;
+        }
+
+        w_mutex_unlock(&shared_rate_mutex);
+
+        w_time_delay((1000000000 - now.tv_nsec) / 1000000 + 1);
+    }
+}
+
 /* Wait for new messages to read */
 void *wait_for_msgs(__attribute__((unused)) void *none)
 {
@@ -1709,6 +1957,76 @@ void *wait_for_msgs(__attribute__((unused)) void *none)
     return NULL;
 }
 
+STATIC void push_keepalive(int agent_id)
+{
+    w_mutex_lock(&keepalive_mutex);
+
+    if (keepalive_count == keepalive_size) {
+        keepalive_size = keepalive_size ? keepalive_size * 2 : 64;
+        os_realloc(keepalive_ids, keepalive_size * sizeof(int), keepalive_ids);
+    }
+
+    keepalive_ids[keepalive_count++] = agent_id;
+
+    w_mutex_unlock(&keepalive_mutex);
+}
+
+STATIC void drop_keepalive(int agent_id)
+{
+    /* Wait for the batch being saved, if any */
+    w_mutex_lock(&keepalive_flush_mutex);
+    w_mutex_lock(&keepalive_mutex);
+
+    for (size_t i = 0; i < keepalive_count;) {
+        if (keepalive_ids[i] == agent_id) {
+            keepalive_ids[i] = keepalive_ids[--keepalive_count];
+        } else {
+            i++;
+        }
+    }
+
+    w_mutex_unlock(&keepalive_mutex);
+    w_mutex_unlock(&keepalive_flush_mutex);
+}
+
+/* Save the queued keepalives */
+void *save_keepalives(__attribute__((unused)) void *none)
+{
+    int interval = getDefine_Int("remoted", "keepalive_flush_interval", 1, 60);
+    int wdb_sock = -1;
+    int *ids;
+    size_t count;
+
+    mdebug1("Keepalive saver thread started.");
+
+    while (1) {
+        sleep(interval);
+
+        w_mutex_lock(&keepalive_flush_mutex);
+
+        w_mutex_lock(&keepalive_mutex);
+        ids = keepalive_ids;
+        count = keepalive_count;
+        keepalive_ids = NULL;
+        keepalive_count = 0;
+        keepalive_size = 0;
+        w_mutex_unlock(&keepalive_mutex);
+
+        if (count > 0) {
+            mdebug2("Saving the keepalive of %zu agents.", count);
+
+            if (OS_SUCCESS != wdb_update_agents_keepalive(ids, count, AGENT_CS_ACTIVE, logr.worker_node ? "syncreq" : "synced", &wdb_sock)) {
+                mwarn("Unable to save last keepalive and set connection status as active for %zu agents.", count);
+            }
+        }
+
+        w_mutex_unlock(&keepalive_flush_mutex);
+        os_free(ids);
+    }
+
+    return NULL;
+}
+
 /* Update shared files */
 void *update_shared_files(__attribute__((unused)) void *none)
 {
@@ -1760,6 +2078,8 @@ void manager_init()
     multi_groups = OSHash_Create();
 
     disk_storage = getDefine_Int("remoted", "disk_storage", 0, 1);
+    agent_data_refresh = getDefine_Int("remoted", "agent_data_refresh", 0, 3600);
+    shared_rate = (size_t)getDefine_Int("remoted", "shared_rate", 0, 1048576) * 1024;
 
     /* Run initial groups and multigroups scan */
     c_files(true);
@@ -119,8 +119,12 @@ int nb_recv(netbuffer_t * buffer, int sock) {
 
         case 1:
             // Shrink memory to fit the current buffer or the receive chunk.
-            sockbuf->data_size = sockbuf->data_len > receive_chunk ? sockbuf->data_len : receive_chunk;
-            os_realloc(sockbuf->data, sockbuf->data_size, sockbuf->data);
+            data_ext = sockbuf->data_len > receive_chunk ? sockbuf->data_len : receive_chunk;
+
+            if (data_ext != sockbuf->data_size) {
+                sockbuf->data_size = data_ext;
+                os_realloc(sockbuf->data, sockbuf->data_size, sockbuf->data);
+            }
             break;
 
         default:
@@ -143,23 +147,34 @@ end:
 
 int nb_send(netbuffer_t * buffer, int socket) {
     ssize_t sent_bytes = 0;
+    ssize_t total_bytes = 0;
+    ssize_t peeked_bytes = 0;
+    size_t queued_bytes = 0;
 
     char data[send_chunk];
-    memset(data, 0, send_chunk);
 
     w_mutex_lock(&mutex);
 
     if (buffer->buffers[socket].bqueue) {
 
-        ssize_t peeked_bytes = bqueue_peek(buffer->buffers[socket].bqueue, data, send_chunk, BQUEUE_NOFLAG);
-        if (peeked_bytes > 0) {
+        // Send until the queue gets empty or the socket gets full, so that a single write event flushes all the queued messages
+        while (peeked_bytes = bqueue_peek(buffer->buffers[socket].bqueue, data, send_chunk, BQUEUE_NOFLAG), peeked_bytes > 0) {
             // Asynchronous sending
             sent_bytes = send(socket, (const void *)data, peeked_bytes, MSG_DONTWAIT);
-        }
 
-        if (sent_bytes > 0) {
+            if (sent_bytes <= 0) {
+                break;
+            }
+
             bqueue_drop(buffer->buffers[socket].bqueue, sent_bytes);
-        } else if (sent_bytes < 0) {
+            total_bytes += sent_bytes;
+
+            if (queued_bytes = bqueue_used(buffer->buffers[socket].bqueue), queued_bytes == 0 || sent_bytes < peeked_bytes) {
+                break;
+            }
+        }
+
+        if (sent_bytes < 0) {
             switch (errno) {
             case EAGAIN:
     #if EAGAIN != EWOULDBLOCK
@@ -171,14 +186,18 @@ int nb_send(netbuffer_t * buffer, int socket) {
             }
         }
 
-        if (!peeked_bytes || bqueue_used(buffer->buffers[socket].bqueue) == 0) {
+        if (sent_bytes <= 0 && peeked_bytes > 0) {
+            queued_bytes = bqueue_used(buffer->buffers[socket].bqueue);
+        }
+
+        if (!peeked_bytes || queued_bytes == 0) {
             wnotify_modify(notify, socket, WO_READ);
         }
     }
 
     w_mutex_unlock(&mutex);
 
-    return sent_bytes;
+    return total_bytes > 0 ? total_bytes : sent_bytes;
 }
 
 int nb_queue(netbuffer_t * buffer, int socket, char * crypt_msg, ssize_t msg_size, char * agent_id) {
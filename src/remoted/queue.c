@@ -34,6 +34,7 @@ int rem_msgpush(const char * buffer, unsigned long size, struct sockaddr_storage
     message->size = size;
     memcpy(&message->addr, addr, sizeof(struct sockaddr_storage));
     message->sock = sock;
+    message->trace_time = w_latency_sample(latency_sample) ? w_latency_now() : 0;
 
     w_mutex_lock(&mutex);
 
@@ -93,7 +93,29 @@ void HandleRemote(int uid)
     /* If UDP is enabled then bind the UDP socket */
     if (logr.proto[position] & REMOTED_NET_PROTOCOL_UDP) {
         /* Using UDP. Fast, unreliable... perfect */
-        logr.udp_sock = OS_Bindportudp(logr.port[position], logr.lip[position], logr.ipv6[position]);
+        logr.udp_listeners = logr.conn[position] == SECURE_CONN ? getDefine_Int("remoted", "udp_listeners", 1, 16) : 1;
+
+        if (logr.udp_listeners > 1) {
+            /* Every listener thread gets its own socket, the system spreads the agents among them */
+            os_calloc(logr.udp_listeners - 1, sizeof(int), logr.udp_socks);
+
+            if (logr.udp_sock = OS_BindportudpReuse(logr.port[position], logr.lip[position], logr.ipv6[position]), logr.udp_sock < 0) {
+                mwarn("Could not share the UDP port %d among %d listeners: %s (%d). Using a single listener.",
+                      logr.port[position], logr.udp_listeners, strerror(errno), errno);
+                logr.udp_listeners = 1;
+                os_free(logr.udp_socks);
+            }
+
+            for (int i = 0; i < logr.udp_listeners - 1; i++) {
+                if (logr.udp_socks[i] = OS_BindportudpReuse(logr.port[position], logr.lip[position], logr.ipv6[position]), logr.udp_socks[i] < 0) {
+                    merror_exit(BIND_ERROR, logr.port[position], errno, strerror(errno));
+                }
+            }
+        }
+
+        if (logr.udp_listeners == 1) {
+            logr.udp_sock = OS_Bindportudp(logr.port[position], logr.lip[position], logr.ipv6[position]);
+        }
 
         if (logr.udp_sock < 0) {
             merror_exit(BIND_ERROR, logr.port[position], errno, strerror(errno));
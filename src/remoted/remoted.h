@@ -33,6 +33,9 @@ typedef struct pending_data_t {
     char *group;
     os_md5 merged_sum;
     int changed;
+    time_t updated;     ///< Last time the agent data was updated in global.db
+    os_md5 message_sum; ///< Hash of the message, sent in the compact keepalives
+    unsigned long keepalive_seq; ///< Sequence number of the last compact keepalive
 } pending_data_t;
 
 typedef struct message_t {
@@ -41,6 +44,7 @@ typedef struct message_t {
     struct sockaddr_storage addr;
     int sock;
     size_t counter;
+    uint64_t trace_time;    ///< Reception time of a traced message, 0 if not traced
 } message_t;
 
 /* Network buffer structure */
@@ -58,6 +62,22 @@ typedef struct netbuffer_t {
     sockbuffer_t * buffers;
 } netbuffer_t;
 
+/**
+ * @brief Source of the last datagram and its allow/deny verdict.
+ *
+ * Network devices send many messages in a row, so the source string and the
+ * lists are only evaluated again when the address changes.
+ */
+typedef struct syslog_source {
+    sa_family_t family;
+    union {
+        struct in_addr ipv4;
+        struct in6_addr ipv6;
+    } addr;
+    char ip[IPSIZE + 1];
+    int denied;
+} syslog_source;
+
 /** Function prototypes **/
 
 /* Read remoted config */
@@ -93,6 +113,9 @@ void *wait_for_msgs(void *none);
 /* Update shared files */
 void *update_shared_files(void *none);
 
+/* Save the keepalives of the agents in batches */
+void *save_keepalives(void *none);
+
 /* Save control messages */
 void save_controlmsg(const keyentry * key, char *msg, size_t msg_length, int *wdb_sock);
 
@@ -203,6 +226,7 @@ extern int guess_agent_group;
 extern unsigned receive_chunk;
 extern unsigned send_chunk;
 extern int buffer_relax;
+extern unsigned latency_sample;
 extern unsigned send_buffer_size;
 extern int send_timeout_to_retry;
 extern int tcp_keepidle;
@@ -49,11 +49,45 @@ void * rem_keyupdate_main(__attribute__((unused)) void * args);
 /* Handle each message received */
 STATIC void HandleSecureMessage(const message_t *message, int *wdb_sock);
 
+/**
+ * @brief Forward an event to analysisd, reconnecting to the queue if needed
+ * @param msg Event
+ * @param srcmsg Location of the event
+ * @param agent_id ID of the agent that sent the event
+ */
+STATIC void rem_forward_event(const char *msg, const char *srcmsg, const char *agent_id);
+
+/**
+ * @brief Get the analysisd instance that decodes the events of an agent
+ *
+ * @param agent_id Agent ID.
+ * @return Instance number, 0 for the main analysisd.
+ */
+STATIC int rem_analysisd_instance(const char *agent_id);
+
+/**
+ * @brief Forward every event of a batch to analysisd
+ *
+ * The batch is a sequence of frames "<length>\n<event>". The parsing stops at
+ * the first malformed frame.
+ *
+ * @param batch Batch content, after the header. The frames are split in place.
+ * @param srcmsg Location of the events
+ * @param agent_id ID of the agent that sent the batch
+ */
+STATIC void rem_forward_batch(char *batch, const char *srcmsg, const char *agent_id);
+
 // Close and remove socket from keystore
 int _close_sock(keystore * keys, int sock);
 
 STATIC void * close_fp_main(void * args);
 
+// Rids flusher thread
+STATIC void * rids_flush_main(void * args);
+
+// UDP listener thread
+STATIC void * rem_udp_listener_main(void * args);
+
 /* Status of key-request feature */
 static char key_request_available = 0;
 
@@ -105,6 +139,9 @@ void HandleSecure()
     /* Create shared file updating thread */
     w_create_thread(update_shared_files, NULL);
 
+    /* Create keepalive saver thread */
+    w_create_thread(save_keepalives, NULL);
+
     /* Create Active Response forwarder thread */
     w_create_thread(AR_Forward, NULL);
 
@@ -160,6 +197,26 @@ void HandleSecure()
         merror_exit(QUEUE_FATAL, DEFAULTQUEUE);
     }
 
+    /* Connect to the queues of the additional analysisd instances */
+    logr.analysisd_instances = getDefine_Int("remoted", "analysisd_instances", 1, ANALYSISD_INSTANCES_MAX);
+
+    if (logr.analysisd_instances > 1) {
+        char path[PATH_MAX];
+
+        os_calloc(logr.analysisd_instances, sizeof(int), logr.m_queues);
+        logr.m_queues[0] = -1;
+
+        for (int i = 1; i < logr.analysisd_instances; i++) {
+            snprintf(path, sizeof(path), ANALYSISD_INSTANCE_QUEUE, i);
+
+            if ((logr.m_queues[i] = StartMQ(path, WRITE, INFINITE_OPENQ_ATTEMPTS)) < 0) {
+                merror_exit(QUEUE_FATAL, path);
+            }
+        }
+
+        minfo("Forwarding the agent events to %d analysisd instances.", logr.analysisd_instances);
+    }
+
     /* Read authentication keys */
     minfo(ENC_READ);
 
@@ -175,6 +232,9 @@ void HandleSecure()
     // fp closer thread
     w_create_thread(close_fp_main, &keys);
 
+    // Rids flusher thread
+    w_create_thread(rids_flush_main, &keys);
+
     /* Set up peer size */
     logr.peer_size = sizeof(peer_info);
 
@@ -195,6 +255,15 @@ void HandleSecure()
         if (wnotify_add(notify, logr.udp_sock, WO_READ) < 0) {
             merror_exit("wnotify_add(%d): %s (%d)", logr.udp_sock, strerror(errno), errno);
         }
+
+        /* The rest of the UDP sockets are read by their own threads */
+        if (logr.udp_listeners > 1) {
+            mdebug2("Creating %d UDP listener threads.", logr.udp_listeners - 1);
+
+            for (int i = 0; i < logr.udp_listeners - 1; i++) {
+                w_create_thread(rem_udp_listener_main, &logr.udp_socks[i]);
+            }
+        }
     }
 
     while (1) {
@@ -281,6 +350,33 @@ STATIC void handle_incoming_data_from_udp_socket(struct sockaddr_storage * peer_
     }
 }
 
+STATIC void * rem_udp_listener_main(void * args)
+{
+    const int sock = *(int *)args;
+    char buffer[OS_MAXSTR + 1];
+    struct sockaddr_storage peer_info;
+    socklen_t peer_size;
+
+    mdebug1("UDP listener thread started on socket [%d].", sock);
+
+    while (1) {
+        peer_size = sizeof(peer_info);
+
+        int recv_b = recvfrom(sock, buffer, OS_MAXSTR, 0, (struct sockaddr *) &peer_info, &peer_size);
+
+        if (recv_b > 0) {
+            buffer[recv_b] = '\0';
+            rem_msgpush(buffer, recv_b, &peer_info, USING_UDP_NO_CLIENT_SOCKET);
+            rem_add_recv((unsigned long) recv_b);
+        } else if (recv_b < 0 && errno != EINTR) {
+            merror("Receiving from UDP socket [%d]: %s (%d)", sock, strerror(errno), errno);
+            sleep(1);
+        }
+    }
+
+    return NULL;
+}
+
 STATIC void handle_incoming_data_from_tcp_socket(int sock_client)
 {
     int recv_b = nb_recv(&netbuffer_recv, sock_client);
@@ -352,7 +448,11 @@ void * rem_handler_main(__attribute__((unused)) void * args) {
 
     while (1) {
         message = rem_msgpop();
+        uint64_t trace_time = rem_add_queued_latency(message->trace_time);
+        W_PROBE2(message__start, message->sock, message->size);
         HandleSecureMessage(message, &wdb_sock);
+        W_PROBE(message__done);
+        rem_add_handled_latency(trace_time);
         rem_msgfree(message);
     }
 
@@ -375,6 +475,26 @@ void * rem_keyupdate_main(__attribute__((unused)) void * args) {
     }
 }
 
+// Rids flusher thread
+STATIC void * rids_flush_main(void * args) {
+    keystore * keys = (keystore *)args;
+    int seconds;
+
+    mdebug1("Rids flusher thread started.");
+    seconds = getDefine_Int("remoted", "rids_flush_interval", 1, 60);
+
+    while (1) {
+        sleep(seconds);
+        key_lock_read();
+        OS_FlushCounters(keys);
+        key_unlock();
+    #ifdef WAZUH_UNIT_TESTING
+        break;
+    #endif
+    }
+    return NULL;
+}
+
 // Closer rids thread
 STATIC void * close_fp_main(void * args) {
     keystore * keys = (keystore *)args;
@@ -601,7 +721,11 @@ STATIC void HandleSecureMessage(const message_t *message, int *wdb_sock) {
     }
 
     /* Decrypt the message */
-    if (r = ReadSecMSG(&keys, tmp_msg, cleartext_msg, agentid, recv_b - 1, &msg_length, srcip, &tmp_msg), r != KS_VALID) {
+    W_PROBE2(decrypt__start, agentid, recv_b);
+    r = ReadSecMSG(&keys, tmp_msg, cleartext_msg, agentid, recv_b - 1, &msg_length, srcip, &tmp_msg);
+    W_PROBE2(decrypt__done, agentid, r);
+
+    if (r != KS_VALID) {
         /* If duplicated, a warning was already generated */
         key_unlock();
 
@@ -622,18 +746,32 @@ STATIC void HandleSecureMessage(const message_t *message, int *wdb_sock) {
         return;
     }
 
-    /* Check if it is a control message */
-    if (IsValidHeader(tmp_msg)) {
+    /* Check if it is a batch of events or a control message */
+    const bool is_batch = strncmp(tmp_msg, CONTROL_HEADER HC_BATCH, strlen(CONTROL_HEADER HC_BATCH)) == 0;
+
+    if (!is_batch && IsValidHeader(tmp_msg)) {
 
         /* let through new and shutdown messages */
         if (message->sock == USING_UDP_NO_CLIENT_SOCKET || message->counter > rem_getCounter(message->sock) || (strncmp(tmp_msg, HC_SHUTDOWN, strlen(HC_SHUTDOWN)) == 0)) {
             /* We need to save the peerinfo if it is a control msg */
+            int flow_control = -1;
+
+            /* The agent tells on startup whether it takes the queue usage in the acks */
+            if (strncmp(tmp_msg, HC_STARTUP, strlen(HC_STARTUP)) == 0) {
+                cJSON * agent_info = cJSON_Parse(strchr(tmp_msg, '{'));
+                flow_control = cJSON_IsTrue(cJSON_GetObjectItem(agent_info, "flow"));
+                cJSON_Delete(agent_info);
+            }
 
             w_mutex_lock(&keys.keyentries[agentid]->mutex);
             keys.keyentries[agentid]->net_protocol = protocol;
             keys.keyentries[agentid]->rcvd = time(0);
             memcpy(&keys.keyentries[agentid]->peer_info, &message->addr, logr.peer_size);
 
+            if (flow_control >= 0) {
+                keys.keyentries[agentid]->flow_control = flow_control;
+            }
+
             keyentry * key = OS_DupKeyEntry(keys.keyentries[agentid]);
 
             if (protocol == REMOTED_NET_PROTOCOL_TCP) {
@@ -687,28 +825,74 @@ STATIC void HandleSecureMessage(const message_t *message, int *wdb_sock) {
 
     key_unlock();
 
+    if (is_batch) {
+        rem_forward_batch(tmp_msg + strlen(CONTROL_HEADER HC_BATCH), srcmsg, agentid_str);
+    } else {
+        rem_forward_event(tmp_msg, srcmsg, agentid_str);
+    }
+
+    os_free(agentid_str);
+}
+
+STATIC int rem_analysisd_instance(const char *agent_id) {
+    // Agent IDs are sequential, so their remainder spreads the agents evenly
+    return logr.analysisd_instances > 1 ? (int)(strtoul(agent_id, NULL, 10) % logr.analysisd_instances) : 0;
+}
+
+STATIC void rem_forward_event(const char *msg, const char *srcmsg, const char *agent_id) {
+    const int instance = rem_analysisd_instance(agent_id);
+    int * queue = instance ? &logr.m_queues[instance] : &logr.m_queue;
+    char path[PATH_MAX];
+
+    if (instance) {
+        snprintf(path, sizeof(path), ANALYSISD_INSTANCE_QUEUE, instance);
+    } else {
+        strcpy(path, DEFAULTQUEUE);
+    }
+
     /* If we can't send the message, try to connect to the
      * socket again. If it not exit.
      */
-    if (SendMSG(logr.m_queue, tmp_msg, srcmsg, SECURE_MQ) < 0) {
-        merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
+    if (SendMSG(*queue, msg, srcmsg, SECURE_MQ) < 0) {
+        merror(QUEUE_ERROR, path, strerror(errno));
 
         // Try to reconnect infinitely
-        logr.m_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS);
+        *queue = StartMQ(path, WRITE, INFINITE_OPENQ_ATTEMPTS);
 
-        minfo("Successfully reconnected to '%s'", DEFAULTQUEUE);
+        minfo("Successfully reconnected to '%s'", path);
 
-        if (SendMSG(logr.m_queue, tmp_msg, srcmsg, SECURE_MQ) < 0) {
+        if (SendMSG(*queue, msg, srcmsg, SECURE_MQ) < 0) {
             // Something went wrong sending a message after an immediate reconnection...
-            merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
+            merror(QUEUE_ERROR, path, strerror(errno));
         } else {
-            rem_inc_recv_evt(agentid_str);
+            rem_inc_recv_evt(agent_id);
         }
     } else {
-        rem_inc_recv_evt(agentid_str);
+        rem_inc_recv_evt(agent_id);
     }
+}
 
-    os_free(agentid_str);
+STATIC void rem_forward_batch(char *batch, const char *srcmsg, const char *agent_id) {
+    char *end = batch + strlen(batch);
+    char *event;
+    char next;
+    unsigned long length;
+
+    while (batch < end) {
+        if (!isdigit((int)*batch) || (length = strtoul(batch, &event, 10), *event != '\n')
+            || length > (unsigned long)(end - ++event)) {
+            mwarn("Invalid batch of events from agent '%s'.", agent_id);
+            return;
+        }
+
+        /* Terminate the event, keeping the first byte of the next frame */
+        next = event[length];
+        event[length] = '\0';
+        rem_forward_event(event, srcmsg, agent_id);
+        event[length] = next;
+
+        batch = event + length;
+    }
 }
 
 // Close and remove socket from keystore
@@ -42,15 +42,25 @@ void key_unlock()
 /* Check for key updates */
 int check_keyupdate()
 {
+    keystore *new_keys;
+
     /* Check key for updates */
     if (!OS_CheckUpdateKeys(&keys)) {
         return (0);
     }
 
     minfo(ENCFILE_CHANGED);
+
+    /* Parse the file and open the counters while the current keys keep serving the agents */
+    new_keys = OS_LoadKeys(&keys);
+
     key_lock_write();
-    OS_UpdateKeys(&keys);
+    OS_SwapKeys(&keys, new_keys);
     key_unlock();
+
+    /* Now new_keys holds the previous keystore */
+    OS_FreeKeys(new_keys);
+    os_free(new_keys);
     return 1;
 }
 
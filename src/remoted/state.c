@@ -26,6 +26,8 @@ static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t agents_state_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int rem_write_state();
 static char *refresh_time;
+static w_latency_t queued_latency = W_LATENCY_INITIALIZER;
+static w_latency_t handled_latency = W_LATENCY_INITIALIZER;
 
 extern OSHash *remoted_agents_state;
 
@@ -601,9 +603,26 @@ cJSON* rem_create_state_json() {
 
     cJSON_AddNumberToObject(_metrics, "tcp_sessions", state_cpy.tcp_sessions);
 
+    /* Latency of the sampled messages, if enabled */
+    if (latency_sample) {
+        cJSON *_latency = cJSON_CreateObject();
+        cJSON_AddItemToObject(_metrics, "latency", _latency);
+
+        cJSON_AddItemToObject(_latency, "queued", w_latency_to_json(&queued_latency));
+        cJSON_AddItemToObject(_latency, "handled", w_latency_to_json(&handled_latency));
+    }
+
     return rem_state_json;
 }
 
+uint64_t rem_add_queued_latency(uint64_t start) {
+    return w_latency_add(&queued_latency, start);
+}
+
+void rem_add_handled_latency(uint64_t start) {
+    w_latency_add(&handled_latency, start);
+}
+
 cJSON* rem_create_agents_state_json(int* agents_ids) {
     remoted_agent_state_t * agent_state;
 
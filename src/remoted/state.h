@@ -193,6 +193,19 @@ void rem_inc_send_discarded(const char *agent_id);
  */
 void rem_inc_keys_reload();
 
+/**
+ * @brief Add the time a traced message waited in the received queue
+ * @param start Reception time of the message, 0 if not traced
+ * @return Current time, to measure the handling. 0 if not traced
+ */
+uint64_t rem_add_queued_latency(uint64_t start);
+
+/**
+ * @brief Add the time taken to handle a traced message
+ * @param start Time the message was dequeued, 0 if not traced
+ */
+void rem_add_handled_latency(uint64_t start);
+
 /**
  * @brief Create a JSON object with all the remoted state information
  * @return JSON object
@@ -12,9 +12,37 @@
 #include "os_net/os_net.h"
 #include "remoted.h"
 
+#ifdef WAZUH_UNIT_TESTING
+// Remove static qualifier when unit testing
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/* Number of datagrams read by each recvmmsg() call */
+#define SYSLOG_RECV_BATCH 64
+
 /* Prototypes */
 static int OS_IPNotAllowed(const char *srcip);
 
+/**
+ * @brief Set the source of a datagram, reusing the previous one if the address didn't change.
+ *
+ * @param peer Peer address returned by the socket.
+ * @param source Source of the previous datagram, updated with the new one.
+ * @return 0 on success, -1 if the address family is not supported.
+ */
+STATIC int syslog_set_source(const struct sockaddr_storage *peer, syslog_source *source);
+
+/**
+ * @brief Forward a datagram to analysisd.
+ *
+ * @param buffer Datagram, with room for the terminating null byte.
+ * @param recv_b Datagram length.
+ * @param source Source of the datagram.
+ */
+STATIC void syslog_dispatch(char *buffer, ssize_t recv_b, const syslog_source *source);
+
 
 /* Check if an IP is not allowed */
 static int OS_IPNotAllowed(const char *srcip)
@@ -34,22 +62,110 @@ static int OS_IPNotAllowed(const char *srcip)
     return (1);
 }
 
+STATIC int syslog_set_source(const struct sockaddr_storage *peer, syslog_source *source)
+{
+    switch (peer->ss_family) {
+    case AF_INET:
+        if (source->family == AF_INET && !memcmp(&source->addr.ipv4, &((struct sockaddr_in *)peer)->sin_addr, sizeof(struct in_addr))) {
+            return 0;
+        }
+        source->addr.ipv4 = ((struct sockaddr_in *)peer)->sin_addr;
+        get_ipv4_string(source->addr.ipv4, source->ip, IPSIZE);
+        break;
+    case AF_INET6:
+        if (source->family == AF_INET6 && !memcmp(&source->addr.ipv6, &((struct sockaddr_in6 *)peer)->sin6_addr, sizeof(struct in6_addr))) {
+            return 0;
+        }
+        source->addr.ipv6 = ((struct sockaddr_in6 *)peer)->sin6_addr;
+        get_ipv6_string(source->addr.ipv6, source->ip, IPSIZE);
+        break;
+    default:
+        return -1;
+    }
+
+    source->family = peer->ss_family;
+    source->denied = OS_IPNotAllowed(source->ip);
+
+    return 0;
+}
+
+STATIC void syslog_dispatch(char *buffer, ssize_t recv_b, const syslog_source *source)
+{
+    char *buffer_pt = NULL;
+
+    /* Null-terminate the message */
+    buffer[recv_b] = '\0';
+
+    /* Remove newline */
+    if (buffer[recv_b - 1] == '\n') {
+        buffer[recv_b - 1] = '\0';
+    }
+
+    /* Remove syslog header */
+    if (buffer[0] == '<') {
+        buffer_pt = strchr(buffer + 1, '>');
+        if (buffer_pt) {
+            buffer_pt++;
+        } else {
+            buffer_pt = buffer;
+        }
+    } else {
+        buffer_pt = buffer;
+    }
+
+    /* Check if IP is allowed here */
+    if (source->denied) {
+        mwarn(DENYIP_WARN, source->ip);
+        return;
+    }
+
+    if (SendMSG(logr.m_queue, buffer_pt, source->ip, SYSLOG_MQ) < 0) {
+        merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
+
+        // Try to reconnect infinitely
+        logr.m_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS);
+
+        minfo("Successfully reconnected to '%s'", DEFAULTQUEUE);
+
+        if (SendMSG(logr.m_queue, buffer_pt, source->ip, SYSLOG_MQ) < 0) {
+            // Something went wrong sending a message after an immediate reconnection...
+            merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
+        }
+    }
+}
+
 /* Handle syslog connections */
 void HandleSyslog()
 {
+    syslog_source source = { .family = AF_UNSPEC };
+#ifdef __linux__
+    struct mmsghdr msgs[SYSLOG_RECV_BATCH];
+    struct iovec iovecs[SYSLOG_RECV_BATCH];
+    struct sockaddr_storage peers[SYSLOG_RECV_BATCH];
+    char *buffers;
+    int received;
+    int i;
+
+    os_calloc(SYSLOG_RECV_BATCH, OS_MAXSTR + 2, buffers);
+    memset(msgs, 0, sizeof(msgs));
+
+    for (i = 0; i < SYSLOG_RECV_BATCH; i++) {
+        iovecs[i].iov_base = buffers + i * (OS_MAXSTR + 2);
+        iovecs[i].iov_len = OS_MAXSTR;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &peers[i];
+    }
+#else
     char buffer[OS_MAXSTR + 2];
-    char srcip[IPSIZE + 1];
-    char *buffer_pt = NULL;
     ssize_t recv_b;
     struct sockaddr_storage _nc;
     socklen_t _ncl;
 
-    /* Set peer size */
-    _ncl = sizeof(_nc);
-
     /* Initialize some variables */
     memset(buffer, '\0', OS_MAXSTR + 2);
     memset(&_nc, 0, sizeof(_nc));
+#endif
 
     /* Connect to the message queue infinitely */
     if ((logr.m_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS)) < 0) {
@@ -58,64 +174,35 @@ void HandleSyslog()
 
     /* Infinite loop */
     while (1) {
-        /* Receive message */
-        recv_b = recvfrom(logr.udp_sock, buffer, OS_MAXSTR, 0, (struct sockaddr *)&_nc, &_ncl);
-
-        /* Nothing received */
-        if (recv_b <= 0) {
-            continue;
+#ifdef __linux__
+        for (i = 0; i < SYSLOG_RECV_BATCH; i++) {
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
         }
 
-        /* Null-terminate the message */
-        buffer[recv_b] = '\0';
+        /* Block until a datagram arrives and take the ones already queued with it */
+        received = recvmmsg(logr.udp_sock, msgs, SYSLOG_RECV_BATCH, MSG_WAITFORONE, NULL);
 
-        /* Remove newline */
-        if (buffer[recv_b - 1] == '\n') {
-            buffer[recv_b - 1] = '\0';
-        }
+        for (i = 0; i < received; i++) {
+            /* Nothing received */
+            if (msgs[i].msg_len == 0 || syslog_set_source(&peers[i], &source) < 0) {
+                continue;
+            }
 
-        /* Set the source IP */
-        switch (_nc.ss_family) {
-        case AF_INET:
-            get_ipv4_string(((struct sockaddr_in *)&_nc)->sin_addr, srcip, IPSIZE);
-            break;
-        case AF_INET6:
-            get_ipv6_string(((struct sockaddr_in6 *)&_nc)->sin6_addr, srcip, IPSIZE);
-            break;
-        default:
-            continue;
+            syslog_dispatch(iovecs[i].iov_base, msgs[i].msg_len, &source);
         }
+#else
+        /* Set peer size */
+        _ncl = sizeof(_nc);
 
-        /* Remove syslog header */
-        if (buffer[0] == '<') {
-            buffer_pt = strchr(buffer + 1, '>');
-            if (buffer_pt) {
-                buffer_pt++;
-            } else {
-                buffer_pt = buffer;
-            }
-        } else {
-            buffer_pt = buffer;
-        }
+        /* Receive message */
+        recv_b = recvfrom(logr.udp_sock, buffer, OS_MAXSTR, 0, (struct sockaddr *)&_nc, &_ncl);
 
-        /* Check if IP is allowed here */
-        if (OS_IPNotAllowed(srcip)) {
-            mwarn(DENYIP_WARN, srcip);
+        /* Nothing received */
+        if (recv_b <= 0 || syslog_set_source(&_nc, &source) < 0) {
             continue;
         }
 
-        if (SendMSG(logr.m_queue, buffer_pt, srcip, SYSLOG_MQ) < 0) {
-            merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
-
-            // Try to reconnect infinitely
-            logr.m_queue = StartMQ(DEFAULTQUEUE, WRITE, INFINITE_OPENQ_ATTEMPTS);
-
-            minfo("Successfully reconnected to '%s'", DEFAULTQUEUE);
-
-            if (SendMSG(logr.m_queue, buffer_pt, srcip, SYSLOG_MQ) < 0) {
-                // Something went wrong sending a message after an immediate reconnection...
-                merror(QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
-            }
-        }
+        syslog_dispatch(buffer, recv_b, &source);
+#endif
     }
 }
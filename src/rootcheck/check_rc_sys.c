@@ -11,9 +11,20 @@
 #include "shared.h"
 #include "rootcheck.h"
 
+/* Metadata of a file whose contents matched its size on the last scan */
+typedef struct _rk_sys_read {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    time_t mtime;
+    time_t ctime;
+} rk_sys_read;
+
 /* Prototypes */
 static int read_sys_file(const char *file_name, int do_read);
 static int read_sys_dir(const char *dir_name, int do_read);
+static int read_sys_unchanged(const char *file_name, const struct stat *statbuf);
+static void read_sys_save(const char *file_name, const struct stat *statbuf);
 
 /* Global variables */
 static int   _sys_errors;
@@ -23,6 +34,46 @@ static FILE *_wx;
 static FILE *_ww;
 static FILE *_suid;
 
+/* Files read on the previous and on the current scan */
+static OSHash *_read_last;
+static OSHash *_read_current;
+
+
+/* Check if the file was read on the last scan and hasn't changed since */
+static int read_sys_unchanged(const char *file_name, const struct stat *statbuf)
+{
+    rk_sys_read *last;
+
+    if (!rootcheck.skip_unchanged || !_read_last || !(last = OSHash_Get(_read_last, file_name))) {
+        return (0);
+    }
+
+    return (last->dev == statbuf->st_dev && last->ino == statbuf->st_ino &&
+            last->size == statbuf->st_size && last->mtime == statbuf->st_mtime &&
+            last->ctime == statbuf->st_ctime);
+}
+
+/* Remember that the contents of the file matched its size */
+static void read_sys_save(const char *file_name, const struct stat *statbuf)
+{
+    rk_sys_read *read;
+
+    if (!_read_current) {
+        return;
+    }
+
+    os_malloc(sizeof(rk_sys_read), read);
+    read->dev = statbuf->st_dev;
+    read->ino = statbuf->st_ino;
+    read->size = statbuf->st_size;
+    read->mtime = statbuf->st_mtime;
+    read->ctime = statbuf->st_ctime;
+
+    if (OSHash_Add(_read_current, file_name, read) != 2) {
+        free(read);
+    }
+}
+
 
 static int read_sys_file(const char *file_name, int do_read)
 {
@@ -77,8 +128,12 @@ static int read_sys_file(const char *file_name, int do_read)
         return (read_sys_dir(file_name, do_read));
     }
 
-    /* Check if the size from stats is the same as when we read the file */
-    if (S_ISREG(statbuf.st_mode) && do_read) {
+    /* Check if the size from stats is the same as when we read the file.
+     * Files that passed on the last scan are only read again if they changed.
+     */
+    if (S_ISREG(statbuf.st_mode) && do_read && read_sys_unchanged(file_name, &statbuf)) {
+        read_sys_save(file_name, &statbuf);
+    } else if (S_ISREG(statbuf.st_mode) && do_read) {
         char buf[OS_SIZE_1024];
         int fd;
         ssize_t nr;
@@ -95,7 +150,9 @@ static int read_sys_file(const char *file_name, int do_read)
 
             if (strcmp(file_name, "/dev/bus/usb/.usbfs/devices") == 0) {
                 /* Ignore .usbfs/devices */
-            } else if (total != statbuf.st_size) {
+            } else if (total == statbuf.st_size) {
+                read_sys_save(file_name, &statbuf);
+            } else {
                 struct stat statbuf2;
 
                 if ((lstat(file_name, &statbuf2) == 0) &&
@@ -400,6 +457,13 @@ void check_rc_sys(const char *basedir)
     _sys_total = 0;
     did = 0; /* device id */
 
+    if (rootcheck.skip_unchanged) {
+        _read_current = OSHash_Create();
+        if (_read_current) {
+            OSHash_SetFreeDataPointer(_read_current, free);
+        }
+    }
+
     snprintf(file_path, OS_SIZE_1024, "%s", basedir);
 
     /* Open output files */
@@ -488,5 +552,12 @@ void check_rc_sys(const char *basedir)
         fclose(_suid);
     }
 
+    /* The files read now are the reference for the next scan */
+    if (_read_last) {
+        OSHash_Free(_read_last);
+    }
+    _read_last = _read_current;
+    _read_current = NULL;
+
     return;
 }
@@ -191,6 +191,7 @@ int rootcheck_init(int test_config)
 #endif
 
     rootcheck.tsleep = getDefine_Int("rootcheck", "sleep", 0, 1000);
+    rootcheck.skip_unchanged = getDefine_Int("rootcheck", "skip_unchanged", 0, 1);
 
     /* If testing config, exit here */
     if (test_config) {
@@ -14,6 +14,84 @@
 #include "unit_tests/wrappers/externals/pcre2/pcre2_wrappers.h"
 #endif
 
+#define PCRE2_JIT_STACK_START   (32 * 1024)     ///< Initial JIT stack size of each thread
+#define PCRE2_JIT_STACK_MAX     (512 * 1024)    ///< Maximum JIT stack size of each thread
+
+/**
+ * @brief PCRE2 match resources of a thread, reused by every PCRE2 match of that thread
+ */
+typedef struct {
+    pcre2_match_data * match_data;      ///< Match data, big enough for the largest pattern matched so far
+    uint32_t ovector_size;              ///< Number of pairs of match_data
+    pcre2_match_context * context;      ///< Match context holding the JIT stack
+    pcre2_jit_stack * jit_stack;        ///< JIT stack of the thread
+} w_pcre2_thread_data_t;
+
+static pthread_key_t pcre2_thread_key;
+static pthread_once_t pcre2_thread_once = PTHREAD_ONCE_INIT;
+
+static bool _w_expression_match(w_expression_t * expression, const char * str_test, const char ** end_match,
+                                regex_matching * regex_match, bool copy_captures);
+
+static void w_expression_pcre2_thread_free(void * data) {
+
+    w_pcre2_thread_data_t * thread_data = (w_pcre2_thread_data_t *) data;
+
+    if (thread_data->match_data) {
+        pcre2_match_data_free(thread_data->match_data);
+    }
+    pcre2_match_context_free(thread_data->context);
+    pcre2_jit_stack_free(thread_data->jit_stack);
+    os_free(thread_data);
+}
+
+static void w_expression_pcre2_key_init() {
+    pthread_key_create(&pcre2_thread_key, w_expression_pcre2_thread_free);
+}
+
+/**
+ * @brief Get the PCRE2 match resources of the calling thread, able to hold the groups of a pattern
+ *
+ * @param code Pattern to be matched
+ * @return Thread resources, NULL if the match data could not be allocated
+ */
+static w_pcre2_thread_data_t * w_expression_pcre2_thread_data(pcre2_code * code) {
+
+    w_pcre2_thread_data_t * thread_data;
+    uint32_t capture_count = 0;
+
+    pthread_once(&pcre2_thread_once, w_expression_pcre2_key_init);
+
+    if (thread_data = pthread_getspecific(pcre2_thread_key), !thread_data) {
+        os_calloc(1, sizeof(w_pcre2_thread_data_t), thread_data);
+
+        /* Without a JIT stack the JIT code uses 32K of the machine stack */
+        thread_data->context = pcre2_match_context_create(NULL);
+        thread_data->jit_stack = pcre2_jit_stack_create(PCRE2_JIT_STACK_START, PCRE2_JIT_STACK_MAX, NULL);
+
+        if (thread_data->context && thread_data->jit_stack) {
+            pcre2_jit_stack_assign(thread_data->context, NULL, thread_data->jit_stack);
+        }
+        pthread_setspecific(pcre2_thread_key, thread_data);
+    }
+
+    pcre2_pattern_info(code, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+
+    if (thread_data->match_data == NULL || thread_data->ovector_size < capture_count + 1) {
+        if (thread_data->match_data) {
+            pcre2_match_data_free(thread_data->match_data);
+            thread_data->ovector_size = 0;
+        }
+
+        if (thread_data->match_data = pcre2_match_data_create_from_pattern(code, NULL), !thread_data->match_data) {
+            return NULL;
+        }
+        thread_data->ovector_size = capture_count + 1;
+    }
+
+    return thread_data;
+}
+
 void w_calloc_expression_t(w_expression_t ** var, w_exp_type_t type) {
 
     os_calloc(1, sizeof(w_expression_t), *var);
@@ -139,8 +217,11 @@ bool w_expression_compile(w_expression_t * expression, char * pattern, int flags
 
             if (!expression->pcre2->code) {
                 retval = false;
+                break;
             }
 
+            /* The interpreter is used if JIT isn't supported on this platform */
+            pcre2_jit_compile(expression->pcre2->code, PCRE2_JIT_COMPLETE);
             break;
 
         case EXP_TYPE_STRING:
@@ -157,11 +238,23 @@ bool w_expression_compile(w_expression_t * expression, char * pattern, int flags
 bool w_expression_match(w_expression_t * expression, const char * str_test, const char ** end_match,
                         regex_matching * regex_match) {
 
+    return _w_expression_match(expression, str_test, end_match, regex_match, true);
+}
+
+bool w_expression_match_spans(w_expression_t * expression, const char * str_test, const char ** end_match,
+                              regex_matching * regex_match) {
+
+    return _w_expression_match(expression, str_test, end_match, regex_match, false);
+}
+
+static bool _w_expression_match(w_expression_t * expression, const char * str_test, const char ** end_match,
+                                regex_matching * regex_match, bool copy_captures) {
+
     bool retval = false;
     const char * ret_match = NULL;
 
     regex_matching status_match = { .sub_strings = NULL };
-    pcre2_match_data * match_data = NULL;
+    w_pcre2_thread_data_t * thread_data = NULL;
     PCRE2_SIZE * ovector = NULL;
     int captured_groups = 0;
 
@@ -169,6 +262,10 @@ bool w_expression_match(w_expression_t * expression, const char * str_test, cons
         return retval;
     }
 
+    if (regex_match) {
+        regex_match->spans = NULL;
+    }
+
     switch (expression->exp_type) {
 
         case EXP_TYPE_OSMATCH:
@@ -180,7 +277,13 @@ bool w_expression_match(w_expression_t * expression, const char * str_test, cons
                 regex_match = &status_match;
             }
 
-            if (ret_match = OSRegex_Execute_ex(str_test, expression->regex, regex_match), ret_match) {
+            if (copy_captures) {
+                ret_match = OSRegex_Execute_ex(str_test, expression->regex, regex_match);
+            } else {
+                ret_match = OSRegex_Execute_spans(str_test, expression->regex, regex_match);
+            }
+
+            if (ret_match) {
                 retval = true;
             }
 
@@ -191,23 +294,23 @@ bool w_expression_match(w_expression_t * expression, const char * str_test, cons
 
         case EXP_TYPE_PCRE2:
 
-            if (match_data = pcre2_match_data_create_from_pattern(expression->pcre2->code, NULL), !match_data) {
+            if (thread_data = w_expression_pcre2_thread_data(expression->pcre2->code), !thread_data) {
                 break;
             }
             captured_groups = pcre2_match(expression->pcre2->code, (PCRE2_SPTR) str_test,
-                                          strlen(str_test), 0, 0, match_data, NULL);
+                                          strlen(str_test), 0, 0, thread_data->match_data, thread_data->context);
 
             /* successful match */
             if (captured_groups > 0) {
                 retval = true;
-                ovector = pcre2_get_ovector_pointer(match_data);
+                ovector = pcre2_get_ovector_pointer(thread_data->match_data);
                 ret_match = str_test + ovector[1] - 1;
 
                 if (regex_match) {
-                    w_expression_PCRE2_fill_regex_match(captured_groups, str_test, match_data, regex_match);
+                    w_expression_PCRE2_fill_regex_match(captured_groups, str_test, thread_data->match_data,
+                                                        regex_match);
                 }
             }
-            pcre2_match_data_free(match_data);
             break;
 
         case EXP_TYPE_STRING:
@@ -229,6 +332,63 @@ bool w_expression_match(w_expression_t * expression, const char * str_test, cons
     return retval;
 }
 
+w_expression_t * w_expression_combine_pcre2(OSList * expressions) {
+
+    OSListNode * node_it;
+    w_expression_t * exp_it;
+    w_expression_t * combined = NULL;
+    char * pattern = NULL;
+    pcre2_code * code;
+    uint32_t backrefs;
+    int errornumber = 0;
+    PCRE2_SIZE erroroffset = 0;
+    int count = 0;
+
+    if (expressions == NULL) {
+        return NULL;
+    }
+
+    OSList_foreach(node_it, expressions) {
+        exp_it = node_it->data;
+
+        if (exp_it->exp_type != EXP_TYPE_PCRE2) {
+            continue;
+        }
+
+        /* Numbered back references would point to other groups once combined */
+        if (pcre2_pattern_info(exp_it->pcre2->code, PCRE2_INFO_BACKREFMAX, &backrefs) != 0 || backrefs > 0) {
+            os_free(pattern);
+            return NULL;
+        }
+
+        wm_strcat(&pattern, "(?:", count > 0 ? '|' : '\0');
+        wm_strcat(&pattern, exp_it->pcre2->raw_pattern, '\0');
+        wm_strcat(&pattern, ")", '\0');
+        count++;
+    }
+
+    if (count < 2) {
+        os_free(pattern);
+        return NULL;
+    }
+
+    /* Patterns that can't be nested (e.g. with leading verbs) are evaluated one by one */
+    if (code = pcre2_compile((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED, 0, &errornumber, &erroroffset, NULL),
+        !code) {
+        os_free(pattern);
+        return NULL;
+    }
+
+    /* The interpreter is used if JIT is not available */
+    pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+
+    w_calloc_expression_t(&combined, EXP_TYPE_PCRE2);
+    combined->pcre2->code = code;
+    combined->pcre2->raw_pattern = pattern;
+
+    return combined;
+}
+
 void w_expression_PCRE2_fill_regex_match(int captured_groups, const char * str_test, pcre2_match_data * match_data,
                                          regex_matching * regex_match) {
 
@@ -623,11 +623,57 @@ void DeleteState() {
 }
 
 
+/* Check if the next 'size' bytes of the merged file match the file at 'path'.
+ * The merged file is left after the member if they match, or at its beginning if not. */
+static int unmerge_member_equal(FILE *finalfp, const char *path, size_t size, int mode)
+{
+    char buf_merged[2048];
+    char buf_file[2048];
+    int64_t offset;
+    size_t n;
+    int equal = 0;
+    FILE *fp;
+
+    if (FileSize(path) != (off_t)size || (offset = w_ftell(finalfp)) < 0) {
+        return 0;
+    }
+
+    if (fp = fopen(path, mode == OS_BINARY ? "rb" : "r"), !fp) {
+        return 0;
+    }
+
+    while (size > 0) {
+        n = size < sizeof(buf_merged) ? size : sizeof(buf_merged);
+
+        if (fread(buf_merged, 1, n, finalfp) != n || fread(buf_file, 1, n, fp) != n || memcmp(buf_merged, buf_file, n) != 0) {
+            break;
+        }
+
+        size -= n;
+    }
+
+    equal = size == 0;
+    fclose(fp);
+
+    if (!equal) {
+        w_fseek(finalfp, offset, SEEK_SET);
+    }
+
+    return equal;
+}
+
 int UnmergeFiles(const char *finalpath, const char *optdir, int mode)
+{
+    return UnmergeFiles_ex(finalpath, optdir, mode, NULL, NULL);
+}
+
+int UnmergeFiles_ex(const char *finalpath, const char *optdir, int mode, char ***unmerged_files, char ***changed_files)
 {
     int ret = 1;
     int state_ok;
     size_t i = 0, n = 0, files_size = 0;
+    size_t unmerged_count = 0;
+    size_t changed_count = 0;
     char *files;
     char * copy;
     char final_name[2048 + 1];
@@ -635,6 +681,14 @@ int UnmergeFiles(const char *finalpath, const char *optdir, int mode)
     FILE *fp;
     FILE *finalfp;
 
+    if (unmerged_files) {
+        os_calloc(1, sizeof(char *), *unmerged_files);
+    }
+
+    if (changed_files) {
+        os_calloc(1, sizeof(char *), *changed_files);
+    }
+
     finalfp = fopen(finalpath, mode == OS_BINARY ? "rb" : "r");
     if (!finalfp) {
         merror("Unable to read merged file: '%s' due to [(%d)-(%s)].", finalpath, errno, strerror(errno));
@@ -693,6 +747,23 @@ int UnmergeFiles(const char *finalpath, const char *optdir, int mode)
 
         free(copy);
 
+        if (state_ok && unmerged_files) {
+            os_realloc(*unmerged_files, (unmerged_count + 2) * sizeof(char *), *unmerged_files);
+            os_strdup(files, (*unmerged_files)[unmerged_count]);
+            (*unmerged_files)[++unmerged_count] = NULL;
+        }
+
+        /* Members that didn't change are not written again */
+        if (state_ok && unmerge_member_equal(finalfp, final_name, files_size, mode)) {
+            continue;
+        }
+
+        if (state_ok && changed_files) {
+            os_realloc(*changed_files, (changed_count + 2) * sizeof(char *), *changed_files);
+            os_strdup(files, (*changed_files)[changed_count]);
+            (*changed_files)[++changed_count] = NULL;
+        }
+
         /* Open filename */
 
         if (state_ok) {
@@ -93,21 +93,40 @@ void *OSHash_Free(OSHash *self)
     return (NULL);
 }
 
-/* Generates hash for key */
+/* Generates hash for key
+ * The key is mixed 8 bytes at a time with multiply-xorshift rounds and a
+ * final avalanche, so that similar keys (paths, agent IDs) spread evenly.
+ */
 static unsigned int _os_genhash(const OSHash *self, const char *key)
 {
-    unsigned int hash_key = self->initial_seed;
-
-    /* What we have here is a simple polynomial hash.
-     * x0 * a^k-1 .. xk * a^k-k +1
-     */
-    while (*key) {
-        hash_key *= self->constant;
-        hash_key += (unsigned int) * key;
-        key++;
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    size_t len = strlen(key);
+    uint64_t hash_key = ((uint64_t)self->initial_seed * multiplier) ^ self->constant ^ len;
+    uint64_t block;
+
+    while (len >= sizeof(block)) {
+        memcpy(&block, key, sizeof(block));
+        hash_key = (hash_key ^ block) * multiplier;
+        hash_key ^= hash_key >> 32;
+        key += sizeof(block);
+        len -= sizeof(block);
+    }
+
+    if (len > 0) {
+        block = 0;
+        memcpy(&block, key, len);
+        hash_key = (hash_key ^ block) * multiplier;
+        hash_key ^= hash_key >> 32;
     }
 
-    return (hash_key);
+    /* MurmurHash3 finalizer */
+    hash_key ^= hash_key >> 33;
+    hash_key *= 0xFF51AFD7ED558CCDULL;
+    hash_key ^= hash_key >> 33;
+    hash_key *= 0xC4CEB9FE1A85EC53ULL;
+    hash_key ^= hash_key >> 33;
+
+    return ((unsigned int)hash_key);
 }
 
 /* Set new size for hash
@@ -537,6 +556,7 @@ OSHash *OSHash_Duplicate(const OSHash *hash) {
     self->rows = hash->rows;
     self->initial_seed = hash->initial_seed;
     self->constant = hash->constant;
+    self->elements = hash->elements;
     self->free_data_function = hash->free_data_function;
 
     os_calloc(self->rows + 1, sizeof(OSHashNode*), self->table);
@@ -9,6 +9,11 @@
 
 #include "shared.h"
 
+#ifdef INOTIFY_ENABLED
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
+
 // Initializes queue. Equivalent to initialize every field to 0.
 void jqueue_init(file_queue * queue) {
     memset(queue, 0, sizeof(file_queue));
@@ -102,6 +107,57 @@ cJSON * jqueue_next(file_queue * queue) {
 void jqueue_close(file_queue * queue) {
     fclose(queue->fp);
     queue->fp = NULL;
+
+#ifdef INOTIFY_ENABLED
+    if (queue->notify_ready && queue->notify_fd >= 0) {
+        close(queue->notify_fd);
+    }
+    queue->notify_ready = 0;
+#endif
+}
+
+// Wait until the alerts file is written, or up to the timeout
+void jqueue_wait(file_queue * queue, unsigned int timeout) {
+#ifdef INOTIFY_ENABLED
+    char buffer[OS_SIZE_4096];
+    struct pollfd pfd;
+
+    if (!queue->notify_ready) {
+        queue->notify_ready = 1;
+        queue->notify_wd = -1;
+        queue->notify_ino = 0;
+
+        if (queue->notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC), queue->notify_fd < 0) {
+            mdebug1("Cannot watch '%s', polling it instead: %s (%d)", queue->file_name, strerror(errno), errno);
+        }
+    }
+
+    /* Follow the file currently open, it changes when the alerts are rotated */
+    if (queue->notify_fd >= 0 && queue->fp && queue->notify_ino != queue->f_status.st_ino) {
+        if (queue->notify_wd >= 0) {
+            inotify_rm_watch(queue->notify_fd, queue->notify_wd);
+        }
+
+        queue->notify_wd = inotify_add_watch(queue->notify_fd, queue->file_name, IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF);
+        queue->notify_ino = queue->f_status.st_ino;
+    }
+
+    if (queue->notify_fd < 0 || queue->notify_wd < 0) {
+        sleep(timeout);
+        return;
+    }
+
+    pfd.fd = queue->notify_fd;
+    pfd.events = POLLIN;
+
+    if (poll(&pfd, 1, timeout * 1000) > 0) {
+        /* Events only wake us up, the data is read by jqueue_next() */
+        while (read(queue->notify_fd, buffer, sizeof(buffer)) > 0);
+    }
+#else
+    (void)queue;
+    sleep(timeout);
+#endif
 }
 
 /**
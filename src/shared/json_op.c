@@ -11,6 +11,12 @@
 
 #include <shared.h>
 
+#ifdef WAZUH_UNIT_TESTING
+#define STATIC
+#else
+#define STATIC static
+#endif
+
 cJSON * json_fread(const char * path, char retry) {
     cJSON * item = NULL;
     char * buffer = NULL;
@@ -144,3 +150,220 @@ int* json_parse_agents(const cJSON* agents) {
 
     return agent_ids;
 }
+
+/* Arena of the parsed request trees */
+
+#define JSON_ARENA_CHUNK    65536
+#define JSON_ARENA_ALIGN    16
+
+typedef struct json_arena_chunk_t {
+    struct json_arena_chunk_t * next;
+    size_t size;                        ///< Chunk size, including this header
+    char * end;
+} json_arena_chunk_t;
+
+/* The header size keeps the data aligned */
+#define JSON_ARENA_HEADER   ((sizeof(json_arena_chunk_t) + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1))
+
+typedef struct {
+    json_arena_chunk_t * chunks;        ///< Current chunk first
+    char * next;                        ///< Free space of the current chunk
+    const json_arena_chunk_t * hit;     ///< Chunk of the last pointer freed
+    const char * low;                   ///< Lowest address of the chunks
+    const char * high;                  ///< Highest end of the chunks
+    bool active;                        ///< The allocations go to the arena
+} json_arena_t;
+
+static pthread_key_t json_arena_key;
+static pthread_once_t json_arena_once = PTHREAD_ONCE_INIT;
+static bool json_arena_hooks;
+
+static void json_arena_destroy(void * data) {
+    json_arena_t * arena = (json_arena_t *)data;
+    json_arena_chunk_t * chunk;
+
+    while (chunk = arena->chunks, chunk) {
+        arena->chunks = chunk->next;
+        os_free(chunk);
+    }
+
+    os_free(arena);
+}
+
+static void json_arena_key_init() {
+    pthread_key_create(&json_arena_key, json_arena_destroy);
+}
+
+/**
+ * @brief Get the arena of the calling thread, creating it on the first call
+ *
+ * @return Arena, NULL if the hooks are not installed.
+ */
+static json_arena_t * json_arena_get() {
+    json_arena_t * arena;
+
+    if (!json_arena_hooks) {
+        return NULL;
+    }
+
+    if (arena = pthread_getspecific(json_arena_key), !arena) {
+        os_calloc(1, sizeof(json_arena_t), arena);
+        pthread_setspecific(json_arena_key, arena);
+    }
+
+    return arena;
+}
+
+static bool json_arena_owns(json_arena_t * arena, const void * ptr) {
+    const char * p = (const char *)ptr;
+    const json_arena_chunk_t * chunk = arena->hit;
+
+    // A tree is deleted in the order it was parsed, so most frees fall in the chunk of the previous one
+    if (chunk && p >= (const char *)chunk && p < chunk->end) {
+        return true;
+    }
+
+    // The heap pointers out of the span of the chunks don't need the walk
+    if (p < arena->low || p >= arena->high) {
+        return false;
+    }
+
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        if (p >= (const char *)chunk && p < chunk->end) {
+            arena->hit = chunk;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+STATIC void * json_arena_malloc(size_t size) {
+    json_arena_t * arena = pthread_getspecific(json_arena_key);
+    json_arena_chunk_t * chunk;
+    void * ptr;
+
+    if (!arena || !arena->active) {
+        return malloc(size);
+    }
+
+    size = (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+
+    if (!arena->chunks || (size_t)(arena->chunks->end - arena->next) < size) {
+        size_t chunk_size = JSON_ARENA_HEADER + size > JSON_ARENA_CHUNK ? JSON_ARENA_HEADER + size : JSON_ARENA_CHUNK;
+
+        os_malloc(chunk_size, chunk);
+        chunk->size = chunk_size;
+        chunk->end = (char *)chunk + chunk_size;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->next = (char *)chunk + JSON_ARENA_HEADER;
+
+        if (!arena->low || (const char *)chunk < arena->low) {
+            arena->low = (const char *)chunk;
+        }
+
+        if (chunk->end > arena->high) {
+            arena->high = chunk->end;
+        }
+    }
+
+    ptr = arena->next;
+    arena->next += size;
+    return ptr;
+}
+
+STATIC void json_arena_free(void * ptr) {
+    json_arena_t * arena;
+
+    // The arena memory is released by json_arena_reset()
+    if (ptr && (arena = pthread_getspecific(json_arena_key), arena) && json_arena_owns(arena, ptr)) {
+        return;
+    }
+
+    free(ptr);
+}
+
+void json_arena_init() {
+    cJSON_Hooks hooks = { .malloc_fn = json_arena_malloc, .free_fn = json_arena_free };
+
+    pthread_once(&json_arena_once, json_arena_key_init);
+    cJSON_InitHooks(&hooks);
+    json_arena_hooks = true;
+}
+
+/**
+ * @brief Send the cJSON allocations of the calling thread to its arena
+ *
+ * @return true if the hooks are installed, false if the allocations still go to malloc().
+ */
+STATIC bool json_arena_enter() {
+    json_arena_t * arena = json_arena_get();
+
+    if (arena) {
+        arena->active = true;
+    }
+
+    return arena != NULL;
+}
+
+STATIC void json_arena_leave() {
+    json_arena_t * arena = json_arena_get();
+
+    if (arena) {
+        arena->active = false;
+    }
+}
+
+cJSON * json_arena_parse(const char * string, const char ** end, cJSON_bool require_null) {
+    cJSON * item;
+
+    if (!json_arena_enter()) {
+        return cJSON_ParseWithOpts(string, end, require_null);
+    }
+
+    item = cJSON_ParseWithOpts(string, end, require_null);
+    json_arena_leave();
+
+    return item;
+}
+
+void json_arena_reset() {
+    json_arena_t * arena;
+    json_arena_chunk_t * chunk;
+
+    if (!json_arena_hooks || (arena = pthread_getspecific(json_arena_key), !arena)) {
+        return;
+    }
+
+    // Keep the first chunk unless it was a large one
+    while (chunk = arena->chunks, chunk && (chunk->next || chunk->size != JSON_ARENA_CHUNK)) {
+        arena->chunks = chunk->next;
+        os_free(chunk);
+    }
+
+    arena->next = arena->chunks ? (char *)arena->chunks + JSON_ARENA_HEADER : NULL;
+    arena->hit = NULL;
+    arena->low = arena->chunks ? (const char *)arena->chunks : NULL;
+    arena->high = arena->chunks ? arena->chunks->end : NULL;
+}
+
+int json_snprint(char * buffer, size_t size, const char * prefix, const cJSON * item) {
+    size_t length = strlen(prefix);
+    char * out;
+
+    if (length < size) {
+        memcpy(buffer, prefix, length);
+
+        if (size - length <= INT_MAX && cJSON_PrintPreallocated((cJSON *)item, buffer + length, (int)(size - length), false)) {
+            return 0;
+        }
+    }
+
+    // It doesn't fit, so it is truncated
+    out = cJSON_PrintUnformatted(item);
+    snprintf(buffer, size, "%s%s", prefix, out ? out : "");
+    os_free(out);
+
+    return -1;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * @file latency_op.c
+ * @brief Latency histograms for sampled events
+ */
+
+#include "shared.h"
+
+static _Atomic unsigned int sample_counter;
+
+bool w_latency_sample(unsigned int rate) {
+    return rate > 0 && sample_counter++ % rate == 0;
+}
+
+uint64_t w_latency_now() {
+    struct timespec ts;
+
+    gettime(&ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t w_latency_add(w_latency_t * latency, uint64_t start) {
+    uint64_t now;
+    uint64_t elapsed;
+    unsigned int bucket = 0;
+
+    if (start == 0) {
+        return 0;
+    }
+
+    now = w_latency_now();
+    elapsed = now > start ? now - start : 0;
+
+    while (bucket < W_LATENCY_BUCKETS - 1 && elapsed >= (UINT64_C(1) << bucket)) {
+        bucket++;
+    }
+
+    w_mutex_lock(&latency->mutex);
+    latency->count++;
+    latency->total += elapsed;
+    latency->buckets[bucket]++;
+
+    if (elapsed > latency->max) {
+        latency->max = elapsed;
+    }
+
+    w_mutex_unlock(&latency->mutex);
+
+    return now;
+}
+
+cJSON * w_latency_to_json(w_latency_t * latency) {
+    w_latency_t copy;
+    char name[OS_SIZE_32];
+
+    w_mutex_lock(&latency->mutex);
+    memcpy(&copy, latency, sizeof(w_latency_t));
+    w_mutex_unlock(&latency->mutex);
+
+    cJSON * json = cJSON_CreateObject();
+    cJSON * histogram = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(json, "count", copy.count);
+    cJSON_AddNumberToObject(json, "avg_us", copy.count ? copy.total / copy.count : 0);
+    cJSON_AddNumberToObject(json, "max_us", copy.max);
+    cJSON_AddItemToObject(json, "histogram", histogram);
+
+    /* Only the non-empty buckets, named by their upper bound */
+    for (unsigned int i = 0; i < W_LATENCY_BUCKETS; i++) {
+        if (copy.buckets[i] > 0) {
+            if (i < W_LATENCY_BUCKETS - 1) {
+                snprintf(name, sizeof(name), "lt_%" PRIu64 "us", UINT64_C(1) << i);
+            } else {
+                snprintf(name, sizeof(name), "ge_%" PRIu64 "us", UINT64_C(1) << (i - 1));
+            }
+
+            cJSON_AddNumberToObject(histogram, name, copy.buckets[i]);
+        }
+    }
+
+    return json;
+}
@@ -75,80 +75,156 @@ int log_builder_update(log_builder_t * builder) {
     return result;
 }
 
-// Build a log string
-char * log_builder_build(log_builder_t * builder, const char * pattern, const char * logmsg, const char * location) {
-    char * final;
-    char * _pattern;
-    char * cur;
-    char * tok;
-    char * end;
-    char * param;
-    const char * field;
-    char _timestamp[64];
-    char * escaped_log = NULL;
-    size_t n = 0;
-    size_t z;
-    time_t timestamp = time(NULL);
-
-    assert(logmsg != NULL);
-
-    if (!pattern) {
-        return strdup(logmsg);
-    }
-
-    assert(&builder->rwlock != NULL);
+// Compile a log format
+log_format_t * log_builder_compile(const char * pattern) {
+    log_format_t * format;
+    log_token_t * token;
+    const char * cur;
+    const char * tok;
+    const char * end;
+    const char * param;
+    size_t length;
 
-    os_malloc(OS_MAXSTR, final);
-    os_strdup(pattern, _pattern);
+    assert(pattern != NULL);
 
-    rwlock_lock_read(&builder->rwlock);
+    os_calloc(1, sizeof(log_format_t), format);
 
-    for (cur = _pattern; tok = strstr(cur, "$("), tok; cur = end) {
-        field = NULL;
-        *tok = '\0';
+    // Every token may need a literal before it
+    os_calloc(2 * (strlen(pattern) / 3 + 1), sizeof(log_token_t), format->tokens);
 
+    for (cur = pattern; tok = strstr(cur, "$("), tok; cur = end + 1) {
         // Skip $(
         param = tok + 2;
 
-        // Copy anything before the token
-        z = strlen(cur);
-
-        if (n + z >= OS_MAXSTR) {
-            goto fail;
+        if (tok > cur) {
+            token = format->tokens + format->size++;
+            token->type = LOG_FIELD_TEXT;
+            token->length = tok - cur;
+            os_malloc(token->length + 1, token->text);
+            memcpy(token->text, cur, token->length);
+            token->text[token->length] = '\0';
+            format->constant_length += token->length;
         }
 
-        strncpy(final + n, cur, OS_MAXSTR - n);
-        n += z;
-
         if (end = strchr(param, ')'), !end) {
-            // Token not closed: break
-            *tok = '$';
+            // Token not closed: the rest is a literal
             cur = tok;
             break;
         }
 
-        *end++ = '\0';
+        length = end - param;
+        token = format->tokens + format->size;
+
+        if ((length == 3 && !strncmp(param, "log", 3)) || (length == 6 && !strncmp(param, "output", 6))) {
+            token->type = LOG_FIELD_LOG;
+        } else if ((length == 8 && !strncmp(param, "location", 8)) || (length == 7 && !strncmp(param, "command", 7))) {
+            token->type = LOG_FIELD_LOCATION;
+        } else if (length >= 9 && !strncmp(param, "timestamp", 9)) {
+            const char * space = memchr(param, ' ', length);
+
+            token->type = LOG_FIELD_TIMESTAMP;
+
+            // If format is not speficied, use RFC3164
+            if (space) {
+                token->length = end - space - 1;
+                os_malloc(token->length + 1, token->text);
+                memcpy(token->text, space + 1, token->length);
+                token->text[token->length] = '\0';
+            }
+        } else if (length == 8 && !strncmp(param, "hostname", 8)) {
+            token->type = LOG_FIELD_HOSTNAME;
+        } else if (length == 7 && !strncmp(param, "host_ip", 7)) {
+            token->type = LOG_FIELD_HOST_IP;
+        } else if (length == 16 && !strncmp(param, "json_escaped_log", 16)) {
+            token->type = LOG_FIELD_JSON_ESCAPED_LOG;
+        } else if (length == 10 && !strncmp(param, "base64_log", 10)) {
+            token->type = LOG_FIELD_BASE64_LOG;
+        } else {
+            mdebug1("Invalid parameter '%.*s' for log format.", (int)length, param);
+            continue;
+        }
+
+        format->size++;
+    }
+
+    // Rest of the pattern
+    if (*cur) {
+        token = format->tokens + format->size++;
+        token->type = LOG_FIELD_TEXT;
+        os_strdup(cur, token->text);
+        token->length = strlen(cur);
+        format->constant_length += token->length;
+    }
+
+    return format;
+}
+
+// Free a compiled log format
+void log_format_free(log_format_t * format) {
+    size_t i;
+
+    if (format) {
+        for (i = 0; i < format->size; i++) {
+            free(format->tokens[i].text);
+        }
+
+        free(format->tokens);
+        free(format);
+    }
+}
+
+// Format a log with a compiled format
+size_t log_builder_format(log_builder_t * builder, const log_format_t * format, const char * logmsg, const char * location, char * output, size_t size) {
+    const log_token_t * token;
+    const char * field;
+    char _timestamp[64];
+    char * escaped_log = NULL;
+    struct tm tm;
+    bool tm_set = false;
+    size_t n = 0;
+    size_t z;
+    size_t i;
+
+    assert(logmsg != NULL);
+    assert(size > 0);
+
+    if (format->constant_length >= size) {
+        goto fail;
+    }
+
+    rwlock_lock_read(&builder->rwlock);
+
+    for (i = 0; i < format->size; i++) {
+        token = format->tokens + i;
+        field = NULL;
 
-        // Find parameter
+        switch (token->type) {
+        case LOG_FIELD_TEXT:
+            field = token->text;
+            break;
 
-        if (strcmp(param, "log") == 0 || strcmp(param, "output") == 0) {
+        case LOG_FIELD_LOG:
             field = logmsg;
-        } else if (strcmp(param, "location") == 0 || strcmp(param, "command") == 0) {
+            break;
+
+        case LOG_FIELD_LOCATION:
             field = location;
-        } else if (strncmp(param, "timestamp", 9) == 0) {
-            struct tm tm;
-            char * format;
+            break;
 
-            localtime_r(&timestamp, &tm);
+        case LOG_FIELD_TIMESTAMP:
+            if (!tm_set) {
+                time_t timestamp = time(NULL);
+                localtime_r(&timestamp, &tm);
+                tm_set = true;
+            }
 
-            if (format = strchr(param, ' '), format) {
-                if (strftime(_timestamp, sizeof(_timestamp), format + 1, &tm)) {
+            if (token->text) {
+                if (strftime(_timestamp, sizeof(_timestamp), token->text, &tm)) {
                     field = _timestamp;
                 } else {
-                    mdebug1("Cannot format time '%s': %s (%d)", format, strerror(errno), errno);
+                    mdebug1("Cannot format time '%s': %s (%d)", token->text, strerror(errno), errno);
                 }
             } else {
-                // If format is not speficied, use RFC3164
 #ifdef WIN32
                 // strfrime() does not allow %e in Windows
                 const char * MONTHS[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
@@ -162,57 +238,75 @@ char * log_builder_build(log_builder_t * builder, const char * pattern, const ch
                 }
 #endif // WIN32
             }
-        } else if (strcmp(param, "hostname") == 0) {
+            break;
+
+        case LOG_FIELD_HOSTNAME:
             field = builder->host_name;
-        } else if (strcmp(param, "host_ip") == 0) {
+            break;
+
+        case LOG_FIELD_HOST_IP:
             field = builder->host_ip;
-        } else if (strcmp(param, "json_escaped_log") == 0) {
+            break;
+
+        case LOG_FIELD_JSON_ESCAPED_LOG:
             field = escaped_log = wstr_escape_json(logmsg);
-        } else if (strcmp(param, "base64_log") == 0) {
+            break;
+
+        case LOG_FIELD_BASE64_LOG:
             field = escaped_log = encode_base64(strlen(logmsg), logmsg);
-        } else {
-            mdebug1("Invalid parameter '%s' for log format.", param);
-            continue;
+            break;
         }
 
         if (field) {
-            z = strlen(field);
+            z = token->type == LOG_FIELD_TEXT ? token->length : strlen(field);
 
-            if (n + z >= OS_MAXSTR) {
+            if (n + z >= size) {
+                rwlock_unlock(&builder->rwlock);
                 goto fail;
             }
 
-            strncpy(final + n, field, OS_MAXSTR - n);
+            memcpy(output + n, field, z);
             n += z;
         }
 
         os_free(escaped_log);
     }
 
-    // Copy rest of the pattern
+    rwlock_unlock(&builder->rwlock);
+
+    output[n] = '\0';
+    return n;
 
-    z = strlen(cur);
+fail:
+    mdebug1("Too long message format");
+    free(escaped_log);
 
-    if (n + z >= OS_MAXSTR) {
-        goto fail;
-    }
+    n = strlen(logmsg);
+    n = n < size ? n : size - 1;
+    memcpy(output, logmsg, n);
+    output[n] = '\0';
+    return n;
+}
 
-    rwlock_unlock(&builder->rwlock);
+// Build a log string
+char * log_builder_build(log_builder_t * builder, const char * pattern, const char * logmsg, const char * location) {
+    log_format_t * format;
+    char * final;
+
+    assert(logmsg != NULL);
 
-    strncpy(final + n, cur, OS_MAXSTR - n);
-    final[n + z] = '\0';
+    if (!pattern) {
+        return strdup(logmsg);
+    }
 
-    free(_pattern);
-    return final;
+    assert(&builder->rwlock != NULL);
 
-fail:
-    rwlock_unlock(&builder->rwlock);
+    os_malloc(OS_MAXSTR, final);
+
+    format = log_builder_compile(pattern);
+    log_builder_format(builder, format, logmsg, location, final, OS_MAXSTR);
+    log_format_free(format);
 
-    mdebug1("Too long message format");
-    strncpy(final, logmsg ? logmsg : "Too long message format", OS_MAXSTR - 1);
-    final[OS_MAXSTR - 1] = '\0';
-    free(_pattern);
-    free(escaped_log);
     return final;
 }
 
@@ -0,0 +1,485 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * Copyright (C) 2009 Trend Micro Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include "shared.h"
+#include "os_regex/os_regex.h"
+
+/* Moved from OS_CleanMSG so that the agents cut the headers the same way */
+void w_log_header_parse(char * raw, size_t loglen, w_log_header_t * header)
+{
+    char *pieces = raw;
+    char *copy = header->log;
+
+    /* check if month contains an umlaut and repair
+     * umlauts are non-ASCII and use 2 slots in the char array
+     * repair to only one slot so we can detect the correct date format in the next step
+     * ex: Mär 02 17:30:52
+     */
+    if (loglen >= 3 && pieces[1] == (char) 195) {
+        if (pieces[2] == (char) 164) {
+            pieces[0] = '\0';
+            pieces[1] = 'M';
+            pieces[2] = 'a';
+            pieces++;
+        }
+    }
+
+    /* Check for the syslog date format
+     * ( ex: Dec 29 10:00:01
+     *   or  2015 Dec 29 10:00:01
+     *   or  2007-06-14T15:48:55-04:00 for syslog-ng isodate
+     *   or  2022-12-19T15:02:53.288+00:00 for syslog isodate
+     *   or  2009-05-22T09:36:46.214994-07:00 for rsyslog )
+     *   or  2015-04-16 21:51:02,805 (proftpd 1.3.5)
+     *   or  2021-04-21 10:16:09.404756-0700 (for macos ULS --syslog output)
+     */
+    if (
+        (
+            (loglen > 17) &&
+            (pieces[3] == ' ') &&
+            (pieces[6] == ' ') &&
+            (pieces[9] == ':') &&
+            (pieces[12] == ':') &&
+            (pieces[15] == ' ') && (header->log += 16)
+        )
+        ||
+	(
+	    (loglen > 24) &&
+	    (pieces[4] == '-') &&
+	    (pieces[7] == '-') &&
+	    (pieces[10] == ' ') &&
+	    (pieces[13] == ':') &&
+	    (pieces[16] == ':') &&
+	    (pieces[19] == ',') &&
+	    (header->log += 24)
+	)
+	||
+        (
+            (loglen > 33) &&
+            (pieces[4] == '-') &&
+            (pieces[7] == '-') &&
+            (pieces[10] == 'T') &&
+            (pieces[13] == ':') &&
+            (pieces[16] == ':') &&
+
+            (
+                ((pieces[22] == ':') &&
+                 (pieces[25] == ' ') && (header->log += 26)) ||
+
+                ((pieces[19] == '.') &&
+                (
+                    ((pieces[26] == ':') && (header->log += 30))  ||
+                    ((pieces[29] == ':') && (header->log += 33))  ||
+                    (header->log += 32)
+                ))
+            )
+        )
+     ||
+        (
+            (loglen > 21) &&
+            (isdigit(pieces[0])) &&
+            (pieces[4] == ' ') &&
+            (pieces[8] == ' ') &&
+            (pieces[11] == ' ') &&
+            (pieces[14] == ':') &&
+            (pieces[17] == ':') &&
+            (pieces[20] == ' ') && (header->log += 21)
+        )
+     ||
+        (
+            (loglen > 33) &&
+            (isdigit(pieces[0])) &&
+            (pieces[4] == '-') &&
+            (pieces[7] == '-') &&
+            (pieces[10] == ' ') &&
+            (pieces[13] == ':') &&
+            (pieces[16] == ':') &&
+            (pieces[19] == '.') &&
+            (pieces[26] == '-') &&
+            (pieces[31] == ' ') && (header->log += 32)
+        )
+
+    ) {
+
+        header->dec_timestamp = copy;
+        header->log[-1] = '\0';
+
+        /* Check for an extra space in here */
+        if (*header->log == ' ') {
+            header->log++;
+        }
+
+
+        /* Hostname */
+        pieces = header->hostname = header->log;
+
+
+        /* Check for a valid hostname */
+        while (isValidChar(*pieces) == 1) {
+            pieces++;
+        }
+
+        /* Check if it is a syslog without hostname (common on Solaris) */
+        if (*pieces == ':' && pieces[1] == ' ') {
+            /* Getting solaris 8/9 messages without hostname.
+             * In these cases, the process_name should be there.
+             * http://www.ossec.net/wiki/index.php/Log_Samples_Solaris
+             */
+            header->program_name = header->hostname;
+            header->hostname = NULL;
+
+            /* End the program name string */
+            *pieces = '\0';
+
+            pieces += 2;
+            header->log = pieces;
+        }
+
+        /* Extract the hostname */
+        else if (*pieces != ' ') {
+            /* Invalid hostname */
+            header->hostname = NULL;
+            pieces = NULL;
+        } else {
+            /* End the hostname string */
+            *pieces = '\0';
+
+            /* Move pieces to the beginning of the log message */
+            pieces++;
+            header->log = pieces;
+
+            /* Get program_name */
+            header->program_name = pieces;
+
+            /* Extract program_name */
+            /* Valid names:
+             * p_name:
+             * p_name[pid]:
+             * p_name[pid]: [ID xx facility.severity]
+             * auth|security:info p_name:
+             */
+            while (isValidChar(*pieces) == 1) {
+                pieces++;
+            }
+
+            /* Check for the first format: p_name: */
+            if (*pieces == ':') {
+                *pieces = '\0';
+                pieces++;
+
+                // The space after ':' is optional
+                pieces += *pieces == ' ';
+            }
+
+            /* Check for the second format: p_name[pid]: */
+            else if ((*pieces == '[') && (isdigit((int)pieces[1]))) {
+                *pieces = '\0';
+                pieces += 2;
+                while (isdigit((int)*pieces)) {
+                    pieces++;
+                }
+
+                if ((*pieces == ']') && (pieces[1] == ':')) {
+                    pieces += 2;
+
+                    // The space after ':' is optional
+                    pieces += *pieces == ' ';
+                }
+                /* Some systems are not terminating the program name with
+                 * a ':'. Working around this in here...
+                 */
+                else if ((*pieces == ']') && (pieces[1] == ' ')) {
+                    pieces += 2;
+                } else {
+                    /* Fix for some weird log formats */
+                    pieces--;
+                    while (isdigit((int)*pieces)) {
+                        pieces--;
+                    }
+
+                    if (*pieces == '\0') {
+                        *pieces = '[';
+                    }
+                    pieces = NULL;
+                    header->program_name = NULL;
+                }
+            }
+            /* AIX syslog */
+            else if ((*pieces == '|') && islower((int)pieces[1])) {
+                pieces += 2;
+
+                /* Remove facility */
+                while (isalnum((int)*pieces)) {
+                    pieces++;
+                }
+
+                if (*pieces == ':') {
+                    /* Remove severity */
+                    pieces++;
+                    while (isalnum((int)*pieces)) {
+                        pieces++;
+                    }
+
+                    if (*pieces == ' ') {
+                        pieces++;
+                        header->program_name = pieces;
+
+
+                        /* Get program name again */
+                        while (isValidChar(*pieces) == 1) {
+                            pieces++;
+                        }
+
+                        /* Check for the first format: p_name: */
+                        if ((*pieces == ':') && (pieces[1] == ' ')) {
+                            *pieces = '\0';
+                            pieces += 2;
+                        }
+
+                        /* Check for the second format: p_name[pid]: */
+                        else if ((*pieces == '[') && (isdigit((int)pieces[1]))) {
+                            *pieces = '\0';
+                            pieces += 2;
+                            while (isdigit((int)*pieces)) {
+                                pieces++;
+                            }
+
+                            if ((*pieces == ']') && (pieces[1] == ':') &&
+                                    (pieces[2] == ' ')) {
+                                pieces += 3;
+                            } else {
+                                pieces = NULL;
+                            }
+                        }
+                    } else {
+                        pieces = NULL;
+                        header->program_name = NULL;
+                    }
+                }
+                /* Invalid AIX */
+                else {
+                    pieces = NULL;
+                    header->program_name = NULL;
+                }
+            } else {
+                pieces = NULL;
+                header->program_name = NULL;
+            }
+        }
+
+        /* Remove [ID xx facility.severity] */
+        if (pieces) {
+            /* Set log after program name */
+            header->log = pieces;
+
+            if ((pieces[0] == '[') &&
+                    (pieces[1] == 'I') &&
+                    (pieces[2] == 'D') &&
+                    (pieces[3] == ' ')) {
+                pieces += 4;
+
+                /* Going after the ] */
+                pieces = strchr(pieces, ']');
+                if (pieces) {
+                    pieces += 2;
+                    header->log = pieces;
+                }
+            }
+        }
+
+        /* Get program name size */
+        if (header->program_name) {
+            header->p_name_size = strlen(header->program_name);
+        }
+    }
+
+    /* xferlog date format
+     * Mon Apr 17 18:27:14 2006 1 64.160.42.130
+     */
+    else if ((loglen > 28) &&
+             (pieces[3] == ' ') &&
+             (pieces[7] == ' ') &&
+             (pieces[10] == ' ') &&
+             (pieces[13] == ':') &&
+             (pieces[16] == ':') &&
+             (pieces[19] == ' ') &&
+             (pieces[24] == ' ') &&
+             (pieces[26] == ' ')) {
+        /* Move log to the beginning of the message */
+        header->log += 25;
+        header->dec_timestamp = copy;
+        header->log[-1] = '\0';
+    }
+
+    /* Check for snort date format
+     * ex: 01/28-09:13:16.240702  [**]
+     */
+    else if ( (loglen > 24) &&
+              (pieces[2] == '/') &&
+              (pieces[5] == '-') &&
+              (pieces[8] == ':') &&
+              (pieces[11] == ':') &&
+              (pieces[14] == '.') &&
+              (pieces[21] == ' ') ) {
+        header->log += 23;
+        header->dec_timestamp = copy;
+        header->log[-2] = '\0';
+    }
+
+    /* Check for suricata (new) date format
+     * ex: 01/28/1979-09:13:16.240702  [**]
+     */
+    else if ( (loglen > 26) &&
+              (pieces[2] == '/') &&
+              (pieces[5] == '/') &&
+              (pieces[10] == '-') &&
+              (pieces[13] == ':') &&
+              (pieces[16] == ':') &&
+              (pieces[19] == '.') &&
+              (pieces[26] == ' ') ) {
+        header->log += 28;
+        header->dec_timestamp = copy;
+        header->log[-2] = '\0';
+    }
+
+
+    /* Check for apache log format */
+    /* [Fri Feb 11 18:06:35 2004] [warn] */
+    else if ( (loglen > 27) &&
+              (pieces[0] == '[') &&
+              (pieces[4] == ' ') &&
+              (pieces[8] == ' ') &&
+              (pieces[11] == ' ') &&
+              (pieces[14] == ':') &&
+              (pieces[17] == ':') &&
+              (pieces[20] == ' ') &&
+              (pieces[25] == ']') ) {
+        header->log += 27;
+        header->dec_timestamp = copy + 1;
+        header->log[-2] = '\0';
+    }
+
+    /* Check for the osx asl log format.
+     * Examples:
+     * [Time 2006.12.28 15:53:55 UTC] [Facility auth] [Sender sshd] [PID 483] [Message error: PAM: Authentication failure for username from 192.168.0.2] [Level 3] [UID -2] [GID -2] [Host Hostname]
+     * [Time 2006.11.02 14:02:11 UTC] [Facility auth] [Sender sshd] [PID 856]
+     [Message refused connect from 59.124.44.34] [Level 4] [UID -2] [GID -2]
+     [Host robert-wyatts-emac]
+     */
+    else if ((loglen > 26) &&
+             (pieces[0] == '[')  &&
+             (pieces[1] == 'T')  &&
+             (pieces[5] == ' ')  &&
+             (pieces[10] == '.') &&
+             (pieces[13] == '.') &&
+             (pieces[16] == ' ') &&
+             (pieces[19] == ':')) {
+        /* Do not read more than 1 message entry -> log tampering */
+        short unsigned int done_message = 0;
+
+        /* Remove the date */
+        header->log += 25;
+
+        /* Get the desired values */
+        pieces = strchr(header->log, '[');
+        while (pieces) {
+            pieces++;
+
+            /* Get the sender (set to program name) */
+            if ((strncmp(pieces, "Sender ", 7) == 0) &&
+                    (header->program_name == NULL)) {
+                pieces += 7;
+                header->program_name = pieces;
+
+                /* Get the closing brackets */
+                pieces = strchr(pieces, ']');
+                if (pieces) {
+                    *pieces = '\0';
+
+                    /* Set program_name size */
+                    header->p_name_size = strlen(header->program_name);
+
+                    pieces++;
+                }
+                /* Invalid program name */
+                else {
+                    header->program_name = NULL;
+                    break;
+                }
+            }
+
+            /* Get message */
+            else if ((strncmp(pieces, "Message ", 8) == 0) &&
+                     (done_message == 0)) {
+                pieces += 8;
+                done_message = 1;
+
+                header->log = pieces;
+
+                /* Get the closing brackets */
+                pieces = strchr(pieces, ']');
+                if (pieces) {
+                    *pieces = '\0';
+                    pieces++;
+                }
+                /* Invalid log closure */
+                else {
+                    break;
+                }
+            }
+
+            /* Get hostname */
+            else if (strncmp(pieces, "Host ", 5) == 0) {
+                pieces += 5;
+                header->hostname = pieces;
+
+                /* Get the closing brackets */
+                pieces = strchr(pieces, ']');
+                if (pieces) {
+                    *pieces = '\0';
+                    pieces++;
+                }
+
+                /* Invalid hostname */
+                else {
+                    header->hostname = NULL;
+                }
+                break;
+            }
+
+            /* Get next entry */
+            pieces = strchr(pieces, '[');
+        }
+    }
+
+    /* Check for squid date format
+     * 1140804070.368  11623
+     * seconds from 00:00:00 1970-01-01 UTC
+     */
+    else if ((loglen > 32) &&
+             (pieces[0] == '1') &&
+             (isdigit((int)pieces[1])) &&
+             (isdigit((int)pieces[2])) &&
+             (isdigit((int)pieces[3])) &&
+             (pieces[10] == '.') &&
+             (isdigit((int)pieces[13])) &&
+             (pieces[14] == ' ') &&
+             ((pieces[21] == ' ') || (pieces[22] == ' '))) {
+        header->log += 14;
+
+        /* We need to start at the size of the event */
+        while (*header->log == ' ') {
+            header->log++;
+        }
+
+        header->dec_timestamp = copy;
+        header->log[-1] = '\0';
+    }
+}
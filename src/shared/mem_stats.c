@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+/**
+ * @file mem_stats.c
+ * @brief Memory accounting per subsystem
+ */
+
+#include "shared.h"
+
+#ifdef __linux__
+#include <malloc.h>
+#endif
+
+size_t w_mem_size(const void * ptr) {
+#ifdef __linux__
+    return ptr ? malloc_usable_size((void *)ptr) : 0;
+#else
+    (void)ptr;
+    return 0;
+#endif
+}
+
+void w_mem_tag_alloc(w_mem_tag_t * tag, const void * ptr) {
+    w_mem_tag_add(tag, (int64_t)w_mem_size(ptr), 1);
+}
+
+void w_mem_tag_free(w_mem_tag_t * tag, const void * ptr) {
+    if (ptr) {
+        w_mem_tag_add(tag, -(int64_t)w_mem_size(ptr), -1);
+    }
+}
+
+void w_mem_tag_add(w_mem_tag_t * tag, int64_t bytes, int64_t allocations) {
+    tag->bytes += bytes;
+    tag->allocations += allocations;
+}
+
+cJSON * w_mem_tags_to_json(w_mem_tag_t * const * tags) {
+    cJSON * json = cJSON_CreateObject();
+
+    for (; *tags; tags++) {
+        cJSON * tag = cJSON_CreateObject();
+
+        cJSON_AddNumberToObject(tag, "bytes", (*tags)->bytes);
+        cJSON_AddNumberToObject(tag, "allocations", (*tags)->allocations);
+        cJSON_AddItemToObject(json, (*tags)->name, tag);
+    }
+
+    return json;
+}
+
+cJSON * w_mem_heap_to_json(void) {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = mallinfo2();
+    cJSON * json = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(json, "heap", info.arena);
+    cJSON_AddNumberToObject(json, "in_use", info.uordblks);
+    cJSON_AddNumberToObject(json, "free", info.fordblks);
+    cJSON_AddNumberToObject(json, "mmap", info.hblkhd);
+
+    return json;
+#elif defined(__GLIBC__)
+    /* mallinfo() counters are int: they wrap around over 2 GB */
+    struct mallinfo info = mallinfo();
+    cJSON * json = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(json, "heap", (unsigned int)info.arena);
+    cJSON_AddNumberToObject(json, "in_use", (unsigned int)info.uordblks);
+    cJSON_AddNumberToObject(json, "free", (unsigned int)info.fordblks);
+    cJSON_AddNumberToObject(json, "mmap", (unsigned int)info.hblkhd);
+
+    return json;
+#else
+    return NULL;
+#endif
+}
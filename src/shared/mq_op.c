@@ -23,6 +23,50 @@ int sock_fail_time;
 
 #ifndef WIN32
 
+#ifdef __linux__
+
+#define MQ_RINGS_MAX 64
+
+/* Rings announced through the connected queues, by socket */
+static struct {
+    int queue;
+    mq_ring_t * ring;
+} mq_rings[MQ_RINGS_MAX];
+static unsigned int mq_rings_size;
+static pthread_mutex_t mq_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int mq_rings_dropped;
+
+/**
+ * @brief Create a ring for a queue and announce it to the reader
+ *
+ * Only if the reader advertises the ring size, otherwise the queue keeps the socket.
+ *
+ * @param queue Socket connected to the queue.
+ */
+STATIC void mq_ring_open(int queue);
+
+/**
+ * @brief Release the ring of a queue being closed
+ *
+ * @param queue Socket connected to the queue.
+ */
+STATIC void mq_ring_release(int queue);
+
+/**
+ * @brief Send a message through the ring of a queue
+ *
+ * A full ring discards the message, like a busy socket. Sending it through the
+ * socket would put it before the events still in the ring.
+ *
+ * @param queue Socket connected to the queue.
+ * @param message Message to send.
+ * @retval 0 Message stored in the ring, or discarded because the ring is full.
+ * @retval -1 The message must go through the socket.
+ */
+STATIC int mq_ring_send(int queue, const char * message);
+
+#endif // __linux__
+
 /* Start the Message Queue with specific owner and permissions(Only for READ type). type: WRITE||READ */
 int StartMQWithSpecificOwnerAndPerms(const char *path, short int type, short int n_attempts, uid_t uid, gid_t gid, mode_t mode)
 {
@@ -51,6 +95,12 @@ int StartMQWithSpecificOwnerAndPerms(const char *path, short int type, short int
 
         mdebug1("Connected succesfully to '%s' after %d attempts", path, attempt);
         mdebug1(MSG_SOCKET_SIZE, OS_getsocketsize(rc));
+
+#ifdef __linux__
+        if (!strcmp(path, DEFAULTQUEUE)) {
+            mq_ring_open(rc);
+        }
+#endif
         return (rc);
     }
 }
@@ -74,6 +124,12 @@ int MQReconnectPredicated(const char *path, bool (*fn_ptr)()) {
 
     mdebug1(SUCCESSFULLY_RECONNECTED_SOCKET, path);
     mdebug1(MSG_SOCKET_SIZE, OS_getsocketsize(rc));
+
+#ifdef __linux__
+    if (!strcmp(path, DEFAULTQUEUE)) {
+        mq_ring_open(rc);
+    }
+#endif
     return (rc);
 }
 
@@ -115,10 +171,19 @@ STATIC int SendMSGAction(int queue, const char *message, const char *locmsg, cha
         return (-1);
     }
 
+#ifdef __linux__
+    if (__atomic_load_n(&mq_rings_size, __ATOMIC_ACQUIRE) > 0 && mq_ring_send(queue, tmpstr) == 0) {
+        return (0);
+    }
+#endif
+
     if ((__mq_rcode = OS_SendUnix(queue, tmpstr, 0)) < 0) {
         /* Error on the socket */
         if (__mq_rcode == OS_SOCKTERR) {
             merror("socketerr (not available).");
+#ifdef __linux__
+            mq_ring_release(queue);
+#endif
             close(queue);
             return (-1);
         }
@@ -157,13 +222,28 @@ int SendMSGtoSCK(int queue, const char *message, const char *locmsg, __attribute
     time_t mtime;
     char * _message = NULL;
     int retval = 0;
-
-    _message = log_builder_build(mq_log_builder, target->format, message, locmsg);
+    size_t prefix_len = 0;
+    bool agent = strcmp(target->log_socket->name, "agent") == 0;
 
     tmpstr[OS_MAXSTR] = '\0';
 
-    if (strcmp(target->log_socket->name, "agent") == 0) {
-        if(SendMSG(queue, _message, locmsg, loc) != 0) {
+    // The socket prefix goes before the message
+    if (!agent && target->log_socket->prefix && *target->log_socket->prefix) {
+        prefix_len = strlen(target->log_socket->prefix);
+        prefix_len = prefix_len < OS_MAXSTR ? prefix_len : OS_MAXSTR - 1;
+        memcpy(tmpstr, target->log_socket->prefix, prefix_len);
+    }
+
+    // Build the message after the prefix, without intermediate copies
+    if (target->compiled_format) {
+        log_builder_format(mq_log_builder, target->compiled_format, message, locmsg, tmpstr + prefix_len, OS_MAXSTR - prefix_len);
+    } else {
+        _message = log_builder_build(mq_log_builder, target->format, message, locmsg);
+        snprintf(tmpstr + prefix_len, OS_MAXSTR - prefix_len, "%s", _message);
+    }
+
+    if (agent) {
+        if(SendMSG(queue, tmpstr, locmsg, loc) != 0) {
             free(_message);
             return -1;
         }
@@ -186,13 +266,6 @@ int SendMSGtoSCK(int queue, const char *message, const char *locmsg, __attribute
             return -1;
         }
 
-        // create message and add prefix
-        if (target->log_socket->prefix && *target->log_socket->prefix) {
-            snprintf(tmpstr, OS_MAXSTR, "%s%s", target->log_socket->prefix, _message);
-        } else {
-            snprintf(tmpstr, OS_MAXSTR, "%s", _message);
-        }
-
         // Connect to socket if disconnected
         if (target->log_socket->socket < 0) {
             if (mtime = time(NULL), mtime > target->log_socket->last_attempt + sock_fail_time) {
@@ -243,6 +316,103 @@ int SendMSGtoSCK(int queue, const char *message, const char *locmsg, __attribute
     return (retval);
 }
 
+#ifdef __linux__
+
+STATIC void mq_ring_open(int queue) {
+    char announce[OS_SIZE_256];
+    char name[NAME_MAX];
+    mq_ring_t * ring;
+    size_t size = 0;
+    FILE * fp;
+
+    if (fp = fopen(MQ_RING_ADVERT, "r"), !fp) {
+        return;
+    }
+
+    if (fscanf(fp, "%zu", &size) != 1) {
+        size = 0;
+    }
+
+    fclose(fp);
+
+    if (size == 0) {
+        return;
+    }
+
+    // A socket number reused by a new connection
+    mq_ring_release(queue);
+
+    w_mutex_lock(&mq_rings_mutex);
+
+    if (mq_rings_size == MQ_RINGS_MAX || (ring = mq_ring_create(size, name, sizeof(name)), !ring)) {
+        w_mutex_unlock(&mq_rings_mutex);
+        return;
+    }
+
+    snprintf(announce, sizeof(announce), MQ_RING_HEADER "%s", name);
+
+    if (OS_SendUnix(queue, announce, 0) < 0) {
+        mdebug1("Couldn't announce the ring '%s'.", name);
+        mq_ring_close(ring);
+    } else {
+        mq_rings[mq_rings_size].queue = queue;
+        mq_rings[mq_rings_size].ring = ring;
+        __atomic_store_n(&mq_rings_size, mq_rings_size + 1, __ATOMIC_RELEASE);
+        mdebug1("Queue events announced through the ring '%s'.", name);
+    }
+
+    w_mutex_unlock(&mq_rings_mutex);
+}
+
+STATIC void mq_ring_release(int queue) {
+    unsigned int i;
+
+    w_mutex_lock(&mq_rings_mutex);
+
+    for (i = 0; i < mq_rings_size; i++) {
+        if (mq_rings[i].queue == queue) {
+            mq_ring_close(mq_rings[i].ring);
+            mq_rings[i] = mq_rings[mq_rings_size - 1];
+            __atomic_store_n(&mq_rings_size, mq_rings_size - 1, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+
+    w_mutex_unlock(&mq_rings_mutex);
+}
+
+STATIC int mq_ring_send(int queue, const char * message) {
+    int retval = -1;
+    unsigned int i;
+
+    w_mutex_lock(&mq_rings_mutex);
+
+    for (i = 0; i < mq_rings_size; i++) {
+        if (mq_rings[i].queue == queue) {
+            if (mq_ring_ready(mq_rings[i].ring)) {
+                if (mq_ring_push(mq_rings[i].ring, message, strlen(message)) < 0) {
+                    unsigned int dropped = ++mq_rings_dropped;
+
+                    mdebug2("Queue ring full, discarding message (%u discarded).", dropped);
+
+                    if (dropped == 1) {
+                        mwarn("Queue ring full, discarding message.");
+                    }
+                }
+
+                retval = 0;
+            }
+            break;
+        }
+    }
+
+    w_mutex_unlock(&mq_rings_mutex);
+
+    return retval;
+}
+
+#endif // __linux__
+
 #else
 
 int SendMSGtoSCK(int queue, const char *message, const char *locmsg, char loc, logtarget * targets) {
@@ -254,7 +424,13 @@ int SendMSGtoSCK(int queue, const char *message, const char *locmsg, char loc, l
         return -1;
     }
 
-    _message = log_builder_build(mq_log_builder, targets[0].format, message, locmsg);
+    if (targets[0].compiled_format) {
+        os_malloc(OS_MAXSTR, _message);
+        log_builder_format(mq_log_builder, targets[0].compiled_format, message, locmsg, _message, OS_MAXSTR);
+    } else {
+        _message = log_builder_build(mq_log_builder, targets[0].format, message, locmsg);
+    }
+
     retval = SendMSG(queue, _message, locmsg, loc);
     free(_message);
     return retval;
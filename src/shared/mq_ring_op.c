@@ -0,0 +1,293 @@
+/**
+ * @file mq_ring_op.c
+ * @brief Shared memory ring to send the events of a queue
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (C) 2015 Wazuh, Inc.
+ */
+
+/*
+ * This program is a free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <shared.h>
+
+#ifdef __linux__
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define MQ_RING_MAGIC   0x676e6972
+#define MQ_RING_MIN     (OS_MAXSTR * 2)     ///< Fits any message of the queue
+#define MQ_RING_FRAME   sizeof(uint32_t)
+
+/// Memory shared by the writer and the reader
+typedef struct {
+    uint32_t magic;
+    uint32_t size;              ///< Data size, a power of two
+    pid_t writer;               ///< Writer process
+    uint32_t attached;          ///< Set by the reader once it serves the ring
+    uint32_t closed;            ///< Set by the writer once it stops writing
+    uint32_t sleeping;          ///< The reader waits on the sequence
+    uint32_t sequence;          ///< Futex word, increased on every push
+    int64_t heartbeat;          ///< Last time the reader checked the ring
+    uint64_t head;              ///< Bytes written
+    uint64_t tail;              ///< Bytes read
+    char data[];
+} mq_ring_memory_t;
+
+struct mq_ring_t {
+    mq_ring_memory_t * memory;
+    size_t length;              ///< Length of the mapping
+    uint32_t size;              ///< Data size, the shared copy is only trusted at attach
+    pthread_mutex_t mutex;      ///< Serializes the writer threads
+    bool unlinked;              ///< The writer removed the name once attached
+    char name[NAME_MAX];
+};
+
+static void mq_ring_copy_in(mq_ring_t * ring, uint64_t offset, const void * src, size_t length) {
+    mq_ring_memory_t * memory = ring->memory;
+    size_t position = offset & (ring->size - 1);
+    size_t first = length < ring->size - position ? length : ring->size - position;
+
+    memcpy(memory->data + position, src, first);
+    memcpy(memory->data, (const char *)src + first, length - first);
+}
+
+static void mq_ring_copy_out(const mq_ring_t * ring, uint64_t offset, void * dst, size_t length) {
+    const mq_ring_memory_t * memory = ring->memory;
+    size_t position = offset & (ring->size - 1);
+    size_t first = length < ring->size - position ? length : ring->size - position;
+
+    memcpy(dst, memory->data + position, first);
+    memcpy((char *)dst + first, memory->data, length - first);
+}
+
+static mq_ring_t * mq_ring_map(const char * name, int fd, size_t length) {
+    mq_ring_t * ring;
+    void * memory;
+
+    if (memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0), memory == MAP_FAILED) {
+        mdebug1("Couldn't map the ring '%s': %s (%d)", name, strerror(errno), errno);
+        return NULL;
+    }
+
+    os_calloc(1, sizeof(mq_ring_t), ring);
+    ring->memory = memory;
+    ring->length = length;
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    w_mutex_init(&ring->mutex, NULL);
+
+    return ring;
+}
+
+static void mq_ring_free(mq_ring_t * ring) {
+    munmap(ring->memory, ring->length);
+    w_mutex_destroy(&ring->mutex);
+    os_free(ring);
+}
+
+mq_ring_t * mq_ring_create(size_t size, char * name, size_t name_size) {
+    static unsigned int counter;
+    mq_ring_t * ring;
+    size_t data_size = MQ_RING_MIN;
+    gid_t gid;
+    int fd;
+
+    while (data_size * 2 <= size && data_size * 2 <= UINT32_MAX / 2) {
+        data_size *= 2;
+    }
+
+    snprintf(name, name_size, "/wazuh-queue-%d-%u", (int)getpid(), __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+
+    if (fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0660), fd < 0) {
+        mdebug1("Couldn't create the ring '%s': %s (%d)", name, strerror(errno), errno);
+        return NULL;
+    }
+
+    // The reader may run as the Wazuh user
+    if (gid = Privsep_GetGroup(GROUPGLOBAL), gid != (gid_t)OS_INVALID && fchown(fd, (uid_t)-1, gid) < 0) {
+        mdebug1("Couldn't set the group of the ring '%s': %s (%d)", name, strerror(errno), errno);
+    }
+
+    if (ftruncate(fd, sizeof(mq_ring_memory_t) + data_size) < 0 ||
+        (ring = mq_ring_map(name, fd, sizeof(mq_ring_memory_t) + data_size), !ring)) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    close(fd);
+
+    ring->memory->size = ring->size = data_size;
+    ring->memory->writer = getpid();
+    __atomic_store_n(&ring->memory->magic, MQ_RING_MAGIC, __ATOMIC_RELEASE);
+
+    return ring;
+}
+
+bool mq_ring_ready(mq_ring_t * ring) {
+    mq_ring_memory_t * memory = ring->memory;
+
+    if (!__atomic_load_n(&memory->attached, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    // Only the owner can remove the name from the sticky directory
+    if (!ring->unlinked) {
+        shm_unlink(ring->name);
+        ring->unlinked = true;
+    }
+
+    return time(NULL) - __atomic_load_n(&memory->heartbeat, __ATOMIC_RELAXED) <= MQ_RING_TIMEOUT;
+}
+
+int mq_ring_push(mq_ring_t * ring, const char * msg, size_t length) {
+    mq_ring_memory_t * memory = ring->memory;
+    uint32_t frame = length;
+    uint64_t head;
+
+    if (length + MQ_RING_FRAME > ring->size) {
+        return -1;
+    }
+
+    w_mutex_lock(&ring->mutex);
+
+    head = memory->head;
+
+    if (ring->size - (head - __atomic_load_n(&memory->tail, __ATOMIC_ACQUIRE)) < length + MQ_RING_FRAME) {
+        w_mutex_unlock(&ring->mutex);
+        return -1;
+    }
+
+    mq_ring_copy_in(ring, head, &frame, MQ_RING_FRAME);
+    mq_ring_copy_in(ring, head + MQ_RING_FRAME, msg, length);
+    __atomic_store_n(&memory->head, head + MQ_RING_FRAME + length, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&memory->sequence, 1, __ATOMIC_SEQ_CST);
+
+    w_mutex_unlock(&ring->mutex);
+
+    // Wake the reader up only if it's waiting
+    if (__atomic_load_n(&memory->sleeping, __ATOMIC_SEQ_CST)) {
+        syscall(SYS_futex, &memory->sequence, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+
+    return 0;
+}
+
+void mq_ring_close(mq_ring_t * ring) {
+    __atomic_store_n(&ring->memory->closed, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &ring->memory->sequence, FUTEX_WAKE, 1, NULL, NULL, 0);
+
+    // The name is still there if no reader attached the ring
+    if (!ring->unlinked) {
+        shm_unlink(ring->name);
+    }
+
+    mq_ring_free(ring);
+}
+
+mq_ring_t * mq_ring_attach(const char * name) {
+    mq_ring_t * ring;
+    struct stat buf;
+    int fd;
+
+    if (fd = shm_open(name, O_RDWR, 0), fd < 0) {
+        mdebug1("Couldn't open the ring '%s': %s (%d)", name, strerror(errno), errno);
+        return NULL;
+    }
+
+    if (fstat(fd, &buf) < 0 || (size_t)buf.st_size < sizeof(mq_ring_memory_t) + MQ_RING_MIN) {
+        mdebug1("Invalid ring '%s'.", name);
+        close(fd);
+        return NULL;
+    }
+
+    ring = mq_ring_map(name, fd, buf.st_size);
+    close(fd);
+
+    if (!ring) {
+        return NULL;
+    }
+
+    // The size is read once, the ring never trusts the shared copy again
+    if (__atomic_load_n(&ring->memory->magic, __ATOMIC_ACQUIRE) == MQ_RING_MAGIC) {
+        ring->size = ring->memory->size;
+    }
+
+    if (sizeof(mq_ring_memory_t) + ring->size != (size_t)buf.st_size || ring->size & (ring->size - 1)) {
+        mdebug1("Invalid ring '%s'.", name);
+        mq_ring_free(ring);
+        return NULL;
+    }
+
+    __atomic_store_n(&ring->memory->heartbeat, (int64_t)time(NULL), __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->memory->attached, 1, __ATOMIC_RELEASE);
+
+    return ring;
+}
+
+ssize_t mq_ring_pop(mq_ring_t * ring, char * buffer, size_t size, int timeout) {
+    mq_ring_memory_t * memory = ring->memory;
+    struct timespec ts = { timeout / 1000, (timeout % 1000) * 1000000 };
+    uint64_t tail = memory->tail;
+    uint64_t head;
+    uint32_t sequence;
+    uint32_t frame;
+    size_t length;
+
+    __atomic_store_n(&memory->heartbeat, (int64_t)time(NULL), __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&memory->head, __ATOMIC_ACQUIRE) == tail) {
+        if (__atomic_load_n(&memory->closed, __ATOMIC_ACQUIRE) || (kill(memory->writer, 0) < 0 && errno == ESRCH)) {
+            return __atomic_load_n(&memory->head, __ATOMIC_ACQUIRE) == tail ? -1 : 0;
+        }
+
+        __atomic_store_n(&memory->sleeping, 1, __ATOMIC_SEQ_CST);
+        sequence = __atomic_load_n(&memory->sequence, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&memory->head, __ATOMIC_SEQ_CST) == tail) {
+            syscall(SYS_futex, &memory->sequence, FUTEX_WAIT, sequence, &ts, NULL, 0);
+        }
+
+        __atomic_store_n(&memory->sleeping, 0, __ATOMIC_RELAXED);
+
+        if (__atomic_load_n(&memory->head, __ATOMIC_ACQUIRE) == tail) {
+            return 0;
+        }
+    }
+
+    // The writer publishes the frame and its message at once, anything else is a broken ring
+    head = __atomic_load_n(&memory->head, __ATOMIC_ACQUIRE);
+
+    if (head - tail > ring->size || head - tail < MQ_RING_FRAME) {
+        merror("Corrupted ring '%s'.", ring->name);
+        return -1;
+    }
+
+    mq_ring_copy_out(ring, tail, &frame, MQ_RING_FRAME);
+
+    if (frame > head - tail - MQ_RING_FRAME) {
+        merror("Corrupted ring '%s'.", ring->name);
+        return -1;
+    }
+
+    length = frame < size - 1 ? frame : size - 1;
+    mq_ring_copy_out(ring, tail + MQ_RING_FRAME, buffer, length);
+    buffer[length] = '\0';
+
+    __atomic_store_n(&memory->tail, tail + MQ_RING_FRAME + frame, __ATOMIC_RELEASE);
+
+    return length;
+}
+
+void mq_ring_detach(mq_ring_t * ring) {
+    __atomic_store_n(&ring->memory->attached, 0, __ATOMIC_RELEASE);
+    mq_ring_free(ring);
+}
+
+#endif // __linux__
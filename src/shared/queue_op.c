@@ -128,3 +128,136 @@ void * queue_pop_ex_timedwait(w_queue_t * queue, const struct timespec * abstime
 
     return data;
 }
+
+size_t queue_push_batch_ex(w_queue_t * queue, void ** data, size_t n) {
+    size_t i;
+
+    w_mutex_lock(&queue->mutex);
+
+    for (i = 0; i < n && queue_push(queue, data[i]) == 0; i++);
+
+    if (i == 1) {
+        w_cond_signal(&queue->available);
+    } else if (i > 1) {
+        w_cond_broadcast(&queue->available);
+    }
+
+    w_mutex_unlock(&queue->mutex);
+    return i;
+}
+
+size_t queue_push_batch_ex_block(w_queue_t * queue, void ** data, size_t n) {
+    size_t i = 0;
+
+    w_mutex_lock(&queue->mutex);
+
+    while (i < n) {
+        while (queue_full(queue)) {
+            w_cond_broadcast(&queue->available);
+            w_cond_wait(&queue->available_not_empty, &queue->mutex);
+        }
+
+        while (i < n && queue_push(queue, data[i]) == 0) {
+            i++;
+        }
+    }
+
+    w_cond_signal(&queue->available_not_empty);
+    w_cond_broadcast(&queue->available);
+    w_mutex_unlock(&queue->mutex);
+
+    return n;
+}
+
+/**
+ * @brief Moves up to max elements from the queue into data. Queue mutex must be held.
+ *
+ * @param queue the queue
+ * @param data output array
+ * @param max maximum number of elements to move
+ * @return number of elements moved
+ */
+static size_t queue_pop_batch(w_queue_t * queue, void ** data, size_t max) {
+    size_t i;
+
+    for (i = 0; i < max && (data[i] = queue_pop(queue)) != NULL; i++);
+
+    return i;
+}
+
+size_t queue_pop_batch_ex(w_queue_t * queue, void ** data, size_t max) {
+    size_t n;
+
+    w_mutex_lock(&queue->mutex);
+
+    while (n = queue_pop_batch(queue, data, max), n == 0) {
+        w_cond_wait(&queue->available, &queue->mutex);
+    }
+
+    if (queue->track_busy) {
+        queue->busy += n;
+    }
+
+    if (n == 1) {
+        w_cond_signal(&queue->available_not_empty);
+    } else {
+        w_cond_broadcast(&queue->available_not_empty);
+    }
+
+    w_mutex_unlock(&queue->mutex);
+
+    return n;
+}
+
+size_t queue_pop_batch_ex_timedwait(w_queue_t * queue, void ** data, size_t max, const struct timespec * abstime) {
+    size_t n;
+
+    w_mutex_lock(&queue->mutex);
+
+    while (n = queue_pop_batch(queue, data, max), n == 0) {
+        if (pthread_cond_timedwait(&queue->available, &queue->mutex, abstime) != 0) {
+            w_mutex_unlock(&queue->mutex);
+            return 0;
+        }
+    }
+
+    if (queue->track_busy) {
+        queue->busy += n;
+    }
+
+    if (n == 1) {
+        w_cond_signal(&queue->available_not_empty);
+    } else {
+        w_cond_broadcast(&queue->available_not_empty);
+    }
+
+    w_mutex_unlock(&queue->mutex);
+
+    return n;
+}
+
+void queue_track_busy(w_queue_t * queue) {
+    w_mutex_lock(&queue->mutex);
+    queue->track_busy = 1;
+    w_mutex_unlock(&queue->mutex);
+}
+
+void queue_done(w_queue_t * queue, size_t n) {
+    w_mutex_lock(&queue->mutex);
+
+    if (queue->track_busy) {
+        queue->busy = queue->busy > n ? queue->busy - n : 0;
+    }
+
+    w_mutex_unlock(&queue->mutex);
+}
+
+int queue_idle(w_queue_t * queue) {
+    int idle;
+
+    w_mutex_lock(&queue->mutex);
+    idle = queue_empty(queue) && queue->busy == 0;
+    w_mutex_unlock(&queue->mutex);
+
+    return idle;
+}
@@ -0,0 +1,141 @@
+/*
+ * Weighted priority queue
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <shared.h>
+
+w_prio_queue_t * prio_queue_init(const size_t sizes[PRIO_QUEUE_CLASSES], const unsigned int weights[PRIO_QUEUE_CLASSES]) {
+    w_prio_queue_t * queue;
+    os_calloc(1, sizeof(w_prio_queue_t), queue);
+
+    for (int i = 0; i < PRIO_QUEUE_CLASSES; i++) {
+        if (sizes[i] > 1) {
+            queue->classes[i] = queue_init(sizes[i]);
+            queue->weights[i] = weights[i] ? weights[i] : 1;
+            queue->total_weight += queue->weights[i];
+            queue->size += sizes[i];
+        }
+    }
+
+    w_mutex_init(&queue->mutex, NULL);
+    w_cond_init(&queue->available, NULL);
+    return queue;
+}
+
+void prio_queue_free(w_prio_queue_t * queue) {
+    if (queue) {
+        for (int i = 0; i < PRIO_QUEUE_CLASSES; i++) {
+            queue_free(queue->classes[i]);
+        }
+
+        w_mutex_destroy(&queue->mutex);
+        w_cond_destroy(&queue->available);
+        free(queue);
+    }
+}
+
+int prio_queue_full(const w_prio_queue_t * queue, unsigned int priority) {
+    return priority >= PRIO_QUEUE_CLASSES || queue->classes[priority] == NULL || queue_full(queue->classes[priority]);
+}
+
+int prio_queue_empty(const w_prio_queue_t * queue) {
+    return queue->elements == 0;
+}
+
+int prio_queue_push_ex(w_prio_queue_t * queue, unsigned int priority, void * data) {
+    int result = -1;
+
+    w_mutex_lock(&queue->mutex);
+
+    if (!prio_queue_full(queue, priority) && (result = queue_push(queue->classes[priority], data), result == 0)) {
+        queue->elements++;
+        w_cond_signal(&queue->available);
+    }
+
+    w_mutex_unlock(&queue->mutex);
+    return result;
+}
+
+/**
+ * @brief Moves up to max elements of a class into data. Queue mutex must be held.
+ *
+ * @param queue the priority queue
+ * @param priority class to pop from
+ * @param data output array
+ * @param max maximum number of elements to move
+ * @return number of elements moved
+ */
+static size_t prio_queue_pop_class(w_prio_queue_t * queue, unsigned int priority, void ** data, size_t max) {
+    size_t i = 0;
+
+    if (queue->classes[priority] != NULL) {
+        for (; i < max && (data[i] = queue_pop(queue->classes[priority])) != NULL; i++);
+    }
+
+    queue->elements -= i;
+    return i;
+}
+
+size_t prio_queue_pop_batch_ex(w_prio_queue_t * queue, void ** data, size_t max) {
+    size_t n = 0;
+    size_t share;
+    int i;
+
+    w_mutex_lock(&queue->mutex);
+
+    while (queue->elements == 0) {
+        w_cond_wait(&queue->available, &queue->mutex);
+    }
+
+    for (i = 0; i < PRIO_QUEUE_CLASSES && n < max; i++) {
+        if (queue->classes[i] != NULL) {
+            share = (max * queue->weights[i] + queue->total_weight - 1) / queue->total_weight;
+            n += prio_queue_pop_class(queue, i, data + n, share < max - n ? share : max - n);
+        }
+    }
+
+    for (i = 0; i < PRIO_QUEUE_CLASSES && n < max; i++) {
+        n += prio_queue_pop_class(queue, i, data + n, max - n);
+    }
+
+    if (queue->track_busy) {
+        queue->busy += n;
+    }
+
+    w_mutex_unlock(&queue->mutex);
+
+    return n;
+}
+
+void prio_queue_track_busy(w_prio_queue_t * queue) {
+    w_mutex_lock(&queue->mutex);
+    queue->track_busy = 1;
+    w_mutex_unlock(&queue->mutex);
+}
+
+void prio_queue_done(w_prio_queue_t * queue, size_t n) {
+    w_mutex_lock(&queue->mutex);
+
+    if (queue->track_busy) {
+        queue->busy = queue->busy > n ? queue->busy - n : 0;
+    }
+
+    w_mutex_unlock(&queue->mutex);
+}
+
+int prio_queue_idle(w_prio_queue_t * queue) {
+    int idle;
+
+    w_mutex_lock(&queue->mutex);
+    idle = queue->elements == 0 && queue->busy == 0;
+    w_mutex_unlock(&queue->mutex);
+
+    return idle;
+}
@@ -35,6 +35,7 @@ void sched_scan_init(sched_scan_config *scan_config){
     scan_config->time_start = 0;
     scan_config->next_scheduled_scan_time = 0;
     scan_config->daylight = -1;
+    scan_config->jittered = false;
 }
 
 /**
@@ -395,3 +396,195 @@ unsigned long int get_time_to_month_day(int month_day, const char* hour, int num
 
     return (unsigned long int) diff;
 }
+
+/* Scheduled jobs, shared by the modules of the process */
+
+#define SCHED_JOBS_DEFER_STEP   5       /* Seconds between the load checks of a deferred job */
+#define SCHED_JOBS_MAX_DEFER    300     /* Maximum time a job is deferred by the load      */
+
+typedef struct {
+    time_t due;             /* Scheduled time of the job                  */
+    unsigned long ticket;   /* Arrival order, to untie the jobs due at once */
+} sched_job_t;
+
+static pthread_mutex_t sched_jobs_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sched_jobs_cond = PTHREAD_COND_INITIALIZER;
+static sched_job_t * sched_jobs_heap;
+static unsigned int sched_jobs_pending;
+static unsigned int sched_jobs_capacity;
+static unsigned int sched_jobs_running;
+static unsigned long sched_jobs_tickets;
+static unsigned int sched_max_jobs;
+static unsigned int sched_max_jitter;
+static unsigned int sched_max_load;
+static int sched_nproc = 1;
+
+static bool _sched_job_before(const sched_job_t *a, const sched_job_t *b) {
+    return a->due < b->due || (a->due == b->due && a->ticket < b->ticket);
+}
+
+/**
+ * Adds a job to the heap of pending jobs
+ * */
+static void _sched_jobs_push(const sched_job_t *job) {
+    unsigned int i;
+
+    if (sched_jobs_pending == sched_jobs_capacity) {
+        sched_jobs_capacity = sched_jobs_capacity ? sched_jobs_capacity * 2 : 8;
+        os_realloc(sched_jobs_heap, sched_jobs_capacity * sizeof(sched_job_t), sched_jobs_heap);
+    }
+
+    for (i = sched_jobs_pending++; i > 0 && _sched_job_before(job, &sched_jobs_heap[(i - 1) / 2]); i = (i - 1) / 2) {
+        sched_jobs_heap[i] = sched_jobs_heap[(i - 1) / 2];
+    }
+
+    sched_jobs_heap[i] = *job;
+}
+
+/**
+ * Removes the first job of the heap of pending jobs
+ * */
+static void _sched_jobs_pop() {
+    sched_job_t last;
+    unsigned int i = 0;
+    unsigned int child;
+
+    if (sched_jobs_pending == 0) {
+        return;
+    }
+
+    last = sched_jobs_heap[--sched_jobs_pending];
+
+    while ((child = 2 * i + 1) < sched_jobs_pending) {
+        if (child + 1 < sched_jobs_pending && _sched_job_before(&sched_jobs_heap[child + 1], &sched_jobs_heap[child])) {
+            child++;
+        }
+
+        if (!_sched_job_before(&sched_jobs_heap[child], &last)) {
+            break;
+        }
+
+        sched_jobs_heap[i] = sched_jobs_heap[child];
+        i = child;
+    }
+
+    sched_jobs_heap[i] = last;
+}
+
+/**
+ * Delay of the jobs of a module, derived from the host name so that
+ * every agent runs its jobs at a different time, but always the same one
+ * */
+static unsigned int _sched_job_jitter(const char *MODULE_TAG) {
+    char hostname[OS_SIZE_256] = "";
+    unsigned int hash = 2166136261u;
+    const char *c;
+
+    if (sched_max_jitter == 0) {
+        return 0;
+    }
+
+    gethostname(hostname, sizeof(hostname) - 1);
+
+    // FNV-1a of the host name and the module tag
+    for (c = hostname; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+
+    for (c = MODULE_TAG; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+
+    return hash % (sched_max_jitter + 1);
+}
+
+/**
+ * Checks if the load average per CPU is above the limit
+ * */
+static bool _sched_job_overloaded() {
+#if defined(__linux__) || defined(__MACH__) || defined(FreeBSD) || defined(OpenBSD)
+    double load;
+
+    if (sched_max_load && getloadavg(&load, 1) == 1) {
+        return load * 100 > (double)sched_max_load * sched_nproc;
+    }
+#endif
+    return false;
+}
+
+void sched_scan_set_limits(unsigned int max_jobs, unsigned int max_jitter, unsigned int max_load) {
+    w_mutex_lock(&sched_jobs_mutex);
+    sched_max_jobs = max_jobs;
+    sched_max_jitter = max_jitter;
+    sched_max_load = max_load;
+    w_mutex_unlock(&sched_jobs_mutex);
+
+    if (max_load) {
+        sched_nproc = get_nproc();
+    }
+}
+
+void sched_scan_job_begin(sched_scan_config *config, const char *MODULE_TAG, bool jitter) {
+    sched_job_t job = { .due = config->next_scheduled_scan_time };
+    unsigned int delay = 0;
+    time_t deferred = 0;
+    struct timespec timeout;
+
+    if (jitter && !config->jittered) {
+        delay = _sched_job_jitter(MODULE_TAG);
+        config->jittered = true;
+    }
+
+    if (delay) {
+        mtdebug2(MODULE_TAG, "Delaying the scheduled job %u seconds.", delay);
+        w_time_delay(delay * 1000);
+    }
+
+    w_mutex_lock(&sched_jobs_mutex);
+    job.ticket = sched_jobs_tickets++;
+    _sched_jobs_push(&job);
+
+    while (true) {
+        bool first = sched_jobs_heap[0].ticket == job.ticket;
+
+        if (first && (!sched_max_jobs || sched_jobs_running < sched_max_jobs)) {
+            if (deferred >= SCHED_JOBS_MAX_DEFER || !_sched_job_overloaded()) {
+                break;
+            }
+
+            if (deferred == 0) {
+                mtdebug1(MODULE_TAG, "System load too high, deferring the scheduled job.");
+            }
+
+            // Wait for the load to fall, or for an earlier job
+            gettime(&timeout);
+            timeout.tv_sec += SCHED_JOBS_DEFER_STEP;
+            deferred += SCHED_JOBS_DEFER_STEP;
+            pthread_cond_timedwait(&sched_jobs_cond, &sched_jobs_mutex, &timeout);
+        } else {
+            if (first) {
+                mtdebug1(MODULE_TAG, "Waiting for %u scheduled jobs to finish.", sched_jobs_running);
+            }
+
+            w_cond_wait(&sched_jobs_cond, &sched_jobs_mutex);
+        }
+    }
+
+    _sched_jobs_pop();
+    sched_jobs_running++;
+
+    // The next job may have a slot too
+    w_cond_broadcast(&sched_jobs_cond);
+    w_mutex_unlock(&sched_jobs_mutex);
+}
+
+void sched_scan_job_end() {
+    w_mutex_lock(&sched_jobs_mutex);
+
+    if (sched_jobs_running > 0) {
+        sched_jobs_running--;
+    }
+
+    w_cond_broadcast(&sched_jobs_cond);
+    w_mutex_unlock(&sched_jobs_mutex);
+}
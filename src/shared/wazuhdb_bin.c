@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include "wazuhdb_bin.h"
+
+#ifdef WAZUH_UNIT_TESTING
+// Remove STATIC qualifier from tests
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/* Largest double that converts to int64 without loss */
+#define WDB_BIN_INT_LIMIT 9007199254740992.0
+
+STATIC ssize_t wdb_bin_encode_varint(char * buffer, size_t size, uint64_t value);
+STATIC ssize_t wdb_bin_decode_varint(const char * buffer, size_t length, uint64_t * value);
+STATIC ssize_t wdb_bin_encode_string(char * buffer, size_t size, const char * string);
+STATIC ssize_t wdb_bin_decode_string(char * buffer, size_t length, char ** string, size_t * string_len);
+STATIC ssize_t wdb_bin_decode_value(char * buffer, size_t length, cJSON ** value, int depth);
+
+bool wdb_bin_is_binary(const char * buffer, size_t length) {
+    return buffer != NULL && length >= WDB_BIN_HEADER_SIZE && buffer[0] == WDB_BIN_MAGIC;
+}
+
+int wdb_bin_get_command(const char * buffer) {
+    return (unsigned char)buffer[1] == WDB_BIN_VERSION ? (unsigned char)buffer[2] : OS_INVALID;
+}
+
+STATIC ssize_t wdb_bin_encode_varint(char * buffer, size_t size, uint64_t value) {
+    size_t i = 0;
+
+    do {
+        if (i == size) {
+            return OS_INVALID;
+        }
+
+        buffer[i++] = (char)((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+        value >>= 7;
+    } while (value);
+
+    return i;
+}
+
+STATIC ssize_t wdb_bin_decode_varint(const char * buffer, size_t length, uint64_t * value) {
+    *value = 0;
+
+    for (size_t i = 0; i < length && i < 10; i++) {
+        *value |= (uint64_t)((unsigned char)buffer[i] & 0x7F) << (7 * i);
+
+        if (!((unsigned char)buffer[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+
+    return OS_INVALID;
+}
+
+STATIC ssize_t wdb_bin_encode_string(char * buffer, size_t size, const char * string) {
+    size_t string_len = strlen(string);
+    ssize_t n;
+
+    if (n = wdb_bin_encode_varint(buffer, size, string_len), n < 0 || size - n < string_len) {
+        return OS_INVALID;
+    }
+
+    memcpy(buffer + n, string, string_len);
+    return n + string_len;
+}
+
+ssize_t wdb_bin_encode_json(char * buffer, size_t size, const cJSON * value) {
+    ssize_t length = 1;
+    ssize_t n;
+    cJSON * item;
+
+    if (size == 0) {
+        return OS_INVALID;
+    }
+
+    switch (value->type & 0xFF) {
+    case cJSON_NULL:
+        *buffer = WDB_BIN_NULL;
+        break;
+
+    case cJSON_False:
+        *buffer = WDB_BIN_FALSE;
+        break;
+
+    case cJSON_True:
+        *buffer = WDB_BIN_TRUE;
+        break;
+
+    case cJSON_Number:
+        if (value->valuedouble > -WDB_BIN_INT_LIMIT && value->valuedouble < WDB_BIN_INT_LIMIT &&
+            value->valuedouble == (double)(int64_t)value->valuedouble) {
+            int64_t integer = (int64_t)value->valuedouble;
+
+            *buffer = WDB_BIN_INT;
+            if (n = wdb_bin_encode_varint(buffer + 1, size - 1, ((uint64_t)integer << 1) ^ (uint64_t)(integer >> 63)), n < 0) {
+                return OS_INVALID;
+            }
+            length += n;
+        } else {
+            uint64_t bits;
+
+            if (size < 9) {
+                return OS_INVALID;
+            }
+
+            *buffer = WDB_BIN_DOUBLE;
+            memcpy(&bits, &value->valuedouble, sizeof(bits));
+            for (int i = 0; i < 8; i++) {
+                buffer[1 + i] = (char)(bits >> (8 * i));
+            }
+            length += 8;
+        }
+        break;
+
+    case cJSON_String:
+        *buffer = WDB_BIN_STRING;
+        if (n = wdb_bin_encode_string(buffer + 1, size - 1, value->valuestring), n < 0) {
+            return OS_INVALID;
+        }
+        length += n;
+        break;
+
+    case cJSON_Array:
+    case cJSON_Object:
+        *buffer = cJSON_IsArray(value) ? WDB_BIN_ARRAY : WDB_BIN_OBJECT;
+        if (n = wdb_bin_encode_varint(buffer + length, size - length, cJSON_GetArraySize(value)), n < 0) {
+            return OS_INVALID;
+        }
+        length += n;
+
+        cJSON_ArrayForEach(item, value) {
+            if (*buffer == WDB_BIN_OBJECT) {
+                if (n = wdb_bin_encode_string(buffer + length, size - length, item->string), n < 0) {
+                    return OS_INVALID;
+                }
+                length += n;
+            }
+
+            if (n = wdb_bin_encode_json(buffer + length, size - length, item), n < 0) {
+                return OS_INVALID;
+            }
+            length += n;
+        }
+        break;
+
+    default:
+        return OS_INVALID;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Decode a string, without terminating it
+ *
+ * @param buffer Input buffer, pointing to the length of the string.
+ * @param length Length of the input.
+ * @param string Output string, pointing into the buffer.
+ * @param string_len Length of the string.
+ * @return Bytes read, or OS_INVALID if the input is truncated.
+ */
+STATIC ssize_t wdb_bin_decode_string(char * buffer, size_t length, char ** string, size_t * string_len) {
+    uint64_t value;
+    ssize_t n;
+
+    if (n = wdb_bin_decode_varint(buffer, length, &value), n < 0 || value > length - n) {
+        return OS_INVALID;
+    }
+
+    *string = buffer + n;
+    *string_len = value;
+
+    return n + value;
+}
+
+STATIC ssize_t wdb_bin_decode_value(char * buffer, size_t length, cJSON ** value, int depth) {
+    ssize_t offset = 1;
+    ssize_t n;
+    uint64_t count;
+    char * string;
+    size_t string_len;
+    char saved;
+
+    *value = NULL;
+
+    if (length == 0 || depth > WDB_BIN_MAX_DEPTH) {
+        return OS_INVALID;
+    }
+
+    switch (*buffer) {
+    case WDB_BIN_NULL:
+        *value = cJSON_CreateNull();
+        break;
+
+    case WDB_BIN_FALSE:
+        *value = cJSON_CreateFalse();
+        break;
+
+    case WDB_BIN_TRUE:
+        *value = cJSON_CreateTrue();
+        break;
+
+    case WDB_BIN_INT:
+        if (n = wdb_bin_decode_varint(buffer + 1, length - 1, &count), n < 0) {
+            return OS_INVALID;
+        }
+        *value = cJSON_CreateNumber((double)(int64_t)((count >> 1) ^ -(count & 1)));
+        offset += n;
+        break;
+
+    case WDB_BIN_DOUBLE: {
+        uint64_t bits = 0;
+        double real;
+
+        if (length < 9) {
+            return OS_INVALID;
+        }
+
+        for (int i = 0; i < 8; i++) {
+            bits |= (uint64_t)(unsigned char)buffer[1 + i] << (8 * i);
+        }
+        memcpy(&real, &bits, sizeof(real));
+        *value = cJSON_CreateNumber(real);
+        offset += 8;
+        break;
+    }
+
+    case WDB_BIN_STRING:
+        if (n = wdb_bin_decode_string(buffer + 1, length - 1, &string, &string_len), n < 0) {
+            return OS_INVALID;
+        }
+
+        saved = string[string_len];
+        string[string_len] = '\0';
+        *value = cJSON_CreateString(string);
+        string[string_len] = saved;
+        offset += n;
+        break;
+
+    case WDB_BIN_ARRAY:
+    case WDB_BIN_OBJECT:
+        if (n = wdb_bin_decode_varint(buffer + 1, length - 1, &count), n < 0 || count > length) {
+            return OS_INVALID;
+        }
+        offset += n;
+        *value = *buffer == WDB_BIN_ARRAY ? cJSON_CreateArray() : cJSON_CreateObject();
+
+        for (uint64_t i = 0; i < count; i++) {
+            cJSON * item;
+
+            if (*buffer == WDB_BIN_OBJECT) {
+                if (n = wdb_bin_decode_string(buffer + offset, length - offset, &string, &string_len), n < 0) {
+                    goto error;
+                }
+                offset += n;
+            }
+
+            if (n = wdb_bin_decode_value(buffer + offset, length - offset, &item, depth + 1), n < 0) {
+                goto error;
+            }
+            offset += n;
+
+            if (*buffer == WDB_BIN_OBJECT) {
+                /* The key is terminated once its value, that follows it, is decoded */
+                saved = string[string_len];
+                string[string_len] = '\0';
+                cJSON_AddItemToObject(*value, string, item);
+                string[string_len] = saved;
+            } else {
+                cJSON_AddItemToArray(*value, item);
+            }
+        }
+        break;
+
+    default:
+        return OS_INVALID;
+    }
+
+    return offset;
+
+error:
+    cJSON_Delete(*value);
+    *value = NULL;
+    return OS_INVALID;
+}
+
+ssize_t wdb_bin_decode_json(char * buffer, size_t length, cJSON ** value) {
+    return wdb_bin_decode_value(buffer, length, value, 0);
+}
+
+ssize_t wdb_bin_encode_dbsync(char * buffer, size_t size, int agent_id, const char * table, const char * operation, const cJSON * data) {
+    ssize_t length = WDB_BIN_HEADER_SIZE;
+    ssize_t n;
+
+    if (size < WDB_BIN_HEADER_SIZE) {
+        return OS_INVALID;
+    }
+
+    buffer[0] = WDB_BIN_MAGIC;
+    buffer[1] = WDB_BIN_VERSION;
+    buffer[2] = WDB_BIN_DBSYNC;
+
+    if (n = wdb_bin_encode_varint(buffer + length, size - length, agent_id), n < 0) {
+        return OS_INVALID;
+    }
+    length += n;
+
+    if (n = wdb_bin_encode_string(buffer + length, size - length, table), n < 0) {
+        return OS_INVALID;
+    }
+    length += n;
+
+    if (n = wdb_bin_encode_string(buffer + length, size - length, operation), n < 0) {
+        return OS_INVALID;
+    }
+    length += n;
+
+    if (n = wdb_bin_encode_json(buffer + length, size - length, data), n < 0) {
+        return OS_INVALID;
+    }
+
+    return length + n;
+}
+
+int wdb_bin_decode_dbsync(char * buffer, size_t length, wdb_bin_dbsync_t * msg) {
+    size_t offset = WDB_BIN_HEADER_SIZE;
+    ssize_t n;
+    uint64_t agent_id;
+    char * string;
+    size_t string_len;
+
+    msg->data = NULL;
+
+    if (n = wdb_bin_decode_varint(buffer + offset, length - offset, &agent_id), n < 0 || agent_id > INT_MAX) {
+        return OS_INVALID;
+    }
+    msg->agent_id = (int)agent_id;
+    offset += n;
+
+    if (n = wdb_bin_decode_string(buffer + offset, length - offset, &string, &string_len), n < 0) {
+        return OS_INVALID;
+    }
+    snprintf(msg->table, sizeof(msg->table), "%.*s", (int)string_len, string);
+    offset += n;
+
+    if (n = wdb_bin_decode_string(buffer + offset, length - offset, &string, &string_len), n < 0) {
+        return OS_INVALID;
+    }
+    snprintf(msg->operation, sizeof(msg->operation), "%.*s", (int)string_len, string);
+    offset += n;
+
+    if (n = wdb_bin_decode_json(buffer + offset, length - offset, &msg->data), n < 0) {
+        return OS_INVALID;
+    }
+
+    if (offset + n != length || !cJSON_IsObject(msg->data)) {
+        cJSON_Delete(msg->data);
+        msg->data = NULL;
+        return OS_INVALID;
+    }
+
+    return OS_SUCCESS;
+}
@@ -59,13 +59,31 @@ int wdbc_connect() {
  * @retval 0 Success.
  */
 int wdbc_query(const int sock, const char *query, char *response, const int len) {
+    return wdbc_query_bin(sock, query, strlen(query) + 1, response, len);
+}
+
+
+/**
+ * @brief Sends a message of a given size to Wazuh-DB and stores the response.
+ *
+ * This allows sending binary messages, that may contain null bytes.
+ *
+ * @param[in] sock Client socket descriptor.
+ * @param[in] query Message to be sent to Wazuh-DB.
+ * @param[in] size Size of the message.
+ * @param[out] response Char pointer where the response from Wazuh-DB will be stored.
+ * @param[in] len Lenght of the response param.
+ * @retval -2 Error in the communication.
+ * @retval -1 Error in the response from socket.
+ * @retval 0 Success.
+ */
+int wdbc_query_bin(const int sock, const char *query, size_t size, char *response, const int len) {
 
-    int size = strlen(query);
     int retval = -2;
     ssize_t recv_len;
 
     // Send query to Wazuh DB
-    if (OS_SendSecureTCP(sock, size + 1, query) != 0) {
+    if (OS_SendSecureTCP(sock, size, query) != 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             merror("database socket is full");
             goto end;
@@ -111,6 +129,23 @@ end:
  * @retval 0 Success.
  */
 int wdbc_query_ex(int *sock, const char *query, char *response, const int len) {
+    return wdbc_query_bin_ex(sock, query, strlen(query) + 1, response, len);
+}
+
+
+/**
+ * @brief Check connection to Wazuh-DB, sends a message of a given size and stores the response.
+ *
+ * @param[in] sock Pointer to the client socket descriptor.
+ * @param[in] query Message to be sent to Wazuh-DB.
+ * @param[in] size Size of the message.
+ * @param[out] response Char pointer where the response from Wazuh-DB will be stored.
+ * @param[in] len Lenght of the response param.
+ * @retval -2 Error in the communication.
+ * @retval -1 Error in the response from socket.
+ * @retval 0 Success.
+ */
+int wdbc_query_bin_ex(int *sock, const char *query, size_t size, char *response, const int len) {
 
     int retval = -2;
 
@@ -126,7 +161,7 @@ int wdbc_query_ex(int *sock, const char *query, char *response, const int len) {
     }
 
     // Send query to Wazuh DB
-    if (retval = wdbc_query(*sock, query, response, len), retval != 0) {
+    if (retval = wdbc_query_bin(*sock, query, size, response, len), retval != 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             merror("database socket is full");
             return retval;
@@ -138,7 +173,7 @@ int wdbc_query_ex(int *sock, const char *query, char *response, const int len) {
                 return retval;
             }
             // Send query
-            if (retval = wdbc_query(*sock, query, response, len), retval != 0) {
+            if (retval = wdbc_query_bin(*sock, query, size, response, len), retval != 0) {
                 return retval;
             }
         } else {
@@ -151,6 +186,148 @@ int wdbc_query_ex(int *sock, const char *query, char *response, const int len) {
 }
 
 
+/**
+ * @brief Check connection to Wazuh-DB and sends a query without waiting for the response.
+ *
+ * Wazuh-DB answers the queries of a connection in order, so the responses can be read
+ * later with wdbc_recv().
+ *
+ * @param[in] sock Pointer to the client socket descriptor.
+ * @param[in] query Query to be sent to Wazuh-DB.
+ * @post On error the socket is closed and set to -1: the pending responses are lost.
+ * @retval -2 Error in the communication.
+ * @retval 0 Success.
+ */
+int wdbc_send_ex(int *sock, const char *query) {
+
+    // Connect to socket if disconnected
+    if (*sock < 0) {
+        if (*sock = wdbc_connect(), *sock < 0) {
+            merror("Unable to connect to socket '%s'.", WDB_LOCAL_SOCK);
+            return -2;
+        }
+    }
+
+    if (OS_SendSecureTCP(*sock, strlen(query) + 1, query) != 0) {
+        if (errno == EPIPE) {
+            merror("Connection with wazuh-db lost.");
+        } else {
+            merror("Cannot send message: (%d) '%s'.", errno, strerror(errno));
+        }
+
+        wdbc_close(sock);
+        return -2;
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Receive the response of a query sent with wdbc_send_ex().
+ *
+ * @param[in] sock Client socket descriptor.
+ * @param[out] response Char pointer where the response from Wazuh-DB will be stored.
+ * @param[in] len Lenght of the response param.
+ * @post This function will null-terminate response, the last byte may be truncated.
+ * @retval -1 Error in the response from socket.
+ * @retval 0 Success.
+ */
+int wdbc_recv(const int sock, char *response, const int len) {
+
+    switch (OS_RecvSecureTCP(sock, response, len)) {
+    case OS_SOCKTERR:
+        merror("Cannot receive message: response size is bigger than expected");
+        return -1;
+    case -1:
+        merror("Cannot receive message: %s (%d)", strerror(errno), errno);
+        return -1;
+    case 0:
+        merror("Cannot receive message: the connection was closed");
+        return -1;
+    }
+
+    response[len - 1] = '\0';
+    return 0;
+}
+
+
+/**
+ * @brief Drop the pending responses of a broken pipeline.
+ *
+ * @param pipeline Pipeline of the lost connection.
+ * @return Number of dropped responses.
+ */
+static int wdbc_pipeline_drop(wdbc_pipeline *pipeline) {
+    int dropped = pipeline->pending;
+
+    if (dropped > 0) {
+        pipeline->dropped += dropped;
+        mwarn("%s: Connection to the database lost, %d responses dropped (%u in total).", pipeline->name, dropped, pipeline->dropped);
+    }
+
+    pipeline->pending = 0;
+    return dropped;
+}
+
+
+int wdbc_pipeline_send(int *sock, wdbc_pipeline *pipeline, const char *query) {
+    bool connected = *sock >= 0;
+    int failed = 0;
+
+    // Wait for the oldest response when the pipeline is full
+    if (pipeline->pending >= pipeline->size) {
+        failed += wdbc_pipeline_recv(sock, pipeline, pipeline->size > 0 ? pipeline->size - 1 : 0);
+    }
+
+    if (wdbc_send_ex(sock, query) != 0) {
+        // The responses of the lost connection won't arrive, retry with a new one
+        failed += wdbc_pipeline_drop(pipeline);
+
+        if (!connected || wdbc_send_ex(sock, query) != 0) {
+            merror("%s: Cannot communicate with database.", pipeline->name);
+            return failed + 1;
+        }
+    }
+
+    pipeline->pending++;
+    return failed;
+}
+
+
+int wdbc_pipeline_recv(int *sock, wdbc_pipeline *pipeline, unsigned int keep) {
+    char *response;
+    char *arg;
+    int failed = 0;
+
+    if (pipeline->pending <= keep) {
+        return 0;
+    }
+
+    os_malloc(OS_MAXSTR, response);
+
+    while (pipeline->pending > keep) {
+        if (wdbc_recv(*sock, response, OS_MAXSTR) != 0) {
+            merror("%s: Cannot get response from database.", pipeline->name);
+            // The stream is out of sync, the remaining responses are discarded
+            wdbc_close(sock);
+            failed += wdbc_pipeline_drop(pipeline);
+            break;
+        }
+
+        pipeline->pending--;
+
+        if (wdbc_parse_result(response, &arg) == WDBC_ERROR && strcmp(arg, "Agent not found") != 0) {
+            merror("%s: Bad response from database: %s", pipeline->name, arg);
+            failed++;
+        }
+    }
+
+    free(response);
+    return failed;
+}
+
+
 /**
  * @brief Parse the result of the query to Wazuh-DB
  *
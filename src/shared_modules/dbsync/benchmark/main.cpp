@@ -0,0 +1,299 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include "json.hpp"
+#include "dbsync.hpp"
+#include "threadDispatcher.h"
+#include "benchmarkHelper.h"
+#include "tableShapes.h"
+
+constexpr auto TXN_QUEUE_SIZE { 4096 };
+constexpr uint64_t ROWS_BATCH_SIZE { 10000 };
+constexpr uint64_t DISPATCHER_MESSAGES { 200 * 1024 };
+
+static std::string s_dbPath { "dbsync_benchmark.db" };
+
+static std::unique_ptr<DBSync> createDatabase(const std::string& sqlStatement)
+{
+    std::remove(s_dbPath.c_str());
+    return std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, s_dbPath, sqlStatement);
+}
+
+/**
+ * @brief Feeds the rows [first, last) of the file_entry table to a transaction, as a FIM scan does.
+ *
+ * The rows are built in batches with the timing paused, so only dbsync_sync_txn_row is measured.
+ */
+static void syncFileEntries(Utils::BenchmarkState& state,
+                            DBSyncTxn& txn,
+                            const uint64_t first,
+                            const uint64_t last,
+                            const uint64_t modifiedEvery)
+{
+    std::vector<nlohmann::json> batch;
+
+    for (auto index { first }; index < last; index += ROWS_BATCH_SIZE)
+    {
+        const auto end { std::min(last, index + ROWS_BATCH_SIZE) };
+
+        state.pauseTiming();
+        batch.clear();
+
+        for (auto row { index }; row < end; ++row)
+        {
+            const auto version { modifiedEvery && row % modifiedEvery == 0 ? 1 : 0 };
+            batch.push_back({ {"table", FILE_ENTRY_TABLE}, {"data", nlohmann::json::array({ fileEntryRow(row, version) })} });
+        }
+
+        state.resumeTiming();
+
+        for (const auto& input : batch)
+        {
+            txn.syncTxnRow(input);
+        }
+    }
+}
+
+static void benchmarkSyncTxnRowInsert(Utils::BenchmarkState& state)
+{
+    const auto callback { [](ReturnTypeCallback, const nlohmann::json&) {} };
+
+    state.pauseTiming();
+    auto spDBSync { createDatabase(FILE_ENTRY_SQL_STATEMENT) };
+    state.resumeTiming();
+
+    {
+        DBSyncTxn txn { spDBSync->handle(), nlohmann::json{{"table", FILE_ENTRY_TABLE}}, 0, TXN_QUEUE_SIZE, callback };
+        syncFileEntries(state, txn, 0, state.range(), 0);
+        txn.getDeletedRows(callback);
+    }
+
+    state.addItemsProcessed(state.range());
+    state.pauseTiming();
+    spDBSync.reset();
+}
+
+static void benchmarkSyncTxnRowRescan(Utils::BenchmarkState& state)
+{
+    const auto callback { [](ReturnTypeCallback, const nlohmann::json&) {} };
+
+    // The database keeps the previous scan: 10% of the files changed and 1% were removed.
+    state.pauseTiming();
+    auto spDBSync { createDatabase(FILE_ENTRY_SQL_STATEMENT) };
+    {
+        Utils::BenchmarkState setup { state.range() };
+        DBSyncTxn txn { spDBSync->handle(), nlohmann::json{{"table", FILE_ENTRY_TABLE}}, 0, TXN_QUEUE_SIZE, callback };
+        syncFileEntries(setup, txn, 0, state.range(), 0);
+        txn.getDeletedRows(callback);
+    }
+    state.resumeTiming();
+
+    {
+        DBSyncTxn txn { spDBSync->handle(), nlohmann::json{{"table", FILE_ENTRY_TABLE}}, 0, TXN_QUEUE_SIZE, callback };
+        syncFileEntries(state, txn, state.range() / 100, state.range(), 10);
+        txn.getDeletedRows(callback);
+    }
+
+    state.addItemsProcessed(state.range());
+    state.pauseTiming();
+    spDBSync.reset();
+}
+
+static void benchmarkUpdateWithSnapshot(Utils::BenchmarkState& state)
+{
+    const auto rows { state.range() };
+    auto snapshot { nlohmann::json{{"table", PACKAGES_TABLE}, {"data", nlohmann::json::array()}} };
+    auto& data { snapshot.at("data") };
+
+    // Stored inventory, and a new one with 5% of the packages upgraded, 5% removed and 5% installed.
+    state.pauseTiming();
+    auto spDBSync { createDatabase(PACKAGES_SQL_STATEMENT) };
+
+    for (uint64_t index { 0 }; index < rows; ++index)
+    {
+        data.push_back(packageRow(index));
+    }
+
+    spDBSync->updateWithSnapshot(snapshot, [](ReturnTypeCallback, const nlohmann::json&) {});
+    data.clear();
+
+    for (uint64_t index { rows / 20 }; index < rows + rows / 20; ++index)
+    {
+        data.push_back(packageRow(index, index % 20 == 1 ? 1 : 0));
+    }
+
+    state.resumeTiming();
+
+    spDBSync->updateWithSnapshot(snapshot, [](ReturnTypeCallback, const nlohmann::json&) {});
+
+    state.addItemsProcessed(rows);
+    state.pauseTiming();
+    spDBSync.reset();
+}
+
+/**
+ * @brief Rate of the messages dispatched to \p threads workers, as the dbsync and rsync queues do.
+ *
+ * The range is the worker count for the unbounded push, and the queue size for the waiting push.
+ */
+template<typename Push>
+static void benchmarkDispatcher(Utils::BenchmarkState& state,
+                                const unsigned int threads,
+                                const size_t maxQueueSize,
+                                Push push)
+{
+    std::atomic<uint64_t> checksum { 0 };
+    std::vector<std::string> messages;
+
+    state.pauseTiming();
+
+    for (uint64_t index { 0 }; index < 1024; ++index)
+    {
+        messages.push_back(fileEntryRow(index).dump());
+    }
+
+    state.resumeTiming();
+
+    Utils::AsyncDispatcher<std::string, std::function<void(const std::string&)>> dispatcher
+    {
+        [&checksum](const std::string & message)
+        {
+            checksum += std::hash<std::string> {}(message);
+        },
+        threads,
+        maxQueueSize
+    };
+
+    push(dispatcher, messages);
+    dispatcher.rundown();
+
+    state.addItemsProcessed(DISPATCHER_MESSAGES);
+}
+
+static void benchmarkDispatcherPush(Utils::BenchmarkState& state)
+{
+    benchmarkDispatcher(state, state.range(), UNLIMITED_QUEUE_SIZE, [](auto & dispatcher, const auto & messages)
+    {
+        for (uint64_t index { 0 }; index < DISPATCHER_MESSAGES; ++index)
+        {
+            dispatcher.push(messages[index % messages.size()]);
+        }
+    });
+}
+
+static void benchmarkDispatcherPushBatch(Utils::BenchmarkState& state)
+{
+    benchmarkDispatcher(state, state.range(), UNLIMITED_QUEUE_SIZE, [](auto & dispatcher, const auto & messages)
+    {
+        for (uint64_t index { 0 }; index < DISPATCHER_MESSAGES; index += messages.size())
+        {
+            dispatcher.pushBatch(messages);
+        }
+    });
+}
+
+static void benchmarkDispatcherPushWait(Utils::BenchmarkState& state)
+{
+    benchmarkDispatcher(state, 4, state.range(), [](auto & dispatcher, const auto & messages)
+    {
+        for (uint64_t index { 0 }; index < DISPATCHER_MESSAGES; ++index)
+        {
+            dispatcher.pushWait(messages[index % messages.size()]);
+        }
+    });
+}
+
+static void showHelp()
+{
+    std::cout << "\nUsage: dbsync_benchmark <option(s)>\n"
+              << "Options:\n"
+              << "\t-h \t\t\tShow this help message\n"
+              << "\t-f FILTER\t\tRun only the benchmarks whose name contains FILTER.\n"
+              << "\t-m MAX_RANGE\t\tSkip the ranges (rows, threads or queue sizes) above MAX_RANGE.\n"
+              << "\t-t MIN_TIME\t\tMinimum seconds each range is measured (default 0, one iteration).\n"
+              << "\t-d DB_PATH\t\tDatabase file used by the benchmarks (default dbsync_benchmark.db).\n"
+              << "\t-j \t\t\tPrint the report as JSON.\n"
+              << "\nExample:"
+              << "\n\t./dbsync_benchmark -f SyncTxnRow -m 500000 -j\n"
+              << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    std::string filter;
+    uint64_t maxRange { 0 };
+    double minTime { 0 };
+    bool jsonFormat { false };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option { argv[i] };
+
+        if (option == "-j")
+        {
+            jsonFormat = true;
+        }
+        else if (i + 1 < argc && option == "-f")
+        {
+            filter = argv[++i];
+        }
+        else if (i + 1 < argc && option == "-m")
+        {
+            maxRange = std::stoull(argv[++i]);
+        }
+        else if (i + 1 < argc && option == "-t")
+        {
+            minTime = std::stod(argv[++i]);
+        }
+        else if (i + 1 < argc && option == "-d")
+        {
+            s_dbPath = argv[++i];
+        }
+        else
+        {
+            showHelp();
+            return option == "-h" ? 0 : 1;
+        }
+    }
+
+    try
+    {
+        Utils::BenchmarkRunner runner;
+
+        DBSync::initialize([](const std::string & msg)
+        {
+            std::cerr << msg << std::endl;
+        });
+
+        runner.add("BM_SyncTxnRowInsert/file_entry", { 10000, 100000, 500000, 2000000 }, benchmarkSyncTxnRowInsert);
+        runner.add("BM_SyncTxnRowRescan/file_entry", { 10000, 100000, 500000, 2000000 }, benchmarkSyncTxnRowRescan);
+        runner.add("BM_UpdateWithSnapshot/dbsync_packages", { 1000, 10000, 100000 }, benchmarkUpdateWithSnapshot);
+        runner.add("BM_AsyncDispatcherPush/threads", { 1, 2, 4, 8 }, benchmarkDispatcherPush);
+        runner.add("BM_AsyncDispatcherPushBatch/threads", { 1, 2, 4, 8 }, benchmarkDispatcherPushBatch);
+        runner.add("BM_AsyncDispatcherPushWait/queue_size", { 16, 256, 4096 }, benchmarkDispatcherPushWait);
+
+        runner.run(filter, maxRange, minTime, jsonFormat);
+
+        DBSync::teardown();
+        std::remove(s_dbPath.c_str());
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _DBSYNC_BENCHMARK_TABLE_SHAPES_H
+#define _DBSYNC_BENCHMARK_TABLE_SHAPES_H
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include "json.hpp"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+// Tables with the columns and keys used by FIM and syscollector, so the
+// benchmarks bind, hash and compare rows of the real sizes.
+
+constexpr auto FILE_ENTRY_TABLE { "file_entry" };
+
+constexpr auto FILE_ENTRY_SQL_STATEMENT
+{
+    R"(CREATE TABLE IF NOT EXISTS file_entry (
+    path TEXT NOT NULL,
+    mode INTEGER,
+    last_event INTEGER,
+    scanned INTEGER,
+    options INTEGER,
+    checksum TEXT NOT NULL,
+    dev INTEGER,
+    inode INTEGER,
+    size INTEGER,
+    perm TEXT,
+    attributes TEXT,
+    uid INTEGER,
+    gid INTEGER,
+    user_name TEXT,
+    group_name TEXT,
+    hash_md5 TEXT,
+    hash_sha1 TEXT,
+    hash_sha256 TEXT,
+    mtime INTEGER,
+    PRIMARY KEY(path)) WITHOUT ROWID;
+    CREATE INDEX IF NOT EXISTS path_index ON file_entry (path);
+    CREATE INDEX IF NOT EXISTS inode_index ON file_entry (dev, inode);)"
+};
+
+constexpr auto PACKAGES_TABLE { "dbsync_packages" };
+
+constexpr auto PACKAGES_SQL_STATEMENT
+{
+    R"(CREATE TABLE dbsync_packages(
+    name TEXT,
+    version TEXT,
+    vendor TEXT,
+    install_time TEXT,
+    location TEXT,
+    architecture TEXT,
+    groups TEXT,
+    description TEXT,
+    size INTEGER,
+    priority TEXT,
+    multiarch TEXT,
+    source TEXT,
+    format TEXT,
+    checksum TEXT,
+    item_id TEXT,
+    PRIMARY KEY (name,version,architecture)) WITHOUT ROWID;)"
+};
+
+/**
+ * @brief Fixed width hexadecimal digest, so every row has hashes of the real length.
+ */
+static std::string benchmarkDigest(const uint64_t seed, const size_t length)
+{
+    std::ostringstream digest;
+
+    for (uint64_t block = 0; block * 16 < length; ++block)
+    {
+        digest << std::hex << std::setw(16) << std::setfill('0') << (seed + block) * 0x9E3779B97F4A7C15ull;
+    }
+
+    return digest.str().substr(0, length);
+}
+
+/**
+ * @brief Key of the row \p index, zero padded so the order of the keys is the order of the rows.
+ */
+static std::string benchmarkKey(const std::string& prefix, const uint64_t index)
+{
+    std::ostringstream key;
+    key << prefix << std::setw(10) << std::setfill('0') << index;
+    return key.str();
+}
+
+/**
+ * @brief FIM file entry. Changing \p version changes the hashes, size and mtime of the file.
+ */
+static nlohmann::json fileEntryRow(const uint64_t index, const uint64_t version = 0)
+{
+    const auto seed { index * 31 + version };
+
+    return
+    {
+        {"path", benchmarkKey("/usr/share/benchmark/", index)},
+        {"mode", 0},
+        {"last_event", 1700000000 + version},
+        {"scanned", 1},
+        {"options", 131583},
+        {"checksum", benchmarkDigest(seed, 40)},
+        {"dev", 2049},
+        {"inode", 1000000 + index},
+        {"size", 4096 + seed % 65536},
+        {"perm", "rw-r--r--"},
+        {"attributes", ""},
+        {"uid", 0},
+        {"gid", 0},
+        {"user_name", "root"},
+        {"group_name", "root"},
+        {"hash_md5", benchmarkDigest(seed + 1, 32)},
+        {"hash_sha1", benchmarkDigest(seed + 2, 40)},
+        {"hash_sha256", benchmarkDigest(seed + 3, 64)},
+        {"mtime", 1690000000 + version}
+    };
+}
+
+/**
+ * @brief Syscollector package. Changing \p version changes the description, size and checksum.
+ */
+static nlohmann::json packageRow(const uint64_t index, const uint64_t version = 0)
+{
+    const auto seed { index * 31 + version };
+
+    return
+    {
+        {"name", benchmarkKey("package-", index)},
+        {"version", "1.2.3-4ubuntu0.1"},
+        {"vendor", "Ubuntu Developers <ubuntu-devel-discuss@lists.ubuntu.com>"},
+        {"install_time", "2023/06/01 10:00:00"},
+        {"location", " "},
+        {"architecture", "amd64"},
+        {"groups", "utils"},
+        {"description", "Benchmark package " + std::to_string(index) + " revision " + std::to_string(version)},
+        {"size", 1024 + seed % 8192},
+        {"priority", "optional"},
+        {"multiarch", "foreign"},
+        {"source", "benchmark"},
+        {"format", "deb"},
+        {"checksum", benchmarkDigest(seed, 40)},
+        {"item_id", benchmarkDigest(index, 40)}
+    };
+}
+
+#pragma GCC diagnostic pop
+
+#endif // _DBSYNC_BENCHMARK_TABLE_SHAPES_H
@@ -44,8 +44,8 @@ EXPORTED void dbsync_initialize(log_fnc_t log_function);
  * @brief Creates a new DBSync instance.
  *
  * @param host_type     Dynamic library host type to be used.
- * @param db_type       Database type to be used (currently only supported SQLITE3)
- * @param path          Path where the local database will be created.
+ * @param db_type       Database type to be used (SQLITE3 or MEMORY)
+ * @param path          Path where the local database will be created (unused by MEMORY).
  * @param sql_statement SQL sentence to create tables in a SQL engine.
  *
  * @return Handle instance to be used for common sql operations (cannot be used by more than 1 thread).
@@ -102,6 +102,24 @@ EXPORTED int dbsync_close_txn(const TXN_HANDLE txn);
 EXPORTED int dbsync_sync_txn_row(const TXN_HANDLE txn,
                                  const cJSON*     js_input);
 
+/**
+ * @brief Synchronizes the \p js_input data of several tables at once using
+ *  the \p txn current database transaction.
+ *
+ * @param txn      Database transaction to be used for \ref js_input data sync.
+ * @param js_input JSON array with one element per table, each one with the
+ *                 format used by \ref dbsync_sync_txn_row.
+ *
+ * @return 0 if succeeded,
+ *         specific error code (OS dependent) otherwise.
+ *
+ * @details The whole array crosses into the library and is parsed once, so the
+ *  rows should be grouped here instead of calling \ref dbsync_sync_txn_row
+ *  for each of them.
+ */
+EXPORTED int dbsync_sync_txn_rows(const TXN_HANDLE txn,
+                                  const cJSON*     js_input);
+
 /**
  * @brief Generates triggers that execute actions to maintain consistency between tables.
  *
@@ -140,6 +158,49 @@ EXPORTED int dbsync_set_table_max_rows(const DBSYNC_HANDLE handle,
                                        const char*         table,
                                        const long long     max_rows);
 
+/**
+ * @brief Gets the prepared statements cache counters of the database engine.
+ *
+ * @param handle    Handle assigned as part of the \ref dbsync_create method().
+ * @param js_result JSON with the prepared, reused and evicted statements count,
+ *                  the cached statements and the cache limit.
+ *
+ * @return 0 if succeeded,
+ *         specific error code (OS dependent) otherwise.
+ *
+ * @details The \p js_result resulting data should be freed using the \ref dbsync_free_result function.
+ */
+EXPORTED int dbsync_get_statement_cache_stats(const DBSYNC_HANDLE handle,
+                                              cJSON**             js_result);
+
+/**
+ * @brief Sets the memory used by the database engine to cache the data.
+ *
+ * @param handle Handle assigned as part of the \ref dbsync_create method().
+ * @param limit  Memory limit in bytes. The data that doesn't fit is kept in the
+ *               database file only. Zero restores the engine default.
+ *
+ * @return 0 if succeeded,
+ *         specific error code (OS dependent) otherwise.
+ */
+EXPORTED int dbsync_set_memory_limit(const DBSYNC_HANDLE      handle,
+                                     const unsigned long long limit);
+
+/**
+ * @brief Gets the memory and storage usage of the database engine.
+ *
+ * @param handle    Handle assigned as part of the \ref dbsync_create method().
+ * @param js_result JSON with the cache memory used and its limit, the database
+ *                  size and the cache hits, misses and spills.
+ *
+ * @return 0 if succeeded,
+ *         specific error code (OS dependent) otherwise.
+ *
+ * @details The \p js_result resulting data should be freed using the \ref dbsync_free_result function.
+ */
+EXPORTED int dbsync_get_storage_stats(const DBSYNC_HANDLE handle,
+                                      cJSON**             js_result);
+
 /**
  * @brief Inserts (or modifies) a database record.
  *
@@ -155,6 +216,25 @@ EXPORTED int dbsync_sync_row(const DBSYNC_HANDLE handle,
                              const cJSON*        js_input,
                              callback_data_t     callback_data);
 
+/**
+ * @brief Inserts (or modifies) the records of several tables at once.
+ *
+ * @param handle         Handle instance assigned as part of the \ref dbsync_create method().
+ * @param js_input       JSON array with one element per table, each one with the
+ *                       format used by \ref dbsync_sync_row.
+ * @param callback_data  This struct contains the result callback that will be called for each result
+ *                       and user data space returned in each callback call.
+ *
+ * @return 0 if succeeded,
+ *         specific error code (OS dependent) otherwise.
+ *
+ * @details The array is parsed once and synchronized under a single database
+ *  lock. Processing stops at the first failing element.
+ */
+EXPORTED int dbsync_sync_rows(const DBSYNC_HANDLE handle,
+                              const cJSON*        js_input,
+                              callback_data_t     callback_data);
+
 /**
  * @brief Select data, based in \p json_data_input data, from the database table.
  *
@@ -47,8 +47,8 @@ public:
      * @brief Explicit DBSync Constructor.
      *
      * @param hostType     Dynamic library host type to be used.
-     * @param dbType       Database type to be used (currently only supported SQLITE3)
-     * @param path         Path where the local database will be created.
+     * @param dbType       Database type to be used (SQLITE3 or MEMORY)
+     * @param path         Path where the local database will be created (unused by MEMORY).
      * @param sqlStatement SQL sentence to create tables in a SQL engine.
      *
      */
@@ -96,6 +96,44 @@ public:
     virtual void setTableMaxRow(const std::string& table,
                                 const long long    maxRows);
 
+    /**
+     * @brief Gets the prepared statements cache counters of the database engine.
+     *
+     * @param jsResult JSON with the prepared, reused and evicted statements count,
+     *                 the cached statements and the cache limit.
+     *
+     */
+    virtual void getStatementCacheStats(nlohmann::json& jsResult);
+
+    /**
+     * @brief Sets the memory used by the database engine to cache the data.
+     *
+     * @param limit Memory limit in bytes. The data that doesn't fit is kept in
+     *              the database file only. Zero restores the engine default.
+     *
+     */
+    virtual void setMemoryLimit(const unsigned long long limit);
+
+    /**
+     * @brief Gets the memory and storage usage of the database engine.
+     *
+     * @param jsResult JSON with the cache memory used and its limit, the database
+     *                 size and the cache hits, misses and spills.
+     *
+     */
+    virtual void getStorageStats(nlohmann::json& jsResult);
+
+    /**
+     * @brief Gets the number of rows of the \p table table.
+     *
+     * @param table Table name to count.
+     *
+     * @return Rows in the table. The tables with a max rows configuration are
+     *         counted as the rows are inserted and deleted, the rest are scanned.
+     *
+     */
+    virtual long long getTableRowCount(const std::string& table);
+
     /**
      * @brief Inserts (or modifies) a database record.
      *
@@ -106,6 +144,16 @@ public:
     virtual void syncRow(const nlohmann::json& jsInput,
                          ResultCallbackData    callbackData);
 
+    /**
+     * @brief Inserts (or modifies) the records of several tables at once.
+     *
+     * @param jsInput        JSON array with one \ref syncRow input per table.
+     * @param callbackData   Result callback(std::function) will be called for each result.
+     *
+     */
+    virtual void syncRows(const nlohmann::json& jsInput,
+                          ResultCallbackData    callbackData);
+
     /**
      * @brief Select data, based in \p jsInput data, from the database table.
      *
@@ -205,6 +253,14 @@ public:
      */
     virtual void syncTxnRow(const nlohmann::json& jsInput);
 
+    /**
+     * @brief Synchronizes the \p jsInput data of several tables at once.
+     *
+     * @param jsInput JSON array with one \ref syncTxnRow input per table.
+     *
+     */
+    virtual void syncTxnRows(const nlohmann::json& jsInput);
+
     /**
      * @brief Gets the deleted rows (diff) from the database.
      *
@@ -12,6 +12,7 @@
 #ifndef _DBENGINE_H
 #define _DBENGINE_H
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -19,8 +20,56 @@
 #include <shared_mutex>
 #include "json.hpp"
 #include "commonDefs.h"
+#include "db_exception.h"
 #include "abstractLocking.hpp"
 
+constexpr auto STATUS_FIELD_NAME {"db_status_field_dm"};
+constexpr auto STATUS_FIELD_TYPE {"INTEGER"};
+
+const std::vector<std::string> InternalColumnNames =
+{
+    { STATUS_FIELD_NAME }
+};
+
+enum ColumnType
+{
+    Unknown = 0,
+    Text,
+    Integer,
+    BigInt,
+    UnsignedBigInt,
+    Double,
+    Blob,
+};
+
+const std::map<std::string, ColumnType> ColumnTypeNames =
+{
+    { "UNKNOWN", Unknown        },
+    { "TEXT", Text           },
+    { "INTEGER", Integer        },
+    { "BIGINT", BigInt         },
+    { "UNSIGNED BIGINT", UnsignedBigInt },
+    { "DOUBLE", Double         },
+    { "BLOB", Blob           },
+};
+
+class dbengine_error : public DbSync::dbsync_error
+{
+    public:
+        explicit dbengine_error(const std::pair<int, std::string>& exceptionInfo)
+            : DbSync::dbsync_error
+        {
+            exceptionInfo.first, "dbEngine: " + exceptionInfo.second
+        }
+        {}
+};
+
+struct MaxRows final
+{
+    int64_t maxRows;
+    int64_t currentRows;
+};
+
 namespace DbSync
 {
     using ResultCallback = std::function<void(ReturnTypeCallback, const nlohmann::json&)>;
@@ -65,6 +114,14 @@ namespace DbSync
 
             virtual void addTableRelationship(const nlohmann::json& data) = 0;
 
+            virtual void getStatementCacheStats(nlohmann::json& stats) = 0;
+
+            virtual void setMemoryLimit(const uint64_t limit) = 0;
+
+            virtual void getStorageStats(nlohmann::json& stats) = 0;
+
+            virtual int64_t getTableRowCount(const std::string& table) = 0;
+
         protected:
             IDbEngine() = default;
     };
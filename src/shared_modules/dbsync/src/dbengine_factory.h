@@ -15,6 +15,7 @@
 #include "db_exception.h"
 #include "sqlite/sqlite_dbengine.h"
 #include "sqlite/sqlite_wrapper_factory.h"
+#include "memory/memory_dbengine.h"
 #include "commonDefs.h"
 #include <iostream>
 
@@ -32,6 +33,11 @@ namespace DbSync
                     return std::make_unique<SQLiteDBEngine>(std::make_shared<SQLiteFactory>(), path, sqlStatement);
                 }
 
+                if (MEMORY == dbType)
+                {
+                    return std::make_unique<MemoryDBEngine>(sqlStatement);
+                }
+
                 throw dbsync_error
                 {
                     FACTORY_INSTANTATION
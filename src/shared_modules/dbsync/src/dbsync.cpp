@@ -197,6 +197,42 @@ int dbsync_sync_txn_row(const TXN_HANDLE txn,
     return retVal;
 }
 
+int dbsync_sync_txn_rows(const TXN_HANDLE txn,
+                         const cJSON*     js_input)
+{
+    auto retVal { -1 };
+    std::string error_message;
+
+    if (!txn || !js_input)
+    {
+        error_message += "Invalid txn or json.";
+    }
+    else
+    {
+        try
+        {
+            const std::unique_ptr<char, CJsonSmartFree> spJsonBytes{cJSON_PrintUnformatted(js_input)};
+            PipelineFactory::instance().pipeline(txn)->syncRows(nlohmann::json::parse(spJsonBytes.get()));
+            retVal = 0;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            error_message += "DB error, id: " + std::to_string(ex.id()) + ". " + ex.what();
+            retVal = ex.id();
+        }
+        // LCOV_EXCL_START
+        catch (...)
+        {
+            error_message += "Unrecognized error.";
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    log_message(error_message);
+    return retVal;
+}
+
 int dbsync_add_table_relationship(const DBSYNC_HANDLE handle,
                                   const cJSON*        js_input)
 {
@@ -320,6 +356,118 @@ int dbsync_set_table_max_rows(const DBSYNC_HANDLE handle,
     return retVal;
 }
 
+int dbsync_get_statement_cache_stats(const DBSYNC_HANDLE handle,
+                                     cJSON**             js_result)
+{
+    auto retVal { -1 };
+    std::string errorMessage;
+
+    if (!handle || !js_result)
+    {
+        errorMessage += "Invalid parameters.";
+    }
+    else
+    {
+        try
+        {
+            nlohmann::json result;
+            DBSyncImplementation::instance().getStatementCacheStats(handle, result);
+            *js_result = cJSON_Parse(result.dump().c_str());
+            retVal = 0;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            errorMessage += "DB error, id: " + std::to_string(ex.id()) + ". " + ex.what();
+            retVal = ex.id();
+        }
+        // LCOV_EXCL_START
+        catch (...)
+        {
+            errorMessage += "Unrecognized error.";
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    log_message(errorMessage);
+
+    return retVal;
+}
+
+int dbsync_set_memory_limit(const DBSYNC_HANDLE      handle,
+                            const unsigned long long limit)
+{
+    auto retVal { -1 };
+    std::string errorMessage;
+
+    if (!handle)
+    {
+        errorMessage += "Invalid parameters.";
+    }
+    else
+    {
+        try
+        {
+            DBSyncImplementation::instance().setMemoryLimit(handle, limit);
+            retVal = 0;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            errorMessage += "DB error, id: " + std::to_string(ex.id()) + ". " + ex.what();
+            retVal = ex.id();
+        }
+        // LCOV_EXCL_START
+        catch (...)
+        {
+            errorMessage += "Unrecognized error.";
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    log_message(errorMessage);
+
+    return retVal;
+}
+
+int dbsync_get_storage_stats(const DBSYNC_HANDLE handle,
+                             cJSON**             js_result)
+{
+    auto retVal { -1 };
+    std::string errorMessage;
+
+    if (!handle || !js_result)
+    {
+        errorMessage += "Invalid parameters.";
+    }
+    else
+    {
+        try
+        {
+            nlohmann::json result;
+            DBSyncImplementation::instance().getStorageStats(handle, result);
+            *js_result = cJSON_Parse(result.dump().c_str());
+            retVal = 0;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            errorMessage += "DB error, id: " + std::to_string(ex.id()) + ". " + ex.what();
+            retVal = ex.id();
+        }
+        // LCOV_EXCL_START
+        catch (...)
+        {
+            errorMessage += "Unrecognized error.";
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    log_message(errorMessage);
+
+    return retVal;
+}
+
 int dbsync_sync_row(const DBSYNC_HANDLE handle,
                     const cJSON*        js_input,
                     callback_data_t     callback_data)
@@ -370,6 +518,56 @@ int dbsync_sync_row(const DBSYNC_HANDLE handle,
     return retVal;
 }
 
+int dbsync_sync_rows(const DBSYNC_HANDLE handle,
+                     const cJSON*        js_input,
+                     callback_data_t     callback_data)
+{
+    auto retVal { -1 };
+    std::string errorMessage;
+
+    if (!handle || !js_input || !callback_data.callback)
+    {
+        errorMessage += "Invalid input parameters.";
+    }
+    else
+    {
+        try
+        {
+            const auto callbackWrapper
+            {
+                [callback_data](ReturnTypeCallback result, const nlohmann::json & jsonResult)
+                {
+                    const std::unique_ptr<cJSON, CJsonSmartDeleter> spJson{ cJSON_Parse(jsonResult.dump().c_str()) };
+                    callback_data.callback(result, spJson.get(), callback_data.user_data);
+                }
+            };
+            const std::unique_ptr<char, CJsonSmartFree> spJsonBytes{ cJSON_PrintUnformatted(js_input) };
+            DBSyncImplementation::instance().syncRowsData(handle, nlohmann::json::parse(spJsonBytes.get()), callbackWrapper);
+            retVal = 0;
+        }
+        catch (const nlohmann::detail::exception& ex)
+        {
+            errorMessage += "json error, id: " + std::to_string(ex.id) + ". " + ex.what();
+            retVal = ex.id;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            errorMessage += "DB error, id: " + std::to_string(ex.id()) + ". " + ex.what();
+            retVal = ex.id();
+        }
+        // LCOV_EXCL_START
+        catch (...)
+        {
+            errorMessage += "Unrecognized error.";
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    log_message(errorMessage);
+    return retVal;
+}
+
 int dbsync_select_rows(const DBSYNC_HANDLE handle,
                        const cJSON*        js_data_input,
                        callback_data_t     callback_data)
@@ -684,6 +882,26 @@ void DBSync::setTableMaxRow(const std::string& table,
     DBSyncImplementation::instance().setMaxRows(m_dbsyncHandle, table, maxRows);
 }
 
+void DBSync::getStatementCacheStats(nlohmann::json& jsResult)
+{
+    DBSyncImplementation::instance().getStatementCacheStats(m_dbsyncHandle, jsResult);
+}
+
+void DBSync::setMemoryLimit(const unsigned long long limit)
+{
+    DBSyncImplementation::instance().setMemoryLimit(m_dbsyncHandle, limit);
+}
+
+void DBSync::getStorageStats(nlohmann::json& jsResult)
+{
+    DBSyncImplementation::instance().getStorageStats(m_dbsyncHandle, jsResult);
+}
+
+long long DBSync::getTableRowCount(const std::string& table)
+{
+    return DBSyncImplementation::instance().getTableRowCount(m_dbsyncHandle, table);
+}
+
 void DBSync::syncRow(const nlohmann::json& jsInput,
                      ResultCallbackData    callbackData)
 {
@@ -697,6 +915,19 @@ void DBSync::syncRow(const nlohmann::json& jsInput,
     DBSyncImplementation::instance().syncRowData(m_dbsyncHandle, jsInput, callbackWrapper);
 }
 
+void DBSync::syncRows(const nlohmann::json& jsInput,
+                      ResultCallbackData    callbackData)
+{
+    const auto callbackWrapper
+    {
+        [callbackData](ReturnTypeCallback result, const nlohmann::json & jsonResult)
+        {
+            callbackData(result, jsonResult);
+        }
+    };
+    DBSyncImplementation::instance().syncRowsData(m_dbsyncHandle, jsInput, callbackWrapper);
+}
+
 void DBSync::selectRows(const nlohmann::json& jsInput,
                         ResultCallbackData    callbackData)
 {
@@ -792,6 +1023,11 @@ void DBSyncTxn::syncTxnRow(const nlohmann::json& jsInput)
     PipelineFactory::instance().pipeline(m_txn)->syncRow(jsInput);
 }
 
+void DBSyncTxn::syncTxnRows(const nlohmann::json& jsInput)
+{
+    PipelineFactory::instance().pipeline(m_txn)->syncRows(jsInput);
+}
+
 void DBSyncTxn::getDeletedRows(ResultCallbackData  callbackData)
 {
     const auto callbackWrapper
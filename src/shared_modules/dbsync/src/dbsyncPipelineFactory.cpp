@@ -70,21 +70,34 @@ namespace DbSync
                         value,
                         [this](ReturnTypeCallback resType, const nlohmann::json & resValue)
                     {
-                        this->pushResult(SyncResult{resType, resValue});
+                        this->pushResult(resType, resValue);
                     }
                     );
                 }
                 catch (const DbSync::max_rows_error&)
                 {
-                    pushResult(SyncResult{MAX_ROWS, value});
+                    pushResult(MAX_ROWS, value);
                 }
                 catch (const std::exception& ex)
                 {
-                    SyncResult result;
-                    result.first = DB_ERROR;
-                    result.second = value;
-                    result.second["exception"] = ex.what();
-                    pushResult(result);
+                    auto result = value;
+                    result["exception"] = ex.what();
+                    pushResult(DB_ERROR, result);
+                }
+            }
+            void syncRows(const nlohmann::json& values) override
+            {
+                if (!values.is_array())
+                {
+                    throw dbsync_error
+                    {
+                        INVALID_PARAMETERS
+                    };
+                }
+
+                for (const auto& value : values)
+                {
+                    syncRow(value);
                 }
             }
             void getDeleted(ResultCallback callback) override
@@ -109,27 +122,33 @@ namespace DbSync
                        );
             }
 
-            void pushResult(const SyncResult& result)
+            void pushResult(const ReturnTypeCallback type,
+                            const nlohmann::json& value)
             {
                 const auto async{ m_spDispatchNode&& m_spDispatchNode->size() < m_maxQueueSize };
 
+                // The result is only copied when it has to be queued.
                 if (async)
                 {
-                    m_spDispatchNode->receive(result);
+                    m_spDispatchNode->receive(SyncResult{type, value});
                 }
                 else
                 {
-                    dispatchResult(result);
+                    notifyResult(type, value);
                 }
             }
 
             void dispatchResult(const SyncResult& result)
             {
-                const auto& value{ result.second };
+                notifyResult(result.first, result.second);
+            }
 
+            void notifyResult(const ReturnTypeCallback type,
+                              const nlohmann::json& value)
+            {
                 if (!value.empty())
                 {
-                    m_callback(result.first, value);
+                    m_callback(type, value);
                 }
             }
             const DBSYNC_HANDLE m_handle;
@@ -27,6 +27,7 @@ namespace DbSync
         virtual ~IPipeline() = default;
         // LCOV_EXCL_STOP
         virtual void syncRow(const nlohmann::json& syncJson) = 0;
+        virtual void syncRows(const nlohmann::json& syncJson) = 0;
         virtual void getDeleted(const ResultCallback callback) = 0;
     };
 
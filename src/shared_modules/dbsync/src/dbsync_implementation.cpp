@@ -26,20 +26,17 @@ DBSYNC_HANDLE DBSyncImplementation::initialize(const HostType     hostType,
         std::make_shared<DbEngineContext>(db, hostType, dbType)
     };
     const DBSYNC_HANDLE handle{ spDbEngineContext.get() };
-    std::lock_guard<std::mutex> lock{m_mutex};
-    m_dbSyncContexts[handle] = spDbEngineContext;
+    m_dbSyncContexts.insert(handle, spDbEngineContext);
     return handle;
 }
 
 void DBSyncImplementation::release()
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
     m_dbSyncContexts.clear();
 }
 
 void DBSyncImplementation::releaseContext(const DBSYNC_HANDLE handle)
 {
-    std::lock_guard<std::mutex> lock{ m_mutex };
     m_dbSyncContexts.erase(handle);
 }
 
@@ -84,6 +81,27 @@ void DBSyncImplementation::syncRowData(const DBSYNC_HANDLE      handle,
                                       lock);
 }
 
+void DBSyncImplementation::syncRowsData(const DBSYNC_HANDLE     handle,
+                                        const nlohmann::json&   json,
+                                        const ResultCallback    callback)
+{
+    if (!json.is_array())
+    {
+        throw dbsync_error{INVALID_PARAMETERS};
+    }
+
+    const auto ctx{ dbEngineContext(handle) };
+    Utils::ExclusiveLocking lock{ ctx->m_syncMutex };
+
+    for (const auto& tableData : json)
+    {
+        ctx->m_dbEngine->syncTableRowData(tableData,
+                                          callback,
+                                          false,
+                                          lock);
+    }
+}
+
 void DBSyncImplementation::deleteRowsData(const DBSYNC_HANDLE   handle,
                                           const nlohmann::json& json)
 {
@@ -106,15 +124,14 @@ void DBSyncImplementation::updateSnapshotData(const DBSYNC_HANDLE   handle,
 
 std::shared_ptr<DBSyncImplementation::DbEngineContext> DBSyncImplementation::dbEngineContext(const DBSYNC_HANDLE handle)
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    const auto it{ m_dbSyncContexts.find(handle) };
+    const auto spDbEngineContext{ m_dbSyncContexts[handle] };
 
-    if (it == m_dbSyncContexts.end())
+    if (!spDbEngineContext)
     {
         throw dbsync_error { INVALID_HANDLE };
     }
 
-    return it->second;
+    return spDbEngineContext;
 }
 
 void DBSyncImplementation::setMaxRows(const DBSYNC_HANDLE handle,
@@ -127,6 +144,42 @@ void DBSyncImplementation::setMaxRows(const DBSYNC_HANDLE handle,
     ctx->m_dbEngine->setMaxRows(table, maxRows);
 }
 
+void DBSyncImplementation::getStatementCacheStats(const DBSYNC_HANDLE handle,
+                                                  nlohmann::json& stats)
+{
+    const auto ctx{ dbEngineContext(handle) };
+
+    std::lock_guard<std::shared_timed_mutex> lock{ ctx->m_syncMutex };
+    ctx->m_dbEngine->getStatementCacheStats(stats);
+}
+
+void DBSyncImplementation::setMemoryLimit(const DBSYNC_HANDLE handle,
+                                          const unsigned long long limit)
+{
+    const auto ctx{ dbEngineContext(handle) };
+
+    std::lock_guard<std::shared_timed_mutex> lock{ ctx->m_syncMutex };
+    ctx->m_dbEngine->setMemoryLimit(limit);
+}
+
+void DBSyncImplementation::getStorageStats(const DBSYNC_HANDLE handle,
+                                           nlohmann::json& stats)
+{
+    const auto ctx{ dbEngineContext(handle) };
+
+    std::lock_guard<std::shared_timed_mutex> lock{ ctx->m_syncMutex };
+    ctx->m_dbEngine->getStorageStats(stats);
+}
+
+int64_t DBSyncImplementation::getTableRowCount(const DBSYNC_HANDLE handle,
+                                               const std::string& table)
+{
+    const auto ctx{ dbEngineContext(handle) };
+
+    std::lock_guard<std::shared_timed_mutex> lock{ ctx->m_syncMutex };
+    return ctx->m_dbEngine->getTableRowCount(table);
+}
+
 TXN_HANDLE DBSyncImplementation::createTransaction(const DBSYNC_HANDLE      handle,
                                                    const nlohmann::json&    json)
 {
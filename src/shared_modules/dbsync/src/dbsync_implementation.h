@@ -18,6 +18,7 @@
 #include <shared_mutex>
 #include "dbengine_factory.h"
 #include "commonDefs.h"
+#include "mapWrapperSafe.h"
 #include "json.hpp"
 
 namespace DbSync
@@ -43,6 +44,10 @@ namespace DbSync
                              const nlohmann::json&  json,
                              const ResultCallback   callback);
 
+            void syncRowsData(const DBSYNC_HANDLE   handle,
+                              const nlohmann::json& json,
+                              const ResultCallback  callback);
+
             void deleteRowsData(const DBSYNC_HANDLE     handle,
                                 const nlohmann::json&   json);
 
@@ -59,6 +64,18 @@ namespace DbSync
                             const std::string& table,
                             const long long maxRows);
 
+            void getStatementCacheStats(const DBSYNC_HANDLE handle,
+                                        nlohmann::json& stats);
+
+            void setMemoryLimit(const DBSYNC_HANDLE handle,
+                                const unsigned long long limit);
+
+            void getStorageStats(const DBSYNC_HANDLE handle,
+                                 nlohmann::json& stats);
+
+            int64_t getTableRowCount(const DBSYNC_HANDLE handle,
+                                     const std::string& table);
+
             TXN_HANDLE createTransaction(const DBSYNC_HANDLE    handle,
                                          const nlohmann::json&  json);
 
@@ -103,31 +120,27 @@ namespace DbSync
                     const DbEngineType m_dbEngineType;
                     const std::shared_ptr<DBSyncImplementation::TransactionContext> transactionContext(const TXN_HANDLE handle)
                     {
-                        std::lock_guard<std::mutex> lock{m_mutex};
-                        const auto it{ m_transactionContexts.find(handle) };
+                        const auto spTransactionContext{ m_transactionContexts[handle] };
 
-                        if (m_transactionContexts.end() == it)
+                        if (!spTransactionContext)
                         {
                             throw dbsync_error { INVALID_TRANSACTION };
                         }
 
-                        return it->second;
+                        return spTransactionContext;
                     }
                     void addTransactionContext(const std::shared_ptr<DbSync::DBSyncImplementation::TransactionContext>& spTransactionContext)
                     {
-                        std::lock_guard<std::mutex> lock{m_mutex};
-                        m_transactionContexts[spTransactionContext.get()] = spTransactionContext;
+                        m_transactionContexts.insert(spTransactionContext.get(), spTransactionContext);
                     }
                     void deleteTransactionContext(const TXN_HANDLE txnHandle)
                     {
-                        std::lock_guard<std::mutex> lock{m_mutex};
                         m_transactionContexts.erase(txnHandle);
                     }
 
                     std::shared_timed_mutex m_syncMutex;
                 private:
-                    std::map<TXN_HANDLE, std::shared_ptr<TransactionContext>> m_transactionContexts;
-                    std::mutex m_mutex;
+                    Utils::MapWrapperSafe<TXN_HANDLE, std::shared_ptr<TransactionContext>> m_transactionContexts;
             };
 
             std::shared_ptr<DbEngineContext> dbEngineContext(const DBSYNC_HANDLE handle);
@@ -136,8 +149,7 @@ namespace DbSync
             ~DBSyncImplementation() = default;
             DBSyncImplementation(const DBSyncImplementation&) = delete;
             DBSyncImplementation& operator=(const DBSyncImplementation&) = delete;
-            std::map<DBSYNC_HANDLE, std::shared_ptr<DbEngineContext>> m_dbSyncContexts;
-            std::mutex m_mutex;
+            Utils::MapWrapperSafe<DBSYNC_HANDLE, std::shared_ptr<DbEngineContext>> m_dbSyncContexts;
     };
 }
 
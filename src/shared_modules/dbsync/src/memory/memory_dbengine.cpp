@@ -0,0 +1,908 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include "memory_dbengine.h"
+#include "stringHelper.h"
+
+using namespace Memory;
+
+template <typename TLock>
+static void notifyEvents(const std::vector<std::pair<ReturnTypeCallback, nlohmann::json>>& events,
+                         const DbSync::ResultCallback& callback,
+                         TLock& lock)
+{
+    if (callback)
+    {
+        for (const auto& event : events)
+        {
+            lock.unlock();
+            callback(event.first, event.second);
+            lock.lock();
+        }
+    }
+}
+
+static bool isCountColumn(const std::string& column, std::string& name)
+{
+    const auto tokens { tokenize(column) };
+    const auto isSymbol
+    {
+        [&tokens](const size_t index, const std::string & value)
+        {
+            return TokenType::Symbol == tokens[index].type && value == tokens[index].value;
+        }
+    };
+    auto ret { false };
+
+    if (tokens.size() >= 5 &&
+            TokenType::Identifier == tokens[0].type && "COUNT" == Utils::toUpperCase(tokens[0].value) &&
+            isSymbol(1, "(") && isSymbol(2, "*") && isSymbol(3, ")"))
+    {
+        if (TokenType::End == tokens[4].type)
+        {
+            name = "count(*)";
+            ret = true;
+        }
+        else if (tokens.size() == 7 &&
+                 TokenType::Identifier == tokens[4].type && "AS" == Utils::toUpperCase(tokens[4].value) &&
+                 TokenType::End != tokens[5].type)
+        {
+            name = tokens[5].value;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+MemoryDBEngine::MemoryDBEngine(const std::string& tableStmtCreation)
+{
+    for (auto& definition : parseCreateStatements(tableStmtCreation))
+    {
+        m_tables[definition.name] = Table
+        {
+            std::move(definition.columns), std::move(definition.primaryKeys), {}, 0, 0, {}
+        };
+    }
+}
+
+void MemoryDBEngine::setMaxRows(const std::string& table,
+                                const int64_t maxRows)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto& data { getTable(table) };
+
+    if (maxRows < 0)
+    {
+        throw dbengine_error { MIN_ROW_LIMIT_BELOW_ZERO };
+    }
+
+    data.maxRows = maxRows;
+}
+
+void MemoryDBEngine::bulkInsert(const std::string& table,
+                                const nlohmann::json& data)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto& tableData { getTable(table) };
+
+    for (const auto& entry : data)
+    {
+        insertRow(tableData, rowFromData(tableData, entry));
+    }
+}
+
+void MemoryDBEngine::refreshTableData(const nlohmann::json& data,
+                                      const DbSync::ResultCallback callback,
+                                      std::unique_lock<std::shared_timed_mutex>& lock)
+{
+    const auto& table { data.at("table").get_ref<const std::string&>() };
+    Events events;
+
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        auto& tableData { getTable(table) };
+        std::map<Key, Row> snapshot;
+
+        if (tableData.primaryKeys.empty())
+        {
+            throw dbengine_error { INVALID_PK_DATA };
+        }
+
+        for (const auto& entry : data.at("data"))
+        {
+            auto row = rowFromData(tableData, entry);
+            auto key = keyFromRow(tableData, row);
+
+            if (!snapshot.emplace(std::move(key), std::move(row)).second)
+            {
+                throw dbengine_error { BIND_FIELDS_DOES_NOT_MATCH };
+            }
+        }
+
+        eraseRows(tableData, [&](const Row & row)
+        {
+            if (snapshot.end() == snapshot.find(keyFromRow(tableData, row)))
+            {
+                events.emplace_back(DELETED, rowToJson(tableData, row, true));
+                return true;
+            }
+
+            return false;
+        });
+
+        Events inserted;
+
+        for (auto& value : snapshot)
+        {
+            const auto it { tableData.rows.find(value.first) };
+
+            if (tableData.rows.end() == it)
+            {
+                inserted.emplace_back(INSERTED, rowToJson(tableData, value.second));
+                insertRow(tableData, std::move(value.second));
+                continue;
+            }
+
+            nlohmann::json object;
+
+            // Like a SQL comparison, a field that is null on either side is not a change.
+            for (size_t i = 0; i < tableData.columns.size(); ++i)
+            {
+                const auto& column { tableData.columns[i] };
+                auto& cell { it->second[i] };
+
+                if (!column.primaryKey && column.name != STATUS_FIELD_NAME &&
+                        !cell.is_null() && !value.second[i].is_null() && cell != value.second[i])
+                {
+                    cell = value.second[i];
+                    object[column.name] = cell;
+                }
+            }
+
+            if (!object.empty())
+            {
+                for (const auto index : tableData.primaryKeys)
+                {
+                    const auto& column { tableData.columns[index] };
+                    object["PK_" + column.name] = fieldValue(column, it->second[index]);
+                }
+
+                events.emplace_back(MODIFIED, std::move(object));
+            }
+        }
+
+        events.insert(events.end(), inserted.begin(), inserted.end());
+    }
+
+    notifyEvents(events, callback, lock);
+}
+
+void MemoryDBEngine::syncTableRowData(const nlohmann::json& jsInput,
+                                      const DbSync::ResultCallback callback,
+                                      const bool inTransaction,
+                                      Utils::ILocking& lock)
+{
+    const auto& table { jsInput.at("table").get_ref<const std::string&>() };
+    const auto& data { jsInput.at("data") };
+
+    auto it { jsInput.find("options") };
+    auto returnOldData { false };
+    nlohmann::json ignoredColumns { };
+
+    if (jsInput.end() != it)
+    {
+        auto itOldData { it->find("return_old_data") };
+
+        if (it->end() != itOldData)
+        {
+            returnOldData = itOldData->is_boolean() ? itOldData.value().get<bool>() : returnOldData;
+        }
+
+        auto itIgnoredFields { it->find("ignore") };
+
+        if (it->end() != itIgnoredFields)
+        {
+            ignoredColumns = itIgnoredFields->is_array() ? itIgnoredFields.value() : ignoredColumns;
+        }
+    }
+
+    std::unique_lock<std::mutex> guard{ m_mutex };
+    auto& tableData { getTable(table) };
+    guard.unlock();
+
+    // Rows of a transaction are synced by several threads, each row is applied under the
+    // engine lock and notified once it is released.
+    for (const auto& entry : data)
+    {
+        Events events;
+        nlohmann::json updated;
+        nlohmann::json oldData;
+
+        guard.lock();
+
+        if (syncRow(tableData, entry, ignoredColumns, inTransaction, updated, oldData))
+        {
+            if (!updated.empty())
+            {
+                if (returnOldData)
+                {
+                    nlohmann::json diff;
+                    diff["old"] = std::move(oldData);
+                    diff["new"] = std::move(updated);
+                    events.emplace_back(MODIFIED, std::move(diff));
+                }
+                else
+                {
+                    events.emplace_back(MODIFIED, std::move(updated));
+                }
+            }
+        }
+        else
+        {
+            insertRow(tableData, rowFromData(tableData, entry));
+            events.emplace_back(INSERTED, entry);
+        }
+
+        guard.unlock();
+        notifyEvents(events, callback, lock);
+    }
+}
+
+void MemoryDBEngine::initializeStatusField(const nlohmann::json& tableNames)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    for (const auto& tableValue : tableNames)
+    {
+        auto& tableData { getTable(tableValue.get_ref<const std::string&>()) };
+        auto index { statusFieldIndex(tableData) };
+
+        if (std::string::npos == index)
+        {
+            tableData.columns.push_back({ STATUS_FIELD_NAME, ColumnType::Integer, false, 1 });
+            index = tableData.columns.size() - 1;
+
+            for (auto& row : tableData.rows)
+            {
+                row.second.emplace_back();
+            }
+        }
+
+        for (auto& row : tableData.rows)
+        {
+            row.second[index] = 0;
+        }
+    }
+}
+
+void MemoryDBEngine::deleteRowsByStatusField(const nlohmann::json& tableNames)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    for (const auto& tableValue : tableNames)
+    {
+        auto& tableData { getTable(tableValue.get_ref<const std::string&>()) };
+        const auto index { statusFieldIndex(tableData) };
+
+        if (std::string::npos == index)
+        {
+            throw dbengine_error { STEP_ERROR_DELETE_STATUS_FIELD };
+        }
+
+        eraseRows(tableData, [index](const Row & row)
+        {
+            return 0 == row[index];
+        });
+    }
+}
+
+void MemoryDBEngine::returnRowsMarkedForDelete(const nlohmann::json& tableNames,
+                                               const DbSync::ResultCallback callback,
+                                               std::unique_lock<std::shared_timed_mutex>& lock)
+{
+    Events events;
+
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        for (const auto& tableValue : tableNames)
+        {
+            const auto& tableData { getTable(tableValue.get_ref<const std::string&>()) };
+            const auto index { statusFieldIndex(tableData) };
+
+            if (std::string::npos != index)
+            {
+                for (const auto& row : tableData.rows)
+                {
+                    if (0 == row.second[index])
+                    {
+                        events.emplace_back(DELETED, rowToJson(tableData, row.second));
+                    }
+                }
+            }
+        }
+    }
+
+    notifyEvents(events, callback, lock);
+}
+
+void MemoryDBEngine::selectData(const std::string& table,
+                                const nlohmann::json& query,
+                                const DbSync::ResultCallback& callback,
+                                std::unique_lock<std::shared_timed_mutex>& lock)
+{
+    Events events;
+
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        const auto& tableData { getTable(table) };
+        const auto& itFilter{ query.find("row_filter") };
+        const auto& itDistinct{ query.find("distinct_opt") };
+        const auto& itOrderBy{ query.find("order_by_opt") };
+        const auto& itCount{ query.find("count_opt") };
+        const auto distinct { itDistinct != query.end() && itDistinct->get<bool>() };
+        const unsigned int limit { itCount != query.end() ? itCount->get<unsigned int>() : std::numeric_limits<unsigned int>::max() };
+        std::vector<size_t> projection;
+        std::string countName;
+
+        Filter filter { tableData.columns, itFilter != query.end() ? itFilter->get<std::string>() : "" };
+
+        if (itOrderBy != query.end() && !itOrderBy->get<std::string>().empty())
+        {
+            filter.addOrderBy(itOrderBy->get<std::string>());
+        }
+
+        for (const auto& columns : query.at("column_list"))
+        {
+            for (const auto& value : Utils::split(columns.get_ref<const std::string&>(), ','))
+            {
+                const auto name { Utils::trim(value) };
+
+                if ("*" == name)
+                {
+                    for (size_t i = 0; i < tableData.columns.size(); ++i)
+                    {
+                        projection.push_back(i);
+                    }
+                }
+                else if (!isCountColumn(name, countName))
+                {
+                    const auto index { columnIndex(tableData.columns, name) };
+
+                    if (std::string::npos == index)
+                    {
+                        throw dbengine_error { SQL_STMT_ERROR };
+                    }
+
+                    projection.push_back(index);
+                }
+            }
+        }
+
+        std::vector<const Row*> rows;
+        nlohmann::json low;
+        nlohmann::json high;
+
+        // A range over the first primary key, as the rsync queries are, starts at its lower bound.
+        if (!tableData.primaryKeys.empty() && filter.keyRange(tableData.primaryKeys.front(), low, high))
+        {
+            for (auto it = tableData.rows.lower_bound(Key { low }); it != tableData.rows.end() && !(high < it->first.front()); ++it)
+            {
+                if (filter.match(it->second))
+                {
+                    rows.push_back(&it->second);
+                }
+            }
+        }
+        else
+        {
+            for (const auto& row : tableData.rows)
+            {
+                if (filter.match(row.second))
+                {
+                    rows.push_back(&row.second);
+                }
+            }
+        }
+
+        const auto& orderBy { filter.orderBy() };
+        const auto keyOrder
+        {
+            orderBy.size() <= tableData.primaryKeys.size() &&
+            std::equal(orderBy.begin(), orderBy.end(), tableData.primaryKeys.begin(),
+                       [](const std::pair<size_t, bool>& order, const size_t index)
+            {
+                return !order.second && order.first == index;
+            })
+        };
+
+        if (!keyOrder)
+        {
+            std::stable_sort(rows.begin(), rows.end(), [&orderBy](const Row * left, const Row * right)
+            {
+                for (const auto& order : orderBy)
+                {
+                    const auto& first { (*left)[order.first] };
+                    const auto& second { (*right)[order.first] };
+
+                    if (first < second || second < first)
+                    {
+                        return order.second ? second < first : first < second;
+                    }
+                }
+
+                return false;
+            });
+        }
+
+        if (!countName.empty())
+        {
+            if (limit > 0)
+            {
+                events.emplace_back(SELECTED, nlohmann::json { { countName, static_cast<int64_t>(rows.size()) } });
+            }
+        }
+        else
+        {
+            std::set<nlohmann::json> selected;
+            auto count { 0u };
+
+            for (const auto row : rows)
+            {
+                nlohmann::json object;
+
+                if (count++ == limit)
+                {
+                    break;
+                }
+
+                for (const auto index : projection)
+                {
+                    if (!(*row)[index].is_null() && tableData.columns[index].name != STATUS_FIELD_NAME)
+                    {
+                        object[tableData.columns[index].name] = (*row)[index];
+                    }
+                }
+
+                if (distinct && !selected.insert(object).second)
+                {
+                    --count;
+                }
+                else if (!object.empty())
+                {
+                    events.emplace_back(SELECTED, std::move(object));
+                }
+            }
+        }
+    }
+
+    notifyEvents(events, callback, lock);
+}
+
+void MemoryDBEngine::deleteTableRowsData(const std::string&    table,
+                                         const nlohmann::json& jsDeletionData)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto& tableData { getTable(table) };
+    const auto& itData{ jsDeletionData.find("data")};
+    const auto& itFilter{ jsDeletionData.find("where_filter_opt")};
+
+    if (itData != jsDeletionData.end() && itData->size() > 0)
+    {
+        // Deletion via primary keys on "data" json field.
+        if (tableData.primaryKeys.empty())
+        {
+            throw dbengine_error { INVALID_PK_DATA };
+        }
+
+        for (const auto& entry : *itData)
+        {
+            Key key;
+
+            for (const auto index : tableData.primaryKeys)
+            {
+                const auto& column { tableData.columns[index] };
+                const auto it { entry.find(column.name) };
+
+                if (entry.end() == it)
+                {
+                    throw dbengine_error { BIND_FIELDS_DOES_NOT_MATCH };
+                }
+
+                key.push_back(toCell(column, *it));
+            }
+
+            const auto it { tableData.rows.find(key) };
+
+            if (tableData.rows.end() != it)
+            {
+                eraseRow(tableData, it);
+            }
+        }
+    }
+    else if (itFilter != jsDeletionData.end() && !itFilter->get<std::string>().empty())
+    {
+        // Deletion via condition on "where_filter_opt" json field.
+        const Filter filter { tableData.columns, itFilter->get<std::string>() };
+
+        eraseRows(tableData, [&filter](const Row & row)
+        {
+            return filter.match(row);
+        });
+    }
+    else
+    {
+        throw dbengine_error{ INVALID_DELETE_INFO };
+    }
+}
+
+void MemoryDBEngine::addTableRelationship(const nlohmann::json& data)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto& tableData { getTable(data.at("base_table").get_ref<const std::string&>()) };
+    std::vector<Relationship> relationships;
+
+    for (const auto& jsonValue : data.at("relationed_tables"))
+    {
+        Relationship relationship { jsonValue.at("table").get<std::string>(), {} };
+
+        for (const auto& match : jsonValue.at("field_match").items())
+        {
+            relationship.fieldMatch.emplace_back(match.key(), match.value().get<std::string>());
+        }
+
+        relationships.push_back(std::move(relationship));
+    }
+
+    // As the triggers of the SQLite engine, the first relationship of a table is kept.
+    if (tableData.relationships.empty())
+    {
+        tableData.relationships = std::move(relationships);
+    }
+}
+
+void MemoryDBEngine::getStatementCacheStats(nlohmann::json& stats)
+{
+    // The memory engine has no SQL statements to cache.
+    stats["prepared"] = 0;
+    stats["reused"] = 0;
+    stats["evicted"] = 0;
+    stats["cached"] = 0;
+    stats["limit"] = 0;
+}
+
+void MemoryDBEngine::setMemoryLimit(const uint64_t /*limit*/)
+{
+    // All the rows of the memory engine are kept in memory.
+}
+
+void MemoryDBEngine::getStorageStats(nlohmann::json& stats)
+{
+    stats["memory_used"] = 0;
+    stats["memory_limit"] = 0;
+    stats["db_size"] = 0;
+    stats["cache_hit"] = 0;
+    stats["cache_miss"] = 0;
+    stats["cache_spill"] = 0;
+}
+
+int64_t MemoryDBEngine::getTableRowCount(const std::string& table)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return getTable(table).rows.size();
+}
+
+///
+/// Private functions section
+///
+
+Table& MemoryDBEngine::getTable(const std::string& table)
+{
+    const auto it { m_tables.find(table) };
+
+    if (m_tables.end() == it)
+    {
+        throw dbengine_error { EMPTY_TABLE_METADATA };
+    }
+
+    return it->second;
+}
+
+// Same conversions that the SQLite engine does to bind JSON values.
+nlohmann::json MemoryDBEngine::toCell(const Column& column,
+                                      const nlohmann::json& value)
+{
+    const auto hasText { value.is_string() && value.get_ref<const std::string&>().size() };
+
+    switch (column.type)
+    {
+        case ColumnType::BigInt:
+            return value.is_number() ? value.get<int64_t>() : hasText ? std::stoll(value.get_ref<const std::string&>()) : 0;
+
+        case ColumnType::UnsignedBigInt:
+            return value.is_number_unsigned() ? value.get<uint64_t>() : hasText ? std::stoull(value.get_ref<const std::string&>()) : 0ull;
+
+        case ColumnType::Integer:
+            return value.is_number() ? value.get<int32_t>() : hasText ? std::stoi(value.get_ref<const std::string&>()) : 0;
+
+        case ColumnType::Text:
+            return value.is_string() ? value : nlohmann::json("");
+
+        case ColumnType::Double:
+            return value.is_number_float() ? value.get<double>() : hasText ? std::stod(value.get_ref<const std::string&>()) : .0;
+
+        default:
+            throw dbengine_error { INVALID_COLUMN_TYPE };
+    }
+}
+
+// Null cells are reported with the default value of their type, as the SQLite engine reads them.
+nlohmann::json MemoryDBEngine::fieldValue(const Column& column,
+                                          const nlohmann::json& cell)
+{
+    if (!cell.is_null())
+    {
+        return cell;
+    }
+
+    switch (column.type)
+    {
+        case ColumnType::Text:
+            return "";
+
+        case ColumnType::Double:
+            return .0;
+
+        case ColumnType::UnsignedBigInt:
+            return 0ull;
+
+        default:
+            return 0;
+    }
+}
+
+size_t MemoryDBEngine::statusFieldIndex(const Table& table)
+{
+    return columnIndex(table.columns, STATUS_FIELD_NAME);
+}
+
+Key MemoryDBEngine::keyFromRow(Table& table,
+                               const Row& row) const
+{
+    Key key;
+
+    for (const auto index : table.primaryKeys)
+    {
+        key.push_back(row[index]);
+    }
+
+    // Tables without primary key are kept in insertion order.
+    if (key.empty())
+    {
+        key.push_back(table.nextRowId++);
+    }
+
+    return key;
+}
+
+Row MemoryDBEngine::rowFromData(const Table& table,
+                                const nlohmann::json& data) const
+{
+    Row row;
+
+    for (const auto& column : table.columns)
+    {
+        const auto it { data.find(column.name) };
+        row.push_back(data.end() != it ? toCell(column, *it) : column.defaultValue);
+    }
+
+    return row;
+}
+
+nlohmann::json MemoryDBEngine::rowToJson(const Table& table,
+                                         const Row& row,
+                                         const bool onlyPrimaryKeys) const
+{
+    nlohmann::json object;
+
+    for (size_t i = 0; i < table.columns.size(); ++i)
+    {
+        const auto& column { table.columns[i] };
+
+        if (column.name != STATUS_FIELD_NAME && (!onlyPrimaryKeys || column.primaryKey))
+        {
+            object[column.name] = fieldValue(column, row[i]);
+        }
+    }
+
+    return object;
+}
+
+void MemoryDBEngine::insertRow(Table& table,
+                               Row&& row)
+{
+    if (table.maxRows > 0 && static_cast<int64_t>(table.rows.size()) + 1 > table.maxRows)
+    {
+        throw DbSync::max_rows_error { MAX_ROWS_ERROR_STRING };
+    }
+
+    const auto key = keyFromRow(table, row);
+
+    if (!table.rows.emplace(key, std::move(row)).second)
+    {
+        throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
+    }
+}
+
+void MemoryDBEngine::eraseRow(Table& table,
+                              const std::map<Key, Row>::iterator& it)
+{
+    const auto row = std::move(it->second);
+    table.rows.erase(it);
+
+    // Delete in cascade the rows of the related tables, as the SQLite engine triggers do.
+    for (const auto& relationship : table.relationships)
+    {
+        const auto itRelated { m_tables.find(relationship.table) };
+
+        if (m_tables.end() != itRelated)
+        {
+            auto& related { itRelated->second };
+            std::vector<std::pair<size_t, size_t>> indexes;
+
+            for (const auto& match : relationship.fieldMatch)
+            {
+                indexes.emplace_back(columnIndex(related.columns, match.first), columnIndex(table.columns, match.second));
+
+                if (std::string::npos == indexes.back().first || std::string::npos == indexes.back().second)
+                {
+                    throw dbengine_error { INVALID_PARAMETERS };
+                }
+            }
+
+            eraseRows(related, [&indexes, &row](const Row & relatedRow)
+            {
+                return std::all_of(indexes.begin(), indexes.end(), [&](const std::pair<size_t, size_t>& index)
+                {
+                    const auto& value { relatedRow[index.first] };
+                    return !value.is_null() && !row[index.second].is_null() && value == row[index.second];
+                });
+            });
+        }
+    }
+}
+
+void MemoryDBEngine::eraseRows(Table& table,
+                               const std::function<bool(const Row&)>& condition)
+{
+    std::vector<Key> keys;
+
+    for (const auto& row : table.rows)
+    {
+        if (condition(row.second))
+        {
+            keys.push_back(row.first);
+        }
+    }
+
+    for (const auto& key : keys)
+    {
+        // A cascade may have deleted the row already.
+        const auto it { table.rows.find(key) };
+
+        if (table.rows.end() != it)
+        {
+            eraseRow(table, it);
+        }
+    }
+}
+
+bool MemoryDBEngine::syncRow(Table& table,
+                             const nlohmann::json& entry,
+                             const nlohmann::json& ignoredColumns,
+                             const bool inTransaction,
+                             nlohmann::json& updated,
+                             nlohmann::json& oldData)
+{
+    Key key;
+
+    // Always include primary keys
+    for (const auto index : table.primaryKeys)
+    {
+        const auto& column { table.columns[index] };
+        const auto& value { entry.at(column.name) };
+        updated[column.name] = value;
+        oldData[column.name] = value;
+        key.push_back(toCell(column, value));
+    }
+
+    const auto it { key.empty() ? table.rows.end() : table.rows.find(key) };
+
+    if (table.rows.end() == it)
+    {
+        updated.clear();
+        oldData.clear();
+        return false;
+    }
+
+    auto& row { it->second };
+    auto isModified { false };
+
+    for (size_t i = 0; i < table.columns.size(); ++i)
+    {
+        const auto& column { table.columns[i] };
+        const auto itField { entry.find(column.name) };
+
+        if (entry.end() != itField)
+        {
+            const auto value = fieldValue(column, row[i]);
+
+            if (*itField != value)
+            {
+                // Diff found
+                isModified = true;
+                oldData[column.name] = value;
+            }
+
+            updated[column.name] = *itField;
+        }
+    }
+
+    // Only the changes of the fields that are not ignored report the row as modified.
+    if (isModified && !ignoredColumns.empty())
+    {
+        isModified = false;
+
+        for (const auto& field : oldData.items())
+        {
+            if (ignoredColumns.end() == std::find(ignoredColumns.begin(), ignoredColumns.end(), field.key()) &&
+                    !table.columns[columnIndex(table.columns, field.key())].primaryKey)
+            {
+                isModified = true;
+                break;
+            }
+        }
+    }
+
+    // If the row is not modified, we clear the result to update the status field value only.
+    if (!isModified)
+    {
+        updated.clear();
+        oldData.clear();
+    }
+
+    for (const auto& field : updated.items())
+    {
+        const auto index { columnIndex(table.columns, field.key()) };
+
+        if (!table.columns[index].primaryKey)
+        {
+            row[index] = toCell(table.columns[index], field.value());
+        }
+    }
+
+    // The status field avoids the row deletion during the txn close.
+    if (inTransaction)
+    {
+        const auto index { statusFieldIndex(table) };
+
+        if (std::string::npos != index)
+        {
+            row[index] = 1;
+        }
+    }
+
+    return true;
+}
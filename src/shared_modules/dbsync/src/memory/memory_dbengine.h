@@ -0,0 +1,140 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _MEMORY_DBENGINE_H
+#define _MEMORY_DBENGINE_H
+
+#include <map>
+#include <mutex>
+#include "dbengine.h"
+#include "memory_sql.h"
+
+namespace Memory
+{
+    const constexpr auto MAX_ROWS_ERROR_STRING {"Too Many Rows."};
+
+    using Key = std::vector<nlohmann::json>;
+
+    struct Relationship final
+    {
+        std::string table;
+        // Pairs of related table column and base table column.
+        std::vector<std::pair<std::string, std::string>> fieldMatch;
+    };
+
+    // Rows are kept ordered by primary key, so a row is found without building SQL
+    // and the rsync ranges over the key are walked in order.
+    struct Table final
+    {
+        Columns columns;
+        std::vector<size_t> primaryKeys;
+        std::map<Key, Row> rows;
+        int64_t nextRowId;
+        int64_t maxRows;
+        std::vector<Relationship> relationships;
+    };
+}// namespace Memory
+
+class MemoryDBEngine final : public DbSync::IDbEngine
+{
+    public:
+        explicit MemoryDBEngine(const std::string& tableStmtCreation);
+        ~MemoryDBEngine() = default;
+
+        void bulkInsert(const std::string& table,
+                        const nlohmann::json& data) override;
+
+        void refreshTableData(const nlohmann::json& data,
+                              const DbSync::ResultCallback callback,
+                              std::unique_lock<std::shared_timed_mutex>& lock) override;
+
+        void syncTableRowData(const nlohmann::json& jsInput,
+                              const DbSync::ResultCallback callback,
+                              const bool inTransaction,
+                              Utils::ILocking& mutex) override;
+
+        void setMaxRows(const std::string& table,
+                        const int64_t maxRows) override;
+
+        void initializeStatusField(const nlohmann::json& tableNames) override;
+
+        void deleteRowsByStatusField(const nlohmann::json& tableNames) override;
+
+        void returnRowsMarkedForDelete(const nlohmann::json& tableNames,
+                                       const DbSync::ResultCallback callback,
+                                       std::unique_lock<std::shared_timed_mutex>& lock) override;
+
+        void selectData(const std::string& table,
+                        const nlohmann::json& query,
+                        const DbSync::ResultCallback& callback,
+                        std::unique_lock<std::shared_timed_mutex>& lock) override;
+
+        void deleteTableRowsData(const std::string& table,
+                                 const nlohmann::json& jsDeletionData) override;
+
+        void addTableRelationship(const nlohmann::json& data) override;
+
+        void getStatementCacheStats(nlohmann::json& stats) override;
+
+        void setMemoryLimit(const uint64_t limit) override;
+
+        void getStorageStats(nlohmann::json& stats) override;
+
+        int64_t getTableRowCount(const std::string& table) override;
+
+    private:
+        using Events = std::vector<std::pair<ReturnTypeCallback, nlohmann::json>>;
+
+        MemoryDBEngine(const MemoryDBEngine&) = delete;
+
+        MemoryDBEngine& operator=(const MemoryDBEngine&) = delete;
+
+        Memory::Table& getTable(const std::string& table);
+
+        static nlohmann::json toCell(const Memory::Column& column,
+                                     const nlohmann::json& value);
+
+        static nlohmann::json fieldValue(const Memory::Column& column,
+                                         const nlohmann::json& cell);
+
+        static size_t statusFieldIndex(const Memory::Table& table);
+
+        Memory::Key keyFromRow(Memory::Table& table,
+                               const Memory::Row& row) const;
+
+        Memory::Row rowFromData(const Memory::Table& table,
+                                const nlohmann::json& data) const;
+
+        nlohmann::json rowToJson(const Memory::Table& table,
+                                 const Memory::Row& row,
+                                 const bool onlyPrimaryKeys = false) const;
+
+        void insertRow(Memory::Table& table,
+                       Memory::Row&& row);
+
+        void eraseRow(Memory::Table& table,
+                      const std::map<Memory::Key, Memory::Row>::iterator& it);
+
+        void eraseRows(Memory::Table& table,
+                       const std::function<bool(const Memory::Row&)>& condition);
+
+        bool syncRow(Memory::Table& table,
+                     const nlohmann::json& entry,
+                     const nlohmann::json& ignoredColumns,
+                     const bool inTransaction,
+                     nlohmann::json& updated,
+                     nlohmann::json& oldData);
+
+        std::map<std::string, Memory::Table> m_tables;
+        std::mutex m_mutex;
+};
+
+#endif // _MEMORY_DBENGINE_H
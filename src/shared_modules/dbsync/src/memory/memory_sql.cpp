@@ -0,0 +1,802 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <map>
+#include "memory_sql.h"
+#include "stringHelper.h"
+
+using namespace Memory;
+
+constexpr auto NO_CONDITION { std::string::npos };
+
+static bool isKeyword(const Token& token, const std::string& keyword)
+{
+    return TokenType::Identifier == token.type && Utils::toUpperCase(token.value) == keyword;
+}
+
+static bool isNumericType(const ColumnType type)
+{
+    return ColumnType::Integer == type ||
+           ColumnType::BigInt == type ||
+           ColumnType::UnsignedBigInt == type ||
+           ColumnType::Double == type;
+}
+
+static nlohmann::json numberValue(const std::string& value)
+{
+    if (std::string::npos != value.find_first_of(".eE"))
+    {
+        return std::stod(value);
+    }
+
+    if ('-' == value.front())
+    {
+        return std::stoll(value);
+    }
+
+    const auto number { std::stoull(value) };
+
+    if (number <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    {
+        return static_cast<int64_t>(number);
+    }
+
+    return number;
+}
+
+static bool isNumber(const std::string& value)
+{
+    size_t i { 0 };
+    size_t digits { 0 };
+
+    if (i < value.size() && ('-' == value[i] || '+' == value[i]))
+    {
+        ++i;
+    }
+
+    for (; i < value.size() && (std::isdigit(static_cast<unsigned char>(value[i])) || '.' == value[i]); ++i)
+    {
+        digits += '.' == value[i] ? 0 : 1;
+    }
+
+    if (digits && i < value.size() && ('e' == value[i] || 'E' == value[i]))
+    {
+        i += i + 1 < value.size() && ('-' == value[i + 1] || '+' == value[i + 1]) ? 2 : 1;
+
+        while (i < value.size() && std::isdigit(static_cast<unsigned char>(value[i])))
+        {
+            ++i;
+        }
+    }
+
+    return digits && i == value.size() && std::count(value.begin(), value.end(), '.') <= 1;
+}
+
+size_t Memory::columnIndex(const Columns& columns, const std::string& name)
+{
+    const auto upperName { Utils::toUpperCase(name) };
+
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        if (Utils::toUpperCase(columns[i].name) == upperName)
+        {
+            return i;
+        }
+    }
+
+    return std::string::npos;
+}
+
+static size_t skipParenthesis(const std::vector<Token>& tokens, size_t position)
+{
+    auto depth { 0 };
+
+    do
+    {
+        if (TokenType::Symbol == tokens[position].type)
+        {
+            if ("(" == tokens[position].value)
+            {
+                ++depth;
+            }
+            else if (")" == tokens[position].value)
+            {
+                --depth;
+            }
+        }
+
+        ++position;
+    }
+    while (depth > 0 && position < tokens.size());
+
+    return position;
+}
+
+static bool like(const std::string& text, const std::string& pattern)
+{
+    size_t t { 0 };
+    size_t p { 0 };
+    size_t wildcardPattern { std::string::npos };
+    size_t wildcardText { 0 };
+
+    while (t < text.size())
+    {
+        if (p < pattern.size() && '%' == pattern[p])
+        {
+            wildcardPattern = p++;
+            wildcardText = t;
+        }
+        else if (p < pattern.size() &&
+                 ('_' == pattern[p] ||
+                  std::tolower(static_cast<unsigned char>(pattern[p])) == std::tolower(static_cast<unsigned char>(text[t]))))
+        {
+            ++t;
+            ++p;
+        }
+        else if (std::string::npos != wildcardPattern)
+        {
+            p = wildcardPattern + 1;
+            t = ++wildcardText;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && '%' == pattern[p])
+    {
+        ++p;
+    }
+
+    return p == pattern.size();
+}
+
+std::vector<Token> Memory::tokenize(const std::string& sql)
+{
+    std::vector<Token> tokens;
+    size_t i { 0 };
+
+    while (i < sql.size())
+    {
+        const auto c { static_cast<unsigned char>(sql[i]) };
+        auto j { i + 1 };
+
+        if (std::isspace(c))
+        {
+            ++i;
+            continue;
+        }
+
+        if (std::isalpha(c) || '_' == c)
+        {
+            while (j < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[j])) || '_' == sql[j]))
+            {
+                ++j;
+            }
+
+            tokens.push_back({ TokenType::Identifier, sql.substr(i, j - i) });
+        }
+        else if (std::isdigit(c) || ('.' == c && j < sql.size() && std::isdigit(static_cast<unsigned char>(sql[j]))))
+        {
+            while (j < sql.size() && (std::isdigit(static_cast<unsigned char>(sql[j])) || '.' == sql[j]))
+            {
+                ++j;
+            }
+
+            if (j < sql.size() && ('e' == sql[j] || 'E' == sql[j]))
+            {
+                ++j;
+
+                if (j < sql.size() && ('+' == sql[j] || '-' == sql[j]))
+                {
+                    ++j;
+                }
+
+                while (j < sql.size() && std::isdigit(static_cast<unsigned char>(sql[j])))
+                {
+                    ++j;
+                }
+            }
+
+            tokens.push_back({ TokenType::Number, sql.substr(i, j - i) });
+        }
+        else if ('\'' == c || '"' == c || '`' == c)
+        {
+            std::string value;
+
+            // A doubled quote stands for the quote itself.
+            while (j < sql.size() && (sql[j] != sql[i] || (j + 1 < sql.size() && sql[j + 1] == sql[i])))
+            {
+                value += sql[j];
+                j += sql[j] == sql[i] ? 2 : 1;
+            }
+
+            if (j == sql.size())
+            {
+                throw dbengine_error { SQL_STMT_ERROR };
+            }
+
+            ++j;
+            tokens.push_back({ '\'' == c ? TokenType::String : '"' == c ? TokenType::Quoted : TokenType::Identifier, value });
+        }
+        else
+        {
+            const auto pair { sql.substr(i, 2) };
+
+            if ("<=" == pair || ">=" == pair || "<>" == pair || "!=" == pair || "==" == pair)
+            {
+                ++j;
+            }
+
+            tokens.push_back({ TokenType::Symbol, sql.substr(i, j - i) });
+        }
+
+        i = j;
+    }
+
+    tokens.push_back({ TokenType::End, "" });
+    return tokens;
+}
+
+nlohmann::json Memory::literalValue(const Token& token, const ColumnType type)
+{
+    nlohmann::json value;
+
+    if (TokenType::Number == token.type)
+    {
+        value = ColumnType::Text == type ? nlohmann::json(token.value) : numberValue(token.value);
+    }
+    else if (TokenType::String == token.type || TokenType::Quoted == token.type)
+    {
+        // Numeric columns compare text that looks like a number as a number.
+        value = isNumericType(type) && isNumber(token.value) ? numberValue(token.value) : nlohmann::json(token.value);
+    }
+    else if (!isKeyword(token, "NULL"))
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+
+    if (ColumnType::Double == type && value.is_number())
+    {
+        value = value.get<double>();
+    }
+
+    return value;
+}
+
+static Column parseColumnDefinition(const std::vector<Token>& tokens)
+{
+    static const std::vector<std::string> CONSTRAINT_KEYWORDS
+    {
+        "PRIMARY", "NOT", "NULL", "DEFAULT", "CHECK", "UNIQUE", "REFERENCES",
+        "COLLATE", "CONSTRAINT", "GENERATED", "AS", "HIDDEN"
+    };
+
+    Column column { tokens[0].value, ColumnType::Unknown, false, nullptr };
+    std::string typeName;
+    size_t i { 1 };
+
+    while (TokenType::Identifier == tokens[i].type &&
+            CONSTRAINT_KEYWORDS.end() == std::find(CONSTRAINT_KEYWORDS.begin(),
+                                                   CONSTRAINT_KEYWORDS.end(),
+                                                   Utils::toUpperCase(tokens[i].value)))
+    {
+        typeName += (typeName.empty() ? "" : " ") + Utils::toUpperCase(tokens[i].value);
+        ++i;
+    }
+
+    const auto it { ColumnTypeNames.find(typeName) };
+
+    if (ColumnTypeNames.end() != it)
+    {
+        column.type = it->second;
+    }
+
+    while (TokenType::End != tokens[i].type)
+    {
+        if (TokenType::Symbol == tokens[i].type && "(" == tokens[i].value)
+        {
+            i = skipParenthesis(tokens, i);
+        }
+        else if (isKeyword(tokens[i], "PRIMARY"))
+        {
+            column.primaryKey = true;
+            ++i;
+        }
+        else if (isKeyword(tokens[i], "DEFAULT") && TokenType::End != tokens[i + 1].type)
+        {
+            auto token { tokens[i + 1] };
+            i += 2;
+
+            if (TokenType::Symbol == token.type && "-" == token.value && TokenType::Number == tokens[i].type)
+            {
+                token = { TokenType::Number, "-" + tokens[i].value };
+                ++i;
+            }
+
+            if (TokenType::Symbol != token.type)
+            {
+                column.defaultValue = literalValue(token, column.type);
+            }
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return column;
+}
+
+static void parseTableDefinition(const std::vector<Token>& tokens,
+                                 size_t i,
+                                 TableDefinition& table)
+{
+    std::vector<std::string> primaryKeyNames;
+
+    while (i < tokens.size() && TokenType::End != tokens[i].type)
+    {
+        std::vector<Token> definition;
+
+        // Each definition ends at a comma or at the closing parenthesis of the table.
+        while (TokenType::End != tokens[i].type &&
+                !(TokenType::Symbol == tokens[i].type && ("," == tokens[i].value || ")" == tokens[i].value)))
+        {
+            const auto next { TokenType::Symbol == tokens[i].type && "(" == tokens[i].value ? skipParenthesis(tokens, i) : i + 1 };
+            definition.insert(definition.end(), tokens.begin() + i, tokens.begin() + next);
+            i = next;
+        }
+
+        definition.push_back({ TokenType::End, "" });
+
+        if (isKeyword(definition[0], "PRIMARY"))
+        {
+            for (size_t j = 1; TokenType::End != definition[j].type; ++j)
+            {
+                if ((TokenType::Identifier == definition[j].type || TokenType::Quoted == definition[j].type) &&
+                        !isKeyword(definition[j], "KEY") && !isKeyword(definition[j], "ASC") && !isKeyword(definition[j], "DESC"))
+                {
+                    primaryKeyNames.push_back(definition[j].value);
+                }
+            }
+        }
+        else if (TokenType::Identifier == definition[0].type || TokenType::Quoted == definition[0].type)
+        {
+            if (!isKeyword(definition[0], "CONSTRAINT") &&
+                    !isKeyword(definition[0], "UNIQUE") &&
+                    !isKeyword(definition[0], "CHECK") &&
+                    !isKeyword(definition[0], "FOREIGN"))
+            {
+                table.columns.push_back(parseColumnDefinition(definition));
+            }
+        }
+
+        if (TokenType::Symbol == tokens[i].type && ")" == tokens[i].value)
+        {
+            break;
+        }
+
+        ++i;
+    }
+
+    for (size_t j = 0; j < table.columns.size(); ++j)
+    {
+        if (table.columns[j].primaryKey)
+        {
+            table.primaryKeys.push_back(j);
+        }
+    }
+
+    for (const auto& name : primaryKeyNames)
+    {
+        const auto index { columnIndex(table.columns, name) };
+
+        if (std::string::npos == index)
+        {
+            throw dbengine_error { STEP_ERROR_CREATE_STMT };
+        }
+
+        if (!table.columns[index].primaryKey)
+        {
+            table.columns[index].primaryKey = true;
+            table.primaryKeys.push_back(index);
+        }
+    }
+}
+
+std::vector<TableDefinition> Memory::parseCreateStatements(const std::string& sql)
+{
+    std::vector<TableDefinition> tables;
+
+    for (const auto& statement : Utils::split(sql, ';'))
+    {
+        const auto tokens { tokenize(statement) };
+        size_t i { 0 };
+
+        if (!isKeyword(tokens[i++], "CREATE"))
+        {
+            continue;
+        }
+
+        if (isKeyword(tokens[i], "TEMP") || isKeyword(tokens[i], "TEMPORARY"))
+        {
+            ++i;
+        }
+
+        // Indexes and the other schema objects are not needed to keep rows in memory.
+        if (!isKeyword(tokens[i++], "TABLE"))
+        {
+            continue;
+        }
+
+        if (isKeyword(tokens[i], "IF"))
+        {
+            i += 3;
+        }
+
+        if (TokenType::Identifier != tokens[i].type && TokenType::Quoted != tokens[i].type)
+        {
+            throw dbengine_error { STEP_ERROR_CREATE_STMT };
+        }
+
+        TableDefinition table;
+        table.name = tokens[i++].value;
+
+        if (TokenType::Symbol != tokens[i].type || "(" != tokens[i].value)
+        {
+            throw dbengine_error { STEP_ERROR_CREATE_STMT };
+        }
+
+        parseTableDefinition(tokens, i + 1, table);
+        tables.push_back(std::move(table));
+    }
+
+    return tables;
+}
+
+Filter::Filter(const Columns& columns,
+               const std::string& filter)
+    : m_columns { columns }
+    , m_tokens { tokenize(filter) }
+    , m_position { 0 }
+    , m_root { NO_CONDITION }
+{
+    // The WHERE keyword is optional, as the deletion filters only have the condition.
+    if (accept("WHERE") ||
+            (TokenType::End != m_tokens[m_position].type && !isKeyword(m_tokens[m_position], "ORDER")))
+    {
+        m_root = parseOr();
+    }
+
+    if (accept("ORDER"))
+    {
+        expect("BY");
+        parseOrderList();
+    }
+
+    expect("");
+}
+
+bool Filter::match(const Row& row) const
+{
+    return NO_CONDITION == m_root || 1 == evaluate(m_root, row);
+}
+
+bool Filter::keyRange(const size_t column,
+                      nlohmann::json& low,
+                      nlohmann::json& high) const
+{
+    return NO_CONDITION != m_root && keyRange(m_root, column, low, high);
+}
+
+void Filter::addOrderBy(const std::string& clause)
+{
+    m_tokens = tokenize(clause);
+    m_position = 0;
+    parseOrderList();
+    expect("");
+}
+
+size_t Filter::parseOr()
+{
+    auto left { parseAnd() };
+
+    while (accept("OR"))
+    {
+        const auto right { parseAnd() };
+        left = addCondition({ Or, 0, nullptr, nullptr, left, right });
+    }
+
+    return left;
+}
+
+size_t Filter::parseAnd()
+{
+    auto left { parseNot() };
+
+    while (accept("AND"))
+    {
+        const auto right { parseNot() };
+        left = addCondition({ And, 0, nullptr, nullptr, left, right });
+    }
+
+    return left;
+}
+
+size_t Filter::parseNot()
+{
+    if (accept("NOT"))
+    {
+        return addCondition({ Not, 0, nullptr, nullptr, parseNot(), NO_CONDITION });
+    }
+
+    return parsePredicate();
+}
+
+size_t Filter::parsePredicate()
+{
+    static const std::map<std::string, Operator> OPERATORS
+    {
+        { "=", Equal },
+        { "==", Equal },
+        { "!=", NotEqual },
+        { "<>", NotEqual },
+        { "<", Less },
+        { "<=", LessEqual },
+        { ">", Greater },
+        { ">=", GreaterEqual }
+    };
+
+    size_t index { NO_CONDITION };
+
+    if (accept("("))
+    {
+        index = parseOr();
+        expect(")");
+        return index;
+    }
+
+    const auto column { parseColumn() };
+
+    if (accept("IS"))
+    {
+        const auto negate { accept("NOT") };
+        expect("NULL");
+        index = addCondition({ IsNull, column, nullptr, nullptr, NO_CONDITION, NO_CONDITION });
+        return negate ? addCondition({ Not, 0, nullptr, nullptr, index, NO_CONDITION }) : index;
+    }
+
+    const auto negate { accept("NOT") };
+
+    if (accept("BETWEEN"))
+    {
+        const auto low = parseLiteral(column);
+        expect("AND");
+        index = addCondition({ Between, column, low, parseLiteral(column), NO_CONDITION, NO_CONDITION });
+    }
+    else if (accept("LIKE"))
+    {
+        const auto& token { m_tokens[m_position++] };
+
+        if (TokenType::String != token.type && TokenType::Quoted != token.type)
+        {
+            throw dbengine_error { SQL_STMT_ERROR };
+        }
+
+        index = addCondition({ Like, column, token.value, nullptr, NO_CONDITION, NO_CONDITION });
+    }
+    else
+    {
+        const auto& token { m_tokens[m_position++] };
+        const auto it { OPERATORS.find(token.value) };
+
+        if (negate || TokenType::Symbol != token.type || OPERATORS.end() == it)
+        {
+            throw dbengine_error { SQL_STMT_ERROR };
+        }
+
+        index = addCondition({ it->second, column, parseLiteral(column), nullptr, NO_CONDITION, NO_CONDITION });
+    }
+
+    return negate ? addCondition({ Not, 0, nullptr, nullptr, index, NO_CONDITION }) : index;
+}
+
+size_t Filter::parseColumn()
+{
+    const auto& token { m_tokens[m_position++] };
+    const auto column
+    {
+        TokenType::Identifier == token.type || TokenType::Quoted == token.type ? columnIndex(m_columns, token.value) : std::string::npos
+    };
+
+    if (std::string::npos == column)
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+
+    return column;
+}
+
+nlohmann::json Filter::parseLiteral(const size_t column)
+{
+    auto token { m_tokens[m_position++] };
+
+    if (TokenType::Symbol == token.type && "-" == token.value && TokenType::Number == m_tokens[m_position].type)
+    {
+        token = { TokenType::Number, "-" + m_tokens[m_position++].value };
+    }
+
+    // A double quoted column name is an identifier, comparisons between columns are not supported.
+    if (TokenType::Quoted == token.type && std::string::npos != columnIndex(m_columns, token.value))
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+
+    return literalValue(token, m_columns[column].type);
+}
+
+void Filter::parseOrderList()
+{
+    do
+    {
+        const auto column { parseColumn() };
+        const auto descending { accept("DESC") };
+
+        if (!descending)
+        {
+            accept("ASC");
+        }
+
+        m_orderBy.emplace_back(column, descending);
+    }
+    while (accept(","));
+}
+
+bool Filter::accept(const std::string& keyword)
+{
+    const auto& token { m_tokens[m_position] };
+    const auto found
+    {
+        keyword.empty() ? TokenType::End == token.type :
+        TokenType::Symbol == token.type ? keyword == token.value : isKeyword(token, keyword)
+    };
+
+    if (found && TokenType::End != token.type)
+    {
+        ++m_position;
+    }
+
+    return found;
+}
+
+void Filter::expect(const std::string& keyword)
+{
+    if (!accept(keyword))
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+}
+
+size_t Filter::addCondition(const Condition& condition)
+{
+    m_conditions.push_back(condition);
+    return m_conditions.size() - 1;
+}
+
+// Conditions follow the SQL three-valued logic: 1 is true, 0 is false and -1 is unknown.
+int Filter::evaluate(const size_t index, const Row& row) const
+{
+    const auto& condition { m_conditions[index] };
+
+    switch (condition.op)
+    {
+        case And:
+        {
+            const auto left { evaluate(condition.left, row) };
+            const auto right { 0 == left ? 0 : evaluate(condition.right, row) };
+            return 0 == left || 0 == right ? 0 : 1 == left && 1 == right ? 1 : -1;
+        }
+
+        case Or:
+        {
+            const auto left { evaluate(condition.left, row) };
+            const auto right { 1 == left ? 1 : evaluate(condition.right, row) };
+            return 1 == left || 1 == right ? 1 : -1 == left || -1 == right ? -1 : 0;
+        }
+
+        case Not:
+        {
+            const auto result { evaluate(condition.left, row) };
+            return -1 == result ? -1 : 1 - result;
+        }
+
+        case IsNull:
+            return row[condition.column].is_null() ? 1 : 0;
+
+        default:
+            break;
+    }
+
+    const auto& value { row[condition.column] };
+
+    if (value.is_null() || condition.first.is_null() || (Between == condition.op && condition.second.is_null()))
+    {
+        return -1;
+    }
+
+    switch (condition.op)
+    {
+        case Equal:
+            return value == condition.first ? 1 : 0;
+
+        case NotEqual:
+            return value != condition.first ? 1 : 0;
+
+        case Less:
+            return value < condition.first ? 1 : 0;
+
+        case LessEqual:
+            return condition.first < value ? 0 : 1;
+
+        case Greater:
+            return condition.first < value ? 1 : 0;
+
+        case GreaterEqual:
+            return value < condition.first ? 0 : 1;
+
+        case Between:
+            return value < condition.first || condition.second < value ? 0 : 1;
+
+        case Like:
+            return like(value.is_string() ? value.get_ref<const std::string&>() : value.dump(),
+                        condition.first.get_ref<const std::string&>()) ? 1 : 0;
+
+        // LCOV_EXCL_START
+        default:
+            throw dbengine_error { SQL_STMT_ERROR };
+            // LCOV_EXCL_STOP
+    }
+}
+
+bool Filter::keyRange(const size_t index,
+                      const size_t column,
+                      nlohmann::json& low,
+                      nlohmann::json& high) const
+{
+    const auto& condition { m_conditions[index] };
+    auto ret { false };
+
+    if (And == condition.op)
+    {
+        ret = keyRange(condition.left, column, low, high) || keyRange(condition.right, column, low, high);
+    }
+    else if (column == condition.column && !condition.first.is_null())
+    {
+        if (Equal == condition.op)
+        {
+            low = condition.first;
+            high = condition.first;
+            ret = true;
+        }
+        else if (Between == condition.op && !condition.second.is_null())
+        {
+            low = condition.first;
+            high = condition.second;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,138 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _MEMORY_SQL_H
+#define _MEMORY_SQL_H
+
+#include <string>
+#include <vector>
+#include "dbengine.h"
+
+// The memory engine keeps the SQL interface of DBSync: tables are described
+// with CREATE TABLE statements and rows are selected with the WHERE / ORDER BY
+// clauses used by the modules. This is the subset of SQL it understands.
+namespace Memory
+{
+    struct Column final
+    {
+        std::string name;
+        ColumnType type;
+        bool primaryKey;
+        nlohmann::json defaultValue;
+    };
+
+    using Columns = std::vector<Column>;
+
+    using Row = std::vector<nlohmann::json>;
+
+    struct TableDefinition final
+    {
+        std::string name;
+        Columns columns;
+        std::vector<size_t> primaryKeys;
+    };
+
+    enum class TokenType
+    {
+        Identifier,
+        Quoted,
+        String,
+        Number,
+        Symbol,
+        End
+    };
+
+    struct Token final
+    {
+        TokenType type;
+        std::string value;
+    };
+
+    std::vector<Token> tokenize(const std::string& sql);
+
+    size_t columnIndex(const Columns& columns, const std::string& name);
+
+    std::vector<TableDefinition> parseCreateStatements(const std::string& sql);
+
+    nlohmann::json literalValue(const Token& token, const ColumnType type);
+
+    class Filter final
+    {
+        public:
+            Filter(const Columns& columns,
+                   const std::string& filter);
+
+            bool match(const Row& row) const;
+
+            bool keyRange(const size_t column,
+                          nlohmann::json& low,
+                          nlohmann::json& high) const;
+
+            void addOrderBy(const std::string& clause);
+
+            const std::vector<std::pair<size_t, bool>>& orderBy() const
+            {
+                return m_orderBy;
+            }
+
+        private:
+            enum Operator
+            {
+                And,
+                Or,
+                Not,
+                Equal,
+                NotEqual,
+                Less,
+                LessEqual,
+                Greater,
+                GreaterEqual,
+                Between,
+                IsNull,
+                Like
+            };
+
+            struct Condition final
+            {
+                Operator op;
+                size_t column;
+                nlohmann::json first;
+                nlohmann::json second;
+                size_t left;
+                size_t right;
+            };
+
+            size_t parseOr();
+            size_t parseAnd();
+            size_t parseNot();
+            size_t parsePredicate();
+            size_t parseColumn();
+            nlohmann::json parseLiteral(const size_t column);
+            void parseOrderList();
+            bool accept(const std::string& keyword);
+            void expect(const std::string& keyword);
+            size_t addCondition(const Condition& condition);
+            int evaluate(const size_t index, const Row& row) const;
+            bool keyRange(const size_t index,
+                          const size_t column,
+                          nlohmann::json& low,
+                          nlohmann::json& high) const;
+
+            const Columns& m_columns;
+            std::vector<Token> m_tokens;
+            size_t m_position;
+            std::vector<Condition> m_conditions;
+            size_t m_root;
+            std::vector<std::pair<size_t, bool>> m_orderBy;
+    };
+}// namespace Memory
+
+#endif // _MEMORY_SQL_H
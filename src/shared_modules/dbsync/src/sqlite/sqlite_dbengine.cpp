@@ -9,7 +9,9 @@
  * Foundation.
  */
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <thread>
 #include "db_exception.h"
 #include "mapWrapperSafe.h"
@@ -21,7 +23,11 @@
 SQLiteDBEngine::SQLiteDBEngine(const std::shared_ptr<ISQLiteFactory>& sqliteFactory,
                                const std::string& path,
                                const std::string& tableStmtCreation)
-    : m_sqliteFactory(sqliteFactory)
+    : m_statementsPrepared(0)
+    , m_statementsReused(0)
+    , m_statementsEvicted(0)
+    , m_memoryLimit(0)
+    , m_sqliteFactory(sqliteFactory)
 {
     initialize(path, tableStmtCreation);
 }
@@ -29,6 +35,7 @@ SQLiteDBEngine::SQLiteDBEngine(const std::shared_ptr<ISQLiteFactory>& sqliteFact
 SQLiteDBEngine::~SQLiteDBEngine()
 {
     std::lock_guard<std::mutex> lock(m_stmtMutex);
+    m_statementsIndex.clear();
     m_statementsCache.clear();
 }
 
@@ -43,10 +50,6 @@ void SQLiteDBEngine::setMaxRows(const std::string& table,
         {
             throw dbengine_error { MIN_ROW_LIMIT_BELOW_ZERO };
         }
-        else if (0 == maxRows)
-        {
-            m_maxRows.erase(table);
-        }
         else
         {
             const auto stmt
@@ -61,7 +64,8 @@ void SQLiteDBEngine::setMaxRows(const std::string& table,
                     stmt->column(0)->value(int64_t{})
                 };
 
-                m_maxRows[table] = { maxRows, currentRows };
+                // Without a limit the rows are still counted, so getTableRowCount doesn't scan the table.
+                m_maxRows[table] = { 0 == maxRows ? std::numeric_limits<int64_t>::max() : maxRows, currentRows };
             }
             else
             {
@@ -98,46 +102,162 @@ void SQLiteDBEngine::refreshTableData(const nlohmann::json& data,
                                       std::unique_lock<std::shared_timed_mutex>& lock)
 {
     const std::string table { data.at("table").is_string() ? data.at("table").get_ref<const std::string&>() : "" };
+    std::vector<std::string> primaryKeyList;
 
-    if (createCopyTempTable(table))
+    if (0 != loadTableData(table) && getPrimaryKeysFromTable(table, primaryKeyList))
     {
-        bulkInsert(table + TEMP_TABLE_SUBFIX, data.at("data"));
+        const auto& tableFields { m_tableFields[table] };
+        std::map<PrimaryKeyValues, std::pair<FieldHashes, bool>> rowHashes;
+        std::vector<std::pair<PrimaryKeyValues, std::pair<const nlohmann::json*, Row>>> rowsToInsert;
+        std::vector<std::pair<PrimaryKeyValues, Row>> rowsToModify;
+        std::vector<Row> rowsToRemove;
+        const auto notify
+        {
+            [&callback, &lock](const ReturnTypeCallback type, const nlohmann::json & object)
+            {
+                if (callback)
+                {
+                    lock.unlock();
+                    callback(type, object);
+                    lock.lock();
+                }
+            }
+        };
 
-        if (0 != loadTableData(table))
+        if (primaryKeyList.empty())
+        {
+            throw dbengine_error { INVALID_PK_DATA };
+        }
+
+        // A single pass over the stored rows gets the field hashes of each one by primary key.
+        getRowHashes(table, tableFields, rowHashes);
+
+        // A single pass over the snapshot, the changed fields are the ones with a different hash.
+        for (const auto& element : data.at("data"))
         {
-            std::vector<std::string> primaryKeyList;
+            PrimaryKeyValues primaryKeyValues;
+            FieldHashes fieldHashes;
+            getJsonFieldHashes(tableFields, element, primaryKeyValues, fieldHashes);
+            const auto it { rowHashes.find(primaryKeyValues) };
 
-            if (getPrimaryKeysFromTable(table, primaryKeyList))
+            if (rowHashes.end() == it)
+            {
+                Row row;
+                getJsonRowData(tableFields, element, row);
+                // The new key is kept as already seen, so a duplicated row in the snapshot is detected.
+                rowHashes.emplace(primaryKeyValues, std::make_pair(FieldHashes(), true));
+                rowsToInsert.emplace_back(std::move(primaryKeyValues), std::make_pair(&element, std::move(row)));
+            }
+            else if (it->second.second)
             {
-                if (!removeNotExistsRows(table, primaryKeyList, callback, lock))
+                throw dbengine_error { BIND_FIELDS_DOES_NOT_MATCH };
+            }
+            else
+            {
+                Row modifiedFields;
+                it->second.second = true;
+                getModifiedFields(tableFields, element, it->second.first, fieldHashes, modifiedFields);
+
+                if (!modifiedFields.empty())
                 {
-                    // LCOV_EXCL_START
-                    std::cout << "Error during the delete rows update " << __LINE__ << " - " << __FILE__ << std::endl;
-                    // LCOV_EXCL_STOP
+                    rowsToModify.emplace_back(std::move(primaryKeyValues), std::move(modifiedFields));
                 }
+            }
+        }
+
+        for (const auto& value : rowHashes)
+        {
+            if (!value.second.second)
+            {
+                Row primaryKeys;
 
-                if (!changeModifiedRows(table, primaryKeyList, callback, lock))
+                for (size_t i = 0; i < primaryKeyList.size(); ++i)
                 {
-                    // LCOV_EXCL_START
-                    std::cout << "Error during the change of modified rows " << __LINE__ << " - " << __FILE__ << std::endl;
-                    // LCOV_EXCL_STOP
+                    primaryKeys[primaryKeyList[i]] = value.first[i];
                 }
 
-                if (!insertNewRows(table, primaryKeyList, callback, lock))
+                rowsToRemove.push_back(std::move(primaryKeys));
+            }
+        }
+
+        if (!rowsToRemove.empty())
+        {
+            deleteRows(table, primaryKeyList, rowsToRemove);
+
+            for (const auto& row : rowsToRemove)
+            {
+                nlohmann::json object;
+
+                for (const auto& value : row)
                 {
-                    // LCOV_EXCL_START
-                    std::cout << "Error during the insert rows update " << __LINE__ << " - " << __FILE__ << std::endl;
-                    // LCOV_EXCL_STOP
+                    getFieldValueFromTuple(value, object);
                 }
+
+                notify(ReturnTypeCallback::DELETED, object);
             }
         }
-        // LCOV_EXCL_START
-        else
+
+        for (const auto& row : rowsToModify)
         {
-            throw dbengine_error { EMPTY_TABLE_METADATA };
+            updateRowFields(table, tableFields, primaryKeyList, row.first, row.second);
         }
 
-        // LCOV_EXCL_STOP
+        for (const auto& row : rowsToModify)
+        {
+            nlohmann::json object;
+
+            for (size_t i = 0; i < primaryKeyList.size(); ++i)
+            {
+                getFieldValueFromTuple(Field { "PK_" + primaryKeyList[i], row.first[i] }, object);
+            }
+
+            for (const auto& value : row.second)
+            {
+                getFieldValueFromTuple(value, object);
+            }
+
+            notify(ReturnTypeCallback::MODIFIED, object);
+        }
+
+        for (const auto& row : rowsToInsert)
+        {
+            insertElement(table, tableFields, *row.second.first);
+        }
+
+        std::vector<std::string> defaultValueFields;
+        getDefaultValueFields(table, defaultValueFields);
+
+        for (auto& row : rowsToInsert)
+        {
+            nlohmann::json object;
+            auto& insertedRow { row.second.second };
+            auto readStoredRow { false };
+
+            // The fields missing in the snapshot are reported empty, unless the table has a default value for them.
+            for (const auto& field : tableFields)
+            {
+                const auto& name { std::get<TableHeader::Name>(field) };
+
+                if (!std::get<TableHeader::TXNStatusField>(field) && insertedRow.end() == insertedRow.find(name))
+                {
+                    readStoredRow |= defaultValueFields.end() != std::find(defaultValueFields.begin(), defaultValueFields.end(), name);
+                    insertedRow[name] = std::make_tuple(std::get<TableHeader::Type>(field), std::string(), 0, 0, 0, 0);
+                }
+            }
+
+            if (readStoredRow)
+            {
+                insertedRow.clear();
+                getRowByPrimaryKeyValues(table, tableFields, primaryKeyList, row.first, insertedRow);
+            }
+
+            for (const auto& value : insertedRow)
+            {
+                getFieldValueFromTuple(value, object);
+            }
+
+            notify(ReturnTypeCallback::INSERTED, object);
+        }
     }
 }
 
@@ -381,30 +501,20 @@ void SQLiteDBEngine::returnRowsMarkedForDelete(const nlohmann::json& tableNames,
 
             while (SQLITE_ROW == stmt->step())
             {
-                Row registerFields;
+                nlohmann::json object {};
                 auto index { 0 };
 
                 for (const auto& field : tableFields)
                 {
                     if (!std::get<TableHeader::TXNStatusField>(field))
                     {
-                        getTableData(stmt,
-                                     index,
-                                     std::get<TableHeader::Type>(field),
-                                     std::get<TableHeader::Name>(field),
-                                     registerFields);
+                        object[std::get<TableHeader::Name>(field)] =
+                            getFieldValue(getTableFieldData(stmt->column(index), std::get<TableHeader::Type>(field)));
                     }
 
                     ++index;
                 }
 
-                nlohmann::json object {};
-
-                for (const auto& value : registerFields)
-                {
-                    getFieldValueFromTuple(value, object);
-                }
-
                 lock.unlock();
                 callback(ReturnTypeCallback::DELETED, object);
                 lock.lock();
@@ -523,6 +633,88 @@ void SQLiteDBEngine::addTableRelationship(const nlohmann::json& data)
     }
 }
 
+void SQLiteDBEngine::getStatementCacheStats(nlohmann::json& stats)
+{
+    std::lock_guard<std::mutex> lock(m_stmtMutex);
+    stats["prepared"] = m_statementsPrepared;
+    stats["reused"] = m_statementsReused;
+    stats["evicted"] = m_statementsEvicted;
+    stats["cached"] = m_statementsCache.size();
+    stats["limit"] = CACHE_STMT_LIMIT;
+}
+
+void SQLiteDBEngine::setMemoryLimit(const uint64_t limit)
+{
+    // A negative cache size is read as KiB. Once the cache is full, the least
+    // recently used pages are written to the database file and dropped from memory.
+    const auto cacheSize { 0 == limit ? DEFAULT_CACHE_SIZE_KIB : std::max<uint64_t>(limit / 1024, 1) };
+
+    m_sqliteConnection->execute("PRAGMA cache_size = -" + std::to_string(cacheSize) + ";");
+    m_memoryLimit = limit;
+}
+
+void SQLiteDBEngine::getStorageStats(nlohmann::json& stats)
+{
+    const auto status
+    {
+        [this](const int op)
+        {
+            auto current { 0 };
+            auto highwater { 0 };
+
+            if (SQLITE_OK != sqlite3_db_status(m_sqliteConnection->db().get(), op, &current, &highwater, 0))
+            {
+                throw dbengine_error { SQL_STMT_ERROR };
+            }
+
+            return current;
+        }
+    };
+    const auto pragma
+    {
+        [this](const std::string & name)
+        {
+            const auto stmt { getStatement("PRAGMA " + name + ";") };
+
+            if (SQLITE_ROW != stmt->step())
+            {
+                throw dbengine_error { SQL_STMT_ERROR };
+            }
+
+            return stmt->column(0)->value(int64_t{});
+        }
+    };
+
+    stats["memory_used"] = status(SQLITE_DBSTATUS_CACHE_USED);
+    stats["memory_limit"] = m_memoryLimit;
+    stats["db_size"] = pragma("page_count") * pragma("page_size");
+    stats["cache_hit"] = status(SQLITE_DBSTATUS_CACHE_HIT);
+    stats["cache_miss"] = status(SQLITE_DBSTATUS_CACHE_MISS);
+    stats["cache_spill"] = status(SQLITE_DBSTATUS_CACHE_SPILL);
+}
+
+int64_t SQLiteDBEngine::getTableRowCount(const std::string& table)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_maxRowsMutex);
+        const auto it { m_maxRows.find(table) };
+
+        if (it != m_maxRows.end())
+        {
+            return it->second.currentRows;
+        }
+    }
+
+    const auto stmt { getStatement("SELECT COUNT(*) FROM " + table + ";") };
+
+    if (SQLITE_ROW != stmt->step())
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+
+    return stmt->column(0)->value(int64_t{});
+}
+
 ///
 /// Private functions section
 ///
@@ -582,7 +774,20 @@ void SQLiteDBEngine::insertElement(const std::string& table,
                                    const nlohmann::json& element,
                                    const std::function<void()> callback)
 {
-    const auto stmt { getStatement(buildInsertDataSqlQuery(table, element)) };
+    const auto stmt
+    {
+        getStatement(StatementKey
+        {
+            table, StatementType::InsertData, getFieldsMask(tableFieldsMetaData, [&element](const std::string & name)
+            {
+                return element.empty() || element.end() != element.find(name);
+            })
+        },
+        [this, &table, &element]()
+        {
+            return buildInsertDataSqlQuery(table, element);
+        })
+    };
     int32_t index { 1l };
 
     for (const auto& field : tableFieldsMetaData)
@@ -595,8 +800,21 @@ void SQLiteDBEngine::insertElement(const std::string& table,
 
     updateTableRowCounter(table, 1ll);
 
+    auto result { SQLITE_ERROR };
+
+    try
+    {
+        result = stmt->step();
+    }
+    catch (...)
+    {
+        // A rejected row (e.g. a duplicated primary key) must not be counted.
+        updateTableRowCounter(table, -1ll);
+        throw;
+    }
+
     // LCOV_EXCL_START
-    if (SQLITE_ERROR == stmt->step())
+    if (SQLITE_ERROR == result)
     {
         updateTableRowCounter(table, -1ll);
         throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
@@ -720,70 +938,12 @@ bool SQLiteDBEngine::bindJsonData(const std::shared_ptr<SQLite::IStatement> stmt
                                   const unsigned int cid)
 {
     bool retVal { true };
-    const auto type { std::get<TableHeader::Type>(cd) };
     const auto name { std::get<TableHeader::Name>(cd) };
     const auto& it  { valueType.find(name) };
 
     if (valueType.end() != it)
     {
-        const auto& jsData { *it };
-
-        if (ColumnType::BigInt == type)
-        {
-            int64_t value
-            {
-                jsData.is_number() ? jsData.get<int64_t>() : jsData.is_string()
-                && jsData.get_ref<const std::string&>().size()
-                ? std::stoll(jsData.get_ref<const std::string&>())
-                : 0
-            };
-            stmt->bind(cid, value);
-        }
-        else if (ColumnType::UnsignedBigInt == type)
-        {
-            uint64_t value
-            {
-                jsData.is_number_unsigned() ? jsData.get<uint64_t>() : jsData.is_string()
-                && jsData.get_ref<const std::string&>().size()
-                ? std::stoull(jsData.get_ref<const std::string&>())
-                : 0
-            };
-            stmt->bind(cid, value);
-        }
-        else if (ColumnType::Integer == type)
-        {
-            int32_t value
-            {
-                jsData.is_number() ? jsData.get<int32_t>() : jsData.is_string()
-                && jsData.get_ref<const std::string&>().size()
-                ? std::stoi(jsData.get_ref<const std::string&>())
-                : 0
-            };
-            stmt->bind(cid, value);
-        }
-        else if (ColumnType::Text == type)
-        {
-            std::string value
-            {
-                jsData.is_string() ? jsData.get_ref<const std::string&>() : ""
-            };
-            stmt->bind(cid, value);
-        }
-        else if (ColumnType::Double == type)
-        {
-            double_t value
-            {
-                jsData.is_number_float() ? jsData.get<double>() : jsData.is_string()
-                && jsData.get_ref<const std::string&>().size()
-                ? std::stod(jsData.get_ref<const std::string&>())
-                : .0f
-            };
-            stmt->bind(cid, value);
-        }
-        else
-        {
-            throw dbengine_error { INVALID_COLUMN_TYPE };
-        }
+        bindFieldData(stmt, cid, getJsonFieldData(cd, *it));
     }
     else
     {
@@ -793,97 +953,63 @@ bool SQLiteDBEngine::bindJsonData(const std::shared_ptr<SQLite::IStatement> stmt
     return retVal;
 }
 
-bool SQLiteDBEngine::createCopyTempTable(const std::string& table)
+TableField SQLiteDBEngine::getJsonFieldData(const ColumnData& cd,
+                                            const nlohmann::json& jsData)
 {
-    auto ret { false };
-    std::string queryResult;
-    deleteTempTable(table);
+    const auto type { std::get<TableHeader::Type>(cd) };
 
-    if (getTableCreateQuery(table, queryResult))
+    if (ColumnType::BigInt == type)
     {
-        if (Utils::replaceAll(queryResult, "CREATE TABLE " + table, "CREATE TEMP TABLE IF NOT EXISTS " + table + "_TEMP"))
+        const int64_t value
         {
-            const auto stmt { getStatement(queryResult) };
-            ret = SQLITE_DONE == stmt->step();
-        }
+            jsData.is_number() ? jsData.get<int64_t>() : jsData.is_string()
+            && jsData.get_ref<const std::string&>().size()
+            ? std::stoll(jsData.get_ref<const std::string&>())
+            : 0
+        };
+        return TableField { type, std::string(), 0, value, 0, 0 };
     }
-
-    return ret;
-}
-
-void SQLiteDBEngine::deleteTempTable(const std::string& table)
-{
-    try
+    else if (ColumnType::UnsignedBigInt == type)
     {
-        m_sqliteConnection->execute("DELETE FROM " + table + TEMP_TABLE_SUBFIX + ";");
+        const uint64_t value
+        {
+            jsData.is_number_unsigned() ? jsData.get<uint64_t>() : jsData.is_string()
+            && jsData.get_ref<const std::string&>().size()
+            ? std::stoull(jsData.get_ref<const std::string&>())
+            : 0
+        };
+        return TableField { type, std::string(), 0, 0, value, 0 };
     }
-    //if the table doesn't exist we don't care.
-    // LCOV_EXCL_START
-    catch (const std::exception& ex)
+    else if (ColumnType::Integer == type)
     {
+        const int32_t value
+        {
+            jsData.is_number() ? jsData.get<int32_t>() : jsData.is_string()
+            && jsData.get_ref<const std::string&>().size()
+            ? std::stoi(jsData.get_ref<const std::string&>())
+            : 0
+        };
+        return TableField { type, std::string(), value, 0, 0, 0 };
     }
-
-    // LCOV_EXCL_STOP
-}
-
-bool SQLiteDBEngine::getTableCreateQuery(const std::string& table,
-                                         std::string& resultQuery)
-{
-    auto ret { false };
-    const std::string sql { "SELECT sql FROM sqlite_master WHERE type='table' AND name=?;" };
-
-    if (!table.empty())
+    else if (ColumnType::Text == type)
     {
-        const auto stmt { getStatement(sql) };
-        stmt->bind(1, table);
-
-        while (SQLITE_ROW == stmt->step())
-        {
-            resultQuery.append(std::move(stmt->column(0)->value(std::string{})));
-            resultQuery.append(";");
-            ret = true;
-        }
+        return TableField { type, jsData.is_string() ? jsData.get_ref<const std::string&>() : "", 0, 0, 0, 0 };
     }
-
-    return ret;
-}
-
-bool SQLiteDBEngine::removeNotExistsRows(const std::string& table,
-                                         const std::vector<std::string>& primaryKeyList,
-                                         const DbSync::ResultCallback callback,
-                                         std::unique_lock<std::shared_timed_mutex>& lock)
-{
-    auto ret { true };
-    std::vector<Row> rowKeysValue;
-
-    if (getPKListLeftOnly(table, table + TEMP_TABLE_SUBFIX, primaryKeyList, rowKeysValue))
+    else if (ColumnType::Double == type)
     {
-        if (deleteRows(table, primaryKeyList, rowKeysValue))
-        {
-            for (const auto& row : rowKeysValue)
-            {
-                nlohmann::json object;
-
-                for (const auto& value : row)
-                {
-                    getFieldValueFromTuple(value, object);
-                }
-
-                if (callback)
-                {
-                    lock.unlock();
-                    callback(ReturnTypeCallback::DELETED, object);
-                    lock.lock();
-                }
-            }
-        }
-        else
+        const double_t value
         {
-            ret = false;
-        }
+            jsData.is_number_float() ? jsData.get<double>() : jsData.is_string()
+            && jsData.get_ref<const std::string&>().size()
+            ? std::stod(jsData.get_ref<const std::string&>())
+            : .0f
+        };
+        return TableField { type, std::string(), 0, 0, 0, value };
+    }
+    else
+    {
+        throw dbengine_error { INVALID_COLUMN_TYPE };
     }
-
-    return ret;
 }
 
 bool SQLiteDBEngine::getPrimaryKeysFromTable(const std::string& table,
@@ -910,26 +1036,32 @@ void SQLiteDBEngine::getTableData(std::shared_ptr<SQLite::IStatement>const stmt,
                                   const ColumnType& type,
                                   const std::string& fieldName,
                                   Row& row)
+{
+    row[fieldName] = getTableFieldData(stmt->column(index), type);
+}
+
+TableField SQLiteDBEngine::getTableFieldData(const std::unique_ptr<SQLite::IColumn>& column,
+                                             const ColumnType& type)
 {
     if (ColumnType::BigInt == type)
     {
-        row[fieldName] = std::make_tuple(type, std::string(), 0, stmt->column(index)->value(int64_t{}), 0, 0);
+        return std::make_tuple(type, std::string(), 0, column->value(int64_t{}), 0, 0);
     }
     else if (ColumnType::UnsignedBigInt == type)
     {
-        row[fieldName] = std::make_tuple(type, std::string(), 0, 0, stmt->column(index)->value(int64_t{}), 0);
+        return std::make_tuple(type, std::string(), 0, 0, column->value(int64_t{}), 0);
     }
     else if (ColumnType::Integer == type)
     {
-        row[fieldName] = std::make_tuple(type, std::string(), stmt->column(index)->value(int32_t{}), 0, 0, 0);
+        return std::make_tuple(type, std::string(), column->value(int32_t{}), 0, 0, 0);
     }
     else if (ColumnType::Text == type)
     {
-        row[fieldName] = std::make_tuple(type, stmt->column(index)->value(std::string{}), 0, 0, 0, 0);
+        return std::make_tuple(type, column->value(std::string{}), 0, 0, 0, 0);
     }
     else if (ColumnType::Double == type)
     {
-        row[fieldName] = std::make_tuple(type, std::string(), 0, 0, 0, stmt->column(index)->value(double_t{}));
+        return std::make_tuple(type, std::string(), 0, 0, 0, column->value(double_t{}));
     }
     else
     {
@@ -937,162 +1069,352 @@ void SQLiteDBEngine::getTableData(std::shared_ptr<SQLite::IStatement>const stmt,
     }
 }
 
-bool SQLiteDBEngine::getLeftOnly(const std::string& t1,
-                                 const std::string& t2,
-                                 const std::vector<std::string>& primaryKeyList,
-                                 std::vector<Row>& returnRows)
+std::string SQLiteDBEngine::buildDeleteBulkDataSqlQuery(const std::string& table,
+                                                        const std::vector<std::string>& primaryKeyList)
 {
-    auto ret { false };
-    const std::string query { buildLeftOnlyQuery(t1, t2, primaryKeyList) };
+    std::string sql{ "DELETE FROM " };
+    sql.append(table);
+    sql.append(" WHERE ");
 
-    if (!t1.empty() && !query.empty())
+    if (0 != primaryKeyList.size())
     {
-        const auto stmt { getStatement(query) };
-        const auto tableFields { m_tableFields[t1] };
-
-        while (SQLITE_ROW == stmt->step())
+        for (const auto& value : primaryKeyList)
         {
-            Row registerFields;
+            sql.append(value);
+            sql.append("=? AND ");
+        }
 
-            for (const auto& field : tableFields)
-            {
-                getTableData(stmt,
-                             std::get<TableHeader::CID>(field),
-                             std::get<TableHeader::Type>(field),
-                             std::get<TableHeader::Name>(field),
-                             registerFields);
+        sql = sql.substr(0, sql.size() - 5);
+        sql.append(";");
+    }
+    // LCOV_EXCL_START
+    else
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
+
+    // LCOV_EXCL_STOP
+    return sql;
+}
+
+bool SQLiteDBEngine::deleteRows(const std::string& table,
+                                const std::vector<std::string>& primaryKeyList,
+                                const std::vector<Row>& rowsToRemove)
+{
+    auto ret { false };
+    const auto sql { buildDeleteBulkDataSqlQuery(table, primaryKeyList) };
+
+    if (!sql.empty())
+    {
+        const auto stmt { getStatement(sql) };
+
+        for (const auto& row : rowsToRemove)
+        {
+            auto index {1l};
+
+            for (const auto& value : primaryKeyList)
+            {
+                bindFieldData(stmt, index, row.at(value));
+                ++index;
             }
 
-            returnRows.push_back(std::move(registerFields));
+            // LCOV_EXCL_START
+            if (SQLITE_ERROR == stmt->step())
+            {
+                throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
+            }
+
+            updateTableRowCounter(table, m_sqliteConnection->changes() * -1ll);
+
+            // LCOV_EXCL_STOP
+            stmt->reset();
         }
 
         ret = true;
     }
+    // LCOV_EXCL_START
+    else
+    {
+        throw dbengine_error { SQL_STMT_ERROR };
+    }
 
+    // LCOV_EXCL_STOP
     return ret;
 }
 
-bool SQLiteDBEngine::getPKListLeftOnly(const std::string& t1,
-                                       const std::string& t2,
-                                       const std::vector<std::string>& primaryKeyList,
-                                       std::vector<Row>& returnRows)
+void SQLiteDBEngine::getJsonRowData(const TableColumns& tableFields,
+                                    const nlohmann::json& element,
+                                    Row& row)
 {
-    auto ret { false };
-    const std::string sql { buildLeftOnlyQuery(t1, t2, primaryKeyList, true) };
+    for (const auto& field : tableFields)
+    {
+        const auto& name { std::get<TableHeader::Name>(field) };
+        const auto it { element.find(name) };
+
+        if (element.end() != it && !std::get<TableHeader::TXNStatusField>(field))
+        {
+            row[name] = getJsonFieldData(field, *it);
+        }
+    }
+}
 
-    if (!t1.empty() && !sql.empty())
+void SQLiteDBEngine::getTableRowData(std::shared_ptr<SQLite::IStatement>const stmt,
+                                     const TableColumns& tableFields,
+                                     Row& row)
+{
+    for (const auto& field : tableFields)
     {
-        const auto stmt { getStatement(sql) };
-        const auto tableFields { m_tableFields[t1] };
+        if (!std::get<TableHeader::TXNStatusField>(field))
+        {
+            getTableData(stmt,
+                         std::get<TableHeader::CID>(field),
+                         std::get<TableHeader::Type>(field),
+                         std::get<TableHeader::Name>(field),
+                         row);
+        }
+    }
+}
 
-        while (SQLITE_ROW == stmt->step())
+size_t SQLiteDBEngine::getFieldHash(const int32_t cid,
+                                    const TableField& field)
+{
+    size_t hash { std::hash<int32_t> {}(cid) };
+    const auto combine
+    {
+        [&hash](const size_t value)
         {
-            Row registerFields;
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+    };
 
-            for (const auto& pkValue : primaryKeyList)
+    combine(std::hash<std::string> {}(std::get<GenericTupleIndex::GenString>(field)));
+    combine(std::hash<int32_t> {}(std::get<GenericTupleIndex::GenInteger>(field)));
+    combine(std::hash<int64_t> {}(std::get<GenericTupleIndex::GenBigInt>(field)));
+    combine(std::hash<uint64_t> {}(std::get<GenericTupleIndex::GenUnsignedBigInt>(field)));
+    combine(std::hash<double_t> {}(std::get<GenericTupleIndex::GenDouble>(field)));
+    return hash;
+}
+
+void SQLiteDBEngine::getJsonFieldHashes(const TableColumns& tableFields,
+                                        const nlohmann::json& element,
+                                        PrimaryKeyValues& primaryKeyValues,
+                                        FieldHashes& fieldHashes)
+{
+    size_t primaryKeysCount { 0 };
+    fieldHashes.resize(tableFields.size());
+
+    // A zero hash means that the field is missing in the snapshot.
+    for (size_t i = 0; i < tableFields.size(); ++i)
+    {
+        const auto& field { tableFields[i] };
+        const auto isPrimaryKey { std::get<TableHeader::PK>(field) };
+        const auto it { element.find(std::get<TableHeader::Name>(field)) };
+
+        if (isPrimaryKey)
+        {
+            ++primaryKeysCount;
+        }
+
+        if (element.end() != it && !std::get<TableHeader::TXNStatusField>(field))
+        {
+            const auto value { getJsonFieldData(field, *it) };
+            fieldHashes[i] = getFieldHash(std::get<TableHeader::CID>(field), value);
+
+            if (isPrimaryKey)
             {
-                auto index { 0ull };
-                const auto& it
-                {
-                    std::find_if(tableFields.begin(), tableFields.end(),
-                                 [&pkValue](const ColumnData & columnData)
-                    {
-                        return std::get<TableHeader::Name>(columnData) == pkValue;
-                    })
-                };
+                primaryKeyValues.push_back(value);
+            }
+        }
+    }
+
+    if (primaryKeysCount != primaryKeyValues.size())
+    {
+        throw dbengine_error { BIND_FIELDS_DOES_NOT_MATCH };
+    }
+}
 
-                if (tableFields.end() != it)
+void SQLiteDBEngine::getTableFieldHashes(std::shared_ptr<SQLite::IStatement>const stmt,
+                                         const TableColumns& tableFields,
+                                         PrimaryKeyValues& primaryKeyValues,
+                                         FieldHashes& fieldHashes)
+{
+    fieldHashes.resize(tableFields.size());
+
+    // A zero hash means that the stored field is null, it is treated like a field missing in the snapshot.
+    for (size_t i = 0; i < tableFields.size(); ++i)
+    {
+        const auto& field { tableFields[i] };
+
+        if (!std::get<TableHeader::TXNStatusField>(field))
+        {
+            const auto index { std::get<TableHeader::CID>(field) };
+            const auto isPrimaryKey { std::get<TableHeader::PK>(field) };
+            const auto column { stmt->column(index) };
+
+            if (isPrimaryKey || column->hasValue())
+            {
+                const auto value { getTableFieldData(column, std::get<TableHeader::Type>(field)) };
+                fieldHashes[i] = getFieldHash(index, value);
+
+                if (isPrimaryKey)
                 {
-                    getTableData(stmt,
-                                 index,
-                                 std::get<TableHeader::Type>(*it),
-                                 std::get<TableHeader::Name>(*it),
-                                 registerFields);
+                    primaryKeyValues.push_back(value);
                 }
-
-                ++index;
             }
+        }
+    }
+}
+
+void SQLiteDBEngine::getRowHashes(const std::string& table,
+                                  const TableColumns& tableFields,
+                                  std::map<PrimaryKeyValues, std::pair<FieldHashes, bool>>& rowHashes)
+{
+    const auto stmt { getStatement("SELECT * FROM " + table + ";") };
 
-            returnRows.push_back(std::move(registerFields));
+    while (SQLITE_ROW == stmt->step())
+    {
+        PrimaryKeyValues primaryKeyValues;
+        FieldHashes fieldHashes;
+        getTableFieldHashes(stmt, tableFields, primaryKeyValues, fieldHashes);
+        rowHashes.emplace(std::move(primaryKeyValues), std::make_pair(std::move(fieldHashes), false));
+    }
+}
+
+void SQLiteDBEngine::getModifiedFields(const TableColumns& tableFields,
+                                       const nlohmann::json& element,
+                                       const FieldHashes& storedHashes,
+                                       const FieldHashes& fieldHashes,
+                                       Row& modifiedFields)
+{
+    for (size_t i = 0; i < tableFields.size(); ++i)
+    {
+        const auto& field { tableFields[i] };
+
+        // A null stored field that gets a value in the snapshot is also a change.
+        if (0 != fieldHashes[i] && storedHashes[i] != fieldHashes[i] && !std::get<TableHeader::PK>(field))
+        {
+            const auto& name { std::get<TableHeader::Name>(field) };
+            modifiedFields[name] = getJsonFieldData(field, element.at(name));
         }
+    }
+}
 
-        ret = true;
+void SQLiteDBEngine::getDefaultValueFields(const std::string& table,
+                                           std::vector<std::string>& fields)
+{
+    const auto stmt { getStatement("PRAGMA table_info(" + table + ");") };
+
+    while (SQLITE_ROW == stmt->step())
+    {
+        if (stmt->column(4)->hasValue())
+        {
+            fields.push_back(stmt->column(1)->value(std::string{}));
+        }
+    }
+}
+
+bool SQLiteDBEngine::getRowByPrimaryKeyValues(const std::string& table,
+                                              const TableColumns& tableFields,
+                                              const std::vector<std::string>& primaryKeyList,
+                                              const PrimaryKeyValues& primaryKeyValues,
+                                              Row& row)
+{
+    const auto stmt { getStatement(buildSelectMatchingPKsSqlQuery(table, primaryKeyList)) };
+    int32_t index { 1l };
+
+    for (const auto& value : primaryKeyValues)
+    {
+        bindFieldData(stmt, index, value);
+        ++index;
+    }
+
+    const auto ret { SQLITE_ROW == stmt->step() };
+
+    if (ret)
+    {
+        getTableRowData(stmt, tableFields, row);
     }
 
     return ret;
 }
 
-std::string SQLiteDBEngine::buildDeleteBulkDataSqlQuery(const std::string& table,
-                                                        const std::vector<std::string>& primaryKeyList)
+std::string SQLiteDBEngine::buildUpdateRowSqlQuery(const std::string& table,
+                                                   const std::vector<std::string>& primaryKeyList,
+                                                   const Row& fields)
 {
-    std::string sql{ "DELETE FROM " };
-    sql.append(table);
-    sql.append(" WHERE ");
+    std::string sql{ "UPDATE " + table + " SET " };
 
-    if (0 != primaryKeyList.size())
+    if (0 != primaryKeyList.size() && !fields.empty())
     {
+        for (const auto& field : fields)
+        {
+            sql.append(field.first);
+            sql.append("=?,");
+        }
+
+        sql = sql.substr(0, sql.size() - 1); // Remove the last " , "
+        sql.append(" WHERE ");
+
         for (const auto& value : primaryKeyList)
         {
             sql.append(value);
             sql.append("=? AND ");
         }
 
-        sql = sql.substr(0, sql.size() - 5);
+        sql = sql.substr(0, sql.size() - 5); // Remove the last " AND "
         sql.append(";");
     }
     // LCOV_EXCL_START
     else
     {
-        throw dbengine_error { SQL_STMT_ERROR };
+        throw dbengine_error{ SQL_STMT_ERROR };
     }
 
     // LCOV_EXCL_STOP
     return sql;
 }
 
-bool SQLiteDBEngine::deleteRows(const std::string& table,
-                                const std::vector<std::string>& primaryKeyList,
-                                const std::vector<Row>& rowsToRemove)
+void SQLiteDBEngine::updateRowFields(const std::string& table,
+                                     const TableColumns& tableFields,
+                                     const std::vector<std::string>& primaryKeyList,
+                                     const PrimaryKeyValues& primaryKeyValues,
+                                     const Row& fields)
 {
-    auto ret { false };
-    const auto sql { buildDeleteBulkDataSqlQuery(table, primaryKeyList) };
-
-    if (!sql.empty())
+    const auto stmt
     {
-        const auto stmt { getStatement(sql) };
-
-        for (const auto& row : rowsToRemove)
+        getStatement(StatementKey
         {
-            auto index {1l};
-
-            for (const auto& value : primaryKeyList)
+            table, StatementType::UpdateRowFields, getFieldsMask(tableFields, [&fields](const std::string & name)
             {
-                bindFieldData(stmt, index, row.at(value));
-                ++index;
-            }
-
-            // LCOV_EXCL_START
-            if (SQLITE_ERROR == stmt->step())
-            {
-                throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
-            }
-
-            updateTableRowCounter(table, m_sqliteConnection->changes() * -1ll);
+                return fields.end() != fields.find(name);
+            })
+        },
+        [this, &table, &primaryKeyList, &fields]()
+        {
+            return buildUpdateRowSqlQuery(table, primaryKeyList, fields);
+        })
+    };
+    int32_t index { 1l };
 
-            // LCOV_EXCL_STOP
-            stmt->reset();
-        }
+    for (const auto& field : fields)
+    {
+        bindFieldData(stmt, index, field.second);
+        ++index;
+    }
 
-        ret = true;
+    for (const auto& value : primaryKeyValues)
+    {
+        bindFieldData(stmt, index, value);
+        ++index;
     }
+
     // LCOV_EXCL_START
-    else
+    if (SQLITE_ERROR == stmt->step())
     {
-        throw dbengine_error { SQL_STMT_ERROR };
+        throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
     }
 
     // LCOV_EXCL_STOP
-    return ret;
 }
 
 void SQLiteDBEngine::deleteRowsbyPK(const std::string& table,
@@ -1232,41 +1554,6 @@ std::string SQLiteDBEngine::buildSelectQuery(const std::string& table,
     return sql;
 }
 
-std::string SQLiteDBEngine::buildLeftOnlyQuery(const std::string& t1,
-                                               const std::string& t2,
-                                               const std::vector<std::string>& primaryKeyList,
-                                               const bool returnOnlyPKFields)
-{
-    std::string fieldsList;
-    std::string onMatchList;
-    std::string nullFilterList;
-
-    for (const auto& value : primaryKeyList)
-    {
-        if (returnOnlyPKFields)
-        {
-            fieldsList.append("t1." + value + ",");
-        }
-
-        onMatchList.append("t1." + value + "= t2." + value + " AND ");
-        nullFilterList.append("t2." + value + " IS NULL AND ");
-    }
-
-    if (returnOnlyPKFields)
-    {
-        fieldsList = fieldsList.substr(0, fieldsList.size() - 1);
-    }
-    else
-    {
-        fieldsList.append("*");
-    }
-
-    onMatchList = onMatchList.substr(0, onMatchList.size() - 5);
-    nullFilterList = nullFilterList.substr(0, nullFilterList.size() - 5);
-
-    return "SELECT " + fieldsList + " FROM " + t1 + " t1 LEFT JOIN " + t2 + " t2 ON " + onMatchList + " WHERE " + nullFilterList + ";";
-}
-
 bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
                                 const nlohmann::json& ignoredColumns,
                                 const std::string& table,
@@ -1309,41 +1596,28 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
 
     if (diffExist)
     {
-        // The row exists, so let's generate the diff
-        Row registryFields;
-
+        // The row exists, so let's generate the diff. The stored fields are compared as they are read,
+        // only the modified ones are converted to json.
         for (const auto& field : tableFields)
         {
-            getTableData(stmt,
-                         std::get<TableHeader::CID>(field),
-                         std::get<TableHeader::Type>(field),
-                         std::get<TableHeader::Name>(field),
-                         registryFields);
-        }
+            const auto& name { std::get<TableHeader::Name>(field) };
+            const auto& it { data.find(name) };
 
-        if (!registryFields.empty())
-        {
-            for (const auto& value : registryFields)
+            if (data.end() != it)
             {
-                nlohmann::json object;
-                getFieldValueFromTuple(value, object);
-                const auto& it
+                const auto& value
                 {
-                    data.find(value.first)
+                    getTableFieldData(stmt->column(std::get<TableHeader::CID>(field)), std::get<TableHeader::Type>(field))
                 };
 
-                if (data.end() != it)
+                if (!isSameFieldValue(value, *it))
                 {
-                    // Only compare if not in ignore set
-                    if (*it != object.at(value.first))
-                    {
-                        // Diff found
-                        isModified = true;
-                        oldData[value.first] = object[value.first];
-                    }
-
-                    updatedData[value.first] = *it;
+                    // Diff found
+                    isModified = true;
+                    oldData[name] = getFieldValue(value);
                 }
+
+                updatedData[name] = *it;
             }
         }
     }
@@ -1393,111 +1667,6 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
     return diffExist;
 }
 
-bool SQLiteDBEngine::insertNewRows(const std::string& table,
-                                   const std::vector<std::string>& primaryKeyList,
-                                   const DbSync::ResultCallback callback,
-                                   std::unique_lock<std::shared_timed_mutex>& lock)
-{
-    auto ret { true };
-    std::vector<Row> rowValues;
-
-    if (getLeftOnly(table + TEMP_TABLE_SUBFIX, table, primaryKeyList, rowValues))
-    {
-        bulkInsert(table, rowValues);
-
-        for (const auto& row : rowValues)
-        {
-            nlohmann::json object;
-
-            for (const auto& value : row)
-            {
-                getFieldValueFromTuple(value, object);
-            }
-
-            if (callback)
-            {
-                lock.unlock();
-                callback(ReturnTypeCallback::INSERTED, object);
-                lock.lock();
-            }
-        }
-    }
-
-    return ret;
-}
-
-void SQLiteDBEngine::bulkInsert(const std::string& table,
-                                const std::vector<Row>& data)
-{
-    const auto stmt { getStatement(buildInsertDataSqlQuery(table)) };
-
-    for (const auto& row : data)
-    {
-        const auto tableFields { m_tableFields[table] };
-
-        for (const auto& value : tableFields)
-        {
-            auto it { row.find(std::get<TableHeader::Name>(value))};
-
-            if (row.end() != it)
-            {
-                bindFieldData(stmt, std::get<TableHeader::CID>(value) + 1, (*it).second);
-            }
-        }
-
-        updateTableRowCounter(table, 1ll);
-
-        // LCOV_EXCL_START
-        if (SQLITE_ERROR == stmt->step())
-        {
-
-            updateTableRowCounter(table, -1ll);
-            throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
-        }
-
-        // LCOV_EXCL_STOP
-        stmt->reset();
-    }
-}
-
-int SQLiteDBEngine::changeModifiedRows(const std::string& table,
-                                       const std::vector<std::string>& primaryKeyList,
-                                       const DbSync::ResultCallback callback,
-                                       std::unique_lock<std::shared_timed_mutex>& lock)
-{
-    auto ret { true };
-    std::vector<Row> rowKeysValue;
-
-    if (getRowsToModify(table, primaryKeyList, rowKeysValue))
-    {
-        if (updateRows(table, primaryKeyList, rowKeysValue))
-        {
-            for (const auto& row : rowKeysValue)
-            {
-                nlohmann::json object;
-
-                for (const auto& value : row)
-                {
-                    getFieldValueFromTuple(value, object);
-                }
-
-                if (callback)
-                {
-                    lock.unlock();
-                    callback(ReturnTypeCallback::MODIFIED, object);
-                    lock.lock();
-                }
-            }
-        }
-        else
-        {
-            ret = false;
-        }
-    }
-
-    return ret;
-}
-
 std::string SQLiteDBEngine::buildUpdatePartialDataSqlQuery(const std::string& table,
                                                            const nlohmann::json& data,
                                                            const std::vector<std::string>& primaryKeyList)
@@ -1568,183 +1737,6 @@ std::string SQLiteDBEngine::buildSelectMatchingPKsSqlQuery(const std::string& ta
     return sql;
 }
 
-std::string SQLiteDBEngine::buildUpdateDataSqlQuery(const std::string& table,
-                                                    const std::vector<std::string>& primaryKeyList,
-                                                    const Row& row,
-                                                    const std::pair<const std::string, TableField>& field)
-{
-    std::string sql{ "UPDATE " };
-    sql.append(table);
-    sql.append(" SET ");
-    sql.append(field.first);
-    sql.append("=");
-    getFieldValueFromTuple(field, sql, true);
-    sql.append(" WHERE ");
-
-    if (0 != primaryKeyList.size())
-    {
-        for (const auto& value : primaryKeyList)
-        {
-            const auto it { row.find("PK_" + value) };
-
-            if (it != row.end())
-            {
-                sql.append(value);
-                sql.append("=");
-                getFieldValueFromTuple((*it), sql, true);
-            }
-            else
-            {
-                sql.clear();
-                break;
-            }
-
-            sql.append(" AND ");
-        }
-
-        sql = sql.substr(0, sql.length() - 5);
-
-        if (sql.length() > 0)
-        {
-            sql.append(";");
-        }
-    }
-    // LCOV_EXCL_START
-    else
-    {
-        throw dbengine_error{ SQL_STMT_ERROR };
-    }
-
-    // LCOV_EXCL_STOP
-    return sql;
-}
-
-std::string SQLiteDBEngine::buildModifiedRowsQuery(const std::string& t1,
-                                                   const std::string& t2,
-                                                   const std::vector<std::string>& primaryKeyList)
-{
-    std::string fieldsList;
-    std::string onMatchList;
-
-    for (const auto& value : primaryKeyList)
-    {
-        fieldsList.append("t1." + value + ",");
-        onMatchList.append("t1." + value + "=t2." + value + " AND ");
-    }
-
-    const auto tableFields { m_tableFields[t1] };
-
-    for (const auto& value : tableFields)
-    {
-        const auto fieldName {std::get<TableHeader::Name>(value)};
-        fieldsList.append("CASE WHEN t1.");
-        fieldsList.append(fieldName);
-        fieldsList.append("<>t2.");
-        fieldsList.append(fieldName);
-        fieldsList.append(" THEN t1.");
-        fieldsList.append(fieldName);
-        fieldsList.append(" ELSE NULL END AS DIF_");
-        fieldsList.append(fieldName);
-        fieldsList.append(",");
-    }
-
-    fieldsList  = fieldsList.substr(0, fieldsList.size() - 1);
-    onMatchList = onMatchList.substr(0, onMatchList.size() - 5);
-    std::string ret {"SELECT "};
-    ret.append(fieldsList);
-    ret.append(" FROM (select *,'");
-    ret.append(t1);
-    ret.append("' as val from ");
-    ret.append(t1);
-    ret.append(" UNION ALL select *,'");
-    ret.append(t2);
-    ret.append("' as val from ");
-    ret.append(t2);
-    ret.append(") t1 INNER JOIN ");
-    ret.append(t1);
-    ret.append(" t2 ON ");
-    ret.append(onMatchList);
-    ret.append(" WHERE t1.val = '");
-    ret.append(t2);
-    ret.append("';");
-
-    return ret;
-}
-
-bool SQLiteDBEngine::getRowsToModify(const std::string& table,
-                                     const std::vector<std::string>& primaryKeyList,
-                                     std::vector<Row>& rowKeysValue)
-{
-    auto ret { false };
-    auto sql { buildModifiedRowsQuery(table, table + TEMP_TABLE_SUBFIX, primaryKeyList) };
-
-    if (!sql.empty())
-    {
-        const auto stmt { getStatement(sql) };
-
-        while (SQLITE_ROW == stmt->step())
-        {
-            bool dataModified{false};
-            const auto tableFields { m_tableFields[table] };
-            Row registerFields;
-            int32_t index {0l};
-
-            for (const auto& pkValue : primaryKeyList)
-            {
-                const auto it
-                {
-                    std::find_if(tableFields.begin(), tableFields.end(),
-                                 [&pkValue] (const ColumnData & cd)
-                    {
-                        return std::get<TableHeader::Name>(cd).compare(pkValue) == 0;
-                    })
-                };
-
-                if (tableFields.end() != it)
-                {
-                    getTableData(stmt,
-                                 index,
-                                 std::get<TableHeader::Type>(*it),
-                                 "PK_" + std::get<TableHeader::Name>(*it),
-                                 registerFields);
-                }
-
-                ++index;
-            }
-
-            for (const auto& field : tableFields)
-            {
-                if (registerFields.end() == registerFields.find(std::get<TableHeader::Name>(field)))
-                {
-                    if (stmt->column(index)->hasValue())
-                    {
-                        dataModified = true;
-                        getTableData(stmt, index, std::get<TableHeader::Type>(field),
-                                     std::get<TableHeader::Name>(field), registerFields);
-                    }
-                }
-
-                ++index;
-            }
-
-            if (dataModified)
-            {
-                rowKeysValue.push_back(std::move(registerFields));
-            }
-        }
-
-        ret = true;
-    }
-    // LCOV_EXCL_START
-    else
-    {
-        throw dbengine_error { SQL_STMT_ERROR };
-    }
-
-    // LCOV_EXCL_STOP
-    return ret;
-}
-
 void SQLiteDBEngine::updateSingleRow(const std::string& table,
                                      const nlohmann::json& jsData)
 {
@@ -1753,7 +1745,27 @@ void SQLiteDBEngine::updateSingleRow(const std::string& table,
     if (getPrimaryKeysFromTable(table, primaryKeyList))
     {
         const auto& tableFields { m_tableFields[table] };
-        const auto stmt { getStatement(buildUpdatePartialDataSqlQuery(table, jsData, primaryKeyList)) };
+        const auto fieldsMask
+        {
+            getFieldsMask(tableFields, [&jsData](const std::string & name)
+            {
+                return jsData.end() != jsData.find(name);
+            })
+        };
+        const auto buildQuery
+        {
+            [this, &table, &jsData, &primaryKeyList]()
+            {
+                return buildUpdatePartialDataSqlQuery(table, jsData, primaryKeyList);
+            }
+        };
+        // Data with fields that are not in the table can't be identified by the table fields.
+        const auto stmt
+        {
+            jsData.size() == static_cast<size_t>(std::count(fieldsMask.begin(), fieldsMask.end(), true))
+            ? getStatement(StatementKey { table, StatementType::UpdatePartialData, fieldsMask }, buildQuery)
+            : getStatement(buildQuery())
+        };
         int32_t index { 1l };
 
         for (auto it = jsData.begin(); it != jsData.end(); ++it)
@@ -1805,56 +1817,35 @@ void SQLiteDBEngine::updateSingleRow(const std::string& table,
     }
 }
 
-bool SQLiteDBEngine::updateRows(const std::string& table,
-                                const std::vector<std::string>& primaryKeyList,
-                                const std::vector<Row>& rowKeysValue)
+void SQLiteDBEngine::getFieldValueFromTuple(const Field& value,
+                                            nlohmann::json& object)
 {
-
-    for (const auto& row : rowKeysValue)
-    {
-        for (const auto& field : row)
-        {
-            if (0 != field.first.substr(0, 3).compare("PK_"))
-            {
-                const auto sql
-                {
-                    buildUpdateDataSqlQuery(table,
-                                            primaryKeyList,
-                                            row,
-                                            field)
-                };
-                m_sqliteConnection->execute(sql);
-            }
-        }
-    }
-
-    return true;
+    object[value.first] = getFieldValue(value.second);
 }
 
-void SQLiteDBEngine::getFieldValueFromTuple(const Field& value,
-                                            nlohmann::json& object)
+nlohmann::json SQLiteDBEngine::getFieldValue(const TableField& field)
 {
-    const auto rowType { std::get<GenericTupleIndex::GenType>(value.second) };
+    const auto rowType { std::get<GenericTupleIndex::GenType>(field) };
 
     if (ColumnType::BigInt == rowType)
     {
-        object[value.first] = std::get<ColumnType::BigInt>(value.second);
+        return std::get<ColumnType::BigInt>(field);
     }
     else if (ColumnType::UnsignedBigInt == rowType)
     {
-        object[value.first] = std::get<ColumnType::UnsignedBigInt>(value.second);
+        return std::get<ColumnType::UnsignedBigInt>(field);
     }
     else if (ColumnType::Integer == rowType)
     {
-        object[value.first] = std::get<ColumnType::Integer>(value.second);
+        return std::get<ColumnType::Integer>(field);
     }
     else if (ColumnType::Text == rowType)
     {
-        object[value.first] = std::get<ColumnType::Text>(value.second);
+        return std::get<ColumnType::Text>(field);
     }
     else if (ColumnType::Double == rowType)
     {
-        object[value.first] = std::get<ColumnType::Double>(value.second);
+        return std::get<ColumnType::Double>(field);
     }
     else
     {
@@ -1862,76 +1853,67 @@ void SQLiteDBEngine::getFieldValueFromTuple(const Field& value,
     }
 }
 
-void SQLiteDBEngine::getFieldValueFromTuple(const Field& value,
-                                            std::string& resultValue,
-                                            const bool quotationMarks)
+bool SQLiteDBEngine::isSameFieldValue(const TableField& field,
+                                      const nlohmann::json& value)
 {
-    const auto rowType { std::get<GenericTupleIndex::GenType>(value.second) };
+    // Text values are compared in place, the numeric json values don't allocate.
+    return ColumnType::Text == std::get<GenericTupleIndex::GenType>(field)
+           ? value.is_string() && value.get_ref<const std::string&>() == std::get<ColumnType::Text>(field)
+           : value == getFieldValue(field);
+}
 
-    if (ColumnType::BigInt == rowType)
-    {
-        resultValue.append(std::to_string(std::get<ColumnType::BigInt>(value.second)));
-    }
-    else if (ColumnType::UnsignedBigInt == rowType)
-    {
-        resultValue.append(std::to_string(std::get<ColumnType::UnsignedBigInt>(value.second)));
-    }
-    else if (ColumnType::Integer == rowType)
-    {
-        resultValue.append(std::to_string(std::get<ColumnType::Integer>(value.second)));
-    }
-    else if (ColumnType::Text == rowType)
-    {
-        if (quotationMarks)
-        {
-            resultValue.append("'" + std::get<ColumnType::Text>(value.second) + "'");
-        }
-        else
-        {
-            resultValue.append(std::get<ColumnType::Text>(value.second));
-        }
-    }
-    else if (ColumnType::Double == rowType)
-    {
-        resultValue.append(std::to_string(std::get<ColumnType::Double>(value.second)));
-    }
-    else
+std::shared_ptr<SQLite::IStatement>const SQLiteDBEngine::getStatement(const std::string& sql)
+{
+    return getStatement(StatementKey { sql, StatementType::SqlText, {} }, [&sql]()
     {
-        throw dbengine_error { DATATYPE_NOT_IMPLEMENTED };
-    }
+        return sql;
+    });
 }
 
-std::shared_ptr<SQLite::IStatement>const SQLiteDBEngine::getStatement(const std::string& sql)
+std::shared_ptr<SQLite::IStatement>const SQLiteDBEngine::getStatement(const StatementKey& key,
+                                                                      const std::function<std::string()>& buildQuery)
 {
     std::lock_guard<std::mutex> lock(m_stmtMutex);
-    const auto it
-    {
-        std::find_if(m_statementsCache.begin(),
-                     m_statementsCache.end(),
-                     [sql](const std::pair<std::string, std::shared_ptr<SQLite::IStatement>>& pair)
-        {
-            return 0 == pair.first.compare(sql);
-        })
-    };
+    const auto it { m_statementsIndex.find(key) };
 
-    if (m_statementsCache.end() != it)
+    if (m_statementsIndex.end() != it)
     {
-        it->second->reset();
-        return it->second;
+        // The statement becomes the most recently used one.
+        m_statementsCache.splice(m_statementsCache.end(), m_statementsCache, it->second);
+        ++m_statementsReused;
+        it->second->second->reset();
+        return it->second->second;
     }
     else
     {
-        m_statementsCache.emplace_back(sql, m_sqliteFactory->createStatement(m_sqliteConnection, sql));
+        m_statementsCache.emplace_back(key, m_sqliteFactory->createStatement(m_sqliteConnection, buildQuery()));
+        m_statementsIndex.emplace(key, std::prev(m_statementsCache.end()));
+        ++m_statementsPrepared;
 
-        if (CACHE_STMT_LIMIT <= m_statementsCache.size())
+        if (CACHE_STMT_LIMIT < m_statementsCache.size())
         {
+            m_statementsIndex.erase(m_statementsCache.front().first);
             m_statementsCache.pop_front();
+            ++m_statementsEvicted;
         }
 
         return m_statementsCache.back().second;
     }
 }
 
+std::vector<bool> SQLiteDBEngine::getFieldsMask(const TableColumns& tableFields,
+                                                const std::function<bool(const std::string&)>& hasField)
+{
+    std::vector<bool> fieldsMask;
+
+    for (const auto& field : tableFields)
+    {
+        fieldsMask.push_back(hasField(std::get<TableHeader::Name>(field)));
+    }
+
+    return fieldsMask;
+}
+
 std::string SQLiteDBEngine::getSelectAllQuery(const std::string& table,
                                               const TableColumns& tableFields) const
 {
@@ -15,47 +15,22 @@
 #include <tuple>
 #include <iostream>
 #include <mutex>
+#include <list>
 #include <queue>
 #include "dbengine.h"
 #include "sqlite_wrapper_factory.h"
 #include "isqlite_wrapper.h"
 #include "mapWrapperSafe.h"
 
-constexpr auto TEMP_TABLE_SUBFIX {"_TEMP"};
-
-constexpr auto STATUS_FIELD_NAME {"db_status_field_dm"};
-constexpr auto STATUS_FIELD_TYPE {"INTEGER"};
-
 constexpr auto CACHE_STMT_LIMIT
 {
     30ull
 };
 
-const std::vector<std::string> InternalColumnNames =
-{
-    { STATUS_FIELD_NAME }
-};
-
-enum ColumnType
+// SQLite page cache size when no memory limit is set, in KiB.
+constexpr auto DEFAULT_CACHE_SIZE_KIB
 {
-    Unknown = 0,
-    Text,
-    Integer,
-    BigInt,
-    UnsignedBigInt,
-    Double,
-    Blob,
-};
-
-const std::map<std::string, ColumnType> ColumnTypeNames =
-{
-    { "UNKNOWN", Unknown        },
-    { "TEXT", Text           },
-    { "INTEGER", Integer        },
-    { "BIGINT", BigInt         },
-    { "UNSIGNED BIGINT", UnsignedBigInt },
-    { "DOUBLE", Double         },
-    { "BLOB", Blob           },
+    2000ull
 };
 
 enum TableHeader
@@ -90,28 +65,28 @@ using Row = std::map<std::string, TableField>;
 
 using Field = std::pair<const std::string, TableField>;
 
+using PrimaryKeyValues = std::vector<TableField>;
+
+using FieldHashes = std::vector<size_t>;
+
 enum ResponseType
 {
     RTJson = 0,
     RTCallback
 };
 
-class dbengine_error : public DbSync::dbsync_error
+enum StatementType
 {
-    public:
-        explicit dbengine_error(const std::pair<int, std::string>& exceptionInfo)
-            : DbSync::dbsync_error
-        {
-            exceptionInfo.first, "dbEngine: " + exceptionInfo.second
-        }
-        {}
+    SqlText = 0,
+    InsertData,
+    UpdatePartialData,
+    UpdateRowFields
 };
 
-struct MaxRows final
-{
-    int64_t maxRows;
-    int64_t currentRows;
-};
+// The statements whose SQL depends on the fields of the data are identified by the table, the
+// operation and the table fields they use, so the SQL is only built when they are prepared.
+// Any other statement is identified by its SQL text.
+using StatementKey = std::tuple<std::string, StatementType, std::vector<bool>>;
 
 class SQLiteDBEngine final : public DbSync::IDbEngine
 {
@@ -154,6 +129,14 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
 
         void addTableRelationship(const nlohmann::json& data) override;
 
+        void getStatementCacheStats(nlohmann::json& stats) override;
+
+        void setMemoryLimit(const uint64_t limit) override;
+
+        void getStorageStats(nlohmann::json& stats) override;
+
+        int64_t getTableRowCount(const std::string& table) override;
+
     private:
         void initialize(const std::string& path,
                         const std::string& tableStmtCreation);
@@ -180,19 +163,12 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                           const nlohmann::json::value_type& valueType,
                           const unsigned int cid);
 
-        bool createCopyTempTable(const std::string& table);
-
-        bool getTableCreateQuery(const std::string& table,
-                                 std::string& resultQuery);
+        TableField getJsonFieldData(const ColumnData& cd,
+                                    const nlohmann::json& jsData);
 
         bool getPrimaryKeysFromTable(const std::string& table,
                                      std::vector<std::string>& primaryKeyList);
 
-        bool removeNotExistsRows(const std::string& table,
-                                 const std::vector<std::string>& primaryKeyList,
-                                 const DbSync::ResultCallback callback,
-                                 std::unique_lock<std::shared_timed_mutex>& lock);
-
         bool getRowDiff(const std::vector<std::string>& primaryKeyList,
                         const nlohmann::json& ignoredColumns,
                         const std::string& table,
@@ -200,11 +176,6 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                         nlohmann::json& updatedData,
                         nlohmann::json& oldData);
 
-        bool insertNewRows(const std::string& table,
-                           const std::vector<std::string>& primaryKeyList,
-                           const DbSync::ResultCallback callback,
-                           std::unique_lock<std::shared_timed_mutex>& lock);
-
         bool deleteRows(const std::string& table,
                         const std::vector<std::string>& primaryKeyList,
                         const std::vector<Row>& rowsToRemove);
@@ -222,75 +193,93 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                           const std::string& fieldName,
                           Row& row);
 
+        TableField getTableFieldData(const std::unique_ptr<SQLite::IColumn>& column,
+                                     const ColumnType& type);
+
         void bindFieldData(const std::shared_ptr<SQLite::IStatement> stmt,
                            const int32_t index,
                            const TableField& fieldData);
 
-        std::string buildLeftOnlyQuery(const std::string& t1,
-                                       const std::string& t2,
-                                       const std::vector<std::string>& primaryKeyList,
-                                       const bool returnOnlyPKFields = false);
+        void getJsonRowData(const TableColumns& tableFields,
+                            const nlohmann::json& element,
+                            Row& row);
 
-        bool getLeftOnly(const std::string& t1,
-                         const std::string& t2,
-                         const std::vector<std::string>& primaryKeyList,
-                         std::vector<Row>& returnRows);
+        void getTableRowData(std::shared_ptr<SQLite::IStatement>const stmt,
+                             const TableColumns& tableFields,
+                             Row& row);
 
-        bool getPKListLeftOnly(const std::string& t1,
-                               const std::string& t2,
-                               const std::vector<std::string>& primaryKeyList,
-                               std::vector<Row>& returnRows);
+        static size_t getFieldHash(const int32_t cid,
+                                   const TableField& field);
 
-        void bulkInsert(const std::string& table,
-                        const std::vector<Row>& data);
+        void getJsonFieldHashes(const TableColumns& tableFields,
+                                const nlohmann::json& element,
+                                PrimaryKeyValues& primaryKeyValues,
+                                FieldHashes& fieldHashes);
+
+        void getTableFieldHashes(std::shared_ptr<SQLite::IStatement>const stmt,
+                                 const TableColumns& tableFields,
+                                 PrimaryKeyValues& primaryKeyValues,
+                                 FieldHashes& fieldHashes);
+
+        void getRowHashes(const std::string& table,
+                          const TableColumns& tableFields,
+                          std::map<PrimaryKeyValues, std::pair<FieldHashes, bool>>& rowHashes);
 
-        void deleteTempTable(const std::string& table);
+        void getModifiedFields(const TableColumns& tableFields,
+                               const nlohmann::json& element,
+                               const FieldHashes& storedHashes,
+                               const FieldHashes& fieldHashes,
+                               Row& modifiedFields);
 
-        std::string buildModifiedRowsQuery(const std::string& t1,
-                                           const std::string& t2,
-                                           const std::vector<std::string>& primaryKeyList);
+        void getDefaultValueFields(const std::string& table,
+                                   std::vector<std::string>& fields);
 
-        int changeModifiedRows(const std::string& table,
-                               const std::vector<std::string>& primaryKeyList,
-                               const DbSync::ResultCallback callback,
-                               std::unique_lock<std::shared_timed_mutex>& lock);
+        bool getRowByPrimaryKeyValues(const std::string& table,
+                                      const TableColumns& tableFields,
+                                      const std::vector<std::string>& primaryKeyList,
+                                      const PrimaryKeyValues& primaryKeyValues,
+                                      Row& row);
+
+        std::string buildUpdateRowSqlQuery(const std::string& table,
+                                           const std::vector<std::string>& primaryKeyList,
+                                           const Row& fields);
+
+        void updateRowFields(const std::string& table,
+                             const TableColumns& tableFields,
+                             const std::vector<std::string>& primaryKeyList,
+                             const PrimaryKeyValues& primaryKeyValues,
+                             const Row& fields);
 
         std::string buildSelectMatchingPKsSqlQuery(const std::string& table,
                                                    const std::vector<std::string>& primaryKeyList);
 
-        std::string buildUpdateDataSqlQuery(const std::string& table,
-                                            const std::vector<std::string>& primaryKeyList,
-                                            const Row& row,
-                                            const std::pair<const std::string, TableField>& field);
-
         std::string buildUpdatePartialDataSqlQuery(const std::string& table,
                                                    const nlohmann::json& data,
                                                    const std::vector<std::string>& primaryKeyList);
 
-        bool getRowsToModify(const std::string& table,
-                             const std::vector<std::string>& primaryKeyList,
-                             std::vector<Row>& rowKeysValue);
-
         void updateSingleRow(const std::string& table,
                              const nlohmann::json& jsData);
 
-        bool updateRows(const std::string& table,
-                        const std::vector<std::string>& primaryKeyList,
-                        const std::vector<Row>& rowKeysValue);
-
-        void getFieldValueFromTuple(const Field& value,
-                                    std::string& resultValue,
-                                    const bool quotationMarks = false);
-
         void getFieldValueFromTuple(const Field& value,
                                     nlohmann::json& object);
 
+        static nlohmann::json getFieldValue(const TableField& field);
+
+        static bool isSameFieldValue(const TableField& field,
+                                     const nlohmann::json& value);
+
         SQLiteDBEngine(const SQLiteDBEngine&) = delete;
 
         SQLiteDBEngine& operator=(const SQLiteDBEngine&) = delete;
 
         std::shared_ptr<SQLite::IStatement>const getStatement(const std::string& sql);
 
+        std::shared_ptr<SQLite::IStatement>const getStatement(const StatementKey& key,
+                                                              const std::function<std::string()>& buildQuery);
+
+        static std::vector<bool> getFieldsMask(const TableColumns& tableFields,
+                                               const std::function<bool(const std::string&)>& hasField);
+
         std::string getSelectAllQuery(const std::string& table,
                                       const TableColumns& tableFields) const;
 
@@ -310,7 +299,13 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                            const std::function<void()> callback = {});
 
         Utils::MapWrapperSafe<std::string, TableColumns> m_tableFields;
-        std::deque<std::pair<std::string, std::shared_ptr<SQLite::IStatement>>> m_statementsCache;
+        // Least recently used statements first.
+        std::list<std::pair<StatementKey, std::shared_ptr<SQLite::IStatement>>> m_statementsCache;
+        std::map<StatementKey, decltype(m_statementsCache)::iterator> m_statementsIndex;
+        uint64_t m_statementsPrepared;
+        uint64_t m_statementsReused;
+        uint64_t m_statementsEvicted;
+        uint64_t m_memoryLimit;
         const std::shared_ptr<ISQLiteFactory> m_sqliteFactory;
         std::shared_ptr<SQLite::IConnection> m_sqliteConnection;
         std::mutex m_stmtMutex;
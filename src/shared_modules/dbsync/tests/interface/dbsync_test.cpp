@@ -356,6 +356,113 @@ TEST_F(DBSyncTest, InsertDataInvalidHandle)
     EXPECT_NE(0, dbsync_insert_data(reinterpret_cast<void*>(0xffffffff), jsInsert.get()));
 }
 
+TEST_F(DBSyncTest, StatementCacheStats)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `threads` INTEGER, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto insertionSqlStmt1{ R"({"table":"processes","data":[{"pid":4,"name":"System"}]})"};
+    const auto insertionSqlStmt2{ R"({"table":"processes","data":[{"pid":5,"name":"User"}]})"};
+    const auto insertionSqlStmt3{ R"({"table":"processes","data":[{"pid":6,"name":"User","threads":2}]})"};
+
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert1{ cJSON_Parse(insertionSqlStmt1) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert2{ cJSON_Parse(insertionSqlStmt2) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert3{ cJSON_Parse(insertionSqlStmt3) };
+
+    cJSON* jsBefore { nullptr };
+    cJSON* jsAfter { nullptr };
+
+    EXPECT_EQ(0, dbsync_get_statement_cache_stats(handle, &jsBefore));
+    ASSERT_NE(nullptr, jsBefore);
+
+    EXPECT_EQ(0, dbsync_insert_data(handle, jsInsert1.get()));
+    EXPECT_EQ(0, dbsync_insert_data(handle, jsInsert2.get()));
+    EXPECT_EQ(0, dbsync_insert_data(handle, jsInsert3.get()));
+
+    EXPECT_EQ(0, dbsync_get_statement_cache_stats(handle, &jsAfter));
+    ASSERT_NE(nullptr, jsAfter);
+
+    // Rows with the same fields share one statement, a new set of fields prepares another.
+    const auto counter
+    {
+        [](const cJSON * stats, const char* name)
+        {
+            const std::unique_ptr<char, CJsonSmartFree> spJsonBytes{ cJSON_PrintUnformatted(stats) };
+            return nlohmann::json::parse(spJsonBytes.get()).at(name).get<int64_t>();
+        }
+    };
+    EXPECT_EQ(2, counter(jsAfter, "prepared") - counter(jsBefore, "prepared"));
+    EXPECT_EQ(1, counter(jsAfter, "reused") - counter(jsBefore, "reused"));
+    EXPECT_EQ(0, counter(jsAfter, "evicted"));
+    EXPECT_LE(counter(jsAfter, "cached"), counter(jsAfter, "limit"));
+
+    EXPECT_NO_THROW(dbsync_free_result(&jsBefore));
+    EXPECT_NO_THROW(dbsync_free_result(&jsAfter));
+}
+
+TEST_F(DBSyncTest, StatementCacheStatsInvalidInput)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    cJSON* jsResult { nullptr };
+
+    EXPECT_NE(0, dbsync_get_statement_cache_stats(handle, nullptr));
+    EXPECT_NE(0, dbsync_get_statement_cache_stats(nullptr, &jsResult));
+    EXPECT_NE(0, dbsync_get_statement_cache_stats(reinterpret_cast<void*>(0xffffffff), &jsResult));
+    EXPECT_EQ(nullptr, jsResult);
+}
+
+TEST_F(DBSyncTest, StorageStatsWithMemoryLimit)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto insertionSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System"},{"pid":5,"name":"User"}]})"};
+
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert{ cJSON_Parse(insertionSqlStmt) };
+
+    EXPECT_EQ(0, dbsync_set_memory_limit(handle, 64 * 1024));
+    EXPECT_EQ(0, dbsync_insert_data(handle, jsInsert.get()));
+
+    cJSON* jsResult { nullptr };
+    EXPECT_EQ(0, dbsync_get_storage_stats(handle, &jsResult));
+    ASSERT_NE(nullptr, jsResult);
+
+    const std::unique_ptr<char, CJsonSmartFree> spJsonBytes{ cJSON_PrintUnformatted(jsResult) };
+    const auto stats { nlohmann::json::parse(spJsonBytes.get()) };
+
+    EXPECT_EQ(64 * 1024, stats.at("memory_limit").get<int64_t>());
+    EXPECT_LT(0, stats.at("memory_used").get<int64_t>());
+    EXPECT_LT(0, stats.at("db_size").get<int64_t>());
+    EXPECT_LE(0, stats.at("cache_hit").get<int64_t>());
+    EXPECT_LE(0, stats.at("cache_miss").get<int64_t>());
+    EXPECT_LE(0, stats.at("cache_spill").get<int64_t>());
+
+    EXPECT_NO_THROW(dbsync_free_result(&jsResult));
+}
+
+TEST_F(DBSyncTest, StorageStatsInvalidInput)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    cJSON* jsResult { nullptr };
+
+    EXPECT_NE(0, dbsync_set_memory_limit(nullptr, 1024));
+    EXPECT_NE(0, dbsync_set_memory_limit(reinterpret_cast<void*>(0xffffffff), 1024));
+    EXPECT_NE(0, dbsync_get_storage_stats(handle, nullptr));
+    EXPECT_NE(0, dbsync_get_storage_stats(nullptr, &jsResult));
+    EXPECT_NE(0, dbsync_get_storage_stats(reinterpret_cast<void*>(0xffffffff), &jsResult));
+    EXPECT_EQ(nullptr, jsResult);
+}
+
 TEST_F(DBSyncTest, GetDeletedRowsInvalidInput)
 {
     CallbackMock wrapper;
@@ -816,6 +923,103 @@ TEST_F(DBSyncTest, syncRowInvalidData)
     EXPECT_NE(0, dbsync_sync_row(reinterpret_cast<void*>(0xffffffff), jsInputNoTable.get(), callbackData));
 }
 
+TEST_F(DBSyncTest, syncRowsMultipleTables)
+{
+    const auto sql
+    {
+        "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"
+        "CREATE TABLE ports(`port` BIGINT, `protocol` TEXT, PRIMARY KEY (`port`)) WITHOUT ROWID;"
+    };
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":4,"name":"System"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":5,"name":"Guake"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"port":22,"protocol":"tcp"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"pid":4,"name":"Systemmm"})"))).Times(1);
+    // The elements before a failing one are kept.
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":7,"name":"Guake"})"))).Times(1);
+
+    const auto insertSqlStmt
+    {
+        R"([{"table":"processes","data":[{"pid":4,"name":"System"},{"pid":5,"name":"Guake"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"tcp"}]}])"
+    };
+    const auto updateSqlStmt
+    {
+        R"([{"table":"processes","data":[{"pid":4,"name":"Systemmm"},{"pid":5,"name":"Guake"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"tcp"}]}])"
+    };
+    const auto notArraySqlStmt{ R"({"table":"processes","data":[{"pid":7,"name":"Guake"}]})" };
+    const auto invalidTableSqlStmt{ R"([{"table":"processes","data":[{"pid":7,"name":"Guake"}]},{"data":[]}])" };
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert{ cJSON_Parse(insertSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsUpdate{ cJSON_Parse(updateSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsNotArray{ cJSON_Parse(notArraySqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInvalidTable{ cJSON_Parse(invalidTableSqlStmt) };
+
+    callback_data_t callbackData { callback, &wrapper };
+    callback_data_t callbackEmpty { nullptr, nullptr };
+
+    EXPECT_EQ(0, dbsync_sync_rows(handle, jsInsert.get(), callbackData));
+    EXPECT_EQ(0, dbsync_sync_rows(handle, jsUpdate.get(), callbackData));
+    // Failure cases
+    EXPECT_NE(0, dbsync_sync_rows(nullptr, jsInsert.get(), callbackData));
+    EXPECT_NE(0, dbsync_sync_rows(handle, nullptr, callbackData));
+    EXPECT_NE(0, dbsync_sync_rows(handle, jsInsert.get(), callbackEmpty));
+    EXPECT_NE(0, dbsync_sync_rows(handle, jsNotArray.get(), callbackData));
+    EXPECT_NE(0, dbsync_sync_rows(handle, jsInvalidTable.get(), callbackData));
+}
+
+TEST_F(DBSyncTest, syncTxnRowsMultipleTables)
+{
+    const auto sql
+    {
+        "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"
+        "CREATE TABLE ports(`port` BIGINT, `protocol` TEXT, PRIMARY KEY (`port`)) WITHOUT ROWID;"
+    };
+    const auto tables { R"(["processes","ports"])" };
+    const auto initialSqlStmt
+    {
+        R"([{"table":"processes","data":[{"pid":4,"name":"System"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"tcp"}]}])"
+    };
+    const auto txnSqlStmt
+    {
+        R"([{"table":"processes","data":[{"pid":7,"name":"Guake"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"tcp"}]}])"
+    };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsonTables { cJSON_Parse(tables) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInitial { cJSON_Parse(initialSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsTxn { cJSON_Parse(txnSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsNotArray { cJSON_Parse(R"({"table":"processes","data":[]})") };
+    const std::unique_ptr<DummyContext> dummyCtx { std::make_unique<DummyContext>()};
+
+    CallbackMock wrapper;
+    callback_data_t callbackData { callback, &wrapper };
+
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":4,"name":"System"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"port":22,"protocol":"tcp"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":7,"name":"Guake"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(DELETED, nlohmann::json::parse(R"({"pid":4,"name":"System"})"))).Times(1);
+
+    dummyCtx->handle = dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql);
+    ASSERT_NE(nullptr, dummyCtx->handle);
+
+    EXPECT_EQ(0, dbsync_sync_rows(dummyCtx->handle, jsInitial.get(), callbackData));
+
+    EXPECT_NO_THROW(dummyCtx->txnContext = dbsync_create_txn(dummyCtx->handle, jsonTables.get(), 0, 100, callbackData));
+    ASSERT_NE(nullptr, dummyCtx->txnContext);
+
+    EXPECT_EQ(0, dbsync_sync_txn_rows(dummyCtx->txnContext, jsTxn.get()));
+    EXPECT_NE(0, dbsync_sync_txn_rows(dummyCtx->txnContext, jsNotArray.get()));
+    EXPECT_NE(0, dbsync_sync_txn_rows(nullptr, jsTxn.get()));
+    EXPECT_NE(0, dbsync_sync_txn_rows(dummyCtx->txnContext, nullptr));
+
+    EXPECT_EQ(0, dbsync_get_deleted_rows(dummyCtx->txnContext, callbackData));
+}
+
 TEST_F(DBSyncTest, selectRowsDataAllNoFilter)
 {
     CallbackMock wrapper;
@@ -1678,6 +1882,35 @@ TEST_F(DBSyncTest, TryToInsertMoreThanMaxRowsCPP)
     EXPECT_NO_THROW(dbSync->insertData(nlohmann::json::parse(insertionSqlStmt)));
 }
 
+TEST_F(DBSyncTest, getTableRowCountCPP)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto insertionSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System"}, {"pid":3,"name":"cmd"}]})"};
+    const auto rowDeletePID4
+    {
+        R"({"table":"processes",
+           "query":{"data":[{"pid":4}],
+           "where_filter_opt":""}})"
+    };
+    std::unique_ptr<DBSync> dbSync;
+
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    // Not counted yet, the table is scanned.
+    EXPECT_NO_THROW(dbSync->insertData(nlohmann::json::parse(insertionSqlStmt)));
+    EXPECT_EQ(2, dbSync->getTableRowCount("processes"));
+
+    // Counted without a limit, a duplicated row isn't added.
+    EXPECT_NO_THROW(dbSync->setTableMaxRow("processes", 0));
+    EXPECT_ANY_THROW(dbSync->insertData(nlohmann::json::parse(insertionSqlStmt)));
+    EXPECT_EQ(2, dbSync->getTableRowCount("processes"));
+
+    EXPECT_NO_THROW(dbSync->deleteRows(nlohmann::json::parse(rowDeletePID4)));
+    EXPECT_EQ(1, dbSync->getTableRowCount("processes"));
+
+    EXPECT_ANY_THROW(dbSync->getTableRowCount("dummy"));
+}
+
 TEST_F(DBSyncTest, createTxnCPP)
 {
     const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
@@ -1721,6 +1954,56 @@ TEST_F(DBSyncTest, createTxnCPP)
 }
 
 
+TEST_F(DBSyncTest, syncRowsCPP)
+{
+    const auto sql
+    {
+        "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"
+        "CREATE TABLE ports(`port` BIGINT, `protocol` TEXT, PRIMARY KEY (`port`)) WITHOUT ROWID;"
+    };
+    const auto tables { R"(["processes","ports"])" };
+    std::unique_ptr<DBSync> dbSync;
+
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"name":"System","pid":4})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"port":22,"protocol":"tcp"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"name":"Guake","pid":7})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"port":22,"protocol":"udp"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(DELETED, nlohmann::json::parse(R"({"name":"System","pid":4})"))).Times(1);
+
+    ResultCallbackData callbackData
+    {
+        [&wrapper](ReturnTypeCallback type, const nlohmann::json & jsonResult)
+        {
+            wrapper.callbackMock(type, jsonResult);
+        }
+    };
+
+    const auto insertionSqlStmt1
+    {
+        R"([{"table":"processes","data":[{"pid":4,"name":"System"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"tcp"}]}])"
+    };
+
+    EXPECT_NO_THROW(dbSync->syncRows(nlohmann::json::parse(insertionSqlStmt1), callbackData));
+    EXPECT_THROW(dbSync->syncRows(nlohmann::json::parse(R"({"table":"processes","data":[]})"), callbackData), DbSync::dbsync_error);
+
+    std::unique_ptr<DBSyncTxn> dbSyncTxn;
+    EXPECT_NO_THROW(dbSyncTxn = std::make_unique<DBSyncTxn>(dbSync->handle(), nlohmann::json::parse(tables), 0, 100, callbackData));
+
+    const auto insertionSqlStmt2
+    {
+        R"([{"table":"processes","data":[{"pid":7,"name":"Guake"}]},
+            {"table":"ports","data":[{"port":22,"protocol":"udp"}]}])"
+    };
+    EXPECT_NO_THROW(dbSyncTxn->syncTxnRows(nlohmann::json::parse(insertionSqlStmt2)));
+    EXPECT_THROW(dbSyncTxn->syncTxnRows(nlohmann::json::parse(tables).front()), DbSync::dbsync_error);
+
+    EXPECT_NO_THROW(dbSyncTxn->getDeletedRows(callbackData));
+}
+
 TEST_F(DBSyncTest, createTxnCPP1)
 {
     constexpr auto sql
@@ -2038,6 +2321,49 @@ TEST_F(DBSyncTest, UpdateDataCPP)
     EXPECT_NO_THROW(dbSync->updateWithSnapshot(nlohmann::json::parse(insertionSqlStmt2), callbackData));
 }
 
+TEST_F(DBSyncTest, UpdateDataWithCompositeKeyCPP)
+{
+    const auto sql{ "CREATE TABLE registry(`path` TEXT, `arch` TEXT, `checksum` TEXT, `dhcp` TEXT DEFAULT 'unknown', PRIMARY KEY (`arch`, `path`)) WITHOUT ROWID;"};
+    const auto insertionSqlStmt1{ R"({"table":"registry","data":[{"path":"a","arch":"[x64]","checksum":"1"},{"path":"b","arch":"[x64]","checksum":"2"}]})"};
+    const auto insertionSqlStmt2{ R"({"table":"registry","data":[{"path":"a","arch":"[x32]","checksum":"1"},{"path":"b","arch":"[x64]","checksum":"3"}]})"};
+
+    std::unique_ptr<DBSync> dbSync;
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    nlohmann::json jsResponse;
+
+    EXPECT_NO_THROW(dbSync->updateWithSnapshot(nlohmann::json::parse(insertionSqlStmt1), jsResponse));
+    EXPECT_NE(nullptr, jsResponse);
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(DELETED, nlohmann::json::parse(R"({"arch":"[x64]","path":"a"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"PK_arch":"[x64]","PK_path":"b","checksum":"3"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"arch":"[x32]","checksum":"1","dhcp":"unknown","path":"a"})"))).Times(1);
+
+    ResultCallbackData callbackData
+    {
+        [&wrapper](ReturnTypeCallback type, const nlohmann::json & jsonResult)
+        {
+            wrapper.callbackMock(type, jsonResult);
+        }
+    };
+
+    EXPECT_NO_THROW(dbSync->updateWithSnapshot(nlohmann::json::parse(insertionSqlStmt2), callbackData));
+}
+
+TEST_F(DBSyncTest, UpdateDataWithDuplicatedKeyCPP)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto insertionSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System"},{"pid":4,"name":"Test"}]})"};
+
+    std::unique_ptr<DBSync> dbSync;
+    EXPECT_NO_THROW(dbSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql));
+
+    nlohmann::json jsResponse;
+
+    EXPECT_ANY_THROW(dbSync->updateWithSnapshot(nlohmann::json::parse(insertionSqlStmt), jsResponse));
+}
+
 TEST_F(DBSyncTest, constructorWithHandle)
 {
     const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
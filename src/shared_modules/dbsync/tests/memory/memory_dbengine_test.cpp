@@ -0,0 +1,257 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include "abstractLocking.hpp"
+#include "memory_dbengine_test.h"
+#include "memory/memory_dbengine.h"
+
+using ::testing::InSequence;
+
+constexpr auto CREATE_STATEMENT
+{
+    "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `tty` INTEGER, `fv` DOUBLE, PRIMARY KEY (`pid`)) WITHOUT ROWID;"
+    "CREATE TABLE processes_sockets(`socket_id` BIGINT, `pid` BIGINT, PRIMARY KEY (`socket_id`)) WITHOUT ROWID;"
+    "CREATE INDEX processes_name ON processes (name);"
+    "CREATE TABLE registry(path TEXT, arch TEXT, checksum TEXT NOT NULL, dhcp TEXT DEFAULT 'disabled', PRIMARY KEY (arch, path)) WITHOUT ROWID;"
+};
+
+class CallbackMock
+{
+    public:
+        CallbackMock() = default;
+        ~CallbackMock() = default;
+        MOCK_METHOD(void, callbackMock, (ReturnTypeCallback result_type, const nlohmann::json&), ());
+};
+
+static DbSync::ResultCallback callbackWrapper(CallbackMock& wrapper)
+{
+    return [&wrapper](ReturnTypeCallback type, const nlohmann::json & data)
+    {
+        wrapper.callbackMock(type, data);
+    };
+}
+
+static void syncRow(MemoryDBEngine& engine,
+                    const nlohmann::json& input,
+                    CallbackMock& wrapper,
+                    const bool inTransaction = false)
+{
+    std::shared_timed_mutex mutex;
+    Utils::ExclusiveLocking lock{ mutex };
+    engine.syncTableRowData(input, callbackWrapper(wrapper), inTransaction, lock);
+}
+
+static void select(MemoryDBEngine& engine,
+                   const std::string& table,
+                   const nlohmann::json& query,
+                   CallbackMock& wrapper)
+{
+    std::shared_timed_mutex mutex;
+    std::unique_lock<std::shared_timed_mutex> lock{ mutex };
+    engine.selectData(table, query, callbackWrapper(wrapper), lock);
+}
+
+TEST_F(MemoryDBEngineTest, InvalidTable)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+
+    EXPECT_THROW(engine.bulkInsert("dummy", nlohmann::json::array()), dbengine_error);
+    EXPECT_THROW(engine.setMaxRows("dummy", 1), dbengine_error);
+    EXPECT_THROW(engine.initializeStatusField(R"(["dummy"])"_json), dbengine_error);
+}
+
+TEST_F(MemoryDBEngineTest, BulkInsertAndSelectAll)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    EXPECT_NO_THROW(engine.bulkInsert("processes", R"([{"pid":5,"name":"b","tty":"2"},{"pid":"4","name":"a","fv":1.5}])"_json));
+    EXPECT_THROW(engine.bulkInsert("processes", R"([{"pid":4}])"_json), dbengine_error);
+
+    InSequence sequence;
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":4,"name":"a","fv":1.5})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":5,"name":"b","tty":2})"_json)).Times(1);
+
+    select(engine, "processes", R"({"column_list":["*"],"row_filter":"","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+}
+
+TEST_F(MemoryDBEngineTest, SyncTableRowData)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    InSequence sequence;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, R"({"pid":4,"name":"a","tty":1})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, R"({"pid":4,"name":"b","tty":1})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, R"({"new":{"pid":4,"name":"c","tty":2},"old":{"pid":4,"name":"b","tty":1}})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, R"({"pid":4,"name":"e","tty":3})"_json)).Times(1);
+
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"a","tty":1}]})"_json, wrapper);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"b","tty":1}]})"_json, wrapper);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"b","tty":1}]})"_json, wrapper);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"c","tty":2}],"options":{"return_old_data":true}})"_json, wrapper);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"d","tty":2}],"options":{"ignore":["name"]}})"_json, wrapper);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"e","tty":3}],"options":{"ignore":["name"]}})"_json, wrapper);
+    EXPECT_THROW(syncRow(engine, R"({"table":"processes","data":[{"name":"f"}]})"_json, wrapper), std::exception);
+}
+
+TEST_F(MemoryDBEngineTest, MaxRows)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    EXPECT_THROW(engine.setMaxRows("processes", -1), dbengine_error);
+    EXPECT_NO_THROW(engine.setMaxRows("processes", 1));
+
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, R"({"pid":4})"_json)).Times(1);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4}]})"_json, wrapper);
+    EXPECT_THROW(syncRow(engine, R"({"table":"processes","data":[{"pid":5}]})"_json, wrapper), DbSync::max_rows_error);
+
+    EXPECT_NO_THROW(engine.setMaxRows("processes", 0));
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, R"({"pid":5})"_json)).Times(1);
+    syncRow(engine, R"({"table":"processes","data":[{"pid":5}]})"_json, wrapper);
+}
+
+TEST_F(MemoryDBEngineTest, SelectRanges)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    engine.bulkInsert("processes", R"([{"pid":1,"name":"System","tty":1},{"pid":2,"name":"b","tty":2},{"pid":3,"name":"a"},{"pid":4,"name":"c","tty":2}])"_json);
+
+    InSequence sequence;
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":2,"name":"b"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":3,"name":"a"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"count":3})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":4})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":1})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":4,"name":"c"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":2,"name":"b"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":1,"name":"System"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"tty":1})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"tty":2})"_json)).Times(1);
+
+    select(engine, "processes", R"({"column_list":["pid, name"],"row_filter":"WHERE pid BETWEEN '2' and '3' ORDER BY pid","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+    select(engine, "processes", R"({"column_list":["count(*) AS count "],"row_filter":"WHERE pid BETWEEN 2 and 4","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+    select(engine, "processes", R"({"column_list":["pid"],"row_filter":" ","distinct_opt":false,"order_by_opt":"pid DESC","count_opt":1})"_json, wrapper);
+    select(engine, "processes", R"({"column_list":["pid"],"row_filter":" ","distinct_opt":false,"order_by_opt":"pid ASC","count_opt":1})"_json, wrapper);
+    select(engine, "processes", R"({"column_list":["pid","name"],"row_filter":"WHERE tty > 1 OR name LIKE 'SYS%'","distinct_opt":false,"order_by_opt":"name DESC"})"_json, wrapper);
+    select(engine, "processes", R"({"column_list":["tty"],"row_filter":"WHERE tty IS NOT NULL","distinct_opt":true,"order_by_opt":""})"_json, wrapper);
+
+    EXPECT_THROW(select(engine, "processes", R"({"column_list":["dummy"],"row_filter":"","distinct_opt":false,"order_by_opt":""})"_json, wrapper), dbengine_error);
+    EXPECT_THROW(select(engine, "processes", R"({"column_list":["*"],"row_filter":"WHERE pid ==","distinct_opt":false,"order_by_opt":""})"_json, wrapper), dbengine_error);
+}
+
+TEST_F(MemoryDBEngineTest, RefreshTableData)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+    std::shared_timed_mutex mutex;
+    std::unique_lock<std::shared_timed_mutex> lock{ mutex };
+
+    engine.bulkInsert("registry", R"([{"path":"a","arch":"[x64]","checksum":"1"},{"path":"b","arch":"[x64]","checksum":"2"}])"_json);
+
+    InSequence sequence;
+    EXPECT_CALL(wrapper, callbackMock(DELETED, R"({"path":"a","arch":"[x64]"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, R"({"PK_path":"b","PK_arch":"[x64]","checksum":"3"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, R"({"path":"c","arch":"[x32]","checksum":"4","dhcp":"disabled"})"_json)).Times(1);
+
+    engine.refreshTableData(R"({"table":"registry","data":[{"path":"b","arch":"[x64]","checksum":"3"},{"path":"c","arch":"[x32]","checksum":"4"}]})"_json,
+                            callbackWrapper(wrapper),
+                            lock);
+}
+
+TEST_F(MemoryDBEngineTest, StatusField)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+    std::shared_timed_mutex mutex;
+    std::unique_lock<std::shared_timed_mutex> lock{ mutex };
+
+    EXPECT_THROW(engine.deleteRowsByStatusField(R"(["processes"])"_json), dbengine_error);
+
+    engine.bulkInsert("processes", R"([{"pid":4,"name":"a"},{"pid":5,"name":"b"}])"_json);
+    engine.initializeStatusField(R"(["processes"])"_json);
+
+    InSequence sequence;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, R"({"pid":6,"name":"c"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(DELETED, R"({"pid":5,"name":"b","tty":0,"fv":0.0})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":4,"name":"a"})"_json)).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"pid":6,"name":"c"})"_json)).Times(1);
+
+    syncRow(engine, R"({"table":"processes","data":[{"pid":4,"name":"a"},{"pid":6,"name":"c"}]})"_json, wrapper, true);
+    engine.returnRowsMarkedForDelete(R"(["processes"])"_json, callbackWrapper(wrapper), lock);
+    engine.deleteRowsByStatusField(R"(["processes"])"_json);
+    select(engine, "processes", R"({"column_list":["*"],"row_filter":"","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+}
+
+TEST_F(MemoryDBEngineTest, DeleteTableRowsData)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    engine.bulkInsert("registry", R"([{"path":"a","arch":"[x64]","checksum":"1"},{"path":"a","arch":"[x32]","checksum":"2"},{"path":"b","arch":"[x64]","checksum":"3"}])"_json);
+
+    EXPECT_THROW(engine.deleteTableRowsData("registry", R"({"data":[{"path":"a"}]})"_json), dbengine_error);
+    EXPECT_THROW(engine.deleteTableRowsData("registry", R"({"where_filter_opt":""})"_json), dbengine_error);
+    EXPECT_NO_THROW(engine.deleteTableRowsData("registry", R"({"data":[{"path":"a","arch":"[x32]"}]})"_json));
+    EXPECT_NO_THROW(engine.deleteTableRowsData("registry", R"({"where_filter_opt":"checksum = \"3\""})"_json));
+
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"path":"a","arch":"[x64]","checksum":"1","dhcp":"disabled"})"_json)).Times(1);
+    select(engine, "registry", R"({"column_list":["*"],"row_filter":"","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+}
+
+TEST_F(MemoryDBEngineTest, TableRelationship)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    CallbackMock wrapper;
+
+    engine.addTableRelationship(R"({"base_table":"processes","relationed_tables":[{"table":"processes_sockets","field_match":{"pid":"pid"}}]})"_json);
+    engine.bulkInsert("processes", R"([{"pid":4},{"pid":5}])"_json);
+    engine.bulkInsert("processes_sockets", R"([{"socket_id":1,"pid":4},{"socket_id":2,"pid":5},{"socket_id":3,"pid":4}])"_json);
+    engine.deleteTableRowsData("processes", R"({"data":[{"pid":4}]})"_json);
+
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, R"({"socket_id":2,"pid":5})"_json)).Times(1);
+    select(engine, "processes_sockets", R"({"column_list":["*"],"row_filter":"","distinct_opt":false,"order_by_opt":""})"_json, wrapper);
+}
+
+TEST_F(MemoryDBEngineTest, StatementCacheStats)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    nlohmann::json stats;
+
+    engine.bulkInsert("processes", R"([{"pid":4},{"pid":5}])"_json);
+    engine.getStatementCacheStats(stats);
+
+    EXPECT_EQ(R"({"prepared":0,"reused":0,"evicted":0,"cached":0,"limit":0})"_json, stats);
+}
+
+TEST_F(MemoryDBEngineTest, StorageStats)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+    nlohmann::json stats;
+
+    engine.bulkInsert("processes", R"([{"pid":4},{"pid":5}])"_json);
+    engine.setMemoryLimit(1024);
+    engine.getStorageStats(stats);
+
+    EXPECT_EQ(R"({"memory_used":0,"memory_limit":0,"db_size":0,"cache_hit":0,"cache_miss":0,"cache_spill":0})"_json, stats);
+}
+
+TEST_F(MemoryDBEngineTest, TableRowCount)
+{
+    MemoryDBEngine engine{ CREATE_STATEMENT };
+
+    EXPECT_EQ(0, engine.getTableRowCount("processes"));
+    engine.bulkInsert("processes", R"([{"pid":4},{"pid":5}])"_json);
+    EXPECT_EQ(2, engine.getTableRowCount("processes"));
+    EXPECT_THROW(engine.getTableRowCount("dummy"), dbengine_error);
+}
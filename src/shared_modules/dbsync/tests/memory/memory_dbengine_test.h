@@ -0,0 +1,25 @@
+/*
+ * Wazuh DBSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _MEMORY_DBENGINE_TEST_H
+#define _MEMORY_DBENGINE_TEST_H
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+class MemoryDBEngineTest : public ::testing::Test
+{
+    protected:
+
+        MemoryDBEngineTest() = default;
+        virtual ~MemoryDBEngineTest() = default;
+};
+
+#endif //_MEMORY_DBENGINE_TEST_H
@@ -12,6 +12,7 @@
 #define _ACTION_H
 #include <json.hpp>
 #include <mutex>
+#include <chrono>
 #include "dbsync.h"
 #include "makeUnique.h"
 #include "cjsonSmartDeleter.hpp"
@@ -449,6 +450,87 @@ struct UpdateWithSnapshotActionCPP final : public IAction
     }
 };
 
+struct BenchmarkSnapshotActionCPP final : public IAction
+{
+    void execute(std::unique_ptr<TestContext>& ctx,
+                 const nlohmann::json& value) override
+    {
+        std::stringstream oFileName;
+        oFileName << "action_" << ctx->currentId << ".json";
+        const auto outputFileName{ ctx->outputPath + "/" + oFileName.str() };
+
+        int retVal{ 0 };
+        nlohmann::json jsonResult { };
+
+        try
+        {
+            const auto& body { value.at("body") };
+            const auto& key { body.at("key").get_ref<const std::string&>() };
+            const auto& changedField { body.at("changed_field").get_ref<const std::string&>() };
+            std::unique_ptr<DBSync> dbSync { std::make_unique<DBSync>(ctx->handle) };
+
+            for (const auto& size : body.at("sizes"))
+            {
+                nlohmann::json snapshot { { "table", body.at("table") }, { "data", nlohmann::json::array() } };
+
+                for (int64_t i = 0; i < size.get<int64_t>(); ++i)
+                {
+                    auto row = body.at("row");
+                    row[key] = i;
+                    snapshot["data"].push_back(row);
+                }
+
+                // The same snapshot is applied to an empty table, unchanged, with a changed field and empty.
+                for (const auto& step : { "initial", "unchanged", "changed", "empty" })
+                {
+                    if (0 == std::string(step).compare("changed"))
+                    {
+                        for (auto& row : snapshot["data"])
+                        {
+                            row[changedField] = row.at(changedField).get<std::string>() + "_changed";
+                        }
+                    }
+                    else if (0 == std::string(step).compare("empty"))
+                    {
+                        snapshot["data"] = nlohmann::json::array();
+                    }
+
+                    size_t events { 0 };
+                    const auto start { std::chrono::steady_clock::now() };
+                    dbSync->updateWithSnapshot(snapshot, [&events](ReturnTypeCallback, const nlohmann::json&)
+                    {
+                        ++events;
+                    });
+                    const auto elapsed { std::chrono::steady_clock::now() - start };
+
+                    jsonResult.push_back({{"rows", size},
+                        {"step", step},
+                        {"events", events},
+                        {"ms", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()}
+                    });
+                }
+            }
+        }
+        catch (const nlohmann::detail::exception& ex)
+        {
+            retVal = ex.id;
+        }
+        catch (const DbSync::dbsync_error& ex)
+        {
+            retVal = ex.id();
+        }
+        catch (...)
+        {
+            retVal = -1;
+        }
+
+        jsonResult.push_back({"benchmarkSnapshot", retVal });
+
+        std::ofstream outputFile{ outputFileName };
+        outputFile << jsonResult.dump() << std::endl;
+    }
+};
+
 struct CreateTransactionActionCPP final : public IAction
 {
     void execute(std::unique_ptr<TestContext>& ctx,
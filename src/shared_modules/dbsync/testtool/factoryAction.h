@@ -73,6 +73,10 @@ class FactoryAction
             {
                 return std::make_unique<UpdateWithSnapshotActionCPP>();
             }
+            else if (0 == actionCode.compare("benchmarkSnapshot"))
+            {
+                return std::make_unique<BenchmarkSnapshotActionCPP>();
+            }
             else if (0 == actionCode.compare("createTxn"))
             {
                 return std::make_unique<CreateTransactionActionCPP>();
@@ -0,0 +1,303 @@
+/*
+ * Wazuh RSYNC
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include "json.hpp"
+#include "dbsync.hpp"
+#include "rsync.hpp"
+#include "benchmarkHelper.h"
+#include "tableShapes.h"
+
+constexpr auto TXN_QUEUE_SIZE { 4096 };
+constexpr auto SYNC_HEADER_ID { "fim_file" };
+
+constexpr auto FILE_SYNC_CONFIG_STATEMENT
+{
+    R"(
+    {
+        "decoder_type":"JSON_RANGE",
+        "table":"file_entry",
+        "component":"fim_file",
+        "index":"path",
+        "checksum_field":"checksum",
+        "last_event":"last_event",
+        "no_data_query_json": {
+                "row_filter":"WHERE path BETWEEN '?' and '?' ORDER BY path",
+                "column_list":["*"],
+                "distinct_opt":false,
+                "order_by_opt":""
+        },
+        "count_range_query_json": {
+                "row_filter":"WHERE path BETWEEN '?' and '?' ORDER BY path",
+                "count_field_name":"count",
+                "column_list":["count(*) AS count"],
+                "distinct_opt":false,
+                "order_by_opt":""
+        },
+        "row_data_query_json": {
+                "row_filter":"WHERE path = '?'",
+                "column_list":["*"],
+                "distinct_opt":false,
+                "order_by_opt":""
+        },
+        "range_checksum_query_json": {
+                "row_filter":"WHERE path BETWEEN '?' and '?' ORDER BY path",
+                "column_list":["*"],
+                "distinct_opt":false,
+                "order_by_opt":""
+        }
+    }
+    )"
+};
+
+constexpr auto FILE_START_CONFIG_STATEMENT
+{
+    R"({"table":"file_entry",
+        "first_query":
+            {
+                "column_list":["path"],
+                "row_filter":" ",
+                "distinct_opt":false,
+                "order_by_opt":"path DESC",
+                "count_opt":1
+            },
+        "last_query":
+            {
+                "column_list":["path"],
+                "row_filter":" ",
+                "distinct_opt":false,
+                "order_by_opt":"path ASC",
+                "count_opt":1
+            },
+        "component":"fim_file",
+        "index":"path",
+        "last_event":"last_event",
+        "checksum_field":"checksum",
+        "range_checksum_query_json":
+            {
+                "row_filter":"WHERE path BETWEEN '?' and '?' ORDER BY path",
+                "column_list":["path, checksum"],
+                "distinct_opt":false,
+                "order_by_opt":"",
+                "count_opt":100
+            }
+        })"
+};
+
+static std::string s_dbPath { "rsync_benchmark.db" };
+
+/**
+ * @brief Database with the first \p rows FIM file entries, filled by a transaction as the first scan does.
+ */
+static std::unique_ptr<DBSync> createDatabase(const uint64_t rows)
+{
+    const auto callback { [](ReturnTypeCallback, const nlohmann::json&) {} };
+
+    std::remove(s_dbPath.c_str());
+    auto spDBSync { std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, s_dbPath, FILE_ENTRY_SQL_STATEMENT) };
+
+    DBSyncTxn txn { spDBSync->handle(), nlohmann::json{{"table", FILE_ENTRY_TABLE}}, 0, TXN_QUEUE_SIZE, callback };
+
+    for (uint64_t index { 0 }; index < rows; ++index)
+    {
+        txn.syncTxnRow({ {"table", FILE_ENTRY_TABLE}, {"data", nlohmann::json::array({ fileEntryRow(index) })} });
+    }
+
+    txn.getDeletedRows(callback);
+
+    return spDBSync;
+}
+
+static void benchmarkStartSync(Utils::BenchmarkState& state)
+{
+    uint64_t messages { 0 };
+
+    state.pauseTiming();
+    auto spDBSync { createDatabase(state.range()) };
+    RemoteSync remoteSync { 1 };
+    state.resumeTiming();
+
+    remoteSync.startSync(spDBSync->handle(), nlohmann::json::parse(FILE_START_CONFIG_STATEMENT), [&messages](const std::string&)
+    {
+        ++messages;
+    });
+
+    state.addItemsProcessed(state.range());
+    state.pauseTiming();
+}
+
+/**
+ * @brief Manager that fails every checksum, so the agent splits the whole table down to its rows.
+ *
+ * Each checksum_fail of a range with several rows is answered with its two halves, and the
+ * ones of a single row with the row itself, which closes it.
+ */
+static void benchmarkSplitResolve(Utils::BenchmarkState& state)
+{
+    std::mutex mutex;
+    std::condition_variable done;
+    uint64_t pending { 0 };
+    uint64_t rowsSent { 0 };
+
+    state.pauseTiming();
+    auto spDBSync { createDatabase(state.range()) };
+    RemoteSync remoteSync;
+    state.resumeTiming();
+
+    const auto checksumFail
+    {
+        [&remoteSync, &pending](const nlohmann::json & range)
+        {
+            const auto& begin { range.at("begin").get_ref<const std::string&>() };
+            const auto& end { range.at("end").get_ref<const std::string&>() };
+            const nlohmann::json payload { {"begin", begin}, {"end", end}, {"id", range.at("id")} };
+            const auto message { std::string(SYNC_HEADER_ID) + " checksum_fail " + payload.dump() };
+
+            pending += begin == end ? 1 : 2;
+            remoteSync.pushMessage(std::vector<uint8_t> { message.begin(), message.end() });
+        }
+    };
+
+    remoteSync.registerSyncID(SYNC_HEADER_ID,
+                              spDBSync->handle(),
+                              nlohmann::json::parse(FILE_SYNC_CONFIG_STATEMENT),
+                              [&](const std::string & payload)
+    {
+        const auto message { nlohmann::json::parse(payload) };
+        std::lock_guard<std::mutex> lock { mutex };
+
+        if (message.at("type") == "state")
+        {
+            ++rowsSent;
+        }
+        else
+        {
+            checksumFail(message.at("data"));
+        }
+
+        if (0 == --pending)
+        {
+            done.notify_one();
+        }
+    });
+
+    {
+        std::unique_lock<std::mutex> lock { mutex };
+        checksumFail(
+        {
+            {"begin", benchmarkKey("/usr/share/benchmark/", 0)},
+            {"end", benchmarkKey("/usr/share/benchmark/", state.range() - 1)},
+            {"id", std::time(nullptr)}
+        });
+        done.wait(lock, [&pending]()
+        {
+            return 0 == pending;
+        });
+    }
+
+    if (rowsSent != state.range())
+    {
+        throw std::runtime_error { "Split sent " + std::to_string(rowsSent) + " rows instead of " + std::to_string(state.range()) };
+    }
+
+    state.addItemsProcessed(state.range());
+    state.pauseTiming();
+}
+
+static void showHelp()
+{
+    std::cout << "\nUsage: rsync_benchmark <option(s)>\n"
+              << "Options:\n"
+              << "\t-h \t\t\tShow this help message\n"
+              << "\t-f FILTER\t\tRun only the benchmarks whose name contains FILTER.\n"
+              << "\t-m MAX_RANGE\t\tSkip the ranges (rows) above MAX_RANGE.\n"
+              << "\t-t MIN_TIME\t\tMinimum seconds each range is measured (default 0, one iteration).\n"
+              << "\t-d DB_PATH\t\tDatabase file used by the benchmarks (default rsync_benchmark.db).\n"
+              << "\t-j \t\t\tPrint the report as JSON.\n"
+              << "\nExample:"
+              << "\n\t./rsync_benchmark -f SplitResolve -m 10000\n"
+              << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    std::string filter;
+    uint64_t maxRange { 0 };
+    double minTime { 0 };
+    bool jsonFormat { false };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option { argv[i] };
+
+        if (option == "-j")
+        {
+            jsonFormat = true;
+        }
+        else if (i + 1 < argc && option == "-f")
+        {
+            filter = argv[++i];
+        }
+        else if (i + 1 < argc && option == "-m")
+        {
+            maxRange = std::stoull(argv[++i]);
+        }
+        else if (i + 1 < argc && option == "-t")
+        {
+            minTime = std::stod(argv[++i]);
+        }
+        else if (i + 1 < argc && option == "-d")
+        {
+            s_dbPath = argv[++i];
+        }
+        else
+        {
+            showHelp();
+            return option == "-h" ? 0 : 1;
+        }
+    }
+
+    try
+    {
+        Utils::BenchmarkRunner runner;
+        const auto logFunction
+        {
+            [](const std::string & msg)
+            {
+                std::cerr << msg << std::endl;
+            }
+        };
+
+        DBSync::initialize(logFunction);
+        RemoteSync::initialize(logFunction);
+
+        runner.add("BM_RsyncStartSync/file_entry", { 10000, 100000, 500000 }, benchmarkStartSync);
+        runner.add("BM_RsyncSplitResolve/file_entry", { 1000, 10000, 100000 }, benchmarkSplitResolve);
+
+        runner.run(filter, maxRange, minTime, jsonFormat);
+
+        RemoteSync::teardown();
+        DBSync::teardown();
+        std::remove(s_dbPath.c_str());
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -82,6 +82,11 @@ EXPORTED int rsync_start_sync(const RSYNC_HANDLE handle,
  *
  * @return 0 if succeeded,
  *         specific error code (OS dependent) otherwise.
+ *
+ * @details The optional \p sync_configuration "max_split_fanout" value splits a failed range
+ *  in up to that many parts instead of two. The optional "full_data_threshold" value sends
+ *  the rows of failed ranges up to that size instead of splitting them, and sizes the parts
+ *  of bigger ranges around it.
  */
 EXPORTED int rsync_register_sync_id(const RSYNC_HANDLE handle,
                                     const char* message_header_id,
@@ -12,6 +12,8 @@
 #ifndef _JSON_MESSAGE_DECODER_H
 #define _JSON_MESSAGE_DECODER_H
 
+#include <algorithm>
+#include <limits>
 #include "imessageDecoder.h"
 #include "json.hpp"
 
@@ -26,45 +28,287 @@ namespace RSync
             SyncInputData decode(const std::vector<unsigned char>& rawData) override
             {
                 SyncInputData retVal{};
-                const std::string rawDataString { reinterpret_cast<const char*>(rawData.data()), rawData.size() };
-                const auto firstToken { rawDataString.find(' ') };
+                const auto begin { reinterpret_cast<const char*>(rawData.data()) };
+                const auto end { begin + rawData.size() };
+                const auto firstToken { std::find(begin, end, ' ') };
 
-                if (std::string::npos != firstToken)
+                if (end != firstToken)
                 {
-                    const auto rawDataStringFromFirst { rawDataString.substr(firstToken + 1, rawDataString.length() - firstToken - 1) };
-                    const auto secondToken { rawDataStringFromFirst.find(' ') };
+                    const auto secondToken { std::find(firstToken + 1, end, ' ') };
 
-                    if (std::string::npos != secondToken)
+                    if (end != secondToken)
                     {
-                        retVal.command = rawDataStringFromFirst.substr(0, secondToken);
+                        retVal.command.assign(firstToken + 1, secondToken);
 
-                        const auto rawDataStringFromSecond { rawDataStringFromFirst.substr(secondToken + 1, rawDataStringFromFirst.length() - secondToken - 1) };
-                        const auto& json { nlohmann::json::parse(rawDataStringFromSecond) };
-                        const auto& begin{json.at("begin")};
-                        const auto& end{json.at("end")};
+                        // The manager sends flat objects, anything else goes through the JSON parser.
+                        if (!parseBody(secondToken + 1, end, retVal))
+                        {
+                            parseBodyDOM(secondToken + 1, end, retVal);
+                        }
+                    }
+                }
+
+                return retVal;
+            }
+
+        private:
+            static void parseBodyDOM(const char* begin, const char* end, SyncInputData& retVal)
+            {
+                const auto& json { nlohmann::json::parse(begin, end) };
+                const auto& rangeBegin{json.at("begin")};
+                const auto& rangeEnd{json.at("end")};
+
+                if (rangeBegin.is_string())
+                {
+                    retVal.begin = rangeBegin;
+                    retVal.end = rangeEnd;
+                }
+                else
+                {
+                    retVal.begin = std::to_string(rangeBegin.get<unsigned long>());
+                    retVal.end = std::to_string(rangeEnd.get<unsigned long>());
+                }
+
+                retVal.id = json.at("id").get<int32_t>();
+            }
+
+            /**
+             * @brief Reads the begin, end and id fields straight from the message.
+             *
+             * @return false if the body isn't a flat object with string and integer values, or
+             * if a field is missing, so the caller falls back to the JSON parser.
+             */
+            static bool parseBody(const char* it, const char* end, SyncInputData& retVal)
+            {
+                std::string key;
+                std::string value;
+                bool isString { false };
+                bool hasBegin { false };
+                bool hasEnd { false };
+                bool hasId { false };
+
+                skipSpaces(it, end);
+
+                if (it == end || '{' != *it++)
+                {
+                    return false;
+                }
+
+                while (true)
+                {
+                    skipSpaces(it, end);
+
+                    if (!parseString(it, end, key))
+                    {
+                        return false;
+                    }
+
+                    skipSpaces(it, end);
+
+                    if (it == end || ':' != *it++)
+                    {
+                        return false;
+                    }
+
+                    skipSpaces(it, end);
+
+                    if (!parseScalar(it, end, value, isString))
+                    {
+                        return false;
+                    }
 
-                        if (begin.is_string())
+                    if ("begin" == key || "end" == key)
+                    {
+                        // The numeric ranges must be unsigned integers.
+                        if (!isString && (value.empty() || '-' == value.front()))
                         {
-                            retVal.begin = begin;
-                            retVal.end = end;
+                            return false;
                         }
-                        else
+
+                        ("begin" == key ? hasBegin : hasEnd) = true;
+                        ("begin" == key ? retVal.begin : retVal.end) = value;
+                    }
+                    else if ("id" == key)
+                    {
+                        if (isString || !parseId(value, retVal.id))
                         {
-                            const auto beginNumber{begin.get<unsigned long>()};
-                            const auto endNumber{end.get<unsigned long>()};
-                            const auto beginString{std::to_string(beginNumber)};
-                            const auto endString{std::to_string(endNumber)};
-                            retVal.begin = beginString;
-                            retVal.end = endString;
+                            return false;
                         }
 
-                        retVal.id = json.at("id").get<int32_t>();
+                        hasId = true;
+                    }
+
+                    skipSpaces(it, end);
+
+                    if (it == end)
+                    {
+                        return false;
+                    }
+
+                    if ('}' == *it)
+                    {
+                        ++it;
+                        break;
+                    }
+
+                    if (',' != *it++)
+                    {
+                        return false;
                     }
                 }
 
-                return retVal;
+                skipSpaces(it, end);
+
+                return it == end && hasBegin && hasEnd && hasId;
+            }
+
+            static void skipSpaces(const char*& it, const char* end)
+            {
+                while (it != end && (' ' == *it || '\t' == *it || '\n' == *it || '\r' == *it))
+                {
+                    ++it;
+                }
+            }
+
+            static bool parseString(const char*& it, const char* end, std::string& value)
+            {
+                if (it == end || '"' != *it++)
+                {
+                    return false;
+                }
+
+                value.clear();
+
+                while (it != end)
+                {
+                    const auto character { *it++ };
+
+                    if ('"' == character)
+                    {
+                        return true;
+                    }
+
+                    if (static_cast<unsigned char>(character) < 0x20)
+                    {
+                        return false;
+                    }
+
+                    if ('\\' == character)
+                    {
+                        if (it == end)
+                        {
+                            return false;
+                        }
+
+                        switch (*it++)
+                        {
+                            case '"':
+                                value.push_back('"');
+                                break;
+                            case '\\':
+                                value.push_back('\\');
+                                break;
+                            case '/':
+                                value.push_back('/');
+                                break;
+                            case 'b':
+                                value.push_back('\b');
+                                break;
+                            case 'f':
+                                value.push_back('\f');
+                                break;
+                            case 'n':
+                                value.push_back('\n');
+                                break;
+                            case 'r':
+                                value.push_back('\r');
+                                break;
+                            case 't':
+                                value.push_back('\t');
+                                break;
+                            default:
+                                // The unicode escapes are left to the JSON parser.
+                                return false;
+                        }
+                    }
+                    else
+                    {
+                        value.push_back(character);
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief Reads a string or an integer. The other values are only accepted for the
+             * fields the decoder ignores, and come back as an empty value.
+             */
+            static bool parseScalar(const char*& it, const char* end, std::string& value, bool& isString)
+            {
+                isString = it != end && '"' == *it;
+
+                if (isString)
+                {
+                    return parseString(it, end, value);
+                }
+
+                value.clear();
+
+                if (it != end && '-' == *it)
+                {
+                    value.push_back(*it++);
+                }
+
+                while (it != end && *it >= '0' && *it <= '9')
+                {
+                    value.push_back(*it++);
+                }
+
+                if (value.empty())
+                {
+                    for (const auto* literal : { "true", "false", "null" })
+                    {
+                        const auto length { std::char_traits<char>::length(literal) };
+
+                        if (static_cast<size_t>(end - it) >= length && std::equal(literal, literal + length, it))
+                        {
+                            it += length;
+                            value.clear();
+                            return true;
+                        }
+                    }
+
+                    return false;
+                }
+
+                const auto digits { '-' == value.front() ? value.c_str() + 1 : value.c_str() };
+
+                // No leading zeros, fractions or exponents.
+                return '\0' != digits[0] &&
+                       !('0' == digits[0] && '\0' != digits[1]) &&
+                       (it == end || ('.' != *it && 'e' != *it && 'E' != *it));
+            }
+
+            static bool parseId(const std::string& value, int32_t& id)
+            {
+                // Sign and ten digits at most, so the value fits in a long long.
+                if (value.empty() || value.size() > std::numeric_limits<int32_t>::digits10 + 2)
+                {
+                    return false;
+                }
+
+                const auto number { std::stoll(value) };
+
+                if (number < std::numeric_limits<int32_t>::min() || number > std::numeric_limits<int32_t>::max())
+                {
+                    return false;
+                }
+
+                id = static_cast<int32_t>(number);
+                return true;
             }
     };
 }// namespace RSync
 
-#endif // _JSON_MESSAGE_DECODER_H
\ No newline at end of file
+#endif // _JSON_MESSAGE_DECODER_H
@@ -19,23 +19,22 @@ using namespace RSync;
 
 void RSyncImplementation::release()
 {
-    std::lock_guard<std::mutex> lock{ m_mutex };
-
-    for (const auto& ctx : m_remoteSyncContexts)
+    m_remoteSyncContexts.forEach([this](const RSYNC_HANDLE handle, const std::shared_ptr<RSyncContext>& spRSyncContext)
     {
-        m_registrationController.removeComponentByHandle(ctx.first);
-        ctx.second->m_msgDispatcher->rundown();
-    }
+        m_registrationController.removeComponentByHandle(handle);
+        spRSyncContext->m_msgDispatcher->rundown();
+    });
 
     m_remoteSyncContexts.clear();
+    removeUnregisteredRangeChecksums();
 }
 
 void RSyncImplementation::releaseContext(const RSYNC_HANDLE handle)
 {
     m_registrationController.removeComponentByHandle(handle);
     remoteSyncContext(handle)->m_msgDispatcher->rundown();
-    std::lock_guard<std::mutex> lock{ m_mutex };
     m_remoteSyncContexts.erase(handle);
+    removeUnregisteredRangeChecksums();
 }
 
 RSYNC_HANDLE RSyncImplementation::create(const unsigned int threadPoolSize, const size_t maxQueueSize)
@@ -45,8 +44,7 @@ RSYNC_HANDLE RSyncImplementation::create(const unsigned int threadPoolSize, cons
         std::make_shared<RSyncContext>(threadPoolSize, maxQueueSize)
     };
     const RSYNC_HANDLE handle{ spRSyncContext.get() };
-    std::lock_guard<std::mutex> lock{m_mutex};
-    m_remoteSyncContexts[handle] = spRSyncContext;
+    m_remoteSyncContexts.insert(handle, spRSyncContext);
     return handle;
 }
 
@@ -105,6 +103,9 @@ void RSyncImplementation::startRSync(const RSYNC_HANDLE handle,
             checksumCtx.rightCtx.type = IntegrityMsgType::INTEGRITY_CLEAR;
         }
 
+        // The answers to the previous sessions of the component are dropped from now on.
+        setSyncId(startConfiguration.at("component").get_ref<const std::string&>(), checksumCtx.rightCtx.id);
+
         // rightCtx will have the final checksum based on fillChecksum method. After processing all checksum select data
         // checksumCtx.rightCtx will have the needed (final) information
         messageCreator->send(callbackWrapper, startConfiguration, checksumCtx.rightCtx);
@@ -117,15 +118,14 @@ void RSyncImplementation::startRSync(const RSYNC_HANDLE handle,
 
 std::shared_ptr<RSyncImplementation::RSyncContext> RSyncImplementation::remoteSyncContext(const RSYNC_HANDLE handle)
 {
-    std::lock_guard<std::mutex> lock{m_mutex};
-    const auto it{ m_remoteSyncContexts.find(handle) };
+    const auto spRSyncContext{ m_remoteSyncContexts[handle] };
 
-    if (it == m_remoteSyncContexts.end())
+    if (!spRSyncContext)
     {
         throw rsync_error { INVALID_HANDLE };
     }
 
-    return it->second;
+    return spRSyncContext;
 }
 
 void RSyncImplementation::registerSyncId(const RSYNC_HANDLE handle,
@@ -144,10 +144,19 @@ void RSyncImplementation::registerSyncId(const RSYNC_HANDLE handle,
 
     ctx->m_msgDispatcher->setMessageDecoderType(messageHeaderID, syncMessageType);
 
+    const auto component { syncConfiguration.value("component", "") };
+
     const auto registerCallback
     {
-        [spDBSyncWrapper, syncConfiguration, callbackWrapper] (const SyncInputData & syncData)
+        [spDBSyncWrapper, syncConfiguration, callbackWrapper, component] (const SyncInputData & syncData)
         {
+            // The messages of the sessions before the one the agent last started are superseded.
+            // The ids are compared for equality, as they come from the clock and it may step back.
+            if (!RSyncImplementation::instance().isCurrentSyncId(component, syncData.id))
+            {
+                return;
+            }
+
             try
             {
                 if (0 == syncData.command.compare("checksum_fail"))
@@ -191,7 +200,32 @@ void RSyncImplementation::sendChecksumFail(const std::shared_ptr<DBSyncWrapper>&
                                            const ResultCallback callbackWrapper,
                                            const SyncInputData syncData)
 {
-    const auto size { getRangeCount(spDBSyncWrapper, jsonSyncConfiguration, syncData) };
+    const auto& component { jsonSyncConfiguration.at("component").get_ref<const std::string&>() };
+    auto spRangeChecksums { RSyncImplementation::instance().cachedRangeChecksums(component, syncData.id) };
+    size_t first { 0ull };
+    size_t size { 0ull };
+
+    if (spRangeChecksums)
+    {
+        const auto& positions { spRangeChecksums->positions };
+        const auto itBegin { positions.find(syncData.begin) };
+        const auto itEnd { positions.find(syncData.end) };
+
+        if (positions.end() != itBegin && positions.end() != itEnd && itBegin->second <= itEnd->second)
+        {
+            first = itBegin->second;
+            size = itEnd->second - itBegin->second + 1;
+        }
+        else
+        {
+            spRangeChecksums.reset();
+        }
+    }
+
+    if (!spRangeChecksums)
+    {
+        size = getRangeCount(spDBSyncWrapper, jsonSyncConfiguration, syncData);
+    }
 
     if (1 == size && syncData.begin.compare(syncData.end) == 0)
     {
@@ -202,21 +236,74 @@ void RSyncImplementation::sendChecksumFail(const std::shared_ptr<DBSyncWrapper>&
     else if (1 <= size)
     {
         auto messageCreator { FactoryMessageCreator<SplitContext, MessageType::CHECKSUM>::create() };
+        auto count { size };
+
+        if (!spRangeChecksums)
+        {
+            const auto spSelectedChecksums { getRangeChecksums(spDBSyncWrapper, jsonSyncConfiguration, syncData) };
+            count = spSelectedChecksums->rows.size();
+
+            if (0 != count)
+            {
+                RSyncImplementation::instance().cacheRangeChecksums(component, spSelectedChecksums);
+            }
 
-        ChecksumContext checksumCtx;
-        checksumCtx.type = CHECKSUM_SPLIT;
-        checksumCtx.size = size;
-        checksumCtx.leftCtx.id = syncData.id;
-        checksumCtx.leftCtx.type = IntegrityMsgType::INTEGRITY_CHECK_LEFT;
-        checksumCtx.leftCtx.begin = syncData.begin;
+            spRangeChecksums = spSelectedChecksums;
+        }
 
-        checksumCtx.rightCtx.id = syncData.id;
-        checksumCtx.rightCtx.type = IntegrityMsgType::INTEGRITY_CHECK_RIGHT;
-        checksumCtx.rightCtx.end = syncData.end;
-        fillChecksum(spDBSyncWrapper, jsonSyncConfiguration, syncData.begin, syncData.end, checksumCtx);
+        // Small ranges are sent in full: their rows followed by one check per row, so the manager removes
+        // the rows it has between them without another round trip. Bigger ones are split in up to
+        // max_split_fanout parts of around full_data_threshold rows.
+        const auto maxFanout { std::max<size_t>(2, jsonSyncConfiguration.value("max_split_fanout", 2ull)) };
+        const auto fullDataThreshold { jsonSyncConfiguration.value("full_data_threshold", 0ull) };
+        const auto fullData { 2 <= count && count <= fullDataThreshold };
+        const auto fanout
+        {
+            fullData ? count : std::min(count, std::min(maxFanout, fullDataThreshold ? std::max<size_t>(2, (size + fullDataThreshold - 1) / fullDataThreshold) : maxFanout))
+        };
+
+        if (fullData || 2 < fanout)
+        {
+            std::vector<SplitContext> splits(fanout);
+            fillChecksum(*spRangeChecksums, first, count, splits);
 
-        messageCreator->send(callbackWrapper, jsonSyncConfiguration, checksumCtx.leftCtx);
-        messageCreator->send(callbackWrapper, jsonSyncConfiguration, checksumCtx.rightCtx);
+            for (auto& split : splits)
+            {
+                split.id = syncData.id;
+                split.type = IntegrityMsgType::INTEGRITY_CHECK_LEFT;
+            }
+
+            splits.front().begin = syncData.begin;
+            splits.back().end = syncData.end;
+            splits.back().type = IntegrityMsgType::INTEGRITY_CHECK_RIGHT;
+
+            if (fullData)
+            {
+                sendAllData(spDBSyncWrapper, jsonSyncConfiguration, callbackWrapper, syncData);
+            }
+
+            for (const auto& split : splits)
+            {
+                messageCreator->send(callbackWrapper, jsonSyncConfiguration, split);
+            }
+        }
+        else
+        {
+            ChecksumContext checksumCtx;
+            checksumCtx.type = CHECKSUM_SPLIT;
+            checksumCtx.size = size;
+            checksumCtx.leftCtx.id = syncData.id;
+            checksumCtx.leftCtx.type = IntegrityMsgType::INTEGRITY_CHECK_LEFT;
+            checksumCtx.leftCtx.begin = syncData.begin;
+
+            checksumCtx.rightCtx.id = syncData.id;
+            checksumCtx.rightCtx.type = IntegrityMsgType::INTEGRITY_CHECK_RIGHT;
+            checksumCtx.rightCtx.end = syncData.end;
+            fillChecksum(*spRangeChecksums, first, count, checksumCtx);
+
+            messageCreator->send(callbackWrapper, jsonSyncConfiguration, checksumCtx.leftCtx);
+            messageCreator->send(callbackWrapper, jsonSyncConfiguration, checksumCtx.rightCtx);
+        }
     }
     else
     {
@@ -270,8 +357,6 @@ void RSyncImplementation::fillChecksum(const std::shared_ptr<DBSyncWrapper>& spD
 
     const auto& querySelect { jsonSyncConfiguration.at("range_checksum_query_json") };
     const auto& checksumFieldName { jsonSyncConfiguration.at("checksum_field").get_ref<const std::string&>() };
-    auto index { 1ull };
-    const auto middle { ctx.size / 2 };
 
     std::unique_ptr<Utils::HashData> hash{ std::make_unique<Utils::HashData>() };
     ResultCallbackData callback
@@ -280,32 +365,54 @@ void RSyncImplementation::fillChecksum(const std::shared_ptr<DBSyncWrapper>& spD
         {
             const auto checksumValue { resultJSON.at(checksumFieldName).get_ref<const std::string&>() };
             hash->update(checksumValue.data(), checksumValue.size());
+        }
+    };
 
-            if (CHECKSUM_SPLIT == ctx.type)
-            {
-                const auto& indexFieldName { jsonSyncConfiguration.at("index").get_ref<const std::string&>() };
-                const auto& result{resultJSON.at(indexFieldName)};
+    auto rowFilter { querySelect.at("row_filter").get_ref<const std::string&>() } ;
+    Utils::replaceFirst(rowFilter, "?", begin);
+    Utils::replaceFirst(rowFilter, "?", end);
 
-                if (middle + 1 == index)
-                {
-                    ctx.rightCtx.begin = result.is_string() ? result.get_ref<const std::string&>() : std::to_string(result.get<unsigned long>());
-                    ctx.leftCtx.tail = ctx.rightCtx.begin;
-                }
-                else if (middle == index)
-                {
-                    ctx.leftCtx.end = result.is_string() ? result.get_ref<const std::string&>() : std::to_string(result.get<unsigned long>());
-                    ctx.leftCtx.checksum = Utils::asciiToHex(hash->hash());
-                    hash = std::make_unique<Utils::HashData>();
-                }
+    auto& queryParam { selectData["query"] };
+    queryParam["row_filter"] = rowFilter;
+    queryParam["column_list"] = querySelect.at("column_list");
+    queryParam["distinct_opt"] = querySelect.at("distinct_opt");
+    queryParam["order_by_opt"] = querySelect.at("order_by_opt");
 
-                ++index;
-            }
+    spDBSyncWrapper->select(selectData, callback);
+
+    // rightCtx field will have the final checksum
+    ctx.rightCtx.checksum = Utils::asciiToHex(hash->hash());
+}
+
+std::shared_ptr<RangeChecksums> RSyncImplementation::getRangeChecksums(const std::shared_ptr<DBSyncWrapper>& spDBSyncWrapper,
+                                                                      const nlohmann::json& jsonSyncConfiguration,
+                                                                      const SyncInputData& syncData)
+{
+    nlohmann::json selectData;
+    selectData["table"] = jsonSyncConfiguration.at("table");
+
+    const auto& querySelect { jsonSyncConfiguration.at("range_checksum_query_json") };
+    const auto& checksumFieldName { jsonSyncConfiguration.at("checksum_field").get_ref<const std::string&>() };
+    const auto& indexFieldName { jsonSyncConfiguration.at("index").get_ref<const std::string&>() };
+    const auto spRangeChecksums { std::make_shared<RangeChecksums>() };
+    spRangeChecksums->id = syncData.id;
+
+    ResultCallbackData callback
+    {
+        [&] (ReturnTypeCallback /*callback*/, const nlohmann::json & resultJSON)
+        {
+            const auto& result{ resultJSON.at(indexFieldName) };
+            auto& rows { spRangeChecksums->rows };
+
+            rows.emplace_back(result.is_string() ? result.get_ref<const std::string&>() : std::to_string(result.get<unsigned long>()),
+                              resultJSON.at(checksumFieldName).get_ref<const std::string&>());
+            spRangeChecksums->positions.emplace(rows.back().first, rows.size() - 1);
         }
     };
 
     auto rowFilter { querySelect.at("row_filter").get_ref<const std::string&>() } ;
-    Utils::replaceFirst(rowFilter, "?", begin);
-    Utils::replaceFirst(rowFilter, "?", end);
+    Utils::replaceFirst(rowFilter, "?", syncData.begin);
+    Utils::replaceFirst(rowFilter, "?", syncData.end);
 
     auto& queryParam { selectData["query"] };
     queryParam["row_filter"] = rowFilter;
@@ -315,10 +422,140 @@ void RSyncImplementation::fillChecksum(const std::shared_ptr<DBSyncWrapper>& spD
 
     spDBSyncWrapper->select(selectData, callback);
 
+    return spRangeChecksums;
+}
+
+void RSyncImplementation::fillChecksum(const RangeChecksums& rangeChecksums,
+                                       const size_t first,
+                                       const size_t count,
+                                       ChecksumContext& ctx)
+{
+    const auto middle { ctx.size / 2 };
+    auto index { 1ull };
+
+    std::unique_ptr<Utils::HashData> hash{ std::make_unique<Utils::HashData>() };
+
+    for (auto it = rangeChecksums.rows.begin() + first; it != rangeChecksums.rows.begin() + first + count; ++it)
+    {
+        hash->update(it->second.data(), it->second.size());
+
+        if (middle + 1 == index)
+        {
+            ctx.rightCtx.begin = it->first;
+            ctx.leftCtx.tail = ctx.rightCtx.begin;
+        }
+        else if (middle == index)
+        {
+            ctx.leftCtx.end = it->first;
+            ctx.leftCtx.checksum = Utils::asciiToHex(hash->hash());
+            hash = std::make_unique<Utils::HashData>();
+        }
+
+        ++index;
+    }
+
     // rightCtx field will have the final checksum
     ctx.rightCtx.checksum = Utils::asciiToHex(hash->hash());
 }
 
+void RSyncImplementation::fillChecksum(const RangeChecksums& rangeChecksums,
+                                       const size_t first,
+                                       const size_t count,
+                                       std::vector<SplitContext>& splits)
+{
+    // Each split gets the same share of rows, the first split starts with the first row.
+    const auto fanout { splits.size() };
+    auto split { 0ull };
+
+    std::unique_ptr<Utils::HashData> hash{ std::make_unique<Utils::HashData>() };
+
+    for (auto index = 0ull; index < count; ++index)
+    {
+        const auto& row { rangeChecksums.rows[first + index] };
+
+        if (index == (split + 1) * count / fanout)
+        {
+            splits[split].checksum = Utils::asciiToHex(hash->hash());
+            splits[split].tail = row.first;
+            hash = std::make_unique<Utils::HashData>();
+            ++split;
+            splits[split].begin = row.first;
+        }
+
+        hash->update(row.second.data(), row.second.size());
+        splits[split].end = row.first;
+    }
+
+    splits[split].checksum = Utils::asciiToHex(hash->hash());
+}
+
+std::shared_ptr<const RangeChecksums> RSyncImplementation::cachedRangeChecksums(const std::string& component,
+                                                                              const int32_t id)
+{
+    std::lock_guard<std::mutex> lock{ m_rangeChecksumsMutex };
+    const auto it { m_rangeChecksums.find(component) };
+
+    return m_rangeChecksums.end() != it && id == it->second->id ? it->second : nullptr;
+}
+
+void RSyncImplementation::cacheRangeChecksums(const std::string& component,
+                                              const std::shared_ptr<const RangeChecksums>& spRangeChecksums)
+{
+    // Only the rows of the latest sync of each component are kept.
+    std::lock_guard<std::mutex> lock{ m_rangeChecksumsMutex };
+    m_rangeChecksums[component] = spRangeChecksums;
+}
+
+void RSyncImplementation::setSyncId(const std::string& component, const int32_t id)
+{
+    std::lock_guard<std::mutex> lock{ m_syncIdsMutex };
+    m_syncIds[component] = id;
+}
+
+bool RSyncImplementation::isCurrentSyncId(const std::string& component, const int32_t id)
+{
+    // Without a session started by this process, there is nothing to supersede.
+    std::lock_guard<std::mutex> lock{ m_syncIdsMutex };
+    const auto it { m_syncIds.find(component) };
+
+    return m_syncIds.end() == it || id == it->second;
+}
+
+void RSyncImplementation::removeUnregisteredRangeChecksums()
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_syncIdsMutex };
+        auto it { m_syncIds.begin() };
+
+        while (it != m_syncIds.end())
+        {
+            if (isComponentRegistered(it->first))
+            {
+                ++it;
+            }
+            else
+            {
+                it = m_syncIds.erase(it);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{ m_rangeChecksumsMutex };
+    auto it { m_rangeChecksums.begin() };
+
+    while (it != m_rangeChecksums.end())
+    {
+        if (isComponentRegistered(it->first))
+        {
+            ++it;
+        }
+        else
+        {
+            it = m_rangeChecksums.erase(it);
+        }
+    }
+}
+
 nlohmann::json RSyncImplementation::getRowData(const std::shared_ptr<DBSyncWrapper>& spDBSyncWrapper,
                                                const nlohmann::json& jsonSyncConfiguration,
                                                const std::string& index)
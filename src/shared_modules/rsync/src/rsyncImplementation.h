@@ -17,10 +17,12 @@
 #include <functional>
 #include <shared_mutex>
 #include <memory>
+#include <unordered_map>
 #include "commonDefs.h"
 #include "json.hpp"
 #include "registrationController.hpp"
 #include "msgDispatcher.h"
+#include "mapWrapperSafe.h"
 #include "syncDecoder.h"
 #include "dbsyncWrapper.h"
 #include "cjsonSmartDeleter.hpp"
@@ -67,6 +69,15 @@ namespace RSync
         size_t size;
     };
 
+    // Index and checksum of the rows of a failed checksum range, in the range checksum query order.
+    // The splits requested later in the same sync are answered from these rows, without selecting them again.
+    struct RangeChecksums
+    {
+        int32_t id;
+        std::vector<std::pair<std::string, std::string>> rows;
+        std::unordered_map<std::string, size_t> positions;
+    };
+
     static std::map<std::string, SyncMsgBodyType> SyncMsgBodyTypeMap
     {
         { "JSON_RANGE", SYNC_RANGE_JSON }
@@ -131,6 +142,34 @@ namespace RSync
                                      const std::string& end,
                                      ChecksumContext& ctx);
 
+            static std::shared_ptr<RangeChecksums> getRangeChecksums(const std::shared_ptr<DBSyncWrapper>& spDBSyncWrapper,
+                                                                     const nlohmann::json& jsonSyncConfiguration,
+                                                                     const SyncInputData& syncData);
+
+            static void fillChecksum(const RangeChecksums& rangeChecksums,
+                                     const size_t first,
+                                     const size_t count,
+                                     ChecksumContext& ctx);
+
+            static void fillChecksum(const RangeChecksums& rangeChecksums,
+                                     const size_t first,
+                                     const size_t count,
+                                     std::vector<SplitContext>& splits);
+
+            std::shared_ptr<const RangeChecksums> cachedRangeChecksums(const std::string& component,
+                                                                       const int32_t id);
+
+            void cacheRangeChecksums(const std::string& component,
+                                     const std::shared_ptr<const RangeChecksums>& spRangeChecksums);
+
+            void setSyncId(const std::string& component,
+                           const int32_t id);
+
+            bool isCurrentSyncId(const std::string& component,
+                                 const int32_t id);
+
+            void removeUnregisteredRangeChecksums();
+
             static nlohmann::json getRowData(const std::shared_ptr<DBSyncWrapper>& spDBSyncWrapper,
                                              const nlohmann::json& jsonSyncConfiguration,
                                              const std::string& index = "");
@@ -154,9 +193,12 @@ namespace RSync
             ~RSyncImplementation() = default;
             RSyncImplementation(const RSyncImplementation&) = delete;
             RSyncImplementation& operator=(const RSyncImplementation&) = delete;
-            std::map<RSYNC_HANDLE, std::shared_ptr<RSyncContext>> m_remoteSyncContexts;
-            std::mutex m_mutex;
+            Utils::MapWrapperSafe<RSYNC_HANDLE, std::shared_ptr<RSyncContext>> m_remoteSyncContexts;
             RegistrationController m_registrationController;
+            std::map<std::string, std::shared_ptr<const RangeChecksums>> m_rangeChecksums;
+            std::mutex m_rangeChecksumsMutex;
+            std::map<std::string, int32_t> m_syncIds;
+            std::mutex m_syncIdsMutex;
     };
 }// namespace RSync
 
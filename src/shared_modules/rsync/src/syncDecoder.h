@@ -12,32 +12,40 @@
 #ifndef _MSGDECODER_SYNC_H
 #define _MSGDECODER_SYNC_H
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include "commonDefs.h"
 #include "rsync_exception.h"
+#include "mapWrapperSafe.h"
 #include "messageDecoderFactory.h"
 
 namespace RSync
 {
     class SyncDecoder
     {
-            std::map<std::string, std::shared_ptr<IMessageDecoder>> m_decodersRegistered;
-            std::mutex m_mutex;
+            Utils::MapWrapperSafe<std::string, std::shared_ptr<IMessageDecoder>> m_decodersRegistered;
 
         public:
             std::pair<std::string, SyncInputData> decode (const std::vector<unsigned char>& rawData)
             {
                 try
                 {
-                    const std::string rawDataString { reinterpret_cast<const char*>(rawData.data()), rawData.size() };
-                    const auto firstToken { rawDataString.find(' ') };
+                    const auto begin { reinterpret_cast<const char*>(rawData.data()) };
+                    const auto end { begin + rawData.size() };
+                    const auto firstToken { std::find(begin, end, ' ') };
 
-                    if (std::string::npos != firstToken)
+                    if (end != firstToken)
                     {
-                        const auto header { rawDataString.substr(0, firstToken) };
-                        std::lock_guard<std::mutex> lock{ m_mutex };
-                        return std::make_pair(header, m_decodersRegistered.at(header)->decode(rawData));
+                        const std::string header { begin, firstToken };
+                        const auto spDecoder { m_decodersRegistered[header] };
+
+                        if (!spDecoder)
+                        {
+                            throw rsync_error { INVALID_HEADER };
+                        }
+
+                        return std::make_pair(header, spDecoder->decode(rawData));
                     }
                     else
                     {
@@ -55,8 +63,7 @@ namespace RSync
             void setMessageDecoderType(const std::string& messageHeaderId,
                                        const SyncMsgBodyType syncMessageType)
             {
-                std::lock_guard<std::mutex> lock{ m_mutex };
-                m_decodersRegistered[messageHeaderId] = FactoryDecoder::create(syncMessageType);
+                m_decodersRegistered.insertOrAssign(messageHeaderId, FactoryDecoder::create(syncMessageType));
             }
     };
 
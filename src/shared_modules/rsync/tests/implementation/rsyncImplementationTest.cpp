@@ -10,9 +10,12 @@
  */
 
 #include <iostream>
+#include <cstring>
+#include <future>
 #include "rsyncImplementationTest.h"
 #include "rsyncImplementation.h"
 #include "rsync_exception.h"
+#include "messageDecoderJSON.h"
 #include "../mocks/dbsyncmock.h"
 
 using ::testing::_;
@@ -279,6 +282,326 @@ TEST_F(RSyncImplementationTest, ValidDecoderPushedChecksumFailToSplit)
     EXPECT_EQ(TOTAL_EXPECTED_MESSAGES, messageCounter.load());
 }
 
+TEST_F(RSyncImplementationTest, ValidDecoderPushedChecksumFailSplitFromSelectedRows)
+{
+    const auto handle { RSync::RSyncImplementation::instance().create(1) };
+
+    const std::vector<std::string> expectedResults
+    {
+        R"({"component":"test_component","data":{"begin":"1","checksum":"68cf9f611f2c6c0f35c5c7b966f3390f0430759a","end":"2","id":1,"tail":"3"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"3","checksum":"5f9f5dbf52376611f307a4f0d45fd5519fbf2fa9","end":"4","id":1},"type":"integrity_check_right"})",
+        R"({"component":"test_component","data":{"begin":"1","checksum":"f29bc91bbdab169fc0c0a326965953d11c7dff83","end":"1","id":1,"tail":"2"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"2","checksum":"b9f85daa6f83cf02ce5c31913d1f64d3f5c8fade","end":"2","id":1},"type":"integrity_check_right"})"
+    };
+
+    const auto config { R"({
+                            "decoder_type":"JSON_RANGE",
+                            "table":"test",
+                            "component":"test_component",
+                            "index":"test_index_field",
+                            "checksum_field":"checksum",
+                            "no_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "count_range_query_json":{
+                                "row_filter":"",
+                                "count_field_name":"count_field",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "row_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "range_checksum_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            }
+                        })" };
+
+    auto mockDbSync { std::make_shared<MockDBSync>() };
+
+    // Only the first range is selected, its left half split is answered from the selected rows.
+    EXPECT_CALL(*mockDbSync, select(_, _)).WillOnce(testing::Invoke([](nlohmann::json & data, ResultCallbackData callback)
+    {
+        data["count_field"] = 4;
+        callback(ReturnTypeCallback::GENERIC, data);
+    })).WillOnce(testing::Invoke([](nlohmann::json & data, ResultCallbackData callback)
+    {
+        for (auto i = 1; i <= 4; ++i)
+        {
+            data["test_index_field"] = std::to_string(i);
+            data["checksum"] = "a" + std::to_string(i);
+            callback(ReturnTypeCallback::GENERIC, data);
+        }
+    }));
+
+    std::vector<std::string> results;
+    std::mutex resultsMutex;
+
+    const auto callbackWrapper
+    {
+        [&](const std::string & payload)
+        {
+            std::lock_guard<std::mutex> lock{ resultsMutex };
+            results.push_back(payload);
+        }
+    };
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().registerSyncId(handle, "test_id", mockDbSync, nlohmann::json::parse(config), callbackWrapper));
+
+    const std::vector<std::string> buffers
+    {
+        R"(test_id checksum_fail {"begin":"1","end":"4","id":1})",
+        R"(test_id checksum_fail {"begin":"1","end":"2","id":1})"
+    };
+
+    for (const auto& buffer : buffers)
+    {
+        const auto first{reinterpret_cast<const unsigned char*>(buffer.data())};
+        const auto last{first + buffer.size()};
+        const std::vector<unsigned char> data{first, last};
+
+        EXPECT_NO_THROW(RSync::RSyncImplementation::instance().push(handle, data));
+    }
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().release());
+
+    EXPECT_EQ(expectedResults, results);
+}
+
+TEST_F(RSyncImplementationTest, ValidDecoderPushedChecksumFailToMultipleSplits)
+{
+    const auto handle { RSync::RSyncImplementation::instance().create(1) };
+
+    const std::vector<std::string> expectedResults
+    {
+        R"({"component":"test_component","data":{"begin":"1","checksum":"68cf9f611f2c6c0f35c5c7b966f3390f0430759a","end":"2","id":1,"tail":"3"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"3","checksum":"5f9f5dbf52376611f307a4f0d45fd5519fbf2fa9","end":"4","id":1,"tail":"5"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"5","checksum":"412bed4a3fb2f0ea7cf8856e3e9b497762b637ca","end":"6","id":1},"type":"integrity_check_right"})"
+    };
+
+    const auto config { R"({
+                            "decoder_type":"JSON_RANGE",
+                            "table":"test",
+                            "component":"test_component",
+                            "index":"test_index_field",
+                            "checksum_field":"checksum",
+                            "max_split_fanout":3,
+                            "no_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "count_range_query_json":{
+                                "row_filter":"",
+                                "count_field_name":"count_field",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "row_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "range_checksum_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            }
+                        })" };
+
+    auto mockDbSync { std::make_shared<MockDBSync>() };
+
+    EXPECT_CALL(*mockDbSync, select(_, _)).WillOnce(testing::Invoke([](nlohmann::json & data, ResultCallbackData callback)
+    {
+        data["count_field"] = 6;
+        callback(ReturnTypeCallback::GENERIC, data);
+    })).WillOnce(testing::Invoke([](nlohmann::json & /*data*/, ResultCallbackData callback)
+    {
+        for (auto i = 1; i <= 6; ++i)
+        {
+            nlohmann::json row;
+            row["test_index_field"] = std::to_string(i);
+            row["checksum"] = "a" + std::to_string(i);
+            callback(ReturnTypeCallback::GENERIC, row);
+        }
+    }));
+
+    std::vector<std::string> results;
+    std::mutex resultsMutex;
+
+    const auto callbackWrapper
+    {
+        [&](const std::string & payload)
+        {
+            std::lock_guard<std::mutex> lock{ resultsMutex };
+            results.push_back(payload);
+        }
+    };
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().registerSyncId(handle, "test_id", mockDbSync, nlohmann::json::parse(config), callbackWrapper));
+
+    std::string buffer{R"(test_id checksum_fail {"begin":"1","end":"6","id":1})"};
+
+    const auto first{reinterpret_cast<const unsigned char*>(buffer.data())};
+    const auto last{first + buffer.size()};
+    const std::vector<unsigned char> data{first, last};
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().push(handle, data));
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().release());
+
+    EXPECT_EQ(expectedResults, results);
+}
+
+TEST_F(RSyncImplementationTest, ValidDecoderPushedChecksumFailToFullData)
+{
+    const auto handle { RSync::RSyncImplementation::instance().create(1) };
+
+    // The rows of the range are sent, then one check per row lets the manager remove the rows between them.
+    // The rows are only sent while the component is registered, so it is registered under its own name.
+    const std::vector<std::string> expectedResults
+    {
+        R"({"component":"test_component","data":{"attributes":{"checksum":"a1","test_index_field":"1"},"index":"1","timestamp":""},"type":"state"})",
+        R"({"component":"test_component","data":{"attributes":{"checksum":"a2","test_index_field":"2"},"index":"2","timestamp":""},"type":"state"})",
+        R"({"component":"test_component","data":{"attributes":{"checksum":"a3","test_index_field":"3"},"index":"3","timestamp":""},"type":"state"})",
+        R"({"component":"test_component","data":{"begin":"1","checksum":"f29bc91bbdab169fc0c0a326965953d11c7dff83","end":"1","id":1,"tail":"2"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"2","checksum":"b9f85daa6f83cf02ce5c31913d1f64d3f5c8fade","end":"2","id":1,"tail":"3"},"type":"integrity_check_left"})",
+        R"({"component":"test_component","data":{"begin":"3","checksum":"252bc06763afb3b6c2a0802f7346700ab55f46f5","end":"3","id":1},"type":"integrity_check_right"})"
+    };
+
+    const auto config { R"({
+                            "decoder_type":"JSON_RANGE",
+                            "table":"test",
+                            "component":"test_component",
+                            "index":"test_index_field",
+                            "checksum_field":"checksum",
+                            "full_data_threshold":3,
+                            "no_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "count_range_query_json":{
+                                "row_filter":"",
+                                "count_field_name":"count_field",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "row_data_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            },
+                            "range_checksum_query_json":{
+                                "row_filter":"",
+                                "column_list":[
+                                    ""
+                                ],
+                                "distinct_opt":"",
+                                "order_by_opt":""
+                            }
+                        })" };
+
+    auto mockDbSync { std::make_shared<MockDBSync>() };
+
+    EXPECT_CALL(*mockDbSync, select(_, _)).WillOnce(testing::Invoke([](nlohmann::json & data, ResultCallbackData callback)
+    {
+        data["count_field"] = 3;
+        callback(ReturnTypeCallback::GENERIC, data);
+    })).WillOnce(testing::Invoke([](nlohmann::json & /*data*/, ResultCallbackData callback)
+    {
+        for (auto i = 1; i <= 3; ++i)
+        {
+            nlohmann::json row;
+            row["test_index_field"] = std::to_string(i);
+            row["checksum"] = "a" + std::to_string(i);
+            callback(ReturnTypeCallback::GENERIC, row);
+        }
+    })).WillOnce(testing::Invoke([](nlohmann::json & /*data*/, ResultCallbackData callback)
+    {
+        for (auto i = 1; i <= 3; ++i)
+        {
+            nlohmann::json row;
+            row["test_index_field"] = std::to_string(i);
+            row["checksum"] = "a" + std::to_string(i);
+            callback(ReturnTypeCallback::GENERIC, row);
+        }
+    }));
+
+    std::vector<std::string> results;
+    std::mutex resultsMutex;
+    std::promise<void> allResults;
+
+    const auto callbackWrapper
+    {
+        [&](const std::string & payload)
+        {
+            std::lock_guard<std::mutex> lock{ resultsMutex };
+            results.push_back(payload);
+
+            if (expectedResults.size() == results.size())
+            {
+                allResults.set_value();
+            }
+        }
+    };
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().registerSyncId(handle, "test_component", mockDbSync, nlohmann::json::parse(config), callbackWrapper));
+
+    std::string buffer{R"(test_component checksum_fail {"begin":"1","end":"3","id":1})"};
+
+    const auto first{reinterpret_cast<const unsigned char*>(buffer.data())};
+    const auto last{first + buffer.size()};
+    const std::vector<unsigned char> data{first, last};
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().push(handle, data));
+
+    // Releasing unregisters the component, so the message has to be processed first.
+    EXPECT_EQ(std::future_status::ready, allResults.get_future().wait_for(std::chrono::seconds(5)));
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().release());
+
+    EXPECT_EQ(expectedResults, results);
+}
+
 TEST_F(RSyncImplementationTest, ValidDecoderPushedChecksumInvalidOperation)
 {
     const auto handle { RSync::RSyncImplementation::instance().create() };
@@ -409,6 +732,84 @@ TEST_F(RSyncImplementationTest, InvalidPushData)
     EXPECT_NO_THROW(RSync::RSyncImplementation::instance().release());
 }
 
+TEST_F(RSyncImplementationTest, SupersededSyncIdDropped)
+{
+    const auto handle { RSync::RSyncImplementation::instance().create(1) };
+    const auto config { R"({"decoder_type":"JSON_RANGE", "component":"test_decoder","table":"test","no_data_query_json":{"row_filter":"","column_list":"","distinct_opt":"","order_by_opt":""}})" };
+    const auto startConfig { R"({"component":"test_decoder","table":"test","index":"id","first_query":{"row_filter":"","column_list":"id","distinct_opt":false,"order_by_opt":"id","count_opt":1},"last_query":{"row_filter":"","column_list":"id","distinct_opt":false,"order_by_opt":"id DESC","count_opt":1}})" };
+    auto mockDbSync { std::make_shared<MockDBSync>() };
+    std::vector<std::string> messages;
+
+    // The first and last queries of the session. The answers to other sessions don't read the table.
+    EXPECT_CALL(*mockDbSync, select(_, _)).Times(2);
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().registerSyncId(handle, "test_id", mockDbSync, nlohmann::json::parse(config), {}));
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().startRSync(handle, mockDbSync, nlohmann::json::parse(startConfig), [&messages](const std::string & message)
+    {
+        messages.push_back(message);
+    }));
+
+    ASSERT_EQ(1ul, messages.size());
+    const auto sessionId { nlohmann::json::parse(messages.front()).at("data").at("id").get<int32_t>() };
+
+    // An older session, and a newer one started before the clock stepped back.
+    for (const auto id : { sessionId - 1, sessionId + 3600 })
+    {
+        const auto buffer { R"(test_id no_data {"begin":"1","end":"2","id":)" + std::to_string(id) + "}" };
+        const std::vector<unsigned char> data{buffer.begin(), buffer.end()};
+
+        EXPECT_NO_THROW(RSync::RSyncImplementation::instance().push(handle, data));
+    }
+
+    EXPECT_NO_THROW(RSync::RSyncImplementation::instance().release());
+}
+
+static RSync::SyncInputData decodeMessage(const std::string& message)
+{
+    RSync::JSONMessageDecoder decoder;
+    return decoder.decode(std::vector<unsigned char> { message.begin(), message.end() });
+}
+
+TEST(RSyncJSONMessageDecoder, FlatMessage)
+{
+    const auto syncData { decodeMessage(R"(test_id checksum_fail { "begin" : "C:\\a\"b", "end":"\/c\td", "id":-5, "tail":null, "extra":true })") };
+
+    EXPECT_EQ("checksum_fail", syncData.command);
+    EXPECT_EQ("C:\\a\"b", syncData.begin);
+    EXPECT_EQ("/c\td", syncData.end);
+    EXPECT_EQ(-5, syncData.id);
+}
+
+TEST(RSyncJSONMessageDecoder, NumericRange)
+{
+    const auto syncData { decodeMessage(R"(test_id no_data {"begin":10,"end":20,"id":1})") };
+
+    EXPECT_EQ("no_data", syncData.command);
+    EXPECT_EQ("10", syncData.begin);
+    EXPECT_EQ("20", syncData.end);
+    EXPECT_EQ(1, syncData.id);
+}
+
+TEST(RSyncJSONMessageDecoder, FallbackToJSONParser)
+{
+    const auto unicode { decodeMessage(R"(test_id no_data {"begin":"\u0041","end":"B","id":1})") };
+    EXPECT_EQ("A", unicode.begin);
+    EXPECT_EQ("B", unicode.end);
+
+    const auto nested { decodeMessage(R"(test_id no_data {"begin":"A","end":"B","id":2,"extra":{"value":[1,2]}})") };
+    EXPECT_EQ("A", nested.begin);
+    EXPECT_EQ(2, nested.id);
+
+    const auto fraction { decodeMessage(R"(test_id no_data {"begin":"A","end":"B","id":2.0})") };
+    EXPECT_EQ(2, fraction.id);
+}
+
+TEST(RSyncJSONMessageDecoder, InvalidMessage)
+{
+    EXPECT_THROW(decodeMessage(R"(test_id no_data {"begin":"A","end":"B"})"), nlohmann::detail::exception);
+    EXPECT_THROW(decodeMessage(R"(test_id no_data {"begin":"A","end":"B","id":1)"), nlohmann::detail::exception);
+    EXPECT_TRUE(decodeMessage("test_id no_data").command.empty());
+}
+
 TEST(RSyncRegistrationController, ValidRegistrationFlow)
 {
     RegistrationController regController;
@@ -0,0 +1,207 @@
+/*
+ * Wazuh shared modules utils
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef _BENCHMARK_HELPER_H
+#define _BENCHMARK_HELPER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+namespace Utils
+{
+    /**
+     * @brief State of a benchmark run, in the spirit of Google Benchmark.
+     *
+     * Each call of the benchmark function is one timed iteration. The setup done
+     * inside the function is left out of the measure between pauseTiming() and
+     * resumeTiming().
+     */
+    class BenchmarkState final
+    {
+        public:
+            explicit BenchmarkState(const uint64_t range)
+                : m_range{ range }
+                , m_items{ 0 }
+                , m_elapsed{ 0 }
+                , m_running{ false }
+            {}
+
+            uint64_t range() const
+            {
+                return m_range;
+            }
+
+            void pauseTiming()
+            {
+                if (m_running)
+                {
+                    m_elapsed += std::chrono::steady_clock::now() - m_start;
+                    m_running = false;
+                }
+            }
+
+            void resumeTiming()
+            {
+                if (!m_running)
+                {
+                    m_start = std::chrono::steady_clock::now();
+                    m_running = true;
+                }
+            }
+
+            void addItemsProcessed(const uint64_t items)
+            {
+                m_items += items;
+            }
+
+            uint64_t itemsProcessed() const
+            {
+                return m_items;
+            }
+
+            std::chrono::nanoseconds elapsed() const
+            {
+                return m_elapsed;
+            }
+
+        private:
+            const uint64_t m_range;
+            uint64_t m_items;
+            std::chrono::nanoseconds m_elapsed;
+            std::chrono::steady_clock::time_point m_start;
+            bool m_running;
+    };
+
+    /**
+     * @brief Registers benchmark functions with their ranges and runs them.
+     *
+     * Every function is run once per range until it has been timed for the minimum
+     * time. The report prints the time per iteration and the items processed per
+     * second, as a table or as JSON.
+     */
+    class BenchmarkRunner final
+    {
+        public:
+            using Function = std::function<void(BenchmarkState&)>;
+
+            void add(const std::string& name, const std::vector<uint64_t>& ranges, Function function)
+            {
+                m_benchmarks.push_back({ name, ranges, function });
+            }
+
+            /**
+             * @brief Runs the benchmarks.
+             *
+             * @param filter     Only the benchmarks whose name contains the filter are run.
+             * @param maxRange   Ranges above it are skipped, 0 runs all of them.
+             * @param minTime    Minimum time each range is measured, in seconds.
+             * @param jsonFormat Print the report as JSON instead of a table.
+             *
+             * @return Number of runs reported.
+             */
+            size_t run(const std::string& filter,
+                       const uint64_t maxRange,
+                       const double minTime,
+                       const bool jsonFormat,
+                       std::ostream& out = std::cout)
+            {
+                const std::chrono::duration<double> minDuration{ minTime };
+                auto report{ nlohmann::json::array() };
+                size_t runs{ 0 };
+
+                if (!jsonFormat)
+                {
+                    out << std::left << std::setw(48) << "Benchmark"
+                        << std::right << std::setw(12) << "Iterations"
+                        << std::setw(16) << "Time/iter (ms)"
+                        << std::setw(16) << "Items/s" << std::endl;
+                }
+
+                for (const auto& benchmark : m_benchmarks)
+                {
+                    if (benchmark.name.find(filter) == std::string::npos)
+                    {
+                        continue;
+                    }
+
+                    for (const auto range : benchmark.ranges)
+                    {
+                        if (maxRange && range > maxRange)
+                        {
+                            continue;
+                        }
+
+                        BenchmarkState state{ range };
+                        uint64_t iterations{ 0 };
+
+                        do
+                        {
+                            state.resumeTiming();
+                            benchmark.function(state);
+                            state.pauseTiming();
+                            ++iterations;
+                        }
+                        while (state.elapsed() < minDuration);
+
+                        const auto seconds{ std::chrono::duration<double>(state.elapsed()).count() };
+                        const auto name{ benchmark.name + "/" + std::to_string(range) };
+                        const auto msPerIteration{ seconds * 1000 / iterations };
+                        const auto itemsPerSecond{ seconds > 0 ? state.itemsProcessed() / seconds : 0 };
+
+                        ++runs;
+
+                        if (jsonFormat)
+                        {
+                            report.push_back(
+                            {
+                                {"name", name},
+                                {"iterations", iterations},
+                                {"ms_per_iteration", msPerIteration},
+                                {"items_per_second", itemsPerSecond}
+                            });
+                        }
+                        else
+                        {
+                            out << std::left << std::setw(48) << name
+                                << std::right << std::setw(12) << iterations
+                                << std::setw(16) << std::fixed << std::setprecision(3) << msPerIteration
+                                << std::setw(16) << std::setprecision(0) << itemsPerSecond << std::endl;
+                        }
+                    }
+                }
+
+                if (jsonFormat)
+                {
+                    out << report.dump(4) << std::endl;
+                }
+
+                return runs;
+            }
+
+        private:
+            struct Benchmark
+            {
+                std::string name;
+                std::vector<uint64_t> ranges;
+                Function function;
+            };
+
+            std::vector<Benchmark> m_benchmarks;
+    };
+}
+
+#endif // _BENCHMARK_HELPER_H
@@ -11,40 +11,157 @@
 #ifndef _MAP_WRAPPER_SAFE_H_
 #define _MAP_WRAPPER_SAFE_H_
 
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
 
 namespace Utils
 {
-    template<typename Key, typename Value>
+    /**
+     * @brief Hash used to pick the shard of a key.
+     *
+     * The strings and the C strings hash the same way, so a map with std::string keys can be
+     * searched with a const char* without building a temporary string.
+     */
+    struct MapShardHash final
+    {
+        template<typename T, typename std::enable_if<!std::is_convertible<const T&, const char*>::value, int>::type = 0>
+        size_t operator()(const T& key) const
+        {
+            return std::hash<T> {}(key);
+        }
+
+        size_t operator()(const std::string& key) const
+        {
+            return hashBytes(key.data(), key.size());
+        }
+
+        size_t operator()(const char* key) const
+        {
+            return hashBytes(key, std::strlen(key));
+        }
+
+        private:
+            static size_t hashBytes(const char* data, const size_t size)
+            {
+                // FNV-1a
+                uint64_t hash { 14695981039346656037ull };
+
+                for (size_t i = 0; i < size; ++i)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+                }
+
+                return static_cast<size_t>(hash);
+            }
+    };
+
+    /**
+     * @brief Thread safe map split in \p Shards independent maps.
+     *
+     * Each shard has its own shared mutex, so the lookups only take a shared lock and the
+     * writers only block the keys of one shard. The shards are ordered maps with a transparent
+     * comparator to allow the lookups with any type comparable with \p Key.
+     */
+    template<typename Key, typename Value, size_t Shards = 16, typename Hash = MapShardHash>
     class MapWrapperSafe final
     {
-            std::map<Key, Value> m_map;
-            std::mutex m_mutex;
+            static_assert(Shards && !(Shards & (Shards - 1)), "The number of shards must be a power of two");
+
+            struct Shard final
+            {
+                std::map<Key, Value, std::less<>> map;
+                mutable std::shared_timed_mutex mutex;
+            };
+
+            template<typename K>
+            Shard& shard(const K& key)
+            {
+                return m_shards[index(key)];
+            }
+
+            template<typename K>
+            const Shard& shard(const K& key) const
+            {
+                return m_shards[index(key)];
+            }
+
+            template<typename K>
+            size_t index(const K& key) const
+            {
+                // Mix the hash, the pointers and the integers have their low bits in common.
+                return static_cast<size_t>((static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ull) >> 32) & (Shards - 1);
+            }
+
+            std::array<Shard, Shards> m_shards;
+            Hash m_hash;
         public:
             // LCOV_EXCL_START
             MapWrapperSafe() = default;
             // LCOV_EXCL_STOP
-            void insert(const Key& key, const Value& value)
+            bool insert(const Key& key, const Value& value)
+            {
+                auto& target { shard(key) };
+                std::lock_guard<std::shared_timed_mutex> lock(target.mutex);
+                return target.map.emplace(key, value).second;
+            }
+
+            void insertOrAssign(const Key& key, const Value& value)
             {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_map.emplace(key, value);
+                auto& target { shard(key) };
+                std::lock_guard<std::shared_timed_mutex> lock(target.mutex);
+                target.map[key] = value;
             }
 
-            Value operator[](const Key& key)
+            template<typename K>
+            Value operator[](const K& key) const
             {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                const auto it { m_map.find(key) };
-                return m_map.end() != it ? it->second : Value();
+                const auto& target { shard(key) };
+                std::shared_lock<std::shared_timed_mutex> lock(target.mutex);
+                const auto it { target.map.find(key) };
+                return target.map.end() != it ? it->second : Value();
             }
 
             void erase(const Key& key)
             {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_map.erase(key);
+                auto& target { shard(key) };
+                std::lock_guard<std::shared_timed_mutex> lock(target.mutex);
+                target.map.erase(key);
+            }
+
+            void clear()
+            {
+                for (auto& target : m_shards)
+                {
+                    std::lock_guard<std::shared_timed_mutex> lock(target.mutex);
+                    target.map.clear();
+                }
+            }
+
+            /**
+             * @brief Calls \p func with every element, holding the shared lock of one shard at a time.
+             */
+            template<typename Function>
+            void forEach(Function func) const
+            {
+                for (const auto& target : m_shards)
+                {
+                    std::shared_lock<std::shared_timed_mutex> lock(target.mutex);
+
+                    for (const auto& element : target.map)
+                    {
+                        func(element.first, element.second);
+                    }
+                }
             }
     };
 };
 
 
-#endif //_MAP_WRAPPER_SAFE_H_
\ No newline at end of file
+#endif //_MAP_WRAPPER_SAFE_H_
@@ -11,11 +11,10 @@
 #ifndef _MESSAGE_DISPATCHER_H_
 #define _MESSAGE_DISPATCHER_H_
 
-#include <map>
-#include <mutex>
 #include <functional>
 #include <utility>
 #include "commonDefs.h"
+#include "mapWrapperSafe.h"
 #include "threadDispatcher.h"
 
 namespace Utils
@@ -48,30 +47,16 @@ namespace Utils
             // LCOV_EXCL_STOP
             bool addCallback(const Key& key, const std::function<void(Value)>& callback)
             {
-                std::lock_guard<std::mutex> lock{ m_mutex };
-                const auto ret{ m_callbacks.find(key) == m_callbacks.end() };
-
-                if (ret)
-                {
-                    m_callbacks[key] = callback;
-                }
-
-                return ret;
+                return m_callbacks.insert(key, callback);
             }
             void removeCallback(const Key& key)
             {
-                std::lock_guard<std::mutex> lock{ m_mutex };
-                const auto it{ m_callbacks.find(key) };
-
-                if (it != m_callbacks.end())
-                {
-                    m_callbacks.erase(it);
-                }
+                m_callbacks.erase(key);
             }
             void dispatch(const RawValue& raw)
             {
                 const auto& data{ RawValueDecoder::decode(raw) };
-                const auto& callback{ findCallback(data.first) };
+                const auto& callback{ m_callbacks[data.first] };
 
                 if (callback)
                 {
@@ -82,21 +67,7 @@ namespace Utils
             using ThreadType = ThreadDispatcher<RawValue, std::function<void(const RawValue&)>>;
             using DispatcherType = MsgDispatcher<Key, Value, RawValue, RawValueDecoder, ThreadDispatcher>;
 
-            std::function<void(Value)> findCallback(const Key& key)
-            {
-                std::function<void(Value)> ret;
-                std::lock_guard<std::mutex> lock{ m_mutex };
-                const auto it { m_callbacks.find(key) };
-
-                if (it != m_callbacks.end())
-                {
-                    return it->second;
-                }
-
-                return {};
-            }
-            std::map<Key, std::function<void(Value)>> m_callbacks;
-            std::mutex                                m_mutex;
+            MapWrapperSafe<Key, std::function<void(Value)>> m_callbacks;
     };
 }
 
@@ -12,11 +12,60 @@
 #ifndef PIPELINE_NODES_IMP_H
 #define PIPELINE_NODES_IMP_H
 #include <functional>
+#include <utility>
 #include "threadDispatcher.h"
 #include "pipelinePattern.h"
 
 namespace Utils
 {
+    /**
+     * @brief Functor that runs two pipeline stages in the same call.
+     * @details Calls Second with the result of First, so adjacent synchronous
+     * stages become a single node functor instead of one node and one queue hop
+     * each.
+     *
+     * @tparam First Stage receiving the input.
+     * @tparam Second Stage receiving the output of First.
+     */
+    template<typename First, typename Second>
+    class FusedFunctor final
+    {
+        public:
+            FusedFunctor(First first, Second second)
+                : m_first{ std::move(first) }
+                , m_second{ std::move(second) }
+            {}
+            template<typename Input>
+            auto operator()(const Input& data) -> decltype(std::declval<Second&>()(std::declval<First&>()(data)))
+            {
+                return m_second(m_first(data));
+            }
+        private:
+            First m_first;
+            Second m_second;
+    };
+
+    template<typename Functor>
+    Functor fuse(Functor functor)
+    {
+        return functor;
+    }
+
+    /**
+     * @brief Composes the stages, in order, into a single functor at compile time.
+     *
+     * @param first First stage.
+     * @param second Second stage.
+     * @param rest Following stages.
+     *
+     * @return Functor calling every stage with the result of the previous one.
+     */
+    template<typename First, typename Second, typename... Rest>
+    auto fuse(First first, Second second, Rest... rest)
+    {
+        return fuse(FusedFunctor<First, Second> { std::move(first), std::move(second) }, std::move(rest)...);
+    }
+
     template
     <
         typename Input,
@@ -33,6 +82,11 @@ namespace Utils
                      const unsigned int numberOfThreads)
                 : DispatcherType{ functor, numberOfThreads, UNLIMITED_QUEUE_SIZE }
             {}
+            ReadNode(Functor functor,
+                     const unsigned int numberOfThreads,
+                     const size_t maxQueueSize)
+                : DispatcherType{ functor, numberOfThreads, maxQueueSize }
+            {}
             // LCOV_EXCL_START
             ~ReadNode() = default;
             // LCOV_EXCL_STOP
@@ -66,6 +120,12 @@ namespace Utils
                 : DispatcherType{ std::bind(&RWNodeType::doTheWork, this, std::placeholders::_1), numberOfThreads, UNLIMITED_QUEUE_SIZE }
                 , m_functor{functor}
             {}
+            ReadWriteNode(Functor functor,
+                          const unsigned int numberOfThreads,
+                          const size_t maxQueueSize)
+                : DispatcherType{ std::bind(&RWNodeType::doTheWork, this, std::placeholders::_1), numberOfThreads, maxQueueSize }
+                , m_functor{functor}
+            {}
             // LCOV_EXCL_START
             ~ReadWriteNode() = default;
             // LCOV_EXCL_STOP
@@ -169,6 +169,35 @@ namespace Utils
                 }
             }
 
+            // Same as enumerate, also reporting when each subkey or its values were last written.
+            void enumerateWithLastWriteTime(const std::function<void(const std::string&, const ULONGLONG)>& callback) const
+            {
+                constexpr auto MAX_KEY_NAME_SIZE{255};//https://docs.microsoft.com/en-us/windows/win32/sysinfo/registry-element-size-limits
+                char buff[MAX_KEY_NAME_SIZE] {};
+                DWORD size{MAX_KEY_NAME_SIZE};
+                DWORD index{0};
+                FILETIME lastWriteTime { };
+                auto result{RegEnumKeyEx(m_registryKey, index, buff, &size, nullptr, nullptr, nullptr, &lastWriteTime)};
+
+                while (result == ERROR_SUCCESS)
+                {
+                    callback(buff, toQuadPart(lastWriteTime));
+                    size = MAX_KEY_NAME_SIZE;
+                    ++index;
+                    result = RegEnumKeyEx(m_registryKey, index, buff, &size, nullptr, nullptr, nullptr, &lastWriteTime);
+                }
+
+                if (result != ERROR_NO_MORE_ITEMS)
+                {
+                    throw std::system_error
+                    {
+                        result,
+                        std::system_category(),
+                        "Error enumerating registry."
+                    };
+                }
+            }
+
             bool enumerate(std::vector<std::string>& values) const
             {
                 bool ret{true};
@@ -201,9 +230,9 @@ namespace Utils
                 return ret;
             }
 
-            std::string keyModificationDate() const
+            // Last time a subkey was added or removed, or a value of the key was written.
+            bool lastWriteTime(ULONGLONG& time) const
             {
-                std::string ret;
                 FILETIME lastModificationTime { };
                 const auto result
                 {
@@ -212,13 +241,21 @@ namespace Utils
 
                 if (ERROR_SUCCESS == result)
                 {
-                    ULARGE_INTEGER time { };
+                    time = toQuadPart(lastModificationTime);
+                }
+
+                return ERROR_SUCCESS == result;
+            }
 
-                    time.LowPart = lastModificationTime.dwLowDateTime;
-                    time.HighPart = lastModificationTime.dwHighDateTime;
+            std::string keyModificationDate() const
+            {
+                std::string ret;
+                ULONGLONG time { };
 
+                if (lastWriteTime(time))
+                {
                     // Use structure values to build 18-digit LDAP/FILETIME number
-                    ret = Utils::buildTimestamp(time.QuadPart);
+                    ret = Utils::buildTimestamp(time);
                 }
 
                 return ret;
@@ -313,6 +350,15 @@ namespace Utils
             }
 
         private:
+            static ULONGLONG toQuadPart(const FILETIME& fileTime)
+            {
+                ULARGE_INTEGER time { };
+
+                time.LowPart = fileTime.dwLowDateTime;
+                time.HighPart = fileTime.dwHighDateTime;
+                return time.QuadPart;
+            }
+
             static HKEY openRegistry(const HKEY key, const std::string& subKey, const REGSAM access)
             {
                 HKEY ret{nullptr};
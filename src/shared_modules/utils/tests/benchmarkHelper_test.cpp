@@ -0,0 +1,57 @@
+/*
+ * Wazuh shared modules utils
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <sstream>
+#include <thread>
+#include "benchmarkHelper_test.h"
+#include "benchmarkHelper.h"
+
+void BenchmarkHelperTest::SetUp() {};
+
+void BenchmarkHelperTest::TearDown() {};
+
+TEST_F(BenchmarkHelperTest, PausedTimeIsNotMeasured)
+{
+    Utils::BenchmarkState state{ 1 };
+
+    state.resumeTiming();
+    state.pauseTiming();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    state.pauseTiming();
+
+    EXPECT_LT(state.elapsed(), std::chrono::milliseconds(50));
+}
+
+TEST_F(BenchmarkHelperTest, RunFilteredRanges)
+{
+    Utils::BenchmarkRunner runner;
+    std::vector<uint64_t> ranges;
+    std::ostringstream out;
+
+    runner.add("BM_Selected", { 10, 100, 1000 }, [&](Utils::BenchmarkState & state)
+    {
+        ranges.push_back(state.range());
+        state.addItemsProcessed(state.range());
+    });
+    runner.add("BM_Other", { 10 }, [&](Utils::BenchmarkState&)
+    {
+        FAIL();
+    });
+
+    EXPECT_EQ(2u, runner.run("Selected", 100, 0, true, out));
+
+    const auto report { nlohmann::json::parse(out.str()) };
+    ASSERT_EQ(2u, report.size());
+    EXPECT_EQ("BM_Selected/10", report.at(0).at("name"));
+    EXPECT_EQ("BM_Selected/100", report.at(1).at("name"));
+    EXPECT_EQ(1u, report.at(0).at("iterations").get<uint64_t>());
+    EXPECT_EQ((std::vector<uint64_t> { 10, 100 }), ranges);
+}
@@ -0,0 +1,28 @@
+/*
+ * Wazuh shared modules utils
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#ifndef BENCHMARK_HELPER_TESTS_H
+#define BENCHMARK_HELPER_TESTS_H
+
+#include "gtest/gtest.h"
+
+class BenchmarkHelperTest : public ::testing::Test
+{
+    protected:
+
+        BenchmarkHelperTest() = default;
+        virtual ~BenchmarkHelperTest() = default;
+
+        void SetUp() override;
+        void TearDown() override;
+};
+
+#endif // BENCHMARK_HELPER_TESTS_H
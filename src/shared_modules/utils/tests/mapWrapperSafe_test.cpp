@@ -11,6 +11,7 @@
 
 #include <thread>
 #include <chrono>
+#include <vector>
 #include "mapWrapperSafe_test.h"
 #include "mapWrapperSafe.h"
 
@@ -34,3 +35,77 @@ TEST_F(MapWrapperSafeTest, eraseTest)
     EXPECT_EQ(0, mapSafe[1]);
 }
 
+TEST_F(MapWrapperSafeTest, insertExistingTest)
+{
+    Utils::MapWrapperSafe<int, int> mapSafe;
+    EXPECT_TRUE(mapSafe.insert(1, 2));
+    EXPECT_FALSE(mapSafe.insert(1, 3));
+    EXPECT_EQ(2, mapSafe[1]);
+    mapSafe.insertOrAssign(1, 3);
+    EXPECT_EQ(3, mapSafe[1]);
+}
+
+TEST_F(MapWrapperSafeTest, heterogeneousLookupTest)
+{
+    Utils::MapWrapperSafe<std::string, int> mapSafe;
+    const char* key { "key" };
+    mapSafe.insert("key", 1);
+    mapSafe.insert("other", 2);
+    EXPECT_EQ(1, mapSafe[key]);
+    EXPECT_EQ(2, mapSafe["other"]);
+    EXPECT_EQ(0, mapSafe["missing"]);
+}
+
+TEST_F(MapWrapperSafeTest, clearAndForEachTest)
+{
+    Utils::MapWrapperSafe<int, int> mapSafe;
+    auto count { 0 };
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        mapSafe.insert(i, i);
+    }
+
+    mapSafe.forEach([&count](const int key, const int value)
+    {
+        EXPECT_EQ(key, value);
+        ++count;
+    });
+    EXPECT_EQ(100, count);
+
+    mapSafe.clear();
+    count = 0;
+    mapSafe.forEach([&count](const int, const int)
+    {
+        ++count;
+    });
+    EXPECT_EQ(0, count);
+}
+
+TEST_F(MapWrapperSafeTest, concurrentAccessTest)
+{
+    Utils::MapWrapperSafe<int, int> mapSafe;
+    std::vector<std::thread> threads;
+
+    for (auto thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&mapSafe, thread]()
+        {
+            for (auto i = thread * 1000; i < (thread + 1) * 1000; ++i)
+            {
+                mapSafe.insert(i, i + 1);
+                EXPECT_EQ(i + 1, mapSafe[i]);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto i = 0; i < 4000; ++i)
+    {
+        EXPECT_EQ(i + 1, mapSafe[i]);
+    }
+}
@@ -44,6 +44,9 @@ using ReadWriteNodeSync = Utils::ReadWriteNode<std::string, int, ReadIntNodeSync
 using ReadIntNodeAsync = Utils::ReadNode<int, std::reference_wrapper<FunctorWrapper>, Utils::AsyncDispatcher>;
 using ReadWriteNodeAsync = Utils::ReadWriteNode<std::string, int, ReadIntNodeAsync>;
 
+using ReadIntNodeSpsc = Utils::ReadNode<int, std::reference_wrapper<FunctorWrapper>, Utils::SpscDispatcher>;
+using ReadWriteNodeSpsc = Utils::ReadWriteNode<std::string, int, ReadIntNodeSpsc, std::function<int(const std::string&)>, Utils::SpscDispatcher>;
+
 TEST_F(PipelineNodesTest, ReadNodeAsync)
 {
     FunctorWrapper functor;
@@ -118,6 +121,120 @@ TEST_F(PipelineNodesTest, ReadWriteNodeSync)
     ReadWriteNodeBehaviour(functor, spReadNode, spReadWriteNode);
 }
 
+TEST_F(PipelineNodesTest, ReadNodeSpsc)
+{
+    FunctorWrapper functor;
+    ReadIntNodeSpsc rNode{ std::ref(functor) };
+
+    ReadNodeBehaviour(functor, rNode);
+
+    EXPECT_EQ(1u, rNode.numberOfThreads());
+}
+
+TEST_F(PipelineNodesTest, ReadWriteNodeSpsc)
+{
+    FunctorWrapper functor;
+    auto spReadNode
+    {
+        std::make_shared<ReadIntNodeSpsc>(std::ref(functor))
+    };
+    auto spReadWriteNode
+    {
+        std::make_shared<ReadWriteNodeSpsc>([](const std::string & value)
+        {
+            return std::stoi(value);
+        })
+    };
+
+    ReadWriteNodeBehaviour(functor, spReadNode, spReadWriteNode);
+}
+
+TEST_F(PipelineNodesTest, FuseFunctors)
+{
+    auto fused
+    {
+        Utils::fuse([](const std::string & value)
+        {
+            return std::stoi(value);
+        },
+        [](const int value)
+        {
+            return value * 2;
+        },
+        [](const int value)
+        {
+            return std::to_string(value);
+        })
+    };
+    EXPECT_EQ("42", fused(std::string{"21"}));
+}
+
+TEST_F(PipelineNodesTest, ReadNodeFusedAsyncMultiThread)
+{
+    FunctorWrapper functor;
+    auto fused
+    {
+        Utils::fuse([](const std::string & value)
+        {
+            return std::stoi(value);
+        }, std::ref(functor))
+    };
+    Utils::ReadNode<std::string, decltype(fused), Utils::AsyncDispatcher> rNode{ fused, 2, 100 };
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_CALL(functor, Operator(i));
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        rNode.receive(std::to_string(i));
+    }
+
+    rNode.rundown();
+    EXPECT_TRUE(rNode.cancelled());
+    EXPECT_EQ(2u, rNode.numberOfThreads());
+}
+
+TEST_F(PipelineNodesTest, ReadWriteNodeFused)
+{
+    FunctorWrapper functor;
+    auto fused
+    {
+        Utils::fuse([](const std::string & value)
+        {
+            return value.substr(1);
+        },
+        [](const std::string & value)
+        {
+            return std::stoi(value);
+        })
+    };
+    auto spReadNode
+    {
+        std::make_shared<ReadIntNodeAsync>(std::ref(functor))
+    };
+    auto spReadWriteNode
+    {
+        std::make_shared<Utils::ReadWriteNode<std::string, int, ReadIntNodeAsync, decltype(fused), Utils::AsyncDispatcher>>(fused, 1, 100)
+    };
+    Utils::connect(spReadWriteNode, spReadNode);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_CALL(functor, Operator(i));
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        spReadWriteNode->receive("x" + std::to_string(i));
+    }
+
+    spReadWriteNode->rundown();
+    spReadNode->rundown();
+    EXPECT_TRUE(spReadNode->cancelled());
+}
+
 TEST_F(PipelineNodesTest, ConnectInvalidPtrs1)
 {
     std::shared_ptr<Utils::ReadNode<int>> spReadNode;
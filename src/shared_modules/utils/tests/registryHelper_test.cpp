@@ -111,4 +111,41 @@ TEST_F(RegistryUtilsTest, RegistryEnumerateNoThrow)
     EXPECT_EQ(0u, values.size());
 }
 
+TEST_F(RegistryUtilsTest, RegistryEnumerateWithLastWriteTime)
+{
+    std::vector<std::string> names;
+    Utils::Registry reg(HKEY_LOCAL_MACHINE, CENTRAL_PROCESSOR_REGISTRY, KEY_ENUMERATE_SUB_KEYS | KEY_READ);
+    reg.enumerateWithLastWriteTime([&names](const std::string & name, const ULONGLONG lastWriteTime)
+    {
+        EXPECT_NE(0u, lastWriteTime);
+        names.push_back(name);
+    });
+    EXPECT_EQ(reg.enumerate(), names);
+}
+
+TEST_F(RegistryUtilsTest, RegistryLastWriteTime)
+{
+    HKEY handler;
+    const LPCTSTR subkey { TEXT("WazuhTest") };
+    LPCTSTR value { TEXT("Test") };
+    DWORD data { 1 };
+    ULONGLONG before { 0 };
+    ULONGLONG after { 0 };
+
+    auto result { RegCreateKeyEx(HKEY_CURRENT_USER, subkey, 0, nullptr, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, nullptr, &handler, nullptr) };
+    EXPECT_EQ(ERROR_SUCCESS, result);
+
+    EXPECT_TRUE(Utils::Registry(HKEY_CURRENT_USER, subkey).lastWriteTime(before));
+    Sleep(20);
+
+    result = RegSetValueEx(handler, value, 0, REG_DWORD, reinterpret_cast<LPBYTE>(&data), sizeof(DWORD));
+    EXPECT_EQ(ERROR_SUCCESS, result);
+
+    EXPECT_TRUE(Utils::Registry(HKEY_CURRENT_USER, subkey).lastWriteTime(after));
+    EXPECT_LT(before, after);
+
+    RegDeleteKeyEx(HKEY_CURRENT_USER, subkey, KEY_WOW64_64KEY, 0);
+    RegCloseKey(handler);
+}
+
 #endif
@@ -11,6 +11,7 @@
 
 #include <thread>
 #include <chrono>
+#include <future>
 #include "threadDispatcher_test.h"
 #include "threadDispatcher.h"
 
@@ -121,3 +122,162 @@ TEST_F(ThreadDispatcherTest, AsyncDispatcherQueue)
     dispatcher.rundown();
 }
 
+TEST_F(ThreadDispatcherTest, AsyncDispatcherPushBatch)
+{
+    FunctorWrapper functor;
+    AsyncDispatcher<int, std::reference_wrapper<FunctorWrapper>> dispatcher
+    {
+        std::ref(functor), 4
+    };
+    std::vector<int> values;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_CALL(functor, Operator(i));
+        values.push_back(i);
+    }
+
+    EXPECT_EQ(values.size(), dispatcher.pushBatch(values));
+    dispatcher.rundown();
+    EXPECT_EQ(0ul, dispatcher.size());
+    EXPECT_EQ(0ul, dispatcher.dropped());
+}
+
+TEST_F(ThreadDispatcherTest, AsyncDispatcherDropCallback)
+{
+    constexpr auto MAX_QUEUE_SIZE { 5ull };
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture { release.get_future().share() };
+    std::atomic<bool> firstCall { true };
+    std::vector<int> droppedValues;
+
+    AsyncDispatcher<int, std::function<void(int)>> dispatcher
+    {
+        [&](int)
+        {
+            if (firstCall.exchange(false))
+            {
+                started.set_value();
+                releaseFuture.wait();
+            }
+        }
+        , 1
+        , MAX_QUEUE_SIZE
+        , [&droppedValues](const int value)
+        {
+            droppedValues.push_back(value);
+        }
+    };
+
+    EXPECT_TRUE(dispatcher.push(0));
+    started.get_future().wait();
+    EXPECT_EQ(3ul, dispatcher.pushBatch({1, 2, 3}));
+    EXPECT_EQ(2ul, dispatcher.pushBatch({4, 5, 6, 7}));
+    EXPECT_FALSE(dispatcher.push(8));
+    EXPECT_EQ(MAX_QUEUE_SIZE, dispatcher.size());
+    EXPECT_EQ(3ul, dispatcher.dropped());
+    EXPECT_EQ((std::vector<int> {6, 7, 8}), droppedValues);
+    release.set_value();
+    dispatcher.rundown();
+    EXPECT_EQ(0ul, dispatcher.size());
+}
+
+TEST_F(ThreadDispatcherTest, AsyncDispatcherPushWait)
+{
+    constexpr auto NUMBER_OF_ITEMS { 100 };
+    std::atomic<int> processed { 0 };
+
+    AsyncDispatcher<int, std::function<void(int)>> dispatcher
+    {
+        [&processed](int)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++processed;
+        }
+        , 2
+        , 1
+    };
+
+    for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+    {
+        EXPECT_TRUE(dispatcher.pushWait(i));
+    }
+
+    dispatcher.rundown();
+    EXPECT_EQ(NUMBER_OF_ITEMS, processed);
+    EXPECT_EQ(0ul, dispatcher.dropped());
+    EXPECT_FALSE(dispatcher.pushWait(0));
+}
+
+TEST_F(ThreadDispatcherTest, AsyncDispatcherHandlerError)
+{
+    std::atomic<int> processed { 0 };
+
+    AsyncDispatcher<int, std::function<void(int)>> dispatcher
+    {
+        [&processed](int value)
+        {
+            if (0 == value)
+            {
+                throw std::runtime_error { "error" };
+            }
+
+            ++processed;
+        }
+        , 1
+    };
+
+    dispatcher.push(0);
+    dispatcher.push(1);
+    dispatcher.push(2);
+    dispatcher.rundown();
+    EXPECT_EQ(2, processed);
+}
+
+TEST_F(ThreadDispatcherTest, SpscDispatcherPushAndRundown)
+{
+    constexpr auto NUMBER_OF_ITEMS { 1000 };
+    std::vector<int> values;
+    SpscDispatcher<int, std::function<void(int)>> dispatcher
+    {
+        [&values](int value)
+        {
+            values.push_back(value);
+        }
+        , 1
+        , 8
+    };
+    EXPECT_EQ(1u, dispatcher.numberOfThreads());
+
+    for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+    {
+        EXPECT_TRUE(dispatcher.push(i));
+    }
+
+    dispatcher.rundown();
+    EXPECT_TRUE(dispatcher.cancelled());
+    EXPECT_EQ(0ul, dispatcher.size());
+    ASSERT_EQ(static_cast<size_t>(NUMBER_OF_ITEMS), values.size());
+
+    for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+    {
+        EXPECT_EQ(i, values[i]);
+    }
+
+    EXPECT_FALSE(dispatcher.push(0));
+}
+
+TEST_F(ThreadDispatcherTest, SpscDispatcherCancel)
+{
+    FunctorWrapper functor;
+    SpscDispatcher<int, std::reference_wrapper<FunctorWrapper>> dispatcher
+    {
+        std::ref(functor)
+    };
+    dispatcher.cancel();
+    EXPECT_CALL(functor, Operator(_)).Times(0);
+    EXPECT_FALSE(dispatcher.push(0));
+    EXPECT_TRUE(dispatcher.cancelled());
+    dispatcher.rundown();
+}
@@ -115,4 +115,144 @@ TEST_F(ThreadSafeQueueTest, CancelBlockingPop)
     queue.cancel();
     t1.join();
     t2.join();
-}
\ No newline at end of file
+}
+TEST_F(ThreadSafeQueueTest, PopMany)
+{
+    SafeQueue<int> queue;
+    std::vector<int> values;
+    EXPECT_EQ(0ul, queue.popMany(values, 2, false));
+
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.push(i);
+    }
+
+    EXPECT_EQ(2ul, queue.popMany(values, 2));
+    EXPECT_EQ(3ul, queue.popMany(values, 10));
+    EXPECT_EQ((std::vector<int> {0, 1, 2, 3, 4}), values);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ThreadSafeQueueTest, BoundedPushTimeout)
+{
+    BoundedSafeQueue<int> queue{ 2 };
+    EXPECT_EQ(2ul, queue.capacity());
+    EXPECT_TRUE(queue.push(0));
+    EXPECT_TRUE(queue.push(1, std::chrono::milliseconds(1)));
+    EXPECT_FALSE(queue.push(2, std::chrono::milliseconds(1)));
+    EXPECT_EQ(2ul, queue.size());
+    int ret_val{};
+    EXPECT_TRUE(queue.pop(ret_val));
+    EXPECT_EQ(0, ret_val);
+    EXPECT_TRUE(queue.push(2, std::chrono::milliseconds(1)));
+    std::vector<int> values;
+    EXPECT_EQ(2ul, queue.popMany(values, 10));
+    EXPECT_EQ((std::vector<int> {1, 2}), values);
+    EXPECT_FALSE(queue.pop(ret_val, false));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ThreadSafeQueueTest, BoundedBlockingPush)
+{
+    constexpr auto NUMBER_OF_ITEMS { 1000 };
+    BoundedSafeQueue<int> queue{ 4 };
+    std::thread t1
+    {
+        [&queue]()
+        {
+            for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+            {
+                EXPECT_TRUE(queue.push(i));
+            }
+        }
+    };
+    std::vector<int> values;
+
+    while (values.size() < NUMBER_OF_ITEMS)
+    {
+        EXPECT_LE(queue.popMany(values, 3), 3ul);
+    }
+
+    t1.join();
+
+    for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+    {
+        EXPECT_EQ(i, values[i]);
+    }
+}
+
+TEST_F(ThreadSafeQueueTest, BoundedCancelBlockingPush)
+{
+    BoundedSafeQueue<int> queue{ 1 };
+    EXPECT_TRUE(queue.push(0));
+    std::thread t1
+    {
+        [&queue]()
+        {
+            EXPECT_FALSE(queue.push(1));
+            EXPECT_TRUE(queue.cancelled());
+        }
+    };
+    queue.cancel();
+    t1.join();
+    int ret_val{};
+    EXPECT_FALSE(queue.pop(ret_val));
+}
+
+TEST_F(ThreadSafeQueueTest, SpscPushPop)
+{
+    SpscQueue<int> queue{ 3 };
+    EXPECT_EQ(4ul, queue.capacity());
+    EXPECT_TRUE(queue.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(4ul, queue.size());
+    int ret_val{};
+    EXPECT_TRUE(queue.tryPop(ret_val));
+    EXPECT_EQ(0, ret_val);
+    EXPECT_TRUE(queue.tryPush(4));
+    std::vector<int> values;
+    EXPECT_EQ(4ul, queue.popMany(values, 10));
+    EXPECT_EQ((std::vector<int> {1, 2, 3, 4}), values);
+    EXPECT_FALSE(queue.tryPop(ret_val));
+}
+
+TEST_F(ThreadSafeQueueTest, SpscProducerConsumer)
+{
+    constexpr auto NUMBER_OF_ITEMS { 10000 };
+    SpscQueue<int> queue{ 16 };
+    std::thread t1
+    {
+        [&queue]()
+        {
+            for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+            {
+                while (!queue.tryPush(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
+    std::vector<int> values;
+
+    while (values.size() < NUMBER_OF_ITEMS)
+    {
+        if (!queue.popMany(values, 8))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    t1.join();
+
+    for (int i = 0; i < NUMBER_OF_ITEMS; ++i)
+    {
+        EXPECT_EQ(i, values[i]);
+    }
+}
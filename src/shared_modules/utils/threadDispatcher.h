@@ -12,13 +12,15 @@
 #ifndef THREAD_DISPATCHER_H
 #define THREAD_DISPATCHER_H
 #include <vector>
+#include <deque>
 #include <thread>
 #include <atomic>
-#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include "threadSafeQueue.h"
-#include "promiseFactory.h"
 #include "commonDefs.h"
 
 namespace Utils
@@ -60,6 +62,19 @@ namespace Utils
     //  void cancel();
     // };
 
+    /**
+     * @brief Work-stealing dispatcher.
+     * @details Every worker thread owns a deque of messages. Producers spread
+     * the messages over the deques and an idle worker takes messages from the
+     * other deques before going to sleep, so a slow message does not stall the
+     * ones queued behind it. The messages are stored as they are pushed, no
+     * callable is built for each of them.
+     * When the queue is full push() drops the message, counts it and reports
+     * it to the drop callback, while pushWait() blocks until there is room.
+     *
+     * @tparam Type Messages types.
+     * @tparam Functor Entity that processes the messages.
+     */
     template
     <
         typename Type,
@@ -68,17 +83,30 @@ namespace Utils
     class AsyncDispatcher
     {
         public:
-            AsyncDispatcher(Functor functor, const unsigned int numberOfThreads = std::thread::hardware_concurrency(), const size_t maxQueueSize = UNLIMITED_QUEUE_SIZE)
+            using DropCallback = std::function<void(const Type&)>;
+
+            AsyncDispatcher(Functor functor,
+                            const unsigned int numberOfThreads = std::thread::hardware_concurrency(),
+                            const size_t maxQueueSize = UNLIMITED_QUEUE_SIZE,
+                            DropCallback dropCallback = nullptr)
                 : m_functor{ functor }
+                , m_dropCallback{ dropCallback }
                 , m_running{ true }
                 , m_numberOfThreads{ numberOfThreads ? numberOfThreads : 1 }
                 , m_maxQueueSize { maxQueueSize }
+                , m_workers(m_numberOfThreads)
+                , m_nextWorker{ 0 }
+                , m_queued{ 0 }
+                , m_pending{ 0 }
+                , m_idleWorkers{ 0 }
+                , m_blockedProducers{ 0 }
+                , m_dropped{ 0 }
             {
                 m_threads.reserve(m_numberOfThreads);
 
                 for (unsigned int i = 0; i < m_numberOfThreads; ++i)
                 {
-                    m_threads.push_back(std::thread{ &AsyncDispatcher<Type, Functor>::dispatch, this });
+                    m_threads.push_back(std::thread{ &AsyncDispatcher<Type, Functor>::dispatch, this, i });
                 }
             }
             AsyncDispatcher& operator=(const AsyncDispatcher&) = delete;
@@ -88,43 +116,120 @@ namespace Utils
                 cancel();
             }
 
-            void push(const Type& value)
+            /**
+             * @brief Pushes a message, dropping it when the queue is full.
+             *
+             * @param value Message value.
+             *
+             * @return true if the message was queued.
+             */
+            bool push(const Type& value)
             {
+                auto ret { false };
+
                 if (m_running)
                 {
-                    if (UNLIMITED_QUEUE_SIZE == m_maxQueueSize || m_queue.size() < m_maxQueueSize)
+                    ret = reserve(1) == 1;
+
+                    if (ret)
                     {
-                        m_queue.push
-                        (
-                            [value, this]()
-                        {
-                            this->m_functor(value);
-                        }
-                        );
+                        enqueue(&value, 1);
+                    }
+                    else
+                    {
+                        drop(&value, 1);
+                    }
+                }
+
+                return ret;
+            }
+
+            /**
+             * @brief Pushes a message, waiting for room when the queue is full.
+             *
+             * @param value Message value.
+             *
+             * @return true if the message was queued, false if the dispatcher
+             * was cancelled while waiting.
+             */
+            bool pushWait(const Type& value)
+            {
+                auto ret { m_running && reserve(1) == 1 };
+
+                if (!ret && m_running)
+                {
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+                    ++m_blockedProducers;
+                    m_spaceCondition.wait(lock, [this, &ret]()
+                    {
+                        ret = m_running && reserve(1) == 1;
+                        return ret || !m_running;
+                    });
+                    --m_blockedProducers;
+                }
+
+                if (ret)
+                {
+                    enqueue(&value, 1);
+                }
+
+                return ret;
+            }
+
+            /**
+             * @brief Pushes several messages at once.
+             * @details The room for the messages is reserved in one step and every
+             * deque is locked once for its share of them. The messages that do
+             * not fit are dropped as push() does.
+             *
+             * @param values Messages values.
+             *
+             * @return Number of messages queued.
+             */
+            size_t pushBatch(const std::vector<Type>& values)
+            {
+                size_t ret { 0 };
+
+                if (m_running && !values.empty())
+                {
+                    ret = reserve(values.size());
+
+                    if (ret)
+                    {
+                        enqueue(values.data(), ret);
+                    }
+
+                    if (ret < values.size())
+                    {
+                        drop(values.data() + ret, values.size() - ret);
                     }
                 }
+
+                return ret;
             }
 
             void rundown()
             {
                 if (m_running)
                 {
-                    auto promise { PromiseFactory<PROMISE_TYPE>::getPromiseObject() };
-                    m_queue.push
-                    (
-                        [&promise]()
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+                    m_doneCondition.wait(lock, [this]()
                     {
-                        promise->set_value();
-                    }
-                    );
-                    promise->wait();
+                        return 0 == m_pending || !m_running;
+                    });
+                    lock.unlock();
                     cancel();
                 }
             }
             void cancel()
             {
-                m_running = false;
-                m_queue.cancel();
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_running = false;
+                    m_workCondition.notify_all();
+                    m_spaceCondition.notify_all();
+                    m_doneCondition.notify_all();
+                }
                 joinThreads();
             }
 
@@ -138,27 +243,128 @@ namespace Utils
             }
             size_t size() const
             {
-                return m_queue.size();
+                return m_queued;
+            }
+            size_t dropped() const
+            {
+                return m_dropped;
             }
 
         private:
-            void dispatch()
+            struct Worker final
             {
-                try
+                std::mutex mutex;
+                std::deque<Type> queue;
+            };
+
+            // Reserves room for up to count messages and returns how many fit.
+            size_t reserve(const size_t count)
+            {
+                auto queued { m_queued.load() };
+                size_t reserved { 0 };
+
+                do
+                {
+                    reserved = UNLIMITED_QUEUE_SIZE == m_maxQueueSize
+                               ? count
+                               : queued < m_maxQueueSize ? std::min(count, m_maxQueueSize - queued) : 0;
+                }
+                while (reserved && !m_queued.compare_exchange_weak(queued, queued + reserved));
+
+                m_pending += reserved;
+                return reserved;
+            }
+            void enqueue(const Type* values, const size_t count)
+            {
+                const auto shares { std::min<size_t>(count, m_numberOfThreads) };
+                const auto first { m_nextWorker.fetch_add(static_cast<unsigned int>(shares)) };
+
+                for (size_t share = 0; share < shares; ++share)
+                {
+                    auto& worker { m_workers[(first + share) % m_numberOfThreads] };
+                    std::lock_guard<std::mutex> lock{ worker.mutex };
+                    worker.queue.insert(worker.queue.end(),
+                                        values + share * count / shares,
+                                        values + (share + 1) * count / shares);
+                }
+
+                if (m_idleWorkers)
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    shares > 1 ? m_workCondition.notify_all() : m_workCondition.notify_one();
+                }
+            }
+            void drop(const Type* values, const size_t count)
+            {
+                m_dropped += count;
+
+                if (m_dropCallback)
                 {
-                    while (m_running)
+                    for (size_t i = 0; i < count; ++i)
                     {
-                        std::function<void()> fnc;
+                        m_dropCallback(values[i]);
+                    }
+                }
+            }
+            // Takes a message from the worker's own deque or, when it is empty,
+            // steals one from the other workers in arrival order.
+            bool pop(const unsigned int index, Type& value)
+            {
+                for (unsigned int i = 0; i < m_numberOfThreads; ++i)
+                {
+                    auto& worker { m_workers[(index + i) % m_numberOfThreads] };
+                    std::lock_guard<std::mutex> lock{ worker.mutex };
 
-                        if (m_queue.pop(fnc))
-                        {
-                            fnc();
-                        }
+                    if (!worker.queue.empty())
+                    {
+                        value = std::move(worker.queue.front());
+                        worker.queue.pop_front();
+                        --m_queued;
+                        return true;
                     }
                 }
-                catch (const std::exception& ex)
+
+                return false;
+            }
+            void dispatch(const unsigned int index)
+            {
+                while (m_running)
                 {
-                    std::cerr << "Dispatch handler error, " << ex.what() << std::endl;
+                    Type value;
+
+                    if (pop(index, value))
+                    {
+                        if (m_blockedProducers)
+                        {
+                            std::lock_guard<std::mutex> lock{ m_mutex };
+                            m_spaceCondition.notify_one();
+                        }
+
+                        try
+                        {
+                            m_functor(value);
+                        }
+                        catch (const std::exception& ex)
+                        {
+                            std::cerr << "Dispatch handler error, " << ex.what() << std::endl;
+                        }
+
+                        if (0 == --m_pending)
+                        {
+                            std::lock_guard<std::mutex> lock{ m_mutex };
+                            m_doneCondition.notify_all();
+                        }
+                    }
+                    else
+                    {
+                        std::unique_lock<std::mutex> lock{ m_mutex };
+                        ++m_idleWorkers;
+                        m_workCondition.wait(lock, [this]()
+                        {
+                            return m_queued || !m_running;
+                        });
+                        --m_idleWorkers;
+                    }
                 }
             }
             void joinThreads()
@@ -173,11 +379,171 @@ namespace Utils
             }
 
             Functor m_functor;
-            SafeQueue<std::function<void()>> m_queue;
+            DropCallback m_dropCallback;
             std::vector<std::thread> m_threads;
             std::atomic_bool m_running;
             const unsigned int m_numberOfThreads;
             const size_t m_maxQueueSize;
+            std::vector<Worker> m_workers;
+            std::atomic<unsigned int> m_nextWorker;
+            std::atomic<size_t> m_queued;
+            std::atomic<size_t> m_pending;
+            std::atomic<unsigned int> m_idleWorkers;
+            std::atomic<unsigned int> m_blockedProducers;
+            std::atomic<size_t> m_dropped;
+            std::mutex m_mutex;
+            std::condition_variable m_workCondition;
+            std::condition_variable m_spaceCondition;
+            std::condition_variable m_doneCondition;
+    };
+
+    constexpr auto SPSC_DEFAULT_QUEUE_SIZE { 4096ul };
+    constexpr auto SPSC_POP_BATCH_SIZE { 64ul };
+
+    /**
+     * @brief Single thread dispatcher fed through a lock-free queue.
+     * @details Meant for pipeline nodes pushed from a single thread: the
+     * producer and the worker only share the SpscQueue, and the worker takes
+     * the messages in batches and sleeps only when the queue is empty. A full
+     * queue makes push() wait instead of dropping the message. An unlimited
+     * queue size falls back to SPSC_DEFAULT_QUEUE_SIZE.
+     *
+     * @tparam Type Messages types.
+     * @tparam Functor Entity that processes the messages.
+     */
+    template
+    <
+        typename Type,
+        typename Functor
+        >
+    class SpscDispatcher
+    {
+        public:
+            SpscDispatcher(Functor functor,
+                           const unsigned int /*numberOfThreads*/ = 1,
+                           const size_t maxQueueSize = UNLIMITED_QUEUE_SIZE)
+                : m_functor{ functor }
+                , m_running{ true }
+                , m_sleeping{ false }
+                , m_queue{ UNLIMITED_QUEUE_SIZE == maxQueueSize ? SPSC_DEFAULT_QUEUE_SIZE : maxQueueSize }
+                , m_thread{ &SpscDispatcher<Type, Functor>::dispatch, this }
+            {
+            }
+            SpscDispatcher& operator=(const SpscDispatcher&) = delete;
+            SpscDispatcher(SpscDispatcher& other) = delete;
+            ~SpscDispatcher()
+            {
+                cancel();
+            }
+
+            bool push(const Type& value)
+            {
+                while (m_running && !m_queue.tryPush(value))
+                {
+                    std::this_thread::yield();
+                }
+
+                // Pairs with the fence in dispatch(): either the worker sees the
+                // message or this thread sees the worker going to sleep.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (m_sleeping)
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_workCondition.notify_one();
+                }
+
+                return m_running;
+            }
+
+            void rundown()
+            {
+                if (m_running)
+                {
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+                    m_doneCondition.wait(lock, [this]()
+                    {
+                        return (m_sleeping && m_queue.empty()) || !m_running;
+                    });
+                    lock.unlock();
+                    cancel();
+                }
+            }
+            void cancel()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_running = false;
+                    m_workCondition.notify_all();
+                    m_doneCondition.notify_all();
+                }
+
+                if (m_thread.joinable())
+                {
+                    m_thread.join();
+                }
+            }
+
+            bool cancelled() const
+            {
+                return !m_running;
+            }
+            unsigned int numberOfThreads() const
+            {
+                return 1;
+            }
+            size_t size() const
+            {
+                return m_queue.size();
+            }
+
+        private:
+            void dispatch()
+            {
+                std::vector<Type> values;
+                values.reserve(SPSC_POP_BATCH_SIZE);
+
+                while (m_running)
+                {
+                    if (m_queue.popMany(values, SPSC_POP_BATCH_SIZE))
+                    {
+                        for (const auto& value : values)
+                        {
+                            try
+                            {
+                                m_functor(value);
+                            }
+                            catch (const std::exception& ex)
+                            {
+                                std::cerr << "Dispatch handler error, " << ex.what() << std::endl;
+                            }
+                        }
+
+                        values.clear();
+                    }
+                    else
+                    {
+                        std::unique_lock<std::mutex> lock{ m_mutex };
+                        m_sleeping = true;
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        m_doneCondition.notify_all();
+                        m_workCondition.wait(lock, [this]()
+                        {
+                            return !m_queue.empty() || !m_running;
+                        });
+                        m_sleeping = false;
+                    }
+                }
+            }
+
+            Functor m_functor;
+            std::atomic_bool m_running;
+            std::atomic_bool m_sleeping;
+            SpscQueue<Type> m_queue;
+            std::mutex m_mutex;
+            std::condition_variable m_workCondition;
+            std::condition_variable m_doneCondition;
+            std::thread m_thread;
     };
 
     template <typename Input, typename Functor>
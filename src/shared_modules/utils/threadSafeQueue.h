@@ -12,7 +12,10 @@
 #ifndef THREAD_SAFE_QUEUE_H
 #define THREAD_SAFE_QUEUE_H
 #include <queue>
+#include <vector>
+#include <algorithm>
 #include <mutex>
+#include <chrono>
 #include <memory>
 #include <atomic>
 #include <condition_variable>
@@ -97,6 +100,39 @@ namespace Utils
                 return nullptr;
             }
 
+            /**
+             * @brief Pops up to maxCount elements in one wakeup.
+             *
+             * @param values Vector the popped elements are appended to.
+             * @param maxCount Maximum number of elements to pop.
+             * @param wait Whether to wait for an element to be pushed.
+             *
+             * @return Number of popped elements.
+             */
+            size_t popMany(std::vector<T>& values, const size_t maxCount, const bool wait = true)
+            {
+                Lock lock{ m_mutex };
+
+                if (wait)
+                {
+                    m_cv.wait(lock, [this]()
+                    {
+                        return !m_queue.empty() || m_canceled;
+                    });
+                }
+
+                size_t ret { 0 };
+
+                while (!m_canceled && !m_queue.empty() && ret < maxCount)
+                {
+                    values.push_back(std::move(m_queue.front()));
+                    m_queue.pop();
+                    ++ret;
+                }
+
+                return ret;
+            }
+
             bool empty() const
             {
                 std::lock_guard<std::mutex> lock{ m_mutex };
@@ -129,6 +165,313 @@ namespace Utils
             bool m_canceled;
             std::queue<T> m_queue;
     };
+
+    /**
+     * @brief Bounded queue backed by a ring buffer.
+     * @details The storage is allocated once. Producers wait for room when the
+     * queue is full, either until it is cancelled or for a given timeout.
+     *
+     * @tparam T Elements type.
+     */
+    template<typename T>
+    class BoundedSafeQueue
+    {
+        public:
+            explicit BoundedSafeQueue(const size_t capacity)
+                : m_buffer(capacity ? capacity : 1)
+                , m_head{ 0 }
+                , m_size{ 0 }
+                , m_canceled{ false }
+            {}
+            BoundedSafeQueue& operator=(const BoundedSafeQueue&) = delete;
+            BoundedSafeQueue(const BoundedSafeQueue&) = delete;
+            ~BoundedSafeQueue()
+            {
+                cancel();
+            }
+
+            /**
+             * @brief Pushes an element, waiting for room when the queue is full.
+             *
+             * @param value Element to push.
+             *
+             * @return false if the queue was cancelled.
+             */
+            bool push(const T& value)
+            {
+                Lock lock{ m_mutex };
+                m_notFull.wait(lock, [this]()
+                {
+                    return m_size < m_buffer.size() || m_canceled;
+                });
+                return insert(value);
+            }
+
+            /**
+             * @brief Pushes an element, waiting at most timeout for room.
+             *
+             * @param value Element to push.
+             * @param timeout Maximum time to wait for room.
+             *
+             * @return false if the queue was cancelled or still full after timeout.
+             */
+            template<typename Rep, typename Period>
+            bool push(const T& value, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                Lock lock{ m_mutex };
+                m_notFull.wait_for(lock, timeout, [this]()
+                {
+                    return m_size < m_buffer.size() || m_canceled;
+                });
+                return insert(value);
+            }
+
+            bool pop(T& value, const bool wait = true)
+            {
+                Lock lock{ m_mutex };
+
+                if (wait)
+                {
+                    m_notEmpty.wait(lock, [this]()
+                    {
+                        return m_size || m_canceled;
+                    });
+                }
+
+                const bool ret { !m_canceled && m_size };
+
+                if (ret)
+                {
+                    value = std::move(m_buffer[m_head]);
+                    m_head = (m_head + 1) % m_buffer.size();
+                    --m_size;
+                    m_notFull.notify_one();
+                }
+
+                return ret;
+            }
+
+            /**
+             * @brief Pops up to maxCount elements in one wakeup.
+             *
+             * @param values Vector the popped elements are appended to.
+             * @param maxCount Maximum number of elements to pop.
+             * @param wait Whether to wait for an element to be pushed.
+             *
+             * @return Number of popped elements.
+             */
+            size_t popMany(std::vector<T>& values, const size_t maxCount, const bool wait = true)
+            {
+                Lock lock{ m_mutex };
+
+                if (wait)
+                {
+                    m_notEmpty.wait(lock, [this]()
+                    {
+                        return m_size || m_canceled;
+                    });
+                }
+
+                size_t ret { 0 };
+
+                while (!m_canceled && m_size && ret < maxCount)
+                {
+                    values.push_back(std::move(m_buffer[m_head]));
+                    m_head = (m_head + 1) % m_buffer.size();
+                    --m_size;
+                    ++ret;
+                }
+
+                if (ret)
+                {
+                    m_notFull.notify_all();
+                }
+
+                return ret;
+            }
+
+            bool empty() const
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                return !m_size;
+            }
+
+            size_t size() const
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                return m_size;
+            }
+
+            size_t capacity() const
+            {
+                return m_buffer.size();
+            }
+
+            void cancel()
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_canceled = true;
+                m_notEmpty.notify_all();
+                m_notFull.notify_all();
+            }
+
+            bool cancelled() const
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                return m_canceled;
+            }
+
+        private:
+            using Lock = std::unique_lock<std::mutex>;
+
+            bool insert(const T& value)
+            {
+                const bool ret { !m_canceled && m_size < m_buffer.size() };
+
+                if (ret)
+                {
+                    m_buffer[(m_head + m_size) % m_buffer.size()] = value;
+                    ++m_size;
+                    m_notEmpty.notify_one();
+                }
+
+                return ret;
+            }
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_notEmpty;
+            std::condition_variable m_notFull;
+            std::vector<T> m_buffer;
+            size_t m_head;
+            size_t m_size;
+            bool m_canceled;
+    };
+
+    /**
+     * @brief Lock-free single producer single consumer queue.
+     * @details Bounded ring buffer whose capacity is rounded up to a power of
+     * two. Only one thread may push and only one thread may pop; neither side
+     * blocks, so waiting is left to the caller.
+     *
+     * @tparam T Elements type.
+     */
+    template<typename T>
+    class SpscQueue
+    {
+        public:
+            explicit SpscQueue(const size_t capacity)
+                : m_buffer(roundUpCapacity(capacity))
+                , m_mask{ m_buffer.size() - 1 }
+                , m_head{ 0 }
+                , m_tail{ 0 }
+            {}
+            SpscQueue& operator=(const SpscQueue&) = delete;
+            SpscQueue(const SpscQueue&) = delete;
+
+            /**
+             * @brief Pushes an element. To be called from the producer thread only.
+             *
+             * @param value Element to push.
+             *
+             * @return false if the queue is full.
+             */
+            bool tryPush(const T& value)
+            {
+                const auto tail { m_tail.load(std::memory_order_relaxed) };
+                const bool ret { tail - m_head.load(std::memory_order_acquire) < m_buffer.size() };
+
+                if (ret)
+                {
+                    m_buffer[tail & m_mask] = value;
+                    m_tail.store(tail + 1, std::memory_order_release);
+                }
+
+                return ret;
+            }
+
+            /**
+             * @brief Pops an element. To be called from the consumer thread only.
+             *
+             * @param value Popped element.
+             *
+             * @return false if the queue is empty.
+             */
+            bool tryPop(T& value)
+            {
+                const auto head { m_head.load(std::memory_order_relaxed) };
+                const bool ret { head != m_tail.load(std::memory_order_acquire) };
+
+                if (ret)
+                {
+                    value = std::move(m_buffer[head & m_mask]);
+                    m_head.store(head + 1, std::memory_order_release);
+                }
+
+                return ret;
+            }
+
+            /**
+             * @brief Pops up to maxCount elements. To be called from the consumer thread only.
+             *
+             * @param values Vector the popped elements are appended to.
+             * @param maxCount Maximum number of elements to pop.
+             *
+             * @return Number of popped elements.
+             */
+            size_t popMany(std::vector<T>& values, const size_t maxCount)
+            {
+                const auto head { m_head.load(std::memory_order_relaxed) };
+                const auto ret { std::min(maxCount, m_tail.load(std::memory_order_acquire) - head) };
+
+                for (size_t i = 0; i < ret; ++i)
+                {
+                    values.push_back(std::move(m_buffer[(head + i) & m_mask]));
+                }
+
+                m_head.store(head + ret, std::memory_order_release);
+                return ret;
+            }
+
+            bool empty() const
+            {
+                return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+            }
+
+            size_t size() const
+            {
+                const auto head { m_head.load(std::memory_order_acquire) };
+                return m_tail.load(std::memory_order_acquire) - head;
+            }
+
+            size_t capacity() const
+            {
+                return m_buffer.size();
+            }
+
+        private:
+            static constexpr size_t CACHE_LINE_SIZE { 64 };
+
+            static size_t roundUpCapacity(const size_t capacity)
+            {
+                size_t ret { 1 };
+
+                while (ret < capacity)
+                {
+                    ret <<= 1;
+                }
+
+                return ret;
+            }
+
+            std::vector<T> m_buffer;
+            const size_t m_mask;
+            // Head and tail are written by different threads, keep them in
+            // different cache lines.
+            char m_padding0[CACHE_LINE_SIZE];
+            std::atomic<size_t> m_head;
+            char m_padding1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+            std::atomic<size_t> m_tail;
+    };
 }//namespace Utils
 
 #endif //THREAD_SAFE_QUEUE_H
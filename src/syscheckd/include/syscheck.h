@@ -28,6 +28,7 @@
 #define AUDIT_HEALTHCHECK_DIR       "tmp"
 #define AUDIT_HEALTHCHECK_KEY       "wazuh_hc"
 #define AUDIT_HEALTHCHECK_FILE      "tmp/audit_hc"
+#define FIM_DIFF_SIZE_FILE          DIFF_DIR "/local.size"
 
 #ifdef WIN32
 #define FIM_REGULAR _S_IFREG
@@ -106,13 +107,58 @@ typedef struct create_json_event_ctx {
 typedef struct fim_txn_context_s {
     event_data_t* evt_data;
     fim_entry* latest_entry;
+    struct fim_scan_worker_s* scan_worker; // Set when the entries are sent to the parallel scan writer.
 } fim_txn_context_t;
 
+/* Worker pool of the parallel scan */
+#define FIM_SCAN_DEQUE_SIZE 1024
+#define FIM_SCAN_RESULT_QUEUE_SIZE 1024
+
+typedef struct fim_scan_pool_s fim_scan_pool_t;
+
+typedef struct fim_scan_job_s {
+    char *path;
+    const directory_t *configuration;
+} fim_scan_job_t;
+
+typedef struct fim_scan_result_s {
+    fim_entry entry;
+    bool hashes_reused;
+} fim_scan_result_t;
+
+typedef struct fim_scan_worker_s {
+    fim_scan_pool_t *pool;
+    unsigned int id;
+    pthread_t thread;
+    fim_scan_job_t *jobs;   // Fixed size deque, the owner works on its back and the others steal from its front.
+    size_t begin;
+    size_t count;
+} fim_scan_worker_t;
+
+struct fim_scan_pool_s {
+    fim_scan_worker_t *workers;
+    unsigned int size;
+    pthread_mutex_t mutex;
+    pthread_cond_t available;
+    unsigned int pending;           // Jobs queued or being processed.
+    unsigned int running;           // Workers that have not finished yet.
+    TXN_HANDLE txn_handle;
+    w_queue_t *results;
+    fim_scan_result_t finished;     // Pushed by the last worker to stop the writer.
+};
+
 #ifdef WIN32
 /* Flags to know if a directory/file's watcher has been removed */
 #define FIM_RT_HANDLE_CLOSED 0
 #define FIM_RT_HANDLE_OPEN 1
 
+/* Size of the change records buffer of a realtime directory, doubled on every overflow up to the maximum */
+#define FIM_RT_BUFFER_SIZE 65536
+#define FIM_RT_BUFFER_MAX (1024 * 1024)
+
+/* Threads that process the completions of the realtime directories */
+#define FIM_RT_WORKERS 2
+
 /* Default value type for cases where type is undefined.
    0x0000000C is the one after the last defined type, REG_QWORD (0x0000000B) */
 #define REG_UNKNOWN 0x0000000C
@@ -228,6 +274,15 @@ void fim_file(const char *path,
  */
 void fim_realtime_event(char *file);
 
+/**
+ * @brief Scan a realtime directory again after its changes were lost
+ *
+ * Reports the new and modified entries under the directory, and the ones deleted from it.
+ *
+ * @param [in] dir Path of the directory
+ */
+void fim_realtime_rescan(const char *dir);
+
 /**
  * @brief Process FIM whodata event
  *
@@ -279,6 +334,23 @@ int fim_check_depth(const char *path, const directory_t *configuration);
  */
 fim_file_data *fim_get_data(const char *file, const directory_t *configuration, const struct stat *statbuf);
 
+/**
+ * @brief Get data from file, taking the hashes from the stored data when the file metadata did not change
+ *
+ * @param file Name of the file to get the data from
+ * @param [in] configuration Configuration block associated with a previous event.
+ * @param [in] statbuf Buffer acquired from a stat command with information linked to 'path'
+ * @param [in] stored Data stored in the FIM DB for the file. If NULL, the hashes are always calculated.
+ * @param [out] hashes_reused Set to true when the stored hashes were used. Can be NULL.
+ *
+ * @return A fim_file_data structure with the data from the file
+ */
+fim_file_data *fim_get_data_reusing_hashes(const char *file,
+                                           const directory_t *configuration,
+                                           const struct stat *statbuf,
+                                           const fim_file_data *stored,
+                                           bool *hashes_reused);
+
 /**
  * @brief Initialize a fim_file_data structure
  *
@@ -405,6 +477,20 @@ void fim_realtime_print_watches();
  */
 void realtime_process(void);
 
+/**
+ * @brief Checks the coalesced real-time paths whose quiet window has ended
+ *
+ * @param force Check all the pending paths, even if their quiet window has not ended
+ */
+void realtime_flush_events(bool force);
+
+/**
+ * @brief Gets the time until the quiet window of the next coalesced real-time path ends
+ *
+ * @return Milliseconds until the next path must be checked, or -1 if there are no pending paths
+ */
+long realtime_coalesce_timeout(void);
+
 /**
  * @brief Deletes subdirectories watches when a folder changes its name
  *
@@ -462,11 +548,11 @@ int audit_init(void);
 char *audit_get_id(const char * event);
 
 /**
- * @brief Initialize regular expressions
+ * @brief Initialize the state of the audit event parser
  *
  * @return 0 on success, -1 on error
  */
-int init_regex(void);
+int init_audit_parser(void);
 
 /**
  * @brief Adds audit rules to directories
@@ -629,6 +715,28 @@ void audit_restore();
 
 long unsigned int WINAPI state_checker(__attribute__((unused)) void *_void);
 
+/**
+ * @brief Thread that reads the whodata subscription until the whodata resources are released
+ *
+ */
+long unsigned int WINAPI whodata_event_loop(__attribute__((unused)) void *_void);
+
+/**
+ * @brief Wait for the whodata subscription to have events and process them in batches
+ *
+ * @param timeout Maximum time to wait for new events (milliseconds)
+ * @return Number of events processed
+ */
+int whodata_process_events(DWORD timeout);
+
+/**
+ * @brief Remove the handles of the whodata table that got no events since a given time
+ *
+ * @param stale_time Handles whose last event is older than this time are removed
+ * @return Number of handles removed
+ */
+unsigned int whodata_expire_handles(time_t stale_time);
+
 /**
  * @brief Function that generates the diff file of a Windows registry when the option report_changes is activated
  * It creates a file with the content of the value, to compute differences
@@ -665,6 +773,13 @@ char *fim_file_diff(const char *filename, const directory_t *configuration);
  */
 void fim_diff_process_delete_file(const char *filename);
 
+#ifndef WIN32
+/**
+ * @brief Removes the stored chunks no file refers to anymore, if some were released since the last call
+ */
+void fim_diff_collect_chunks();
+#endif
+
 #ifdef WIN32
 /**
  * @brief Deletes the registry diff folder and modify diff_folder_size if disk_quota enabled
@@ -708,6 +823,16 @@ int fim_check_ignore(const char *file_name);
  */
 int fim_check_restrict(const char *file_name, OSMatch *restriction);
 
+/**
+ * @brief Checks whether the scan is due to verify the hashes of an entry even if its metadata did not change.
+ * @details The entries are spread over 'hash_verify_scans' buckets by path and one bucket is verified per scan,
+ * so every entry is hashed at least once every 'hash_verify_scans' scans.
+ *
+ * @param path Path of the file or registry key.
+ * @return true if the entry must be hashed in this scan, false otherwise.
+ */
+bool fim_hash_verify_due(const char *path);
+
 #ifndef WIN32
 
 /**
@@ -756,6 +881,23 @@ int w_update_sacl(const char *obj_path);
  * @return Number of realtime watches.
  */
 unsigned int get_realtime_watches();
+
+/**
+ * @brief Process the next completion of the realtime directories
+ *
+ * @param timeout Maximum time to wait, in milliseconds.
+ * @retval 1 A completion was processed.
+ * @retval 0 Timeout.
+ * @retval -1 The completion port failed.
+ */
+int realtime_win32_dequeue(DWORD timeout);
+
+/**
+ * @brief Thread that processes the completions of the realtime directories
+ *
+ * @param args Unused.
+ */
+DWORD WINAPI realtime_win32_worker(void * args);
 #endif
 
 /**
@@ -866,6 +1008,40 @@ void fim_check_db_state();
  */
 void fim_diff_folder_size();
 
+/**
+ * @brief Corrects the saved diff folder size with a walk of the folder, in its own thread
+ *
+ * @param args Unused
+ */
+#ifdef WIN32
+DWORD WINAPI fim_diff_folder_size_reconcile(__attribute__((unused)) void *args);
+#else
+void *fim_diff_folder_size_reconcile(__attribute__((unused)) void *args);
+#endif
+
+/**
+ * @brief Walks the queue/diff/local folder when its running total must be reconciled
+ *
+ * The folder is walked on every scan if syscheck.diff_size_reconcile is 1. Otherwise it is walked on the first
+ * scan, in the background if there is a saved total, and then once every syscheck.diff_size_reconcile scans.
+ *
+ * @param scan Number of the scan starting, from 1
+ */
+void fim_diff_folder_size_refresh(unsigned int scan);
+
+/**
+ * @brief Reads the diff folder size saved by a previous scan into syscheck.diff_folder_size
+ *
+ * @return 0 on success, -1 if there is no valid saved size
+ */
+int fim_diff_folder_size_load();
+
+/**
+ * @brief Saves syscheck.diff_folder_size so that the next start doesn't need to walk the diff folder
+ *
+ */
+void fim_diff_folder_size_save();
+
 /**
  * @brief Get the directory that will be effectively monitored depending on configuration the entry configuration and
  * physical object in the filesystem
@@ -144,6 +144,8 @@ cJSON *getSyscheckConfig(void) {
     if (syscheck.scan_day) cJSON_AddStringToObject(syscfg,"scan_day",syscheck.scan_day);
     if (syscheck.scan_time) cJSON_AddStringToObject(syscfg,"scan_time",syscheck.scan_time);
     cJSON_AddNumberToObject(syscfg, "max_files_per_second", syscheck.max_files_per_second);
+    cJSON_AddStringToObject(syscfg, "skip_unchanged_hash", syscheck.skip_unchanged_hash ? "yes" : "no");
+    cJSON_AddNumberToObject(syscfg, "hash_verify_scans", syscheck.hash_verify_scans);
 
     cJSON * file_limit = cJSON_CreateObject();
     cJSON_AddStringToObject(file_limit, "enabled", syscheck.file_limit_enabled ? "yes" : "no");
@@ -493,7 +495,16 @@ cJSON *getSyscheckConfig(void) {
     cJSON_AddNumberToObject(syscfg, "process_priority", syscheck.process_priority);
 
     // Add sql database information
-    cJSON_AddStringToObject(syscfg, "database", syscheck.database_store ? "memory" : "disk");
+    switch (syscheck.database_store) {
+    case FIM_DB_MEMORY:
+        cJSON_AddStringToObject(syscfg, "database", "memory");
+        break;
+    case FIM_DB_HYBRID:
+        cJSON_AddStringToObject(syscfg, "database", "hybrid");
+        break;
+    default:
+        cJSON_AddStringToObject(syscfg, "database", "disk");
+    }
 
 
     cJSON_AddItemToObject(root,"syscheck",syscfg);
@@ -513,6 +524,7 @@ cJSON *getSyscheckInternalOptions(void) {
     cJSON_AddNumberToObject(syscheckd,"symlink_scan_interval",syscheck.sym_checker_interval);
     cJSON_AddNumberToObject(syscheckd,"debug",sys_debug_level);
     cJSON_AddNumberToObject(syscheckd,"file_max_size",syscheck.file_max_size);
+    cJSON_AddNumberToObject(syscheckd,"scan_threads",syscheck.scan_threads);
 #ifdef WIN32
     cJSON_AddNumberToObject(syscheckd,"max_fd_win_rt",syscheck.max_fd_win_rt);
 #else
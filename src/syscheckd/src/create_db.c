@@ -31,6 +31,9 @@ extern void mock_assert(const int result, const char* const expression,
 
 // Global variables
 static int _base_line = 0;
+static unsigned int _scan_count = 0;
+static unsigned int _hashed_files = 0;
+static unsigned int _hash_skipped_files = 0;
 
 static const char *FIM_EVENT_TYPE_ARRAY[] = {
     "added",
@@ -481,6 +484,237 @@ int fim_generate_delete_event(const char *file_path,
     return fim_db_get_path(file_path, callback_data);
 }
 
+static void fim_count_hashed_file(bool hashes_reused) {
+    if (hashes_reused) {
+        _hash_skipped_files++;
+    } else {
+        _hashed_files++;
+    }
+}
+
+/**
+ * @brief Queues a path in the deque of a scan worker.
+ *
+ * @param worker Worker that owns the deque.
+ * @param path Path to be checked. It's copied.
+ * @param configuration Configuration of the directory the path was found in.
+ * @return true if the path was queued, false if the deque is full and the caller must process it.
+ */
+static bool fim_scan_push_job(fim_scan_worker_t *worker, const char *path, const directory_t *configuration) {
+    fim_scan_pool_t *pool = worker->pool;
+    fim_scan_job_t *job;
+
+    w_mutex_lock(&pool->mutex);
+
+    if (worker->count == FIM_SCAN_DEQUE_SIZE) {
+        w_mutex_unlock(&pool->mutex);
+        return false;
+    }
+
+    job = &worker->jobs[(worker->begin + worker->count) % FIM_SCAN_DEQUE_SIZE];
+    os_strdup(path, job->path);
+    job->configuration = configuration;
+    worker->count++;
+    pool->pending++;
+
+    w_cond_signal(&pool->available);
+    w_mutex_unlock(&pool->mutex);
+
+    return true;
+}
+
+/**
+ * @brief Takes the newest job of the worker or, if it has none, steals the oldest one of another worker.
+ * @details Must be called with the pool mutex locked. Working depth-first on the own deque keeps it small,
+ * while the stolen jobs are the ones closer to the root, which hold the biggest subtrees.
+ *
+ * @param worker Worker looking for a job.
+ * @param job Buffer for the job.
+ * @return true if a job was taken, false if all the deques are empty.
+ */
+static bool fim_scan_take_job(fim_scan_worker_t *worker, fim_scan_job_t *job) {
+    fim_scan_pool_t *pool = worker->pool;
+    fim_scan_worker_t *victim;
+    unsigned int i;
+
+    if (worker->count > 0) {
+        worker->count--;
+        *job = worker->jobs[(worker->begin + worker->count) % FIM_SCAN_DEQUE_SIZE];
+        return true;
+    }
+
+    for (i = 1; i < pool->size; i++) {
+        victim = &pool->workers[(worker->id + i) % pool->size];
+
+        if (victim->count > 0) {
+            *job = victim->jobs[victim->begin];
+            victim->begin = (victim->begin + 1) % FIM_SCAN_DEQUE_SIZE;
+            victim->count--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Hands a scanned file over to the writer, which syncs it in the scan transaction.
+ *
+ * @param worker Worker that scanned the file.
+ * @param entry Scanned entry. The path is copied and the data is owned by the writer from now on.
+ * @param hashes_reused Whether the hashes were taken from the DB instead of read from the file.
+ */
+static void fim_scan_push_result(fim_scan_worker_t *worker, const fim_entry *entry, bool hashes_reused) {
+    fim_scan_result_t *result;
+
+    os_calloc(1, sizeof(fim_scan_result_t), result);
+    result->entry.type = entry->type;
+    os_strdup(entry->file_entry.path, result->entry.file_entry.path);
+    result->entry.file_entry.data = entry->file_entry.data;
+    result->hashes_reused = hashes_reused;
+
+    queue_push_ex_block(worker->pool->results, result);
+}
+
+static void *fim_scan_worker_main(void *args) {
+    fim_scan_worker_t *worker = (fim_scan_worker_t *)args;
+    fim_scan_pool_t *pool = worker->pool;
+    event_data_t evt_data = { .report_event = true, .mode = FIM_SCHEDULED, .w_evt = NULL };
+    fim_txn_context_t txn_ctx = { .evt_data = &evt_data, .latest_entry = NULL, .scan_worker = worker };
+    fim_scan_job_t job;
+    bool last;
+
+    w_mutex_lock(&pool->mutex);
+
+    while (true) {
+        if (fim_scan_take_job(worker, &job)) {
+            w_mutex_unlock(&pool->mutex);
+
+            fim_checker(job.path, &evt_data, job.configuration, pool->txn_handle, &txn_ctx);
+            os_free(job.path);
+
+            w_mutex_lock(&pool->mutex);
+
+            if (--pool->pending == 0) {
+                w_cond_broadcast(&pool->available);
+            }
+        } else if (pool->pending == 0) {
+            break;
+        } else {
+            w_cond_wait(&pool->available, &pool->mutex);
+        }
+    }
+
+    last = --pool->running == 0;
+    w_mutex_unlock(&pool->mutex);
+
+    if (last) {
+        queue_push_ex_block(pool->results, &pool->finished);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Walks the configured directories with a pool of 'scan_threads' workers.
+ * @details The workers enumerate the directories and get the data of the files, but only the calling thread syncs
+ * the entries in the scan transaction. The entries are dbsync rows keyed by path, so the order in which they
+ * arrive doesn't change the result of the transaction.
+ *
+ * @param txn_handle Handle of the scan transaction.
+ * @param txn_ctx Context of the scan transaction.
+ */
+static void fim_scan_parallel(TXN_HANDLE txn_handle, fim_txn_context_t *txn_ctx) {
+    fim_scan_pool_t pool = { .size = syscheck.scan_threads, .txn_handle = txn_handle };
+    fim_scan_result_t *result;
+    OSListNode *node_it;
+    directory_t *dir_it;
+    unsigned int i = 0;
+    unsigned int started = 0;
+    bool stopped;
+    int error;
+
+    w_mutex_init(&pool.mutex, NULL);
+    w_cond_init(&pool.available, NULL);
+    pool.results = queue_init(FIM_SCAN_RESULT_QUEUE_SIZE);
+    os_calloc(pool.size, sizeof(fim_scan_worker_t), pool.workers);
+
+    for (i = 0; i < pool.size; i++) {
+        pool.workers[i].pool = &pool;
+        pool.workers[i].id = i;
+        os_calloc(FIM_SCAN_DEQUE_SIZE, sizeof(fim_scan_job_t), pool.workers[i].jobs);
+    }
+
+    // The configured directories are spread over the workers before they start.
+    i = 0;
+    OSList_foreach(node_it, syscheck.directories) {
+        dir_it = node_it->data;
+        char *path = fim_get_real_path(dir_it);
+
+        if (!fim_scan_push_job(&pool.workers[i++ % pool.size], path, dir_it)) {
+            fim_checker(path, txn_ctx->evt_data, dir_it, txn_handle, txn_ctx);
+        }
+
+        os_free(path);
+    }
+
+    pool.running = pool.size;
+
+    for (i = 0; i < pool.size; i++) {
+        if (error = pthread_create(&pool.workers[i].thread, NULL, fim_scan_worker_main, &pool.workers[i]), error) {
+            merror(FIM_ERROR_SCAN_THREAD, strerror(error));
+            w_mutex_lock(&pool.mutex);
+            pool.running -= pool.size - i;
+            stopped = started > 0 && pool.running == 0;
+            w_mutex_unlock(&pool.mutex);
+
+            // The started workers already finished, so none of them will stop the writer.
+            if (stopped) {
+                queue_push_ex_block(pool.results, &pool.finished);
+            }
+            break;
+        }
+        started++;
+    }
+
+    if (started > 0) {
+        // Single writer: the DB transaction and its callback events work as in the sequential scan.
+        while (result = queue_pop_ex(pool.results), result != &pool.finished) {
+            txn_ctx->latest_entry = &result->entry;
+            fim_db_transaction_sync_row(txn_handle, &result->entry);
+            txn_ctx->latest_entry = NULL;
+
+            fim_count_hashed_file(result->hashes_reused);
+            free_file_data(result->entry.file_entry.data);
+            os_free(result->entry.file_entry.path);
+            os_free(result);
+        }
+
+        for (i = 0; i < started; i++) {
+            pthread_join(pool.workers[i].thread, NULL);
+        }
+    }
+
+    // Whatever is left if no worker could be started is scanned here.
+    for (i = 0; i < pool.size; i++) {
+        while (pool.workers[i].count > 0) {
+            fim_scan_job_t *job = &pool.workers[i].jobs[pool.workers[i].begin];
+
+            pool.workers[i].begin = (pool.workers[i].begin + 1) % FIM_SCAN_DEQUE_SIZE;
+            pool.workers[i].count--;
+            fim_checker(job->path, txn_ctx->evt_data, job->configuration, txn_handle, txn_ctx);
+            os_free(job->path);
+        }
+
+        os_free(pool.workers[i].jobs);
+    }
+
+    os_free(pool.workers);
+    queue_free(pool.results);
+    w_cond_destroy(&pool.available);
+    w_mutex_destroy(&pool.mutex);
+}
+
 time_t fim_scan() {
     struct timespec start;
     struct timespec end;
@@ -506,13 +740,16 @@ time_t fim_scan() {
     minfo(FIM_FREQUENCY_STARTED);
     fim_send_scan_info(FIM_SCAN_START);
 
+    _scan_count++;
+    _hashed_files = 0;
+    _hash_skipped_files = 0;
 
     TXN_HANDLE db_transaction_handle = fim_db_transaction_start(FIMDB_FILE_TXN_TABLE, transaction_callback, &txn_ctx);
     if (db_transaction_handle == NULL) {
         merror(FIM_ERROR_TRANSACTION, FIMDB_FILE_TXN_TABLE);
         return time(NULL);
     }
-    fim_diff_folder_size();
+    fim_diff_folder_size_refresh(_scan_count);
     syscheck.disk_quota_full_msg = true;
 
     mdebug2(FIM_DIFF_FOLDER_SIZE, DIFF_DIR, syscheck.diff_folder_size);
@@ -522,11 +759,18 @@ time_t fim_scan() {
     update_wildcards_config();
 
     w_rwlock_rdlock(&syscheck.directories_lock);
+
+    if (syscheck.scan_threads > 1) {
+        fim_scan_parallel(db_transaction_handle, &txn_ctx);
+    }
+
     OSList_foreach(node_it, syscheck.directories) {
         dir_it = node_it->data;
         char *path = fim_get_real_path(dir_it);
 
-        fim_checker(path, &evt_data, dir_it, db_transaction_handle, &txn_ctx);
+        if (syscheck.scan_threads <= 1) {
+            fim_checker(path, &evt_data, dir_it, db_transaction_handle, &txn_ctx);
+        }
 
 #ifndef WIN32
         realtime_adddir(path, dir_it);
@@ -581,10 +825,18 @@ time_t fim_scan() {
         db_transaction_handle = NULL;
     }
 
+#ifndef WIN32
+    fim_diff_collect_chunks();
+#endif
+
 #ifdef WIN32
     fim_registry_scan();
 #endif
 
+    if (syscheck.disk_quota_enabled && syscheck.diff_size_reconcile > 1) {
+        fim_diff_folder_size_save();
+    }
+
     gettime(&end);
     end_of_scan = time(NULL);
 
@@ -619,6 +871,11 @@ time_t fim_scan() {
     }
 
     minfo(FIM_FREQUENCY_ENDED);
+
+    if (syscheck.skip_unchanged_hash) {
+        minfo(FIM_HASH_SCAN_SUMMARY, _hashed_files, _hash_skipped_files);
+    }
+
     fim_send_scan_info(FIM_SCAN_END);
 
     if (isDebug()) {
@@ -734,7 +991,9 @@ void fim_checker(const char *path,
             return;
         }
 
+        W_PROBE1(file__start, path);
         fim_file(path, configuration, evt_data, dbsync_txn, ctx);
+        W_PROBE1(file__done, path);
         break;
 
     case FIM_DIRECTORY:
@@ -801,6 +1060,11 @@ int fim_directory(const char *dir,
 #ifdef WIN32
         str_lowercase(f_name);
 #endif
+        // In a parallel scan the entry is left to any idle worker, unless the deque is full
+        if (ctx != NULL && ctx->scan_worker != NULL && fim_scan_push_job(ctx->scan_worker, f_name, configuration)) {
+            continue;
+        }
+
         // Process the event related to f_name
         fim_checker(f_name, evt_data, configuration, dbsync_txn, ctx);
     }
@@ -860,6 +1124,69 @@ void fim_event_callback(void* data, void * ctx)
     }
 }
 
+static void fim_copy_stored_data(void *data, void *ctx) {
+    const fim_entry *entry = (const fim_entry *)data;
+    fim_file_data *stored = (fim_file_data *)ctx;
+
+    stored->size = entry->file_entry.data->size;
+    stored->mtime = entry->file_entry.data->mtime;
+    stored->inode = entry->file_entry.data->inode;
+    stored->dev = entry->file_entry.data->dev;
+    stored->options = entry->file_entry.data->options;
+    snprintf(stored->hash_md5, sizeof(os_md5), "%s", entry->file_entry.data->hash_md5);
+    snprintf(stored->hash_sha1, sizeof(os_sha1), "%s", entry->file_entry.data->hash_sha1);
+    snprintf(stored->hash_sha256, sizeof(os_sha256), "%s", entry->file_entry.data->hash_sha256);
+    stored->scanned = 1;
+}
+
+bool fim_hash_verify_due(const char *path) {
+    unsigned int bucket = 5381;
+
+    if (syscheck.hash_verify_scans <= 1) {
+        return true;
+    }
+
+    for (const unsigned char *it = (const unsigned char *)path; *it != '\0'; it++) {
+        bucket = bucket * 33 + *it;
+    }
+
+    return bucket % syscheck.hash_verify_scans == _scan_count % syscheck.hash_verify_scans;
+}
+
+/**
+ * @brief Gets the data stored in the FIM DB for a file whose hashes may be reused in a scheduled scan.
+ *
+ * @param path Path of the file.
+ * @param configuration Configuration block associated with the file.
+ * @param evt_data Information associated to the triggered event.
+ * @param stored Buffer for the stored size, mtime, inode, device, options and hashes.
+ * @return true if the stored data was found and its hashes can be reused if the metadata matches.
+ */
+static bool fim_get_stored_data(const char *path,
+                                const directory_t *configuration,
+                                const event_data_t *evt_data,
+                                fim_file_data *stored) {
+    callback_context_t callback_data = { .callback = fim_copy_stored_data, .context = stored };
+
+    if (!syscheck.skip_unchanged_hash || evt_data->mode != FIM_SCHEDULED) {
+        return false;
+    }
+
+    // Without size and mtime the stored row can't tell whether the content may have changed.
+    if ((configuration->options & (CHECK_SIZE | CHECK_MTIME)) != (CHECK_SIZE | CHECK_MTIME) ||
+        (configuration->options & (CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM)) == 0) {
+        return false;
+    }
+
+    if (fim_hash_verify_due(path)) {
+        return false;
+    }
+
+    memset(stored, 0, sizeof(fim_file_data));
+
+    return fim_db_get_path(path, callback_data) == FIMDB_OK && stored->scanned;
+}
+
 void fim_file(const char *path,
               const directory_t *configuration,
               event_data_t *evt_data,
@@ -870,18 +1197,36 @@ void fim_file(const char *path,
     assert(evt_data != NULL);
 
     fim_entry new_entry;
+    fim_file_data stored;
+    bool hashes_reused = false;
+    bool stored_found;
 
     check_max_fps();
 
+    stored_found = fim_get_stored_data(path, configuration, evt_data, &stored);
+
     new_entry.type = FIM_TYPE_FILE;
     new_entry.file_entry.path = (char *)path;
-    new_entry.file_entry.data = fim_get_data(path, configuration, &(evt_data->statbuf));
+    new_entry.file_entry.data = fim_get_data_reusing_hashes(path,
+                                                            configuration,
+                                                            &(evt_data->statbuf),
+                                                            stored_found ? &stored : NULL,
+                                                            &hashes_reused);
 
     if (new_entry.file_entry.data == NULL) {
         mdebug1(FIM_GET_ATTRIBUTES, path);
         return;
     }
 
+    if (txn_context != NULL && txn_context->scan_worker != NULL) {
+        fim_scan_push_result(txn_context->scan_worker, &new_entry, hashes_reused);
+        return;
+    }
+
+    if (evt_data->mode == FIM_SCHEDULED) {
+        fim_count_hashed_file(hashes_reused);
+    }
+
     if (txn_handle != NULL) {
         txn_context->latest_entry = &new_entry;
 
@@ -981,10 +1326,10 @@ void fim_process_wildcard_removed(directory_t *configuration) {
     }
 
     // Since the file doesn't exist, research if it's directory and have files in DB.
-    char pattern[PATH_MAX] = {0};
+    char prefix[PATH_MAX] = {0};
 
-    // Create the sqlite LIKE pattern -> "pathname/%"
-    snprintf(pattern, PATH_MAX, "%s%c%%", configuration->path, PATH_SEP);
+    // Every entry under "pathname/"
+    snprintf(prefix, PATH_MAX, "%s%c", configuration->path, PATH_SEP);
     get_data_ctx ctx = {
         .event = (event_data_t *)&evt_data,
         .config = configuration,
@@ -993,7 +1338,7 @@ void fim_process_wildcard_removed(directory_t *configuration) {
     callback_context_t callback_data;
     callback_data.callback = fim_db_remove_entry;
     callback_data.context = &ctx;
-    fim_db_file_pattern_search(pattern, callback_data);
+    fim_db_file_prefix_search(prefix, callback_data);
 }
 
 // Callback
@@ -1038,15 +1383,54 @@ void fim_process_missing_entry(char * pathname, fim_event_mode mode, whodata_evt
         return;
     }
     // Since the file doesn't exist, research if it's directory and have files in DB.
-    char pattern[PATH_MAX] = {0};
+    char prefix[PATH_MAX] = {0};
 
-    // Create the sqlite LIKE pattern -> "pathname/%"
-    snprintf(pattern, PATH_MAX, "%s%c%%", pathname, PATH_SEP);
+    // Every entry under "pathname/"
+    snprintf(prefix, PATH_MAX, "%s%c", pathname, PATH_SEP);
     evt_data.type = FIM_DELETE;
     ctx.event = (event_data_t *)&evt_data;
     callback_data.callback = fim_db_remove_entry;
     callback_data.context = &ctx;
-    fim_db_file_pattern_search(pattern, callback_data);
+    fim_db_file_prefix_search(prefix, callback_data);
+}
+
+// Callback
+static void fim_db_remove_missing_entry(void * data, void * ctx)
+{
+    struct stat file_stat;
+
+    if (w_stat((char *)data, &file_stat) < 0) {
+        fim_db_remove_entry(data, ctx);
+    }
+}
+
+void fim_realtime_rescan(const char *dir) {
+    event_data_t evt_data = { .mode = FIM_REALTIME, .w_evt = NULL, .report_event = true };
+    directory_t *configuration = NULL;
+    char prefix[PATH_MAX] = {0};
+
+    configuration = fim_configuration_directory(dir);
+    if (NULL == configuration) {
+        return;
+    }
+
+    // New and modified entries
+    fim_checker(dir, &evt_data, NULL, NULL, NULL);
+
+    // Entries under "dir/" that are gone
+    get_data_ctx ctx = {
+        .event = (event_data_t *)&evt_data,
+        .config = configuration,
+        .path = dir
+    };
+
+    callback_context_t callback_data;
+    callback_data.callback = fim_db_remove_missing_entry;
+    callback_data.context = &ctx;
+
+    snprintf(prefix, PATH_MAX, "%s%c", dir, PATH_SEP);
+    evt_data.type = FIM_DELETE;
+    fim_db_file_prefix_search(prefix, callback_data);
 }
 
 // Checks the DB state, sends a message alert if necessary
@@ -1232,8 +1616,20 @@ int fim_check_depth(const char *path, const directory_t *configuration) {
 
 // Get data from file
 fim_file_data *fim_get_data(const char *file, const directory_t *configuration, const struct stat *statbuf) {
+    return fim_get_data_reusing_hashes(file, configuration, statbuf, NULL, NULL);
+}
+
+fim_file_data *fim_get_data_reusing_hashes(const char *file,
+                                           const directory_t *configuration,
+                                           const struct stat *statbuf,
+                                           const fim_file_data *stored,
+                                           bool *hashes_reused) {
     fim_file_data * data = NULL;
 
+    if (hashes_reused != NULL) {
+        *hashes_reused = false;
+    }
+
     os_calloc(1, sizeof(fim_file_data), data);
     init_fim_data_entry(data);
 
@@ -1306,8 +1702,23 @@ fim_file_data *fim_get_data(const char *file, const directory_t *configuration,
     // We won't calculate hash for symbolic links, empty or large files
     if (S_ISREG(statbuf->st_mode) && (statbuf->st_size > 0 && (size_t)statbuf->st_size < syscheck.file_max_size) &&
         (configuration->options & (CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM))) {
-        if (OS_MD5_SHA1_SHA256_File(file, syscheck.prefilter_cmd, data->hash_md5,
-                                    data->hash_sha1, data->hash_sha256, OS_BINARY, syscheck.file_max_size) < 0) {
+        // The content is assumed unchanged if the file keeps its inode, device, size and mtime.
+        if (stored != NULL && stored->options == configuration->options && stored->inode == statbuf->st_ino &&
+            stored->dev == statbuf->st_dev && stored->size == data->size && stored->mtime == data->mtime) {
+            snprintf(data->hash_md5, sizeof(os_md5), "%s", stored->hash_md5);
+            snprintf(data->hash_sha1, sizeof(os_sha1), "%s", stored->hash_sha1);
+            snprintf(data->hash_sha256, sizeof(os_sha256), "%s", stored->hash_sha256);
+
+            if (hashes_reused != NULL) {
+                *hashes_reused = true;
+            }
+        } else if (OS_MD5_SHA1_SHA256_File(file,
+                                           syscheck.prefilter_cmd,
+                                           (configuration->options & CHECK_MD5SUM) ? data->hash_md5 : NULL,
+                                           (configuration->options & CHECK_SHA1SUM) ? data->hash_sha1 : NULL,
+                                           (configuration->options & CHECK_SHA256SUM) ? data->hash_sha256 : NULL,
+                                           OS_BINARY,
+                                           syscheck.file_max_size) < 0) {
             mdebug1(FIM_HASHES_FAIL, file);
             free_file_data(data);
             return NULL;
@@ -1700,18 +2111,123 @@ void free_file_data(fim_file_data * data) {
     os_free(data);
 }
 
-void fim_diff_folder_size() {
+/**
+ * @brief Walks the queue/diff/local folder
+ *
+ * @param size Size of the folder in KB
+ * @return 0 on success, -1 if the folder doesn't exist
+ */
+static int fim_diff_folder_walk(float *size) {
     char *diff_local;
+    int retval = -1;
 
     os_malloc(strlen(DIFF_DIR) + strlen("/local") + 1, diff_local);
 
     snprintf(diff_local, strlen(DIFF_DIR) + strlen("/local") + 1, "%s/local", DIFF_DIR);
 
     if (IsDir(diff_local) == 0) {
-        syscheck.diff_folder_size = DirSize(diff_local) / 1024;
+        *size = DirSize(diff_local) / 1024;
+        retval = 0;
     }
 
     os_free(diff_local);
+    return retval;
+}
+
+void fim_diff_folder_size() {
+    float size;
+
+    if (fim_diff_folder_walk(&size) == 0) {
+        syscheck.diff_folder_size = size;
+    }
+}
+
+#ifdef WIN32
+DWORD WINAPI fim_diff_folder_size_reconcile(__attribute__((unused)) void *args) {
+#else
+void *fim_diff_folder_size_reconcile(__attribute__((unused)) void *args) {
+#endif
+    float base = syscheck.diff_folder_size;
+    float size;
+
+    if (fim_diff_folder_walk(&size) == 0) {
+        // The sizes stored or removed by the scan during the walk are kept on top of it
+        syscheck.diff_folder_size = size + (syscheck.diff_folder_size - base);
+        mdebug2(FIM_DIFF_FOLDER_SIZE, DIFF_DIR, syscheck.diff_folder_size);
+    }
+
+    return 0;
+}
+
+void fim_diff_folder_size_refresh(unsigned int scan) {
+    unsigned int reconcile = syscheck.diff_size_reconcile;
+
+    // The diff store keeps the running total, the folder is only walked to correct its drift
+    if (reconcile > 1) {
+        if (scan <= 1) {
+            // The saved total may be stale if FIM stopped before saving it, the scan starts with it and a walk checks it
+            if (fim_diff_folder_size_load() == 0) {
+#ifndef WIN32
+                w_create_thread(fim_diff_folder_size_reconcile, NULL);
+#else
+                if (CreateThread(NULL, 0, fim_diff_folder_size_reconcile, NULL, 0, NULL) == NULL) {
+                    merror(THREAD_ERROR);
+                }
+#endif
+                return;
+            }
+        } else if ((scan - 1) % reconcile != 0) {
+            return;
+        }
+    }
+
+    fim_diff_folder_size();
+}
+
+int fim_diff_folder_size_load() {
+    char buffer[OS_SIZE_128];
+    char *end = NULL;
+    float size;
+    FILE *fp;
+
+    if (fp = wfopen(FIM_DIFF_SIZE_FILE, "r"), fp == NULL) {
+        return -1;
+    }
+
+    if (fgets(buffer, sizeof(buffer), fp) == NULL) {
+        fclose(fp);
+        return -1;
+    }
+
+    fclose(fp);
+    size = strtof(buffer, &end);
+
+    if (end == buffer || size < 0) {
+        return -1;
+    }
+
+    syscheck.diff_folder_size = size;
+    return 0;
+}
+
+void fim_diff_folder_size_save() {
+    char tmp_path[PATH_MAX];
+    FILE *fp;
+
+    snprintf(tmp_path, PATH_MAX, "%s.tmp", FIM_DIFF_SIZE_FILE);
+
+    if (fp = wfopen(tmp_path, "w"), fp == NULL) {
+        mdebug2(FOPEN_ERROR, tmp_path, errno, strerror(errno));
+        return;
+    }
+
+    fprintf(fp, "%f\n", syscheck.diff_folder_size);
+    fclose(fp);
+
+    if (rename_ex(tmp_path, FIM_DIFF_SIZE_FILE) != 0) {
+        mdebug2(RENAME_ERROR, tmp_path, FIM_DIFF_SIZE_FILE, errno, strerror(errno));
+        unlink(tmp_path);
+    }
 }
 
 void update_wildcards_config() {
@@ -1822,12 +2338,17 @@ void fim_print_info(struct timespec start, struct timespec end, clock_t cputime_
     unsigned inode_items = 0;
     unsigned inode_paths = 0;
 
-    inode_items = fim_db_get_count_file_inode();
-    inode_paths = fim_db_get_count_file_entry();
+    // Counting the distinct inodes scans the whole table, only do it when it will be logged
+    if (isDebug()) {
+        inode_items = fim_db_get_count_file_inode();
+        inode_paths = fim_db_get_count_file_entry();
 
-    mdebug1(FIM_INODES_INFO, inode_items, inode_paths);
+        mdebug1(FIM_INODES_INFO, inode_items, inode_paths);
+    }
 #endif
 
+    mdebug1(FIM_DB_STORAGE_INFO, fim_db_get_storage_size() / 1024, fim_db_get_memory_usage() / 1024);
+
     return;
 }
 
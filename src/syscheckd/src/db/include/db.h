@@ -31,7 +31,7 @@ extern "C" {
  * @brief Initialize the FIM database.
  *
  * It will be dbsync the responsible of managing the DB.
- * @param storage storage 1 Store database in memory, disk otherwise.
+ * @param storage storage 1 Store database in memory, 2 on disk caching up to memory_limit in memory, disk otherwise.
  * @param sync_interval Interval when the synchronization will be performed.
  * @param sync_max_interval Maximum interval allowed for the synchronization process.
  * @param sync_response_timeout Minimum interval for the synchronization process.
@@ -41,6 +41,7 @@ extern "C" {
  * @param value_limit Maximum number of registry values to be monitored.
  * @param sync_registry_enable Flag to enable the registry synchronization.
  * @param sync_queue_size Number to define the size of the queue to be synchronized.
+ * @param memory_limit Memory used to cache the hybrid database (in MB).
  *
  * @return FIMDB_OK on success, FIMDB_ERROR on error.
  */
@@ -54,7 +55,8 @@ FIMDBErrorCode fim_db_init(int storage,
                            int value_limit,
                            bool sync_registry_enabled,
                            int sync_thread_pool,
-                           unsigned int sync_queue_size);
+                           unsigned int sync_queue_size,
+                           unsigned int memory_limit);
 
 /**
  * @brief Get entry data using path.
@@ -82,6 +84,20 @@ FIMDBErrorCode fim_db_get_path(const char* file_path,
 FIMDBErrorCode fim_db_file_pattern_search(const char* pattern,
                                           callback_context_t data);
 
+/**
+ * @brief Find the entries whose path starts with a prefix.
+ *
+ * Unlike a pattern search, it is answered with a range scan of the path index.
+ *
+ * @param prefix Beginning of the paths to be searched, usually a directory followed by the path separator.
+ * @param data Pointer to the data structure where the callback context will be stored.
+ *
+ * @retval FIMDB_OK on success.
+ * @retval FIMDB_ERR on failure.
+ */
+FIMDBErrorCode fim_db_file_prefix_search(const char* prefix,
+                                         callback_context_t data);
+
 /**
  * @brief Delete entry from the DB using file path.
  *
@@ -107,6 +123,20 @@ int fim_db_get_count_file_inode();
  */
 int fim_db_get_count_file_entry();
 
+/**
+ * @brief Get the memory used by the database cache.
+ *
+ * @return Bytes of the database kept in memory.
+ */
+unsigned long long fim_db_get_memory_usage();
+
+/**
+ * @brief Get the size of the database.
+ *
+ * @return Bytes used by the database, in memory or on disk depending on the storage.
+ */
+unsigned long long fim_db_get_storage_size();
+
 /**
  * @brief Makes any necessary queries to get the entry updated in the DB.
  *
@@ -212,6 +242,35 @@ int fim_db_get_count_registry_data();
  */
 int fim_db_get_count_registry_key();
 
+/**
+ * @brief Get a registry key entry using its path and architecture.
+ *
+ * @param path Path of the key.
+ * @param arch Architecture of the key, ARCH_32BIT or ARCH_64BIT.
+ * @param data Pointer to the data structure where the callback context will be stored.
+ *
+ * @retval FIMDB_OK on success.
+ * @retval FIMDB_ERR if the key isn't stored or on failure.
+ */
+FIMDBErrorCode fim_db_get_registry_key(const char* path,
+                                       int arch,
+                                       callback_context_t data);
+
+/**
+ * @brief Get the stored values of a registry key.
+ *
+ * @param path Path of the key.
+ * @param arch Architecture of the key, ARCH_32BIT or ARCH_64BIT.
+ * @param data Pointer to the data structure where the callback context will be stored.
+ *             The callback is called once for each value.
+ *
+ * @retval FIMDB_OK on success.
+ * @retval FIMDB_ERR on failure.
+ */
+FIMDBErrorCode fim_db_get_registry_key_values(const char* path,
+                                              int arch,
+                                              callback_context_t data);
+
 #endif /* WIN32 */
 
 
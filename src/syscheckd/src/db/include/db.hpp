@@ -38,11 +38,20 @@ typedef enum COUNT_SELECT_TYPE
 typedef enum FILE_SEARCH_TYPE
 {
     SEARCH_TYPE_PATH,
-    SEARCH_TYPE_INODE
+    SEARCH_TYPE_INODE,
+    SEARCH_TYPE_PREFIX
 } FILE_SEARCH_TYPE;
 
 using SearchData = std::tuple<FILE_SEARCH_TYPE, std::string, std::string, std::string>;
 
+/**
+* @brief sqlStringLiteral Quote a value as an SQL string literal.
+*
+* @param value Value to quote.
+* @return The value between single quotes, with its single quotes doubled.
+*/
+std::string sqlStringLiteral(const std::string& value);
+
 class no_entry_found : public std::exception
 {
     public:
@@ -85,6 +94,7 @@ class EXPORTED DB final
         * @param syncRegistryEnabled Flag to enable/disable the registry sync mechanism.
         * @param syncThreadPool Number of threads used by RSync.
         * @param syncQueueSize Number to define the size of the queue to be synchronized.
+        * @param memoryLimit Memory used to cache the hybrid database, in bytes.
         */
         void init(const int storage,
                   const int syncInterval,
@@ -97,7 +107,8 @@ class EXPORTED DB final
                   int valueLimit,
                   bool syncRegistryEnabled,
                   const int syncThreadPool,
-                  const int syncQueueSize);
+                  const int syncQueueSize,
+                  const uint64_t memoryLimit);
 
         /**
         * @brief runIntegrity Execute the integrity mechanism.
@@ -153,12 +164,43 @@ class EXPORTED DB final
         * @brief countEntries Count files in the database.
         *
         * @param tableName Table name.
-        * @param selectType Type of count.
+        * @param selectType Type of count. COUNT_ALL is read from the dbsync row counter,
+        *                   COUNT_INODE scans the table.
         * @return Number of files.
         */
         int countEntries(const std::string& tableName,
                          const COUNT_SELECT_TYPE selectType);
 
+        /**
+        * @brief storageStats Get the memory and storage usage of the database.
+        *
+        * @return JSON with the cache memory used and its limit, the database size
+        *         and the cache hits, misses and spills.
+        */
+        nlohmann::json storageStats();
+
+        /**
+        * @brief getRegistryKey Get a registry key from the database.
+        *
+        * @param path Path of the key.
+        * @param arch Architecture of the key, ARCH_32BIT or ARCH_64BIT.
+        * @param callback Callback return the key data.
+        */
+        void getRegistryKey(const std::string& path,
+                            const int arch,
+                            std::function<void(const nlohmann::json&)> callback);
+
+        /**
+        * @brief getRegistryValues Get the values of a registry key from the database.
+        *
+        * @param path Path of the key.
+        * @param arch Architecture of the key, ARCH_32BIT or ARCH_64BIT.
+        * @param callback Callback return the data of each value.
+        */
+        void getRegistryValues(const std::string& path,
+                               const int arch,
+                               std::function<void(const nlohmann::json&)> callback);
+
         /**
         * @brief updateFile Update/insert a file in the database.
         *
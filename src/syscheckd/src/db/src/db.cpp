@@ -22,6 +22,51 @@
 #include "fimDBSpecialization.h"
 #include "stringHelper.h"
 #include "cjsonSmartDeleter.hpp"
+#include <map>
+
+struct TransactionContext final
+{
+    std::string table;
+    callback_data_t callbackData;
+};
+
+static std::mutex s_transactionsMutex;
+static std::map<TXN_HANDLE, std::unique_ptr<TransactionContext>> s_transactions;
+
+/**
+ * @brief Marks the table of a transaction as changed for the sync, then calls the caller callback.
+ */
+static void transactionCallback(ReturnTypeCallback resultType, const cJSON* resultJson, void* userData)
+{
+    const auto context { reinterpret_cast<TransactionContext*>(userData) };
+
+    if (INSERTED == resultType || MODIFIED == resultType || DELETED == resultType)
+    {
+        FIMDB::instance().setTableChanged(context->table);
+    }
+
+    if (context->callbackData.callback)
+    {
+        context->callbackData.callback(resultType, resultJson, context->callbackData.user_data);
+    }
+}
+
+std::string sqlStringLiteral(const std::string& value)
+{
+    std::string literal { "'" };
+
+    for (const auto c : value)
+    {
+        literal += c;
+
+        if ('\'' == c)
+        {
+            literal += c;
+        }
+    }
+
+    return literal + "'";
+}
 
 void DB::init(const int storage,
               const int syncInterval,
@@ -34,7 +79,8 @@ void DB::init(const int storage,
               const int valueLimit,
               bool syncRegistryEnabled,
               const int syncThreadPool,
-              const int syncQueueSize)
+              const int syncQueueSize,
+              const uint64_t memoryLimit)
 {
     auto path { storage == FIM_DB_MEMORY ? FIM_DB_MEMORY_PATH : FIM_DB_DISK_PATH };
     auto dbsyncHandler
@@ -43,6 +89,12 @@ void DB::init(const int storage,
                                  FIMDBCreator<OS_TYPE>::CreateStatement())
     };
 
+    // The hybrid database lives on disk, SQLite keeps the most used pages within the limit in memory.
+    if (storage == FIM_DB_HYBRID)
+    {
+        dbsyncHandler->setMemoryLimit(memoryLimit);
+    }
+
     auto rsyncHandler { std::make_shared<RemoteSync>(syncThreadPool, syncQueueSize) };
 
     FIMDB::instance().init(syncInterval,
@@ -86,6 +138,12 @@ const std::map<COUNT_SELECT_TYPE, std::vector<std::string>> COUNT_SELECT_TYPE_MA
 
 int DB::countEntries(const std::string& tableName, const COUNT_SELECT_TYPE selectType)
 {
+    // The limited tables are counted by dbsync as the rows are inserted and deleted.
+    if (COUNT_SELECT_TYPE::COUNT_ALL == selectType)
+    {
+        return FIMDB::instance().DBSyncHandler()->getTableRowCount(tableName);
+    }
+
     auto count { 0 };
     auto callback
     {
@@ -114,6 +172,14 @@ int DB::countEntries(const std::string& tableName, const COUNT_SELECT_TYPE selec
     return count;
 }
 
+nlohmann::json DB::storageStats()
+{
+    nlohmann::json stats;
+    FIMDB::instance().DBSyncHandler()->getStorageStats(stats);
+
+    return stats;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -127,7 +193,8 @@ FIMDBErrorCode fim_db_init(int storage,
                            int value_limit,
                            bool sync_registry_enabled,
                            int sync_thread_pool,
-                           unsigned int sync_queue_size)
+                           unsigned int sync_queue_size,
+                           unsigned int memory_limit)
 {
     auto retVal { FIMDBErrorCode::FIMDB_ERR };
 
@@ -252,7 +319,8 @@ FIMDBErrorCode fim_db_init(int storage,
                             value_limit,
                             sync_registry_enabled,
                             sync_thread_pool,
-                            sync_queue_size);
+                            sync_queue_size,
+                            static_cast<uint64_t>(memory_limit) * 1024 * 1024);
         retVal = FIMDBErrorCode::FIMDB_OK;
 
     }
@@ -267,6 +335,44 @@ FIMDBErrorCode fim_db_init(int storage,
     return retVal;
 }
 
+unsigned long long fim_db_get_memory_usage()
+{
+    auto usage { 0ull };
+
+    try
+    {
+        usage = DB::instance().storageStats().at("memory_used").get<unsigned long long>();
+    }
+    // LCOV_EXCL_START
+    catch (const std::exception& err)
+    {
+        FIMDB::instance().logFunction(LOG_ERROR, err.what());
+    }
+
+    // LCOV_EXCL_STOP
+
+    return usage;
+}
+
+unsigned long long fim_db_get_storage_size()
+{
+    auto size { 0ull };
+
+    try
+    {
+        size = DB::instance().storageStats().at("db_size").get<unsigned long long>();
+    }
+    // LCOV_EXCL_START
+    catch (const std::exception& err)
+    {
+        FIMDB::instance().logFunction(LOG_ERROR, err.what());
+    }
+
+    // LCOV_EXCL_STOP
+
+    return size;
+}
+
 FIMDBErrorCode fim_run_integrity()
 {
     auto retval { FIMDB_ERR };
@@ -311,11 +417,22 @@ TXN_HANDLE fim_db_transaction_start(const char* table, result_callback_t row_cal
         cJSON_Parse(table)
     };
 
-    callback_data_t cb_data = { .callback = row_callback, .user_data = user_data };
+    const auto jsTable { cJSON_GetObjectItem(jsInput.get(), "table") };
+    auto context { std::make_unique<TransactionContext>() };
+    context->table = cJSON_IsString(jsTable) ? jsTable->valuestring : "";
+    context->callbackData = { .callback = row_callback, .user_data = user_data };
+
+    callback_data_t cb_data = { .callback = transactionCallback, .user_data = context.get() };
 
     TXN_HANDLE dbsyncTxnHandle = dbsync_create_txn(DB::instance().DBSyncHandle(), jsInput.get(), 0,
                                                    QUEUE_SIZE, cb_data);
 
+    if (dbsyncTxnHandle)
+    {
+        std::lock_guard<std::mutex> lock{s_transactionsMutex};
+        s_transactions[dbsyncTxnHandle] = std::move(context);
+    }
+
     return dbsyncTxnHandle;
 }
 
@@ -362,7 +479,22 @@ FIMDBErrorCode fim_db_transaction_deleted_rows(TXN_HANDLE txn_handler,
                                                void* txn_ctx)
 {
     auto retval {FIMDB_OK};
-    callback_data_t cb_data = { .callback = res_callback, .user_data = txn_ctx };
+    std::unique_ptr<TransactionContext> context;
+
+    {
+        std::lock_guard<std::mutex> lock{s_transactionsMutex};
+        const auto it { s_transactions.find(txn_handler) };
+
+        if (it != s_transactions.end())
+        {
+            context = std::move(it->second);
+            s_transactions.erase(it);
+        }
+    }
+
+    // The row context is kept until the transaction is closed, the queued rows still use it.
+    TransactionContext deletedContext { context ? context->table : "", { .callback = res_callback, .user_data = txn_ctx } };
+    callback_data_t cb_data = { .callback = transactionCallback, .user_data = &deletedContext };
 
     if (dbsync_get_deleted_rows(txn_handler, cb_data) != 0)
     {
@@ -25,6 +25,8 @@ void RegistryValue::createFimEntry()
         {
             value->path = const_cast<char*>(m_path.c_str());
             value->hash_full_path = const_cast<char*>(m_hashpath.c_str());
+            value->arch = m_arch;
+            value->type = m_type;
             value->size = m_size;
             value->name = const_cast<char*>(m_identifier.c_str());
             std::snprintf(value->hash_md5, sizeof(value->hash_md5), "%s", m_md5.c_str());
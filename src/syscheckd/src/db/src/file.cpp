@@ -16,6 +16,7 @@
 #include "fimDB.hpp"
 #include "dbFileItem.hpp"
 #include "cjsonSmartDeleter.hpp"
+#include <climits>
 
 static const char* FIM_EVENT_TYPE_ARRAY[] =
 {
@@ -39,6 +40,28 @@ enum SEARCH_FIELDS
     SEARCH_FIELD_DEV
 };
 
+// Filter that selects the paths starting with a prefix as a range of the path index.
+// The upper bound is the prefix with its last byte incremented, so "/dir/" selects ["/dir/", "/dir0").
+static std::string prefixRangeFilter(const std::string& prefix)
+{
+    auto upperBound { prefix };
+
+    while (!upperBound.empty() && static_cast<unsigned char>(upperBound.back()) == UCHAR_MAX)
+    {
+        upperBound.pop_back();
+    }
+
+    std::string filter { "WHERE path >= " + sqlStringLiteral(prefix) };
+
+    if (!upperBound.empty())
+    {
+        upperBound.back() = static_cast<char>(static_cast<unsigned char>(upperBound.back()) + 1);
+        filter += " AND path < " + sqlStringLiteral(upperBound);
+    }
+
+    return filter;
+}
+
 nlohmann::json DB::createJsonEvent(const nlohmann::json& fileJson, const nlohmann::json& resultJson, ReturnTypeCallback type, create_json_event_ctx* ctx)
 {
     nlohmann::json jsonEvent;
@@ -425,6 +448,10 @@ void DB::searchFile(const SearchData& data, std::function<void(const std::string
     {
         filter = "WHERE path LIKE \"" + std::get<SEARCH_FIELD_PATH>(data) + "\"";
     }
+    else if (SEARCH_TYPE_PREFIX == searchType)
+    {
+        filter = prefixRangeFilter(std::get<SEARCH_FIELD_PATH>(data));
+    }
     else
     {
         throw std::runtime_error{ "Invalid search type" };
@@ -664,6 +691,38 @@ FIMDBErrorCode fim_db_file_pattern_search(const char* pattern, callback_context_
     return retVal;
 }
 
+FIMDBErrorCode fim_db_file_prefix_search(const char* prefix, callback_context_t callback)
+{
+    auto retVal { FIMDB_ERR };
+
+    if (!prefix || *prefix == '\0' || !callback.callback)
+    {
+        FIMDB::instance().logFunction(LOG_ERROR, "Invalid parameters");
+    }
+    else
+    {
+        try
+        {
+            DB::instance().searchFile(std::make_tuple(SEARCH_TYPE_PREFIX, prefix, "", ""),
+                                      [callback] (const std::string & path)
+            {
+                char* entry = const_cast<char*>(path.c_str());
+                callback.callback(entry, callback.context);
+            });
+            retVal = FIMDB_OK;
+        }
+        // LCOV_EXCL_START
+        catch (const std::exception& err)
+        {
+            FIMDB::instance().logFunction(LOG_ERROR, err.what());
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    return retVal;
+}
+
 
 #ifdef __cplusplus
 }
@@ -29,7 +29,38 @@ void FIMDB::registerRSync()
     }
 }
 
-void FIMDB::sync()
+void FIMDB::setTableChanged(const std::string& table)
+{
+    std::lock_guard<std::mutex> lock{m_changedTablesMutex};
+    m_changedTables.insert(table);
+}
+
+std::set<std::string> FIMDB::takePendingTables(const bool all)
+{
+    std::lock_guard<std::mutex> lock{m_changedTablesMutex};
+    std::set<std::string> tables;
+
+    if (all)
+    {
+        tables = { FIMDB_FILE_TABLE_NAME, FIMDB_REGISTRY_KEY_TABLENAME, FIMDB_REGISTRY_VALUE_TABLENAME };
+        m_changedTables.clear();
+    }
+    else
+    {
+        tables.swap(m_changedTables);
+    }
+
+    return tables;
+}
+
+std::chrono::seconds FIMDB::syncDelay()
+{
+    // Up to 5% of the interval later, so agents started together don't sync in lockstep.
+    std::uniform_int_distribution<uint32_t> distribution { 0, m_currentSyncInterval / 20 };
+    return std::chrono::seconds{m_currentSyncInterval + distribution(m_randomEngine)};
+}
+
+void FIMDB::sync(const std::set<std::string>& tables)
 {
     std::shared_lock<std::shared_timed_mutex> lock(m_handlersMutex);
 
@@ -40,7 +71,8 @@ void FIMDB::sync()
                                     m_dbsyncHandler->handle(),
                                     m_syncFileMessageFunction,
                                     m_syncRegistryMessageFunction,
-                                    m_syncRegistryEnabled);
+                                    m_syncRegistryEnabled,
+                                    tables);
         m_loggingFunction(LOG_DEBUG, "Finished FIM sync.");
     }
 }
@@ -48,9 +80,13 @@ void FIMDB::sync()
 void FIMDB::syncAlgorithm()
 {
     char debugmsg[1024];
+    const auto currentTime { getCurrentTime() };
 
-    if ((uint32_t)(getCurrentTime() - m_timeLastSyncMsg) > m_syncResponseTimeout)
+    if ((uint32_t)(currentTime - m_timeLastSyncMsg) > m_syncResponseTimeout)
     {
+        // The manager answered the previous sync, so any table may still differ.
+        const auto fullSync { !m_syncSuccessful || (uint32_t)(currentTime - m_timeLastFullSync) >= m_syncMaxInterval };
+
         if (m_syncSuccessful && m_currentSyncInterval > m_syncInterval)
         {
             m_currentSyncInterval = m_syncInterval;
@@ -61,7 +97,21 @@ void FIMDB::syncAlgorithm()
 
         m_syncSuccessful = true;
 
-        sync();
+        const auto tables { takePendingTables(fullSync) };
+
+        if (tables.empty())
+        {
+            m_loggingFunction(LOG_DEBUG_VERBOSE, "No changes since the previous sync. Skipped FIM sync.");
+        }
+        else
+        {
+            if (fullSync)
+            {
+                m_timeLastFullSync = currentTime;
+            }
+
+            sync(tables);
+        }
     }
     else
     {
@@ -109,6 +159,11 @@ void FIMDB::init(unsigned int syncInterval,
     m_syncMaxInterval = syncMaxInterval;
     m_currentSyncInterval = m_syncInterval;
     m_syncSuccessful = true;
+    m_timeLastFullSync = 0;
+    m_randomEngine.seed(std::random_device{}());
+    // No table has been synchronized yet.
+    std::lock_guard<std::mutex> lockChanges{m_changedTablesMutex};
+    m_changedTables = { FIMDB_FILE_TABLE_NAME, FIMDB_REGISTRY_KEY_TABLENAME, FIMDB_REGISTRY_VALUE_TABLENAME };
 }
 
 void FIMDB::removeItem(const nlohmann::json& item)
@@ -118,6 +173,11 @@ void FIMDB::removeItem(const nlohmann::json& item)
     if (!m_stopping)
     {
         m_dbsyncHandler->deleteRows(item);
+
+        if (item.contains("table"))
+        {
+            setTableChanged(item.at("table"));
+        }
     }
 }
 
@@ -127,7 +187,17 @@ void FIMDB::updateItem(const nlohmann::json& item, ResultCallbackData callbackDa
 
     if (!m_stopping)
     {
-        m_dbsyncHandler->syncRow(item, callbackData);
+        const auto table { item.contains("table") ? item.at("table").get<std::string>() : "" };
+
+        m_dbsyncHandler->syncRow(item, [this, &table, &callbackData](ReturnTypeCallback resultType, const nlohmann::json & result)
+        {
+            if (INSERTED == resultType || MODIFIED == resultType)
+            {
+                setTableChanged(table);
+            }
+
+            callbackData(resultType, result);
+        });
     }
 }
 
@@ -148,11 +218,12 @@ void FIMDB::runIntegrity()
         m_integrityThread = std::thread([&]()
         {
             m_loggingFunction(LOG_INFO, "FIM sync module started.");
-            sync();
+            m_timeLastFullSync = getCurrentTime();
+            sync(takePendingTables(true));
             promise->set_value();
             std::unique_lock<std::mutex> lockCv{m_fimSyncMutex};
 
-            while (!m_cv.wait_for(lockCv, std::chrono::seconds{m_currentSyncInterval}, [&]()
+            while (!m_cv.wait_for(lockCv, syncDelay(), [&]()
         {
             return m_stopping;
         }))
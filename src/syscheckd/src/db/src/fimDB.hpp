@@ -16,6 +16,8 @@
 #include "stringHelper.h"
 #include <condition_variable>
 #include <mutex>
+#include <random>
+#include <set>
 #include <thread>
 #include <shared_mutex>
 
@@ -169,6 +171,13 @@ class FIMDB
          */
         void registerRSync();
 
+        /**
+         * @brief Mark a table as changed, so the next synchronization checks it.
+         *
+         * @param table Name of the table that had an insertion, modification or deletion.
+         */
+        void setTableChanged(const std::string& table);
+
         /**
          * @brief Push a syscheck synchronization message to the rsync queue
          *
@@ -258,6 +267,10 @@ class FIMDB
 
         /**
         * @brief Execute the sync algorithm to avoid overlaping differents syncs.
+        *
+        * After a successful sync only the tables changed since then are synchronized, and none
+        * if there are no changes. Every table is checked again when the manager answered the
+        * previous sync or when the maximum interval has passed since the last full sync.
         */
         void syncAlgorithm();
 
@@ -288,11 +301,33 @@ class FIMDB
         uint32_t                                                                m_currentSyncInterval;
         bool                                                                    m_syncSuccessful;
         std::time_t                                                             m_timeLastSyncMsg;
+        std::time_t                                                             m_timeLastFullSync;
+        std::mutex                                                              m_changedTablesMutex;
+        std::set<std::string>                                                   m_changedTables;
+        std::default_random_engine                                              m_randomEngine;
 
         /**
         * @brief Function that executes the synchronization of the databases with the manager
+        *
+        * @param tables Tables to synchronize.
+        */
+        void sync(const std::set<std::string>& tables);
+
+        /**
+        * @brief Take the tables pending of synchronization, leaving none pending.
+        *
+        * @param all Take every table, changed or not.
+        *
+        * @return Tables to synchronize.
+        */
+        std::set<std::string> takePendingTables(const bool all);
+
+        /**
+        * @brief Delay until the next sync: the current interval plus up to a 5% of it.
+        *
+        * @return Seconds to wait.
         */
-        void sync();
+        std::chrono::seconds syncDelay();
 
     protected:
         FIMDB() = default;
@@ -240,7 +240,8 @@ class FIMDBCreator final
         static void sync(__attribute__((unused)) std::shared_ptr<RemoteSync> RSyncHandler,
                          __attribute__((unused)) const DBSYNC_HANDLE& handle,
                          __attribute__((unused)) std::function<void(const std::string&)> syncFileMessageFunction,
-                         __attribute__((unused)) std::function<void(const std::string&)> syncRegistryMessageFunction)
+                         __attribute__((unused)) std::function<void(const std::string&)> syncRegistryMessageFunction,
+                         __attribute__((unused)) const std::set<std::string>& tables)
         {
             throw std::runtime_error
             {
@@ -310,20 +311,31 @@ class FIMDBCreator<OSType::WINDOWS> final
                          const DBSYNC_HANDLE& handle,
                          std::function<void(const std::string&)> syncFileMessageFunction,
                          __attribute__((unused)) std::function<void(const std::string&)> syncRegistryMessageFunction,
-                         const bool syncRegistryEnabled)
+                         const bool syncRegistryEnabled,
+                         const std::set<std::string>& tables)
         {
-            RSyncHandler->startSync(handle,
-                                    nlohmann::json::parse(FIM_FILE_START_CONFIG_STATEMENT),
-                                    syncFileMessageFunction);
+            if (tables.count(FIMDB_FILE_TABLE_NAME))
+            {
+                RSyncHandler->startSync(handle,
+                                        nlohmann::json::parse(FIM_FILE_START_CONFIG_STATEMENT),
+                                        syncFileMessageFunction);
+            }
 
             if (syncRegistryEnabled)
             {
-                RSyncHandler->startSync(handle,
-                                        nlohmann::json::parse(FIM_REGISTRY_START_CONFIG_STATEMENT),
-                                        syncRegistryMessageFunction);
-                RSyncHandler->startSync(handle,
-                                        nlohmann::json::parse(FIM_VALUE_START_CONFIG_STATEMENT),
-                                        syncRegistryMessageFunction);
+                if (tables.count(FIMDB_REGISTRY_KEY_TABLENAME))
+                {
+                    RSyncHandler->startSync(handle,
+                                            nlohmann::json::parse(FIM_REGISTRY_START_CONFIG_STATEMENT),
+                                            syncRegistryMessageFunction);
+                }
+
+                if (tables.count(FIMDB_REGISTRY_VALUE_TABLENAME))
+                {
+                    RSyncHandler->startSync(handle,
+                                            nlohmann::json::parse(FIM_VALUE_START_CONFIG_STATEMENT),
+                                            syncRegistryMessageFunction);
+                }
             }
         }
 
@@ -365,11 +377,15 @@ class FIMDBCreator<OSType::OTHERS> final
                          const DBSYNC_HANDLE& handle,
                          std::function<void(const std::string&)> syncFileMessageFunction,
                          __attribute__((unused)) std::function<void(const std::string&)> syncRegistryMessageFunction,
-                         __attribute__((unused)) const bool syncRegistryEnabled)
+                         __attribute__((unused)) const bool syncRegistryEnabled,
+                         const std::set<std::string>& tables)
         {
-            RSyncHandler->startSync(handle,
-                                    nlohmann::json::parse(FIM_FILE_START_CONFIG_STATEMENT),
-                                    syncFileMessageFunction);
+            if (tables.count(FIMDB_FILE_TABLE_NAME))
+            {
+                RSyncHandler->startSync(handle,
+                                        nlohmann::json::parse(FIM_FILE_START_CONFIG_STATEMENT),
+                                        syncFileMessageFunction);
+            }
         }
 
         static void encodeString(__attribute__((unused)) std::string& stringToEncode){}
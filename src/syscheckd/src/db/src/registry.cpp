@@ -23,6 +23,120 @@
 #include "db.h"
 #include "db.hpp"
 
+// Filter that selects the rows of a registry key and architecture.
+static std::string registryKeyFilter(std::string path, const int arch)
+{
+    FIMDBCreator<OS_TYPE>::encodeString(path);
+
+    return "WHERE path=" + sqlStringLiteral(path) + " AND arch=" + sqlStringLiteral(arch == ARCH_32BIT ? "[x32]" : "[x64]");
+}
+
+// The registry tables store the architecture as text and have no mode column.
+static nlohmann::json registryItemFromRow(nlohmann::json row)
+{
+    row["arch"] = row.at("arch") == "[x32]" ? ARCH_32BIT : ARCH_64BIT;
+    row["mode"] = FIM_SCHEDULED;
+
+    return row;
+}
+
+static std::vector<nlohmann::json> selectRegistryRows(const std::string& table,
+                                                      const std::vector<std::string>& columns,
+                                                      const std::string& filter)
+{
+    auto selectQuery
+    {
+        SelectQuery::builder()
+        .table(table)
+        .columnList(columns)
+        .rowFilter(filter)
+        .orderByOpt("")
+        .distinctOpt(false)
+        .build()
+    };
+
+    std::vector<nlohmann::json> rows;
+    const auto internalCallback
+    {
+        [&rows](ReturnTypeCallback type, const nlohmann::json & jsonResult)
+        {
+            if (ReturnTypeCallback::SELECTED == type)
+            {
+                rows.push_back(registryItemFromRow(jsonResult));
+            }
+        }
+    };
+
+    FIMDB::instance().executeQuery(selectQuery.query(), internalCallback);
+
+    return rows;
+}
+
+void DB::getRegistryKey(const std::string& path,
+                        const int arch,
+                        std::function<void(const nlohmann::json&)> callback)
+{
+    const auto rows
+    {
+        selectRegistryRows(FIMDB_REGISTRY_KEY_TABLENAME,
+        {
+            "path",
+            "perm",
+            "uid",
+            "gid",
+            "user_name",
+            "group_name",
+            "mtime",
+            "arch",
+            "scanned",
+            "last_event",
+            "checksum",
+            "hash_full_path"
+        },
+        registryKeyFilter(path, arch))
+    };
+
+    if (rows.size() == 1)
+    {
+        callback(rows.front());
+    }
+    else
+    {
+        throw no_entry_found { "No entry found for " + path};
+    }
+}
+
+void DB::getRegistryValues(const std::string& path,
+                           const int arch,
+                           std::function<void(const nlohmann::json&)> callback)
+{
+    // The rows are gathered first so the callback can use the database.
+    const auto rows
+    {
+        selectRegistryRows(FIMDB_REGISTRY_VALUE_TABLENAME,
+        {
+            "path",
+            "arch",
+            "name",
+            "type",
+            "size",
+            "hash_md5",
+            "hash_sha1",
+            "hash_sha256",
+            "scanned",
+            "last_event",
+            "checksum",
+            "hash_full_path"
+        },
+        registryKeyFilter(path, arch))
+    };
+
+    for (const auto& row : rows)
+    {
+        callback(row);
+    }
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -65,6 +179,72 @@ int fim_db_get_count_registry_data()
     return count;
 }
 
+FIMDBErrorCode fim_db_get_registry_key(const char* path, int arch, callback_context_t callback)
+{
+    auto retVal { FIMDB_ERR };
+
+    if (!path || !callback.callback)
+    {
+        FIMDB::instance().logFunction(LOG_ERROR, "Invalid parameters");
+    }
+    else
+    {
+        try
+        {
+            DB::instance().getRegistryKey(path, arch, [&callback](const nlohmann::json & jsonResult)
+            {
+                const auto key { std::make_unique<RegistryKey>(jsonResult) };
+                callback.callback(key->toFimEntry(), callback.context);
+            });
+            retVal = FIMDB_OK;
+        }
+        catch (const no_entry_found& err)
+        {
+            FIMDB::instance().logFunction(LOG_DEBUG_VERBOSE, err.what());
+        }
+        // LCOV_EXCL_START
+        catch (const std::exception& err)
+        {
+            FIMDB::instance().logFunction(LOG_ERROR, err.what());
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    return retVal;
+}
+
+FIMDBErrorCode fim_db_get_registry_key_values(const char* path, int arch, callback_context_t callback)
+{
+    auto retVal { FIMDB_ERR };
+
+    if (!path || !callback.callback)
+    {
+        FIMDB::instance().logFunction(LOG_ERROR, "Invalid parameters");
+    }
+    else
+    {
+        try
+        {
+            DB::instance().getRegistryValues(path, arch, [&callback](const nlohmann::json & jsonResult)
+            {
+                const auto value { std::make_unique<RegistryValue>(jsonResult) };
+                callback.callback(value->toFimEntry(), callback.context);
+            });
+            retVal = FIMDB_OK;
+        }
+        // LCOV_EXCL_START
+        catch (const std::exception& err)
+        {
+            FIMDB::instance().logFunction(LOG_ERROR, err.what());
+        }
+
+        // LCOV_EXCL_STOP
+    }
+
+    return retVal;
+}
+
 #ifdef __cplusplus
 }
 #endif
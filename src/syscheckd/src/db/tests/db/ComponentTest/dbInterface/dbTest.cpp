@@ -84,6 +84,18 @@ TEST_F(DBTestFixture, TestFimDBInit)
     });
 }
 
+TEST_F(DBTestFixture, TestFimDBStorageUsage)
+{
+    const auto fileFIMTest { std::make_unique<FileItem>(insertFileStatement) };
+
+    EXPECT_NO_THROW(
+    {
+        ASSERT_EQ(fim_db_file_update(fileFIMTest->toFimEntry(), callback_data_added), FIMDB_OK);
+        ASSERT_GT(fim_db_get_memory_usage(), 0ull);
+        ASSERT_GT(fim_db_get_storage_size(), 0ull);
+    });
+}
+
 TEST_F(DBTestFixture, TestFimSyncPushMsg)
 {
     const auto test{R"(fim_file no_data {"begin":"a2fbef8f81af27155dcee5e3927ff6243593b91a","end":"a2fbef8f81af27155dcee5e3927ff6243593b91b","id":1})"};
@@ -237,6 +249,7 @@ TEST(DBTest, TestInvalidFimLimit)
                     -1,
                     true,
                     0,
+                    0,
                     0)
     };
     ASSERT_EQ(result, FIMDB_ERR);
@@ -262,6 +275,7 @@ TEST(DBTest, TestValidFimLimit)
                     100000,
                     true,
                     0,
+                    0,
                     0)
     };
     ASSERT_EQ(result, FIMDB_OK);
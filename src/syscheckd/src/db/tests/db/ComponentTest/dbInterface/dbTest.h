@@ -90,6 +90,7 @@ class DBTestFixture : public testing::Test {
                         100000,
                         true,
                         1,
+                        0,
                         0);
 
             evt_data = {};
@@ -84,6 +84,12 @@ static void callbackTestSearchPath(void* return_data, void* user_data)
     ASSERT_EQ(std::strcmp(returnPath, path), 0);
 }
 
+static void callbackTestSearchCount(void* return_data, void* user_data)
+{
+    ASSERT_TRUE(return_data);
+    ++*static_cast<int*>(user_data);
+}
+
 static void callBackTestFIMEntry(void* return_data, void* user_data)
 {
     fim_entry *entry = (fim_entry *) user_data;
@@ -331,6 +337,63 @@ TEST_F(DBTestFixture, TestFimDBFilePatternSearchNullParameters)
     });
 }
 
+TEST_F(DBTestFixture, TestFimDBFilePrefixSearch)
+{
+    const auto fileFIMTest1 { std::make_unique<FileItem>(insertStatement1["data"].front()) };
+    const auto fileFIMTest2 { std::make_unique<FileItem>(insertStatement2["data"].front()) };
+    const auto fileFIMTest3 { std::make_unique<FileItem>(insertStatement3["data"].front()) };
+
+    EXPECT_NO_THROW(
+    {
+        auto result = fim_db_file_update(fileFIMTest1->toFimEntry(), callback_data_added);
+        ASSERT_EQ(result, FIMDB_OK);
+        result = fim_db_file_update(fileFIMTest2->toFimEntry(), callback_data_added);
+        ASSERT_EQ(result, FIMDB_OK);
+        result = fim_db_file_update(fileFIMTest3->toFimEntry(), callback_data_added);
+        ASSERT_EQ(result, FIMDB_OK);
+        auto count { 0 };
+        callback_context_t callback_data;
+        callback_data.callback = callbackTestSearchCount;
+        callback_data.context = &count;
+        result = fim_db_file_prefix_search("/tmp/", callback_data);
+        ASSERT_EQ(result, FIMDB_OK);
+        ASSERT_EQ(count, 2);
+        count = 0;
+        result = fim_db_file_prefix_search("/tmp/test2", callback_data);
+        ASSERT_EQ(result, FIMDB_OK);
+        ASSERT_EQ(count, 1);
+        count = 0;
+        // Unlike LIKE patterns, '_' and '%' are plain characters and the case matters
+        result = fim_db_file_prefix_search("/tmp/test_", callback_data);
+        ASSERT_EQ(result, FIMDB_OK);
+        ASSERT_EQ(count, 0);
+        result = fim_db_file_prefix_search("/TMP/", callback_data);
+        ASSERT_EQ(result, FIMDB_OK);
+        ASSERT_EQ(count, 0);
+        char *test;
+        test = strdup("/etc/wgetrc");
+        callback_data.callback = callbackTestSearchPath;
+        callback_data.context = test;
+        result = fim_db_file_prefix_search("/etc/", callback_data);
+        ASSERT_EQ(result, FIMDB_OK);
+        os_free(test);
+    });
+}
+
+TEST_F(DBTestFixture, TestFimDBFilePrefixSearchNullParameters)
+{
+    callback_context_t callback_data{};
+    callback_data.callback = callbackTestSearch;
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_ERROR, "Invalid parameters")).Times(testing::AtLeast(3));
+    EXPECT_NO_THROW(
+    {
+               ASSERT_EQ(fim_db_file_prefix_search(nullptr, callback_data), FIMDB_ERR);
+               ASSERT_EQ(fim_db_file_prefix_search("", callback_data), FIMDB_ERR);
+               callback_data.callback = nullptr;
+               ASSERT_EQ(fim_db_file_prefix_search("/tmp/", callback_data), FIMDB_ERR);
+    });
+}
+
 TEST_F(DBTestFixture, TestFimDBFileINodeSearchNullParameter)
 {
     callback_context_t callback_data{};
@@ -153,3 +153,57 @@ TEST_F(DBTestFixture, TestFimDBGetCountRegistryValueEntry)
         ASSERT_EQ(result, 0);
     });
 }
+
+TEST_F(DBTestFixture, TestFimDBGetRegistryKeyAndValues)
+{
+    EXPECT_NO_THROW(
+    {
+        auto keyHandler = fim_db_transaction_start(FIMDB_REGISTRY_KEY_TXN_TABLE, transaction_callback, &txn_ctx);
+        ASSERT_TRUE(keyHandler);
+        auto valueHandler = fim_db_transaction_start(FIMDB_REGISTRY_VALUE_TXN_TABLE, transaction_callback, &txn_ctx);
+        ASSERT_TRUE(valueHandler);
+
+        const auto registryKeyFIMTest { std::make_unique<RegistryKey>(insertRegistryKeyStatement1) };
+        ASSERT_EQ(fim_db_transaction_sync_row(keyHandler, registryKeyFIMTest->toFimEntry()), FIMDB_OK);
+
+        auto valueStatement = insertRegistryValueStatement1;
+        valueStatement["arch"] = 1;
+        const auto registryValueFIMTest { std::make_unique<RegistryValue>(valueStatement) };
+        ASSERT_EQ(fim_db_transaction_sync_row(valueHandler, registryValueFIMTest->toFimEntry()), FIMDB_OK);
+
+        time_t mtime { 0 };
+        callback_context_t keyCallback
+        {
+            [](void* data, void* ctx)
+            {
+                *static_cast<time_t*>(ctx) = static_cast<fim_entry*>(data)->registry_entry.key->mtime;
+            },
+            &mtime
+        };
+        ASSERT_EQ(fim_db_get_registry_key("HKEY_LOCAL_MACHINE\\SOFTWARE\\regtest1", 1, keyCallback), FIMDB_OK);
+        ASSERT_EQ(mtime, 1578075431);
+        ASSERT_EQ(fim_db_get_registry_key("HKEY_LOCAL_MACHINE\\SOFTWARE\\regtest1", 0, keyCallback), FIMDB_ERR);
+
+        std::vector<std::string> names;
+        callback_context_t valueCallback
+        {
+            [](void* data, void* ctx)
+            {
+                const auto value { static_cast<fim_entry*>(data)->registry_entry.value };
+                ASSERT_EQ(value->arch, 1);
+                ASSERT_EQ(value->size, 4925u);
+                static_cast<std::vector<std::string>*>(ctx)->push_back(value->name);
+            },
+            &names
+        };
+        ASSERT_EQ(fim_db_get_registry_key_values("HKEY_LOCAL_MACHINE\\SOFTWARE\\regtest1", 1, valueCallback), FIMDB_OK);
+        ASSERT_EQ(names, std::vector<std::string> { "testRegistry1" });
+
+        names.clear();
+        ASSERT_EQ(fim_db_get_registry_key_values("HKEY_LOCAL_MACHINE\\SOFTWARE\\regtest2", 1, valueCallback), FIMDB_OK);
+        ASSERT_TRUE(names.empty());
+
+        ASSERT_EQ(fim_db_transaction_deleted_rows(valueHandler, transaction_callback, &txn_ctx), FIMDB_OK);
+        ASSERT_EQ(fim_db_transaction_deleted_rows(keyHandler, transaction_callback, &txn_ctx), FIMDB_OK);
+    });
+}
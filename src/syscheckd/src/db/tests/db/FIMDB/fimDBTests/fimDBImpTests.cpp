@@ -18,6 +18,11 @@
 
 constexpr auto MOCK_DB_PATH {"temp_fimdb_ut.db"};
 constexpr auto MOCK_DB_MEM {":memory:"};
+#ifdef WIN32
+constexpr auto SYNC_TABLES {3};
+#else
+constexpr auto SYNC_TABLES {1};
+#endif
 MockLoggingCall* mockLog;
 MockSyncMsg* mockSync;
 
@@ -264,6 +269,7 @@ TEST_F(FimDBFixture, loopRSyncSuccess)
     std::mutex test_mutex;
 
     EXPECT_CALL(*mockLog, loggingFunction(LOG_INFO, "FIM sync module started."));
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(15));
     EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Executing FIM sync."));
     EXPECT_CALL(*mockRSync, startSync(testing::_, testing::_, testing::_)).Times(testing::AtLeast(1));
     EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Finished FIM sync."));
@@ -297,6 +303,68 @@ TEST_F(FimDBFixture, syncAlgorithmLoop)
     fimDBMock.syncAlgorithm();
 }
 
+TEST_F(FimDBFixture, syncAlgorithmSkipWithoutChanges)
+{
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(15)).WillOnce(testing::Return(60));
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Executing FIM sync."));
+    EXPECT_CALL(*mockRSync, startSync(testing::_, testing::_, testing::_)).Times(SYNC_TABLES);
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Finished FIM sync."));
+
+    fimDBMock.setTimeLastSyncMsg();
+    fimDBMock.syncAlgorithm();
+
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(60)).WillOnce(testing::Return(1000));
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG_VERBOSE, "No changes since the previous sync. Skipped FIM sync."));
+
+    fimDBMock.setTimeLastSyncMsg();
+    fimDBMock.syncAlgorithm();
+}
+
+TEST_F(FimDBFixture, syncAlgorithmChangedTable)
+{
+    const nlohmann::json itemJson { {"table", FIMDB_FILE_TABLE_NAME} };
+    ResultCallbackData callback { [](ReturnTypeCallback, const nlohmann::json&) {} };
+
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(15)).WillOnce(testing::Return(60));
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Executing FIM sync.")).Times(2);
+    // Only the changed table is synchronized the second time.
+    EXPECT_CALL(*mockRSync, startSync(testing::_, testing::_, testing::_)).Times(SYNC_TABLES + 1);
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Finished FIM sync.")).Times(2);
+
+    fimDBMock.setTimeLastSyncMsg();
+    fimDBMock.syncAlgorithm();
+
+    EXPECT_CALL(*mockDBSync, syncRow(itemJson, testing::_)).WillOnce(testing::Invoke([](const nlohmann::json&, ResultCallbackData result)
+    {
+        result(MODIFIED, {});
+    }));
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(60)).WillOnce(testing::Return(1000));
+
+    fimDBMock.updateItem(itemJson, callback);
+    fimDBMock.setTimeLastSyncMsg();
+    fimDBMock.syncAlgorithm();
+}
+
+TEST_F(FimDBFixture, syncAlgorithmAfterManagerMessages)
+{
+    const std::string data("testing msg");
+
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(15)).WillOnce(testing::Return(60));
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Executing FIM sync.")).Times(2);
+    EXPECT_CALL(*mockRSync, startSync(testing::_, testing::_, testing::_)).Times(SYNC_TABLES * 2);
+    EXPECT_CALL(*mockLog, loggingFunction(LOG_DEBUG, "Finished FIM sync.")).Times(2);
+
+    fimDBMock.setTimeLastSyncMsg();
+    fimDBMock.syncAlgorithm();
+
+    // The manager answered the sync, so every table is checked even without changes.
+    EXPECT_CALL(*mockRSync, pushMessage(testing::_));
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(100)).WillOnce(testing::Return(1000));
+
+    fimDBMock.pushMessage(data);
+    fimDBMock.syncAlgorithm();
+}
+
 TEST_F(FimDBFixture, executeQuerySuccess)
 {
     nlohmann::json itemJson;
@@ -364,6 +432,7 @@ TEST(FimDB, notInitalizedDbSyncException)
 TEST_F(FimDBFixture, loopRSyncInvalidCallOrder)
 {
     EXPECT_CALL(*mockLog, loggingFunction(LOG_INFO, "FIM sync module started."));
+    EXPECT_CALL(fimDBMock, getCurrentTime()).WillOnce(testing::Return(15));
     fimDBMock.stopIntegrity();
     fimDBMock.runIntegrity();
 }
@@ -54,6 +54,7 @@ int main(int argc, const char* argv[])
             const auto syncMaxInterval{ jsonConfigFile.at("sync_max_interval").get<const uint32_t>() };
             const auto syncThreadPool{ jsonConfigFile.at("thread_pool").get<const uint32_t>() };
             const auto syncQueueSize{ jsonConfigFile.at("queue_size").get<const uint32_t>() };
+            const auto memoryLimit{ jsonConfigFile.value("memory_limit", 0u) };
 
             std::function<void(const std::string&)> callbackSyncFileWrapper
             {
@@ -92,7 +93,8 @@ int main(int argc, const char* argv[])
                                     registryLimit,
                                     syncRegistryEnabled,
                                     syncThreadPool,
-                                    syncQueueSize);
+                                    syncQueueSize,
+                                    static_cast<uint64_t>(memoryLimit) * 1024 * 1024);
 
                 std::unique_ptr<TestContext> testContext { std::make_unique<TestContext>()};
                 testContext->outputPath = cmdLineArgs.outputFolder();
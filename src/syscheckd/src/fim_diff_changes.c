@@ -9,6 +9,7 @@
 
 #include "shared.h"
 #include "os_crypto/md5/md5_op.h"
+#include "os_zlib/os_zlib.h"
 #include "syscheck.h"
 
 
@@ -184,6 +185,125 @@ char* filter(const char *string);
  */
 void save_compress_file(const diff_data *diff);
 
+#ifndef WIN32
+
+#define FIM_CHUNK_MIN_SIZE 2048
+#define FIM_CHUNK_AVG_SIZE 8192
+#define FIM_CHUNK_MAX_SIZE 65536
+#define FIM_CHUNK_MASK_SMALL 0x0003590703530000ULL  // 15 bits, used before the average size
+#define FIM_CHUNK_MASK_LARGE 0x0000d90003530000ULL  // 11 bits, used after the average size
+#define FIM_DIFF_MAX_EDITS 2048                     // Line edits computed in memory before running diff
+#define FIM_CHUNKS_MANIFEST "last-entry.chunks"
+
+static uint64_t fim_chunk_gear[256];
+static pthread_once_t fim_chunk_gear_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t fim_chunks_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool fim_chunks_released = false;
+
+/**
+ * @brief Chunk of a file stored in the chunk store
+ */
+typedef struct fim_chunk {
+    os_sha1 id;     // SHA-1 of the chunk content
+    size_t length;  // Uncompressed length
+} fim_chunk;
+
+/**
+ * @brief Line of a file being compared
+ */
+typedef struct fim_diff_line {
+    const char *text;   // Start of the line, including its newline if there is one
+    size_t length;
+    int equiv;          // Lines with the same content share this number
+} fim_diff_line;
+
+/**
+ * @brief Finds where the next chunk ends using content-defined chunking (gear rolling hash)
+ *
+ * The same content produces the same boundaries wherever it is in the file, so an insertion only
+ * changes the chunks around it.
+ *
+ * @param data Data to split
+ * @param length Length of the data
+ *
+ * @return Length of the next chunk
+ */
+size_t fim_diff_next_chunk(const char *data, size_t length);
+
+/**
+ * @brief Splits data in chunks and computes their identifiers
+ *
+ * @param data Data to split
+ * @param length Length of the data
+ * @param count Returns the number of chunks
+ *
+ * @return Array of chunks, to be freed by the caller
+ */
+fim_chunk *fim_diff_split_chunks(const char *data, size_t length, size_t *count);
+
+/**
+ * @brief Reads the list of chunks of the last stored version of a file
+ *
+ * @param path Path of the manifest
+ * @param count Returns the number of chunks
+ *
+ * @return Array of chunks, NULL if there is no stored version
+ */
+fim_chunk *fim_diff_read_manifest(const char *path, size_t *count);
+
+/**
+ * @brief Rebuilds the content of a file from the chunk store
+ *
+ * @param chunks Chunks of the file
+ * @param count Number of chunks
+ * @param length Returns the length of the content
+ *
+ * @return Content of the file, NULL if a chunk is missing or damaged
+ */
+char *fim_diff_load_chunks(const fim_chunk *chunks, size_t count, size_t *length);
+
+/**
+ * @brief Stores the chunks missing in the store and writes the manifest of the file
+ *
+ * @param diff Structure with all the data necessary to compute differences
+ * @param data Content of the file
+ * @param chunks Chunks of the content
+ * @param count Number of chunks
+ *
+ * @return 0 on success, -1 on error or if the disk quota would be exceeded
+ */
+int fim_diff_save_chunks(const diff_data *diff, const char *data, const fim_chunk *chunks, size_t count);
+
+/**
+ * @brief Computes the differences between two contents in the normal format of diff
+ *
+ * @param old_data Stored content
+ * @param old_length Length of the stored content
+ * @param new_data Current content
+ * @param new_length Length of the current content
+ * @param diff Structure with all the data necessary to compute differences
+ * @param diff_str Returns the differences, truncated as the output of diff
+ *
+ * @return 0 on success, -1 if the contents are too different to be compared in memory
+ */
+int fim_diff_lines(const char *old_data,
+                   size_t old_length,
+                   const char *new_data,
+                   size_t new_length,
+                   const diff_data *diff,
+                   char **diff_str);
+
+/**
+ * @brief Generates the diff of a file stored as chunks
+ *
+ * @param diff Structure with all the data necessary to compute differences
+ *
+ * @return String with the diff to add to the alert
+ */
+char *fim_diff_chunked_file(const diff_data *diff);
+
+#endif
+
 #ifdef WIN32
 
 /**
@@ -411,6 +531,13 @@ char *fim_file_diff(const char *filename, const directory_t *configuration) {
         goto cleanup;
     }
 
+#ifndef WIN32
+    if (syscheck.diff_chunking) {
+        diff_changes = fim_diff_chunked_file(diff);
+        goto cleanup;
+    }
+#endif
+
     // If the file is not there, create compressed file and return.
     if (w_uncompress_gzfile(diff->compress_file, diff->uncompress_file) != 0) {
         if (fim_diff_create_compress_file(diff) == 0){
@@ -574,6 +701,15 @@ int fim_diff_delete_compress_folder(const char *folder) {
         }
     }
 
+#ifndef WIN32
+    if (syscheck.diff_chunking) {
+        // The chunks of the deleted version are removed by the next collection
+        w_mutex_lock(&fim_chunks_mutex);
+        fim_chunks_released = true;
+        w_mutex_unlock(&fim_chunks_mutex);
+    }
+#endif
+
     if (remove_empty_folders(folder) == -1) {
         return -1;
     }
@@ -1002,3 +1138,1202 @@ void fim_diff_process_delete_value(const char *key_name, const char *value_name,
     return;
 }
 #endif
+
+#ifndef WIN32
+
+// The table must not change between runs or the stored chunks wouldn't match the new ones
+static void fim_chunk_gear_init() {
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < 256; i++) {
+        // splitmix64
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        fim_chunk_gear[i] = z ^ (z >> 31);
+    }
+}
+
+size_t fim_diff_next_chunk(const char *data, size_t length) {
+    const size_t normal = length < FIM_CHUNK_AVG_SIZE ? length : FIM_CHUNK_AVG_SIZE;
+    const size_t max = length < FIM_CHUNK_MAX_SIZE ? length : FIM_CHUNK_MAX_SIZE;
+    uint64_t fingerprint = 0;
+    size_t i;
+
+    if (length <= FIM_CHUNK_MIN_SIZE) {
+        return length;
+    }
+
+    pthread_once(&fim_chunk_gear_once, fim_chunk_gear_init);
+
+    for (i = FIM_CHUNK_MIN_SIZE; i < normal; i++) {
+        fingerprint = (fingerprint << 1) + fim_chunk_gear[(unsigned char)data[i]];
+
+        if (!(fingerprint & FIM_CHUNK_MASK_SMALL)) {
+            return i + 1;
+        }
+    }
+
+    for (; i < max; i++) {
+        fingerprint = (fingerprint << 1) + fim_chunk_gear[(unsigned char)data[i]];
+
+        if (!(fingerprint & FIM_CHUNK_MASK_LARGE)) {
+            return i + 1;
+        }
+    }
+
+    return i;
+}
+
+fim_chunk *fim_diff_split_chunks(const char *data, size_t length, size_t *count) {
+    fim_chunk *chunks = NULL;
+    size_t offset = 0;
+    size_t size = 0;
+
+    *count = 0;
+    os_calloc(1, sizeof(fim_chunk), chunks);
+
+    while (offset < length) {
+        size_t chunk_length = fim_diff_next_chunk(data + offset, length - offset);
+
+        if (*count == size) {
+            size = size ? size * 2 : 16;
+            os_realloc(chunks, size * sizeof(fim_chunk), chunks);
+        }
+
+        OS_SHA1_Str(data + offset, chunk_length, chunks[*count].id);
+        chunks[*count].length = chunk_length;
+        (*count)++;
+        offset += chunk_length;
+    }
+
+    return chunks;
+}
+
+fim_chunk *fim_diff_read_manifest(const char *path, size_t *count) {
+    char line[OS_SIZE_128];
+    fim_chunk *chunks = NULL;
+    size_t size = 16;
+    char *end = NULL;
+    FILE *fp;
+
+    *count = 0;
+
+    if (fp = wfopen(path, "r"), fp == NULL) {
+        return NULL;
+    }
+
+    os_calloc(size, sizeof(fim_chunk), chunks);
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        // <sha1> <length>
+        if (strlen(line) < sizeof(os_sha1) + 1 || line[sizeof(os_sha1) - 1] != ' ') {
+            goto error;
+        }
+
+        if (*count == size) {
+            size *= 2;
+            os_realloc(chunks, size * sizeof(fim_chunk), chunks);
+        }
+
+        memcpy(chunks[*count].id, line, sizeof(os_sha1) - 1);
+        chunks[*count].id[sizeof(os_sha1) - 1] = '\0';
+        chunks[*count].length = strtoul(line + sizeof(os_sha1), &end, 10);
+
+        if (chunks[*count].length == 0 || (*end != '\n' && *end != '\0')) {
+            goto error;
+        }
+
+        (*count)++;
+    }
+
+    fclose(fp);
+    return chunks;
+
+error:
+    mdebug1(FIM_DIFF_CHUNKS_MANIFEST_INVALID, path);
+    fclose(fp);
+    os_free(chunks);
+    *count = 0;
+    return NULL;
+}
+
+char *fim_diff_load_chunks(const fim_chunk *chunks, size_t count, size_t *length) {
+    char path[PATH_MAX];
+    char *compressed = NULL;
+    char *data = NULL;
+    size_t total = 0;
+    size_t offset = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        total += chunks[i].length;
+    }
+
+    os_malloc(total + 1, data);
+    os_malloc(FIM_CHUNK_MAX_SIZE + (FIM_CHUNK_MAX_SIZE >> 10) + 64, compressed);
+
+    for (i = 0; i < count; i++) {
+        size_t read_size = 0;
+        FILE *fp;
+
+        snprintf(path, PATH_MAX, "%s/chunks/%.2s/%s", DIFF_DIR, chunks[i].id, chunks[i].id);
+
+        if (fp = wfopen(path, "rb"), fp == NULL) {
+            mdebug1(FIM_DIFF_CHUNK_MISSING, path);
+            goto error;
+        }
+
+        read_size = fread(compressed, 1, FIM_CHUNK_MAX_SIZE + (FIM_CHUNK_MAX_SIZE >> 10) + 64, fp);
+        fclose(fp);
+
+        // The extra byte holds the terminator written by os_zlib_uncompress
+        if (read_size == 0 || chunks[i].length > FIM_CHUNK_MAX_SIZE ||
+            os_zlib_uncompress(compressed, data + offset, read_size, chunks[i].length + 1) != chunks[i].length) {
+            mdebug1(FIM_DIFF_CHUNK_MISSING, path);
+            goto error;
+        }
+
+        offset += chunks[i].length;
+    }
+
+    data[total] = '\0';
+    *length = total;
+    os_free(compressed);
+    return data;
+
+error:
+    os_free(compressed);
+    os_free(data);
+    return NULL;
+}
+
+int fim_diff_save_chunks(const diff_data *diff, const char *data, const fim_chunk *chunks, size_t count) {
+    char path[PATH_MAX];
+    char tmp_path[PATH_MAX];
+    char **compressed = NULL;
+    unsigned long *compressed_length = NULL;
+    float stored_size = 0;
+    size_t offset = 0;
+    int retval = -1;
+    size_t i;
+    FILE *fp;
+
+    os_calloc(count + 1, sizeof(char *), compressed);
+    os_calloc(count + 1, sizeof(unsigned long), compressed_length);
+
+    // Compress the chunks that aren't in the store yet, so that the disk quota is checked before writing them
+    for (i = 0; i < count; offset += chunks[i].length, i++) {
+        size_t bound = chunks[i].length + (chunks[i].length >> 10) + 64;
+
+        snprintf(path, PATH_MAX, "%s/chunks/%.2s/%s", DIFF_DIR, chunks[i].id, chunks[i].id);
+
+        if (w_is_file(path)) {
+            continue;
+        }
+
+        os_malloc(bound, compressed[i]);
+
+        if (compressed_length[i] = os_zlib_compress(data + offset, compressed[i], chunks[i].length, bound - 1),
+            compressed_length[i] == 0) {
+            mwarn(FIM_WARN_GENDIFF_SNAPSHOT, diff->file_origin);
+            goto end;
+        }
+
+        stored_size += compressed_length[i] / 1024.0f;
+    }
+
+    if (syscheck.disk_quota_enabled && syscheck.diff_folder_size + stored_size > syscheck.disk_quota_limit) {
+        if (syscheck.disk_quota_full_msg) {
+            syscheck.disk_quota_full_msg = false;
+            mdebug2(FIM_DISK_QUOTA_LIMIT_REACHED, "calculate", diff->file_origin);
+        }
+        goto end;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (compressed[i] == NULL) {
+            continue;
+        }
+
+        snprintf(path, PATH_MAX, "%s/chunks/%.2s", DIFF_DIR, chunks[i].id);
+
+        if (mkdir_ex(path) != 0) {
+            goto end;
+        }
+
+        snprintf(path, PATH_MAX, "%s/chunks/%.2s/%s", DIFF_DIR, chunks[i].id, chunks[i].id);
+        snprintf(tmp_path, PATH_MAX, "%s.tmp", path);
+
+        if (fp = wfopen(tmp_path, "wb"), fp == NULL) {
+            merror(FOPEN_ERROR, tmp_path, errno, strerror(errno));
+            goto end;
+        }
+
+        if (fwrite(compressed[i], 1, compressed_length[i], fp) != compressed_length[i]) {
+            merror(FWRITE_ERROR, tmp_path, errno, strerror(errno));
+            fclose(fp);
+            unlink(tmp_path);
+            goto end;
+        }
+
+        fclose(fp);
+
+        if (rename_ex(tmp_path, path) != 0) {
+            merror(RENAME_ERROR, tmp_path, path, errno, strerror(errno));
+            unlink(tmp_path);
+            goto end;
+        }
+    }
+
+    if (syscheck.disk_quota_enabled) {
+        syscheck.diff_folder_size += stored_size;
+    }
+
+    // Write the new manifest next to the old one and replace it at once
+    mkdir_ex(diff->compress_folder);
+    snprintf(path, PATH_MAX, "%s/%s", diff->compress_folder, FIM_CHUNKS_MANIFEST);
+    snprintf(tmp_path, PATH_MAX, "%s.tmp", path);
+
+    if (fp = wfopen(tmp_path, "w"), fp == NULL) {
+        merror(FOPEN_ERROR, tmp_path, errno, strerror(errno));
+        goto end;
+    }
+
+    for (i = 0; i < count; i++) {
+        fprintf(fp, "%s %zu\n", chunks[i].id, chunks[i].length);
+    }
+
+    if (fclose(fp) != 0 || rename_ex(tmp_path, path) != 0) {
+        merror(RENAME_ERROR, tmp_path, path, errno, strerror(errno));
+        unlink(tmp_path);
+        goto end;
+    }
+
+    retval = 0;
+
+end:
+    for (i = 0; i < count; i++) {
+        os_free(compressed[i]);
+    }
+    os_free(compressed);
+    os_free(compressed_length);
+
+    return retval;
+}
+
+/**
+ * @brief Splits a content in lines and numbers them by content
+ *
+ * @param data Content to split
+ * @param length Length of the content
+ * @param count Returns the number of lines
+ *
+ * @return Array of lines
+ */
+static fim_diff_line *fim_diff_split_lines(const char *data, size_t length, size_t *count) {
+    fim_diff_line *lines = NULL;
+    size_t size = 64;
+    size_t offset = 0;
+
+    *count = 0;
+    os_calloc(size, sizeof(fim_diff_line), lines);
+
+    while (offset < length) {
+        const char *newline = memchr(data + offset, '\n', length - offset);
+        size_t line_length = newline ? (size_t)(newline - (data + offset)) + 1 : length - offset;
+
+        if (*count == size) {
+            size *= 2;
+            os_realloc(lines, size * sizeof(fim_diff_line), lines);
+        }
+
+        lines[*count].text = data + offset;
+        lines[*count].length = line_length;
+        (*count)++;
+        offset += line_length;
+    }
+
+    return lines;
+}
+
+/**
+ * @brief Gives the same number to the lines of both contents with the same text
+ *
+ * @return Number of different lines, plus one
+ */
+static int fim_diff_number_lines(fim_diff_line *old_lines, size_t old_count, fim_diff_line *new_lines, size_t new_count) {
+    const size_t total = old_count + new_count;
+    size_t buckets = 64;
+    fim_diff_line **table = NULL;
+    int next_equiv = 1;
+    size_t i;
+
+    while (buckets < total * 2) {
+        buckets *= 2;
+    }
+
+    os_calloc(buckets, sizeof(fim_diff_line *), table);
+
+    for (i = 0; i < total; i++) {
+        fim_diff_line *line = i < old_count ? &old_lines[i] : &new_lines[i - old_count];
+        unsigned long hash = 5381;
+        size_t j;
+
+        for (j = 0; j < line->length; j++) {
+            hash = ((hash << 5) + hash) + (unsigned char)line->text[j];
+        }
+
+        for (j = hash & (buckets - 1); table[j] != NULL; j = (j + 1) & (buckets - 1)) {
+            if (table[j]->length == line->length && memcmp(table[j]->text, line->text, line->length) == 0) {
+                break;
+            }
+        }
+
+        if (table[j] == NULL) {
+            table[j] = line;
+            line->equiv = next_equiv++;
+        } else {
+            line->equiv = table[j]->equiv;
+        }
+    }
+
+    os_free(table);
+
+    return next_equiv;
+}
+
+/**
+ * @brief State of the comparison of two sequences of line numbers, as the one of diff
+ */
+typedef struct fim_diff_context {
+    const int *old_equivs;      // Lines of the stored content that are compared
+    const int *new_equivs;      // Lines of the current content that are compared
+    const long *old_indexes;    // Position of every compared line in the stored content
+    const long *new_indexes;    // Position of every compared line in the current content
+    char *old_changed;
+    char *new_changed;
+    long *forward;              // Furthest point of every diagonal searching from the start
+    long *backward;             // Furthest point of every diagonal searching from the end
+} fim_diff_context;
+
+/**
+ * @brief Finds the middle snake of the shortest edit script between two ranges (Myers)
+ *
+ * @param ctx Comparison state
+ * @param old_first First line of the stored content
+ * @param old_last Line after the last one of the stored content
+ * @param new_first First line of the current content
+ * @param new_last Line after the last one of the current content
+ * @param old_mid Returns the line of the stored content where the script is split
+ * @param new_mid Returns the line of the current content where the script is split
+ *
+ * @return 0 on success, -1 if more than FIM_DIFF_MAX_EDITS edits are needed from each end
+ */
+static int fim_diff_middle_snake(fim_diff_context *ctx,
+                                 long old_first,
+                                 long old_last,
+                                 long new_first,
+                                 long new_last,
+                                 long *old_mid,
+                                 long *new_mid) {
+    const int *xv = ctx->old_equivs;
+    const int *yv = ctx->new_equivs;
+    long *fd = ctx->forward;
+    long *bd = ctx->backward;
+    const long dmin = old_first - new_last;
+    const long dmax = old_last - new_first;
+    const long fmid = old_first - new_first;
+    const long bmid = old_last - new_last;
+    const bool odd = (fmid - bmid) & 1;
+    long fmin = fmid, fmax = fmid;
+    long bmin = bmid, bmax = bmid;
+    long c, d, x, y;
+
+    fd[fmid] = old_first;
+    bd[bmid] = old_last;
+
+    for (c = 1; c < FIM_DIFF_MAX_EDITS; c++) {
+        // Extend the search from the start by one edit in every diagonal
+        if (fmin > dmin) {
+            fd[--fmin - 1] = -1;
+        } else {
+            ++fmin;
+        }
+
+        if (fmax < dmax) {
+            fd[++fmax + 1] = -1;
+        } else {
+            --fmax;
+        }
+
+        for (d = fmax; d >= fmin; d -= 2) {
+            long x0 = fd[d - 1] < fd[d + 1] ? fd[d + 1] : fd[d - 1] + 1;
+
+            for (x = x0, y = x0 - d; x < old_last && y < new_last && xv[x] == yv[y]; x++, y++);
+
+            fd[d] = x;
+
+            if (odd && bmin <= d && d <= bmax && bd[d] <= x) {
+                *old_mid = x;
+                *new_mid = y;
+                return 0;
+            }
+        }
+
+        // Same from the end
+        if (bmin > dmin) {
+            bd[--bmin - 1] = LONG_MAX;
+        } else {
+            ++bmin;
+        }
+
+        if (bmax < dmax) {
+            bd[++bmax + 1] = LONG_MAX;
+        } else {
+            --bmax;
+        }
+
+        for (d = bmax; d >= bmin; d -= 2) {
+            long x0 = bd[d - 1] < bd[d + 1] ? bd[d - 1] : bd[d + 1] - 1;
+
+            for (x = x0, y = x0 - d; old_first < x && new_first < y && xv[x - 1] == yv[y - 1]; x--, y--);
+
+            bd[d] = x;
+
+            if (!odd && fmin <= d && d <= fmax && x <= fd[d]) {
+                *old_mid = x;
+                *new_mid = y;
+                return 0;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Marks the changed lines of two ranges, splitting them by their middle snake
+ *
+ * @return 0 on success, -1 if the ranges are too different
+ */
+static int fim_diff_compare_ranges(fim_diff_context *ctx, long old_first, long old_last, long new_first, long new_last) {
+    long old_mid, new_mid;
+
+    while (old_first < old_last && new_first < new_last && ctx->old_equivs[old_first] == ctx->new_equivs[new_first]) {
+        old_first++;
+        new_first++;
+    }
+
+    while (old_first < old_last && new_first < new_last &&
+           ctx->old_equivs[old_last - 1] == ctx->new_equivs[new_last - 1]) {
+        old_last--;
+        new_last--;
+    }
+
+    if (old_first == old_last) {
+        for (; new_first < new_last; new_first++) {
+            ctx->new_changed[ctx->new_indexes[new_first]] = 1;
+        }
+    } else if (new_first == new_last) {
+        for (; old_first < old_last; old_first++) {
+            ctx->old_changed[ctx->old_indexes[old_first]] = 1;
+        }
+    } else {
+        if (fim_diff_middle_snake(ctx, old_first, old_last, new_first, new_last, &old_mid, &new_mid) != 0 ||
+            fim_diff_compare_ranges(ctx, old_first, old_mid, new_first, new_mid) != 0 ||
+            fim_diff_compare_ranges(ctx, old_mid, old_last, new_mid, new_last) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Marks the lines that can't match any line of the other content, as diff does before comparing
+ *
+ * Lines with no match in the other content are marked as changed. Lines with many matches are only
+ * marked when they are in the middle of a run of lines with no match.
+ *
+ * @param lines Lines of the content
+ * @param count Number of lines
+ * @param other_counts Number of lines of the other content of every class
+ * @param discards Returns 1 for the lines that won't be compared
+ */
+static void fim_diff_discard_lines(const fim_diff_line *lines, long count, const long *other_counts, char *discards) {
+    long many = 5;
+    long i, j;
+
+    // Provisional discards are the lines that match more than about the square root of the lines
+    for (long tem = count / 64; (tem = tem >> 2) > 0;) {
+        many *= 2;
+    }
+
+    for (i = 0; i < count; i++) {
+        long matches = other_counts[lines[i].equiv];
+
+        if (matches == 0) {
+            discards[i] = 1;
+        } else if (matches > many) {
+            discards[i] = 2;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        long provisional = 0;
+        long length, consec;
+
+        if (discards[i] == 2) {
+            discards[i] = 0;
+            continue;
+        } else if (discards[i] == 0) {
+            continue;
+        }
+
+        // Run of discards starting by a line with no match
+        for (j = i; j < count && discards[j] != 0; j++) {
+            if (discards[j] == 2) {
+                provisional++;
+            }
+        }
+
+        while (j > i && discards[j - 1] == 2) {
+            discards[--j] = 0;
+            provisional--;
+        }
+
+        length = j - i;
+
+        if (provisional * 4 > length) {
+            while (j > i) {
+                if (discards[--j] == 2) {
+                    discards[j] = 0;
+                }
+            }
+        } else {
+            long minimum = 1;
+
+            for (long tem = length >> 2; (tem >>= 2) > 0;) {
+                minimum <<= 1;
+            }
+            minimum++;
+
+            // Keep the long subruns of provisional discards
+            for (j = 0, consec = 0; j < length; j++) {
+                if (discards[i + j] != 2) {
+                    consec = 0;
+                } else if (minimum == ++consec) {
+                    j -= consec;
+                } else if (minimum < consec) {
+                    discards[i + j] = 0;
+                }
+            }
+
+            // Keep the provisional discards at both ends of the run
+            for (j = 0, consec = 0; j < length; j++) {
+                if (j >= 8 && discards[i + j] == 1) {
+                    break;
+                }
+
+                if (discards[i + j] == 2) {
+                    consec = 0;
+                    discards[i + j] = 0;
+                } else if (discards[i + j] == 0) {
+                    consec = 0;
+                } else if (++consec == 3) {
+                    break;
+                }
+            }
+
+            i += length - 1;
+
+            for (j = 0, consec = 0; j < length; j++) {
+                if (j >= 8 && discards[i - j] == 1) {
+                    break;
+                }
+
+                if (discards[i - j] == 2) {
+                    consec = 0;
+                    discards[i - j] = 0;
+                } else if (discards[i - j] == 0) {
+                    consec = 0;
+                } else if (++consec == 3) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Marks the lines that changed, choosing the same ones as diff
+ *
+ * @param old_lines Lines of the stored content, only the ones between the common prefix and suffix
+ * @param old_count Number of lines
+ * @param new_lines Lines of the current content, only the ones between the common prefix and suffix
+ * @param new_count Number of lines
+ * @param classes Number of different lines
+ * @param old_changed Flags of the deleted lines
+ * @param new_changed Flags of the inserted lines
+ *
+ * @return 0 on success, -1 if more than FIM_DIFF_MAX_EDITS edits are needed
+ */
+static int fim_diff_mark_changes(const fim_diff_line *old_lines,
+                                 long old_count,
+                                 const fim_diff_line *new_lines,
+                                 long new_count,
+                                 int classes,
+                                 char *old_changed,
+                                 char *new_changed) {
+    fim_diff_context ctx = { .old_changed = old_changed, .new_changed = new_changed };
+    long *old_counts = NULL;
+    long *new_counts = NULL;
+    char *discards = NULL;
+    int *equivs = NULL;
+    long *indexes = NULL;
+    long *diagonals = NULL;
+    long old_kept = 0;
+    long new_kept = 0;
+    long i;
+    int retval;
+
+    os_calloc(classes, sizeof(long), old_counts);
+    os_calloc(classes, sizeof(long), new_counts);
+    os_calloc(old_count + new_count + 1, sizeof(char), discards);
+    os_calloc(old_count + new_count + 1, sizeof(int), equivs);
+    os_calloc(old_count + new_count + 1, sizeof(long), indexes);
+
+    for (i = 0; i < old_count; i++) {
+        old_counts[old_lines[i].equiv]++;
+    }
+
+    for (i = 0; i < new_count; i++) {
+        new_counts[new_lines[i].equiv]++;
+    }
+
+    fim_diff_discard_lines(old_lines, old_count, new_counts, discards);
+    fim_diff_discard_lines(new_lines, new_count, old_counts, discards + old_count);
+
+    for (i = 0; i < old_count; i++) {
+        if (discards[i]) {
+            old_changed[i] = 1;
+        } else {
+            equivs[old_kept] = old_lines[i].equiv;
+            indexes[old_kept++] = i;
+        }
+    }
+
+    for (i = 0; i < new_count; i++) {
+        if (discards[old_count + i]) {
+            new_changed[i] = 1;
+        } else {
+            equivs[old_kept + new_kept] = new_lines[i].equiv;
+            indexes[old_kept + new_kept++] = i;
+        }
+    }
+
+    ctx.old_equivs = equivs;
+    ctx.old_indexes = indexes;
+    ctx.new_equivs = equivs + old_kept;
+    ctx.new_indexes = indexes + old_kept;
+
+    // Diagonals go from -new_kept to old_kept, with one more at each side
+    os_calloc(2 * (old_kept + new_kept + 3), sizeof(long), diagonals);
+    ctx.forward = diagonals + new_kept + 1;
+    ctx.backward = diagonals + (old_kept + new_kept + 3) + new_kept + 1;
+
+    retval = fim_diff_compare_ranges(&ctx, 0, old_kept, 0, new_kept);
+
+    os_free(old_counts);
+    os_free(new_counts);
+    os_free(discards);
+    os_free(equivs);
+    os_free(indexes);
+    os_free(diagonals);
+
+    return retval;
+}
+
+/**
+ * @brief Slides every run of changed lines as diff does, so that the same hunks are reported
+ *
+ * A run that can be moved without changing the result is merged with the neighbouring runs and
+ * aligned with a run of the other content when possible, or moved as far down as it goes.
+ *
+ * @param lines Lines of the content
+ * @param count Number of lines
+ * @param changed Flags of the changed lines, with a zero before the first line and after the last one
+ * @param other_changed Flags of the other content, with the same extra zeros
+ */
+static void fim_diff_shift_boundaries(const fim_diff_line *lines,
+                                      long count,
+                                      char *changed,
+                                      const char *other_changed) {
+    long i = 0;
+    long j = 0;
+
+    while (1) {
+        long runlength, start, corresponding;
+
+        // Find the beginning of the next run of changes and the corresponding point in the other content
+        while (i < count && !changed[i]) {
+            while (other_changed[j++]);
+            i++;
+        }
+
+        if (i == count) {
+            break;
+        }
+
+        start = i;
+
+        while (changed[++i]);
+        while (other_changed[j]) {
+            j++;
+        }
+
+        do {
+            runlength = i - start;
+
+            // Move the run up while the previous line equals its last one
+            while (start && lines[start - 1].equiv == lines[i - 1].equiv) {
+                changed[--start] = 1;
+                changed[--i] = 0;
+                while (changed[start - 1]) {
+                    start--;
+                }
+                while (other_changed[--j]);
+            }
+
+            corresponding = other_changed[j - 1] ? i : count;
+
+            // Move the run down while its first line equals the next one
+            while (i != count && lines[start].equiv == lines[i].equiv) {
+                changed[start++] = 0;
+                changed[i++] = 1;
+                while (changed[i]) {
+                    i++;
+                }
+                while (other_changed[++j]) {
+                    corresponding = i;
+                }
+            }
+        } while (runlength != i - start);
+
+        // Move the merged run back up to the run of the other content if there is one
+        while (corresponding < i) {
+            changed[--start] = 1;
+            changed[--i] = 0;
+            while (other_changed[--j]);
+        }
+    }
+}
+
+/**
+ * @brief Appends text to the diff output, stopping at its maximum size
+ */
+static void fim_diff_append(char *output, size_t *length, size_t max_length, const char *text, size_t text_length) {
+    if (*length + text_length > max_length) {
+        text_length = max_length - *length;
+    }
+
+    memcpy(output + *length, text, text_length);
+    *length += text_length;
+}
+
+/**
+ * @brief Appends the lines of a hunk with the given prefix
+ */
+static void fim_diff_append_lines(char *output,
+                                  size_t *length,
+                                  size_t max_length,
+                                  const fim_diff_line *lines,
+                                  size_t first,
+                                  size_t last,
+                                  const char *prefix) {
+    for (size_t i = first; i < last && *length < max_length; i++) {
+        fim_diff_append(output, length, max_length, prefix, 2);
+        fim_diff_append(output, length, max_length, lines[i].text, lines[i].length);
+
+        if (lines[i].text[lines[i].length - 1] != '\n') {
+            fim_diff_append(output, length, max_length, "\n\\ No newline at end of file\n", 29);
+        }
+    }
+}
+
+/**
+ * @brief Prints a line range as diff does: a single number when it holds one line or none
+ */
+static int fim_diff_print_range(char *buffer, size_t size, size_t first, size_t last) {
+    return last > first ? snprintf(buffer, size, "%zu,%zu", first, last) : snprintf(buffer, size, "%zu", last);
+}
+
+int fim_diff_lines(const char *old_data,
+                   size_t old_length,
+                   const char *new_data,
+                   size_t new_length,
+                   const diff_data *diff,
+                   char **diff_str) {
+    const size_t max_length = OS_MAXSTR - OS_SK_HEADER - 1;
+    fim_diff_line *old_lines = NULL;
+    fim_diff_line *new_lines = NULL;
+    char *old_changed = NULL;
+    char *new_changed = NULL;
+    size_t old_count, new_count;
+    size_t prefix = 0;
+    size_t suffix = 0;
+    size_t length = 0;
+    size_t i, j;
+    char *output;
+    int classes;
+    int retval = -1;
+
+    os_malloc(max_length + 1, output);
+
+    if (memchr(old_data, '\0', old_length) || memchr(new_data, '\0', new_length)) {
+        length = snprintf(output, max_length + 1, "Binary files %s and %s differ\n", diff->uncompress_file, diff->file_origin);
+        length = length > max_length ? max_length : length;
+        goto print;
+    }
+
+    old_lines = fim_diff_split_lines(old_data, old_length, &old_count);
+    new_lines = fim_diff_split_lines(new_data, new_length, &new_count);
+    classes = fim_diff_number_lines(old_lines, old_count, new_lines, new_count);
+
+    // The flags have an extra zero before the first line and after the last one
+    os_calloc(old_count + 2, sizeof(char), old_changed);
+    os_calloc(new_count + 2, sizeof(char), new_changed);
+
+    while (prefix < old_count && prefix < new_count && old_lines[prefix].equiv == new_lines[prefix].equiv) {
+        prefix++;
+    }
+
+    while (suffix < old_count - prefix && suffix < new_count - prefix &&
+           old_lines[old_count - suffix - 1].equiv == new_lines[new_count - suffix - 1].equiv) {
+        suffix++;
+    }
+
+    if (fim_diff_mark_changes(old_lines + prefix, old_count - prefix - suffix, new_lines + prefix,
+                              new_count - prefix - suffix, classes, old_changed + 1 + prefix,
+                              new_changed + 1 + prefix) != 0) {
+        goto end;
+    }
+
+    // As diff, runs are not moved into the common prefix and suffix
+    fim_diff_shift_boundaries(old_lines + prefix, old_count - prefix - suffix, old_changed + 1 + prefix,
+                              new_changed + 1 + prefix);
+    fim_diff_shift_boundaries(new_lines + prefix, new_count - prefix - suffix, new_changed + 1 + prefix,
+                              old_changed + 1 + prefix);
+
+    for (i = 0, j = 0; (i < old_count || j < new_count) && length < max_length;) {
+        char header[OS_SIZE_128];
+        size_t first_old = i;
+        size_t first_new = j;
+        int header_length;
+
+        if (!old_changed[i + 1] && !new_changed[j + 1]) {
+            i++;
+            j++;
+            continue;
+        }
+
+        while (old_changed[i + 1]) {
+            i++;
+        }
+
+        while (new_changed[j + 1]) {
+            j++;
+        }
+
+        header_length = fim_diff_print_range(header, sizeof(header), first_old + 1, i);
+        header[header_length++] = (first_old == i) ? 'a' : (first_new == j) ? 'd' : 'c';
+        header_length += fim_diff_print_range(header + header_length, sizeof(header) - header_length, first_new + 1, j);
+        header[header_length++] = '\n';
+
+        fim_diff_append(output, &length, max_length, header, header_length);
+        fim_diff_append_lines(output, &length, max_length, old_lines, first_old, i, "< ");
+
+        if (first_old != i && first_new != j) {
+            fim_diff_append(output, &length, max_length, "---\n", 4);
+        }
+
+        fim_diff_append_lines(output, &length, max_length, new_lines, first_new, j, "> ");
+    }
+
+print:
+    output[length] = '\0';
+
+    // Same truncation as the output of the diff command
+    if (length >= max_length) {
+        length -= strlen(STR_MORE_CHANGES);
+
+        while (length > 0 && output[length - 1] != '\n') {
+            length--;
+        }
+
+        strcpy(output + length, STR_MORE_CHANGES);
+    }
+
+    *diff_str = output;
+    output = NULL;
+    retval = 0;
+
+end:
+    os_free(output);
+    os_free(old_lines);
+    os_free(new_lines);
+    os_free(old_changed);
+    os_free(new_changed);
+
+    return retval;
+}
+
+/**
+ * @brief Reads a whole file in memory
+ *
+ * @param path Path of the file
+ * @param length Returns the length of the content
+ *
+ * @return Content of the file, NULL on error
+ */
+static char *fim_diff_read_content(const char *path, size_t *length) {
+    char *data = NULL;
+    long size;
+    FILE *fp;
+
+    if (fp = wfopen(path, "rb"), fp == NULL) {
+        return NULL;
+    }
+
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    os_malloc(size + 1, data);
+
+    if (fread(data, 1, size, fp) != (size_t)size) {
+        fclose(fp);
+        os_free(data);
+        return NULL;
+    }
+
+    fclose(fp);
+    data[size] = '\0';
+    *length = size;
+
+    return data;
+}
+
+char *fim_diff_chunked_file(const diff_data *diff) {
+    char manifest[PATH_MAX];
+    fim_chunk *old_chunks = NULL;
+    fim_chunk *new_chunks = NULL;
+    size_t old_count = 0;
+    size_t new_count = 0;
+    char *old_data = NULL;
+    char *new_data = NULL;
+    size_t old_length = 0;
+    size_t new_length = 0;
+    char *diff_str = NULL;
+    bool save = true;
+    size_t i;
+
+    if (new_data = fim_diff_read_content(diff->file_origin, &new_length), new_data == NULL) {
+        mwarn(FIM_WARN_GENDIFF_SNAPSHOT, diff->file_origin);
+        return NULL;
+    }
+
+    new_chunks = fim_diff_split_chunks(new_data, new_length, &new_count);
+    snprintf(manifest, PATH_MAX, "%s/%s", diff->compress_folder, FIM_CHUNKS_MANIFEST);
+
+    w_mutex_lock(&fim_chunks_mutex);
+
+    if (old_chunks = fim_diff_read_manifest(manifest, &old_count), old_chunks != NULL) {
+        if (old_count == new_count) {
+            for (i = 0; i < new_count && strcmp(old_chunks[i].id, new_chunks[i].id) == 0; i++);
+
+            if (i == new_count) {
+                mdebug2(FIM_DIFF_IDENTICAL_MD5_FILES);
+                save = false;
+                goto end;
+            }
+        }
+
+        if (is_file_nodiff(diff->file_origin)) {
+            os_strdup("<Diff truncated because nodiff option>", diff_str);
+            save = false;
+            goto end;
+        }
+
+        old_data = fim_diff_load_chunks(old_chunks, old_count, &old_length);
+    } else if (w_uncompress_gzfile(diff->compress_file, diff->uncompress_file) == 0) {
+        // The last version was stored as a compressed copy before chunking was enabled
+        if (is_file_nodiff(diff->file_origin)) {
+            os_strdup("<Diff truncated because nodiff option>", diff_str);
+            save = false;
+            goto end;
+        }
+
+        if (old_data = fim_diff_read_content(diff->uncompress_file, &old_length), old_data != NULL) {
+            unlink(diff->compress_file);
+        }
+    }
+
+    if (old_data == NULL) {
+        // First version of the file, or the stored one was lost: keep the current one
+        goto end;
+    }
+
+    if (fim_diff_lines(old_data, old_length, new_data, new_length, diff, &diff_str) != 0) {
+        // Too many changes to compare in memory: run diff over the stored version
+        FILE *fp = wfopen(diff->uncompress_file, "wb");
+
+        if (fp != NULL) {
+            size_t written = fwrite(old_data, 1, old_length, fp);
+            fclose(fp);
+
+            if (written == old_length) {
+                diff_str = fim_diff_generate(diff);
+            }
+        }
+
+        if (diff_str == NULL) {
+            save = false;
+        }
+    }
+
+end:
+    if (save && fim_diff_save_chunks(diff, new_data, new_chunks, new_count) != 0) {
+        os_free(diff_str);
+    } else if (save && old_chunks != NULL) {
+        // Chunks of the old version may not be used anymore
+        fim_chunks_released = true;
+    }
+
+    w_mutex_unlock(&fim_chunks_mutex);
+
+    os_free(old_chunks);
+    os_free(new_chunks);
+    os_free(old_data);
+    os_free(new_data);
+
+    return diff_str;
+}
+
+/**
+ * @brief Adds the chunks listed in the manifests under a folder to the set of used chunks
+ *
+ * @param folder Folder with one subfolder per monitored file
+ * @param used Set of chunk identifiers
+ */
+static void fim_diff_mark_used_chunks(const char *folder, rb_tree *used) {
+    char path[PATH_MAX];
+    struct dirent *entry;
+    DIR *dir;
+
+    if (dir = opendir(folder), dir == NULL) {
+        return;
+    }
+
+    while (entry = readdir(dir), entry != NULL) {
+        fim_chunk *chunks;
+        size_t count = 0;
+
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        snprintf(path, PATH_MAX, "%s/%s/%s", folder, entry->d_name, FIM_CHUNKS_MANIFEST);
+
+        if (chunks = fim_diff_read_manifest(path, &count), chunks == NULL) {
+            continue;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            rbtree_insert(used, chunks[i].id, (void *)1);
+        }
+
+        os_free(chunks);
+    }
+
+    closedir(dir);
+}
+
+void fim_diff_collect_chunks() {
+    char store[PATH_MAX];
+    char path[PATH_MAX];
+    struct dirent *bucket;
+    struct dirent *entry;
+    unsigned int removed = 0;
+    float removed_size = 0;
+    rb_tree *used;
+    DIR *store_dir;
+    DIR *bucket_dir;
+
+    w_mutex_lock(&fim_chunks_mutex);
+
+    if (!fim_chunks_released) {
+        w_mutex_unlock(&fim_chunks_mutex);
+        return;
+    }
+
+    fim_chunks_released = false;
+
+    snprintf(store, PATH_MAX, "%s/chunks", DIFF_DIR);
+
+    if (store_dir = opendir(store), store_dir == NULL) {
+        w_mutex_unlock(&fim_chunks_mutex);
+        return;
+    }
+
+    used = rbtree_init();
+    snprintf(path, PATH_MAX, "%s/file", DIFF_DIR);
+    fim_diff_mark_used_chunks(path, used);
+
+    while (bucket = readdir(store_dir), bucket != NULL) {
+        if (bucket->d_name[0] == '.') {
+            continue;
+        }
+
+        snprintf(path, PATH_MAX, "%s/%s", store, bucket->d_name);
+
+        if (bucket_dir = opendir(path), bucket_dir == NULL) {
+            continue;
+        }
+
+        while (entry = readdir(bucket_dir), entry != NULL) {
+            if (entry->d_name[0] == '.' || rbtree_get(used, entry->d_name) != NULL) {
+                continue;
+            }
+
+            snprintf(path, PATH_MAX, "%s/%s/%s", store, bucket->d_name, entry->d_name);
+            float size = FileSize(path) / 1024.0f;
+
+            if (unlink(path) == 0) {
+                removed++;
+                removed_size += size;
+            }
+        }
+
+        closedir(bucket_dir);
+    }
+
+    closedir(store_dir);
+    rbtree_destroy(used);
+
+    if (syscheck.disk_quota_enabled) {
+        syscheck.diff_folder_size -= removed_size;
+
+        if (syscheck.diff_folder_size < 0) {
+            syscheck.diff_folder_size = 0;
+        }
+    }
+
+    w_mutex_unlock(&fim_chunks_mutex);
+
+    mdebug1(FIM_DIFF_CHUNKS_COLLECTED, removed, removed_size);
+}
+
+#endif
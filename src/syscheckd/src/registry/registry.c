@@ -29,6 +29,9 @@ extern int _base_line;
 static int _base_line = 0;
 #endif
 
+static unsigned int _read_keys = 0;
+static unsigned int _reused_keys = 0;
+
 /* Default values */
 #define MAX_KEY_LENGTH 260
 #define MAX_VALUE_NAME 16383
@@ -925,6 +928,102 @@ void fim_read_values(HKEY key_handle,
     os_free(data_buffer);
 }
 
+/**
+ * @brief Callback that copies the modification time of a registry key stored in the FIM DB.
+ *
+ * @param data A fim_entry holding the stored key.
+ * @param ctx A pointer to the time_t where the modification time will be stored.
+ */
+static void fim_registry_copy_key_mtime(void *data, void *ctx) {
+    fim_entry *entry = (fim_entry *)data;
+
+    *(time_t *)ctx = entry->registry_entry.key->mtime;
+}
+
+typedef struct fim_stored_values_ctx_s {
+    TXN_HANDLE regval_txn_handler;
+    fim_val_txn_context_t *txn_ctx_regval;
+    registry_t *configuration;
+} fim_stored_values_ctx_t;
+
+/**
+ * @brief Callback that adds a value stored in the FIM DB to the current value transaction.
+ * @details The value is marked as seen without being read from the registry, so it is not reported as deleted.
+ *
+ * @param data A fim_entry holding the stored value.
+ * @param ctx A fim_stored_values_ctx_t with the value transaction.
+ */
+static void fim_registry_sync_stored_value(void *data, void *ctx) {
+    fim_entry *entry = (fim_entry *)data;
+    fim_stored_values_ctx_t *stored_ctx = (fim_stored_values_ctx_t *)ctx;
+    fim_registry_value_data *value = entry->registry_entry.value;
+    char *value_path;
+    size_t value_path_length;
+    int result_transaction;
+
+    value_path_length = strlen(value->path) + strlen(value->name) + 2;
+    os_malloc(value_path_length, value_path);
+    snprintf(value_path, value_path_length, "%s\\%s", value->path, value->name);
+
+    // The configuration may have changed since the value was stored.
+    if (fim_registry_validate_ignore(value_path, stored_ctx->configuration, 0) ||
+        fim_check_restrict(value->name, stored_ctx->configuration->restrict_value)) {
+        os_free(value_path);
+        return;
+    }
+    os_free(value_path);
+
+    stored_ctx->txn_ctx_regval->diff = NULL;
+    stored_ctx->txn_ctx_regval->data = value;
+
+    result_transaction = fim_db_transaction_sync_row(stored_ctx->regval_txn_handler, entry);
+
+    if (result_transaction < 0) {
+        mdebug2("dbsync transaction failed due to %d", result_transaction);
+    }
+}
+
+/**
+ * @brief Adds the values stored in the FIM DB for a key to the value transaction if they can be reused.
+ * @details A key's last write time changes whenever one of its values is added, removed or modified, so the values of a
+ * key whose last write time matches the stored one haven't changed. Each key is still read every 'hash_verify_scans'
+ * scans.
+ *
+ * @param key The registry key as currently read.
+ * @param configuration The configuration associated with the key.
+ * @param mode A value specifying if the event has been triggered in scheduled, realtime or whodata mode.
+ * @param regval_txn_handler Handler of the value transaction.
+ * @param txn_ctx_regval Context of the value transaction.
+ * @return true if the stored values were reused, false if the values must be read from the registry.
+ */
+static bool fim_registry_reuse_values(const fim_registry_key *key,
+                                      registry_t *configuration,
+                                      fim_event_mode mode,
+                                      TXN_HANDLE regval_txn_handler,
+                                      fim_val_txn_context_t *txn_ctx_regval) {
+    time_t stored_mtime = 0;
+    callback_context_t mtime_callback = { .callback = fim_registry_copy_key_mtime, .context = &stored_mtime };
+    fim_stored_values_ctx_t stored_ctx = { .regval_txn_handler = regval_txn_handler,
+                                           .txn_ctx_regval = txn_ctx_regval,
+                                           .configuration = configuration };
+    callback_context_t values_callback = { .callback = fim_registry_sync_stored_value, .context = &stored_ctx };
+
+    if (!syscheck.skip_unchanged_hash || mode != FIM_SCHEDULED || !(configuration->opts & CHECK_MTIME) ||
+        key->mtime == 0) {
+        return false;
+    }
+
+    if (fim_hash_verify_due(key->path)) {
+        return false;
+    }
+
+    if (fim_db_get_registry_key(key->path, key->arch, mtime_callback) != FIMDB_OK || stored_mtime != key->mtime) {
+        return false;
+    }
+
+    return fim_db_get_registry_key_values(key->path, key->arch, values_callback) == FIMDB_OK;
+}
+
 /**
  * @brief Open a registry key and scan its contents.
  *
@@ -959,6 +1058,7 @@ void fim_open_key(HKEY root_key_handle,
     int result_transaction = -1;
     os_sha1 hash_full_path;
     char* arch_string;
+    bool reuse_values;
 
     if (root_key_handle == NULL || full_key == NULL || sub_key == NULL) {
         return;
@@ -1042,6 +1142,10 @@ void fim_open_key(HKEY root_key_handle,
     OS_SHA1_strings(hash_full_path, "key", arch_string, new.registry_entry.key->path, NULL);
     new.registry_entry.key->hash_full_path = hash_full_path;
 
+    // The stored key must be checked before the transaction updates it.
+    reuse_values = value_count &&
+                   fim_registry_reuse_values(new.registry_entry.key, configuration, mode, regval_txn_handler, txn_ctx_regval);
+
     txn_ctx_reg->key = new.registry_entry.key;
 
     result_transaction = fim_db_transaction_sync_row(regkey_txn_handler, &new);
@@ -1050,7 +1154,10 @@ void fim_open_key(HKEY root_key_handle,
         merror("Dbsync registry transaction failed due to %d", result_transaction);
     }
 
-    if (value_count) {
+    if (reuse_values) {
+        _reused_keys++;
+    } else if (value_count) {
+        _read_keys++;
         fim_read_values(current_key_handle, new.registry_entry.key->path, new.registry_entry.key->arch, value_count, max_value_length, max_value_data_length,
                         regval_txn_handler, txn_ctx_regval);
     }
@@ -1073,6 +1180,9 @@ void fim_registry_scan() {
 
     /* Debug entries */
     mdebug1(FIM_WINREGISTRY_START);
+    _read_keys = 0;
+    _reused_keys = 0;
+
     /* Get sub class and a valid registry entry */
     for (i = 0; syscheck.registry[i].entry; i++) {
         /* Ignored entries are zeroed */
@@ -1102,6 +1212,10 @@ void fim_registry_scan() {
 
     mdebug1(FIM_WINREGISTRY_ENDED);
 
+    if (syscheck.skip_unchanged_hash) {
+        minfo(FIM_REGISTRY_SCAN_SUMMARY, _read_keys, _reused_keys);
+    }
+
     if (_base_line == 0) {
         _base_line = 1;
     }
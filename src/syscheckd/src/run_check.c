@@ -401,6 +401,7 @@ DWORD WINAPI fim_run_realtime(__attribute__((unused)) void * args) {
     directory_t *dir_it;
     OSListNode *node_it;
     int watches;
+    int i;
 
     Wow64DisableWow64FsRedirection(NULL); //Disable virtual redirection to 64bits folder due this is a x86 process
     set_priority_windows_thread();
@@ -419,6 +420,13 @@ DWORD WINAPI fim_run_realtime(__attribute__((unused)) void * args) {
         mdebug2(FIM_NUM_WATCHES, watches);
     }
 
+    // The changes of every directory are queued to a completion port, the workers process them
+    for (i = 0; i < FIM_RT_WORKERS; i++) {
+        if (CreateThread(NULL, 0, realtime_win32_worker, NULL, 0, NULL) == NULL) {
+            merror(THREAD_ERROR);
+        }
+    }
+
     while (FOREVER()) {
 
 #ifdef WIN_WHODATA
@@ -428,14 +436,10 @@ DWORD WINAPI fim_run_realtime(__attribute__((unused)) void * args) {
 #endif
         if (get_realtime_watches() > 0) {
             log_realtime_status(1);
-
-            if (WaitForSingleObjectEx(syscheck.realtime->evt, SYSCHECK_WAIT * 1000, TRUE) == WAIT_FAILED) {
-                merror(FIM_ERROR_REALTIME_WAITSINGLE_OBJECT);
-            }
-        } else {
-            sleep(SYSCHECK_WAIT);
         }
 
+        sleep(SYSCHECK_WAIT);
+
         // Directories in Windows configured with real-time add recursive watches
         w_rwlock_wrlock(&syscheck.directories_lock);
         OSList_foreach(node_it, syscheck.directories) {
@@ -467,10 +471,17 @@ void *fim_run_realtime(__attribute__((unused)) void * args) {
             struct timeval selecttime;
             fd_set rfds;
             int run_now = 0;
+            long coalesce_timeout = realtime_coalesce_timeout();
 
             selecttime.tv_sec = SYSCHECK_WAIT;
             selecttime.tv_usec = 0;
 
+            // Wake up when the quiet window of the next coalesced path ends
+            if (coalesce_timeout >= 0 && coalesce_timeout < SYSCHECK_WAIT * 1000) {
+                selecttime.tv_sec = coalesce_timeout / 1000;
+                selecttime.tv_usec = (coalesce_timeout % 1000) * 1000;
+            }
+
             // zero-out the fd_set
             FD_ZERO (&rfds);
             FD_SET(nfds, &rfds);
@@ -480,6 +491,7 @@ void *fim_run_realtime(__attribute__((unused)) void * args) {
                 merror(FIM_ERROR_SELECT);
             } else if (run_now == 0) {
                 // Timeout
+                realtime_flush_events(false);
             } else if (FD_ISSET (nfds, &rfds)) {
                 realtime_process();
             }
@@ -820,20 +832,20 @@ STATIC void fim_link_check_delete(directory_t *configuration) {
 
 STATIC void fim_link_delete_range(directory_t *configuration) {
     event_data_t evt_data = { .mode = FIM_SCHEDULED, .report_event = false, .w_evt = NULL, .type = FIM_DELETE };
-    char pattern[PATH_MAX] = {0};
+    char prefix[PATH_MAX] = {0};
 
     get_data_ctx ctx = {
         .event = (event_data_t *)&evt_data,
         .config = configuration,
         .path = configuration->path
     };
-    // Create the sqlite LIKE pattern.
-    snprintf(pattern, PATH_MAX, "%s%c%%", configuration->symbolic_links, PATH_SEP);
+    // Every entry under the old target of the link.
+    snprintf(prefix, PATH_MAX, "%s%c", configuration->symbolic_links, PATH_SEP);
     callback_context_t callback_data;
     callback_data.callback = fim_db_remove_validated_path;
     callback_data.context = &ctx;
 
-    fim_db_file_pattern_search(pattern, callback_data);
+    fim_db_file_prefix_search(prefix, callback_data);
 }
 
 STATIC void fim_link_silent_scan(const char *path, directory_t *configuration) {
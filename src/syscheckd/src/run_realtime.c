@@ -19,8 +19,10 @@
 
 #ifdef WAZUH_UNIT_TESTING
 #ifdef WIN32
+#include "unit_tests/wrappers/windows/errhandlingapi_wrappers.h"
 #include "unit_tests/wrappers/windows/fileapi_wrappers.h"
 #include "unit_tests/wrappers/windows/handleapi_wrappers.h"
+#include "unit_tests/wrappers/windows/ioapiset_wrappers.h"
 #include "unit_tests/wrappers/windows/synchapi_wrappers.h"
 #include "unit_tests/wrappers/windows/winbase_wrappers.h"
 #endif
@@ -29,9 +31,375 @@
 #ifdef INOTIFY_ENABLED
 #include <sys/inotify.h>
 
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/fanotify.h>)
+#include <sys/fanotify.h>
+#include <sys/vfs.h>
+#endif
+#endif
+
+#if defined(FAN_REPORT_FID) && defined(FAN_MARK_FILESYSTEM)
+#define FANOTIFY_ENABLED
+#define REALTIME_FANOTIFY_FLAGS FAN_MODIFY|FAN_ATTRIB|FAN_MOVED_FROM|FAN_MOVED_TO|FAN_CREATE|FAN_DELETE|FAN_DELETE_SELF|FAN_MOVE_SELF|FAN_ONDIR
+#endif
+
 #define REALTIME_MONITOR_FLAGS  IN_MODIFY|IN_ATTRIB|IN_MOVED_FROM|IN_MOVED_TO|IN_CREATE|IN_DELETE|IN_DELETE_SELF|IN_MOVE_SELF
 #define REALTIME_EVENT_SIZE     (sizeof (struct inotify_event))
 #define REALTIME_EVENT_BUFFER   (2048 * (REALTIME_EVENT_SIZE + 16))
+#define REALTIME_COALESCE_MAX_PATHS         4096    /* Pending paths that force a flush before their quiet window ends */
+#define REALTIME_COALESCE_REPORT_INTERVAL   60      /* Seconds between two coalescing reports */
+
+/* Paths waiting for their quiet window to end. Only the realtime thread uses them. */
+static rb_tree *rt_pending_events = NULL;
+static unsigned int rt_received_events = 0;
+static unsigned int rt_checked_events = 0;
+static time_t rt_last_report = 0;
+
+static long long realtime_now_ms() {
+    struct timespec now;
+
+    gettime(&now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Logs how many events were collapsed into each check since the previous report.
+ */
+static void realtime_report_coalescing() {
+    time_t now = time(NULL);
+
+    if (now - rt_last_report < REALTIME_COALESCE_REPORT_INTERVAL) {
+        return;
+    }
+
+    if (rt_checked_events > 0) {
+        mdebug1(FIM_REALTIME_COALESCE_STATS, rt_received_events, rt_checked_events,
+                (double)rt_received_events / rt_checked_events, rbtree_size(rt_pending_events));
+    }
+
+    rt_received_events = 0;
+    rt_checked_events = 0;
+    rt_last_report = now;
+}
+
+/**
+ * @brief Delays the check of the given paths until no new event arrives for them in 'rt_coalesce_window' ms.
+ *
+ * @param paths NULL terminated list of paths with events.
+ */
+static void realtime_coalesce_events(char **paths) {
+    long long *deadline;
+
+    if (rt_pending_events == NULL) {
+        rt_pending_events = rbtree_init();
+        rbtree_set_dispose(rt_pending_events, free);
+        rt_last_report = time(NULL);
+    }
+
+    for (int i = 0; paths[i] != NULL; i++) {
+        os_malloc(sizeof(long long), deadline);
+        *deadline = realtime_now_ms() + syscheck.rt_coalesce_window;
+
+        // Every new event restarts the quiet window of the path.
+        if (rbtree_replace(rt_pending_events, paths[i], deadline) == NULL &&
+            rbtree_insert(rt_pending_events, paths[i], deadline) == NULL) {
+            os_free(deadline);
+        }
+    }
+
+    realtime_flush_events(rbtree_size(rt_pending_events) >= REALTIME_COALESCE_MAX_PATHS);
+}
+
+void realtime_flush_events(bool force) {
+    char **paths;
+    long long now;
+    long long *deadline;
+
+    if (rt_pending_events == NULL || rbtree_empty(rt_pending_events)) {
+        return;
+    }
+
+    paths = rbtree_keys(rt_pending_events);
+    now = realtime_now_ms();
+
+    for (int i = 0; paths[i] != NULL; i++) {
+        deadline = (long long *)rbtree_get(rt_pending_events, paths[i]);
+
+        if (!force && deadline != NULL && *deadline > now) {
+            continue;
+        }
+
+        rbtree_delete(rt_pending_events, paths[i]);
+        rt_checked_events++;
+
+        w_rwlock_rdlock(&syscheck.directories_lock);
+        fim_realtime_event(paths[i]);
+        w_rwlock_unlock(&syscheck.directories_lock);
+    }
+
+    free_strarray(paths);
+    realtime_report_coalescing();
+}
+
+/**
+ * @brief Checks the paths of a batch of real-time events, or queues them if coalescing is enabled.
+ *
+ * @param tree Paths of the events. It's destroyed.
+ */
+static void realtime_dispatch_events(rb_tree *tree) {
+    char ** paths = rbtree_keys(tree);
+
+    if (syscheck.rt_coalesce_window > 0) {
+        realtime_coalesce_events(paths);
+    } else {
+        for (int i = 0; paths[i] != NULL; i++) {
+            w_rwlock_rdlock(&syscheck.directories_lock);
+            fim_realtime_event(paths[i]);
+            w_rwlock_unlock(&syscheck.directories_lock);
+        }
+    }
+
+    free_strarray(paths);
+    rbtree_destroy(tree);
+}
+
+#ifdef FANOTIFY_ENABLED
+/* A filesystem marked for fanotify, with a descriptor to open its file handles */
+typedef struct fim_fanotify_fs {
+    int fsid[2];
+    int mount_fd;
+} fim_fanotify_fs;
+
+static fim_fanotify_fs *rt_fanotify_fs = NULL;
+static size_t rt_fanotify_fs_count = 0;
+
+/**
+ * @brief Initializes fanotify, reporting directory handles and names if the kernel supports it (Linux 5.9).
+ * Otherwise, only the handle of the changed object is reported (Linux 5.1).
+ *
+ * @return The fanotify descriptor, or -1 on error.
+ */
+static int realtime_fanotify_init() {
+    int fd = -1;
+
+#ifdef FAN_REPORT_DFID_NAME
+    fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_REPORT_DFID_NAME, O_RDONLY | O_LARGEFILE);
+#endif
+    if (fd < 0) {
+        fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_REPORT_FID, O_RDONLY | O_LARGEFILE);
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Marks the filesystem of a directory, once per filesystem. Must be called with fim_realtime_mutex locked.
+ *
+ * @param dir Directory to be monitored.
+ * @return 1 on success, -1 on error.
+ */
+static int realtime_fanotify_mark(const char *dir) {
+    struct statfs fs;
+    int fsid[2];
+    int mount_fd;
+
+    if (statfs(dir, &fs) < 0) {
+        mdebug1(FIM_FANOTIFY_MARK, dir, errno, strerror(errno));
+        return -1;
+    }
+
+    memcpy(fsid, &fs.f_fsid, sizeof(fsid));
+
+    for (size_t i = 0; i < rt_fanotify_fs_count; i++) {
+        if (memcmp(rt_fanotify_fs[i].fsid, fsid, sizeof(fsid)) == 0) {
+            return 1;
+        }
+    }
+
+    if (fanotify_mark(syscheck.realtime->fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, REALTIME_FANOTIFY_FLAGS, AT_FDCWD,
+                      dir) < 0) {
+        mdebug1(FIM_FANOTIFY_MARK, dir, errno, strerror(errno));
+        return -1;
+    }
+
+    if (mount_fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC), mount_fd < 0) {
+        mdebug1(FIM_FANOTIFY_MARK, dir, errno, strerror(errno));
+        return -1;
+    }
+
+    os_realloc(rt_fanotify_fs, (rt_fanotify_fs_count + 1) * sizeof(fim_fanotify_fs), rt_fanotify_fs);
+    memcpy(rt_fanotify_fs[rt_fanotify_fs_count].fsid, fsid, sizeof(fsid));
+    rt_fanotify_fs[rt_fanotify_fs_count].mount_fd = mount_fd;
+    rt_fanotify_fs_count++;
+
+    mdebug2(FIM_FANOTIFY_NEW_FILESYSTEM, dir);
+
+    return 1;
+}
+
+/**
+ * @brief Resolves the path of a fanotify event from its file handle.
+ *
+ * @param metadata Event.
+ * @param path Buffer for the path.
+ * @param size Size of the buffer.
+ * @return 0 on success, -1 if the path can't be resolved (e.g. the object no longer exists).
+ */
+static int realtime_fanotify_path(const struct fanotify_event_metadata *metadata, char *path, size_t size) {
+    const struct fanotify_event_info_fid *fid = (const struct fanotify_event_info_fid *)(metadata + 1);
+    struct file_handle *handle;
+    const char *name = NULL;
+    char fd_path[OS_SIZE_64];
+    int mount_fd = -1;
+    ssize_t len;
+    int fd;
+
+    if (metadata->event_len < metadata->metadata_len + sizeof(struct fanotify_event_info_fid)) {
+        return -1;
+    }
+
+    handle = (struct file_handle *)fid->handle;
+
+#ifdef FAN_EVENT_INFO_TYPE_DFID_NAME
+    if (fid->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME) {
+        name = (const char *)(handle->f_handle + handle->handle_bytes);
+
+        if (strcmp(name, ".") == 0) {
+            name = NULL;
+        }
+    } else
+#endif
+    if (fid->hdr.info_type != FAN_EVENT_INFO_TYPE_FID) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < rt_fanotify_fs_count; i++) {
+        if (memcmp(rt_fanotify_fs[i].fsid, &fid->fsid, sizeof(rt_fanotify_fs[i].fsid)) == 0) {
+            mount_fd = rt_fanotify_fs[i].mount_fd;
+            break;
+        }
+    }
+
+    if (mount_fd < 0) {
+        return -1;
+    }
+
+    if (fd = open_by_handle_at(mount_fd, handle, O_RDONLY | O_PATH), fd < 0) {
+        return -1;
+    }
+
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
+    len = readlink(fd_path, path, size - 1);
+    close(fd);
+
+    if (len < 0) {
+        return -1;
+    }
+
+    path[len] = '\0';
+
+    if (name != NULL && snprintf(path + len, size - len, "%s%s", len > 0 && path[len - 1] == PATH_SEP ? "" : "/",
+                                 name) >= (int)(size - len)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Checks whether a path is under a directory monitored in real-time.
+ * @details The marks cover whole filesystems, so most of the events are discarded here.
+ *
+ * @param path Path of the event.
+ * @return true if the path must be checked.
+ */
+static bool realtime_fanotify_monitored(const char *path) {
+    directory_t *configuration;
+    bool monitored;
+
+    w_rwlock_rdlock(&syscheck.directories_lock);
+    configuration = fim_configuration_directory(path);
+    monitored = configuration != NULL && FIM_MODE(configuration->options) == FIM_REALTIME;
+    w_rwlock_unlock(&syscheck.directories_lock);
+
+    return monitored;
+}
+
+static void realtime_process_fanotify() {
+    struct fanotify_event_metadata buf[REALTIME_EVENT_BUFFER / sizeof(struct fanotify_event_metadata)];
+    const struct fanotify_event_metadata *metadata;
+    char path[PATH_MAX + 1];
+    ssize_t len;
+
+    w_mutex_lock(&syscheck.fim_realtime_mutex);
+    len = read(syscheck.realtime->fd, buf, sizeof(buf));
+
+    if (len < 0) {
+        w_mutex_unlock(&syscheck.fim_realtime_mutex);
+        merror(FIM_ERROR_REALTIME_READ_BUFFER);
+        return;
+    }
+
+    rb_tree * tree = rbtree_init();
+
+    for (metadata = buf; FAN_EVENT_OK(metadata, len); metadata = FAN_EVENT_NEXT(metadata, len)) {
+        if (metadata->mask & FAN_Q_OVERFLOW) {
+            mwarn("Real-time fanotify queue is full. Some events may be lost. Next scheduled scan will recover lost data.");
+            fim_realtime_set_queue_overflow(true);
+            send_log_msg("ossec: Real-time fanotify queue is full. Some events may be lost. Next scheduled scan will recover lost data.");
+            continue;
+        }
+
+        rt_received_events++;
+
+        if (metadata->fd >= 0) {
+            close(metadata->fd);
+        }
+
+        if (realtime_fanotify_path(metadata, path, sizeof(path)) != 0) {
+            continue;
+        }
+
+        if (realtime_fanotify_monitored(path) && rbtree_insert(tree, path, NULL) == NULL) {
+            mdebug2("Duplicate event in real-time buffer: %s", path);
+        }
+    }
+
+    w_mutex_unlock(&syscheck.fim_realtime_mutex);
+
+    realtime_dispatch_events(tree);
+}
+#endif /* FANOTIFY_ENABLED */
+
+long realtime_coalesce_timeout() {
+    char **paths;
+    long long now;
+    long long next = -1;
+    long long *deadline;
+
+    if (rt_pending_events == NULL || rbtree_empty(rt_pending_events)) {
+        return -1;
+    }
+
+    paths = rbtree_keys(rt_pending_events);
+
+    for (int i = 0; paths[i] != NULL; i++) {
+        deadline = (long long *)rbtree_get(rt_pending_events, paths[i]);
+
+        if (deadline != NULL && (next < 0 || *deadline < next)) {
+            next = *deadline;
+        }
+    }
+
+    free_strarray(paths);
+
+    if (next < 0) {
+        return -1;
+    }
+
+    now = realtime_now_ms();
+    return next > now ? (long)(next - now) : 0;
+}
 
 int realtime_start() {
     OSListNode *node_it;
@@ -45,6 +413,20 @@ int realtime_start() {
 
     OSHash_SetFreeDataPointer(syscheck.realtime->dirtb, (void (*)(void *))free);
 
+    if (syscheck.rt_fanotify) {
+#ifdef FANOTIFY_ENABLED
+        if (syscheck.realtime->fd = realtime_fanotify_init(), syscheck.realtime->fd >= 0) {
+            syscheck.realtime->fanotify = 1;
+            minfo(FIM_REALTIME_FANOTIFY);
+            return (0);
+        }
+
+        mwarn(FIM_WARN_FANOTIFY_INITIALIZE, errno, strerror(errno));
+#else
+        mwarn(FIM_WARN_FANOTIFY_UNSUPPORTED);
+#endif
+    }
+
     syscheck.realtime->fd = inotify_init();
     if (syscheck.realtime->fd < 0) {
         merror(FIM_ERROR_INOTIFY_INITIALIZE);
@@ -75,6 +457,13 @@ int fim_add_inotify_watch(const char *dir, const directory_t *configuration) {
     if (syscheck.realtime->fd < 0) {
         w_mutex_unlock(&syscheck.fim_realtime_mutex);
         return (-1);
+#ifdef FANOTIFY_ENABLED
+    } else if (syscheck.realtime->fanotify) {
+        // A single mark covers every directory in the filesystem
+        int retval = realtime_fanotify_mark(dir);
+        w_mutex_unlock(&syscheck.fim_realtime_mutex);
+        return retval;
+#endif
     } else {
         int wd = 0;
 
@@ -203,6 +592,13 @@ void realtime_process() {
     char buf[REALTIME_EVENT_BUFFER + 1];
     struct inotify_event *event;
 
+#ifdef FANOTIFY_ENABLED
+    if (syscheck.realtime->fanotify) {
+        realtime_process_fanotify();
+        return;
+    }
+#endif
+
     buf[REALTIME_EVENT_BUFFER] = '\0';
 
     w_mutex_lock(&syscheck.fim_realtime_mutex);
@@ -235,6 +631,7 @@ void realtime_process() {
         }
 
         snprintf(wdchar, 33, "%d", event->wd);
+        rt_received_events++;
 
         w_mutex_lock(&syscheck.fim_realtime_mutex);
         // The configured paths can end at / or not, we must check it.
@@ -274,16 +671,7 @@ void realtime_process() {
         w_mutex_unlock(&syscheck.fim_realtime_mutex);
     }
 
-    char ** paths = rbtree_keys(tree);
-
-    for (int i = 0; paths[i] != NULL; i++) {
-        w_rwlock_rdlock(&syscheck.directories_lock);
-        fim_realtime_event(paths[i]);
-        w_rwlock_unlock(&syscheck.directories_lock);
-    }
-
-    free_strarray(paths);
-    rbtree_destroy(tree);
+    realtime_dispatch_events(tree);
 }
 
 int realtime_update_watch(const char *wd, const char *dir) {
@@ -431,19 +819,52 @@ void free_win32rtfim_data(win32rtfim *data);
 int realtime_win32read(win32rtfim *rtlocald);
 int fim_check_realtime_directory(win32rtfim *rtlocald);
 
+// Remove a watch without pending operations, realtime_adddir() opens it again
+static void realtime_win32_remove(win32rtfim *rtlocald) {
+    if (rtlocald->watch_status == FIM_RT_HANDLE_OPEN) {
+        CloseHandle(rtlocald->h);
+    }
+
+    rtlocald = OSHash_Delete_ex(syscheck.realtime->dirtb, rtlocald->dir);
+    mdebug2(FIM_REALTIME_CALLBACK, rtlocald->dir);
+    free_win32rtfim_data(rtlocald);
+}
+
 void CALLBACK RTCallBack(DWORD dwerror, DWORD dwBytes, LPOVERLAPPED overlap)
 {
     int lcount;
     size_t offset = 0;
-    char wdchar[260 + 1] = {0};
     char final_path[MAX_LINE + 1];
-    win32rtfim *rtlocald;
+    win32rtfim *rtlocald = CONTAINING_RECORD(overlap, win32rtfim, overlap);
     PFILE_NOTIFY_INFORMATION pinfo;
     TCHAR finalfile[MAX_PATH];
+    char **paths = NULL;
+    char *rescan = NULL;
+    int npaths = 0;
+    int i;
 
     memset(final_path, '\0', MAX_LINE + 1);
 
-    if (dwerror != ERROR_SUCCESS) {
+    /* Get hash to parse the data */
+    w_rwlock_rdlock(&syscheck.directories_lock);
+    w_mutex_lock(&syscheck.fim_realtime_mutex);
+
+    if (rtlocald->dir == NULL || OSHash_Get_ex(syscheck.realtime->dirtb, rtlocald->dir) != rtlocald) {
+        merror(FIM_ERROR_REALTIME_WINDOWS_CALLBACK_EMPTY);
+        w_mutex_unlock(&syscheck.fim_realtime_mutex);
+        w_rwlock_unlock(&syscheck.directories_lock);
+        return;
+    }
+
+    // The handle was closed: this is the last completion of the watch
+    if (rtlocald->watch_status == FIM_RT_HANDLE_CLOSED) {
+        realtime_win32_remove(rtlocald);
+        w_mutex_unlock(&syscheck.fim_realtime_mutex);
+        w_rwlock_unlock(&syscheck.directories_lock);
+        return;
+    }
+
+    if (dwerror != ERROR_SUCCESS && dwerror != ERROR_NOTIFY_ENUM_DIR) {
         LPSTR messageBuffer = NULL;
         LPSTR end;
 
@@ -457,32 +878,17 @@ void CALLBACK RTCallBack(DWORD dwerror, DWORD dwBytes, LPOVERLAPPED overlap)
             merror(FIM_ERROR_REALTIME_WINDOWS_CALLBACK, messageBuffer, dwerror);
             LocalFree(messageBuffer);
         }
-        return;
-    }
 
-    /* Get hash to parse the data */
-    w_rwlock_rdlock(&syscheck.directories_lock);
-    w_mutex_lock(&syscheck.fim_realtime_mutex);
-    snprintf(wdchar, 260, "%s", (char*)overlap->hEvent);
-    rtlocald = OSHash_Get_ex(syscheck.realtime->dirtb, wdchar);
-    if (rtlocald == NULL) {
-        merror(FIM_ERROR_REALTIME_WINDOWS_CALLBACK_EMPTY);
+        realtime_win32_remove(rtlocald);
         w_mutex_unlock(&syscheck.fim_realtime_mutex);
         w_rwlock_unlock(&syscheck.directories_lock);
         return;
     }
 
-    if(rtlocald->watch_status == FIM_RT_HANDLE_CLOSED) {
-        rtlocald = OSHash_Delete_ex(syscheck.realtime->dirtb, wdchar);
-        free_win32rtfim_data(rtlocald);
-        mdebug2(FIM_REALTIME_CALLBACK, wdchar);
-        w_mutex_unlock(&syscheck.fim_realtime_mutex);
-        w_rwlock_unlock(&syscheck.directories_lock);
-        return;
-    }
-
-    if (dwBytes) {
+    directory_t *index = fim_configuration_directory(rtlocald->dir);
 
+    if (dwerror == ERROR_SUCCESS && dwBytes) {
+        // Take the paths out of the buffer, so it can be filled again while they are processed
         do {
             pinfo = (PFILE_NOTIFY_INFORMATION) &rtlocald->buffer[offset];
             offset += pinfo->NextEntryOffset;
@@ -494,42 +900,100 @@ void CALLBACK RTCallBack(DWORD dwerror, DWORD dwBytes, LPOVERLAPPED overlap)
 
             final_path[MAX_LINE] = '\0';
 
-            if (rtlocald->dir) {
-                if (rtlocald->dir[strlen(rtlocald->dir) - 1] == PATH_SEP) {
-                    snprintf(final_path, MAX_LINE, "%s%s",
-                            rtlocald->dir,
-                            finalfile);
-                } else {
-                    snprintf(final_path, MAX_LINE, "%s\\%s",
-                            rtlocald->dir,
-                            finalfile);
-                }
+            if (rtlocald->dir[strlen(rtlocald->dir) - 1] == PATH_SEP) {
+                snprintf(final_path, MAX_LINE, "%s%s",
+                        rtlocald->dir,
+                        finalfile);
+            } else {
+                snprintf(final_path, MAX_LINE, "%s\\%s",
+                        rtlocald->dir,
+                        finalfile);
             }
             str_lowercase(final_path);
 
-            directory_t *index = fim_configuration_directory(wdchar);
-            directory_t *file_index = fim_configuration_directory(final_path);
-
-            if (index == file_index) {
-                /* Check the change */
-                fim_realtime_event(final_path);
+            if (index == fim_configuration_directory(final_path)) {
+                os_realloc(paths, (npaths + 1) * sizeof(char *), paths);
+                os_strdup(final_path, paths[npaths]);
+                npaths++;
             }
 
         } while (pinfo->NextEntryOffset != 0);
+    } else {
+        // The changes didn't fit in the buffer: make it larger and scan the directory
+        mwarn(FIM_WARN_REALTIME_OVERFLOW_DIR, rtlocald->dir);
+
+        if (rtlocald->buffer_size < FIM_RT_BUFFER_MAX) {
+            rtlocald->buffer_size *= 2;
+            os_realloc(rtlocald->buffer, rtlocald->buffer_size, rtlocald->buffer);
+            mdebug2(FIM_REALTIME_BUFFER_SIZE, rtlocald->dir, (unsigned long)rtlocald->buffer_size);
+        }
+
+        os_strdup(rtlocald->dir, rescan);
+        str_lowercase(rescan);
     }
-    else {
-        mwarn(FIM_WARN_REALTIME_OVERFLOW);
+
+    if (realtime_win32read(rtlocald) == 0) {
+        mdebug1(FIM_REALTIME_DIRECTORYCHANGES, rtlocald->dir);
+        realtime_win32_remove(rtlocald);
     }
 
-    realtime_win32read(rtlocald);
     w_mutex_unlock(&syscheck.fim_realtime_mutex);
+
+    for (i = 0; i < npaths; i++) {
+        /* Check the change */
+        fim_realtime_event(paths[i]);
+        os_free(paths[i]);
+    }
+
+    if (rescan) {
+        fim_realtime_rescan(rescan);
+        os_free(rescan);
+    }
+
     w_rwlock_unlock(&syscheck.directories_lock);
-    return;
+    os_free(paths);
+}
+
+int realtime_win32_dequeue(DWORD timeout) {
+    LPOVERLAPPED overlap = NULL;
+    ULONG_PTR key;
+    DWORD bytes = 0;
+    DWORD error;
+
+    if (GetQueuedCompletionStatus(syscheck.realtime->iocp, &bytes, &key, &overlap, timeout)) {
+        RTCallBack(ERROR_SUCCESS, bytes, overlap);
+        return 1;
+    }
+
+    error = GetLastError();
+
+    // The operation failed, not the port
+    if (overlap != NULL) {
+        RTCallBack(error, bytes, overlap);
+        return 1;
+    }
+
+    if (error == WAIT_TIMEOUT) {
+        return 0;
+    }
+
+    merror(FIM_ERROR_REALTIME_WAITSINGLE_OBJECT);
+    return -1;
+}
+
+DWORD WINAPI realtime_win32_worker(__attribute__((unused)) void * args) {
+    while (FOREVER()) {
+        if (realtime_win32_dequeue(INFINITE) < 0) {
+            sleep(1);
+        }
+    }
+
+    return 0;
 }
 
 void free_win32rtfim_data(win32rtfim *data) {
     if (!data) return;
-    os_free(data->overlap.hEvent);
+    os_free(data->buffer);
     os_free(data->dir);
     os_free(data);
 }
@@ -573,7 +1037,10 @@ int realtime_start() {
     }
     OSHash_SetFreeDataPointer(syscheck.realtime->dirtb, (void (*)(void *))free_win32rtfim_data);
 
-    syscheck.realtime->evt = CreateEvent(NULL, TRUE, FALSE, NULL);
+    syscheck.realtime->iocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, FIM_RT_WORKERS);
+    if (syscheck.realtime->iocp == NULL) {
+        merror(FIM_ERROR_REALTIME_PORT, GetLastError());
+    }
 
     return (0);
 }
@@ -582,15 +1049,22 @@ int realtime_win32read(win32rtfim *rtlocald)
 {
     int rc;
 
+    // The completion is queued to the port
     rc = ReadDirectoryChangesW(rtlocald->h,
                                rtlocald->buffer,
-                               sizeof(rtlocald->buffer) / sizeof(TCHAR),
+                               rtlocald->buffer_size,
                                TRUE,
                                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE |
                                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SECURITY,
-                               0,
+                               NULL,
                                &rtlocald->overlap,
-                               RTCallBack);
+                               NULL);
+
+    // Network shares don't allow buffers larger than 64 KiB
+    if (rc == 0 && rtlocald->buffer_size > FIM_RT_BUFFER_SIZE && GetLastError() == ERROR_INVALID_PARAMETER) {
+        rtlocald->buffer_size = FIM_RT_BUFFER_SIZE;
+        return realtime_win32read(rtlocald);
+    }
 
     return rc;
 }
@@ -682,9 +1156,19 @@ int realtime_adddir(const char *dir, directory_t *configuration) {
         return 0;
     }
 
+    if (CreateIoCompletionPort(rtlocald->h, syscheck.realtime->iocp, 0, 0) == NULL) {
+        CloseHandle(rtlocald->h);
+        os_free(rtlocald);
+        mdebug2(FIM_REALTIME_ADD, dir);
+
+        w_mutex_unlock(&syscheck.fim_realtime_mutex);
+        return 0;
+    }
+
     /* Add final elements to the hash */
     os_strdup(dir, rtlocald->dir);
-    os_strdup(dir, rtlocald->overlap.hEvent);
+    rtlocald->buffer_size = FIM_RT_BUFFER_SIZE;
+    os_malloc(rtlocald->buffer_size, rtlocald->buffer);
     rtlocald->watch_status = FIM_RT_HANDLE_OPEN;
 
     /* Add directory to be monitored */
@@ -51,12 +51,21 @@ void init_magic(magic_t *cookie_ptr)
 void read_internal(int debug_level)
 {
     syscheck.rt_delay = getDefine_Int("syscheck", "rt_delay", 0, 1000);
+#ifdef INOTIFY_ENABLED
+    syscheck.rt_coalesce_window = getDefine_Int("syscheck", "rt_coalesce_window", 0, 60000);
+    syscheck.rt_fanotify = getDefine_Int("syscheck", "rt_fanotify", 0, 1);
+#endif
     syscheck.max_depth = getDefine_Int("syscheck", "default_max_depth", 1, 320);
     syscheck.file_max_size = (size_t)getDefine_Int("syscheck", "file_max_size", 0, 4095) * 1024 * 1024;
     syscheck.sym_checker_interval = getDefine_Int("syscheck", "symlink_scan_interval", 1, 2592000);
+    syscheck.scan_threads = (unsigned int)getDefine_Int("syscheck", "scan_threads", 1, 32);
+    syscheck.db_memory_limit = (unsigned int)getDefine_Int("syscheck", "db_memory_limit", 1, 65536);
+    syscheck.diff_size_reconcile = (unsigned int)getDefine_Int("syscheck", "diff_size_reconcile", 1, 1000);
 
 #ifndef WIN32
     syscheck.max_audit_entries = getDefine_Int("syscheck", "max_audit_entries", 1, 4096);
+    syscheck.audit_process_cache = getDefine_Int("syscheck", "audit_process_cache", 0, 65536);
+    syscheck.diff_chunking = (unsigned int)getDefine_Int("syscheck", "diff_chunking", 0, 1);
 #endif
     sys_debug_level = getDefine_Int("syscheck", "debug", 0, 2);
 
@@ -88,7 +97,8 @@ void fim_initialize() {
                                          0,
                                          false,
                                          syscheck.sync_thread_pool,
-                                         syscheck.sync_queue_size);
+                                         syscheck.sync_queue_size,
+                                         syscheck.db_memory_limit);
 #else
     FIMDBErrorCode ret_val = fim_db_init(syscheck.database_store,
                                          syscheck.sync_interval,
@@ -100,7 +110,8 @@ void fim_initialize() {
                                          syscheck.db_entry_registry_limit,
                                          syscheck.enable_registry_synchronization,
                                          syscheck.sync_thread_pool,
-                                         syscheck.sync_queue_size);
+                                         syscheck.sync_queue_size,
+                                         syscheck.db_memory_limit);
 #endif
 
     if (ret_val != FIMDB_OK) {
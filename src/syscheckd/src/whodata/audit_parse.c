@@ -19,221 +19,245 @@
 #define STATIC
 #endif
 
-static regex_t regexCompiled_uid;
-static regex_t regexCompiled_pid;
-static regex_t regexCompiled_ppid;
-static regex_t regexCompiled_gid;
-static regex_t regexCompiled_auid;
-static regex_t regexCompiled_euid;
-
-static regex_t regexCompiled_cwd;
-static regex_t regexCompiled_pname;
-static regex_t regexCompiled_path0;
-static regex_t regexCompiled_path1;
-static regex_t regexCompiled_path2;
-static regex_t regexCompiled_path3;
-static regex_t regexCompiled_path4;
-
-static regex_t regexCompiled_cwd_hex;
-static regex_t regexCompiled_pname_hex;
-static regex_t regexCompiled_path0_hex;
-static regex_t regexCompiled_path1_hex;
-static regex_t regexCompiled_path2_hex;
-static regex_t regexCompiled_path3_hex;
-static regex_t regexCompiled_path4_hex;
-
-static regex_t regexCompiled_items;
-static regex_t regexCompiled_inode;
-static regex_t regexCompiled_dir;
-static regex_t regexCompiled_dir_hex;
-static regex_t regexCompiled_syscall;
-static regex_t regexCompiled_dev;
-
-// Initialize regular expressions
-int init_regex(void) {
-
-    static const char *pattern_uid = " uid=([0-9]*) ";
-    if (regcomp(&regexCompiled_uid, pattern_uid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "uid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_gid = " gid=([0-9]*) ";
-    if (regcomp(&regexCompiled_gid, pattern_gid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "gid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_auid = " auid=([0-9]*) ";
-    if (regcomp(&regexCompiled_auid, pattern_auid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "auid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_euid = " euid=([0-9]*) ";
-    if (regcomp(&regexCompiled_euid, pattern_euid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "euid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_pid = " pid=([0-9]*) ";
-    if (regcomp(&regexCompiled_pid, pattern_pid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "pid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_ppid = " ppid=([0-9]*) ";
-    if (regcomp(&regexCompiled_ppid, pattern_ppid, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "ppid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_inode = " item=[0-9] name=.* inode=([0-9]*)";
-    if (regcomp(&regexCompiled_inode, pattern_inode, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "inode"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+#define AUDIT_FIELD_DELIMITERS " \n\035"
+#define AUDIT_HEX_DIGITS "0123456789ABCDEFabcdef"
+#define AUDIT_DEC_DIGITS "0123456789"
+
+// Fields read from the records of a reassembled audit event
+typedef enum audit_field_id {
+    AUDIT_FIELD_UID,
+    AUDIT_FIELD_GID,
+    AUDIT_FIELD_AUID,
+    AUDIT_FIELD_EUID,
+    AUDIT_FIELD_PID,
+    AUDIT_FIELD_PPID,
+    AUDIT_FIELD_ITEMS,
+    AUDIT_FIELD_SYSCALL,
+    AUDIT_FIELD_EXE,
+    AUDIT_FIELD_CWD,
+    AUDIT_FIELD_DIR,
+    AUDIT_FIELD_DEV,
+    AUDIT_FIELD_INODE,
+    AUDIT_FIELD_PATH0, // Name of the PATH record with item=0, and so on up to item=4
+    AUDIT_FIELD_PATH1,
+    AUDIT_FIELD_PATH2,
+    AUDIT_FIELD_PATH3,
+    AUDIT_FIELD_PATH4,
+    AUDIT_FIELD_COUNT
+} audit_field_id;
+
+static const char *AUDIT_FIELD_KEYS[AUDIT_FIELD_PATH0] = {
+    "uid", "gid", "auid", "euid", "pid", "ppid", "items", "syscall", "exe", "cwd", "dir", "dev", "inode"
+};
+
+// Slices of the audit message holding the value of a field
+typedef struct audit_event_field {
+    const char *value;    // Value of the first occurrence of the key
+    size_t length;
+    const char *quoted;   // First value enclosed in double quotes, without them
+    size_t quoted_length;
+    const char *number;   // First value made only of decimal digits
+    size_t number_length;
+} audit_field_t;
+
+// Parent process data kept between events
+typedef struct audit_process_info {
+    unsigned long long start_time; // Start time of the process in clock ticks since boot
+    char *name;
+    char *cwd;
+} audit_process_info_t;
+
+static rb_tree *audit_process_cache = NULL;
+static unsigned int audit_process_cache_size = 0;
+
+static void audit_process_info_free(void *data) {
+    audit_process_info_t *info = data;
+
+    if (info == NULL) {
+        return;
     }
 
-    static const char *pattern_items = " items=([0-9]*) ";
-    if (regcomp(&regexCompiled_items, pattern_items, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "items"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    os_free(info->name);
+    os_free(info->cwd);
+    os_free(info);
+}
 
-    static const char *pattern_syscall = " syscall=([0-9]*)";
-    if (regcomp(&regexCompiled_syscall, pattern_syscall, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "syscall"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+// Initialize the state kept by the audit event parser
+int init_audit_parser(void) {
+    if (audit_process_cache == NULL) {
+        audit_process_cache = rbtree_init();
+        rbtree_set_dispose(audit_process_cache, audit_process_info_free);
+        audit_process_cache_size = 0;
     }
 
-    static const char *pattern_pname = " exe=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_pname, pattern_pname, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "pname"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_cwd = " cwd=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_cwd, pattern_cwd, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "cwd"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    return 0;
+}
 
-    static const char *pattern_dir = " dir=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_dir, pattern_dir, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "dir"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+void clean_audit_parser() {
+    if (audit_process_cache == NULL) { // Prevent double free
+        return;
     }
 
-    static const char *pattern_path0 = " item=0 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path0, pattern_path0, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path0"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path1 = " item=1 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path1, pattern_path1, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path1"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path2 = " item=2 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path2, pattern_path2, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path2"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path3 = " item=3 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path3, pattern_path3, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path3"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path4 = " item=4 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path4, pattern_path4, REG_EXTENDED)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path4"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    rbtree_destroy(audit_process_cache);
+    audit_process_cache = NULL;
+    audit_process_cache_size = 0;
+}
 
-    static const char *pattern_pname_hex = " exe=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_pname_hex, pattern_pname_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "pname_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+/**
+ * @brief Stores a value in the slices of a field, keeping the first one of each kind.
+ *
+ * @param field Field to update.
+ * @param value Value found in the message, not null-terminated.
+ * @param length Length of the value.
+ */
+static void audit_field_store(audit_field_t *field, const char *value, size_t length) {
+    if (field->value == NULL) {
+        field->value = value;
+        field->length = length;
     }
 
-    static const char *pattern_cwd_hex = " cwd=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_cwd_hex, pattern_cwd_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "cwd_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    if (field->quoted == NULL && length > 1 && *value == '"') {
+        size_t end;
 
-    static const char *pattern_dir_hex = " dir=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_dir_hex, pattern_dir_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "dir_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+        for (end = length - 1; end > 0 && value[end] != '"'; end--);
 
-    static const char *pattern_path0_hex = " item=0 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path0_hex, pattern_path0_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path0_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+        if (end > 0) {
+            field->quoted = value + 1;
+            field->quoted_length = end - 1;
+        }
     }
 
-    static const char *pattern_path1_hex = " item=1 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path1_hex, pattern_path1_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path1_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (field->number == NULL && strspn(value, AUDIT_DEC_DIGITS) == length) {
+        field->number = value;
+        field->number_length = length;
     }
+}
 
-    static const char *pattern_path2_hex = " item=2 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path2_hex, pattern_path2_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path2_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+/**
+ * @brief Checks if a value starts with a device number in the format major:minor (hexadecimal).
+ *
+ * @param value Value of a dev field.
+ * @return Length of the device number, 0 if there is none.
+ */
+static size_t audit_device_length(const char *value) {
+    size_t major = strspn(value, AUDIT_HEX_DIGITS);
 
-    static const char *pattern_path3_hex = " item=3 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path3_hex, pattern_path3_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path3_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (value[major] != ':') {
+        return 0;
     }
 
-    static const char *pattern_path4_hex = " item=4 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path4_hex, pattern_path4_hex, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "path4_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    return major + 1 + strspn(value + major + 1, AUDIT_HEX_DIGITS);
+}
+
+/**
+ * @brief Splits an audit event in its key=value fields in a single pass over the message.
+ *
+ * Only the fields used to build whodata events are kept. The name of a PATH record is stored
+ * according to the item that precedes it, and the inode is the last one found after the first
+ * PATH record.
+ *
+ * @param buffer Audit message, with one or more records.
+ * @param fields Array of AUDIT_FIELD_COUNT fields to fill.
+ */
+STATIC void audit_tokenize_event(const char *buffer, audit_field_t *fields) {
+    const char *token = buffer;
+    int path_item = -1;
+    int path_found = 0;
+    int i;
+
+    memset(fields, 0, AUDIT_FIELD_COUNT * sizeof(audit_field_t));
+
+    while (token += strspn(token, AUDIT_FIELD_DELIMITERS), *token != '\0') {
+        const size_t token_length = strcspn(token, AUDIT_FIELD_DELIMITERS);
+        const char *equal = memchr(token, '=', token_length);
+        audit_field_t *field = NULL;
+        int item = -1;
+
+        if (equal != NULL) {
+            const size_t key_length = equal - token;
+            const char *value = equal + 1;
+            const size_t value_length = token_length - key_length - 1;
+
+            if (key_length == 4 && memcmp(token, "item", 4) == 0) {
+                if (value_length == 1 && isdigit((unsigned char)*value)) {
+                    item = *value - '0';
+                }
+            } else if (key_length == 4 && memcmp(token, "name", 4) == 0) {
+                if (path_item >= 0) {
+                    path_found = 1;
+
+                    if (path_item <= AUDIT_FIELD_PATH4 - AUDIT_FIELD_PATH0) {
+                        field = &fields[AUDIT_FIELD_PATH0 + path_item];
+                    }
+                }
+            } else {
+                for (i = 0; i < AUDIT_FIELD_PATH0; i++) {
+                    if (strlen(AUDIT_FIELD_KEYS[i]) == key_length && memcmp(token, AUDIT_FIELD_KEYS[i], key_length) == 0) {
+                        field = &fields[i];
+                        break;
+                    }
+                }
+            }
+
+            if (field == &fields[AUDIT_FIELD_INODE]) {
+                if (path_found) {
+                    // Every PATH record overrides the inode of the previous one
+                    field->value = value;
+                    field->length = strspn(value, AUDIT_DEC_DIGITS);
+                }
+            } else if (field == &fields[AUDIT_FIELD_DEV]) {
+                if (field->value == NULL && audit_device_length(value) > 0) {
+                    field->value = value;
+                    field->length = audit_device_length(value);
+                }
+            } else if (field != NULL) {
+                audit_field_store(field, value, value_length);
+            }
+        }
+
+        path_item = item;
+        token += token_length;
     }
-    static const char *pattern_dev = " dev=([A-F0-9]*:[A-F0-9]*)";
-    if (regcomp(&regexCompiled_dev, pattern_dev, REG_EXTENDED | REG_ICASE)) {
-        merror(FIM_ERROR_WHODATA_COMPILE_REGEX, "dev"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+}
+
+/**
+ * @brief Copies the value of a numeric field.
+ *
+ * @param field Field to copy.
+ * @return Null-terminated copy of the value, NULL if no value made of digits was found.
+ */
+static char *audit_field_number(const audit_field_t *field) {
+    char *number = NULL;
+
+    if (field->number != NULL) {
+        os_calloc(field->number_length + 1, sizeof(char), number);
+        memcpy(number, field->number, field->number_length);
     }
-    return 0;
+
+    return number;
 }
 
-void clean_regex() {
-    static int freed = 0;
+/**
+ * @brief Copies the value of a field that may be written as text between quotes or encoded in hexadecimal.
+ *
+ * @param field Field to copy.
+ * @return Null-terminated value, NULL if the field wasn't found or the hexadecimal value couldn't be decoded.
+ */
+static char *audit_field_text(const audit_field_t *field) {
+    char *text = NULL;
+
+    if (field->quoted != NULL) {
+        os_calloc(field->quoted_length + 1, sizeof(char), text);
+        memcpy(text, field->quoted, field->quoted_length);
+    } else if (field->value != NULL) {
+        const size_t hex_length = strspn(field->value, AUDIT_HEX_DIGITS);
 
-    if (freed) { // Prevent double free
-        return;
+        if (text = decode_hex_buffer_2_ascii_buffer(field->value, hex_length), text == NULL) {
+            merror("Error found while decoding HEX bufer: '%.*s'", (int)hex_length, field->value);
+        }
     }
 
-    regfree(&regexCompiled_uid);
-    regfree(&regexCompiled_gid);
-    regfree(&regexCompiled_auid);
-    regfree(&regexCompiled_euid);
-    regfree(&regexCompiled_pid);
-    regfree(&regexCompiled_ppid);
-    regfree(&regexCompiled_inode);
-    regfree(&regexCompiled_items);
-    regfree(&regexCompiled_syscall);
-    regfree(&regexCompiled_pname);
-    regfree(&regexCompiled_cwd);
-    regfree(&regexCompiled_dir);
-    regfree(&regexCompiled_path0);
-    regfree(&regexCompiled_path1);
-    regfree(&regexCompiled_path2);
-    regfree(&regexCompiled_path3);
-    regfree(&regexCompiled_path4);
-
-    regfree(&regexCompiled_pname_hex);
-    regfree(&regexCompiled_cwd_hex);
-    regfree(&regexCompiled_dir_hex);
-    regfree(&regexCompiled_path0_hex);
-    regfree(&regexCompiled_path1_hex);
-    regfree(&regexCompiled_path2_hex);
-    regfree(&regexCompiled_path3_hex);
-    regfree(&regexCompiled_path4_hex);
-    regfree(&regexCompiled_dev);
-
-    freed = 1;
+    return text;
 }
 
 /**
@@ -425,6 +449,89 @@ void get_parent_process_info(char *ppid, char **const parent_name, char **const
 }
 
 
+/**
+ * @brief Reads the start time of a process, which tells apart processes that reuse the same pid.
+ *
+ * @param pid Process ID.
+ * @return Start time in clock ticks since boot, 0 if it couldn't be read.
+ */
+STATIC unsigned long long audit_get_process_start_time(const char *pid) {
+    char path[OS_SIZE_64];
+    char line[OS_SIZE_1024];
+    char *field = NULL;
+    char *save_ptr = NULL;
+    unsigned long long start_time = 0;
+    FILE *fp;
+    int i;
+
+    snprintf(path, sizeof(path), "/proc/%s/stat", pid);
+
+    if (fp = wfopen(path, "r"), fp == NULL) {
+        return 0;
+    }
+
+    // The process name may contain spaces, so fields are counted from its closing parenthesis
+    if (fgets(line, sizeof(line), fp) != NULL && (field = strrchr(line, ')'), field != NULL)) {
+        for (field = strtok_r(field + 1, " ", &save_ptr), i = 3; field != NULL;
+             field = strtok_r(NULL, " ", &save_ptr), i++) {
+            if (i == 22) {
+                start_time = strtoull(field, NULL, 10);
+                break;
+            }
+        }
+    }
+
+    fclose(fp);
+    return start_time;
+}
+
+
+/**
+ * @brief Gets the name and working directory of the parent process, reusing the ones read for
+ * previous events of the same process.
+ *
+ * @param ppid Parent process ID.
+ * @param parent_name Buffer of OS_FLSIZE bytes for the name of the parent process.
+ * @param parent_cwd Buffer of OS_FLSIZE bytes for the working directory of the parent process.
+ */
+STATIC void audit_get_parent_process_info(char *ppid, char **const parent_name, char **const parent_cwd) {
+    audit_process_info_t *info = NULL;
+    unsigned long long start_time = 0;
+
+    if (syscheck.audit_process_cache <= 0 || audit_process_cache == NULL ||
+        (start_time = audit_get_process_start_time(ppid), start_time == 0)) {
+        get_parent_process_info(ppid, parent_name, parent_cwd);
+        return;
+    }
+
+    if (info = rbtree_get(audit_process_cache, ppid), info != NULL && info->start_time == start_time) {
+        snprintf(*parent_name, OS_FLSIZE, "%s", info->name);
+        snprintf(*parent_cwd, OS_FLSIZE, "%s", info->cwd);
+        return;
+    }
+
+    get_parent_process_info(ppid, parent_name, parent_cwd);
+
+    if (info == NULL && audit_process_cache_size >= (unsigned int)syscheck.audit_process_cache) {
+        // Start over instead of tracking which entry was used last
+        clean_audit_parser();
+        init_audit_parser();
+    }
+
+    os_calloc(1, sizeof(audit_process_info_t), info);
+    info->start_time = start_time;
+    os_strdup(*parent_name, info->name);
+    os_strdup(*parent_cwd, info->cwd);
+
+    if (rbtree_insert(audit_process_cache, ppid, info) != NULL) {
+        audit_process_cache_size++;
+    } else {
+        // The pid was reused by another process
+        rbtree_replace(audit_process_cache, ppid, info);
+    }
+}
+
+
 // Extract id: node=... type=CWD msg=audit(1529332881.955:3867): cwd="..."
 char *audit_get_id(const char *event) {
     char *begin;
@@ -456,8 +563,6 @@ void audit_parse(char *buffer) {
     char *pconfig;
     char *pdelete;
     char *endptr = NULL;
-    regmatch_t match[2];
-    int match_size;
     char *path0 = NULL;
     char *path1 = NULL;
     char *path2 = NULL;
@@ -468,10 +573,17 @@ void audit_parse(char *buffer) {
     whodata_evt *w_evt;
     unsigned int items = 0;
     audit_key_type filter_key;
+    audit_field_t fields[AUDIT_FIELD_COUNT];
 
     // Checks if the key obtained is one of those configured to monitor
     filter_key = filterkey_audit_events(buffer);
 
+    if (filter_key == FIM_AUDIT_UNKNOWN_KEY) {
+        return;
+    }
+
+    audit_tokenize_event(buffer, fields);
+
     switch (filter_key) {
     case FIM_AUDIT_KEY:
         if ((pconfig = strstr(buffer, "type=CONFIG_CHANGE"), pconfig) &&
@@ -479,26 +591,7 @@ void audit_parse(char *buffer) {
              (pdelete = strstr(buffer, "op=\"remove_rule\""), pdelete))) { // Detect rules modification.
 
             // Filter rule removed
-            char *p_dir = NULL;
-            if (regexec(&regexCompiled_dir, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_calloc(1, match_size + 1, p_dir);
-                snprintf(p_dir, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            }
-
-
-            else if (regexec(&regexCompiled_dir_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, p_dir);
-                    snprintf(p_dir, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            char *p_dir = audit_field_text(&fields[AUDIT_FIELD_DIR]);
 
             if (p_dir && *p_dir != '\0') {
                 minfo(FIM_AUDIT_REMOVE_RULE, p_dir);
@@ -537,12 +630,9 @@ void audit_parse(char *buffer) {
             os_calloc(1, sizeof(whodata_evt), w_evt);
 
             // Items
-            if (regexec(&regexCompiled_items, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *chr_item;
-                os_malloc(match_size + 1, chr_item);
-                snprintf(chr_item, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            // Items
+            char *chr_item = audit_field_number(&fields[AUDIT_FIELD_ITEMS]);
+            if (chr_item) {
                 // No further checks needed on items
                 items = strtol(chr_item, NULL, 10);
 
@@ -550,11 +640,7 @@ void audit_parse(char *buffer) {
             }
 
             // user_name & user_id
-            if (regexec(&regexCompiled_uid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->user_id);
-                snprintf(w_evt->user_id, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->user_id = audit_field_number(&fields[AUDIT_FIELD_UID]), w_evt->user_id) {
                 if (w_evt->user_id[0] != '\0') {
                     errno = 0;
                     int user_id = strtol(w_evt->user_id, &endptr, 10);
@@ -567,11 +653,8 @@ void audit_parse(char *buffer) {
             }
 
             // audit_name & audit_uid
-            if (regexec(&regexCompiled_auid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *auid = NULL;
-                os_malloc(match_size + 1, auid);
-                snprintf(auid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+            char *auid = audit_field_number(&fields[AUDIT_FIELD_AUID]);
+            if (auid) {
                 if (strcmp(auid, "4294967295") == 0) { // Invalid auid (-1)
                     if (!auid_err_reported) {
                         mdebug1(FIM_AUDIT_INVALID_AUID);
@@ -596,11 +679,7 @@ void audit_parse(char *buffer) {
                 os_free(auid);
             }
             // effective_name && effective_uid
-            if (regexec(&regexCompiled_euid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->effective_uid);
-                snprintf(w_evt->effective_uid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->effective_uid = audit_field_number(&fields[AUDIT_FIELD_EUID]), w_evt->effective_uid) {
                 if (w_evt->effective_uid[0] != '\0') {
                     errno = 0;
                     int euid = strtol(w_evt->effective_uid, &endptr, 10);
@@ -612,11 +691,7 @@ void audit_parse(char *buffer) {
                 }
             }
             // group_name & group_id
-            if (regexec(&regexCompiled_gid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->group_id);
-                snprintf(w_evt->group_id, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->group_id = audit_field_number(&fields[AUDIT_FIELD_GID]), w_evt->group_id) {
                 if (w_evt->group_id[0] != '\0') {
                     errno = 0;
                     int gid = strtol(w_evt->group_id, &endptr, 10);
@@ -628,113 +703,44 @@ void audit_parse(char *buffer) {
                 }
             }
             // process_id
-            if (regexec(&regexCompiled_pid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *pid = NULL;
-                os_malloc(match_size + 1, pid);
-                snprintf(pid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            char *pid = audit_field_number(&fields[AUDIT_FIELD_PID]);
+            if (pid) {
                 w_evt->process_id = strtol(pid, &endptr, 10);
 
                 free(pid);
             }
             // ppid
-            if (regexec(&regexCompiled_ppid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *ppid = NULL;
+            char *ppid = audit_field_number(&fields[AUDIT_FIELD_PPID]);
+            if (ppid) {
                 os_malloc(OS_FLSIZE, w_evt->parent_name);
                 os_malloc(OS_FLSIZE, w_evt->parent_cwd);
-                os_malloc(match_size + 1, ppid);
-                snprintf(ppid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                get_parent_process_info(ppid, &w_evt->parent_name, &w_evt->parent_cwd);
+                audit_get_parent_process_info(ppid, &w_evt->parent_name, &w_evt->parent_cwd);
 
                 w_evt->ppid = strtol(ppid, &endptr, 10);
 
                 free(ppid);
             }
             // process_name
-            if (regexec(&regexCompiled_pname, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->process_name);
-                snprintf(w_evt->process_name, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_pname_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, w_evt->process_name);
-                    snprintf(w_evt->process_name, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            w_evt->process_name = audit_field_text(&fields[AUDIT_FIELD_EXE]);
 
             // cwd
-            if (regexec(&regexCompiled_cwd, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->cwd);
-                snprintf(w_evt->cwd, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_cwd_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, w_evt->cwd);
-                    snprintf(w_evt->cwd, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            w_evt->cwd = audit_field_text(&fields[AUDIT_FIELD_CWD]);
 
             // path0
-            if (regexec(&regexCompiled_path0, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, path0);
-                snprintf(path0, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_path0_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, path0);
-                    snprintf(path0, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            path0 = audit_field_text(&fields[AUDIT_FIELD_PATH0]);
 
             // path1
-            if (regexec(&regexCompiled_path1, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, path1);
-                snprintf(path1, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_path1_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, path1);
-                    snprintf(path1, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            path1 = audit_field_text(&fields[AUDIT_FIELD_PATH1]);
 
             // inode
-            if (regexec(&regexCompiled_inode, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->inode);
-                snprintf(w_evt->inode, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+            if (fields[AUDIT_FIELD_INODE].value) {
+                os_calloc(fields[AUDIT_FIELD_INODE].length + 1, sizeof(char), w_evt->inode);
+                memcpy(w_evt->inode, fields[AUDIT_FIELD_INODE].value, fields[AUDIT_FIELD_INODE].length);
             }
             // dev
-            if (regexec(&regexCompiled_dev, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, dev);
-                snprintf(dev, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+            if (fields[AUDIT_FIELD_DEV].value) {
+                os_calloc(fields[AUDIT_FIELD_DEV].length + 1, sizeof(char), dev);
+                memcpy(dev, fields[AUDIT_FIELD_DEV].value, fields[AUDIT_FIELD_DEV].length);
 
                 char *aux = wstr_chr(dev, ':');
 
@@ -799,22 +805,7 @@ void audit_parse(char *buffer) {
                 break;
             case 3:
                 // path2
-                if (regexec(&regexCompiled_path2, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path2);
-                    snprintf(path2, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path2_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path2);
-                        snprintf(path2, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path2 = audit_field_text(&fields[AUDIT_FIELD_PATH2]);
 
                 if (w_evt->cwd && path1 && path2) {
                     if (file_path = gen_audit_path(w_evt->cwd, path1, path2), file_path) {
@@ -835,40 +826,10 @@ void audit_parse(char *buffer) {
                 break;
             case 4:
                 // path2
-                if (regexec(&regexCompiled_path2, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path2);
-                    snprintf(path2, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path2_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path2);
-                        snprintf(path2, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path2 = audit_field_text(&fields[AUDIT_FIELD_PATH2]);
 
                 // path3
-                if (regexec(&regexCompiled_path3, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path3);
-                    snprintf(path3, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path3_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path3);
-                        snprintf(path3, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path3 = audit_field_text(&fields[AUDIT_FIELD_PATH3]);
 
                 if (w_evt->cwd && path0 && path1 && path2 && path3) {
                     // Send event 1/2
@@ -910,22 +871,7 @@ void audit_parse(char *buffer) {
                 break;
             case 5:
                 // path4
-                if (regexec(&regexCompiled_path4, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path4);
-                    snprintf(path4, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path4_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path4);
-                        snprintf(path4, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        merror("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path4 = audit_field_text(&fields[AUDIT_FIELD_PATH4]);
 
                 if (w_evt->cwd && path1 && path4) {
                     char *file_path;
@@ -953,11 +899,11 @@ void audit_parse(char *buffer) {
         }
         break;
     case FIM_AUDIT_HC_KEY:
-        if (regexec(&regexCompiled_syscall, buffer, 2, match, 0) == 0) {
-            match_size = match[1].rm_eo - match[1].rm_so;
+        if (fields[AUDIT_FIELD_SYSCALL].value) {
+            const size_t syscall_length = strspn(fields[AUDIT_FIELD_SYSCALL].value, AUDIT_DEC_DIGITS);
             char *syscall = NULL;
-            os_malloc(match_size + 1, syscall);
-            snprintf(syscall, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+            os_calloc(syscall_length + 1, sizeof(char), syscall);
+            memcpy(syscall, fields[AUDIT_FIELD_SYSCALL].value, syscall_length);
             if (!strcmp(syscall, "2") || !strcmp(syscall, "257") || !strcmp(syscall, "5") || !strcmp(syscall, "295")) {
                 // x86_64: 2 open
                 // x86_64: 257 openat
@@ -349,9 +349,8 @@ int audit_init(void) {
         return -1;
     }
 
-    int regex_comp = init_regex();
-    if (regex_comp < 0) {
-        merror("Can't init regex in 'init_regex()'");
+    if (init_audit_parser() < 0) {
+        merror("Can't init audit parser in 'init_audit_parser()'");
         return -1;
     }
 
@@ -447,8 +446,8 @@ void *audit_main(audit_data_t *audit_data) {
     mdebug1(FIM_AUDIT_THREAD_STOPED);
     close(audit_data->socket);
 
-    // Clean regexes used for parsing events
-    clean_regex();
+    // Clean the state used for parsing events
+    clean_audit_parser();
     // Change Audit monitored folders to Inotify.
     w_rwlock_wrlock(&syscheck.directories_lock);
     OSList_foreach(node_it, syscheck.directories) {
@@ -56,7 +56,7 @@ int fim_audit_rules_init();
 int fim_rules_initial_load();
 
 // Public parse functions
-void clean_regex();
+void clean_audit_parser();
 
 extern pthread_mutex_t audit_mutex;
 extern atomic_int_t audit_thread_active;
@@ -32,6 +32,10 @@
 #define criteria (DELETE | modify_criteria)
 #define WHODATA_DIR_REMOVE_INTERVAL 2
 #define FILETIME_SECOND 10000000
+#define WHODATA_EVENT_BATCH 64          // Events read from the subscription at once
+#define WHODATA_EVENT_WAIT 1000         // Milliseconds to wait for new events
+#define WHODATA_HANDLE_TIMEOUT 21600    // Seconds to drop a handle whose close event never came
+#define WHODATA_HANDLE_SWEEP 300        // Seconds between the handle expirations
 #ifdef WAZUH_UNIT_TESTING
 #ifdef WIN32
 #include "unit_tests/wrappers/windows/aclapi_wrappers.h"
@@ -94,6 +98,10 @@ STATIC int restore_policies = 0;
 STATIC int policies_checked = 0;
 atomic_int_t whodata_end = ATOMIC_INT_INITIALIZER(0);
 EVT_HANDLE evt_subscribe_handle;  // Subscribe handle.
+STATIC HANDLE whodata_signal;     // Set by the event log when the subscription has events
+// Render buffer, only used by the thread that reads the subscription
+STATIC PEVT_VARIANT render_buffer;
+STATIC unsigned long render_buffer_size;
 
 // Whodata function headers
 void restore_sacls();
@@ -171,6 +179,7 @@ STATIC void win_whodata_release_resources(whodata *wdata) {
 
     if (evt_subscribe_handle != NULL) {
         EvtClose(evt_subscribe_handle);
+        evt_subscribe_handle = NULL;
     }
 
     if (wdata->fd != NULL) {
@@ -439,19 +448,35 @@ int run_whodata_scan() {
         return 1;
     }
 
+    if (whodata_signal = CreateEvent(NULL, TRUE, TRUE, NULL), !whodata_signal) {
+        merror(FIM_ERROR_WHODATA_SIGNAL, GetLastError());
+        return 1;
+    }
+
     set_subscription_query(query);
-    // Set the whodata callback
 
+    // Pull subscription, the events are read in batches by whodata_event_loop()
     evt_subscribe_handle = EvtSubscribe(NULL,
-                           NULL,
+                           whodata_signal,
                            L"Security",
                            query,
                            NULL,
                            NULL,
-                           (EVT_SUBSCRIBE_CALLBACK) whodata_callback,
+                           NULL,
                            EvtSubscribeToFutureEvents);
     if (evt_subscribe_handle == NULL) {
         merror(FIM_ERROR_WHODATA_EVENTCHANNEL);
+        CloseHandle(whodata_signal);
+        whodata_signal = NULL;
+        return 1;
+    }
+
+    if (CreateThread(NULL, 0, whodata_event_loop, NULL, 0, NULL) == NULL) {
+        merror(THREAD_ERROR);
+        EvtClose(evt_subscribe_handle);
+        evt_subscribe_handle = NULL;
+        CloseHandle(whodata_signal);
+        whodata_signal = NULL;
         return 1;
     }
 
@@ -582,28 +607,31 @@ int restore_audit_policies() {
 }
 
 PEVT_VARIANT whodata_event_render(EVT_HANDLE event) {
-    PEVT_VARIANT buffer = NULL;
-    unsigned long used_size;
-    unsigned long property_count;
-
-    // Extract the necessary memory size
-    EvtRender(context, event, EvtRenderEventValues, 0, NULL, &used_size, &property_count);
+    unsigned long used_size = 0;
+    unsigned long property_count = 0;
+
+    // The buffer of the previous events is reused, it only grows when an event doesn't fit
+    if (!EvtRender(context, event, EvtRenderEventValues, render_buffer_size, render_buffer, &used_size, &property_count)) {
+        if (used_size <= render_buffer_size) {
+            mwarn(FIM_WHODATA_RENDER_EVENT, GetLastError());
+            return NULL;
+        }
 
-    os_malloc(used_size, buffer);
-    memset(buffer, 0, used_size);
+        os_realloc(render_buffer, used_size, render_buffer);
+        render_buffer_size = used_size;
 
-    if (!EvtRender(context, event, EvtRenderEventValues, used_size, buffer, &used_size, &property_count)) {
-        mwarn(FIM_WHODATA_RENDER_EVENT, GetLastError());
-        os_free(buffer);
-        return buffer;
+        if (!EvtRender(context, event, EvtRenderEventValues, render_buffer_size, render_buffer, &used_size, &property_count)) {
+            mwarn(FIM_WHODATA_RENDER_EVENT, GetLastError());
+            return NULL;
+        }
     }
 
     if (property_count != fields_number) {
         mwarn(FIM_WHODATA_RENDER_PARAM);
-        os_free(buffer);
+        return NULL;
     }
 
-    return buffer;
+    return render_buffer;
 }
 
 int whodata_get_event_id(const PEVT_VARIANT raw_data, short *event_id) {
@@ -829,6 +857,7 @@ unsigned long WINAPI whodata_callback(EVT_SUBSCRIBE_NOTIFY_ACTION action, __attr
                     w_evt->mask = 0;
                 }
                 w_evt->scan_directory = is_directory;
+                w_evt->last_event = time(NULL);
 
                 if (result = whodata_hash_add(syscheck.wdata.fd, hash_id, w_evt, "whodata"), result == 0) {
                     free_whodata_event(w_evt);
@@ -863,6 +892,8 @@ unsigned long WINAPI whodata_callback(EVT_SUBSCRIBE_NOTIFY_ACTION action, __attr
                     goto clean;
                 }
 
+                w_evt->last_event = time(NULL);
+
                 // Check if the mask is relevant
                 if (whodata_get_access_mask(buffer, &mask)) {
                     goto clean;
@@ -968,10 +999,99 @@ unsigned long WINAPI whodata_callback(EVT_SUBSCRIBE_NOTIFY_ACTION action, __attr
     }
     retval = 0;
 clean:
-    os_free(buffer);
     return retval;
 }
 
+int whodata_process_events(DWORD timeout) {
+    EVT_HANDLE events[WHODATA_EVENT_BATCH];
+    unsigned long returned = 0;
+    unsigned long error;
+    unsigned long i;
+    int processed = 0;
+
+    if (WaitForSingleObjectEx(whodata_signal, timeout, FALSE) != WAIT_OBJECT_0) {
+        return 0;
+    }
+
+    // Reset the signal before reading, the events that arrive meanwhile set it again
+    ResetEvent(whodata_signal);
+
+    while (EvtNext(evt_subscribe_handle, WHODATA_EVENT_BATCH, events, INFINITE, 0, &returned)) {
+        for (i = 0; i < returned; i++) {
+            // A policy change releases the whodata resources, the rest of the batch is dropped
+            if (atomic_int_get(&whodata_end) == 0) {
+                whodata_callback(EvtSubscribeActionDeliver, NULL, events[i]);
+                processed++;
+            }
+
+            EvtClose(events[i]);
+        }
+
+        if (atomic_int_get(&whodata_end)) {
+            return processed;
+        }
+    }
+
+    if (error = GetLastError(), error != ERROR_NO_MORE_ITEMS) {
+        mwarn(FIM_WARN_WHODATA_EVENT_NEXT, error);
+    }
+
+    return processed;
+}
+
+unsigned int whodata_expire_handles(time_t stale_time) {
+    OSHashNode *node;
+    OSHashNode *next;
+    whodata_evt *w_evt;
+    unsigned int expired = 0;
+    unsigned int i;
+
+    if (syscheck.wdata.fd == NULL) {
+        return 0;
+    }
+
+    w_rwlock_wrlock(&syscheck.wdata.fd->mutex);
+
+    for (i = 0; i <= syscheck.wdata.fd->rows; i++) {
+        for (node = syscheck.wdata.fd->table[i]; node; node = next) {
+            next = node->next;
+            w_evt = node->data;
+
+            if (w_evt->last_event < stale_time) {
+                if (w_evt = OSHash_Delete(syscheck.wdata.fd, node->key), w_evt) {
+                    free_whodata_event(w_evt);
+                    expired++;
+                }
+            }
+        }
+    }
+
+    w_rwlock_unlock(&syscheck.wdata.fd->mutex);
+
+    if (expired) {
+        mdebug1(FIM_WHODATA_HANDLES_EXPIRED, expired);
+    }
+
+    return expired;
+}
+
+long unsigned int WINAPI whodata_event_loop(__attribute__((unused)) void *_void) {
+    time_t last_sweep = time(NULL);
+    time_t now;
+
+    while (atomic_int_get(&whodata_end) == 0) {
+        whodata_process_events(WHODATA_EVENT_WAIT);
+
+        // The handles opened by a program that never closes them are dropped together
+        if (now = time(NULL), now - last_sweep >= WHODATA_HANDLE_SWEEP) {
+            whodata_expire_handles(now - WHODATA_HANDLE_TIMEOUT);
+            last_sweep = now;
+        }
+    }
+
+    return 0;
+}
+
 int whodata_audit_start() {
     // Set the hash table of directories
     if (syscheck.wdata.directories = OSHash_Create(), !syscheck.wdata.directories) {
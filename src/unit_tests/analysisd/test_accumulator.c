@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+
+#include "../../headers/shared.h"
+#include "../../analysisd/accumulator.h"
+#include "../../analysisd/decoders/decoder.h"
+
+#include "../wrappers/wazuh/shared/debug_op_wrappers.h"
+
+typedef struct test_acm_s {
+    OS_ACM_Hash *store;
+    int lookups;
+    time_t purge_ts;
+    OSDecoderInfo decoder;
+} test_acm_t;
+
+/* setup/teardown */
+
+static int setup_acm(void **state) {
+    test_acm_t *data;
+
+    os_calloc(1, sizeof(test_acm_t), data);
+
+    expect_any_always(__wrap__mdebug1, formatted_msg);
+    expect_any_always(__wrap__mdebug2, formatted_msg);
+
+    if (!Accumulate_Init(&data->store, &data->lookups, &data->purge_ts)) {
+        os_free(data);
+        return -1;
+    }
+
+    data->decoder.name = "sshd";
+    *state = data;
+    return 0;
+}
+
+static int teardown_acm(void **state) {
+    test_acm_t *data = *state;
+
+    w_analysisd_accumulate_free(&data->store);
+    os_free(data);
+    return 0;
+}
+
+/* Helpers */
+
+static Eventinfo *new_event(test_acm_t *data, const char *id, const char *srcip, const char *dstuser) {
+    Eventinfo *lf;
+
+    os_calloc(1, sizeof(Eventinfo), lf);
+    lf->decoder_info = &data->decoder;
+    lf->hostname = "host";
+    os_strdup(id, lf->id);
+
+    if (srcip) {
+        os_strdup(srcip, lf->srcip);
+    }
+    if (dstuser) {
+        os_strdup(dstuser, lf->dstuser);
+    }
+
+    return lf;
+}
+
+static void free_event(Eventinfo *lf) {
+    os_free(lf->id);
+    os_free(lf->srcip);
+    os_free(lf->dstuser);
+    os_free(lf);
+}
+
+static void accumulate(test_acm_t *data, const char *id, const char *srcip, const char *dstuser) {
+    Eventinfo *lf = new_event(data, id, srcip, dstuser);
+
+    Accumulate(lf, &data->store, &data->lookups, &data->purge_ts);
+    free_event(lf);
+}
+
+static OS_ACM_Store *get_entry(test_acm_t *data, const char *id) {
+    char key[OS_SIZE_256];
+
+    snprintf(key, sizeof(key), "host sshd %s", id);
+    return OSHash_Get_ex(data->store->entries, key);
+}
+
+/* tests */
+
+/* Accumulate */
+void test_Accumulate_merge(void **state) {
+    test_acm_t *data = *state;
+    Eventinfo *lf;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+
+    lf = new_event(data, "1", NULL, "root");
+    assert_ptr_equal(Accumulate(lf, &data->store, &data->lookups, &data->purge_ts), lf);
+
+    // The second event gets the fields of the first one
+    assert_string_equal(lf->srcip, "192.168.0.1");
+    assert_string_equal(lf->dstuser, "root");
+    free_event(lf);
+
+    assert_int_equal(data->store->entries->elements, 1);
+    assert_string_equal(get_entry(data, "1")->srcip, "192.168.0.1");
+    assert_string_equal(get_entry(data, "1")->dstuser, "root");
+}
+
+void test_Accumulate_no_id(void **state) {
+    test_acm_t *data = *state;
+    Eventinfo *lf = new_event(data, "1", "192.168.0.1", NULL);
+
+    os_free(lf->id);
+
+    assert_ptr_equal(Accumulate(lf, &data->store, &data->lookups, &data->purge_ts), lf);
+    assert_int_equal(data->store->entries->elements, 0);
+    assert_null(data->store->oldest);
+
+    free_event(lf);
+}
+
+void test_Accumulate_update_order(void **state) {
+    test_acm_t *data = *state;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    accumulate(data, "2", "192.168.0.2", NULL);
+    accumulate(data, "3", "192.168.0.3", NULL);
+
+    assert_ptr_equal(data->store->oldest, get_entry(data, "1"));
+    assert_ptr_equal(data->store->newest, get_entry(data, "3"));
+
+    // An update moves the entry to the end
+    accumulate(data, "1", NULL, "root");
+
+    assert_ptr_equal(data->store->oldest, get_entry(data, "2"));
+    assert_ptr_equal(data->store->oldest->next, get_entry(data, "3"));
+    assert_ptr_equal(data->store->newest, get_entry(data, "1"));
+    assert_ptr_equal(data->store->newest->prev, get_entry(data, "3"));
+    assert_null(data->store->newest->next);
+    assert_null(data->store->oldest->prev);
+}
+
+void test_Accumulate_expired_entry(void **state) {
+    test_acm_t *data = *state;
+    Eventinfo *lf;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    accumulate(data, "2", "192.168.0.2", NULL);
+    get_entry(data, "1")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+
+    lf = new_event(data, "1", NULL, "root");
+    Accumulate(lf, &data->store, &data->lookups, &data->purge_ts);
+
+    // The expired data is replaced instead of merged
+    assert_null(lf->srcip);
+    free_event(lf);
+
+    assert_int_equal(data->store->entries->elements, 2);
+    assert_null(get_entry(data, "1")->srcip);
+    assert_string_equal(get_entry(data, "1")->dstuser, "root");
+    assert_ptr_equal(data->store->oldest, get_entry(data, "2"));
+    assert_ptr_equal(data->store->newest, get_entry(data, "1"));
+}
+
+/* Accumulate_CleanUp */
+void test_Accumulate_CleanUp_expired(void **state) {
+    test_acm_t *data = *state;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    accumulate(data, "2", "192.168.0.2", NULL);
+    accumulate(data, "3", "192.168.0.3", NULL);
+
+    get_entry(data, "1")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+    get_entry(data, "2")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+
+    data->lookups = OS_ACM_PURGE_COUNT - 1;
+
+    Accumulate_CleanUp(&data->store, &data->lookups, &data->purge_ts);
+
+    assert_int_equal(data->lookups, 0);
+    assert_int_equal(data->store->entries->elements, 1);
+    assert_null(get_entry(data, "1"));
+    assert_null(get_entry(data, "2"));
+    assert_ptr_equal(data->store->oldest, get_entry(data, "3"));
+    assert_ptr_equal(data->store->newest, get_entry(data, "3"));
+}
+
+void test_Accumulate_CleanUp_stops_at_valid(void **state) {
+    test_acm_t *data = *state;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    accumulate(data, "2", "192.168.0.2", NULL);
+
+    // Only the head of the list is checked, an expired entry after a valid one waits for its turn
+    get_entry(data, "2")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+
+    data->lookups = OS_ACM_PURGE_COUNT - 1;
+
+    Accumulate_CleanUp(&data->store, &data->lookups, &data->purge_ts);
+
+    assert_int_equal(data->store->entries->elements, 2);
+}
+
+void test_Accumulate_CleanUp_not_due(void **state) {
+    test_acm_t *data = *state;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    get_entry(data, "1")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+
+    data->lookups = 0;
+
+    Accumulate_CleanUp(&data->store, &data->lookups, &data->purge_ts);
+
+    assert_int_equal(data->lookups, 1);
+    assert_int_equal(data->store->entries->elements, 1);
+}
+
+void test_Accumulate_CleanUp_interval(void **state) {
+    test_acm_t *data = *state;
+
+    accumulate(data, "1", "192.168.0.1", NULL);
+    get_entry(data, "1")->timestamp -= OS_ACM_EXPIRE_ELM + 1;
+
+    data->lookups = 0;
+    data->purge_ts -= OS_ACM_PURGE_INTERVAL;
+
+    Accumulate_CleanUp(&data->store, &data->lookups, &data->purge_ts);
+
+    assert_int_equal(data->lookups, 0);
+    assert_int_equal(data->store->entries->elements, 0);
+    assert_null(data->store->oldest);
+    assert_null(data->store->newest);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        // Tests Accumulate
+        cmocka_unit_test_setup_teardown(test_Accumulate_merge, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_no_id, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_update_order, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_expired_entry, setup_acm, teardown_acm),
+        // Tests Accumulate_CleanUp
+        cmocka_unit_test_setup_teardown(test_Accumulate_CleanUp_expired, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_CleanUp_stops_at_valid, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_CleanUp_not_due, setup_acm, teardown_acm),
+        cmocka_unit_test_setup_teardown(test_Accumulate_CleanUp_interval, setup_acm, teardown_acm),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
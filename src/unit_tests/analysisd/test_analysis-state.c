@@ -36,6 +36,7 @@ extern OSHash *analysisd_agents_state;
 
 analysisd_agent_state_t * get_node(const char *agent_id);
 void w_analysisd_clean_agents_state(int *sock);
+void w_analysisd_merge_agents_state();
 /* setup/teardown */
 
 static int test_setup(void ** state) {
@@ -107,6 +108,7 @@ static int test_setup(void ** state) {
     analysisd_state.events_written_breakdown.archives_written = 4200;
     analysisd_state.eps_state_breakdown.events_dropped = 552;
     analysisd_state.eps_state_breakdown.seconds_over_limit = 1254;
+    analysisd_state.events_priority_dropped[2] = 17;
 
     decode_queue_syscheck_input = queue_init(4096);
     decode_queue_syscollector_input = queue_init(4096);
@@ -116,7 +118,9 @@ static int test_setup(void ** state) {
     decode_queue_winevt_input = queue_init(4096);
     dispatch_dbsync_input = queue_init(4096);
     upgrade_module_input = queue_init(4096);
-    decode_queue_event_input = queue_init(4096);
+    size_t event_sizes[PRIO_QUEUE_CLASSES] = { 0, 4096, 0 };
+    unsigned int event_weights[PRIO_QUEUE_CLASSES] = { 4, 2, 1 };
+    decode_queue_event_input = prio_queue_init(event_sizes, event_weights);
     decode_queue_event_output = queue_init(4096);
     writer_queue_log = queue_init(4096);
     writer_queue_log_firewall = queue_init(4096);
@@ -133,6 +137,7 @@ static int test_setup(void ** state) {
     dispatch_dbsync_input->size = queue_status.dbsync_queue_size = 4096;
     upgrade_module_input->size = queue_status.upgrade_queue_size = 4096;
     decode_queue_event_input->size = queue_status.events_queue_size = 4096;
+    queue_status.events_priority_size[1] = 4096;
     decode_queue_event_output->size = queue_status.processed_queue_size = 4096;
     writer_queue_log->size = queue_status.alerts_queue_size = 4096;
     writer_queue_log_firewall->size = queue_status.firewall_queue_size = 4096;
@@ -148,7 +153,7 @@ static int test_setup(void ** state) {
     decode_queue_winevt_input->elements = 23;
     dispatch_dbsync_input->elements = 456;
     upgrade_module_input->elements = 0;
-    decode_queue_event_input->elements = 259;
+    decode_queue_event_input->elements = decode_queue_event_input->classes[1]->elements = 259;
     decode_queue_event_output->elements = 154;
     writer_queue_log->elements = 5;
     writer_queue_log_firewall->elements = 1;
@@ -220,7 +225,6 @@ static int test_teardown(void ** state) {
     os_free(decode_queue_winevt_input->data);
     os_free(dispatch_dbsync_input->data);
     os_free(upgrade_module_input->data);
-    os_free(decode_queue_event_input->data);
     os_free(decode_queue_event_output->data);
     os_free(writer_queue_log->data);
     os_free(writer_queue_log_firewall->data);
@@ -235,7 +239,8 @@ static int test_teardown(void ** state) {
     os_free(decode_queue_winevt_input);
     os_free(dispatch_dbsync_input);
     os_free(upgrade_module_input);
-    os_free(decode_queue_event_input);
+    prio_queue_free(decode_queue_event_input);
+    decode_queue_event_input = NULL;
     os_free(decode_queue_event_output);
     os_free(writer_queue_log);
     os_free(writer_queue_log_firewall);
@@ -501,6 +506,15 @@ void test_asys_create_state_json(void ** state) {
     assert_non_null(cJSON_GetObjectItem(metrics, "queues"));
     cJSON* queue = cJSON_GetObjectItem(metrics, "queues");
 
+    assert_non_null(cJSON_GetObjectItem(metrics, "memory"));
+    cJSON* memory = cJSON_GetObjectItem(metrics, "memory");
+
+    cJSON* memory_eventlist = cJSON_GetObjectItem(memory, "eventlist");
+    assert_non_null(cJSON_GetObjectItem(memory_eventlist, "bytes"));
+    assert_non_null(cJSON_GetObjectItem(memory_eventlist, "allocations"));
+    assert_non_null(cJSON_GetObjectItem(memory, "fts"));
+    assert_non_null(cJSON_GetObjectItem(memory, "lists"));
+
     cJSON* syscheck = cJSON_GetObjectItem(queue, "syscheck");
     assert_non_null(cJSON_GetObjectItem(syscheck, "usage"));
     assert_float_equal(cJSON_GetObjectItem(syscheck, "usage")->valuedouble, 0.031, 0.001);
@@ -546,11 +560,22 @@ void test_asys_create_state_json(void ** state) {
     assert_float_equal(cJSON_GetObjectItem(others, "usage")->valuedouble, 0.063, 0.001);
     assert_non_null(cJSON_GetObjectItem(others, "size"));
     assert_int_equal(cJSON_GetObjectItem(others, "size")->valueint, 4096);
+    cJSON* others_priority = cJSON_GetObjectItem(others, "priority");
+    assert_non_null(others_priority);
+    cJSON* others_normal = cJSON_GetObjectItem(others_priority, "normal");
+    assert_int_equal(cJSON_GetObjectItem(others_normal, "size")->valueint, 4096);
+    assert_float_equal(cJSON_GetObjectItem(others_normal, "usage")->valuedouble, 0.063, 0.001);
+    assert_int_equal(cJSON_GetObjectItem(others_normal, "dropped")->valueint, 0);
+    cJSON* others_low = cJSON_GetObjectItem(others_priority, "low");
+    assert_int_equal(cJSON_GetObjectItem(others_low, "size")->valueint, 0);
+    assert_int_equal(cJSON_GetObjectItem(others_low, "dropped")->valueint, 17);
     cJSON* processed = cJSON_GetObjectItem(queue, "processed");
     assert_non_null(cJSON_GetObjectItem(processed, "usage"));
     assert_float_equal(cJSON_GetObjectItem(processed, "usage")->valuedouble, 0.037, 0.001);
     assert_non_null(cJSON_GetObjectItem(processed, "size"));
     assert_int_equal(cJSON_GetObjectItem(processed, "size")->valueint, 4096);
+    assert_non_null(cJSON_GetObjectItem(processed, "imbalance"));
+    assert_float_equal(cJSON_GetObjectItem(processed, "imbalance")->valuedouble, 1, 0.001);
     cJSON* alerts = cJSON_GetObjectItem(queue, "alerts");
     assert_non_null(cJSON_GetObjectItem(alerts, "usage"));
     assert_float_equal(cJSON_GetObjectItem(alerts, "usage")->valuedouble, 0.001, 0.001);
@@ -787,6 +812,29 @@ void test_w_analysisd_clean_agents_state_query_fail(void ** state) {
     os_free(test_data->agent_state);
 }
 
+void test_w_analysisd_merge_agents_state(void ** state) {
+    test_struct_t *test_data  = (test_struct_t *)*state;
+
+    // The counters are kept in the slab of the thread until they are read
+    will_return(__wrap_time, 123456000);
+    w_inc_agent_decoded_events("001");
+    w_inc_modules_syscheck_decoded_events("001");
+    w_inc_modules_syscheck_decoded_events("001");
+
+    expect_value(__wrap_OSHash_Get_ex, self, analysisd_agents_state);
+    expect_string(__wrap_OSHash_Get_ex, key, "001");
+    will_return(__wrap_OSHash_Get_ex, test_data->agent_state);
+
+    w_analysisd_merge_agents_state();
+
+    assert_int_equal(test_data->agent_state->uptime, 123456000);
+    assert_int_equal(test_data->agent_state->events_decoded_breakdown.agent, 2);
+    assert_int_equal(test_data->agent_state->events_decoded_breakdown.modules.syscheck, 516);
+
+    // Nothing is pending after the merge
+    w_analysisd_merge_agents_state();
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         // Test asys_create_state_json
@@ -801,6 +849,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_w_analysisd_clean_agents_state_completed, test_setup_agent, test_teardown_agent),
         cmocka_unit_test_setup_teardown(test_w_analysisd_clean_agents_state_completed_without_delete, test_setup_agent, test_teardown_agent),
         cmocka_unit_test_setup_teardown(test_w_analysisd_clean_agents_state_query_fail, test_setup_agent, test_teardown_agent),
+        // Test w_analysisd_merge_agents_state
+        cmocka_unit_test_setup_teardown(test_w_analysisd_merge_agents_state, test_setup_agent, test_teardown_agent),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
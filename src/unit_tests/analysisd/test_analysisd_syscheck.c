@@ -32,7 +32,8 @@ typedef struct __fim_adjust_checksum_data_s {
 } fim_adjust_checksum_data_t;
 
 /* private functions to be tested */
-void fim_send_db_query(int * sock, const char * query);
+void fim_send_db_query(_sdb * sdb, const char * query);
+void fim_db_flush(_sdb * sdb);
 void fim_send_db_delete(_sdb * sdb, const char * agent_id, const char * path);
 void fim_send_db_save(_sdb * sdb, const char * agent_id, cJSON * data);
 void fim_process_scan_info(_sdb * sdb, const char * agent_id, fim_scan_event event, cJSON * data);
@@ -457,6 +458,7 @@ static int setup_registry_key_data(void **state) {
 }
 
 extern OSHash *fim_agentinfo;
+extern OSHash *fim_scan_start;
 
 static int setup_registry_value_data(void **state) {
     fim_data_t *data;
@@ -536,6 +538,7 @@ static int teardown_fim_data(void **state) {
     free(data);
 
     OSHash_Free(fim_agentinfo);
+    OSHash_Free(fim_scan_start);
 
     return 0;
 }
@@ -677,71 +680,49 @@ static int teardown_fim_adjust_checksum(void **state) {
 /* fim_send_db_query */
 static void test_fim_send_db_query_success(void **state) {
     const char *query = "This is a mock query, it wont go anywhere";
-    const char *result = "This is a mock query result, it wont go anywhere";
-    int sock = 1;
+    _sdb sdb = {.socket = 1};
 
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, query);
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
+    expect_string(__wrap_wdbc_pipeline_send, query, query);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    fim_send_db_query(&sdb, query);
 
-    fim_send_db_query(&sock, query);
+    assert_int_equal(sdb.db_err, 0);
 }
 
-static void test_fim_send_db_query_communication_error(void **state) {
+static void test_fim_send_db_query_failed(void **state) {
     const char *query = "This is a mock query, it wont go anywhere";
-    const char *result = "This is a mock query result, it wont go anywhere";
-    int sock = 1;
+    _sdb sdb = {.socket = -1};
 
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, query);
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, -2);
+    expect_string(__wrap_wdbc_pipeline_send, query, query);
+    will_return(__wrap_wdbc_pipeline_send, 3);
 
-    expect_string(__wrap__merror, formatted_msg, "FIM decoder: Cannot communicate with database.");
+    fim_send_db_query(&sdb, query);
 
-    fim_send_db_query(&sock, query);
+    assert_int_equal(sdb.db_err, 3);
 }
 
-static void test_fim_send_db_query_no_response(void **state) {
-    const char *query = "This is a mock query, it wont go anywhere";
-    const char *result = "This is a mock query result, it wont go anywhere";
-    int sock = 1;
+/* fim_db_flush */
+static void test_fim_db_flush_success(void **state) {
+    _sdb sdb = {.socket = 1};
 
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, query);
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, -1);
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
 
-    expect_string(__wrap__merror, formatted_msg, "FIM decoder: Cannot get response from database.");
+    fim_db_flush(&sdb);
 
-    fim_send_db_query(&sock, query);
+    assert_int_equal(sdb.db_err, 0);
 }
 
-static void test_fim_send_db_query_format_error(void **state) {
-    const char *query = "This is a mock query, it wont go anywhere";
-    const char *result = "This is a mock query result, it wont go anywhere";
-    int sock = 1;
-
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, query);
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
+static void test_fim_db_flush_failed(void **state) {
+    _sdb sdb = {.socket = 1};
 
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_ERROR);
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 2);
 
-    expect_string(__wrap__merror, formatted_msg,
-        "FIM decoder: Bad response from database: is a mock query result, it wont go anywhere");
+    fim_db_flush(&sdb);
 
-    fim_send_db_query(&sock, query);
+    assert_int_equal(sdb.db_err, 2);
 }
 
 /* fim_send_db_delete */
@@ -749,18 +730,11 @@ static void test_fim_send_db_delete_success(void **state) {
     _sdb sdb = {.socket=10};
     const char *agent_id = "001";
     const char *path = "/a/path";
-    const char *result = "This is a mock query result, it wont go anywhere";
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 001 syscheck delete /a/path");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 001 syscheck delete /a/path");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_delete(&sdb, agent_id, path);
 }
@@ -783,16 +757,9 @@ static void test_fim_send_db_delete_query_too_long(void **state) {
 static void test_fim_send_db_delete_null_agent_id(void **state) {
     _sdb sdb = {.socket=10};
     const char *path = "/a/path";
-    const char *result = "This is a mock query result, it wont go anywhere";
-
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent (null) syscheck delete /a/path");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
 
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent (null) syscheck delete /a/path");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_delete(&sdb, NULL, path);
 }
@@ -800,18 +767,11 @@ static void test_fim_send_db_delete_null_agent_id(void **state) {
 static void test_fim_send_db_delete_null_path(void **state) {
     _sdb sdb = {.socket=10};
     const char *agent_id = "001";
-    const char *result = "This is a mock query result, it wont go anywhere";
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 001 syscheck delete (null)");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 001 syscheck delete (null)");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_delete(&sdb, agent_id, NULL);
 }
@@ -820,15 +780,13 @@ static void test_fim_send_db_delete_null_path(void **state) {
 static void test_fim_send_db_save_success(void **state) {
     _sdb sdb = {.socket = 10};
     const char *agent_id = "007";
-    const char *result = "This is a mock query result, it wont go anywhere";
     cJSON *event = *state;
 
     cJSON *data = cJSON_GetObjectItem(event, "data");
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -847,12 +805,7 @@ static void test_fim_send_db_save_success(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_save(&sdb, agent_id, data);
 }
@@ -881,15 +834,13 @@ static void test_fim_send_db_save_event_too_long(void **state) {
 
 static void test_fim_send_db_save_null_agent_id(void **state) {
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     cJSON *event = *state;
 
     cJSON *data = cJSON_GetObjectItem(event, "data");
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent (null) syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent (null) syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -908,12 +859,7 @@ static void test_fim_send_db_save_null_agent_id(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_save(&sdb, NULL, data);
 }
@@ -921,18 +867,11 @@ static void test_fim_send_db_save_null_agent_id(void **state) {
 static void test_fim_send_db_save_null_data(void **state) {
     _sdb sdb = {.socket = 10};
     const char *agent_id = "007";
-    const char *result = "This is a mock query result, it wont go anywhere";
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 (null)");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 (null)");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_send_db_save(&sdb, agent_id, NULL);
 }
@@ -941,21 +880,14 @@ static void test_fim_send_db_save_null_data(void **state) {
 static void test_fim_process_scan_info_scan_start(void **state) {
     _sdb sdb = {.socket = 10};
     const char *agent_id = "007";
-    const char *result = "This is a mock query result, it wont go anywhere";
     cJSON *event = *state;
 
     cJSON *data = cJSON_GetObjectItem(event, "data");
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck scan_info_update start_scan 123456789");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck scan_info_update start_scan 123456789");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_process_scan_info(&sdb, agent_id, FIM_SCAN_START, data);
 }
@@ -963,21 +895,14 @@ static void test_fim_process_scan_info_scan_start(void **state) {
 static void test_fim_process_scan_info_scan_end(void **state) {
     _sdb sdb = {.socket = 10};
     const char *agent_id = "007";
-    const char *result = "This is a mock query result, it wont go anywhere";
     cJSON *event = *state;
 
     cJSON *data = cJSON_GetObjectItem(event, "data");
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck scan_info_update end_scan 123456789");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck scan_info_update end_scan 123456789");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_process_scan_info(&sdb, agent_id, FIM_SCAN_END, data);
 }
@@ -1014,21 +939,14 @@ static void test_fim_process_scan_info_query_too_long(void **state) {
 
 static void test_fim_process_scan_info_null_agent_id(void **state) {
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     cJSON *event = *state;
 
     cJSON *data = cJSON_GetObjectItem(event, "data");
 
     // Assertion of this test is done through fim_send_db_query.
     // The following lines configure the test to check a correct input message.
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent (null) syscheck scan_info_update start_scan 123456789");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent (null) syscheck scan_info_update start_scan 123456789");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     fim_process_scan_info(&sdb, NULL, FIM_SCAN_START, data);
 }
@@ -1970,7 +1888,6 @@ static void test_fim_generate_alert_null_audit(void **state) {
 static void test_fim_process_alert_added_success(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -1979,8 +1896,7 @@ static void test_fim_process_alert_added_success(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -1999,12 +1915,7 @@ static void test_fim_process_alert_added_success(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2066,7 +1977,6 @@ static void test_fim_process_alert_added_success(void **state) {
 static void test_fim_process_alert_modified_success(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2078,8 +1988,7 @@ static void test_fim_process_alert_modified_success(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2098,12 +2007,7 @@ static void test_fim_process_alert_modified_success(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2179,7 +2083,6 @@ static void test_fim_process_alert_modified_success(void **state) {
 static void test_fim_process_alert_deleted_success(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2191,14 +2094,8 @@ static void test_fim_process_alert_deleted_success(void **state) {
         fail();
 
     /* Inside fim_send_db_delete */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck delete /a/path");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck delete /a/path");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2363,7 +2260,6 @@ static void test_fim_process_alert_no_path(void **state) {
 static void test_fim_process_alert_no_hard_links(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2373,8 +2269,7 @@ static void test_fim_process_alert_no_hard_links(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2393,12 +2288,7 @@ static void test_fim_process_alert_no_hard_links(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2459,7 +2349,6 @@ static void test_fim_process_alert_no_hard_links(void **state) {
 static void test_fim_process_alert_no_mode(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2471,8 +2360,7 @@ static void test_fim_process_alert_no_mode(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2491,12 +2379,7 @@ static void test_fim_process_alert_no_mode(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2558,7 +2441,6 @@ static void test_fim_process_alert_no_mode(void **state) {
 static void test_fim_process_alert_no_tags(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2568,8 +2450,7 @@ static void test_fim_process_alert_no_tags(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2588,12 +2469,7 @@ static void test_fim_process_alert_no_tags(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2656,7 +2532,6 @@ static void test_fim_process_alert_no_tags(void **state) {
 static void test_fim_process_alert_no_content_changes(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2666,8 +2541,7 @@ static void test_fim_process_alert_no_content_changes(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2686,12 +2560,7 @@ static void test_fim_process_alert_no_content_changes(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2754,7 +2623,6 @@ static void test_fim_process_alert_no_content_changes(void **state) {
 static void test_fim_process_alert_no_changed_attributes(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2764,8 +2632,7 @@ static void test_fim_process_alert_no_changed_attributes(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2784,12 +2651,7 @@ static void test_fim_process_alert_no_changed_attributes(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2872,7 +2734,6 @@ static void test_fim_process_alert_no_attributes(void **state) {
 static void test_fim_process_alert_no_old_attributes(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2884,8 +2745,7 @@ static void test_fim_process_alert_no_old_attributes(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -2904,12 +2764,7 @@ static void test_fim_process_alert_no_old_attributes(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -2985,7 +2840,6 @@ static void test_fim_process_alert_no_old_attributes(void **state) {
 static void test_fim_process_alert_no_audit(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -2995,8 +2849,7 @@ static void test_fim_process_alert_no_audit(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -3015,12 +2868,7 @@ static void test_fim_process_alert_no_audit(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -3082,7 +2930,6 @@ static void test_fim_process_alert_no_audit(void **state) {
 static void test_fim_process_alert_remove_registry_key(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -3095,14 +2942,8 @@ static void test_fim_process_alert_remove_registry_key(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck delete 234567890ABCDEF1234567890ABCDEF123456111");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck delete 234567890ABCDEF1234567890ABCDEF123456111");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -3136,7 +2977,6 @@ static void test_fim_process_alert_remove_registry_key(void **state) {
 static void test_fim_process_alert_remove_registry_value(void **state) {
     fim_data_t *input = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *data = cJSON_GetObjectItem(input->event, "data");
@@ -3149,14 +2989,8 @@ static void test_fim_process_alert_remove_registry_value(void **state) {
         fail();
 
     /* Inside fim_send_db_save */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck delete 234567890ABCDEF1234567890ABCDEF123456111");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck delete 234567890ABCDEF1234567890ABCDEF123456111");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = fim_process_alert(&sdb, input->lf, data);
 
@@ -3220,15 +3054,13 @@ static void test_fim_process_alert_null_event(void **state) {
 static void test_decode_fim_event_type_event(void **state) {
     Eventinfo *lf = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     if(lf->agent_id = strdup("007"), lf->agent_id == NULL)
         fail();
 
     /* Inside fim_process_alert */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck save2 "
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck save2 "
         "{\"path\":\"/a/path\","
         "\"timestamp\":123456789,"
         "\"attributes\":{"
@@ -3247,12 +3079,7 @@ static void test_decode_fim_event_type_event(void **state) {
             "\"win_attributes\":\"win_attributes\","
             "\"symlink_path\":\"symlink_path\","
             "\"checksum\":\"checksum\"}}");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = decode_fim_event(&sdb, lf);
 
@@ -3314,7 +3141,6 @@ static void test_decode_fim_event_type_event(void **state) {
 static void test_decode_fim_event_type_scan_start(void **state) {
     Eventinfo *lf = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *event = cJSON_Parse(lf->log);
@@ -3330,14 +3156,8 @@ static void test_decode_fim_event_type_scan_start(void **state) {
         fail();
 
     /* inside fim_process_scan_info */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck scan_info_update start_scan 123456789");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck scan_info_update start_scan 123456789");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = decode_fim_event(&sdb, lf);
 
@@ -3347,7 +3167,6 @@ static void test_decode_fim_event_type_scan_start(void **state) {
 static void test_decode_fim_event_type_scan_end(void **state) {
     Eventinfo *lf = *state;
     _sdb sdb = {.socket = 10};
-    const char *result = "This is a mock query result, it wont go anywhere";
     int ret;
 
     cJSON *event = cJSON_Parse(lf->log);
@@ -3363,14 +3182,8 @@ static void test_decode_fim_event_type_scan_end(void **state) {
         fail();
 
     /* inside fim_process_scan_info */
-    expect_any(__wrap_wdbc_query_ex, *sock);
-    expect_string(__wrap_wdbc_query_ex, query, "agent 007 syscheck scan_info_update end_scan 123456789");
-    expect_any(__wrap_wdbc_query_ex, len);
-    will_return(__wrap_wdbc_query_ex, result);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, result);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    expect_string(__wrap_wdbc_pipeline_send, query, "agent 007 syscheck scan_info_update end_scan 123456789");
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     ret = decode_fim_event(&sdb, lf);
 
@@ -3818,9 +3631,11 @@ int main(void) {
     const struct CMUnitTest tests[] = {
         /* fim_send_db_query */
         cmocka_unit_test(test_fim_send_db_query_success),
-        cmocka_unit_test(test_fim_send_db_query_communication_error),
-        cmocka_unit_test(test_fim_send_db_query_no_response),
-        cmocka_unit_test(test_fim_send_db_query_format_error),
+        cmocka_unit_test(test_fim_send_db_query_failed),
+
+        /* fim_db_flush */
+        cmocka_unit_test(test_fim_db_flush_success),
+        cmocka_unit_test(test_fim_db_flush_failed),
 
         /* fim_send_db_delete */
         cmocka_unit_test(test_fim_send_db_delete_success),
@@ -41,6 +41,10 @@ int __wrap_accept() {
     return mock();
 }
 
+unsigned int __wrap_w_ruleset_reload() {
+    return mock();
+}
+
 /* Tests */
 
 void test_asyscom_output_builder(void ** state) {
@@ -305,6 +309,51 @@ void test_asyscom_dispatch_getagentsstats_array_ok(void ** state) {
     assert_int_equal(size, strlen(response));
 }
 
+void test_asyscom_dispatch_reload(void ** state) {
+    char* request = "{\"command\":\"reload\"}";
+    char *response = NULL;
+
+    will_return(__wrap_w_ruleset_reload, 2);
+
+    size_t size = asyscom_dispatch(request, &response);
+
+    *state = response;
+
+    assert_non_null(response);
+    assert_string_equal(response, "{\"error\":0,\"message\":\"ok\",\"data\":{\"generation\":2}}");
+    assert_int_equal(size, strlen(response));
+}
+
+void test_asyscom_dispatch_reload_error(void ** state) {
+    char* request = "{\"command\":\"reload\"}";
+    char *response = NULL;
+
+    will_return(__wrap_w_ruleset_reload, 0);
+
+    size_t size = asyscom_dispatch(request, &response);
+
+    *state = response;
+
+    assert_non_null(response);
+    assert_string_equal(response, "{\"error\":12,\"message\":\"Unable to reload the ruleset\",\"data\":{}}");
+    assert_int_equal(size, strlen(response));
+}
+
+void test_asyscom_dispatch_getprofile_disabled(void ** state) {
+    char* request = "{\"command\":\"getprofile\",\"parameters\":{\"limit\":10}}";
+    char *response = NULL;
+
+    Config.profile_ruleset = 0;
+
+    size_t size = asyscom_dispatch(request, &response);
+
+    *state = response;
+
+    assert_non_null(response);
+    assert_string_equal(response, "{\"error\":13,\"message\":\"Ruleset profiling is disabled\",\"data\":{}}");
+    assert_int_equal(size, strlen(response));
+}
+
 void test_asyscom_dispatch_unknown_command(void ** state) {
     char* request = "{\"command\":\"unknown\"}";
     char *response = NULL;
@@ -672,6 +721,9 @@ int main(void) {
         cmocka_unit_test_teardown(test_asyscom_dispatch_getagentsstats_all_ok, test_teardown),
         cmocka_unit_test_teardown(test_asyscom_dispatch_getagentsstats_array_empty_agents, test_teardown),
         cmocka_unit_test_teardown(test_asyscom_dispatch_getagentsstats_array_ok, test_teardown),
+        cmocka_unit_test_teardown(test_asyscom_dispatch_reload, test_teardown),
+        cmocka_unit_test_teardown(test_asyscom_dispatch_reload_error, test_teardown),
+        cmocka_unit_test_teardown(test_asyscom_dispatch_getprofile_disabled, test_teardown),
         cmocka_unit_test_teardown(test_asyscom_dispatch_unknown_command, test_teardown),
         cmocka_unit_test_teardown(test_asyscom_dispatch_empty_command, test_teardown),
         cmocka_unit_test_teardown(test_asyscom_dispatch_invalid_json, test_teardown),
@@ -391,6 +391,31 @@ static void test_OS_CleanMSG_xferlog_timestamp(void **state){
     os_free(msg);
 }
 
+static void test_OS_CleanMSG_event_date(void **state){
+
+    Eventinfo *lf = (Eventinfo *)*state;
+    struct tm p = { .tm_sec = 0 };
+    char hour[10];
+
+    char *msg;
+    os_calloc(OS_BUFFER_SIZE, sizeof(char), msg);
+    snprintf(msg, OS_BUFFER_SIZE, "%c:%s:%s", '1', "location test", "payload test");
+
+    int value = OS_CleanMSG(msg, lf);
+
+    localtime_r(&lf->time.tv_sec, &p);
+    snprintf(hour, sizeof(hour), "%02d:%02d:%02d", p.tm_hour, p.tm_min, p.tm_sec);
+
+    assert_int_equal(value, 0);
+    assert_int_equal(lf->day, p.tm_mday);
+    assert_int_equal(lf->year, p.tm_year + 1900);
+    assert_string_equal(lf->hour, hour);
+    assert_int_equal(strftime(hour, sizeof(hour), "%b", &p), 3);
+    assert_memory_equal(lf->mon, hour, 3);
+
+    os_free(msg);
+}
+
 void test_extract_module_from_message(void ** state) {
     char message[32] = "1:/var/log/demo.log:Hello world";
 
@@ -465,6 +490,7 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_OS_CleanMSG_suricata_timestamp, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_OS_CleanMSG_snort_timestamp, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_OS_CleanMSG_xferlog_timestamp, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_OS_CleanMSG_event_date, test_setup, test_teardown),
         
         // Test extract_module_from_message
         cmocka_unit_test(test_extract_module_from_message),
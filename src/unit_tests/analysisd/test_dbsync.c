@@ -36,6 +36,7 @@ void dispatch_check(dbsync_context_t * ctx, const char * command);
 void dispatch_state(dbsync_context_t * ctx);
 void dispatch_clear(dbsync_context_t * ctx);
 void DispatchDBSync(dbsync_context_t * ctx, Eventinfo * lf);
+void DispatchDBSyncFlush(dbsync_context_t * ctx);
 
 /* auxiliary structs */
 typedef struct __test_dbsync_s{
@@ -129,6 +130,8 @@ static int teardown_dispatch_send_remote(void **state) {
 static int setup_dispatch_answer(void **state) {
     test_dbsync_t *data = *state;
 
+    data->ctx->pipeline = (wdbc_pipeline) { .name = "dbsync", .size = DBSYNC_PIPELINE_SIZE };
+
     data->ctx->data = cJSON_Parse(
         "{\"tail\": \"tail\", \"checksum\": \"checksum\", \"begin\": \"/a/path\", \"end\": \"/z/path\"}");
     data->ctx->agent_id = calloc(OS_SIZE_16, sizeof(char));
@@ -164,6 +167,8 @@ static int teardown_dispatch_answer(void **state) {
 static int setup_DispatchDBSync(void **state) {
     test_dbsync_t *data = *state;
 
+    data->ctx->pipeline = (wdbc_pipeline) { .name = "dbsync", .size = DBSYNC_PIPELINE_SIZE };
+
     if(data->lf = calloc(1, sizeof(Eventinfo)), !data->lf)
         return -1;
 
@@ -450,6 +455,10 @@ static void test_dispatch_check_success(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
+    // The pending responses are read before waiting for this one
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
+
     expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
     expect_string(__wrap_wdbc_query_ex, query,
         "agent 007 syscheck command {\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
@@ -505,6 +514,10 @@ static void test_dispatch_check_unable_to_communicate_with_db(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
+    // The pending responses are read before waiting for this one
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
+
     expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
     expect_string(__wrap_wdbc_query_ex, query,
         "agent 007 syscheck command {\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
@@ -526,6 +539,10 @@ static void test_dispatch_check_no_response_from_db(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
+    // The pending responses are read before waiting for this one
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
+
     expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
     expect_string(__wrap_wdbc_query_ex, query,
         "agent 007 syscheck command {\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
@@ -547,6 +564,10 @@ static void test_dispatch_check_error_parsing_response(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
+    // The pending responses are read before waiting for this one
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
+
     expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
     expect_string(__wrap_wdbc_query_ex, query,
         "agent 007 syscheck command {\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
@@ -565,24 +586,16 @@ static void test_dispatch_check_error_parsing_response(void **state) {
 /* dispatch_state */
 static void test_dispatch_state_success(void **state) {
     test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
 
     data->ctx->db_sock = 65555;
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck save2 "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
-    // Assertions for this test are done through wrappers
     dispatch_state(data->ctx);
 }
 
@@ -628,62 +641,11 @@ static void test_dispatch_state_unable_to_communicate_with_db(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    // The pipeline logs the error
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck save2 "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, NULL);
-    will_return(__wrap_wdbc_query_ex, -2);
-
-    expect_string(__wrap__merror, formatted_msg, "dbsync: Cannot communicate with database.");
-
-    // Assertions for this test are done through wrappers
-    dispatch_state(data->ctx);
-}
-
-static void test_dispatch_state_no_response_from_db(void **state) {
-    test_dbsync_t *data = *state;
-
-    data->ctx->db_sock = 65555;
-    snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
-    snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
-
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
-        "agent 007 syscheck save2 "
-        "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, NULL);
-    will_return(__wrap_wdbc_query_ex, -1);
-
-    expect_string(__wrap__merror, formatted_msg, "dbsync: Cannot get response from database.");
-
-    // Assertions for this test are done through wrappers
-    dispatch_state(data->ctx);
-}
-
-static void test_dispatch_state_error_parsing_response(void **state) {
-    test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
-
-    data->ctx->db_sock = 65555;
-    snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
-    snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
-
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
-        "agent 007 syscheck save2 "
-        "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_ERROR);
-
-    expect_string(__wrap__merror, formatted_msg,
-        "dbsync: Bad response from database: is a mock response, payload points -> here <-");
+    will_return(__wrap_wdbc_pipeline_send, 1);
 
     // Assertions for this test are done through wrappers
     dispatch_state(data->ctx);
@@ -692,24 +654,16 @@ static void test_dispatch_state_error_parsing_response(void **state) {
 /* dispatch_clear */
 static void test_dispatch_clear_success(void **state) {
     test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
 
     data->ctx->db_sock = 65555;
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck integrity_clear "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
-
-    // Assertions for this test are done through wrappers
     dispatch_clear(data->ctx);
 }
 
@@ -754,65 +708,30 @@ static void test_dispatch_clear_unable_to_communicate_with_db(void **state) {
     snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
     snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    // The pipeline logs the error
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck integrity_clear "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, NULL);
-    will_return(__wrap_wdbc_query_ex, -2);
-
-    expect_string(__wrap__merror, formatted_msg, "dbsync: Cannot communicate with database.");
+    will_return(__wrap_wdbc_pipeline_send, 1);
 
     // Assertions for this test are done through wrappers
     dispatch_clear(data->ctx);
 }
 
-static void test_dispatch_clear_no_response_from_db(void **state) {
+/* DispatchDBSyncFlush */
+static void test_DispatchDBSyncFlush_success(void **state) {
     test_dbsync_t *data = *state;
 
     data->ctx->db_sock = 65555;
-    snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
-    snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
-        "agent 007 syscheck integrity_clear "
-        "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, NULL);
-    will_return(__wrap_wdbc_query_ex, -1);
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
 
-    expect_string(__wrap__merror, formatted_msg, "dbsync: Cannot get response from database.");
-
-    // Assertions for this test are done through wrappers
-    dispatch_clear(data->ctx);
+    DispatchDBSyncFlush(data->ctx);
 }
 
-static void test_dispatch_clear_error_parsing_response(void **state) {
-    test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
-
-    data->ctx->db_sock = 65555;
-    snprintf(data->ctx->agent_id, OS_SIZE_16, "007");
-    snprintf(data->ctx->component, OS_SIZE_16, "syscheck");
-
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
-        "agent 007 syscheck integrity_clear "
-        "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_ERROR);
-
-    expect_string(__wrap__merror, formatted_msg,
-        "dbsync: Bad response from database: is a mock response, payload points -> here <-");
-
-    // Assertions for this test are done through wrappers
-    dispatch_clear(data->ctx);
+static void test_DispatchDBSyncFlush_null_ctx(void **state) {
+    expect_assert_failure(DispatchDBSyncFlush(NULL));
 }
 
 /* DispatchDBSync */
@@ -824,6 +743,10 @@ static void test_DispatchDBSync_integrity_check_success(void **state) {
 
     data->ctx->db_sock = 65555;
 
+    // The pending responses are read before waiting for this one
+    expect_value(__wrap_wdbc_pipeline_recv, keep, 0);
+    will_return(__wrap_wdbc_pipeline_recv, 0);
+
     expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
     expect_string(__wrap_wdbc_query_ex, query,
         "agent 007 syscheck integrity_check_test {\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
@@ -846,7 +769,6 @@ static void test_DispatchDBSync_integrity_check_success(void **state) {
 
 static void test_DispatchDBSync_state_success(void **state) {
     test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
     cJSON *root = cJSON_Parse(data->lf->log);
 
     snprintf(data->lf->agent_id, OS_SIZE_16, "007");
@@ -861,23 +783,16 @@ static void test_DispatchDBSync_state_success(void **state) {
 
     cJSON_Delete(root);
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck save2 "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     DispatchDBSync(data->ctx, data->lf);
 }
 
 static void test_DispatchDBSync_integrity_clear_success(void **state) {
     test_dbsync_t *data = *state;
-    char *response = "This is a mock response, payload points -> here <-";
     cJSON *root = cJSON_Parse(data->lf->log);
 
     snprintf(data->lf->agent_id, OS_SIZE_16, "007");
@@ -892,16 +807,10 @@ static void test_DispatchDBSync_integrity_clear_success(void **state) {
 
     cJSON_Delete(root);
 
-    expect_value(__wrap_wdbc_query_ex, *sock, data->ctx->db_sock);
-    expect_string(__wrap_wdbc_query_ex, query,
+    expect_string(__wrap_wdbc_pipeline_send, query,
         "agent 007 syscheck integrity_clear "
         "{\"tail\":\"tail\",\"checksum\":\"checksum\",\"begin\":\"/a/path\",\"end\":\"/z/path\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, response);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, response);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_wdbc_pipeline_send, 0);
 
     DispatchDBSync(data->ctx, data->lf);
 }
@@ -1030,16 +939,16 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_dispatch_state_corrupted_message, setup_dispatch_state, teardown_dispatch_state),
         cmocka_unit_test_setup_teardown(test_dispatch_state_query_too_long, setup_dispatch_state, teardown_dispatch_state),
         cmocka_unit_test_setup_teardown(test_dispatch_state_unable_to_communicate_with_db, setup_dispatch_state, teardown_dispatch_state),
-        cmocka_unit_test_setup_teardown(test_dispatch_state_no_response_from_db, setup_dispatch_state, teardown_dispatch_state),
-        cmocka_unit_test_setup_teardown(test_dispatch_state_error_parsing_response, setup_dispatch_state, teardown_dispatch_state),
 
         /* dispatch_clear */
         cmocka_unit_test_setup_teardown(test_dispatch_clear_success, setup_dispatch_clear, teardown_dispatch_clear),
         cmocka_unit_test_setup_teardown(test_dispatch_clear_corrupted_message, setup_dispatch_clear, teardown_dispatch_clear),
         cmocka_unit_test_setup_teardown(test_dispatch_clear_query_too_long, setup_dispatch_clear, teardown_dispatch_clear),
         cmocka_unit_test_setup_teardown(test_dispatch_clear_unable_to_communicate_with_db, setup_dispatch_clear, teardown_dispatch_clear),
-        cmocka_unit_test_setup_teardown(test_dispatch_clear_no_response_from_db, setup_dispatch_clear, teardown_dispatch_clear),
-        cmocka_unit_test_setup_teardown(test_dispatch_clear_error_parsing_response, setup_dispatch_clear, teardown_dispatch_clear),
+
+        /* DispatchDBSyncFlush */
+        cmocka_unit_test_setup_teardown(test_DispatchDBSyncFlush_success, setup_dispatch_answer, teardown_dispatch_answer),
+        cmocka_unit_test(test_DispatchDBSyncFlush_null_ctx),
 
         /* DispatchDBSync */
         cmocka_unit_test_setup_teardown(test_DispatchDBSync_integrity_check_success, setup_DispatchDBSync, teardown_DispatchDBSync),
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+
+#include "../../headers/shared.h"
+#include "../../analysisd/eventinfo.h"
+#include "../../analysisd/config.h"
+
+#include "../wrappers/wazuh/shared/debug_op_wrappers.h"
+
+/* setup/teardown */
+
+static int setup_event(void **state) {
+    Config.decoder_order_size = 8;
+    *state = w_event_new();
+    return 0;
+}
+
+static int teardown_event(void **state) {
+    Free_Eventinfo(*state);
+    return 0;
+}
+
+/* Add a field the way the decoders do */
+static void add_field(Eventinfo *lf, const char *key, const char *value) {
+    char *field;
+
+    os_strdup(value, field);
+    DynamicField_FP(lf, field, key);
+}
+
+/* Add a field without indexing it, the way the FIM and rootcheck decoders do */
+static void set_field(Eventinfo *lf, const char *key, const char *value) {
+    os_strdup(key, lf->fields[lf->nfields].key);
+    os_strdup(value, lf->fields[lf->nfields].value);
+    lf->nfields++;
+}
+
+/* tests */
+
+/* FindField */
+void test_FindField_indexed(void **state) {
+    Eventinfo *lf = *state;
+
+    add_field(lf, "srcip", "192.168.0.1");
+    add_field(lf, "win.system.eventID", "4625");
+    add_field(lf, "win.system.channel", "Security");
+
+    assert_int_equal(lf->field_indexed, 3);
+
+    assert_string_equal(FindField(lf, "srcip"), "192.168.0.1");
+    assert_string_equal(FindField(lf, "win.system.eventID"), "4625");
+    assert_string_equal(FindField(lf, "win.system.channel"), "Security");
+}
+
+void test_FindField_case_insensitive(void **state) {
+    Eventinfo *lf = *state;
+
+    add_field(lf, "win.system.eventID", "4625");
+
+    assert_string_equal(FindField(lf, "WIN.System.EventId"), "4625");
+}
+
+void test_FindField_miss(void **state) {
+    Eventinfo *lf = *state;
+
+    add_field(lf, "win.system.eventID", "4625");
+
+    assert_null(FindField(lf, "win.system"));
+    assert_null(FindField(lf, "win.system.eventID.value"));
+    assert_null(FindField(lf, "srcip"));
+}
+
+void test_FindField_miss_empty(void **state) {
+    Eventinfo *lf = *state;
+
+    assert_int_equal(lf->field_indexed, 0);
+    assert_null(FindField(lf, "srcip"));
+}
+
+void test_FindField_repeated_name(void **state) {
+    Eventinfo *lf = *state;
+
+    add_field(lf, "user", "root");
+    add_field(lf, "USER", "admin");
+
+    assert_int_equal(lf->nfields, 2);
+    assert_int_equal(lf->field_indexed, 2);
+
+    // The first field with the name wins, as with the linear scan
+    assert_string_equal(FindField(lf, "user"), "root");
+}
+
+void test_FindField_unindexed_fields(void **state) {
+    Eventinfo *lf = *state;
+
+    add_field(lf, "srcip", "192.168.0.1");
+    set_field(lf, "file", "/etc/passwd");
+
+    // The index only holds a contiguous prefix of the fields
+    add_field(lf, "dstip", "10.0.0.1");
+
+    assert_int_equal(lf->nfields, 3);
+    assert_int_equal(lf->field_indexed, 1);
+
+    assert_string_equal(FindField(lf, "srcip"), "192.168.0.1");
+    assert_string_equal(FindField(lf, "file"), "/etc/passwd");
+    assert_string_equal(FindField(lf, "dstip"), "10.0.0.1");
+    assert_null(FindField(lf, "srcport"));
+}
+
+void test_FindField_no_index(void **state) {
+    Eventinfo *lf;
+
+    os_calloc(1, sizeof(Eventinfo), lf);
+    os_calloc(2, sizeof(DynamicField), lf->fields);
+
+    set_field(lf, "srcip", "192.168.0.1");
+    add_field(lf, "dstip", "10.0.0.1");
+
+    assert_null(lf->field_index);
+    assert_int_equal(lf->field_indexed, 0);
+
+    assert_string_equal(FindField(lf, "srcip"), "192.168.0.1");
+    assert_string_equal(FindField(lf, "dstip"), "10.0.0.1");
+    assert_null(FindField(lf, "srcport"));
+
+    Free_Eventinfo(lf);
+}
+
+void test_FindField_full_index(void **state) {
+    Eventinfo *lf = *state;
+    char key[16];
+    int i;
+
+    for (i = 0; i < Config.decoder_order_size; i++) {
+        snprintf(key, sizeof(key), "field%d", i);
+        add_field(lf, key, key);
+    }
+
+    assert_int_equal(lf->field_indexed, Config.decoder_order_size);
+
+    for (i = 0; i < Config.decoder_order_size; i++) {
+        snprintf(key, sizeof(key), "field%d", i);
+        assert_string_equal(FindField(lf, key), key);
+    }
+
+    assert_null(FindField(lf, "field8"));
+}
+
+void test_FindField_new_generation(void **state) {
+    Eventinfo *lf = *state;
+    u_int16_t gen = lf->field_index_gen;
+
+    add_field(lf, "srcip", "192.168.0.1");
+    os_free(lf->fields[0].key);
+
+    Zero_Eventinfo(lf);
+
+    assert_int_equal(lf->field_index_gen, gen + 1);
+    assert_int_equal(lf->field_indexed, 0);
+
+    // The slot of the previous event is stale, not a hit on the cleared field
+    add_field(lf, "dstip", "10.0.0.1");
+
+    assert_null(FindField(lf, "srcip"));
+    assert_string_equal(FindField(lf, "dstip"), "10.0.0.1");
+}
+
+void test_FindField_generation_wrap(void **state) {
+    Eventinfo *lf = *state;
+    unsigned int i;
+
+    add_field(lf, "srcip", "192.168.0.1");
+    os_free(lf->fields[0].key);
+
+    // The slot was stamped with generation 1, which comes back after the wrap
+    assert_int_equal(lf->field_index_gen, 1);
+    lf->field_index_gen = 0xFFFF;
+
+    Zero_Eventinfo(lf);
+
+    // Generation 0 marks the free slots, so the table is cleared instead
+    assert_int_equal(lf->field_index_gen, 1);
+    for (i = 0; i < lf->field_index_size; i++) {
+        assert_int_equal(lf->field_index[i], 0);
+    }
+
+    add_field(lf, "dstip", "10.0.0.1");
+
+    assert_null(FindField(lf, "srcip"));
+    assert_string_equal(FindField(lf, "dstip"), "10.0.0.1");
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        // Tests FindField
+        cmocka_unit_test_setup_teardown(test_FindField_indexed, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_case_insensitive, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_miss, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_miss_empty, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_repeated_name, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_unindexed_fields, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_full_index, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_new_generation, setup_event, teardown_event),
+        cmocka_unit_test_setup_teardown(test_FindField_generation_wrap, setup_event, teardown_event),
+        cmocka_unit_test(test_FindField_no_index),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -20,6 +20,7 @@
 #include "error_messages/error_messages.h"
 #include "error_messages/debug_messages.h"
 #include "../../analysisd/analysisd.h"
+#include "../../analysisd/eventinfo.h"
 
 void os_remove_decoders_list(OSDecoderNode *decoderlist_pn, OSDecoderNode *decoderlist_npn);
 void os_remove_decodernode(OSDecoderNode *node, OSDecoderInfo **decoders, int *pos, int *max_size);
@@ -140,6 +141,180 @@ void test_os_remove_decoders_list_OK(void **state)
 
 }
 
+/* OS_BuildDecoderIndex */
+static OSDecoderNode * build_decoder_list(const char ** prematches, const char ** program_names, int size) {
+
+    OSDecoderNode * list;
+    os_calloc(size, sizeof(OSDecoderNode), list);
+
+    for (int i = 0; i < size; i++) {
+        os_calloc(1, sizeof(OSDecoderInfo), list[i].osdecoder);
+        list[i].next = (i + 1 < size) ? &list[i + 1] : NULL;
+
+        if (prematches && prematches[i]) {
+            w_calloc_expression_t(&list[i].osdecoder->prematch, EXP_TYPE_OSREGEX);
+            assert_true(w_expression_compile(list[i].osdecoder->prematch, (char *) prematches[i], 0));
+        }
+
+        if (program_names && program_names[i]) {
+            w_calloc_expression_t(&list[i].osdecoder->program_name, EXP_TYPE_OSMATCH);
+            assert_true(w_expression_compile(list[i].osdecoder->program_name, (char *) program_names[i], 0));
+        }
+    }
+
+    return list;
+}
+
+static void free_decoder_list(OSDecoderNode * list, int size) {
+
+    os_remove_decoder_index(list->index);
+
+    for (int i = 0; i < size; i++) {
+        w_free_expression_t(&list[i].osdecoder->prematch);
+        w_free_expression_t(&list[i].osdecoder->program_name);
+        os_free(list[i].osdecoder);
+    }
+
+    os_free(list);
+}
+
+void test_OS_BuildDecoderIndex_few_parents(void **state)
+{
+    const char * prematches[] = {"^a", "^b"};
+    OSDecoderNode * list = build_decoder_list(prematches, NULL, 2);
+
+    OS_BuildDecoderIndex(list);
+
+    assert_null(list->index);
+
+    free_decoder_list(list, 2);
+}
+
+void test_OS_BuildDecoderIndex_prematch(void **state)
+{
+    const char * prematches[] = {"^sshd", "^abc$", "foo\\d+", "\\d+bar", "^Oct |^Nov ", "xyz", NULL, "^sshd["};
+    OSDecoderNode * list = build_decoder_list(prematches, NULL, 8);
+    unsigned char candidates[DECODER_INDEX_MAX_PARENTS];
+    Eventinfo lf = {0};
+
+    OS_BuildDecoderIndex(list);
+
+    assert_non_null(list->index);
+    assert_int_equal(list->index->size, 8);
+    assert_int_equal(list->index->n_program_name, 0);
+
+    // Parents without a literal key are always tried
+    assert_int_equal(list->index->fallback[3], 1);
+    assert_int_equal(list->index->fallback[6], 1);
+
+    lf.log = "SSHD[12]: foo12 nov";
+    assert_true(OS_GetDecoderCandidates(list->index, &lf, candidates));
+
+    unsigned char expected[] = {1, 0, 1, 1, 0, 0, 1, 1};
+    assert_memory_equal(candidates, expected, sizeof(expected));
+
+    lf.log = "abc";
+    assert_true(OS_GetDecoderCandidates(list->index, &lf, candidates));
+
+    unsigned char expected_exact[] = {0, 1, 0, 1, 0, 0, 1, 0};
+    assert_memory_equal(candidates, expected_exact, sizeof(expected_exact));
+
+    free_decoder_list(list, 8);
+}
+
+void test_OS_BuildDecoderIndex_program_name(void **state)
+{
+    const char * program_names[] = {"^sshd$", "^su", "cron", "!sshd", "^vsftpd|ftpd$", "^", "^a$", "^b$"};
+    OSDecoderNode * list = build_decoder_list(NULL, program_names, 8);
+    unsigned char candidates[DECODER_INDEX_MAX_PARENTS];
+    Eventinfo lf = {0};
+
+    OS_BuildDecoderIndex(list);
+
+    assert_non_null(list->index);
+    assert_int_equal(list->index->n_program_name, 6);
+
+    lf.log = "log";
+    lf.program_name = "sudo";
+    assert_true(OS_GetDecoderCandidates(list->index, &lf, candidates));
+
+    unsigned char expected[] = {0, 1, 0, 1, 0, 1, 0, 0};
+    assert_memory_equal(candidates, expected, sizeof(expected));
+
+    lf.program_name = "pure-ftpd";
+    assert_true(OS_GetDecoderCandidates(list->index, &lf, candidates));
+
+    unsigned char expected_ftpd[] = {0, 0, 0, 1, 1, 1, 0, 0};
+    assert_memory_equal(candidates, expected_ftpd, sizeof(expected_ftpd));
+
+    // Without program name, the program name keys do not apply
+    lf.program_name = NULL;
+    assert_false(OS_GetDecoderCandidates(list->index, &lf, candidates));
+
+    free_decoder_list(list, 8);
+}
+
+void test_OS_SkipUnusedDecodersFields(void **state)
+{
+    OSDecoderNode * list;
+    OSDecoderInfo * parent;
+    OSDecoderInfo * child;
+    OSHash * fields = OSHash_Create();
+    char * field;
+
+    Config.decoder_order_size = 3;
+
+    os_calloc(1, sizeof(OSDecoderNode), list);
+    os_calloc(1, sizeof(OSDecoderNode), list->child);
+    os_calloc(1, sizeof(OSDecoderInfo), parent);
+    os_calloc(1, sizeof(OSDecoderInfo), child);
+    list->osdecoder = parent;
+    list->child->osdecoder = child;
+
+    os_calloc(3, sizeof(void *), parent->order);
+    os_calloc(3, sizeof(char *), parent->fields);
+    parent->order[0] = SrcIP_FP;
+    parent->order[1] = DynamicField_FP;
+    parent->fields[1] = "Session";
+
+    os_calloc(3, sizeof(void *), child->order);
+    os_calloc(3, sizeof(char *), child->fields);
+    os_calloc(3, sizeof(char), child->fts_fields);
+    child->order[0] = DynamicField_FP;
+    child->order[1] = DynamicField_FP;
+    child->fields[0] = "data.win.user";
+    child->fields[1] = "logon_type";
+    child->fts_fields[1] = 1;
+
+    OSHash_Add_ins(fields, "session", list);
+    OS_AddDecodersFields(fields, list);
+
+    assert_non_null(OSHash_Get(fields, "logon_type"));
+    assert_null(OSHash_Get(fields, "data.win.user"));
+
+    OS_SkipUnusedDecodersFields(fields, list);
+
+    assert_ptr_equal(parent->order[0], SrcIP_FP);
+    assert_ptr_equal(parent->order[1], DynamicField_FP);
+    assert_ptr_equal(child->order[0], UnusedField_FP);
+    assert_ptr_equal(child->order[1], DynamicField_FP);
+
+    // The skipped captures are released
+    os_strdup("administrator", field);
+    assert_null(child->order[0](NULL, field, child->fields[0]));
+
+    OSHash_Free(fields);
+    os_free(parent->order);
+    os_free(parent->fields);
+    os_free(child->order);
+    os_free(child->fields);
+    os_free(child->fts_fields);
+    os_free(parent);
+    os_free(child);
+    os_free(list->child);
+    os_free(list);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -150,7 +325,13 @@ int main(void)
         cmocka_unit_test(test_os_remove_decodernode_no_child),
         cmocka_unit_test(test_os_remove_decodernode_child),
         // Tests os_remove_decoders_list
-        cmocka_unit_test(test_os_remove_decoders_list_OK)
+        cmocka_unit_test(test_os_remove_decoders_list_OK),
+        // Tests OS_BuildDecoderIndex
+        cmocka_unit_test(test_OS_BuildDecoderIndex_few_parents),
+        cmocka_unit_test(test_OS_BuildDecoderIndex_prematch),
+        cmocka_unit_test(test_OS_BuildDecoderIndex_program_name),
+        // Tests OS_SkipUnusedDecodersFields
+        cmocka_unit_test(test_OS_SkipUnusedDecodersFields)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -198,11 +198,6 @@ void test_all_agents_success_json_string(void **state)
 
     will_return(__wrap_OS_GetOneContentforElement, node_1);
 
-    expect_value(__wrap_OS_SendUnix, socket, arq);
-    expect_string(__wrap_OS_SendUnix, msg, exec_msg_1);
-    expect_value(__wrap_OS_SendUnix, size, 0);
-    will_return(__wrap_OS_SendUnix, 1);
-
     // Alert 2
 
     wlabel_t *labels_2 = NULL;
@@ -217,11 +212,18 @@ void test_all_agents_success_json_string(void **state)
     expect_string(__wrap_labels_get, key, labels_2->key);
     will_return(__wrap_labels_get, labels_2->value);
 
+    // Legacy agents first, then the agents that support JSON
+
     expect_value(__wrap_OS_SendUnix, socket, arq);
     expect_string(__wrap_OS_SendUnix, msg, exec_msg);
     expect_value(__wrap_OS_SendUnix, size, 0);
     will_return(__wrap_OS_SendUnix, 1);
 
+    expect_value(__wrap_OS_SendUnix, socket, arq);
+    expect_string(__wrap_OS_SendUnix, msg, exec_msg_1);
+    expect_value(__wrap_OS_SendUnix, size, 0);
+    will_return(__wrap_OS_SendUnix, 1);
+
     OS_Exec(&execq, &arq, &sock, data->lf, data->ar);
 }
 
@@ -287,11 +289,6 @@ void test_all_agents_success_json_string_wdb(void **state)
 
     will_return(__wrap_OS_GetOneContentforElement, node_1);
 
-    expect_value(__wrap_OS_SendUnix, socket, arq);
-    expect_string(__wrap_OS_SendUnix, msg, exec_msg_1);
-    expect_value(__wrap_OS_SendUnix, size, 0);
-    will_return(__wrap_OS_SendUnix, 1);
-
     // Alert 2
 
     wlabel_t *labels_2 = NULL;
@@ -306,6 +303,85 @@ void test_all_agents_success_json_string_wdb(void **state)
     expect_value(__wrap_wdb_get_agent_info, id, array[1]);
     will_return(__wrap_wdb_get_agent_info, agent_info_array_2);
 
+    // Legacy agents first, then the agents that support JSON
+
+    expect_value(__wrap_OS_SendUnix, socket, arq);
+    expect_string(__wrap_OS_SendUnix, msg, exec_msg);
+    expect_value(__wrap_OS_SendUnix, size, 0);
+    will_return(__wrap_OS_SendUnix, 1);
+
+    expect_value(__wrap_OS_SendUnix, socket, arq);
+    expect_string(__wrap_OS_SendUnix, msg, exec_msg_1);
+    expect_value(__wrap_OS_SendUnix, size, 0);
+    will_return(__wrap_OS_SendUnix, 1);
+
+    OS_Exec(&execq, &arq, &sock, data->lf, data->ar);
+}
+
+void test_all_agents_success_json_broadcast(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    int execq = 10;
+    int arq = 11;
+    int sock = -1;
+
+    char *version = "Wazuh v4.3.0";
+    data->ar->location = ALL_AGENTS;
+
+    char *exec_msg = "(local_source) [] NNS 003,005 {\"version\":1,\"origin\":{\"name\":\"node01\",\"module\":\"wazuh-analysisd\"},\"command\":\"restart-wazuh0\",\"parameters\":{\"extra_args\":[],\"alert\":[{\"timestamp\":\"2021-01-05T15:23:00.547+0000\",\"rule\":{\"level\":5,\"description\":\"File added to the system.\",\"id\":\"554\"}}]}}";
+    const char *alert_info = "[{\"timestamp\":\"2021-01-05T15:23:00.547+0000\",\"rule\":{\"level\":5,\"description\":\"File added to the system.\",\"id\":\"554\"}}]";
+    char *node = NULL;
+
+    os_strdup("node01", node);
+
+    Config.ar = 1;
+
+    int *array = NULL;
+    os_malloc(sizeof(int)*3, array);
+    array[0] = 3;
+    array[1] = 5;
+    array[2] = OS_INVALID;
+
+    expect_string(__wrap_wdb_get_agents_by_connection_status, status, AGENT_CS_ACTIVE);
+    will_return(__wrap_wdb_get_agents_by_connection_status, array);
+
+    // Agent 1
+
+    wlabel_t *labels_1 = NULL;
+    os_calloc(2, sizeof(wlabel_t), labels_1);
+
+    os_strdup("_wazuh_version", labels_1[0].key);
+    os_strdup(version, labels_1[0].value);
+
+    expect_string(__wrap_labels_find, agent_id, "003");
+    will_return(__wrap_labels_find, labels_1);
+
+    expect_string(__wrap_labels_get, key, labels_1->key);
+    will_return(__wrap_labels_get, labels_1->value);
+
+    // Agent 2
+
+    wlabel_t *labels_2 = NULL;
+    os_calloc(2, sizeof(wlabel_t), labels_2);
+
+    os_strdup("_wazuh_version", labels_2[0].key);
+    os_strdup(version, labels_2[0].value);
+
+    expect_string(__wrap_labels_find, agent_id, "005");
+    will_return(__wrap_labels_find, labels_2);
+
+    expect_string(__wrap_labels_get, key, labels_2->key);
+    will_return(__wrap_labels_get, labels_2->value);
+
+    // A single message for both agents
+
+    will_return(__wrap_Eventinfo_to_jsonstr, strdup(alert_info));
+
+    will_return(__wrap_OS_ReadXML, 1);
+
+    will_return(__wrap_OS_GetOneContentforElement, node);
+
     expect_value(__wrap_OS_SendUnix, socket, arq);
     expect_string(__wrap_OS_SendUnix, msg, exec_msg);
     expect_value(__wrap_OS_SendUnix, size, 0);
@@ -898,6 +974,7 @@ int main(void)
         // ALL_AGENTS
         cmocka_unit_test_setup_teardown(test_all_agents_success_json_string, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_all_agents_success_json_string_wdb, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_all_agents_success_json_broadcast, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_all_agents_success_fail_agt_info1, test_setup, test_teardown),
 
         // SPECIFIC_AGENT
@@ -19,6 +19,12 @@
 #include "../analysisd/labels.h"
 #include "labels_op.h"
 
+extern OSHash *label_cache;
+extern w_queue_t *label_refresh_queue;
+
+void labels_refresh(const char *agent_id, int *sock);
+void labels_prefetch(int *sock);
+
 /* setup/teardown */
 
 static int setup_labels_context(void **state) {
@@ -31,6 +37,54 @@ static int teardown_labels_local(void **state) {
     return OS_SUCCESS;
 }
 
+static int setup_labels_refresher(void **state) {
+    labels_init();
+    label_refresh_queue = queue_init(LABELS_REFRESH_QUEUE_SIZE);
+    Config.label_cache_maxage = 10;
+    return OS_SUCCESS;
+}
+
+static int teardown_labels_refresher(void **state) {
+    char *agent_id;
+
+    while (agent_id = queue_pop(label_refresh_queue), agent_id) {
+        os_free(agent_id);
+    }
+
+    queue_free(label_refresh_queue);
+    label_refresh_queue = NULL;
+    labels_finalize();
+    return OS_SUCCESS;
+}
+
+/* Helpers */
+
+static cJSON *labels_json(const char *value) {
+    cJSON* array = cJSON_CreateArray();
+    cJSON* label = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(label, "key", "\"label\"");
+    cJSON_AddStringToObject(label, "value", value);
+    cJSON_AddItemToArray(array, label);
+
+    return array;
+}
+
+/* Cache the labels of an agent as if they were loaded 'age' seconds ago */
+static wlabel_data_t *labels_cached(const char *agent_id, int id, const char *value, time_t age) {
+    int sock = -1;
+    wlabel_data_t *data;
+
+    expect_value(__wrap_wdb_get_agent_labels, id, id);
+    will_return(__wrap_wdb_get_agent_labels, labels_json(value));
+
+    labels_free(labels_find((char *)agent_id, &sock));
+
+    data = (wlabel_data_t *)OSHash_Get(label_cache, agent_id);
+    data->mtime -= age;
+    return data;
+}
+
 /* tests */
 
 void test_labels_find_manager_no_labels(void **state) {
@@ -102,13 +156,172 @@ void test_labels_find_agent_with_labels(void **state) {
     labels_free(labels);
 }
 
+void test_labels_find_agent_cached(void **state) {
+    int sock = -1;
+    wlabel_t *labels;
+
+    labels_cached("001", 1, "value", 0);
+
+    // Valid labels don't reach Wazuh DB
+    labels = labels_find("001", &sock);
+
+    assert_string_equal("value", labels_get(labels, "label"));
+    assert_true(queue_empty(label_refresh_queue));
+    labels_free(labels);
+}
+
+void test_labels_find_agent_expired_refresh_queued(void **state) {
+    int sock = -1;
+    wlabel_data_t *data = labels_cached("001", 1, "value", 20);
+    wlabel_t *labels;
+    char *agent_id;
+
+    // The expired labels are served and the agent is queued once
+    labels = labels_find("001", &sock);
+    assert_string_equal("value", labels_get(labels, "label"));
+    labels_free(labels);
+
+    labels = labels_find("001", &sock);
+    assert_string_equal("value", labels_get(labels, "label"));
+    labels_free(labels);
+
+    assert_int_equal(data->refreshing, 1);
+
+    agent_id = queue_pop(label_refresh_queue);
+    assert_string_equal(agent_id, "001");
+    os_free(agent_id);
+
+    assert_true(queue_empty(label_refresh_queue));
+}
+
+void test_labels_find_agent_expired_no_refresher(void **state) {
+    int sock = -1;
+    wlabel_t *labels;
+    w_queue_t *queue = label_refresh_queue;
+
+    labels_cached("001", 1, "old_value", 20);
+
+    // Without the refresher thread, the event thread waits for Wazuh DB
+    label_refresh_queue = NULL;
+
+    expect_value(__wrap_wdb_get_agent_labels, id, 1);
+    will_return(__wrap_wdb_get_agent_labels, labels_json("new_value"));
+
+    labels = labels_find("001", &sock);
+
+    label_refresh_queue = queue;
+
+    assert_string_equal("new_value", labels_get(labels, "label"));
+    labels_free(labels);
+}
+
+void test_labels_find_agent_expired_queue_full(void **state) {
+    int sock = -1;
+    wlabel_t *labels;
+    w_queue_t *queue = label_refresh_queue;
+
+    labels_cached("001", 1, "old_value", 20);
+
+    label_refresh_queue = queue_init(1);
+
+    expect_value(__wrap_wdb_get_agent_labels, id, 1);
+    will_return(__wrap_wdb_get_agent_labels, labels_json("new_value"));
+
+    labels = labels_find("001", &sock);
+
+    queue_free(label_refresh_queue);
+    label_refresh_queue = queue;
+
+    assert_string_equal("new_value", labels_get(labels, "label"));
+    labels_free(labels);
+}
+
+void test_labels_refresh(void **state) {
+    int sock = -1;
+    wlabel_data_t *data = labels_cached("001", 1, "old_value", 20);
+
+    data->refreshing = 1;
+
+    expect_value(__wrap_wdb_get_agent_labels, id, 1);
+    will_return(__wrap_wdb_get_agent_labels, labels_json("new_value"));
+
+    labels_refresh("001", &sock);
+
+    assert_int_equal(data->refreshing, 0);
+    assert_true(data->mtime >= time(NULL) - 1);
+    assert_string_equal("new_value", labels_get(data->labels, "label"));
+}
+
+void test_labels_refresh_error(void **state) {
+    int sock = -1;
+    wlabel_data_t *data = labels_cached("001", 1, "old_value", 20);
+    time_t mtime = data->mtime;
+
+    data->refreshing = 1;
+
+    expect_value(__wrap_wdb_get_agent_labels, id, 1);
+    will_return(__wrap_wdb_get_agent_labels, NULL);
+
+    labels_refresh("001", &sock);
+
+    // The stale labels are kept, and the next event requests them again
+    assert_int_equal(data->refreshing, 0);
+    assert_int_equal(data->mtime, mtime);
+    assert_string_equal("old_value", labels_get(data->labels, "label"));
+}
+
+void test_labels_prefetch(void **state) {
+    int sock = -1;
+    int *agents;
+    wlabel_data_t *data;
+
+    os_calloc(3, sizeof(int), agents);
+    agents[0] = 1;
+    agents[1] = 2;
+    agents[2] = -1;
+
+    labels_cached("001", 1, "value1", 0);
+
+    // Only the agents missing in the cache are requested
+    expect_value(__wrap_wdb_get_all_agents, include_manager, false);
+    will_return(__wrap_wdb_get_all_agents, agents);
+    expect_value(__wrap_wdb_get_agent_labels, id, 2);
+    will_return(__wrap_wdb_get_agent_labels, labels_json("value2"));
+
+    labels_prefetch(&sock);
+
+    data = (wlabel_data_t *)OSHash_Get(label_cache, "002");
+    assert_non_null(data);
+    assert_string_equal("value2", labels_get(data->labels, "label"));
+}
+
+void test_labels_prefetch_no_agents(void **state) {
+    int sock = -1;
+
+    expect_value(__wrap_wdb_get_all_agents, include_manager, false);
+    will_return(__wrap_wdb_get_all_agents, NULL);
+
+    labels_prefetch(&sock);
+
+    assert_int_equal(label_cache->elements, 0);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         /* dispatch_send_local */
         cmocka_unit_test_setup_teardown(test_labels_find_manager_no_labels, setup_labels_context, teardown_labels_local),
         cmocka_unit_test_setup_teardown(test_labels_find_manager_with_labels, setup_labels_context, teardown_labels_local),
         cmocka_unit_test_setup_teardown(test_labels_find_agent_no_labels, setup_labels_context, teardown_labels_local),
-        cmocka_unit_test_setup_teardown(test_labels_find_agent_with_labels, setup_labels_context, teardown_labels_local)
+        cmocka_unit_test_setup_teardown(test_labels_find_agent_with_labels, setup_labels_context, teardown_labels_local),
+        /* labels refresher */
+        cmocka_unit_test_setup_teardown(test_labels_find_agent_cached, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_find_agent_expired_refresh_queued, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_find_agent_expired_no_refresher, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_find_agent_expired_queue_full, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_refresh, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_refresh_error, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_prefetch, setup_labels_refresher, teardown_labels_refresher),
+        cmocka_unit_test_setup_teardown(test_labels_prefetch_no_agents, setup_labels_refresher, teardown_labels_refresher)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -175,7 +175,7 @@ int __wrap_OSHash_setSize(OSHash *self, unsigned int new_size) {
     return mock();
 }
 
-void __wrap_w_analysisd_accumulate_free(OSHash **acm_store) {
+void __wrap_w_analysisd_accumulate_free(OS_ACM_Hash **acm_store) {
     return;
 }
 
@@ -378,9 +378,9 @@ int __wrap_AddHash_Rule(RuleNode *node) {
     return mock_type(int);
 }
 
-int __wrap_Accumulate_Init(OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts) {
+int __wrap_Accumulate_Init(OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts) {
     if (session_load_acm_store) {
-        *acm_store = (OSHash *) 8;
+        *acm_store = (OS_ACM_Hash *) 8;
     }
     return mock_type(int);
 }
@@ -424,7 +424,7 @@ int __wrap_OS_CleanMSG(char *msg, Eventinfo *lf) {
     return mock_type(int);
 }
 
-Eventinfo * __wrap_Accumulate(Eventinfo *lf, OSHash **acm_store, int *acm_lookups, time_t *acm_purge_ts) {
+Eventinfo * __wrap_Accumulate(Eventinfo *lf, OS_ACM_Hash **acm_store, int *acm_lookups, time_t *acm_purge_ts) {
     return lf;
 }
 
@@ -1674,7 +1674,6 @@ void test_w_logtest_initialize_session_error_accumulate_init(void ** state) {
     will_return(__wrap_OSHash_Free, (OSStore *) 8);
     will_return(__wrap_OSHash_Free, (OSStore *) 8);
 
-    will_return(__wrap_OSHash_Free, (OSStore *) 8);
     will_return(__wrap_pthread_mutex_destroy, 0);
 
     session_load_acm_store = true;
@@ -1842,6 +1841,114 @@ void test_w_logtest_initialize_session_success_duplicate_key(void ** state) {
     os_free(session->token);
     os_free(session);
 }
+/* w_logtest_decoders_signature */
+void test_w_logtest_decoders_signature_no_files(void ** state) {
+
+    assert_null(w_logtest_decoders_signature(NULL));
+}
+
+void test_w_logtest_decoders_signature_missing_file(void ** state) {
+
+    char * files[] = {"/nonexistent/logtest_decoder.xml", NULL};
+
+    assert_null(w_logtest_decoders_signature(files));
+}
+
+void test_w_logtest_decoders_signature_OK(void ** state) {
+
+    char * files[] = {"/", "/", NULL};
+    char entry[OS_SIZE_256];
+    char expected[OS_SIZE_512];
+    struct stat file_stat;
+
+    stat("/", &file_stat);
+    snprintf(entry, sizeof(entry), "/:%lld:%lld", (long long) file_stat.st_size, (long long) file_stat.st_mtime);
+    snprintf(expected, sizeof(expected), "%s|%s", entry, entry);
+
+    char * signature = w_logtest_decoders_signature(files);
+
+    assert_string_equal(signature, expected);
+
+    os_free(signature);
+}
+
+/* w_logtest_decoders_load */
+void test_w_logtest_decoders_load_not_shared(void ** state) {
+
+    char * files[] = {"/nonexistent/logtest_decoder.xml", NULL};
+    w_logtest_session_t session = {0};
+
+    will_return(__wrap_ReadDecodeXML, 1);
+    will_return(__wrap_SetDecodeXML, 1);
+
+    assert_true(w_logtest_decoders_load(&session, files, NULL));
+
+    assert_null(session.decoders);
+    assert_ptr_equal(session.decoder_store, (OSStore *) 1);
+    assert_null(w_logtest_shared_decoders);
+}
+
+void test_w_logtest_decoders_load_error(void ** state) {
+
+    char * files[] = {"/", NULL};
+    w_logtest_session_t session = {0};
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    will_return(__wrap_ReadDecodeXML, 0);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    assert_false(w_logtest_decoders_load(&session, files, NULL));
+
+    assert_null(session.decoders);
+    assert_null(w_logtest_shared_decoders);
+}
+
+void test_w_logtest_decoders_load_shared(void ** state) {
+
+    char * files[] = {"/", NULL};
+    w_logtest_session_t first = {0};
+    w_logtest_session_t second = {0};
+    w_logtest_decoders_t * decoders;
+
+    /* The first session reads the decoders */
+    expect_function_call(__wrap_pthread_mutex_lock);
+    will_return(__wrap_ReadDecodeXML, 1);
+    will_return(__wrap_SetDecodeXML, 1);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    assert_true(w_logtest_decoders_load(&first, files, NULL));
+
+    /* The second one reuses them */
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    assert_true(w_logtest_decoders_load(&second, files, NULL));
+
+    decoders = w_logtest_shared_decoders;
+    assert_non_null(decoders);
+    assert_ptr_equal(first.decoders, decoders);
+    assert_ptr_equal(second.decoders, decoders);
+    assert_ptr_equal(second.decoder_store, (OSStore *) 1);
+    assert_int_equal(decoders->references, 3);
+
+    /* They are freed when they are not the latest ones and no session uses them */
+    w_logtest_shared_decoders = NULL;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    w_logtest_decoders_release(decoders);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    w_logtest_decoders_release(decoders);
+    assert_int_equal(decoders->references, 1);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    will_return(__wrap_OSStore_Free, NULL);
+    w_logtest_decoders_release(decoders);
+}
+
 /* w_logtest_generate_token */
 void test_w_logtest_generate_token_success(void ** state) {
 
@@ -6164,6 +6271,10 @@ void test_w_logtest_process_request_log_processing_rules_debug_true(void ** stat
     expect_any(__wrap_cJSON_AddItemToObject, object);
     expect_string(__wrap_cJSON_AddItemToObject, string, "rules_debug");
 
+    expect_string(__wrap_cJSON_AddNumberToObject, name, "decoders_tried");
+    expect_value(__wrap_cJSON_AddNumberToObject, number, 0);
+    will_return(__wrap_cJSON_AddNumberToObject, NULL);
+
     // w_logtest_add_msg_response
     os_analysisd_log_msg_t * message_error;
     os_calloc(1, sizeof(os_analysisd_log_msg_t), message_error);
@@ -6606,6 +6717,14 @@ int main(void)
         cmocka_unit_test(test_w_logtest_initialize_session_error_accumulate_init),
         cmocka_unit_test(test_w_logtest_initialize_session_success),
         cmocka_unit_test(test_w_logtest_initialize_session_success_duplicate_key),
+        // Tests w_logtest_decoders_signature
+        cmocka_unit_test(test_w_logtest_decoders_signature_no_files),
+        cmocka_unit_test(test_w_logtest_decoders_signature_missing_file),
+        cmocka_unit_test(test_w_logtest_decoders_signature_OK),
+        // Tests w_logtest_decoders_load
+        cmocka_unit_test(test_w_logtest_decoders_load_not_shared),
+        cmocka_unit_test(test_w_logtest_decoders_load_error),
+        cmocka_unit_test(test_w_logtest_decoders_load_shared),
         // Tests w_logtest_generate_token
         cmocka_unit_test(test_w_logtest_generate_token_success),
         cmocka_unit_test(test_w_logtest_generate_token_success_empty_bytes),
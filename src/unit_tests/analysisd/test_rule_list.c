@@ -25,6 +25,36 @@ void os_remove_ruleinfo(RuleInfo *ruleinfo);
 void os_remove_rules_list(RuleNode *node);
 int OS_AddChild(RuleInfo *read_rule, RuleNode **r_node, OSList* log_msg);
 
+static RuleNode * create_rule_children(int count) {
+    RuleNode *first = NULL;
+    RuleNode **last = &first;
+
+    for (int i = 0; i < count; i++) {
+        os_calloc(1, sizeof(RuleNode), *last);
+        os_calloc(1, sizeof(RuleInfo), (*last)->ruleinfo);
+        (*last)->ruleinfo->sigid = 100 + i;
+        last = &(*last)->next;
+    }
+
+    return first;
+}
+
+static void free_rule_children(RuleNode *node) {
+    RuleNode *next;
+
+    while (node) {
+        next = node->next;
+        if (node->ruleinfo->match) {
+            os_free(node->ruleinfo->match->match);
+            os_free(node->ruleinfo->match);
+        }
+        os_free(node->ruleinfo->program_name);
+        os_free(node->ruleinfo);
+        os_free(node);
+        node = next;
+    }
+}
+
 /* setup/teardown */
 
 static int setup_AR(void **state) {
@@ -315,6 +345,65 @@ void test_os_remove_rules_list_OK(void **state)
 
 }
 
+/* OS_BuildRuleIndex */
+void test_OS_BuildRuleIndex_few_children(void **state)
+{
+    RuleNode parent = { .ruleinfo = NULL };
+
+    parent.child = create_rule_children(RULE_INDEX_MIN_CHILDREN - 1);
+
+    OS_BuildRuleIndex(&parent);
+
+    assert_null(parent.child_index);
+
+    free_rule_children(parent.child);
+}
+
+void test_OS_BuildRuleIndex_OK(void **state)
+{
+    RuleNode parent = { .ruleinfo = NULL };
+    RuleNode *child;
+    RuleIndex *index;
+
+    parent.child = create_rule_children(RULE_INDEX_MIN_CHILDREN);
+
+    /* First child: decoded_as + program_name */
+    child = parent.child;
+    child->ruleinfo->decoded_as = 5;
+    w_calloc_expression_t(&child->ruleinfo->program_name, EXP_TYPE_OSMATCH);
+
+    /* Second child: affirmative match */
+    child = child->next;
+    w_calloc_expression_t(&child->ruleinfo->match, EXP_TYPE_OSMATCH);
+    assert_int_equal(OSMatch_Compile("Failed password|^Invalid user", child->ruleinfo->match->match, 0), 1);
+
+    /* Third child: negated match can't be gated */
+    child = child->next;
+    w_calloc_expression_t(&child->ruleinfo->match, EXP_TYPE_OSMATCH);
+    assert_int_equal(OSMatch_Compile("!accepted", child->ruleinfo->match->match, 0), 1);
+
+    OS_BuildRuleIndex(&parent);
+
+    index = parent.child_index;
+    assert_non_null(index);
+    assert_int_equal(index->size, RULE_INDEX_MIN_CHILDREN);
+    assert_true(index->has_literals);
+
+    assert_ptr_equal(index->entries[0].node, parent.child);
+    assert_int_equal(index->entries[0].decoded_as, 5);
+    assert_int_equal(index->entries[0].required, RULE_REQ_PROGRAM_NAME);
+    assert_false(index->entries[0].gated);
+    assert_true(index->entries[1].gated);
+    assert_false(index->entries[2].gated);
+
+    unsigned char found[RULE_INDEX_MIN_CHILDREN] = {0};
+    OSMultiMatch_Execute("sshd: invalid USER admin", &index->literals, found);
+    assert_int_equal(found[1], 1);
+    assert_int_equal(found[2], 0);
+
+    os_remove_rule_index(index);
+    free_rule_children(parent.child);
+}
 
 int main(void)
 {
@@ -329,7 +418,10 @@ int main(void)
         cmocka_unit_test(test_os_remove_ruleinfo_NULL),
         cmocka_unit_test_setup_teardown(test_os_remove_ruleinfo_OK, setup_AR, teardown_AR),
         // Tests os_remove_rules_list
-        cmocka_unit_test_setup_teardown(test_os_remove_rules_list_OK, setup_AR, teardown_AR)
+        cmocka_unit_test_setup_teardown(test_os_remove_rules_list_OK, setup_AR, teardown_AR),
+        // Tests OS_BuildRuleIndex
+        cmocka_unit_test(test_OS_BuildRuleIndex_few_children),
+        cmocka_unit_test(test_OS_BuildRuleIndex_OK)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -152,11 +152,114 @@ void test_different(void **state)
     os_free(different_lf);
 }
 
+/* tests for the correlation index used by Search_LastSids */
+
+void test_correlation_index_same_srcip(void **state)
+{
+    RuleInfo *searcher = state[0];
+    Eventinfo *lf = state[1];
+    Eventinfo *same_lf = state[2];
+    Eventinfo *different_lf = state[3];
+    RuleInfo *rule;
+
+    os_calloc(1, sizeof(RuleInfo), rule);
+    rule->sid_prev_matched = OSList_Create();
+
+    searcher->sid_search = rule->sid_prev_matched;
+    searcher->context_opts = FIELD_GFREQUENCY;
+    searcher->same_field = FIELD_SRCIP;
+    searcher->level = 10;
+    searcher->timeframe = 60;
+
+    OS_AddCorrelatedRule(rule, searcher);
+    assert_non_null(searcher->sid_index);
+    assert_int_equal(rule->sid_correlated_sz, 1);
+
+    same_lf->full_log = "same log";
+    same_lf->generated_rule = rule;
+    different_lf->full_log = "different log";
+    different_lf->generated_rule = rule;
+
+    OSList_AddData(rule->sid_prev_matched, different_lf);
+    OS_AddCorrelationEvent(rule, different_lf);
+
+    /* Events from other source IPs are not correlated */
+    assert_null(Search_LastSids(lf, NULL, searcher, NULL));
+
+    OSList_AddData(rule->sid_prev_matched, same_lf);
+    OS_AddCorrelationEvent(rule, same_lf);
+
+    assert_ptr_equal(Search_LastSids(lf, NULL, searcher, NULL), same_lf);
+    assert_int_equal(lf->matched, 10);
+    assert_string_equal(lf->last_events[0], "same log");
+
+    /* Removed events get out of the index */
+    lf->matched = 0;
+    OS_RemoveCorrelationEvent(same_lf);
+    assert_null(same_lf->sid_index_slots);
+    assert_null(Search_LastSids(lf, NULL, searcher, NULL));
+
+    OS_RemoveCorrelationEvent(different_lf);
+    assert_int_equal(searcher->sid_index->buckets->elements, 0);
+
+    free_strarray(lf->last_events);
+    os_remove_correlation_index(searcher->sid_index);
+    os_free(rule->sid_correlated);
+    OSList_Destroy(rule->sid_prev_matched);
+    os_free(rule);
+    os_free(searcher);
+    os_free(lf);
+    os_free(same_lf);
+    os_free(different_lf);
+}
+
+void test_correlation_index_missing_field(void **state)
+{
+    RuleInfo *searcher = state[0];
+    Eventinfo *lf = state[1];
+    Eventinfo *same_lf = state[2];
+    Eventinfo *different_lf = state[3];
+    RuleInfo *rule;
+
+    os_calloc(1, sizeof(RuleInfo), rule);
+    rule->sid_prev_matched = OSList_Create();
+
+    searcher->sid_search = rule->sid_prev_matched;
+    searcher->same_field = FIELD_SRCIP;
+    searcher->level = 10;
+    searcher->timeframe = 60;
+
+    OS_AddCorrelatedRule(rule, searcher);
+
+    /* Without agent ID the event can't get into the index */
+    same_lf->generated_rule = rule;
+    OSList_AddData(rule->sid_prev_matched, same_lf);
+    OS_AddCorrelationEvent(rule, same_lf);
+    assert_null(same_lf->sid_index_slots[0].bucket);
+    assert_int_equal(searcher->sid_index->buckets->elements, 0);
+
+    assert_null(Search_LastSids(lf, NULL, searcher, NULL));
+    assert_int_equal(lf->matched, 0);
+
+    OS_RemoveCorrelationEvent(same_lf);
+    os_remove_correlation_index(searcher->sid_index);
+    os_free(rule->sid_correlated);
+    OSList_Destroy(rule->sid_prev_matched);
+    os_free(rule);
+    os_free(searcher);
+    os_free(lf);
+    os_free(same_lf);
+    os_free(different_lf);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         /* Tests for same loop function */
         cmocka_unit_test_setup(test_same, testSetup),
-        cmocka_unit_test_setup(test_different, testSetup)
+        cmocka_unit_test_setup(test_different, testSetup),
+        /* Tests for the correlation index */
+        cmocka_unit_test_setup(test_correlation_index_same_srcip, testSetup),
+        cmocka_unit_test_setup(test_correlation_index_missing_field, testSetup)
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
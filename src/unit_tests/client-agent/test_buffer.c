@@ -18,10 +18,18 @@
 #include "../wrappers/posix/pthread_wrappers.h"
 
 int w_agentd_get_buffer_lenght();
+void buffer_flow_control(const cJSON * ack_info);
+int spill_init();
+int spill_write(const char * msg);
+char * spill_read();
 
 extern agent *agt;
 extern int i;
 extern int j;
+extern int eps_rate;
+extern int min_eps;
+extern int spill_size;
+extern const char * spill_dir;
 
 /* setup/teardown */
 
@@ -92,12 +100,166 @@ void test_w_agentd_get_buffer_lenght_buffer(void ** state)
 
 }
 
+/* buffer_flow_control */
+
+void test_buffer_flow_control_no_queue(void ** state)
+{
+    os_calloc(1, sizeof(agent), agt);
+    agt->events_persec = 500;
+    eps_rate = 100;
+
+    buffer_flow_control(NULL);
+
+    assert_int_equal(eps_rate, 500);
+
+    os_free(agt);
+}
+
+void test_buffer_flow_control_busy(void ** state)
+{
+    cJSON * ack_info = cJSON_Parse("{\"queue\":90}");
+
+    os_calloc(1, sizeof(agent), agt);
+    agt->events_persec = 500;
+    min_eps = 50;
+    eps_rate = 500;
+
+    buffer_flow_control(ack_info);
+    assert_int_equal(eps_rate, 250);
+
+    eps_rate = 60;
+
+    buffer_flow_control(ack_info);
+    assert_int_equal(eps_rate, 50);
+
+    cJSON_Delete(ack_info);
+    os_free(agt);
+}
+
+void test_buffer_flow_control_idle(void ** state)
+{
+    cJSON * ack_info = cJSON_Parse("{\"queue\":10}");
+
+    os_calloc(1, sizeof(agent), agt);
+    agt->events_persec = 500;
+    eps_rate = 250;
+
+    buffer_flow_control(ack_info);
+    assert_int_equal(eps_rate, 300);
+
+    eps_rate = 480;
+
+    buffer_flow_control(ack_info);
+    assert_int_equal(eps_rate, 500);
+
+    cJSON_Delete(ack_info);
+    os_free(agt);
+}
+
+void test_buffer_flow_control_steady(void ** state)
+{
+    cJSON * ack_info = cJSON_Parse("{\"queue\":50}");
+
+    os_calloc(1, sizeof(agent), agt);
+    agt->events_persec = 500;
+    eps_rate = 250;
+
+    buffer_flow_control(ack_info);
+    assert_int_equal(eps_rate, 250);
+
+    cJSON_Delete(ack_info);
+    os_free(agt);
+}
+
+/* spill_write / spill_read */
+
+void test_spill_write_read(void ** state)
+{
+    char dir[] = "/tmp/test_buffer_spill_XXXXXX";
+    char * msg;
+
+    assert_non_null(mkdtemp(dir));
+    spill_dir = dir;
+    spill_size = 1;
+
+    assert_int_equal(spill_init(), 0);
+    assert_null(spill_read());
+
+    assert_int_equal(spill_write("first event"), 0);
+    assert_int_equal(spill_write("second\nevent"), 0);
+
+    msg = spill_read();
+    assert_string_equal(msg, "first event");
+    os_free(msg);
+
+    assert_int_equal(spill_write("third event"), 0);
+
+    msg = spill_read();
+    assert_string_equal(msg, "second\nevent");
+    os_free(msg);
+
+    msg = spill_read();
+    assert_string_equal(msg, "third event");
+    os_free(msg);
+
+    assert_null(spill_read());
+
+    rmdir_ex(dir);
+    spill_size = 0;
+}
+
+void test_spill_read_missing_segment(void ** state)
+{
+    char dir[] = "/tmp/test_buffer_spill_XXXXXX";
+    char path[PATH_MAX];
+    char * msg;
+    FILE * fp;
+
+    assert_non_null(mkdtemp(dir));
+    spill_dir = dir;
+    spill_size = 1;
+
+    // Segment 2 was removed from the directory
+    snprintf(path, sizeof(path), "%s/0000000001.seg", dir);
+    assert_non_null(fp = fopen(path, "w"));
+    fprintf(fp, "11\nfirst event");
+    fclose(fp);
+
+    snprintf(path, sizeof(path), "%s/0000000003.seg", dir);
+    assert_non_null(fp = fopen(path, "w"));
+    fprintf(fp, "12\nsecond event");
+    fclose(fp);
+
+    assert_int_equal(spill_init(), 0);
+
+    msg = spill_read();
+    assert_string_equal(msg, "first event");
+    os_free(msg);
+
+    msg = spill_read();
+    assert_string_equal(msg, "second event");
+    os_free(msg);
+
+    assert_null(spill_read());
+
+    rmdir_ex(dir);
+    spill_size = 0;
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         // Tests w_agentd_get_buffer_lenght
         cmocka_unit_test(test_w_agentd_get_buffer_lenght_buffer_disabled),
         cmocka_unit_test(test_w_agentd_get_buffer_lenght_buffer_empty),
         cmocka_unit_test(test_w_agentd_get_buffer_lenght_buffer),
+        // Tests buffer_flow_control
+        cmocka_unit_test(test_buffer_flow_control_no_queue),
+        cmocka_unit_test(test_buffer_flow_control_busy),
+        cmocka_unit_test(test_buffer_flow_control_idle),
+        cmocka_unit_test(test_buffer_flow_control_steady),
+        // Tests spill_write and spill_read
+        cmocka_unit_test(test_spill_write_read),
+        cmocka_unit_test(test_spill_read_missing_segment),
     };
 
     return cmocka_run_group_tests(tests, setup_group, teardown_group);
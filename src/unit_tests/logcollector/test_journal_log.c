@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+
+#include "../../logcollector/logcollector.h"
+#include "../../logcollector/journal_log.h"
+#include "../../headers/shared.h"
+#include "../wrappers/common.h"
+
+bool w_journald_copy_field(const char * field, char * buffer, size_t size);
+int w_journald_format(char * buffer, size_t size, time_t timestamp, const char * hostname,
+                      const char * identifier, const char * pid, const char * message, int message_len);
+
+extern w_journal_lib_t journal_lib;
+
+/* Fake sd_journal_get_data(): the entry only has the _HOSTNAME field */
+static int fake_get_data(sd_journal * j, const char * field, const void ** data, size_t * length) {
+    static const char hostname[] = "_HOSTNAME=agent-hostname";
+
+    if (strcmp(field, "_HOSTNAME") != 0) {
+        return -2;
+    }
+
+    *data = hostname;
+    *length = sizeof(hostname) - 1;
+    return 0;
+}
+
+/* setup/teardown */
+
+static int setup_group(void ** state) {
+    setenv("TZ", "UTC", 1);
+    tzset();
+    return 0;
+}
+
+/* tests */
+
+/* w_journald_format */
+void test_w_journald_format_pid(void ** state) {
+    char buffer[OS_MAXSTR];
+
+    int length = w_journald_format(buffer, sizeof(buffer), 0, "host", "sshd", "1234", "Accepted publickey", 8);
+
+    assert_string_equal(buffer, "Jan  1 00:00:00 host sshd[1234]: Accepted");
+    assert_int_equal(length, strlen(buffer));
+}
+
+void test_w_journald_format_no_pid(void ** state) {
+    char buffer[OS_MAXSTR];
+
+    int length = w_journald_format(buffer, sizeof(buffer), 0, "host", "kernel", "", "Booting", 7);
+
+    assert_string_equal(buffer, "Jan  1 00:00:00 host kernel: Booting");
+    assert_int_equal(length, strlen(buffer));
+}
+
+void test_w_journald_format_truncated(void ** state) {
+    char buffer[24];
+
+    int length = w_journald_format(buffer, sizeof(buffer), 0, "host", "kernel", "", "Booting", 7);
+
+    assert_string_equal(buffer, "Jan  1 00:00:00 host ke");
+    assert_int_equal(length, sizeof(buffer) - 1);
+}
+
+/* w_journald_copy_field */
+void test_w_journald_copy_field(void ** state) {
+    char buffer[OS_SIZE_256];
+
+    journal_lib.get_data = fake_get_data;
+
+    assert_true(w_journald_copy_field("_HOSTNAME", buffer, sizeof(buffer)));
+    assert_string_equal(buffer, "agent-hostname");
+
+    journal_lib.get_data = NULL;
+}
+
+void test_w_journald_copy_field_truncated(void ** state) {
+    char buffer[6];
+
+    journal_lib.get_data = fake_get_data;
+
+    assert_true(w_journald_copy_field("_HOSTNAME", buffer, sizeof(buffer)));
+    assert_string_equal(buffer, "agent");
+
+    journal_lib.get_data = NULL;
+}
+
+void test_w_journald_copy_field_missing(void ** state) {
+    char buffer[OS_SIZE_256];
+
+    journal_lib.get_data = fake_get_data;
+
+    assert_false(w_journald_copy_field("_PID", buffer, sizeof(buffer)));
+    assert_string_equal(buffer, "");
+
+    journal_lib.get_data = NULL;
+}
+
+/* w_journald_get_status_as_JSON / w_journald_set_status_from_JSON */
+void test_w_journald_status_JSON(void ** state) {
+    cJSON * global_json = cJSON_CreateObject();
+    char * cursor = NULL;
+
+    assert_null(w_journald_get_status_as_JSON());
+
+    cJSON * journald = cJSON_AddObjectToObject(global_json, OS_LOGCOLLECTOR_JSON_JOURNALD);
+    cJSON_AddStringToObject(journald, OS_LOGCOLLECTOR_JSON_CURSOR, "s=abc;i=1");
+    w_journald_set_status_from_JSON(global_json);
+
+    cursor = w_journald_get_cursor();
+    assert_string_equal(cursor, "s=abc;i=1");
+    os_free(cursor);
+
+    cJSON * status = w_journald_get_status_as_JSON();
+    assert_string_equal(cJSON_GetStringValue(cJSON_GetObjectItem(status, OS_LOGCOLLECTOR_JSON_CURSOR)), "s=abc;i=1");
+
+    cJSON_Delete(status);
+    cJSON_Delete(global_json);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // Test w_journald_format
+        cmocka_unit_test(test_w_journald_format_pid),
+        cmocka_unit_test(test_w_journald_format_no_pid),
+        cmocka_unit_test(test_w_journald_format_truncated),
+        // Test w_journald_copy_field
+        cmocka_unit_test(test_w_journald_copy_field),
+        cmocka_unit_test(test_w_journald_copy_field_truncated),
+        cmocka_unit_test(test_w_journald_copy_field_missing),
+        // Test w_journald_get_status_as_JSON
+        cmocka_unit_test(test_w_journald_status_JSON),
+    };
+
+    return cmocka_run_group_tests(tests, setup_group, NULL);
+}
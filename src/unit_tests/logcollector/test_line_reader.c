@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+
+#include "../../logcollector/logcollector.h"
+#include "../../headers/shared.h"
+#include "../wrappers/common.h"
+#include "../wrappers/libc/stdio_wrappers.h"
+
+/* setup/teardown */
+
+static int setup_test_mode(void ** state) {
+    test_mode = 1;
+    return 0;
+}
+
+static int teardown_test_mode(void ** state) {
+    test_mode = 0;
+    return 0;
+}
+
+/* tests */
+
+/* w_line_reader_gets */
+void test_w_line_reader_gets_lines(void ** state) {
+    w_line_reader_t reader;
+    char str[OS_MAXSTR + 1];
+
+    w_line_reader_init(&reader, (FILE *)1, 10, NULL);
+
+    expect_fread("first\nsecond\n", 13);
+
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 6);
+    assert_string_equal(str, "first\n");
+    assert_int_equal(reader.position, 16);
+
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 7);
+    assert_string_equal(str, "second\n");
+    assert_int_equal(reader.position, 23);
+
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 0);
+    assert_true(reader.eof);
+
+    will_return(__wrap_fseek, 0);
+    w_line_reader_release(&reader, 23);
+}
+
+void test_w_line_reader_gets_incomplete_line(void ** state) {
+    w_line_reader_t reader;
+    char str[OS_MAXSTR + 1];
+
+    w_line_reader_init(&reader, (FILE *)1, 0, NULL);
+
+    expect_fread("line\npartial", 12);
+
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 5);
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 7);
+    assert_string_equal(str, "partial");
+    assert_true(reader.eof);
+
+    will_return(__wrap_fseek, 0);
+    w_line_reader_release(&reader, 5);
+}
+
+void test_w_line_reader_gets_long_line(void ** state) {
+    w_line_reader_t reader;
+    char str[OS_MAXSTR + 1];
+
+    w_line_reader_init(&reader, (FILE *)1, 0, NULL);
+
+    expect_fread("abcdefgh\n", 9);
+
+    /* Same as fgets: at most size - 1 bytes */
+    assert_int_equal(w_line_reader_gets(&reader, str, 5), 4);
+    assert_string_equal(str, "abcd");
+    assert_int_equal(w_line_reader_gets(&reader, str, 5), 4);
+    assert_string_equal(str, "efgh");
+    assert_int_equal(w_line_reader_gets(&reader, str, 5), 1);
+    assert_string_equal(str, "\n");
+
+    will_return(__wrap_fseek, 0);
+    w_line_reader_release(&reader, 9);
+}
+
+/* w_line_reader_release */
+void test_w_line_reader_release_hash(void ** state) {
+    w_line_reader_t reader;
+    char str[OS_MAXSTR + 1];
+    SHA_CTX context;
+    SHA_CTX expected;
+    unsigned char md[SHA_DIGEST_LENGTH];
+    unsigned char expected_md[SHA_DIGEST_LENGTH];
+
+    SHA1_Init(&context);
+    SHA1_Init(&expected);
+    SHA1_Update(&expected, "one\ntwo\n", 8);
+
+    w_line_reader_init(&reader, (FILE *)1, 0, &context);
+
+    expect_fread("one\ntwo\nthr", 11);
+
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 4);
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 4);
+    assert_int_equal(w_line_reader_gets(&reader, str, sizeof(str)), 3);
+
+    /* The incomplete line is not hashed */
+    will_return(__wrap_fseek, 0);
+    w_line_reader_release(&reader, 8);
+
+    SHA1_Final(md, &context);
+    SHA1_Final(expected_md, &expected);
+    assert_memory_equal(md, expected_md, SHA_DIGEST_LENGTH);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // Tests w_line_reader_gets
+        cmocka_unit_test_setup_teardown(test_w_line_reader_gets_lines, setup_test_mode, teardown_test_mode),
+        cmocka_unit_test_setup_teardown(test_w_line_reader_gets_incomplete_line, setup_test_mode, teardown_test_mode),
+        cmocka_unit_test_setup_teardown(test_w_line_reader_gets_long_line, setup_test_mode, teardown_test_mode),
+        // Tests w_line_reader_release
+        cmocka_unit_test_setup_teardown(test_w_line_reader_release_hash, setup_test_mode, teardown_test_mode),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
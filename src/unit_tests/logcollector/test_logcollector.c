@@ -28,6 +28,7 @@
 #include "../wrappers/wazuh/os_crypto/sha1_op_wrappers.h"
 #include "../wrappers/posix/pthread_wrappers.h"
 #include "../wrappers/posix/signal_wrappers.h"
+#include "../wrappers/linux/inotify_wrappers.h"
 
 
 extern OSHash *files_status;
@@ -41,6 +42,15 @@ void w_load_files_status(cJSON *global_json);
 void w_initialize_file_status();
 int w_update_hash_node(char * path, int64_t pos);
 int w_set_to_last_line_read(logreader *lf);
+void w_rebalance_input_threads();
+void w_inotify_unwatch(logreader *lf);
+int w_inotify_ready(logreader *lf);
+void w_inotify_set_ready(logreader *lf);
+
+extern int lc_inotify_fd;
+extern OSHash *lc_ready_wds;
+extern time_t lc_inotify_rescan;
+extern char * files_status_saved;
 
 // Auxiliar structs
 typedef struct test_logcollector_s {
@@ -52,6 +62,16 @@ typedef struct test_logcollector_s {
 
 extern w_macos_log_vault_t macos_log_vault;
 extern w_macos_log_procceses_t * macos_processes;
+
+typedef struct {
+    int rule;
+    w_expression_t * location;
+    w_expression_t * match;
+} w_drop_filter_t;
+
+extern w_drop_filter_t * drop_filters;
+extern unsigned int drop_filters_size;
+extern char * drop_filters_prefix;
 static wfd_t * stream_backup;
 static wfd_t * show_backup;
 
@@ -422,6 +442,9 @@ void test_w_save_files_status_to_cJSON_begin_NULL(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     char * ret = w_save_files_status_to_cJSON();
     assert_null(ret);
 }
@@ -481,6 +504,9 @@ void test_w_save_files_status_to_cJSON_OK(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, "test_1234");
 
     expect_function_call(__wrap_cJSON_Delete);
@@ -514,6 +540,9 @@ void test_w_save_files_status_to_cJSON_macos_invalid_vault(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     char * ret = w_save_files_status_to_cJSON();
     assert_null(ret);
 
@@ -564,6 +593,9 @@ void test_w_save_files_status_to_cJSON_macos_valid_vault(void ** state) {
     expect_function_call(__wrap_cJSON_AddItemToObject);
     will_return(__wrap_cJSON_AddItemToObject, true);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, "test_1234");
 
     expect_function_call(__wrap_cJSON_Delete);
@@ -591,6 +623,9 @@ void test_w_save_files_status_invalid_vault(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     char * ret = w_save_files_status_to_cJSON();
     assert_null(ret);
     assert_false(macos_log_vault.is_valid_data);
@@ -674,6 +709,9 @@ void test_w_save_files_status_to_cJSON_data(void ** state) {
     expect_function_call(__wrap_cJSON_AddItemToObject);
     will_return(__wrap_cJSON_AddItemToObject, true);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, "test_1234");
 
     expect_function_call(__wrap_cJSON_Delete);
@@ -708,6 +746,9 @@ void test_w_save_file_status_str_NULL(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     w_save_file_status();
 
 }
@@ -716,6 +757,8 @@ void test_w_save_file_status_str_NULL(void ** state) {
 void test_w_save_file_status_wfopen_error(void ** state) {
     test_logcollector_t *test_data = *state;
 
+    os_free(files_status_saved);
+
     os_file_status_t * data = test_data->status;
     OSHashNode *hash_node = test_data->node;
 
@@ -767,21 +810,26 @@ void test_w_save_file_status_wfopen_error(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, "test_1234");
 
     expect_function_call(__wrap_cJSON_Delete);
 
-    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json");
+    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json.tmp");
     expect_string(__wrap_wfopen, __modes, "w");
     will_return(__wrap_wfopen, 0);
 
-    expect_string(__wrap__merror_exit, formatted_msg, "(1103): Could not open file 'queue/logcollector/file_status.json' due to [(0)-(Success)].");
+    expect_string(__wrap__merror_exit, formatted_msg, "(1103): Could not open file 'queue/logcollector/file_status.json.tmp' due to [(0)-(Success)].");
     expect_assert_failure(w_save_file_status());
 }
 
 void test_w_save_file_status_fwrite_error(void ** state) {
     test_logcollector_t *test_data = *state;
 
+    os_free(files_status_saved);
+
     os_file_status_t * data = test_data->status;
     OSHashNode *hash_node = test_data->node;
 
@@ -834,17 +882,20 @@ void test_w_save_file_status_fwrite_error(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, strdup("test_1234"));
 
     expect_function_call(__wrap_cJSON_Delete);
 
-    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json");
+    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json.tmp");
     expect_string(__wrap_wfopen, __modes, "w");
     will_return(__wrap_wfopen, "test");
 
     will_return(__wrap_fwrite, 0);
 
-    expect_string(__wrap__merror, formatted_msg, "(1110): Could not write file 'queue/logcollector/file_status.json' due to [(0)-(Success)].");
+    expect_string(__wrap__merror, formatted_msg, "(1110): Could not write file 'queue/logcollector/file_status.json.tmp' due to [(0)-(Success)].");
 
     expect_function_call(__wrap_clearerr);
     expect_string(__wrap_clearerr, __stream, "test");
@@ -858,6 +909,9 @@ void test_w_save_file_status_fwrite_error(void ** state) {
 void test_w_save_file_status_OK(void ** state) {
     test_logcollector_t *test_data = *state;
 
+    // Nothing saved yet, so the status is written
+    os_free(files_status_saved);
+
     os_file_status_t * data = test_data->status;
     OSHashNode *hash_node = test_data->node;
 
@@ -909,11 +963,14 @@ void test_w_save_file_status_OK(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
     will_return(__wrap_cJSON_PrintUnformatted, strdup("test_1234"));
 
     expect_function_call(__wrap_cJSON_Delete);
 
-    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json");
+    expect_string(__wrap_wfopen, __filename, "queue/logcollector/file_status.json.tmp");
     expect_string(__wrap_wfopen, __modes, "w");
     will_return(__wrap_wfopen, "test");
 
@@ -922,7 +979,83 @@ void test_w_save_file_status_OK(void ** state) {
     expect_value(__wrap_fclose, _File, "test");
     will_return(__wrap_fclose, 1);
 
+    expect_rename_ex("queue/logcollector/file_status.json.tmp", "queue/logcollector/file_status.json", 0);
+
+    w_save_file_status();
+
+    assert_string_equal(files_status_saved, "test_1234");
+    os_free(files_status_saved);
+}
+
+void test_w_save_file_status_unchanged(void ** state) {
+    test_logcollector_t *test_data = *state;
+
+    // The same status was saved before, so the file is not written
+    os_free(files_status_saved);
+    os_strdup("test_1234", files_status_saved);
+
+    os_file_status_t * data = test_data->status;
+    OSHashNode *hash_node = test_data->node;
+
+    strcpy(data->hash,"test1234");
+    data->offset = 5;
+
+    hash_node->key = "test";
+    hash_node->data = data;
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    strcpy(macos_log_vault.timestamp,"hi 123");
+    macos_log_vault.settings = "my settings";
+
+    expect_value(__wrap_OSHash_Begin, self, files_status);
+    will_return(__wrap_OSHash_Begin, hash_node);
+
+    will_return(__wrap_cJSON_CreateObject, (cJSON *) 1);
+
+    expect_string(__wrap_cJSON_AddArrayToObject, name, "files");
+    will_return(__wrap_cJSON_AddArrayToObject, (cJSON *) 1);
+
+    will_return(__wrap_cJSON_CreateObject, (cJSON *) 1);
+
+    expect_string(__wrap_cJSON_AddStringToObject, name, "path");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "test");
+    will_return(__wrap_cJSON_AddStringToObject, (cJSON *)1);
+
+    expect_string(__wrap_cJSON_AddStringToObject, name, "hash");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "test1234");
+    will_return(__wrap_cJSON_AddStringToObject, (cJSON *)1);
+
+    expect_string(__wrap_cJSON_AddStringToObject, name, "offset");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "5");
+    will_return(__wrap_cJSON_AddStringToObject, (cJSON *)1);
+
+    expect_function_call(__wrap_cJSON_AddItemToArray);
+    will_return(__wrap_cJSON_AddItemToArray, true);
+
+    expect_value(__wrap_OSHash_Next, self, files_status);
+    will_return(__wrap_OSHash_Next, NULL);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    will_return(__wrap_cJSON_PrintUnformatted, strdup("test_1234"));
+
+    expect_function_call(__wrap_cJSON_Delete);
+
     w_save_file_status();
+
+    assert_string_equal(files_status_saved, "test_1234");
+    os_free(files_status_saved);
 }
 
 /* w_load_files_status */
@@ -947,6 +1080,12 @@ void test_w_load_files_status_empty_array(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -975,6 +1114,12 @@ void test_w_load_files_status_path_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1005,6 +1150,12 @@ void test_w_load_files_status_path_str_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1042,6 +1193,12 @@ void test_w_load_files_status_no_file(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1082,6 +1239,12 @@ void test_w_load_files_status_hash_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1124,6 +1287,12 @@ void test_w_load_files_status_hash_str_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1169,6 +1338,12 @@ void test_w_load_files_status_offset_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1216,6 +1391,12 @@ void test_w_load_files_status_offset_str_NULL(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 }
 
@@ -1262,6 +1443,12 @@ void test_w_load_files_status_invalid_offset(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1271,7 +1458,6 @@ void test_w_load_files_status_update_add_fail(void ** state) {
 
     cJSON *global_json = (cJSON*)1;
 
-    int mode = OS_BINARY;
     struct stat stat_buf = { .st_mode = 0040000 };
     strcpy(macos_log_vault.timestamp,"hi 123");
     macos_log_vault.settings = "my settings";
@@ -1301,12 +1487,6 @@ void test_w_load_files_status_update_add_fail(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, "1");
 
-    expect_string(__wrap_OS_SHA1_File_Nbytes, fname, file);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, mode, mode);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, nbytes, 1);
-    will_return(__wrap_OS_SHA1_File_Nbytes, "32bb98743e298dee0a654a654765c765d765ae80");
-    will_return(__wrap_OS_SHA1_File_Nbytes, 1);
-
     will_return(__wrap_OSHash_Update_ex, 0);
 
     expect_value(__wrap_OSHash_Add_ex, self, files_status);
@@ -1325,51 +1505,11 @@ void test_w_load_files_status_update_add_fail(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
-    w_load_files_status(global_json);
-}
-
-void test_w_load_files_status_update_hash_fail (void ** state) {
-    char * file = "test";
-
-    cJSON *global_json = (cJSON*)1;
-
-    int mode = OS_BINARY;
-    struct stat stat_buf = { .st_mode = 0040000 };
-    strcpy(macos_log_vault.timestamp,"hi 123");
-    macos_log_vault.settings = "my settings";
-
     will_return(__wrap_cJSON_GetObjectItem, NULL);
 
-    will_return(__wrap_cJSON_GetArraySize, 1);
-
-    will_return(__wrap_cJSON_GetArrayItem, NULL);
-
-    //Path
-    will_return(__wrap_cJSON_GetObjectItem, 1);
-
-    will_return(__wrap_cJSON_GetStringValue, "test");
-
-    expect_string(__wrap_stat, __file, file);
-    will_return(__wrap_stat, &stat_buf);
-    will_return(__wrap_stat, 0);
-
-    //Hash
-    will_return(__wrap_cJSON_GetObjectItem, 1);
-
-    will_return(__wrap_cJSON_GetStringValue, "32bb98743e298dee0a654a654765c765d765ae80");
-
-    //Offset
-    will_return(__wrap_cJSON_GetObjectItem, 1);
-
-    will_return(__wrap_cJSON_GetStringValue, "1");
-
-    expect_string(__wrap_OS_SHA1_File_Nbytes, fname, file);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, mode, mode);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, nbytes, 1);
-    will_return(__wrap_OS_SHA1_File_Nbytes, "32bb98743e298dee0a654a654765c765d765ae80");
-    will_return(__wrap_OS_SHA1_File_Nbytes, -1);
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
 
-    expect_string(__wrap__mdebug1, formatted_msg, "(9000): File 'test' no longer exists.");
+    will_return(__wrap_cJSON_GetStringValue, NULL);
 
     w_load_files_status(global_json);
 }
@@ -1379,7 +1519,6 @@ void test_w_load_files_status_update_fail(void ** state) {
 
     cJSON *global_json = (cJSON*)1;
 
-    int mode = OS_BINARY;
     struct stat stat_buf = { .st_mode = 0040000 };
     strcpy(macos_log_vault.timestamp,"hi 123");
     macos_log_vault.settings = "my settings";
@@ -1409,12 +1548,6 @@ void test_w_load_files_status_update_fail(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, "1");
 
-    expect_string(__wrap_OS_SHA1_File_Nbytes, fname, file);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, mode, mode);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, nbytes, 1);
-    will_return(__wrap_OS_SHA1_File_Nbytes, "32bb98743e298dee0a654a654765c765d765ae80");
-    will_return(__wrap_OS_SHA1_File_Nbytes, 1);
-
     will_return(__wrap_OSHash_Update_ex, 0);
 
     expect_value(__wrap_OSHash_Add_ex, self, files_status);
@@ -1431,6 +1564,12 @@ void test_w_load_files_status_update_fail(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1443,7 +1582,6 @@ void test_w_load_files_status_OK(void ** state) {
     __real_OSHash_Add_ex(mock_hashmap, file, strdup("data to be replaced"));
     cJSON *global_json = (cJSON*)1;
 
-    int mode = OS_BINARY;
     struct stat stat_buf = { .st_mode = 0040000 };
 
     will_return(__wrap_cJSON_GetObjectItem, NULL);
@@ -1471,12 +1609,6 @@ void test_w_load_files_status_OK(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, "1");
 
-    expect_string(__wrap_OS_SHA1_File_Nbytes, fname, file);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, mode, mode);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, nbytes, 1);
-    will_return(__wrap_OS_SHA1_File_Nbytes, "32bb98743e298dee0a654a654765c765d765ae80");
-    will_return(__wrap_OS_SHA1_File_Nbytes, 1);
-
     will_return(__wrap_OSHash_Update_ex, 1);
 
     will_return(__wrap_cJSON_GetObjectItem, NULL);
@@ -1489,6 +1621,12 @@ void test_w_load_files_status_OK(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
 }
@@ -1514,6 +1652,12 @@ void test_w_load_files_status_valid_timestamp_only(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, NULL);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
     assert_string_equal(macos_log_vault.settings, "my settings");
@@ -1541,6 +1685,12 @@ void test_w_load_files_status_valid_settings_only(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, "/usr/bin/log stream --style syslog");
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
     assert_string_equal(macos_log_vault.settings, "my settings");
@@ -1579,6 +1729,12 @@ void test_w_load_files_status_valid_vault(void ** state) {
     expect_function_call(__wrap_pthread_rwlock_wrlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetObjectItem, NULL);
+
+    will_return(__wrap_cJSON_GetStringValue, NULL);
+
     w_load_files_status(global_json);
 
     assert_string_equal(macos_log_vault.timestamp, "2021-04-27 08:07:20-0700");
@@ -1656,7 +1812,6 @@ void test_w_initialize_file_status_fread_fail(void ** state) {
 }
 
 void test_w_initialize_file_status_OK(void ** state) {
-    int mode = OS_BINARY;
     char * file = "test";
     struct stat stat_buf = { .st_mode = 0040000 };
 
@@ -1706,12 +1861,6 @@ void test_w_initialize_file_status_OK(void ** state) {
 
     will_return(__wrap_cJSON_GetStringValue, "1");
 
-    expect_string(__wrap_OS_SHA1_File_Nbytes, fname, file);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, mode, mode);
-    expect_value(__wrap_OS_SHA1_File_Nbytes, nbytes, 1);
-    will_return(__wrap_OS_SHA1_File_Nbytes, "32bb98743e298dee0a654a654765c765d765ae80");
-    will_return(__wrap_OS_SHA1_File_Nbytes, 1);
-
     will_return(__wrap_OSHash_Update_ex, 1);
 
     will_return(__wrap_cJSON_GetObjectItem, NULL);
@@ -2299,10 +2448,81 @@ void test_w_macos_release_log_execution_log_stream_not_launched_and_show_launche
 
 }
 
+/* w_drop_filters_match */
+
+void test_w_drop_filters_match(void ** state) {
+    w_drop_filter_t filters[2] = { { .rule = 100100 }, { .rule = 100101 } };
+
+    w_calloc_expression_t(&filters[0].location, EXP_TYPE_OSMATCH);
+    w_expression_compile(filters[0].location, "^(agent) any->/var/log/noisy.log", 0);
+    w_calloc_expression_t(&filters[0].match, EXP_TYPE_OSMATCH);
+    w_expression_compile(filters[0].match, "healthcheck", 0);
+    w_calloc_expression_t(&filters[1].match, EXP_TYPE_OSMATCH);
+    w_expression_compile(filters[1].match, "^keepalive probe", 0);
+
+    drop_filters = filters;
+    drop_filters_size = 2;
+    drop_filters_prefix = "(agent) any->";
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap__mdebug2, formatted_msg, "Log 'GET /healthcheck 200' dropped by the filter of rule 100100.");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_true(w_drop_filters_match("/var/log/noisy.log", "GET /healthcheck 200"));
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_false(w_drop_filters_match("/var/log/other.log", "GET /healthcheck 200"));
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_false(w_drop_filters_match("/var/log/noisy.log", "GET /login 200"));
+
+    drop_filters = NULL;
+    drop_filters_size = 0;
+    drop_filters_prefix = NULL;
+
+    for (int i = 0; i < 2; i++) {
+        w_free_expression_t(&filters[i].location);
+        w_free_expression_t(&filters[i].match);
+    }
+}
+
+void test_w_drop_filters_match_predecoded(void ** state) {
+    w_drop_filter_t filter = { .rule = 100101 };
+
+    w_calloc_expression_t(&filter.match, EXP_TYPE_OSMATCH);
+    w_expression_compile(filter.match, "^keepalive probe", 0);
+
+    drop_filters = &filter;
+    drop_filters_size = 1;
+
+    // The syslog header is cut before the match, as analysisd does
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap__mdebug2, formatted_msg, "Log 'Dec 29 10:00:01 host sshd[123]: keepalive probe' dropped by the filter of rule 100101.");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_true(w_drop_filters_match("/var/log/secure", "Dec 29 10:00:01 host sshd[123]: keepalive probe"));
+
+    // Without the header cut, an anchored match can't test the raw line
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_false(w_drop_filters_match("/var/log/secure", "sshd: keepalive probe"));
+
+    drop_filters = NULL;
+    drop_filters_size = 0;
+
+    w_free_expression_t(&filter.match);
+}
+
+void test_w_drop_filters_match_empty(void ** state) {
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+    assert_false(w_drop_filters_match("/var/log/secure", "sshd: keepalive probe"));
+}
+
 void check_ignore_and_restrict_null_config(void ** state) {
     logreader *regex_config = *state;
 
-    int ret = check_ignore_and_restrict(NULL, NULL, "testing log line");
+    int ret = check_ignore_and_restrict(NULL, NULL, NULL, "testing log line");
     assert_false(ret);
 }
 
@@ -2322,7 +2542,7 @@ void check_ignore_and_restrict_not_ignored(void ** state) {
     will_return(wrap_pcre2_match_data_create_from_pattern, 1);
     will_return(wrap_pcre2_match, 0);
 
-    int ret = check_ignore_and_restrict(regex_config->regex_ignore, NULL, str_test);
+    int ret = check_ignore_and_restrict(NULL, regex_config->regex_ignore, NULL, str_test);
 
     assert_false(ret);
 }
@@ -2350,7 +2570,7 @@ void check_ignore_and_restrict_ignored(void ** state) {
     snprintf(log_str, PATH_MAX, LF_MATCH_REGEX, "testing log with ignore word", "ignore", "ignore.*");
     expect_string(__wrap__mdebug2, formatted_msg, log_str);
 
-    int ret = check_ignore_and_restrict(regex_config->regex_ignore, NULL, str_test);
+    int ret = check_ignore_and_restrict(NULL, regex_config->regex_ignore, NULL, str_test);
 
     assert_true(ret);
 }
@@ -2375,7 +2595,7 @@ void check_ignore_and_restrict_not_restricted(void ** state) {
     will_return(wrap_pcre2_match, 1);
     will_return(wrap_pcre2_get_ovector_pointer, aux);
 
-    int ret = check_ignore_and_restrict(NULL, regex_config->regex_restrict, str_test);
+    int ret = check_ignore_and_restrict(NULL, NULL, regex_config->regex_restrict, str_test);
 
     assert_false(ret);
 }
@@ -2399,11 +2619,212 @@ void check_ignore_and_restrict_restricted(void ** state) {
     snprintf(log_str, PATH_MAX, LF_MATCH_REGEX, "testing log not match", "restrict", "restrict.*");
     expect_string(__wrap__mdebug2, formatted_msg, log_str);
 
-    int ret = check_ignore_and_restrict(NULL, regex_config->regex_restrict, str_test);
+    int ret = check_ignore_and_restrict(NULL, NULL, regex_config->regex_restrict, str_test);
 
     assert_true(ret);
 }
 
+/* w_msg_queue_pop_batch */
+void test_w_msg_queue_pop_batch(void ** state) {
+    w_msg_queue_t msg_queue;
+    w_message_t message[3];
+    w_message_t * messages[OUTPUT_MAX_BATCH];
+
+    msg_queue.msg_queue = queue_init(4);
+    w_mutex_init(&msg_queue.mutex, NULL);
+    w_cond_init(&msg_queue.available, NULL);
+
+    for (int i = 0; i < 3; i++) {
+        queue_push(msg_queue.msg_queue, &message[i]);
+    }
+
+    /* Messages are popped in order, a batch at most */
+    assert_int_equal(w_msg_queue_pop_batch(&msg_queue, messages, 2), 2);
+    assert_ptr_equal(messages[0], &message[0]);
+    assert_ptr_equal(messages[1], &message[1]);
+
+    assert_int_equal(w_msg_queue_pop_batch(&msg_queue, messages, OUTPUT_MAX_BATCH), 1);
+    assert_ptr_equal(messages[0], &message[2]);
+    assert_true(queue_empty(msg_queue.msg_queue));
+
+    queue_free(msg_queue.msg_queue);
+    w_mutex_destroy(&msg_queue.mutex);
+    w_cond_destroy(&msg_queue.available);
+}
+
+/* w_rebalance_input_threads */
+void test_w_rebalance_input_threads(void ** state) {
+    logreader files[4];
+    logreader * logff_backup = logff;
+    logreader_glob * globs_backup = globs;
+    int threads_backup = N_INPUT_THREADS;
+
+    memset(files, 0, sizeof(files));
+    files[0].file = "/var/log/a.log";
+    files[0].logformat = "syslog";
+    files[0].read_bytes = 60;
+    files[1].file = "/var/log/b.log";
+    files[1].logformat = "syslog";
+    files[1].read_bytes = 100;
+    files[2].file = "/var/log/c.log";
+    files[2].logformat = "syslog";
+    files[2].read_bytes = 50;
+
+    logff = files;
+    globs = NULL;
+    N_INPUT_THREADS = 2;
+
+    /* The busiest file keeps a thread, the other two share the second one */
+    expect_string(__wrap__mdebug2, formatted_msg, "File '/var/log/a.log' assigned to input thread 1.");
+    expect_string(__wrap__mdebug2, formatted_msg, "File '/var/log/c.log' assigned to input thread 1.");
+
+    w_rebalance_input_threads();
+
+    assert_int_equal(files[0].thread_id, 1);
+    assert_int_equal(files[1].thread_id, 0);
+    assert_int_equal(files[2].thread_id, 1);
+    assert_int_equal(files[0].read_bytes, 0);
+    assert_int_equal(files[1].read_bytes, 0);
+    assert_int_equal(files[2].read_bytes, 0);
+
+    logff = logff_backup;
+    globs = globs_backup;
+    N_INPUT_THREADS = threads_backup;
+}
+
+/* close_file */
+
+void test_close_file_inotify_watched(void ** state) {
+    logreader lf = { .fp = (FILE *)1, .wd = 3 };
+    fpos_t position_stack = {.__pos = 1};
+    test_position = &position_stack;
+    lc_inotify_fd = 5;
+    lc_ready_wds = (OSHash *)1;
+
+    expect_value(__wrap_fgetpos, __stream, (FILE *)1);
+    will_return(__wrap_fgetpos, 0);
+    expect_fclose((FILE *)1, 0);
+
+    expect_value(__wrap_OSHash_Delete_ex, self, lc_ready_wds);
+    expect_string(__wrap_OSHash_Delete_ex, key, "3");
+    will_return(__wrap_OSHash_Delete_ex, NULL);
+    will_return(__wrap_inotify_rm_watch, 0);
+
+    close_file(&lf);
+
+    assert_null(lf.fp);
+    assert_int_equal(lf.wd, 0);
+
+    lc_inotify_fd = -1;
+    lc_ready_wds = NULL;
+}
+
+void test_close_file_inotify_polled(void ** state) {
+    logreader lf = { .fp = (FILE *)1, .wd = 0 };
+    fpos_t position_stack = {.__pos = 1};
+    test_position = &position_stack;
+    lc_inotify_fd = 5;
+
+    expect_value(__wrap_fgetpos, __stream, (FILE *)1);
+    will_return(__wrap_fgetpos, 0);
+    expect_fclose((FILE *)1, 0);
+
+    close_file(&lf);
+
+    assert_null(lf.fp);
+    assert_int_equal(lf.wd, 0);
+
+    lc_inotify_fd = -1;
+}
+
+/* w_inotify_unwatch */
+
+void test_w_inotify_unwatch_disabled(void ** state) {
+    logreader lf = { .wd = 3 };
+    lc_inotify_fd = -1;
+
+    w_inotify_unwatch(&lf);
+
+    assert_int_equal(lf.wd, 3);
+}
+
+/* w_inotify_ready */
+
+void test_w_inotify_ready_polled(void ** state) {
+    logreader lf = { .wd = 0 };
+    lc_inotify_fd = 5;
+
+    assert_int_equal(w_inotify_ready(&lf), 1);
+
+    lc_inotify_fd = -1;
+}
+
+void test_w_inotify_ready_event(void ** state) {
+    logreader lf = { .wd = 3 };
+    lc_inotify_fd = 5;
+    lc_ready_wds = (OSHash *)1;
+
+    expect_value(__wrap_OSHash_Delete_ex, self, lc_ready_wds);
+    expect_string(__wrap_OSHash_Delete_ex, key, "3");
+    will_return(__wrap_OSHash_Delete_ex, (void *)1);
+
+    assert_int_equal(w_inotify_ready(&lf), 1);
+
+    lc_inotify_fd = -1;
+    lc_ready_wds = NULL;
+}
+
+void test_w_inotify_ready_no_event(void ** state) {
+    logreader lf = { .wd = 3 };
+    lc_inotify_fd = 5;
+    lc_ready_wds = (OSHash *)1;
+    lc_inotify_rescan = 0;
+
+    expect_value(__wrap_OSHash_Delete_ex, self, lc_ready_wds);
+    expect_string(__wrap_OSHash_Delete_ex, key, "3");
+    will_return(__wrap_OSHash_Delete_ex, NULL);
+
+    assert_int_equal(w_inotify_ready(&lf), 0);
+
+    lc_inotify_fd = -1;
+    lc_ready_wds = NULL;
+}
+
+void test_w_inotify_ready_overflow(void ** state) {
+    logreader lf = { .wd = 3 };
+    lc_inotify_fd = 5;
+    lc_ready_wds = (OSHash *)1;
+    lc_inotify_rescan = time(NULL) + 10;
+
+    expect_value(__wrap_OSHash_Delete_ex, self, lc_ready_wds);
+    expect_string(__wrap_OSHash_Delete_ex, key, "3");
+    will_return(__wrap_OSHash_Delete_ex, NULL);
+
+    assert_int_equal(w_inotify_ready(&lf), 1);
+
+    lc_inotify_fd = -1;
+    lc_ready_wds = NULL;
+    lc_inotify_rescan = 0;
+}
+
+/* w_inotify_set_ready */
+
+void test_w_inotify_set_ready(void ** state) {
+    logreader lf = { .wd = 3 };
+    lc_inotify_fd = 5;
+    lc_ready_wds = (OSHash *)1;
+
+    OSHash_Add_ex_check_data = 0;
+    expect_value(__wrap_OSHash_Add_ex, self, lc_ready_wds);
+    expect_string(__wrap_OSHash_Add_ex, key, "3");
+    will_return(__wrap_OSHash_Add_ex, 2);
+
+    w_inotify_set_ready(&lf);
+
+    lc_inotify_fd = -1;
+    lc_ready_wds = NULL;
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         // Test w_get_hash_context
@@ -2436,6 +2857,7 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_w_save_file_status_wfopen_error, setup_log_context, teardown_log_context),
         cmocka_unit_test_setup_teardown(test_w_save_file_status_fwrite_error, setup_log_context, teardown_log_context),
         cmocka_unit_test_setup_teardown(test_w_save_file_status_OK, setup_log_context, teardown_log_context),
+        cmocka_unit_test_setup_teardown(test_w_save_file_status_unchanged, setup_log_context, teardown_log_context),
 
         // Test w_load_files_status
         cmocka_unit_test(test_w_load_files_status_empty_array),
@@ -2448,7 +2870,6 @@ int main(void) {
         cmocka_unit_test(test_w_load_files_status_offset_str_NULL),
         cmocka_unit_test(test_w_load_files_status_invalid_offset),
         cmocka_unit_test_setup_teardown(test_w_load_files_status_update_add_fail, setup_local_hashmap, teardown_local_hashmap),
-        cmocka_unit_test_setup_teardown(test_w_load_files_status_update_hash_fail, setup_local_hashmap, teardown_local_hashmap),
         cmocka_unit_test_setup_teardown(test_w_load_files_status_update_fail, setup_local_hashmap, teardown_local_hashmap),
         cmocka_unit_test_setup_teardown(test_w_load_files_status_OK, setup_local_hashmap, teardown_local_hashmap),
         // Related only to macos
@@ -2504,8 +2925,30 @@ int main(void) {
         cmocka_unit_test_setup_teardown(check_ignore_and_restrict_null_config, setup_regex, teardown_regex),
         cmocka_unit_test_setup_teardown(check_ignore_and_restrict_not_ignored, setup_regex, teardown_regex),
         cmocka_unit_test_setup_teardown(check_ignore_and_restrict_ignored, setup_regex, teardown_regex),
+        // Tests w_drop_filters_match
+        cmocka_unit_test(test_w_drop_filters_match),
+        cmocka_unit_test(test_w_drop_filters_match_predecoded),
+        cmocka_unit_test(test_w_drop_filters_match_empty),
         cmocka_unit_test_setup_teardown(check_ignore_and_restrict_not_restricted, setup_regex, teardown_regex),
-        cmocka_unit_test_setup_teardown(check_ignore_and_restrict_restricted, setup_regex, teardown_regex)
+        cmocka_unit_test_setup_teardown(check_ignore_and_restrict_restricted, setup_regex, teardown_regex),
+
+        // Test w_msg_queue_pop_batch
+        cmocka_unit_test(test_w_msg_queue_pop_batch),
+        // Test w_rebalance_input_threads
+        cmocka_unit_test(test_w_rebalance_input_threads),
+
+        // Test close_file
+        cmocka_unit_test(test_close_file_inotify_watched),
+        cmocka_unit_test(test_close_file_inotify_polled),
+        // Test w_inotify_unwatch
+        cmocka_unit_test(test_w_inotify_unwatch_disabled),
+        // Test w_inotify_ready
+        cmocka_unit_test(test_w_inotify_ready_polled),
+        cmocka_unit_test(test_w_inotify_ready_event),
+        cmocka_unit_test(test_w_inotify_ready_no_event),
+        cmocka_unit_test(test_w_inotify_ready_overflow),
+        // Test w_inotify_set_ready
+        cmocka_unit_test(test_w_inotify_set_ready)
 
     };
 
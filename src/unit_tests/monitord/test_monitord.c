@@ -57,6 +57,7 @@ int setup_monitord(void **state) {
     mond.rotate_log = 0;
     mond.size_rotate = 0;
     mond.daily_rotations = 0;
+    mond.compress_rate = 0;
     mond.delete_old_agents = 0;
 
     mond_time_control.disconnect_counter = 0;
@@ -85,6 +86,7 @@ int teardown_monitord(void **state) {
     mond.rotate_log = 0;
     mond.size_rotate = 0;
     mond.daily_rotations = 0;
+    mond.compress_rate = 0;
     mond.delete_old_agents = 0;
 
     mond_time_control.disconnect_counter = 0;
@@ -361,6 +363,7 @@ void test_getMonitorInternalOptions_success(void **state) {
     mond.rotate_log = 1;
     mond.size_rotate = 0;
     mond.daily_rotations = 100;
+    mond.compress_rate = 1024;
     mond.delete_old_agents = 3;
 
     root = getMonitorInternalOptions();
@@ -382,6 +385,8 @@ void test_getMonitorInternalOptions_success(void **state) {
         assert_int_equal(object->valueint, mond.size_rotate);
         object = cJSON_GetObjectItem(root->child, "daily_rotations");
         assert_int_equal(object->valueint, mond.daily_rotations);
+        object = cJSON_GetObjectItem(root->child, "compress_rate");
+        assert_int_equal(object->valueint, mond.compress_rate);
         object = cJSON_GetObjectItem(root->child, "delete_old_agents");
         assert_int_equal(object->valueint, mond.delete_old_agents);
     }
@@ -491,6 +496,7 @@ void test_MonitordConfig_success(void **state) {
     assert_int_equal(mond.keep_log_days, 1);
     assert_int_equal(mond.size_rotate, 1 * 1024 * 1024);
     assert_int_equal(mond.daily_rotations, 1);
+    assert_int_equal(mond.compress_rate, 1 * 1024);
     assert_int_equal(mond.delete_old_agents, 1);
 }
 
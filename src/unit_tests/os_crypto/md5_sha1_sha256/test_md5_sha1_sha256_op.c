@@ -58,6 +58,53 @@ void test_md5_sha1_sha256_file(void **state)
     assert_string_equal(sha1buffer, string_sha1);
 }
 
+void test_md5_sha1_sha256_file_only_sha256(void **state)
+{
+    char *string = "teststring";
+    const char *string_sha256 = "3c8727e019a42b444667a587b6001251becadabbb36bfed8087a92c18882d111";
+
+    char file_name[256] = "/tmp/tmp_file-XXXXXX";
+
+    FILE * fp = 0x1;
+    expect_wfopen(file_name, "r", fp);
+    expect_fread(string, strlen(string));
+    expect_fread(string, 0);
+    expect_fclose(fp, 0);
+
+    os_sha256 sha256buffer;
+
+    assert_int_equal(OS_MD5_SHA1_SHA256_File(file_name, NULL, NULL, NULL, sha256buffer, OS_TEXT, 20), 0);
+
+    assert_string_equal(sha256buffer, string_sha256);
+}
+
+void test_md5_sha1_sha256_file_no_digests(void **state)
+{
+    // Nothing to calculate, the file is not opened.
+    assert_int_equal(OS_MD5_SHA1_SHA256_File("file_name", NULL, NULL, NULL, NULL, OS_TEXT, 20), 0);
+}
+
+void test_md5_sha1_sha256_file_max_size(void **state)
+{
+    char *string = "teststring";
+    char file_name[256] = "/tmp/tmp_file-XXXXXX";
+
+    FILE * fp = 0x1;
+    expect_wfopen(file_name, "r", fp);
+    expect_fread(string, strlen(string));
+    expect_fclose(fp, 0);
+
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+
+    assert_int_equal(OS_MD5_SHA1_SHA256_File(file_name, NULL, md5buffer, sha1buffer, sha256buffer, OS_TEXT, 5), -1);
+
+    assert_string_equal(md5buffer, "");
+    assert_string_equal(sha1buffer, "");
+    assert_string_equal(sha256buffer, "");
+}
+
 void test_md5_sha1_sha256_cmd_file(void **state)
 {
     char *string = "teststring";
@@ -102,6 +149,9 @@ void test_md5_sha1_sha256_cmd_file_fail(void **state)
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_md5_sha1_sha256_file),
+        cmocka_unit_test(test_md5_sha1_sha256_file_only_sha256),
+        cmocka_unit_test(test_md5_sha1_sha256_file_no_digests),
+        cmocka_unit_test(test_md5_sha1_sha256_file_max_size),
         cmocka_unit_test(test_md5_sha1_sha256_cmd_file),
         cmocka_unit_test(test_md5_sha1_sha256_cmd_file_fail),
     };
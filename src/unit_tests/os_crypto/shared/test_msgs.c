@@ -26,6 +26,7 @@
 
 /* Forward declarations */
 void StoreCounter(const keystore *keys, int id, unsigned int global, unsigned int local);
+void SaveCounter(const keystore *keys, int id, unsigned int global, unsigned int local);
 
 /* Setup/teardown */
 
@@ -46,9 +47,9 @@ time_t __wrap_time(int time) {
     return mock();
 }
 
-/* Tests StoreCounter*/
+/* Tests SaveCounter*/
 
-void test_StoreCounter_updating_rids(void **state)
+void test_SaveCounter_updating_rids(void **state)
 {
     keystore keys = KEYSTORE_INITIALIZER;
     keyentry** keyentries;
@@ -86,7 +87,7 @@ void test_StoreCounter_updating_rids(void **state)
 
     expect_string(__wrap__mdebug2, formatted_msg, "Updating rids_node for agent 001.");
 
-    StoreCounter(&keys, id, global, local);
+    SaveCounter(&keys, id, global, local);
 
     assert_int_equal(keys.opened_fp_queue->elements, 1);
     linked_queue_free(keys.opened_fp_queue);
@@ -96,7 +97,7 @@ void test_StoreCounter_updating_rids(void **state)
     os_free(keys.keyentries);
 }
 
-void test_StoreCounter_pushing_rids(void **state)
+void test_SaveCounter_pushing_rids(void **state)
 {
     keystore keys = KEYSTORE_INITIALIZER;
     keyentry** keyentries;
@@ -137,7 +138,7 @@ void test_StoreCounter_pushing_rids(void **state)
 
     assert_int_equal(keys.opened_fp_queue->elements, 0);
 
-    StoreCounter(&keys, id, global, local);
+    SaveCounter(&keys, id, global, local);
 
     assert_int_equal(keys.opened_fp_queue->elements, 1);
     assert_int_equal(keys.keyentries[0]->updating_time, now);
@@ -149,7 +150,7 @@ void test_StoreCounter_pushing_rids(void **state)
     os_free(keys.keyentries);
 }
 
-void test_StoreCounter_pushing_rids_fp_null(void **state)
+void test_SaveCounter_pushing_rids_fp_null(void **state)
 {
     keystore keys = KEYSTORE_INITIALIZER;
     keyentry** keyentries;
@@ -195,7 +196,7 @@ void test_StoreCounter_pushing_rids_fp_null(void **state)
 
     assert_int_equal(keys.opened_fp_queue->elements, 0);
 
-    StoreCounter(&keys, id, global, local);
+    SaveCounter(&keys, id, global, local);
 
     assert_int_equal(keys.opened_fp_queue->elements, 1);
     assert_int_equal(keys.keyentries[0]->updating_time, now);
@@ -207,7 +208,7 @@ void test_StoreCounter_pushing_rids_fp_null(void **state)
     os_free(keys.keyentries);
 }
 
-void test_StoreCounter_fail_first_open(void **state)
+void test_SaveCounter_fail_first_open(void **state)
 {
     keystore keys = KEYSTORE_INITIALIZER;
     keyentry** keyentries;
@@ -258,7 +259,7 @@ void test_StoreCounter_fail_first_open(void **state)
 
     assert_int_equal(keys.opened_fp_queue->elements, 0);
 
-    StoreCounter(&keys, id, global, local);
+    SaveCounter(&keys, id, global, local);
 
     assert_int_equal(keys.opened_fp_queue->elements, 1);
 
@@ -269,15 +270,101 @@ void test_StoreCounter_fail_first_open(void **state)
     os_free(keys.keyentries);
 }
 
+/* Tests StoreCounter */
+
+void test_StoreCounter_pending(void **state)
+{
+    keystore keys = KEYSTORE_INITIALIZER;
+    keyentry** keyentries;
+    os_calloc(1, sizeof(keyentry*), keyentries);
+    keys.keyentries = keyentries;
+    keys.keysize = 0;
+
+    keyentry *key = NULL;
+    os_calloc(1, sizeof(keyentry), key);
+    key->id = strdup("001");
+    key->fp = (FILE *)1234;
+    keys.keyentries[0] = key;
+
+    StoreCounter(&keys, 0, 1, 2);
+
+    assert_true(key->rids_pending);
+    assert_int_equal(key->global, 1);
+    assert_int_equal(key->local, 2);
+
+    os_free(key->id);
+    os_free(key);
+    os_free(keys.keyentries);
+}
+
+/* Tests OS_FlushCounters */
+
+void test_OS_FlushCounters(void **state)
+{
+    keystore keys = KEYSTORE_INITIALIZER;
+    keyentry** keyentries;
+    os_calloc(3, sizeof(keyentry*), keyentries);
+    keys.keyentries = keyentries;
+    w_linked_queue_t *queue;
+    queue = linked_queue_init();
+    keys.keysize = 2;
+    keys.opened_fp_queue = queue;
+
+    int now = 123456789;
+
+    for (int i = 0; i < 3; i++) {
+        os_calloc(1, sizeof(keyentry), keys.keyentries[i]);
+    }
+
+    keyentry *key = keys.keyentries[0];
+    key->id = strdup("001");
+    key->fp = (FILE *)1234;
+    key->global = 3;
+    key->local = 4;
+    key->rids_pending = true;
+    key->rids_node = linked_queue_push(keys.opened_fp_queue, key);
+
+    keys.keyentries[1]->id = strdup("002");
+    keys.keyentries[1]->fp = (FILE *)5678;
+
+    will_return(__wrap_fseek, 0);
+
+    expect_value(__wrap_fprintf, __stream, 1234);
+    expect_string(__wrap_fprintf, formatted_msg, "3:4:");
+    will_return(__wrap_fprintf, 0);
+
+    expect_value(__wrap_time, time, 0);
+    will_return(__wrap_time, now);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating rids_node for agent 001.");
+
+    OS_FlushCounters(&keys);
+
+    assert_false(key->rids_pending);
+    assert_int_equal(key->updating_time, now);
+
+    linked_queue_free(keys.opened_fp_queue);
+    os_free(key->rids_node);
+    os_free(key->id);
+    os_free(keys.keyentries[1]->id);
+    for (int i = 0; i < 3; i++) {
+        os_free(keys.keyentries[i]);
+    }
+    os_free(keys.keyentries);
+}
 
 int main(void)
 {
     const struct CMUnitTest tests[] = {
+        // Tests SaveCounter
+        cmocka_unit_test_setup_teardown(test_SaveCounter_updating_rids, setup_config, teardown_config),
+        cmocka_unit_test_setup_teardown(test_SaveCounter_pushing_rids, setup_config, teardown_config),
+        cmocka_unit_test_setup_teardown(test_SaveCounter_pushing_rids_fp_null, setup_config, teardown_config),
+        cmocka_unit_test_setup_teardown(test_SaveCounter_fail_first_open, setup_config, teardown_config),
         // Tests StoreCounter
-        cmocka_unit_test_setup_teardown(test_StoreCounter_updating_rids, setup_config, teardown_config),
-        cmocka_unit_test_setup_teardown(test_StoreCounter_pushing_rids, setup_config, teardown_config),
-        cmocka_unit_test_setup_teardown(test_StoreCounter_pushing_rids_fp_null, setup_config, teardown_config),
-        cmocka_unit_test_setup_teardown(test_StoreCounter_fail_first_open, setup_config, teardown_config)
+        cmocka_unit_test_setup_teardown(test_StoreCounter_pending, setup_config, teardown_config),
+        // Tests OS_FlushCounters
+        cmocka_unit_test_setup_teardown(test_OS_FlushCounters, setup_config, teardown_config)
         };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../headers/shared.h"
+#include "../../os_csyslogd/csyslogd.h"
+
+#include "../wrappers/posix/time_wrappers.h"
+#include "../wrappers/wazuh/os_net/os_net_wrappers.h"
+#include "../wrappers/wazuh/shared/debug_op_wrappers.h"
+
+/* setup/teardown */
+
+static int setup_syslog_config(void **state) {
+    SyslogConfig *config;
+
+    os_calloc(1, sizeof(SyslogConfig), config);
+    os_strdup("127.0.0.1", config->server);
+    config->port = 514;
+    config->protocol = IPPROTO_TCP;
+    config->socket = 3;
+
+    *state = config;
+    return 0;
+}
+
+static int teardown_syslog_config(void **state) {
+    SyslogConfig *config = *state;
+
+    os_free(config->buffer);
+    os_free(config->server);
+    os_free(config);
+    return 0;
+}
+
+/* Helpers */
+
+static void expect_send_error(SyslogConfig *config) {
+    char error_msg[OS_SIZE_256];
+
+    snprintf(error_msg, OS_SIZE_256, ERROR_SENDING_MSG, config->server);
+
+    expect_value(__wrap_OS_CloseSocket, sock, config->socket);
+    will_return(__wrap_OS_CloseSocket, 0);
+    expect_string(__wrap__merror, formatted_msg, error_msg);
+}
+
+static void expect_dropped(SyslogConfig *config, unsigned int count, unsigned long total) {
+    char error_msg[OS_SIZE_256];
+
+    snprintf(error_msg, OS_SIZE_256, CSYSLOG_DROPPED, count, config->server, total);
+    expect_string(__wrap__merror, formatted_msg, error_msg);
+}
+
+/* tests */
+
+/* OS_CSyslog_Connect */
+void test_OS_CSyslog_Connect_connected(void **state) {
+    SyslogConfig *config = *state;
+
+    assert_int_equal(OS_CSyslog_Connect(config), 0);
+    assert_int_equal(config->socket, 3);
+}
+
+void test_OS_CSyslog_Connect_tcp(void **state) {
+    SyslogConfig *config = *state;
+    char debug_msg[OS_SIZE_256];
+
+    config->socket = -1;
+
+    snprintf(debug_msg, OS_SIZE_256, SUCCESSFULLY_RECONNECTED_SOCKET, "127.0.0.1");
+
+    expect_value(__wrap_OS_ConnectTCP, _port, 514);
+    expect_string(__wrap_OS_ConnectTCP, _ip, "127.0.0.1");
+    expect_value(__wrap_OS_ConnectTCP, ipv6, 0);
+    will_return(__wrap_OS_ConnectTCP, 5);
+    expect_string(__wrap__mdebug2, formatted_msg, debug_msg);
+
+    assert_int_equal(OS_CSyslog_Connect(config), 0);
+    assert_int_equal(config->socket, 5);
+}
+
+void test_OS_CSyslog_Connect_udp_error(void **state) {
+    SyslogConfig *config = *state;
+
+    config->socket = -1;
+    config->protocol = IPPROTO_UDP;
+
+    will_return(__wrap_OS_ConnectUDP, -1);
+
+    assert_int_equal(OS_CSyslog_Connect(config), -1);
+    assert_int_equal(config->socket, -1);
+}
+
+/* OS_CSyslog_Send */
+void test_OS_CSyslog_Send_udp(void **state) {
+    SyslogConfig *config = *state;
+
+    config->protocol = IPPROTO_UDP;
+
+    expect_value(__wrap_OS_SendUDPbySize, sock, 3);
+    expect_value(__wrap_OS_SendUDPbySize, size, 5);
+    expect_string(__wrap_OS_SendUDPbySize, msg, "hello");
+    will_return(__wrap_OS_SendUDPbySize, 0);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), 0);
+
+    // Datagrams are never buffered
+    assert_null(config->buffer);
+    assert_int_equal(config->buffer_count, 0);
+}
+
+void test_OS_CSyslog_Send_udp_error(void **state) {
+    SyslogConfig *config = *state;
+
+    config->protocol = IPPROTO_UDP;
+
+    expect_value(__wrap_OS_SendUDPbySize, sock, 3);
+    expect_value(__wrap_OS_SendUDPbySize, size, 5);
+    expect_string(__wrap_OS_SendUDPbySize, msg, "hello");
+    will_return(__wrap_OS_SendUDPbySize, -1);
+    expect_send_error(config);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), -1);
+    assert_int_equal(config->socket, -1);
+    assert_int_equal(config->dropped, 0);
+}
+
+void test_OS_CSyslog_Send_tcp_buffered(void **state) {
+    SyslogConfig *config = *state;
+
+    // Only the first frame sets the age of the buffer
+    will_return(__wrap_time, 1000);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), 0);
+    assert_int_equal(OS_CSyslog_Send(config, "hi!", 3), 0);
+
+    assert_int_equal(config->buffer_len, 12);
+    assert_memory_equal(config->buffer, "5 hello3 hi!", 12);
+    assert_int_equal(config->buffer_count, 2);
+    assert_int_equal(config->buffer_time, 1000);
+}
+
+void test_OS_CSyslog_Send_tcp_full(void **state) {
+    SyslogConfig *config = *state;
+    size_t size = CSYSLOG_BUFFER_SIZE / 2;
+    char *msg;
+
+    os_calloc(size + 1, sizeof(char), msg);
+    memset(msg, 'a', size);
+
+    will_return(__wrap_time, 1000);
+    assert_int_equal(OS_CSyslog_Send(config, msg, size), 0);
+
+    // The second frame doesn't fit with its header, so the first one is sent before
+    expect_value(__wrap_OS_SendTCPbySize, sock, 3);
+    expect_value(__wrap_OS_SendTCPbySize, size, config->buffer_len);
+    expect_memory(__wrap_OS_SendTCPbySize, msg, config->buffer, config->buffer_len);
+    will_return(__wrap_OS_SendTCPbySize, 0);
+    will_return(__wrap_time, 1001);
+
+    assert_int_equal(OS_CSyslog_Send(config, msg, size), 0);
+
+    assert_int_equal(config->buffer_count, 1);
+    assert_int_equal(config->buffer_time, 1001);
+
+    os_free(msg);
+}
+
+void test_OS_CSyslog_Send_tcp_truncated(void **state) {
+    SyslogConfig *config = *state;
+    size_t size = CSYSLOG_BUFFER_SIZE + 10;
+    char header[OS_SIZE_32];
+    char *msg;
+
+    os_calloc(size + 1, sizeof(char), msg);
+    memset(msg, 'a', size);
+
+    will_return(__wrap_time, 1000);
+
+    assert_int_equal(OS_CSyslog_Send(config, msg, size), 0);
+
+    // The frame is cut to fill the whole buffer, header included
+    snprintf(header, sizeof(header), "%d ", CSYSLOG_BUFFER_SIZE - 7);
+    assert_int_equal(config->buffer_len, CSYSLOG_BUFFER_SIZE);
+    assert_memory_equal(config->buffer, header, strlen(header));
+    assert_int_equal(config->buffer_count, 1);
+
+    os_free(msg);
+}
+
+void test_OS_CSyslog_Send_tcp_flush_error(void **state) {
+    SyslogConfig *config = *state;
+    size_t size = CSYSLOG_BUFFER_SIZE / 2;
+    char *msg;
+
+    os_calloc(size + 1, sizeof(char), msg);
+    memset(msg, 'a', size);
+
+    will_return(__wrap_time, 1000);
+    assert_int_equal(OS_CSyslog_Send(config, msg, size), 0);
+
+    expect_value(__wrap_OS_SendTCPbySize, sock, 3);
+    expect_value(__wrap_OS_SendTCPbySize, size, config->buffer_len);
+    expect_memory(__wrap_OS_SendTCPbySize, msg, config->buffer, config->buffer_len);
+    will_return(__wrap_OS_SendTCPbySize, -1);
+    expect_send_error(config);
+    expect_dropped(config, 2, 2);
+
+    // The message that didn't fit is lost too
+    assert_int_equal(OS_CSyslog_Send(config, msg, size), -1);
+
+    assert_int_equal(config->socket, -1);
+    assert_int_equal(config->buffer_len, 0);
+    assert_int_equal(config->buffer_count, 0);
+    assert_int_equal(config->dropped, 2);
+
+    os_free(msg);
+}
+
+/* OS_CSyslog_Flush */
+void test_OS_CSyslog_Flush(void **state) {
+    SyslogConfig *config = *state;
+
+    will_return(__wrap_time, 1000);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), 0);
+    assert_int_equal(OS_CSyslog_Send(config, "hi!", 3), 0);
+
+    // All the frames go in a single send
+    expect_value(__wrap_OS_SendTCPbySize, sock, 3);
+    expect_value(__wrap_OS_SendTCPbySize, size, 12);
+    expect_memory(__wrap_OS_SendTCPbySize, msg, "5 hello3 hi!", 12);
+    will_return(__wrap_OS_SendTCPbySize, 0);
+
+    assert_int_equal(OS_CSyslog_Flush(config), 0);
+
+    assert_int_equal(config->buffer_len, 0);
+    assert_int_equal(config->buffer_count, 0);
+    assert_int_equal(config->socket, 3);
+}
+
+void test_OS_CSyslog_Flush_empty(void **state) {
+    SyslogConfig *config = *state;
+
+    assert_int_equal(OS_CSyslog_Flush(config), 0);
+}
+
+void test_OS_CSyslog_Flush_error(void **state) {
+    SyslogConfig *config = *state;
+
+    will_return(__wrap_time, 1000);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), 0);
+    assert_int_equal(OS_CSyslog_Send(config, "hi!", 3), 0);
+
+    expect_value(__wrap_OS_SendTCPbySize, sock, 3);
+    expect_value(__wrap_OS_SendTCPbySize, size, 12);
+    expect_memory(__wrap_OS_SendTCPbySize, msg, "5 hello3 hi!", 12);
+    will_return(__wrap_OS_SendTCPbySize, -1);
+    expect_send_error(config);
+    expect_dropped(config, 2, 2);
+
+    assert_int_equal(OS_CSyslog_Flush(config), -1);
+
+    assert_int_equal(config->socket, -1);
+    assert_int_equal(config->buffer_len, 0);
+    assert_int_equal(config->buffer_count, 0);
+    assert_int_equal(config->dropped, 2);
+
+    // The total keeps growing across disconnections
+    config->socket = 4;
+    will_return(__wrap_time, 1001);
+
+    assert_int_equal(OS_CSyslog_Send(config, "hello", 5), 0);
+
+    expect_value(__wrap_OS_SendTCPbySize, sock, 4);
+    expect_value(__wrap_OS_SendTCPbySize, size, 7);
+    expect_memory(__wrap_OS_SendTCPbySize, msg, "5 hello", 7);
+    will_return(__wrap_OS_SendTCPbySize, -1);
+    expect_send_error(config);
+    expect_dropped(config, 1, 3);
+
+    assert_int_equal(OS_CSyslog_Flush(config), -1);
+    assert_int_equal(config->dropped, 3);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        // Tests OS_CSyslog_Connect
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Connect_connected, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Connect_tcp, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Connect_udp_error, setup_syslog_config, teardown_syslog_config),
+        // Tests OS_CSyslog_Send
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_udp, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_udp_error, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_tcp_buffered, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_tcp_full, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_tcp_truncated, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Send_tcp_flush_error, setup_syslog_config, teardown_syslog_config),
+        // Tests OS_CSyslog_Flush
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Flush, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Flush_empty, setup_syslog_config, teardown_syslog_config),
+        cmocka_unit_test_setup_teardown(test_OS_CSyslog_Flush_error, setup_syslog_config, teardown_syslog_config),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -32,6 +32,7 @@
 
 extern int test_mode;
 extern OSList *timeout_list;
+extern OSHash *timeout_hash;
 
 void ExecdStart(int q);
 
@@ -52,7 +53,7 @@ static int test_setup_file(void **state) {
     os_calloc(1, sizeof(wfd_t), wfd);
     wfd->file_in = (FILE *)1;
     wfd->file_out = (FILE *)2;
-    timeout_list = OSList_Create();
+    CreateTimeoutList();
     *state = wfd;
     return 0;
 }
@@ -62,7 +63,7 @@ static int test_setup_file_timeout(void **state) {
     os_calloc(1, sizeof(wfd_t), wfd);
     wfd->file_in = (FILE *)1;
     wfd->file_out = (FILE *)2;
-    timeout_list = OSList_Create();
+    CreateTimeoutList();
     timeout_data *timeout_entry;
     os_calloc(1, sizeof(timeout_data), timeout_entry);
     os_calloc(2, sizeof(char *), timeout_entry->command);
@@ -72,6 +73,7 @@ static int test_setup_file_timeout(void **state) {
     timeout_entry->time_of_addition = 123456789;
     timeout_entry->time_to_block = 10;
     OSList_AddData(timeout_list, timeout_entry);
+    OSHash_Add(timeout_hash, timeout_entry->rkey, timeout_entry);
     *state = wfd;
     return 0;
 }
@@ -29,6 +29,7 @@
 
 extern int test_mode;
 extern OSList *timeout_list;
+extern OSHash *timeout_hash;
 
 /* Setup/Teardown */
 
@@ -47,7 +48,7 @@ static int test_setup_file(void **state) {
     os_calloc(1, sizeof(wfd_t), wfd);
     wfd->file_in = (FILE *)1;
     wfd->file_out = (FILE *)2;
-    timeout_list = OSList_Create();
+    CreateTimeoutList();
     *state = wfd;
     return 0;
 }
@@ -57,7 +58,7 @@ static int test_setup_file_timeout(void **state) {
     os_calloc(1, sizeof(wfd_t), wfd);
     wfd->file_in = (FILE *)1;
     wfd->file_out = (FILE *)2;
-    timeout_list = OSList_Create();
+    CreateTimeoutList();
     timeout_data *timeout_entry;
     os_calloc(1, sizeof(timeout_data), timeout_entry);
     os_calloc(2, sizeof(char *), timeout_entry->command);
@@ -67,6 +68,7 @@ static int test_setup_file_timeout(void **state) {
     timeout_entry->time_of_addition = 123456789;
     timeout_entry->time_to_block = 10;
     OSList_AddData(timeout_list, timeout_entry);
+    OSHash_Add(timeout_hash, timeout_entry->rkey, timeout_entry);
     *state = wfd;
     return 0;
 }
@@ -40,6 +40,10 @@ int __wrap_getgid(void) {
     return mock();
 }
 
+ssize_t __wrap_writev(__attribute__((unused)) int fd, __attribute__((unused)) const struct iovec *iov, __attribute__((unused)) int iovcnt) {
+    return mock();
+}
+
 // Structs
 
 typedef struct test_struct {
@@ -288,6 +292,116 @@ void test_recv_secure_TCP(void **state) {
     assert_string_equal(buffer, SENDSTRING);
 }
 
+void test_send_secure_TCPv(void **state) {
+    os_frame_t frames[] = { { "Hello", 5 }, { SENDSTRING, 13 } };
+
+    // The headers and both messages take 26 bytes, sent in two calls
+    will_return(__wrap_writev, 10);
+    will_return(__wrap_writev, 16);
+
+    assert_int_equal(OS_SendSecureTCPv(3, frames, 2), 0);
+}
+
+void test_send_secure_TCPv_error(void **state) {
+    os_frame_t frames[] = { { SENDSTRING, 13 } };
+
+    will_return(__wrap_writev, -1);
+
+    assert_int_equal(OS_SendSecureTCPv(3, frames, 1), OS_SOCKTERR);
+}
+
+void test_send_secure_TCPv_invalid_socket(void **state) {
+    os_frame_t frames[] = { { SENDSTRING, 13 } };
+
+    assert_int_equal(OS_SendSecureTCPv(-1, frames, 1), OS_SOCKTERR);
+}
+
+static size_t frame_put(char *buffer, const char *msg) {
+    uint32_t size = wnet_order(strlen(msg));
+
+    memcpy(buffer, &size, sizeof(size));
+    memcpy(buffer + sizeof(size), msg, strlen(msg));
+    return sizeof(size) + strlen(msg);
+}
+
+void test_recv_secure_TCP_frame_batch(void **state) {
+    os_frame_reader_t reader;
+    char data[BUFFERSIZE];
+    size_t length;
+    char *frame;
+
+    length = frame_put(data, "first");
+    length += frame_put(data + length, "second");
+
+    OS_FrameReaderInit(&reader, 8, BUFFERSIZE, BUFFERSIZE);
+
+    // A single recv() gives both messages
+    will_return(__wrap_recv, data);
+    will_return(__wrap_recv, length);
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), 5);
+    assert_string_equal(frame, "first");
+    assert_true(OS_FrameReaderPending(&reader));
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), 6);
+    assert_string_equal(frame, "second");
+    assert_false(OS_FrameReaderPending(&reader));
+
+    will_return(__wrap_recv, data);
+    will_return(__wrap_recv, 0);
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), 0);
+
+    OS_FrameReaderFree(&reader);
+}
+
+void test_recv_secure_TCP_frame_large(void **state) {
+    os_frame_reader_t reader;
+    char data[BUFFERSIZE];
+    size_t length;
+    char *frame;
+
+    length = frame_put(data, "a message larger than the buffer");
+
+    OS_FrameReaderInit(&reader, 8, 8, BUFFERSIZE);
+
+    will_return(__wrap_recv, data);
+    will_return(__wrap_recv, 8);
+    will_return(__wrap_recv, data + 8);
+    will_return(__wrap_recv, length - 8);
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), 32);
+    assert_string_equal(frame, "a message larger than the buffer");
+    assert_int_equal(reader.size, 36);
+
+    // The buffer shrinks back before the next read
+    will_return(__wrap_recv, data);
+    will_return(__wrap_recv, -1);
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), -1);
+    assert_int_equal(reader.size, 8);
+
+    OS_FrameReaderFree(&reader);
+}
+
+void test_recv_secure_TCP_frame_too_big(void **state) {
+    os_frame_reader_t reader;
+    char data[BUFFERSIZE];
+    size_t length;
+    char *frame;
+
+    length = frame_put(data, SENDSTRING);
+
+    OS_FrameReaderInit(&reader, 8, BUFFERSIZE, 8);
+
+    will_return(__wrap_recv, data);
+    will_return(__wrap_recv, length);
+
+    assert_int_equal(OS_RecvSecureTCPFrame(&reader, &frame), OS_SOCKTERR);
+
+    OS_FrameReaderFree(&reader);
+}
+
 void test_tcp_invalid_sockets(void **state) {
     char buffer[BUFFERSIZE];
     will_return(__wrap_accept, AF_INET);
@@ -974,6 +1088,12 @@ int main(void) {
 
         /* Receive secure TCP message */
         cmocka_unit_test_setup_teardown(test_recv_secure_TCP, test_setup, test_teardown),
+        cmocka_unit_test(test_send_secure_TCPv),
+        cmocka_unit_test(test_send_secure_TCPv_error),
+        cmocka_unit_test(test_send_secure_TCPv_invalid_socket),
+        cmocka_unit_test(test_recv_secure_TCP_frame_batch),
+        cmocka_unit_test(test_recv_secure_TCP_frame_large),
+        cmocka_unit_test(test_recv_secure_TCP_frame_too_big),
 
         /* Send a TCP packet of a specific size */
         cmocka_unit_test_setup_teardown(test_send_TCP_by_size, test_setup, test_teardown),
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../os_regex/os_regex.h"
+
+/* setup/teardown */
+
+static int setup_multi_match(void **state) {
+    OSMultiMatch *mm = calloc(1, sizeof(OSMultiMatch));
+    const char *patterns[] = { "he", "she", "his", "hers", "Failed password" };
+
+    OSMultiMatch_Init(mm);
+
+    for (int i = 0; i < 5; i++) {
+        if (!OSMultiMatch_AddPattern(mm, patterns[i], strlen(patterns[i]), i)) {
+            return -1;
+        }
+    }
+
+    if (!OSMultiMatch_Compile(mm)) {
+        return -1;
+    }
+
+    *state = mm;
+    return 0;
+}
+
+static int teardown_multi_match(void **state) {
+    OSMultiMatch *mm = *state;
+
+    OSMultiMatch_FreePattern(mm);
+    free(mm);
+    return 0;
+}
+
+/* Tests */
+
+void test_OSMultiMatch_AddPattern_empty(void **state) {
+    OSMultiMatch mm;
+
+    OSMultiMatch_Init(&mm);
+
+    assert_int_equal(OSMultiMatch_AddPattern(&mm, "", 0, 0), 0);
+    assert_int_equal(mm.error, OS_REGEX_PATTERN_NULL);
+
+    OSMultiMatch_FreePattern(&mm);
+}
+
+void test_OSMultiMatch_AddPattern_compiled(void **state) {
+    OSMultiMatch *mm = *state;
+
+    assert_int_equal(OSMultiMatch_AddPattern(mm, "late", 4, 9), 0);
+    assert_int_equal(mm->error, OS_REGEX_BADREGEX);
+}
+
+void test_OSMultiMatch_Execute_overlapping(void **state) {
+    OSMultiMatch *mm = *state;
+    unsigned char found[5] = {0};
+
+    assert_int_equal(OSMultiMatch_Execute("ushers", mm, found), 3);
+    assert_int_equal(found[0], 1);
+    assert_int_equal(found[1], 1);
+    assert_int_equal(found[2], 0);
+    assert_int_equal(found[3], 1);
+    assert_int_equal(found[4], 0);
+}
+
+void test_OSMultiMatch_Execute_case_insensitive(void **state) {
+    OSMultiMatch *mm = *state;
+    unsigned char found[5] = {0};
+
+    OSMultiMatch_Execute("sshd[123]: FAILED PASSWORD for root", mm, found);
+    assert_int_equal(found[4], 1);
+}
+
+void test_OSMultiMatch_Execute_no_match(void **state) {
+    OSMultiMatch *mm = *state;
+    unsigned char found[5] = {0};
+
+    assert_int_equal(OSMultiMatch_Execute("accepted publickey", mm, found), 0);
+    assert_int_equal(OSMultiMatch_Execute("", mm, found), 0);
+
+    for (int i = 0; i < 5; i++) {
+        assert_int_equal(found[i], 0);
+    }
+}
+
+void test_OSMultiMatch_Execute_empty_automaton(void **state) {
+    OSMultiMatch mm;
+    unsigned char found[1] = {0};
+
+    OSMultiMatch_Init(&mm);
+    assert_int_equal(OSMultiMatch_Compile(&mm), 1);
+
+    assert_int_equal(OSMultiMatch_Execute("anything", &mm, found), 0);
+    assert_int_equal(found[0], 0);
+
+    OSMultiMatch_FreePattern(&mm);
+}
+
+void test_OSMultiMatch_Search(void **state) {
+    OSMultiMatch *mm = *state;
+
+    assert_int_equal(OSMultiMatch_Search("ushers", 6, mm), 1);
+    assert_int_equal(OSMultiMatch_Search("sshd: FAILED PASSWORD", 21, mm), 1);
+    assert_int_equal(OSMultiMatch_Search("accepted publickey", 18, mm), 0);
+}
+
+void test_OSMultiMatch_Search_length(void **state) {
+    OSMultiMatch *mm = *state;
+
+    /* "she" starts inside the searched bytes but ends after them */
+    assert_int_equal(OSMultiMatch_Search("a she", 4, mm), 0);
+    assert_int_equal(OSMultiMatch_Search("a she", 5, mm), 1);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_OSMultiMatch_AddPattern_empty),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_AddPattern_compiled, setup_multi_match, teardown_multi_match),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_Execute_overlapping, setup_multi_match, teardown_multi_match),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_Execute_case_insensitive, setup_multi_match, teardown_multi_match),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_Execute_no_match, setup_multi_match, teardown_multi_match),
+        cmocka_unit_test(test_OSMultiMatch_Execute_empty_automaton),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_Search, setup_multi_match, teardown_multi_match),
+        cmocka_unit_test_setup_teardown(test_OSMultiMatch_Search_length, setup_multi_match, teardown_multi_match),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -95,6 +95,47 @@ void test_fail_match(void **state)
     }
 }
 
+void test_match_many_alternatives(void **state)
+{
+    (void) state;
+
+    const char *pattern = "^sshd|kernel$|^crond$|cupsd|dhclient|rsyslogd|ntpd|postfix|dovecot|named|httpd|squid";
+    const char *negated = "!sshd|kernel|crond|cupsd|dhclient|rsyslogd|ntpd|postfix|dovecot|named|httpd|squid";
+    OSMatch reg;
+
+    assert_int_equal(OSMatch_Compile(pattern, &reg, 0), 1);
+    assert_non_null(reg.literals);
+
+    assert_int_equal(OSMatch_Execute("Dovecot: imap-login", 19, &reg), 1);
+    assert_int_equal(OSMatch_Execute("sshd[123]: session opened", 25, &reg), 1);
+    assert_int_equal(OSMatch_Execute("crond", 5, &reg), 1);
+    assert_int_equal(OSMatch_Execute("linux kernel", 12, &reg), 1);
+    assert_int_equal(OSMatch_Execute("a sshd", 6, &reg), 0);
+    assert_int_equal(OSMatch_Execute("kernel: oops", 12, &reg), 0);
+    assert_int_equal(OSMatch_Execute("crond[1]", 8, &reg), 0);
+    assert_int_equal(OSMatch_Execute("systemd-logind", 14, &reg), 0);
+    /* The string length bounds the search */
+    assert_int_equal(OSMatch_Execute("run squid", 8, &reg), 0);
+
+    OSMatch_FreePattern(&reg);
+
+    assert_int_equal(OSMatch_Compile(negated, &reg, 0), 1);
+    assert_int_equal(OSMatch_Execute("httpd: GET /", 12, &reg), 0);
+    assert_int_equal(OSMatch_Execute("systemd-logind", 14, &reg), 1);
+    OSMatch_FreePattern(&reg);
+
+    /* Upper case alternatives of a case sensitive pattern never match */
+    assert_int_equal(OSMatch_Compile("SSHD|kernel|crond|cupsd|dhclient|rsyslogd|ntpd|postfix|dovecot", &reg, OS_CASE_SENSITIVE), 1);
+    assert_int_equal(OSMatch_Execute("SSHD", 4, &reg), 0);
+    assert_int_equal(OSMatch_Execute("NTPD", 4, &reg), 1);
+    OSMatch_FreePattern(&reg);
+
+    /* Few alternatives are tried one by one */
+    assert_int_equal(OSMatch_Compile("sshd|kernel", &reg, 0), 1);
+    assert_null(reg.literals);
+    OSMatch_FreePattern(&reg);
+}
+
 void test_success_regex(void **state)
 {
     (void) state;
@@ -469,6 +510,120 @@ void test_regex_extraction(void **state)
     }
 }
 
+void test_regex_extraction_spans(void **state)
+{
+    (void) state;
+
+    /* Same captures as the sub_strings ones, left as spans of the input */
+    const char *tests[][15] = {
+        { "123(\\w+\\s+)abc", "abc123sdf    abc", "sdf    ", NULL},
+        { "^sshd[\\d+]: Accepted \\S+ for (\\S+) from (\\S+) port ", "sshd[21405]: Accepted password for root from 192.1.1.1 port 6023", "root", "192.1.1.1", NULL},
+        { "^abc|x(\\d+)", "x123", "123", NULL},
+        {NULL, NULL, NULL}
+    };
+
+    for (int i = 0; tests[i][0] != NULL; i++) {
+        OSRegex reg;
+        regex_matching matching = {0};
+
+        assert_int_equal(OSRegex_Compile(tests[i][0], &reg, OS_RETURN_SUBSTRING), 1);
+        assert_non_null((void *)OSRegex_Execute_spans(tests[i][1], &reg, &matching));
+        assert_non_null(matching.spans);
+
+        int j;
+        int k;
+        for (j = 2, k = 0; tests[i][j] != NULL; j++, k += 2) {
+            assert_non_null(matching.spans[k]);
+            assert_int_equal(matching.spans[k + 1] - matching.spans[k], strlen(tests[i][j]));
+            assert_memory_equal(matching.spans[k], tests[i][j], strlen(tests[i][j]));
+        }
+        assert_null(matching.spans[k]);
+
+        /* Nothing was copied */
+        assert_null(matching.sub_strings[0]);
+
+        OSRegex_free_regex_matching(&matching);
+        OSRegex_FreePattern(&reg);
+    }
+}
+
+void test_regex_extraction_spans_no_match(void **state)
+{
+    (void) state;
+    OSRegex reg;
+    regex_matching matching = {0};
+
+    assert_int_equal(OSRegex_Compile("123(\\w+)abc", &reg, OS_RETURN_SUBSTRING), 1);
+
+    assert_non_null((void *)OSRegex_Execute_spans("123sdfabc", &reg, &matching));
+    assert_non_null(matching.spans);
+
+    /* A failed match doesn't leave the spans of the previous one */
+    assert_null(OSRegex_Execute_spans("nothing here", &reg, &matching));
+    assert_null(matching.spans);
+
+    OSRegex_free_regex_matching(&matching);
+    OSRegex_FreePattern(&reg);
+}
+
+void test_literal_regex_flag(void **state)
+{
+    (void) state;
+    OSRegex reg;
+
+    assert_int_equal(OSRegex_Compile("^abc|de f$|\\d+x|(g)|", &reg, 0), 1);
+
+    assert_true(reg.flags[0] & LITERAL_SET);
+    assert_true(reg.flags[1] & LITERAL_SET);
+    assert_false(reg.flags[2] & LITERAL_SET);
+    assert_false(reg.flags[3] & LITERAL_SET);
+    assert_false(reg.flags[4] & LITERAL_SET);
+
+    OSRegex_FreePattern(&reg);
+}
+
+void test_literal_regex_offset(void **state)
+{
+    (void) state;
+
+    /* The literal path must return the same position as the interpreter */
+    const struct {
+        const char *pattern;
+        const char *str;
+        int offset;
+    } tests[] = {
+        {"abc", "xxabcyyabc", 4},
+        {"abc", "xxABCyy", 4},
+        {"aab", "aaab", 3},
+        {"^abc", "abcd", 2},
+        {"^abc", "xabc", -1},
+        {"abc$", "abcabc", 5},
+        {"abc$", "abcab", -1},
+        {"^abc$", "abc", 2},
+        {"^abc$", "abcabc", -1},
+        {"x|bc", "abc", 2},
+        {"abcd", "abc", -1},
+        {NULL, NULL, 0}
+    };
+
+    for (int i = 0; tests[i].pattern != NULL; i++) {
+        OSRegex reg;
+        const char *ret;
+
+        assert_int_equal(OSRegex_Compile(tests[i].pattern, &reg, 0), 1);
+        ret = OSRegex_Execute(tests[i].str, &reg);
+
+        if (tests[i].offset < 0) {
+            assert_null(ret);
+        } else {
+            assert_non_null(ret);
+            assert_int_equal(ret - tests[i].str, tests[i].offset);
+        }
+
+        OSRegex_FreePattern(&reg);
+    }
+}
+
 void test_hostname_map(void **state)
 {
     (void) state;
@@ -816,6 +971,7 @@ int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_success_match),
         cmocka_unit_test(test_fail_match),
+        cmocka_unit_test(test_match_many_alternatives),
         cmocka_unit_test(test_success_regex),
         cmocka_unit_test(test_fail_regex),
         cmocka_unit_test(test_success_wordmatch),
@@ -830,6 +986,10 @@ int main(void) {
         cmocka_unit_test(test_strbreak),
         cmocka_unit_test(test_strbreak_null),
         cmocka_unit_test(test_regex_extraction),
+        cmocka_unit_test(test_regex_extraction_spans),
+        cmocka_unit_test(test_regex_extraction_spans_no_match),
+        cmocka_unit_test(test_literal_regex_flag),
+        cmocka_unit_test(test_literal_regex_offset),
         cmocka_unit_test(test_hostname_map),
         cmocka_unit_test(test_case_insensitive_char_map),
         cmocka_unit_test(test_regexmap_digit),
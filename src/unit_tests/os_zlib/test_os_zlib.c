@@ -135,6 +135,18 @@ void test_fail_uncompress_no_dest_size(void **state) {
     assert_int_equal(i2, 0);
 }
 
+void test_success_uncompress_after_failure(void **state) {
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    char buffer2[BUFFER_LENGTH];
+    unsigned long int i2 = os_zlib_uncompress(data->buffer, buffer2, data->i1 - 2, BUFFER_LENGTH);
+    assert_int_equal(i2, 0);
+
+    i2 = os_zlib_uncompress(data->buffer, buffer2, data->i1, BUFFER_LENGTH);
+    assert_int_equal(i2, strlen(TEST_STRING_1));
+    assert_string_equal(buffer2, TEST_STRING_1);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_success_compress_string),
@@ -148,6 +160,7 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_fail_uncompress_null_dst, setup_uncompress_string1, teardown_uncompress),
         cmocka_unit_test_setup_teardown(test_fail_uncompress_no_src_size, setup_uncompress_string1, teardown_uncompress),
         cmocka_unit_test_setup_teardown(test_fail_uncompress_no_dest_size, setup_uncompress_string1, teardown_uncompress),
+        cmocka_unit_test_setup_teardown(test_success_uncompress_after_failure, setup_uncompress_string1, teardown_uncompress),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
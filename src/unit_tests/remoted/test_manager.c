@@ -22,6 +22,7 @@
 #include "../wrappers/posix/unistd_wrappers.h"
 #include "../wrappers/wazuh/remoted/request_wrappers.h"
 #include "../wrappers/wazuh/remoted/remoted_op_wrappers.h"
+#include "../wrappers/wazuh/remoted/queue_wrappers.h"
 #include "../wrappers/wazuh/wazuh_db/wdb_global_helpers_wrappers.h"
 
 #include "../wazuh_db/wdb.h"
@@ -36,6 +37,7 @@ int lookfor_agent_group(const char *agent_id, char *msg, char **r_group, int* wd
 #define LONG_PATH "190-characters-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
 
 void keyentry_init(keyentry *key, char *name, char *id, char *ip, char *raw_key) {
+    memset(key, 0, sizeof(keyentry));
     os_calloc(1, sizeof(os_ip), key->ip);
     key->ip->ip = ip ? strdup(ip) : NULL;
     key->name = name ? strdup(name) : NULL;
@@ -785,7 +787,7 @@ void test_c_group_no_changes(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Couldn't add file 'merged.mg' to group hash table.");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "md5_test");
@@ -857,7 +859,7 @@ void test_c_group_no_changes_disk(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Couldn't add file 'merged.mg' to group hash table.");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "md5_test");
@@ -930,7 +932,7 @@ void test_c_group_changes(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Unable to get entry attributes 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "md5_test2");
@@ -998,7 +1000,7 @@ void test_c_group_changes_disk(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Unable to get entry attributes 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "md5_test2");
@@ -1060,6 +1062,10 @@ void test_c_group_fail(void **state)
     expect_value(__wrap_fclose, _File, (FILE *)2);
     will_return(__wrap_fclose, 0);
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "md5_test");
@@ -1067,7 +1073,7 @@ void test_c_group_fail(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Accessing file 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "");
@@ -1117,7 +1123,7 @@ void test_c_group_fail_disk(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Accessing file 'etc/shared/test_default/merged.mg.tmp'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     assert_string_equal(group->name, "test_default");
     assert_string_equal(group->merged_sum, "");
@@ -1162,6 +1168,10 @@ void test_c_group_downloaded_file(void **state)
     expect_string(__wrap_OS_MoveFile, dst, "etc/shared/test_default/merged.mg");
     will_return(__wrap_OS_MoveFile, 0);
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "md5_test");
@@ -1169,7 +1179,7 @@ void test_c_group_downloaded_file(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Accessing file 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1203,6 +1213,10 @@ void test_c_group_downloaded_file_no_poll(void **state)
     expect_string(__wrap_w_parser_get_group, name, group->name);
     will_return(__wrap_w_parser_get_group, r_group);
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "md5_test");
@@ -1210,7 +1224,7 @@ void test_c_group_downloaded_file_no_poll(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Accessing file 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1259,7 +1273,7 @@ void test_c_group_downloaded_file_is_corrupted(void **state)
     expect_string(__wrap__merror, formatted_msg, "The downloaded file 'var/download/merged.mg' is corrupted.");
     expect_string(__wrap__merror, formatted_msg, "Failed to delete file 'var/download/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1306,6 +1320,10 @@ void test_c_group_download_all_files(void **state)
     expect_string(__wrap_OS_MoveFile, dst, "etc/shared/test_default/r_group->files_name");
     will_return(__wrap_OS_MoveFile, 0);
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "md5_test");
@@ -1313,7 +1331,7 @@ void test_c_group_download_all_files(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Accessing file 'etc/shared/test_default/merged.mg'");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1355,12 +1373,16 @@ void test_c_group_no_create_shared_file(void **state)
     expect_string(__wrap__mdebug1, formatted_msg, "Could not open directory 'etc/shared/test_default'");
     // End validate_shared_files function
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "md5_test");
     will_return(__wrap_OS_MD5_File, -1);
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, false, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, false, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1373,6 +1395,51 @@ void test_c_group_no_create_shared_file(void **state)
     assert_non_null(group->f_time);
 }
 
+void test_c_group_no_create_merged_not_modified(void **state)
+{
+    group_t *group = (group_t *)state[0];
+
+    const char *group_name = "test_default";
+
+    struct stat merged_attrib = { .st_ino = 1234, .st_size = 2048, .st_mtime = 1650000000 };
+
+    snprintf(group->merged_sum, sizeof(os_md5), "md5_test");
+    group->merged_stat.inode = 1234;
+    group->merged_stat.size = 2048;
+    group->merged_stat.m_time = 1650000000;
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, (OSHash *)10);
+
+    expect_string(__wrap_stat, __file, "etc/shared/ar.conf");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
+    // Start validate_shared_files function
+    expect_string(__wrap_wreaddir, name, "etc/shared/test_default");
+    will_return(__wrap_wreaddir, NULL);
+
+    expect_string(__wrap__mdebug1, formatted_msg, "Could not open directory 'etc/shared/test_default'");
+    // End validate_shared_files function
+
+    // The merged file is not hashed again
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, &merged_attrib);
+    will_return(__wrap_stat, 0);
+
+    OSHash_Add_ex_check_data = 0;
+    expect_value(__wrap_OSHash_Add_ex, self, (OSHash *)10);
+    expect_string(__wrap_OSHash_Add_ex, key, "merged.mg");
+    will_return(__wrap_OSHash_Add_ex, 1);
+
+    expect_string(__wrap__merror, formatted_msg, "Couldn't add file 'merged.mg' to group hash table.");
+
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, false, false);
+
+    assert_string_equal(group->merged_sum, "md5_test");
+    assert_non_null(group->f_time);
+}
+
 void test_c_group_invalid_share_file(void **state)
 {
     disk_storage = 0;
@@ -1452,7 +1519,7 @@ void test_c_group_invalid_share_file(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Unable to open file: 'etc/shared/test_default/merged.mg' due to [(0)-(No such file or directory)].");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1545,7 +1612,7 @@ void test_c_group_append_file_error(void **state)
     expect_value(__wrap_fclose, _File, (FILE *)1);
     will_return(__wrap_fclose, 0);
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1601,7 +1668,7 @@ void test_c_group_append_ar_error(void **state)
     expect_value(__wrap_fclose, _File, (FILE *)1);
     will_return(__wrap_fclose, 0);
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1645,7 +1712,7 @@ void test_c_group_truncate_error(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Unable to open memory stream due to [(0)-(No such file or directory)].");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1689,7 +1756,7 @@ void test_c_group_truncate_error_disk(void **state)
 
     expect_string(__wrap__merror, formatted_msg, "Unable to create merged file: 'etc/shared/test_default/merged.mg.tmp' due to [(0)-(No such file or directory)].");
 
-    c_group(group_name, &group->f_time, &group->merged_sum, SHAREDCFG_DIR, true, false);
+    c_group(group_name, &group->f_time, &group->merged_sum, &group->merged_stat, SHAREDCFG_DIR, true, false);
 
     os_free(r_group->name)
     os_free(r_group->files->name);
@@ -1703,9 +1770,10 @@ void test_c_multi_group_hash_multigroup_null(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 }
 
 void test_c_multi_group_open_directory_fail(void **state)
@@ -1713,6 +1781,7 @@ void test_c_multi_group_open_directory_fail(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1727,7 +1796,7 @@ void test_c_multi_group_open_directory_fail(void **state)
 
     expect_string(__wrap__mdebug2, formatted_msg, "Opening directory: 'etc/shared': No such file or directory");
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     os_free(hash_multigroup);
     os_free(multi_group);
@@ -1738,6 +1807,7 @@ void test_c_multi_group_call_copy_directory(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1758,7 +1828,7 @@ void test_c_multi_group_call_copy_directory(void **state)
     will_return(__wrap_strerror, "No such file or directory");
     expect_string(__wrap__mdebug2, formatted_msg, "Opening directory: 'var/multigroups': No such file or directory");
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     os_free(hash_multigroup);
     os_free(multi_group);
@@ -1769,6 +1839,7 @@ void test_c_multi_group_read_dir_fail_no_entry(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1789,7 +1860,7 @@ void test_c_multi_group_read_dir_fail_no_entry(void **state)
 
     errno = ENOTDIR;
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     errno = 0;
 
@@ -1802,6 +1873,7 @@ void test_c_multi_group_Ignore_hidden_files(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1862,7 +1934,7 @@ void test_c_multi_group_Ignore_hidden_files(void **state)
     will_return(__wrap_strerror, "No such file or directory");
     expect_string(__wrap__mdebug2, formatted_msg, "Opening directory: 'var/multigroups': No such file or directory");
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     os_free(last_modify);
     os_free(hash_multigroup);
@@ -1874,6 +1946,7 @@ void test_c_multi_group_subdir_fail(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1898,7 +1971,7 @@ void test_c_multi_group_subdir_fail(void **state)
     will_return(__wrap_strerror, "ERROR");
     expect_string(__wrap__mdebug2, formatted_msg, "Opening directory: 'var/multigroups': ERROR");
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     errno = 0;
     os_free(hash_multigroup);
@@ -1912,6 +1985,7 @@ void test_c_multi_group_call_c_group(void **state)
     char *multi_group = NULL;
     OSHash *_f_time = (OSHash *)10;
     os_md5 sum;
+    file_stat merged_stat = {0};
     char *hash_multigroup = NULL;
 
     os_strdup("multi_group_test", multi_group);
@@ -1953,7 +2027,7 @@ void test_c_multi_group_call_c_group(void **state)
     expect_string(__wrap_cldir_ex_ignore, name, "var/multigroups/hash_multi_group_test");
     will_return(__wrap_cldir_ex_ignore, 0);
 
-    c_multi_group(multi_group, &_f_time, &sum, hash_multigroup, true);
+    c_multi_group(multi_group, &_f_time, &sum, &merged_stat, hash_multigroup, true);
 
     errno = 0;
 
@@ -1961,29 +2035,9 @@ void test_c_multi_group_call_c_group(void **state)
     os_free(multi_group);
 }
 
-void test_find_group_from_file_found(void **state)
+void test_index_groups_by_sum(void **state)
 {
-    char group_name[OS_SIZE_65536] = {0};
-
-    OSHashNode* node = NULL;
-    os_calloc(1, sizeof(OSHashNode), node);
-    node->data = state[0];
-
-    expect_value(__wrap_OSHash_Begin, self, groups);
-    will_return(__wrap_OSHash_Begin, node);
-
-    group_t *group = find_group_from_sum("ABCDEF1234567890", group_name);
-
-    assert_string_equal(group_name, "test_default");
-    assert_non_null(group);
-    assert_string_equal(group->name, "test_default");
-
-    os_free(node);
-}
-
-void test_find_group_from_file_not_found(void **state)
-{
-    char group_name[OS_SIZE_65536] = {0};
+    OSHash *index = (OSHash *)1;
 
     OSHashNode* node1 = NULL;
     os_calloc(1, sizeof(OSHashNode), node1);
@@ -1993,80 +2047,94 @@ void test_find_group_from_file_not_found(void **state)
     os_calloc(1, sizeof(OSHashNode), node2);
     node2->data = state[1];
 
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, index);
+
     expect_value(__wrap_OSHash_Begin, self, groups);
     will_return(__wrap_OSHash_Begin, node1);
 
+    expect_string(__wrap_OSHash_Add, key, "ABCDEF1234567890");
+    will_return(__wrap_OSHash_Add, 2);
+
     expect_value(__wrap_OSHash_Next, self, groups);
     will_return(__wrap_OSHash_Next, node2);
 
+    expect_string(__wrap_OSHash_Add, key, "ABCDEF1234567809");
+    will_return(__wrap_OSHash_Add, 2);
+
     expect_value(__wrap_OSHash_Next, self, groups);
     will_return(__wrap_OSHash_Next, NULL);
 
+    assert_ptr_equal(index_groups_by_sum(groups, NULL), index);
+
+    os_free(node1);
+    os_free(node2);
+}
+
+void test_find_group_from_file_found(void **state)
+{
+    char group_name[OS_SIZE_65536] = {0};
+
+    groups_by_sum_outdated = false;
+
+    expect_value(__wrap_OSHash_Get, self, groups_by_sum);
+    expect_string(__wrap_OSHash_Get, key, "ABCDEF1234567890");
+    will_return(__wrap_OSHash_Get, state[0]);
+
+    group_t *group = find_group_from_sum("ABCDEF1234567890", group_name);
+
+    assert_string_equal(group_name, "test_default");
+    assert_non_null(group);
+    assert_string_equal(group->name, "test_default");
+}
+
+void test_find_group_from_file_not_found(void **state)
+{
+    char group_name[OS_SIZE_65536] = {0};
+
+    groups_by_sum_outdated = false;
+
+    expect_value(__wrap_OSHash_Get, self, groups_by_sum);
+    expect_string(__wrap_OSHash_Get, key, "2121212121");
+    will_return(__wrap_OSHash_Get, NULL);
+
     group_t *group = find_group_from_sum("2121212121", group_name);
 
     assert_string_equal(group_name, "\0");
     assert_null(group);
-
-    os_free(node1);
-    os_free(node2);
 }
 
 void test_find_multi_group_from_file_found(void **state)
 {
     char multi_group_name[OS_SIZE_65536] = {0};
 
-    OSHashNode* node1 = NULL;
-    os_calloc(1, sizeof(OSHashNode), node1);
-    node1->data = state[0];
+    groups_by_sum_outdated = false;
 
-    OSHashNode* node2 = NULL;
-    os_calloc(1, sizeof(OSHashNode), node2);
-    node2->data = state[1];
-
-    expect_value(__wrap_OSHash_Begin, self, multi_groups);
-    will_return(__wrap_OSHash_Begin, node1);
-
-    expect_value(__wrap_OSHash_Next, self, multi_groups);
-    will_return(__wrap_OSHash_Next, node2);
+    expect_value(__wrap_OSHash_Get, self, multi_groups_by_sum);
+    expect_string(__wrap_OSHash_Get, key, "1234567890ABCDFE");
+    will_return(__wrap_OSHash_Get, state[1]);
 
     group_t *multi_group = find_multi_group_from_sum("1234567890ABCDFE", multi_group_name);
 
     assert_string_equal(multi_group_name, "test_test_default2");
     assert_non_null(multi_group);
     assert_string_equal(multi_group->name, "test_test_default2");
-
-    os_free(node1);
-    os_free(node2);
 }
 
 void test_find_multi_group_from_file_not_found(void **state)
 {
     char multi_group_name[OS_SIZE_65536] = {0};
 
-    OSHashNode* node1 = NULL;
-    os_calloc(1, sizeof(OSHashNode), node1);
-    node1->data = state[0];
-
-    OSHashNode* node2 = NULL;
-    os_calloc(1, sizeof(OSHashNode), node2);
-    node2->data = state[1];
-
-    expect_value(__wrap_OSHash_Begin, self, multi_groups);
-    will_return(__wrap_OSHash_Begin, node1);
-
-    expect_value(__wrap_OSHash_Next, self, multi_groups);
-    will_return(__wrap_OSHash_Next, node2);
+    groups_by_sum_outdated = false;
 
-    expect_value(__wrap_OSHash_Next, self, multi_groups);
-    will_return(__wrap_OSHash_Next, NULL);
+    expect_value(__wrap_OSHash_Get, self, multi_groups_by_sum);
+    expect_string(__wrap_OSHash_Get, key, "4545454545");
+    will_return(__wrap_OSHash_Get, NULL);
 
     group_t *multi_group = find_multi_group_from_sum("4545454545", multi_group_name);
 
     assert_string_equal(multi_group_name, "\0");
     assert_null(multi_group);
-
-    os_free(node1);
-    os_free(node2);
 }
 
 void test_ftime_changed_same_fsum(void **state)
@@ -2740,6 +2808,10 @@ void test_process_groups_find_group_changed(void **state)
     expect_string(__wrap__mdebug1, formatted_msg, "Could not open directory 'etc/shared/test_default'");
     // End validate_shared_files function
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "1212121212121");
@@ -2860,6 +2932,10 @@ void test_process_groups_find_group_not_changed(void **state)
     expect_string(__wrap__mdebug1, formatted_msg, "Could not open directory 'etc/shared/test_default'");
     // End validate_shared_files function
 
+    expect_string(__wrap_stat, __file, "etc/shared/test_default/merged.mg");
+    will_return(__wrap_stat, 0);
+    will_return(__wrap_stat, -1);
+
     expect_string(__wrap_OS_MD5_File, fname, "etc/shared/test_default/merged.mg");
     expect_value(__wrap_OS_MD5_File, mode, OS_TEXT);
     will_return(__wrap_OS_MD5_File, "1212121212121");
@@ -4702,7 +4778,7 @@ void test_save_controlmsg_could_not_add_pending_data(void **state)
     free_keyentry(&key);
 }
 
-void test_save_controlmsg_unable_to_save_last_keepalive(void **state)
+void test_save_controlmsg_push_keepalive(void **state)
 {
     char r_msg[OS_SIZE_128] = {0};
     strcpy(r_msg, "Invalid message \n with enter");
@@ -4736,18 +4812,156 @@ void test_save_controlmsg_unable_to_save_last_keepalive(void **state)
     expect_function_call(__wrap_pthread_mutex_lock);
     expect_function_call(__wrap_pthread_mutex_unlock);
 
-    expect_value(__wrap_wdb_update_agent_keepalive, id, 1);
-    expect_string(__wrap_wdb_update_agent_keepalive, connection_status, AGENT_CS_ACTIVE);
-    expect_string(__wrap_wdb_update_agent_keepalive, sync_status, "synced");
-    will_return(__wrap_wdb_update_agent_keepalive, OS_INVALID);
+    // Queue the keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    save_controlmsg(&key, r_msg, msg_length, wdb_sock);
+    free_keyentry(&key);
+    os_free(data.message);
+}
+
+void test_save_controlmsg_push_keepalive_flow_control(void **state)
+{
+    char r_msg[OS_SIZE_128] = {0};
+    strcpy(r_msg, "Invalid message \n with enter");
+
+    keyentry key;
+    keyentry_init(&key, "NEW_AGENT", "001", "10.2.2.5", NULL);
+    key.flow_control = true;
+
+    size_t msg_length = sizeof(r_msg);
+    int *wdb_sock = NULL;
+
+    will_return(__wrap_rem_get_tsize, 1024);
+    will_return(__wrap_rem_get_qsize, 256);
+
+    expect_string(__wrap_send_msg, agent_id, "001");
+    expect_string(__wrap_send_msg, msg, "#!-agent ack {\"queue\":25}");
+
+    expect_string(__wrap_rem_inc_send_ack, agent_id, "001");
 
-    expect_string(__wrap__mwarn, formatted_msg, "Unable to save last keepalive and set connection status as active for agent: 001");
+    expect_string(__wrap_rem_inc_recv_ctrl_keepalive, agent_id, "001");
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, 1);
+    pending_data = OSHash_Create();
+
+    pending_data_t data;
+    char * message = strdup("Invalid message \n");
+    data.changed = true;
+    data.message = message;
+
+    expect_value(__wrap_OSHash_Get, self, pending_data);
+    expect_string(__wrap_OSHash_Get, key, "001");
+    will_return(__wrap_OSHash_Get, &data);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // Queue the keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    save_controlmsg(&key, r_msg, msg_length, wdb_sock);
+    free_keyentry(&key);
+    os_free(data.message);
+}
+
+void test_save_controlmsg_compact_keepalive(void **state)
+{
+    char r_msg[OS_SIZE_128] = {0};
+
+    keyentry key;
+    keyentry_init(&key, "NEW_AGENT", "001", "10.2.2.5", NULL);
+
+    size_t msg_length = sizeof(r_msg);
+    int *wdb_sock = NULL;
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, 1);
+    pending_data = OSHash_Create();
+
+    pending_data_t data;
+    char * message = strdup("Invalid message \n");
+    data.changed = true;
+    data.message = message;
+    data.keepalive_seq = 0;
+    OS_MD5_Str(message, -1, data.message_sum);
+
+    snprintf(r_msg, sizeof(r_msg), "%s1 %s", HC_KEEPALIVE, data.message_sum);
+
+    // Take the metadata of the last keepalive
+    expect_value(__wrap_OSHash_Get, self, pending_data);
+    expect_string(__wrap_OSHash_Get, key, "001");
+    will_return(__wrap_OSHash_Get, &data);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_string(__wrap_send_msg, agent_id, "001");
+    expect_string(__wrap_send_msg, msg, "#!-agent ack ");
+
+    expect_string(__wrap_rem_inc_send_ack, agent_id, "001");
+
+    expect_string(__wrap_rem_inc_recv_ctrl_keepalive, agent_id, "001");
+
+    expect_value(__wrap_OSHash_Get, self, pending_data);
+    expect_string(__wrap_OSHash_Get, key, "001");
+    will_return(__wrap_OSHash_Get, &data);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // Queue the keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
 
     save_controlmsg(&key, r_msg, msg_length, wdb_sock);
+
+    assert_int_equal(data.keepalive_seq, 1);
+
     free_keyentry(&key);
     os_free(data.message);
 }
 
+void test_save_controlmsg_compact_keepalive_unknown(void **state)
+{
+    char r_msg[OS_SIZE_128] = {0};
+    strcpy(r_msg, HC_KEEPALIVE "3 0123456789abcdef0123456789abcdef");
+
+    keyentry key;
+    keyentry_init(&key, "NEW_AGENT", "001", "10.2.2.5", NULL);
+
+    size_t msg_length = sizeof(r_msg);
+    int *wdb_sock = NULL;
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, 1);
+    pending_data = OSHash_Create();
+
+    expect_value(__wrap_OSHash_Get, self, pending_data);
+    expect_string(__wrap_OSHash_Get, key, "001");
+    will_return(__wrap_OSHash_Get, NULL);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Unknown metadata in the keepalive of agent '001', requesting it");
+
+    // Ask the agent for the full keepalive
+    expect_string(__wrap_send_msg, agent_id, "001");
+    expect_string(__wrap_send_msg, msg, "#!-agent ack {\"metadata\":true}");
+
+    expect_string(__wrap_rem_inc_send_ack, agent_id, "001");
+
+    expect_string(__wrap_rem_inc_recv_ctrl_keepalive, agent_id, "001");
+
+    save_controlmsg(&key, r_msg, msg_length, wdb_sock);
+
+    free_keyentry(&key);
+}
+
 void test_save_controlmsg_update_msg_error_parsing(void **state)
 {
     char r_msg[OS_SIZE_128] = {0};
@@ -5047,6 +5261,71 @@ void test_save_controlmsg_startup(void **state)
     expect_function_call(__wrap_pthread_mutex_lock);
     expect_function_call(__wrap_pthread_mutex_unlock);
 
+    // Drop the queued keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_value(__wrap_wdb_update_agent_keepalive, id, 1);
+    expect_string(__wrap_wdb_update_agent_keepalive, connection_status, AGENT_CS_PENDING);
+    expect_string(__wrap_wdb_update_agent_keepalive, sync_status, "synced");
+    will_return(__wrap_wdb_update_agent_keepalive, OS_INVALID);
+
+    expect_string(__wrap__mwarn, formatted_msg, "Unable to save last keepalive and set connection status as pending for agent: 001");
+
+    save_controlmsg(&key, r_msg, msg_length, wdb_sock);
+
+    free_keyentry(&key);
+    os_free(message);
+}
+
+void test_save_controlmsg_startup_batch(void **state)
+{
+    char r_msg[OS_SIZE_128] = {0};
+    strcpy(r_msg, "agent startup {\"version\":\"v4.5.0\",\"batch\":true}");
+    keyentry key;
+    keyentry_init(&key, "NEW_AGENT", "001", "10.2.2.5", NULL);
+    key.peer_info.ss_family = 0;
+    size_t msg_length = sizeof(r_msg);
+    int *wdb_sock = NULL;
+
+    expect_string(__wrap_send_msg, agent_id, "001");
+    expect_string(__wrap_send_msg, msg, "#!-agent ack {\"batch\":true}");
+
+    expect_string(__wrap_rem_inc_send_ack, agent_id, "001");
+
+    expect_string(__wrap_rem_inc_recv_ctrl_startup, agent_id, "001");
+
+    expect_string(__wrap__mdebug1, formatted_msg, "Agent NEW_AGENT sent HC_STARTUP from ''");
+
+    expect_string(__wrap_compare_wazuh_versions, version1, "v4.5.0");
+    expect_string(__wrap_compare_wazuh_versions, version2, "v4.5.0");
+    expect_value(__wrap_compare_wazuh_versions, compare_patch, false);
+    will_return(__wrap_compare_wazuh_versions, 0);
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, 1);
+    pending_data = OSHash_Create();
+
+    pending_data_t data;
+    char * message = strdup("startup message \n");
+    data.changed = false;
+    data.message = message;
+
+    expect_value(__wrap_OSHash_Get, self, pending_data);
+    expect_string(__wrap_OSHash_Get, key, "001");
+    will_return(__wrap_OSHash_Get, &data);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // Drop the queued keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
     expect_value(__wrap_wdb_update_agent_keepalive, id, 1);
     expect_string(__wrap_wdb_update_agent_keepalive, connection_status, AGENT_CS_PENDING);
     expect_string(__wrap_wdb_update_agent_keepalive, sync_status, "synced");
@@ -5096,6 +5375,12 @@ void test_save_controlmsg_shutdown(void **state)
     expect_function_call(__wrap_pthread_mutex_lock);
     expect_function_call(__wrap_pthread_mutex_unlock);
 
+    // Drop the queued keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
     expect_value(__wrap_wdb_update_agent_connection_status, id, 1);
     expect_string(__wrap_wdb_update_agent_connection_status, connection_status, AGENT_CS_DISCONNECTED);
     expect_string(__wrap_wdb_update_agent_connection_status, sync_status, "synced");
@@ -5164,6 +5449,12 @@ void test_save_controlmsg_shutdown_wdb_fail(void **state)
     expect_function_call(__wrap_pthread_mutex_lock);
     expect_function_call(__wrap_pthread_mutex_unlock);
 
+    // Drop the queued keepalive
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
     expect_value(__wrap_wdb_update_agent_connection_status, id, 1);
     expect_string(__wrap_wdb_update_agent_connection_status, connection_status, AGENT_CS_DISCONNECTED);
     expect_string(__wrap_wdb_update_agent_connection_status, sync_status, "synced");
@@ -5200,6 +5491,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_c_group_downloaded_file_is_corrupted, test_c_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_c_group_download_all_files, test_c_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_c_group_no_create_shared_file, test_c_group_setup, test_c_group_teardown),
+        cmocka_unit_test_setup_teardown(test_c_group_no_create_merged_not_modified, test_c_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_c_group_invalid_share_file, test_c_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_c_group_append_file_error, test_c_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_c_group_append_ar_error, test_c_group_setup, test_c_group_teardown),
@@ -5214,6 +5506,7 @@ int main(void)
         cmocka_unit_test(test_c_multi_group_subdir_fail),
         cmocka_unit_test(test_c_multi_group_call_c_group),
         // Test find_group_from_sum
+        cmocka_unit_test_setup_teardown(test_index_groups_by_sum, test_find_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_find_group_from_file_found, test_find_group_setup, test_c_group_teardown),
         cmocka_unit_test_setup_teardown(test_find_group_from_file_not_found, test_find_group_setup, test_c_group_teardown),
         // Test find_multi_group_from_sum
@@ -5303,11 +5596,15 @@ int main(void)
         cmocka_unit_test(test_save_controlmsg_agent_invalid_version),
         cmocka_unit_test(test_save_controlmsg_get_agent_version_fail),
         cmocka_unit_test(test_save_controlmsg_could_not_add_pending_data),
-        cmocka_unit_test(test_save_controlmsg_unable_to_save_last_keepalive),
+        cmocka_unit_test(test_save_controlmsg_push_keepalive),
+        cmocka_unit_test(test_save_controlmsg_push_keepalive_flow_control),
+        cmocka_unit_test(test_save_controlmsg_compact_keepalive),
+        cmocka_unit_test(test_save_controlmsg_compact_keepalive_unknown),
         cmocka_unit_test(test_save_controlmsg_update_msg_error_parsing),
         cmocka_unit_test(test_save_controlmsg_update_msg_unable_to_update_information),
         cmocka_unit_test(test_save_controlmsg_update_msg_lookfor_agent_group_fail),
         cmocka_unit_test(test_save_controlmsg_startup),
+        cmocka_unit_test(test_save_controlmsg_startup_batch),
         cmocka_unit_test(test_save_controlmsg_shutdown),
         cmocka_unit_test(test_save_controlmsg_shutdown_wdb_fail),
     };
@@ -268,6 +268,58 @@ void test_nb_send_zero_ok(void ** state) {
     assert_int_equal(retval, 0);
 }
 
+void test_nb_send_flush_queue_ok(void ** state) {
+    netbuffer_t *netbuffer = *state;
+    char final_msg[14] = {0};
+
+    ssize_t final_size = snprintf(final_msg, 14, "4321abcdefghi");
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    // First chunk
+    expect_memory(__wrap_bqueue_peek, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    expect_value(__wrap_bqueue_peek, flags, BQUEUE_NOFLAG);
+    will_return(__wrap_bqueue_peek, 1);
+    will_return(__wrap_bqueue_peek, final_msg);
+    will_return(__wrap_bqueue_peek, final_size);
+
+    will_return(__wrap_send, final_size);
+
+    expect_memory(__wrap_bqueue_drop, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    expect_value(__wrap_bqueue_drop, length, final_size);
+    will_return(__wrap_bqueue_drop, final_size);
+
+    expect_memory(__wrap_bqueue_used, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    will_return(__wrap_bqueue_used, final_size);
+
+    // Second chunk
+    expect_memory(__wrap_bqueue_peek, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    expect_value(__wrap_bqueue_peek, flags, BQUEUE_NOFLAG);
+    will_return(__wrap_bqueue_peek, 1);
+    will_return(__wrap_bqueue_peek, final_msg);
+    will_return(__wrap_bqueue_peek, final_size);
+
+    will_return(__wrap_send, final_size);
+
+    expect_memory(__wrap_bqueue_drop, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    expect_value(__wrap_bqueue_drop, length, final_size);
+    will_return(__wrap_bqueue_drop, final_size);
+
+    expect_memory(__wrap_bqueue_used, queue, (bqueue_t *)netbuffer->buffers[sock].bqueue, sizeof(bqueue_t *));
+    will_return(__wrap_bqueue_used, 0);
+
+    expect_memory(__wrap_wnotify_modify, notify, notify, sizeof(wnotify_t *));
+    expect_value(__wrap_wnotify_modify, fd, sock);
+    expect_value(__wrap_wnotify_modify, op, WO_READ);
+    will_return(__wrap_wnotify_modify, 0);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    int retval = nb_send(netbuffer, sock);
+
+    assert_int_equal(retval, 2 * final_size);
+}
+
 void test_nb_send_would_block_ok(void ** state) {
     netbuffer_t *netbuffer = *state;
     char final_msg[14] = {0};
@@ -338,6 +390,7 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_nb_queue_retry_err, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_nb_send_zero_ok, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_nb_send_ok, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_nb_send_flush_queue_ok, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_nb_send_would_block_ok, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_nb_send_err, test_setup, test_teardown),
     };
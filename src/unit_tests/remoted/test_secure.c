@@ -31,6 +31,7 @@
 #include "../wrappers/wazuh/remoted/netcounter_wrappers.h"
 #include "../wrappers/wazuh/os_crypto/msgs_wrappers.h"
 #include "../wrappers/wazuh/remoted/state_wrappers.h"
+#include "../wrappers/wazuh/shared/mq_op_wrappers.h"
 #include "remoted/secure.c"
 
 extern keystore keys;
@@ -1098,6 +1099,60 @@ void test_handle_outgoing_data_to_tcp_socket_success(void **state)
     handle_outgoing_data_to_tcp_socket(sock_client);
 }
 
+void test_rem_forward_batch_success(void **state)
+{
+    char batch[] = "10\n1:test:one13\n1:test:second";
+
+    expect_SendMSG_call("1:test:one", "[001] (agent) any", SECURE_MQ, 0);
+    expect_string(__wrap_rem_inc_recv_evt, agent_id, "001");
+
+    expect_SendMSG_call("1:test:second", "[001] (agent) any", SECURE_MQ, 0);
+    expect_string(__wrap_rem_inc_recv_evt, agent_id, "001");
+
+    rem_forward_batch(batch, "[001] (agent) any", "001");
+}
+
+void test_rem_forward_batch_invalid_length(void **state)
+{
+    char batch[] = "10\n1:test:one50\n1:test:second";
+
+    expect_SendMSG_call("1:test:one", "[001] (agent) any", SECURE_MQ, 0);
+    expect_string(__wrap_rem_inc_recv_evt, agent_id, "001");
+
+    expect_string(__wrap__mwarn, formatted_msg, "Invalid batch of events from agent '001'.");
+
+    rem_forward_batch(batch, "[001] (agent) any", "001");
+}
+
+void test_rem_forward_batch_invalid_frame(void **state)
+{
+    char batch[] = "1:test:one";
+
+    expect_string(__wrap__mwarn, formatted_msg, "Invalid batch of events from agent '001'.");
+
+    rem_forward_batch(batch, "[001] (agent) any", "001");
+}
+
+void test_rem_analysisd_instance_single(void **state)
+{
+    logr.analysisd_instances = 1;
+
+    assert_int_equal(rem_analysisd_instance("001"), 0);
+    assert_int_equal(rem_analysisd_instance("1024"), 0);
+}
+
+void test_rem_analysisd_instance_sharded(void **state)
+{
+    logr.analysisd_instances = 4;
+
+    assert_int_equal(rem_analysisd_instance("001"), 1);
+    assert_int_equal(rem_analysisd_instance("004"), 0);
+    assert_int_equal(rem_analysisd_instance("010"), 2);
+    assert_int_equal(rem_analysisd_instance("1023"), 3);
+
+    logr.analysisd_instances = 1;
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -1132,6 +1187,13 @@ int main(void)
         cmocka_unit_test(test_handle_outgoing_data_to_tcp_socket_case_1_EAGAIN),
         cmocka_unit_test(test_handle_outgoing_data_to_tcp_socket_case_1_EPIPE),
         cmocka_unit_test(test_handle_outgoing_data_to_tcp_socket_success),
+        // Tests rem_forward_batch
+        cmocka_unit_test(test_rem_forward_batch_success),
+        cmocka_unit_test(test_rem_forward_batch_invalid_length),
+        cmocka_unit_test(test_rem_forward_batch_invalid_frame),
+        // Tests rem_analysisd_instance
+        cmocka_unit_test(test_rem_analysisd_instance_single),
+        cmocka_unit_test(test_rem_analysisd_instance_sharded),
 
         };
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "remoted/remoted.h"
+#include "headers/shared.h"
+#include "os_net/os_net.h"
+#include "../wrappers/common.h"
+#include "../wrappers/wazuh/shared/debug_op_wrappers.h"
+#include "../wrappers/wazuh/shared/mq_op_wrappers.h"
+
+/* Forward declarations */
+int syslog_set_source(const struct sockaddr_storage *peer, syslog_source *source);
+void syslog_dispatch(char *buffer, ssize_t recv_b, const syslog_source *source);
+
+/* setup/teardown */
+
+static int group_setup(void ** state) {
+    test_mode = 1;
+    return 0;
+}
+
+static int group_teardown(void ** state) {
+    test_mode = 0;
+    return 0;
+}
+
+static void set_ipv4_peer(struct sockaddr_storage *peer, const char *ip) {
+    memset(peer, 0, sizeof(struct sockaddr_storage));
+    peer->ss_family = AF_INET;
+    inet_pton(AF_INET, ip, &((struct sockaddr_in *)peer)->sin_addr);
+}
+
+/* Tests */
+
+// syslog_set_source
+
+void test_syslog_set_source_ipv4_not_allowed(void ** state) {
+    struct sockaddr_storage peer;
+    syslog_source source = { .family = AF_UNSPEC };
+
+    logr.allowips = NULL;
+    logr.denyips = NULL;
+    set_ipv4_peer(&peer, "192.168.0.1");
+
+    assert_int_equal(syslog_set_source(&peer, &source), 0);
+    assert_int_equal(source.family, AF_INET);
+    assert_string_equal(source.ip, "192.168.0.1");
+    assert_int_equal(source.denied, 1);
+}
+
+void test_syslog_set_source_same_address(void ** state) {
+    struct sockaddr_storage peer;
+    syslog_source source = { .family = AF_INET, .denied = 0 };
+
+    // The verdict of the previous datagram is reused
+    set_ipv4_peer(&peer, "192.168.0.1");
+    source.addr.ipv4 = ((struct sockaddr_in *)&peer)->sin_addr;
+    strcpy(source.ip, "192.168.0.1");
+
+    logr.allowips = NULL;
+    logr.denyips = NULL;
+
+    assert_int_equal(syslog_set_source(&peer, &source), 0);
+    assert_string_equal(source.ip, "192.168.0.1");
+    assert_int_equal(source.denied, 0);
+}
+
+void test_syslog_set_source_new_address(void ** state) {
+    struct sockaddr_storage peer;
+    syslog_source source = { .family = AF_INET, .denied = 0 };
+
+    set_ipv4_peer(&peer, "192.168.0.1");
+    source.addr.ipv4 = ((struct sockaddr_in *)&peer)->sin_addr;
+    strcpy(source.ip, "192.168.0.1");
+
+    logr.allowips = NULL;
+    logr.denyips = NULL;
+    set_ipv4_peer(&peer, "10.0.0.1");
+
+    assert_int_equal(syslog_set_source(&peer, &source), 0);
+    assert_string_equal(source.ip, "10.0.0.1");
+    assert_int_equal(source.denied, 1);
+}
+
+void test_syslog_set_source_unsupported_family(void ** state) {
+    struct sockaddr_storage peer = { .ss_family = AF_UNIX };
+    syslog_source source = { .family = AF_UNSPEC };
+
+    assert_int_equal(syslog_set_source(&peer, &source), -1);
+}
+
+// syslog_dispatch
+
+void test_syslog_dispatch_denied(void ** state) {
+    char buffer[OS_MAXSTR + 2] = "<18>test log\n";
+    syslog_source source = { .family = AF_INET, .ip = "192.168.0.1", .denied = 1 };
+
+    expect_string(__wrap__mwarn, formatted_msg, "(1213): Message from '192.168.0.1' not allowed. Cannot find the ID of the agent.");
+
+    syslog_dispatch(buffer, strlen(buffer), &source);
+}
+
+void test_syslog_dispatch_send(void ** state) {
+    char buffer[OS_MAXSTR + 2] = "<18>test log\n";
+    syslog_source source = { .family = AF_INET, .ip = "192.168.0.1", .denied = 0 };
+
+    // The header and the trailing newline are removed
+    expect_SendMSG_call("test log", "192.168.0.1", SYSLOG_MQ, 0);
+
+    syslog_dispatch(buffer, strlen(buffer), &source);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // Test syslog_set_source
+        cmocka_unit_test(test_syslog_set_source_ipv4_not_allowed),
+        cmocka_unit_test(test_syslog_set_source_same_address),
+        cmocka_unit_test(test_syslog_set_source_new_address),
+        cmocka_unit_test(test_syslog_set_source_unsupported_family),
+        // Test syslog_dispatch
+        cmocka_unit_test(test_syslog_dispatch_denied),
+        cmocka_unit_test(test_syslog_dispatch_send),
+    };
+
+    return cmocka_run_group_tests(tests, group_setup, group_teardown);
+}
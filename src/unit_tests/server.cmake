@@ -22,4 +22,5 @@ add_subdirectory(monitord)
 add_subdirectory(logcollector)
 add_subdirectory(os_execd)
 add_subdirectory(os_integrator)
+add_subdirectory(os_csyslogd)
 add_subdirectory(addagent)
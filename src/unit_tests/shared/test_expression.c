@@ -621,7 +621,7 @@ void w_expression_match_pcre2_match_captured_groups(void ** state)
     aux[0] = str_test;
     aux[1] = str_test+1;
 
-    will_return(wrap_pcre2_match_data_create_from_pattern, 1);
+    /* The match data of the thread is reused */
     will_return(wrap_pcre2_match, 1);
     will_return(wrap_pcre2_get_ovector_pointer, aux);
 
@@ -661,7 +661,7 @@ void w_expression_match_pcre2_match_regex_matching(void ** state)
     regex_matching * regex_match;
     os_calloc(1, sizeof(regex_matching), regex_match);
 
-    will_return(wrap_pcre2_match_data_create_from_pattern, 1);
+    /* The match data of the thread is reused */
     will_return(wrap_pcre2_match, 1);
     will_return(wrap_pcre2_get_ovector_pointer, aux);
 
@@ -674,6 +674,39 @@ void w_expression_match_pcre2_match_regex_matching(void ** state)
     w_free_expression_t(&expression);
 }
 
+void w_expression_match_pcre2_match_data_grow(void ** state)
+{
+    w_expression_t * expression = NULL;
+    os_calloc(1, sizeof(w_expression_t), expression);
+    expression->exp_type = EXP_TYPE_PCRE2;
+
+    const char* end_match = "test_end_match";
+
+    os_calloc(1, sizeof(w_pcre2_code_t), expression->pcre2);
+
+    int errornumber = 0;
+    PCRE2_SIZE erroroffset = 0;
+    char* pattern = NULL;
+    os_strdup("(te)(st)", pattern);
+
+    expression->pcre2->code = pcre2_compile((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED,
+                                               0, &errornumber, &erroroffset, NULL);
+
+    char * str_test = NULL;
+    os_strdup("test", str_test);
+
+    /* The match data of the thread is too small for the groups of the pattern */
+    will_return(wrap_pcre2_match_data_create_from_pattern, 1);
+    will_return(wrap_pcre2_match, 0);
+
+    bool ret = w_expression_match(expression, str_test, &end_match, NULL);
+    assert_false(ret);
+
+    os_free(str_test);
+    os_free(pattern);
+    w_free_expression_t(&expression);
+}
+
 void w_expression_match_string(void ** state)
 {
     w_expression_t * expression = NULL;
@@ -770,7 +803,7 @@ void w_expression_match_end_match_NULL(void ** state)
     regex_matching * regex_match;
     os_calloc(1, sizeof(regex_matching), regex_match);
 
-    will_return(wrap_pcre2_match_data_create_from_pattern, 1);
+    /* The match data of the thread is reused */
     will_return(wrap_pcre2_match, 1);
     will_return(wrap_pcre2_get_ovector_pointer, aux);
 
@@ -1096,6 +1129,60 @@ void w_expression_get_regex_type_exp_type_default(void ** state)
     os_free(expression);
 }
 
+// w_expression_combine_pcre2
+
+static OSList * combine_pcre2_list(const char ** patterns) {
+    OSList * list = OSList_Create();
+    OSList_SetFreeDataPointer(list, (void (*)(void *))w_free_expression);
+
+    for (int i = 0; patterns[i]; i++) {
+        w_expression_t * expression = NULL;
+        w_calloc_expression_t(&expression, EXP_TYPE_PCRE2);
+        assert_true(w_expression_compile(expression, (char *) patterns[i], 0));
+        OSList_AddData(list, expression);
+    }
+
+    return list;
+}
+
+void w_expression_combine_pcre2_NULL(void ** state)
+{
+    assert_null(w_expression_combine_pcre2(NULL));
+}
+
+void w_expression_combine_pcre2_single(void ** state)
+{
+    const char * patterns[] = {"test", NULL};
+    OSList * list = combine_pcre2_list(patterns);
+
+    assert_null(w_expression_combine_pcre2(list));
+
+    OSList_Destroy(list);
+}
+
+void w_expression_combine_pcre2_backref(void ** state)
+{
+    const char * patterns[] = {"test", "(a)\\1", NULL};
+    OSList * list = combine_pcre2_list(patterns);
+
+    assert_null(w_expression_combine_pcre2(list));
+
+    OSList_Destroy(list);
+}
+
+void w_expression_combine_pcre2_ok(void ** state)
+{
+    const char * patterns[] = {"^first", "second$", NULL};
+    OSList * list = combine_pcre2_list(patterns);
+
+    w_expression_t * combined = w_expression_combine_pcre2(list);
+    assert_non_null(combined);
+    assert_string_equal(w_expression_get_regex_pattern(combined), "(?:^first)|(?:second$)");
+
+    w_free_expression_t(&combined);
+    OSList_Destroy(list);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -1141,6 +1228,7 @@ int main(void)
         cmocka_unit_test(w_expression_match_pcre2_match_no_captured_groups),
         cmocka_unit_test(w_expression_match_pcre2_match_captured_groups),
         cmocka_unit_test(w_expression_match_pcre2_match_regex_matching),
+        cmocka_unit_test(w_expression_match_pcre2_match_data_grow),
         cmocka_unit_test(w_expression_match_string),
         cmocka_unit_test(w_expression_match_osip_array),
         cmocka_unit_test(w_expression_match_default),
@@ -1169,7 +1257,13 @@ int main(void)
         cmocka_unit_test(w_expression_get_regex_type_exp_type_pcre2),
         cmocka_unit_test(w_expression_get_regex_type_exp_type_string),
         cmocka_unit_test(w_expression_get_regex_type_exp_type_osip_array),
-        cmocka_unit_test(w_expression_get_regex_type_exp_type_default)
+        cmocka_unit_test(w_expression_get_regex_type_exp_type_default),
+
+        //Test w_expression_combine_pcre2
+        cmocka_unit_test(w_expression_combine_pcre2_NULL),
+        cmocka_unit_test(w_expression_combine_pcre2_single),
+        cmocka_unit_test(w_expression_combine_pcre2_backref),
+        cmocka_unit_test(w_expression_combine_pcre2_ok)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
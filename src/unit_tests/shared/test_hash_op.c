@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "headers/shared.h"
+
+#define HASH_ROWS 2048
+#define HASH_KEYS 1000
+#define HASH_MAX_CHAIN 8
+
+/* setup/teardowns */
+
+static int setup_hash(void **state) {
+    OSHash *hash = OSHash_Create();
+
+    if (!hash || !OSHash_setSize(hash, HASH_ROWS)) {
+        return -1;
+    }
+
+    *state = hash;
+    return 0;
+}
+
+static int teardown_hash(void **state) {
+    OSHash_Free(*state);
+    return 0;
+}
+
+/* Helpers */
+
+static void assert_spread(const OSHash *hash) {
+    unsigned int used = 0;
+    unsigned int longest = 0;
+    unsigned int elements = 0;
+
+    for (unsigned int i = 0; i <= hash->rows; i++) {
+        unsigned int chain = 0;
+
+        for (OSHashNode *node = hash->table[i]; node; node = node->next) {
+            chain++;
+        }
+
+        if (chain) {
+            used++;
+        }
+        if (chain > longest) {
+            longest = chain;
+        }
+
+        elements += chain;
+    }
+
+    assert_int_equal(elements, HASH_KEYS);
+
+    // 1000 keys in about 2048 rows: most keys get a row of their own, and no chain grows long
+    assert_true(used > HASH_KEYS / 2);
+    assert_true(longest <= HASH_MAX_CHAIN);
+}
+
+/* tests */
+
+/* _os_genhash */
+void test_OSHash_spread_paths(void **state) {
+    OSHash *hash = *state;
+    char key[OS_SIZE_256];
+
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "/var/ossec/queue/diff/local/etc/file%d", i);
+        assert_int_equal(OSHash_Add(hash, key, hash), 2);
+    }
+
+    assert_spread(hash);
+}
+
+void test_OSHash_spread_agent_ids(void **state) {
+    OSHash *hash = *state;
+    char key[OS_SIZE_32];
+
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "%03d", i);
+        assert_int_equal(OSHash_Add(hash, key, hash), 2);
+    }
+
+    assert_spread(hash);
+}
+
+void test_OSHash_get_stable(void **state) {
+    OSHash *hash = *state;
+    int data[HASH_KEYS];
+    char key[OS_SIZE_32];
+
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert_int_equal(OSHash_Add(hash, key, &data[i]), 2);
+    }
+
+    // Keys that share a prefix longer than a word, or differ only in the length
+    assert_int_equal(OSHash_Add(hash, "key-1", &data[0]), 1);
+    assert_null(OSHash_Get(hash, "key-"));
+    assert_null(OSHash_Get(hash, "key-10000"));
+
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert_ptr_equal(OSHash_Get(hash, key), &data[i]);
+    }
+
+    assert_int_equal(hash->elements, HASH_KEYS);
+}
+
+/* OSHash_Duplicate */
+void test_OSHash_Duplicate(void **state) {
+    OSHash *hash = *state;
+    OSHash *copy;
+    int data[HASH_KEYS];
+    int extra;
+    char key[OS_SIZE_32];
+
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert_int_equal(OSHash_Add(hash, key, &data[i]), 2);
+    }
+
+    copy = OSHash_Duplicate(hash);
+
+    assert_non_null(copy);
+    assert_int_equal(copy->rows, hash->rows);
+    assert_int_equal(copy->elements, HASH_KEYS);
+
+    // The copy keeps the seeds, so the keys are found in the same rows
+    for (int i = 0; i < HASH_KEYS; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert_ptr_equal(OSHash_Get(copy, key), &data[i]);
+    }
+
+    assert_int_equal(OSHash_Add(copy, "key-0", &extra), 1);
+    assert_int_equal(OSHash_Add(copy, "extra", &extra), 2);
+    assert_ptr_equal(OSHash_Get(copy, "extra"), &extra);
+    assert_int_equal(copy->elements, HASH_KEYS + 1);
+
+    assert_ptr_equal(OSHash_Delete(copy, "key-1"), &data[1]);
+    assert_null(OSHash_Get(copy, "key-1"));
+    assert_int_equal(copy->elements, HASH_KEYS);
+
+    // The original is not changed by the copy
+    assert_null(OSHash_Get(hash, "extra"));
+    assert_ptr_equal(OSHash_Get(hash, "key-1"), &data[1]);
+    assert_int_equal(hash->elements, HASH_KEYS);
+
+    OSHash_Free(copy);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // Tests _os_genhash
+        cmocka_unit_test_setup_teardown(test_OSHash_spread_paths, setup_hash, teardown_hash),
+        cmocka_unit_test_setup_teardown(test_OSHash_spread_agent_ids, setup_hash, teardown_hash),
+        cmocka_unit_test_setup_teardown(test_OSHash_get_stable, setup_hash, teardown_hash),
+        // Tests OSHash_Duplicate
+        cmocka_unit_test_setup_teardown(test_OSHash_Duplicate, setup_hash, teardown_hash),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
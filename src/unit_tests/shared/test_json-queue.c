@@ -230,6 +230,25 @@ void test_jqueue_parse_json_stat_fail_and_retry(void ** state) {
     assert_int_equal(queue->flags, 0);
 }
 
+// jqueue_wait
+
+void test_jqueue_wait_file_not_open(void ** state) {
+    file_queue * queue = *state;
+
+    queue->fp = NULL;
+
+    expect_value(__wrap_sleep, seconds, 1);
+
+    jqueue_wait(queue, 1);
+
+    assert_int_equal(queue->notify_ready, 1);
+    assert_int_equal(queue->notify_wd, -1);
+
+    if (queue->notify_fd >= 0) {
+        close(queue->notify_fd);
+    }
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(test_jqueue_parse_json_valid, setup_queue, teardown_queue),
@@ -238,6 +257,8 @@ int main(void) {
             cmocka_unit_test_setup_teardown(test_jqueue_parse_json_fgets_fail, setup_queue, teardown_queue),
             cmocka_unit_test_setup_teardown(test_jqueue_parse_json_fgets_fail_and_retry, setup_queue, teardown_queue),
             cmocka_unit_test_setup_teardown(test_jqueue_parse_json_stat_fail_and_retry, setup_queue, teardown_queue),
+            // jqueue_wait
+            cmocka_unit_test_setup_teardown(test_jqueue_wait_file_not_open, setup_queue, teardown_queue),
 
     };
     return cmocka_run_group_tests(tests, setup_group, teardown_group);
@@ -29,6 +29,11 @@
 #define PATH_EXAMPLE "/home/test"
 #define BUFFER_EXAMPLE "//This is a comment"
 
+void * json_arena_malloc(size_t size);
+void json_arena_free(void * ptr);
+bool json_arena_enter();
+void json_arena_leave();
+
 static int teardown(void **state) {
     if (state[0]) {
         int *ids = (int*)state[0];
@@ -294,6 +299,134 @@ void test_json_parse_agents_empty(void **state)
 }
 
 
+
+// json_arena
+
+static int setup_json_arena(void **state) {
+    (void) state;
+    json_arena_init();
+    return 0;
+}
+
+static int teardown_json_arena(void **state) {
+    (void) state;
+    json_arena_leave();
+    json_arena_reset();
+    return 0;
+}
+
+static void test_json_arena_malloc(void **state) {
+    (void) state;
+
+    assert_true(json_arena_enter());
+
+    char * first = json_arena_malloc(10);
+    char * second = json_arena_malloc(100);
+
+    assert_non_null(first);
+    assert_int_equal((uintptr_t)first % 16, 0);
+    assert_ptr_equal(second, first + 16);
+
+    // The arena memory is not released one by one
+    json_arena_free(first);
+    assert_ptr_equal(json_arena_malloc(1), second + 112);
+
+    json_arena_leave();
+
+    // Out of the arena
+    char * plain = json_arena_malloc(10);
+    strcpy(plain, "plain");
+    json_arena_free(plain);
+    json_arena_free(NULL);
+}
+
+static void test_json_arena_large(void **state) {
+    (void) state;
+
+    assert_true(json_arena_enter());
+
+    char * large = json_arena_malloc(200000);
+    memset(large, 'a', 200000);
+    char * small = json_arena_malloc(10);
+
+    assert_non_null(small);
+    json_arena_free(large);
+    json_arena_free(small);
+}
+
+static void test_json_arena_reset(void **state) {
+    (void) state;
+
+    assert_true(json_arena_enter());
+    char * first = json_arena_malloc(10);
+    json_arena_leave();
+
+    json_arena_reset();
+
+    // The first chunk is reused
+    assert_true(json_arena_enter());
+    assert_ptr_equal(json_arena_malloc(10), first);
+}
+
+static void test_json_arena_parse(void **state) {
+    (void) state;
+    const char * end = NULL;
+
+    will_return(__wrap_cJSON_ParseWithOpts, "");
+    will_return(__wrap_cJSON_ParseWithOpts, (cJSON *)1);
+
+    assert_ptr_equal(json_arena_parse("{}", &end, true), (cJSON *)1);
+
+    // The allocations out of the parser don't use the arena
+    char * plain = json_arena_malloc(10);
+    free(plain);
+}
+
+static void test_json_arena_free_old_chunk(void **state) {
+    (void) state;
+
+    assert_true(json_arena_enter());
+
+    char * first = json_arena_malloc(10);
+    char * large = json_arena_malloc(200000);
+    char * heap = malloc(10);
+
+    json_arena_leave();
+
+    // Only the heap pointer is released
+    json_arena_free(large);
+    json_arena_free(first);
+    json_arena_free(first);
+    json_arena_free(heap);
+}
+
+static void test_json_snprint(void **state) {
+    (void) state;
+    char buffer[OS_SIZE_128];
+    cJSON * item = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(item, "id", 1);
+
+    assert_int_equal(json_snprint(buffer, sizeof(buffer), "ok ", item), 0);
+    assert_string_equal(buffer, "ok {\"id\":1}");
+
+    cJSON_Delete(item);
+}
+
+static void test_json_snprint_truncated(void **state) {
+    (void) state;
+    char buffer[8];
+    cJSON * item = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(item, "name", "agent");
+    will_return(__wrap_cJSON_PrintUnformatted, strdup("{\"name\":\"agent\"}"));
+
+    assert_int_equal(json_snprint(buffer, sizeof(buffer), "ok ", item), -1);
+    assert_string_equal(buffer, "ok {\"na");
+
+    cJSON_Delete(item);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_json_fread_buffer_null),
@@ -310,7 +443,16 @@ int main(void) {
         // json_parse_agents
         cmocka_unit_test_teardown(test_json_parse_agents_success, teardown),
         cmocka_unit_test_teardown(test_json_parse_agents_type_error, teardown),
-        cmocka_unit_test_teardown(test_json_parse_agents_empty, teardown)
+        cmocka_unit_test_teardown(test_json_parse_agents_empty, teardown),
+        // json_arena
+        cmocka_unit_test_setup_teardown(test_json_arena_malloc, setup_json_arena, teardown_json_arena),
+        cmocka_unit_test_setup_teardown(test_json_arena_large, setup_json_arena, teardown_json_arena),
+        cmocka_unit_test_setup_teardown(test_json_arena_reset, setup_json_arena, teardown_json_arena),
+        cmocka_unit_test_setup_teardown(test_json_arena_parse, setup_json_arena, teardown_json_arena),
+        cmocka_unit_test_setup_teardown(test_json_arena_free_old_chunk, setup_json_arena, teardown_json_arena),
+        // json_snprint
+        cmocka_unit_test(test_json_snprint),
+        cmocka_unit_test(test_json_snprint_truncated)
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
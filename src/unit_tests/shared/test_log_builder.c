@@ -40,9 +40,37 @@ void test_log_builder(void **state)
     log_builder_destroy(builder);
 }
 
+void test_log_builder_format(void **state)
+{
+    const char * PATTERN = "$(location) $(unknown)[$(log)] $(unclosed";
+    const char * LOG = "Hello";
+    const char * LOCATION = "test";
+    const char * EXPECTED_OUTPUT = "test [Hello] $(unclosed";
+    char output[64];
+
+    will_return(__wrap_getDefine_Int, 60);
+
+    log_builder_t * builder = log_builder_init(false);
+    log_format_t * format = log_builder_compile(PATTERN);
+
+    assert_int_equal(format->size, 6);
+    assert_int_equal(format->constant_length, strlen(" [] $(unclosed"));
+
+    assert_int_equal(log_builder_format(builder, format, LOG, LOCATION, output, sizeof(output)), strlen(EXPECTED_OUTPUT));
+    assert_string_equal(output, EXPECTED_OUTPUT);
+
+    // The message doesn't fit: the input log is kept
+    assert_int_equal(log_builder_format(builder, format, LOG, LOCATION, output, 10), strlen(LOG));
+    assert_string_equal(output, LOG);
+
+    log_format_free(format);
+    log_builder_destroy(builder);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(test_log_builder),
+            cmocka_unit_test(test_log_builder_format),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
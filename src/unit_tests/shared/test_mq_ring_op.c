@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+/* More than half of the smallest ring */
+#define MSG_SIZE 70000
+
+/* setup/teardowns */
+
+static int create_ring(void **state)
+{
+    char name[NAME_MAX];
+    mq_ring_t ** rings;
+
+    os_calloc(2, sizeof(mq_ring_t *), rings);
+
+    if (rings[0] = mq_ring_create(0, name, sizeof(name)), !rings[0]) {
+        os_free(rings);
+        return -1;
+    }
+
+    rings[1] = mq_ring_attach(name);
+    *state = rings;
+
+    return rings[1] ? 0 : -1;
+}
+
+static int delete_ring(void **state)
+{
+    mq_ring_t ** rings = *state;
+
+    if (rings[0]) {
+        mq_ring_close(rings[0]);
+    }
+
+    mq_ring_detach(rings[1]);
+    os_free(rings);
+
+    return 0;
+}
+
+/* tests */
+
+void test_mq_ring_push_pop(void **state)
+{
+    mq_ring_t ** rings = *state;
+    char buffer[OS_SIZE_128];
+
+    assert_true(mq_ring_ready(rings[0]));
+
+    assert_int_equal(mq_ring_push(rings[0], "1:location:first", 16), 0);
+    assert_int_equal(mq_ring_push(rings[0], "1:location:second", 17), 0);
+
+    assert_int_equal(mq_ring_pop(rings[1], buffer, sizeof(buffer), 0), 16);
+    assert_string_equal(buffer, "1:location:first");
+
+    assert_int_equal(mq_ring_pop(rings[1], buffer, sizeof(buffer), 0), 17);
+    assert_string_equal(buffer, "1:location:second");
+
+    assert_int_equal(mq_ring_pop(rings[1], buffer, sizeof(buffer), 0), 0);
+}
+
+void test_mq_ring_push_full(void **state)
+{
+    mq_ring_t ** rings = *state;
+    char * msg;
+
+    os_calloc(MSG_SIZE + 1, sizeof(char), msg);
+    memset(msg, 'A', MSG_SIZE);
+
+    assert_int_equal(mq_ring_push(rings[0], msg, MSG_SIZE), 0);
+    assert_int_equal(mq_ring_push(rings[0], msg, MSG_SIZE), -1);
+
+    os_free(msg);
+}
+
+void test_mq_ring_pop_closed(void **state)
+{
+    mq_ring_t ** rings = *state;
+    char buffer[OS_SIZE_128];
+
+    assert_int_equal(mq_ring_push(rings[0], "1:location:last", 15), 0);
+
+    mq_ring_close(rings[0]);
+    rings[0] = NULL;
+
+    assert_int_equal(mq_ring_pop(rings[1], buffer, sizeof(buffer), 0), 15);
+    assert_string_equal(buffer, "1:location:last");
+
+    assert_int_equal(mq_ring_pop(rings[1], buffer, sizeof(buffer), 0), -1);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_mq_ring_push_pop, create_ring, delete_ring),
+        cmocka_unit_test_setup_teardown(test_mq_ring_push_full, create_ring, delete_ring),
+        cmocka_unit_test_setup_teardown(test_mq_ring_pop_closed, create_ring, delete_ring),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
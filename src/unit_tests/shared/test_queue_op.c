@@ -79,6 +79,11 @@ int __wrap_pthread_cond_signal(pthread_cond_t *cond) {
     return 0;
 }
 
+int __wrap_pthread_cond_broadcast(pthread_cond_t *cond) {
+    check_expected_ptr(cond);
+    return 0;
+}
+
 /****************TESTS***************************/
 void test_queue_full(void **state){
     w_queue_t *queue = *state;
@@ -284,6 +289,188 @@ void test_queue_pop_ex_timedwait_no_timeout(void **state) {
     assert_ptr_not_equal(ptr, NULL);
     os_free(ptr);
 }
+void test_queue_push_batch_ex(void **state) {
+    w_queue_t *queue = *state;
+    int values[QUEUE_SIZE];
+    void *batch[QUEUE_SIZE];
+    int i;
+
+    for (i = 0; i < QUEUE_SIZE; i++) {
+        values[i] = i;
+        batch[i] = &values[i];
+    }
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_broadcast, cond, &queue->available);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    // Should fit QUEUE_SIZE - 1 elements
+    assert_int_equal(queue_push_batch_ex(queue, batch, QUEUE_SIZE), QUEUE_SIZE - 1);
+    assert_int_equal(queue->elements, QUEUE_SIZE - 1);
+
+    for (i = 0; i < QUEUE_SIZE - 1; i++) {
+        assert_ptr_equal(queue->data[i], &values[i]);
+    }
+
+    // Should now be full
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(queue_push_batch_ex(queue, batch, 1), 0);
+}
+
+void test_queue_push_batch_ex_block(void **state) {
+    w_queue_t *queue = *state;
+    int values[QUEUE_SIZE];
+    void *batch[QUEUE_SIZE];
+    int i;
+
+    for (i = 0; i < QUEUE_SIZE; i++) {
+        values[i] = i;
+        batch[i] = &values[i];
+    }
+
+    // Queue gets full after QUEUE_SIZE - 1 elements, callback frees one slot
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 2);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 2);
+    expect_value_count(__wrap_pthread_cond_broadcast, cond, &queue->available, 2);
+    expect_value(__wrap_pthread_cond_wait, cond, &queue->available_not_empty);
+    expect_value(__wrap_pthread_cond_wait, mutex, &queue->mutex);
+    expect_value_count(__wrap_pthread_cond_signal, cond, &queue->available_not_empty, 2);
+    callback_ptr = callback_queue_pop_ex;
+
+    assert_int_equal(queue_push_batch_ex_block(queue, batch, QUEUE_SIZE), QUEUE_SIZE);
+    assert_int_equal(queue->elements, QUEUE_SIZE - 1);
+}
+
+void test_queue_pop_batch_ex(void **state) {
+    w_queue_t *queue = *state;
+    int values[QUEUE_SIZE];
+    void *batch[QUEUE_SIZE];
+    int i;
+
+    for (i = 0; i < QUEUE_SIZE - 1; i++) {
+        values[i] = i;
+        queue_push(queue, &values[i]);
+    }
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_broadcast, cond, &queue->available_not_empty);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(queue_pop_batch_ex(queue, batch, 2), 2);
+    assert_ptr_equal(batch[0], &values[0]);
+    assert_ptr_equal(batch[1], &values[1]);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_broadcast, cond, &queue->available_not_empty);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(queue_pop_batch_ex(queue, batch, QUEUE_SIZE), QUEUE_SIZE - 3);
+    assert_ptr_equal(batch[0], &values[2]);
+    assert_ptr_equal(batch[1], &values[3]);
+    assert_int_equal(queue_empty(queue), 1);
+
+    // Should be empty now until some push event
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 2);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 2);
+    expect_value(__wrap_pthread_cond_wait, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_wait, cond, &queue->available);
+    expect_value(__wrap_pthread_cond_signal, cond, &queue->available);
+    expect_value(__wrap_pthread_cond_signal, cond, &queue->available_not_empty);
+    callback_ptr = callback_queue_push_ex;
+
+    assert_int_equal(queue_pop_batch_ex(queue, batch, QUEUE_SIZE), 1);
+    os_free(batch[0]);
+}
+
+void test_queue_pop_batch_ex_timedwait_timeout(void **state) {
+    w_queue_t *queue = *state;
+    struct timespec abstime;
+    void *batch[QUEUE_SIZE];
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_timedwait, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_timedwait, cond, &queue->available);
+    expect_value(__wrap_pthread_cond_timedwait, abstime, &abstime);
+    will_return(__wrap_pthread_cond_timedwait, ETIMEDOUT);
+
+    assert_int_equal(queue_pop_batch_ex_timedwait(queue, batch, QUEUE_SIZE, &abstime), 0);
+}
+
+void test_queue_pop_batch_ex_timedwait_no_timeout(void **state) {
+    w_queue_t *queue = *state;
+    struct timespec abstime;
+    void *batch[QUEUE_SIZE];
+
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 2);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 2);
+    expect_value(__wrap_pthread_cond_timedwait, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_timedwait, cond, &queue->available);
+    expect_value(__wrap_pthread_cond_timedwait, abstime, &abstime);
+    will_return(__wrap_pthread_cond_timedwait, 0);
+    expect_value(__wrap_pthread_cond_signal, cond, &queue->available);
+    expect_value(__wrap_pthread_cond_signal, cond, &queue->available_not_empty);
+    callback_ptr = callback_queue_push_ex;
+
+    assert_int_equal(queue_pop_batch_ex_timedwait(queue, batch, QUEUE_SIZE, &abstime), 1);
+    os_free(batch[0]);
+}
+
+void test_queue_idle_busy_batch(void **state) {
+    w_queue_t *queue = *state;
+    int values[QUEUE_SIZE];
+    void *batch[QUEUE_SIZE];
+    int i;
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+    queue_track_busy(queue);
+
+    for (i = 0; i < 3; i++) {
+        queue_push(queue, &values[i]);
+    }
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_broadcast, cond, &queue->available_not_empty);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(queue_pop_batch_ex(queue, batch, QUEUE_SIZE), 3);
+    assert_int_equal(queue_empty(queue), 1);
+
+    // Empty, but the batch is still in process
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 4);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 4);
+
+    assert_int_equal(queue_idle(queue), 0);
+    queue_done(queue, 2);
+    assert_int_equal(queue_idle(queue), 0);
+    queue_done(queue, 1);
+    assert_int_equal(queue_idle(queue), 1);
+}
+
+void test_queue_idle_not_tracked(void **state) {
+    w_queue_t *queue = *state;
+    int values[QUEUE_SIZE];
+    void *batch[QUEUE_SIZE];
+
+    queue_push(queue, &values[0]);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_cond_signal, cond, &queue->available_not_empty);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(queue_pop_batch_ex(queue, batch, QUEUE_SIZE), 1);
+
+    // Without tracking, an empty queue is idle and done does nothing
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 2);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 2);
+
+    queue_done(queue, 1);
+    assert_int_equal(queue->busy, 0);
+    assert_int_equal(queue_idle(queue), 1);
+}
 /************************************************/
 int main(void) {
     const struct CMUnitTest tests[] = {
@@ -296,6 +483,13 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_queue_pop_ex, setup_queue, teardown_queue),
         cmocka_unit_test_setup_teardown(test_queue_pop_ex_timedwait_timeout, setup_queue, teardown_queue),
         cmocka_unit_test_setup_teardown(test_queue_pop_ex_timedwait_no_timeout, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_push_batch_ex, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_push_batch_ex_block, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_pop_batch_ex, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_pop_batch_ex_timedwait_timeout, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_pop_batch_ex_timedwait_no_timeout, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_idle_busy_batch, setup_queue, teardown_queue),
+        cmocka_unit_test_setup_teardown(test_queue_idle_not_tracked, setup_queue, teardown_queue),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
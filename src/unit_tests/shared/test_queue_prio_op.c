@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BATCH_SIZE 8
+
+static int values[64];
+
+/****************SETUP/TEARDOWN******************/
+int setup_prio_queue(void **state) {
+    // High and low classes fit 16 elements, the normal one fits 4
+    size_t sizes[PRIO_QUEUE_CLASSES] = { 17, 5, 17 };
+    unsigned int weights[PRIO_QUEUE_CLASSES] = { 4, 2, 2 };
+    *state = prio_queue_init(sizes, weights);
+    return 0;
+}
+
+int setup_prio_queue_normal_only(void **state) {
+    size_t sizes[PRIO_QUEUE_CLASSES] = { 0, 17, 0 };
+    unsigned int weights[PRIO_QUEUE_CLASSES] = { 4, 2, 1 };
+    *state = prio_queue_init(sizes, weights);
+    return 0;
+}
+
+int teardown_prio_queue(void **state) {
+    prio_queue_free(*state);
+    return 0;
+}
+
+/*****************WRAPS********************/
+int __wrap_pthread_mutex_lock(pthread_mutex_t *mutex) {
+    check_expected_ptr(mutex);
+    return 0;
+}
+
+int __wrap_pthread_mutex_unlock(pthread_mutex_t *mutex) {
+    check_expected_ptr(mutex);
+    return 0;
+}
+
+int __wrap_pthread_cond_signal(pthread_cond_t *cond) {
+    check_expected_ptr(cond);
+    return 0;
+}
+
+/****************TESTS***************************/
+static void push_elements(w_prio_queue_t *queue, unsigned int priority, int first, int n) {
+    for (int i = first; i < first + n; i++) {
+        expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+        expect_value(__wrap_pthread_cond_signal, cond, &queue->available);
+        expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+        assert_int_equal(prio_queue_push_ex(queue, priority, &values[i]), 0);
+    }
+}
+
+void test_prio_queue_init(void **state) {
+    w_prio_queue_t *queue = *state;
+
+    assert_non_null(queue->classes[0]);
+    assert_non_null(queue->classes[1]);
+    assert_non_null(queue->classes[2]);
+    assert_int_equal(queue->size, 39);
+    assert_int_equal(queue->total_weight, 8);
+    assert_int_equal(prio_queue_empty(queue), 1);
+}
+
+void test_prio_queue_init_disabled_classes(void **state) {
+    w_prio_queue_t *queue = *state;
+
+    assert_null(queue->classes[0]);
+    assert_non_null(queue->classes[1]);
+    assert_null(queue->classes[2]);
+    assert_int_equal(queue->size, 17);
+    assert_int_equal(queue->total_weight, 2);
+    assert_int_equal(prio_queue_full(queue, 0), 1);
+    assert_int_equal(prio_queue_full(queue, 1), 0);
+    assert_int_equal(prio_queue_full(queue, 3), 1);
+}
+
+void test_prio_queue_push_ex_disabled_class(void **state) {
+    w_prio_queue_t *queue = *state;
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(prio_queue_push_ex(queue, 2, &values[0]), -1);
+    assert_int_equal(prio_queue_empty(queue), 1);
+}
+
+void test_prio_queue_push_ex_class_full(void **state) {
+    w_prio_queue_t *queue = *state;
+
+    push_elements(queue, 1, 0, 4);
+    assert_int_equal(prio_queue_full(queue, 1), 1);
+    assert_int_equal(prio_queue_full(queue, 0), 0);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+    assert_int_equal(prio_queue_push_ex(queue, 1, &values[4]), -1);
+
+    // The other classes keep their room
+    push_elements(queue, 0, 4, 1);
+    assert_int_equal(queue->elements, 5);
+}
+
+void test_prio_queue_pop_batch_ex_weighted(void **state) {
+    w_prio_queue_t *queue = *state;
+    void *batch[BATCH_SIZE];
+
+    push_elements(queue, 2, 0, 16);
+    push_elements(queue, 0, 16, 16);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    // High takes 4 slots, normal is empty and low takes its 2 and the 2 left
+    assert_int_equal(prio_queue_pop_batch_ex(queue, batch, BATCH_SIZE), BATCH_SIZE);
+    assert_ptr_equal(batch[0], &values[16]);
+    assert_ptr_equal(batch[3], &values[19]);
+    assert_ptr_equal(batch[4], &values[0]);
+    assert_ptr_equal(batch[5], &values[1]);
+    assert_ptr_equal(batch[6], &values[20]);
+    assert_ptr_equal(batch[7], &values[21]);
+    assert_int_equal(queue->elements, 24);
+}
+
+void test_prio_queue_pop_batch_ex_short(void **state) {
+    w_prio_queue_t *queue = *state;
+    void *batch[BATCH_SIZE];
+
+    push_elements(queue, 1, 0, 3);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(prio_queue_pop_batch_ex(queue, batch, BATCH_SIZE), 3);
+    assert_ptr_equal(batch[0], &values[0]);
+    assert_ptr_equal(batch[2], &values[2]);
+    assert_int_equal(prio_queue_empty(queue), 1);
+}
+
+void test_prio_queue_idle_busy_batch(void **state) {
+    w_prio_queue_t *queue = *state;
+    void *batch[BATCH_SIZE];
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+    prio_queue_track_busy(queue);
+
+    push_elements(queue, 0, 0, 2);
+    push_elements(queue, 2, 2, 2);
+
+    expect_value(__wrap_pthread_mutex_lock, mutex, &queue->mutex);
+    expect_value(__wrap_pthread_mutex_unlock, mutex, &queue->mutex);
+
+    assert_int_equal(prio_queue_pop_batch_ex(queue, batch, BATCH_SIZE), 4);
+    assert_int_equal(prio_queue_empty(queue), 1);
+
+    // Empty, but the batch is still in process
+    expect_value_count(__wrap_pthread_mutex_lock, mutex, &queue->mutex, 3);
+    expect_value_count(__wrap_pthread_mutex_unlock, mutex, &queue->mutex, 3);
+
+    assert_int_equal(prio_queue_idle(queue), 0);
+    prio_queue_done(queue, 4);
+    assert_int_equal(prio_queue_idle(queue), 1);
+}
+
+/************************************************/
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_prio_queue_init, setup_prio_queue, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_init_disabled_classes, setup_prio_queue_normal_only, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_push_ex_disabled_class, setup_prio_queue_normal_only, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_push_ex_class_full, setup_prio_queue, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_pop_batch_ex_weighted, setup_prio_queue, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_pop_batch_ex_short, setup_prio_queue, teardown_prio_queue),
+        cmocka_unit_test_setup_teardown(test_prio_queue_idle_busy_batch, setup_prio_queue, teardown_prio_queue),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -21,6 +21,18 @@ extern time_t _get_next_time(const sched_scan_config *config, const char *MODULE
 extern int _sched_scan_validate_parameters(sched_scan_config *scan_config);
 extern time_t __real_time(time_t *_time);
 
+typedef struct {
+    time_t due;
+    unsigned long ticket;
+} sched_job_t;
+
+extern sched_job_t * sched_jobs_heap;
+extern unsigned int sched_jobs_pending;
+extern unsigned int sched_jobs_running;
+extern void _sched_jobs_push(const sched_job_t *job);
+extern void _sched_jobs_pop();
+extern unsigned int _sched_job_jitter(const char *MODULE_TAG);
+
 typedef struct test_structure {
     xml_node **nodes;
     sched_scan_config *scan_config;
@@ -695,6 +707,70 @@ void test_get_time_to_month_day_num_months(void **state) {
 }
 
 
+/* Scheduled jobs */
+
+void test_sched_jobs_heap_order(void **state) {
+    const sched_job_t jobs[] = { { 30, 0 }, { 10, 1 }, { 20, 2 }, { 10, 3 }, { 5, 4 } };
+    const unsigned long expected[] = { 4, 1, 3, 2, 0 };
+    unsigned int i;
+
+    for (i = 0; i < sizeof(jobs) / sizeof(jobs[0]); i++) {
+        _sched_jobs_push(&jobs[i]);
+    }
+
+    assert_int_equal(sched_jobs_pending, 5);
+
+    for (i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        assert_int_equal(sched_jobs_heap[0].ticket, expected[i]);
+        _sched_jobs_pop();
+    }
+
+    assert_int_equal(sched_jobs_pending, 0);
+    _sched_jobs_pop();
+    assert_int_equal(sched_jobs_pending, 0);
+}
+
+void test_sched_job_jitter(void **state) {
+    unsigned int jitter;
+
+    sched_scan_set_limits(0, 0, 0);
+    assert_int_equal(_sched_job_jitter("wazuh-modulesd:sca"), 0);
+
+    sched_scan_set_limits(0, 100, 0);
+    jitter = _sched_job_jitter("wazuh-modulesd:sca");
+    assert_true(jitter <= 100);
+    assert_int_equal(_sched_job_jitter("wazuh-modulesd:sca"), jitter);
+
+    sched_scan_set_limits(0, 0, 0);
+}
+
+void test_sched_scan_job_begin_end(void **state) {
+    sched_scan_config *scan_config = (sched_scan_config *) *state;
+
+    scan_config->next_scheduled_scan_time = 5;
+    sched_scan_set_limits(1, 0, 0);
+
+    sched_scan_job_begin(scan_config, "wazuh-modulesd:sca", false);
+    assert_int_equal(sched_jobs_running, 1);
+    assert_int_equal(sched_jobs_pending, 0);
+    assert_false(scan_config->jittered);
+
+    sched_scan_job_end();
+    assert_int_equal(sched_jobs_running, 0);
+
+    // Only the first scheduled run is delayed
+    sched_scan_job_begin(scan_config, "wazuh-modulesd:sca", true);
+    assert_true(scan_config->jittered);
+
+    sched_scan_job_end();
+    assert_int_equal(sched_jobs_running, 0);
+
+    sched_scan_job_end();
+    assert_int_equal(sched_jobs_running, 0);
+
+    sched_scan_set_limits(0, 0, 0);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_tag_successfull),
@@ -748,7 +824,11 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_get_time_to_month_day_same_month_day_positive_diff, test_get_time_setup, test_get_time_teardown),
         cmocka_unit_test_setup_teardown(test_get_time_to_month_day_same_month, test_get_time_setup, test_get_time_teardown),
         cmocka_unit_test_setup_teardown(test_get_time_to_month_day_high_num_months, test_get_time_setup, test_get_time_teardown),
-        cmocka_unit_test_setup_teardown(test_get_time_to_month_day_num_months, test_get_time_setup, test_get_time_teardown)
+        cmocka_unit_test_setup_teardown(test_get_time_to_month_day_num_months, test_get_time_setup, test_get_time_teardown),
+        /* Scheduled jobs tests */
+        cmocka_unit_test(test_sched_jobs_heap_order),
+        cmocka_unit_test(test_sched_job_jitter),
+        cmocka_unit_test_setup_teardown(test_sched_scan_job_begin_end, test_sched_scan_validate_setup, test_sched_scan_validate_teardown)
     };
     return cmocka_run_group_tests(tests, setup_group, teardown_group);
 }
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../headers/wazuhdb_bin.h"
+
+static cJSON * build_delta() {
+    cJSON * data = cJSON_CreateObject();
+    cJSON * array = cJSON_CreateArray();
+
+    cJSON_AddStringToObject(data, "name", "openssl");
+    cJSON_AddNumberToObject(data, "size", -123456789);
+    cJSON_AddNumberToObject(data, "ratio", 0.25);
+    cJSON_AddNullToObject(data, "vendor");
+    cJSON_AddItemToArray(array, cJSON_CreateTrue());
+    cJSON_AddItemToArray(array, cJSON_CreateString(""));
+    cJSON_AddItemToObject(data, "flags", array);
+    cJSON_AddStringToObject(data, "checksum", "d41d8cd98f00b204e9800998ecf8427e");
+
+    return data;
+}
+
+// Tests
+
+void test_wdb_bin_is_binary(void **state)
+{
+    char message[] = { WDB_BIN_MAGIC, WDB_BIN_VERSION, WDB_BIN_DBSYNC };
+
+    assert_true(wdb_bin_is_binary(message, sizeof(message)));
+    assert_false(wdb_bin_is_binary(message, 2));
+    assert_false(wdb_bin_is_binary("agent 001 dbsync", 17));
+    assert_int_equal(wdb_bin_get_command(message), WDB_BIN_DBSYNC);
+
+    message[1] = WDB_BIN_VERSION + 1;
+    assert_int_equal(wdb_bin_get_command(message), OS_INVALID);
+}
+
+void test_wdb_bin_dbsync_roundtrip(void **state)
+{
+    char buffer[OS_SIZE_1024];
+    char copy[OS_SIZE_1024];
+    wdb_bin_dbsync_t msg;
+    cJSON * data = build_delta();
+
+    ssize_t length = wdb_bin_encode_dbsync(buffer, sizeof(buffer) - 1, 1, "packages", "INSERTED", data);
+    assert_true(length > 0);
+    assert_true(wdb_bin_is_binary(buffer, length));
+    memcpy(copy, buffer, length);
+
+    assert_int_equal(wdb_bin_decode_dbsync(buffer, length, &msg), OS_SUCCESS);
+
+    // The message is restored after decoding
+    assert_memory_equal(buffer, copy, length);
+
+    assert_int_equal(msg.agent_id, 1);
+    assert_string_equal(msg.table, "packages");
+    assert_string_equal(msg.operation, "INSERTED");
+    assert_true(cJSON_Compare(msg.data, data, true));
+
+    cJSON_Delete(msg.data);
+    cJSON_Delete(data);
+}
+
+void test_wdb_bin_dbsync_truncated(void **state)
+{
+    char buffer[OS_SIZE_1024];
+    wdb_bin_dbsync_t msg;
+    cJSON * data = build_delta();
+
+    ssize_t length = wdb_bin_encode_dbsync(buffer, sizeof(buffer) - 1, 1, "packages", "INSERTED", data);
+    assert_true(length > 0);
+
+    for (ssize_t i = WDB_BIN_HEADER_SIZE; i < length; i++) {
+        assert_int_equal(wdb_bin_decode_dbsync(buffer, i, &msg), OS_INVALID);
+        assert_null(msg.data);
+    }
+
+    cJSON_Delete(data);
+}
+
+void test_wdb_bin_dbsync_buffer_too_small(void **state)
+{
+    char buffer[32];
+    cJSON * data = build_delta();
+
+    assert_int_equal(wdb_bin_encode_dbsync(buffer, sizeof(buffer), 1, "packages", "INSERTED", data), OS_INVALID);
+
+    cJSON_Delete(data);
+}
+
+void test_wdb_bin_dbsync_not_object(void **state)
+{
+    char buffer[OS_SIZE_256];
+    wdb_bin_dbsync_t msg;
+    cJSON * data = cJSON_CreateString("value");
+
+    ssize_t length = wdb_bin_encode_dbsync(buffer, sizeof(buffer) - 1, 1, "osinfo", "MODIFIED", data);
+    assert_true(length > 0);
+
+    assert_int_equal(wdb_bin_decode_dbsync(buffer, length, &msg), OS_INVALID);
+    assert_null(msg.data);
+
+    cJSON_Delete(data);
+}
+
+void test_wdb_bin_json_max_depth(void **state)
+{
+    char buffer[OS_SIZE_256];
+    cJSON * data = cJSON_CreateArray();
+    cJSON * value = NULL;
+
+    for (int i = 0; i <= WDB_BIN_MAX_DEPTH; i++) {
+        cJSON * array = cJSON_CreateArray();
+        cJSON_AddItemToArray(array, data);
+        data = array;
+    }
+
+    ssize_t length = wdb_bin_encode_json(buffer, sizeof(buffer) - 1, data);
+    assert_true(length > 0);
+
+    assert_int_equal(wdb_bin_decode_json(buffer, length, &value), OS_INVALID);
+    assert_null(value);
+
+    cJSON_Delete(data);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_wdb_bin_is_binary),
+        cmocka_unit_test(test_wdb_bin_dbsync_roundtrip),
+        cmocka_unit_test(test_wdb_bin_dbsync_truncated),
+        cmocka_unit_test(test_wdb_bin_dbsync_buffer_too_small),
+        cmocka_unit_test(test_wdb_bin_dbsync_not_object),
+        cmocka_unit_test(test_wdb_bin_json_max_depth),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
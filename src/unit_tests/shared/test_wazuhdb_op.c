@@ -129,12 +129,199 @@ void test_err_query(void **state)
     assert_int_equal(wdbc_parse_result(response, &message), WDBC_ERROR);
 }
 
+void test_pipelined_query(void **state)
+{
+    int wdb_sock = -1;
+    char *query1 = "agent 000 syscheck delete /tmp/test.file";
+    char *query2 = "agent 000 syscheck delete /tmp/test2.file";
+    char response[OS_SIZE_6144];
+    char *message;
+
+    expect_string(__wrap_OS_ConnectUnixDomain, path, WDB_LOCAL_SOCK);
+    expect_value(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM);
+    expect_value(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_SIZE_6144);
+    will_return(__wrap_OS_ConnectUnixDomain, 65555);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query1) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query1);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query2) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query2);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    assert_int_equal(wdbc_send_ex(&wdb_sock, query1), 0);
+    assert_int_equal(wdbc_send_ex(&wdb_sock, query2), 0);
+    assert_int_equal(wdb_sock, 65555);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_SIZE_6144);
+    will_return(__wrap_OS_RecvSecureTCP, "ok");
+    will_return(__wrap_OS_RecvSecureTCP, 2);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_SIZE_6144);
+    will_return(__wrap_OS_RecvSecureTCP, "err Agent not found");
+    will_return(__wrap_OS_RecvSecureTCP, 19);
+
+    assert_int_equal(wdbc_recv(wdb_sock, response, OS_SIZE_6144), 0);
+    assert_int_equal(wdbc_parse_result(response, &message), WDBC_OK);
+    assert_int_equal(wdbc_recv(wdb_sock, response, OS_SIZE_6144), 0);
+    assert_int_equal(wdbc_parse_result(response, &message), WDBC_ERROR);
+    assert_string_equal(message, "Agent not found");
+}
+
+void test_recv_closed(void **state)
+{
+    char response[OS_SIZE_6144];
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_SIZE_6144);
+    will_return(__wrap_OS_RecvSecureTCP, "");
+    will_return(__wrap_OS_RecvSecureTCP, 0);
+
+    assert_int_equal(wdbc_recv(65555, response, OS_SIZE_6144), -1);
+}
+
+void test_pipeline_send_full(void **state)
+{
+    int wdb_sock = 65555;
+    char *query = "agent 000 syscheck delete /tmp/test.file";
+    wdbc_pipeline pipeline = { .name = "test", .size = 2, .pending = 2 };
+
+    // The oldest response is read to make room
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR);
+    will_return(__wrap_OS_RecvSecureTCP, "ok");
+    will_return(__wrap_OS_RecvSecureTCP, 2);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    assert_int_equal(wdbc_pipeline_send(&wdb_sock, &pipeline, query), 0);
+    assert_int_equal(pipeline.pending, 2);
+    assert_int_equal(pipeline.dropped, 0);
+}
+
+void test_pipeline_send_reconnect(void **state)
+{
+    int wdb_sock = 65555;
+    char *query = "agent 000 syscheck delete /tmp/test.file";
+    wdbc_pipeline pipeline = { .name = "test", .size = 64, .pending = 3 };
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, -1);
+
+    expect_string(__wrap_OS_ConnectUnixDomain, path, WDB_LOCAL_SOCK);
+    expect_value(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM);
+    expect_value(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_SIZE_6144);
+    will_return(__wrap_OS_ConnectUnixDomain, 65556);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65556);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    // The responses of the lost connection are dropped
+    assert_int_equal(wdbc_pipeline_send(&wdb_sock, &pipeline, query), 3);
+    assert_int_equal(wdb_sock, 65556);
+    assert_int_equal(pipeline.pending, 1);
+    assert_int_equal(pipeline.dropped, 3);
+}
+
+void test_pipeline_send_error(void **state)
+{
+    int wdb_sock = 65555;
+    char *query = "agent 000 syscheck delete /tmp/test.file";
+    wdbc_pipeline pipeline = { .name = "test", .size = 64, .pending = 1 };
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, -1);
+
+    expect_string(__wrap_OS_ConnectUnixDomain, path, WDB_LOCAL_SOCK);
+    expect_value(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM);
+    expect_value(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_SIZE_6144);
+    will_return(__wrap_OS_ConnectUnixDomain, 65556);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 65556);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(query) + 1);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, -1);
+
+    assert_int_equal(wdbc_pipeline_send(&wdb_sock, &pipeline, query), 2);
+    assert_int_equal(wdb_sock, -1);
+    assert_int_equal(pipeline.pending, 0);
+    assert_int_equal(pipeline.dropped, 1);
+}
+
+void test_pipeline_recv_errors(void **state)
+{
+    int wdb_sock = 65555;
+    wdbc_pipeline pipeline = { .name = "test", .size = 64, .pending = 3 };
+
+    expect_value_count(__wrap_OS_RecvSecureTCP, sock, 65555, 3);
+    expect_value_count(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR, 3);
+    will_return(__wrap_OS_RecvSecureTCP, "ok");
+    will_return(__wrap_OS_RecvSecureTCP, 2);
+    will_return(__wrap_OS_RecvSecureTCP, "err Agent not found");
+    will_return(__wrap_OS_RecvSecureTCP, 19);
+    will_return(__wrap_OS_RecvSecureTCP, "err Cannot execute query");
+    will_return(__wrap_OS_RecvSecureTCP, 24);
+
+    // Only the last one is a failure
+    assert_int_equal(wdbc_pipeline_recv(&wdb_sock, &pipeline, 0), 1);
+    assert_int_equal(wdb_sock, 65555);
+    assert_int_equal(pipeline.pending, 0);
+    assert_int_equal(pipeline.dropped, 0);
+}
+
+void test_pipeline_recv_keep(void **state)
+{
+    int wdb_sock = 65555;
+    wdbc_pipeline pipeline = { .name = "test", .size = 64, .pending = 1 };
+
+    assert_int_equal(wdbc_pipeline_recv(&wdb_sock, &pipeline, 1), 0);
+    assert_int_equal(pipeline.pending, 1);
+}
+
+void test_pipeline_recv_closed(void **state)
+{
+    int wdb_sock = 65555;
+    wdbc_pipeline pipeline = { .name = "test", .size = 64, .pending = 2 };
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 65555);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR);
+    will_return(__wrap_OS_RecvSecureTCP, "");
+    will_return(__wrap_OS_RecvSecureTCP, 0);
+
+    assert_int_equal(wdbc_pipeline_recv(&wdb_sock, &pipeline, 0), 2);
+    assert_int_equal(wdb_sock, -1);
+    assert_int_equal(pipeline.pending, 0);
+    assert_int_equal(pipeline.dropped, 2);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_ok_query),
         cmocka_unit_test(test_ok2_query),
         cmocka_unit_test(test_okmsg_query),
         cmocka_unit_test(test_err_query),
+        cmocka_unit_test(test_pipelined_query),
+        cmocka_unit_test(test_recv_closed),
+        cmocka_unit_test(test_pipeline_send_full),
+        cmocka_unit_test(test_pipeline_send_reconnect),
+        cmocka_unit_test(test_pipeline_send_error),
+        cmocka_unit_test(test_pipeline_recv_errors),
+        cmocka_unit_test(test_pipeline_recv_keep),
+        cmocka_unit_test(test_pipeline_recv_closed),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -802,6 +802,62 @@ static void test_fim_registry_scan_regular_scan(void **state) {
     fim_registry_scan();
 }
 
+static void test_fim_registry_scan_reuse_unchanged_values(void **state) {
+    syscheck.registry = one_entry_config;
+    syscheck.registry[0].opts = CHECK_REGISTRY_ALL;
+    syscheck.skip_unchanged_hash = 1;
+    // The bucket of FirstSubKey isn't verified in this scan.
+    syscheck.hash_verify_scans = 7;
+
+    TXN_HANDLE mock_handle;
+    LPSTR usid = "userid";
+    LPSTR gsid = "groupid";
+    FILETIME last_write_time = { 0, 1000 };
+    fim_registry_key stored_key = { .mtime = get_windows_file_time_epoch(last_write_time) };
+    fim_entry stored = { .type = FIM_TYPE_REGISTRY, .registry_entry.key = &stored_key };
+
+    will_return(__wrap_fim_db_transaction_start, mock_handle);
+    will_return(__wrap_fim_db_transaction_start, mock_handle);
+    expect_string(__wrap__mdebug1, formatted_msg, FIM_WINREGISTRY_START);
+    expect_any_always(__wrap__mdebug2, formatted_msg);
+
+    expect_RegOpenKeyEx_call(HKEY_LOCAL_MACHINE, "Software\\Classes\\batfile", 0, KEY_READ | KEY_WOW64_64KEY, NULL,
+                             ERROR_SUCCESS);
+    expect_RegQueryInfoKey_call(1, 0, &last_write_time, ERROR_SUCCESS);
+    expect_RegEnumKeyEx_call("FirstSubKey", 12, ERROR_SUCCESS);
+
+    expect_RegOpenKeyEx_call(HKEY_LOCAL_MACHINE, "Software\\Classes\\batfile\\FirstSubKey", 0,
+                             KEY_READ | KEY_WOW64_64KEY, NULL, ERROR_SUCCESS);
+    expect_RegQueryInfoKey_call(0, 1, &last_write_time, ERROR_SUCCESS);
+
+    expect_fim_registry_get_key_data_call(usid, gsid, "username", "groupname",
+                                          "sid (allowed): delete|write_dac|write_data|append_data|write_attributes",
+                                          last_write_time);
+
+    // The last write time matches the stored one, so the values aren't read.
+    expect_fim_db_get_registry_key("HKEY_LOCAL_MACHINE\\Software\\Classes\\batfile\\FirstSubKey", ARCH_64BIT, &stored,
+                                   FIMDB_OK);
+    expect_fim_db_get_registry_key_values("HKEY_LOCAL_MACHINE\\Software\\Classes\\batfile\\FirstSubKey", ARCH_64BIT,
+                                          FIMDB_OK);
+    will_return(__wrap_fim_db_transaction_sync_row, 0);
+
+    expect_fim_registry_get_key_data_call(usid, gsid, "username", "groupname",
+                                          "sid (allowed): delete|write_dac|write_data|append_data|write_attributes",
+                                          last_write_time);
+    will_return(__wrap_fim_db_transaction_sync_row, 0);
+
+    expect_function_call(__wrap_fim_db_transaction_deleted_rows);
+    expect_function_call(__wrap_fim_db_transaction_deleted_rows);
+    expect_string(__wrap__mdebug1, formatted_msg, FIM_WINREGISTRY_ENDED);
+    expect_string(__wrap__minfo, formatted_msg,
+                  "(6048): Registry keys whose values were read: 0. Unchanged keys whose stored values were reused: 1.");
+
+    fim_registry_scan();
+
+    syscheck.skip_unchanged_hash = 0;
+    syscheck.hash_verify_scans = 0;
+}
+
 static void test_fim_registry_scan_RegOpenKeyEx_fail(void **state) {
     syscheck.registry = one_entry_config;
     syscheck.registry[0].opts = CHECK_REGISTRY_ALL;
@@ -1157,6 +1213,7 @@ int main(void) {
         /* fim_registry_scan tests */
         cmocka_unit_test(test_fim_registry_scan_base_line_generation),
         cmocka_unit_test(test_fim_registry_scan_regular_scan),
+        cmocka_unit_test(test_fim_registry_scan_reuse_unchanged_values),
         cmocka_unit_test(test_fim_registry_scan_RegOpenKeyEx_fail),
         cmocka_unit_test(test_fim_registry_scan_RegQueryInfoKey_fail),
 
@@ -298,15 +298,19 @@ void test_getSyscheckConfig(void **state)
 
     cJSON *sys_items = cJSON_GetObjectItem(ret, "syscheck");
     #if defined(TEST_SERVER) || defined(TEST_AGENT)
-    assert_int_equal(cJSON_GetArraySize(sys_items), 21);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 23);
     #elif defined(TEST_WINAGENT)
-    assert_int_equal(cJSON_GetArraySize(sys_items), 29);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 31);
     #endif
 
     cJSON *disabled = cJSON_GetObjectItem(sys_items, "disabled");
     assert_string_equal(cJSON_GetStringValue(disabled), "no");
     cJSON *frequency = cJSON_GetObjectItem(sys_items, "frequency");
     assert_int_equal(frequency->valueint, 43200);
+    cJSON *skip_unchanged_hash = cJSON_GetObjectItem(sys_items, "skip_unchanged_hash");
+    assert_string_equal(cJSON_GetStringValue(skip_unchanged_hash), "no");
+    cJSON *hash_verify_scans = cJSON_GetObjectItem(sys_items, "hash_verify_scans");
+    assert_int_equal(hash_verify_scans->valueint, 7);
 
     cJSON *db_file_entry_limit = cJSON_GetObjectItem(sys_items, "file_limit");
     cJSON *db_file_entry_limit_enabled = cJSON_GetObjectItem(db_file_entry_limit, "enabled");
@@ -434,9 +438,9 @@ void test_getSyscheckConfig_no_audit(void **state)
 
     cJSON *sys_items = cJSON_GetObjectItem(ret, "syscheck");
     #ifndef TEST_WINAGENT
-    assert_int_equal(cJSON_GetArraySize(sys_items), 17);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 19);
     #else
-    assert_int_equal(cJSON_GetArraySize(sys_items), 21);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 23);
     #endif
 
     cJSON *disabled = cJSON_GetObjectItem(sys_items, "disabled");
@@ -561,7 +565,7 @@ void test_getSyscheckConfig_no_directories(void **state)
     assert_int_equal(cJSON_GetArraySize(ret), 1);
 
     cJSON *sys_items = cJSON_GetObjectItem(ret, "syscheck");
-    assert_int_equal(cJSON_GetArraySize(sys_items), 18);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 20);
     cJSON *disabled = cJSON_GetObjectItem(sys_items, "disabled");
     assert_string_equal(cJSON_GetStringValue(disabled), "yes");
     cJSON *frequency = cJSON_GetObjectItem(sys_items, "frequency");
@@ -675,7 +679,7 @@ void test_getSyscheckInternalOptions(void **state)
     cJSON *items = cJSON_GetObjectItem(ret, "internal");
     assert_int_equal(cJSON_GetArraySize(items), 2);
     cJSON *sys_items = cJSON_GetObjectItem(items, "syscheck");
-    assert_int_equal(cJSON_GetArraySize(sys_items), 6);
+    assert_int_equal(cJSON_GetArraySize(sys_items), 7);
     cJSON *root_items = cJSON_GetObjectItem(items, "rootcheck");
     assert_int_equal(cJSON_GetArraySize(root_items), 1);
 }
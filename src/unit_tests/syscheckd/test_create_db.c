@@ -51,6 +51,10 @@ void fim_db_remove_entry(void * data, void * ctx);
 void process_delete_event(void * data, void * ctx);
 void fim_db_process_missing_entry(void * data, void * ctx);
 void dbsync_attributes_json(const cJSON *dbsync_event, const directory_t *configuration, cJSON *attributes);
+bool fim_scan_push_job(fim_scan_worker_t *worker, const char *path, const directory_t *configuration);
+bool fim_scan_take_job(fim_scan_worker_t *worker, fim_scan_job_t *job);
+void *fim_scan_worker_main(void *args);
+void fim_scan_parallel(TXN_HANDLE txn_handle, fim_txn_context_t *txn_ctx);
 
 /* auxiliary structs */
 typedef struct __fim_data_s {
@@ -3138,6 +3142,70 @@ static void test_fim_get_data(void **state) {
     assert_string_equal(fim_data->local_data->hash_sha256, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
 }
 
+static void test_fim_get_data_reusing_hashes(void **state) {
+    fim_data_t *fim_data = *state;
+    directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP |
+                                             CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM };
+    struct stat statbuf = { .st_mode = S_IFREG | 00444,
+                            .st_size = 1000,
+                            .st_uid = 0,
+                            .st_gid = 0,
+                            .st_ino = 1234,
+                            .st_dev = 2345,
+                            .st_mtime = 3456 };
+    fim_file_data stored = { .size = 1000,
+#ifndef TEST_WINAGENT
+                             .mtime = 3456,
+#else
+                             .mtime = 123456,
+#endif
+                             .inode = 1234,
+                             .dev = 2345,
+                             .options = configuration.options,
+                             .hash_md5 = "d41d8cd98f00b204e9800998ecf8427e",
+                             .hash_sha1 = "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                             .hash_sha256 = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" };
+    bool hashes_reused = false;
+
+    // No hash calculation is expected.
+    expect_get_data(strdup("user"), strdup("group"), "test", 0);
+    fim_data->local_data = fim_get_data_reusing_hashes("test", &configuration, &statbuf, &stored, &hashes_reused);
+
+    assert_true(hashes_reused);
+    assert_string_equal(fim_data->local_data->hash_md5, "d41d8cd98f00b204e9800998ecf8427e");
+    assert_string_equal(fim_data->local_data->hash_sha1, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    assert_string_equal(fim_data->local_data->hash_sha256, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+static void test_fim_get_data_reusing_hashes_size_changed(void **state) {
+    fim_data_t *fim_data = *state;
+    directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP |
+                                             CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM };
+    struct stat statbuf = { .st_mode = S_IFREG | 00444,
+                            .st_size = 1000,
+                            .st_uid = 0,
+                            .st_gid = 0,
+                            .st_ino = 1234,
+                            .st_dev = 2345,
+                            .st_mtime = 3456 };
+    fim_file_data stored = { .size = 999,
+#ifndef TEST_WINAGENT
+                             .mtime = 3456,
+#else
+                             .mtime = 123456,
+#endif
+                             .inode = 1234,
+                             .dev = 2345,
+                             .options = configuration.options };
+    bool hashes_reused = true;
+
+    expect_get_data(strdup("user"), strdup("group"), "test", 1);
+    fim_data->local_data = fim_get_data_reusing_hashes("test", &configuration, &statbuf, &stored, &hashes_reused);
+
+    assert_false(hashes_reused);
+    assert_string_equal(fim_data->local_data->hash_md5, "d41d8cd98f00b204e9800998ecf8427e");
+}
+
 static void test_fim_get_data_no_hashes(void **state) {
     fim_data_t *fim_data = *state;
     directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP };
@@ -3469,7 +3537,7 @@ void test_fim_process_missing_entry(void **state){
 #endif
 
     char pattern[PATH_MAX] = {0};
-    snprintf(pattern, PATH_MAX, "%s%c%%", fim_data->w_evt->path, PATH_SEP);
+    snprintf(pattern, PATH_MAX, "%s%c", fim_data->w_evt->path, PATH_SEP);
 
 #ifndef TEST_WINAGENT
     expect_function_call_any(__wrap_pthread_rwlock_wrlock);
@@ -3487,8 +3555,8 @@ void test_fim_process_missing_entry(void **state){
 
     expect_string(__wrap_fim_db_get_path, file_path, fim_data->w_evt->path);
     will_return(__wrap_fim_db_get_path, FIMDB_ERR);
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, pattern);
-    will_return(__wrap_fim_db_file_pattern_search, FIMDB_OK);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, pattern);
+    will_return(__wrap_fim_db_file_prefix_search, FIMDB_OK);
 
     fim_process_missing_entry(fim_data->w_evt->path, FIM_SCHEDULED, fim_data->w_evt);
 }
@@ -3501,9 +3569,9 @@ static void test_fim_process_wildcard_removed_no_data(void **state) {
     directory_t *directory0 = OSList_GetFirstNode(removed_entries)->data;
 
     char buff[OS_SIZE_128] = {0};
-    snprintf(buff, OS_SIZE_128, "%s%c%%", directory0->path, PATH_SEP);
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, buff);
-    will_return(__wrap_fim_db_file_pattern_search, FIMDB_OK);
+    snprintf(buff, OS_SIZE_128, "%s%c", directory0->path, PATH_SEP);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, buff);
+    will_return(__wrap_fim_db_file_prefix_search, FIMDB_OK);
 
     expect_string(__wrap_fim_db_get_path, file_path, directory0->path);
     will_return(__wrap_fim_db_get_path, NULL);
@@ -3523,9 +3591,9 @@ static void test_fim_process_wildcard_removed_failure(void **state) {
 
     char buff[OS_SIZE_128] = {0};
 
-    snprintf(buff, OS_SIZE_128, "%s%c%%", directory0->path, PATH_SEP);
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, buff);
-    will_return(__wrap_fim_db_file_pattern_search, FIMDB_OK);
+    snprintf(buff, OS_SIZE_128, "%s%c", directory0->path, PATH_SEP);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, buff);
+    will_return(__wrap_fim_db_file_prefix_search, FIMDB_OK);
     expect_string(__wrap_fim_db_get_path, file_path, directory0->path);
     will_return(__wrap_fim_db_get_path, NULL);
 
@@ -3564,9 +3632,9 @@ static void test_fim_process_wildcard_removed_data_exists(void **state) {
     fim_data->local_data->options = 511;
     strcpy(fim_data->local_data->checksum, "");
     char pattern[100];
-    snprintf(pattern, PATH_MAX, "%s%c%%", directory0->path, PATH_SEP);
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, pattern);
-    will_return(__wrap_fim_db_file_pattern_search, FIMDB_OK);
+    snprintf(pattern, PATH_MAX, "%s%c", directory0->path, PATH_SEP);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, pattern);
+    will_return(__wrap_fim_db_file_prefix_search, FIMDB_OK);
     expect_string(__wrap_fim_db_get_path, file_path, directory0->path);
     will_return(__wrap_fim_db_get_path, fim_data->fentry);
 
@@ -3596,6 +3664,366 @@ void test_fim_diff_folder_size(void **state) {
     }
 }
 
+static void expect_fim_diff_folder_size_walk(float size) {
+    expect_string(__wrap_IsDir, file, "queue/diff/local");
+    will_return(__wrap_IsDir, 0);
+
+    expect_string(__wrap_DirSize, path, "queue/diff/local");
+    will_return(__wrap_DirSize, size * 1024);
+}
+
+static void test_fim_diff_folder_size_refresh_every_scan(void **state) {
+    syscheck.diff_size_reconcile = 1;
+
+    expect_fim_diff_folder_size_walk(20);
+    fim_diff_folder_size_refresh(2);
+
+    assert_int_equal(syscheck.diff_folder_size, 20);
+}
+
+static void test_fim_diff_folder_size_refresh_first_scan_not_saved(void **state) {
+    syscheck.diff_size_reconcile = 10;
+
+    expect_fim_diff_folder_size_walk(30);
+    fim_diff_folder_size_refresh(1);
+
+    assert_int_equal(syscheck.diff_folder_size, 30);
+    syscheck.diff_size_reconcile = 1;
+}
+
+static void test_fim_diff_folder_size_refresh_running_total(void **state) {
+    syscheck.diff_size_reconcile = 10;
+    syscheck.diff_folder_size = 40;
+
+    // No walk between two reconciliations
+    fim_diff_folder_size_refresh(5);
+
+    assert_int_equal(syscheck.diff_folder_size, 40);
+    syscheck.diff_size_reconcile = 1;
+}
+
+static void test_fim_diff_folder_size_refresh_reconcile(void **state) {
+    syscheck.diff_size_reconcile = 10;
+    syscheck.diff_folder_size = 40;
+
+    expect_fim_diff_folder_size_walk(35);
+    fim_diff_folder_size_refresh(11);
+
+    assert_int_equal(syscheck.diff_folder_size, 35);
+    syscheck.diff_size_reconcile = 1;
+}
+
+static void test_fim_diff_folder_size_reconcile(void **state) {
+    char debug_msg[OS_SIZE_256];
+
+    syscheck.diff_folder_size = 40;
+
+    snprintf(debug_msg, OS_SIZE_256, FIM_DIFF_FOLDER_SIZE, DIFF_DIR, 35.0);
+
+    expect_fim_diff_folder_size_walk(35);
+    expect_string(__wrap__mdebug2, formatted_msg, debug_msg);
+
+    fim_diff_folder_size_reconcile(NULL);
+
+    assert_int_equal(syscheck.diff_folder_size, 35);
+}
+
+static void test_fim_diff_folder_size_reconcile_no_folder(void **state) {
+    syscheck.diff_folder_size = 40;
+
+    expect_string(__wrap_IsDir, file, "queue/diff/local");
+    will_return(__wrap_IsDir, -1);
+
+    fim_diff_folder_size_reconcile(NULL);
+
+    assert_int_equal(syscheck.diff_folder_size, 40);
+}
+
+#ifndef TEST_WINAGENT
+typedef struct scan_pool_data_s {
+    fim_scan_pool_t pool;
+    OSList *directories;
+    OSList *saved_directories;
+    unsigned int saved_scan_threads;
+} scan_pool_data_t;
+
+static const char *SCAN_POOL_PATHS[] = { "/scan/dir0", "/scan/dir1", "/scan/dir2" };
+
+static int setup_scan_pool(void **state) {
+    scan_pool_data_t *data;
+    unsigned int i;
+
+    os_calloc(1, sizeof(scan_pool_data_t), data);
+
+    data->directories = OSList_Create();
+    if (data->directories == NULL) {
+        return -1;
+    }
+    OSList_SetFreeDataPointer(data->directories, (void (*)(void *))free_directory);
+
+    for (i = 0; i < 3; i++) {
+        OSList_InsertData(data->directories, NULL, fim_create_directory(SCAN_POOL_PATHS[i], 0, NULL, 512, NULL, 1024, 0));
+    }
+
+    data->saved_directories = syscheck.directories;
+    data->saved_scan_threads = syscheck.scan_threads;
+    syscheck.directories = data->directories;
+
+    data->pool.size = 2;
+    pthread_mutex_init(&data->pool.mutex, NULL);
+    pthread_cond_init(&data->pool.available, NULL);
+    data->pool.results = queue_init(FIM_SCAN_RESULT_QUEUE_SIZE);
+    os_calloc(data->pool.size, sizeof(fim_scan_worker_t), data->pool.workers);
+
+    for (i = 0; i < data->pool.size; i++) {
+        data->pool.workers[i].pool = &data->pool;
+        data->pool.workers[i].id = i;
+        os_calloc(FIM_SCAN_DEQUE_SIZE, sizeof(fim_scan_job_t), data->pool.workers[i].jobs);
+    }
+
+    *state = data;
+    return 0;
+}
+
+static int teardown_scan_pool(void **state) {
+    scan_pool_data_t *data = *state;
+    fim_scan_worker_t *worker;
+    unsigned int i;
+
+    for (i = 0; i < data->pool.size; i++) {
+        worker = &data->pool.workers[i];
+
+        while (worker->count > 0) {
+            os_free(worker->jobs[worker->begin].path);
+            worker->begin = (worker->begin + 1) % FIM_SCAN_DEQUE_SIZE;
+            worker->count--;
+        }
+
+        os_free(worker->jobs);
+    }
+
+    os_free(data->pool.workers);
+    queue_free(data->pool.results);
+    pthread_cond_destroy(&data->pool.available);
+    pthread_mutex_destroy(&data->pool.mutex);
+
+    syscheck.directories = data->saved_directories;
+    syscheck.scan_threads = data->saved_scan_threads;
+    OSList_Destroy(data->directories);
+    os_free(data);
+
+    return 0;
+}
+
+// Scanning a configured directory ends at HasFilesystem, so the worker only walks the given paths.
+static void expect_scan_pool_skipped_path(const char *path) {
+    static struct stat statbuf = { .st_mode = S_IFDIR };
+
+    expect_string(__wrap_lstat, filename, path);
+    will_return(__wrap_lstat, &statbuf);
+    will_return(__wrap_lstat, 0);
+
+    expect_string(__wrap_HasFilesystem, path, path);
+    will_return(__wrap_HasFilesystem, 1);
+}
+
+static void test_fim_scan_push_job(void **state) {
+    scan_pool_data_t *data = *state;
+    fim_scan_worker_t *worker = &data->pool.workers[1];
+    directory_t *configuration = OSList_GetFirstNode(data->directories)->data;
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+
+    assert_true(fim_scan_push_job(worker, "/scan/dir0/file", configuration));
+
+    assert_int_equal(worker->count, 1);
+    assert_int_equal(data->pool.pending, 1);
+    assert_string_equal(worker->jobs[0].path, "/scan/dir0/file");
+    assert_ptr_equal(worker->jobs[0].configuration, configuration);
+    assert_int_equal(data->pool.workers[0].count, 0);
+}
+
+static void test_fim_scan_push_job_full(void **state) {
+    scan_pool_data_t *data = *state;
+    fim_scan_worker_t *worker = &data->pool.workers[0];
+    directory_t *configuration = OSList_GetFirstNode(data->directories)->data;
+    unsigned int i;
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+
+    for (i = 0; i < FIM_SCAN_DEQUE_SIZE; i++) {
+        assert_true(fim_scan_push_job(worker, "/scan/dir0/file", configuration));
+    }
+
+    // The caller processes the path itself
+    assert_false(fim_scan_push_job(worker, "/scan/dir0/other", configuration));
+
+    assert_int_equal(worker->count, FIM_SCAN_DEQUE_SIZE);
+    assert_int_equal(data->pool.pending, FIM_SCAN_DEQUE_SIZE);
+}
+
+static void test_fim_scan_take_job(void **state) {
+    scan_pool_data_t *data = *state;
+    fim_scan_worker_t *worker = &data->pool.workers[0];
+    fim_scan_worker_t *victim = &data->pool.workers[1];
+    fim_scan_job_t job;
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+
+    assert_true(fim_scan_push_job(worker, "/scan/dir0/a", NULL));
+    assert_true(fim_scan_push_job(worker, "/scan/dir0/b", NULL));
+    assert_true(fim_scan_push_job(victim, "/scan/dir1/a", NULL));
+    assert_true(fim_scan_push_job(victim, "/scan/dir1/b", NULL));
+
+    // The own deque is taken newest first
+    assert_true(fim_scan_take_job(worker, &job));
+    assert_string_equal(job.path, "/scan/dir0/b");
+    os_free(job.path);
+
+    assert_true(fim_scan_take_job(worker, &job));
+    assert_string_equal(job.path, "/scan/dir0/a");
+    os_free(job.path);
+
+    // Then the oldest job of another worker is stolen
+    assert_true(fim_scan_take_job(worker, &job));
+    assert_string_equal(job.path, "/scan/dir1/a");
+    os_free(job.path);
+
+    assert_int_equal(victim->count, 1);
+    assert_int_equal(victim->begin, 1);
+
+    assert_true(fim_scan_take_job(worker, &job));
+    assert_string_equal(job.path, "/scan/dir1/b");
+    os_free(job.path);
+
+    assert_false(fim_scan_take_job(worker, &job));
+
+    // Taking a job doesn't finish it
+    assert_int_equal(data->pool.pending, 4);
+}
+
+static void test_fim_scan_worker_main(void **state) {
+    scan_pool_data_t *data = *state;
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+    expect_function_call_any(__wrap_pthread_rwlock_rdlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    assert_true(fim_scan_push_job(&data->pool.workers[0], SCAN_POOL_PATHS[0], NULL));
+    assert_true(fim_scan_push_job(&data->pool.workers[0], SCAN_POOL_PATHS[2], NULL));
+    assert_true(fim_scan_push_job(&data->pool.workers[1], SCAN_POOL_PATHS[1], NULL));
+
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[2]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[0]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[1]);
+
+    data->pool.running = 1;
+
+    assert_null(fim_scan_worker_main(&data->pool.workers[0]));
+
+    assert_int_equal(data->pool.pending, 0);
+    assert_int_equal(data->pool.running, 0);
+    assert_int_equal(data->pool.workers[1].count, 0);
+
+    // The last worker stops the writer
+    assert_false(queue_empty(data->pool.results));
+    assert_ptr_equal(queue_pop_ex(data->pool.results), &data->pool.finished);
+}
+
+static void test_fim_scan_worker_main_not_last(void **state) {
+    scan_pool_data_t *data = *state;
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+
+    data->pool.running = 2;
+
+    assert_null(fim_scan_worker_main(&data->pool.workers[1]));
+
+    assert_int_equal(data->pool.running, 1);
+    assert_true(queue_empty(data->pool.results));
+}
+
+static void test_fim_scan_parallel(void **state) {
+    event_data_t evt_data = { .report_event = true, .mode = FIM_SCHEDULED, .w_evt = NULL };
+    fim_txn_context_t txn_ctx = { .evt_data = &evt_data };
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+    expect_function_call_any(__wrap_pthread_rwlock_rdlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    syscheck.scan_threads = 2;
+
+    // The directories are dealt round robin, the first worker runs alone and steals the job of the second one
+    will_return(__wrap_pthread_create, 0);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[2]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[0]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[1]);
+    will_return(__wrap_pthread_create, 0);
+
+    expect_function_calls(__wrap_pthread_join, 2);
+
+    fim_scan_parallel(NULL, &txn_ctx);
+}
+
+static void test_fim_scan_parallel_thread_error(void **state) {
+    event_data_t evt_data = { .report_event = true, .mode = FIM_SCHEDULED, .w_evt = NULL };
+    fim_txn_context_t txn_ctx = { .evt_data = &evt_data };
+    char error_msg[OS_SIZE_256];
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+    expect_function_call_any(__wrap_pthread_rwlock_rdlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    syscheck.scan_threads = 2;
+
+    snprintf(error_msg, OS_SIZE_256, FIM_ERROR_SCAN_THREAD, strerror(EAGAIN));
+
+    // The second worker can't start, the writer must still be stopped by the first one
+    will_return(__wrap_pthread_create, 0);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[2]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[0]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[1]);
+    will_return(__wrap_pthread_create, EAGAIN);
+    expect_string(__wrap__merror, formatted_msg, error_msg);
+
+    expect_function_call(__wrap_pthread_join);
+
+    fim_scan_parallel(NULL, &txn_ctx);
+}
+
+static void test_fim_scan_parallel_no_threads(void **state) {
+    event_data_t evt_data = { .report_event = true, .mode = FIM_SCHEDULED, .w_evt = NULL };
+    fim_txn_context_t txn_ctx = { .evt_data = &evt_data };
+    char error_msg[OS_SIZE_256];
+
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+    expect_function_call_any(__wrap_pthread_rwlock_rdlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    syscheck.scan_threads = 2;
+
+    snprintf(error_msg, OS_SIZE_256, FIM_ERROR_SCAN_THREAD, strerror(EAGAIN));
+
+    will_return(__wrap_pthread_create, EAGAIN);
+    expect_string(__wrap__merror, formatted_msg, error_msg);
+
+    // The calling thread scans the queued directories, oldest first for each worker
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[0]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[2]);
+    expect_scan_pool_skipped_path(SCAN_POOL_PATHS[1]);
+
+    fim_scan_parallel(NULL, &txn_ctx);
+}
+#endif
+
 static void test_update_wildcards_config() {
     char **paths;
 #ifndef TEST_WINAGENT
@@ -3647,15 +4075,15 @@ static void test_update_wildcards_config_remove_config() {
     char wildcard2[20] = "/*/path";
     char resolvedpath1[20] = "/testdir1";
     char resolvedpath2[20] = "/testdir2";
-    char pattern1[20] = "/testdir1/%";
-    char pattern2[20] = "/testdir2/%";
+    char pattern1[20] = "/testdir1/";
+    char pattern2[20] = "/testdir2/";
 #else
     char wildcard1[20] = "c:\\testdir?";
     char wildcard2[20] = "c:\\*\\path";
     char resolvedpath1[20] = "c:\\testdir1";
     char resolvedpath2[20] = "c:\\testdir2";
-    char pattern1[20] = "c:\\testdir1\\%";
-    char pattern2[20] = "c:\\testdir2\\%";
+    char pattern1[20] = "c:\\testdir1\\";
+    char pattern2[20] = "c:\\testdir2\\";
 #endif
 
     char error_msg[OS_MAXSTR];
@@ -3691,11 +4119,11 @@ static void test_update_wildcards_config_remove_config() {
     expect_string(__wrap_fim_db_get_path, file_path, resolvedpath1);
     will_return(__wrap_fim_db_get_path, NULL);
 
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, pattern2);
-    will_return(__wrap_fim_db_file_pattern_search, 0);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, pattern2);
+    will_return(__wrap_fim_db_file_prefix_search, 0);
 
-    expect_string(__wrap_fim_db_file_pattern_search, pattern, pattern1);
-    will_return(__wrap_fim_db_file_pattern_search, 0);
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, pattern1);
+    will_return(__wrap_fim_db_file_prefix_search, 0);
     update_wildcards_config();
 
     // Empty config
@@ -4397,6 +4825,8 @@ int main(void) {
 
         /* fim_get_data */
         cmocka_unit_test_teardown(test_fim_get_data, teardown_local_data),
+        cmocka_unit_test_teardown(test_fim_get_data_reusing_hashes, teardown_local_data),
+        cmocka_unit_test_teardown(test_fim_get_data_reusing_hashes_size_changed, teardown_local_data),
         cmocka_unit_test_teardown(test_fim_get_data_no_hashes, teardown_local_data),
         cmocka_unit_test(test_fim_get_data_hash_error),
 #ifdef TEST_WINAGENT
@@ -4424,6 +4854,24 @@ int main(void) {
 
         /* fim_diff_folder_size */
         cmocka_unit_test(test_fim_diff_folder_size),
+        cmocka_unit_test(test_fim_diff_folder_size_refresh_every_scan),
+        cmocka_unit_test(test_fim_diff_folder_size_refresh_first_scan_not_saved),
+        cmocka_unit_test(test_fim_diff_folder_size_refresh_running_total),
+        cmocka_unit_test(test_fim_diff_folder_size_refresh_reconcile),
+        cmocka_unit_test(test_fim_diff_folder_size_reconcile),
+        cmocka_unit_test(test_fim_diff_folder_size_reconcile_no_folder),
+
+#ifndef TEST_WINAGENT
+        /* fim_scan_parallel */
+        cmocka_unit_test_setup_teardown(test_fim_scan_push_job, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_push_job_full, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_take_job, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_main, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_main_not_last, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_parallel, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_parallel_thread_error, setup_scan_pool, teardown_scan_pool),
+        cmocka_unit_test_setup_teardown(test_fim_scan_parallel_no_threads, setup_scan_pool, teardown_scan_pool),
+#endif
 
         /* transaction_callback */
         cmocka_unit_test_setup_teardown(test_transaction_callback_add, setup_transaction_callback, teardown_transaction_callback),
@@ -110,6 +110,15 @@ int is_file_nodiff(const char *filename);
 int is_registry_nodiff(const char *key_name, const char *value_name, int arch);
 char *gen_diff_str(const diff_data *diff);
 char *fim_diff_generate(const diff_data *diff);
+#ifndef TEST_WINAGENT
+size_t fim_diff_next_chunk(const char *data, size_t length);
+int fim_diff_lines(const char *old_data,
+                   size_t old_length,
+                   const char *new_data,
+                   size_t new_length,
+                   const diff_data *diff,
+                   char **diff_str);
+#endif
 
 void expect_gen_diff_generate(gen_diff_struct *gen_diff_data_container) {
     FILE *fp = (FILE*)2345;
@@ -1956,6 +1965,150 @@ void test_fim_diff_process_delete_value_delete_error(void **state) {
 }
 #endif
 
+#ifndef TEST_WINAGENT
+static void fill_chunk_data(char *data, size_t length) {
+    unsigned int seed = 12345;
+
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (char)(seed >> 16);
+    }
+}
+
+void test_fim_diff_next_chunk_small(void **state) {
+    char data[OS_SIZE_1024] = {0};
+
+    assert_int_equal(fim_diff_next_chunk(data, sizeof(data)), sizeof(data));
+}
+
+void test_fim_diff_next_chunk_max_size(void **state) {
+    char *data;
+    size_t length;
+
+    os_calloc(OS_SIZE_65536 * 2, sizeof(char), data);
+
+    // Data without boundaries is cut at the maximum chunk size
+    length = fim_diff_next_chunk(data, OS_SIZE_65536 * 2);
+
+    os_free(data);
+    assert_int_equal(length, OS_SIZE_65536);
+}
+
+void test_fim_diff_next_chunk_insertion(void **state) {
+    const size_t length = OS_SIZE_65536 * 4;
+    size_t old_ends[OS_SIZE_1024];
+    size_t old_count = 0;
+    size_t offset;
+    char *data;
+    int shared = 0;
+
+    os_malloc(length + 100, data);
+    fill_chunk_data(data + 100, length);
+
+    for (offset = 100; offset < length + 100; offset += fim_diff_next_chunk(data + offset, length + 100 - offset)) {
+        old_ends[old_count++] = offset;
+    }
+
+    // Inserting data at the beginning only moves the first boundaries
+    fill_chunk_data(data, 100);
+
+    for (offset = 0; offset < length + 100; offset += fim_diff_next_chunk(data + offset, length + 100 - offset)) {
+        for (size_t i = 1; i < old_count; i++) {
+            if (old_ends[i] == offset) {
+                shared++;
+            }
+        }
+    }
+
+    os_free(data);
+    assert_true(old_count > 4);
+    assert_true(shared >= (int)old_count - 3);
+}
+
+void test_fim_diff_lines_changes(void **state) {
+    const char *old_data = "a\nb\nc\nd\n";
+    const char *new_data = "a\nB\nc\nd\ne\n";
+    diff_data diff = { .uncompress_file = (char *)UNCOMPRESS_FILE, .file_origin = (char *)GENERIC_PATH };
+    char *diff_str = NULL;
+
+    assert_int_equal(fim_diff_lines(old_data, strlen(old_data), new_data, strlen(new_data), &diff, &diff_str), 0);
+    assert_string_equal(diff_str, "2c2\n< b\n---\n> B\n4a5\n> e\n");
+
+    os_free(diff_str);
+}
+
+void test_fim_diff_lines_no_newline(void **state) {
+    const char *old_data = "a\nb\nc\nd\n";
+    const char *new_data = "a\nd";
+    diff_data diff = { .uncompress_file = (char *)UNCOMPRESS_FILE, .file_origin = (char *)GENERIC_PATH };
+    char *diff_str = NULL;
+
+    assert_int_equal(fim_diff_lines(old_data, strlen(old_data), new_data, strlen(new_data), &diff, &diff_str), 0);
+    assert_string_equal(diff_str, "2,4c2\n< b\n< c\n< d\n---\n> d\n\\ No newline at end of file\n");
+
+    os_free(diff_str);
+}
+
+void test_fim_diff_lines_binary(void **state) {
+    const char old_data[] = "abc\0def";
+    const char new_data[] = "abc\0xyz";
+    diff_data diff = { .uncompress_file = (char *)UNCOMPRESS_FILE, .file_origin = (char *)GENERIC_PATH };
+    char *diff_str = NULL;
+
+    assert_int_equal(fim_diff_lines(old_data, sizeof(old_data) - 1, new_data, sizeof(new_data) - 1, &diff, &diff_str), 0);
+    assert_string_equal(diff_str, "Binary files queue/diff/tmp/tmp-entry and /path/to/file differ\n");
+
+    os_free(diff_str);
+}
+
+void test_fim_diff_lines_too_long(void **state) {
+    const size_t lines = OS_SIZE_8192;
+    diff_data diff = { .uncompress_file = (char *)UNCOMPRESS_FILE, .file_origin = (char *)GENERIC_PATH };
+    char *new_data = NULL;
+    char *diff_str = NULL;
+    size_t length;
+
+    os_malloc(lines * 10 + 1, new_data);
+
+    for (size_t i = 0; i < lines; i++) {
+        snprintf(new_data + i * 10, 11, "line %04zu\n", i);
+    }
+
+    assert_int_equal(fim_diff_lines("", 0, new_data, lines * 10, &diff, &diff_str), 0);
+
+    length = strlen(diff_str);
+    assert_true(length <= OS_MAXSTR - OS_SK_HEADER - 1);
+    assert_string_equal(diff_str + length - strlen("More changes..."), "More changes...");
+    assert_int_equal(diff_str[length - strlen("More changes...") - 1], '\n');
+
+    os_free(new_data);
+    os_free(diff_str);
+}
+
+void test_fim_diff_lines_too_different(void **state) {
+    const size_t lines = OS_SIZE_8192;
+    diff_data diff = { .uncompress_file = (char *)UNCOMPRESS_FILE, .file_origin = (char *)GENERIC_PATH };
+    char *old_data = NULL;
+    char *new_data = NULL;
+    char *diff_str = NULL;
+
+    os_malloc(lines * 4 + 1, old_data);
+    os_malloc(lines * 4 + 1, new_data);
+
+    // Every line matches a line of the other content, but in a different order
+    for (size_t i = 0; i < lines; i++) {
+        snprintf(old_data + i * 4, 5, "%03zu\n", i % 1000);
+        snprintf(new_data + i * 4, 5, "%03zu\n", (i * 7) % 1000);
+    }
+
+    assert_int_equal(fim_diff_lines(old_data, lines * 4, new_data, lines * 4, &diff, &diff_str), -1);
+    assert_null(diff_str);
+
+    os_free(old_data);
+    os_free(new_data);
+}
+#endif
+
 int main(void) {
     const struct CMUnitTest tests[] = {
 
@@ -2082,6 +2235,20 @@ int main(void) {
         cmocka_unit_test(test_fim_diff_process_delete_file_delete_error),
         cmocka_unit_test(test_fim_diff_process_delete_file_folder_not_exist),
 
+#ifndef TEST_WINAGENT
+        // fim_diff_next_chunk
+        cmocka_unit_test(test_fim_diff_next_chunk_small),
+        cmocka_unit_test(test_fim_diff_next_chunk_max_size),
+        cmocka_unit_test(test_fim_diff_next_chunk_insertion),
+
+        // fim_diff_lines
+        cmocka_unit_test(test_fim_diff_lines_changes),
+        cmocka_unit_test(test_fim_diff_lines_no_newline),
+        cmocka_unit_test(test_fim_diff_lines_binary),
+        cmocka_unit_test(test_fim_diff_lines_too_long),
+        cmocka_unit_test(test_fim_diff_lines_too_different),
+#endif
+
 #ifdef TEST_WINAGENT
         // fim_diff_process_delete_registry
         cmocka_unit_test(test_fim_diff_process_delete_registry_ok),
@@ -276,7 +276,7 @@ static int setup_hash(void **state) {
             OSHash_Add_ex(syscheck.realtime->dirtb, dir_it->path, rtlocald);
         }
     }
-    syscheck.realtime->evt = (HANDLE)234;
+    syscheck.realtime->iocp = (HANDLE)234;
     return 0;
 }
 
@@ -470,7 +470,7 @@ void test_fim_run_realtime_process_after_timeout(void **state) {
 }
 #else
 
-void test_fim_run_realtime_w_first_timeout(void **state) {
+void test_fim_run_realtime_w_worker_error(void **state) {
     char debug_msg[OS_SIZE_128] = {0};
     directory_t *dir_it;
     OSListNode *node_it;
@@ -496,17 +496,17 @@ void test_fim_run_realtime_w_first_timeout(void **state) {
             added_dirs++;
         }
     }
-    will_return(__wrap_FOREVER, 1);
-
     snprintf(debug_msg, OS_SIZE_128, FIM_NUM_WATCHES, added_dirs);
     expect_string(__wrap__mdebug2, formatted_msg, debug_msg);
 
-    expect_value(wrap_WaitForSingleObjectEx, hHandle, (DWORD)234);
-    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, SYSCHECK_WAIT * 1000);
-    expect_value(wrap_WaitForSingleObjectEx, bAlertable, TRUE);
-    will_return(wrap_WaitForSingleObjectEx, WAIT_FAILED);
+    will_return(wrap_CreateThread, (HANDLE)123456);
+    will_return(wrap_CreateThread, NULL);
+    expect_string(__wrap__merror, formatted_msg, THREAD_ERROR);
+
+    will_return(__wrap_FOREVER, 1);
+
+    expect_value(wrap_Sleep, dwMilliseconds, SYSCHECK_WAIT * 1000);
 
-    expect_string(__wrap__merror, formatted_msg, FIM_ERROR_REALTIME_WAITSINGLE_OBJECT);
     OSList_foreach(node_it, syscheck.directories) {
         dir_it = node_it->data;
         if (dir_it->options & REALTIME_ACTIVE) {
@@ -520,7 +520,7 @@ void test_fim_run_realtime_w_first_timeout(void **state) {
     fim_run_realtime(NULL);
 }
 
-void test_fim_run_realtime_w_wait_success(void **state) {
+void test_fim_run_realtime_w_workers(void **state) {
     char debug_msg[OS_SIZE_128] = {0};
     directory_t *dir_it;
     OSListNode *node_it;
@@ -547,15 +547,15 @@ void test_fim_run_realtime_w_wait_success(void **state) {
         }
     }
 
-    will_return(__wrap_FOREVER, 1);
-
     snprintf(debug_msg, OS_SIZE_128, FIM_NUM_WATCHES, added_dirs);
     expect_string(__wrap__mdebug2, formatted_msg, debug_msg);
 
-    expect_value(wrap_WaitForSingleObjectEx, hHandle, (DWORD)234);
-    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, SYSCHECK_WAIT * 1000);
-    expect_value(wrap_WaitForSingleObjectEx, bAlertable, TRUE);
-    will_return(wrap_WaitForSingleObjectEx, WAIT_IO_COMPLETION);
+    // The changes are processed by the workers of the completion port
+    will_return_count(wrap_CreateThread, (HANDLE)123456, FIM_RT_WORKERS);
+
+    will_return(__wrap_FOREVER, 1);
+
+    expect_value(wrap_Sleep, dwMilliseconds, SYSCHECK_WAIT * 1000);
 
     OSList_foreach(node_it, syscheck.directories) {
         dir_it = node_it->data;
@@ -596,6 +596,9 @@ void test_fim_run_realtime_w_sleep(void **state) {
             will_return(__wrap_realtime_adddir, 0);
         }
     }
+
+    will_return_count(wrap_CreateThread, (HANDLE)123456, FIM_RT_WORKERS);
+
     will_return(__wrap_FOREVER, 1);
 
     expect_value(wrap_Sleep, dwMilliseconds, SYSCHECK_WAIT * 1000);
@@ -832,8 +835,8 @@ void test_fim_link_update(void **state) {
 
     expect_string(__wrap_remove_audit_rule_syscheck, path, affected_config->symbolic_links);
 
-    snprintf(pattern, PATH_MAX, "%s%c%%", affected_config->symbolic_links, PATH_SEP);
-    expect_fim_db_file_pattern_search(pattern, 0);
+    snprintf(pattern, PATH_MAX, "%s%c", affected_config->symbolic_links, PATH_SEP);
+    expect_fim_db_file_prefix_search(pattern, 0);
 
     expect_fim_checker_call(new_path, affected_config);
     expect_realtime_adddir_call(new_path, 0);
@@ -881,8 +884,8 @@ void test_fim_link_check_delete(void **state) {
 
     expect_string(__wrap_remove_audit_rule_syscheck, path, affected_config->symbolic_links);
 
-    snprintf(pattern, PATH_MAX, "%s%c%%", affected_config->symbolic_links, PATH_SEP);
-    expect_fim_db_file_pattern_search(pattern, 0);
+    snprintf(pattern, PATH_MAX, "%s%c", affected_config->symbolic_links, PATH_SEP);
+    expect_fim_db_file_prefix_search(pattern, 0);
 
     expect_fim_configuration_directory_call("data", NULL);
     fim_link_check_delete(affected_config);
@@ -962,8 +965,8 @@ void test_fim_link_delete_range(void **state) {
     expect_function_call_any(__wrap_pthread_mutex_lock);
     expect_function_call_any(__wrap_pthread_mutex_unlock);
 
-    snprintf(pattern, PATH_MAX, "%s%c%%", "/folder", PATH_SEP);
-    expect_fim_db_file_pattern_search(pattern, 0);
+    snprintf(pattern, PATH_MAX, "%s%c", "/folder", PATH_SEP);
+    expect_fim_db_file_prefix_search(pattern, 0);
 
     fim_link_delete_range(((directory_t *)OSList_GetDataFromIndex(syscheck.directories, 1)));
 }
@@ -1125,8 +1128,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_fim_link_reload_broken_link_already_monitored, setup_symbolic_links, teardown_symbolic_links),
         cmocka_unit_test_setup_teardown(test_fim_link_reload_broken_link_reload_broken, setup_symbolic_links, teardown_symbolic_links),
 #else
-        cmocka_unit_test_setup_teardown(test_fim_run_realtime_w_first_timeout, setup_hash, teardown_hash),
-        cmocka_unit_test_setup_teardown(test_fim_run_realtime_w_wait_success, setup_hash, teardown_hash),
+        cmocka_unit_test_setup_teardown(test_fim_run_realtime_w_worker_error, setup_hash, teardown_hash),
+        cmocka_unit_test_setup_teardown(test_fim_run_realtime_w_workers, setup_hash, teardown_hash),
         cmocka_unit_test(test_fim_run_realtime_w_sleep),
 #endif
         cmocka_unit_test(test_send_sync_state),
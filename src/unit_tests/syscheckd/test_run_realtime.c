@@ -36,6 +36,9 @@
 #include "../config/syscheck-config.h"
 
 #ifdef TEST_WINAGENT
+#include "../wrappers/windows/errhandlingapi_wrappers.h"
+#include "../wrappers/windows/ioapiset_wrappers.h"
+
 // This struct should always reflect the one defined in run_realtime.c
 
 int realtime_win32read(win32rtfim *rtlocald);
@@ -94,6 +97,15 @@ static int setup_RTCallBack(void **state) {
     if(rt == NULL)
         return -1;
 
+    rt->dir = strdup("C:\\a\\path");
+    rt->h = (HANDLE)1234;
+    rt->buffer_size = FIM_RT_BUFFER_SIZE;
+    rt->buffer = calloc(1, rt->buffer_size);
+    rt->watch_status = FIM_RT_HANDLE_OPEN;
+
+    if(rt->dir == NULL || rt->buffer == NULL)
+        return -1;
+
     *state = rt;
     return 0;
 }
@@ -101,10 +113,12 @@ static int setup_RTCallBack(void **state) {
 static int teardown_RTCallBack(void **state) {
     win32rtfim *rt = *state;
 
-    if(rt->dir)
+    // The watch is freed when it's removed
+    if (rt) {
+        free(rt->buffer);
         free(rt->dir);
-
-    free(rt);
+        free(rt);
+    }
 
     return 0;
 }
@@ -330,18 +344,17 @@ void test_realtime_start_success(void **state) {
 #if defined(TEST_SERVER) || defined(TEST_AGENT)
     will_return(__wrap_inotify_init, 0);
 #else
-    expect_value(wrap_CreateEvent, lpEventAttributes, NULL);
-    expect_value(wrap_CreateEvent, bManualReset, TRUE);
-    expect_value(wrap_CreateEvent, bInitialState, FALSE);
-    expect_value(wrap_CreateEvent, lpName, NULL);
-    will_return(wrap_CreateEvent, (HANDLE)123456);
+    expect_value(wrap_CreateIoCompletionPort, FileHandle, INVALID_HANDLE_VALUE);
+    expect_value(wrap_CreateIoCompletionPort, ExistingCompletionPort, NULL);
+    expect_value(wrap_CreateIoCompletionPort, NumberOfConcurrentThreads, FIM_RT_WORKERS);
+    will_return(wrap_CreateIoCompletionPort, (HANDLE)123456);
 #endif
 
     ret = realtime_start();
 
     assert_int_equal(ret, 0);
 #ifdef TEST_WINAGENT
-    assert_ptr_equal(syscheck.realtime->evt, 123456);
+    assert_ptr_equal(syscheck.realtime->iocp, 123456);
 #endif
 }
 
@@ -630,6 +643,51 @@ void test_realtime_process_len(void **state) {
     test_mode = 0;
 }
 
+void test_realtime_process_coalesce(void **state) {
+    struct inotify_event *event = *state;
+    event->wd = 1;
+    event->mask = 2;
+    event->cookie = 0;
+    event->len = 5;
+    strcpy(event->name, "test");
+
+    syscheck.realtime->fd = 1;
+    syscheck.rt_coalesce_window = 100;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    will_return(__wrap_read, event);
+    will_return(__wrap_read, 21);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "1");
+    will_return(__wrap_OSHash_Get_ex, "test");
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/test");
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    char **paths = NULL;
+    paths = os_AddStrArray("/test", paths);
+
+    will_return(__wrap_rbtree_keys, paths);
+
+    // The path waits for its quiet window, fim_realtime_event is not called.
+    test_mode = 1;
+    realtime_process();
+    test_mode = 0;
+
+    syscheck.rt_coalesce_window = 0;
+}
+
+void test_realtime_flush_events_no_pending(void **state) {
+    // Nothing is pending, so nothing is checked.
+    realtime_flush_events(true);
+    assert_int_equal(realtime_coalesce_timeout(), -1);
+}
+
 void test_realtime_process_len_zero(void **state) {
     struct inotify_event *event = *state;
     event->wd = 1;
@@ -1361,7 +1419,7 @@ void test_realtime_sanitize_watch_map_update_existing_watch_with_new_directory_f
 
 #else // TEST_WINAGENT
 void test_realtime_win32read_success(void **state) {
-    win32rtfim rtlocal;
+    win32rtfim rtlocal = { .buffer_size = FIM_RT_BUFFER_SIZE };
     int ret;
 
     will_return(wrap_ReadDirectoryChangesW, 1);
@@ -1372,7 +1430,7 @@ void test_realtime_win32read_success(void **state) {
 }
 
 void test_realtime_win32read_unable_to_read_directory(void **state) {
-    win32rtfim rtlocal;
+    win32rtfim rtlocal = { .buffer_size = FIM_RT_BUFFER_SIZE };
     int ret;
 
     rtlocal.dir = "C:\\a\\path";
@@ -1384,6 +1442,20 @@ void test_realtime_win32read_unable_to_read_directory(void **state) {
     assert_int_equal(ret, 0);
 }
 
+void test_realtime_win32read_network_share(void **state) {
+    win32rtfim rtlocal = { .buffer_size = FIM_RT_BUFFER_SIZE * 4 };
+    int ret;
+
+    will_return(wrap_ReadDirectoryChangesW, 0);
+    expect_GetLastError_call(ERROR_INVALID_PARAMETER);
+    will_return(wrap_ReadDirectoryChangesW, 1);
+
+    ret = realtime_win32read(&rtlocal);
+
+    assert_int_equal(ret, 1);
+    assert_int_equal(rtlocal.buffer_size, FIM_RT_BUFFER_SIZE);
+}
+
 void test_free_win32rtfim_data_null_input(void **state) {
     // Nothing to check on this condition
     free_win32rtfim_data(NULL);
@@ -1397,9 +1469,9 @@ void test_free_win32rtfim_data_full_data(void **state) {
 
     data->h = (HANDLE)123456;
 
-    data->overlap.hEvent = calloc(1, sizeof(PVOID));
+    data->buffer = calloc(1, FIM_RT_BUFFER_SIZE);
 
-    if(data->overlap.hEvent == NULL) {
+    if(data->buffer == NULL) {
         free(data);
         fail();
     }
@@ -1407,7 +1479,7 @@ void test_free_win32rtfim_data_full_data(void **state) {
     data->dir = strdup("c:\\a\\path");
 
     if(data->dir == NULL) {
-        free(data->overlap.hEvent);
+        free(data->buffer);
         free(data);
         fail();
     }
@@ -1694,6 +1766,39 @@ void test_realtime_adddir_handle_error(void **state) {
     assert_int_equal(ret, 0);
 }
 
+void test_realtime_adddir_port_error(void **state) {
+    int ret;
+
+    expect_function_call_any(__wrap_pthread_rwlock_rdlock);
+    expect_function_call_any(__wrap_pthread_mutex_lock);
+    expect_function_call_any(__wrap_pthread_mutex_unlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    expect_value(__wrap_OSHash_Get_Elem_ex, self, syscheck.realtime->dirtb);
+    will_return(__wrap_OSHash_Get_Elem_ex, 128);
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
+    will_return(__wrap_OSHash_Get_ex, 0);
+
+    expect_string(wrap_CreateFile, lpFileName, "C:\\a\\path");
+    will_return(wrap_CreateFile, (HANDLE)123456);
+
+    expect_value(wrap_CreateIoCompletionPort, FileHandle, (HANDLE)123456);
+    expect_value(wrap_CreateIoCompletionPort, ExistingCompletionPort, syscheck.realtime->iocp);
+    expect_value(wrap_CreateIoCompletionPort, NumberOfConcurrentThreads, 0);
+    will_return(wrap_CreateIoCompletionPort, NULL);
+
+    expect_CloseHandle_call((HANDLE)123456, 1);
+
+    expect_string(__wrap__mdebug2, formatted_msg,
+        "(6290): Unable to add directory to real time monitoring: 'C:\\a\\path'");
+
+    ret = realtime_adddir("C:\\a\\path", ((directory_t *)OSList_GetDataFromIndex(syscheck.directories, 0)));
+
+    assert_int_equal(ret, 0);
+}
+
 void test_realtime_adddir_success(void **state) {
     int ret;
 
@@ -1711,6 +1816,11 @@ void test_realtime_adddir_success(void **state) {
     expect_string(wrap_CreateFile, lpFileName, "C:\\a\\path");
     will_return(wrap_CreateFile, (HANDLE)123456);
 
+    expect_value(wrap_CreateIoCompletionPort, FileHandle, (HANDLE)123456);
+    expect_value(wrap_CreateIoCompletionPort, ExistingCompletionPort, syscheck.realtime->iocp);
+    expect_value(wrap_CreateIoCompletionPort, NumberOfConcurrentThreads, 0);
+    will_return(wrap_CreateIoCompletionPort, syscheck.realtime->iocp);
+
     will_return(wrap_ReadDirectoryChangesW, 1);
     expect_value(__wrap_OSHash_Get_Elem_ex, self, syscheck.realtime->dirtb);
     will_return(__wrap_OSHash_Get_Elem_ex, 127);
@@ -1725,23 +1835,52 @@ void test_realtime_adddir_success(void **state) {
     assert_int_equal(ret, 1);
 }
 
+static void expect_realtime_win32_remove(win32rtfim *rt, bool close) {
+    char debug_msg[OS_SIZE_128];
+
+    if (close) {
+        expect_CloseHandle_call(rt->h, 1);
+    }
+
+    expect_value(__wrap_OSHash_Delete_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Delete_ex, key, rt->dir);
+    will_return(__wrap_OSHash_Delete_ex, rt);
+
+    snprintf(debug_msg, OS_SIZE_128, FIM_REALTIME_CALLBACK, rt->dir);
+    expect_string(__wrap__mdebug2, formatted_msg, debug_msg);
+}
+
 void test_RTCallBack_error_on_callback(void **state) {
-    OVERLAPPED ov = {.hEvent = "C:\\a\\path"};
+    win32rtfim *rt = *state;
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
+    will_return(__wrap_OSHash_Get_ex, rt);
 
     will_return(wrap_FormatMessage, "Path not found.");
     expect_string(__wrap__merror, formatted_msg, "(6613): Real time Windows callback process: 'Path not found.' (3).");
 
-    RTCallBack(ERROR_PATH_NOT_FOUND, 0, &ov);
+    // The watch has no pending operation, so it's removed
+    expect_realtime_win32_remove(rt, true);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    RTCallBack(ERROR_PATH_NOT_FOUND, 0, &rt->overlap);
+    *state = NULL;
 }
 
 void test_RTCallBack_empty_hash_table(void **state) {
-    OVERLAPPED ov = {.hEvent = "C:\\a\\path"};
+    win32rtfim *rt = *state;
 
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_mutex_lock);
 
     expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
-    expect_any(__wrap_OSHash_Get_ex, key);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
     will_return(__wrap_OSHash_Get_ex, NULL);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
@@ -1749,36 +1888,67 @@ void test_RTCallBack_empty_hash_table(void **state) {
 
     expect_string(__wrap__merror, formatted_msg, FIM_ERROR_REALTIME_WINDOWS_CALLBACK_EMPTY);
 
-    RTCallBack(ERROR_SUCCESS, 1, &ov);
+    RTCallBack(ERROR_SUCCESS, 1, &rt->overlap);
 }
 
-void test_RTCallBack_no_bytes_returned(void **state) {
+void test_RTCallBack_closed_handle(void **state) {
     win32rtfim *rt = *state;
-    OVERLAPPED ov = {.hEvent = "C:\\a\\path"};
 
-    rt->watch_status = 1;
+    rt->watch_status = FIM_RT_HANDLE_CLOSED;
 
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_mutex_lock);
 
     expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
-    expect_any(__wrap_OSHash_Get_ex, key);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
     will_return(__wrap_OSHash_Get_ex, rt);
 
-    expect_string(__wrap__mwarn, formatted_msg, FIM_WARN_REALTIME_OVERFLOW);
+    expect_realtime_win32_remove(rt, false);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
+    RTCallBack(ERROR_OPERATION_ABORTED, 0, &rt->overlap);
+    *state = NULL;
+}
+
+void test_RTCallBack_no_bytes_returned(void **state) {
+    win32rtfim *rt = *state;
+    char msg[OS_SIZE_256];
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
+    will_return(__wrap_OSHash_Get_ex, rt);
+
+    expect_string(__wrap_fim_configuration_directory, path, "C:\\a\\path");
+    will_return(__wrap_fim_configuration_directory, 0);
+
+    snprintf(msg, OS_SIZE_256, FIM_WARN_REALTIME_OVERFLOW_DIR, "C:\\a\\path");
+    expect_string(__wrap__mwarn, formatted_msg, msg);
+
+    snprintf(msg, OS_SIZE_256, FIM_REALTIME_BUFFER_SIZE, "C:\\a\\path", (unsigned long)FIM_RT_BUFFER_SIZE * 2);
+    expect_string(__wrap__mdebug2, formatted_msg, msg);
+
     // Inside realtime_win32read
     will_return(wrap_ReadDirectoryChangesW, 1);
 
-    RTCallBack(ERROR_SUCCESS, 0, &ov);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // Only the directory that overflowed is scanned
+    expect_string(__wrap_fim_realtime_rescan, dir, "c:\\a\\path");
+
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    RTCallBack(ERROR_SUCCESS, 0, &rt->overlap);
+
+    assert_int_equal(rt->buffer_size, FIM_RT_BUFFER_SIZE * 2);
 }
 
-void test_RTCallBack_acquired_changes_null_dir(void **state) {
+void test_RTCallBack_acquired_changes_other_directory(void **state) {
     win32rtfim *rt = *state;
-    OVERLAPPED ov;
     PFILE_NOTIFY_INFORMATION pinfo;
 
     expect_function_call(__wrap_pthread_rwlock_rdlock);
@@ -1786,16 +1956,10 @@ void test_RTCallBack_acquired_changes_null_dir(void **state) {
 
     // Fill the win32rtfim struct with testing data
     pinfo = (PFILE_NOTIFY_INFORMATION) rt->buffer;
-    wcscpy(pinfo->FileName, L"C:\\a\\path");
+    wcscpy(pinfo->FileName, L"file.test");
     pinfo->FileNameLength = wcslen(pinfo->FileName) * sizeof(WCHAR);
     pinfo->NextEntryOffset = 0;
 
-    // This condition is not taken into account
-    rt->dir = NULL;
-    rt->watch_status = 1;
-
-    ov.hEvent = "C:\\a\\path";
-
     // Begin calls to mock functions
 
     expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
@@ -1805,7 +1969,8 @@ void test_RTCallBack_acquired_changes_null_dir(void **state) {
     expect_string(__wrap_fim_configuration_directory, path, "C:\\a\\path");
     will_return(__wrap_fim_configuration_directory, 0);
 
-    expect_string(__wrap_fim_configuration_directory, path, "");
+    // The file belongs to another configured directory
+    expect_string(__wrap_fim_configuration_directory, path, "c:\\a\\path\\file.test");
     will_return(__wrap_fim_configuration_directory, -1);
 
     // Inside realtime_win32read
@@ -1814,15 +1979,13 @@ void test_RTCallBack_acquired_changes_null_dir(void **state) {
     expect_function_call(__wrap_pthread_mutex_unlock);
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
-    RTCallBack(ERROR_SUCCESS, 1, &ov);
+    RTCallBack(ERROR_SUCCESS, 1, &rt->overlap);
 }
 
 void test_RTCallBack_acquired_changes(void **state) {
     win32rtfim *rt = *state;
-    OVERLAPPED ov;
     PFILE_NOTIFY_INFORMATION pinfo;
 
-
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_function_call(__wrap_pthread_mutex_lock);
 
@@ -1832,33 +1995,109 @@ void test_RTCallBack_acquired_changes(void **state) {
     pinfo->FileNameLength = wcslen(pinfo->FileName) * sizeof(WCHAR);
     pinfo->NextEntryOffset = 0;
 
-    // This condition is not taken into account
-    rt->dir = strdup("C:\\a\\path");
-    rt->watch_status = 1;
-
-    ov.hEvent = "C:\\a\\path\\file.test";
-
     // Begin calls to mock functions
 
     expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
-    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path\\file.test");
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
     will_return(__wrap_OSHash_Get_ex, rt);
 
-    expect_string(__wrap_fim_configuration_directory, path, "C:\\a\\path\\file.test");
+    expect_string(__wrap_fim_configuration_directory, path, "C:\\a\\path");
     will_return(__wrap_fim_configuration_directory, 0);
 
     expect_string(__wrap_fim_configuration_directory, path, "c:\\a\\path\\file.test");
     will_return(__wrap_fim_configuration_directory, 0);
 
+    // Inside realtime_win32read
+    will_return(wrap_ReadDirectoryChangesW, 1);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // The changes are processed once the directory is watched again
     expect_string(__wrap_fim_realtime_event, file, "c:\\a\\path\\file.test");
 
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    RTCallBack(ERROR_SUCCESS, 1, &rt->overlap);
+}
+
+void test_RTCallBack_read_directory_error(void **state) {
+    win32rtfim *rt = *state;
+    PFILE_NOTIFY_INFORMATION pinfo;
+    char debug_msg[OS_SIZE_256];
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    pinfo = (PFILE_NOTIFY_INFORMATION) rt->buffer;
+    wcscpy(pinfo->FileName, L"file.test");
+    pinfo->FileNameLength = wcslen(pinfo->FileName) * sizeof(WCHAR);
+    pinfo->NextEntryOffset = 0;
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
+    will_return(__wrap_OSHash_Get_ex, rt);
+
+    expect_string(__wrap_fim_configuration_directory, path, "C:\\a\\path");
+    will_return(__wrap_fim_configuration_directory, 0);
+
+    expect_string(__wrap_fim_configuration_directory, path, "c:\\a\\path\\file.test");
+    will_return(__wrap_fim_configuration_directory, 0);
+
     // Inside realtime_win32read
-    will_return(wrap_ReadDirectoryChangesW, 1);
+    will_return(wrap_ReadDirectoryChangesW, 0);
+
+    snprintf(debug_msg, OS_SIZE_256, FIM_REALTIME_DIRECTORYCHANGES, "C:\\a\\path");
+    expect_string(__wrap__mdebug1, formatted_msg, debug_msg);
+
+    // The watch can't be set again, so it's removed
+    expect_realtime_win32_remove(rt, true);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // The changes that were read are still processed
+    expect_string(__wrap_fim_realtime_event, file, "c:\\a\\path\\file.test");
+
     expect_function_call(__wrap_pthread_rwlock_unlock);
 
-    RTCallBack(ERROR_SUCCESS, 1, &ov);
+    RTCallBack(ERROR_SUCCESS, 1, &rt->overlap);
+    *state = NULL;
+}
+
+void test_realtime_win32_dequeue_timeout(void **state) {
+    expect_GetQueuedCompletionStatus_call(0, NULL, FALSE);
+    expect_GetLastError_call(WAIT_TIMEOUT);
+
+    assert_int_equal(realtime_win32_dequeue(1000), 0);
+}
+
+void test_realtime_win32_dequeue_port_error(void **state) {
+    expect_GetQueuedCompletionStatus_call(0, NULL, FALSE);
+    expect_GetLastError_call(ERROR_INVALID_HANDLE);
+
+    expect_string(__wrap__merror, formatted_msg, FIM_ERROR_REALTIME_WAITSINGLE_OBJECT);
+
+    assert_int_equal(realtime_win32_dequeue(1000), -1);
+}
+
+void test_realtime_win32_dequeue_completion(void **state) {
+    win32rtfim *rt = *state;
+
+    expect_GetQueuedCompletionStatus_call(1, &rt->overlap, TRUE);
+
+    // Inside RTCallBack
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "C:\\a\\path");
+    will_return(__wrap_OSHash_Get_ex, NULL);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    expect_string(__wrap__merror, formatted_msg, FIM_ERROR_REALTIME_WINDOWS_CALLBACK_EMPTY);
+
+    assert_int_equal(realtime_win32_dequeue(1000), 1);
 }
 #endif
 
@@ -1948,6 +2187,8 @@ int main(void) {
         /* realtime_process */
         cmocka_unit_test(test_realtime_process),
         cmocka_unit_test_setup_teardown(test_realtime_process_len, setup_inotify_event, teardown_inotify_event),
+        cmocka_unit_test_setup_teardown(test_realtime_process_coalesce, setup_inotify_event, teardown_inotify_event),
+        cmocka_unit_test(test_realtime_flush_events_no_pending),
         cmocka_unit_test_setup_teardown(test_realtime_process_len_zero, setup_inotify_event, teardown_inotify_event),
         cmocka_unit_test_setup_teardown(test_realtime_process_len_path_separator, setup_inotify_event, teardown_inotify_event),
         cmocka_unit_test_setup_teardown(test_realtime_process_overflow, setup_inotify_event, teardown_inotify_event),
@@ -1965,17 +2206,25 @@ int main(void) {
         // realtime_win32read
         cmocka_unit_test(test_realtime_win32read_success),
         cmocka_unit_test(test_realtime_win32read_unable_to_read_directory),
+        cmocka_unit_test(test_realtime_win32read_network_share),
 
         // free_win32rtfim_data
         cmocka_unit_test(test_free_win32rtfim_data_null_input),
         cmocka_unit_test(test_free_win32rtfim_data_full_data),
 
         // RTCallBack
-        cmocka_unit_test(test_RTCallBack_error_on_callback),
-        cmocka_unit_test(test_RTCallBack_empty_hash_table),
+        cmocka_unit_test_setup_teardown(test_RTCallBack_error_on_callback, setup_RTCallBack, teardown_RTCallBack),
+        cmocka_unit_test_setup_teardown(test_RTCallBack_empty_hash_table, setup_RTCallBack, teardown_RTCallBack),
+        cmocka_unit_test_setup_teardown(test_RTCallBack_closed_handle, setup_RTCallBack, teardown_RTCallBack),
         cmocka_unit_test_setup_teardown(test_RTCallBack_no_bytes_returned, setup_RTCallBack, teardown_RTCallBack),
-        cmocka_unit_test_setup_teardown(test_RTCallBack_acquired_changes_null_dir, setup_RTCallBack, teardown_RTCallBack),
+        cmocka_unit_test_setup_teardown(test_RTCallBack_acquired_changes_other_directory, setup_RTCallBack, teardown_RTCallBack),
         cmocka_unit_test_setup_teardown(test_RTCallBack_acquired_changes, setup_RTCallBack, teardown_RTCallBack),
+        cmocka_unit_test_setup_teardown(test_RTCallBack_read_directory_error, setup_RTCallBack, teardown_RTCallBack),
+
+        // realtime_win32_dequeue
+        cmocka_unit_test(test_realtime_win32_dequeue_timeout),
+        cmocka_unit_test(test_realtime_win32_dequeue_port_error),
+        cmocka_unit_test_setup_teardown(test_realtime_win32_dequeue_completion, setup_RTCallBack, teardown_RTCallBack),
 #endif
 
         /* realtime_sanitize_watch_map */
@@ -2012,6 +2261,7 @@ int main(void) {
         cmocka_unit_test(test_realtime_adddir_max_limit_reached),
         cmocka_unit_test(test_realtime_adddir_duplicate_entry),
         cmocka_unit_test(test_realtime_adddir_handle_error),
+        cmocka_unit_test(test_realtime_adddir_port_error),
         cmocka_unit_test(test_realtime_adddir_duplicate_entry_non_existent_directory_valid_handle),
         cmocka_unit_test(test_realtime_adddir_duplicate_entry_non_existent_directory_closed_handle),
         cmocka_unit_test(test_realtime_adddir_duplicate_entry_non_existent_directory_invalid_handle),
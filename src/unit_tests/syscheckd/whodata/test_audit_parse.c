@@ -31,12 +31,13 @@
 
 extern unsigned int count_reload_retries;
 audit_key_type filterkey_audit_events(char *buffer);
+void audit_get_parent_process_info(char *ppid, char **const parent_name, char **const parent_cwd);
 
 /* setup/teardown */
 static int setup_group(void **state) {
     (void) state;
     test_mode = 1;
-    init_regex();
+    init_audit_parser();
 
     return 0;
 }
@@ -45,11 +46,23 @@ static int teardown_group(void **state) {
     (void) state;
     memset(&syscheck, 0, sizeof(syscheck_config));
     Free_Syscheck(&syscheck);
-    clean_regex();
+    clean_audit_parser();
     test_mode = 0;
     return 0;
 }
 
+static int setup_process_cache(void **state) {
+    syscheck.audit_process_cache = 16;
+    return 0;
+}
+
+static int teardown_process_cache(void **state) {
+    syscheck.audit_process_cache = 0;
+    clean_audit_parser();
+    init_audit_parser();
+    return 0;
+}
+
 static int setup_config(void **state) {
     expect_function_call_any(__wrap_pthread_rwlock_wrlock);
     expect_function_call_any(__wrap_pthread_mutex_lock);
@@ -524,6 +537,82 @@ void test_get_process_parent_info_passsed(void **state) {
     }
 }
 
+void test_audit_get_parent_process_info_cached(void **state) {
+    (void) state;
+    char *stat_line = "1516 (my process) S 1 1516 1516 0 -1 4194560 100 0 0 0 0 0 0 0 20 0 1 0 123456 1000 100";
+    char *parent_name;
+    char *parent_cwd;
+
+    os_malloc(OS_FLSIZE, parent_name);
+    os_malloc(OS_FLSIZE, parent_cwd);
+
+    expect_fopen("/proc/1516/stat", "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, stat_line);
+    expect_fclose((FILE *)1, 0);
+
+    will_return(__wrap_readlink, 0);
+    will_return(__wrap_readlink, 0);
+
+    audit_get_parent_process_info("1516", &parent_name, &parent_cwd);
+
+    assert_string_equal(parent_name, "");
+    assert_string_equal(parent_cwd, "");
+
+    // The second event of the same process doesn't read its links again
+    snprintf(parent_name, OS_FLSIZE, "name");
+    snprintf(parent_cwd, OS_FLSIZE, "cwd");
+
+    expect_fopen("/proc/1516/stat", "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, stat_line);
+    expect_fclose((FILE *)1, 0);
+
+    audit_get_parent_process_info("1516", &parent_name, &parent_cwd);
+
+    assert_string_equal(parent_name, "");
+    assert_string_equal(parent_cwd, "");
+
+    os_free(parent_name);
+    os_free(parent_cwd);
+}
+
+void test_audit_get_parent_process_info_pid_reused(void **state) {
+    (void) state;
+    char *parent_name;
+    char *parent_cwd;
+
+    os_malloc(OS_FLSIZE, parent_name);
+    os_malloc(OS_FLSIZE, parent_cwd);
+
+    expect_fopen("/proc/1517/stat", "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, "1517 (first) S 1 1517 1517 0 -1 4194560 100 0 0 0 0 0 0 0 20 0 1 0 123456 1000 100");
+    expect_fclose((FILE *)1, 0);
+
+    will_return(__wrap_readlink, 0);
+    will_return(__wrap_readlink, 0);
+
+    audit_get_parent_process_info("1517", &parent_name, &parent_cwd);
+
+    // Another process started later with the same pid
+    expect_fopen("/proc/1517/stat", "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, "1517 (second) S 1 1517 1517 0 -1 4194560 100 0 0 0 0 0 0 0 20 0 1 0 654321 1000 100");
+    expect_fclose((FILE *)1, 0);
+
+    will_return(__wrap_readlink, 0);
+    will_return(__wrap_readlink, 0);
+
+    audit_get_parent_process_info("1517", &parent_name, &parent_cwd);
+
+    assert_string_equal(parent_name, "");
+    assert_string_equal(parent_cwd, "");
+
+    os_free(parent_name);
+    os_free(parent_cwd);
+}
+
 void test_audit_parse(void **state) {
     (void) state;
     char audit_key_msg[OS_SIZE_128] = {0};
@@ -1341,6 +1430,8 @@ int main(void) {
         cmocka_unit_test_teardown(test_gen_audit_path8, free_string),
         cmocka_unit_test(test_get_process_parent_info_failed),
         cmocka_unit_test(test_get_process_parent_info_passsed),
+        cmocka_unit_test_setup_teardown(test_audit_get_parent_process_info_cached, setup_process_cache, teardown_process_cache),
+        cmocka_unit_test_setup_teardown(test_audit_get_parent_process_info_pid_reused, setup_process_cache, teardown_process_cache),
         cmocka_unit_test(test_audit_parse),
         cmocka_unit_test(test_audit_parse3),
         cmocka_unit_test(test_audit_parse4),
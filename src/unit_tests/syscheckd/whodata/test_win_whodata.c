@@ -35,6 +35,9 @@
 #include "wrappers/wazuh/shared/validate_op_wrappers.h"
 #include "wrappers/windows/winevt_wrappers.h"
 #include "wrappers/windows/ntsecapi_wrappers.h"
+#include "wrappers/windows/handleapi_wrappers.h"
+#include "wrappers/windows/processthreadsapi_wrappers.h"
+#include "wrappers/windows/synchapi_wrappers.h"
 
 
 #include "syscheckd/include/syscheck.h"
@@ -76,6 +79,10 @@ extern int restore_policies;
 extern int policies_checked;
 extern EVT_HANDLE context;
 extern atomic_int_t whodata_end;
+extern EVT_HANDLE evt_subscribe_handle;
+extern HANDLE whodata_signal;
+extern PEVT_VARIANT render_buffer;
+extern unsigned long render_buffer_size;
 
 extern const wchar_t* event_fields[];
 
@@ -99,7 +106,16 @@ typedef struct PolicyInfo {
 
 /**************************************************************************/
 /*******************Helper functions*************************************/
+// Drop the render buffer of the previous tests, so the event doesn't fit in it
+static void reset_render_buffer() {
+    free(render_buffer);
+    render_buffer = NULL;
+    render_buffer_size = 0;
+}
+
 static void successful_whodata_event_render(EVT_HANDLE event, PEVT_VARIANT raw_data) {
+    reset_render_buffer();
+
     /* EvtRender first call */
     expect_value(wrap_EvtRender, Context, context);
     expect_value(wrap_EvtRender, Fragment, event);
@@ -4061,23 +4077,15 @@ void test_whodata_event_render_fail_to_render_event(void **state) {
     EVT_HANDLE event = NULL;
     PEVT_VARIANT result = NULL;
 
-    /* EvtRender first call */
-    expect_value(wrap_EvtRender, Context, context);
-    expect_value(wrap_EvtRender, Fragment, event);
-    expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
-    expect_value(wrap_EvtRender, BufferSize, 0); // BufferSize
-    will_return(wrap_EvtRender, NULL); // Buffer
-    will_return(wrap_EvtRender, 0); // BufferUsed
-    will_return(wrap_EvtRender, 0); // PropertyCount
-    will_return(wrap_EvtRender, 0);
+    reset_render_buffer();
 
-    /* EvtRender second call */
+    /* EvtRender fails without asking for a larger buffer */
     expect_value(wrap_EvtRender, Context, context);
     expect_value(wrap_EvtRender, Fragment, event);
     expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
     expect_value(wrap_EvtRender, BufferSize, 0); // BufferSize
     will_return(wrap_EvtRender, NULL); // Buffer
-    will_return(wrap_EvtRender, 0);// BufferUsed
+    will_return(wrap_EvtRender, 0); // BufferUsed
     will_return(wrap_EvtRender, 0); // PropertyCount
     will_return(wrap_EvtRender, 0);
 
@@ -4094,6 +4102,8 @@ void test_whodata_event_render_wrong_property_count(void **state) {
     EVT_VARIANT buffer[NUM_EVENTS];
     PEVT_VARIANT result = NULL;
 
+    reset_render_buffer();
+
     /* EvtRender first call */
     expect_value(wrap_EvtRender, Context, context);
     expect_value(wrap_EvtRender, Fragment, event);
@@ -4127,6 +4137,8 @@ void test_whodata_event_render_success(void **state) {
     EVT_VARIANT buffer[NUM_EVENTS];
     PEVT_VARIANT result = NULL;
 
+    reset_render_buffer();
+
     /* EvtRender first call */
     expect_value(wrap_EvtRender, Context, context);
     expect_value(wrap_EvtRender, Fragment, event);
@@ -4151,11 +4163,40 @@ void test_whodata_event_render_success(void **state) {
 
     result = whodata_event_render(event);
 
-    *state = result;
     assert_non_null(result);
+    assert_ptr_equal(result, render_buffer);
+    assert_int_equal(render_buffer_size, SIZE_EVENTS);
     assert_int_equal(result[0].Type, EvtVarTypeNull);
 }
 
+void test_whodata_event_render_reuse_buffer(void **state) {
+    EVT_HANDLE event = NULL;
+    EVT_VARIANT buffer[NUM_EVENTS];
+    PEVT_VARIANT result = NULL;
+
+    reset_render_buffer();
+    render_buffer_size = SIZE_EVENTS;
+    render_buffer = calloc(1, render_buffer_size);
+
+    /* The event fits in the buffer of the previous one */
+    memset(buffer, 0, SIZE_EVENTS);
+    buffer[0].Type = EvtVarTypeUInt16;
+    expect_value(wrap_EvtRender, Context, context);
+    expect_value(wrap_EvtRender, Fragment, event);
+    expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
+    expect_value(wrap_EvtRender, BufferSize, SIZE_EVENTS); // BufferSize
+    will_return(wrap_EvtRender, buffer); // Buffer
+    will_return(wrap_EvtRender, SIZE_EVENTS);// BufferUsed
+    will_return(wrap_EvtRender, 9); // PropertyCount
+    will_return(wrap_EvtRender, 1);
+
+    result = whodata_event_render(event);
+
+    assert_ptr_equal(result, render_buffer);
+    assert_int_equal(render_buffer_size, SIZE_EVENTS);
+    assert_int_equal(result[0].Type, EvtVarTypeUInt16);
+}
+
 /********************************************************************************************/
 /**********************************whodata_get_event_id**************************************/
 void test_whodata_get_event_id_null_raw_data(void **state) {
@@ -4683,9 +4724,11 @@ void test_whodata_callback_fail_to_render_event(void **state) {
     EVT_HANDLE event = NULL;
     unsigned long result;
 
+    reset_render_buffer();
+
     // Inside whodata_event_render
     {
-        /* EvtRender first call */
+        /* EvtRender fails without asking for a larger buffer */
         expect_value(wrap_EvtRender, Context, context);
         expect_value(wrap_EvtRender, Fragment, event);
         expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
@@ -4695,16 +4738,6 @@ void test_whodata_callback_fail_to_render_event(void **state) {
         will_return(wrap_EvtRender, 0); // PropertyCount
         will_return(wrap_EvtRender, 0);
 
-        /* EvtRender second call */
-        expect_value(wrap_EvtRender, Context, context);
-        expect_value(wrap_EvtRender, Fragment, event);
-        expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
-        expect_value(wrap_EvtRender, BufferSize, 0); // BufferSize
-        will_return(wrap_EvtRender, NULL); // Buffer
-        will_return(wrap_EvtRender, 0);// BufferUsed
-        will_return(wrap_EvtRender, 0); // PropertyCount
-        will_return(wrap_EvtRender, 0);
-
         will_return(wrap_GetLastError, 500);
         expect_string(__wrap__mwarn, formatted_msg, "(6933): Error rendering the event. Error 500.");
     }
@@ -6435,6 +6468,12 @@ void test_run_whodata_scan_error_event_channel(void **state) {
     expect_value(wrap_EvtCreateRenderContext, Flags, EvtRenderContextValues);
     will_return(wrap_EvtCreateRenderContext, event);
 
+    expect_value(wrap_CreateEvent, lpEventAttributes, NULL);
+    expect_value(wrap_CreateEvent, bManualReset, TRUE);
+    expect_value(wrap_CreateEvent, bInitialState, TRUE);
+    expect_value(wrap_CreateEvent, lpName, NULL);
+    will_return(wrap_CreateEvent, (HANDLE)4321);
+
     wchar_t *query = L"Event[ System[band(Keywords, 9007199254740992)] and "
                             "( ( ( EventData/Data[@Name='ObjectType'] = 'File' ) and "
                             "( (  System/EventID = 4656 or System/EventID = 4663 ) and "
@@ -6442,20 +6481,23 @@ void test_run_whodata_scan_error_event_channel(void **state) {
                             "System/EventID = 4658 or System/EventID = 4660 ) ]";
 
     expect_value(wrap_EvtSubscribe, Session, NULL);
-    expect_value(wrap_EvtSubscribe, SignalEvent, NULL);
+    expect_value(wrap_EvtSubscribe, SignalEvent, (HANDLE)4321);
     expect_string(wrap_EvtSubscribe, ChannelPath, L"Security");
     expect_string(wrap_EvtSubscribe, Query, query);
     expect_value(wrap_EvtSubscribe, Bookmark, NULL);
     expect_value(wrap_EvtSubscribe, Context, NULL);
-    expect_value(wrap_EvtSubscribe, Callback, (EVT_SUBSCRIBE_CALLBACK)whodata_callback);
+    expect_value(wrap_EvtSubscribe, Callback, NULL);
     expect_value(wrap_EvtSubscribe, Flags, EvtSubscribeToFutureEvents);
 
     will_return(wrap_EvtSubscribe, NULL);
 
     expect_string(__wrap__merror, formatted_msg, "(6621): Event Channel subscription could not be made. Whodata scan is disabled.");
 
+    expect_CloseHandle_call((HANDLE)4321, 1);
+
     ret = run_whodata_scan();
     assert_int_equal(ret, 1);
+    assert_null(whodata_signal);
 }
 
 void test_run_whodata_scan_success(void **state) {
@@ -6540,6 +6582,12 @@ void test_run_whodata_scan_success(void **state) {
     expect_value(wrap_EvtCreateRenderContext, Flags, EvtRenderContextValues);
     will_return(wrap_EvtCreateRenderContext, event);
 
+    expect_value(wrap_CreateEvent, lpEventAttributes, NULL);
+    expect_value(wrap_CreateEvent, bManualReset, TRUE);
+    expect_value(wrap_CreateEvent, bInitialState, TRUE);
+    expect_value(wrap_CreateEvent, lpName, NULL);
+    will_return(wrap_CreateEvent, (HANDLE)4321);
+
     wchar_t *query = L"Event[ System[band(Keywords, 9007199254740992)] and "
                             "( ( ( EventData/Data[@Name='ObjectType'] = 'File' ) and "
                             "( (  System/EventID = 4656 or System/EventID = 4663 ) and "
@@ -6547,20 +6595,141 @@ void test_run_whodata_scan_success(void **state) {
                             "System/EventID = 4658 or System/EventID = 4660 ) ]";
 
     expect_value(wrap_EvtSubscribe, Session, NULL);
-    expect_value(wrap_EvtSubscribe, SignalEvent, NULL);
+    expect_value(wrap_EvtSubscribe, SignalEvent, (HANDLE)4321);
     expect_string(wrap_EvtSubscribe, ChannelPath, L"Security");
     expect_string(wrap_EvtSubscribe, Query, query);
     expect_value(wrap_EvtSubscribe, Bookmark, NULL);
     expect_value(wrap_EvtSubscribe, Context, NULL);
-    expect_value(wrap_EvtSubscribe, Callback, (EVT_SUBSCRIBE_CALLBACK)whodata_callback);
+    expect_value(wrap_EvtSubscribe, Callback, NULL);
     expect_value(wrap_EvtSubscribe, Flags, EvtSubscribeToFutureEvents);
 
     will_return(wrap_EvtSubscribe, 1);
 
+    // Thread that reads the subscription
+    will_return(wrap_CreateThread, (HANDLE)123456);
+
     expect_string(__wrap__minfo, formatted_msg, "(6019): File integrity monitoring real-time Whodata engine started.");
 
     ret = run_whodata_scan();
     assert_int_equal(ret, 0);
+    assert_ptr_equal(whodata_signal, (HANDLE)4321);
+}
+
+void test_run_whodata_scan_error_thread(void **state) {
+    int ret;
+
+/* Inside whodata_check_arch */
+{
+    HKEY key;
+    const BYTE data[64] = "ARM64";
+
+    expect_value(wrap_RegOpenKeyEx, hKey, HKEY_LOCAL_MACHINE);
+    expect_string(wrap_RegOpenKeyEx, lpSubKey,
+        "System\\CurrentControlSet\\Control\\Session Manager\\Environment");
+    expect_value(wrap_RegOpenKeyEx, ulOptions, 0);
+    expect_value(wrap_RegOpenKeyEx, samDesired, KEY_READ);
+    will_return(wrap_RegOpenKeyEx, &key);
+    will_return(wrap_RegOpenKeyEx, ERROR_SUCCESS);
+
+    expect_string(wrap_RegQueryValueEx, lpValueName, "PROCESSOR_ARCHITECTURE");
+    expect_value(wrap_RegQueryValueEx, lpReserved, NULL);
+    expect_value(wrap_RegQueryValueEx, lpType, NULL);
+    will_return(wrap_RegQueryValueEx, data);
+    will_return(wrap_RegQueryValueEx, ERROR_SUCCESS);
+
+}
+
+/* Inside set_policies */
+{
+    expect_string(__wrap_IsFile, file, "tmp\\backup-policies");
+    will_return(__wrap_IsFile, 1);
+
+    expect_string(__wrap_wm_exec, command, "auditpol /backup /file:\"tmp\\backup-policies\"");
+    expect_value(__wrap_wm_exec, secs, 5);
+    expect_value(__wrap_wm_exec, add_path, NULL);
+    will_return(__wrap_wm_exec, 0);
+    will_return(__wrap_wm_exec, 0);
+
+    expect_string(__wrap_fopen, path, "tmp\\backup-policies");
+    expect_string(__wrap_fopen, mode, "r");
+    will_return(__wrap_fopen, (FILE*)1234);
+
+    expect_string(__wrap_fopen, path, "tmp\\new-policies");
+    expect_string(__wrap_fopen, mode, "w");
+    will_return(__wrap_fopen, (FILE*)2345);
+
+    expect_value(wrap_fgets, __stream, (FILE*)1234);
+    will_return(wrap_fgets, "some policies");
+
+    expect_value(wrap_fprintf, __stream, 2345);
+    expect_string(wrap_fprintf, formatted_msg, "some policies");
+    will_return(wrap_fprintf, 0);
+
+    expect_value(wrap_fgets, __stream, (FILE*)1234);
+    will_return(wrap_fgets, NULL);
+
+    expect_value(wrap_fprintf, __stream, 2345);
+    expect_string(wrap_fprintf, formatted_msg, ",System,File System,{0CCE921D-69AE-11D9-BED3-505054503030},,,1\n");
+    will_return(wrap_fprintf, 0);
+
+    expect_value(wrap_fprintf, __stream, 2345);
+    expect_string(wrap_fprintf, formatted_msg, ",System,Handle Manipulation,{0CCE9223-69AE-11D9-BED3-505054503030},,,1\n");
+    will_return(wrap_fprintf, 0);
+
+    expect_value(__wrap_fclose, _File, (FILE*)2345);
+    will_return(__wrap_fclose, 0);
+
+    expect_string(__wrap_wm_exec, command, "auditpol /restore /file:\"tmp\\new-policies\"");
+    expect_value(__wrap_wm_exec, secs, 5);
+    expect_value(__wrap_wm_exec, add_path, NULL);
+    will_return(__wrap_wm_exec, 0);
+    will_return(__wrap_wm_exec, 0);
+
+    expect_value(__wrap_fclose, _File, (FILE*)1234);
+    will_return(__wrap_fclose, 0);
+}
+
+    DWORD fields_number = 9;
+    EVT_HANDLE event;
+
+    expect_value(wrap_EvtCreateRenderContext, ValuePathsCount, fields_number);
+    expect_value(wrap_EvtCreateRenderContext, ValuePaths, event_fields);
+    expect_value(wrap_EvtCreateRenderContext, Flags, EvtRenderContextValues);
+    will_return(wrap_EvtCreateRenderContext, event);
+
+    expect_value(wrap_CreateEvent, lpEventAttributes, NULL);
+    expect_value(wrap_CreateEvent, bManualReset, TRUE);
+    expect_value(wrap_CreateEvent, bInitialState, TRUE);
+    expect_value(wrap_CreateEvent, lpName, NULL);
+    will_return(wrap_CreateEvent, (HANDLE)4321);
+
+    wchar_t *query = L"Event[ System[band(Keywords, 9007199254740992)] and "
+                            "( ( ( EventData/Data[@Name='ObjectType'] = 'File' ) and "
+                            "( (  System/EventID = 4656 or System/EventID = 4663 ) and "
+                            "( EventData[band(Data[@Name='AccessMask'], 327938‬)] ) ) ) or "
+                            "System/EventID = 4658 or System/EventID = 4660 ) ]";
+
+    expect_value(wrap_EvtSubscribe, Session, NULL);
+    expect_value(wrap_EvtSubscribe, SignalEvent, (HANDLE)4321);
+    expect_string(wrap_EvtSubscribe, ChannelPath, L"Security");
+    expect_string(wrap_EvtSubscribe, Query, query);
+    expect_value(wrap_EvtSubscribe, Bookmark, NULL);
+    expect_value(wrap_EvtSubscribe, Context, NULL);
+    expect_value(wrap_EvtSubscribe, Callback, NULL);
+    expect_value(wrap_EvtSubscribe, Flags, EvtSubscribeToFutureEvents);
+
+    will_return(wrap_EvtSubscribe, (EVT_HANDLE)1);
+
+    will_return(wrap_CreateThread, NULL);
+    expect_string(__wrap__merror, formatted_msg, "(1109): Unable to create new pthread.");
+
+    will_return(wrap_EvtClose, 1);
+    expect_CloseHandle_call((HANDLE)4321, 1);
+
+    ret = run_whodata_scan();
+    assert_int_equal(ret, 1);
+    assert_null(evt_subscribe_handle);
+    assert_null(whodata_signal);
 }
 
 void test_set_subscription_query(void **state) {
@@ -8097,10 +8266,156 @@ void test_win_whodata_release_resources(void **state) {
     expect_function_call_any(__wrap_pthread_mutex_lock);
     expect_function_call_any(__wrap_pthread_mutex_unlock);
 
+    evt_subscribe_handle = (EVT_HANDLE)1;
     will_return(wrap_EvtClose, 0);
 
     win_whodata_release_resources(&syscheck.wdata);
 
+    assert_null(evt_subscribe_handle);
+}
+
+/**********************************whodata_process_events**************************************/
+static void expect_whodata_callback_render_error(EVT_HANDLE event) {
+    expect_value(__wrap_atomic_int_get, atomic, &whodata_end);
+    will_return(__wrap_atomic_int_get, 0);
+
+    // Inside whodata_callback
+    expect_value(wrap_EvtRender, Context, context);
+    expect_value(wrap_EvtRender, Fragment, event);
+    expect_value(wrap_EvtRender, Flags, EvtRenderEventValues);
+    expect_value(wrap_EvtRender, BufferSize, 0);
+    will_return(wrap_EvtRender, NULL);
+    will_return(wrap_EvtRender, 0);
+    will_return(wrap_EvtRender, 0);
+    will_return(wrap_EvtRender, 0);
+
+    will_return(wrap_GetLastError, 500);
+    expect_string(__wrap__mwarn, formatted_msg, "(6933): Error rendering the event. Error 500.");
+
+    will_return(wrap_EvtClose, 1);
+}
+
+void test_whodata_process_events_timeout(void **state) {
+    whodata_signal = (HANDLE)4321;
+
+    expect_value(wrap_WaitForSingleObjectEx, hHandle, (HANDLE)4321);
+    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, 1000);
+    expect_value(wrap_WaitForSingleObjectEx, bAlertable, FALSE);
+    will_return(wrap_WaitForSingleObjectEx, WAIT_TIMEOUT);
+
+    assert_int_equal(whodata_process_events(1000), 0);
+}
+
+void test_whodata_process_events_batch(void **state) {
+    EVT_HANDLE events[] = { (EVT_HANDLE)10, (EVT_HANDLE)20 };
+
+    whodata_signal = (HANDLE)4321;
+    reset_render_buffer();
+
+    expect_value(wrap_WaitForSingleObjectEx, hHandle, (HANDLE)4321);
+    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, 1000);
+    expect_value(wrap_WaitForSingleObjectEx, bAlertable, FALSE);
+    will_return(wrap_WaitForSingleObjectEx, WAIT_OBJECT_0);
+
+    expect_value(wrap_ResetEvent, hEvent, (HANDLE)4321);
+    will_return(wrap_ResetEvent, 1);
+
+    // Both events come in the same batch
+    expect_EvtNext_call(events, 2);
+    expect_whodata_callback_render_error(events[0]);
+    expect_whodata_callback_render_error(events[1]);
+
+    expect_value(__wrap_atomic_int_get, atomic, &whodata_end);
+    will_return(__wrap_atomic_int_get, 0);
+
+    expect_EvtNext_call(NULL, 0);
+    will_return(wrap_GetLastError, ERROR_NO_MORE_ITEMS);
+
+    assert_int_equal(whodata_process_events(1000), 2);
+}
+
+void test_whodata_process_events_released(void **state) {
+    EVT_HANDLE events[] = { (EVT_HANDLE)10, (EVT_HANDLE)20 };
+
+    whodata_signal = (HANDLE)4321;
+
+    expect_value(wrap_WaitForSingleObjectEx, hHandle, (HANDLE)4321);
+    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, 1000);
+    expect_value(wrap_WaitForSingleObjectEx, bAlertable, FALSE);
+    will_return(wrap_WaitForSingleObjectEx, WAIT_OBJECT_0);
+
+    expect_value(wrap_ResetEvent, hEvent, (HANDLE)4321);
+    will_return(wrap_ResetEvent, 1);
+
+    expect_EvtNext_call(events, 2);
+
+    // The whodata resources were released, the events are only closed
+    expect_value_count(__wrap_atomic_int_get, atomic, &whodata_end, 3);
+    will_return_count(__wrap_atomic_int_get, 1, 3);
+    will_return_count(wrap_EvtClose, 1, 2);
+
+    assert_int_equal(whodata_process_events(1000), 0);
+}
+
+void test_whodata_process_events_read_error(void **state) {
+    whodata_signal = (HANDLE)4321;
+
+    expect_value(wrap_WaitForSingleObjectEx, hHandle, (HANDLE)4321);
+    expect_value(wrap_WaitForSingleObjectEx, dwMilliseconds, 1000);
+    expect_value(wrap_WaitForSingleObjectEx, bAlertable, FALSE);
+    will_return(wrap_WaitForSingleObjectEx, WAIT_OBJECT_0);
+
+    expect_value(wrap_ResetEvent, hEvent, (HANDLE)4321);
+    will_return(wrap_ResetEvent, 1);
+
+    expect_EvtNext_call(NULL, 0);
+    will_return(wrap_GetLastError, ERROR_INVALID_HANDLE);
+    expect_string(__wrap__mwarn, formatted_msg, "(6958): Unable to read the whodata events (6).");
+
+    assert_int_equal(whodata_process_events(1000), 0);
+}
+
+/**********************************whodata_expire_handles**************************************/
+void test_whodata_expire_handles_no_table(void **state) {
+    syscheck.wdata.fd = NULL;
+
+    assert_int_equal(whodata_expire_handles(500), 0);
+}
+
+void test_whodata_expire_handles(void **state) {
+    whodata_evt *stale_evt = calloc(1, sizeof(whodata_evt));
+    whodata_evt *recent_evt = calloc(1, sizeof(whodata_evt));
+
+    if (stale_evt == NULL || recent_evt == NULL) {
+        fail();
+    }
+
+    will_return_count(__wrap_os_random, 12345, 2);
+    syscheck.wdata.fd = __real_OSHash_Create();
+
+    stale_evt->last_event = 100;
+    recent_evt->last_event = 1000;
+
+    if (__real_OSHash_Add(syscheck.wdata.fd, "1", stale_evt) != 2 ||
+        __real_OSHash_Add(syscheck.wdata.fd, "2", recent_evt) != 2) {
+        fail();
+    }
+
+    expect_function_call_any(__wrap_pthread_rwlock_wrlock);
+    expect_function_call_any(__wrap_pthread_rwlock_unlock);
+
+    expect_value(__wrap_free_whodata_event, w_evt, stale_evt);
+    expect_string(__wrap__mdebug1, formatted_msg, "(6380): 1 whodata handles without close event expired.");
+
+    assert_int_equal(whodata_expire_handles(500), 1);
+
+    assert_null(__real_OSHash_Get(syscheck.wdata.fd, "1"));
+    assert_ptr_equal(__real_OSHash_Get(syscheck.wdata.fd, "2"), recent_evt);
+
+    OSHash_Free(syscheck.wdata.fd);
+    syscheck.wdata.fd = NULL;
+    free(stale_evt);
+    free(recent_evt);
 }
 
 /**************************************************************************/
@@ -8201,7 +8516,8 @@ int main(void) {
         /* whodata_event_render */
         cmocka_unit_test(test_whodata_event_render_fail_to_render_event),
         cmocka_unit_test(test_whodata_event_render_wrong_property_count),
-        cmocka_unit_test_teardown(test_whodata_event_render_success, teardown_memblock),
+        cmocka_unit_test(test_whodata_event_render_success),
+        cmocka_unit_test(test_whodata_event_render_reuse_buffer),
         /* whodata_get_event_id */
         cmocka_unit_test(test_whodata_get_event_id_null_raw_data),
         cmocka_unit_test(test_whodata_get_event_id_null_event_id),
@@ -8241,6 +8557,7 @@ int main(void) {
         cmocka_unit_test(test_run_whodata_scan_no_auto_audit_policies),
         cmocka_unit_test(test_run_whodata_scan_error_event_channel),
         cmocka_unit_test(test_run_whodata_scan_success),
+        cmocka_unit_test(test_run_whodata_scan_error_thread),
         /* set_subscription_query */
         cmocka_unit_test(test_set_subscription_query),
         /* set_policies */
@@ -8264,6 +8581,14 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_policy_check_AuditQuerySystemPolicy_fail, setup_policy_check, teardown_policy_check),
         /* win_whodata_release_resources */
         cmocka_unit_test(test_win_whodata_release_resources),
+        /* whodata_process_events */
+        cmocka_unit_test(test_whodata_process_events_timeout),
+        cmocka_unit_test(test_whodata_process_events_batch),
+        cmocka_unit_test(test_whodata_process_events_released),
+        cmocka_unit_test(test_whodata_process_events_read_error),
+        /* whodata_expire_handles */
+        cmocka_unit_test(test_whodata_expire_handles_no_table),
+        cmocka_unit_test(test_whodata_expire_handles),
     };
     const struct CMUnitTest whodata_callback_tests[] = {
         /* whodata_callback */
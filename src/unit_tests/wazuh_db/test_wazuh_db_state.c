@@ -21,6 +21,18 @@ extern wdb_state_t wdb_state;
 static int test_setup(void ** state) {
     wdb_state.uptime = 123456789;
     wdb_state.queries_total = 856;
+    wdb_state.commits_total = 12;
+    wdb_state.commits_breakdown.changes_commits = 4;
+    wdb_state.commits_breakdown.time_commits = 8;
+    wdb_state.commits_breakdown.latency[0] = 7;
+    wdb_state.commits_breakdown.latency[2] = 4;
+    wdb_state.commits_breakdown.latency[4] = 1;
+    wdb_state.databases_breakdown.open_hits = 120;
+    wdb_state.databases_breakdown.open_misses = 6;
+    wdb_state.databases_breakdown.closed = 2;
+    wdb_state.databases_breakdown.prepared_statements = 35;
+    wdb_state.databases_breakdown.prepare_time.tv_sec = 0;
+    wdb_state.databases_breakdown.prepare_time.tv_usec = 4500;
     wdb_state.queries_breakdown.wazuhdb_queries = 212;
     wdb_state.queries_breakdown.wazuhdb_breakdown.remove_queries = 212;
     wdb_state.queries_breakdown.wazuhdb_breakdown.remove_time.tv_sec = 0;
@@ -143,6 +155,8 @@ static int test_setup(void ** state) {
     wdb_state.queries_breakdown.global_breakdown.agent.get_agent_info_queries = 2;
     wdb_state.queries_breakdown.global_breakdown.agent.get_all_agents_queries = 1;
     wdb_state.queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_queries = 0;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_changes_queries = 0;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_queries = 0;
     wdb_state.queries_breakdown.global_breakdown.agent.disconnect_agents_queries = 2;
     wdb_state.queries_breakdown.global_breakdown.agent.sync_agent_info_get_queries = 1;
     wdb_state.queries_breakdown.global_breakdown.agent.sync_agent_info_set_queries = 2;
@@ -190,6 +204,10 @@ static int test_setup(void ** state) {
     wdb_state.queries_breakdown.global_breakdown.agent.get_all_agents_time.tv_usec = 25101;
     wdb_state.queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_time.tv_sec = 1;
     wdb_state.queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_time.tv_usec = 2000;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_changes_time.tv_sec = 0;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_changes_time.tv_usec = 0;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time.tv_sec = 0;
+    wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time.tv_usec = 0;
     wdb_state.queries_breakdown.global_breakdown.agent.disconnect_agents_time.tv_sec = 0;
     wdb_state.queries_breakdown.global_breakdown.agent.disconnect_agents_time.tv_usec= 412480;
     wdb_state.queries_breakdown.global_breakdown.agent.sync_agent_info_get_time.tv_sec = 0;
@@ -273,6 +291,47 @@ void test_wazuhdb_create_state_json(void ** state) {
     assert_non_null(cJSON_GetObjectItem(state_json, "metrics"));
     cJSON* metrics = cJSON_GetObjectItem(state_json, "metrics");
 
+    assert_non_null(cJSON_GetObjectItem(metrics, "commits"));
+    cJSON* commits = cJSON_GetObjectItem(metrics, "commits");
+
+    assert_int_equal(cJSON_GetObjectItem(commits, "total")->valueint, 12);
+
+    cJSON* commits_breakdown = cJSON_GetObjectItem(commits, "total_breakdown");
+    assert_int_equal(cJSON_GetObjectItem(commits_breakdown, "changes")->valueint, 4);
+    assert_int_equal(cJSON_GetObjectItem(commits_breakdown, "time")->valueint, 8);
+
+    cJSON* commits_latency = cJSON_GetObjectItem(commits, "latency");
+    assert_int_equal(cJSON_GetObjectItem(commits_latency, "1ms")->valueint, 7);
+    assert_int_equal(cJSON_GetObjectItem(commits_latency, "10ms")->valueint, 0);
+    assert_int_equal(cJSON_GetObjectItem(commits_latency, "100ms")->valueint, 4);
+    assert_int_equal(cJSON_GetObjectItem(commits_latency, "1s")->valueint, 0);
+    assert_int_equal(cJSON_GetObjectItem(commits_latency, "slower")->valueint, 1);
+
+    assert_non_null(cJSON_GetObjectItem(metrics, "databases"));
+    cJSON* databases = cJSON_GetObjectItem(metrics, "databases");
+
+    assert_int_equal(cJSON_GetObjectItem(databases, "closed")->valueint, 2);
+
+    cJSON* databases_open = cJSON_GetObjectItem(databases, "open");
+    assert_int_equal(cJSON_GetObjectItem(databases_open, "hits")->valueint, 120);
+    assert_int_equal(cJSON_GetObjectItem(databases_open, "misses")->valueint, 6);
+
+    cJSON* databases_statements = cJSON_GetObjectItem(databases, "statements");
+    assert_int_equal(cJSON_GetObjectItem(databases_statements, "prepared")->valueint, 35);
+    assert_int_equal(cJSON_GetObjectItem(databases_statements, "time")->valueint, 4);
+
+    assert_non_null(cJSON_GetObjectItem(metrics, "memory"));
+    cJSON* memory = cJSON_GetObjectItem(metrics, "memory");
+
+    cJSON* memory_databases = cJSON_GetObjectItem(memory, "databases");
+    assert_non_null(memory_databases);
+    assert_int_equal(cJSON_GetObjectItem(memory_databases, "open")->valueint, 0);
+    assert_int_equal(cJSON_GetArraySize(cJSON_GetObjectItem(memory_databases, "largest")), 0);
+
+    cJSON* memory_sqlite = cJSON_GetObjectItem(memory, "sqlite");
+    assert_non_null(cJSON_GetObjectItem(memory_sqlite, "used"));
+    assert_non_null(cJSON_GetObjectItem(memory_sqlite, "highwater"));
+
     assert_non_null(cJSON_GetObjectItem(metrics, "queries"));
     cJSON* queries = cJSON_GetObjectItem(metrics, "queries");
 
@@ -416,6 +475,10 @@ void test_wazuhdb_create_state_json(void ** state) {
     assert_int_equal(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-all-agents")->valueint, 1);
     assert_non_null(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-agents-by-connection-status"));
     assert_int_equal(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-agents-by-connection-status")->valueint, 0);
+    assert_non_null(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-changes"));
+    assert_int_equal(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-changes")->valueint, 0);
+    assert_non_null(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-agents-info-by-connection-status"));
+    assert_int_equal(cJSON_GetObjectItem(global_agent_queries_breakdown, "get-agents-info-by-connection-status")->valueint, 0);
     assert_non_null(cJSON_GetObjectItem(global_agent_queries_breakdown, "disconnect-agents"));
     assert_int_equal(cJSON_GetObjectItem(global_agent_queries_breakdown, "disconnect-agents")->valueint, 2);
     assert_non_null(cJSON_GetObjectItem(global_agent_queries_breakdown, "sync-agent-info-get"));
@@ -639,6 +702,10 @@ void test_wazuhdb_create_state_json(void ** state) {
     assert_int_equal(cJSON_GetObjectItem(global_agent_time_breakdown, "get-all-agents")->valueint, 25);
     assert_non_null(cJSON_GetObjectItem(global_agent_time_breakdown, "get-agents-by-connection-status"));
     assert_int_equal(cJSON_GetObjectItem(global_agent_time_breakdown, "get-agents-by-connection-status")->valueint, 1002);
+    assert_non_null(cJSON_GetObjectItem(global_agent_time_breakdown, "get-changes"));
+    assert_int_equal(cJSON_GetObjectItem(global_agent_time_breakdown, "get-changes")->valueint, 0);
+    assert_non_null(cJSON_GetObjectItem(global_agent_time_breakdown, "get-agents-info-by-connection-status"));
+    assert_int_equal(cJSON_GetObjectItem(global_agent_time_breakdown, "get-agents-info-by-connection-status")->valueint, 0);
     assert_non_null(cJSON_GetObjectItem(global_agent_time_breakdown, "disconnect-agents"));
     assert_int_equal(cJSON_GetObjectItem(global_agent_time_breakdown, "disconnect-agents")->valueint, 412);
     assert_non_null(cJSON_GetObjectItem(global_agent_time_breakdown, "sync-agent-info-get"));
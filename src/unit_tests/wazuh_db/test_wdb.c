@@ -34,8 +34,11 @@ int wdb_execute_non_select_query(sqlite3 *db, const char *query);
 int wdb_select_from_temp_table(sqlite3 *db);
 int wdb_get_last_vacuum_data(wdb_t* wdb, int *last_vacuum_time, int *last_vacuum_value);
 int wdb_execute_single_int_select_query(wdb_t * wdb, const char *query, int *value);
+wdb_t * wdb_pool_sort_lru(wdb_t * list);
+void wdb_set_agent_cache(sqlite3 * db);
 
 extern wdb_t * db_pool_begin;
+extern wdb_t ** db_global_readers;
 
 typedef struct test_struct {
     wdb_t *wdb;
@@ -165,6 +168,108 @@ void test_wdb_open_global_pool_success(void **state)
     assert_int_equal(ret, data->wdb);
 }
 
+void test_wdb_open_global_reader_disabled(void **state)
+{
+    wconfig.global_readers = 0;
+
+    assert_null(wdb_open_global_reader());
+}
+
+void test_wdb_open_global_reader_no_writer(void **state)
+{
+    wconfig.global_readers = 2;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, WDB_GLOB_NAME);
+    will_return(__wrap_OSHash_Get, NULL);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    assert_null(wdb_open_global_reader());
+
+    wconfig.global_readers = 0;
+}
+
+void test_wdb_open_global_reader_success(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+    wdb_t *ret = NULL;
+
+    wconfig.global_readers = 2;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, WDB_GLOB_NAME);
+    will_return(__wrap_OSHash_Get, data->wdb);
+
+    expect_string(__wrap_sqlite3_open_v2, filename, "queue/db/global.db");
+    will_return(__wrap_sqlite3_open_v2, (sqlite3 *)1);
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READONLY);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_OK);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    ret = wdb_open_global_reader();
+
+    assert_non_null(ret);
+    assert_ptr_equal(ret, db_global_readers[0]);
+    assert_null(db_global_readers[1]);
+    assert_int_equal(ret->refcount, 1);
+    assert_string_equal(ret->id, WDB_GLOB_NAME);
+
+    // An idle reader is reused
+    ret->refcount = 0;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, WDB_GLOB_NAME);
+    will_return(__wrap_OSHash_Get, data->wdb);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    assert_ptr_equal(wdb_open_global_reader(), ret);
+    assert_null(db_global_readers[1]);
+
+    wdb_destroy(ret);
+    os_free(db_global_readers);
+    wconfig.global_readers = 0;
+}
+
+void test_wdb_set_agent_cache_disabled(void **state)
+{
+    wconfig.agent_cache_size = 0;
+
+    wdb_set_agent_cache((sqlite3 *)1);
+}
+
+void test_wdb_set_agent_cache_success(void **state)
+{
+    wconfig.agent_cache_size = 1024;
+
+    expect_string(__wrap_sqlite3_exec, sql, "PRAGMA cache_size = -1024;");
+    will_return(__wrap_sqlite3_exec, NULL);
+    will_return(__wrap_sqlite3_exec, SQLITE_OK);
+
+    wdb_set_agent_cache((sqlite3 *)1);
+
+    wconfig.agent_cache_size = 0;
+}
+
+void test_wdb_set_agent_cache_error(void **state)
+{
+    wconfig.agent_cache_size = 1024;
+
+    expect_string(__wrap_sqlite3_exec, sql, "PRAGMA cache_size = -1024;");
+    will_return(__wrap_sqlite3_exec, NULL);
+    will_return(__wrap_sqlite3_exec, SQLITE_ERROR);
+    expect_string(__wrap__mdebug1, formatted_msg, "Cannot set the cache size of an agent database: unknown error");
+
+    wdb_set_agent_cache((sqlite3 *)1);
+
+    wconfig.agent_cache_size = 0;
+}
+
 void test_wdb_open_global_create_fail(void **state)
 {
     wdb_t *ret = NULL;
@@ -526,6 +631,13 @@ void test_wdb_exec_stmt_silent_invalid(void **state) {
 
 /* Tests wdb_exec_stmt_send */
 
+/* Frame a message into a buffer as OS_SendSecureTCP() does */
+static size_t frame_message(char * buffer, const char * format, const char * payload) {
+    int length = sprintf(buffer + sizeof(uint32_t), format, payload);
+    *(uint32_t *)buffer = wnet_order(length);
+    return sizeof(uint32_t) + length;
+}
+
 void test_wdb_exec_stmt_send_single_row_success(void **state) {
     test_struct_t *data  = (test_struct_t *)*state;
     int peer = 1234;
@@ -550,11 +662,11 @@ void test_wdb_exec_stmt_send_single_row_success(void **state) {
     will_return(__wrap_sqlite3_column_double, json_value);
     expect_sqlite3_step_call(SQLITE_DONE);
 
-    os_snprintf(command_result, OS_MAXSTR, "due %s", str_query_result);
-    expect_value(__wrap_OS_SendSecureTCP, sock, peer);
-    expect_value(__wrap_OS_SendSecureTCP, size, strlen(command_result));
-    expect_string(__wrap_OS_SendSecureTCP, msg, command_result);
-    will_return(__wrap_OS_SendSecureTCP, 0);
+    size_t frames_size = frame_message(command_result, "due %s", str_query_result);
+    expect_value(__wrap_OS_SendSecureTCPFrames, sock, peer);
+    expect_value(__wrap_OS_SendSecureTCPFrames, size, frames_size);
+    expect_memory(__wrap_OS_SendSecureTCPFrames, frames, command_result, frames_size);
+    will_return(__wrap_OS_SendSecureTCPFrames, 0);
 
     int result = wdb_exec_stmt_send(*data->wdb->stmt, peer);
 
@@ -590,11 +702,15 @@ void test_wdb_exec_stmt_send_multiple_rows_success(void **state) {
     will_return_count(__wrap_sqlite3_column_double, json_value, ROWS_RESPONSE);
     expect_sqlite3_step_call(SQLITE_DONE);
 
-    os_snprintf(command_result, OS_MAXSTR, "due %s", str_query_result);
-    expect_value_count(__wrap_OS_SendSecureTCP, sock, peer, ROWS_RESPONSE);
-    expect_value_count(__wrap_OS_SendSecureTCP, size, strlen(command_result), ROWS_RESPONSE);
-    expect_string_count(__wrap_OS_SendSecureTCP, msg, command_result, ROWS_RESPONSE);
-    will_return_count(__wrap_OS_SendSecureTCP, 0, ROWS_RESPONSE);
+    // Every row takes one message, and all of them are sent together
+    size_t frames_size = 0;
+    for (int i = 0; i < ROWS_RESPONSE; i++) {
+        frames_size += frame_message(command_result + frames_size, "due %s", str_query_result);
+    }
+    expect_value(__wrap_OS_SendSecureTCPFrames, sock, peer);
+    expect_value(__wrap_OS_SendSecureTCPFrames, size, frames_size);
+    expect_memory(__wrap_OS_SendSecureTCPFrames, frames, command_result, frames_size);
+    will_return(__wrap_OS_SendSecureTCPFrames, 0);
 
     int result = wdb_exec_stmt_send(*data->wdb->stmt, peer);
 
@@ -605,6 +721,42 @@ void test_wdb_exec_stmt_send_multiple_rows_success(void **state) {
     os_free(command_result);
 }
 
+void test_wdb_exec_stmt_send_escaped_text_success(void **state) {
+    test_struct_t *data  = (test_struct_t *)*state;
+    int peer = 1234;
+    const char* json_str = "COLUMN";
+    const char* json_value = "quote \" backslash \\ newline \n tab \t bell \a";
+    char* command_result = NULL;
+    os_calloc(OS_MAXSTR, sizeof(char), command_result);
+
+    will_return(__wrap_OS_SetSendTimeout, 0);
+
+    //Calling wdb_exec_row_stmt
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_sqlite3_column_count, 2);
+    expect_any_count(__wrap_sqlite3_column_type, i, 2);
+    will_return(__wrap_sqlite3_column_type, SQLITE_NULL);
+    will_return(__wrap_sqlite3_column_type, SQLITE_TEXT);
+    expect_any(__wrap_sqlite3_column_name, N);
+    will_return(__wrap_sqlite3_column_name, json_str);
+    expect_any(__wrap_sqlite3_column_text, iCol);
+    will_return(__wrap_sqlite3_column_text, json_value);
+    expect_sqlite3_step_call(SQLITE_DONE);
+
+    size_t frames_size = frame_message(command_result, "due %s",
+                                       "{\"COLUMN\":\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007\"}");
+    expect_value(__wrap_OS_SendSecureTCPFrames, sock, peer);
+    expect_value(__wrap_OS_SendSecureTCPFrames, size, frames_size);
+    expect_memory(__wrap_OS_SendSecureTCPFrames, frames, command_result, frames_size);
+    will_return(__wrap_OS_SendSecureTCPFrames, 0);
+
+    int result = wdb_exec_stmt_send(*data->wdb->stmt, peer);
+
+    assert_int_equal(result, OS_SUCCESS);
+
+    os_free(command_result);
+}
+
 void test_wdb_exec_stmt_send_no_rows_success(void **state) {
     test_struct_t *data  = (test_struct_t *)*state;
     int peer = 1234;
@@ -677,11 +829,13 @@ void test_wdb_exec_stmt_send_socket_err(void **state) {
     expect_any(__wrap_sqlite3_column_double, iCol);
     will_return(__wrap_sqlite3_column_double, json_value);
 
-    os_snprintf(command_result, OS_MAXSTR, "due %s", str_query_result);
-    expect_value(__wrap_OS_SendSecureTCP, sock, peer);
-    expect_value(__wrap_OS_SendSecureTCP, size, strlen(command_result));
-    expect_string(__wrap_OS_SendSecureTCP, msg, command_result);
-    will_return(__wrap_OS_SendSecureTCP, -1);
+    expect_sqlite3_step_call(SQLITE_DONE);
+
+    size_t frames_size = frame_message(command_result, "due %s", str_query_result);
+    expect_value(__wrap_OS_SendSecureTCPFrames, sock, peer);
+    expect_value(__wrap_OS_SendSecureTCPFrames, size, frames_size);
+    expect_memory(__wrap_OS_SendSecureTCPFrames, frames, command_result, frames_size);
+    will_return(__wrap_OS_SendSecureTCPFrames, -1);
 
     will_return(__wrap_strerror, "error");
     expect_string(__wrap__merror, formatted_msg, "Socket 1234 error: error (0)");
@@ -3092,6 +3246,222 @@ void test_wdb_check_fragmentation_vacuum_current_fragmentation_delta(void **stat
     os_free(db_pool_begin);
 }
 
+/* Tests wdb_incremental_vacuum */
+
+void test_wdb_incremental_vacuum_prepare_error(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    bool finished = true;
+
+    will_return(__wrap_sqlite3_prepare_v2, NULL);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    expect_string(__wrap__mdebug1, formatted_msg, "SQLite: ERROR MESSAGE");
+
+    assert_int_equal(wdb_incremental_vacuum(db, 100, &finished), OS_INVALID);
+    assert_false(finished);
+}
+
+void test_wdb_incremental_vacuum_step_error(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    bool finished = true;
+
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    expect_string(__wrap__mdebug1, formatted_msg, "wdb_step(): ERROR MESSAGE");
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    assert_int_equal(wdb_incremental_vacuum(db, 100, &finished), OS_INVALID);
+    assert_false(finished);
+}
+
+void test_wdb_incremental_vacuum_finished(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    bool finished = false;
+
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_time_diff, 0.01);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_time_diff, 0.02);
+    expect_sqlite3_step_call(SQLITE_DONE);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    assert_int_equal(wdb_incremental_vacuum(db, 100, &finished), 2);
+    assert_true(finished);
+}
+
+void test_wdb_incremental_vacuum_budget_exhausted(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    bool finished = true;
+
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_time_diff, 0.05);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_time_diff, 0.1);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    assert_int_equal(wdb_incremental_vacuum(db, 100, &finished), 2);
+    assert_false(finished);
+}
+
+/* Tests wdb_check_fragmentation in incremental mode */
+
+void test_wdb_check_fragmentation_incremental_pending(void **state)
+{
+    wconfig.incremental_vacuum_budget = 100;
+    wconfig.free_pages_percentage = 5;
+    os_calloc(1,sizeof(wdb_t),db_pool_begin);
+    os_strdup("000",db_pool_begin->id);
+    os_calloc(1,sizeof(sqlite3 *),db_pool_begin->db);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, "000");
+    will_return(__wrap_OSHash_Get, db_pool_begin);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    // auto_vacuum mode
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int, iCol, 0);
+    will_return(__wrap_sqlite3_column_int, WDB_AUTO_VACUUM_INCREMENTAL);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    // wdb_get_db_free_pages_percentage
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int, iCol, 0);
+    will_return(__wrap_sqlite3_column_int, 100);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int, iCol, 0);
+    will_return(__wrap_sqlite3_column_int, 10);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    wdb_check_fragmentation();
+
+    assert_true(db_pool_begin->vacuum_pending);
+
+    wconfig.incremental_vacuum_budget = 0;
+    os_free(db_pool_begin->id);
+    os_free(db_pool_begin->db);
+    os_free(db_pool_begin);
+}
+
+/* Tests wdb_incremental_vacuum_idle */
+
+void test_wdb_incremental_vacuum_idle_busy(void **state)
+{
+    wconfig.incremental_vacuum_budget = 100;
+    os_calloc(1,sizeof(wdb_t),db_pool_begin);
+    os_strdup("000",db_pool_begin->id);
+    db_pool_begin->vacuum_pending = true;
+    db_pool_begin->refcount = 1;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, "000");
+    will_return(__wrap_OSHash_Get, db_pool_begin);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    wdb_incremental_vacuum_idle();
+
+    assert_true(db_pool_begin->vacuum_pending);
+
+    wconfig.incremental_vacuum_budget = 0;
+    os_free(db_pool_begin->id);
+    os_free(db_pool_begin);
+}
+
+void test_wdb_incremental_vacuum_idle_success(void **state)
+{
+    wconfig.incremental_vacuum_budget = 100;
+    os_calloc(1,sizeof(wdb_t),db_pool_begin);
+    os_strdup("000",db_pool_begin->id);
+    os_calloc(1,sizeof(sqlite3 *),db_pool_begin->db);
+    db_pool_begin->vacuum_pending = true;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_any(__wrap_OSHash_Get, self);
+    expect_string(__wrap_OSHash_Get, key, "000");
+    will_return(__wrap_OSHash_Get, db_pool_begin);
+
+    expect_function_call(__wrap_pthread_mutex_unlock);
+    expect_function_call(__wrap_pthread_mutex_lock);
+
+    // wdb_incremental_vacuum
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_step_call(SQLITE_ROW);
+    will_return(__wrap_time_diff, 0.001);
+    expect_sqlite3_step_call(SQLITE_DONE);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+    will_return(__wrap_time_diff, 0.002);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Incremental vacuum executed on the '000' database. Pages: 1. Time: 2.000 ms.");
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    wdb_incremental_vacuum_idle();
+
+    assert_false(db_pool_begin->vacuum_pending);
+    assert_int_equal(db_pool_begin->refcount, 0);
+
+    wconfig.incremental_vacuum_budget = 0;
+    os_free(db_pool_begin->id);
+    os_free(db_pool_begin->db);
+    os_free(db_pool_begin);
+}
+
+/* Tests wdb_pool_sort_lru */
+
+void test_wdb_pool_sort_lru_empty(void **state)
+{
+    assert_null(wdb_pool_sort_lru(NULL));
+}
+
+void test_wdb_pool_sort_lru_success(void **state)
+{
+    wdb_t nodes[3] = { { .id = "001", .last = 30 }, { .id = "002", .last = 10 }, { .id = "003", .last = 20 } };
+
+    nodes[0].next = &nodes[1];
+    nodes[1].next = &nodes[2];
+    nodes[2].next = NULL;
+
+    wdb_t * list = wdb_pool_sort_lru(nodes);
+
+    assert_ptr_equal(list, &nodes[1]);
+    assert_ptr_equal(list->next, &nodes[2]);
+    assert_ptr_equal(list->next->next, &nodes[0]);
+    assert_null(list->next->next->next);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
         // wdb_open_tasks
@@ -3099,6 +3469,12 @@ int main() {
         cmocka_unit_test_setup_teardown(test_wdb_open_tasks_create_error, setup_wdb, teardown_wdb),
         // wdb_open_global
         cmocka_unit_test_setup_teardown(test_wdb_open_global_pool_success, setup_wdb, teardown_wdb),
+        cmocka_unit_test(test_wdb_set_agent_cache_disabled),
+        cmocka_unit_test(test_wdb_set_agent_cache_success),
+        cmocka_unit_test(test_wdb_set_agent_cache_error),
+        cmocka_unit_test(test_wdb_open_global_reader_disabled),
+        cmocka_unit_test(test_wdb_open_global_reader_no_writer),
+        cmocka_unit_test_setup_teardown(test_wdb_open_global_reader_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_open_global_create_fail, setup_wdb, teardown_wdb),
         // wdb_exec_row_stm
         cmocka_unit_test_setup_teardown(test_wdb_exec_row_stmt_multi_column_one_int, setup_wdb, teardown_wdb),
@@ -3124,6 +3500,7 @@ int main() {
         // wdb_exec_stmt_send
         cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_single_row_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_multiple_rows_success, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_escaped_text_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_no_rows_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_row_size_limit_err, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_exec_stmt_send_socket_err, setup_wdb, teardown_wdb),
@@ -3202,6 +3579,18 @@ int main() {
         cmocka_unit_test(test_wdb_check_fragmentation_no_vacuum_current_fragmentation_delta),
         cmocka_unit_test(test_wdb_check_fragmentation_vacuum_first),
         cmocka_unit_test(test_wdb_check_fragmentation_vacuum_current_fragmentation_delta),
+        // wdb_incremental_vacuum
+        cmocka_unit_test(test_wdb_incremental_vacuum_prepare_error),
+        cmocka_unit_test(test_wdb_incremental_vacuum_step_error),
+        cmocka_unit_test(test_wdb_incremental_vacuum_finished),
+        cmocka_unit_test(test_wdb_incremental_vacuum_budget_exhausted),
+        cmocka_unit_test(test_wdb_check_fragmentation_incremental_pending),
+        // wdb_incremental_vacuum_idle
+        cmocka_unit_test(test_wdb_incremental_vacuum_idle_busy),
+        cmocka_unit_test(test_wdb_incremental_vacuum_idle_success),
+        // wdb_pool_sort_lru
+        cmocka_unit_test(test_wdb_pool_sort_lru_empty),
+        cmocka_unit_test(test_wdb_pool_sort_lru_success),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -381,6 +381,106 @@ void test_wdb_insert_vuln_cves_success(void **state)
     free_strarray(external_references);
 }
 
+/* Tests wdb_insert_vuln_cves_batch */
+
+void test_wdb_insert_vuln_cves_batch_success(void **state)
+{
+    cJSON *ret = NULL;
+    int id = 1;
+    int sock = 1;
+    cJSON *batch = __real_cJSON_CreateArray();
+    cJSON *results = __real_cJSON_CreateArray();
+    cJSON *pack_results = __real_cJSON_CreateArray();
+    char *item_str = NULL;
+    char *item2_str = NULL;
+
+    __real_cJSON_AddItemToArray(batch, __real_cJSON_CreateObject());
+    __real_cJSON_AddItemToArray(batch, __real_cJSON_CreateObject());
+    __real_cJSON_AddItemToArray(pack_results, __real_cJSON_CreateObject());
+    __real_cJSON_AddItemToArray(pack_results, __real_cJSON_CreateObject());
+    os_strdup("{\"cve\":\"CVE-2021-1001\"}", item_str);
+    os_strdup("{\"cve\":\"CVE-2021-1002\"}", item2_str);
+
+    will_return(__wrap_cJSON_CreateArray, results);
+    will_return(__wrap_cJSON_PrintUnformatted, item_str);
+    will_return(__wrap_cJSON_PrintUnformatted, item2_str);
+
+    // Both vulnerabilities are sent in the same query
+    will_return(__wrap_wdbc_query_parse_json, 0);
+    will_return(__wrap_wdbc_query_parse_json, pack_results);
+
+    // Moving the results
+    expect_function_calls(__wrap_cJSON_AddItemToArray, 2);
+    will_return_count(__wrap_cJSON_AddItemToArray, true, 2);
+
+    //Cleaning  memory
+    expect_function_calls(__wrap_cJSON_Delete, 2);
+
+    ret = wdb_insert_vuln_cves_batch(id, &batch, &sock);
+
+    assert_ptr_equal(results, ret);
+    assert_null(batch);
+    assert_int_equal(0, cJSON_GetArraySize(pack_results));
+    __real_cJSON_Delete(pack_results);
+    __real_cJSON_Delete(results);
+}
+
+void test_wdb_insert_vuln_cves_batch_error_sql_execution(void **state)
+{
+    cJSON *ret = NULL;
+    int id = 1;
+    int sock = 1;
+    cJSON *batch = __real_cJSON_CreateArray();
+    cJSON *results = __real_cJSON_CreateArray();
+    char *item_str = NULL;
+
+    __real_cJSON_AddItemToArray(batch, __real_cJSON_CreateObject());
+    os_strdup("{\"cve\":\"CVE-2021-1001\"}", item_str);
+
+    will_return(__wrap_cJSON_CreateArray, results);
+    will_return(__wrap_cJSON_PrintUnformatted, item_str);
+
+    // Calling Wazuh DB
+    will_return(__wrap_wdbc_query_parse_json, 0);
+    will_return(__wrap_wdbc_query_parse_json, NULL);
+
+    // Handling result
+    expect_string(__wrap__merror, formatted_msg, "Agents DB (1) Error querying Wazuh DB to insert vuln_cves");
+    will_return(__wrap_cJSON_CreateObject, (cJSON *)1);
+    expect_string(__wrap_cJSON_AddStringToObject, name, "status");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "ERROR");
+    will_return(__wrap_cJSON_AddStringToObject, (cJSON *)1);
+    expect_function_call(__wrap_cJSON_AddItemToArray);
+    will_return(__wrap_cJSON_AddItemToArray, true);
+
+    //Cleaning  memory
+    expect_function_calls(__wrap_cJSON_Delete, 2);
+
+    ret = wdb_insert_vuln_cves_batch(id, &batch, &sock);
+
+    assert_ptr_equal(results, ret);
+    assert_null(batch);
+    __real_cJSON_Delete(results);
+}
+
+void test_wdb_insert_vuln_cves_batch_error_json(void **state)
+{
+    cJSON *ret = NULL;
+    int id = 1;
+    int sock = 1;
+    cJSON *batch = NULL;
+
+    will_return(__wrap_cJSON_CreateArray, NULL);
+
+    expect_string(__wrap__mdebug1, formatted_msg, "Error creating data JSON for Wazuh DB.");
+    expect_function_call(__wrap_cJSON_Delete);
+
+    ret = wdb_insert_vuln_cves_batch(id, &batch, &sock);
+
+    assert_null(ret);
+    assert_null(batch);
+}
+
 /* Tests wdb_update_vuln_cves_status */
 
 void test_wdb_update_vuln_cves_status_error_json(void **state){
@@ -1124,6 +1224,10 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_null_parameters, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_error_sql_execution, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_success, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
+        /* Tests wdb_insert_vuln_cves_batch */
+        cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_batch_success, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
+        cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_batch_error_sql_execution, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
+        cmocka_unit_test_setup_teardown(test_wdb_insert_vuln_cves_batch_error_json, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
         /* Tests wdb_update_vuln_cves_status*/
         cmocka_unit_test_setup_teardown(test_wdb_update_vuln_cves_status_error_json, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_update_vuln_cves_status_error_socket, setup_wdb_agents_helpers, teardown_wdb_agents_helpers),
@@ -7048,6 +7048,164 @@ void test_wdb_global_get_agents_by_connection_status_and_node_err(void **state)
     assert_null(result);
 }
 
+/* Tests wdb_global_get_agents_info_by_connection_status */
+
+void test_wdb_global_get_agents_info_by_connection_status_transaction_fail(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    will_return(__wrap_wdb_begin2, -1);
+    expect_string(__wrap__mdebug1, formatted_msg, "Cannot begin transaction");
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_agents_info_by_connection_status(data->wdb, 0, "active", &status);
+
+    assert_int_equal(status, WDBC_ERROR);
+    assert_null(result);
+}
+
+void test_wdb_global_get_agents_info_by_connection_status_bind_fail(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    will_return(__wrap_wdb_begin2, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    expect_value(__wrap_sqlite3_bind_int, index, 1);
+    expect_value(__wrap_sqlite3_bind_int, value, 0);
+    will_return(__wrap_sqlite3_bind_int, SQLITE_OK);
+    expect_value(__wrap_sqlite3_bind_text, pos, 2);
+    expect_string(__wrap_sqlite3_bind_text, buffer, "active");
+    will_return(__wrap_sqlite3_bind_text, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    expect_string(__wrap__merror, formatted_msg, "DB(global) sqlite3_bind_text(): ERROR MESSAGE");
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_agents_info_by_connection_status(data->wdb, 0, "active", &status);
+
+    assert_int_equal(status, WDBC_ERROR);
+    assert_null(result);
+}
+
+void test_wdb_global_get_agents_info_by_connection_status_due(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+    const char connection_status[] = "active";
+    cJSON* root = __real_cJSON_CreateArray();
+    for (int i=1; i<=10; i++){
+        cJSON* json_agent = cJSON_CreateObject();
+        cJSON_AddItemToObject(json_agent, "id", cJSON_CreateNumber(i));
+        cJSON_AddItemToObject(json_agent, "name", cJSON_CreateString("agent"));
+        cJSON_AddItemToArray(root, json_agent);
+    }
+
+    //Preparing statement
+    will_return(__wrap_wdb_begin2, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    expect_value(__wrap_sqlite3_bind_int, index, 1);
+    expect_value(__wrap_sqlite3_bind_int, value, 0);
+    will_return(__wrap_sqlite3_bind_int, SQLITE_OK);
+    expect_value(__wrap_sqlite3_bind_text, pos, 2);
+    expect_string(__wrap_sqlite3_bind_text, buffer, connection_status);
+    will_return(__wrap_sqlite3_bind_text, SQLITE_OK);
+    //Executing statement
+    wrap_wdb_exec_stmt_sized_socket_full_call(root, STMT_MULTI_COLUMN);
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_agents_info_by_connection_status(data->wdb, 0, connection_status, &status);
+
+    assert_int_equal(status, WDBC_DUE);
+    assert_ptr_equal(result, root);
+
+    __real_cJSON_Delete(root);
+}
+
+/* Tests wdb_global_get_changes */
+
+void test_wdb_global_get_changes_transaction_fail(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    will_return(__wrap_wdb_begin2, -1);
+    expect_string(__wrap__mdebug1, formatted_msg, "Cannot begin transaction");
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_changes(data->wdb, 0, -1, &status);
+
+    assert_int_equal(status, WDBC_ERROR);
+    assert_null(result);
+}
+
+void test_wdb_global_get_changes_oldest_step_fail(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    will_return(__wrap_wdb_begin2, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    will_return(__wrap_wdb_step, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    expect_string(__wrap__mdebug1, formatted_msg, "DB(global) Cannot get the oldest change: ERROR MESSAGE");
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_changes(data->wdb, 0, -1, &status);
+
+    assert_int_equal(status, WDBC_ERROR);
+    assert_null(result);
+}
+
+void test_wdb_global_get_changes_bind_fail(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    will_return(__wrap_wdb_begin2, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    will_return(__wrap_wdb_step, SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int64, iCol, 0);
+    will_return(__wrap_sqlite3_column_int64, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    expect_sqlite3_bind_int64_call(1, 5, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    expect_string(__wrap__merror, formatted_msg, "DB(global) sqlite3_bind_int64(): ERROR MESSAGE");
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_changes(data->wdb, 5, -1, &status);
+
+    assert_int_equal(status, WDBC_ERROR);
+    assert_null(result);
+}
+
+void test_wdb_global_get_changes_ok(void **state)
+{
+    test_struct_t *data  = (test_struct_t *)*state;
+    cJSON* root = __real_cJSON_CreateArray();
+    cJSON* json_change = cJSON_CreateObject();
+    cJSON_AddNumberToObject(json_change, "seq", 6);
+    cJSON_AddNumberToObject(json_change, "id", 1);
+    cJSON_AddStringToObject(json_change, "operation", "update");
+    cJSON_AddItemToArray(root, json_change);
+
+    will_return(__wrap_wdb_begin2, 1);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    will_return(__wrap_wdb_step, SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int64, iCol, 0);
+    will_return(__wrap_sqlite3_column_int64, 3);
+    will_return(__wrap_wdb_stmt_cache, 1);
+    expect_sqlite3_bind_int64_call(1, 5, SQLITE_OK);
+    expect_value(__wrap_sqlite3_bind_int, index, 2);
+    expect_value(__wrap_sqlite3_bind_int, value, 100);
+    will_return(__wrap_sqlite3_bind_int, SQLITE_OK);
+    wrap_wdb_exec_stmt_sized_success_call(root, STMT_MULTI_COLUMN);
+
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_changes(data->wdb, 5, 100, &status);
+
+    assert_int_equal(status, WDBC_OK);
+    assert_non_null(result);
+    assert_int_equal(cJSON_GetObjectItem(result, "oldest_seq")->valueint, 3);
+    assert_ptr_equal(cJSON_GetObjectItem(result, "changes"), root);
+
+    __real_cJSON_Delete(result);
+}
+
 /* Tests wdb_global_create_backup */
 
 void test_wdb_global_create_backup_commit_failed(void **state) {
@@ -7208,6 +7366,120 @@ void test_wdb_global_create_backup_success(void **state) {
     __real_cJSON_Delete(j_path);
 }
 
+/* Tests wdb_global_create_backup_online */
+
+void test_wdb_global_create_backup_online_open_failed(void **state) {
+    test_struct_t *data  = (test_struct_t *)*state;
+    int result = OS_INVALID;
+    char* test_date = strdup("2015/11/23 12:00:00");
+
+    will_return(__wrap_time, (time_t)0);
+    expect_value(__wrap_w_get_timestamp, time, 0);
+    will_return(__wrap_w_get_timestamp, test_date);
+
+    expect_string(__wrap_sqlite3_open_v2, filename, "queue/db/global.db");
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READONLY);
+    will_return(__wrap_sqlite3_open_v2, NULL);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_CANTOPEN);
+    will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
+    will_return(__wrap_sqlite3_close_v2, SQLITE_OK);
+
+    result = wdb_global_create_backup_online(data->output, "-tag");
+
+    assert_string_equal(data->output, "err Can't open SQLite database 'queue/db/global.db': ERROR MESSAGE");
+    assert_int_equal(result, OS_INVALID);
+}
+
+void test_wdb_global_create_backup_online_step_failed(void **state) {
+    test_struct_t *data  = (test_struct_t *)*state;
+    int result = OS_INVALID;
+    char* test_date = strdup("2015/11/23 12:00:00");
+
+    will_return(__wrap_time, (time_t)0);
+    expect_value(__wrap_w_get_timestamp, time, 0);
+    will_return(__wrap_w_get_timestamp, test_date);
+
+    expect_string(__wrap_sqlite3_open_v2, filename, "queue/db/global.db");
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READONLY);
+    will_return(__wrap_sqlite3_open_v2, (sqlite3 *)1);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_OK);
+    expect_string(__wrap_sqlite3_open_v2, filename, "backup/db/global.db-backup-2015-11-23-12:00:00-tag");
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    will_return(__wrap_sqlite3_open_v2, (sqlite3 *)2);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_OK);
+    will_return(__wrap_sqlite3_backup_init, (sqlite3_backup *)1);
+
+    expect_value(__wrap_sqlite3_backup_step, nPage, WDB_BACKUP_STEP_PAGES);
+    will_return(__wrap_sqlite3_backup_step, SQLITE_IOERR);
+    will_return(__wrap_sqlite3_backup_finish, SQLITE_IOERR);
+    will_return(__wrap_sqlite3_errmsg, "disk I/O error");
+    will_return(__wrap_sqlite3_close_v2, SQLITE_OK);
+    will_return(__wrap_sqlite3_close_v2, SQLITE_OK);
+    expect_string(__wrap_unlink, file, "backup/db/global.db-backup-2015-11-23-12:00:00-tag");
+    will_return(__wrap_unlink, OS_SUCCESS);
+
+    result = wdb_global_create_backup_online(data->output, "-tag");
+
+    assert_string_equal(data->output, "err SQLite: disk I/O error");
+    assert_int_equal(result, OS_INVALID);
+}
+
+void test_wdb_global_create_backup_online_success(void **state) {
+    test_struct_t *data  = (test_struct_t *)*state;
+    int result = OS_INVALID;
+    char* test_date = strdup("2015/11/23 12:00:00");
+
+    will_return(__wrap_time, (time_t)0);
+    expect_value(__wrap_w_get_timestamp, time, 0);
+    will_return(__wrap_w_get_timestamp, test_date);
+
+    expect_string(__wrap_sqlite3_open_v2, filename, "queue/db/global.db");
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READONLY);
+    will_return(__wrap_sqlite3_open_v2, (sqlite3 *)1);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_OK);
+    expect_string(__wrap_sqlite3_open_v2, filename, "backup/db/global.db-backup-2015-11-23-12:00:00-tag");
+    expect_value(__wrap_sqlite3_open_v2, flags, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    will_return(__wrap_sqlite3_open_v2, (sqlite3 *)2);
+    will_return(__wrap_sqlite3_open_v2, SQLITE_OK);
+    will_return(__wrap_sqlite3_backup_init, (sqlite3_backup *)1);
+
+    // The copy of a database of one step keeps restarting, so after twice the steps the rest is copied at once
+    expect_value(__wrap_sqlite3_backup_step, nPage, WDB_BACKUP_STEP_PAGES);
+    will_return(__wrap_sqlite3_backup_step, SQLITE_OK);
+    will_return(__wrap_sqlite3_backup_pagecount, WDB_BACKUP_STEP_PAGES - 1);
+    expect_value(__wrap_sqlite3_backup_step, nPage, WDB_BACKUP_STEP_PAGES);
+    will_return(__wrap_sqlite3_backup_step, SQLITE_BUSY);
+    will_return(__wrap_sqlite3_backup_pagecount, WDB_BACKUP_STEP_PAGES - 1);
+    expect_value(__wrap_sqlite3_backup_step, nPage, WDB_BACKUP_STEP_PAGES);
+    will_return(__wrap_sqlite3_backup_step, SQLITE_OK);
+    will_return(__wrap_sqlite3_backup_pagecount, WDB_BACKUP_STEP_PAGES - 1);
+    expect_value(__wrap_sqlite3_backup_step, nPage, -1);
+    will_return(__wrap_sqlite3_backup_step, SQLITE_DONE);
+    will_return(__wrap_sqlite3_backup_finish, SQLITE_OK);
+    will_return(__wrap_sqlite3_close_v2, SQLITE_OK);
+    will_return(__wrap_sqlite3_close_v2, SQLITE_OK);
+
+    expect_string(__wrap_w_compress_gzfile, filesrc, "backup/db/global.db-backup-2015-11-23-12:00:00-tag");
+    expect_string(__wrap_w_compress_gzfile, filedst, "backup/db/global.db-backup-2015-11-23-12:00:00-tag.gz");
+    will_return(__wrap_w_compress_gzfile, OS_SUCCESS);
+    expect_string(__wrap_unlink, file, "backup/db/global.db-backup-2015-11-23-12:00:00-tag");
+    will_return(__wrap_unlink, OS_SUCCESS);
+    expect_string(__wrap__minfo, formatted_msg, "Created Global database backup \"backup/db/global.db-backup-2015-11-23-12:00:00-tag.gz\"");
+    cJSON* j_path = __real_cJSON_CreateArray();
+    will_return(__wrap_cJSON_CreateArray, j_path);
+    expect_function_call(__wrap_cJSON_Delete);
+
+    // wdb_global_remove_old_backups
+    will_return(__wrap_opendir, NULL);
+    expect_string(__wrap__mdebug1, formatted_msg, "Unable to open backup directory 'backup/db'");
+
+    result = wdb_global_create_backup_online(data->output, "-tag");
+
+    assert_string_equal(data->output, "ok [\"backup/db/global.db-backup-2015-11-23-12:00:00-tag.gz\"]");
+    assert_int_equal(result, OS_SUCCESS);
+    __real_cJSON_Delete(j_path);
+}
+
 /* Tests wdb_global_remove_old_backups */
 
 void test_wdb_global_remove_old_backups_opendir_failed(void **state) {
@@ -9550,6 +9822,15 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_by_connection_status_and_node_due, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_by_connection_status_err, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_by_connection_status_and_node_err, test_setup, test_teardown),
+        /* Tests wdb_global_get_agents_info_by_connection_status */
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_info_by_connection_status_transaction_fail, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_info_by_connection_status_bind_fail, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_agents_info_by_connection_status_due, test_setup, test_teardown),
+        /* Tests wdb_global_get_changes */
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_changes_transaction_fail, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_changes_oldest_step_fail, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_changes_bind_fail, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_get_changes_ok, test_setup, test_teardown),
         /* Tests wdb_global_create_backup */
         cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_commit_failed, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_prepare_failed, test_setup, test_teardown),
@@ -9557,6 +9838,10 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_exec_failed, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_compress_failed, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_success, test_setup, test_teardown),
+        /* Tests wdb_global_create_backup_online */
+        cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_online_open_failed, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_online_step_failed, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_global_create_backup_online_success, test_setup, test_teardown),
         /* Tests wdb_global_remove_old_backups */
         cmocka_unit_test_setup_teardown(test_wdb_global_remove_old_backups_opendir_failed, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_global_remove_old_backups_success_without_removing,
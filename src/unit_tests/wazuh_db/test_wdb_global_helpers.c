@@ -1412,6 +1412,53 @@ void test_wdb_update_agent_keepalive_success(void **state)
     assert_int_equal(OS_SUCCESS, ret);
 }
 
+/* Tests wdb_update_agents_keepalive */
+
+void test_wdb_update_agents_keepalive_success(void **state)
+{
+    int ret = 0;
+    int ids[] = {1, 2};
+    const char *connection_status = "active";
+    const char *sync_status = "synced";
+
+    const char *json_str = strdup("{\"ids\":[1,2],\"connection_status\":\"active\",\"sync_status\":\"synced\"}");
+    const char *query_str = "global update-keepalive {\"ids\":[1,2],\"connection_status\":\"active\",\"sync_status\":\"synced\"}";
+    const char *response = "ok";
+
+    will_return(__wrap_cJSON_CreateObject, 1);
+    will_return_always(__wrap_cJSON_AddStringToObject, 1);
+
+    // Adding data to JSON
+    expect_string(__wrap_cJSON_AddArrayToObject, name, "ids");
+    will_return(__wrap_cJSON_AddArrayToObject, 1);
+    expect_function_calls(__wrap_cJSON_AddItemToArray, 2);
+    will_return_count(__wrap_cJSON_AddItemToArray, true, 2);
+    expect_string(__wrap_cJSON_AddStringToObject, name, "connection_status");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "active");
+    expect_string(__wrap_cJSON_AddStringToObject, name, "sync_status");
+    expect_string(__wrap_cJSON_AddStringToObject, string, "synced");
+
+    // Printing JSON
+    will_return(__wrap_cJSON_PrintUnformatted, json_str);
+
+    // Calling Wazuh DB
+    expect_any(__wrap_wdbc_query_ex, *sock);
+    expect_string(__wrap_wdbc_query_ex, query, query_str);
+    expect_value(__wrap_wdbc_query_ex, len, WDBOUTPUT_SIZE);
+    will_return(__wrap_wdbc_query_ex, response);
+    will_return(__wrap_wdbc_query_ex, OS_SUCCESS);
+
+    // Parsing Wazuh DB result
+    expect_any(__wrap_wdbc_parse_result, result);
+    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+
+    expect_function_call(__wrap_cJSON_Delete);
+
+    ret = wdb_update_agents_keepalive(ids, 2, connection_status, sync_status, NULL);
+
+    assert_int_equal(OS_SUCCESS, ret);
+}
+
 /* Tests wdb_update_agent_connection_status */
 
 void test_wdb_update_agent_connection_status_error_json(void **state)
@@ -3117,6 +3164,89 @@ void test_wdb_get_agents_by_connection_status_success(void **state)
     memset(test_payload, '\0', OS_MAXSTR);
 }
 
+void test_wdb_get_agents_info_by_connection_status_query_error(void **state)
+{
+    const char *query_str = "global get-agents-info-by-connection-status 0 active";
+    const char *response = "err";
+    cJSON* agents = __real_cJSON_CreateArray();
+
+    will_return(__wrap_cJSON_CreateArray, agents);
+
+    // Calling Wazuh DB
+    expect_any(__wrap_wdbc_query_ex, *sock);
+    expect_string(__wrap_wdbc_query_ex, query, query_str);
+    expect_value(__wrap_wdbc_query_ex, len, WDBOUTPUT_SIZE);
+    will_return(__wrap_wdbc_query_ex, response);
+    will_return(__wrap_wdbc_query_ex, OS_INVALID);
+
+    expect_string(__wrap__merror, formatted_msg, "Error querying Wazuh DB to get the information of the agents by connection status.");
+    expect_function_call(__wrap_cJSON_Delete);
+
+    cJSON *result = wdb_get_agents_info_by_connection_status("active", NULL);
+
+    assert_null(result);
+    __real_cJSON_Delete(agents);
+}
+
+void test_wdb_get_agents_info_by_connection_status_success(void **state)
+{
+    const char *query_str = "global get-agents-info-by-connection-status 0 active";
+    const char *query2_str = "global get-agents-info-by-connection-status 2 active";
+    cJSON* agents = __real_cJSON_CreateArray();
+
+    // Setting the payload
+    set_payload = 1;
+    strcpy(test_payload, "due [{\"id\":1,\"name\":\"agent1\"},{\"id\":2,\"name\":\"agent2\"}]");
+    cJSON* test_json = __real_cJSON_Parse(test_payload+4);
+    cJSON* test_json2 = __real_cJSON_Parse("[]");
+    cJSON* id1 = cJSON_CreateNumber(1);
+    cJSON* id2 = cJSON_CreateNumber(2);
+
+    will_return(__wrap_cJSON_CreateArray, agents);
+
+    // First chunk
+    expect_any(__wrap_wdbc_query_ex, *sock);
+    expect_string(__wrap_wdbc_query_ex, query, query_str);
+    expect_value(__wrap_wdbc_query_ex, len, WDBOUTPUT_SIZE);
+    will_return(__wrap_wdbc_query_ex, test_payload);
+    will_return(__wrap_wdbc_query_ex, OS_SUCCESS);
+
+    expect_any(__wrap_wdbc_parse_result, result);
+    will_return(__wrap_wdbc_parse_result, WDBC_DUE);
+    will_return(__wrap_cJSON_Parse, test_json);
+    will_return(__wrap_cJSON_GetObjectItem, id1);
+    will_return(__wrap_cJSON_GetObjectItem, id2);
+    expect_function_calls(__wrap_cJSON_AddItemToArray, 2);
+    will_return_count(__wrap_cJSON_AddItemToArray, true, 2);
+    expect_function_call(__wrap_cJSON_Delete);
+
+    // Second chunk, from the last agent received
+    expect_any(__wrap_wdbc_query_ex, *sock);
+    expect_string(__wrap_wdbc_query_ex, query, query2_str);
+    expect_value(__wrap_wdbc_query_ex, len, WDBOUTPUT_SIZE);
+    will_return(__wrap_wdbc_query_ex, test_payload);
+    will_return(__wrap_wdbc_query_ex, OS_SUCCESS);
+
+    expect_any(__wrap_wdbc_parse_result, result);
+    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+    will_return(__wrap_cJSON_Parse, test_json2);
+    expect_function_call(__wrap_cJSON_Delete);
+
+    cJSON *result = wdb_get_agents_info_by_connection_status("active", NULL);
+
+    assert_ptr_equal(agents, result);
+
+    __real_cJSON_Delete(agents);
+    __real_cJSON_Delete(test_json);
+    __real_cJSON_Delete(test_json2);
+    __real_cJSON_Delete(id1);
+    __real_cJSON_Delete(id2);
+
+    // Cleaning payload
+    set_payload = 0;
+    memset(test_payload, '\0', OS_MAXSTR);
+}
+
 void test_wdb_get_agents_ids_of_current_node_success(void **state)
 {
     const char *query_str = "global get-agents-by-connection-status 0 active node01 -1";
@@ -4138,6 +4268,8 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_update_agent_keepalive_error_sql_execution, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_update_agent_keepalive_error_result, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_update_agent_keepalive_success, setup_wdb_global_helpers, teardown_wdb_global_helpers),
+        // Tests wdb_update_agents_keepalive
+        cmocka_unit_test_setup_teardown(test_wdb_update_agents_keepalive_success, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         /* Tests wdb_update_agent_connection_status */
         cmocka_unit_test_setup_teardown(test_wdb_update_agent_connection_status_error_json, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_update_agent_connection_status_error_socket, setup_wdb_global_helpers, teardown_wdb_global_helpers),
@@ -4212,6 +4344,8 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_get_agents_by_connection_status_query_error, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_get_agents_by_connection_status_parse_error, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_get_agents_by_connection_status_success, setup_wdb_global_helpers, teardown_wdb_global_helpers),
+        cmocka_unit_test_setup_teardown(test_wdb_get_agents_info_by_connection_status_query_error, setup_wdb_global_helpers, teardown_wdb_global_helpers),
+        cmocka_unit_test_setup_teardown(test_wdb_get_agents_info_by_connection_status_success, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         /* Tests wdb_get_agents_ids_of_current_node */
         cmocka_unit_test_setup_teardown(test_wdb_get_agents_ids_of_current_node_query_error, setup_wdb_global_helpers, teardown_wdb_global_helpers),
         cmocka_unit_test_setup_teardown(test_wdb_get_agents_ids_of_current_node_parse_error, setup_wdb_global_helpers, teardown_wdb_global_helpers),
@@ -195,6 +195,35 @@ void test_wdb_parse_global_sql_fail(void **state)
     assert_int_equal(ret, OS_INVALID);
 }
 
+void test_wdb_parse_global_sql_reader_success(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global sql SELECT id FROM agent";
+    cJSON *root = cJSON_CreateArray();
+
+    cJSON_AddItemToArray(root, cJSON_CreateObject());
+
+    // The reader serves the query, the global connection is not opened
+    will_return(__wrap_wdb_open_global_reader, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: sql SELECT id FROM agent");
+    will_return(__wrap_wdb_exec, root);
+    expect_string(__wrap_wdb_exec, sql, "SELECT id FROM agent");
+    will_return(__wrap_wdb_commit2, OS_SUCCESS);
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_sql);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_sql_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "ok [{}]");
+    assert_int_equal(ret, OS_SUCCESS);
+}
+
 void test_wdb_parse_global_actor_fail(void **state)
 {
     int ret = 0;
@@ -869,6 +898,60 @@ void test_wdb_parse_global_update_agent_keepalive_success(void **state)
     assert_int_equal(ret, OS_SUCCESS);
 }
 
+void test_wdb_parse_global_update_agents_keepalive_invalid_id(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global update-keepalive {\"ids\":[1,\"2\"],\"connection_status\":\"active\",\"sync_status\":\"syncreq\"}";
+
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: update-keepalive {\"ids\":[1,\"2\"],\"connection_status\":\"active\",\"sync_status\":\"syncreq\"}");
+    expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid JSON data when updating agent keepalive.");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_update_keepalive);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_update_keepalive_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid JSON data, near '{\"ids\":[1,\"2\"],\"connection_statu'");
+    assert_int_equal(ret, OS_INVALID);
+}
+
+void test_wdb_parse_global_update_agents_keepalive_success(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global update-keepalive {\"ids\":[1,2],\"connection_status\":\"active\",\"sync_status\":\"syncreq\"}";
+
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_value(__wrap_wdb_global_update_agent_keepalive, id, 1);
+    expect_string(__wrap_wdb_global_update_agent_keepalive, connection_status, "active");
+    expect_string(__wrap_wdb_global_update_agent_keepalive, status, "syncreq");
+    will_return(__wrap_wdb_global_update_agent_keepalive, OS_SUCCESS);
+    expect_value(__wrap_wdb_global_update_agent_keepalive, id, 2);
+    expect_string(__wrap_wdb_global_update_agent_keepalive, connection_status, "active");
+    expect_string(__wrap_wdb_global_update_agent_keepalive, status, "syncreq");
+    will_return(__wrap_wdb_global_update_agent_keepalive, OS_SUCCESS);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: update-keepalive {\"ids\":[1,2],\"connection_status\":\"active\",\"sync_status\":\"syncreq\"}");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_update_keepalive);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_update_keepalive_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "ok");
+    assert_int_equal(ret, OS_SUCCESS);
+}
+
 /* Tests wdb_parse_global_update_connection_status */
 
 void test_wdb_parse_global_update_connection_status_syntax_error(void **state)
@@ -1706,6 +1789,7 @@ void test_wdb_parse_global_get_group_agents_syntax_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-group-agents";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents");
     expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-group-agents.");
@@ -1727,6 +1811,7 @@ void test_wdb_parse_global_get_group_agents_group_missing(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-group-agents ";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents ");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments, group name not found.");
@@ -1750,6 +1835,7 @@ void test_wdb_parse_global_get_group_agents_last_id_missing(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-group-agents group_name";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents group_name");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments, 'last_id' not found.");
@@ -1773,6 +1859,7 @@ void test_wdb_parse_global_get_group_agents_last_id_value_missing(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-group-agents group_name last_id";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents group_name last_id");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments, last agent id not found.");
@@ -1796,6 +1883,7 @@ void test_wdb_parse_global_get_group_agents_failed(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-group-agents group_name last_id 0";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents group_name last_id 0");
 
@@ -1825,6 +1913,7 @@ void test_wdb_parse_global_get_group_agents_success(void **state)
     char query[OS_BUFFER_SIZE] = "global get-group-agents group_name last_id 0";
     cJSON *result = cJSON_Parse("[1,2,3]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-group-agents group_name last_id 0");
 
@@ -2789,6 +2878,7 @@ void test_wdb_parse_global_get_groups_integrity_syntax_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity");
     expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-groups-integrity.");
@@ -2810,6 +2900,7 @@ void test_wdb_parse_global_get_groups_integrity_hash_length_expected_fail(void *
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity small_hash";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity small_hash");
     // Expected hash should be OS_SHA1_HEXDIGEST_SIZE (40) characters long, and the received hash, "small_hash", is 10 characters long.
@@ -2834,6 +2925,7 @@ void test_wdb_parse_global_get_groups_integrity_query_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
     expect_string(__wrap_wdb_global_get_groups_integrity, hash, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
@@ -2860,6 +2952,7 @@ void test_wdb_parse_global_get_groups_integrity_success_syncreq(void **state)
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
     cJSON* j_response = cJSON_Parse("[\"syncreq\"]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
     expect_string(__wrap_wdb_global_get_groups_integrity, hash, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
@@ -2885,6 +2978,7 @@ void test_wdb_parse_global_get_groups_integrity_success_synced(void **state)
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
     cJSON* j_response = cJSON_Parse("[\"synced\"]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
     expect_string(__wrap_wdb_global_get_groups_integrity, hash, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
@@ -2910,6 +3004,7 @@ void test_wdb_parse_global_get_groups_integrity_success_hash_mismatch(void **sta
     char query[OS_BUFFER_SIZE] = "global get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
     cJSON* j_response = cJSON_Parse("[\"hash_mismatch\"]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-groups-integrity xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
     expect_string(__wrap_wdb_global_get_groups_integrity, hash, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
@@ -3059,6 +3154,7 @@ void test_wdb_parse_global_get_all_agents_syntax_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-all-agents";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-all-agents");
     expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-all-agents.");
@@ -3080,6 +3176,7 @@ void test_wdb_parse_global_get_all_agents_argument_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-all-agents invalid";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-all-agents invalid");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'last_id' not found.");
@@ -3102,6 +3199,7 @@ void test_wdb_parse_global_get_all_agents_argument2_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-all-agents last_id";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-all-agents last_id");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'last_id' not found.");
@@ -3129,6 +3227,7 @@ void test_wdb_parse_global_get_all_agents_success(void **state)
     cJSON_AddItemToObject(json_agent, "id", cJSON_CreateNumber(10));
     cJSON_AddItemToArray(root, json_agent);
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-all-agents last_id 1");
     expect_value(__wrap_wdb_global_get_all_agents, last_agent_id, 1);
@@ -3156,6 +3255,7 @@ void test_wdb_parse_global_get_agent_info_syntax_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agent-info";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agent-info");
     expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-agent-info.");
@@ -3177,6 +3277,7 @@ void test_wdb_parse_global_get_agent_info_query_error(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agent-info 1";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agent-info 1");
     expect_value(__wrap_wdb_global_get_agent_info, id, 1);
@@ -3206,6 +3307,7 @@ void test_wdb_parse_global_get_agent_info_success(void **state)
     j_object = cJSON_CreateObject();
     cJSON_AddStringToObject(j_object, "name", "test_name");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agent-info 1");
     expect_value(__wrap_wdb_global_get_agent_info, id, 1);
@@ -3297,6 +3399,180 @@ void test_wdb_parse_reset_agents_connection_success(void **state)
     assert_int_equal(ret, OS_SUCCESS);
 }
 
+/* Tests wdb_parse_global_get_agents_info_by_connection_status */
+
+void test_wdb_parse_global_get_agents_info_by_connection_status_status_error(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-agents-info-by-connection-status 0";
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-info-by-connection-status 0");
+    expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'connection_status' not found.");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid arguments 'connection_status' not found");
+    assert_int_equal(ret, OS_INVALID);
+}
+
+void test_wdb_parse_global_get_agents_info_by_connection_status_query_success(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-agents-info-by-connection-status 0 active";
+    cJSON* root = cJSON_CreateArray();
+    cJSON* json_agent = cJSON_CreateObject();
+    cJSON_AddNumberToObject(json_agent, "id", 1);
+    cJSON_AddStringToObject(json_agent, "name", "agent1");
+    cJSON_AddItemToArray(root, json_agent);
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-info-by-connection-status 0 active");
+    expect_value(__wrap_wdb_global_get_agents_info_by_connection_status, last_agent_id, 0);
+    expect_string(__wrap_wdb_global_get_agents_info_by_connection_status, connection_status, "active");
+    will_return(__wrap_wdb_global_get_agents_info_by_connection_status, WDBC_DUE);
+    will_return(__wrap_wdb_global_get_agents_info_by_connection_status, root);
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "due [{\"id\":1,\"name\":\"agent1\"}]");
+    assert_int_equal(ret, OS_SUCCESS);
+}
+
+void test_wdb_parse_global_get_agents_info_by_connection_status_query_fail(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-agents-info-by-connection-status 0 active";
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-info-by-connection-status 0 active");
+    expect_value(__wrap_wdb_global_get_agents_info_by_connection_status, last_agent_id, 0);
+    expect_string(__wrap_wdb_global_get_agents_info_by_connection_status, connection_status, "active");
+    will_return(__wrap_wdb_global_get_agents_info_by_connection_status, WDBC_ERROR);
+    will_return(__wrap_wdb_global_get_agents_info_by_connection_status, NULL);
+    expect_string(__wrap__mdebug1, formatted_msg, "Error getting agents information by connection status from global.db.");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_get_agents_info_by_connection_status_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "err Error getting agents information by connection status from global.db.");
+    assert_int_equal(ret, OS_INVALID);
+}
+
+/* Tests wdb_parse_global_get_changes */
+
+void test_wdb_parse_global_get_changes_syntax_error(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-changes";
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-changes");
+    expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-changes.");
+    expect_string(__wrap__mdebug2, formatted_msg, "Global DB query error near: get-changes");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_changes);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid DB query syntax, near 'get-changes'");
+    assert_int_equal(ret, OS_INVALID);
+}
+
+void test_wdb_parse_global_get_changes_query_success(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-changes 5 100";
+    cJSON* root = cJSON_CreateObject();
+    cJSON* changes = cJSON_CreateArray();
+    cJSON* json_change = cJSON_CreateObject();
+    cJSON_AddNumberToObject(json_change, "seq", 6);
+    cJSON_AddNumberToObject(json_change, "id", 1);
+    cJSON_AddStringToObject(json_change, "operation", "update");
+    cJSON_AddItemToArray(changes, json_change);
+    cJSON_AddNumberToObject(root, "oldest_seq", 3);
+    cJSON_AddItemToObject(root, "changes", changes);
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-changes 5 100");
+    expect_value(__wrap_wdb_global_get_changes, last_seq, 5);
+    expect_value(__wrap_wdb_global_get_changes, limit, 100);
+    will_return(__wrap_wdb_global_get_changes, WDBC_OK);
+    will_return(__wrap_wdb_global_get_changes, root);
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_changes);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_get_changes_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "ok {\"oldest_seq\":3,\"changes\":[{\"seq\":6,\"id\":1,\"operation\":\"update\"}]}");
+    assert_int_equal(ret, OS_SUCCESS);
+}
+
+void test_wdb_parse_global_get_changes_query_fail(void **state)
+{
+    int ret = 0;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char query[OS_BUFFER_SIZE] = "global get-changes 0";
+
+    will_return(__wrap_wdb_open_global_reader, NULL);
+    will_return(__wrap_wdb_open_global, data->wdb);
+    expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-changes 0");
+    expect_value(__wrap_wdb_global_get_changes, last_seq, 0);
+    expect_value(__wrap_wdb_global_get_changes, limit, -1);
+    will_return(__wrap_wdb_global_get_changes, WDBC_ERROR);
+    will_return(__wrap_wdb_global_get_changes, NULL);
+    expect_string(__wrap__mdebug1, formatted_msg, "Error getting changes from global.db.");
+
+    expect_function_call(__wrap_w_inc_queries_total);
+    expect_function_call(__wrap_w_inc_global);
+    expect_function_call(__wrap_w_inc_global_agent_get_changes);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_gettimeofday);
+    expect_function_call(__wrap_w_inc_global_agent_get_changes_time);
+
+    ret = wdb_parse(query, data->output, 0);
+
+    assert_string_equal(data->output, "err Error getting changes from global.db.");
+    assert_int_equal(ret, OS_INVALID);
+}
+
 /* Tests wdb_parse_global_get_agents_by_connection_status */
 
 void test_wdb_parse_global_get_agents_by_connection_status_syntax_error(void **state)
@@ -3305,6 +3581,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_syntax_error(void **s
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agents-by-connection-status";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status");
     expect_string(__wrap__mdebug1, formatted_msg, "Global DB Invalid DB query syntax for get-agents-by-connection-status.");
@@ -3326,6 +3603,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_status_error(void **s
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agents-by-connection-status 0 ";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status 0 ");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'connection_status' not found.");
@@ -3349,6 +3627,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_last_id_error(void **
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agents-by-connection-status ";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status ");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'last_id' not found.");
@@ -3372,6 +3651,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_limit_error(void **st
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agents-by-connection-status 0 active node01";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status 0 active node01");
     expect_string(__wrap__mdebug1, formatted_msg, "Invalid arguments 'limit' not found.");
@@ -3400,6 +3680,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_limit_succes(void **s
     cJSON_AddItemToArray(root, json_agent);
 
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status 0 active node01 -1");
     expect_value(__wrap_wdb_global_get_agents_by_connection_status, last_agent_id, 0);
@@ -3433,6 +3714,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_query_success(void **
     cJSON_AddItemToArray(root, json_agent);
 
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status 0 active");
     expect_value(__wrap_wdb_global_get_agents_by_connection_status, last_agent_id, 0);
@@ -3459,6 +3741,7 @@ void test_wdb_parse_global_get_agents_by_connection_status_query_fail(void **sta
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-agents-by-connection-status 0 active";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-agents-by-connection-status 0 active");
     expect_value(__wrap_wdb_global_get_agents_by_connection_status, last_agent_id, 0);
@@ -3967,6 +4250,7 @@ void test_wdb_parse_global_get_distinct_agent_groups_success(void **state)
     char query[OS_BUFFER_SIZE] = "global get-distinct-groups";
     cJSON *group_info = cJSON_Parse("[\"GROUP INFO\"]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-distinct-groups");
     expect_value(__wrap_wdb_global_get_distinct_agent_groups, group_hash, NULL);
@@ -3993,6 +4277,7 @@ void test_wdb_parse_global_get_distinct_agent_groups_success_with_last_hash(void
     char query[OS_BUFFER_SIZE] = "global get-distinct-groups abcdef";
     cJSON *group_info = cJSON_Parse("[\"GROUP INFO\"]");
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-distinct-groups abcdef");
     expect_string(__wrap_wdb_global_get_distinct_agent_groups, group_hash, "abcdef");
@@ -4018,6 +4303,7 @@ void test_wdb_parse_global_get_distinct_agent_groups_result_null(void **state)
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-distinct-groups";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-distinct-groups");
     expect_value(__wrap_wdb_global_get_distinct_agent_groups, group_hash, NULL);
@@ -4045,6 +4331,7 @@ void test_wdb_parse_global_get_distinct_agent_groups_result_null_with_last_hash(
     test_struct_t *data  = (test_struct_t *)*state;
     char query[OS_BUFFER_SIZE] = "global get-distinct-groups abcdef";
 
+    will_return(__wrap_wdb_open_global_reader, NULL);
     will_return(__wrap_wdb_open_global, data->wdb);
     expect_string(__wrap__mdebug2, formatted_msg, "Global query: get-distinct-groups abcdef");
     expect_string(__wrap_wdb_global_get_distinct_agent_groups, group_hash, "abcdef");
@@ -4074,6 +4361,7 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_substr_fail, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_sql_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_sql_success, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_sql_reader_success, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_sql_fail, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_actor_fail, test_setup, test_teardown),
         /* Tests wdb_parse_global_insert_agent */
@@ -4104,6 +4392,8 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_agent_keepalive_invalid_data, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_agent_keepalive_query_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_agent_keepalive_success, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_agents_keepalive_invalid_id, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_agents_keepalive_success, test_setup, test_teardown),
         /* Tests wdb_parse_global_update_connection_status */
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_connection_status_syntax_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_update_connection_status_invalid_json, test_setup, test_teardown),
@@ -4219,6 +4509,14 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_parse_reset_agents_connection_syntax_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_reset_agents_connection_query_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_reset_agents_connection_success, test_setup, test_teardown),
+        /* Tests wdb_parse_global_get_agents_info_by_connection_status */
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_agents_info_by_connection_status_status_error, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_agents_info_by_connection_status_query_success, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_agents_info_by_connection_status_query_fail, test_setup, test_teardown),
+        /* Tests wdb_parse_global_get_changes */
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_changes_syntax_error, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_changes_query_success, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_changes_query_fail, test_setup, test_teardown),
         /* Tests wdb_parse_global_get_agent_info */
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_agents_by_connection_status_syntax_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_get_agents_by_connection_status_status_error, test_setup, test_teardown),
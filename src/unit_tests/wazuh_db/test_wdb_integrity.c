@@ -51,6 +51,7 @@ static int teardown_wdb_t(void **state) {
     wdb_t *data = *state;
 
     if(data) {
+        wdbi_checksum_cache_free(data);
         os_free(data->id);
         os_free(data);
     }
@@ -180,6 +181,7 @@ static void test_wdbi_checksum_stmt_cache_fail(void **state) {
     data->id = strdup("000");
     os_sha1 test_hex = "";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
 
@@ -195,6 +197,7 @@ static void test_wdbi_checksum_success(void **state) {
     data->id = strdup("000");
     os_sha1 test_hex = {5,5,0,8,6,'c','e','f',9,'c',8,7,'d',6,'d',0,3,1,'c','d',5,'d','b',2,9,'c','d',0,3,'a',2,'e','d',0,2,5,2,'b',4,5};
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
 
     will_return(__wrap_sqlite3_step, 0);
@@ -311,6 +314,7 @@ static void test_wdbi_checksum_range_stmt_cache_fail(void **state) {
     data->id = strdup("000");
     os_sha1 test_hex = "";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
 
@@ -329,6 +333,7 @@ static void test_wdbi_checksum_range_begin_null(void **state) {
     const char* end = "test_end";
     os_sha1 test_hex = "";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
 
     expect_value(__wrap_sqlite3_bind_text, pos, 1);
@@ -355,6 +360,7 @@ static void test_wdbi_checksum_range_end_null(void **state) {
     const char* end = NULL;
     os_sha1 test_hex = "";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
 
     expect_value(__wrap_sqlite3_bind_text, pos, 1);
@@ -380,6 +386,7 @@ static void test_wdbi_checksum_range_success(void **state) {
     const char* end = "test_end";
     os_sha1 test_hex = {5,5,0,8,6,'c','e','f',9,'c',8,7,'d',6,'d',0,3,1,'c','d',5,'d','b',2,9,'c','d',0,3,'a',2,'e','d',0,2,5,2,'b',4,5};
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
 
     expect_value(__wrap_sqlite3_bind_text, pos, 1);
@@ -403,6 +410,87 @@ static void test_wdbi_checksum_range_success(void **state) {
     assert_int_equal(ret, 1);
 }
 
+static void test_wdbi_checksum_range_cached(void **state) {
+    int ret;
+
+    wdb_t * data = *state;
+    data->id = strdup("000");
+    const char* begin = "test_begin";
+    const char* end = "test_end";
+    os_sha1 test_hex = "";
+    os_sha1 cached_hex = "";
+
+    // wdbi_checksum_cache_get and wdbi_checksum_cache_set
+    will_return_count(__wrap_sqlite3_total_changes, 5, 2);
+    will_return(__wrap_wdb_stmt_cache, 0);
+
+    expect_value(__wrap_sqlite3_bind_text, pos, 1);
+    expect_string(__wrap_sqlite3_bind_text, buffer, begin);
+    will_return(__wrap_sqlite3_bind_text, 0);
+    expect_value(__wrap_sqlite3_bind_text, pos, 2);
+    expect_string(__wrap_sqlite3_bind_text, buffer, end);
+    will_return(__wrap_sqlite3_bind_text, 0);
+
+    will_return(__wrap_sqlite3_step, 0);
+    will_return(__wrap_sqlite3_step, 100);
+    will_return(__wrap_sqlite3_step, 0);
+    will_return(__wrap_sqlite3_step, 0);
+    expect_value(__wrap_sqlite3_column_text, iCol, 0);
+    will_return(__wrap_sqlite3_column_text, NULL);
+
+    expect_string(__wrap__mdebug1, formatted_msg, "DB(000) has a NULL fim checksum.");
+
+    ret = wdbi_checksum_range(data, 0, begin, end, test_hex);
+    assert_int_equal(ret, 1);
+
+    // The database did not change: the checksum is not calculated again
+    will_return(__wrap_sqlite3_total_changes, 5);
+
+    ret = wdbi_checksum_range(data, 0, begin, end, cached_hex);
+    assert_int_equal(ret, 1);
+    assert_string_equal(cached_hex, test_hex);
+}
+
+static void test_wdbi_checksum_range_cache_changed(void **state) {
+    int ret;
+
+    wdb_t * data = *state;
+    data->id = strdup("000");
+    const char* begin = "test_begin";
+    const char* end = "test_end";
+    os_sha1 test_hex = "";
+
+    // First calculation, without items
+    will_return_count(__wrap_sqlite3_total_changes, 5, 2);
+    will_return(__wrap_wdb_stmt_cache, 0);
+    expect_value(__wrap_sqlite3_bind_text, pos, 1);
+    expect_string(__wrap_sqlite3_bind_text, buffer, begin);
+    will_return(__wrap_sqlite3_bind_text, 0);
+    expect_value(__wrap_sqlite3_bind_text, pos, 2);
+    expect_string(__wrap_sqlite3_bind_text, buffer, end);
+    will_return(__wrap_sqlite3_bind_text, 0);
+    will_return(__wrap_sqlite3_step, 0);
+    will_return(__wrap_sqlite3_step, 0);
+
+    ret = wdbi_checksum_range(data, 0, begin, end, test_hex);
+    assert_int_equal(ret, 0);
+
+    // The database changed: the checksum is calculated again
+    will_return_count(__wrap_sqlite3_total_changes, 6, 2);
+    will_return(__wrap_wdb_stmt_cache, 0);
+    expect_value(__wrap_sqlite3_bind_text, pos, 1);
+    expect_string(__wrap_sqlite3_bind_text, buffer, begin);
+    will_return(__wrap_sqlite3_bind_text, 0);
+    expect_value(__wrap_sqlite3_bind_text, pos, 2);
+    expect_string(__wrap_sqlite3_bind_text, buffer, end);
+    will_return(__wrap_sqlite3_bind_text, 0);
+    will_return(__wrap_sqlite3_step, 0);
+    will_return(__wrap_sqlite3_step, 0);
+
+    ret = wdbi_checksum_range(data, 0, begin, end, test_hex);
+    assert_int_equal(ret, 0);
+}
+
 // Test wdbi_delete
 static void test_wdbi_delete_wdb_null(void **state) {
     expect_assert_failure(wdbi_delete(NULL, 0, "test_begin", "test_end","test_tail"));
@@ -900,6 +988,8 @@ void test_wdbi_query_checksum_range_fail(void **state) {
     os_strdup("000", data->id);
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
@@ -921,6 +1011,8 @@ void test_wdbi_query_checksum_range_no_data(void **state) {
     const char *component = "fim";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
@@ -976,6 +1068,8 @@ void test_wdbi_query_checksum_diff_hexdigest(void **state) {
     const char *end = "something";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
@@ -1015,6 +1109,8 @@ void test_wdbi_query_checksum_equal_hexdigest(void **state) {
     const char *end = "something";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"da39a3ee5e6b4b0d3255bfef95601890afd80709\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, -1);
     expect_string(__wrap__mdebug1, formatted_msg, "Cannot cache statement");
@@ -1055,6 +1151,7 @@ void test_wdbi_query_checksum_bad_action(void **state) {
     const char *end = "something";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_sqlite3_step, 0);
     will_return(__wrap_sqlite3_step, 100);
@@ -1087,6 +1184,7 @@ void test_wdbi_query_checksum_check_left_no_tail(void **state) {
     const char *end = "something";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_sqlite3_step, 0);
     will_return(__wrap_sqlite3_step, 100);
@@ -1123,6 +1221,7 @@ void test_wdbi_query_checksum_check_left_ok(void **state) {
     const char *end = "something";
     const char * payload = "{\"begin\":\"something\",\"end\":\"something\",\"checksum\":\"something\",\"id\":1234,\"tail\":\"something\"}";
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_sqlite3_step, 0);
     will_return(__wrap_sqlite3_step, 100);
@@ -1161,6 +1260,8 @@ void test_wdbi_query_checksum_last_manager_success(void **state) {
     cJSON_AddStringToObject(j_object, "last_manager_checksum", "da39a3ee5e6b4b0d3255bfef95601890afd80709");
     cJSON_AddItemToArray(j_data, j_object);
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, 0);
     expect_value(__wrap_sqlite3_bind_text, pos, 1);
@@ -1190,6 +1291,8 @@ void test_wdbi_query_checksum_last_manager_diff(void **state) {
     cJSON_AddStringToObject(j_object, "last_manager_checksum", "");
     cJSON_AddItemToArray(j_data, j_object);
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
+
     // wdbi_get_last_manager_checksum
     will_return(__wrap_wdb_stmt_cache, 0);
     expect_value(__wrap_sqlite3_bind_text, pos, 1);
@@ -1459,6 +1562,7 @@ void test_wdbi_check_sync_status_data_not_synced_error_checksum(void **state) {
     cJSON_AddStringToObject(j_object, "last_agent_checksum", "da39a3ee5e6b4b0d3255bfef95601890afd80709");
     cJSON_AddItemToArray(j_data, j_object);
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_wdb_exec_stmt, j_data);
 
@@ -1488,6 +1592,7 @@ void test_wdbi_check_sync_status_data_not_synced_checksum_no_data(void **state)
     cJSON_AddStringToObject(j_object, "last_agent_checksum", "da39a3ee5e6b4b0d3255bfef95601890afd80709");
     cJSON_AddItemToArray(j_data, j_object);
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_wdb_exec_stmt, j_data);
 
@@ -1520,6 +1625,7 @@ void test_wdbi_check_sync_status_data_not_synced_checksum_valid(void **state) {
     cJSON_AddStringToObject(j_object, "last_agent_checksum", "da39a3ee5e6b4b0d3255bfef95601890afd80709");
     cJSON_AddItemToArray(j_data, j_object);
 
+    will_return_always(__wrap_sqlite3_total_changes, 0);
     will_return(__wrap_wdb_stmt_cache, 0);
     will_return(__wrap_wdb_exec_stmt, j_data);
 
@@ -1788,6 +1894,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_wdbi_checksum_range_begin_null, setup_wdb_t, teardown_wdb_t),
         cmocka_unit_test_setup_teardown(test_wdbi_checksum_range_end_null, setup_wdb_t, teardown_wdb_t),
         cmocka_unit_test_setup_teardown(test_wdbi_checksum_range_success, setup_wdb_t, teardown_wdb_t),
+        cmocka_unit_test_setup_teardown(test_wdbi_checksum_range_cached, setup_wdb_t, teardown_wdb_t),
+        cmocka_unit_test_setup_teardown(test_wdbi_checksum_range_cache_changed, setup_wdb_t, teardown_wdb_t),
         //Test wdbi_delete
         cmocka_unit_test(test_wdbi_delete_wdb_null),
         cmocka_unit_test_setup_teardown(test_wdbi_delete_begin_null, setup_wdb_t, teardown_wdb_t),
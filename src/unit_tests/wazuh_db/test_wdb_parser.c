@@ -16,6 +16,7 @@
 
 #include "os_err.h"
 #include "wazuh_db/wdb.h"
+#include "wazuhdb_bin.h"
 
 typedef struct test_struct {
     wdb_t *wdb;
@@ -1411,6 +1412,48 @@ void test_vuln_cves_insert_command_success(void **state) {
     os_free(query);
 }
 
+void test_vuln_cves_insert_batch_success(void **state) {
+    int ret = OS_INVALID;
+    test_struct_t *data  = (test_struct_t *)*state;
+    char *query = NULL;
+    char *result = NULL;
+    os_strdup("[{\"status\":\"SUCCESS\"},{\"status\":\"ERROR\"}]", result);
+    os_strdup("insert [{\"name\":\"package\",\"version\":\"2.2\",\"architecture\":\"x86\",\"cve\":\"CVE-2021-1500\","
+              "\"reference\":\"8549fd9faf9b124635298e9311ccf672c2ad05d1\",\"type\":\"PACKAGE\",\"status\":\"VALID\","
+              "\"check_pkg_existence\":true,\"severity\":null,\"cvss2_score\":0,\"cvss3_score\":0},"
+              "{\"name\":\"package\",\"version\":\"2.2\",\"architecture\":\"x86\"}]", query);
+
+    cJSON *test =  cJSON_CreateObject();
+
+    // wdb_parse_agents_insert_vuln_cves
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, name, "package");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, version, "2.2");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, architecture, "x86");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, cve, "CVE-2021-1500");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, reference, "8549fd9faf9b124635298e9311ccf672c2ad05d1");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, type, "PACKAGE");
+    expect_string(__wrap_wdb_agents_insert_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_agents_insert_vuln_cves, check_pkg_existence, true);
+    expect_value(__wrap_wdb_agents_insert_vuln_cves, severity, NULL);
+    expect_value(__wrap_wdb_agents_insert_vuln_cves, cvss2_score, 0);
+    expect_value(__wrap_wdb_agents_insert_vuln_cves, cvss3_score, 0);
+    will_return(__wrap_cJSON_PrintUnformatted, NULL);
+    will_return(__wrap_wdb_agents_insert_vuln_cves, test);
+
+    // The second vulnerability misses required fields
+    expect_string(__wrap__mdebug1, formatted_msg, "Invalid vuln_cves JSON data when inserting vulnerable package."
+    " Not compliant with constraints defined in the database.");
+
+    will_return(__wrap_cJSON_PrintUnformatted, result);
+
+    ret = wdb_parse_vuln_cves(data->wdb, query, data->output);
+
+    assert_string_equal(data->output, "ok [{\"status\":\"SUCCESS\"},{\"status\":\"ERROR\"}]");
+    assert_int_equal(ret, OS_SUCCESS);
+
+    os_free(query);
+}
+
 void test_vuln_cves_update_status_syntax_error(void **state){
     int ret = -1;
     test_struct_t *data  = (test_struct_t *)*state;
@@ -2514,6 +2557,152 @@ void test_wdb_parse_dbsync_deleted_err(void ** state) {
     os_free(query);
 }
 
+/* wdb_parse_dbsync_bulk */
+
+void test_wdb_parse_dbsync_bulk_no_deltas(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char * query = NULL;
+
+    os_strdup("osinfo", query);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "DBSYNC bulk query: osinfo");
+
+    const int ret = wdb_parse_dbsync_bulk(data->wdb, query, data->output);
+
+    assert_string_equal(data->output, "err Invalid dbsync query syntax, near 'osinfo'");
+    assert_int_equal(ret, OS_INVALID);
+
+    os_free(query);
+}
+
+void test_wdb_parse_dbsync_bulk_invalid_table(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char * query = NULL;
+
+    os_strdup("not_existant_table []", query);
+
+    const int ret = wdb_parse_dbsync_bulk(data->wdb, query, data->output);
+
+    assert_string_equal(data->output, "err Invalid dbsync table, near 'not_existant_table'");
+    assert_int_equal(ret, OS_INVALID);
+
+    os_free(query);
+}
+
+void test_wdb_parse_dbsync_bulk_not_array(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char * query = NULL;
+
+    os_strdup("osinfo {}", query);
+
+    expect_string(__wrap__mdebug1, formatted_msg, DB_DELTA_PARSING_ERR);
+    expect_string(__wrap__mdebug2, formatted_msg, "JSON error near: {}");
+
+    const int ret = wdb_parse_dbsync_bulk(data->wdb, query, data->output);
+
+    assert_string_equal(data->output, "err Invalid JSON syntax, near '{}'");
+    assert_int_equal(ret, OS_INVALID);
+
+    os_free(query);
+}
+
+void test_wdb_parse_dbsync_bulk_ok(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char * query = NULL;
+
+    os_strdup("osinfo [{\"operation\":\"INSERTED\",\"data\":{\"key\":\"value\"}},"
+              "{\"operation\":\"MODIFIED\",\"data\":{\"key\":\"value\"}},"
+              "{\"operation\":\"DELETED\",\"data\":{\"key\":\"value\"}},"
+              "{\"operation\":\"NOOP\",\"data\":{}},"
+              "{\"data\":{}}]", query);
+    data->wdb->transaction = 1;
+
+    expect_function_call(__wrap_wdb_upsert_dbsync);
+    will_return(__wrap_wdb_upsert_dbsync, true);
+    expect_function_call(__wrap_wdb_upsert_dbsync);
+    will_return(__wrap_wdb_upsert_dbsync, false);
+    expect_function_call(__wrap_wdb_delete_dbsync);
+    will_return(__wrap_wdb_delete_dbsync, true);
+    expect_string(__wrap__mdebug1, formatted_msg, "Invalid operation type: NOOP");
+    expect_string(__wrap__mdebug1, formatted_msg, DB_DELTA_PARSING_ERR);
+
+    const int ret = wdb_parse_dbsync_bulk(data->wdb, query, data->output);
+
+    assert_string_equal(data->output, "ok [true,false,true,false,false]");
+    assert_int_equal(ret, OS_SUCCESS);
+
+    os_free(query);
+}
+
+/* wdb_parse_binary */
+
+void test_wdb_parse_binary_invalid_command(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char query[] = { WDB_BIN_MAGIC, WDB_BIN_VERSION, 99, 0 };
+
+    expect_string(__wrap__mdebug1, formatted_msg, "Invalid binary DB query.");
+
+    const int ret = wdb_parse_binary(query, 3, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid binary DB query");
+    assert_int_equal(ret, OS_INVALID);
+}
+
+void test_wdb_parse_binary_dbsync_invalid_table(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char query[OS_SIZE_256];
+    cJSON * delta = cJSON_Parse("{\"key\":\"value\"}");
+
+    ssize_t length = wdb_bin_encode_dbsync(query, sizeof(query) - 1, 0, "invalid", "INSERTED", delta);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Agent 000 binary query: dbsync invalid INSERTED");
+
+    const int ret = wdb_parse_binary(query, length, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid dbsync table, near 'invalid'");
+    assert_int_equal(ret, OS_INVALID);
+
+    cJSON_Delete(delta);
+}
+
+void test_wdb_parse_binary_dbsync_malformed(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char query[OS_SIZE_256];
+    cJSON * delta = cJSON_Parse("{\"key\":\"value\"}");
+
+    ssize_t length = wdb_bin_encode_dbsync(query, sizeof(query) - 1, 0, "osinfo", "INSERTED", delta);
+
+    expect_string(__wrap__mdebug1, formatted_msg, DB_DELTA_PARSING_ERR);
+
+    const int ret = wdb_parse_binary(query, length - 1, data->output, 0);
+
+    assert_string_equal(data->output, "err Invalid binary dbsync query");
+    assert_int_equal(ret, OS_INVALID);
+
+    cJSON_Delete(delta);
+}
+
+void test_wdb_parse_binary_dbsync_insert_ok(void ** state) {
+    test_struct_t * data = (test_struct_t *) *state;
+    char query[OS_SIZE_256];
+    cJSON * delta = cJSON_Parse("{\"key\":\"value\"}");
+
+    ssize_t length = wdb_bin_encode_dbsync(query, sizeof(query) - 1, 0, "osinfo", "INSERTED", delta);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Agent 000 binary query: dbsync osinfo INSERTED");
+    expect_value(__wrap_wdb_open_agent2, agent_id, 0);
+    will_return(__wrap_wdb_open_agent2, data->wdb);
+    expect_function_call(__wrap_wdb_upsert_dbsync);
+    will_return(__wrap_wdb_upsert_dbsync, true);
+
+    const int ret = wdb_parse_binary(query, length, data->output, 0);
+
+    assert_string_equal(data->output, "ok ");
+    assert_int_equal(ret, OS_SUCCESS);
+
+    cJSON_Delete(delta);
+}
+
 /* wdb_parse_global_backup */
 
 void test_wdb_parse_global_backup_invalid_syntax(void **state) {
@@ -2916,6 +3105,7 @@ int main()
         cmocka_unit_test_setup_teardown(test_vuln_cves_insert_constraint_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_vuln_cves_insert_command_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_vuln_cves_insert_command_success, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_vuln_cves_insert_batch_success, test_setup, test_teardown),
         // wdb_parse_agents_update_vuln_cves_status
         cmocka_unit_test_setup_teardown(test_vuln_cves_update_status_syntax_error, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_vuln_cves_update_status_constraint_error, test_setup, test_teardown),
@@ -2974,6 +3164,16 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_modified_err, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_deleted_ok, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_deleted_err, test_setup, test_teardown),
+        /* wdb_parse_dbsync_bulk */
+        cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_bulk_no_deltas, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_bulk_invalid_table, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_bulk_not_array, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_dbsync_bulk_ok, test_setup, test_teardown),
+        /* wdb_parse_binary */
+        cmocka_unit_test_setup_teardown(test_wdb_parse_binary_invalid_command, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_binary_dbsync_invalid_table, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_binary_dbsync_malformed, test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_wdb_parse_binary_dbsync_insert_ok, test_setup, test_teardown),
         /* wdb_parse_global_backup */
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_backup_invalid_syntax, test_setup, test_teardown),
         cmocka_unit_test_setup_teardown(test_wdb_parse_global_backup_missing_action, test_setup, test_teardown),
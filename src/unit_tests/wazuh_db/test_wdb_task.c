@@ -53,6 +53,7 @@ static int test_teardown(void **state){
 void test_wdb_task_delete_old_entries_ok(void **state)
 {
     int timestamp = 12345;
+    int limit = 1000;
 
     test_struct_t *data  = (test_struct_t *)*state;
 
@@ -62,17 +63,22 @@ void test_wdb_task_delete_old_entries_ok(void **state)
     expect_value(__wrap_sqlite3_bind_int, index, 1);
     expect_value(__wrap_sqlite3_bind_int, value, timestamp);
     will_return(__wrap_sqlite3_bind_int, 0);
+    expect_value(__wrap_sqlite3_bind_int, index, 2);
+    expect_value(__wrap_sqlite3_bind_int, value, limit);
+    will_return(__wrap_sqlite3_bind_int, 0);
 
     will_return(__wrap_wdb_step, SQLITE_DONE);
+    will_return(__wrap_sqlite3_changes, 10);
 
-    int ret = wdb_task_delete_old_entries(data->wdb, timestamp);
+    int ret = wdb_task_delete_old_entries(data->wdb, timestamp, limit);
 
-    assert_int_equal(ret, OS_SUCCESS);
+    assert_int_equal(ret, 10);
 }
 
 void test_wdb_task_delete_old_entries_step_err(void **state)
 {
     int timestamp = 12345;
+    int limit = 1000;
 
     test_struct_t *data  = (test_struct_t *)*state;
 
@@ -82,12 +88,15 @@ void test_wdb_task_delete_old_entries_step_err(void **state)
     expect_value(__wrap_sqlite3_bind_int, index, 1);
     expect_value(__wrap_sqlite3_bind_int, value, timestamp);
     will_return(__wrap_sqlite3_bind_int, 0);
+    expect_value(__wrap_sqlite3_bind_int, index, 2);
+    expect_value(__wrap_sqlite3_bind_int, value, limit);
+    will_return(__wrap_sqlite3_bind_int, 0);
 
     will_return(__wrap_wdb_step, -1);
     will_return(__wrap_sqlite3_errmsg, "ERROR MESSAGE");
     expect_string(__wrap__merror, formatted_msg, "(5211): SQL error: 'ERROR MESSAGE'");
 
-    int ret = wdb_task_delete_old_entries(data->wdb, timestamp);
+    int ret = wdb_task_delete_old_entries(data->wdb, timestamp, limit);
 
     assert_int_equal(ret, OS_INVALID);
 }
@@ -95,6 +104,7 @@ void test_wdb_task_delete_old_entries_step_err(void **state)
 void test_wdb_task_delete_old_entries_cache_err(void **state)
 {
     int timestamp = 12345;
+    int limit = 1000;
 
     test_struct_t *data  = (test_struct_t *)*state;
 
@@ -103,7 +113,7 @@ void test_wdb_task_delete_old_entries_cache_err(void **state)
 
     expect_any(__wrap__mdebug1, formatted_msg);
 
-    int ret = wdb_task_delete_old_entries(data->wdb, timestamp);
+    int ret = wdb_task_delete_old_entries(data->wdb, timestamp, limit);
 
     assert_int_equal(ret, OS_INVALID);
 }
@@ -111,6 +121,7 @@ void test_wdb_task_delete_old_entries_cache_err(void **state)
 void test_wdb_task_delete_old_entries_begin2_err(void **state)
 {
     int timestamp = 12345;
+    int limit = 1000;
 
     test_struct_t *data  = (test_struct_t *)*state;
 
@@ -118,7 +129,7 @@ void test_wdb_task_delete_old_entries_begin2_err(void **state)
 
     expect_any(__wrap__mdebug1, formatted_msg);
 
-    int ret = wdb_task_delete_old_entries(data->wdb, timestamp);
+    int ret = wdb_task_delete_old_entries(data->wdb, timestamp, limit);
 
     assert_int_equal(ret, OS_INVALID);
 }
@@ -288,6 +288,66 @@ void test_wdb_parse_task_upgrade_err(void **state)
     assert_string_equal(output, "ok {\"error\":-1}");
 }
 
+void test_wdb_parse_task_upgrade_bulk_ok(void **state)
+{
+    char *node = "master";
+    char *module = "upgrade_module";
+    char *command = "upgrade";
+
+    char output[OS_MAXSTR + 1];
+    *output = '\0';
+
+    cJSON *parameters = cJSON_CreateObject();
+    cJSON *agents = cJSON_CreateArray();
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(15));
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(16));
+    cJSON_AddItemToObject(parameters, "agents", agents);
+    cJSON_AddStringToObject(parameters, "node", node);
+    cJSON_AddStringToObject(parameters, "module", module);
+
+    expect_value(__wrap_wdb_task_insert_task, agent_id, 15);
+    expect_string(__wrap_wdb_task_insert_task, node, node);
+    expect_string(__wrap_wdb_task_insert_task, module, module);
+    expect_string(__wrap_wdb_task_insert_task, command, command);
+    will_return(__wrap_wdb_task_insert_task, 31);
+
+    expect_value(__wrap_wdb_task_insert_task, agent_id, 16);
+    expect_string(__wrap_wdb_task_insert_task, node, node);
+    expect_string(__wrap_wdb_task_insert_task, module, module);
+    expect_string(__wrap_wdb_task_insert_task, command, command);
+    will_return(__wrap_wdb_task_insert_task, OS_INVALID);
+
+    int result = wdb_parse_task_upgrade((wdb_t*)1, parameters, command, output);
+
+    *state = (void*)parameters;
+
+    assert_int_equal(result, 0);
+    assert_string_equal(output, "ok {\"error\":0,\"data\":[{\"agent\":15,\"error\":0,\"task_id\":31},{\"agent\":16,\"error\":-1}]}");
+}
+
+void test_wdb_parse_task_upgrade_bulk_agents_err(void **state)
+{
+    char *command = "upgrade";
+
+    char output[OS_MAXSTR + 1];
+    *output = '\0';
+
+    cJSON *parameters = cJSON_CreateObject();
+    cJSON *agents = cJSON_CreateArray();
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(15));
+    cJSON_AddItemToArray(agents, cJSON_CreateString("016"));
+    cJSON_AddItemToObject(parameters, "agents", agents);
+    cJSON_AddStringToObject(parameters, "node", "master");
+    cJSON_AddStringToObject(parameters, "module", "upgrade_module");
+
+    int result = wdb_parse_task_upgrade((wdb_t*)1, parameters, command, output);
+
+    *state = (void*)parameters;
+
+    assert_int_equal(result, OS_INVALID);
+    assert_string_equal(output, "err Error insert task: 'parsing agent error'");
+}
+
 void test_wdb_parse_task_upgrade_module_err(void **state)
 {
     int agent_id = 15;
@@ -469,6 +529,40 @@ void test_wdb_parse_task_upgrade_update_status_ok(void **state)
     assert_string_equal(output, "ok {\"error\":0}");
 }
 
+void test_wdb_parse_task_upgrade_update_status_bulk_ok(void **state)
+{
+    char *node = "master";
+    char *status = "In progress";
+
+    char output[OS_MAXSTR + 1];
+    *output = '\0';
+
+    cJSON *parameters = cJSON_CreateObject();
+    cJSON *agents = cJSON_CreateArray();
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(15));
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(16));
+    cJSON_AddItemToObject(parameters, "agents", agents);
+    cJSON_AddStringToObject(parameters, "node", node);
+    cJSON_AddStringToObject(parameters, "status", status);
+
+    expect_value(__wrap_wdb_task_update_upgrade_task_status, agent_id, 15);
+    expect_string(__wrap_wdb_task_update_upgrade_task_status, node, node);
+    expect_string(__wrap_wdb_task_update_upgrade_task_status, status, status);
+    will_return(__wrap_wdb_task_update_upgrade_task_status, 0);
+
+    expect_value(__wrap_wdb_task_update_upgrade_task_status, agent_id, 16);
+    expect_string(__wrap_wdb_task_update_upgrade_task_status, node, node);
+    expect_string(__wrap_wdb_task_update_upgrade_task_status, status, status);
+    will_return(__wrap_wdb_task_update_upgrade_task_status, OS_NOTFOUND);
+
+    int result = wdb_parse_task_upgrade_update_status((wdb_t*)1, parameters, output);
+
+    *state = (void*)parameters;
+
+    assert_int_equal(result, 0);
+    assert_string_equal(output, "ok {\"error\":0,\"data\":[{\"agent\":15,\"error\":0},{\"agent\":16,\"error\":-2}]}");
+}
+
 void test_wdb_parse_task_upgrade_update_status_err(void **state)
 {
     int agent_id = 15;
@@ -599,6 +693,45 @@ void test_wdb_parse_task_upgrade_result_ok(void **state)
     assert_string_equal(output, "ok {\"error\":0,\"task_id\":44,\"node\":\"master\",\"module\":\"upgrade_module\",\"command\":\"upgrade_custom\",\"status\":\"Pending\",\"error_msg\":\"Error message\",\"create_time\":123456,\"update_time\":123465}");
 }
 
+void test_wdb_parse_task_upgrade_result_bulk_ok(void **state)
+{
+    char output[OS_MAXSTR + 1];
+    *output = '\0';
+
+    cJSON *parameters = cJSON_CreateObject();
+    cJSON *agents = cJSON_CreateArray();
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(15));
+    cJSON_AddItemToArray(agents, cJSON_CreateNumber(16));
+    cJSON_AddItemToObject(parameters, "agents", agents);
+
+    expect_value(__wrap_wdb_task_get_upgrade_task_by_agent_id, agent_id, 15);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "master");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "upgrade_module");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "upgrade");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "Done");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, 123456);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, 123465);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, 44);
+
+    expect_value(__wrap_wdb_task_get_upgrade_task_by_agent_id, agent_id, 16);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "master");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "upgrade_module");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "upgrade");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "Done");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, "");
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, 123456);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, 123465);
+    will_return(__wrap_wdb_task_get_upgrade_task_by_agent_id, OS_NOTFOUND);
+
+    int result = wdb_parse_task_upgrade_result((wdb_t*)1, parameters, output);
+
+    *state = (void*)parameters;
+
+    assert_int_equal(result, 0);
+    assert_string_equal(output, "ok {\"error\":0,\"data\":[{\"agent\":15,\"error\":0,\"task_id\":44,\"node\":\"master\",\"module\":\"upgrade_module\",\"command\":\"upgrade\",\"status\":\"Done\",\"error_msg\":\"\",\"create_time\":123456,\"update_time\":123465},{\"agent\":16,\"error\":-2}]}");
+}
+
 void test_wdb_parse_task_upgrade_result_err(void **state)
 {
     int agent_id = 15;
@@ -805,6 +938,7 @@ void test_wdb_parse_task_delete_old_ok(void **state)
     cJSON_AddNumberToObject(parameters, "timestamp", timestamp);
 
     expect_value(__wrap_wdb_task_delete_old_entries, timestamp, timestamp);
+    expect_value(__wrap_wdb_task_delete_old_entries, limit, OS_INVALID);
     will_return(__wrap_wdb_task_delete_old_entries, 0);
 
     int result = wdb_parse_task_delete_old((wdb_t*)1, parameters, output);
@@ -812,7 +946,31 @@ void test_wdb_parse_task_delete_old_ok(void **state)
     *state = (void*)parameters;
 
     assert_int_equal(result, 0);
-    assert_string_equal(output, "ok {\"error\":0}");
+    assert_string_equal(output, "ok {\"error\":0,\"deleted\":0}");
+}
+
+void test_wdb_parse_task_delete_old_limit_ok(void **state)
+{
+    int timestamp = 12345;
+    int limit = 1000;
+
+    char output[OS_MAXSTR + 1];
+    *output = '\0';
+
+    cJSON *parameters = cJSON_CreateObject();
+    cJSON_AddNumberToObject(parameters, "timestamp", timestamp);
+    cJSON_AddNumberToObject(parameters, "limit", limit);
+
+    expect_value(__wrap_wdb_task_delete_old_entries, timestamp, timestamp);
+    expect_value(__wrap_wdb_task_delete_old_entries, limit, limit);
+    will_return(__wrap_wdb_task_delete_old_entries, limit);
+
+    int result = wdb_parse_task_delete_old((wdb_t*)1, parameters, output);
+
+    *state = (void*)parameters;
+
+    assert_int_equal(result, 0);
+    assert_string_equal(output, "ok {\"error\":0,\"deleted\":1000}");
 }
 
 void test_wdb_parse_task_delete_old_err(void **state)
@@ -826,6 +984,7 @@ void test_wdb_parse_task_delete_old_err(void **state)
     cJSON_AddNumberToObject(parameters, "timestamp", timestamp);
 
     expect_value(__wrap_wdb_task_delete_old_entries, timestamp, timestamp);
+    expect_value(__wrap_wdb_task_delete_old_entries, limit, OS_INVALID);
     will_return(__wrap_wdb_task_delete_old_entries, OS_INVALID);
 
     int result = wdb_parse_task_delete_old((wdb_t*)1, parameters, output);
@@ -869,6 +1028,8 @@ int main()
         // wdb_parse_task_upgrade
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_ok, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_err, teardown_json),
+        cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_bulk_ok, teardown_json),
+        cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_bulk_agents_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_module_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_node_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_agent_err, teardown_json),
@@ -879,12 +1040,14 @@ int main()
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_get_status_agent_err, teardown_json),
         // wdb_parse_task_upgrade_update_status
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_ok, teardown_json),
+        cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_bulk_ok, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_status_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_node_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_update_status_agent_err, teardown_json),
         // wdb_parse_task_upgrade_result
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_result_ok, teardown_json),
+        cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_result_bulk_ok, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_result_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_upgrade_result_agent_err, teardown_json),
         // wdb_parse_task_upgrade_cancel_tasks
@@ -898,6 +1061,7 @@ int main()
         cmocka_unit_test_teardown(test_wdb_parse_task_set_timeout_now_err, teardown_json),
         // wdb_parse_task_delete_old
         cmocka_unit_test_teardown(test_wdb_parse_task_delete_old_ok, teardown_json),
+        cmocka_unit_test_teardown(test_wdb_parse_task_delete_old_limit_ok, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_delete_old_err, teardown_json),
         cmocka_unit_test_teardown(test_wdb_parse_task_delete_old_timestamp_err, teardown_json)
     };
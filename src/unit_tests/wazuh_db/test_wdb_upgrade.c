@@ -451,6 +451,10 @@ void test_wdb_upgrade_global_full_upgrade_success(void **state)
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, OS_SUCCESS);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, OS_SUCCESS);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -501,6 +505,10 @@ void test_wdb_upgrade_global_full_upgrade_success_from_unversioned_db(void **sta
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, OS_SUCCESS);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, OS_SUCCESS);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -537,6 +545,10 @@ void test_wdb_upgrade_global_update_v1_to_v5_success(void **state)
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, 0);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -599,6 +611,10 @@ void test_wdb_upgrade_global_update_v2_to_v5_success(void **state)
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, 0);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -658,6 +674,10 @@ void test_wdb_upgrade_global_update_v3_to_v5_success(void **state)
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, 0);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -712,6 +732,10 @@ void test_wdb_upgrade_global_update_v4_to_v5_success(void **state)
     expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 5");
     expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v5_sql);
     will_return(__wrap_wdb_sql_exec, 0);
+    // Upgrading database from version 5 to 6
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
 
     ret = wdb_upgrade_global(data->wdb);
 
@@ -747,6 +771,60 @@ void test_wdb_upgrade_global_update_v4_to_v5_fail(void **state)
     assert_int_equal(ret, data->wdb);
 }
 
+void test_wdb_upgrade_global_update_v5_to_v6_success(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_count_tables_with_name, key, "metadata");
+    will_return(__wrap_wdb_count_tables_with_name, 1);
+    will_return(__wrap_wdb_count_tables_with_name, OS_SUCCESS);
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "5");
+    will_return(__wrap_wdb_metadata_get_entry, OS_SUCCESS);
+
+    will_return(__wrap_wdb_global_create_backup, "string");
+    will_return(__wrap_wdb_global_create_backup, OS_SUCCESS);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
+
+    ret = wdb_upgrade_global(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
+void test_wdb_upgrade_global_update_v5_to_v6_fail(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_count_tables_with_name, key, "metadata");
+    will_return(__wrap_wdb_count_tables_with_name, 1);
+    will_return(__wrap_wdb_count_tables_with_name, OS_SUCCESS);
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "5");
+    will_return(__wrap_wdb_metadata_get_entry, OS_SUCCESS);
+
+    will_return(__wrap_wdb_global_create_backup, "string");
+    will_return(__wrap_wdb_global_create_backup, OS_SUCCESS);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 6");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_global_upgrade_v6_sql);
+    will_return(__wrap_wdb_sql_exec, -1);
+    expect_string(__wrap__merror, formatted_msg, "Failed to update global.db to version 6.");
+
+    expect_value(__wrap_wdb_global_restore_backup, save_pre_restore_state, false);
+    will_return(__wrap_wdb_global_restore_backup, OS_INVALID);
+
+    ret = wdb_upgrade_global(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
 void test_wdb_upgrade_global_fail_backup_fail(void **state)
 {
     wdb_t *ret = NULL;
@@ -817,6 +895,74 @@ void test_wdb_is_older_than_v310_step_ok(void **state) {
 }
 
 
+/* Tests wdb_upgrade_tasks */
+
+void test_wdb_upgrade_tasks_v1_to_v2_success(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "1");
+    will_return(__wrap_wdb_metadata_get_entry, OS_SUCCESS);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 2");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_task_manager_upgrade_v2_sql);
+    will_return(__wrap_wdb_sql_exec, 0);
+
+    ret = wdb_upgrade_tasks(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
+void test_wdb_upgrade_tasks_v1_to_v2_fail(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "1");
+    will_return(__wrap_wdb_metadata_get_entry, OS_SUCCESS);
+
+    expect_string(__wrap__mdebug2, formatted_msg, "Updating database 'global' to version 2");
+    expect_string(__wrap_wdb_sql_exec, sql_exec, schema_task_manager_upgrade_v2_sql);
+    will_return(__wrap_wdb_sql_exec, OS_INVALID);
+    expect_string(__wrap__merror, formatted_msg, "Failed to update global.db to version 2.");
+
+    ret = wdb_upgrade_tasks(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
+void test_wdb_upgrade_tasks_last_version(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "2");
+    will_return(__wrap_wdb_metadata_get_entry, OS_SUCCESS);
+
+    ret = wdb_upgrade_tasks(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
+void test_wdb_upgrade_tasks_error_getting_database_version(void **state)
+{
+    wdb_t *ret = NULL;
+    test_struct_t *data  = (test_struct_t *)*state;
+
+    expect_string(__wrap_wdb_metadata_get_entry, key, "db_version");
+    will_return(__wrap_wdb_metadata_get_entry, "");
+    will_return(__wrap_wdb_metadata_get_entry, OS_INVALID);
+    expect_string(__wrap__mwarn, formatted_msg, "DB(global): Error trying to get DB version");
+
+    ret = wdb_upgrade_tasks(data->wdb);
+
+    assert_int_equal(ret, data->wdb);
+}
+
 int main()
 {
 
@@ -847,8 +993,14 @@ int main()
         cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v3_to_v5_fail, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v3_to_v5_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v4_to_v5_fail, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v5_to_v6_success, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v5_to_v6_fail, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_update_v4_to_v5_success, setup_wdb, teardown_wdb),
         cmocka_unit_test_setup_teardown(test_wdb_upgrade_global_fail_backup_fail, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_tasks_v1_to_v2_success, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_tasks_v1_to_v2_fail, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_tasks_last_version, setup_wdb, teardown_wdb),
+        cmocka_unit_test_setup_teardown(test_wdb_upgrade_tasks_error_getting_database_version, setup_wdb, teardown_wdb),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -70,6 +70,7 @@ void test_wm_agent_upgrade_dump_enabled(void **state)
     #ifdef TEST_SERVER
     os_strdup("wazuh.com/packages", config->manager_config.wpk_repository);
     config->manager_config.chunk_size = 512;
+    config->manager_config.window_size = 8;
     config->manager_config.max_threads = 8;
     #else
     config->agent_config.enable_ca_verification = 1;
@@ -90,6 +91,7 @@ void test_wm_agent_upgrade_dump_enabled(void **state)
     #ifdef TEST_SERVER
     assert_int_equal(cJSON_GetObjectItem(conf, "max_threads")->valueint, 8);
     assert_int_equal(cJSON_GetObjectItem(conf, "chunk_size")->valueint, 512);
+    assert_int_equal(cJSON_GetObjectItem(conf, "window_size")->valueint, 8);
     assert_non_null(cJSON_GetObjectItem(conf, "wpk_repository"));
     assert_string_equal(cJSON_GetObjectItem(conf, "wpk_repository")->valuestring, "wazuh.com/packages");
     #else
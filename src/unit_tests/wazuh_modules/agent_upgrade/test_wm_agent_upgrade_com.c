@@ -578,6 +578,9 @@ void test_wm_agent_upgrade_com_open_success(void **state) {
     char *response = wm_agent_upgrade_com_open(command);
     cJSON *response_object = cJSON_Parse(response);
     assert_string_equal(cJSON_GetObjectItem(response_object, task_manager_json_keys[WM_TASK_ERROR_MESSAGE])->valuestring, "ok");
+    cJSON *data_array = cJSON_GetObjectItem(response_object, task_manager_json_keys[WM_TASK_DATA]);
+    assert_int_equal(cJSON_GetArraySize(data_array), 1);
+    assert_string_equal(cJSON_GetArrayItem(data_array, 0)->valuestring, "write_offset");
     cJSON_Delete(response_object);
     os_free(response);
 }
@@ -680,6 +683,59 @@ void test_wm_agent_upgrade_com_write_success(void **state) {
     os_free(response);
 }
 
+void test_wm_agent_upgrade_com_write_offset_success(void **state) {
+    cJSON * command = *state;
+#ifdef TEST_WINAGENT
+    sprintf(file.path, "incoming\\test_file");
+#else
+    sprintf(file.path, "var/incoming/test_file");
+#endif
+
+    cJSON_AddNumberToObject(command, "offset", 512);
+
+    expect_string(__wrap_w_ref_parent_folder, path, "test_file");
+    will_return(__wrap_w_ref_parent_folder, 0);
+
+    will_return(__wrap_fseek, 0);
+
+    will_return(__wrap_fwrite, 8);
+
+    char *response = wm_agent_upgrade_com_write(command);
+    cJSON *response_object = cJSON_Parse(response);
+    assert_string_equal(cJSON_GetObjectItem(response_object, task_manager_json_keys[WM_TASK_ERROR_MESSAGE])->valuestring, "ok");
+    cJSON_Delete(response_object);
+    os_free(response);
+}
+
+void test_wm_agent_upgrade_com_write_offset_error(void **state) {
+    cJSON * command = *state;
+#ifdef TEST_WINAGENT
+    sprintf(file.path, "incoming\\test_file");
+#else
+    sprintf(file.path, "var/incoming/test_file");
+#endif
+
+    cJSON_AddNumberToObject(command, "offset", 512);
+
+    expect_string(__wrap_w_ref_parent_folder, path, "test_file");
+    will_return(__wrap_w_ref_parent_folder, 0);
+
+    will_return(__wrap_fseek, -1);
+
+    expect_string(__wrap__mterror, tag, "wazuh-modulesd:agent-upgrade");
+#ifdef TEST_WINAGENT
+    expect_string(__wrap__mterror, formatted_msg, "(8129): At write: Cannot write on 'incoming\\test_file'");
+#else
+    expect_string(__wrap__mterror, formatted_msg, "(8129): At write: Cannot write on 'var/incoming/test_file'");
+#endif
+
+    char *response = wm_agent_upgrade_com_write(command);
+    cJSON *response_object = cJSON_Parse(response);
+    assert_string_equal(cJSON_GetObjectItem(response_object, task_manager_json_keys[WM_TASK_ERROR_MESSAGE])->valuestring, "Cannot write file");
+    cJSON_Delete(response_object);
+    os_free(response);
+}
+
 void test_wm_agent_upgrade_com_close_file_opened(void **state) {
     cJSON * command = *state;
 
@@ -1885,6 +1941,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_write_different_file_name, setup_write, teardown_commands),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_write_error, setup_write, teardown_commands),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_write_success, setup_write, teardown_commands),
+        cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_write_offset_success, setup_write, teardown_commands),
+        cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_write_offset_error, setup_write, teardown_commands),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_close_file_opened, setup_write, teardown_commands),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_close_invalid_file_name, setup_write, teardown_commands),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_com_close_different_file_name, setup_write, teardown_commands),
@@ -31,18 +31,17 @@
 
 extern w_linked_queue_t *upgrade_queue;
 
-extern sem_t upgrade_semaphore;
-
 typedef struct _test_upgrade_args {
     wm_manager_configs *config;
     wm_agent_task *agent_task;
 } test_upgrade_args;
 
+void* wm_agent_upgrade_upgrade_worker(void *arg);
 void* wm_agent_upgrade_start_upgrade(void *arg);
 int wm_agent_upgrade_send_wpk_to_agent(const wm_agent_task *agent_task, const wm_manager_configs* manager_configs);
 int wm_agent_upgrade_send_lock_restart(int agent_id);
-int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file);
-int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size);
+int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file, bool *write_offset);
+int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size, int window_size);
 int wm_agent_upgrade_send_close(int agent_id, int wpk_message_format, const char *wpk_file);
 int wm_agent_upgrade_send_sha1(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_sha1);
 int wm_agent_upgrade_send_upgrade(int agent_id, int wpk_message_format, const char *wpk_file, const char *installer);
@@ -84,15 +83,15 @@ static int setup_upgrade_args(void **state) {
     state[0] = (void *)args;
     state[1] = (void *)config;
     upgrade_queue = linked_queue_init();
-    sem_init(&upgrade_semaphore, 0, 5);
     return 0;
 }
 
 static int teardown_upgrade_args(void **state) {
+    test_upgrade_args *args = state[0];
     wm_manager_configs *config = state[1];
+    os_free(args);
     os_free(config);
     linked_queue_free(upgrade_queue);
-    sem_destroy(&upgrade_semaphore);
     return 0;
 }
 
@@ -169,16 +168,7 @@ static int teardown_group(void **state) {
 
 int __wrap_CreateThread(void * (*function_pointer)(void *), void *data) {
     check_expected_ptr(function_pointer);
-
-    test_upgrade_args *args = (test_upgrade_args *)data;
-    wm_agent_task *agent_task = args->agent_task;
-    wm_manager_configs *config = args->config;
-
-    check_expected(agent_task);
-    check_expected(config);
-
-    wm_agent_upgrade_free_agent_task(agent_task);
-    os_free(args);
+    check_expected_ptr(data);
 
     return 1;
 }
@@ -390,6 +380,7 @@ void test_wm_agent_upgrade_send_open_ok(void **state)
     (void) state;
 
     int socket = 555;
+    bool write_offset = true;
     int agent = 39;
     char *wpk_file = "test.wpk";
     char *cmd = "039 com open wb test.wpk";
@@ -420,9 +411,10 @@ void test_wm_agent_upgrade_send_open_ok(void **state)
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res);
     will_return(__wrap_wm_agent_upgrade_parse_agent_response, 0);
 
-    int res = wm_agent_upgrade_send_open(agent, format, wpk_file);
+    int res = wm_agent_upgrade_send_open(agent, format, wpk_file, &write_offset);
 
     assert_int_equal(res, 0);
+    assert_false(write_offset);
 }
 
 void test_wm_agent_upgrade_send_open_ok_new(void **state)
@@ -430,6 +422,7 @@ void test_wm_agent_upgrade_send_open_ok_new(void **state)
     (void) state;
 
     int socket = 555;
+    bool write_offset = true;
     int agent = 39;
     char *wpk_file = "test.wpk";
     char *cmd = "039 upgrade {\"command\":\"open\",\"parameters\":{\"mode\":\"wb\",\"file\":\"test.wpk\"}}";
@@ -460,9 +453,52 @@ void test_wm_agent_upgrade_send_open_ok_new(void **state)
     expect_string(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, agent_response, agent_res);
     will_return(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, 0);
 
-    int res = wm_agent_upgrade_send_open(agent, format, wpk_file);
+    int res = wm_agent_upgrade_send_open(agent, format, wpk_file, &write_offset);
 
     assert_int_equal(res, 0);
+    assert_false(write_offset);
+}
+
+void test_wm_agent_upgrade_send_open_ok_write_offset(void **state)
+{
+    (void) state;
+
+    int socket = 555;
+    bool write_offset = false;
+    int agent = 39;
+    char *wpk_file = "test.wpk";
+    char *cmd = "039 upgrade {\"command\":\"open\",\"parameters\":{\"mode\":\"wb\",\"file\":\"test.wpk\"}}";
+    char *agent_res = "{\"error\":0,\"message\":\"ok\",\"data\":[\"write_offset\"]}";
+    int format = 1;
+
+    expect_string(__wrap_OS_ConnectUnixDomain, path, REMOTE_LOCAL_SOCK);
+    expect_value(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM);
+    expect_value(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_MAXSTR);
+    will_return(__wrap_OS_ConnectUnixDomain, socket);
+
+    expect_string(__wrap__mtdebug2, tag, "wazuh-modulesd:agent-upgrade");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"open\",\"parameters\":{\"mode\":\"wb\",\"file\":\"test.wpk\"}}'");
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, socket);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, socket);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res) + 1);
+
+    expect_string(__wrap__mtdebug2, tag, "wazuh-modulesd:agent-upgrade");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":0,\"message\":\"ok\",\"data\":[\"write_offset\"]}'");
+
+    expect_string(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, agent_response, agent_res);
+    will_return(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, 0);
+
+    int res = wm_agent_upgrade_send_open(agent, format, wpk_file, &write_offset);
+
+    assert_int_equal(res, 0);
+    assert_true(write_offset);
 }
 
 void test_wm_agent_upgrade_send_open_retry_ok(void **state)
@@ -470,6 +506,7 @@ void test_wm_agent_upgrade_send_open_retry_ok(void **state)
     (void) state;
 
     int socket = 555;
+    bool write_offset = true;
     int agent = 39;
     char *wpk_file = "test.wpk";
     char *cmd = "039 com open wb test.wpk";
@@ -525,9 +562,10 @@ void test_wm_agent_upgrade_send_open_retry_ok(void **state)
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res2);
     will_return(__wrap_wm_agent_upgrade_parse_agent_response, 0);
 
-    int res = wm_agent_upgrade_send_open(agent, format, wpk_file);
+    int res = wm_agent_upgrade_send_open(agent, format, wpk_file, &write_offset);
 
     assert_int_equal(res, 0);
+    assert_false(write_offset);
 }
 
 void test_wm_agent_upgrade_send_open_retry_err(void **state)
@@ -535,6 +573,7 @@ void test_wm_agent_upgrade_send_open_retry_err(void **state)
     (void) state;
 
     int socket = 555;
+    bool write_offset = true;
     int agent = 39;
     char *wpk_file = "test.wpk";
     char *cmd = "039 com open wb test.wpk";
@@ -599,9 +638,10 @@ void test_wm_agent_upgrade_send_open_retry_err(void **state)
     expect_string_count(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res, 10);
     will_return_count(__wrap_wm_agent_upgrade_parse_agent_response, OS_INVALID, 10);
 
-    int res = wm_agent_upgrade_send_open(agent, format, wpk_file);
+    int res = wm_agent_upgrade_send_open(agent, format, wpk_file, &write_offset);
 
     assert_int_equal(res, OS_INVALID);
+    assert_false(write_offset);
 }
 
 void test_wm_agent_upgrade_send_write_ok(void **state)
@@ -682,7 +722,7 @@ void test_wm_agent_upgrade_send_write_ok(void **state)
     expect_value(__wrap_fclose, _File, 1);
     will_return(__wrap_fclose, 0);
 
-    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size);
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 1);
 
     assert_int_equal(res, 0);
 }
@@ -765,7 +805,7 @@ void test_wm_agent_upgrade_send_write_ok_new(void **state)
     expect_value(__wrap_fclose, _File, 1);
     will_return(__wrap_fclose, 0);
 
-    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size);
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 1);
 
     assert_int_equal(res, 0);
 }
@@ -843,10 +883,13 @@ void test_wm_agent_upgrade_send_write_err(void **state)
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res2);
     will_return(__wrap_wm_agent_upgrade_parse_agent_response, OS_INVALID);
 
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, 0);
+
     expect_value(__wrap_fclose, _File, 1);
     will_return(__wrap_fclose, 0);
 
-    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size);
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 1);
 
     assert_int_equal(res, OS_INVALID);
 }
@@ -865,11 +908,168 @@ void test_wm_agent_upgrade_send_write_open_err(void **state)
     expect_string(__wrap_fopen, mode, "rb");
     will_return(__wrap_fopen, 0);
 
-    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size);
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 1);
 
     assert_int_equal(res, OS_INVALID);
 }
 
+void test_wm_agent_upgrade_send_write_window_ok(void **state)
+{
+    (void) state;
+
+    int socket1 = 555;
+    int socket2 = 556;
+    int agent = 39;
+    char *wpk_file = "test.wpk";
+    char *file_path = "/var/upgrade/wazuh_agent.wpk";
+    int chunk_size = 5;
+    char *chunk = "test\n";
+    char *cmd1 = "039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":0}}";
+    char *cmd2 = "039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":5}}";
+    char *agent_res = "{\"error\":0,\"message\":\"ok\",\"data\": []}";
+    int format = 1;
+
+    expect_string(__wrap_fopen, path, file_path);
+    expect_string(__wrap_fopen, mode, "rb");
+    will_return(__wrap_fopen, 1);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, chunk_size);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, chunk_size);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, 0);
+
+    expect_value(__wrap_fclose, _File, 1);
+    will_return(__wrap_fclose, 0);
+
+    // Both blocks are sent before waiting for the first response
+
+    expect_string_count(__wrap_OS_ConnectUnixDomain, path, REMOTE_LOCAL_SOCK, 2);
+    expect_value_count(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM, 2);
+    expect_value_count(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_MAXSTR, 2);
+    will_return(__wrap_OS_ConnectUnixDomain, socket1);
+    will_return(__wrap_OS_ConnectUnixDomain, socket2);
+
+    expect_string_count(__wrap__mtdebug2, tag, "wazuh-modulesd:agent-upgrade", 4);
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":0}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":5}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":0,\"message\":\"ok\",\"data\": []}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":0,\"message\":\"ok\",\"data\": []}'");
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, socket1);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd1));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd1);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, socket2);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd2));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd2);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, socket1);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res) + 1);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, socket2);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res) + 1);
+
+    expect_string_count(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, agent_response, agent_res, 2);
+    will_return_count(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, 0, 2);
+
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 2);
+
+    assert_int_equal(res, 0);
+}
+
+void test_wm_agent_upgrade_send_write_window_resume(void **state)
+{
+    (void) state;
+
+    int socket = 555;
+    int agent = 39;
+    char *wpk_file = "test.wpk";
+    char *file_path = "/var/upgrade/wazuh_agent.wpk";
+    int chunk_size = 5;
+    char *chunk = "test\n";
+    char *cmd1 = "039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":0}}";
+    char *cmd2 = "039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":5}}";
+    char *agent_res_ok = "{\"error\":0,\"message\":\"ok\",\"data\": []}";
+    char *agent_res_err = "{\"error\":1,\"message\":\"Agent not connected\",\"data\": []}";
+    int format = 1;
+
+    expect_string(__wrap_fopen, path, file_path);
+    expect_string(__wrap_fopen, mode, "rb");
+    will_return(__wrap_fopen, 1);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, chunk_size);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, chunk_size);
+
+    will_return(__wrap_fread, chunk);
+    will_return(__wrap_fread, 0);
+
+    expect_value(__wrap_fclose, _File, 1);
+    will_return(__wrap_fclose, 0);
+
+    // The first block fails, the one in flight is dropped and both are sent again
+
+    expect_string_count(__wrap_OS_ConnectUnixDomain, path, REMOTE_LOCAL_SOCK, 4);
+    expect_value_count(__wrap_OS_ConnectUnixDomain, type, SOCK_STREAM, 4);
+    expect_value_count(__wrap_OS_ConnectUnixDomain, max_msg_size, OS_MAXSTR, 4);
+    will_return_count(__wrap_OS_ConnectUnixDomain, socket, 4);
+
+    expect_string_count(__wrap__mtdebug2, tag, "wazuh-modulesd:agent-upgrade", 7);
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":0}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":5}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":1,\"message\":\"Agent not connected\",\"data\": []}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":0}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '039 upgrade {\"command\":\"write\",\"parameters\":{\"buffer\":\"dGVzdAo=\",\"length\":5,\"file\":\"test.wpk\",\"offset\":5}}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":0,\"message\":\"ok\",\"data\": []}'");
+    expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: '{\"error\":0,\"message\":\"ok\",\"data\": []}'");
+
+    expect_value_count(__wrap_OS_SendSecureTCP, sock, socket, 4);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd1));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd1);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd2));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd2);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd1));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd1);
+    expect_value(__wrap_OS_SendSecureTCP, size, strlen(cmd2));
+    expect_string(__wrap_OS_SendSecureTCP, msg, cmd2);
+    will_return_count(__wrap_OS_SendSecureTCP, 0, 4);
+
+    expect_value_count(__wrap_OS_RecvSecureTCP, sock, socket, 3);
+    expect_value_count(__wrap_OS_RecvSecureTCP, size, OS_MAXSTR, 3);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res_err);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res_err) + 1);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res_ok);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res_ok) + 1);
+    will_return(__wrap_OS_RecvSecureTCP, agent_res_ok);
+    will_return(__wrap_OS_RecvSecureTCP, strlen(agent_res_ok) + 1);
+
+    expect_string(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, agent_response, agent_res_err);
+    will_return(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, OS_INVALID);
+    expect_string_count(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, agent_response, agent_res_ok, 2);
+    will_return_count(__wrap_wm_agent_upgrade_parse_agent_upgrade_command_response, 0, 2);
+
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_string(__wrap__mtdebug1, formatted_msg, "(8169): WPK transfer to agent '039' interrupted, resuming from offset 0.");
+
+    expect_value(__wrap_sleep, seconds, 1);
+
+    int res = wm_agent_upgrade_send_write(agent, format, wpk_file, file_path, chunk_size, 2);
+
+    assert_int_equal(res, 0);
+}
+
 void test_wm_agent_upgrade_send_close_ok(void **state)
 {
     (void) state;
@@ -1480,6 +1680,9 @@ void test_wm_agent_upgrade_send_wpk_to_agent_upgrade_linux_ok(void **state)
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '111 com upgrade test.wpk upgrade.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -1647,6 +1850,9 @@ void test_wm_agent_upgrade_send_wpk_to_agent_upgrade_windows_ok(void **state)
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '111 com upgrade test.wpk upgrade.bat'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -1812,6 +2018,9 @@ void test_wm_agent_upgrade_send_wpk_to_agent_upgrade_custom_custom_installer_ok(
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '111 com upgrade test.wpk test.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -1976,6 +2185,9 @@ void test_wm_agent_upgrade_send_wpk_to_agent_upgrade_custom_default_installer_ok
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '111 com upgrade test.wpk upgrade.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -2529,6 +2741,9 @@ void test_wm_agent_upgrade_send_wpk_to_agent_upgrade_write_file_err(void **state
     will_return(__wrap_fread, "test\n");
     will_return(__wrap_fread, config->chunk_size);
 
+    will_return(__wrap_fread, "test\n");
+    will_return(__wrap_fread, 0);
+
     expect_value(__wrap_OS_SendSecureTCP, sock, socket);
     expect_value(__wrap_OS_SendSecureTCP, size, strlen(write_file));
     expect_string(__wrap_OS_SendSecureTCP, msg, write_file);
@@ -3072,6 +3287,9 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_ok(void **state)
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '025 com upgrade test.wpk upgrade.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -3081,11 +3299,6 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_ok(void **state)
     will_return_count(__wrap_wm_agent_upgrade_parse_agent_response, 0, 6);
 
     wm_agent_upgrade_start_upgrade(args);
-
-    int value = 0;
-    sem_getvalue(&upgrade_semaphore, &value);
-
-    assert_int_equal(value, 6);
 }
 
 void test_wm_agent_upgrade_start_upgrade_upgrade_legacy_ok(void **state)
@@ -3304,6 +3517,9 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_legacy_ok(void **state)
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '025 com upgrade test.wpk upgrade.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -3337,11 +3553,6 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_legacy_ok(void **state)
     will_return(__wrap_wm_agent_upgrade_validate_task_status_message, agent_id);
 
     wm_agent_upgrade_start_upgrade(args);
-
-    int value = 0;
-    sem_getvalue(&upgrade_semaphore, &value);
-
-    assert_int_equal(value, 6);
 }
 
 void test_wm_agent_upgrade_start_upgrade_upgrade_custom_ok(void **state)
@@ -3537,6 +3748,9 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_custom_ok(void **state)
     expect_string(__wrap__mtdebug2, formatted_msg, "(8165): Sending message to agent: '025 com upgrade test.wpk upgrade.sh'");
     expect_string(__wrap__mtdebug2, formatted_msg, "(8166): Receiving message from agent: 'ok 0'");
 
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:agent-upgrade");
+    expect_any(__wrap__mtdebug1, formatted_msg);
+
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
     expect_string(__wrap_wm_agent_upgrade_parse_agent_response, agent_response, agent_res_ok);
@@ -3546,11 +3760,6 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_custom_ok(void **state)
     will_return_count(__wrap_wm_agent_upgrade_parse_agent_response, 0, 6);
 
     wm_agent_upgrade_start_upgrade(args);
-
-    int value = 0;
-    sem_getvalue(&upgrade_semaphore, &value);
-
-    assert_int_equal(value, 6);
 }
 
 void test_wm_agent_upgrade_start_upgrade_upgrade_err(void **state)
@@ -3707,11 +3916,6 @@ void test_wm_agent_upgrade_start_upgrade_upgrade_err(void **state)
     will_return(__wrap_wm_agent_upgrade_validate_task_status_message, agent_id);
 
     wm_agent_upgrade_start_upgrade(args);
-
-    int value = 0;
-    sem_getvalue(&upgrade_semaphore, &value);
-
-    assert_int_equal(value, 6);
 }
 
 void test_wm_agent_upgrade_dispatch_upgrades(void **state) {
@@ -3719,28 +3923,63 @@ void test_wm_agent_upgrade_dispatch_upgrades(void **state) {
 
     config->max_threads = 8;
 
-    wm_agent_task *agent_task_next = NULL;
-    wm_upgrade_task *upgrade_task_next = NULL;
+    expect_value_count(__wrap_CreateThread, function_pointer, wm_agent_upgrade_upgrade_worker, 8);
+    expect_value_count(__wrap_CreateThread, data, config, 8);
 
-    wm_agent_task *agent_task = wm_agent_upgrade_init_agent_task();
+    wm_agent_upgrade_dispatch_upgrades(config);
+}
 
-    config->chunk_size = 5;
+void test_wm_agent_upgrade_upgrade_worker(void **state) {
+    wm_manager_configs *config = *state;
+    int agent_id = 25;
+    char *status = "In progress";
+
+    wm_agent_task *agent_task = wm_agent_upgrade_init_agent_task();
+    agent_task->agent_info = wm_agent_upgrade_init_agent_info();
+    agent_task->agent_info->agent_id = agent_id;
 
     linked_queue_push(upgrade_queue, agent_task);
 
+    cJSON *task_request_status = cJSON_CreateObject();
+    cJSON *origin = cJSON_CreateObject();
+    cJSON *parameters = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(origin, "module", "upgrade_module");
+    cJSON_AddItemToObject(task_request_status, "origin", origin);
+    cJSON_AddStringToObject(task_request_status, "command", "upgrade_update_status");
+    cJSON_AddStringToObject(parameters, "status", status);
+    cJSON_AddItemToObject(task_request_status, "parameters", parameters);
+
+    cJSON *task_response_status = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(task_response_status, "error", WM_UPGRADE_SUCCESS);
+    cJSON_AddStringToObject(task_response_status, "message", upgrade_error_codes[WM_UPGRADE_SUCCESS]);
+    cJSON_AddNumberToObject(task_response_status, "agent", agent_id);
+    cJSON_AddStringToObject(task_response_status, "status", status);
+
     will_return(__wrap_linked_queue_pop_ex, 1);
     expect_memory(__wrap_linked_queue_pop_ex, queue, upgrade_queue, sizeof(upgrade_queue));
 
-    expect_memory(__wrap_CreateThread, function_pointer, wm_agent_upgrade_start_upgrade, sizeof(wm_agent_upgrade_start_upgrade));
-    expect_memory(__wrap_CreateThread, agent_task, agent_task, sizeof(agent_task));
-    expect_memory(__wrap_CreateThread, config, config, sizeof(config));
+    // wm_agent_upgrade_parse_task_module_request
 
-    wm_agent_upgrade_dispatch_upgrades(config);
+    expect_value(__wrap_wm_agent_upgrade_parse_task_module_request, command, WM_UPGRADE_AGENT_UPDATE_STATUS);
+    will_return(__wrap_wm_agent_upgrade_parse_task_module_request, task_request_status);
+    expect_string(__wrap_wm_agent_upgrade_parse_task_module_request, status, status);
+
+    // wm_agent_upgrade_task_module_callback
+
+    expect_memory(__wrap_wm_agent_upgrade_task_module_callback, task_module_request, task_request_status, sizeof(task_request_status));
+    will_return(__wrap_wm_agent_upgrade_task_module_callback, task_response_status);
+    will_return(__wrap_wm_agent_upgrade_task_module_callback, 0);
+
+    // wm_agent_upgrade_validate_task_status_message
+
+    expect_memory(__wrap_wm_agent_upgrade_validate_task_status_message, input_json, task_response_status, sizeof(task_response_status));
+    will_return(__wrap_wm_agent_upgrade_validate_task_status_message, 0);
 
-    int value = 0;
-    sem_getvalue(&upgrade_semaphore, &value);
+    wm_agent_upgrade_upgrade_worker(config);
 
-    assert_int_equal(value, 7);
+    assert_null(upgrade_queue->first);
 }
 
 void test_wm_agent_upgrade_prepare_upgrades_ok(void **state) {
@@ -3818,6 +4057,7 @@ int main(void) {
         // wm_agent_upgrade_send_open
         cmocka_unit_test(test_wm_agent_upgrade_send_open_ok),
         cmocka_unit_test(test_wm_agent_upgrade_send_open_ok_new),
+        cmocka_unit_test(test_wm_agent_upgrade_send_open_ok_write_offset),
         cmocka_unit_test(test_wm_agent_upgrade_send_open_retry_ok),
         cmocka_unit_test(test_wm_agent_upgrade_send_open_retry_err),
         // wm_agent_upgrade_send_write
@@ -3825,6 +4065,8 @@ int main(void) {
         cmocka_unit_test(test_wm_agent_upgrade_send_write_ok_new),
         cmocka_unit_test(test_wm_agent_upgrade_send_write_err),
         cmocka_unit_test(test_wm_agent_upgrade_send_write_open_err),
+        cmocka_unit_test(test_wm_agent_upgrade_send_write_window_ok),
+        cmocka_unit_test(test_wm_agent_upgrade_send_write_window_resume),
         // wm_agent_upgrade_send_close
         cmocka_unit_test(test_wm_agent_upgrade_send_close_ok),
         cmocka_unit_test(test_wm_agent_upgrade_send_close_ok_new),
@@ -3860,6 +4102,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_start_upgrade_upgrade_err, setup_upgrade_args, teardown_upgrade_args),
         // wm_agent_upgrade_dispatch_upgrades
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_dispatch_upgrades, setup_config, teardown_config),
+        // wm_agent_upgrade_upgrade_worker
+        cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_upgrade_worker, setup_config, teardown_config),
         // wm_agent_upgrade_prepare_upgrades
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_prepare_upgrades_ok, setup_nodes, teardown_nodes),
         cmocka_unit_test_setup_teardown(test_wm_agent_upgrade_prepare_upgrades_multiple, setup_nodes, teardown_nodes),
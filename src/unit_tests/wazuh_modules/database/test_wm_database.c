@@ -404,7 +404,7 @@ void test_sync_keys_with_wdb_insert(void **state) {
     expect_string(__wrap_OS_IsAllowedID, id, keys.keyentries[0]->id);
     will_return(__wrap_OS_IsAllowedID, 0);
 
-    sync_keys_with_wdb(&keys);
+    assert_int_equal(sync_keys_with_wdb(&keys), OS_INVALID);
 }
 
 void test_sync_keys_with_wdb_delete(void **state) {
@@ -440,7 +440,7 @@ void test_sync_keys_with_wdb_delete(void **state) {
     expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:database");
     expect_string(__wrap__mtdebug1, formatted_msg, "Couldn't remove agent '001' from the database.");
 
-    sync_keys_with_wdb(&keys);
+    assert_int_equal(sync_keys_with_wdb(&keys), OS_INVALID);
 }
 
 void test_sync_keys_with_wdb_insert_delete(void **state) {
@@ -508,7 +508,7 @@ void test_sync_keys_with_wdb_insert_delete(void **state) {
     expect_string(__wrap_fopen, mode, "r");
     will_return(__wrap_fopen, NULL);
 
-    sync_keys_with_wdb(&keys);
+    assert_int_equal(sync_keys_with_wdb(&keys), OS_SUCCESS);
 }
 
 void test_sync_keys_with_wdb_null(void **state) {
@@ -521,7 +521,65 @@ void test_sync_keys_with_wdb_null(void **state) {
     expect_string(__wrap__mterror, tag, "wazuh-modulesd:database");
     expect_string(__wrap__mterror, formatted_msg, "Couldn't synchronize the keystore with the DB.");
 
-    sync_keys_with_wdb(&keys);
+    assert_int_equal(sync_keys_with_wdb(&keys), OS_INVALID);
+}
+
+/* Tests sync_keys_diff_with_wdb */
+
+void test_sync_keys_diff_with_wdb_added(void **state) {
+    keystore keys = *((keystore *)*state);
+    keystore old_keys = KEYSTORE_INITIALIZER;
+    keys.keysize = 1;
+
+    char *test_ip = "1.1.1.1";
+
+    expect_string(__wrap_OS_IsAllowedID, id, keys.keyentries[0]->id);
+    will_return(__wrap_OS_IsAllowedID, -1);
+
+    expect_string(__wrap__mtdebug2, tag, "wazuh-modulesd:database");
+    expect_string(__wrap__mtdebug2, formatted_msg, "Synchronizing agent 001 'agent1'.");
+
+    expect_any(__wrap_OS_CIDRtoStr, ip);
+    expect_value(__wrap_OS_CIDRtoStr, size, IPSIZE);
+    will_return(__wrap_OS_CIDRtoStr, test_ip);
+    will_return(__wrap_OS_CIDRtoStr, 0);
+
+    expect_value(__wrap_wdb_insert_agent, id, 1);
+    expect_string(__wrap_wdb_insert_agent, name, keys.keyentries[0]->name);
+    expect_string(__wrap_wdb_insert_agent, register_ip, test_ip);
+    expect_string(__wrap_wdb_insert_agent, internal_key, keys.keyentries[0]->raw_key);
+    expect_value(__wrap_wdb_insert_agent, keep_date, 1);
+    will_return(__wrap_wdb_insert_agent, 0);
+
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:database");
+    expect_string(__wrap__mtdebug1, formatted_msg, "Agents synchronized: 1 added, 0 removed.");
+
+    assert_int_equal(sync_keys_diff_with_wdb(&old_keys, &keys), OS_SUCCESS);
+}
+
+void test_sync_keys_diff_with_wdb_removed(void **state) {
+    keystore old_keys = *((keystore *)*state);
+    keystore keys = KEYSTORE_INITIALIZER;
+    old_keys.keysize = 1;
+
+    char *test_name = strdup("TESTNAME");
+
+    expect_string(__wrap_OS_IsAllowedID, id, old_keys.keyentries[0]->id);
+    will_return(__wrap_OS_IsAllowedID, -1);
+
+    expect_value(__wrap_wdb_get_agent_name, id, 1);
+    will_return(__wrap_wdb_get_agent_name, test_name);
+
+    expect_value(__wrap_wdb_remove_agent, id, 1);
+    will_return(__wrap_wdb_remove_agent, -1);
+
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:database");
+    expect_string(__wrap__mtdebug1, formatted_msg, "Couldn't remove agent '001' from the database.");
+
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:database");
+    expect_string(__wrap__mtdebug1, formatted_msg, "Agents synchronized: 0 added, 1 removed.");
+
+    assert_int_equal(sync_keys_diff_with_wdb(&old_keys, &keys), OS_INVALID);
 }
 
 int main()
@@ -543,6 +601,9 @@ int main()
         cmocka_unit_test_setup_teardown(test_sync_keys_with_wdb_delete, setup_keys_to_db, teardown_keys_to_db),
         cmocka_unit_test_setup_teardown(test_sync_keys_with_wdb_insert_delete, setup_keys_to_db, teardown_keys_to_db),
         cmocka_unit_test_setup_teardown(test_sync_keys_with_wdb_null, setup_keys_to_db, teardown_keys_to_db),
+        // sync_keys_diff_with_wdb
+        cmocka_unit_test_setup_teardown(test_sync_keys_diff_with_wdb_added, setup_keys_to_db, teardown_keys_to_db),
+        cmocka_unit_test_setup_teardown(test_sync_keys_diff_with_wdb_removed, setup_keys_to_db, teardown_keys_to_db),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -272,7 +272,7 @@ void test_wm_task_manager_command_upgrade_ok(void **state)
     int agent_id = 35;
     int task_id = 24;
 
-    char *wdb_response = "ok {\"error\":0,\"task_id\":24}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":0,\"task_id\":24}]}";
 
     wm_task_manager_upgrade *task_parameters = wm_task_manager_init_upgrade_parameters();
     int *agents = NULL;
@@ -288,7 +288,7 @@ void test_wm_task_manager_command_upgrade_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"agent\":35,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -321,7 +321,7 @@ void test_wm_task_manager_command_upgrade_custom_ok(void **state)
     int agent_id = 35;
     int task_id = 24;
 
-    char *wdb_response = "ok {\"error\":0,\"task_id\":24}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":0,\"task_id\":24}]}";
 
     wm_task_manager_upgrade *task_parameters = wm_task_manager_init_upgrade_parameters();
     int *agents = NULL;
@@ -337,7 +337,7 @@ void test_wm_task_manager_command_upgrade_custom_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_custom {\"agent\":35,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_custom {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -369,7 +369,7 @@ void test_wm_task_manager_command_upgrade_db_err(void **state)
     int error_code = 0;
     int agent_id = 35;
 
-    char *wdb_response = "ok {\"error\":-1}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":-1}]}";
 
     wm_task_manager_upgrade *task_parameters = wm_task_manager_init_upgrade_parameters();
     int *agents = NULL;
@@ -383,7 +383,7 @@ void test_wm_task_manager_command_upgrade_db_err(void **state)
     task_parameters->agent_ids = agents;
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"agent\":35,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -419,7 +419,7 @@ void test_wm_task_manager_command_upgrade_db_response_null(void **state)
     task_parameters->agent_ids = agents;
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"agent\":35,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, NULL);
     will_return(__wrap_wdbc_query_ex, OS_INVALID);
@@ -558,7 +558,7 @@ void test_wm_task_manager_command_upgrade_update_status_ok(void **state)
     int agent_id = 35;
     char *status = "Done";
 
-    char *wdb_response = "ok {\"error\":0}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":0}]}";
 
     wm_task_manager_upgrade_update_status *task_parameters = wm_task_manager_init_upgrade_update_status_parameters();
     int *agents = NULL;
@@ -574,7 +574,7 @@ void test_wm_task_manager_command_upgrade_update_status_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"agent\":35,\"node\":\"node02\",\"status\":\"Done\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"node\":\"node02\",\"status\":\"Done\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -605,7 +605,7 @@ void test_wm_task_manager_command_upgrade_update_status_task_err(void **state)
     int agent_id = 35;
     char *status = "Done";
 
-    char *wdb_response = "ok {\"error\":-2}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":-2}]}";
 
     wm_task_manager_upgrade_update_status *task_parameters = wm_task_manager_init_upgrade_update_status_parameters();
     int *agents = NULL;
@@ -621,7 +621,7 @@ void test_wm_task_manager_command_upgrade_update_status_task_err(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"agent\":35,\"node\":\"node02\",\"status\":\"Done\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"node\":\"node02\",\"status\":\"Done\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -652,7 +652,7 @@ void test_wm_task_manager_command_upgrade_update_status_db_err(void **state)
     int agent_id = 35;
     char *status = "Done";
 
-    char *wdb_response = "ok {\"error\":-1}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":-1}]}";
 
     wm_task_manager_upgrade_update_status *task_parameters = wm_task_manager_init_upgrade_update_status_parameters();
     int *agents = NULL;
@@ -666,7 +666,7 @@ void test_wm_task_manager_command_upgrade_update_status_db_err(void **state)
     os_strdup(status, task_parameters->status);
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"agent\":35,\"node\":\"node02\",\"status\":\"Done\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"node\":\"node02\",\"status\":\"Done\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -701,7 +701,7 @@ void test_wm_task_manager_command_upgrade_update_status_db_response_null(void **
     os_strdup(status, task_parameters->status);
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"agent\":35,\"node\":\"node02\",\"status\":\"Done\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"node\":\"node02\",\"status\":\"Done\",\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, NULL);
     will_return(__wrap_wdbc_query_ex, OS_INVALID);
@@ -732,7 +732,7 @@ void test_wm_task_manager_command_upgrade_result_ok(void **state)
     int create_time = 789456123;
     int last_update = 987654321;
 
-    char *wdb_response = "ok {\"error\":0,\"task_id\":24,\"node\":\"node01\",\"module\":\"upgrade_module\",\"command\":\"upgrade\",\"create_time\":789456123,\"update_time\":987654321,\"status\":\"In progress\",\"error_msg\":\"Error string\"}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":0,\"task_id\":24,\"node\":\"node01\",\"module\":\"upgrade_module\",\"command\":\"upgrade\",\"create_time\":789456123,\"update_time\":987654321,\"status\":\"In progress\",\"error_msg\":\"Error string\"}]}";
 
     wm_task_manager_upgrade_result *task_parameters = wm_task_manager_init_upgrade_result_parameters();
     int *agents = NULL;
@@ -746,7 +746,7 @@ void test_wm_task_manager_command_upgrade_result_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agent\":35}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -793,7 +793,7 @@ void test_wm_task_manager_command_upgrade_result_not_found_err(void **state)
     int create_time = 789456123;
     int last_update = 987654321;
 
-    char *wdb_response = "ok {\"error\":-2}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":-2}]}";
 
     wm_task_manager_upgrade_result *task_parameters = wm_task_manager_init_upgrade_result_parameters();
     int *agents = NULL;
@@ -807,7 +807,7 @@ void test_wm_task_manager_command_upgrade_result_not_found_err(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agent\":35}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -837,7 +837,7 @@ void test_wm_task_manager_command_upgrade_result_db_err(void **state)
     int agent_id = 35;
     int task_id = OS_INVALID;
 
-    char *wdb_response = "ok {\"error\":-1}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":35,\"error\":-1}]}";
 
     wm_task_manager_upgrade_result *task_parameters = wm_task_manager_init_upgrade_result_parameters();
     int *agents = NULL;
@@ -849,7 +849,7 @@ void test_wm_task_manager_command_upgrade_result_db_err(void **state)
     task_parameters->agent_ids = agents;
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agent\":35}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -881,7 +881,7 @@ void test_wm_task_manager_command_upgrade_result_db_response_null(void **state)
     task_parameters->agent_ids = agents;
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agent\":35}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agents\":[35]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, NULL);
     will_return(__wrap_wdbc_query_ex, OS_INVALID);
@@ -974,8 +974,7 @@ void test_wm_task_manager_process_task_upgrade_ok(void **state)
     int task_id1 = 38;
     int task_id2 = 39;
 
-    char *wdb_response1 = "ok {\"error\":0,\"task_id\":38}";
-    char *wdb_response2 = "ok {\"error\":0,\"task_id\":39}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":45,\"error\":0,\"task_id\":38},{\"agent\":49,\"error\":0,\"task_id\":39}]}";
 
     wm_task_manager_task *task = wm_task_manager_init_task();
     wm_task_manager_upgrade *task_parameters = wm_task_manager_init_upgrade_parameters();
@@ -996,12 +995,12 @@ void test_wm_task_manager_process_task_upgrade_ok(void **state)
     cJSON* res2 = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"agent\":45,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[45,49]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, wdb_response1);
+    will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
 
-    expect_string(__wrap_wdbc_parse_result, result, wdb_response1);
+    expect_string(__wrap_wdbc_parse_result, result, wdb_response);
     will_return(__wrap_wdbc_parse_result, WDBC_OK);
 
     expect_value(__wrap_wm_task_manager_parse_data_response, error_code, WM_TASK_SUCCESS);
@@ -1009,15 +1008,6 @@ void test_wm_task_manager_process_task_upgrade_ok(void **state)
     expect_value(__wrap_wm_task_manager_parse_data_response, task_id, task_id1);
     will_return(__wrap_wm_task_manager_parse_data_response, res1);
 
-    expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade {\"agent\":49,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, wdb_response2);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, wdb_response2);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
-
     expect_value(__wrap_wm_task_manager_parse_data_response, error_code, WM_TASK_SUCCESS);
     expect_value(__wrap_wm_task_manager_parse_data_response, agent_id, agent_id2);
     expect_value(__wrap_wm_task_manager_parse_data_response, task_id, task_id2);
@@ -1047,8 +1037,7 @@ void test_wm_task_manager_process_task_upgrade_custom_ok(void **state)
     int task_id1 = 38;
     int task_id2 = 39;
 
-    char *wdb_response1 = "ok {\"error\":0,\"task_id\":38}";
-    char *wdb_response2 = "ok {\"error\":0,\"task_id\":39}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":45,\"error\":0,\"task_id\":38},{\"agent\":49,\"error\":0,\"task_id\":39}]}";
 
     wm_task_manager_task *task = wm_task_manager_init_task();
     wm_task_manager_upgrade *task_parameters = wm_task_manager_init_upgrade_parameters();
@@ -1069,12 +1058,12 @@ void test_wm_task_manager_process_task_upgrade_custom_ok(void **state)
     cJSON* res2 = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_custom {\"agent\":45,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_custom {\"node\":\"node02\",\"module\":\"upgrade_module\",\"agents\":[45,49]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, wdb_response1);
+    will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
 
-    expect_string(__wrap_wdbc_parse_result, result, wdb_response1);
+    expect_string(__wrap_wdbc_parse_result, result, wdb_response);
     will_return(__wrap_wdbc_parse_result, WDBC_OK);
 
     expect_value(__wrap_wm_task_manager_parse_data_response, error_code, WM_TASK_SUCCESS);
@@ -1082,15 +1071,6 @@ void test_wm_task_manager_process_task_upgrade_custom_ok(void **state)
     expect_value(__wrap_wm_task_manager_parse_data_response, task_id, task_id1);
     will_return(__wrap_wm_task_manager_parse_data_response, res1);
 
-    expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_custom {\"agent\":49,\"node\":\"node02\",\"module\":\"upgrade_module\"}");
-    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
-    will_return(__wrap_wdbc_query_ex, wdb_response2);
-    will_return(__wrap_wdbc_query_ex, 0);
-
-    expect_string(__wrap_wdbc_parse_result, result, wdb_response2);
-    will_return(__wrap_wdbc_parse_result, WDBC_OK);
-
     expect_value(__wrap_wm_task_manager_parse_data_response, error_code, WM_TASK_SUCCESS);
     expect_value(__wrap_wm_task_manager_parse_data_response, agent_id, agent_id2);
     expect_value(__wrap_wm_task_manager_parse_data_response, task_id, task_id2);
@@ -1168,7 +1148,7 @@ void test_wm_task_manager_process_task_upgrade_update_status_ok(void **state)
     char *status = "Failed";
     char *error = "Error message";
 
-    char *wdb_response = "ok {\"error\":0}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":45,\"error\":0}]}";
 
     wm_task_manager_task *task = wm_task_manager_init_task();
     wm_task_manager_upgrade_update_status *task_parameters = wm_task_manager_init_upgrade_update_status_parameters();
@@ -1188,7 +1168,7 @@ void test_wm_task_manager_process_task_upgrade_update_status_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"agent\":45,\"node\":\"node02\",\"status\":\"Failed\",\"error_msg\":\"Error message\"}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_update_status {\"node\":\"node02\",\"status\":\"Failed\",\"error_msg\":\"Error message\",\"agents\":[45]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -1228,7 +1208,7 @@ void test_wm_task_manager_process_task_upgrade_result_ok(void **state)
     int create_time = 789456123;
     int last_update = 987654321;
 
-    char *wdb_response = "ok {\"error\":0,\"task_id\":38,\"node\":\"node01\",\"module\":\"api\",\"command\":\"upgrade\",\"create_time\":789456123,\"update_time\":987654321,\"status\":\"Updating\",\"error_msg\":\"Error string\"}";
+    char *wdb_response = "ok {\"error\":0,\"data\":[{\"agent\":45,\"error\":0,\"task_id\":38,\"node\":\"node01\",\"module\":\"api\",\"command\":\"upgrade\",\"create_time\":789456123,\"update_time\":987654321,\"status\":\"Updating\",\"error_msg\":\"Error string\"}]}";
 
     wm_task_manager_task *task = wm_task_manager_init_task();
     wm_task_manager_upgrade_result *task_parameters = wm_task_manager_init_upgrade_result_parameters();
@@ -1245,7 +1225,7 @@ void test_wm_task_manager_process_task_upgrade_result_ok(void **state)
     cJSON* res = cJSON_CreateObject();
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agent\":45}");
+    expect_string(__wrap_wdbc_query_ex, query, "task upgrade_result {\"agents\":[45]}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -1365,7 +1345,7 @@ void test_wm_task_manager_clean_tasks(void **state)
     will_return(__wrap_wdbc_parse_result, WDBC_OK);
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task delete_old {\"timestamp\":123455789}");
+    expect_string(__wrap_wdbc_query_ex, query, "task delete_old {\"timestamp\":123455789,\"limit\":1000}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response1);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -1427,7 +1407,7 @@ void test_wm_task_manager_clean_tasks_clean(void **state)
     will_return(__wrap_time, now);
 
     expect_value(__wrap_wdbc_query_ex, *sock, -1);
-    expect_string(__wrap_wdbc_query_ex, query, "task delete_old {\"timestamp\":123455789}");
+    expect_string(__wrap_wdbc_query_ex, query, "task delete_old {\"timestamp\":123455789,\"limit\":1000}");
     expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
     will_return(__wrap_wdbc_query_ex, wdb_response);
     will_return(__wrap_wdbc_query_ex, 0);
@@ -1440,6 +1420,37 @@ void test_wm_task_manager_clean_tasks_clean(void **state)
     assert_int_equal(current_time, now + 200);
 }
 
+void test_wm_task_manager_clean_tasks_clean_step(void **state)
+{
+    wm_task_manager *config = *state;
+
+    config->cleanup_time = 1000;
+    config->task_timeout = 850;
+
+    int now = 123456789;
+
+    char *wdb_response = "ok {\"error\":0,\"deleted\":1000}";
+
+    will_return(__wrap_time, now);
+
+    will_return(__wrap_time, now + 200);
+
+    will_return(__wrap_time, now);
+
+    expect_value(__wrap_wdbc_query_ex, *sock, -1);
+    expect_string(__wrap_wdbc_query_ex, query, "task delete_old {\"timestamp\":123455789,\"limit\":1000}");
+    expect_value(__wrap_wdbc_query_ex, len, OS_MAXSTR);
+    will_return(__wrap_wdbc_query_ex, wdb_response);
+    will_return(__wrap_wdbc_query_ex, 0);
+
+    expect_string(__wrap_wdbc_parse_result, result, wdb_response);
+    will_return(__wrap_wdbc_parse_result, WDBC_OK);
+
+    wm_task_manager_clean_tasks(config);
+
+    assert_int_equal(current_time, now + 1);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         // wm_task_manager_send_message_to_wdb
@@ -1480,7 +1491,8 @@ int main(void) {
         // wm_task_manager_clean_tasks
         cmocka_unit_test_setup_teardown(test_wm_task_manager_clean_tasks, setup_config, teardown_config),
         cmocka_unit_test_setup_teardown(test_wm_task_manager_clean_tasks_timeout, setup_config, teardown_config),
-        cmocka_unit_test_setup_teardown(test_wm_task_manager_clean_tasks_clean, setup_config, teardown_config)
+        cmocka_unit_test_setup_teardown(test_wm_task_manager_clean_tasks_clean, setup_config, teardown_config),
+        cmocka_unit_test_setup_teardown(test_wm_task_manager_clean_tasks_clean_step, setup_config, teardown_config)
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
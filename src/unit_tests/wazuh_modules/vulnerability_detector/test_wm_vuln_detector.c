@@ -56,6 +56,8 @@ int wm_vuldet_add_cve_node(cve_vuln_pkg *newPkg, const char *cve, OSHash *cve_ta
 cJSON *wm_vuldet_get_cvss(const char *scoring_vector);
 void wm_vuldet_free_scan_agent(scan_agent *agent);
 int wm_vuldet_build_unix_os_release(scan_agent *agent, const char* os_major, const char* os_minor, const char* os_patch);
+scan_agent *wm_vuldet_group_agents_by_feed(scan_agent *agents);
+int wm_vuldet_copy_cve_table(OSHash *src, OSHash *dst);
 int wm_vuldet_generate_os_and_kernel_package(sqlite3 *db, scan_agent *agent);
 int wm_vuldet_find_agent_vulnerabilities(sqlite3 *db, scan_agent *agent, wm_vuldet_flags *flags, scan_ctx_t* scan_ctx);
 int wm_vuldet_discard_kernel_package(scan_agent *agent, const char *name, const char *version, const char *arch);
@@ -117,6 +119,7 @@ void wm_vuldet_update_last_scan(scan_ctx_t* scan_ctx);
 time_t wm_vuldet_get_last_scan(scan_ctx_t* scan_ctx);
 time_t wm_vuldet_get_last_full_scan(scan_ctx_t* scan_ctx);
 time_t wm_vuldet_get_last_partial_scan(scan_ctx_t* scan_ctx);
+int wm_vuldet_agent_inventory_changed(scan_ctx_t* scan_ctx);
 bool wm_vuldet_feed_changed (update_node** feeds, scan_agent* agent, time_t last_scan);
 time_t wm_vuldet_get_last_feed_update(vu_feed feed);
 int wm_vuldet_find_obsolete_vulnerabilities(scan_ctx_t* scan_ctx);
@@ -1155,6 +1158,35 @@ void test_wm_vuldet_build_unix_os_release_suse(void **state)
     assert_string_equal(agent->os_release, "15");
 }
 
+/* wm_vuldet_group_agents_by_feed */
+
+void test_wm_vuldet_group_agents_by_feed_empty(void **state)
+{
+    assert_null(wm_vuldet_group_agents_by_feed(NULL));
+}
+
+void test_wm_vuldet_group_agents_by_feed(void **state)
+{
+    scan_agent agents[5] = {0};
+    vu_feed dist[5] = {FEED_UBUNTU, FEED_REDHAT, FEED_UBUNTU, FEED_REDHAT, FEED_UBUNTU};
+    vu_feed dist_ver[5] = {FEED_JAMMY, FEED_RHEL8, FEED_FOCAL, FEED_RHEL8, FEED_JAMMY};
+    int expected[5] = {0, 4, 1, 3, 2};
+
+    for (int i = 0; i < 5; i++) {
+        agents[i].dist = dist[i];
+        agents[i].dist_ver = dist_ver[i];
+        agents[i].next = i < 4 ? &agents[i + 1] : NULL;
+    }
+
+    scan_agent *agents_it = wm_vuldet_group_agents_by_feed(agents);
+
+    for (int i = 0; i < 5; i++) {
+        assert_ptr_equal(agents_it, &agents[expected[i]]);
+        agents_it = agents_it->next;
+    }
+    assert_null(agents_it);
+}
+
 /* wm_vuldet_linux_rm_nvd_not_affected_packages */
 
 void test_wm_vuldet_linux_rm_nvd_not_affected_packages_oval()
@@ -6660,24 +6692,25 @@ void test_wm_vuldet_process_agent_vulnerabilities_vuln_cves_insert_error(void **
     will_return(__wrap_sqlite3_column_text, "RHSA-2020:0975");
     expect_sqlite3_step_call(SQLITE_DONE);
     //Save the vulnerability in the agent database
-    expect_value(__wrap_wdb_insert_vuln_cves, id, 0);
-    expect_string(__wrap_wdb_insert_vuln_cves, name, "libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, version, "5.3.4");
-    expect_string(__wrap_wdb_insert_vuln_cves, architecture, "x86_64");
-    expect_string(__wrap_wdb_insert_vuln_cves, cve, "CVE-2016-6489");
-    expect_string(__wrap_wdb_insert_vuln_cves, severity, "High");
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss2_score, 6.9);
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss3_score, 3.6);
-    expect_string(__wrap_wdb_insert_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
-    expect_string(__wrap_wdb_insert_vuln_cves, type, VULN_CVES_TYPE_PACKAGE);
-    expect_string(__wrap_wdb_insert_vuln_cves, status, "VALID");
-    expect_value(__wrap_wdb_insert_vuln_cves, check_pkg_existence, TRUE);
-    expect_string(__wrap_wdb_insert_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
-    expect_string(__wrap_wdb_insert_vuln_cves, condition, "Package less than 4.3-2");
-    expect_string(__wrap_wdb_insert_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, published, "2017-04-14");
-    expect_string(__wrap_wdb_insert_vuln_cves, updated, "2017-07-01");
-    will_return(__wrap_wdb_insert_vuln_cves, NULL);
+    expect_string(__wrap_wdb_append_vuln_cves, name, "libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, version, "5.3.4");
+    expect_string(__wrap_wdb_append_vuln_cves, architecture, "x86_64");
+    expect_string(__wrap_wdb_append_vuln_cves, cve, "CVE-2016-6489");
+    expect_string(__wrap_wdb_append_vuln_cves, severity, "High");
+    expect_value(__wrap_wdb_append_vuln_cves, cvss2_score, 6.9);
+    expect_value(__wrap_wdb_append_vuln_cves, cvss3_score, 3.6);
+    expect_string(__wrap_wdb_append_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    expect_string(__wrap_wdb_append_vuln_cves, type, VULN_CVES_TYPE_PACKAGE);
+    expect_string(__wrap_wdb_append_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_append_vuln_cves, check_pkg_existence, TRUE);
+    expect_string(__wrap_wdb_append_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
+    expect_string(__wrap_wdb_append_vuln_cves, condition, "Package less than 4.3-2");
+    expect_string(__wrap_wdb_append_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, published, "2017-04-14");
+    expect_string(__wrap_wdb_append_vuln_cves, updated, "2017-07-01");
+    will_return(__wrap_wdb_append_vuln_cves, OS_SUCCESS);
+    expect_value(__wrap_wdb_insert_vuln_cves_batch, id, 0);
+    will_return(__wrap_wdb_insert_vuln_cves_batch, NULL);
 
     configure_wm_vuldet_give_report_format_success();
 
@@ -6727,6 +6760,8 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_error(void **s
     scan_ctx.agent_id = 0;
     cJSON* j_status = __real_cJSON_CreateString("SUCCESS");
     cJSON* j_action = __real_cJSON_CreateString("INSERT");
+    cJSON* j_results = __real_cJSON_CreateArray();
+    __real_cJSON_AddItemToArray(j_results, __real_cJSON_CreateObject());
 
     wm_max_eps = 1000000;
 
@@ -6739,24 +6774,25 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_error(void **s
         return;
 
     //Save the vulnerability in the agent database
-    expect_value(__wrap_wdb_insert_vuln_cves, id, 0);
-    expect_string(__wrap_wdb_insert_vuln_cves, name, "libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, version, "5.3.4");
-    expect_string(__wrap_wdb_insert_vuln_cves, architecture, "x86_64");
-    expect_string(__wrap_wdb_insert_vuln_cves, cve, "CVE-2016-6489");
-    expect_string(__wrap_wdb_insert_vuln_cves, severity, "High");
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss2_score, 6.9);
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss3_score, 3.6);
-    expect_string(__wrap_wdb_insert_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
-    expect_string(__wrap_wdb_insert_vuln_cves, type, VULN_CVES_TYPE_PACKAGE);
-    expect_string(__wrap_wdb_insert_vuln_cves, status, "VALID");
-    expect_value(__wrap_wdb_insert_vuln_cves, check_pkg_existence, TRUE);
-    expect_string(__wrap_wdb_insert_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
-    expect_string(__wrap_wdb_insert_vuln_cves, condition, "Package less than 4.3-2");
-    expect_string(__wrap_wdb_insert_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, published, "2017-04-14");
-    expect_string(__wrap_wdb_insert_vuln_cves, updated, "2017-07-01");
-    will_return(__wrap_wdb_insert_vuln_cves, (cJSON *)1);
+    expect_string(__wrap_wdb_append_vuln_cves, name, "libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, version, "5.3.4");
+    expect_string(__wrap_wdb_append_vuln_cves, architecture, "x86_64");
+    expect_string(__wrap_wdb_append_vuln_cves, cve, "CVE-2016-6489");
+    expect_string(__wrap_wdb_append_vuln_cves, severity, "High");
+    expect_value(__wrap_wdb_append_vuln_cves, cvss2_score, 6.9);
+    expect_value(__wrap_wdb_append_vuln_cves, cvss3_score, 3.6);
+    expect_string(__wrap_wdb_append_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    expect_string(__wrap_wdb_append_vuln_cves, type, VULN_CVES_TYPE_PACKAGE);
+    expect_string(__wrap_wdb_append_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_append_vuln_cves, check_pkg_existence, TRUE);
+    expect_string(__wrap_wdb_append_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
+    expect_string(__wrap_wdb_append_vuln_cves, condition, "Package less than 4.3-2");
+    expect_string(__wrap_wdb_append_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, published, "2017-04-14");
+    expect_string(__wrap_wdb_append_vuln_cves, updated, "2017-07-01");
+    will_return(__wrap_wdb_append_vuln_cves, OS_SUCCESS);
+    expect_value(__wrap_wdb_insert_vuln_cves_batch, id, 0);
+    will_return(__wrap_wdb_insert_vuln_cves_batch, j_results);
 
     configure_wm_vuldet_give_report_format_success();
 
@@ -6923,6 +6959,7 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_error(void **s
     os_free(node);
     __real_cJSON_Delete(j_action);
     __real_cJSON_Delete(j_status);
+    __real_cJSON_Delete(j_results);
 }
 
 void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_negative_version(void **state)
@@ -6935,6 +6972,8 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_negative_versi
     scan_ctx.agent_id = 0;
     cJSON* j_status = __real_cJSON_CreateString("SUCCESS");
     cJSON* j_action = __real_cJSON_CreateString("INSERT");
+    cJSON* j_results = __real_cJSON_CreateArray();
+    __real_cJSON_AddItemToArray(j_results, __real_cJSON_CreateObject());
 
     wm_max_eps = 1000000;
 
@@ -7075,24 +7114,25 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_negative_versi
     will_return(__wrap_sqlite3_column_text, "RHSA-2020:0975");
     expect_sqlite3_step_call(SQLITE_DONE);
     //Save the vulnerability in the agent database
-    expect_value(__wrap_wdb_insert_vuln_cves, id, 0);
-    expect_string(__wrap_wdb_insert_vuln_cves, name, "libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, version, "");
-    expect_string(__wrap_wdb_insert_vuln_cves, architecture, "x86_64");
-    expect_string(__wrap_wdb_insert_vuln_cves, cve, "CVE-2016-6489");
-    expect_string(__wrap_wdb_insert_vuln_cves, severity, "High");
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss2_score, 6.9);
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss3_score, 3.6);
-    expect_string(__wrap_wdb_insert_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
-    expect_string(__wrap_wdb_insert_vuln_cves, type, "PACKAGE");
-    expect_string(__wrap_wdb_insert_vuln_cves, status, "VALID");
-    expect_value(__wrap_wdb_insert_vuln_cves, check_pkg_existence, TRUE);
-    expect_string(__wrap_wdb_insert_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
-    expect_string(__wrap_wdb_insert_vuln_cves, condition, "Package less than 4.3-2");
-    expect_string(__wrap_wdb_insert_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, published, "2017-04-14");
-    expect_string(__wrap_wdb_insert_vuln_cves, updated, "2017-07-01");
-    will_return(__wrap_wdb_insert_vuln_cves, (cJSON *)1);
+    expect_string(__wrap_wdb_append_vuln_cves, name, "libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, version, "");
+    expect_string(__wrap_wdb_append_vuln_cves, architecture, "x86_64");
+    expect_string(__wrap_wdb_append_vuln_cves, cve, "CVE-2016-6489");
+    expect_string(__wrap_wdb_append_vuln_cves, severity, "High");
+    expect_value(__wrap_wdb_append_vuln_cves, cvss2_score, 6.9);
+    expect_value(__wrap_wdb_append_vuln_cves, cvss3_score, 3.6);
+    expect_string(__wrap_wdb_append_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    expect_string(__wrap_wdb_append_vuln_cves, type, "PACKAGE");
+    expect_string(__wrap_wdb_append_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_append_vuln_cves, check_pkg_existence, TRUE);
+    expect_string(__wrap_wdb_append_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
+    expect_string(__wrap_wdb_append_vuln_cves, condition, "Package less than 4.3-2");
+    expect_string(__wrap_wdb_append_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, published, "2017-04-14");
+    expect_string(__wrap_wdb_append_vuln_cves, updated, "2017-07-01");
+    will_return(__wrap_wdb_append_vuln_cves, OS_SUCCESS);
+    expect_value(__wrap_wdb_insert_vuln_cves_batch, id, 0);
+    will_return(__wrap_wdb_insert_vuln_cves_batch, j_results);
 
     configure_wm_vuldet_give_report_format_success();
 
@@ -7133,6 +7173,7 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_negative_versi
     os_free(node);
     __real_cJSON_Delete(j_action);
     __real_cJSON_Delete(j_status);
+    __real_cJSON_Delete(j_results);
 }
 
 void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_adding_data_from_OVAL_error(void **state)
@@ -7296,6 +7337,8 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     scan_ctx.agent_id = 0;
     cJSON* j_status = __real_cJSON_CreateString("SUCCESS");
     cJSON* j_action = __real_cJSON_CreateString("INSERT");
+    cJSON* j_results = __real_cJSON_CreateArray();
+    __real_cJSON_AddItemToArray(j_results, __real_cJSON_CreateObject());
 
     if (!vuldet) {
         return;
@@ -7453,24 +7496,25 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     expect_sqlite3_step_call(SQLITE_DONE);
 
     //Save the vulnerability in the agent database
-    expect_value(__wrap_wdb_insert_vuln_cves, id, 0);
-    expect_string(__wrap_wdb_insert_vuln_cves, name, "libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, version, "5.3.4");
-    expect_string(__wrap_wdb_insert_vuln_cves, architecture, "x86_64");
-    expect_string(__wrap_wdb_insert_vuln_cves, cve, "CVE-2016-6489");
-    expect_string(__wrap_wdb_insert_vuln_cves, severity, "High");
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss2_score, 6.9);
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss3_score, 3.6);
-    expect_string(__wrap_wdb_insert_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
-    expect_string(__wrap_wdb_insert_vuln_cves, type, "PACKAGE");
-    expect_string(__wrap_wdb_insert_vuln_cves, status, "VALID");
-    expect_value(__wrap_wdb_insert_vuln_cves, check_pkg_existence, TRUE);
-    expect_string(__wrap_wdb_insert_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
-    expect_string(__wrap_wdb_insert_vuln_cves, condition, "Package less than 4.3-2");
-    expect_string(__wrap_wdb_insert_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, published, "2017-04-14");
-    expect_string(__wrap_wdb_insert_vuln_cves, updated, "2017-07-01");
-    will_return(__wrap_wdb_insert_vuln_cves, (cJSON *)1);
+    expect_string(__wrap_wdb_append_vuln_cves, name, "libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, version, "5.3.4");
+    expect_string(__wrap_wdb_append_vuln_cves, architecture, "x86_64");
+    expect_string(__wrap_wdb_append_vuln_cves, cve, "CVE-2016-6489");
+    expect_string(__wrap_wdb_append_vuln_cves, severity, "High");
+    expect_value(__wrap_wdb_append_vuln_cves, cvss2_score, 6.9);
+    expect_value(__wrap_wdb_append_vuln_cves, cvss3_score, 3.6);
+    expect_string(__wrap_wdb_append_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    expect_string(__wrap_wdb_append_vuln_cves, type, "PACKAGE");
+    expect_string(__wrap_wdb_append_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_append_vuln_cves, check_pkg_existence, TRUE);
+    expect_string(__wrap_wdb_append_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
+    expect_string(__wrap_wdb_append_vuln_cves, condition, "Package less than 4.3-2");
+    expect_string(__wrap_wdb_append_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, published, "2017-04-14");
+    expect_string(__wrap_wdb_append_vuln_cves, updated, "2017-07-01");
+    will_return(__wrap_wdb_append_vuln_cves, OS_SUCCESS);
+    expect_value(__wrap_wdb_insert_vuln_cves_batch, id, 0);
+    will_return(__wrap_wdb_insert_vuln_cves_batch, j_results);
 
     configure_wm_vuldet_give_report_format_success();
 
@@ -7650,6 +7694,7 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     os_free(vuldet);
     __real_cJSON_Delete(j_action);
     __real_cJSON_Delete(j_status);
+    __real_cJSON_Delete(j_results);
 }
 
 void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors_NVD(void **state)
@@ -7661,6 +7706,8 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     scan_ctx.agent_id = 0;
     cJSON* j_status = __real_cJSON_CreateString("SUCCESS");
     cJSON* j_action = __real_cJSON_CreateString("INSERT");
+    cJSON* j_results = __real_cJSON_CreateArray();
+    __real_cJSON_AddItemToArray(j_results, __real_cJSON_CreateObject());
 
     if (!vuldet) {
         return;
@@ -7819,24 +7866,25 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     expect_sqlite3_step_call(SQLITE_DONE);
 
     //Save the vulnerability in the agent database
-    expect_value(__wrap_wdb_insert_vuln_cves, id, 0);
-    expect_string(__wrap_wdb_insert_vuln_cves, name, "libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, version, "5.3.4");
-    expect_string(__wrap_wdb_insert_vuln_cves, architecture, "x86_64");
-    expect_string(__wrap_wdb_insert_vuln_cves, cve, "CVE-2016-6489");
-    expect_string(__wrap_wdb_insert_vuln_cves, severity, "High");
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss2_score, 6.9);
-    expect_value(__wrap_wdb_insert_vuln_cves, cvss3_score, 3.6);
-    expect_string(__wrap_wdb_insert_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
-    expect_string(__wrap_wdb_insert_vuln_cves, type, "PACKAGE");
-    expect_string(__wrap_wdb_insert_vuln_cves, status, "VALID");
-    expect_value(__wrap_wdb_insert_vuln_cves, check_pkg_existence, TRUE);
-    expect_string(__wrap_wdb_insert_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
-    expect_string(__wrap_wdb_insert_vuln_cves, condition, "Package matches a vulnerable version");
-    expect_string(__wrap_wdb_insert_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
-    expect_string(__wrap_wdb_insert_vuln_cves, published, "2017-04-14");
-    expect_string(__wrap_wdb_insert_vuln_cves, updated, "2017-07-01");
-    will_return(__wrap_wdb_insert_vuln_cves, (cJSON *)1);
+    expect_string(__wrap_wdb_append_vuln_cves, name, "libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, version, "5.3.4");
+    expect_string(__wrap_wdb_append_vuln_cves, architecture, "x86_64");
+    expect_string(__wrap_wdb_append_vuln_cves, cve, "CVE-2016-6489");
+    expect_string(__wrap_wdb_append_vuln_cves, severity, "High");
+    expect_value(__wrap_wdb_append_vuln_cves, cvss2_score, 6.9);
+    expect_value(__wrap_wdb_append_vuln_cves, cvss3_score, 3.6);
+    expect_string(__wrap_wdb_append_vuln_cves, reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    expect_string(__wrap_wdb_append_vuln_cves, type, "PACKAGE");
+    expect_string(__wrap_wdb_append_vuln_cves, status, "VALID");
+    expect_value(__wrap_wdb_append_vuln_cves, check_pkg_existence, TRUE);
+    expect_string(__wrap_wdb_append_vuln_cves, external_references_concatenated, "http://rhn.redhat.com/errata/RHSA-2016-2582.html");
+    expect_string(__wrap_wdb_append_vuln_cves, condition, "Package matches a vulnerable version");
+    expect_string(__wrap_wdb_append_vuln_cves, title, "CVE-2016-6489 affects libhogweed4");
+    expect_string(__wrap_wdb_append_vuln_cves, published, "2017-04-14");
+    expect_string(__wrap_wdb_append_vuln_cves, updated, "2017-07-01");
+    will_return(__wrap_wdb_append_vuln_cves, OS_SUCCESS);
+    expect_value(__wrap_wdb_insert_vuln_cves_batch, id, 0);
+    will_return(__wrap_wdb_insert_vuln_cves_batch, j_results);
 
     configure_wm_vuldet_give_report_format_success();
 
@@ -8016,6 +8064,7 @@ void test_wm_vuldet_process_agent_vulnerabilities_send_cve_report_without_errors
     os_free(vuldet);
     __real_cJSON_Delete(j_action);
     __real_cJSON_Delete(j_status);
+    __real_cJSON_Delete(j_results);
 }
 
 /* wm_vuldet_get_cvss */
@@ -10454,6 +10503,76 @@ void test_wm_vuldet_free_cve_node(void **state)
     next_pkg = NULL;
 }
 
+/* wm_vuldet_copy_cve_table */
+
+void test_wm_vuldet_copy_cve_table(void **state)
+{
+    OSHash *src = (OSHash *)1;
+    OSHash *dst = (OSHash *)2;
+
+    OSHashNode* node = NULL;
+    os_calloc(1, sizeof(OSHashNode), node);
+    if (!node || (OS_INVALID == build_test_hash_node(node, VU_SRC_NVD)))
+        return;
+
+    expect_value(__wrap_OSHash_Begin, self, src);
+    will_return(__wrap_OSHash_Begin, node);
+
+    expect_string(__wrap_OSHash_Add, key, "CVE-2016-6489");
+    will_return(__wrap_OSHash_Add, 2);
+
+    expect_value(__wrap_OSHash_Next, self, src);
+    will_return(__wrap_OSHash_Next, NULL);
+
+    int ret = wm_vuldet_copy_cve_table(src, dst);
+
+    assert_int_equal(ret, 0);
+
+    // The discarded package is not copied
+    cve_vuln_pkg *pkg = __real_OSHash_Get(mock_hashmap, "CVE-2016-6489");
+    cve_vuln_pkg *orig = ((cve_vuln_pkg *)node->data)->next;
+    assert_non_null(pkg);
+    assert_null(pkg->next);
+    assert_string_equal(pkg->bin_name, "libhogweed4");
+    assert_string_equal(pkg->reference, "e91d3dd01b9214df53c8f3985f028112268d2173");
+    assert_int_equal(pkg->feed, VU_SRC_NVD);
+    assert_non_null(pkg->nvd_cond);
+    assert_ptr_not_equal(pkg->nvd_cond, orig->nvd_cond);
+    assert_int_equal(pkg->nvd_cond->id, orig->nvd_cond->id);
+
+    wm_vuldet_free_cve_node(pkg);
+    wm_vuldet_free_cve_node(node->data);
+    os_free(node->key);
+    os_free(node);
+}
+
+void test_wm_vuldet_copy_cve_table_add_error(void **state)
+{
+    OSHash *src = (OSHash *)1;
+    OSHash *dst = (OSHash *)2;
+
+    OSHashNode* node = NULL;
+    os_calloc(1, sizeof(OSHashNode), node);
+    if (!node || (OS_INVALID == build_test_hash_node(node, VU_SRC_NVD)))
+        return;
+
+    expect_value(__wrap_OSHash_Begin, self, src);
+    will_return(__wrap_OSHash_Begin, node);
+
+    expect_string(__wrap_OSHash_Add, key, "CVE-2016-6489");
+    will_return(__wrap_OSHash_Add, 0);
+
+    expect_string(__wrap__merror, formatted_msg, "(1290): Unable to create a new list (calloc).");
+
+    int ret = wm_vuldet_copy_cve_table(src, dst);
+
+    assert_int_equal(ret, OS_INVALID);
+
+    wm_vuldet_free_cve_node(node->data);
+    os_free(node->key);
+    os_free(node);
+}
+
 /* wm_vuldet_find_agent_vulnerabilities */
 
 void test_wm_vuldet_find_agent_vulnerabilities_agent_info_NULL(void **state)
@@ -16477,7 +16596,7 @@ void test_wm_vuldet_json_parser_file_content_NULL(void **state)
     expect_string(__wrap_w_uncompress_bz2_gz_file, dest, VU_FIT_TEMP_FILE);
     will_return(__wrap_w_uncompress_bz2_gz_file, OS_SUCCESS);
 
-    will_return(__wrap_w_get_file_content, NULL);
+    expect_fopen(VU_FIT_TEMP_FILE, "r", NULL);
 
     expect_string(__wrap__mterror, tag, "wazuh-modulesd:vulnerability-detector");
     expect_string(__wrap__mterror, formatted_msg, "(5523): Couldn't get the content of the 'Windows' feed from '/test' file.");
@@ -16510,20 +16629,19 @@ void test_wm_vuldet_json_parser_json_nvd_parser_NULL(void **state)
         return;
     }
 
-    char *content = NULL;
-    os_strdup("test", content);
-
     expect_string(__wrap_w_uncompress_bz2_gz_file, path, "/test");
     expect_string(__wrap_w_uncompress_bz2_gz_file, dest, VU_FIT_TEMP_FILE);
     will_return(__wrap_w_uncompress_bz2_gz_file, 1);
 
-    will_return(__wrap_w_get_file_content, content);
+    expect_fopen("/test", "r", (FILE *)1);
 
     will_return(__wrap_wm_vuldet_json_nvd_parser, OS_INVALID);
 
     expect_string(__wrap__mterror, tag, "wazuh-modulesd:vulnerability-detector");
     expect_string(__wrap__mterror, formatted_msg, "(5524): The 'Windows' feed couldn't be parsed from '/test' file.");
 
+    expect_fclose((FILE *)1, 0);
+
     int ret = wm_vuldet_json_parser(json_path, parsed_vulnerabilities, update);
 
     assert_int_equal(ret,OS_INVALID);
@@ -18357,9 +18475,6 @@ void test_wm_vuldet_index_json_no_multipath_vu_not_need_update(void **state)
     os_calloc(1, sizeof(wm_vuldet_db), parsed_vulnerabilities);
 
     //wm_vuldet_json_parser
-    char *content = NULL;
-    os_strdup("test", content);
-
     expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:vulnerability-detector");
     expect_string(__wrap__mtdebug1, formatted_msg, "(5408): Updating from 'tmp/vuln-temp-deb'");
 
@@ -18368,10 +18483,12 @@ void test_wm_vuldet_index_json_no_multipath_vu_not_need_update(void **state)
     expect_string(__wrap_w_uncompress_bz2_gz_file, dest, VU_FIT_TEMP_FILE);
     will_return(__wrap_w_uncompress_bz2_gz_file, 1);
 
-    will_return(__wrap_w_get_file_content, content);
+    expect_fopen(VU_DEB_TEMP_FILE, "r", (FILE *)1);
 
     will_return(__wrap_wm_vuldet_json_nvd_parser, VU_NOT_NEED_UPDATE);
 
+    expect_fclose((FILE *)1, 0);
+
     int ret = wm_vuldet_index_json(parsed_vulnerabilities, update, path, multi_path);
 
     assert_int_equal(ret, VU_NOT_NEED_UPDATE);
@@ -21762,6 +21879,88 @@ void test_wm_vuldet_get_last_partial_scan_json_fail(void **state)
     assert_int_equal(ret, 0);
 }
 
+// Tests wm_vuldet_agent_inventory_changed
+
+void test_wm_vuldet_agent_inventory_changed_none(void **state)
+{
+    scan_ctx_t scan_ctx = {0};
+    scan_ctx.agent_id = 0;
+
+    const char *query = "agent 0 sql SELECT (SELECT COUNT(*) FROM SYS_PROGRAMS WHERE TRIAGED != 1 OR TRIAGED IS NULL) AS PACKAGES, (SELECT COUNT(*) FROM VULN_CVES WHERE STATUS = 'OBSOLETE') AS OBSOLETE;";
+    size_t query_size = strlen(query) + 1;
+
+    char *response = "ok [{\"PACKAGES\":0,\"OBSOLETE\":0}]";
+    size_t response_size = strlen(response) + 1;
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 11111);
+    expect_value(__wrap_OS_SendSecureTCP, size, query_size);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 11111);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_SIZE_6144);
+    will_return(__wrap_OS_RecvSecureTCP, response);
+    will_return(__wrap_OS_RecvSecureTCP, response_size);
+
+    cJSON* parsed_json = __real_cJSON_CreateArray();
+    cJSON* object = __real_cJSON_CreateObject();
+    __real_cJSON_AddItemToArray(parsed_json, object);
+    cJSON* packages = __real_cJSON_CreateNumber(0);
+    cJSON* obsolete = __real_cJSON_CreateNumber(0);
+    __real_cJSON_AddItemToObject(object, "PACKAGES", packages);
+    __real_cJSON_AddItemToObject(object, "OBSOLETE", obsolete);
+    will_return(__wrap_cJSON_Parse, parsed_json);
+    will_return(__wrap_cJSON_GetObjectItem, packages);
+    will_return(__wrap_cJSON_GetObjectItem, obsolete);
+
+    expect_function_call(__wrap_cJSON_Delete);
+
+    int ret = wm_vuldet_agent_inventory_changed(&scan_ctx);
+    assert_int_equal(ret, 0);
+
+    __real_cJSON_Delete(parsed_json);
+}
+
+void test_wm_vuldet_agent_inventory_changed_packages(void **state)
+{
+    scan_ctx_t scan_ctx = {0};
+    scan_ctx.agent_id = 0;
+
+    const char *query = "agent 0 sql SELECT (SELECT COUNT(*) FROM SYS_PROGRAMS WHERE TRIAGED != 1 OR TRIAGED IS NULL) AS PACKAGES, (SELECT COUNT(*) FROM VULN_CVES WHERE STATUS = 'OBSOLETE') AS OBSOLETE;";
+    size_t query_size = strlen(query) + 1;
+
+    char *response = "ok [{\"PACKAGES\":3,\"OBSOLETE\":0}]";
+    size_t response_size = strlen(response) + 1;
+
+    expect_value(__wrap_OS_SendSecureTCP, sock, 11111);
+    expect_value(__wrap_OS_SendSecureTCP, size, query_size);
+    expect_string(__wrap_OS_SendSecureTCP, msg, query);
+    will_return(__wrap_OS_SendSecureTCP, 0);
+
+    expect_value(__wrap_OS_RecvSecureTCP, sock, 11111);
+    expect_value(__wrap_OS_RecvSecureTCP, size, OS_SIZE_6144);
+    will_return(__wrap_OS_RecvSecureTCP, response);
+    will_return(__wrap_OS_RecvSecureTCP, response_size);
+
+    cJSON* parsed_json = __real_cJSON_CreateArray();
+    cJSON* object = __real_cJSON_CreateObject();
+    __real_cJSON_AddItemToArray(parsed_json, object);
+    cJSON* packages = __real_cJSON_CreateNumber(3);
+    cJSON* obsolete = __real_cJSON_CreateNumber(0);
+    __real_cJSON_AddItemToObject(object, "PACKAGES", packages);
+    __real_cJSON_AddItemToObject(object, "OBSOLETE", obsolete);
+    will_return(__wrap_cJSON_Parse, parsed_json);
+    will_return(__wrap_cJSON_GetObjectItem, packages);
+    will_return(__wrap_cJSON_GetObjectItem, obsolete);
+
+    expect_function_call(__wrap_cJSON_Delete);
+
+    int ret = wm_vuldet_agent_inventory_changed(&scan_ctx);
+    assert_int_equal(ret, 1);
+
+    __real_cJSON_Delete(parsed_json);
+}
+
 // Tests wm_vuldet_feed_changed
 
 void test_wm_vuldet_feed_changed_unix(void **state)
@@ -22747,6 +22946,9 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_wm_vuldet_build_unix_os_release_mac, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_build_unix_os_release_ubuntu, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_build_unix_os_release_suse, setup_scan_agent, teardown_scan_agent),
+        // Tests wm_vuldet_group_agents_by_feed
+        cmocka_unit_test(test_wm_vuldet_group_agents_by_feed_empty),
+        cmocka_unit_test(test_wm_vuldet_group_agents_by_feed),
         // Tests wm_vuldet_linux_rm_nvd_not_affected_packages
         cmocka_unit_test(test_wm_vuldet_linux_rm_nvd_not_affected_packages_oval),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_linux_rm_nvd_not_affected_packages_vendor_Ubuntu, setup_scan_agent, teardown_scan_agent),
@@ -22984,6 +23186,9 @@ int main(void)
         // Tests wm_vuldet_free_cve_node
         cmocka_unit_test(test_wm_vuldet_free_cve_node),
         // Tests wm_vuldet_find_agent_vulnerabilities
+        // Tests wm_vuldet_copy_cve_table
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_copy_cve_table, setup_hashmap, teardown_hashmap),
+        cmocka_unit_test(test_wm_vuldet_copy_cve_table_add_error),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_find_agent_vulnerabilities_agent_info_NULL, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_find_agent_vulnerabilities_agent_windows_error, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_find_agent_vulnerabilities_agent_windows_OK, setup_scan_agent, teardown_scan_agent),
@@ -23132,8 +23337,8 @@ int main(void)
         cmocka_unit_test(test_wm_vuldet_oval_xml_parser_suse_description),
         cmocka_unit_test(test_wm_vuldet_oval_xml_parser_suse_issued),
         // Tests wm_vuldet_json_parser
-        cmocka_unit_test(test_wm_vuldet_json_parser_file_content_NULL),
-        cmocka_unit_test(test_wm_vuldet_json_parser_json_nvd_parser_NULL),
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_json_parser_file_content_NULL, setup_group, teardown_group),
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_json_parser_json_nvd_parser_NULL, setup_group, teardown_group),
         cmocka_unit_test(test_wm_vuldet_json_parser_json_fread_NULL),
         cmocka_unit_test(test_wm_vuldet_json_parser_feed_redhat),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_json_parser_feed_arch_fail, setup_json_parser_decode, teardown_json_parser_decode),
@@ -23159,7 +23364,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_wm_vuldet_index_debian_multiple_packages, setup_debian_json, teardown_debian_json),
         // Tests wm_vuldet_index_json
         cmocka_unit_test(test_wm_vuldet_index_json_no_multipath_parser_invalid),
-        cmocka_unit_test(test_wm_vuldet_index_json_no_multipath_vu_not_need_update),
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_index_json_no_multipath_vu_not_need_update, setup_group, teardown_group),
         cmocka_unit_test(test_wm_vuldet_index_json_multipath_error),
         cmocka_unit_test(test_wm_vuldet_index_json_multipath_opendir_fail),
         cmocka_unit_test(test_wm_vuldet_index_json_multipath_regcomp_fail),
@@ -23287,6 +23492,9 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_wm_vuldet_get_last_scan_request_fail, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_get_last_scan_response_fail, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_get_last_partial_scan_json_fail, setup_scan_agent, teardown_scan_agent),
+        // Tests wm_vuldet_agent_inventory_changed
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_agent_inventory_changed_none, setup_scan_agent, teardown_scan_agent),
+        cmocka_unit_test_setup_teardown(test_wm_vuldet_agent_inventory_changed_packages, setup_scan_agent, teardown_scan_agent),
         // Tests wm_vuldet_feed_changed
         cmocka_unit_test_setup_teardown(test_wm_vuldet_feed_changed_unix, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_feed_changed_windows, setup_scan_agent, teardown_scan_agent),
@@ -1046,6 +1046,115 @@ void test_nvd_verrevcmp_version_a_truncated_number(void **state)
     assert_int_equal(ret, 0);
 }
 
+/* pkg_version_key */
+
+static int compare_keys(const struct pkg_version *a, const struct pkg_version *b, version_type vertype)
+{
+    unsigned char key_a[PKG_VERSION_KEY_SIZE];
+    unsigned char key_b[PKG_VERSION_KEY_SIZE];
+    size_t size_a = pkg_version_key(a, vertype, key_a, sizeof(key_a));
+    size_t size_b = pkg_version_key(b, vertype, key_b, sizeof(key_b));
+    int rc;
+
+    assert_true(size_a > 0);
+    assert_true(size_b > 0);
+
+    rc = memcmp(key_a, key_b, size_a < size_b ? size_a : size_b);
+    return rc ? rc : (int)(size_a > size_b) - (int)(size_a < size_b);
+}
+
+void test_pkg_version_key_deb_tilde(void **state)
+{
+    struct pkg_version *version_a = state[0];
+    struct pkg_version *version_b = state[1];
+
+    version_a->epoch = 0;
+    version_a->version = "1.0~rc1";
+    version_a->revision = "0";
+    version_b->epoch = 0;
+    version_b->version = "1.0";
+    version_b->revision = "0";
+
+    assert_true(compare_keys(version_a, version_b, VER_TYPE_DEB) < 0);
+
+    version_a->version = "1.0a";
+    assert_true(compare_keys(version_a, version_b, VER_TYPE_DEB) > 0);
+
+    version_a->version = "01.00";
+    assert_int_equal(compare_keys(version_a, version_b, VER_TYPE_DEB), 0);
+}
+
+void test_pkg_version_key_deb_epoch(void **state)
+{
+    struct pkg_version *version_a = state[0];
+    struct pkg_version *version_b = state[1];
+
+    version_a->epoch = 1;
+    version_a->version = "1.0";
+    version_a->revision = "1ubuntu1";
+    version_b->epoch = 0;
+    version_b->version = "2.0";
+    version_b->revision = "1ubuntu1";
+
+    assert_true(compare_keys(version_a, version_b, VER_TYPE_DEB) > 0);
+}
+
+void test_pkg_version_key_rpm_caret(void **state)
+{
+    struct pkg_version *version_a = state[0];
+    struct pkg_version *version_b = state[1];
+
+    version_a->epoch = 0;
+    version_a->version = "1.0^git1";
+    version_a->revision = "1.el8";
+    version_b->epoch = 0;
+    version_b->version = "1.0";
+    version_b->revision = "1.el8";
+
+    assert_true(compare_keys(version_a, version_b, VER_TYPE_RPM) > 0);
+
+    version_b->version = "1.0.1";
+    assert_true(compare_keys(version_a, version_b, VER_TYPE_RPM) < 0);
+
+    version_b->version = "1_0^git1";
+    assert_int_equal(compare_keys(version_a, version_b, VER_TYPE_RPM), 0);
+}
+
+void test_pkg_version_key_nvd(void **state)
+{
+    struct pkg_version *version_a = state[0];
+    unsigned char key[PKG_VERSION_KEY_SIZE];
+
+    version_a->epoch = 0;
+    version_a->version = "1.0";
+    version_a->revision = "0";
+
+    assert_int_equal(pkg_version_key(version_a, VER_TYPE_NVD, key, sizeof(key)), 0);
+
+    version_a->epoch = -1;
+    assert_int_equal(pkg_version_key(version_a, VER_TYPE_DEB, key, sizeof(key)), 0);
+}
+
+void test_pkg_version_relate_cached_key(void **state)
+{
+    struct pkg_version *version_a = state[0];
+    struct pkg_version *version_b = state[1];
+
+    version_a->epoch = 0;
+    version_a->version = "2.4.1";
+    version_a->revision = "3";
+    version_b->epoch = 0;
+    version_b->version = "2.4.2";
+    version_b->revision = "1";
+
+    assert_int_equal(pkg_version_relate(version_a, PKG_RELATION_LT, version_b, VER_TYPE_DEB), 1);
+
+    // The key of the package is reused against another condition
+    version_b->version = "2.4";
+    assert_int_equal(pkg_version_relate(version_a, PKG_RELATION_LT, version_b, VER_TYPE_DEB), 0);
+    assert_int_equal(pkg_version_relate(version_a, PKG_RELATION_GT, version_b, VER_TYPE_RPM), 1);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         //Tests order
@@ -1054,6 +1163,12 @@ int main(void) {
         cmocka_unit_test(test_order_tilde),
         cmocka_unit_test(test_order_other),
         cmocka_unit_test(test_order_zero),
+        //Tests pkg_version_key
+        cmocka_unit_test_setup_teardown(test_pkg_version_key_deb_tilde, setup_versions, teardown_versions),
+        cmocka_unit_test_setup_teardown(test_pkg_version_key_deb_epoch, setup_versions, teardown_versions),
+        cmocka_unit_test_setup_teardown(test_pkg_version_key_rpm_caret, setup_versions, teardown_versions),
+        cmocka_unit_test_setup_teardown(test_pkg_version_key_nvd, setup_versions, teardown_versions),
+        cmocka_unit_test_setup_teardown(test_pkg_version_relate_cached_key, setup_versions, teardown_versions),
         //Tests pkg_version_relate
         cmocka_unit_test_setup_teardown(test_pkg_version_relate_epoch_NONE, setup_versions, teardown_versions),
         cmocka_unit_test_setup_teardown(test_pkg_version_relate_epoch_VER_TYPE_unknown, setup_versions, teardown_versions),
@@ -13,9 +13,12 @@
 #include <cmocka.h>
 #include <stdio.h>
 
+#include "../../wrappers/common.h"
 #include "../../wazuh_modules/wmodules.h"
 #include "../../wazuh_modules/vulnerability_detector/wm_vuln_detector.h"
 #include "../../wrappers/externals/sqlite/sqlite3_wrappers.h"
+#include "../../wrappers/libc/stdio_wrappers.h"
+#include "../../wrappers/wazuh/shared/hash_op_wrappers.h"
 #include "../../headers/shared.h"
 #include "mocks_wm_vuln_detector.h"
 
@@ -49,6 +52,18 @@ int wm_vuldet_check_specific_package(sqlite3 *dbCVE,
                                      int *vuln_count);
 int wm_vuldet_get_children(sqlite3 * dbCVE, int configuration_id, int package_id, int *children);
 int wm_vuldet_get_siblings(sqlite3 * dbCVE, int parent, int configuration_id, int *siblings);
+int wm_vuldet_get_vuln_nvd_cpe(sqlite3 *db,
+                               scan_agent *agent,
+                               wm_vuldet_flags *flags,
+                               cpe *agent_cpe,
+                               char *raw_product,
+                               char *raw_version,
+                               char *raw_arch,
+                               char *raw_reference,
+                               char *raw_type,
+                               vu_nvd_report **nvd_report_list);
+int wm_vuldet_download_nvd_year(update_node *update, int year, const char *stored_timestamp, const char *metadata_path, const char *feed_path);
+int wm_vuldet_take_nvd_prefetch(int year);
 
 /* setup */
 
@@ -7413,8 +7428,293 @@ void test_wm_vuldet_linux_nvd_vulnerabilities_app_pkg_mac_with_vendor(void **sta
 
 /* Tests */
 
+/* Tests wm_vuldet_json_nvd_parser */
+
+#define NVD_FEED_HEAD "{\r\n  \"CVE_data_type\" : \"CVE\",\r\n  \"CVE_Items\" : [ {\r\n    \"cve\" : {\r\n      \"CVE_data_meta\" : {\r\n"
+#define NVD_FEED_TAIL "        \"ID\" : \"CVE-2021-0001\"\r\n      }\r\n    },\r\n    \"publishedDate\" : \"2021-01-01T00:00Z\"\r\n  } ]\r\n}\r\n"
+
+void test_wm_vuldet_json_nvd_parser_split_cve(void **state)
+{
+    FILE *fp = (FILE *)1;
+    wm_vuldet_db parsed_vulnerabilities = {0};
+
+    test_mode = 1;
+
+    // The CVE is split between two reads
+    expect_fread(NVD_FEED_HEAD, strlen(NVD_FEED_HEAD));
+    expect_fread(NVD_FEED_TAIL, strlen(NVD_FEED_TAIL));
+    expect_fread("", 0);
+    will_return(__wrap_ferror, 0);
+
+    int ret = wm_vuldet_json_nvd_parser(fp, &parsed_vulnerabilities);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, 0);
+    assert_non_null(parsed_vulnerabilities.nvd_vulnerabilities);
+    assert_string_equal(parsed_vulnerabilities.nvd_vulnerabilities->id, "CVE-2021-0001");
+    assert_string_equal(parsed_vulnerabilities.nvd_vulnerabilities->published, "2021-01-01T00:00Z");
+    assert_null(parsed_vulnerabilities.nvd_vulnerabilities->next);
+
+    wm_vuldet_free_nvd_list(parsed_vulnerabilities.nvd_vulnerabilities);
+}
+
+void test_wm_vuldet_json_nvd_parser_truncated_cve(void **state)
+{
+    FILE *fp = (FILE *)1;
+    wm_vuldet_db parsed_vulnerabilities = {0};
+
+    test_mode = 1;
+
+    expect_fread(NVD_FEED_HEAD, strlen(NVD_FEED_HEAD));
+    expect_fread("", 0);
+    will_return(__wrap_ferror, 0);
+
+    int ret = wm_vuldet_json_nvd_parser(fp, &parsed_vulnerabilities);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, OS_INVALID);
+    assert_null(parsed_vulnerabilities.nvd_vulnerabilities);
+}
+
+void test_wm_vuldet_json_nvd_parser_read_error(void **state)
+{
+    FILE *fp = (FILE *)1;
+    wm_vuldet_db parsed_vulnerabilities = {0};
+
+    test_mode = 1;
+
+    expect_fread("", 0);
+    will_return(__wrap_ferror, 1);
+
+    int ret = wm_vuldet_json_nvd_parser(fp, &parsed_vulnerabilities);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, OS_INVALID);
+    assert_null(parsed_vulnerabilities.nvd_vulnerabilities);
+}
+
+void test_wm_vuldet_index_nvd_delta_hash_error(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    int cve_count = 0;
+
+    test_mode = 1;
+
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, NULL);
+
+    expect_string(__wrap__merror, formatted_msg, "(1290): Unable to create a new list (calloc).");
+
+    int ret = wm_vuldet_index_nvd_delta(db, 2021, NULL, &cve_count);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, OS_INVALID);
+    assert_int_equal(cve_count, 0);
+}
+
+void test_wm_vuldet_index_nvd_delta_prepare_error(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    int cve_count = 0;
+    nvd_vulnerability *nvd_it = NULL;
+
+    os_calloc(1, sizeof(nvd_vulnerability), nvd_it);
+    os_strdup("CVE-2021-0001", nvd_it->id);
+
+    test_mode = 1;
+
+    // The function frees the table
+    expect_function_call(__wrap_OSHash_Create);
+    will_return(__wrap_OSHash_Create, __real_OSHash_Create());
+    expect_function_call(__wrap_OSHash_SetFreeDataPointer);
+    will_return(__wrap_OSHash_SetFreeDataPointer, 1);
+
+    will_return(__wrap_sqlite3_prepare_v2, NULL);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "error");
+    expect_string(__wrap__mterror, tag, "wazuh-modulesd:vulnerability-detector");
+    expect_string(__wrap__mterror, formatted_msg, "(5503): SQL error: 'error'");
+
+    int ret = wm_vuldet_index_nvd_delta(db, 2021, nvd_it, &cve_count);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, OS_INVALID);
+    assert_int_equal(cve_count, 0);
+}
+
+void test_wm_vuldet_get_vuln_nvd_cpe_prepare_error(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    scan_agent agent = { .dist_ver = FEED_W10 };
+    wm_vuldet_flags flags = { 0 };
+    cpe agent_cpe = { .part = "a", .vendor = "vendor", .product = "product", .version = "1.0" };
+    vu_nvd_report *nvd_report_list = NULL;
+
+    will_return(__wrap_sqlite3_prepare_v2, NULL);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_ERROR);
+    will_return(__wrap_sqlite3_errmsg, "error");
+    expect_string(__wrap__mterror, tag, "wazuh-modulesd:vulnerability-detector");
+    expect_string(__wrap__mterror, formatted_msg, "(5503): SQL error: 'error'");
+
+    int ret = wm_vuldet_get_vuln_nvd_cpe(db, &agent, &flags, &agent_cpe, "product", "1.0", "x86_64", NULL, "program", &nvd_report_list);
+
+    assert_int_equal(ret, OS_INVALID);
+    assert_null(nvd_report_list);
+}
+
+void test_wm_vuldet_get_vuln_nvd_cpe_not_vulnerable(void **state)
+{
+    sqlite3 *db = (sqlite3 *)1;
+    scan_agent agent = { .dist_ver = FEED_W10 };
+    wm_vuldet_flags flags = { 0 };
+    cpe agent_cpe = { .part = "a", .vendor = "vendor", .product = "product", .version = "1.0" };
+    vu_nvd_report *nvd_report_list = NULL;
+
+    will_return(__wrap_sqlite3_prepare_v2, 1);
+    will_return(__wrap_sqlite3_prepare_v2, SQLITE_OK);
+    expect_sqlite3_bind_text_call(1, "a", 0);
+    expect_sqlite3_bind_text_call(2, "vendor", 0);
+    expect_sqlite3_bind_text_call(3, "product", 0);
+    expect_sqlite3_bind_text_call(4, "1.0", 0);
+    expect_sqlite3_bind_text_call(5, "", 0);
+    expect_sqlite3_bind_text_call(6, "", 0);
+    expect_sqlite3_bind_text_call(7, "", 0);
+    expect_sqlite3_bind_text_call(8, "", 0);
+    expect_sqlite3_bind_text_call(9, "", 0);
+
+    // The match is not vulnerable, so its URI is not decoded
+    expect_sqlite3_step_call(SQLITE_ROW);
+    expect_value(__wrap_sqlite3_column_int, iCol, 0);
+    will_return(__wrap_sqlite3_column_int, 10);
+    expect_value(__wrap_sqlite3_column_text, iCol, 1);
+    will_return(__wrap_sqlite3_column_text, "1.0");
+    expect_value(__wrap_sqlite3_column_int, iCol, 2);
+    will_return(__wrap_sqlite3_column_int, 20);
+    expect_value(__wrap_sqlite3_column_text, iCol, 3);
+    will_return(__wrap_sqlite3_column_text, "cpe:2.3:a:vendor:product:1.0:*:*:*:*:*:*:*");
+    expect_value(__wrap_sqlite3_column_int, iCol, 4);
+    will_return(__wrap_sqlite3_column_int, 0);
+
+    expect_sqlite3_step_call(SQLITE_DONE);
+    will_return(__wrap_sqlite3_finalize, SQLITE_OK);
+
+    int ret = wm_vuldet_get_vuln_nvd_cpe(db, &agent, &flags, &agent_cpe, "product", "1.0", "x86_64", NULL, "program", &nvd_report_list);
+
+    assert_int_equal(ret, 0);
+    assert_null(nvd_report_list);
+}
+
+void test_wm_vuldet_download_nvd_year_metadata_error(void **state)
+{
+    update_node update = { .timeout = 300, .dist_ext = "NVD" };
+
+    test_mode = 1;
+
+    for (int attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
+        char msg[OS_SIZE_1024];
+
+        expect_string(__wrap_wurl_request, url, "https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.meta");
+        expect_string(__wrap_wurl_request, dest, VU_NVD_PREFETCH_METADATA_FILE);
+        expect_value(__wrap_wurl_request, timeout, 300);
+        will_return(__wrap_wurl_request, OS_CONNERR);
+
+        snprintf(msg, OS_SIZE_1024, "(5522): There was no valid response to 'https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.meta' after '%d' attempts.", attempt * DOWNLOAD_SLEEP_FACTOR);
+        expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:vulnerability-detector");
+        expect_string(__wrap__mtdebug1, formatted_msg, msg);
+        expect_value(__wrap_sleep, seconds, attempt * DOWNLOAD_SLEEP_FACTOR);
+    }
+
+    expect_string(__wrap__mtwarn, tag, "wazuh-modulesd:vulnerability-detector");
+    expect_string(__wrap__mtwarn, formatted_msg, "(5522): There was no valid response to 'https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.meta' after '3' attempts.");
+
+    int ret = wm_vuldet_download_nvd_year(&update, 2021, NULL, VU_NVD_PREFETCH_METADATA_FILE, VU_NVD_PREFETCH_FILE);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, VU_INV_FEED);
+}
+
+void test_wm_vuldet_download_nvd_year_not_updated(void **state)
+{
+    update_node update = { .timeout = 300, .dist_ext = "NVD" };
+
+    test_mode = 1;
+
+    expect_string(__wrap_wurl_request, url, "https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.meta");
+    expect_string(__wrap_wurl_request, dest, VU_TEMP_METADATA_FILE);
+    expect_value(__wrap_wurl_request, timeout, 300);
+    will_return(__wrap_wurl_request, 0);
+
+    expect_fopen(VU_TEMP_METADATA_FILE, "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, "lastModifiedDate:2021-01-01T03:00:00-05:00\r\n");
+    expect_fclose((FILE *)1, 0);
+
+    // The metadata of a year that doesn't change is not kept
+    expect_string(__wrap_remove, filename, VU_TEMP_METADATA_FILE);
+    will_return(__wrap_remove, 0);
+
+    int ret = wm_vuldet_download_nvd_year(&update, 2021, "2021-01-01T03:00:00-05:00", VU_TEMP_METADATA_FILE, VU_FIT_TEMP_FILE);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, VU_NOT_NEED_UPDATE);
+}
+
+void test_wm_vuldet_download_nvd_year_outdated(void **state)
+{
+    update_node update = { .timeout = 300, .dist_ext = "NVD" };
+
+    test_mode = 1;
+
+    expect_string(__wrap_wurl_request, url, "https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.meta");
+    expect_string(__wrap_wurl_request, dest, VU_TEMP_METADATA_FILE);
+    expect_value(__wrap_wurl_request, timeout, 300);
+    will_return(__wrap_wurl_request, 0);
+
+    expect_fopen(VU_TEMP_METADATA_FILE, "r", (FILE *)1);
+    expect_value(__wrap_fgets, __stream, (FILE *)1);
+    will_return(__wrap_fgets, "lastModifiedDate:2021-02-01T03:00:00-05:00\r\n");
+
+    expect_string(__wrap__mtdebug1, tag, "wazuh-modulesd:vulnerability-detector");
+    expect_string(__wrap__mtdebug1, formatted_msg, "(5407): The feed 'NVD (2021)' is outdated. Fetching the last version.");
+    expect_fclose((FILE *)1, 0);
+
+    expect_string(__wrap_wurl_request_uncompress_bz2_gz, url, "https://nvd.nist.gov/feeds/json/cve/1.1/nvdcve-1.1-2021.json.gz");
+    expect_string(__wrap_wurl_request_uncompress_bz2_gz, dest, VU_FIT_TEMP_FILE);
+    expect_value(__wrap_wurl_request_uncompress_bz2_gz, timeout, 300);
+    will_return(__wrap_wurl_request_uncompress_bz2_gz, 0);
+
+    int ret = wm_vuldet_download_nvd_year(&update, 2021, "2021-01-01T03:00:00-05:00", VU_TEMP_METADATA_FILE, VU_FIT_TEMP_FILE);
+
+    test_mode = 0;
+
+    assert_int_equal(ret, 0);
+}
+
+void test_wm_vuldet_take_nvd_prefetch_not_running(void **state)
+{
+    // Nothing was prefetched, the year is downloaded in the foreground
+    assert_int_equal(wm_vuldet_take_nvd_prefetch(2021), OS_INVALID);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
+        // Tests wm_vuldet_get_vuln_nvd_cpe
+        cmocka_unit_test(test_wm_vuldet_get_vuln_nvd_cpe_prepare_error),
+        cmocka_unit_test(test_wm_vuldet_get_vuln_nvd_cpe_not_vulnerable),
+        // Tests wm_vuldet_index_nvd_delta
+        cmocka_unit_test(test_wm_vuldet_index_nvd_delta_hash_error),
+        cmocka_unit_test(test_wm_vuldet_index_nvd_delta_prepare_error),
+        // Tests wm_vuldet_json_nvd_parser
+        cmocka_unit_test(test_wm_vuldet_json_nvd_parser_split_cve),
+        cmocka_unit_test(test_wm_vuldet_json_nvd_parser_truncated_cve),
+        cmocka_unit_test(test_wm_vuldet_json_nvd_parser_read_error),
         //Tests wm_vuldet_clean_version
         cmocka_unit_test_setup_teardown(test_wm_vuldet_clean_version_complete, setup_version, teardown_version),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_clean_version_no_epoch, setup_version, teardown_version),
@@ -7522,6 +7822,12 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_wm_vuldet_linux_nvd_vulnerabilities_os_pkg_mac, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_linux_nvd_vulnerabilities_app_pkg_mac_no_vendor, setup_scan_agent, teardown_scan_agent),
         cmocka_unit_test_setup_teardown(test_wm_vuldet_linux_nvd_vulnerabilities_app_pkg_mac_with_vendor, setup_scan_agent, teardown_scan_agent),
+        // Tests wm_vuldet_download_nvd_year
+        cmocka_unit_test(test_wm_vuldet_download_nvd_year_metadata_error),
+        cmocka_unit_test(test_wm_vuldet_download_nvd_year_not_updated),
+        cmocka_unit_test(test_wm_vuldet_download_nvd_year_outdated),
+        // Tests wm_vuldet_take_nvd_prefetch
+        cmocka_unit_test(test_wm_vuldet_take_nvd_prefetch_not_running),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -219,6 +219,34 @@ int __wrap_sqlite3_get_autocommit(__attribute__((unused)) sqlite3 * db) {
     return mock();
 }
 
+int __wrap_sqlite3_total_changes(__attribute__((unused)) sqlite3 * db) {
+    return mock();
+}
+
 const char*  __wrap_sqlite3_sql(__attribute__((unused)) sqlite3_stmt *pStmt){
     return mock_ptr_type(char*);
 }
+
+sqlite3_backup * __wrap_sqlite3_backup_init(__attribute__((unused)) sqlite3 *pDest,
+                                            __attribute__((unused)) const char *zDestName,
+                                            __attribute__((unused)) sqlite3 *pSource,
+                                            __attribute__((unused)) const char *zSourceName) {
+    return mock_ptr_type(sqlite3_backup *);
+}
+
+int __wrap_sqlite3_backup_step(__attribute__((unused)) sqlite3_backup *p, int nPage) {
+    check_expected(nPage);
+    return mock();
+}
+
+int __wrap_sqlite3_backup_finish(__attribute__((unused)) sqlite3_backup *p) {
+    return mock();
+}
+
+int __wrap_sqlite3_backup_pagecount(__attribute__((unused)) sqlite3_backup *p) {
+    return mock();
+}
+
+int __wrap_sqlite3_sleep(__attribute__((unused)) int ms) {
+    return 0;
+}
@@ -102,6 +102,18 @@ const char* __wrap_sqlite3_column_name(sqlite3_stmt *pStmt, int N);
 
 int __wrap_sqlite3_get_autocommit(__attribute__((unused)) sqlite3 * db);
 
+int __wrap_sqlite3_total_changes(__attribute__((unused)) sqlite3 * db);
+
 const char* __wrap_sqlite3_sql(sqlite3_stmt *pStmt);
 
+sqlite3_backup * __wrap_sqlite3_backup_init(sqlite3 *pDest, const char *zDestName, sqlite3 *pSource, const char *zSourceName);
+
+int __wrap_sqlite3_backup_step(sqlite3_backup *p, int nPage);
+
+int __wrap_sqlite3_backup_finish(sqlite3_backup *p);
+
+int __wrap_sqlite3_backup_pagecount(sqlite3_backup *p);
+
+int __wrap_sqlite3_sleep(int ms);
+
 #endif
@@ -140,6 +140,14 @@ void expect_fread(char *file, size_t ret) {
     will_return(__wrap_fread, ret);
 }
 
+extern int __real_ferror(FILE *stream);
+int __wrap_ferror(FILE *stream) {
+    if (test_mode) {
+        return mock();
+    }
+    return __real_ferror(stream);
+}
+
 long int __wrap_ftell(__attribute__ ((__unused__)) FILE *stream) {
     return mock();
 }
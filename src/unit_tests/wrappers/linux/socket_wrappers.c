@@ -82,6 +82,14 @@ ssize_t __wrap_recv(__attribute__((unused))int __fd, __attribute__((unused))void
         strcpy(text, "err --------");
         void *buffertext = &text;
         memcpy((char*)__buf+8, (char*)buffertext, 12);
+    } else if(__fd == 8) {
+        const char *data = mock_type(const char *);
+        ssize_t length = mock();
+        if (length > 0) {
+            assert_true((size_t)length <= __n);
+            memcpy(__buf, data, length);
+        }
+        return length;
     }
 
     return mock();
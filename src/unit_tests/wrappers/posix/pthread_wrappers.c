@@ -57,3 +57,22 @@ int __wrap_pthread_cond_signal(pthread_cond_t *cond) {
     check_expected_ptr(cond);
     return 0;
 }
+
+int __wrap_pthread_create(__attribute__((unused)) pthread_t *thread,
+                          __attribute__((unused)) const pthread_attr_t *attr,
+                          void *(*start_routine)(void *),
+                          void *arg) {
+    int ret = mock();
+
+    // The started thread runs to completion before returning, so tests stay deterministic
+    if (ret == 0) {
+        start_routine(arg);
+    }
+
+    return ret;
+}
+
+int __wrap_pthread_join(__attribute__((unused)) pthread_t thread, __attribute__((unused)) void **retval) {
+    function_called();
+    return 0;
+}
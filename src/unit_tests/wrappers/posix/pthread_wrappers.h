@@ -29,6 +29,10 @@ int __wrap_pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
 
 int __wrap_pthread_cond_signal(pthread_cond_t *cond);
 
+int __wrap_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *), void *arg);
+
+int __wrap_pthread_join(pthread_t thread, void **retval);
+
 extern void (*pthread_callback_ptr)(void);
 
 #endif
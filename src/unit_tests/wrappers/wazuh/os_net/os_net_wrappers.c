@@ -49,6 +49,14 @@ int __wrap_OS_SendUDPbySize(int sock, int size, const char *msg) {
     return mock();
 }
 
+int __wrap_OS_SendTCPbySize(int sock, int size, const char *msg) {
+    check_expected(sock);
+    check_expected(size);
+    check_expected(msg);
+
+    return mock();
+}
+
 int __wrap_OS_SendSecureTCP(int sock, uint32_t size, const void * msg) {
     check_expected(sock);
     check_expected(size);
@@ -57,6 +65,14 @@ int __wrap_OS_SendSecureTCP(int sock, uint32_t size, const void * msg) {
     return mock();
 }
 
+int __wrap_OS_SendSecureTCPFrames(int sock, size_t size, const void * frames) {
+    check_expected(sock);
+    check_expected(size);
+    check_expected(frames);
+
+    return mock();
+}
+
 int __wrap_OS_SendUnix(int socket, const char *msg, int size) {
     check_expected(socket);
     check_expected(msg);
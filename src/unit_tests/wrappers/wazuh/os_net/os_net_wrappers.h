@@ -28,8 +28,12 @@ int __wrap_OS_ConnectUnixDomain(const char *path, int type, int max_msg_size);
 
 int __wrap_OS_SendUDPbySize(int sock, int size, const char *msg);
 
+int __wrap_OS_SendTCPbySize(int sock, int size, const char *msg);
+
 int __wrap_OS_SendSecureTCP(int sock, uint32_t size, const void * msg);
 
+int __wrap_OS_SendSecureTCPFrames(int sock, size_t size, const void * frames);
+
 int __wrap_OS_SendUnix(int socket, const char *msg, int size);
 
 void expect_OS_SendUnix_call(int socket, const char *msg, int size, int ret);
@@ -46,6 +50,8 @@ int __wrap_OS_ConnectUDP(u_int16_t _port, const char *_ip, int ipv6);
 
 int __wrap_OS_SetRecvTimeout(int socket, long seconds, long useconds);
 
+int __wrap_OS_CloseSocket(int sock);
+
 int __wrap_OS_SetSendTimeout(int socket, int seconds);
 
 int __wrap_wnet_select(int sock, int timeout);
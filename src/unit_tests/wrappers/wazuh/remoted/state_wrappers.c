@@ -53,6 +53,10 @@ void __wrap_rem_inc_recv_unknown() {
     return;
 }
 
+void __wrap_rem_inc_recv_evt(const char *agent_id) {
+    check_expected(agent_id);
+}
+
 void __wrap_rem_add_send(unsigned long bytes) {
     check_expected(bytes);
 }
@@ -32,6 +32,8 @@ void __wrap_rem_inc_recv_ctrl(const char *agent_id);
 
 void __wrap_rem_inc_recv_unknown();
 
+void __wrap_rem_inc_recv_evt(const char *agent_id);
+
 void __wrap_rem_add_send(unsigned long bytes);
 
 void __wrap_rem_inc_send_ack(const char *agent_id);
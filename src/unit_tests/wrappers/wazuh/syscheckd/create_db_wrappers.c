@@ -32,6 +32,10 @@ void __wrap_fim_realtime_event(char *file) {
     check_expected(file);
 }
 
+void __wrap_fim_realtime_rescan(const char *dir) {
+    check_expected(dir);
+}
+
 int __wrap_fim_registry_event(__attribute__((unused)) char *key,
                               __attribute__((unused)) fim_file_data *data,
                               __attribute__((unused)) int pos) {
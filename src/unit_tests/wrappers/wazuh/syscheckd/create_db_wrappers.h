@@ -21,6 +21,8 @@ cJSON *__wrap_fim_json_event();
 
 void __wrap_fim_realtime_event(char *file);
 
+void __wrap_fim_realtime_rescan(const char *dir);
+
 int __wrap_fim_registry_event(char *key, fim_file_data *data, int pos);
 
 int __wrap_fim_whodata_event(whodata_evt * w_evt);
@@ -25,6 +25,42 @@ int __wrap_fim_db_get_count_registry_key(){
     return mock();
 }
 
+FIMDBErrorCode __wrap_fim_db_get_registry_key(const char *path, int arch, callback_context_t callback) {
+    fim_entry *stored;
+
+    check_expected(path);
+    check_expected(arch);
+
+    stored = mock_type(fim_entry *);
+    if (stored != NULL) {
+        callback.callback(stored, callback.context);
+    }
+
+    return mock();
+}
+
+void expect_fim_db_get_registry_key(const char *path, int arch, fim_entry *stored, int ret_val) {
+    expect_string(__wrap_fim_db_get_registry_key, path, path);
+    expect_value(__wrap_fim_db_get_registry_key, arch, arch);
+    will_return(__wrap_fim_db_get_registry_key, stored);
+    will_return(__wrap_fim_db_get_registry_key, ret_val);
+}
+
+FIMDBErrorCode __wrap_fim_db_get_registry_key_values(const char *path,
+                                                     int arch,
+                                                     __attribute__((unused)) callback_context_t callback) {
+    check_expected(path);
+    check_expected(arch);
+
+    return mock();
+}
+
+void expect_fim_db_get_registry_key_values(const char *path, int arch, int ret_val) {
+    expect_string(__wrap_fim_db_get_registry_key_values, path, path);
+    expect_value(__wrap_fim_db_get_registry_key_values, arch, arch);
+    will_return(__wrap_fim_db_get_registry_key_values, ret_val);
+}
+
 FIMDBErrorCode __wrap_fim_db_get_path(const char* file_path,
                                      __attribute__((unused))callback_context_t callback) {
     check_expected(file_path);
@@ -47,7 +83,8 @@ FIMDBErrorCode __wrap_fim_db_init(int storage,
                                   int value_limit,
                                   int sync_registry_enable,
                                   int sync_thread_pool,
-                                  int sync_queue_size) {
+                                  int sync_queue_size,
+                                  unsigned int memory_limit) {
     check_expected(storage);
     check_expected(sync_interval);
     check_expected(sync_max_interval);
@@ -57,6 +94,7 @@ FIMDBErrorCode __wrap_fim_db_init(int storage,
     check_expected(sync_registry_enable);
     check_expected(sync_thread_pool);
     check_expected(sync_queue_size);
+    check_expected(memory_limit);
 
     return mock_type(int);
 }
@@ -69,7 +107,8 @@ void expect_wrapper_fim_db_init(int storage,
                                 int value_limit,
                                 int sync_registry_enable,
                                 int sync_thread_pool,
-                                int sync_queue_size) {
+                                int sync_queue_size,
+                                unsigned int memory_limit) {
     expect_value(__wrap_fim_db_init, storage, storage);
     expect_value(__wrap_fim_db_init, sync_interval, sync_interval);
     expect_value(__wrap_fim_db_init, file_limit, file_limit);
@@ -79,6 +118,7 @@ void expect_wrapper_fim_db_init(int storage,
     expect_value(__wrap_fim_db_init, sync_registry_enable, sync_registry_enable);
     expect_value(__wrap_fim_db_init, sync_thread_pool, sync_thread_pool);
     expect_value(__wrap_fim_db_init, sync_queue_size, sync_queue_size);
+    expect_value(__wrap_fim_db_init, memory_limit, memory_limit);
 
     will_return(__wrap_fim_db_init, FIMDB_OK);
 }
@@ -131,6 +171,18 @@ void expect_fim_db_file_pattern_search(const char* pattern, int ret_val) {
     will_return(__wrap_fim_db_file_pattern_search, ret_val);
 }
 
+FIMDBErrorCode __wrap_fim_db_file_prefix_search(const char* prefix,
+                                     __attribute__((unused)) callback_context_t callback) {
+    check_expected(prefix);
+
+    return mock();
+}
+
+void expect_fim_db_file_prefix_search(const char* prefix, int ret_val) {
+    expect_string(__wrap_fim_db_file_prefix_search, prefix, prefix);
+    will_return(__wrap_fim_db_file_prefix_search, ret_val);
+}
+
 FIMDBErrorCode __wrap_fim_db_file_inode_search(const unsigned long inode,
                                     const unsigned long dev,
                                     __attribute__((unused)) callback_context_t callback) {
@@ -151,6 +203,14 @@ int __wrap_fim_db_get_count_file_inode() {
     return mock();
 }
 
+unsigned long long __wrap_fim_db_get_memory_usage() {
+    return mock_type(unsigned long long);
+}
+
+unsigned long long __wrap_fim_db_get_storage_size() {
+    return mock_type(unsigned long long);
+}
+
 void __wrap_fim_run_integrity() {
     function_called();
 }
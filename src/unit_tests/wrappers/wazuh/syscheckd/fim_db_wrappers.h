@@ -30,6 +30,12 @@ int __wrap_fim_db_get_count_registry_data();
 
 int __wrap_fim_db_get_count_registry_key();
 
+FIMDBErrorCode __wrap_fim_db_get_registry_key(const char *path, int arch, callback_context_t callback);
+void expect_fim_db_get_registry_key(const char *path, int arch, fim_entry *stored, int ret_val);
+
+FIMDBErrorCode __wrap_fim_db_get_registry_key_values(const char *path, int arch, callback_context_t callback);
+void expect_fim_db_get_registry_key_values(const char *path, int arch, int ret_val);
+
 int __wrap_fim_db_get_count_range(fdb_t *fim_sql,
                                   fim_type type,
                                   char *start,
@@ -49,7 +55,8 @@ FIMDBErrorCode __wrap_fim_db_init(int storage,
                                   int value_limit,
                                   int sync_registry_enable,
                                   int sync_thread_pool,
-                                  int sync_queue_size);
+                                  int sync_queue_size,
+                                  unsigned int memory_limit);
 
 void expect_wrapper_fim_db_init(int storage,
                                 int sync_interval,
@@ -59,7 +66,8 @@ void expect_wrapper_fim_db_init(int storage,
                                 int value_limit,
                                 int sync_registry_enable,
                                 int sync_thread_pool,
-                                int sync_queue_size);
+                                int sync_queue_size,
+                                unsigned int memory_limit);
 
 FIMDBErrorCode __wrap_fim_db_remove_path(const char *path);
 
@@ -84,6 +92,11 @@ FIMDBErrorCode __wrap_fim_db_file_pattern_search(const char* pattern,
 
 void expect_fim_db_file_pattern_search(const char* pattern, int ret_val);
 
+FIMDBErrorCode __wrap_fim_db_file_prefix_search(const char* prefix,
+                                     __attribute__((unused)) callback_context_t callback);
+
+void expect_fim_db_file_prefix_search(const char* prefix, int ret_val);
+
 FIMDBErrorCode __wrap_fim_db_file_inode_search(const unsigned long inode,
                                     const unsigned long dev,
                                     __attribute__((unused)) callback_context_t callback);
@@ -93,6 +106,10 @@ void expect_fim_db_file_inode_search(const unsigned long inode,
 
 int __wrap_fim_db_get_count_file_inode();
 
+unsigned long long __wrap_fim_db_get_memory_usage();
+
+unsigned long long __wrap_fim_db_get_storage_size();
+
 void __wrap_fim_run_integrity();
 
 void __wrap_is_fim_shutdown();
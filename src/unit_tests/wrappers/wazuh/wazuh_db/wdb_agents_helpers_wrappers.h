@@ -32,6 +32,28 @@ cJSON* __wrap_wdb_insert_vuln_cves(int id,
                                    bool check_pkg_existence,
                                    __attribute__((unused)) int *sock);
 
+int __wrap_wdb_append_vuln_cves(__attribute__((unused)) cJSON **batch,
+                                const char *name,
+                                const char *version,
+                                const char *architecture,
+                                const char *cve,
+                                const char *severity,
+                                double cvss2_score,
+                                double cvss3_score,
+                                const char *reference,
+                                const char *type,
+                                const char *status,
+                                char **external_references,
+                                const char *condition,
+                                const char *title,
+                                const char *published,
+                                const char *updated,
+                                bool check_pkg_existence);
+
+cJSON* __wrap_wdb_insert_vuln_cves_batch(int id,
+                                         __attribute__((unused)) cJSON **batch,
+                                         __attribute__((unused)) int *sock);
+
 cJSON* __wrap_wdb_remove_vuln_cves_by_status(int id,
                                              const char *status,
                                              __attribute__((unused)) int *sock);
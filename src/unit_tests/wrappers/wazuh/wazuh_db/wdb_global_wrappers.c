@@ -282,6 +282,26 @@ cJSON* __wrap_wdb_global_get_agents_by_connection_status (__attribute__((unused)
     return mock_ptr_type(cJSON*);
 }
 
+cJSON* __wrap_wdb_global_get_agents_info_by_connection_status(__attribute__((unused)) wdb_t *wdb,
+                                                              int last_agent_id,
+                                                              const char* connection_status,
+                                                              wdbc_result* status) {
+    check_expected(last_agent_id);
+    check_expected(connection_status);
+    *status = mock();
+    return mock_ptr_type(cJSON*);
+}
+
+cJSON* __wrap_wdb_global_get_changes(__attribute__((unused)) wdb_t *wdb,
+                                     int64_t last_seq,
+                                     int limit,
+                                     wdbc_result* status) {
+    check_expected(last_seq);
+    check_expected(limit);
+    *status = mock();
+    return mock_ptr_type(cJSON*);
+}
+
 wdbc_result __wrap_wdb_global_sync_agent_groups_get(__attribute__((unused)) wdb_t *wdb,
                                                     wdb_groups_sync_condition_t condition,
                                                     int last_agent_id,
@@ -176,6 +176,22 @@ void __wrap_w_inc_global_agent_get_agents_by_connection_status_time(__attribute_
     function_called();
 }
 
+void __wrap_w_inc_global_agent_get_changes() {
+    function_called();
+}
+
+void __wrap_w_inc_global_agent_get_changes_time(__attribute__((unused))struct timeval diff) {
+    function_called();
+}
+
+void __wrap_w_inc_global_agent_get_agents_info_by_connection_status() {
+    function_called();
+}
+
+void __wrap_w_inc_global_agent_get_agents_info_by_connection_status_time(__attribute__((unused))struct timeval diff) {
+    function_called();
+}
+
 void __wrap_w_inc_global_agent_disconnect_agents() {
     function_called();
 }
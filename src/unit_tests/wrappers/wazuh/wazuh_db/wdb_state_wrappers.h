@@ -98,6 +98,14 @@ void __wrap_w_inc_global_agent_get_agents_by_connection_status();
 
 void __wrap_w_inc_global_agent_get_agents_by_connection_status_time(__attribute__((unused))struct timeval diff);
 
+void __wrap_w_inc_global_agent_get_changes();
+
+void __wrap_w_inc_global_agent_get_changes_time(__attribute__((unused))struct timeval diff);
+
+void __wrap_w_inc_global_agent_get_agents_info_by_connection_status();
+
+void __wrap_w_inc_global_agent_get_agents_info_by_connection_status_time(__attribute__((unused))struct timeval diff);
+
 void __wrap_w_inc_global_agent_disconnect_agents();
 
 void __wrap_w_inc_global_agent_disconnect_agents_time(__attribute__((unused))struct timeval diff);
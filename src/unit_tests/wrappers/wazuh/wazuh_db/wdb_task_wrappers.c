@@ -69,8 +69,9 @@ int __wrap_wdb_task_set_timeout_status(__attribute__((unused)) wdb_t* wdb, time_
     return mock();
 }
 
-int __wrap_wdb_task_delete_old_entries(__attribute__((unused)) wdb_t* wdb, int timestamp) {
+int __wrap_wdb_task_delete_old_entries(__attribute__((unused)) wdb_t* wdb, int timestamp, int limit) {
     check_expected(timestamp);
+    check_expected(limit);
 
     return mock();
 }
@@ -17,6 +17,10 @@ wdb_t* __wrap_wdb_open_global() {
     return mock_ptr_type(wdb_t*);
 }
 
+wdb_t* __wrap_wdb_open_global_reader() {
+    return mock_ptr_type(wdb_t*);
+}
+
 wdb_t* __wrap_wdb_open_agent2(int agent_id) {
     check_expected(agent_id);
     return mock_ptr_type(wdb_t*);
@@ -136,6 +140,18 @@ int __wrap_wdbc_query_ex(int *sock, const char *query, char *response, const int
     return mock();
 }
 
+int __wrap_wdbc_pipeline_send(__attribute__((unused)) int *sock, __attribute__((unused)) wdbc_pipeline *pipeline, const char *query) {
+    check_expected(query);
+
+    return mock();
+}
+
+int __wrap_wdbc_pipeline_recv(__attribute__((unused)) int *sock, __attribute__((unused)) wdbc_pipeline *pipeline, unsigned int keep) {
+    check_expected(keep);
+
+    return mock();
+}
+
 int __wrap_wdbi_query_checksum(__attribute__((unused)) wdb_t *wdb,
                                __attribute__((unused)) wdb_component_t component,
                                __attribute__((unused)) const char *command,
@@ -15,6 +15,8 @@
 
 wdb_t* __wrap_wdb_open_global();
 
+wdb_t* __wrap_wdb_open_global_reader();
+
 wdb_t* __wrap_wdb_open_agent2(int agent_id);
 
 int __wrap_wdb_begin2(wdb_t* aux);
@@ -53,6 +55,10 @@ int __wrap_wdbc_parse_result(char *result, char **payload);
 
 int __wrap_wdbc_query_ex(int *sock, const char *query, char *response, const int len);
 
+int __wrap_wdbc_pipeline_send(int *sock, wdbc_pipeline *pipeline, const char *query);
+
+int __wrap_wdbc_pipeline_recv(int *sock, wdbc_pipeline *pipeline, unsigned int keep);
+
 int __wrap_wdbi_query_checksum(wdb_t *wdb, wdb_component_t component, const char *command, const char *payload);
 
 int __wrap_wdbi_query_clear(wdb_t *wdb, wdb_component_t component, const char *payload);
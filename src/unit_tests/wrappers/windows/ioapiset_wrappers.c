@@ -0,0 +1,40 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include "ioapiset_wrappers.h"
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+HANDLE wrap_CreateIoCompletionPort(HANDLE FileHandle,
+                                   HANDLE ExistingCompletionPort,
+                                   __UNUSED_PARAM(ULONG_PTR CompletionKey),
+                                   DWORD NumberOfConcurrentThreads) {
+    check_expected(FileHandle);
+    check_expected(ExistingCompletionPort);
+    check_expected(NumberOfConcurrentThreads);
+    return mock_type(HANDLE);
+}
+
+WINBOOL wrap_GetQueuedCompletionStatus(__UNUSED_PARAM(HANDLE CompletionPort),
+                                       LPDWORD lpNumberOfBytesTransferred,
+                                       __UNUSED_PARAM(PULONG_PTR lpCompletionKey),
+                                       LPOVERLAPPED *lpOverlapped,
+                                       __UNUSED_PARAM(DWORD dwMilliseconds)) {
+    *lpNumberOfBytesTransferred = mock_type(DWORD);
+    *lpOverlapped = mock_type(LPOVERLAPPED);
+    return mock_type(WINBOOL);
+}
+
+void expect_GetQueuedCompletionStatus_call(DWORD bytes, LPOVERLAPPED overlap, WINBOOL ret) {
+    will_return(wrap_GetQueuedCompletionStatus, bytes);
+    will_return(wrap_GetQueuedCompletionStatus, overlap);
+    will_return(wrap_GetQueuedCompletionStatus, ret);
+}
@@ -0,0 +1,32 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+
+#ifndef IOAPISET_WRAPPERS_H
+#define IOAPISET_WRAPPERS_H
+
+#include <windows.h>
+
+#define CreateIoCompletionPort wrap_CreateIoCompletionPort
+#define GetQueuedCompletionStatus wrap_GetQueuedCompletionStatus
+
+HANDLE wrap_CreateIoCompletionPort(HANDLE FileHandle,
+                                   HANDLE ExistingCompletionPort,
+                                   ULONG_PTR CompletionKey,
+                                   DWORD NumberOfConcurrentThreads);
+
+WINBOOL wrap_GetQueuedCompletionStatus(HANDLE CompletionPort,
+                                       LPDWORD lpNumberOfBytesTransferred,
+                                       PULONG_PTR lpCompletionKey,
+                                       LPOVERLAPPED *lpOverlapped,
+                                       DWORD dwMilliseconds);
+
+void expect_GetQueuedCompletionStatus_call(DWORD bytes, LPOVERLAPPED overlap, WINBOOL ret);
+
+#endif
@@ -34,3 +34,8 @@ DWORD wrap_WaitForSingleObjectEx(HANDLE hHandle, DWORD dwMilliseconds, BOOL bAle
     check_expected(bAlertable);
     return mock_type(DWORD);
 }
+
+WINBOOL wrap_ResetEvent(HANDLE hEvent) {
+    check_expected(hEvent);
+    return mock();
+}
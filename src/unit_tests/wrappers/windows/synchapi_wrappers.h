@@ -18,6 +18,7 @@
 #define CreateEvent wrap_CreateEvent
 #undef WaitForSingleObjectEx
 #define WaitForSingleObjectEx wrap_WaitForSingleObjectEx
+#define ResetEvent wrap_ResetEvent
 
 VOID wrap_Sleep(DWORD dwMilliseconds);
 
@@ -28,4 +29,6 @@ HANDLE wrap_CreateEvent(LPSECURITY_ATTRIBUTES lpEventAttributes,
 
 DWORD wrap_WaitForSingleObjectEx(HANDLE hHandle, DWORD dwMilliseconds, BOOL bAlertable);
 
+WINBOOL wrap_ResetEvent(HANDLE hEvent);
+
 #endif
@@ -63,3 +63,29 @@ EVT_HANDLE wrap_EvtSubscribe(EVT_HANDLE             Session,
 BOOL wrap_EvtClose(__UNUSED_PARAM(EVT_HANDLE object)) {
     return mock_type(BOOL);
 }
+
+BOOL wrap_EvtNext(EVT_HANDLE  ResultSet,
+                  DWORD       EventsSize,
+                  PEVT_HANDLE Events,
+                  DWORD       Timeout,
+                  __UNUSED_PARAM(DWORD Flags),
+                  PDWORD      Returned) {
+    check_expected(ResultSet);
+    check_expected(EventsSize);
+    check_expected(Timeout);
+    EVT_HANDLE *output = mock_ptr_type(EVT_HANDLE *);
+    *Returned = mock_type(DWORD);
+    if (output && *Returned <= EventsSize) {
+        memcpy(Events, output, *Returned * sizeof(EVT_HANDLE));
+    }
+    return mock_type(BOOL);
+}
+
+void expect_EvtNext_call(EVT_HANDLE *events, DWORD count) {
+    expect_any(wrap_EvtNext, ResultSet);
+    expect_any(wrap_EvtNext, EventsSize);
+    expect_value(wrap_EvtNext, Timeout, INFINITE);
+    will_return(wrap_EvtNext, events);
+    will_return(wrap_EvtNext, count);
+    will_return(wrap_EvtNext, events != NULL);
+}
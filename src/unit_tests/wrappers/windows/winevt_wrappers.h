@@ -18,6 +18,7 @@
 #define EvtCreateRenderContext wrap_EvtCreateRenderContext
 #define EvtSubscribe wrap_EvtSubscribe
 #define EvtClose wrap_EvtClose
+#define EvtNext wrap_EvtNext
 
 
 BOOL wrap_EvtRender(EVT_HANDLE Context,
@@ -43,4 +44,19 @@ EVT_HANDLE wrap_EvtSubscribe(EVT_HANDLE             Session,
 
 BOOL wrap_EvtClose(EVT_HANDLE object);
 
+BOOL wrap_EvtNext(EVT_HANDLE  ResultSet,
+                  DWORD       EventsSize,
+                  PEVT_HANDLE Events,
+                  DWORD       Timeout,
+                  DWORD       Flags,
+                  PDWORD      Returned);
+
+/**
+ * @brief Expect a call to EvtNext returning a batch of events
+ *
+ * @param events Events returned, NULL to fail with no events.
+ * @param count Number of events.
+ */
+void expect_EvtNext_call(EVT_HANDLE *events, DWORD count);
+
 #endif
@@ -0,0 +1,508 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+/* Load generator: many virtual agents connected to a manager over TCP */
+
+#include "shared.h"
+#include "os_net/os_net.h"
+#include "sec.h"
+#include <poll.h>
+
+#undef ARGV0
+#define ARGV0 "agent-swarm"
+
+#define SWARM_MAX_THREADS   256
+#define SWARM_POLL_MS       10
+#define SWARM_RECONNECT     10
+
+/* Virtual agent, bound to an entry of the keystore */
+typedef struct {
+    unsigned int key;               ///< Index in the keystore
+    int sock;                       ///< Connection to the manager, -1 if disconnected
+    time_t next_connect;            ///< Next connection attempt
+    time_t next_keepalive;          ///< Next keepalive
+    uint64_t keepalive_sent;        ///< Time of the keepalive waiting for its ack (us), 0 if none
+    char merged_sum[33];            ///< Shared files hash reported in the keepalives
+} swarm_agent_t;
+
+/* Agents driven by one thread */
+typedef struct {
+    swarm_agent_t * agents;
+    unsigned int size;
+    double eps;                     ///< Events per second of the whole slice
+} swarm_slice_t;
+
+/* Counters of every thread, printed by the main thread */
+static struct {
+    _Atomic(unsigned long) connected;
+    _Atomic(unsigned long) connect_errors;
+    _Atomic(unsigned long) sent;
+    _Atomic(unsigned long) sent_bytes;
+    _Atomic(unsigned long) send_errors;
+    _Atomic(unsigned long) received;
+    _Atomic(unsigned long) acks;
+    _Atomic(unsigned long) rtt_total;
+    _Atomic(unsigned long) rtt_max;
+    _Atomic(unsigned long) events[3];
+} swarm_stats;
+
+static keystore keys = KEYSTORE_INITIALIZER;
+static const char * manager;
+static u_int16_t port = 1514;
+static int keepalive_interval = 10;
+static unsigned int mix[3] = { 80, 10, 10 };
+static volatile int running = 1;
+
+static const char * event_names[] = { "syslog", "fim", "syscollector" };
+
+/* Prototypes */
+static void helpmsg(void) __attribute__((noreturn));
+
+static void helpmsg()
+{
+    printf("\n%s %s: Simulate many agents sending events to a manager.\n", __ossec_name, ARGV0);
+    printf("Available options:\n");
+    printf("\t-h                This help message.\n");
+    printf("\t-m <manager>      Manager address (required).\n");
+    printf("\t-p <port>         Manager port (default: 1514).\n");
+    printf("\t-D <dir>          Directory with etc/client.keys and queue/rids (default: current directory).\n");
+    printf("\t-n <agents>       Number of agents, taken from the top of client.keys (default: all).\n");
+    printf("\t-t <threads>      Sending threads (default: 4).\n");
+    printf("\t-e <eps>          Events per second of each agent (default: 1).\n");
+    printf("\t-k <seconds>      Keepalive interval (default: 10).\n");
+    printf("\t-x <s,f,y>        Event mix as syslog,fim,syscollector weights (default: 80,10,10).\n");
+    printf("\t-d <seconds>      Duration, 0 means until interrupted (default: 0).\n");
+    printf("\t-r <seconds>      Report interval (default: 5).\n");
+    printf("\t-S                Print the remoted and analysisd statistics at the end.\n");
+    printf("\t                  Only when running on the manager host.\n\n");
+    printf("The keys must be registered in the manager with the IP 'any'. Set\n");
+    printf("remoted.verify_msg_id=0 in the manager to replay the same keys again.\n");
+    exit(1);
+}
+
+static void swarm_stop(__attribute__((unused)) int signum)
+{
+    running = 0;
+}
+
+static uint64_t swarm_now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Encrypt a message of an agent and send it */
+static int swarm_send(swarm_agent_t * agent, const char * msg)
+{
+    char crypt_msg[OS_MAXSTR + OS_SIZE_64];
+    size_t prefix;
+    size_t length;
+
+    /* The manager build of CreateSecMSG doesn't add the agent ID */
+    prefix = snprintf(crypt_msg, OS_SIZE_64, "!%s!", keys.keyentries[agent->key]->id);
+
+    if (length = CreateSecMSG(&keys, msg, strlen(msg), crypt_msg + prefix, agent->key), length == 0) {
+        return -1;
+    }
+
+    if (OS_SendSecureTCP(agent->sock, prefix + length, crypt_msg) < 0) {
+        swarm_stats.send_errors++;
+        close(agent->sock);
+        agent->sock = -1;
+        agent->next_connect = time(NULL) + SWARM_RECONNECT;
+        agent->keepalive_sent = 0;
+        swarm_stats.connected--;
+        return -1;
+    }
+
+    swarm_stats.sent++;
+    swarm_stats.sent_bytes += prefix + length;
+    return 0;
+}
+
+static void swarm_keepalive(swarm_agent_t * agent)
+{
+    char msg[OS_SIZE_2048];
+
+    snprintf(msg, sizeof(msg), "%sLinux |swarm-%s |5.15.0 |#1 SMP |x86_64 [Ubuntu|ubuntu: 22.04 (Jammy Jellyfish)] - %s %s\n%s merged.mg\n",
+             CONTROL_HEADER, keys.keyentries[agent->key]->name, __ossec_name, __ossec_version, agent->merged_sum);
+
+    if (swarm_send(agent, msg) == 0) {
+        agent->keepalive_sent = swarm_now();
+    }
+}
+
+static void swarm_connect(swarm_agent_t * agent, time_t now)
+{
+    char msg[OS_SIZE_256];
+
+    if (agent->sock = OS_ConnectTCP(port, manager, strchr(manager, ':') != NULL, 0), agent->sock < 0) {
+        swarm_stats.connect_errors++;
+        agent->sock = -1;
+        agent->next_connect = now + SWARM_RECONNECT;
+        return;
+    }
+
+    swarm_stats.connected++;
+
+    snprintf(msg, sizeof(msg), "%s%s{\"version\":\"%s\"}", CONTROL_HEADER, HC_STARTUP, __ossec_version);
+
+    if (swarm_send(agent, msg) == 0) {
+        agent->next_keepalive = now;
+    }
+}
+
+/* Send an event of the configured mix */
+static void swarm_event(swarm_agent_t * agent, unsigned long seq)
+{
+    char msg[OS_SIZE_2048];
+    unsigned int total = mix[0] + mix[1] + mix[2];
+    unsigned int pick = total ? seq % total : 0;
+    time_t now = time(NULL);
+    int type;
+
+    if (pick < mix[0]) {
+        type = 0;
+        snprintf(msg, sizeof(msg), "%c:/var/log/auth.log:Jan  1 00:00:00 swarm-%s sshd[%lu]: Failed password for invalid user swarm%lu from 10.%lu.%lu.%lu port 22 ssh2",
+                 LOCALFILE_MQ, keys.keyentries[agent->key]->name, seq % 32768, seq % 100,
+                 (seq >> 16) & 255, (seq >> 8) & 255, seq & 255);
+    } else if (pick < mix[0] + mix[1]) {
+        type = 1;
+        snprintf(msg, sizeof(msg), "%c:%s:{\"type\":\"event\",\"data\":{\"path\":\"/etc/swarm/file%lu\",\"version\":2.0,\"mode\":\"scheduled\",\"type\":\"modified\",\"timestamp\":%ld,"
+                 "\"attributes\":{\"type\":\"file\",\"size\":%lu,\"perm\":\"rw-r--r--\",\"uid\":\"0\",\"gid\":\"0\",\"user_name\":\"root\",\"group_name\":\"root\",\"inode\":%lu,\"mtime\":%ld,"
+                 "\"hash_md5\":\"d41d8cd98f00b204e9800998ecf8427e\",\"hash_sha1\":\"da39a3ee5e6b4b0d3255bfef95601890afd80709\","
+                 "\"hash_sha256\":\"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\",\"checksum\":\"da39a3ee5e6b4b0d3255bfef95601890afd80709\"},"
+                 "\"changed_attributes\":[\"size\"],\"old_attributes\":{\"type\":\"file\",\"size\":0}}}",
+                 SYSCHECK_MQ, SYSCHECK, seq % 1000, (long)now, seq, seq, (long)now);
+    } else {
+        type = 2;
+        snprintf(msg, sizeof(msg), "%c:%s:{\"type\":\"dbsync_processes\",\"operation\":\"MODIFIED\",\"data\":{\"pid\":\"%lu\",\"name\":\"swarm\",\"state\":\"S\",\"ppid\":1,"
+                 "\"utime\":%lu,\"stime\":0,\"cmd\":\"/usr/bin/swarm\",\"euser\":\"root\",\"ruser\":\"root\",\"suser\":\"root\",\"egroup\":\"root\","
+                 "\"rgroup\":\"root\",\"sgroup\":\"root\",\"fgroup\":\"root\",\"priority\":20,\"nice\":0,\"size\":1024,\"vm_size\":4096,\"resident\":512,"
+                 "\"share\":256,\"start_time\":%ld,\"pgrp\":1,\"session\":1,\"nlwp\":1,\"tgid\":1,\"tty\":0,\"processor\":0,\"scan_time\":\"2023/01/01 00:00:00\","
+                 "\"checksum\":\"%016lx\",\"item_id\":\"%016lx\"}}",
+                 DBSYNC_MQ, "syscollector", seq % 1000, seq, (long)now, seq, seq % 1000);
+    }
+
+    if (swarm_send(agent, msg) == 0) {
+        swarm_stats.events[type]++;
+    }
+}
+
+/* Read a message from the manager: acks and shared file updates */
+static void swarm_receive(swarm_agent_t * agent)
+{
+    char buffer[OS_MAXSTR + 1];
+    char cleartext[OS_MAXSTR + 1];
+    char * msg = NULL;
+    size_t length;
+    int recv_b;
+
+    if (recv_b = OS_RecvSecureTCP(agent->sock, buffer, OS_MAXSTR), recv_b <= 0) {
+        close(agent->sock);
+        agent->sock = -1;
+        agent->next_connect = time(NULL) + SWARM_RECONNECT;
+        agent->keepalive_sent = 0;
+        swarm_stats.connected--;
+        return;
+    }
+
+    buffer[recv_b] = '\0';
+    swarm_stats.received++;
+
+    if (ReadSecMSG(&keys, buffer, cleartext, agent->key, recv_b - 1, &length, manager, &msg) != KS_VALID || !msg) {
+        return;
+    }
+
+    if (strncmp(msg, CONTROL_HEADER HC_ACK, strlen(CONTROL_HEADER HC_ACK)) == 0) {
+        swarm_stats.acks++;
+
+        if (agent->keepalive_sent) {
+            unsigned long rtt = swarm_now() - agent->keepalive_sent;
+
+            swarm_stats.rtt_total += rtt;
+            if (rtt > swarm_stats.rtt_max) {
+                swarm_stats.rtt_max = rtt;
+            }
+            agent->keepalive_sent = 0;
+        }
+    } else if (strncmp(msg, CONTROL_HEADER FILE_UPDATE_HEADER, strlen(CONTROL_HEADER FILE_UPDATE_HEADER)) == 0) {
+        /* Report the new hash, so the manager doesn't push the files again */
+        sscanf(msg + strlen(CONTROL_HEADER FILE_UPDATE_HEADER), "%32s", agent->merged_sum);
+    }
+}
+
+static void * swarm_thread(void * args)
+{
+    swarm_slice_t * slice = args;
+    struct pollfd * fds;
+    unsigned int * polled;
+    uint64_t start = swarm_now();
+    unsigned long seq = 0;
+    unsigned int next = 0;
+    unsigned int i;
+    int nfds;
+
+    os_calloc(slice->size, sizeof(struct pollfd), fds);
+    os_calloc(slice->size, sizeof(unsigned int), polled);
+
+    while (running) {
+        time_t now = time(NULL);
+        unsigned long due = (unsigned long)((swarm_now() - start) * slice->eps / 1000000);
+
+        for (i = 0; i < slice->size; i++) {
+            swarm_agent_t * agent = &slice->agents[i];
+
+            if (agent->sock < 0 && now >= agent->next_connect) {
+                swarm_connect(agent, now);
+            }
+
+            if (agent->sock >= 0 && now >= agent->next_keepalive) {
+                swarm_keepalive(agent);
+                agent->next_keepalive = now + keepalive_interval;
+            }
+        }
+
+        /* Spread the events of the slice among its connected agents */
+        for (i = 0; seq < due && i < slice->size; ) {
+            swarm_agent_t * agent = &slice->agents[next];
+            next = (next + 1) % slice->size;
+
+            if (agent->sock < 0) {
+                i++;
+                continue;
+            }
+
+            swarm_event(agent, seq++);
+            i = 0;
+        }
+
+        /* The events of the disconnected agents are not sent later */
+        seq = seq < due ? due : seq;
+
+        for (i = 0, nfds = 0; i < slice->size; i++) {
+            if (slice->agents[i].sock >= 0) {
+                fds[nfds].fd = slice->agents[i].sock;
+                fds[nfds].events = POLLIN;
+                polled[nfds++] = i;
+            }
+        }
+
+        if (poll(fds, nfds, SWARM_POLL_MS) > 0) {
+            for (i = 0; i < (unsigned int)nfds; i++) {
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    swarm_receive(&slice->agents[polled[i]]);
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < slice->size; i++) {
+        if (slice->agents[i].sock >= 0) {
+            close(slice->agents[i].sock);
+        }
+    }
+
+    os_free(fds);
+    os_free(polled);
+    return NULL;
+}
+
+static void swarm_report(unsigned long elapsed)
+{
+    unsigned long acks = swarm_stats.acks;
+
+    printf("[%lus] connected: %lu, connect errors: %lu, sent: %lu (%lu bytes), send errors: %lu, received: %lu, "
+           "events: %s %lu, %s %lu, %s %lu, keepalive ack avg: %lu us, max: %lu us\n",
+           elapsed, (unsigned long)swarm_stats.connected, (unsigned long)swarm_stats.connect_errors,
+           (unsigned long)swarm_stats.sent, (unsigned long)swarm_stats.sent_bytes, (unsigned long)swarm_stats.send_errors,
+           (unsigned long)swarm_stats.received, event_names[0], (unsigned long)swarm_stats.events[0],
+           event_names[1], (unsigned long)swarm_stats.events[1], event_names[2], (unsigned long)swarm_stats.events[2],
+           acks ? (unsigned long)swarm_stats.rtt_total / acks : 0, (unsigned long)swarm_stats.rtt_max);
+    fflush(stdout);
+}
+
+/* Print the statistics of a manager daemon through its local socket */
+static void swarm_manager_stats(const char * name, const char * path)
+{
+    char response[OS_MAXSTR + 1];
+    const char * request = "{\"command\":\"getstats\"}";
+    int sock;
+    int length;
+
+    if (sock = OS_ConnectUnixDomain(path, SOCK_STREAM, OS_MAXSTR), sock < 0) {
+        printf("Unable to connect to %s at '%s'.\n", name, path);
+        return;
+    }
+
+    if (OS_SendSecureTCP(sock, strlen(request), request) == 0
+        && (length = OS_RecvSecureTCP(sock, response, OS_MAXSTR), length > 0)) {
+        response[length] = '\0';
+        printf("%s statistics: %s\n", name, response);
+    } else {
+        printf("Unable to get the %s statistics.\n", name);
+    }
+
+    close(sock);
+}
+
+int main(int argc, char **argv)
+{
+    const char * dir = NULL;
+    unsigned int agents = 0;
+    unsigned int threads = 4;
+    double eps = 1;
+    long duration = 0;
+    long report_interval = 5;
+    int manager_stats = 0;
+    swarm_agent_t * swarm;
+    swarm_slice_t slices[SWARM_MAX_THREADS];
+    pthread_t thread_ids[SWARM_MAX_THREADS];
+    struct rlimit rlim;
+    time_t start;
+    unsigned int i;
+    int c;
+
+    OS_SetName(ARGV0);
+
+    while ((c = getopt(argc, argv, "hm:p:D:n:t:e:k:x:d:r:S")) != -1) {
+        switch (c) {
+            case 'm':
+                manager = optarg;
+                break;
+            case 'p':
+                port = (u_int16_t)atoi(optarg);
+                break;
+            case 'D':
+                dir = optarg;
+                break;
+            case 'n':
+                agents = (unsigned int)strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                threads = (unsigned int)strtoul(optarg, NULL, 10);
+                break;
+            case 'e':
+                eps = strtod(optarg, NULL);
+                break;
+            case 'k':
+                keepalive_interval = atoi(optarg);
+                break;
+            case 'x':
+                if (sscanf(optarg, "%u,%u,%u", &mix[0], &mix[1], &mix[2]) != 3) {
+                    helpmsg();
+                }
+                break;
+            case 'd':
+                duration = atol(optarg);
+                break;
+            case 'r':
+                report_interval = atol(optarg);
+                break;
+            case 'S':
+                manager_stats = 1;
+                break;
+            default:
+                helpmsg();
+        }
+    }
+
+    if (!manager || port == 0 || eps < 0 || keepalive_interval < 1 || report_interval < 1) {
+        helpmsg();
+    }
+
+    threads = threads < 1 ? 1 : (threads > SWARM_MAX_THREADS ? SWARM_MAX_THREADS : threads);
+
+    if (dir && chdir(dir) < 0) {
+        merror_exit(CHDIR_ERROR, dir, errno, strerror(errno));
+    }
+
+    mkdir_ex(RIDS_DIR);
+
+    /* Accept any counter sent by the manager */
+    _s_verify_counter = 0;
+
+    OS_ReadKeys(&keys, W_ENCRYPTION_KEY, 0);
+
+    if (keys.keysize == 0) {
+        merror_exit("No keys found in '%s'.", KEYS_FILE);
+    }
+
+    if (agents == 0 || agents > keys.keysize) {
+        agents = keys.keysize;
+    }
+
+    threads = threads > agents ? agents : threads;
+
+    /* One socket per agent */
+    if (getrlimit(RLIMIT_NOFILE, &rlim) == 0 && rlim.rlim_cur < agents + OS_SIZE_1024) {
+        rlim.rlim_cur = rlim.rlim_max < agents + OS_SIZE_1024 ? rlim.rlim_max : agents + OS_SIZE_1024;
+
+        if (setrlimit(RLIMIT_NOFILE, &rlim) < 0 || rlim.rlim_cur < agents) {
+            mwarn("The open files limit (%lu) is lower than the number of agents.", (unsigned long)rlim.rlim_cur);
+        }
+    }
+
+    os_calloc(agents, sizeof(swarm_agent_t), swarm);
+
+    for (i = 0; i < agents; i++) {
+        keys.keyentries[i]->crypto_method = W_METH_AES;
+        swarm[i].key = i;
+        swarm[i].sock = -1;
+        /* Spread the first connections along a keepalive interval */
+        swarm[i].next_connect = time(NULL) + (time_t)((unsigned long)i * keepalive_interval / agents);
+        strcpy(swarm[i].merged_sum, "x");
+    }
+
+    signal(SIGINT, swarm_stop);
+    signal(SIGTERM, swarm_stop);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Starting %u agents in %u threads against %s:%u, %.2f EPS per agent.\n", agents, threads, manager, port, eps);
+
+    for (i = 0; i < threads; i++) {
+        unsigned int first = (unsigned long)agents * i / threads;
+        unsigned int last = (unsigned long)agents * (i + 1) / threads;
+
+        slices[i].agents = swarm + first;
+        slices[i].size = last - first;
+        slices[i].eps = eps * (last - first);
+
+        if (pthread_create(&thread_ids[i], NULL, swarm_thread, &slices[i]) != 0) {
+            merror_exit(THREAD_ERROR);
+        }
+    }
+
+    start = time(NULL);
+
+    while (running) {
+        sleep(report_interval);
+        swarm_report(time(NULL) - start);
+
+        if (duration > 0 && time(NULL) - start >= duration) {
+            running = 0;
+        }
+    }
+
+    for (i = 0; i < threads; i++) {
+        pthread_join(thread_ids[i], NULL);
+    }
+
+    swarm_report(time(NULL) - start);
+
+    if (manager_stats) {
+        swarm_manager_stats("remoted", REMOTE_LOCAL_SOCK);
+        swarm_manager_stats("analysisd", ANLSYS_LOCAL_SOCK);
+    }
+
+    os_free(swarm);
+    return 0;
+}
@@ -89,31 +89,28 @@ int wdb_set_agent_sys_osinfo_triaged(int id,
     return result;
 }
 
-cJSON* wdb_insert_vuln_cves(int id,
-                            const char *name,
-                            const char *version,
-                            const char *architecture,
-                            const char *cve,
-                            const char *severity,
-                            double cvss2_score,
-                            double cvss3_score,
-                            const char *reference,
-                            const char *type,
-                            const char *status,
-                            char **external_references,
-                            const char *condition,
-                            const char *title,
-                            const char *published,
-                            const char *updated,
-                            bool check_pkg_existence,
-                            int *sock) {
-    cJSON *data_in = NULL;
-    char *data_in_str = NULL;
-    char *wdbquery = NULL;
-    char *wdboutput = NULL;
-    int aux_sock = -1;
-
-    data_in = cJSON_CreateObject();
+/**
+ * @brief Builds the data of a vulnerability for the vuln_cves insert command.
+ *
+ * @return cJSON object with the data, NULL on error. It must be freed by the caller.
+ */
+static cJSON* wdb_create_vuln_cves_data(const char *name,
+                                        const char *version,
+                                        const char *architecture,
+                                        const char *cve,
+                                        const char *severity,
+                                        double cvss2_score,
+                                        double cvss3_score,
+                                        const char *reference,
+                                        const char *type,
+                                        const char *status,
+                                        char **external_references,
+                                        const char *condition,
+                                        const char *title,
+                                        const char *published,
+                                        const char *updated,
+                                        bool check_pkg_existence) {
+    cJSON *data_in = cJSON_CreateObject();
     if (!data_in) {
         mdebug1("Error creating data JSON for Wazuh DB.");
         return NULL;
@@ -157,6 +154,39 @@ cJSON* wdb_insert_vuln_cves(int id,
         os_free(str_cvs_references);
     }
 
+    return data_in;
+}
+
+cJSON* wdb_insert_vuln_cves(int id,
+                            const char *name,
+                            const char *version,
+                            const char *architecture,
+                            const char *cve,
+                            const char *severity,
+                            double cvss2_score,
+                            double cvss3_score,
+                            const char *reference,
+                            const char *type,
+                            const char *status,
+                            char **external_references,
+                            const char *condition,
+                            const char *title,
+                            const char *published,
+                            const char *updated,
+                            bool check_pkg_existence,
+                            int *sock) {
+    cJSON *data_in = NULL;
+    char *data_in_str = NULL;
+    char *wdbquery = NULL;
+    char *wdboutput = NULL;
+    int aux_sock = -1;
+
+    data_in = wdb_create_vuln_cves_data(name, version, architecture, cve, severity, cvss2_score, cvss3_score, reference, type,
+                                        status, external_references, condition, title, published, updated, check_pkg_existence);
+    if (!data_in) {
+        return NULL;
+    }
+
     data_in_str = cJSON_PrintUnformatted(data_in);
     os_malloc(WDB_MAX_QUERY_SIZE, wdbquery);
     snprintf(wdbquery, WDB_MAX_QUERY_SIZE, agents_db_commands[WDB_AGENTS_VULN_CVES_INSERT], id, data_in_str);
@@ -180,6 +210,148 @@ cJSON* wdb_insert_vuln_cves(int id,
     return result;
 }
 
+int wdb_append_vuln_cves(cJSON **batch,
+                         const char *name,
+                         const char *version,
+                         const char *architecture,
+                         const char *cve,
+                         const char *severity,
+                         double cvss2_score,
+                         double cvss3_score,
+                         const char *reference,
+                         const char *type,
+                         const char *status,
+                         char **external_references,
+                         const char *condition,
+                         const char *title,
+                         const char *published,
+                         const char *updated,
+                         bool check_pkg_existence) {
+    cJSON *data_in = wdb_create_vuln_cves_data(name, version, architecture, cve, severity, cvss2_score, cvss3_score, reference, type,
+                                               status, external_references, condition, title, published, updated, check_pkg_existence);
+    if (!data_in) {
+        return OS_INVALID;
+    }
+
+    if (!*batch && (*batch = cJSON_CreateArray(), !*batch)) {
+        mdebug1("Error creating data JSON for Wazuh DB.");
+        cJSON_Delete(data_in);
+        return OS_INVALID;
+    }
+
+    cJSON_AddItemToArray(*batch, data_in);
+    return OS_SUCCESS;
+}
+
+/**
+ * @brief Adds the result of a vulnerability that couldn't be inserted.
+ */
+static void wdb_add_vuln_cves_error(cJSON *results) {
+    cJSON *j_error = cJSON_CreateObject();
+
+    if (j_error) {
+        cJSON_AddStringToObject(j_error, "status", "ERROR");
+        cJSON_AddItemToArray(results, j_error);
+    }
+}
+
+/**
+ * @brief Sends a pack of the vuln_cves insert batch and moves the results of its vulnerabilities to results.
+ *
+ * @param[in] id The agent ID.
+ * @param[in] wdbquery Query with the open array of the pack, of length characters.
+ * @param[in] length Length of the query.
+ * @param[in] count Number of vulnerabilities in the pack.
+ * @param[in] sock The Wazuh DB socket connection.
+ * @param[out] results Results of the batch.
+ */
+static void wdb_send_vuln_cves_pack(int id, char *wdbquery, size_t length, int count, int *sock, cJSON *results) {
+    char *wdboutput = NULL;
+    int i;
+
+    wdbquery[length] = ']';
+    wdbquery[length + 1] = '\0';
+
+    os_malloc(WDBOUTPUT_SIZE, wdboutput);
+    cJSON *j_pack_results = wdbc_query_parse_json(sock, wdbquery, wdboutput, WDBOUTPUT_SIZE);
+    os_free(wdboutput);
+
+    if (cJSON_IsArray(j_pack_results) && cJSON_GetArraySize(j_pack_results) == count) {
+        while (j_pack_results->child) {
+            cJSON_AddItemToArray(results, cJSON_DetachItemFromArray(j_pack_results, 0));
+        }
+    } else {
+        merror("Agents DB (%d) Error querying Wazuh DB to insert vuln_cves", id);
+        for (i = 0; i < count; i++) {
+            wdb_add_vuln_cves_error(results);
+        }
+    }
+
+    cJSON_Delete(j_pack_results);
+}
+
+cJSON* wdb_insert_vuln_cves_batch(int id,
+                                  cJSON **batch,
+                                  int *sock) {
+    cJSON *results = NULL;
+    cJSON *j_item = NULL;
+    char *wdbquery = NULL;
+    size_t header = 0;
+    size_t length = 0;
+    int count = 0;
+    int aux_sock = -1;
+
+    if (results = cJSON_CreateArray(), !results) {
+        mdebug1("Error creating data JSON for Wazuh DB.");
+        cJSON_Delete(*batch);
+        *batch = NULL;
+        return NULL;
+    }
+
+    os_malloc(WDB_MAX_QUERY_SIZE, wdbquery);
+    header = length = snprintf(wdbquery, WDB_MAX_QUERY_SIZE, agents_db_commands[WDB_AGENTS_VULN_CVES_INSERT], id, "[");
+
+    cJSON_ArrayForEach(j_item, *batch) {
+        char *item_str = cJSON_PrintUnformatted(j_item);
+        size_t item_length = item_str ? strlen(item_str) : 0;
+
+        // The vulnerabilities that don't fit with the pending ones go in the next pack
+        if (count && length + item_length + 2 >= WDB_MAX_QUERY_SIZE) {
+            wdb_send_vuln_cves_pack(id, wdbquery, length, count, sock ? sock : &aux_sock, results);
+            length = header;
+            count = 0;
+        }
+
+        if (!item_str || length + item_length + 2 >= WDB_MAX_QUERY_SIZE) {
+            mdebug1("Agents DB (%d) Vulnerability too large to insert in vuln_cves", id);
+            wdb_add_vuln_cves_error(results);
+        } else {
+            if (count) {
+                wdbquery[length++] = ',';
+            }
+            memcpy(wdbquery + length, item_str, item_length);
+            length += item_length;
+            count++;
+        }
+
+        os_free(item_str);
+    }
+
+    if (count) {
+        wdb_send_vuln_cves_pack(id, wdbquery, length, count, sock ? sock : &aux_sock, results);
+    }
+
+    os_free(wdbquery);
+    cJSON_Delete(*batch);
+    *batch = NULL;
+
+    if (!sock) {
+        wdbc_close(&aux_sock);
+    }
+
+    return results;
+}
+
 int wdb_update_vuln_cves_status(int id,
                                 const char *old_status,
                                 const char *new_status,
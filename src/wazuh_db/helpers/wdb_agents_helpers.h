@@ -91,6 +91,47 @@ cJSON* wdb_insert_vuln_cves(int id,
                             bool check_pkg_existence,
                             int *sock);
 
+/**
+ * @brief Appends a vulnerability to a batch of insertions in the vuln_cves table, see wdb_insert_vuln_cves_batch().
+ *
+ * @param[in,out] batch JSON array with the batch. It's created if it points to NULL.
+ * The rest of parameters are the ones of wdb_insert_vuln_cves().
+ * @return OS_SUCCESS on success, OS_INVALID on error.
+ */
+int wdb_append_vuln_cves(cJSON **batch,
+                         const char *name,
+                         const char *version,
+                         const char *architecture,
+                         const char *cve,
+                         const char *severity,
+                         double cvss2_score,
+                         double cvss3_score,
+                         const char *reference,
+                         const char *type,
+                         const char *status,
+                         char **external_references,
+                         const char *condition,
+                         const char *title,
+                         const char *published,
+                         const char *updated,
+                         bool check_pkg_existence);
+
+/**
+ * @brief Insert or update a batch of vulnerabilities in the vuln_cves table in the agents database.
+ *
+ * The vulnerabilities are sent packed in as few queries as fit in the Wazuh DB query size.
+ *
+ * @param[in] id The agent ID.
+ * @param[in,out] batch JSON array built with wdb_append_vuln_cves(). It's freed and set to NULL.
+ * @param[in] sock The Wazuh DB socket connection. If NULL, a new connection will be created and closed locally.
+ * @return Returns a cJSON array with the result of each vulnerability in the order of the batch,
+ *         as described in wdb_insert_vuln_cves(). The vulnerabilities that couldn't be sent have
+ *         'status': 'ERROR'. NULL on error. The cJSON array must be freed by the caller.
+ */
+cJSON* wdb_insert_vuln_cves_batch(int id,
+                                  cJSON **batch,
+                                  int *sock);
+
 /**
  * @brief Removes all the entries from the vuln_cves table in the agent's database that have the specified status.
  *
@@ -17,6 +17,9 @@
 #define chown(x, y, z) 0
 #endif
 
+/* Agents per keepalive update query, so that it fits in a socket message */
+#define WDB_KEEPALIVE_BATCH 4096
+
 static const char *global_db_commands[] = {
     [WDB_INSERT_AGENT] = "global insert-agent %s",
     [WDB_INSERT_AGENT_GROUP] = "global insert-agent-group %s",
@@ -39,6 +42,7 @@ static const char *global_db_commands[] = {
     [WDB_RESET_AGENTS_CONNECTION] = "global reset-agents-connection %s",
     [WDB_GET_AGENTS_BY_CONNECTION_STATUS] = "global get-agents-by-connection-status %d %s",
     [WDB_GET_AGENTS_BY_CONNECTION_STATUS_AND_NODE] = "global get-agents-by-connection-status %d %s %s %d",
+    [WDB_GET_AGENTS_INFO_BY_CONNECTION_STATUS] = "global get-agents-info-by-connection-status %d %s",
     [WDB_DISCONNECT_AGENTS] = "global disconnect-agents %d %d %s",
     [WDB_GET_DISTINCT_AGENT_GROUP] = "global get-distinct-groups %s"
 };
@@ -333,6 +337,73 @@ int wdb_update_agent_keepalive(int id, const char *connection_status, const char
     return result;
 }
 
+int wdb_update_agents_keepalive(const int *ids, size_t count, const char *connection_status, const char *sync_status, int *sock) {
+    int result = OS_SUCCESS;
+    cJSON *data_in = NULL;
+    cJSON *j_ids = NULL;
+    char *data_in_str = NULL;
+    char *wdbquery = NULL;
+    char *wdboutput = NULL;
+    int aux_sock = -1;
+    size_t i = 0;
+
+    os_malloc(OS_MAXSTR, wdbquery);
+    os_malloc(WDBOUTPUT_SIZE, wdboutput);
+
+    while (i < count && result == OS_SUCCESS) {
+        data_in = cJSON_CreateObject();
+
+        if (!data_in) {
+            mdebug1("Error creating data JSON for Wazuh DB.");
+            result = OS_INVALID;
+            break;
+        }
+
+        j_ids = cJSON_AddArrayToObject(data_in, "ids");
+
+        for (size_t batch_end = i + WDB_KEEPALIVE_BATCH; i < count && i < batch_end; i++) {
+            cJSON_AddItemToArray(j_ids, cJSON_CreateNumber(ids[i]));
+        }
+
+        cJSON_AddStringToObject(data_in, "connection_status", connection_status);
+        cJSON_AddStringToObject(data_in, "sync_status", sync_status);
+        data_in_str = cJSON_PrintUnformatted(data_in);
+
+        snprintf(wdbquery, OS_MAXSTR, global_db_commands[WDB_UPDATE_AGENT_KEEPALIVE], data_in_str);
+
+        result = wdbc_query_ex(sock?sock:&aux_sock, wdbquery, wdboutput, WDBOUTPUT_SIZE);
+
+        switch (result) {
+            case OS_SUCCESS:
+                if (WDBC_OK != wdbc_parse_result(wdboutput, NULL)) {
+                    mdebug1("Global DB Error reported in the result of the query");
+                    result = OS_INVALID;
+                }
+                break;
+            case OS_INVALID:
+                mdebug1("Global DB Error in the response from socket");
+                mdebug2("Global DB SQL query: %s", wdbquery);
+                break;
+            default:
+                mdebug1("Global DB Cannot execute SQL query; err database %s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
+                mdebug2("Global DB SQL query: %s", wdbquery);
+                result = OS_INVALID;
+        }
+
+        cJSON_Delete(data_in);
+        os_free(data_in_str);
+    }
+
+    if (!sock) {
+        wdbc_close(&aux_sock);
+    }
+
+    os_free(wdbquery);
+    os_free(wdboutput);
+
+    return result;
+}
+
 int wdb_update_agent_connection_status(int id, const char *connection_status, const char *sync_status, int *sock, agent_status_code_t status_code) {
     int result = 0;
     cJSON *data_in = NULL;
@@ -986,6 +1057,66 @@ int* wdb_get_agents_by_connection_status(const char* connection_status, int *soc
     return array;
 }
 
+cJSON* wdb_get_agents_info_by_connection_status(const char* connection_status, int *sock) {
+    char wdbquery[WDBQUERY_SIZE] = "";
+    char wdboutput[WDBOUTPUT_SIZE] = "";
+    int last_id = 0;
+    cJSON *agents = NULL;
+    wdbc_result status = WDBC_DUE;
+    int aux_sock = -1;
+
+    if (agents = cJSON_CreateArray(), !agents) {
+        return NULL;
+    }
+
+    while (status == WDBC_DUE) {
+        char* payload = NULL;
+        cJSON* chunk = NULL;
+        cJSON* agent = NULL;
+
+        // Query WazuhDB
+        snprintf(wdbquery, sizeof(wdbquery), global_db_commands[WDB_GET_AGENTS_INFO_BY_CONNECTION_STATUS], last_id, connection_status);
+        if (wdbc_query_ex(sock?sock:&aux_sock, wdbquery, wdboutput, sizeof(wdboutput)) != 0) {
+            status = WDBC_ERROR;
+            break;
+        }
+
+        status = wdbc_parse_result(wdboutput, &payload);
+        if (status != WDBC_OK && status != WDBC_DUE) {
+            status = WDBC_ERROR;
+            break;
+        }
+
+        if (chunk = cJSON_Parse(payload), !chunk) {
+            status = WDBC_ERROR;
+            break;
+        }
+
+        // Move the agents of the chunk to the output array
+        while (agent = cJSON_DetachItemFromArray(chunk, 0), agent) {
+            cJSON* json_id = cJSON_GetObjectItem(agent, "id");
+            if (cJSON_IsNumber(json_id)) {
+                last_id = json_id->valueint;
+            }
+            cJSON_AddItemToArray(agents, agent);
+        }
+
+        cJSON_Delete(chunk);
+    }
+
+    if (!sock) {
+        wdbc_close(&aux_sock);
+    }
+
+    if (status == WDBC_ERROR) {
+        merror("Error querying Wazuh DB to get the information of the agents by connection status.");
+        cJSON_Delete(agents);
+        return NULL;
+    }
+
+    return agents;
+}
+
 wdbc_result wdb_parse_chunk_to_int(char* input, int** output, const char* item, int* last_item, int* last_size) {
     int len = last_size ? *last_size : 0;
     int _last_item = 0;
@@ -36,6 +36,7 @@ typedef enum global_db_access {
     WDB_RESET_AGENTS_CONNECTION,
     WDB_GET_AGENTS_BY_CONNECTION_STATUS,
     WDB_GET_AGENTS_BY_CONNECTION_STATUS_AND_NODE,
+    WDB_GET_AGENTS_INFO_BY_CONNECTION_STATUS,
     WDB_DISCONNECT_AGENTS,
     WDB_GET_DISTINCT_AGENT_GROUP
 } global_db_access;
@@ -101,6 +102,20 @@ int wdb_update_agent_data(agent_info_data *agent_data, int *sock);
  */
 int wdb_update_agent_keepalive(int id, const char *connection_status, const char *sync_status, int *sock);
 
+/**
+ * @brief Update the last keepalive of a set of agents and modifies their cluster synchronization status.
+ *
+ * The agents are sent in as few queries as the query size allows.
+ *
+ * @param[in] ids Array with the IDs of the agents for whom the keepalive must be updated.
+ * @param[in] count Number of agents in the array.
+ * @param[in] connection_status String with the connection status to be set.
+ * @param[in] sync_status String with the cluster synchronization status to be set.
+ * @param[in] sock The Wazuh DB socket connection. If NULL, a new connection will be created and closed locally.
+ * @return OS_SUCCESS on success or OS_INVALID on failure.
+ */
+int wdb_update_agents_keepalive(const int *ids, size_t count, const char *connection_status, const char *sync_status, int *sock);
+
 /**
  * @brief Update agent's connection status.
  *
@@ -284,6 +299,18 @@ int wdb_reset_agents_connection(const char *sync_status, int *sock);
  */
 int* wdb_get_agents_by_connection_status(const char* connection_status, int *sock);
 
+/**
+ * @brief Returns a JSON array with the information of every agent (excluding the manager) that matches
+ *        the specified connection status, as wdb_get_agent_info() does for a single agent.
+ *        If the response is bigger than the capacity of the socket, multiple commands will be sent until every
+ *        agent is obtained.
+ *
+ * @param[in] connection_status The connection status.
+ * @param[in] sock The Wazuh DB socket connection. If NULL, a new connection will be created and closed locally.
+ * @return JSON array with the agents, on success. NULL on errors. It must be freed by the caller.
+ */
+cJSON* wdb_get_agents_info_by_connection_status(const char* connection_status, int *sock);
+
 /**
  * @brief Set agents as disconnected based on the keepalive and return an array containing
  * the ID of every agent that had been set as disconnected.
@@ -11,6 +11,7 @@
 
 #include "wdb.h"
 #include "wdb_state.h"
+#include "wazuhdb_bin.h"
 #include <os_net/os_net.h>
 
 static void wdb_help() __attribute__ ((noreturn));
@@ -21,6 +22,7 @@ static void * run_worker(void * args);
 static void * run_gc(void * args);
 static void * run_up(void * args);
 static void * run_backup(void * args);
+static bool peer_pending(int peer);
 
 extern wdb_state_t wdb_state;
 
@@ -91,6 +93,7 @@ int main(int argc, char ** argv)
     wconfig.worker_pool_size = getDefine_Int("wazuh_db", "worker_pool_size", 1, 32);
     wconfig.commit_time_min = getDefine_Int("wazuh_db", "commit_time_min", 1, 3600);
     wconfig.commit_time_max = getDefine_Int("wazuh_db", "commit_time_max", 1, 3600);
+    wconfig.commit_changes_max = getDefine_Int("wazuh_db", "commit_changes_max", 0, 1000000);
     wconfig.open_db_limit = getDefine_Int("wazuh_db", "open_db_limit", 1, 4096);
     nofile = getDefine_Int("wazuh_db", "rlimit_nofile", 1024, 1048576);
 
@@ -99,6 +102,10 @@ int main(int argc, char ** argv)
     wconfig.free_pages_percentage = getDefine_Int("wazuh_db", "free_pages_percentage", 0, 99);
     wconfig.max_fragmentation = getDefine_Int("wazuh_db", "max_fragmentation", 0, 100);
     wconfig.check_fragmentation_interval = getDefine_Int("wazuh_db", "check_fragmentation_interval", 1, 30758400);
+    wconfig.incremental_vacuum_budget = getDefine_Int("wazuh_db", "incremental_vacuum_budget", 0, 60000);
+    wconfig.global_readers = getDefine_Int("wazuh_db", "global_readers", 0, 32);
+    wconfig.pipeline_max = getDefine_Int("wazuh_db", "pipeline_max", 1, 1024);
+    wconfig.agent_cache_size = getDefine_Int("wazuh_db", "agent_cache_size", 0, 1048576);
 
     // Allocating memory for configuration structures and setting default values
     wdb_init_conf();
@@ -204,6 +211,9 @@ int main(int argc, char ** argv)
 
     wdb_state.uptime = time(NULL);
 
+    // The request payloads are parsed into per-worker arenas
+    json_arena_init();
+
     // Start threads
 
     if (status = pthread_create(&thread_dealer, NULL, run_dealer, NULL), status != 0) {
@@ -331,11 +341,16 @@ error:
 }
 
 void * run_worker(__attribute__((unused)) void * args) {
-    char buffer[OS_MAXSTR + 1];
+    os_frame_reader_t reader;
+    char * buffer;
     char response[OS_MAXSTR + 1];
     ssize_t length;
     int terminal;
     int peer;
+    int served;
+    int connected;
+
+    OS_FrameReaderInit(&reader, -1, OS_MAXSTR, OS_MAXSTR);
 
     while (running) {
         // Dequeue peer
@@ -365,54 +380,80 @@ void * run_worker(__attribute__((unused)) void * args) {
 
         w_mutex_unlock(&queue_mutex);
 
-        ssize_t count;
-        length = 0;
-        count = OS_RecvSecureTCP(peer, buffer, OS_MAXSTR);
+        /* Serve the commands that the peer has already sent, in order.
+         * A single read may carry several of them: the peer is not returned
+         * to the queue while there is data left in the reader. */
+        OS_FrameReaderReset(&reader, peer);
 
-        if(count == OS_SOCKTERR){
-            mwarn("at run_worker(): received string size is bigger than %d bytes",
-                    OS_MAXSTR);
-            break;
-        }
-        length+=count;
+        for (served = 0, connected = 1; connected && (served < wconfig.pipeline_max || OS_FrameReaderPending(&reader)); served++) {
+            length = OS_RecvSecureTCPFrame(&reader, &buffer);
 
-        switch (length) {
-        case -1:
-            merror("at run_worker(): at recv(): %s (%d)", strerror(errno), errno);
-            close(peer);
-            continue;
+            if (length == OS_SOCKTERR) {
+                mwarn("at run_worker(): received string size is bigger than %d bytes",
+                        OS_MAXSTR);
+                close(peer);
+                connected = 0;
+                break;
+            }
 
-        case 0:
-            mdebug1("Client %d disconnected.", peer);
-            close(peer);
-            continue;
+            switch (length) {
+            case -1:
+                merror("at run_worker(): at recv(): %s (%d)", strerror(errno), errno);
+                close(peer);
+                connected = 0;
+                break;
 
-        default:
-            if (length > 0 && buffer[length - 1] == '\n') {
-                buffer[length - 1] = '\0';
-                terminal = 1;
-            } else {
-                buffer[length] = '\0';
+            case 0:
+                mdebug1("Client %d disconnected.", peer);
+                close(peer);
+                connected = 0;
+                break;
+
+            default:
+                *response = '\0';
                 terminal = 0;
-            }
 
-            *response = '\0';
+                if (wdb_bin_is_binary(buffer, length)) {
+                    buffer[length] = '\0';
+                    wdb_parse_binary(buffer, length, response, peer);
+                } else {
+                    if (length > 0 && buffer[length - 1] == '\n') {
+                        buffer[length - 1] = '\0';
+                        terminal = 1;
+                    } else {
+                        buffer[length] = '\0';
+                    }
 
-            if (buffer[0] == '{') {
-                wdbcom_dispatch(buffer, response);
-            } else {
-                wdb_parse(buffer, response, peer);
-            }
-            if (length = strlen(response), length > 0) {
-                if (terminal && length < OS_MAXSTR - 1) {
-                    response[length++] = '\n';
+                    if (buffer[0] == '{') {
+                        wdbcom_dispatch(buffer, response);
+                    } else {
+                        W_PROBE1(query__start, peer);
+                        wdb_parse(buffer, response, peer);
+                        W_PROBE1(query__done, peer);
+                    }
                 }
-                if (OS_SendSecureTCP(peer, length, response) < 0) {
-                    merror("at run_worker(): OS_SendSecureTCP(%d): %s (%d)",
-                            peer, strerror(errno), errno);
+                if (length = strlen(response), length > 0) {
+                    if (terminal && length < OS_MAXSTR - 1) {
+                        response[length++] = '\n';
+                    }
+                    if (OS_SendSecureTCP(peer, length, response) < 0) {
+                        merror("at run_worker(): OS_SendSecureTCP(%d): %s (%d)",
+                                peer, strerror(errno), errno);
+                    }
                 }
+
+                // The trees parsed by the command are already deleted
+                json_arena_reset();
+                break;
+            }
+
+            if (connected && !OS_FrameReaderPending(&reader) && !peer_pending(peer)) {
+                break;
             }
-            break;
+        }
+
+        if (!connected) {
+            continue;
         }
 
         if (wnotify_add(notify_queue, peer, WO_READ) < 0) {
@@ -421,9 +462,16 @@ void * run_worker(__attribute__((unused)) void * args) {
         }
     }
 
+    OS_FrameReaderFree(&reader);
     return NULL;
 }
 
+// Check whether the peer has sent more data, or closed the connection, without blocking
+bool peer_pending(int peer) {
+    char byte;
+    return recv(peer, &byte, 1, MSG_PEEK | MSG_DONTWAIT) >= 0;
+}
+
 void * run_gc(__attribute__((unused)) void * args) {
     int fragmentation_interval = wconfig.check_fragmentation_interval;
     while (running) {
@@ -436,6 +484,10 @@ void * run_gc(__attribute__((unused)) void * args) {
             fragmentation_interval--;
         }
 
+        if (wconfig.incremental_vacuum_budget > 0) {
+            wdb_incremental_vacuum_idle();
+        }
+
         wdb_close_old();
 
         sleep(1);
@@ -461,11 +513,20 @@ void * run_backup(__attribute__((unused)) void * args) {
                         current_time = time(NULL);
                         if((current_time - last_global_backup_time) >= global_interval) {
                             wdb_t* wdb = wdb_open_global();
-                            if (wdb && wdb->enabled && OS_SUCCESS != wdb_global_create_backup(wdb, output, NULL)) {
+                            bool ready = wdb && wdb->enabled;
+
+                            // Commit the pending changes only: the snapshot is taken through another connection
+                            if (ready && wdb_commit2(wdb) == OS_INVALID) {
+                                merror("Creating Global DB snapshot by interval failed: Cannot commit current transaction");
+                                ready = false;
+                            }
+
+                            wdb_leave(wdb);
+
+                            if (ready && OS_SUCCESS != wdb_global_create_backup_online(output, NULL)) {
                                 merror("Creating Global DB snapshot by interval failed: %s", output);
                             }
                             last_global_backup_time = current_time;
-                            wdb_leave(wdb);
                         }
                     }
                     break;
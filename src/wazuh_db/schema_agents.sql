@@ -6,6 +6,8 @@
  * and/or modify it under the terms of GPLv2.
  */
 
+PRAGMA auto_vacuum = INCREMENTAL;
+
 CREATE TABLE IF NOT EXISTS fim_entry (
     full_path TEXT NOT NULL PRIMARY KEY,
     file TEXT,
@@ -0,0 +1,51 @@
+/*
+ * SQL Schema for upgrading databases
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * October, 2026.
+ *
+ * This program is a free software, you can redistribute it
+ * and/or modify it under the terms of GPLv2.
+*/
+
+CREATE TABLE IF NOT EXISTS agent_change (
+    seq INTEGER PRIMARY KEY AUTOINCREMENT,
+    id INTEGER NOT NULL,
+    operation TEXT NOT NULL CHECK (operation IN ('insert', 'update', 'delete', 'groups')),
+    timestamp INTEGER NOT NULL
+);
+
+CREATE TRIGGER IF NOT EXISTS agent_change_prune AFTER INSERT ON agent_change BEGIN
+    DELETE FROM agent_change WHERE seq <= NEW.seq - 100000;
+END;
+
+CREATE TRIGGER IF NOT EXISTS agent_change_insert AFTER INSERT ON agent BEGIN
+    INSERT INTO agent_change (id, operation, timestamp) VALUES (NEW.id, 'insert', strftime('%s', 'now'));
+END;
+
+CREATE TRIGGER IF NOT EXISTS agent_change_update AFTER UPDATE ON agent
+    WHEN OLD.name IS NOT NEW.name OR OLD.ip IS NOT NEW.ip OR OLD.register_ip IS NOT NEW.register_ip OR
+        OLD.internal_key IS NOT NEW.internal_key OR OLD.os_name IS NOT NEW.os_name OR OLD.os_version IS NOT NEW.os_version OR
+        OLD.os_major IS NOT NEW.os_major OR OLD.os_minor IS NOT NEW.os_minor OR OLD.os_codename IS NOT NEW.os_codename OR
+        OLD.os_build IS NOT NEW.os_build OR OLD.os_platform IS NOT NEW.os_platform OR OLD.os_uname IS NOT NEW.os_uname OR
+        OLD.os_arch IS NOT NEW.os_arch OR OLD.version IS NOT NEW.version OR OLD.config_sum IS NOT NEW.config_sum OR
+        OLD.merged_sum IS NOT NEW.merged_sum OR OLD.manager_host IS NOT NEW.manager_host OR OLD.node_name IS NOT NEW.node_name OR
+        OLD.`group` IS NOT NEW.`group` OR OLD.connection_status IS NOT NEW.connection_status OR
+        OLD.disconnection_time IS NOT NEW.disconnection_time OR OLD.group_config_status IS NOT NEW.group_config_status OR
+        OLD.status_code IS NOT NEW.status_code BEGIN
+    INSERT INTO agent_change (id, operation, timestamp) VALUES (NEW.id, 'update', strftime('%s', 'now'));
+END;
+
+CREATE TRIGGER IF NOT EXISTS agent_change_delete AFTER DELETE ON agent BEGIN
+    INSERT INTO agent_change (id, operation, timestamp) VALUES (OLD.id, 'delete', strftime('%s', 'now'));
+END;
+
+CREATE TRIGGER IF NOT EXISTS agent_change_belongs_insert AFTER INSERT ON belongs BEGIN
+    INSERT INTO agent_change (id, operation, timestamp) VALUES (NEW.id_agent, 'groups', strftime('%s', 'now'));
+END;
+
+CREATE TRIGGER IF NOT EXISTS agent_change_belongs_delete AFTER DELETE ON belongs BEGIN
+    INSERT INTO agent_change (id, operation, timestamp) VALUES (OLD.id_agent, 'groups', strftime('%s', 'now'));
+END;
+
+UPDATE metadata SET value = '6' where key = 'db_version';
@@ -28,12 +28,14 @@ CREATE INDEX IF NOT EXISTS IN_TASK_CREATE_TIME ON TASKS (CREATE_TIME);
 CREATE INDEX IF NOT EXISTS IN_TASK_LAST_UPDATE_TIME ON TASKS (LAST_UPDATE_TIME);
 CREATE INDEX IF NOT EXISTS IN_TASK_STATUS ON TASKS (STATUS);
 CREATE INDEX IF NOT EXISTS IN_TASK_ERROR_MESSAGE ON TASKS (ERROR_MESSAGE);
+CREATE INDEX IF NOT EXISTS IN_TASK_AGENT_COMMAND ON TASKS (AGENT_ID, COMMAND, CREATE_TIME);
+CREATE INDEX IF NOT EXISTS IN_TASK_NODE_STATUS ON TASKS (NODE, STATUS);
 
 CREATE TABLE IF NOT EXISTS METADATA (
     key TEXT PRIMARY KEY,
     value TEXT
 );
 
-INSERT INTO METADATA (key, value) VALUES ('db_version', '1');
+INSERT INTO METADATA (key, value) VALUES ('db_version', '2');
 
 END;
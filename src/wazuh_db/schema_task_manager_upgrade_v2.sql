@@ -0,0 +1,16 @@
+/*
+ * SQL Schema for upgrading the task manager database
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is a free software, you can redistribute it
+ * and/or modify it under the terms of GPLv2.
+*/
+
+BEGIN;
+
+CREATE INDEX IF NOT EXISTS IN_TASK_AGENT_COMMAND ON TASKS (AGENT_ID, COMMAND, CREATE_TIME);
+CREATE INDEX IF NOT EXISTS IN_TASK_NODE_STATUS ON TASKS (NODE, STATUS);
+
+UPDATE METADATA SET value = '2' WHERE key = 'db_version';
+
+END;
@@ -125,6 +125,7 @@ CREATE INDEX IF NOT EXISTS IN_VUL_TARGET ON VULNERABILITIES (TARGET);
 CREATE INDEX IF NOT EXISTS IN_VUL_TARGET_MINOR ON VULNERABILITIES (TARGET_MINOR);
 CREATE INDEX IF NOT EXISTS IN_VUL_ARCH ON VULNERABILITIES (ARCH_ID);
 CREATE INDEX IF NOT EXISTS IN_VUL_DEPS ON VULNERABILITIES (DEPS_ID);
+CREATE INDEX IF NOT EXISTS IN_VUL_PACK_TARGET ON VULNERABILITIES (PACKAGE, TARGET);
 
 CREATE TABLE IF NOT EXISTS VARIABLES (
     VID TEXT NOT NULL,
@@ -10,6 +10,7 @@
  */
 
 #include "wdb.h"
+#include "wdb_state.h"
 #include "wazuh_modules/wmodules.h"
 #include "wazuhdb_op.h"
 
@@ -46,6 +47,9 @@ static const char *SQL_SELECT_TEMP_TABLE = "SELECT sum(s1.pageno+1==s2.pageno)*1
 static const char *SQL_SELECT_PAGE_COUNT = "SELECT page_count FROM pragma_page_count();";
 static const char *SQL_SELECT_PAGE_FREE = "SELECT freelist_count FROM pragma_freelist_count();";
 static const char *SQL_VACUUM = "VACUUM;";
+static const char *SQL_SELECT_AUTO_VACUUM = "SELECT auto_vacuum FROM pragma_auto_vacuum();";
+static const char *SQL_SET_AUTO_VACUUM_INCREMENTAL = "PRAGMA auto_vacuum = INCREMENTAL;";
+static const char *SQL_INCREMENTAL_VACUUM = "PRAGMA incremental_vacuum;";
 static const char *SQL_METADATA_UPDATE_FRAGMENTATION_DATA = "INSERT INTO metadata (key, value) VALUES ('last_vacuum_time', ?), ('last_vacuum_value', ?) ON CONFLICT(key) DO UPDATE SET value=excluded.value;";
 static const char *SQL_METADATA_GET_FRAGMENTATION_DATA = "SELECT key, value FROM metadata WHERE key in ('last_vacuum_time', 'last_vacuum_value');";
 static const char *SQL_INSERT_INFO = "INSERT INTO info (key, value) VALUES (?, ?);";
@@ -210,12 +214,15 @@ static const char *SQL_STMT[] = {
     [WDB_STMT_GLOBAL_RESET_CONNECTION_STATUS] = "UPDATE agent SET connection_status = 'disconnected', status_code = ?, sync_status = ?, disconnection_time = STRFTIME('%s', 'NOW') where connection_status != 'disconnected' AND connection_status != 'never_connected' AND id != 0;",
     [WDB_STMT_GLOBAL_GET_AGENTS_TO_DISCONNECT] = "SELECT id FROM agent WHERE id > ? AND (connection_status = 'active' OR connection_status = 'pending') AND last_keepalive < ?;",
     [WDB_STMT_GLOBAL_AGENT_EXISTS] = "SELECT EXISTS(SELECT 1 FROM agent WHERE id=?);",
+    [WDB_STMT_GLOBAL_GET_CHANGES] = "SELECT seq, id, operation FROM agent_change WHERE seq > ? ORDER BY seq LIMIT ?;",
+    [WDB_STMT_GLOBAL_GET_OLDEST_CHANGE] = "SELECT IFNULL(MIN(seq), 0) FROM agent_change;",
+    [WDB_STMT_GLOBAL_GET_AGENTS_INFO_BY_CONNECTION_STATUS] = "SELECT * FROM agent WHERE id > ? AND connection_status = ? ORDER BY id;",
     [WDB_STMT_TASK_INSERT_TASK] = "INSERT INTO TASKS VALUES(NULL,?,?,?,?,?,?,?,?);",
     [WDB_STMT_TASK_GET_LAST_AGENT_TASK] = "SELECT *, MAX(CREATE_TIME) FROM TASKS WHERE AGENT_ID = ?;",
     [WDB_STMT_TASK_GET_LAST_AGENT_UPGRADE_TASK] = "SELECT *, MAX(CREATE_TIME) FROM TASKS WHERE AGENT_ID = ? AND (COMMAND = 'upgrade' OR COMMAND = 'upgrade_custom');",
     [WDB_STMT_TASK_UPDATE_TASK_STATUS] = "UPDATE TASKS SET STATUS = ?, LAST_UPDATE_TIME = ?, ERROR_MESSAGE = ? WHERE TASK_ID = ?;",
     [WDB_STMT_TASK_GET_TASK_BY_STATUS] = "SELECT * FROM TASKS WHERE STATUS = ?;",
-    [WDB_STMT_TASK_DELETE_OLD_TASKS] = "DELETE FROM TASKS WHERE CREATE_TIME <= ?;",
+    [WDB_STMT_TASK_DELETE_OLD_TASKS] = "DELETE FROM TASKS WHERE TASK_ID IN (SELECT TASK_ID FROM TASKS WHERE CREATE_TIME <= ? LIMIT ?);",
     [WDB_STMT_TASK_DELETE_TASK] = "DELETE FROM TASKS WHERE TASK_ID = ?;",
     [WDB_STMT_TASK_CANCEL_PENDING_UPGRADE_TASKS] = "UPDATE TASKS SET STATUS = '" WM_TASK_STATUS_CANCELLED "', LAST_UPDATE_TIME = ? WHERE NODE = ? AND STATUS = '" WM_TASK_STATUS_PENDING "' AND (COMMAND = 'upgrade' OR COMMAND = 'upgrade_custom');",
     [WDB_STMT_PRAGMA_JOURNAL_WAL] = "PRAGMA journal_mode=WAL;",
@@ -305,6 +312,16 @@ STATIC int wdb_execute_non_select_query(sqlite3 *db, const char *query);
  */
 STATIC int wdb_select_from_temp_table(sqlite3 *db);
 
+/**
+ * @brief Print the current row of a statement as a JSON object, without building it with cJSON.
+ *
+ * @param[in] stmt Statement stepped to a row.
+ * @param[out] buffer Output buffer.
+ * @param[in] size Size of the buffer, including the string terminator.
+ * @return Length of the object printed, or -1 if it does not fit in the buffer.
+ */
+STATIC int wdb_print_row(sqlite3_stmt* stmt, char * buffer, size_t size);
+
 /**
  * @brief Execute a select query that returns a single integer value.
  *
@@ -325,12 +342,47 @@ STATIC int wdb_execute_single_int_select_query(wdb_t * wdb, const char *query, i
  */
 STATIC int wdb_get_last_vacuum_data(wdb_t* wdb, int *last_vacuum_time, int *last_vacuum_value);
 
+/**
+ * @brief Take a database found in the pool and lock it.
+ *
+ * The reference is taken before releasing the pool mutex, so the database cannot be closed
+ * meanwhile. Then the database is locked out of the pool mutex: waiting for a database that
+ * another worker is using does not block the workers that use other databases.
+ *
+ * @param[in] wdb Database found in the pool. The pool mutex must be locked, and it is unlocked.
+ */
+STATIC void wdb_pool_enter(wdb_t * wdb);
+
+/**
+ * @brief Sort a copy of the database pool from the least to the most recently used database.
+ *
+ * @param[in] list Copy of the pool, as returned by wdb_pool_copy().
+ * @return The same nodes, relinked by their last use.
+ */
+STATIC wdb_t * wdb_pool_sort_lru(wdb_t * list);
+
+/**
+ * @brief Close an idle reader of the global database and free its slot.
+ *
+ * @param[in] slot Index of the reader in db_global_readers. The pool mutex must be locked.
+ */
+STATIC void wdb_close_global_reader(int slot);
+
 wdb_config wconfig;
 pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 wdb_t * db_pool_begin;
 wdb_t * db_pool_last;
 int db_pool_size;
 OSHash * open_dbs;
+wdb_t ** db_global_readers;
+
+STATIC void wdb_pool_enter(wdb_t * wdb) {
+    wdb->refcount++;
+    w_mutex_unlock(&pool_mutex);
+
+    // The corresponding w_mutex_unlock(&wdb->mutex) is called in wdb_leave(wdb_t * wdb)
+    w_mutex_lock(&wdb->mutex);
+}
 
 // Opens global database and stores it in DB pool. It returns a locked database or NULL
 wdb_t * wdb_open_global() {
@@ -342,10 +394,7 @@ wdb_t * wdb_open_global() {
 
     // Finds DB in pool
     if (wdb = (wdb_t *)OSHash_Get(open_dbs, WDB_GLOB_NAME), wdb) {
-        // The corresponding w_mutex_unlock(&wdb->mutex) is called in wdb_leave(wdb_t * wdb)
-        w_mutex_lock(&wdb->mutex);
-        wdb->refcount++;
-        w_mutex_unlock(&pool_mutex);
+        wdb_pool_enter(wdb);
         return wdb;
     } else {
         // Try to open DB
@@ -387,6 +436,11 @@ wdb_t * wdb_open_global() {
         }
 
         wdb_enable_foreign_keys(wdb->db);
+
+        // The readers need write-ahead logging, so that they neither block the writer nor are blocked by it
+        if (wconfig.global_readers > 0) {
+            wdb_journal_wal(wdb->db);
+        }
     }
 
     w_mutex_unlock(&pool_mutex);
@@ -403,7 +457,8 @@ wdb_t * wdb_open_mitre() {
     w_mutex_lock(&pool_mutex);
 
     if (wdb = (wdb_t *)OSHash_Get(open_dbs, WDB_MITRE_NAME), wdb) {
-        goto success;
+        wdb_pool_enter(wdb);
+        return wdb;
     }
 
     // Try to open DB
@@ -420,7 +475,6 @@ wdb_t * wdb_open_mitre() {
         wdb_pool_append(wdb);
     }
 
-success:
     w_mutex_lock(&wdb->mutex);
     wdb->refcount++;
 
@@ -429,6 +483,132 @@ end:
     return wdb;
 }
 
+// Opens a read-only connection to the global database. It returns a locked database or NULL
+wdb_t * wdb_open_global_reader() {
+    char path[PATH_MAX + 1] = "";
+    sqlite3 *db = NULL;
+    wdb_t * wdb = NULL;
+    int i;
+
+    if (wconfig.global_readers <= 0) {
+        return NULL;
+    }
+
+    w_mutex_lock(&pool_mutex);
+
+    // The writer must be open first: it upgrades the database and sets the WAL mode
+    if (OSHash_Get(open_dbs, WDB_GLOB_NAME) == NULL) {
+        w_mutex_unlock(&pool_mutex);
+        return NULL;
+    }
+
+    if (db_global_readers == NULL) {
+        os_calloc(wconfig.global_readers, sizeof(wdb_t *), db_global_readers);
+    }
+
+    // Take an idle reader. The disabled ones were left behind by a backup restore
+    for (i = 0; i < wconfig.global_readers; i++) {
+        if (db_global_readers[i] == NULL || db_global_readers[i]->refcount > 0) {
+            continue;
+        }
+
+        if (db_global_readers[i]->enabled) {
+            wdb = db_global_readers[i];
+            wdb_pool_enter(wdb);
+            return wdb;
+        }
+
+        wdb_close_global_reader(i);
+    }
+
+    for (i = 0; i < wconfig.global_readers && db_global_readers[i] != NULL; i++);
+
+    if (i < wconfig.global_readers) {
+        snprintf(path, sizeof(path), "%s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
+
+        if (sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, NULL)) {
+            mdebug1("Can't open a reader for the global database: %s", sqlite3_errmsg(db));
+            sqlite3_close_v2(db);
+            w_mutex_unlock(&pool_mutex);
+            return NULL;
+        }
+
+        wdb = db_global_readers[i] = wdb_init(db, WDB_GLOB_NAME);
+    } else {
+        // Every reader is busy: wait for the one with the fewest users
+        for (i = 0; i < wconfig.global_readers; i++) {
+            if (db_global_readers[i]->enabled && (wdb == NULL || db_global_readers[i]->refcount < wdb->refcount)) {
+                wdb = db_global_readers[i];
+            }
+        }
+
+        if (wdb == NULL) {
+            w_mutex_unlock(&pool_mutex);
+            return NULL;
+        }
+    }
+
+    wdb_pool_enter(wdb);
+    return wdb;
+}
+
+STATIC void wdb_close_global_reader(int slot) {
+    wdb_t * reader = db_global_readers[slot];
+
+    wdb_finalize_all_statements(reader);
+
+    if (sqlite3_close_v2(reader->db) != SQLITE_OK) {
+        merror("DB(%s) wdb_close_global_reader(): %s", reader->id, sqlite3_errmsg(reader->db));
+    }
+
+    wdb_destroy(reader);
+    db_global_readers[slot] = NULL;
+}
+
+void wdb_close_global_readers() {
+    if (db_global_readers == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < wconfig.global_readers; i++) {
+        if (db_global_readers[i] == NULL) {
+            continue;
+        }
+
+        if (db_global_readers[i]->refcount == 0) {
+            wdb_close_global_reader(i);
+        } else {
+            // It is closed when its users release it
+            db_global_readers[i]->enabled = false;
+        }
+    }
+}
+
+/**
+ * @brief Limit the page cache of an agent database to wconfig.agent_cache_size KiB
+ *
+ * Every open agent database keeps its own page cache, so the cache of the whole
+ * pool grows with open_db_limit. 0 keeps the default size of SQLite.
+ *
+ * @param db Agent database connection.
+ */
+STATIC void wdb_set_agent_cache(sqlite3 * db) {
+    char query[64];
+    char * sql_error = NULL;
+
+    if (wconfig.agent_cache_size <= 0) {
+        return;
+    }
+
+    snprintf(query, sizeof(query), "PRAGMA cache_size = -%d;", wconfig.agent_cache_size);
+
+    if (sqlite3_exec(db, query, NULL, NULL, &sql_error) != SQLITE_OK) {
+        mdebug1("Cannot set the cache size of an agent database: %s", sql_error ? sql_error : "unknown error");
+    }
+
+    sqlite3_free(sql_error);
+}
+
 // Open database for agent and store in DB pool. It returns a locked database or NULL
 wdb_t * wdb_open_agent2(int agent_id) {
     char sagent_id[64];
@@ -443,9 +623,13 @@ wdb_t * wdb_open_agent2(int agent_id) {
     w_mutex_lock(&pool_mutex);
 
     if (wdb = (wdb_t *)OSHash_Get(open_dbs, sagent_id), wdb) {
-        goto success;
+        w_inc_db_open(true);
+        wdb_pool_enter(wdb);
+        return wdb;
     }
 
+    w_inc_db_open(false);
+
     // Try to open DB
 
     snprintf(path, sizeof(path), "%s/%s.db", WDB2_DIR, sagent_id);
@@ -467,10 +651,12 @@ wdb_t * wdb_open_agent2(int agent_id) {
             goto end;
         }
 
+        wdb_set_agent_cache(db);
         wdb = wdb_init(db, sagent_id);
         wdb_pool_append(wdb);
     }
     else {
+        wdb_set_agent_cache(db);
         wdb = wdb_init(db, sagent_id);
         wdb_pool_append(wdb);
         wdb = wdb_upgrade(wdb);
@@ -480,7 +666,6 @@ wdb_t * wdb_open_agent2(int agent_id) {
         }
     }
 
-success:
     w_mutex_lock(&wdb->mutex);
     wdb->refcount++;
 
@@ -499,10 +684,7 @@ wdb_t * wdb_open_tasks() {
 
     // Finds DB in pool
     if (wdb = (wdb_t *)OSHash_Get(open_dbs, WDB_TASK_NAME), wdb) {
-        // The corresponding w_mutex_unlock(&wdb->mutex) is called in wdb_leave(wdb_t * wdb)
-        w_mutex_lock(&wdb->mutex);
-        wdb->refcount++;
-        w_mutex_unlock(&pool_mutex);
+        wdb_pool_enter(wdb);
         return wdb;
     } else {
         // Try to open DB
@@ -533,6 +715,7 @@ wdb_t * wdb_open_tasks() {
         else {
             wdb = wdb_init(db, WDB_TASK_NAME);
             wdb_pool_append(wdb);
+            wdb = wdb_upgrade_tasks(wdb);
         }
     }
 
@@ -697,6 +880,7 @@ int wdb_commit2(wdb_t * wdb) {
     }
 
     wdb->transaction = 0;
+    wdb->commit_changes = sqlite3_total_changes(wdb->db);
     return 0;
 }
 
@@ -809,6 +993,43 @@ int wdb_vacuum(sqlite3 *db) {
     return result;
 }
 
+/* Free pages of an incremental auto-vacuum db for up to budget milliseconds. Returns the number of pages freed or OS_INVALID on error. */
+int wdb_incremental_vacuum(sqlite3 *db, int budget, bool *finished) {
+    struct timespec ts_start, ts_now;
+    sqlite3_stmt *stmt;
+    int pages = 0;
+    int result;
+
+    *finished = false;
+
+    if (wdb_prepare(db, SQL_INCREMENTAL_VACUUM, -1, &stmt, NULL)) {
+        mdebug1("SQLite: %s", sqlite3_errmsg(db));
+        return OS_INVALID;
+    }
+
+    gettime(&ts_start);
+
+    // Every step frees a single page. Finalizing the statement early keeps the pages freed so far.
+    while (result = wdb_step(stmt), result == SQLITE_ROW) {
+        pages++;
+        gettime(&ts_now);
+
+        if (time_diff(&ts_start, &ts_now) * 1e3 >= budget) {
+            break;
+        }
+    }
+
+    if (result == SQLITE_DONE) {
+        *finished = true;
+    } else if (result != SQLITE_ROW) {
+        mdebug1("wdb_step(): %s", sqlite3_errmsg(db));
+        pages = OS_INVALID;
+    }
+
+    sqlite3_finalize(stmt);
+    return pages;
+}
+
 /* Calculate the fragmentation state of a db. Returns 0-100 on success or OS_INVALID on error. */
 int wdb_get_db_state(wdb_t * wdb) {
     int result = OS_INVALID;
@@ -968,6 +1189,7 @@ wdb_t * wdb_init(sqlite3 * db, const char * id) {
 }
 
 void wdb_destroy(wdb_t * wdb) {
+    wdbi_checksum_cache_free(wdb);
     os_free(wdb->id);
     w_mutex_destroy(&wdb->mutex);
     free(wdb);
@@ -1025,6 +1247,7 @@ wdb_t * wdb_pool_copy() {
 
     for (wdb_t *i = db_pool_begin; i != NULL; i = i->next) {
         wdb_t * t = wdb_init(NULL, i->id);
+        t->last = i->last;
 
         if (copy == NULL) {
             copy = last = t;
@@ -1037,12 +1260,101 @@ wdb_t * wdb_pool_copy() {
     return copy;
 }
 
+typedef struct wdb_memory_entry_t {
+    const char * id;
+    int cache_used;
+    int schema_used;
+    int stmt_used;
+} wdb_memory_entry_t;
+
+// Add the SQLite memory used by a database to the totals and keep it if it is among the largest.
+static void wdb_pool_memory_add(wdb_t * wdb, wdb_memory_entry_t * largest, unsigned int limit, unsigned int * count, wdb_memory_entry_t * total) {
+    wdb_memory_entry_t entry = { .id = wdb->id };
+    int highwater;
+    unsigned int i;
+
+    if (wdb->db == NULL) {
+        return;
+    }
+
+    sqlite3_db_status(wdb->db, SQLITE_DBSTATUS_CACHE_USED, &entry.cache_used, &highwater, 0);
+    sqlite3_db_status(wdb->db, SQLITE_DBSTATUS_SCHEMA_USED, &entry.schema_used, &highwater, 0);
+    sqlite3_db_status(wdb->db, SQLITE_DBSTATUS_STMT_USED, &entry.stmt_used, &highwater, 0);
+
+    total->cache_used += entry.cache_used;
+    total->schema_used += entry.schema_used;
+    total->stmt_used += entry.stmt_used;
+
+    for (i = *count; i > 0 && largest[i - 1].cache_used < entry.cache_used; i--) {
+        if (i < limit) {
+            largest[i] = largest[i - 1];
+        }
+    }
+
+    if (i < limit) {
+        largest[i] = entry;
+
+        if (*count < limit) {
+            (*count)++;
+        }
+    }
+}
+
+// Get the SQLite memory used by the open databases
+cJSON * wdb_pool_memory_json(unsigned int limit) {
+    wdb_memory_entry_t total = { .id = NULL };
+    wdb_memory_entry_t * largest = NULL;
+    unsigned int count = 0;
+    unsigned int open = 0;
+    cJSON * root = cJSON_CreateObject();
+    cJSON * array = cJSON_CreateArray();
+
+    os_calloc(limit + 1, sizeof(wdb_memory_entry_t), largest);
+
+    w_mutex_lock(&pool_mutex);
+
+    for (wdb_t * i = db_pool_begin; i != NULL; i = i->next) {
+        wdb_pool_memory_add(i, largest, limit, &count, &total);
+        open += i->db != NULL;
+    }
+
+    for (int i = 0; db_global_readers != NULL && i < wconfig.global_readers; i++) {
+        if (db_global_readers[i] != NULL) {
+            wdb_pool_memory_add(db_global_readers[i], largest, limit, &count, &total);
+            open += db_global_readers[i]->db != NULL;
+        }
+    }
+
+    // The ids are owned by the pool, so the array is filled before releasing it.
+    for (unsigned int i = 0; i < count; i++) {
+        cJSON * item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "id", largest[i].id);
+        cJSON_AddNumberToObject(item, "cache_used", largest[i].cache_used);
+        cJSON_AddNumberToObject(item, "schema_used", largest[i].schema_used);
+        cJSON_AddNumberToObject(item, "stmt_used", largest[i].stmt_used);
+        cJSON_AddItemToArray(array, item);
+    }
+
+    w_mutex_unlock(&pool_mutex);
+
+    cJSON_AddNumberToObject(root, "open", open);
+    cJSON_AddNumberToObject(root, "cache_used", total.cache_used);
+    cJSON_AddNumberToObject(root, "schema_used", total.schema_used);
+    cJSON_AddNumberToObject(root, "stmt_used", total.stmt_used);
+    cJSON_AddItemToObject(root, "largest", array);
+
+    os_free(largest);
+    return root;
+}
+
 void wdb_close_all() {
     wdb_t * node;
 
     mdebug1("Closing all databases...");
     w_mutex_lock(&pool_mutex);
 
+    wdb_close_global_readers();
+
     while (node = db_pool_begin, node) {
         mdebug2("Closing database for agent %s", node->id);
 
@@ -1078,15 +1390,28 @@ void wdb_commit_old() {
         time_t cur_time = time(NULL);
 
         // Commit condition: more than commit_time_min seconds elapsed from the last query, or more than commit_time_max elapsed from the transaction began.
+        // A transaction that reaches commit_changes_max changed rows is committed at once, so that bursts are written in bounded groups.
 
-        if (node->transaction && (cur_time - node->last > wconfig.commit_time_min || cur_time - node->transaction_begin_time > wconfig.commit_time_max)) {
-            struct timespec ts_start, ts_end;
+        if (node->transaction) {
+            int changes = sqlite3_total_changes(node->db) - node->commit_changes;
+            bool by_time = cur_time - node->last > wconfig.commit_time_min || cur_time - node->transaction_begin_time > wconfig.commit_time_max;
+            bool by_changes = wconfig.commit_changes_max > 0 && changes >= wconfig.commit_changes_max;
 
-            gettime(&ts_start);
-            wdb_commit2(node);
-            gettime(&ts_end);
+            if (by_time || by_changes) {
+                struct timespec ts_start, ts_end;
+                time_t elapsed = cur_time - node->transaction_begin_time;
+
+                gettime(&ts_start);
+                wdb_commit2(node);
+                gettime(&ts_end);
 
-            mdebug2("Agent '%s' database commited. Time: %.3f ms.", node->id, time_diff(&ts_start, &ts_end) * 1e3);
+                double latency = time_diff(&ts_start, &ts_end);
+                struct timeval tv_latency = { (time_t)latency, (suseconds_t)((latency - (time_t)latency) * 1e6) };
+                w_inc_commit(!by_time, tv_latency);
+
+                mdebug2("Agent '%s' database commited. Changes: %d (%.1f/s). Time: %.3f ms.", node->id, changes,
+                        elapsed > 0 ? (double)changes / elapsed : (double)changes, latency * 1e3);
+            }
         }
 
         w_mutex_unlock(&node->mutex);
@@ -1119,6 +1444,32 @@ void wdb_check_fragmentation() {
         }
 
         w_mutex_lock(&node->mutex);
+
+        if (wconfig.incremental_vacuum_budget > 0) {
+            int auto_vacuum = 0;
+
+            if (wdb_execute_single_int_select_query(node, SQL_SELECT_AUTO_VACUUM, &auto_vacuum) != OS_SUCCESS) {
+                merror("Couldn't get the auto-vacuum mode of the database '%s'", node->id);
+                w_mutex_unlock(&node->mutex);
+                w_mutex_unlock(&pool_mutex);
+                continue;
+            }
+
+            // An incremental database is not rebuilt: its free pages are reclaimed by wdb_incremental_vacuum_idle(),
+            // so the free pages counter is enough and the dbstat scan is skipped.
+            if (auto_vacuum == WDB_AUTO_VACUUM_INCREMENTAL) {
+                if (current_free_pages_percentage = wdb_get_db_free_pages_percentage(node), current_free_pages_percentage == OS_INVALID) {
+                    merror("Couldn't get current state for the database '%s'", node->id);
+                } else if (current_free_pages_percentage >= wconfig.free_pages_percentage) {
+                    node->vacuum_pending = true;
+                }
+
+                w_mutex_unlock(&node->mutex);
+                w_mutex_unlock(&pool_mutex);
+                continue;
+            }
+        }
+
         current_fragmentation = wdb_get_db_state(node);
         current_free_pages_percentage = wdb_get_db_free_pages_percentage(node);
         if (current_fragmentation == OS_INVALID || current_free_pages_percentage == OS_INVALID) {
@@ -1150,6 +1501,11 @@ void wdb_check_fragmentation() {
 
                     wdb_finalize_all_statements(node);
 
+                    // This vacuum converts the database, so that the next ones are incremental
+                    if (wconfig.incremental_vacuum_budget > 0 && wdb_execute_non_select_query(node->db, SQL_SET_AUTO_VACUUM_INCREMENTAL) == OS_INVALID) {
+                        mdebug1("Couldn't set the incremental auto-vacuum mode for the database '%s'", node->id);
+                    }
+
                     gettime(&ts_start);
                     if (wdb_vacuum(node->db) < 0) {
                         merror("Couldn't execute vacuum for the database '%s'", node->id);
@@ -1186,6 +1542,52 @@ void wdb_check_fragmentation() {
     }
 }
 
+void wdb_incremental_vacuum_idle() {
+    wdb_t * node;
+    wdb_t * next;
+
+    w_mutex_lock(&pool_mutex);
+    wdb_t *copy = wdb_pool_copy();
+    w_mutex_unlock(&pool_mutex);
+
+    for (wdb_t *i = copy; i != NULL; wdb_destroy(i), i = next) {
+        next = i->next;
+
+        w_mutex_lock(&pool_mutex);
+        node = (wdb_t *)OSHash_Get(open_dbs, i->id);
+
+        // Only the databases that nobody is using or waiting for are compacted
+        if (node == NULL || !node->vacuum_pending || node->refcount > 0) {
+            w_mutex_unlock(&pool_mutex);
+            continue;
+        }
+
+        wdb_pool_enter(node);
+
+        if (!node->transaction) {
+            struct timespec ts_start, ts_end;
+            bool finished;
+            int pages;
+
+            gettime(&ts_start);
+            pages = wdb_incremental_vacuum(node->db, wconfig.incremental_vacuum_budget, &finished);
+            gettime(&ts_end);
+
+            if (pages == OS_INVALID) {
+                merror("Couldn't execute incremental vacuum for the database '%s'", node->id);
+                node->vacuum_pending = false;
+            } else {
+                mdebug2("Incremental vacuum executed on the '%s' database. Pages: %d. Time: %.3f ms.", node->id, pages, time_diff(&ts_start, &ts_end) * 1e3);
+                node->vacuum_pending = !finished;
+            }
+        }
+
+        // Not wdb_leave(): the database was not used by an agent
+        node->refcount--;
+        w_mutex_unlock(&node->mutex);
+    }
+}
+
 STATIC int wdb_get_last_vacuum_data(wdb_t* wdb, int *last_vacuum_time, int *last_vacuum_value) {
    int result = OS_INVALID;
    cJSON *data = NULL;
@@ -1270,6 +1672,9 @@ void wdb_close_old() {
     wdb_t *copy = wdb_pool_copy();
     w_mutex_unlock(&pool_mutex);
 
+    // The databases unused for the longest time are closed first: the busiest agents keep their connection and prepared statements.
+    copy = wdb_pool_sort_lru(copy);
+
     for (wdb_t *i = copy; i != NULL; wdb_destroy(i), i = next) {
         next = i->next;
 
@@ -1286,7 +1691,10 @@ void wdb_close_old() {
         if (node->refcount == 0 && !node->transaction) {
             w_mutex_unlock(&node->mutex);
             mdebug2("Closing database for agent %s", node->id);
-            wdb_close(node, FALSE);
+
+            if (wdb_close(node, FALSE) == OS_SUCCESS) {
+                w_inc_db_close();
+            }
         } else {
             w_mutex_unlock(&node->mutex);
         }
@@ -1295,6 +1703,45 @@ void wdb_close_old() {
     }
 }
 
+static int wdb_pool_cmp_last(const void * a, const void * b) {
+    time_t last_a = (*(wdb_t * const *)a)->last;
+    time_t last_b = (*(wdb_t * const *)b)->last;
+
+    return (last_a > last_b) - (last_a < last_b);
+}
+
+STATIC wdb_t * wdb_pool_sort_lru(wdb_t * list) {
+    wdb_t ** nodes = NULL;
+    size_t count = 0;
+    size_t n;
+
+    for (wdb_t *i = list; i != NULL; i = i->next) {
+        count++;
+    }
+
+    if (count < 2) {
+        return list;
+    }
+
+    os_calloc(count, sizeof(wdb_t *), nodes);
+
+    for (n = 0; list != NULL; list = list->next) {
+        nodes[n++] = list;
+    }
+
+    qsort(nodes, count, sizeof(wdb_t *), wdb_pool_cmp_last);
+
+    for (n = 0; n < count - 1; n++) {
+        nodes[n]->next = nodes[n + 1];
+    }
+
+    nodes[count - 1]->next = NULL;
+    list = nodes[0];
+    os_free(nodes);
+
+    return list;
+}
+
 int wdb_exec_stmt_silent(sqlite3_stmt* stmt) {
     switch (wdb_step(stmt)) {
     case SQLITE_ROW:
@@ -1392,6 +1839,133 @@ cJSON* wdb_exec_stmt_sized(sqlite3_stmt* stmt, const size_t max_size, int* statu
     return result;
 }
 
+/**
+ * @brief Append raw bytes to a buffer
+ *
+ * @param buffer Output buffer.
+ * @param size Size of the buffer.
+ * @param length Length already written, it is updated.
+ * @param data Bytes to append.
+ * @param data_len Number of bytes.
+ * @return true if the bytes fit, false otherwise.
+ */
+static bool wdb_print_raw(char * buffer, size_t size, size_t * length, const char * data, size_t data_len) {
+    if (*length + data_len >= size) {
+        return false;
+    }
+
+    memcpy(buffer + *length, data, data_len);
+    *length += data_len;
+    return true;
+}
+
+/**
+ * @brief Append a JSON string to a buffer, escaped as cJSON does
+ */
+static bool wdb_print_string(char * buffer, size_t size, size_t * length, const char * str) {
+    if (!wdb_print_raw(buffer, size, length, "\"", 1)) {
+        return false;
+    }
+
+    for (const unsigned char * c = (const unsigned char *)(str ? str : ""); *c; c++) {
+        char escaped[8];
+        size_t escaped_len = 2;
+
+        switch (*c) {
+        case '\"':
+        case '\\':
+            escaped[0] = '\\';
+            escaped[1] = *c;
+            break;
+        case '\b':
+            memcpy(escaped, "\\b", 2);
+            break;
+        case '\f':
+            memcpy(escaped, "\\f", 2);
+            break;
+        case '\n':
+            memcpy(escaped, "\\n", 2);
+            break;
+        case '\r':
+            memcpy(escaped, "\\r", 2);
+            break;
+        case '\t':
+            memcpy(escaped, "\\t", 2);
+            break;
+        default:
+            if (*c < 32) {
+                escaped_len = snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            } else {
+                escaped[0] = *c;
+                escaped_len = 1;
+            }
+        }
+
+        if (!wdb_print_raw(buffer, size, length, escaped, escaped_len)) {
+            return false;
+        }
+    }
+
+    return wdb_print_raw(buffer, size, length, "\"", 1);
+}
+
+/**
+ * @brief Append a JSON number to a buffer, formatted as cJSON does
+ */
+static bool wdb_print_number(char * buffer, size_t size, size_t * length, double value) {
+    char number[32];
+    int number_len;
+
+    if (value * 0 != 0) {
+        number_len = snprintf(number, sizeof(number), "null");
+    } else if (number_len = snprintf(number, sizeof(number), "%1.15g", value), strtod(number, NULL) != value) {
+        number_len = snprintf(number, sizeof(number), "%1.17g", value);
+    }
+
+    return wdb_print_raw(buffer, size, length, number, number_len);
+}
+
+STATIC int wdb_print_row(sqlite3_stmt* stmt, char * buffer, size_t size) {
+    size_t length = 0;
+    bool first = true;
+    int count = sqlite3_column_count(stmt);
+
+    if (!wdb_print_raw(buffer, size, &length, "{", 1)) {
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int type = sqlite3_column_type(stmt, i);
+
+        if (type != SQLITE_INTEGER && type != SQLITE_FLOAT && type != SQLITE_TEXT && type != SQLITE_BLOB) {
+            continue;
+        }
+
+        if ((!first && !wdb_print_raw(buffer, size, &length, ",", 1))
+            || !wdb_print_string(buffer, size, &length, sqlite3_column_name(stmt, i))
+            || !wdb_print_raw(buffer, size, &length, ":", 1)) {
+            return -1;
+        }
+
+        first = false;
+
+        if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+            if (!wdb_print_number(buffer, size, &length, sqlite3_column_double(stmt, i))) {
+                return -1;
+            }
+        } else if (!wdb_print_string(buffer, size, &length, (const char *)sqlite3_column_text(stmt, i))) {
+            return -1;
+        }
+    }
+
+    if (!wdb_print_raw(buffer, size, &length, "}", 1)) {
+        return -1;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
 int wdb_exec_stmt_send(sqlite3_stmt* stmt, int peer) {
     if (!stmt) {
         mdebug1("Invalid SQL statement.");
@@ -1403,41 +1977,66 @@ int wdb_exec_stmt_send(sqlite3_stmt* stmt, int peer) {
     }
 
     int status = OS_SUCCESS;
-    int sql_status = SQLITE_ERROR;
-    cJSON * row = NULL;
-    char* response = NULL;
+    int sql_status;
+    char* chunk = NULL;
+    size_t used = 0;
     // Every row will be the payload of a message with the format "due {payload}"
     const char* header = "due ";
-    int header_size = strlen(header);
-    // Allocating the memory where all the responses will be dumped, it will contain the header+payload
-    os_calloc(OS_MAXSTR, sizeof(char), response);
-    // Coping the "due" header into the response buffer
-    memcpy(response, header, header_size);
-    // Each row is dumped into the payload section of the buffer, so the pointer and the tailing available space for the payload are obtained
-    char* payload = response + header_size;
-    int payload_size = OS_MAXSTR - header_size;
-
-    while ((row = wdb_exec_row_stmt(stmt, &sql_status, STMT_MULTI_COLUMN))) {
-        bool row_fits = cJSON_PrintPreallocated(row, payload, payload_size, FALSE);
-        cJSON_Delete(row);
-        if (row_fits) {
-            if (OS_SendSecureTCP(peer, strlen(response), response) < 0) {
-                merror("Socket %d error: %s (%d)", peer, strerror(errno), errno);
-                status = OS_SOCKTERR;
+    const size_t header_size = strlen(header);
+    // Messages are framed into a chunk as OS_SendSecureTCP() does, and the chunk is sent when it is full
+    os_malloc(WDB_SEND_CHUNK_SIZE, chunk);
+
+    while (sql_status = sqlite3_step(stmt), sql_status == SQLITE_ROW) {
+        int row_len = -1;
+
+        while (true) {
+            char* message = chunk + used + sizeof(uint32_t);
+            size_t available = WDB_SEND_CHUNK_SIZE - used - sizeof(uint32_t) - header_size;
+
+            // A row never takes more than the receiving buffer of the clients
+            if (available > OS_MAXSTR - header_size) {
+                available = OS_MAXSTR - header_size;
+            }
+
+            memcpy(message, header, header_size);
+
+            if (row_len = wdb_print_row(stmt, message + header_size, available), row_len >= 0 || used == 0) {
                 break;
             }
+
+            if (OS_SendSecureTCPFrames(peer, used, chunk) < 0) {
+                break;
+            }
+
+            used = 0;
         }
-        else {
-            merror("SQL row response for statement %s is too big to be sent", sqlite3_sql(stmt));
-            status = OS_SIZELIM;
+
+        if (row_len < 0) {
+            if (used > 0) {
+                merror("Socket %d error: %s (%d)", peer, strerror(errno), errno);
+                status = OS_SOCKTERR;
+            } else {
+                merror("SQL row response for statement %s is too big to be sent", sqlite3_sql(stmt));
+                status = OS_SIZELIM;
+            }
             break;
         }
+
+        *(uint32_t *)(chunk + used) = wnet_order(header_size + row_len);
+        used += sizeof(uint32_t) + header_size + row_len;
+    }
+
+    if (status == OS_SUCCESS && used > 0 && OS_SendSecureTCPFrames(peer, used, chunk) < 0) {
+        merror("Socket %d error: %s (%d)", peer, strerror(errno), errno);
+        status = OS_SOCKTERR;
     }
+
     if (status == OS_SUCCESS && sql_status != SQLITE_DONE) {
+        mdebug1("SQL statement execution failed");
         status = OS_INVALID;
     }
 
-    os_free(response);
+    os_free(chunk);
 
     return status;
 }
@@ -1608,10 +2207,20 @@ int wdb_stmt_cache(wdb_t * wdb, int index) {
         return -1;
     }
     if (!wdb->stmt[index]) {
+        struct timespec ts_start, ts_end;
+
+        gettime(&ts_start);
+
         if (sqlite3_prepare_v2(wdb->db, SQL_STMT[index], -1, wdb->stmt + index, NULL) != SQLITE_OK) {
             merror("DB(%s) sqlite3_prepare_v2() stmt(%d): %s", wdb->id, index, sqlite3_errmsg(wdb->db));
             return -1;
         }
+
+        gettime(&ts_end);
+
+        double elapsed = time_diff(&ts_start, &ts_end);
+        struct timeval tv_elapsed = { (time_t)elapsed, (suseconds_t)((elapsed - (time_t)elapsed) * 1e6) };
+        w_inc_stmt_prepare(tv_elapsed);
     } else {
         sqlite3_reset(wdb->stmt[index]);
         sqlite3_clear_bindings(wdb->stmt[index]);
@@ -1860,6 +2469,9 @@ cJSON* wdb_get_internal_config() {
     cJSON_AddNumberToObject(wazuh_db_config, "free_pages_percentage", wconfig.free_pages_percentage);
     cJSON_AddNumberToObject(wazuh_db_config, "max_fragmentation", wconfig.max_fragmentation);
     cJSON_AddNumberToObject(wazuh_db_config, "check_fragmentation_interval", wconfig.check_fragmentation_interval);
+    cJSON_AddNumberToObject(wazuh_db_config, "incremental_vacuum_budget", wconfig.incremental_vacuum_budget);
+    cJSON_AddNumberToObject(wazuh_db_config, "global_readers", wconfig.global_readers);
+    cJSON_AddNumberToObject(wazuh_db_config, "agent_cache_size", wconfig.agent_cache_size);
 
     cJSON_AddItemToObject(root, "wazuh_db", wazuh_db_config);
 
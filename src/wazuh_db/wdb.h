@@ -106,7 +106,11 @@ typedef enum wdb_global_group_hash_operations_t {
 #define WDB_GROUP_HASH_SIZE        8 /* Size of the groups hash */
 
 #define WDB_BLOCK_SEND_TIMEOUT_S   1 /* Max time in seconds waiting for the client to receive the information sent with a blocking method*/
+#define WDB_SEND_CHUNK_SIZE      (OS_MAXSTR * 2) /* Buffer of the messages sent together with a blocking method */
+#define WDB_BACKUP_STEP_PAGES    256 /* Pages copied per step of an online backup */
+#define WDB_BACKUP_STEP_SLEEP    10 /* Milliseconds between the steps of an online backup, for the writers to commit */
 #define WDB_RESPONSE_OK_SIZE     3
+#define WDB_AUTO_VACUUM_INCREMENTAL 2 /* Value of PRAGMA auto_vacuum in incremental mode */
 
 #define SYSCOLLECTOR_LEGACY_CHECKSUM_VALUE "legacy"
 
@@ -269,6 +273,9 @@ typedef enum wdb_stmt {
     WDB_STMT_GLOBAL_GET_AGENTS_TO_DISCONNECT,
     WDB_STMT_GLOBAL_RESET_CONNECTION_STATUS,
     WDB_STMT_GLOBAL_AGENT_EXISTS,
+    WDB_STMT_GLOBAL_GET_CHANGES,
+    WDB_STMT_GLOBAL_GET_OLDEST_CHANGE,
+    WDB_STMT_GLOBAL_GET_AGENTS_INFO_BY_CONNECTION_STATUS,
     WDB_STMT_TASK_INSERT_TASK,
     WDB_STMT_TASK_GET_LAST_AGENT_TASK,
     WDB_STMT_TASK_GET_LAST_AGENT_UPGRADE_TASK,
@@ -362,10 +369,13 @@ typedef struct wdb_t {
     sqlite3_stmt * stmt[WDB_STMT_SIZE];
     char * id;
     int peer;
-    unsigned int refcount;
+    _Atomic unsigned int refcount;      ///< Users of the database, including the ones waiting for its mutex
     unsigned int transaction:1;
     time_t last;
     time_t transaction_begin_time;
+    int commit_changes;                 ///< Changes of the connection up to the last commit
+    struct wdb_checksum_cache_t * checksum_cache; ///< Last integrity checksum calculated for each component
+    bool vacuum_pending;                ///< Free pages left for wdb_incremental_vacuum_idle(). Only the gc thread uses it
     pthread_mutex_t mutex;
     struct stmt_cache_list *cache_list;
     struct wdb_t * next;
@@ -393,6 +403,11 @@ typedef struct wdb_config {
     int free_pages_percentage;
     int max_fragmentation;
     int check_fragmentation_interval;
+    int pipeline_max;
+    int commit_changes_max;
+    int incremental_vacuum_budget;
+    int global_readers;
+    int agent_cache_size;
     wdb_backup_settings_node** wdb_backup_settings;
 } wdb_config;
 
@@ -418,6 +433,7 @@ typedef enum {
 extern char *schema_global_sql;
 extern char *schema_agents_sql;
 extern char *schema_task_manager_sql;
+extern char *schema_task_manager_upgrade_v2_sql;
 extern char *schema_upgrade_v1_sql;
 extern char *schema_upgrade_v2_sql;
 extern char *schema_upgrade_v3_sql;
@@ -434,6 +450,7 @@ extern char *schema_global_upgrade_v2_sql;
 extern char *schema_global_upgrade_v3_sql;
 extern char *schema_global_upgrade_v4_sql;
 extern char *schema_global_upgrade_v5_sql;
+extern char *schema_global_upgrade_v6_sql;
 
 extern wdb_config wconfig;
 extern pthread_mutex_t pool_mutex;
@@ -519,6 +536,27 @@ struct kv_list {
  */
 wdb_t * wdb_open_global();
 
+/**
+ * @brief Opens a read-only connection to the global database.
+ *
+ * The readers are kept out of the DB pool, up to global_readers connections. They see the
+ * last committed state of the database, and they do not wait for the mutex of the writer.
+ * A reader that opens a read transaction must commit it before leaving, not to stay on an
+ * old snapshot.
+ *
+ * @return wdb_t* Database Structure locked, or NULL if the readers are disabled, the global
+ *         database is not open yet or the reader could not be opened.
+ */
+wdb_t * wdb_open_global_reader();
+
+/**
+ * @brief Closes the readers of the global database.
+ *
+ * The readers in use are disabled, and closed once their users release them.
+ * The pool mutex must be locked.
+ */
+void wdb_close_global_readers();
+
 /**
  * @brief Open mitre database and store in DB poll.
  *
@@ -744,6 +782,16 @@ int wdb_rootcheck_delete(wdb_t * wdb);
  */
 int wdb_vacuum(sqlite3 *db);
 
+/**
+ * @brief Free pages of a database in incremental auto-vacuum mode, for a limited time.
+ *
+ * @param[in] db Database to compact.
+ * @param[in] budget Time limit in milliseconds. At least one page is freed.
+ * @param[out] finished Set to true if the database has no free pages left.
+ * @return Returns the number of pages freed or OS_INVALID on error.
+ */
+int wdb_incremental_vacuum(sqlite3 *db, int budget, bool *finished);
+
 /**
  * @brief Calculate the fragmentation state of a db.
  *
@@ -874,6 +922,17 @@ void wdb_pool_remove(wdb_t * wdb);
  */
 wdb_t * wdb_pool_copy();
 
+/**
+ * @brief Get the SQLite memory used by the open databases
+ *
+ * Sums the page cache, schema and prepared statement memory of the databases
+ * in the pool and the global readers. The pool mutex is held while reading.
+ *
+ * @param limit Maximum number of databases listed in "largest", by cache size.
+ * @return JSON object with the totals and the largest databases.
+ */
+cJSON * wdb_pool_memory_json(unsigned int limit);
+
 void wdb_close_all();
 
 void wdb_commit_old();
@@ -887,6 +946,15 @@ int wdb_remove_database(const char * agent_id);
  */
 void wdb_check_fragmentation();
 
+/**
+ * @brief Runs a time-bounded incremental vacuum on the idle databases with free pages left.
+ *
+ * A database is idle if nobody is using or waiting for it, and it has no transaction open.
+ * Every step lasts up to incremental_vacuum_budget milliseconds, so the compaction of a
+ * large database is spread over several calls.
+ */
+void wdb_incremental_vacuum_idle();
+
 /**
  * @brief Function to execute one row of an SQL statement and save the result in a JSON array.
  *
@@ -945,6 +1013,8 @@ cJSON* wdb_exec_stmt_sized(sqlite3_stmt* stmt, const size_t max_size, int* statu
 /**
  * @brief Function to execute a SQL statement and send the result via TCP socket.
  *        Each row of the SQL response will be sent in a different command.
+ *        Rows are printed straight into a buffer of WDB_SEND_CHUNK_SIZE bytes,
+ *        and the commands that fit in it are sent at once.
  *        This method will continue until SQL_DONE or an error is obtained.
  *        This method could block if the receiver lasts longer in receiving the information.
  *        The block will timeout after the time defined in WDB_BLOCK_SEND_TIMEOUT_S.
@@ -995,6 +1065,19 @@ int wdb_stmt_cache(wdb_t * wdb, int index);
 
 int wdb_parse(char * input, char * output, int peer);
 
+/**
+ * @brief Parse a binary message, see wazuhdb_bin.h.
+ *
+ * Only dbsync deltas have a binary encoding. They are applied like "agent <id> dbsync" queries.
+ *
+ * @param input Message, checked with wdb_bin_is_binary(). It is modified temporarily.
+ * @param length Length of the message.
+ * @param output Response of the query.
+ * @param peer Peer that sent the message.
+ * @return OS_SUCCESS on success, OS_INVALID on error.
+ */
+int wdb_parse_binary(char * input, size_t length, char * output, int peer);
+
 int wdb_parse_syscheck(wdb_t * wdb, wdb_component_t component, char * input, char * output);
 int wdb_parse_syscollector(wdb_t * wdb, const char * query, char * input, char * output);
 
@@ -1105,6 +1188,20 @@ int wdb_parse_agents_set_sys_osinfo_triaged(wdb_t* wdb, char* output);
  */
 int wdb_parse_dbsync(wdb_t * wdb, char * input, char * output);
 
+/**
+ * @brief Function to parse a batch of dbsync deltas of one table, and apply
+ * them in the same transaction.
+ *
+ * Input format: "<table> [{\"operation\":\"INSERTED\",\"data\":{...}},...]"
+ *
+ * @param wdb The agent struct database.
+ * @param input Buffer input
+ * @param output Buffer output, on success the response is "ok" followed by
+ *        an array with the status of each delta, e.g. "ok [true,false]".
+ * @return -1 on error, and 0 on success.
+ */
+int wdb_parse_dbsync_bulk(wdb_t * wdb, char * input, char * output);
+
 /**
  * @brief Function to parse the agent insert request.
  *
@@ -1186,7 +1283,8 @@ int wdb_parse_global_set_agent_labels(wdb_t * wdb, char * input, char * output);
  * @brief Function to parse the update agent keepalive request.
  *
  * @param [in] wdb The global struct database.
- * @param [in] input String with the agent data in JSON format.
+ * @param [in] input String with the agent data in JSON format. It contains either the "id" of an agent
+ *                   or an "ids" array to update a batch of agents with the same status.
  * @param [out] output Response of the query.
  * @return 0 Success: response contains "ok".
  *        -1 On error: response contains "err" and an error description.
@@ -1427,6 +1525,28 @@ int wdb_parse_reset_agents_connection(wdb_t * wdb, char* input, char * output);
  */
 int wdb_parse_global_get_agents_by_connection_status(wdb_t* wdb, char* input, char* output);
 
+/**
+ * @brief Function to parse the get changes request.
+ *
+ * @param [in] wdb The global struct database.
+ * @param [in] input String with 'last_seq' and optionally 'limit'.
+ * @param [out] output Response of the query in JSON format.
+ * @retval 0 Success: Response contains the value.
+ * @retval -1 On error: Response contains details of the error.
+ */
+int wdb_parse_global_get_changes(wdb_t* wdb, char* input, char* output);
+
+/**
+ * @brief Function to parse the get agents info by connection status request.
+ *
+ * @param [in] wdb The global struct database.
+ * @param [in] input String with 'last_id' and 'connection_status'.
+ * @param [out] output Response of the query in JSON format.
+ * @retval 0 Success: Response contains the value.
+ * @retval -1 On error: Response contains details of the error.
+ */
+int wdb_parse_global_get_agents_info_by_connection_status(wdb_t* wdb, char* input, char* output);
+
 /**
  * @brief Function to parse the global backup request.
  *
@@ -1469,9 +1589,25 @@ int wdb_parse_global_restore_backup(wdb_t** wdb, char* input, char* output);
  */
 int wdb_global_create_backup(wdb_t* wdb, char* output, const char* tag);
 
+/**
+ * @brief Function to create a backup of the global.db without holding the global struct database.
+ *
+ * The snapshot is copied through its own read-only connection with the SQLite backup API, a few
+ * pages per step, so that the writers are not blocked during the copy nor during the compression.
+ * The changes not committed yet by the global struct database are not part of the snapshot.
+ *
+ * @param [out] output Response of the query.
+ * @param [in] tag Adds extra information to snapshot file name.
+ * @retval  0 Success: Backup created successfully.
+ * @retval -1 On error: The backup creation failed.
+ */
+int wdb_global_create_backup_online(char* output, const char* tag);
+
 /**
  * @brief Function to delete old backups in case the amount exceeds the max_files limit.
  *
+ * It runs under the lock of the backup folder, right after a new backup is compressed.
+ *
  * @retval  0 Success: The method exited without errors.
  * @retval -1 On error: The method failed in reading the backup folder.
  */
@@ -1528,6 +1664,13 @@ int wdbi_checksum_range(wdb_t * wdb, wdb_component_t component, const char * beg
 
 int wdbi_delete(wdb_t * wdb, wdb_component_t component, const char * begin, const char * end, const char * tail);
 
+/**
+ * @brief Free the integrity checksums cached for a database.
+ *
+ * @param [in] wdb Database node.
+ */
+void wdbi_checksum_cache_free(wdb_t * wdb);
+
 /**
  * @brief Updates the timestamps and counters of a component from sync_info table. It should be called when
  *        the syncronization with the agents is in process, or the checksum sent to the manager is not the same than
@@ -1609,6 +1752,14 @@ wdb_t * wdb_upgrade(wdb_t *wdb);
  */
 wdb_t * wdb_upgrade_global(wdb_t *wdb);
 
+/**
+ * @brief Function to upgrade the tasks DB to the latest version.
+ *
+ * @param [in] wdb The tasks.db database to upgrade.
+ * @return wdb The tasks.db database, updated on success.
+ */
+wdb_t * wdb_upgrade_tasks(wdb_t *wdb);
+
 // Create backup and generate an empty DB
 wdb_t * wdb_backup(wdb_t *wdb, int version);
 
@@ -2257,6 +2408,40 @@ int wdb_global_reset_agents_connection(wdb_t *wdb, const char *sync_status);
  */
 cJSON* wdb_global_get_agents_by_connection_status (wdb_t *wdb, int last_agent_id, const char* connection_status, const char* node_name, int limit, wdbc_result* status);
 
+/**
+ * @brief Function to get the changes of the agents and their groups after a sequence number.
+ *        Every change has its sequence number "seq", the agent "id" and the "operation":
+ *        insert, update, delete or groups. Only the latest changes are kept, and the response
+ *        reports the oldest one as "oldest_seq": a consumer whose last_seq is older than that
+ *        missed changes and must read the agents again.
+ *        Response is prepared in one chunk, if the size of the chunk exceeds WDB_MAX_RESPONSE_SIZE
+ *        parsing stops and reports the changes obtained.
+ *
+ * @param [in] wdb The Global struct database.
+ * @param [in] last_seq Sequence number of the last change already known.
+ * @param [in] limit Limits the number of changes returned. -1 means no limit.
+ * @param [out] status wdbc_result to represent if all changes has being obtained or any error occurred.
+ * @retval JSON with the changes on success.
+ * @retval NULL on error.
+ */
+cJSON* wdb_global_get_changes(wdb_t *wdb, int64_t last_seq, int limit, wdbc_result* status);
+
+/**
+ * @brief Function to get the information of the agents with a connection status, as
+ *        wdb_global_get_agent_info() does for a single agent.
+ *        Response is prepared in one chunk, if the size of the chunk exceeds WDB_MAX_RESPONSE_SIZE
+ *        parsing stops and reports the agents obtained.
+ *        Multiple calls to this function can be required to fully obtain all agents.
+ *
+ * @param [in] wdb The Global struct database.
+ * @param [in] last_agent_id ID where to start querying.
+ * @param [in] connection_status Connection status of the agents requested.
+ * @param [out] status wdbc_result to represent if all agents has being obtained or any error occurred.
+ * @retval JSON with the agents on success.
+ * @retval NULL on error.
+ */
+cJSON* wdb_global_get_agents_info_by_connection_status(wdb_t *wdb, int last_agent_id, const char* connection_status, wdbc_result* status);
+
 /**
  * @brief Gets all the agents' IDs (excluding the manager) that satisfy the keepalive condition to be disconnected.
  *        Response is prepared in one chunk,
@@ -2324,6 +2509,9 @@ bool wdb_delete_dbsync(wdb_t * wdb, struct kv const *kv_value, cJSON *data);
 /**
  * @brief Function to parse the insert upgrade request.
  *
+ * A request with an "agents" array instead of "agent" inserts a task for every
+ * agent and returns a "data" array with the result of each one.
+ *
  * @param [in] wdb The global struct database.
  * @param parameters JSON with the parameters
  * @param command Command to be insert in task
@@ -2347,6 +2535,8 @@ int wdb_parse_task_upgrade_get_status(wdb_t* wdb, const cJSON *parameters, char*
 /**
  * @brief Function to parse the upgrade_update_status request.
  *
+ * Accepts an "agents" array as the insert upgrade request does.
+ *
  * @param [in] wdb The global struct database.
  * @param parameters JSON with the parameters
  * @param [out] output Response of the query.
@@ -2358,6 +2548,8 @@ int wdb_parse_task_upgrade_update_status(wdb_t* wdb, const cJSON *parameters, ch
 /**
  * @brief Function to parse the upgrade_result request.
  *
+ * Accepts an "agents" array as the insert upgrade request does.
+ *
  * @param [in] wdb The global struct database.
  * @param parameters JSON with the parameters
  * @param [out] output Response of the query.
@@ -2391,6 +2583,8 @@ int wdb_parse_task_set_timeout(wdb_t* wdb, const cJSON *parameters, char* output
 /**
  * @brief Function to parse the delete_old request.
  *
+ * An optional "limit" caps the tasks deleted by the request, which reports them in "deleted".
+ *
  * @param [in] wdb The global struct database.
  * @param parameters JSON with the parameters
  * @param [out] output Response of the query.
@@ -2413,6 +2607,9 @@ int wdb_parse_task_delete_old(wdb_t* wdb, const cJSON *parameters, char* output)
  /**
  * @brief Function to parse the vuln_cves insert action.
  *
+ * The input can also be an array of vulnerabilities, then the response has an array with
+ * the result of each one in the same order.
+ *
  * @param [in] wdb The global struct database.
  * @param [in] input String with the the data in json format.
  * @param [out] output Response of the query.
@@ -2459,9 +2656,10 @@ int wdb_task_set_timeout_status(wdb_t* wdb, time_t now, int timeout, time_t *nex
  * Delete old tasks from the tasks DB
  * @param wdb The task struct database
  * @param timestamp Deletion limit time
- * @return OS_SUCCESS on success, OS_INVALID on errors
+ * @param limit Maximum number of tasks to delete, -1 for no limit
+ * @return Number of deleted tasks on success, OS_INVALID on errors
  * */
-int wdb_task_delete_old_entries(wdb_t* wdb, int timestamp);
+int wdb_task_delete_old_entries(wdb_t* wdb, int timestamp, int limit);
 
 /**
  * Insert a new task in the tasks DB.
@@ -41,6 +41,19 @@ static const char *global_db_agent_fields[] = {
 
 static const char *SQL_VACUUM_INTO = "VACUUM INTO ?;";
 
+/* The interval backups no longer run under the global database mutex: this one serializes the files of the backup folder */
+static pthread_mutex_t backup_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Compress a snapshot of global.db into the backup folder, and rotate the old backups.
+ *
+ * @param [in] path Snapshot file. It is removed once compressed.
+ * @param [out] output Response of the query.
+ * @retval  0 Success: Backup created successfully.
+ * @retval -1 On error: The compression failed.
+ */
+static int wdb_global_compress_backup(const char* path, char* output);
+
 int wdb_global_insert_agent(wdb_t *wdb, int id, char* name, char* ip, char* register_ip, char* internal_key, char* group, int date_add) {
     sqlite3_stmt *stmt = NULL;
 
@@ -1952,9 +1965,106 @@ cJSON* wdb_global_get_agents_by_connection_status (wdb_t *wdb, int last_agent_id
     return result;
 }
 
+cJSON* wdb_global_get_agents_info_by_connection_status(wdb_t *wdb, int last_agent_id, const char* connection_status, wdbc_result* status) {
+    sqlite3_stmt* stmt = NULL;
+
+    if (!wdb->transaction && wdb_begin2(wdb) < 0) {
+        mdebug1("Cannot begin transaction");
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+
+    if (wdb_stmt_cache(wdb, WDB_STMT_GLOBAL_GET_AGENTS_INFO_BY_CONNECTION_STATUS) < 0) {
+        mdebug1("Cannot cache statement");
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    stmt = wdb->stmt[WDB_STMT_GLOBAL_GET_AGENTS_INFO_BY_CONNECTION_STATUS];
+
+    if (sqlite3_bind_int(stmt, 1, last_agent_id) != SQLITE_OK) {
+        merror("DB(%s) sqlite3_bind_int(): %s", wdb->id, sqlite3_errmsg(wdb->db));
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    if (sqlite3_bind_text(stmt, 2, connection_status, -1, NULL) != SQLITE_OK) {
+        merror("DB(%s) sqlite3_bind_text(): %s", wdb->id, sqlite3_errmsg(wdb->db));
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+
+    //Execute SQL query limited by size
+    int sql_status = SQLITE_ERROR;
+    cJSON* result = wdb_exec_stmt_sized(stmt, WDB_MAX_RESPONSE_SIZE, &sql_status, STMT_MULTI_COLUMN);
+    if (SQLITE_DONE == sql_status) *status = WDBC_OK;
+    else if (SQLITE_ROW == sql_status) *status = WDBC_DUE;
+    else *status = WDBC_ERROR;
+
+    return result;
+}
+
+cJSON* wdb_global_get_changes(wdb_t *wdb, int64_t last_seq, int limit, wdbc_result* status) {
+    sqlite3_stmt* stmt = NULL;
+    sqlite3_int64 oldest_seq = 0;
+
+    if (!wdb->transaction && wdb_begin2(wdb) < 0) {
+        mdebug1("Cannot begin transaction");
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+
+    // Oldest change kept, so that the consumers know whether they missed any
+    if (wdb_stmt_cache(wdb, WDB_STMT_GLOBAL_GET_OLDEST_CHANGE) < 0) {
+        mdebug1("Cannot cache statement");
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    stmt = wdb->stmt[WDB_STMT_GLOBAL_GET_OLDEST_CHANGE];
+
+    if (wdb_step(stmt) != SQLITE_ROW) {
+        mdebug1("DB(%s) Cannot get the oldest change: %s", wdb->id, sqlite3_errmsg(wdb->db));
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    oldest_seq = sqlite3_column_int64(stmt, 0);
+
+    if (wdb_stmt_cache(wdb, WDB_STMT_GLOBAL_GET_CHANGES) < 0) {
+        mdebug1("Cannot cache statement");
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    stmt = wdb->stmt[WDB_STMT_GLOBAL_GET_CHANGES];
+
+    if (sqlite3_bind_int64(stmt, 1, last_seq) != SQLITE_OK) {
+        merror("DB(%s) sqlite3_bind_int64(): %s", wdb->id, sqlite3_errmsg(wdb->db));
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+    if (sqlite3_bind_int(stmt, 2, limit) != SQLITE_OK) {
+        merror("DB(%s) sqlite3_bind_int(): %s", wdb->id, sqlite3_errmsg(wdb->db));
+        *status = WDBC_ERROR;
+        return NULL;
+    }
+
+    //Execute SQL query limited by size
+    int sql_status = SQLITE_ERROR;
+    cJSON* changes = wdb_exec_stmt_sized(stmt, WDB_MAX_RESPONSE_SIZE, &sql_status, STMT_MULTI_COLUMN);
+    if (SQLITE_DONE == sql_status) *status = WDBC_OK;
+    else if (SQLITE_ROW == sql_status) *status = WDBC_DUE;
+    else *status = WDBC_ERROR;
+
+    if (!changes) {
+        return NULL;
+    }
+
+    cJSON* result = cJSON_CreateObject();
+    cJSON_AddNumberToObject(result, "oldest_seq", oldest_seq);
+    cJSON_AddItemToObject(result, "changes", changes);
+
+    return result;
+}
+
 int wdb_global_create_backup(wdb_t* wdb, char* output, const char* tag) {
     char path[PATH_MAX-3] = {0};
-    char path_compressed[PATH_MAX] = {0};
     int result = OS_INVALID;
     char* timestamp = NULL;
 
@@ -1994,21 +2104,107 @@ int wdb_global_create_backup(wdb_t* wdb, char* output, const char* tag) {
     sqlite3_finalize(stmt);
 
     if (OS_SUCCESS == result) {
-        snprintf(path_compressed, PATH_MAX, "%s.gz", path);
-        result = w_compress_gzfile(path, path_compressed);
+        result = wdb_global_compress_backup(path, output);
+    }
+
+    return result;
+}
+
+int wdb_global_create_backup_online(char* output, const char* tag) {
+    char path[PATH_MAX-3] = {0};
+    char db_path[PATH_MAX + 1] = {0};
+    sqlite3 *source = NULL;
+    sqlite3 *dest = NULL;
+    sqlite3_backup *backup = NULL;
+    char* timestamp = NULL;
+    int pages = WDB_BACKUP_STEP_PAGES;
+    int steps = 0;
+    int status;
+
+    timestamp = w_get_timestamp(time(NULL));
+    wchr_replace(timestamp, ' ', '-');
+    wchr_replace(timestamp, '/', '-');
+    snprintf(path, PATH_MAX-3, "%s/%s-%s%s", WDB_BACKUP_FOLDER, WDB_GLOB_BACKUP_NAME, timestamp, tag ? tag : "");
+    os_free(timestamp);
+
+    snprintf(db_path, sizeof(db_path), "%s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
+
+    if (sqlite3_open_v2(db_path, &source, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+        snprintf(output, OS_MAXSTR + 1, "err Can't open SQLite database '%s': %s", db_path, sqlite3_errmsg(source));
+        sqlite3_close_v2(source);
+        return OS_INVALID;
+    }
+
+    if (sqlite3_open_v2(path, &dest, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) != SQLITE_OK) {
+        snprintf(output, OS_MAXSTR + 1, "err Can't create SQLite database '%s': %s", path, sqlite3_errmsg(dest));
+        sqlite3_close_v2(dest);
+        sqlite3_close_v2(source);
+        return OS_INVALID;
+    }
+
+    if (backup = sqlite3_backup_init(dest, "main", source, "main"), backup == NULL) {
+        snprintf(output, OS_MAXSTR + 1, "err SQLite: %s", sqlite3_errmsg(dest));
+        sqlite3_close_v2(dest);
+        sqlite3_close_v2(source);
         unlink(path);
-        if(OS_SUCCESS == result) {
-            minfo("Created Global database backup \"%s\"", path_compressed);
-            wdb_global_remove_old_backups();
-            cJSON* j_path = cJSON_CreateArray();
-            cJSON_AddItemToArray(j_path, cJSON_CreateString(path_compressed));
-            char* output_str = cJSON_PrintUnformatted(j_path);
-            snprintf(output, OS_MAXSTR + 1, "ok %s", output_str);
-            cJSON_Delete(j_path);
-            os_free(output_str);
-        } else {
-            snprintf(output, OS_MAXSTR + 1, "err Failed during database backup compression");
+        return OS_INVALID;
+    }
+
+    /* Copy a few pages per step, and let the writers commit between steps.
+     * A commit through another connection restarts the copy, so once the
+     * steps are twice the ones needed the rest is copied at once. */
+    do {
+        status = sqlite3_backup_step(backup, pages);
+
+        if (status == SQLITE_OK || status == SQLITE_BUSY || status == SQLITE_LOCKED) {
+            if (++steps > 2 * (sqlite3_backup_pagecount(backup) / WDB_BACKUP_STEP_PAGES + 1)) {
+                pages = -1;
+            }
+
+            sqlite3_sleep(WDB_BACKUP_STEP_SLEEP);
         }
+    } while (status == SQLITE_OK || status == SQLITE_BUSY || status == SQLITE_LOCKED);
+
+    sqlite3_backup_finish(backup);
+
+    if (status != SQLITE_DONE) {
+        snprintf(output, OS_MAXSTR + 1, "err SQLite: %s", sqlite3_errmsg(dest));
+        sqlite3_close_v2(dest);
+        sqlite3_close_v2(source);
+        unlink(path);
+        return OS_INVALID;
+    }
+
+    sqlite3_close_v2(dest);
+    sqlite3_close_v2(source);
+
+    return wdb_global_compress_backup(path, output);
+}
+
+static int wdb_global_compress_backup(const char* path, char* output) {
+    char path_compressed[PATH_MAX] = {0};
+    int result;
+
+    snprintf(path_compressed, PATH_MAX, "%s.gz", path);
+
+    w_mutex_lock(&backup_mutex);
+    result = w_compress_gzfile(path, path_compressed);
+    unlink(path);
+    if(OS_SUCCESS == result) {
+        minfo("Created Global database backup \"%s\"", path_compressed);
+        wdb_global_remove_old_backups();
+    }
+    w_mutex_unlock(&backup_mutex);
+
+    if(OS_SUCCESS == result) {
+        cJSON* j_path = cJSON_CreateArray();
+        cJSON_AddItemToArray(j_path, cJSON_CreateString(path_compressed));
+        char* output_str = cJSON_PrintUnformatted(j_path);
+        snprintf(output, OS_MAXSTR + 1, "ok %s", output_str);
+        cJSON_Delete(j_path);
+        os_free(output_str);
+    } else {
+        snprintf(output, OS_MAXSTR + 1, "err Failed during database backup compression");
     }
 
     return result;
@@ -2104,9 +2300,19 @@ int wdb_global_restore_backup(wdb_t** wdb, char* snapshot, bool save_pre_restore
         snprintf(global_tmp_path, OS_SIZE_256, "%s/%s.db.back", WDB2_DIR, WDB_GLOB_NAME);
         snprintf(backup_to_restore_path, OS_SIZE_256, "%s/%s", WDB_BACKUP_FOLDER, backup_to_restore);
 
-        if (!w_uncompress_gzfile(backup_to_restore_path, global_tmp_path)) {
+        // The rotation of the backups can't remove the snapshot while it is uncompressed
+        w_mutex_lock(&backup_mutex);
+        int uncompressed = w_uncompress_gzfile(backup_to_restore_path, global_tmp_path);
+        w_mutex_unlock(&backup_mutex);
+
+        if (!uncompressed) {
             // Preparing DB for restoration.
+            // The pool is locked until the backup replaces the database, so that neither the writer nor a reader
+            // is opened on the old file. The readers are closed first, so that the writer checkpoints the
+            // write-ahead log as the last connection
             wdb_leave(*wdb);
+            w_mutex_lock(&pool_mutex);
+            wdb_close_global_readers();
             wdb_close(*wdb, true);
             *wdb = NULL;
 
@@ -2120,6 +2326,8 @@ int wdb_global_restore_backup(wdb_t** wdb, char* snapshot, bool save_pre_restore
                 snprintf(output, OS_MAXSTR + 1, "ok");
                 result = OS_SUCCESS;
             }
+
+            w_mutex_unlock(&pool_mutex);
         } else {
             mdebug1("Failed during backup decompression");
             snprintf(output, OS_MAXSTR + 1, "err Failed during backup decompression");
@@ -52,6 +52,135 @@ extern void mock_assert(const int result, const char* const expression,
     mock_assert((int)(expression), #expression, __FILE__, __LINE__);
 #endif
 
+/**
+ * Last checksum calculated for a component. wazuh-db is the only writer of the
+ * agent databases, so it stays valid while the connection makes no changes.
+ */
+typedef struct wdb_checksum_cache_t {
+    bool valid;
+    char * begin;       ///< First element of the range, NULL for the whole table.
+    char * end;         ///< Last element of the range, NULL for the whole table.
+    int changes;        ///< sqlite3_total_changes() when the checksum was calculated.
+    int result;         ///< Result of the calculation: 1 with items, 0 without them.
+    os_sha1 hexdigest;
+} wdb_checksum_cache_t;
+
+static bool wdbi_checksum_cache_key(const char * cached, const char * value) {
+    return cached == value || (cached && value && !strcmp(cached, value));
+}
+
+/**
+ * @brief Get the cached checksum of a component range
+ *
+ * @param[in] wdb Database node.
+ * @param[in] component Name of the component.
+ * @param[in] begin First element.
+ * @param[in] end Last element.
+ * @param[out] hexdigest Cached checksum.
+ * @param[out] result Cached result of the calculation.
+ * @param[out] changes Current changes of the connection, to store the checksum calculated on a miss.
+ * @retval true If the range checksum is cached and no change was made since it was calculated.
+ * @retval false Otherwise.
+ */
+static bool wdbi_checksum_cache_get(wdb_t * wdb, wdb_component_t component, const char * begin, const char * end, os_sha1 hexdigest, int * result, int * changes) {
+    *changes = sqlite3_total_changes(wdb->db);
+
+    if (wdb->checksum_cache == NULL) {
+        return false;
+    }
+
+    wdb_checksum_cache_t * entry = &wdb->checksum_cache[component];
+
+    if (!entry->valid || entry->changes != *changes || !wdbi_checksum_cache_key(entry->begin, begin) || !wdbi_checksum_cache_key(entry->end, end)) {
+        return false;
+    }
+
+    memcpy(hexdigest, entry->hexdigest, sizeof(os_sha1));
+    *result = entry->result;
+    return true;
+}
+
+/**
+ * @brief Store the checksum of a component range
+ *
+ * Nothing is stored if the calculation changed the database, that happens
+ * when it removes duplicated items.
+ *
+ * @param[in] wdb Database node.
+ * @param[in] component Name of the component.
+ * @param[in] begin First element.
+ * @param[in] end Last element.
+ * @param[in] hexdigest Checksum calculated.
+ * @param[in] result Result of the calculation.
+ * @param[in] changes Changes of the connection before the calculation.
+ */
+static void wdbi_checksum_cache_set(wdb_t * wdb, wdb_component_t component, const char * begin, const char * end, const os_sha1 hexdigest, int result, int changes) {
+    if (result < 0 || sqlite3_total_changes(wdb->db) != changes) {
+        return;
+    }
+
+    if (wdb->checksum_cache == NULL) {
+        os_calloc(WDB_GENERIC_COMPONENT, sizeof(wdb_checksum_cache_t), wdb->checksum_cache);
+    }
+
+    wdb_checksum_cache_t * entry = &wdb->checksum_cache[component];
+
+    os_free(entry->begin);
+    os_free(entry->end);
+
+    if (begin) {
+        os_strdup(begin, entry->begin);
+    }
+
+    if (end) {
+        os_strdup(end, entry->end);
+    }
+
+    if (result == 1) {
+        memcpy(entry->hexdigest, hexdigest, sizeof(os_sha1));
+    } else {
+        entry->hexdigest[0] = '\0';
+    }
+
+    entry->changes = changes;
+    entry->result = result;
+    entry->valid = true;
+}
+
+/**
+ * @brief Keep the cached checksum of a component valid after changes made out of its range
+ *
+ * @param[in] wdb Database node.
+ * @param[in] component Name of the component.
+ * @param[in] begin First element.
+ * @param[in] end Last element.
+ * @param[in] changes Changes of the connection before the changes out of the range.
+ */
+static void wdbi_checksum_cache_refresh(wdb_t * wdb, wdb_component_t component, const char * begin, const char * end, int changes) {
+    if (wdb->checksum_cache == NULL) {
+        return;
+    }
+
+    wdb_checksum_cache_t * entry = &wdb->checksum_cache[component];
+
+    if (entry->valid && entry->changes == changes && wdbi_checksum_cache_key(entry->begin, begin) && wdbi_checksum_cache_key(entry->end, end)) {
+        entry->changes = sqlite3_total_changes(wdb->db);
+    }
+}
+
+void wdbi_checksum_cache_free(wdb_t * wdb) {
+    if (wdb->checksum_cache == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < WDB_GENERIC_COMPONENT; i++) {
+        os_free(wdb->checksum_cache[i].begin);
+        os_free(wdb->checksum_cache[i].end);
+    }
+
+    os_free(wdb->checksum_cache);
+}
+
 void wdbi_remove_by_pk(wdb_t *wdb, wdb_component_t component, const char *pk_value) {
     assert(wdb != NULL);
 
@@ -182,6 +311,13 @@ int wdbi_checksum(wdb_t * wdb, wdb_component_t component, os_sha1 hexdigest) {
 
     assert(component < sizeof(INDEXES) / sizeof(int));
 
+    int result;
+    int changes;
+
+    if (wdbi_checksum_cache_get(wdb, component, NULL, NULL, hexdigest, &result, &changes)) {
+        return result;
+    }
+
     if (wdb_stmt_cache(wdb, INDEXES[component]) == -1) {
         mdebug1("Cannot cache statement");
         return -1;
@@ -189,7 +325,9 @@ int wdbi_checksum(wdb_t * wdb, wdb_component_t component, os_sha1 hexdigest) {
 
     sqlite3_stmt * stmt = wdb->stmt[INDEXES[component]];
 
-    return wdb_calculate_stmt_checksum(wdb, stmt, component, hexdigest, NULL);
+    result = wdb_calculate_stmt_checksum(wdb, stmt, component, hexdigest, NULL);
+    wdbi_checksum_cache_set(wdb, component, NULL, NULL, hexdigest, result, changes);
+    return result;
 }
 
 /**
@@ -225,6 +363,13 @@ int wdbi_checksum_range(wdb_t * wdb, wdb_component_t component, const char * beg
 
     assert(component < sizeof(INDEXES) / sizeof(int));
 
+    int result;
+    int changes;
+
+    if (wdbi_checksum_cache_get(wdb, component, begin, end, hexdigest, &result, &changes)) {
+        return result;
+    }
+
     if (wdb_stmt_cache(wdb, INDEXES[component]) == -1) {
         mdebug1("Cannot cache statement");
         return -1;
@@ -240,7 +385,9 @@ int wdbi_checksum_range(wdb_t * wdb, wdb_component_t component, const char * beg
         unique_id = begin;
     }
 
-    return wdb_calculate_stmt_checksum(wdb, stmt, component, hexdigest, unique_id);
+    result = wdb_calculate_stmt_checksum(wdb, stmt, component, hexdigest, unique_id);
+    wdbi_checksum_cache_set(wdb, component, begin, end, hexdigest, result, changes);
+    return result;
 }
 
 /**
@@ -447,7 +594,9 @@ integrity_sync_status_t wdbi_query_checksum(wdb_t * wdb, wdb_component_t compone
         }
     }
 
-    // Update sync status
+    // Update sync status. It only changes items out of the range, so its checksum is still valid.
+    int changes = sqlite3_total_changes(wdb->db);
+
     if (INTEGRITY_CHECK_GLOBAL == action) {
         wdbi_delete(wdb, component, begin, end, NULL);
         switch (status) {
@@ -470,6 +619,8 @@ integrity_sync_status_t wdbi_query_checksum(wdb_t * wdb, wdb_component_t compone
         wdbi_delete(wdb, component, begin, end, cJSON_GetStringValue(item));
     }
 
+    wdbi_checksum_cache_refresh(wdb, component, begin, end, changes);
+
 end:
     cJSON_Delete(data);
     return status;
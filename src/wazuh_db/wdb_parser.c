@@ -10,11 +10,15 @@
  */
 
 #include "wazuhdb_op.h"
+#include "wazuhdb_bin.h"
 #include "wdb.h"
 #include "wdb_agents.h"
 #include "external/cJSON/cJSON.h"
 #include "wdb_state.h"
 
+// Deltas that fit the response of a bulk dbsync query, 6 bytes each
+#define DBSYNC_BULK_MAX ((OS_MAXSTR - 8) / 6)
+
 #define HOTFIXES_FIELD_COUNT 3
 static struct column_list const TABLE_HOTFIXES[HOTFIXES_FIELD_COUNT+1] = {
     { .value = {FIELD_INTEGER, 1, true, false, NULL, "scan_id", {.integer = 0}, true}, .next = &TABLE_HOTFIXES[1] },
@@ -185,6 +189,12 @@ static struct column_list const TABLE_HARDWARE[HARDWARE_FIELD_COUNT+1] = {
     { .value = { FIELD_TEXT, 10, false, false, NULL, "checksum", {.text = ""}, false}, .next = NULL }
 };
 
+/* Global commands of the API and the cluster that can be served by a reader: they only read, and their callers do not need to see the uncommitted changes */
+static const char * GLOBAL_READER_COMMANDS[] = {
+    "get-agent-info", "get-agents-by-connection-status", "get-all-agents", "get-distinct-groups", "get-group-agents",
+    "get-groups-integrity", "get-changes", "get-agents-info-by-connection-status", NULL
+};
+
 static struct kv_list const TABLE_MAP[] = {
     { .current = { "network_iface", "sys_netiface", false, TABLE_NETIFACE, NETIFACE_FIELD_COUNT }, .next = &TABLE_MAP[1]},
     { .current = { "network_protocol", "sys_netproto", false, TABLE_NETPROTO, NETPROTO_FIELD_COUNT }, .next = &TABLE_MAP[2]},
@@ -198,6 +208,70 @@ static struct kv_list const TABLE_MAP[] = {
 };
 
 
+/**
+ * @brief Check whether a global command can be served by a read-only connection.
+ *
+ * @param command Name of the command.
+ * @param args Arguments of the command. It may be NULL.
+ * @return true if the command only reads, false otherwise.
+ */
+static bool wdb_parse_global_reader_command(const char * command, const char * args) {
+    if (strcmp(command, "sql") == 0) {
+        return args != NULL && strncasecmp(args, "select ", 7) == 0;
+    }
+
+    for (int i = 0; GLOBAL_READER_COMMANDS[i]; i++) {
+        if (strcmp(command, GLOBAL_READER_COMMANDS[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Open the database of an agent that is registered in the global database.
+ *
+ * @param agent_id ID of the agent. The registration of the manager (0) is not checked.
+ * @param sagent_id ID of the agent, as text.
+ * @param output Response to write the error into.
+ * @return Database node, or NULL on error.
+ */
+static wdb_t * wdb_parse_open_agent(int agent_id, const char * sagent_id, char * output) {
+    wdb_t * wdb_global;
+    wdb_t * wdb;
+
+    // Don't perform this check if it's a manager.
+    if (agent_id != 0) {
+        if (wdb_global = wdb_open_global(), !wdb_global) {
+            mdebug2("Couldn't open DB global: %s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
+            snprintf(output, OS_MAXSTR + 1, "err Couldn't open DB global");
+            return NULL;
+        } else if (!wdb_global->enabled) {
+            mdebug2("Database disabled: %s/%s.db.", WDB2_DIR, WDB_GLOB_NAME);
+            snprintf(output, OS_MAXSTR + 1, "err DB global disabled.");
+            wdb_leave(wdb_global);
+            return NULL;
+        }
+
+        if (wdb_global_agent_exists(wdb_global, agent_id) <= 0) {
+            mdebug2("No agent with id %s found.", sagent_id);
+            snprintf(output, OS_MAXSTR + 1, "err Agent not found");
+            wdb_leave(wdb_global);
+            return NULL;
+        }
+        wdb_leave(wdb_global);
+    }
+
+    if (wdb = wdb_open_agent2(agent_id), !wdb) {
+        merror("Couldn't open DB for agent '%s'", sagent_id);
+        snprintf(output, OS_MAXSTR + 1, "err Couldn't open DB for agent %d", agent_id);
+        return NULL;
+    }
+
+    return wdb;
+}
+
 int wdb_parse(char * input, char * output, int peer) {
     char * actor;
     char * id;
@@ -207,9 +281,8 @@ int wdb_parse(char * input, char * output, int peer) {
     int agent_id = 0;
     char sagent_id[64] = "000";
     wdb_t * wdb;
-    wdb_t * wdb_global;
+    wdb_t * reader = NULL;
     cJSON * data;
-    char * out;
     int result = 0;
     struct timeval begin;
     struct timeval end;
@@ -262,31 +335,7 @@ int wdb_parse(char * input, char * output, int peer) {
 
         mdebug2("Agent %s query: %s", sagent_id, query);
 
-        // Don't perform this check if it's a manager.
-        if (agent_id != 0) {
-            if (wdb_global = wdb_open_global(), !wdb_global) {
-                mdebug2("Couldn't open DB global: %s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
-                snprintf(output, OS_MAXSTR + 1, "err Couldn't open DB global");
-                return OS_INVALID;
-            } else if (!wdb_global->enabled) {
-                mdebug2("Database disabled: %s/%s.db.", WDB2_DIR, WDB_GLOB_NAME);
-                snprintf(output, OS_MAXSTR + 1, "err DB global disabled.");
-                wdb_leave(wdb_global);
-                return OS_INVALID;
-            }
-
-            if (wdb_global_agent_exists(wdb_global, agent_id) <= 0) {
-                mdebug2("No agent with id %s found.", sagent_id);
-                snprintf(output, OS_MAXSTR + 1, "err Agent not found");
-                wdb_leave(wdb_global);
-                return OS_INVALID;
-            }
-            wdb_leave(wdb_global);
-        }
-
-        if (wdb = wdb_open_agent2(agent_id), !wdb) {
-            merror("Couldn't open DB for agent '%s'", sagent_id);
-            snprintf(output, OS_MAXSTR + 1, "err Couldn't open DB for agent %d", agent_id);
+        if (wdb = wdb_parse_open_agent(agent_id, sagent_id, output), !wdb) {
             return OS_INVALID;
         }
         // Add the current peer to wdb structure
@@ -510,6 +559,20 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_agent_dbsync_time(diff);
             }
+        } else if (strcmp(query, "dbsync_bulk") == 0) {
+            w_inc_agent_dbsync();
+            if (!next) {
+                mdebug1("DB(%s) Invalid DB query syntax.", sagent_id);
+                mdebug2("DB(%s) query error near: %s", sagent_id, query);
+                snprintf(output, OS_MAXSTR + 1, "err Invalid DB query syntax, near '%.32s'", query);
+                result = OS_INVALID;
+            } else {
+                gettimeofday(&begin, 0);
+                result = wdb_parse_dbsync_bulk(wdb, next, output);
+                gettimeofday(&end, 0);
+                timersub(&end, &begin, &diff);
+                w_inc_agent_dbsync_time(diff);
+            }
         } else if (strcmp(query, "ciscat") == 0) {
             w_inc_agent_ciscat();
             if (!next) {
@@ -568,9 +631,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_agent_sql_time(diff);
                 if (data) {
-                    out = cJSON_PrintUnformatted(data);
-                    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-                    os_free(out);
+                    json_snprint(output, OS_MAXSTR + 1, "ok ", data);
                     cJSON_Delete(data);
                 } else {
                     mdebug1("DB(%s) Cannot execute SQL query.", sagent_id);
@@ -697,10 +758,7 @@ int wdb_parse(char * input, char * output, int peer) {
                         } else {
                             cJSON *json_fragmentation = cJSON_CreateObject();
                             cJSON_AddNumberToObject(json_fragmentation, "fragmentation_after_vacuum", fragmentation_after_vacuum);
-                            char *out = cJSON_PrintUnformatted(json_fragmentation);
-                            snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-                            os_free(out);
+                            json_snprint(output, OS_MAXSTR + 1, "ok ", json_fragmentation);
                             cJSON_Delete(json_fragmentation);
                             result = 0;
                         }
@@ -723,10 +781,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 cJSON *json_fragmentation = cJSON_CreateObject();
                 cJSON_AddNumberToObject(json_fragmentation, "fragmentation", state);
                 cJSON_AddNumberToObject(json_fragmentation, "free_pages_percentage", free_pages);
-                char *out = cJSON_PrintUnformatted(json_fragmentation);
-                snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-                os_free(out);
+                json_snprint(output, OS_MAXSTR + 1, "ok ", json_fragmentation);
                 cJSON_Delete(json_fragmentation);
                 result = 0;
             }
@@ -761,9 +816,7 @@ int wdb_parse(char * input, char * output, int peer) {
             gettimeofday(&end, 0);
             timersub(&end, &begin, &diff);
             w_inc_wazuhdb_remove_time(diff);
-            out = cJSON_PrintUnformatted(data);
-            snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-            os_free(out);
+            json_snprint(output, OS_MAXSTR + 1, "ok ", data);
             cJSON_Delete(data);
         } else {
             mdebug1("Invalid DB query syntax.");
@@ -812,9 +865,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_mitre_sql_time(diff);
                 if (data) {
-                    out = cJSON_PrintUnformatted(data);
-                    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-                    os_free(out);
+                    json_snprint(output, OS_MAXSTR + 1, "ok ", data);
                     cJSON_Delete(data);
                 } else {
                     mdebug1("Mitre DB Cannot execute SQL query; err database %s/%s.db: %s", WDB_DIR, WDB_MITRE_NAME, sqlite3_errmsg(wdb->db));
@@ -838,7 +889,16 @@ int wdb_parse(char * input, char * output, int peer) {
 
         mdebug2("Global query: %s", query);
 
-        if (wdb = wdb_open_global(), !wdb) {
+        if (next = wstr_chr(query, ' '), next) {
+            *next++ = '\0';
+        }
+
+        // The read-only commands do not wait for the writers if a reader is available
+        if (wdb_parse_global_reader_command(query, next)) {
+            reader = wdb_open_global_reader();
+        }
+
+        if (wdb = reader ? reader : wdb_open_global(), !wdb) {
             mdebug2("Couldn't open DB global: %s/%s.db", WDB2_DIR, WDB_GLOB_NAME);
             snprintf(output, OS_MAXSTR + 1, "err Couldn't open DB global");
             return OS_INVALID;
@@ -851,10 +911,6 @@ int wdb_parse(char * input, char * output, int peer) {
         // Add the current peer to wdb structure
         wdb->peer = peer;
 
-        if (next = wstr_chr(query, ' '), next) {
-            *next++ = '\0';
-        }
-
         if (strcmp(query, "sql") == 0) {
             w_inc_global_sql();
             if (!next) {
@@ -871,9 +927,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_global_sql_time(diff);
                 if (data) {
-                    out = cJSON_PrintUnformatted(data);
-                    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-                    os_free(out);
+                    json_snprint(output, OS_MAXSTR + 1, "ok ", data);
                     cJSON_Delete(data);
                 } else {
                     mdebug1("Global DB Cannot execute SQL query; err database %s/%s.db: %s", WDB2_DIR, WDB_GLOB_NAME, sqlite3_errmsg(wdb->db));
@@ -1253,6 +1307,34 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_global_agent_get_agents_by_connection_status_time(diff);
             }
+        } else if (strcmp(query, "get-agents-info-by-connection-status") == 0) {
+            w_inc_global_agent_get_agents_info_by_connection_status();
+            if (!next) {
+                mdebug1("Global DB Invalid DB query syntax for get-agents-info-by-connection-status.");
+                mdebug2("Global DB query error near: %s", query);
+                snprintf(output, OS_MAXSTR + 1, "err Invalid DB query syntax, near '%.32s'", query);
+                result = OS_INVALID;
+            } else {
+                gettimeofday(&begin, 0);
+                result = wdb_parse_global_get_agents_info_by_connection_status(wdb, next, output);
+                gettimeofday(&end, 0);
+                timersub(&end, &begin, &diff);
+                w_inc_global_agent_get_agents_info_by_connection_status_time(diff);
+            }
+        } else if (strcmp(query, "get-changes") == 0) {
+            w_inc_global_agent_get_changes();
+            if (!next) {
+                mdebug1("Global DB Invalid DB query syntax for get-changes.");
+                mdebug2("Global DB query error near: %s", query);
+                snprintf(output, OS_MAXSTR + 1, "err Invalid DB query syntax, near '%.32s'", query);
+                result = OS_INVALID;
+            } else {
+                gettimeofday(&begin, 0);
+                result = wdb_parse_global_get_changes(wdb, next, output);
+                gettimeofday(&end, 0);
+                timersub(&end, &begin, &diff);
+                w_inc_global_agent_get_changes_time(diff);
+            }
         } else if (strcmp(query, "backup") == 0) {
             w_inc_global_backup();
             if (!next) {
@@ -1305,10 +1387,7 @@ int wdb_parse(char * input, char * output, int peer) {
                         } else {
                             cJSON *json_fragmentation = cJSON_CreateObject();
                             cJSON_AddNumberToObject(json_fragmentation, "fragmentation_after_vacuum", fragmentation_after_vacuum);
-                            char *out = cJSON_PrintUnformatted(json_fragmentation);
-                            snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-                            os_free(out);
+                            json_snprint(output, OS_MAXSTR + 1, "ok ", json_fragmentation);
                             cJSON_Delete(json_fragmentation);
                             result = 0;
                         }
@@ -1331,10 +1410,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 cJSON *json_fragmentation = cJSON_CreateObject();
                 cJSON_AddNumberToObject(json_fragmentation, "fragmentation", state);
                 cJSON_AddNumberToObject(json_fragmentation, "free_pages_percentage", free_pages);
-                char *out = cJSON_PrintUnformatted(json_fragmentation);
-                snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-                os_free(out);
+                json_snprint(output, OS_MAXSTR + 1, "ok ", json_fragmentation);
                 cJSON_Delete(json_fragmentation);
                 result = 0;
             }
@@ -1347,6 +1423,12 @@ int wdb_parse(char * input, char * output, int peer) {
             snprintf(output, OS_MAXSTR + 1, "err Invalid DB query syntax, near '%.32s'", query);
             result = OS_INVALID;
         }
+
+        // A read transaction left open would keep the reader on an old snapshot
+        if (reader) {
+            wdb_commit2(reader);
+        }
+
         wdb_leave(wdb);
         return result;
     } else if (strcmp(actor, "task") == 0) {
@@ -1584,9 +1666,7 @@ int wdb_parse(char * input, char * output, int peer) {
                 timersub(&end, &begin, &diff);
                 w_inc_task_sql_time(diff);
                 if (data) {
-                    out = cJSON_PrintUnformatted(data);
-                    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-                    os_free(out);
+                    json_snprint(output, OS_MAXSTR + 1, "ok ", data);
                     cJSON_Delete(data);
                 } else {
                     mdebug1("Tasks DB Cannot execute SQL query; err database %s/%s.db: %s", WDB_TASK_DIR, WDB_TASK_NAME, sqlite3_errmsg(wdb->db));
@@ -3444,9 +3524,7 @@ int wdb_parse_agents_get_sys_osinfo(wdb_t* wdb, char* output) {
         snprintf(output, OS_MAXSTR + 1, "err Cannot get sys_osinfo database table information; SQL err: %s", sqlite3_errmsg(wdb->db));
     }
     else {
-        char *out = cJSON_PrintUnformatted(result);
-        snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-        os_free(out);
+        json_snprint(output, OS_MAXSTR + 1, "ok ", result);
         cJSON_Delete(result);
         ret = OS_SUCCESS;
     }
@@ -5034,7 +5112,7 @@ int wdb_parse_global_insert_agent(wdb_t * wdb, char * input, char * output) {
     cJSON *j_group = NULL;
     cJSON *j_date_add = NULL;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when inserting agent.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5091,7 +5169,7 @@ int wdb_parse_global_update_agent_name(wdb_t * wdb, char * input, char * output)
     cJSON *j_id = NULL;
     cJSON *j_name = NULL;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when updating agent name.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5151,7 +5229,7 @@ int wdb_parse_global_update_agent_data(wdb_t * wdb, char * input, char * output)
     cJSON *j_labels = NULL;
     cJSON *j_group_config_status = NULL;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when updating agent version.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5239,7 +5317,6 @@ int wdb_parse_global_update_agent_data(wdb_t * wdb, char * input, char * output)
 int wdb_parse_global_get_agent_labels(wdb_t * wdb, char * input, char * output) {
     int agent_id = 0;
     cJSON *labels = NULL;
-    char *out = NULL;
 
     agent_id = atoi(input);
 
@@ -5249,9 +5326,7 @@ int wdb_parse_global_get_agent_labels(wdb_t * wdb, char * input, char * output)
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(labels);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", labels);
     cJSON_Delete(labels);
 
     return OS_SUCCESS;
@@ -5314,10 +5389,12 @@ int wdb_parse_global_update_agent_keepalive(wdb_t * wdb, char * input, char * ou
     cJSON *agent_data = NULL;
     const char *error = NULL;
     cJSON *j_id = NULL;
+    cJSON *j_ids = NULL;
     cJSON *j_connection_status = NULL;
     cJSON *j_sync_status = NULL;
+    int result = OS_SUCCESS;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when updating agent keepalive.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5325,16 +5402,37 @@ int wdb_parse_global_update_agent_keepalive(wdb_t * wdb, char * input, char * ou
         return OS_INVALID;
     } else {
         j_id = cJSON_GetObjectItem(agent_data, "id");
+        j_ids = cJSON_GetObjectItem(agent_data, "ids");
         j_connection_status = cJSON_GetObjectItem(agent_data, "connection_status");
         j_sync_status = cJSON_GetObjectItem(agent_data, "sync_status");
 
-        if (cJSON_IsNumber(j_id) && cJSON_IsString(j_connection_status) && cJSON_IsString(j_sync_status)) {
+        if ((cJSON_IsNumber(j_id) || cJSON_IsArray(j_ids)) && cJSON_IsString(j_connection_status) && cJSON_IsString(j_sync_status)) {
             // Getting each field
-            int id = j_id->valueint;
             char *connection_status = j_connection_status->valuestring;
             char *sync_status = j_sync_status->valuestring;
+            cJSON *j_item = NULL;
+
+            // A batch of agents is checked before updating any of them
+            cJSON_ArrayForEach(j_item, j_ids) {
+                if (!cJSON_IsNumber(j_item)) {
+                    mdebug1("Global DB Invalid JSON data when updating agent keepalive.");
+                    snprintf(output, OS_MAXSTR + 1, "err Invalid JSON data, near '%.32s'", input);
+                    cJSON_Delete(agent_data);
+                    return OS_INVALID;
+                }
+            }
 
-            if (OS_SUCCESS != wdb_global_update_agent_keepalive(wdb, id, connection_status, sync_status)) {
+            if (cJSON_IsNumber(j_id)) {
+                result = wdb_global_update_agent_keepalive(wdb, j_id->valueint, connection_status, sync_status);
+            } else {
+                cJSON_ArrayForEach(j_item, j_ids) {
+                    if (result = wdb_global_update_agent_keepalive(wdb, j_item->valueint, connection_status, sync_status), OS_SUCCESS != result) {
+                        break;
+                    }
+                }
+            }
+
+            if (OS_SUCCESS != result) {
                 mdebug1("Global DB Cannot execute SQL query; err database %s/%s.db: %s", WDB2_DIR, WDB_GLOB_NAME, sqlite3_errmsg(wdb->db));
                 snprintf(output, OS_MAXSTR + 1, "err Cannot execute Global database query; %s", sqlite3_errmsg(wdb->db));
                 cJSON_Delete(agent_data);
@@ -5362,7 +5460,7 @@ int wdb_parse_global_update_connection_status(wdb_t * wdb, char * input, char *
     cJSON *j_sync_status = NULL;
     cJSON *j_status_code = NULL;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when updating agent connection status.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5409,7 +5507,7 @@ int wdb_parse_global_update_status_code(wdb_t * wdb, char * input, char * output
     cJSON *j_version = NULL;
     cJSON *j_sync_status = NULL;
 
-    agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
+    agent_data = json_arena_parse(input, &error, TRUE);
     if (!agent_data) {
         mdebug1("Global DB Invalid JSON syntax when updating agent status code.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5472,7 +5570,6 @@ int wdb_parse_global_delete_agent(wdb_t * wdb, char * input, char * output) {
 int wdb_parse_global_select_agent_name(wdb_t * wdb, char * input, char * output) {
     int agent_id = 0;
     cJSON *name = NULL;
-    char *out = NULL;
 
     agent_id = atoi(input);
 
@@ -5482,9 +5579,7 @@ int wdb_parse_global_select_agent_name(wdb_t * wdb, char * input, char * output)
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(name);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", name);
     cJSON_Delete(name);
 
     return OS_SUCCESS;
@@ -5493,7 +5588,6 @@ int wdb_parse_global_select_agent_name(wdb_t * wdb, char * input, char * output)
 int wdb_parse_global_select_agent_group(wdb_t * wdb, char * input, char * output) {
     int agent_id = 0;
     cJSON *name = NULL;
-    char *out = NULL;
 
     agent_id = atoi(input);
 
@@ -5503,9 +5597,7 @@ int wdb_parse_global_select_agent_group(wdb_t * wdb, char * input, char * output
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(name);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", name);
     cJSON_Delete(name);
 
     return OS_SUCCESS;
@@ -5517,7 +5609,6 @@ int wdb_parse_global_find_agent(wdb_t * wdb, char * input, char * output) {
     cJSON *j_name = NULL;
     cJSON *j_ip = NULL;
     cJSON *j_id = NULL;
-    char *out = NULL;
 
     agent_data = cJSON_ParseWithOpts(input, &error, TRUE);
     if (!agent_data) {
@@ -5548,9 +5639,7 @@ int wdb_parse_global_find_agent(wdb_t * wdb, char * input, char * output) {
         }
     }
 
-    out = cJSON_PrintUnformatted(j_id);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", j_id);
     cJSON_Delete(j_id);
     cJSON_Delete(agent_data);
 
@@ -5560,7 +5649,6 @@ int wdb_parse_global_find_agent(wdb_t * wdb, char * input, char * output) {
 int wdb_parse_global_find_group(wdb_t * wdb, char * input, char * output) {
     char *group_name = NULL;
     cJSON *group_id = NULL;
-    char *out = NULL;
 
     group_name = input;
 
@@ -5570,9 +5658,7 @@ int wdb_parse_global_find_group(wdb_t * wdb, char * input, char * output) {
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(group_id);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", group_id);
     cJSON_Delete(group_id);
 
     return OS_SUCCESS;
@@ -5604,10 +5690,7 @@ int wdb_parse_global_select_group_belong(wdb_t *wdb, char *input, char *output)
         return OS_INVALID;
     }
 
-    char *out = NULL;
-    out = cJSON_PrintUnformatted(agent_groups);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", agent_groups);
     cJSON_Delete(agent_groups);
 
     return OS_SUCCESS;
@@ -5681,7 +5764,6 @@ int wdb_parse_global_delete_group(wdb_t * wdb, char * input, char * output) {
 
 int wdb_parse_global_select_groups(wdb_t * wdb, char * output) {
     cJSON *groups = NULL;
-    char *out = NULL;
 
     if (groups = wdb_global_select_groups(wdb), !groups) {
         mdebug1("Error getting groups from global.db.");
@@ -5689,9 +5771,7 @@ int wdb_parse_global_select_groups(wdb_t * wdb, char * output) {
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(groups);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", groups);
     cJSON_Delete(groups);
 
     return OS_SUCCESS;
@@ -5870,7 +5950,7 @@ int wdb_parse_global_sync_agent_info_set(wdb_t * wdb, char * input, char * outpu
     * The third arguments is TRUE and it will give an error if the input string
     * contains data after the JSON command
     */
-    root = cJSON_ParseWithOpts(input, &error, TRUE);
+    root = json_arena_parse(input, &error, TRUE);
     if (!root) {
         mdebug1("Global DB Invalid JSON syntax updating unsynced agents.");
         mdebug2("Global DB JSON error near: %s", error);
@@ -5958,9 +6038,7 @@ int wdb_parse_get_groups_integrity(wdb_t* wdb, char* input, char* output) {
         return OS_INVALID;
     }
 
-    char* out = cJSON_PrintUnformatted(j_result);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", j_result);
     cJSON_Delete(j_result);
     return OS_SUCCESS;
 }
@@ -5968,7 +6046,6 @@ int wdb_parse_get_groups_integrity(wdb_t* wdb, char* input, char* output) {
 int wdb_parse_global_get_agent_info(wdb_t* wdb, char* input, char* output) {
     int agent_id = 0;
     cJSON *agent_info = NULL;
-    char *out = NULL;
 
     agent_id = atoi(input);
 
@@ -5978,9 +6055,7 @@ int wdb_parse_global_get_agent_info(wdb_t* wdb, char* input, char* output) {
         return OS_INVALID;
     }
 
-    out = cJSON_PrintUnformatted(agent_info);
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-    os_free(out);
+    json_snprint(output, OS_MAXSTR + 1, "ok ", agent_info);
     cJSON_Delete(agent_info);
 
     return OS_SUCCESS;
@@ -6046,6 +6121,90 @@ int wdb_parse_global_get_agents_by_connection_status(wdb_t* wdb, char* input, ch
     return OS_SUCCESS;
 }
 
+int wdb_parse_global_get_agents_info_by_connection_status(wdb_t* wdb, char* input, char* output) {
+    int last_id = 0;
+    char *connection_status = NULL;
+    char *next = NULL;
+    const char delim[2] = " ";
+    char *savedptr = NULL;
+
+    /* Get last_id*/
+    next = strtok_r(input, delim, &savedptr);
+    if (next == NULL) {
+        mdebug1("Invalid arguments 'last_id' not found.");
+        snprintf(output, OS_MAXSTR + 1, "err Invalid arguments 'last_id' not found");
+        return OS_INVALID;
+    }
+    last_id = atoi(next);
+    /* Get connection status */
+    next = strtok_r(NULL, delim, &savedptr);
+    if (next == NULL) {
+        mdebug1("Invalid arguments 'connection_status' not found.");
+        snprintf(output, OS_MAXSTR + 1, "err Invalid arguments 'connection_status' not found");
+        return OS_INVALID;
+    }
+    connection_status = next;
+
+    // Execute command
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_agents_info_by_connection_status(wdb, last_id, connection_status, &status);
+    if (!result) {
+        mdebug1("Error getting agents information by connection status from global.db.");
+        snprintf(output, OS_MAXSTR + 1, "err Error getting agents information by connection status from global.db.");
+        return OS_INVALID;
+    }
+
+    //Print response
+    char* out = cJSON_PrintUnformatted(result);
+    snprintf(output, OS_MAXSTR + 1, "%s %s",  WDBC_RESULT[status], out);
+
+    cJSON_Delete(result);
+    os_free(out)
+
+    return OS_SUCCESS;
+}
+
+int wdb_parse_global_get_changes(wdb_t* wdb, char* input, char* output) {
+    int64_t last_seq = 0;
+    int limit = -1;
+    char *next = NULL;
+    const char delim[2] = " ";
+    char *savedptr = NULL;
+
+    /* Get last_seq */
+    next = strtok_r(input, delim, &savedptr);
+    if (next == NULL) {
+        mdebug1("Invalid arguments 'last_seq' not found.");
+        snprintf(output, OS_MAXSTR + 1, "err Invalid arguments 'last_seq' not found");
+        return OS_INVALID;
+    }
+    last_seq = strtoll(next, NULL, 10);
+
+    /* Get limit */
+    next = strtok_r(NULL, delim, &savedptr);
+    if (next != NULL) {
+        limit = atoi(next);
+    }
+
+    // Execute command
+    wdbc_result status = WDBC_UNKNOWN;
+    cJSON* result = wdb_global_get_changes(wdb, last_seq, limit, &status);
+    if (!result) {
+        mdebug1("Error getting changes from global.db.");
+        snprintf(output, OS_MAXSTR + 1, "err Error getting changes from global.db.");
+        return OS_INVALID;
+    }
+
+    //Print response
+    char* out = cJSON_PrintUnformatted(result);
+    snprintf(output, OS_MAXSTR + 1, "%s %s",  WDBC_RESULT[status], out);
+
+    cJSON_Delete(result);
+    os_free(out)
+
+    return OS_SUCCESS;
+}
+
 int wdb_parse_global_get_all_agents(wdb_t* wdb, char* input, char* output) {
     int last_id = 0;
     char *next = NULL;
@@ -6209,9 +6368,7 @@ int wdb_parse_global_get_backup(char* output) {
     cJSON* j_backups = wdb_global_get_backups();
 
     if (j_backups) {
-        char* out = cJSON_PrintUnformatted(j_backups);
-        snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-        os_free(out);
+        json_snprint(output, OS_MAXSTR + 1, "ok ", j_backups);
         cJSON_Delete(j_backups);
         return OS_SUCCESS;
     } else {
@@ -6243,19 +6400,36 @@ int wdb_parse_global_restore_backup(wdb_t** wdb, char* input, char* output) {
     return result;
 }
 
+/**
+ * @brief Apply a dbsync delta to a table
+ *
+ * @param wdb Database node.
+ * @param kv_value Table of the delta.
+ * @param operation Operation of the delta: INSERTED, MODIFIED or DELETED.
+ * @param data Fields of the delta.
+ * @return true if the delta was applied, false otherwise.
+ */
+static bool wdb_dbsync_apply(wdb_t * wdb, const struct kv * kv_value, const char * operation, cJSON * data) {
+    bool ret_val = false;
+
+    if (strcmp(operation, "INSERTED") == 0 || strcmp(operation, "MODIFIED") == 0) {
+        ret_val = wdb_upsert_dbsync(wdb, kv_value, data);
+    } else if (strcmp(operation, "DELETED") == 0) {
+        wdb_delete_dbsync(wdb, kv_value, data);
+        ret_val = true;
+    } else {
+        mdebug1("Invalid operation type: %s", operation);
+    }
+
+    return ret_val;
+}
+
 bool process_dbsync_data(wdb_t * wdb, const struct kv * kv_value, const char * operation, const char * raw_data) {
     bool ret_val = false;
     const char * parse_error;
-    cJSON * data = cJSON_ParseWithOpts(raw_data, &parse_error, true);
+    cJSON * data = json_arena_parse(raw_data, &parse_error, true);
     if (NULL != data) {
-        if (strcmp(operation, "INSERTED") == 0 || strcmp(operation, "MODIFIED") == 0) {
-            ret_val = wdb_upsert_dbsync(wdb, kv_value, data);
-        } else if (strcmp(operation, "DELETED") == 0) {
-            wdb_delete_dbsync(wdb, kv_value, data);
-            ret_val = true;
-        } else {
-            mdebug1("Invalid operation type: %s", operation);
-        }
+        ret_val = wdb_dbsync_apply(wdb, kv_value, operation, data);
         cJSON_Delete(data);
     } else {
         mdebug1(DB_DELTA_PARSING_ERR);
@@ -6311,18 +6485,201 @@ int wdb_parse_dbsync(wdb_t * wdb, char * input, char * output) {
     return ret_val;
 }
 
+int wdb_parse_dbsync_bulk(wdb_t * wdb, char * input, char * output) {
+    char *next = NULL;
+    char *table_key = input;
+
+    if (next = strchr(input, ' '), !next || !strlen(next + 1)) {
+        mdebug2("DBSYNC bulk query: %s", input);
+        snprintf(output, OS_MAXSTR + 1, "err Invalid dbsync query syntax, near '%.32s'", input);
+        return OS_INVALID;
+    }
+
+    *next++ = '\0';
+
+    struct kv_list const *head = TABLE_MAP;
+    while (NULL != head && strncmp(head->current.key, table_key, OS_SIZE_256 - 1) != 0) {
+        head = head->next;
+    }
+
+    if (NULL == head) {
+        snprintf(output, OS_MAXSTR + 1, "err Invalid dbsync table, near '%.32s'", table_key);
+        return OS_INVALID;
+    }
+
+    const char * parse_error = NULL;
+    cJSON * deltas = json_arena_parse(next, &parse_error, true);
+
+    if (!cJSON_IsArray(deltas)) {
+        mdebug1(DB_DELTA_PARSING_ERR);
+        mdebug2("JSON error near: %s", deltas ? next : parse_error);
+        snprintf(output, OS_MAXSTR + 1, "err Invalid JSON syntax, near '%.32s'", next);
+        cJSON_Delete(deltas);
+        return OS_INVALID;
+    }
+
+    if (cJSON_GetArraySize(deltas) > DBSYNC_BULK_MAX) {
+        snprintf(output, OS_MAXSTR + 1, "err Too many deltas, the limit is %d", DBSYNC_BULK_MAX);
+        cJSON_Delete(deltas);
+        return OS_INVALID;
+    }
+
+    if (!wdb->transaction && wdb_begin2(wdb) < 0) {
+        mdebug1("DB(%s) Cannot begin transaction.", wdb->id);
+        snprintf(output, OS_MAXSTR + 1, "err Cannot begin transaction");
+        cJSON_Delete(deltas);
+        return OS_INVALID;
+    }
+
+    int length = snprintf(output, OS_MAXSTR + 1, "ok [");
+    cJSON * delta = NULL;
+
+    cJSON_ArrayForEach(delta, deltas) {
+        char * operation = cJSON_GetStringValue(cJSON_GetObjectItem(delta, "operation"));
+        cJSON * data = cJSON_GetObjectItem(delta, "data");
+        bool applied = false;
+
+        if (NULL != operation && cJSON_IsObject(data)) {
+            applied = wdb_dbsync_apply(wdb, &head->current, operation, data);
+        } else {
+            mdebug1(DB_DELTA_PARSING_ERR);
+        }
+
+        length += snprintf(output + length, OS_MAXSTR + 1 - length, "%s%s", delta == deltas->child ? "" : ",", applied ? "true" : "false");
+    }
+
+    snprintf(output + length, OS_MAXSTR + 1 - length, "]");
+    cJSON_Delete(deltas);
+    return OS_SUCCESS;
+}
+
+int wdb_parse_binary(char * input, size_t length, char * output, int peer) {
+    wdb_bin_dbsync_t msg = { .data = NULL };
+    struct kv_list const * head = TABLE_MAP;
+    char sagent_id[64];
+    struct timeval begin;
+    struct timeval end;
+    struct timeval diff;
+    int result = OS_INVALID;
+    wdb_t * wdb;
+
+    w_inc_queries_total();
+
+    if (wdb_bin_get_command(input) != WDB_BIN_DBSYNC) {
+        mdebug1("Invalid binary DB query.");
+        snprintf(output, OS_MAXSTR + 1, "err Invalid binary DB query");
+        return OS_INVALID;
+    }
+
+    w_inc_agent();
+    w_inc_agent_dbsync();
+
+    if (wdb_bin_decode_dbsync(input, length, &msg) < 0) {
+        mdebug1(DB_DELTA_PARSING_ERR);
+        snprintf(output, OS_MAXSTR + 1, "err Invalid binary dbsync query");
+        return OS_INVALID;
+    }
+
+    snprintf(sagent_id, sizeof(sagent_id), "%03d", msg.agent_id);
+    mdebug2("Agent %s binary query: dbsync %s %s", sagent_id, msg.table, msg.operation);
+
+    while (NULL != head && strncmp(head->current.key, msg.table, OS_SIZE_256 - 1) != 0) {
+        head = head->next;
+    }
+
+    if (NULL == head) {
+        snprintf(output, OS_MAXSTR + 1, "err Invalid dbsync table, near '%.32s'", msg.table);
+        goto end;
+    }
+
+    if (wdb = wdb_parse_open_agent(msg.agent_id, sagent_id, output), !wdb) {
+        goto end;
+    }
+
+    wdb->peer = peer;
+
+    gettimeofday(&begin, 0);
+    result = wdb_dbsync_apply(wdb, &head->current, msg.operation, msg.data) ? OS_SUCCESS : OS_INVALID;
+    gettimeofday(&end, 0);
+    timersub(&end, &begin, &diff);
+    w_inc_agent_dbsync_time(diff);
+
+    snprintf(output, OS_MAXSTR + 1, "%s", result == OS_SUCCESS ? "ok " : "err");
+    wdb_leave(wdb);
+
+end:
+    cJSON_Delete(msg.data);
+    return result;
+}
+
+/**
+ * @brief Get the agent IDs of a bulk task request.
+ *
+ * @param parameters JSON with the parameters
+ * @return The "agents" array, or NULL if it's missing or contains anything but numbers.
+ */
+static const cJSON* wdb_parse_task_agents(const cJSON *parameters) {
+    cJSON *agents_json = cJSON_GetObjectItem(parameters, "agents");
+    cJSON *agent_json = NULL;
+
+    if (!cJSON_IsArray(agents_json) || !cJSON_GetArraySize(agents_json)) {
+        return NULL;
+    }
+
+    cJSON_ArrayForEach(agent_json, agents_json) {
+        if (!cJSON_IsNumber(agent_json)) {
+            return NULL;
+        }
+    }
+
+    return agents_json;
+}
+
+/**
+ * @brief Print a task response into the output buffer and free it.
+ *
+ * @param response JSON with the response
+ * @param [out] output Response of the query.
+ */
+static void wdb_parse_task_output(cJSON *response, char *output) {
+    char *out = cJSON_PrintUnformatted(response);
+
+    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
+
+    os_free(out);
+    cJSON_Delete(response);
+}
+
+/**
+ * @brief Insert the upgrade task of an agent and fill its response.
+ *
+ * @return OS_SUCCESS on success, the error of the tasks DB otherwise.
+ */
+static int wdb_parse_task_upgrade_agent(wdb_t* wdb, cJSON *response, int agent_id, const char *node, const char *module, const char *command) {
+    int result = wdb_task_insert_task(wdb, agent_id, node, module, command);
+
+    if (result >= 0) {
+        cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
+        cJSON_AddNumberToObject(response, "task_id", result);
+        result = OS_SUCCESS;
+    } else {
+        cJSON_AddNumberToObject(response, "error", result);
+    }
+
+    return result;
+}
+
 int wdb_parse_task_upgrade(wdb_t* wdb, const cJSON *parameters, const char *command, char* output) {
     int result = OS_INVALID;
-    int agent_id = OS_INVALID;
     char *node = NULL;
     char *module = NULL;
 
     cJSON *agent_id_json = cJSON_GetObjectItem(parameters, "agent");
-    if (!agent_id_json || (agent_id_json->type != cJSON_Number)) {
+    const cJSON *agents_json = wdb_parse_task_agents(parameters);
+    if ((!agent_id_json || (agent_id_json->type != cJSON_Number)) && !agents_json) {
         snprintf(output, OS_MAXSTR + 1, "err Error insert task: 'parsing agent error'");
         return OS_INVALID;
     }
-    agent_id = agent_id_json->valueint;
 
     cJSON *node_json = cJSON_GetObjectItem(parameters, "node");
     if (!node_json || (node_json->type != cJSON_String)) {
@@ -6338,24 +6695,28 @@ int wdb_parse_task_upgrade(wdb_t* wdb, const cJSON *parameters, const char *comm
     }
     module = module_json->valuestring;
 
-    result = wdb_task_insert_task(wdb, agent_id, node, module, command);
-
     cJSON *response = cJSON_CreateObject();
-    char *out = NULL;
 
-    if (result >= 0) {
+    if (agents_json) {
+        // Bulk request: every agent gets its own result
+        cJSON *data = cJSON_CreateArray();
+        cJSON *agent_json = NULL;
+
+        cJSON_ArrayForEach(agent_json, agents_json) {
+            cJSON *agent_response = cJSON_CreateObject();
+            cJSON_AddNumberToObject(agent_response, "agent", agent_json->valueint);
+            wdb_parse_task_upgrade_agent(wdb, agent_response, agent_json->valueint, node, module, command);
+            cJSON_AddItemToArray(data, agent_response);
+        }
+
         cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
-        cJSON_AddNumberToObject(response, "task_id", result);
+        cJSON_AddItemToObject(response, "data", data);
         result = OS_SUCCESS;
     } else {
-        cJSON_AddNumberToObject(response, "error", result);
+        result = wdb_parse_task_upgrade_agent(wdb, response, agent_id_json->valueint, node, module, command);
     }
-    out = cJSON_PrintUnformatted(response);
 
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-    os_free(out);
-    cJSON_Delete(response);
+    wdb_parse_task_output(response, output);
 
     return result;
 }
@@ -6401,19 +6762,31 @@ int wdb_parse_task_upgrade_get_status(wdb_t* wdb, const cJSON *parameters, char*
     return result;
 }
 
+/**
+ * @brief Update the status of the upgrade task of an agent and fill its response.
+ *
+ * @return OS_SUCCESS on success, the error of the tasks DB otherwise.
+ */
+static int wdb_parse_task_upgrade_update_status_agent(wdb_t* wdb, cJSON *response, int agent_id, const char *node, const char *status, const char *error) {
+    int result = wdb_task_update_upgrade_task_status(wdb, agent_id, node, status, error);
+
+    cJSON_AddNumberToObject(response, "error", result);
+
+    return result;
+}
+
 int wdb_parse_task_upgrade_update_status(wdb_t* wdb, const cJSON *parameters, char* output) {
     int result = OS_INVALID;
-    int agent_id = OS_INVALID;
     char *node = NULL;
     char *status = NULL;
     char *error = NULL;
 
     cJSON *agent_id_json = cJSON_GetObjectItem(parameters, "agent");
-    if (!agent_id_json || (agent_id_json->type != cJSON_Number)) {
+    const cJSON *agents_json = wdb_parse_task_agents(parameters);
+    if ((!agent_id_json || (agent_id_json->type != cJSON_Number)) && !agents_json) {
         snprintf(output, OS_MAXSTR + 1, "err Error upgrade update status task: 'parsing agent error'");
         return OS_INVALID;
     }
-    agent_id = agent_id_json->valueint;
 
     cJSON *node_json = cJSON_GetObjectItem(parameters, "node");
     if (!node_json || (node_json->type != cJSON_String)) {
@@ -6434,25 +6807,39 @@ int wdb_parse_task_upgrade_update_status(wdb_t* wdb, const cJSON *parameters, ch
         error = error_json->valuestring;
     }
 
-    result = wdb_task_update_upgrade_task_status(wdb, agent_id, node, status, error);
-
     cJSON *response = cJSON_CreateObject();
-    char *out = NULL;
 
-    cJSON_AddNumberToObject(response, "error", result);
-    out = cJSON_PrintUnformatted(response);
+    if (agents_json) {
+        // Bulk request: every agent gets its own result
+        cJSON *data = cJSON_CreateArray();
+        cJSON *agent_json = NULL;
 
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
+        cJSON_ArrayForEach(agent_json, agents_json) {
+            cJSON *agent_response = cJSON_CreateObject();
+            cJSON_AddNumberToObject(agent_response, "agent", agent_json->valueint);
+            wdb_parse_task_upgrade_update_status_agent(wdb, agent_response, agent_json->valueint, node, status, error);
+            cJSON_AddItemToArray(data, agent_response);
+        }
 
-    os_free(out);
-    cJSON_Delete(response);
+        cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
+        cJSON_AddItemToObject(response, "data", data);
+        result = OS_SUCCESS;
+    } else {
+        result = wdb_parse_task_upgrade_update_status_agent(wdb, response, agent_id_json->valueint, node, status, error);
+    }
+
+    wdb_parse_task_output(response, output);
 
     return result;
 }
 
-int wdb_parse_task_upgrade_result(wdb_t* wdb, const cJSON *parameters, char* output) {
+/**
+ * @brief Get the last upgrade task of an agent and fill its response.
+ *
+ * @return OS_SUCCESS on success, the error of the tasks DB otherwise.
+ */
+static int wdb_parse_task_upgrade_result_agent(wdb_t* wdb, cJSON *response, int agent_id) {
     int result = OS_INVALID;
-    int agent_id = OS_INVALID;
     char *node_result = NULL;
     char *module_result = NULL;
     char *command_result = NULL;
@@ -6461,18 +6848,8 @@ int wdb_parse_task_upgrade_result(wdb_t* wdb, const cJSON *parameters, char* out
     int create_time = OS_INVALID;
     int last_update_time = OS_INVALID;
 
-    cJSON *agent_id_json = cJSON_GetObjectItem(parameters, "agent");
-    if (!agent_id_json || (agent_id_json->type != cJSON_Number)) {
-        snprintf(output, OS_MAXSTR + 1, "err Error upgrade result task: 'parsing agent error'");
-        return OS_INVALID;
-    }
-    agent_id = agent_id_json->valueint;
-
     result = wdb_task_get_upgrade_task_by_agent_id(wdb, agent_id, &node_result, &module_result, &command_result, &status, &error, &create_time, &last_update_time);
 
-    cJSON *response = cJSON_CreateObject();
-    char *out = NULL;
-
     if (result >= 0) {
         cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
         cJSON_AddNumberToObject(response, "task_id", result);
@@ -6487,12 +6864,6 @@ int wdb_parse_task_upgrade_result(wdb_t* wdb, const cJSON *parameters, char* out
     } else {
         cJSON_AddNumberToObject(response, "error", result);
     }
-    out = cJSON_PrintUnformatted(response);
-
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-
-    os_free(out);
-    cJSON_Delete(response);
 
     os_free(node_result);
     os_free(module_result);
@@ -6503,6 +6874,42 @@ int wdb_parse_task_upgrade_result(wdb_t* wdb, const cJSON *parameters, char* out
     return result;
 }
 
+int wdb_parse_task_upgrade_result(wdb_t* wdb, const cJSON *parameters, char* output) {
+    int result = OS_INVALID;
+
+    cJSON *agent_id_json = cJSON_GetObjectItem(parameters, "agent");
+    const cJSON *agents_json = wdb_parse_task_agents(parameters);
+    if ((!agent_id_json || (agent_id_json->type != cJSON_Number)) && !agents_json) {
+        snprintf(output, OS_MAXSTR + 1, "err Error upgrade result task: 'parsing agent error'");
+        return OS_INVALID;
+    }
+
+    cJSON *response = cJSON_CreateObject();
+
+    if (agents_json) {
+        // Bulk request: every agent gets its own result
+        cJSON *data = cJSON_CreateArray();
+        cJSON *agent_json = NULL;
+
+        cJSON_ArrayForEach(agent_json, agents_json) {
+            cJSON *agent_response = cJSON_CreateObject();
+            cJSON_AddNumberToObject(agent_response, "agent", agent_json->valueint);
+            wdb_parse_task_upgrade_result_agent(wdb, agent_response, agent_json->valueint);
+            cJSON_AddItemToArray(data, agent_response);
+        }
+
+        cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
+        cJSON_AddItemToObject(response, "data", data);
+        result = OS_SUCCESS;
+    } else {
+        result = wdb_parse_task_upgrade_result_agent(wdb, response, agent_id_json->valueint);
+    }
+
+    wdb_parse_task_output(response, output);
+
+    return result;
+}
+
 int wdb_parse_task_upgrade_cancel_tasks(wdb_t* wdb, const cJSON *parameters, char* output) {
     int result = OS_INVALID;
     char *node = NULL;
@@ -6574,6 +6981,7 @@ int wdb_parse_task_set_timeout(wdb_t* wdb, const cJSON *parameters, char* output
 int wdb_parse_task_delete_old(wdb_t* wdb, const cJSON *parameters, char* output) {
     int result = OS_INVALID;
     int timestamp = OS_INVALID;
+    int limit = OS_INVALID;
 
     cJSON *timestamp_json = cJSON_GetObjectItem(parameters, "timestamp");
     if (!timestamp_json || (timestamp_json->type != cJSON_Number)) {
@@ -6582,18 +6990,25 @@ int wdb_parse_task_delete_old(wdb_t* wdb, const cJSON *parameters, char* output)
     }
     timestamp = timestamp_json->valueint;
 
-    result = wdb_task_delete_old_entries(wdb, timestamp);
+    // Without a limit, every old task is deleted at once
+    cJSON *limit_json = cJSON_GetObjectItem(parameters, "limit");
+    if (limit_json && (limit_json->type == cJSON_Number)) {
+        limit = limit_json->valueint;
+    }
 
-    cJSON *response = cJSON_CreateObject();
-    char *out = NULL;
+    result = wdb_task_delete_old_entries(wdb, timestamp, limit);
 
-    cJSON_AddNumberToObject(response, "error", result);
-    out = cJSON_PrintUnformatted(response);
+    cJSON *response = cJSON_CreateObject();
 
-    snprintf(output, OS_MAXSTR + 1, "ok %s", out);
+    if (result >= 0) {
+        cJSON_AddNumberToObject(response, "error", OS_SUCCESS);
+        cJSON_AddNumberToObject(response, "deleted", result);
+        result = OS_SUCCESS;
+    } else {
+        cJSON_AddNumberToObject(response, "error", result);
+    }
 
-    os_free(out);
-    cJSON_Delete(response);
+    wdb_parse_task_output(response, output);
 
     return result;
 }
@@ -6623,8 +7038,56 @@ int wdb_parse_vuln_cves(wdb_t* wdb, char* input, char* output) {
     return result;
 }
 
+/**
+ * @brief Inserts one vulnerability of a vuln_cves insert command.
+ *
+ * @param [in] wdb The 'agents' struct database.
+ * @param [in] data JSON object with the vulnerability.
+ * @param [out] result Result of the insertion, NULL if it failed.
+ * @return OS_SUCCESS if the data has the required fields, OS_INVALID otherwise.
+ */
+static int wdb_parse_agents_insert_vuln_cve(wdb_t* wdb, cJSON* data, cJSON** result) {
+    cJSON* j_name = cJSON_GetObjectItem(data, "name");
+    cJSON* j_version = cJSON_GetObjectItem(data, "version");
+    cJSON* j_architecture = cJSON_GetObjectItem(data, "architecture");
+    cJSON* j_cve = cJSON_GetObjectItem(data, "cve");
+    cJSON* j_reference = cJSON_GetObjectItem(data, "reference");
+    cJSON* j_type = cJSON_GetObjectItem(data, "type");
+    cJSON* j_status = cJSON_GetObjectItem(data, "status");
+    cJSON* j_check_pkg_existence = cJSON_GetObjectItem(data, "check_pkg_existence");
+    cJSON* j_severity = cJSON_GetObjectItem(data, "severity");
+    cJSON* j_cvss2_score = cJSON_GetObjectItem(data, "cvss2_score");
+    cJSON* j_cvss3_score = cJSON_GetObjectItem(data, "cvss3_score");
+    cJSON* j_external_references = cJSON_GetObjectItem(data, "external_references");
+    cJSON* j_condition = cJSON_GetObjectItem(data, "condition");
+    cJSON* j_title = cJSON_GetObjectItem(data, "title");
+    cJSON* j_published = cJSON_GetObjectItem(data, "published");
+    cJSON* j_updated = cJSON_GetObjectItem(data, "updated");
+
+    *result = NULL;
+
+    // Required fields
+    if (!cJSON_IsString(j_name) || !cJSON_IsString(j_version) || !cJSON_IsString(j_architecture) ||!cJSON_IsString(j_cve) ||
+        !cJSON_IsString(j_reference) || !cJSON_IsString(j_type) || !cJSON_IsString(j_status) ||!cJSON_IsBool(j_check_pkg_existence)) {
+        mdebug1("Invalid vuln_cves JSON data when inserting vulnerable package. Not compliant with constraints defined in the database.");
+        return OS_INVALID;
+    }
+
+    char* str_external_references = cJSON_PrintUnformatted(j_external_references);
+
+    *result = wdb_agents_insert_vuln_cves(wdb, cJSON_GetStringValue(j_name), cJSON_GetStringValue(j_version), cJSON_GetStringValue(j_architecture), cJSON_GetStringValue(j_cve),
+                                          cJSON_GetStringValue(j_reference), cJSON_GetStringValue(j_type), cJSON_GetStringValue(j_status), (bool)j_check_pkg_existence->valueint,
+                                          cJSON_GetStringValue(j_severity), cJSON_IsNumber(j_cvss2_score) ? j_cvss2_score->valuedouble : 0,
+                                          cJSON_IsNumber(j_cvss3_score) ? j_cvss3_score->valuedouble : 0, str_external_references, cJSON_GetStringValue(j_condition),
+                                          cJSON_GetStringValue(j_title), cJSON_GetStringValue(j_published), cJSON_GetStringValue(j_updated));
+
+    os_free(str_external_references);
+    return OS_SUCCESS;
+}
+
 int wdb_parse_agents_insert_vuln_cves(wdb_t* wdb, char* input, char* output) {
     cJSON *data = NULL;
+    cJSON *result = NULL;
     const char *error = NULL;
     int ret = OS_INVALID;
 
@@ -6634,50 +7097,33 @@ int wdb_parse_agents_insert_vuln_cves(wdb_t* wdb, char* input, char* output) {
         mdebug2("JSON error near: %s", error);
         snprintf(output, OS_MAXSTR + 1, "err Invalid JSON syntax, near '%.32s'", input);
     }
-    else {
-        cJSON* j_name = cJSON_GetObjectItem(data, "name");
-        cJSON* j_version = cJSON_GetObjectItem(data, "version");
-        cJSON* j_architecture = cJSON_GetObjectItem(data, "architecture");
-        cJSON* j_cve = cJSON_GetObjectItem(data, "cve");
-        cJSON* j_reference = cJSON_GetObjectItem(data, "reference");
-        cJSON* j_type = cJSON_GetObjectItem(data, "type");
-        cJSON* j_status = cJSON_GetObjectItem(data, "status");
-        cJSON* j_check_pkg_existence = cJSON_GetObjectItem(data, "check_pkg_existence");
-        cJSON* j_severity = cJSON_GetObjectItem(data, "severity");
-        cJSON* j_cvss2_score = cJSON_GetObjectItem(data, "cvss2_score");
-        cJSON* j_cvss3_score = cJSON_GetObjectItem(data, "cvss3_score");
-        cJSON* j_external_references = cJSON_GetObjectItem(data, "external_references");
-        cJSON* j_condition = cJSON_GetObjectItem(data, "condition");
-        cJSON* j_title = cJSON_GetObjectItem(data, "title");
-        cJSON* j_published = cJSON_GetObjectItem(data, "published");
-        cJSON* j_updated = cJSON_GetObjectItem(data, "updated");
-
-        // Required fields
-        if (!cJSON_IsString(j_name) || !cJSON_IsString(j_version) || !cJSON_IsString(j_architecture) ||!cJSON_IsString(j_cve) ||
-            !cJSON_IsString(j_reference) || !cJSON_IsString(j_type) || !cJSON_IsString(j_status) ||!cJSON_IsBool(j_check_pkg_existence)) {
-            mdebug1("Invalid vuln_cves JSON data when inserting vulnerable package. Not compliant with constraints defined in the database.");
-            snprintf(output, OS_MAXSTR + 1, "err Invalid JSON data, missing required fields");
-        } else {
-            char* str_external_references = cJSON_PrintUnformatted(j_external_references);
-
-            cJSON* result = wdb_agents_insert_vuln_cves(wdb, cJSON_GetStringValue(j_name), cJSON_GetStringValue(j_version), cJSON_GetStringValue(j_architecture), cJSON_GetStringValue(j_cve),
-                                                        cJSON_GetStringValue(j_reference), cJSON_GetStringValue(j_type), cJSON_GetStringValue(j_status), (bool)j_check_pkg_existence->valueint,
-                                                        cJSON_GetStringValue(j_severity), cJSON_IsNumber(j_cvss2_score) ? j_cvss2_score->valuedouble : 0,
-                                                        cJSON_IsNumber(j_cvss3_score) ? j_cvss3_score->valuedouble : 0, str_external_references, cJSON_GetStringValue(j_condition),
-                                                        cJSON_GetStringValue(j_title), cJSON_GetStringValue(j_published), cJSON_GetStringValue(j_updated));
+    else if (cJSON_IsArray(data)) {
+        // A batch of vulnerabilities gets a result per vulnerability, in the same order
+        cJSON *results = cJSON_CreateArray();
+        cJSON *item = NULL;
 
-            if (result) {
-                char *out = cJSON_PrintUnformatted(result);
-                snprintf(output, OS_MAXSTR + 1, "ok %s", out);
-                os_free(out);
-                cJSON_Delete(result);
-                ret = OS_SUCCESS;
-            } else {
-                mdebug1("Error inserting vulnerability in vuln_cves.");
-                snprintf(output, OS_MAXSTR + 1, "err Error inserting vulnerability in vuln_cves.");
+        cJSON_ArrayForEach(item, data) {
+            if (wdb_parse_agents_insert_vuln_cve(wdb, item, &result) == OS_INVALID || !result) {
+                result = cJSON_CreateObject();
+                cJSON_AddStringToObject(result, "status", "ERROR");
             }
-            os_free(str_external_references);
+            cJSON_AddItemToArray(results, result);
         }
+
+        json_snprint(output, OS_MAXSTR + 1, "ok ", results);
+        cJSON_Delete(results);
+        ret = OS_SUCCESS;
+    }
+    else if (wdb_parse_agents_insert_vuln_cve(wdb, data, &result) == OS_INVALID) {
+        snprintf(output, OS_MAXSTR + 1, "err Invalid JSON data, missing required fields");
+    }
+    else if (result) {
+        json_snprint(output, OS_MAXSTR + 1, "ok ", result);
+        cJSON_Delete(result);
+        ret = OS_SUCCESS;
+    } else {
+        mdebug1("Error inserting vulnerability in vuln_cves.");
+        snprintf(output, OS_MAXSTR + 1, "err Error inserting vulnerability in vuln_cves.");
     }
 
     cJSON_Delete(data);
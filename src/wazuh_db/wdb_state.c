@@ -658,6 +658,30 @@ void w_inc_global_agent_get_agents_by_connection_status_time(struct timeval time
     w_mutex_unlock(&db_state_t_mutex);
 }
 
+void w_inc_global_agent_get_changes() {
+    w_mutex_lock(&db_state_t_mutex);
+    wdb_state.queries_breakdown.global_breakdown.agent.get_changes_queries++;
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_global_agent_get_changes_time(struct timeval time) {
+    w_mutex_lock(&db_state_t_mutex);
+    timeradd(&wdb_state.queries_breakdown.global_breakdown.agent.get_changes_time, &time, &wdb_state.queries_breakdown.global_breakdown.agent.get_changes_time);
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_global_agent_get_agents_info_by_connection_status() {
+    w_mutex_lock(&db_state_t_mutex);
+    wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_queries++;
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_global_agent_get_agents_info_by_connection_status_time(struct timeval time) {
+    w_mutex_lock(&db_state_t_mutex);
+    timeradd(&wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time, &time, &wdb_state.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time);
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
 void w_inc_global_agent_disconnect_agents() {
     w_mutex_lock(&db_state_t_mutex);
     wdb_state.queries_breakdown.global_breakdown.agent.disconnect_agents_queries++;
@@ -970,6 +994,53 @@ void w_inc_mitre_sql_time(struct timeval time) {
     w_mutex_unlock(&db_state_t_mutex);
 }
 
+void w_inc_commit(bool by_changes, struct timeval time) {
+    static const uint64_t bounds[WDB_COMMIT_LATENCY_BUCKETS - 1] = { 1, 10, 100, 1000 };
+    uint64_t millis = timeval_to_milis(time);
+    int bucket = 0;
+
+    while (bucket < WDB_COMMIT_LATENCY_BUCKETS - 1 && millis >= bounds[bucket]) {
+        bucket++;
+    }
+
+    w_mutex_lock(&db_state_t_mutex);
+    wdb_state.commits_total++;
+
+    if (by_changes) {
+        wdb_state.commits_breakdown.changes_commits++;
+    } else {
+        wdb_state.commits_breakdown.time_commits++;
+    }
+
+    wdb_state.commits_breakdown.latency[bucket]++;
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_db_open(bool hit) {
+    w_mutex_lock(&db_state_t_mutex);
+
+    if (hit) {
+        wdb_state.databases_breakdown.open_hits++;
+    } else {
+        wdb_state.databases_breakdown.open_misses++;
+    }
+
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_db_close() {
+    w_mutex_lock(&db_state_t_mutex);
+    wdb_state.databases_breakdown.closed++;
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
+void w_inc_stmt_prepare(struct timeval time) {
+    w_mutex_lock(&db_state_t_mutex);
+    wdb_state.databases_breakdown.prepared_statements++;
+    timeradd(&wdb_state.databases_breakdown.prepare_time, &time, &wdb_state.databases_breakdown.prepare_time);
+    w_mutex_unlock(&db_state_t_mutex);
+}
+
 cJSON* wdb_create_state_json() {
     wdb_state_t wdb_state_cpy;
 
@@ -988,6 +1059,60 @@ cJSON* wdb_create_state_json() {
 
     // Fields within metrics are sorted alphabetically
 
+    cJSON *_commits = cJSON_CreateObject();
+    cJSON_AddItemToObject(_metrics, "commits", _commits);
+
+    cJSON_AddNumberToObject(_commits, "total", wdb_state_cpy.commits_total);
+
+    cJSON *_commits_breakdown = cJSON_CreateObject();
+    cJSON_AddItemToObject(_commits, "total_breakdown", _commits_breakdown);
+
+    cJSON_AddNumberToObject(_commits_breakdown, "changes", wdb_state_cpy.commits_breakdown.changes_commits);
+    cJSON_AddNumberToObject(_commits_breakdown, "time", wdb_state_cpy.commits_breakdown.time_commits);
+
+    cJSON *_commits_latency = cJSON_CreateObject();
+    cJSON_AddItemToObject(_commits, "latency", _commits_latency);
+
+    cJSON_AddNumberToObject(_commits_latency, "1ms", wdb_state_cpy.commits_breakdown.latency[0]);
+    cJSON_AddNumberToObject(_commits_latency, "10ms", wdb_state_cpy.commits_breakdown.latency[1]);
+    cJSON_AddNumberToObject(_commits_latency, "100ms", wdb_state_cpy.commits_breakdown.latency[2]);
+    cJSON_AddNumberToObject(_commits_latency, "1s", wdb_state_cpy.commits_breakdown.latency[3]);
+    cJSON_AddNumberToObject(_commits_latency, "slower", wdb_state_cpy.commits_breakdown.latency[4]);
+
+    cJSON *_databases = cJSON_CreateObject();
+    cJSON_AddItemToObject(_metrics, "databases", _databases);
+
+    cJSON_AddNumberToObject(_databases, "closed", wdb_state_cpy.databases_breakdown.closed);
+
+    cJSON *_databases_open = cJSON_CreateObject();
+    cJSON_AddItemToObject(_databases, "open", _databases_open);
+
+    cJSON_AddNumberToObject(_databases_open, "hits", wdb_state_cpy.databases_breakdown.open_hits);
+    cJSON_AddNumberToObject(_databases_open, "misses", wdb_state_cpy.databases_breakdown.open_misses);
+
+    cJSON *_databases_statements = cJSON_CreateObject();
+    cJSON_AddItemToObject(_databases, "statements", _databases_statements);
+
+    cJSON_AddNumberToObject(_databases_statements, "prepared", wdb_state_cpy.databases_breakdown.prepared_statements);
+    cJSON_AddNumberToObject(_databases_statements, "time", timeval_to_milis(wdb_state_cpy.databases_breakdown.prepare_time));
+
+    cJSON *_memory = cJSON_CreateObject();
+    cJSON_AddItemToObject(_metrics, "memory", _memory);
+
+    cJSON_AddItemToObject(_memory, "databases", wdb_pool_memory_json(WDB_STATE_MEMORY_LARGEST));
+
+    cJSON *_memory_sqlite = cJSON_CreateObject();
+    cJSON_AddItemToObject(_memory, "sqlite", _memory_sqlite);
+
+    cJSON_AddNumberToObject(_memory_sqlite, "used", sqlite3_memory_used());
+    cJSON_AddNumberToObject(_memory_sqlite, "highwater", sqlite3_memory_highwater(0));
+
+    cJSON *_memory_heap = w_mem_heap_to_json();
+
+    if (_memory_heap != NULL) {
+        cJSON_AddItemToObject(_memory, "heap", _memory_heap);
+    }
+
     cJSON *_queries = cJSON_CreateObject();
     cJSON_AddItemToObject(_metrics, "queries", _queries);
 
@@ -1097,6 +1222,8 @@ cJSON* wdb_create_state_json() {
     cJSON_AddNumberToObject(_global_tables_agent, "find-agent", wdb_state_cpy.queries_breakdown.global_breakdown.agent.find_agent_queries);
     cJSON_AddNumberToObject(_global_tables_agent, "get-agent-info", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agent_info_queries);
     cJSON_AddNumberToObject(_global_tables_agent, "get-agents-by-connection-status", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_queries);
+    cJSON_AddNumberToObject(_global_tables_agent, "get-changes", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_changes_queries);
+    cJSON_AddNumberToObject(_global_tables_agent, "get-agents-info-by-connection-status", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_queries);
     cJSON_AddNumberToObject(_global_tables_agent, "get-all-agents", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_all_agents_queries);
     cJSON_AddNumberToObject(_global_tables_agent, "get-distinct-groups", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_distinct_groups_queries);
     cJSON_AddNumberToObject(_global_tables_agent, "get-groups-integrity", wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_groups_integrity_queries);
@@ -1287,6 +1414,8 @@ cJSON* wdb_create_state_json() {
     cJSON_AddNumberToObject(_global_tables_agent_t, "find-agent", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.find_agent_time));
     cJSON_AddNumberToObject(_global_tables_agent_t, "get-agent-info", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agent_info_time));
     cJSON_AddNumberToObject(_global_tables_agent_t, "get-agents-by-connection-status", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_time));
+    cJSON_AddNumberToObject(_global_tables_agent_t, "get-changes", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_changes_time));
+    cJSON_AddNumberToObject(_global_tables_agent_t, "get-agents-info-by-connection-status", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time));
     cJSON_AddNumberToObject(_global_tables_agent_t, "get-all-agents", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_all_agents_time));
     cJSON_AddNumberToObject(_global_tables_agent_t, "get-distinct-groups", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_distinct_groups_time));
     cJSON_AddNumberToObject(_global_tables_agent_t, "get-groups-integrity", timeval_to_milis(wdb_state_cpy.queries_breakdown.global_breakdown.agent.get_groups_integrity_time));
@@ -1431,6 +1560,8 @@ STATIC uint64_t get_global_time(wdb_state_t *state){
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.get_all_agents_time, &task_time);
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.get_distinct_groups_time, &task_time);
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.get_agents_by_connection_status_time, &task_time);
+    timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.get_changes_time, &task_time);
+    timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.get_agents_info_by_connection_status_time, &task_time);
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.disconnect_agents_time, &task_time);
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.sync_agent_info_get_time, &task_time);
     timeradd(&task_time, &state->queries_breakdown.global_breakdown.agent.sync_agent_info_set_time, &task_time);
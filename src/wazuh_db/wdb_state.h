@@ -124,6 +124,8 @@ typedef struct _global_agent_t {
     uint64_t find_agent_queries;
     uint64_t get_agent_info_queries;
     uint64_t get_agents_by_connection_status_queries;
+    uint64_t get_changes_queries;
+    uint64_t get_agents_info_by_connection_status_queries;
     uint64_t get_all_agents_queries;
     uint64_t get_distinct_groups_queries;
     uint64_t get_groups_integrity_queries;
@@ -145,6 +147,8 @@ typedef struct _global_agent_t {
     struct timeval find_agent_time;
     struct timeval get_agent_info_time;
     struct timeval get_agents_by_connection_status_time;
+    struct timeval get_changes_time;
+    struct timeval get_agents_info_by_connection_status_time;
     struct timeval get_all_agents_time;
     struct timeval get_distinct_groups_time;
     struct timeval get_groups_integrity_time;
@@ -249,10 +253,33 @@ typedef struct _queries_breakdown_t {
     wazuhdb_breakdown_t wazuhdb_breakdown;
 } queries_breakdown_t;
 
+/* Databases listed by their SQLite cache size in the memory metrics */
+#define WDB_STATE_MEMORY_LARGEST 10
+
+/* Upper bounds of the commit latency histogram (milliseconds), the last bucket counts the slower commits */
+#define WDB_COMMIT_LATENCY_BUCKETS 5
+
+typedef struct _commits_breakdown_t {
+    uint64_t changes_commits;
+    uint64_t time_commits;
+    uint64_t latency[WDB_COMMIT_LATENCY_BUCKETS];
+} commits_breakdown_t;
+
+typedef struct _databases_breakdown_t {
+    uint64_t open_hits;
+    uint64_t open_misses;
+    uint64_t closed;
+    uint64_t prepared_statements;
+    struct timeval prepare_time;
+} databases_breakdown_t;
+
 typedef struct _db_stats_t {
     uint64_t uptime;
     uint64_t queries_total;
     queries_breakdown_t queries_breakdown;
+    uint64_t commits_total;
+    commits_breakdown_t commits_breakdown;
+    databases_breakdown_t databases_breakdown;
 } wdb_state_t;
 
 /* Status functions */
@@ -889,6 +916,32 @@ void w_inc_global_agent_get_agents_by_connection_status();
  */
 void w_inc_global_agent_get_agents_by_connection_status_time(struct timeval time);
 
+/**
+ * @brief Increment get-changes global agent queries counter
+ *
+ */
+void w_inc_global_agent_get_changes();
+
+/**
+ * @brief Increment get-changes global agent time counter
+ *
+ * @param time Value to increment the counter.
+ */
+void w_inc_global_agent_get_changes_time(struct timeval time);
+
+/**
+ * @brief Increment get-agents-info-by-connection-status global agent queries counter
+ *
+ */
+void w_inc_global_agent_get_agents_info_by_connection_status();
+
+/**
+ * @brief Increment get-agents-info-by-connection-status global agent time counter
+ *
+ * @param time Value to increment the counter.
+ */
+void w_inc_global_agent_get_agents_info_by_connection_status_time(struct timeval time);
+
 /**
  * @brief Increment disconnect-agents global agent queries counter
  *
@@ -1226,6 +1279,34 @@ void w_inc_mitre_sql();
  */
 void w_inc_mitre_sql_time(struct timeval time);
 
+/**
+ * @brief Increment the counters of the automatic commits
+ *
+ * @param by_changes The commit was due to the number of changes, instead of the time.
+ * @param time Time taken by the commit.
+ */
+void w_inc_commit(bool by_changes, struct timeval time);
+
+/**
+ * @brief Increment the counters of the agent databases requested to the pool
+ *
+ * @param hit The database was already open in the pool.
+ */
+void w_inc_db_open(bool hit);
+
+/**
+ * @brief Increment the counter of the agent databases closed to keep the pool within open_db_limit
+ *
+ */
+void w_inc_db_close();
+
+/**
+ * @brief Increment the counters of the cached statements prepared
+ *
+ * @param time Time taken by sqlite3_prepare_v2().
+ */
+void w_inc_stmt_prepare(struct timeval time);
+
 /**
  * @brief Create a JSON object with all the wazuh-db state information
  * @return JSON object
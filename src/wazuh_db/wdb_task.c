@@ -315,7 +315,7 @@ int wdb_task_set_timeout_status(wdb_t* wdb, time_t now, int interval, time_t *ne
     return OS_SUCCESS;
 }
 
-int wdb_task_delete_old_entries(wdb_t* wdb, int timestamp) {
+int wdb_task_delete_old_entries(wdb_t* wdb, int timestamp, int limit) {
     sqlite3_stmt *stmt = NULL;
     int result = OS_INVALID;
 
@@ -332,11 +332,12 @@ int wdb_task_delete_old_entries(wdb_t* wdb, int timestamp) {
     stmt = wdb->stmt[WDB_STMT_TASK_DELETE_OLD_TASKS];
 
     sqlite3_bind_int(stmt, 1, timestamp);
+    sqlite3_bind_int(stmt, 2, limit);
 
     if (result = wdb_step(stmt), result != SQLITE_DONE) {
         merror(DB_SQL_ERROR, sqlite3_errmsg(wdb->db));
         return OS_INVALID;
     }
 
-    return OS_SUCCESS;
+    return sqlite3_changes(wdb->db);
 }
@@ -78,7 +78,8 @@ wdb_t * wdb_upgrade_global(wdb_t *wdb) {
         schema_global_upgrade_v2_sql,
         schema_global_upgrade_v3_sql,
         schema_global_upgrade_v4_sql,
-        schema_global_upgrade_v5_sql
+        schema_global_upgrade_v5_sql,
+        schema_global_upgrade_v6_sql
     };
 
     char output[OS_MAXSTR + 1] = { 0 };
@@ -165,6 +166,39 @@ wdb_t * wdb_upgrade_global(wdb_t *wdb) {
     return wdb;
 }
 
+wdb_t * wdb_upgrade_tasks(wdb_t *wdb) {
+    const char * UPDATES[] = {
+        schema_task_manager_upgrade_v2_sql
+    };
+
+    char db_version[OS_SIZE_256 + 2];
+    int version = 0;
+    int updates_length = (int)(sizeof(UPDATES) / sizeof(char *));
+
+    if (wdb_metadata_get_entry(wdb, "db_version", db_version) != OS_SUCCESS) {
+        mwarn("DB(%s): Error trying to get DB version", wdb->id);
+        return wdb;
+    }
+
+    // The first version is the one created by the original schema
+    if (version = atoi(db_version), version < 1) {
+        merror("DB(%s): Incorrect database version: %d", wdb->id, version);
+        return wdb;
+    }
+
+    for (int i = version - 1; i < updates_length; i++) {
+        mdebug2("Updating database '%s' to version %d", wdb->id, i + 2);
+
+        // Upgrades only add indexes, the tasks keep working on the previous version
+        if (wdb_sql_exec(wdb, UPDATES[i]) == OS_INVALID) {
+            merror("Failed to update %s.db to version %d.", wdb->id, i + 2);
+            break;
+        }
+    }
+
+    return wdb;
+}
+
 // Create backup and generate an empty DB
 wdb_t * wdb_backup(wdb_t *wdb, int version) {
     char path[PATH_MAX];
@@ -114,7 +114,8 @@ STATIC char* wm_agent_upgrade_com_open(const cJSON* json_object) __attribute__((
  * {
  *    "file":    "file_path",
  *    "buffer" : "base64_data",
- *    "length" : {data_length}
+ *    "length" : {data_length},
+ *    "offset" : {data_offset}    (optional, the data is appended if missing)
  * }
  * */
 STATIC char * wm_agent_upgrade_com_write(const cJSON* json_object) __attribute__((nonnull));
@@ -231,7 +232,17 @@ STATIC char * wm_agent_upgrade_com_open(const cJSON* json_object) {
 
     if (file.fp = fopen(final_path, mode_obj->valuestring), file.fp) {
         snprintf(file.path, sizeof(file.path), "%s", final_path);
-        return wm_agent_upgrade_command_ack(ERROR_OK, error_messages[ERROR_OK]);
+
+        // Tell the manager that the blocks can be written at their offset, so it may send several at once
+        cJSON* root = cJSON_CreateObject();
+        cJSON* data = cJSON_CreateArray();
+        cJSON_AddNumberToObject(root, task_manager_json_keys[WM_TASK_ERROR], ERROR_OK);
+        cJSON_AddStringToObject(root, task_manager_json_keys[WM_TASK_ERROR_MESSAGE], error_messages[ERROR_OK]);
+        cJSON_AddItemToArray(data, cJSON_CreateString(WM_UPGRADE_CAPABILITY_WRITE_OFFSET));
+        cJSON_AddItemToObject(root, task_manager_json_keys[WM_TASK_DATA], data);
+        char *msg_string = cJSON_PrintUnformatted(root);
+        cJSON_Delete(root);
+        return msg_string;
     } else {
         mterror(WM_AGENT_UPGRADE_LOGTAG, FOPEN_ERROR, file_path_obj->valuestring, errno, strerror(errno));
         char *output;
@@ -247,6 +258,7 @@ STATIC char * wm_agent_upgrade_com_write(const cJSON* json_object) {
     const cJSON *file_path_obj = cJSON_GetObjectItem(json_object, "file");
     const cJSON *buffer_obj = cJSON_GetObjectItem(json_object, "buffer");
     const cJSON *value_obj = cJSON_GetObjectItem(json_object, "length");
+    const cJSON *offset_obj = cJSON_GetObjectItem(json_object, "offset");
     char final_path[PATH_MAX + 1];
 
     if (!*file.path) {
@@ -264,6 +276,12 @@ STATIC char * wm_agent_upgrade_com_write(const cJSON* json_object) {
         return wm_agent_upgrade_command_ack(ERROR_TARGET_FILE_NOT_MATCH, error_messages[ERROR_TARGET_FILE_NOT_MATCH]);
     }
 
+    // The manager may send several blocks at once, so they are written at their position
+    if (cJSON_IsNumber(offset_obj) && (offset_obj->valuedouble < 0 || fseek(file.fp, (long)offset_obj->valuedouble, SEEK_SET))) {
+        mterror(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_CANNOT_WRITE, "write", final_path);
+        return wm_agent_upgrade_command_ack(ERROR_WRITE_FILE, error_messages[ERROR_WRITE_FILE]);
+    }
+
     char *base64_string = decode_base64(buffer_obj->valuestring);
     if (value_obj && (value_obj->type == cJSON_Number) && base64_string && fwrite(base64_string, 1, value_obj->valueint, file.fp) == (unsigned)value_obj->valueint) {
         os_free(base64_string);
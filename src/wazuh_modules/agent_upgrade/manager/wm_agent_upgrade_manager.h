@@ -20,6 +20,7 @@
 #define WM_UPGRADE_WPK_DOWNLOAD_TIMEOUT 60000
 #define WM_UPGRADE_WPK_DOWNLOAD_ATTEMPTS 5
 #define WM_UPGRADE_WPK_OPEN_ATTEMPTS 10
+#define WM_UPGRADE_WPK_WRITE_ATTEMPTS 10
 #define WM_UPGRADE_MAX_RESPONSE_SIZE 1048576L
 #define MANAGER_ID 0
 #define WM_AGENT_UPGRADE_START_WAIT_TIME 30
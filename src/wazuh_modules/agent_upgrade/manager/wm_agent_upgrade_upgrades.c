@@ -27,17 +27,33 @@
 /* Queue to store agents ready to be upgraded */
 STATIC w_linked_queue_t *upgrade_queue;
 
-/* Running threads semaphore */
-sem_t upgrade_semaphore;
-
 /* Definition of upgrade arguments structure */
 typedef struct _wm_upgrade_args {
     wm_manager_configs *config;
     wm_agent_task *agent_task;
 } wm_upgrade_args;
 
+/* WPK file loaded in memory, shared by the upgrades sending it at the same time */
+typedef struct _wm_upgrade_wpk {
+    char *path;
+    char *data;
+    size_t size;
+    unsigned int references;
+    struct _wm_upgrade_wpk *next;
+} wm_upgrade_wpk;
+
+/* WPK files being sent */
+STATIC wm_upgrade_wpk *upgrade_wpks;
+static pthread_mutex_t upgrade_wpks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Main function of the upgrade workers, runs the upgrades taken from the queue one after another
+ * @param arg manager configuration parameters
+ * */
+STATIC void* wm_agent_upgrade_upgrade_worker(void *arg);
+
 /**
- * Main function of upgrade threads
+ * Run the upgrade of an agent
  * @param arg Upgrade arguments structure
  * */
 STATIC void* wm_agent_upgrade_start_upgrade(void *arg);
@@ -72,11 +88,12 @@ STATIC int wm_agent_upgrade_send_lock_restart(int agent_id);
  * @param agent_id id of the agent
  * @param wpk_message_format 1 for new format, 0 for old
  * @param wpk_file name of the file to open in the agent
+ * @param write_offset set to true if the agent reports that it writes the blocks at their offset
  * @return error code
  * @retval OS_SUCCESS on success
  * @retval OS_INVALID on errors
  * */
-STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file) __attribute__((nonnull));
+STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file, bool *write_offset) __attribute__((nonnull));
 
 /**
  * Send a write file command to an agent
@@ -85,11 +102,68 @@ STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, cons
  * @param wpk_file name of the file to write in the agent
  * @param file_path name of the file to read in the manager
  * @param chunk_size size of block to send WPK file
+ * @param window_size number of blocks sent without waiting for the agent, 1 to wait for every block
+ * @return error code
+ * @retval OS_SUCCESS on success
+ * @retval OS_INVALID on errors
+ * */
+STATIC int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size, int window_size) __attribute__((nonnull));
+
+/**
+ * Send the WPK file to an agent keeping several blocks in flight
+ * Every block carries its offset, so the transfer resumes from the first
+ * block not acknowledged when a write fails
+ * @param agent_id id of the agent
+ * @param wpk_file name of the file to write in the agent
+ * @param wpk WPK file to send
+ * @param chunk_size size of block to send WPK file
+ * @param window_size maximum number of blocks not acknowledged
  * @return error code
  * @retval OS_SUCCESS on success
  * @retval OS_INVALID on errors
  * */
-STATIC int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size) __attribute__((nonnull));
+STATIC int wm_agent_upgrade_send_write_window(int agent_id, const char *wpk_file, const wm_upgrade_wpk *wpk, int chunk_size, int window_size) __attribute__((nonnull));
+
+/**
+ * Build a write file command
+ * @param command buffer of OS_MAXSTR bytes to build the command
+ * @param agent_id id of the agent
+ * @param wpk_message_format 1 for new format, 0 for old
+ * @param wpk_file name of the file to write in the agent
+ * @param data block to write
+ * @param bytes size of the block
+ * @param offset position of the block in the file, -1 to append it
+ * @return size of the command
+ * */
+STATIC size_t wm_agent_upgrade_build_write(char *command, int agent_id, int wpk_message_format, const char *wpk_file, const char *data, size_t bytes, long offset) __attribute__((nonnull));
+
+/**
+ * Load a WPK file in memory, or take a reference to it if it is already loaded
+ * @param file_path name of the file to read in the manager
+ * @return WPK file, NULL on errors
+ * */
+STATIC wm_upgrade_wpk* wm_agent_upgrade_wpk_acquire(const char *file_path) __attribute__((nonnull));
+
+/**
+ * Release a reference to a WPK file, it is freed when no upgrade is sending it
+ * @param wpk WPK file
+ * */
+STATIC void wm_agent_upgrade_wpk_release(wm_upgrade_wpk *wpk) __attribute__((nonnull));
+
+/**
+ * Connect to remoted and send a command to an agent without waiting for the response
+ * @param command command to be sent
+ * @param command_size size of the command
+ * @return socket to read the response from, OS_SOCKTERR on errors
+ * */
+STATIC int wm_agent_upgrade_send_request(const char *command, const size_t command_size) __attribute__((nonnull));
+
+/**
+ * Read the response of a command sent with wm_agent_upgrade_send_request and close the socket
+ * @param sock socket returned by wm_agent_upgrade_send_request
+ * @return response from the agent
+ * */
+STATIC char* wm_agent_upgrade_recv_response(int sock);
 
 /**
  * Send a close file command to an agent
@@ -153,30 +227,29 @@ void wm_agent_upgrade_prepare_upgrades() {
 
 void* wm_agent_upgrade_dispatch_upgrades(void *arg) {
     wm_manager_configs *config = (wm_manager_configs *)arg;
-    wm_upgrade_args *upgrade_config = NULL;
 
-    sem_init(&upgrade_semaphore, 0, config->max_threads);
+    // A fixed pool of workers takes the upgrades from the queue, instead of a thread per upgrade
+    for (unsigned int i = 0; i < config->max_threads; i++) {
+        w_create_thread(wm_agent_upgrade_upgrade_worker, (void *)config);
+    }
 
-    while (1) {
-        // Blocks until an available thread is ready
-        sem_wait(&upgrade_semaphore);
+    return NULL;
+}
 
-        wm_agent_task *agent_task = linked_queue_pop_ex(upgrade_queue);
+STATIC void* wm_agent_upgrade_upgrade_worker(void *arg) {
+    wm_upgrade_args upgrade_config = { .config = (wm_manager_configs *)arg };
 
-        os_calloc(1, sizeof(wm_upgrade_args), upgrade_config);
-        upgrade_config->config = config;
-        upgrade_config->agent_task = agent_task;
+    while (1) {
+        // Blocks until an upgrade is ready
+        upgrade_config.agent_task = linked_queue_pop_ex(upgrade_queue);
 
-        // Thread that will launch the upgrade
-        w_create_thread(wm_agent_upgrade_start_upgrade, (void *)upgrade_config);
+        wm_agent_upgrade_start_upgrade(&upgrade_config);
 
     #ifdef WAZUH_UNIT_TESTING
         break;
     #endif
     }
 
-    sem_destroy(&upgrade_semaphore);
-
     return NULL;
 }
 
@@ -244,15 +317,6 @@ STATIC void* wm_agent_upgrade_start_upgrade(void *arg) {
 
     wm_agent_upgrade_free_agent_task(agent_task);
 
-    os_free(upgrade_config);
-
-    // Notify end of execution
-    sem_post(&upgrade_semaphore);
-
-#ifndef WAZUH_UNIT_TESTING
-    pthread_exit(NULL);
-#endif
-
     return NULL;
 }
 
@@ -263,6 +327,12 @@ STATIC int wm_agent_upgrade_send_wpk_to_agent(const wm_agent_task *agent_task, c
     char *file_sha1 = NULL;
     char *wpk_path = NULL;
     char *installer = NULL;
+    struct timespec stage_start;
+    struct timespec stage_end;
+    double open_time = 0;
+    double write_time = 0;
+    double sha1_time = 0;
+    double upgrade_time = 0;
 
     // Validate WPK file
     if (WM_UPGRADE_UPGRADE == agent_task->task_info->command) {
@@ -314,6 +384,8 @@ STATIC int wm_agent_upgrade_send_wpk_to_agent(const wm_agent_task *agent_task, c
 
     wpk_path = basename_ex(file_path_copy);
 
+    gettime(&stage_start);
+
     // lock_restart
     if (wm_agent_upgrade_send_lock_restart(agent_task->agent_info->agent_id)) {
         result = WM_UPGRADE_SEND_LOCK_RESTART_ERROR;
@@ -323,15 +395,28 @@ STATIC int wm_agent_upgrade_send_wpk_to_agent(const wm_agent_task *agent_task, c
     int wpk_message_format = compare_wazuh_versions(strchr(agent_task->agent_info->wazuh_version, 'v'), WM_UPGRADE_NEW_UPGRADE_MECHANISM, true);
 
     // open wb
-    if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_open(agent_task->agent_info->agent_id, wpk_message_format, wpk_path)) {
+    bool write_offset = false;
+    if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_open(agent_task->agent_info->agent_id, wpk_message_format, wpk_path, &write_offset)) {
         result = WM_UPGRADE_SEND_OPEN_ERROR;
     }
 
+    gettime(&stage_end);
+    open_time = time_diff(&stage_start, &stage_end);
+
+    // Only agents writing the blocks at their offset can receive several of them at once
+    int window_size = 1;
+    if (write_offset && manager_configs->window_size > 1) {
+        window_size = manager_configs->window_size;
+    }
+
     // write
-    if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_write(agent_task->agent_info->agent_id, wpk_message_format, wpk_path, file_path, manager_configs->chunk_size)) {
+    if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_write(agent_task->agent_info->agent_id, wpk_message_format, wpk_path, file_path, manager_configs->chunk_size, window_size)) {
         result = WM_UPGRADE_SEND_WRITE_ERROR;
     }
 
+    gettime(&stage_start);
+    write_time = time_diff(&stage_end, &stage_start);
+
     // close
     if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_close(agent_task->agent_info->agent_id, wpk_message_format, wpk_path)) {
         result = WM_UPGRADE_SEND_CLOSE_ERROR;
@@ -342,11 +427,21 @@ STATIC int wm_agent_upgrade_send_wpk_to_agent(const wm_agent_task *agent_task, c
         result = WM_UPGRADE_SEND_SHA1_ERROR;
     }
 
+    gettime(&stage_end);
+    sha1_time = time_diff(&stage_start, &stage_end);
+
     // upgrade
     if ((result == WM_UPGRADE_SUCCESS) && wm_agent_upgrade_send_upgrade(agent_task->agent_info->agent_id, wpk_message_format, wpk_path, installer)) {
         result = WM_UPGRADE_SEND_UPGRADE_ERROR;
     }
 
+    gettime(&stage_start);
+    upgrade_time = time_diff(&stage_end, &stage_start);
+
+    if (result == WM_UPGRADE_SUCCESS) {
+        mtdebug1(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_WPK_SENT_TIMES, agent_task->agent_info->agent_id, open_time, write_time, sha1_time, upgrade_time);
+    }
+
     os_free(file_path);
     os_free(file_path_copy);
     os_free(file_sha1);
@@ -374,7 +469,7 @@ STATIC int wm_agent_upgrade_send_lock_restart(int agent_id) {
     return result;
 }
 
-STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file) {
+STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, const char *wpk_file, bool *write_offset) {
     int result = OS_INVALID;
     char *command = NULL;
     char *response = NULL;
@@ -412,69 +507,237 @@ STATIC int wm_agent_upgrade_send_open(int agent_id, int wpk_message_format, cons
         }
     }
 
+    // The agents that write the blocks at their offset list it in the data of the answer
+    *write_offset = false;
+
+    if (!result && wpk_message_format >= 0) {
+        cJSON *json_response = cJSON_Parse(response);
+        cJSON *data_obj = cJSON_GetObjectItem(json_response, task_manager_json_keys[WM_TASK_DATA]);
+        cJSON *item = NULL;
+
+        cJSON_ArrayForEach(item, data_obj) {
+            if (cJSON_IsString(item) && !strcmp(item->valuestring, WM_UPGRADE_CAPABILITY_WRITE_OFFSET)) {
+                *write_offset = true;
+            }
+        }
+
+        cJSON_Delete(json_response);
+    }
+
     os_free(command);
     os_free(response);
 
     return result;
 }
 
-STATIC int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size) {
+STATIC int wm_agent_upgrade_send_write(int agent_id, int wpk_message_format, const char *wpk_file, const char *file_path, int chunk_size, int window_size) {
     int result = OS_INVALID;
     char *command = NULL;
     char *response = NULL;
-    char buffer[chunk_size];
+    wm_upgrade_wpk *wpk = NULL;
+    size_t offset = 0;
+    size_t bytes = 0;
+    size_t command_size = 0;
+
+    if (wpk = wm_agent_upgrade_wpk_acquire(file_path), !wpk) {
+        return OS_INVALID;
+    }
+
+    if (window_size > 1) {
+        result = wpk->size ? wm_agent_upgrade_send_write_window(agent_id, wpk_file, wpk, chunk_size, window_size) : OS_INVALID;
+        wm_agent_upgrade_wpk_release(wpk);
+        return result;
+    }
+
+    os_calloc(OS_MAXSTR, sizeof(char), command);
+
+    for (offset = 0; offset < wpk->size; offset += bytes) {
+        bytes = wpk->size - offset < (size_t)chunk_size ? wpk->size - offset : (size_t)chunk_size;
+        command_size = wm_agent_upgrade_build_write(command, agent_id, wpk_message_format, wpk_file, wpk->data + offset, bytes, -1);
+
+        os_free(response);
+        response = wm_agent_upgrade_send_command_to_agent(command, command_size);
+        if (wpk_message_format >= 0) {
+            result = wm_agent_upgrade_parse_agent_upgrade_command_response(response, NULL);
+        } else {
+            result = wm_agent_upgrade_parse_agent_response(response, NULL);
+        }
+        if (result) {
+            break;
+        }
+    }
+
+    wm_agent_upgrade_wpk_release(wpk);
+
+    os_free(command);
+    os_free(response);
+
+    return result;
+}
+
+STATIC int wm_agent_upgrade_send_write_window(int agent_id, const char *wpk_file, const wm_upgrade_wpk *wpk, int chunk_size, int window_size) {
+    int result = OS_SUCCESS;
+    char *command = NULL;
+    char *response = NULL;
+    int *sockets = NULL;
+    size_t *offsets = NULL;
+    size_t next = 0;
+    size_t acked = 0;
     size_t bytes = 0;
     size_t command_size = 0;
+    int first = 0;
+    int pending = 0;
+    int attempts = 0;
+    int slot = 0;
 
     os_calloc(OS_MAXSTR, sizeof(char), command);
+    os_calloc(window_size, sizeof(int), sockets);
+    os_calloc(window_size, sizeof(size_t), offsets);
+
+    while (acked < wpk->size) {
+        // Fill the window
+        while (pending < window_size && next < wpk->size) {
+            bytes = wpk->size - next < (size_t)chunk_size ? wpk->size - next : (size_t)chunk_size;
+            command_size = wm_agent_upgrade_build_write(command, agent_id, 1, wpk_file, wpk->data + next, bytes, (long)next);
+
+            slot = (first + pending) % window_size;
+            sockets[slot] = wm_agent_upgrade_send_request(command, command_size);
+            offsets[slot] = next;
+            pending++;
+            next += bytes;
+        }
+
+        // Responses are read in sending order, so the acknowledged bytes are always contiguous
+        response = (sockets[first] != OS_SOCKTERR) ? wm_agent_upgrade_recv_response(sockets[first]) : NULL;
 
-    FILE *file = fopen(file_path, "rb");
-    if (file) {
-        while (bytes = fread(buffer, 1, sizeof(buffer), file), bytes) {
-
-            if (wpk_message_format >= 0) {
-                cJSON *command_info = cJSON_CreateObject();
-                cJSON_AddStringToObject(command_info, task_manager_json_keys[WM_TASK_COMMAND], "write");
-                cJSON *params = cJSON_CreateObject();
-                char *base64 = encode_base64(bytes, buffer);
-                cJSON_AddStringToObject(params, "buffer", base64);
-                cJSON_AddNumberToObject(params, "length", bytes);
-                cJSON_AddStringToObject(params, "file", wpk_file);
-                cJSON_AddItemToObject(command_info, task_manager_json_keys[WM_TASK_PARAMETERS], params);
-                char *command_string = cJSON_PrintUnformatted(command_info);
-                snprintf(command, OS_MAXSTR, "%.3d upgrade %s", agent_id, command_string);
-                os_free(command_string);
-                command_size = strlen(command);
-                os_free(base64);
-                cJSON_Delete(command_info);
-            } else {
-                snprintf(command, OS_MAXSTR, "%.3d com write %ld %s ", agent_id, bytes, wpk_file);
-                command_size = strlen(command);
-                for (size_t byte = 0; byte < bytes; ++byte) {
-                    sprintf(&command[command_size++], "%c", buffer[byte]);
+        if (response && !wm_agent_upgrade_parse_agent_upgrade_command_response(response, NULL)) {
+            acked = offsets[first] + chunk_size < wpk->size ? offsets[first] + chunk_size : wpk->size;
+            attempts = 0;
+            first = (first + 1) % window_size;
+            pending--;
+        } else {
+            // Drop the blocks in flight and resume from the first one not acknowledged
+            next = offsets[first];
+
+            for (first = (first + 1) % window_size, pending--; pending > 0; first = (first + 1) % window_size, pending--) {
+                if (sockets[first] != OS_SOCKTERR) {
+                    close(sockets[first]);
                 }
             }
 
-            os_free(response);
-            response = wm_agent_upgrade_send_command_to_agent(command, command_size);
-            if (wpk_message_format >= 0) {
-                result = wm_agent_upgrade_parse_agent_upgrade_command_response(response, NULL);
-            } else {
-                result = wm_agent_upgrade_parse_agent_response(response, NULL);
-            }
-            if (result) {
+            if (++attempts >= WM_UPGRADE_WPK_WRITE_ATTEMPTS) {
+                result = OS_INVALID;
+                os_free(response);
                 break;
             }
+
+            mtdebug1(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_WPK_RESUME_TRANSFER, agent_id, next);
+            sleep(attempts);
         }
-        fclose(file);
+
+        os_free(response);
     }
 
     os_free(command);
-    os_free(response);
+    os_free(sockets);
+    os_free(offsets);
 
     return result;
 }
 
+STATIC size_t wm_agent_upgrade_build_write(char *command, int agent_id, int wpk_message_format, const char *wpk_file, const char *data, size_t bytes, long offset) {
+    size_t command_size = 0;
+
+    if (wpk_message_format >= 0) {
+        cJSON *command_info = cJSON_CreateObject();
+        cJSON_AddStringToObject(command_info, task_manager_json_keys[WM_TASK_COMMAND], "write");
+        cJSON *params = cJSON_CreateObject();
+        char *base64 = encode_base64(bytes, data);
+        cJSON_AddStringToObject(params, "buffer", base64);
+        cJSON_AddNumberToObject(params, "length", bytes);
+        cJSON_AddStringToObject(params, "file", wpk_file);
+        if (offset >= 0) {
+            cJSON_AddNumberToObject(params, "offset", offset);
+        }
+        cJSON_AddItemToObject(command_info, task_manager_json_keys[WM_TASK_PARAMETERS], params);
+        char *command_string = cJSON_PrintUnformatted(command_info);
+        snprintf(command, OS_MAXSTR, "%.3d upgrade %s", agent_id, command_string);
+        os_free(command_string);
+        command_size = strlen(command);
+        os_free(base64);
+        cJSON_Delete(command_info);
+    } else {
+        snprintf(command, OS_MAXSTR, "%.3d com write %ld %s ", agent_id, bytes, wpk_file);
+        command_size = strlen(command);
+        for (size_t byte = 0; byte < bytes; ++byte) {
+            sprintf(&command[command_size++], "%c", data[byte]);
+        }
+    }
+
+    return command_size;
+}
+
+STATIC wm_upgrade_wpk* wm_agent_upgrade_wpk_acquire(const char *file_path) {
+    wm_upgrade_wpk *wpk = NULL;
+    size_t capacity = OS_SIZE_65536;
+    size_t bytes = 0;
+    FILE *file = NULL;
+
+    w_mutex_lock(&upgrade_wpks_mutex);
+
+    for (wpk = upgrade_wpks; wpk; wpk = wpk->next) {
+        if (!strcmp(wpk->path, file_path)) {
+            wpk->references++;
+            w_mutex_unlock(&upgrade_wpks_mutex);
+            return wpk;
+        }
+    }
+
+    // The file is read once, other upgrades of the same WPK wait for it
+    if (file = fopen(file_path, "rb"), file) {
+        os_calloc(1, sizeof(wm_upgrade_wpk), wpk);
+        os_strdup(file_path, wpk->path);
+        os_malloc(capacity, wpk->data);
+
+        while (bytes = fread(wpk->data + wpk->size, 1, capacity - wpk->size, file), bytes) {
+            wpk->size += bytes;
+            if (wpk->size == capacity) {
+                capacity *= 2;
+                os_realloc(wpk->data, capacity, wpk->data);
+            }
+        }
+        fclose(file);
+
+        wpk->references = 1;
+        wpk->next = upgrade_wpks;
+        upgrade_wpks = wpk;
+    }
+
+    w_mutex_unlock(&upgrade_wpks_mutex);
+
+    return wpk;
+}
+
+STATIC void wm_agent_upgrade_wpk_release(wm_upgrade_wpk *wpk) {
+    wm_upgrade_wpk **node = NULL;
+
+    w_mutex_lock(&upgrade_wpks_mutex);
+
+    if (--wpk->references == 0) {
+        for (node = &upgrade_wpks; *node; node = &(*node)->next) {
+            if (*node == wpk) {
+                *node = wpk->next;
+                break;
+            }
+        }
+        os_free(wpk->path);
+        os_free(wpk->data);
+        os_free(wpk);
+    }
+
+    w_mutex_unlock(&upgrade_wpks_mutex);
+}
+
 STATIC int wm_agent_upgrade_send_close(int agent_id, int wpk_message_format, const char *wpk_file) {
     int result = OS_INVALID;
     char *command = NULL;
@@ -599,9 +862,12 @@ STATIC int wm_agent_upgrade_send_upgrade(int agent_id, int wpk_message_format, c
 }
 
 char* wm_agent_upgrade_send_command_to_agent(const char *command, const size_t command_size) {
-    char *response = NULL;
-    int length = 0;
+    int sock = wm_agent_upgrade_send_request(command, command_size);
+
+    return (sock != OS_SOCKTERR) ? wm_agent_upgrade_recv_response(sock) : NULL;
+}
 
+STATIC int wm_agent_upgrade_send_request(const char *command, const size_t command_size) {
     const char *path = REMOTE_LOCAL_SOCK;
 
     int sock = OS_ConnectUnixDomain(path, SOCK_STREAM, OS_MAXSTR);
@@ -612,22 +878,30 @@ char* wm_agent_upgrade_send_command_to_agent(const char *command, const size_t c
         mtdebug2(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_REQUEST_SEND_MESSAGE, command);
 
         OS_SendSecureTCP(sock, command_size ? command_size : strlen(command), command);
-        os_calloc(OS_MAXSTR, sizeof(char), response);
+    }
 
-        switch (length = OS_RecvSecureTCP(sock, response, OS_MAXSTR), length) {
-            case OS_SOCKTERR:
-                mterror(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_SOCKTERR_ERROR);
-                break;
-            case -1:
-                mterror(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_RECV_ERROR, strerror(errno));
-                break;
-            default:
-                mtdebug2(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_REQUEST_RECEIVE_MESSAGE, response);
-                break;
-        }
+    return sock;
+}
+
+STATIC char* wm_agent_upgrade_recv_response(int sock) {
+    char *response = NULL;
+    int length = 0;
 
-        close(sock);
+    os_calloc(OS_MAXSTR, sizeof(char), response);
+
+    switch (length = OS_RecvSecureTCP(sock, response, OS_MAXSTR), length) {
+        case OS_SOCKTERR:
+            mterror(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_SOCKTERR_ERROR);
+            break;
+        case -1:
+            mterror(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_RECV_ERROR, strerror(errno));
+            break;
+        default:
+            mtdebug2(WM_AGENT_UPGRADE_LOGTAG, WM_UPGRADE_REQUEST_RECEIVE_MESSAGE, response);
+            break;
     }
 
+    close(sock);
+
     return response;
 }
@@ -17,6 +17,8 @@
 #define WM_UPGRADE_WPK_REPO_URL_3_X "packages.wazuh.com/wpk/"
 #define WM_UPGRADE_WPK_REPO_URL "packages.wazuh.com/%d.x/wpk/"
 #define WM_UPGRADE_CHUNK_SIZE 512
+#define WM_UPGRADE_WINDOW_SIZE 8
+#define WM_UPGRADE_CAPABILITY_WRITE_OFFSET "write_offset"
 #define WM_UPGRADE_MAX_THREADS 8
 #define WM_UPGRADE_WAIT_START 300
 #define WM_UPGRADE_WAIT_MAX 3600
@@ -38,6 +40,7 @@ typedef struct _wm_agent_configs {
 typedef struct _wm_manager_configs {
     unsigned int max_threads;
     unsigned int chunk_size;
+    unsigned int window_size;
     char *wpk_repository;
 } wm_manager_configs;
 
@@ -51,7 +51,8 @@ EXPORTED void syscollector_start(const unsigned int inverval,
                                  const bool ports,
                                  const bool portsAll,
                                  const bool processes,
-                                 const bool hotfixes);
+                                 const bool hotfixes,
+                                 const unsigned int changesInterval);
 
 EXPORTED void syscollector_stop();
 
@@ -78,7 +79,8 @@ typedef void(*syscollector_start_func)(const unsigned int inverval,
                                        const bool ports,
                                        const bool portsAll,
                                        const bool processes,
-                                       const bool hotfixes);
+                                       const bool hotfixes,
+                                       const unsigned int changesInterval);
 
 typedef void(*syscollector_stop_func)();
 
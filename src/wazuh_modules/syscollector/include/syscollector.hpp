@@ -15,11 +15,14 @@
 #include <condition_variable>
 #include <mutex>
 #include <memory>
+#include <random>
+#include <set>
 #include "sysInfoInterface.h"
 #include "commonDefs.h"
 #include "dbsync.hpp"
 #include "rsync.hpp"
 #include "syscollectorNormalizer.h"
+#include "syscollectorChanges.h"
 #include "syscollector.h"
 
 // Define EXPORTED for any platform
@@ -61,7 +64,8 @@ public:
               const bool portsAll = true,
               const bool processes = true,
               const bool hotfixes = true,
-              const bool notifyOnFirstScan = false);
+              const bool notifyOnFirstScan = false,
+              const unsigned int changesInterval = 0ul);
 
     void destroy();
     void push(const std::string& data);
@@ -99,12 +103,16 @@ private:
     void syncProcesses();
     void scan();
     void sync();
+    void createChangeSources();
+    void scanChanges();
+    std::chrono::seconds scanDelay();
     void syncLoop(std::unique_lock<std::mutex>& lock);
     std::shared_ptr<ISysInfo>                                               m_spInfo;
     std::function<void(const std::string&)>                                 m_reportDiffFunction;
     std::function<void(const std::string&)>                                 m_reportSyncFunction;
     std::function<void(const modules_log_level_t, const std::string&)>      m_logFunction;
     unsigned int                                                            m_intervalValue;
+    unsigned int                                                            m_changesInterval;
     bool                                                                    m_scanOnStart;
     bool                                                                    m_hardware;
     bool                                                                    m_os;
@@ -122,6 +130,13 @@ private:
     std::mutex                                                              m_mutex;
     std::unique_ptr<SysNormalizer>                                          m_spNormalizer;
     std::string                                                             m_scanTime;
+    std::unique_ptr<IChangeSource>                                          m_spPackagesChanges;
+    std::unique_ptr<IChangeSource>                                          m_spNetworkChanges;
+    std::default_random_engine                                              m_randomEngine;
+    std::mutex                                                              m_changedTablesMutex;
+    std::set<std::string>                                                   m_changedTables;
+    bool                                                                    m_fullSyncPending;
+    std::chrono::steady_clock::time_point                                   m_lastFullSync;
 };
 
 
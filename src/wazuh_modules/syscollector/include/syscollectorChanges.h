@@ -0,0 +1,69 @@
+/*
+ * Wazuh SysCollector
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#ifndef _SYSCOLLECTOR_CHANGES_H
+#define _SYSCOLLECTOR_CHANGES_H
+#include <string>
+#include <vector>
+#include <memory>
+
+class IChangeSource
+{
+    public:
+        // LCOV_EXCL_START
+        virtual ~IChangeSource() = default;
+        // LCOV_EXCL_STOP
+        /**
+         * @brief Checks whether the watched category changed since the previous check.
+         */
+        virtual bool changed() = 0;
+};
+
+// Reports a change when the modification time or the size of any of the watched paths changes.
+class FileChangeSource final : public IChangeSource
+{
+    public:
+        explicit FileChangeSource(const std::vector<std::string>& paths);
+        ~FileChangeSource() = default;
+        bool changed() override;
+    private:
+        std::vector<std::string> stamps() const;
+        const std::vector<std::string> m_paths;
+        std::vector<std::string> m_stamps;
+};
+
+#ifdef __linux__
+// Reports a change when the kernel notifies a link, address or route event through a netlink socket.
+class NetlinkChangeSource final : public IChangeSource
+{
+    public:
+        NetlinkChangeSource();
+        ~NetlinkChangeSource();
+        NetlinkChangeSource(const NetlinkChangeSource&) = delete;
+        NetlinkChangeSource& operator=(const NetlinkChangeSource&) = delete;
+        bool changed() override;
+    private:
+        int m_socket;
+};
+#endif
+
+/**
+ * @brief Creates the change source of the installed packages for the current platform.
+ * @return The change source, nullptr if the packages can only be checked with a full scan.
+ */
+std::unique_ptr<IChangeSource> createPackagesChangeSource();
+
+/**
+ * @brief Creates the change source of the network interfaces for the current platform.
+ * @return The change source, nullptr if the interfaces can only be checked with a full scan.
+ */
+std::unique_ptr<IChangeSource> createNetworkChangeSource();
+
+#endif //_SYSCOLLECTOR_CHANGES_H
@@ -13,6 +13,50 @@
 #include <json.hpp>
 #include <string>
 #include <map>
+#include <memory>
+#include <regex>
+#include <vector>
+
+// Configuration pattern compiled once, literal shapes are matched without the regex engine.
+class SysNormalizerPattern
+{
+    public:
+        explicit SysNormalizerPattern(const std::string& pattern);
+        ~SysNormalizerPattern() = default;
+        bool match(const std::string& value) const;
+        std::string replace(const std::string& value,
+                            const std::string& format) const;
+    private:
+        enum class MatchType
+        {
+            REGEX,
+            EXACT,
+            PREFIX,
+            SUFFIX,
+            CONTAINS
+        };
+        MatchType m_matchType;
+        std::string m_literal;
+        std::regex m_regex;
+};
+
+struct SysNormalizerExclusion
+{
+    std::string fieldName;
+    std::shared_ptr<SysNormalizerPattern> pattern;
+};
+
+struct SysNormalizerRule
+{
+    std::string findField;
+    std::shared_ptr<SysNormalizerPattern> findPattern;
+    std::string replaceField;
+    std::shared_ptr<SysNormalizerPattern> replacePattern;
+    std::string replaceValue;
+    std::string addField;
+    std::string addValue;
+    bool hasAdd;
+};
 
 class SysNormalizer
 {
@@ -28,8 +72,10 @@ class SysNormalizer
         static std::map<std::string, nlohmann::json> getTypeValues(const std::string& configFile,
                                                                    const std::string& target,
                                                                    const std::string& type);
-        const std::map<std::string, nlohmann::json> m_typeExclusions;
-        const std::map<std::string, nlohmann::json> m_typeDictionary;
+        static std::map<std::string, std::vector<SysNormalizerExclusion>> compileExclusions(const std::map<std::string, nlohmann::json>& typeValues);
+        static std::map<std::string, std::vector<SysNormalizerRule>> compileDictionary(const std::map<std::string, nlohmann::json>& typeValues);
+        const std::map<std::string, std::vector<SysNormalizerExclusion>> m_typeExclusions;
+        const std::map<std::string, std::vector<SysNormalizerRule>> m_typeDictionary;
 };
 
 
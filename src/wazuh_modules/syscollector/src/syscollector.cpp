@@ -33,7 +33,8 @@ void syscollector_start(const unsigned int inverval,
                         const bool ports,
                         const bool portsAll,
                         const bool processes,
-                        const bool hotfixes)
+                        const bool hotfixes,
+                        const unsigned int changesInterval)
 {
     std::function<void(const std::string&)> callbackDiffWrapper
     {
@@ -87,7 +88,9 @@ void syscollector_start(const unsigned int inverval,
                                       ports,
                                       portsAll,
                                       processes,
-                                      hotfixes);
+                                      hotfixes,
+                                      false,
+                                      changesInterval);
     }
     catch (const std::exception& ex)
     {
@@ -0,0 +1,142 @@
+/*
+ * Wazuh SysCollector
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#include <sys/stat.h>
+#include <cerrno>
+#include <system_error>
+#include <syscollectorChanges.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+FileChangeSource::FileChangeSource(const std::vector<std::string>& paths)
+    : m_paths{paths}
+    , m_stamps{stamps()}
+{
+}
+
+std::vector<std::string> FileChangeSource::stamps() const
+{
+    std::vector<std::string> ret;
+
+    for (const auto& path : m_paths)
+    {
+        struct stat info {};
+
+        // A missing path gets an empty stamp, so its creation is a change as well.
+        ret.push_back(stat(path.c_str(), &info) == 0 ? std::to_string(info.st_mtime) + ":" + std::to_string(info.st_size) : "");
+    }
+
+    return ret;
+}
+
+bool FileChangeSource::changed()
+{
+    auto current{stamps()};
+    const auto ret{current != m_stamps};
+    m_stamps = std::move(current);
+    return ret;
+}
+
+#ifdef __linux__
+NetlinkChangeSource::NetlinkChangeSource()
+    : m_socket{socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE)}
+{
+    if (m_socket < 0)
+    {
+        throw std::system_error{errno, std::system_category(), "Unable to open the netlink socket"};
+    }
+
+    struct sockaddr_nl address {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+
+    if (bind(m_socket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        const auto error{errno};
+        close(m_socket);
+        throw std::system_error{error, std::system_category(), "Unable to bind the netlink socket"};
+    }
+}
+
+NetlinkChangeSource::~NetlinkChangeSource()
+{
+    close(m_socket);
+}
+
+bool NetlinkChangeSource::changed()
+{
+    auto ret{false};
+    char buffer[8192];
+
+    // The pending notifications are drained. Their content doesn't matter, the whole category is scanned.
+    for (;;)
+    {
+        const auto size{recv(m_socket, buffer, sizeof(buffer), 0)};
+
+        if (size > 0)
+        {
+            ret = true;
+        }
+        else if (size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (size < 0 && errno == ENOBUFS)
+        {
+            // The kernel dropped notifications because the socket buffer was full.
+            ret = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return ret;
+}
+#endif
+
+std::unique_ptr<IChangeSource> createPackagesChangeSource()
+{
+#if defined(__linux__)
+    return std::make_unique<FileChangeSource>(std::vector<std::string>
+    {
+        "/var/lib/dpkg/status",
+        "/var/lib/rpm/Packages",
+        "/var/lib/rpm/rpmdb.sqlite",
+        "/usr/lib/sysimage/rpm/rpmdb.sqlite",
+        "/var/lib/pacman/local",
+        "/lib/apk/db/installed"
+    });
+#elif defined(__APPLE__)
+    return std::make_unique<FileChangeSource>(std::vector<std::string>
+    {
+        "/Applications",
+        "/Library/Receipts/InstallHistory.plist",
+        "/usr/local/Cellar",
+        "/opt/homebrew/Cellar"
+    });
+#else
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<IChangeSource> createNetworkChangeSource()
+{
+#ifdef __linux__
+    return std::make_unique<NetlinkChangeSource>();
+#else
+    return nullptr;
+#endif
+}
@@ -12,9 +12,12 @@
 #include "syscollector.hpp"
 #include "json.hpp"
 #include <iostream>
+#include <algorithm>
+#include <set>
 #include "stringHelper.h"
 #include "hashHelper.h"
 #include "timeHelper.h"
+#include "probe_op.h"
 
 #define TRY_CATCH_TASK(task)                                            \
 do                                                                      \
@@ -23,7 +26,9 @@ do                                                                      \
     {                                                                   \
         if(!m_stopping)                                                 \
         {                                                               \
+            W_PROBE1(task__start, #task);                               \
             task();                                                     \
+            W_PROBE1(task__done, #task);                                \
         }                                                               \
     }                                                                   \
     catch(const std::exception& ex)                                     \
@@ -883,6 +888,9 @@ constexpr auto PROCESSES_TABLE    { "dbsync_processes"        };
 constexpr auto OS_TABLE           { "dbsync_osinfo"           };
 constexpr auto HW_TABLE           { "dbsync_hwinfo"           };
 
+// A sync after a clean one skips the tables without changes, but every table is checked at least once a day.
+constexpr auto FULL_SYNC_PERIOD { std::chrono::hours{24} };
+
 
 static std::string getItemId(const nlohmann::json& item, const std::vector<std::string>& idFields)
 {
@@ -894,7 +902,7 @@ static std::string getItemId(const nlohmann::json& item, const std::vector<std::
 
         if (value.is_string())
         {
-            const auto& valueString{value.get<std::string>()};
+            const auto& valueString{value.get_ref<const std::string&>()};
             hash.update(valueString.c_str(), valueString.size());
         }
         else
@@ -908,6 +916,8 @@ static std::string getItemId(const nlohmann::json& item, const std::vector<std::
     return Utils::asciiToHex(hash.hash());
 }
 
+// The rows stay JSON from ISysInfo to dbsync and rsync, which only take JSON, so the checksum
+// hashes the dump. It has to stay byte for byte the same as the checksums the managers store.
 static std::string getItemChecksum(const nlohmann::json& item)
 {
     const auto content{item.dump()};
@@ -935,20 +945,14 @@ static void removeKeysWithEmptyValue(nlohmann::json& input)
     }
 }
 
-static bool isElementDuplicated(const nlohmann::json& input, const std::pair<std::string, std::string>& keyValue)
+void Syscollector::notifyChange(ReturnTypeCallback result, const nlohmann::json& data, const std::string& table)
 {
-    const auto it
+    if (INSERTED == result || MODIFIED == result || DELETED == result)
     {
-        std::find_if (input.begin(), input.end(), [&keyValue](const auto & elem)
-        {
-            return elem.at(keyValue.first) == keyValue.second;
-        })
-    };
-    return it != input.end();
-}
+        std::lock_guard<std::mutex> lock{m_changedTablesMutex};
+        m_changedTables.insert(table);
+    }
 
-void Syscollector::notifyChange(ReturnTypeCallback result, const nlohmann::json& data, const std::string& table)
-{
     if (DB_ERROR == result)
     {
         m_logFunction(LOG_ERROR, data.dump());
@@ -1014,6 +1018,7 @@ void Syscollector::updateChanges(const std::string& table,
 
 Syscollector::Syscollector()
     : m_intervalValue { 0 }
+    , m_changesInterval { 0 }
     , m_scanOnStart { false }
     , m_hardware { false }
     , m_os { false }
@@ -1025,6 +1030,8 @@ Syscollector::Syscollector()
     , m_hotfixes { false }
     , m_stopping { true }
     , m_notify { false }
+    , m_randomEngine { std::random_device{}() }
+    , m_fullSyncPending { true }
 {}
 
 std::string Syscollector::getCreateStatement() const
@@ -1167,7 +1174,8 @@ void Syscollector::init(const std::shared_ptr<ISysInfo>& spInfo,
                         const bool portsAll,
                         const bool processes,
                         const bool hotfixes,
-                        const bool notifyOnFirstScan)
+                        const bool notifyOnFirstScan,
+                        const unsigned int changesInterval)
 {
     m_spInfo = spInfo;
     m_reportDiffFunction = reportDiffFunction;
@@ -1184,13 +1192,16 @@ void Syscollector::init(const std::shared_ptr<ISysInfo>& spInfo,
     m_processes = processes;
     m_hotfixes = hotfixes;
     m_notify = notifyOnFirstScan;
+    m_changesInterval = changesInterval;
 
     std::unique_lock<std::mutex> lock{m_mutex};
     m_stopping = false;
+    m_fullSyncPending = true;
     m_spDBSync = std::make_unique<DBSync>(HostType::AGENT, DbEngineType::SQLITE3, dbPath, getCreateStatement());
     m_spRsync = std::make_unique<RemoteSync>();
     m_spNormalizer = std::make_unique<SysNormalizer>(normalizerConfigPath, normalizerType);
     registerWithRsync();
+    createChangeSources();
     syncLoop(lock);
 }
 
@@ -1435,6 +1446,13 @@ void Syscollector::scanPackages()
         });
         txn.getDeletedRows(callback);
 
+        for (const auto& source : m_spInfo->packagesSources())
+        {
+            m_logFunction(LOG_DEBUG_VERBOSE, "Packages source '" + source.at("source").get<std::string>() + "': " +
+                          std::to_string(source.at("packages").get<size_t>()) + " packages in " +
+                          std::to_string(source.at("elapsed_ms").get<long long>()) + " ms");
+        }
+
         m_logFunction(LOG_DEBUG_VERBOSE, "Ending packages scan");
     }
 }
@@ -1473,58 +1491,34 @@ void Syscollector::syncHotfixes()
 nlohmann::json Syscollector::getPortsData()
 {
     nlohmann::json ret;
+    // A socket can be listed more than once (e.g. by several processes), the first row of each item id is kept.
+    std::set<std::string> itemIds;
     constexpr auto PORT_LISTENING_STATE { "listening" };
     constexpr auto TCP_PROTOCOL { "tcp" };
     constexpr auto UDP_PROTOCOL { "udp" };
-    const auto& data { m_spInfo->ports() };
+    auto data = m_spInfo->ports();
 
     if (!data.is_null())
     {
-        for (auto item : data)
+        for (auto& item : data)
         {
-            const auto protocol { item.at("protocol").get_ref<const std::string&>() };
-
-            if (Utils::startsWith(protocol, TCP_PROTOCOL))
+            const auto& protocol { item.at("protocol").get_ref<const std::string&>() };
+            // All UDP ports, and TCP ports in listening state unless all of them were requested.
+            const auto isReported
             {
-                // All ports.
-                if (m_portsAll)
-                {
-                    const auto& itemId { getItemId(item, PORTS_ITEM_ID_FIELDS) };
+                Utils::startsWith(protocol, UDP_PROTOCOL) ||
+                (Utils::startsWith(protocol, TCP_PROTOCOL) && (m_portsAll || item.at("state") == PORT_LISTENING_STATE))
+            };
 
-                    if (!isElementDuplicated(ret, std::make_pair("item_id", itemId)))
-                    {
-                        item["checksum"] = getItemChecksum(item);
-                        item["item_id"] = itemId;
-                        ret.push_back(item);
-                    }
-                }
-                else
-                {
-                    // Only listening ports.
-                    const auto isListeningState { item.at("state") == PORT_LISTENING_STATE };
-
-                    if (isListeningState)
-                    {
-                        const auto& itemId { getItemId(item, PORTS_ITEM_ID_FIELDS) };
-
-                        if (!isElementDuplicated(ret, std::make_pair("item_id", itemId)))
-                        {
-                            item["checksum"] = getItemChecksum(item);
-                            item["item_id"] = itemId;
-                            ret.push_back(item);
-                        }
-                    }
-                }
-            }
-            else if (Utils::startsWith(protocol, UDP_PROTOCOL))
+            if (isReported)
             {
-                const auto& itemId { getItemId(item, PORTS_ITEM_ID_FIELDS) };
+                auto itemId { getItemId(item, PORTS_ITEM_ID_FIELDS) };
 
-                if (!isElementDuplicated(ret, std::make_pair("item_id", itemId)))
+                if (itemIds.insert(itemId).second)
                 {
                     item["checksum"] = getItemChecksum(item);
-                    item["item_id"] = itemId;
-                    ret.push_back(item);
+                    item["item_id"] = std::move(itemId);
+                    ret.push_back(std::move(item));
                 }
             }
         }
@@ -1595,6 +1589,7 @@ void Syscollector::scan()
 {
     m_logFunction(LOG_INFO, "Starting evaluation.");
     m_scanTime = Utils::getCurrentTimestamp();
+    W_PROBE(scan__start);
 
     TRY_CATCH_TASK(scanHardware);
     TRY_CATCH_TASK(scanOs);
@@ -1603,23 +1598,163 @@ void Syscollector::scan()
     TRY_CATCH_TASK(scanHotfixes);
     TRY_CATCH_TASK(scanPorts);
     TRY_CATCH_TASK(scanProcesses);
+    W_PROBE(scan__done);
     m_notify = true;
     m_logFunction(LOG_INFO, "Evaluation finished.");
 }
 
 void Syscollector::sync()
 {
+    const auto now { std::chrono::steady_clock::now() };
+    // The manager answered the previous sync, so any table may still differ.
+    const auto fullSync { m_fullSyncPending || now - m_lastFullSync >= FULL_SYNC_PERIOD };
+    std::set<std::string> changedTables;
+
+    {
+        std::lock_guard<std::mutex> lock{m_changedTablesMutex};
+        changedTables.swap(m_changedTables);
+    }
+
+    if (!fullSync && changedTables.empty())
+    {
+        m_logFunction(LOG_DEBUG, "No changes since the last syscollector sync, skipped");
+        return;
+    }
+
+    const auto pending
+    {
+        [fullSync, &changedTables](const std::initializer_list<std::string>& tables)
+        {
+            return fullSync || std::any_of(tables.begin(), tables.end(), [&changedTables](const std::string & table)
+            {
+                return changedTables.count(table) != 0;
+            });
+        }
+    };
+
+    if (fullSync)
+    {
+        m_fullSyncPending = false;
+        m_lastFullSync = now;
+    }
+
     m_logFunction(LOG_DEBUG, "Starting syscollector sync");
-    TRY_CATCH_TASK(syncHardware);
-    TRY_CATCH_TASK(syncOs);
-    TRY_CATCH_TASK(syncNetwork);
-    TRY_CATCH_TASK(syncPackages);
-    TRY_CATCH_TASK(syncHotfixes);
-    TRY_CATCH_TASK(syncPorts);
-    TRY_CATCH_TASK(syncProcesses);
+
+    if (pending({HW_TABLE}))
+    {
+        TRY_CATCH_TASK(syncHardware);
+    }
+
+    if (pending({OS_TABLE}))
+    {
+        TRY_CATCH_TASK(syncOs);
+    }
+
+    if (pending({NET_IFACE_TABLE, NET_PROTOCOL_TABLE, NET_ADDRESS_TABLE}))
+    {
+        TRY_CATCH_TASK(syncNetwork);
+    }
+
+    if (pending({PACKAGES_TABLE}))
+    {
+        TRY_CATCH_TASK(syncPackages);
+    }
+
+    if (pending({HOTFIXES_TABLE}))
+    {
+        TRY_CATCH_TASK(syncHotfixes);
+    }
+
+    if (pending({PORTS_TABLE}))
+    {
+        TRY_CATCH_TASK(syncPorts);
+    }
+
+    if (pending({PROCESSES_TABLE}))
+    {
+        TRY_CATCH_TASK(syncProcesses);
+    }
+
     m_logFunction(LOG_DEBUG, "Ending syscollector sync");
 }
 
+void Syscollector::createChangeSources()
+{
+    // Change sources are only useful if they are checked more often than the full scan runs.
+    if (m_changesInterval == 0 || m_changesInterval >= m_intervalValue)
+    {
+        return;
+    }
+
+    try
+    {
+        if (m_packages)
+        {
+            m_spPackagesChanges = createPackagesChangeSource();
+        }
+
+        if (m_network)
+        {
+            m_spNetworkChanges = createNetworkChangeSource();
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        m_logFunction(LOG_DEBUG, std::string{"Unable to watch for changes: "} + ex.what());
+    }
+}
+
+void Syscollector::scanChanges()
+{
+    const auto packagesChanged { m_spPackagesChanges && m_spPackagesChanges->changed() };
+    const auto networkChanged { m_spNetworkChanges && m_spNetworkChanges->changed() };
+
+    if (packagesChanged || networkChanged)
+    {
+        m_logFunction(LOG_DEBUG, "Starting evaluation of changed categories.");
+        m_scanTime = Utils::getCurrentTimestamp();
+
+        if (networkChanged)
+        {
+            TRY_CATCH_TASK(scanNetwork);
+            TRY_CATCH_TASK(syncNetwork);
+        }
+
+        if (packagesChanged)
+        {
+            TRY_CATCH_TASK(scanPackages);
+            TRY_CATCH_TASK(syncPackages);
+        }
+
+        {
+            // Their changes are already synchronized.
+            std::lock_guard<std::mutex> lock{m_changedTablesMutex};
+
+            if (networkChanged)
+            {
+                m_changedTables.erase(NET_IFACE_TABLE);
+                m_changedTables.erase(NET_PROTOCOL_TABLE);
+                m_changedTables.erase(NET_ADDRESS_TABLE);
+            }
+
+            if (packagesChanged)
+            {
+                m_changedTables.erase(PACKAGES_TABLE);
+            }
+        }
+
+        m_logFunction(LOG_DEBUG, "Evaluation of changed categories finished.");
+    }
+}
+
+std::chrono::seconds Syscollector::scanDelay()
+{
+    // Up to 5% of the interval earlier or later, so agents started together don't scan and sync in lockstep.
+    const auto jitter { static_cast<int>(m_intervalValue / 20) };
+    std::uniform_int_distribution<int> distribution { -jitter, jitter };
+    return std::chrono::seconds{static_cast<int64_t>(m_intervalValue) + distribution(m_randomEngine)};
+}
+
 void Syscollector::syncLoop(std::unique_lock<std::mutex>& lock)
 {
     m_logFunction(LOG_INFO, "Module started.");
@@ -1630,14 +1765,39 @@ void Syscollector::syncLoop(std::unique_lock<std::mutex>& lock)
         sync();
     }
 
-    while (!m_cv.wait_for(lock, std::chrono::seconds{m_intervalValue}, [&]()
+    const auto checkChanges { m_spPackagesChanges || m_spNetworkChanges };
+    auto nextScan { std::chrono::steady_clock::now() + scanDelay() };
+
+    // Between two full scans, the categories with a change source are scanned only when they change.
+    while (!m_cv.wait_until(lock, checkChanges ? std::min(nextScan, std::chrono::steady_clock::now() + std::chrono::seconds{m_changesInterval}) : nextScan, [&]()
 {
     return m_stopping;
 }))
     {
-        scan();
-        sync();
+        if (std::chrono::steady_clock::now() >= nextScan)
+        {
+            // The pending changes are covered by the full scan.
+            if (m_spPackagesChanges)
+            {
+                m_spPackagesChanges->changed();
+            }
+
+            if (m_spNetworkChanges)
+            {
+                m_spNetworkChanges->changed();
+            }
+
+            scan();
+            sync();
+            nextScan = std::chrono::steady_clock::now() + scanDelay();
+        }
+        else
+        {
+            scanChanges();
+        }
     }
+    m_spPackagesChanges.reset(nullptr);
+    m_spNetworkChanges.reset(nullptr);
     m_spRsync.reset(nullptr);
     m_spDBSync.reset(nullptr);
 }
@@ -1651,6 +1811,7 @@ void Syscollector::push(const std::string& data)
         auto rawData{data};
         Utils::replaceFirst(rawData, "dbsync ", "");
         const auto buff{reinterpret_cast<const uint8_t*>(rawData.c_str())};
+        m_fullSyncPending = true;
 
         try
         {
@@ -13,13 +13,138 @@
 #include <regex>
 #include <syscollectorNormalizer.h>
 
+constexpr auto ANY_SEQUENCE {".*"};
+constexpr auto LINE_TERMINATORS {"\n\r"};
+constexpr auto REGEX_SPECIAL_CHARS {"\\^$.|?*+()[]{}"};
+
+static bool isLiteral(const std::string& text)
+{
+    return text.find_first_of(REGEX_SPECIAL_CHARS) == std::string::npos;
+}
+
+static bool startsWith(const std::string& str, const std::string& start)
+{
+    return str.size() >= start.size() && str.compare(0, start.size(), start) == 0;
+}
+
+static bool endsWith(const std::string& str, const std::string& ending)
+{
+    return str.size() >= ending.size() && str.compare(str.size() - ending.size(), ending.size(), ending) == 0;
+}
+
+SysNormalizerPattern::SysNormalizerPattern(const std::string& pattern)
+    : m_matchType{MatchType::REGEX}
+    , m_regex{pattern}
+{
+    // Recognizes "[.*](literal)[.*]", where the group is optional.
+    auto core{pattern};
+    const auto anyPrefix{startsWith(core, ANY_SEQUENCE)};
+
+    if (anyPrefix)
+    {
+        core.erase(0, 2);
+    }
+
+    const auto anySuffix{endsWith(core, ANY_SEQUENCE)};
+
+    if (anySuffix)
+    {
+        core.erase(core.size() - 2);
+    }
+
+    if (core.size() >= 2 && core.front() == '(' && core.back() == ')')
+    {
+        core = core.substr(1, core.size() - 2);
+    }
+
+    if (isLiteral(core))
+    {
+        m_literal = core;
+        m_matchType = anyPrefix ? (anySuffix ? MatchType::CONTAINS : MatchType::SUFFIX)
+                      : (anySuffix ? MatchType::PREFIX : MatchType::EXACT);
+    }
+}
+
+bool SysNormalizerPattern::match(const std::string& value) const
+{
+    // '.' does not match line terminators, so a literal can't match a value containing them.
+    if (m_matchType != MatchType::REGEX && m_matchType != MatchType::EXACT &&
+            value.find_first_of(LINE_TERMINATORS) != std::string::npos)
+    {
+        return false;
+    }
+
+    switch (m_matchType)
+    {
+        case MatchType::EXACT:
+            return value == m_literal;
+
+        case MatchType::PREFIX:
+            return startsWith(value, m_literal);
+
+        case MatchType::SUFFIX:
+            return endsWith(value, m_literal);
+
+        case MatchType::CONTAINS:
+            return value.find(m_literal) != std::string::npos;
+
+        default:
+            return std::regex_match(value, m_regex);
+    }
+}
+
+std::string SysNormalizerPattern::replace(const std::string& value,
+                                          const std::string& format) const
+{
+    if (m_matchType != MatchType::EXACT || m_literal.empty() || format.find('$') != std::string::npos)
+    {
+        return std::regex_replace(value, m_regex, format);
+    }
+
+    std::string ret;
+    size_t start{0};
+    size_t pos;
+
+    while ((pos = value.find(m_literal, start)) != std::string::npos)
+    {
+        ret.append(value, start, pos - start);
+        ret.append(format);
+        start = pos + m_literal.size();
+    }
+
+    ret.append(value, start, std::string::npos);
+    return ret;
+}
+
 SysNormalizer::SysNormalizer(const std::string& configFile,
                              const std::string& target)
-    : m_typeExclusions{getTypeValues(configFile, target, "exclusions")}
-    , m_typeDictionary{getTypeValues(configFile, target, "dictionary")}
+    : m_typeExclusions{compileExclusions(getTypeValues(configFile, target, "exclusions"))}
+    , m_typeDictionary{compileDictionary(getTypeValues(configFile, target, "dictionary"))}
 {
 }
 
+static bool fieldMatches(const nlohmann::json& item,
+                         const std::string& fieldName,
+                         const SysNormalizerPattern& pattern)
+{
+    const auto fieldIt{item.find(fieldName)};
+    return fieldIt != item.end() && fieldIt->is_string() && pattern.match(fieldIt->get_ref<const std::string&>());
+}
+
+static bool isExcluded(const std::vector<SysNormalizerExclusion>& exclusions,
+                       const nlohmann::json& item)
+{
+    for (const auto& exclusion : exclusions)
+    {
+        if (fieldMatches(item, exclusion.fieldName, *exclusion.pattern))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void SysNormalizer::removeExcluded(const std::string& type,
                                    nlohmann::json& data) const
 {
@@ -27,92 +152,52 @@ void SysNormalizer::removeExcluded(const std::string& type,
 
     if (exclusionsIt != m_typeExclusions.cend())
     {
-        for (const auto& exclusionItem : exclusionsIt->second)
+        if (data.is_array())
         {
-            try
+            for (auto item{data.begin()}; item != data.end();)
             {
-                std::regex pattern{exclusionItem["pattern"].get_ref<const std::string&>()};
-                const auto& fieldName{exclusionItem["field_name"].get_ref<const std::string&>()};
-
-                if (data.is_array())
+                if (isExcluded(exclusionsIt->second, *item))
                 {
-                    for (auto item{data.begin()}; item != data.end(); ++item)
-                    {
-                        const auto fieldIt{item->find(fieldName)};
-
-                        if (fieldIt != item->end() && std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
-                        {
-                            data.erase(item);
-                        }
-                    }
+                    item = data.erase(item);
                 }
                 else
                 {
-                    const auto fieldIt{data.find(fieldName)};
-
-                    if (fieldIt != data.end() && std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
-                    {
-                        data.clear();
-                    }
+                    ++item;
                 }
             }
-            // LCOV_EXCL_START
-            catch (...)
-            {}
-
-            // LCOV_EXCL_STOP
+        }
+        else if (isExcluded(exclusionsIt->second, data))
+        {
+            data.clear();
         }
     }
 }
 
 
-static void normalizeItem(const nlohmann::json& dictionary,
+static void normalizeItem(const std::vector<SysNormalizerRule>& dictionary,
                           nlohmann::json& item)
 {
-    for (const auto& dictItem : dictionary)
+    for (const auto& rule : dictionary)
     {
-        const auto itFindPattern{dictItem.find("find_pattern")};
-        const auto itFindField{dictItem.find("find_field")};
-
-        if (itFindPattern != dictItem.end() && itFindField != dictItem.end())
-        {
-            const auto fieldIt{item.find(itFindField->get_ref<const std::string&>())};
-            std::regex pattern{itFindPattern->get_ref<const std::string&>()};
-
-            if (fieldIt == item.end() ||
-                    !std::regex_match(fieldIt->get_ref<const std::string&>(), pattern))
-            {
-                //no field in the item or no matching, we continue
-                continue;
-            }
-        }
-        else if (itFindPattern != dictItem.end() || itFindField != dictItem.end())
+        if (rule.findPattern && !fieldMatches(item, rule.findField, *rule.findPattern))
         {
-            //we won't evaluate an incomplete item.
+            //no field in the item or no matching, we continue
             continue;
         }
 
-        const auto itReplacePattern{dictItem.find("replace_pattern")};
-        const auto itReplaceField{dictItem.find("replace_field")};
-        const auto itReplaceValue{dictItem.find("replace_value")};
-
-        if (itReplacePattern != dictItem.end() && itReplaceField != dictItem.end() && itReplaceValue != dictItem.end())
+        if (rule.replacePattern)
         {
-            std::regex pattern{itReplacePattern->get_ref<const std::string&>()};
-            const auto fieldIt{item.find(itReplaceField->get_ref<const std::string&>())};
+            const auto fieldIt{item.find(rule.replaceField)};
 
-            if (fieldIt != item.end())
+            if (fieldIt != item.end() && fieldIt->is_string())
             {
-                *fieldIt = std::regex_replace(fieldIt->get_ref<const std::string&>(), pattern, itReplaceValue->get_ref<const std::string&>());
+                *fieldIt = rule.replacePattern->replace(fieldIt->get_ref<const std::string&>(), rule.replaceValue);
             }
         }
 
-        const auto itAddField{dictItem.find("add_field")};
-        const auto itAddValue{dictItem.find("add_value")};
-
-        if (itAddField != dictItem.end() && itAddValue != dictItem.end())
+        if (rule.hasAdd)
         {
-            item[itAddField->get_ref<const std::string&>()] = itAddValue->get_ref<const std::string&>();
+            item[rule.addField] = rule.addValue;
         }
     }
 }
@@ -138,6 +223,92 @@ void SysNormalizer::normalize(const std::string& type,
     }
 }
 
+std::map<std::string, std::vector<SysNormalizerExclusion>> SysNormalizer::compileExclusions(const std::map<std::string, nlohmann::json>& typeValues)
+{
+    std::map<std::string, std::vector<SysNormalizerExclusion>> ret;
+
+    for (const auto& typeValue : typeValues)
+    {
+        auto& exclusions{ret[typeValue.first]};
+
+        for (const auto& exclusionItem : typeValue.second)
+        {
+            try
+            {
+                exclusions.push_back(
+                {
+                    exclusionItem.at("field_name").get<std::string>(),
+                    std::make_shared<SysNormalizerPattern>(exclusionItem.at("pattern").get_ref<const std::string&>())
+                });
+            }
+            // Items with missing fields or invalid patterns are ignored.
+            catch (...)
+            {}
+        }
+    }
+
+    return ret;
+}
+
+std::map<std::string, std::vector<SysNormalizerRule>> SysNormalizer::compileDictionary(const std::map<std::string, nlohmann::json>& typeValues)
+{
+    std::map<std::string, std::vector<SysNormalizerRule>> ret;
+
+    for (const auto& typeValue : typeValues)
+    {
+        auto& dictionary{ret[typeValue.first]};
+
+        for (const auto& dictItem : typeValue.second)
+        {
+            try
+            {
+                SysNormalizerRule rule{};
+                const auto itFindPattern{dictItem.find("find_pattern")};
+                const auto itFindField{dictItem.find("find_field")};
+
+                if (itFindPattern != dictItem.end() && itFindField != dictItem.end())
+                {
+                    rule.findField = itFindField->get<std::string>();
+                    rule.findPattern = std::make_shared<SysNormalizerPattern>(itFindPattern->get_ref<const std::string&>());
+                }
+                else if (itFindPattern != dictItem.end() || itFindField != dictItem.end())
+                {
+                    //we won't evaluate an incomplete item.
+                    continue;
+                }
+
+                const auto itReplacePattern{dictItem.find("replace_pattern")};
+                const auto itReplaceField{dictItem.find("replace_field")};
+                const auto itReplaceValue{dictItem.find("replace_value")};
+
+                if (itReplacePattern != dictItem.end() && itReplaceField != dictItem.end() && itReplaceValue != dictItem.end())
+                {
+                    rule.replaceField = itReplaceField->get<std::string>();
+                    rule.replaceValue = itReplaceValue->get<std::string>();
+                    rule.replacePattern = std::make_shared<SysNormalizerPattern>(itReplacePattern->get_ref<const std::string&>());
+                }
+
+                const auto itAddField{dictItem.find("add_field")};
+                const auto itAddValue{dictItem.find("add_value")};
+
+                if (itAddField != dictItem.end() && itAddValue != dictItem.end())
+                {
+                    rule.addField = itAddField->get<std::string>();
+                    rule.addValue = itAddValue->get<std::string>();
+                    rule.hasAdd = true;
+                }
+
+                dictionary.push_back(std::move(rule));
+            }
+            // Items with missing fields or invalid patterns are ignored.
+            catch (...)
+            {}
+        }
+    }
+
+    return ret;
+}
+
 std::map<std::string, nlohmann::json> SysNormalizer::getTypeValues(const std::string& configFile,
                                                                    const std::string& target,
                                                                    const std::string& type)
@@ -0,0 +1,80 @@
+/*
+ * Wazuh SyscollectorChanges
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#include "sysChanges_test.h"
+#include "syscollectorChanges.h"
+#include <fstream>
+#include <cstdio>
+
+constexpr auto TEST_PACKAGES_FILE {"test_packages_db"};
+constexpr auto TEST_MISSING_FILE {"test_missing_db"};
+
+void SysChangesTest::SetUp()
+{
+    std::ofstream file{TEST_PACKAGES_FILE};
+    file << "Package: wazuh-agent" << std::endl;
+};
+
+void SysChangesTest::TearDown()
+{
+    std::remove(TEST_PACKAGES_FILE);
+    std::remove(TEST_MISSING_FILE);
+};
+
+TEST_F(SysChangesTest, fileUnchanged)
+{
+    FileChangeSource source{{TEST_PACKAGES_FILE, TEST_MISSING_FILE}};
+    EXPECT_FALSE(source.changed());
+    EXPECT_FALSE(source.changed());
+}
+
+TEST_F(SysChangesTest, fileModified)
+{
+    FileChangeSource source{{TEST_PACKAGES_FILE}};
+    {
+        std::ofstream file{TEST_PACKAGES_FILE, std::ios_base::app};
+        file << "Version: 4.6.0" << std::endl;
+    }
+    EXPECT_TRUE(source.changed());
+    EXPECT_FALSE(source.changed());
+}
+
+TEST_F(SysChangesTest, fileCreatedAndRemoved)
+{
+    FileChangeSource source{{TEST_MISSING_FILE}};
+    {
+        std::ofstream file{TEST_MISSING_FILE};
+    }
+    EXPECT_TRUE(source.changed());
+    std::remove(TEST_MISSING_FILE);
+    EXPECT_TRUE(source.changed());
+    EXPECT_FALSE(source.changed());
+}
+
+TEST_F(SysChangesTest, packagesChangeSource)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    const auto source{createPackagesChangeSource()};
+    ASSERT_NE(nullptr, source);
+    EXPECT_FALSE(source->changed());
+#else
+    EXPECT_EQ(nullptr, createPackagesChangeSource());
+#endif
+}
+
+#ifdef __linux__
+TEST_F(SysChangesTest, netlinkNoEvents)
+{
+    NetlinkChangeSource source;
+    // Only the notifications received after the socket was bound are reported.
+    source.changed();
+    EXPECT_FALSE(source.changed());
+}
+#endif
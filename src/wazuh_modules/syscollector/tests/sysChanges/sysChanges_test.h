@@ -0,0 +1,27 @@
+/*
+ * Wazuh SyscollectorChanges
+ * Copyright (C) 2015, Wazuh Inc.
+ * October 14, 2026.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+#ifndef _SYS_CHANGES_TEST_H
+#define _SYS_CHANGES_TEST_H
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+class SysChangesTest : public ::testing::Test
+{
+    protected:
+
+        SysChangesTest() = default;
+        virtual ~SysChangesTest() = default;
+
+        void SetUp() override;
+        void TearDown() override;
+};
+
+#endif //_SYS_CHANGES_TEST_H
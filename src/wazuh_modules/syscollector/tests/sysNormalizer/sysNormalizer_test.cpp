@@ -246,3 +246,57 @@ TEST_F(SysNormalizerTest, normalizeItemMatch)
     EXPECT_EQ(inputJson.size(), origJson.size());
     EXPECT_NE(inputJson, origJson);
 }
+
+TEST_F(SysNormalizerTest, excludeConsecutiveItems)
+{
+    auto inputJson(nlohmann::json::parse(R"([
+        {"name": "Siri"},
+        {"name": "iCloud"},
+        {"name": "FaceTime"}
+    ])"));
+    SysNormalizer normalizer{TEST_CONFIG_FILE_NAME, "macos"};
+    normalizer.removeExcluded("packages", inputJson);
+    ASSERT_EQ(inputJson.size(), 1ull);
+    EXPECT_EQ(inputJson[0]["name"], "FaceTime");
+}
+
+TEST_F(SysNormalizerTest, patternLiteralShapes)
+{
+    EXPECT_TRUE(SysNormalizerPattern{"(Siri)"}.match("Siri"));
+    EXPECT_FALSE(SysNormalizerPattern{"(Siri)"}.match("Siri Launcher"));
+    EXPECT_TRUE(SysNormalizerPattern{"Kaspersky.*"}.match("Kaspersky Antivirus"));
+    EXPECT_FALSE(SysNormalizerPattern{"Kaspersky.*"}.match("The Kaspersky"));
+    EXPECT_TRUE(SysNormalizerPattern{".*For Mac"}.match("Antivirus For Mac"));
+    EXPECT_TRUE(SysNormalizerPattern{".*(Quick ).*"}.match("Quick Heal Total Security"));
+    EXPECT_FALSE(SysNormalizerPattern{".*(Quick ).*"}.match("QuickHeal"));
+    // '.' does not match line terminators, as in std::regex.
+    EXPECT_FALSE(SysNormalizerPattern{".*Microsoft.*"}.match("Microsoft\nOffice"));
+    EXPECT_TRUE(SysNormalizerPattern{"(zoom.us)"}.match("zoomXus"));
+}
+
+TEST_F(SysNormalizerTest, patternReplace)
+{
+    EXPECT_EQ(SysNormalizerPattern{"(AVG)"}.replace("AVGAntivirusAVG", ""), "Antivirus");
+    EXPECT_EQ(SysNormalizerPattern{"(zoom.us)"}.replace("zoom.us", "zoom"), "zoom");
+    EXPECT_EQ(SysNormalizerPattern{"(AVG)"}.replace("AVG Antivirus", "[$1]"), "[AVG] Antivirus");
+}
+
+TEST_F(SysNormalizerTest, ctorInvalidPattern)
+{
+    constexpr auto INVALID_PATTERN_FILE{"invalid_pattern.json"};
+    std::ofstream testConfigFile{INVALID_PATTERN_FILE};
+
+    if (testConfigFile.is_open())
+    {
+        testConfigFile << R"DELIMITER({"exclusions":[{"target":"macos","data_type":"packages","field_name":"name","pattern":"(Siri"},
+                                                      {"target":"macos","data_type":"packages","field_name":"name","pattern":"(iCloud)"}]})DELIMITER";
+        testConfigFile.close();
+    }
+
+    SysNormalizer normalizer{INVALID_PATTERN_FILE, "macos"};
+    auto inputJson(nlohmann::json::parse(R"([{"name": "Siri"}, {"name": "iCloud"}])"));
+    normalizer.removeExcluded("packages", inputJson);
+    ASSERT_EQ(inputJson.size(), 1ull);
+    EXPECT_EQ(inputJson[0]["name"], "Siri");
+    std::remove(INVALID_PATTERN_FILE);
+}
@@ -19,6 +19,9 @@
 #define WM_TASK_MAX_IN_PROGRESS_TIME 900 // 15 minutes
 #define WM_TASK_CLEANUP_DB_SLEEP_TIME 86400 // A day
 #define WM_TASK_DEFAULT_CLEANUP_TIME 604800 // A week
+#define WM_TASK_CLEANUP_DB_BATCH 1000 // Tasks deleted per cleanup step
+#define WM_TASK_CLEANUP_DB_STEP_TIME 1 // Seconds between cleanup steps
+#define WM_TASK_MAX_BULK_AGENTS 100 // Agents per tasks DB request
 
 typedef struct _wm_task_manager {
     int enabled:1;
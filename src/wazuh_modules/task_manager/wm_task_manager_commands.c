@@ -73,6 +73,17 @@ STATIC cJSON* wm_task_manager_command_upgrade_cancel_tasks(wm_task_manager_upgra
  * */
 STATIC cJSON* wm_task_manager_send_message_to_wdb(const char *command, cJSON *parameters, int *error_code) __attribute__((nonnull));
 
+/**
+ * Send a bulk request to Wazuh DB for the next batch of agents.
+ * @param command Command to be send.
+ * @param parameters cJSON with the parameters, the agents of the batch are added to it.
+ * @param agent_ids Array of agent ids, ending with OS_INVALID.
+ * @param agent_it Index of the first agent of the batch, moved to the first agent of the next one.
+ * @param error_code Variable to store an error code if something is wrong.
+ * @return JSON array with the response for every agent of the batch, NULL on errors.
+ * */
+STATIC cJSON* wm_task_manager_send_bulk_to_wdb(const char *command, cJSON *parameters, const int *agent_ids, int *agent_it, int *error_code) __attribute__((nonnull));
+
 cJSON* wm_task_manager_process_task(const wm_task_manager_task *task, int *error_code) {
     cJSON *response = NULL;
 
@@ -103,48 +114,48 @@ cJSON* wm_task_manager_process_task(const wm_task_manager_task *task, int *error
 STATIC cJSON* wm_task_manager_command_upgrade(wm_task_manager_upgrade *task, int command, int *error_code) {
     cJSON *response = cJSON_CreateArray();
     int agent_it = 0;
-    int agent_id = 0;
 
-    while (agent_id = task->agent_ids[agent_it++], agent_id != OS_INVALID) {
+    while (task->agent_ids[agent_it] != OS_INVALID) {
         cJSON *parameters = cJSON_CreateObject();
-        cJSON *wdb_response = NULL;
+        cJSON *wdb_data = NULL;
+        cJSON *wdb_agent = NULL;
 
-        cJSON_AddNumberToObject(parameters, task_manager_json_keys[WM_TASK_AGENT_ID], agent_id);
         cJSON_AddStringToObject(parameters, task_manager_json_keys[WM_TASK_NODE], task->node);
         cJSON_AddStringToObject(parameters, task_manager_json_keys[WM_TASK_MODULE], task->module);
 
-        if (wdb_response = wm_task_manager_send_message_to_wdb(task_manager_commands_list[command], parameters, error_code), wdb_response) {
+        wdb_data = wm_task_manager_send_bulk_to_wdb(task_manager_commands_list[command], parameters, task->agent_ids, &agent_it, error_code);
+        cJSON_Delete(parameters);
 
-            cJSON *wdb_error = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_ERROR]);
+        if (!wdb_data) {
+            cJSON_Delete(response);
+            return NULL;
+        }
 
-            if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_SUCCESS)) {
+        cJSON_ArrayForEach(wdb_agent, wdb_data) {
+            cJSON *agent_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_AGENT_ID]);
+            cJSON *wdb_error = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_ERROR]);
+
+            if (agent_json && (agent_json->type == cJSON_Number) &&
+                wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_SUCCESS)) {
                 int task_id = OS_INVALID;
 
-                cJSON *task_id_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_TASK_ID]);
+                cJSON *task_id_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_TASK_ID]);
 
                 if (task_id_json && (task_id_json->type == cJSON_Number)) {
                     task_id = task_id_json->valueint;
                 }
 
-                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_id, task_id, NULL));
+                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_json->valueint, task_id, NULL));
 
             } else {
                 *error_code = WM_TASK_DATABASE_ERROR;
-                cJSON_Delete(wdb_response);
-                cJSON_Delete(parameters);
+                cJSON_Delete(wdb_data);
                 cJSON_Delete(response);
                 return NULL;
             }
-
-            cJSON_Delete(wdb_response);
-
-        } else {
-            cJSON_Delete(parameters);
-            cJSON_Delete(response);
-            return NULL;
         }
 
-        cJSON_Delete(parameters);
+        cJSON_Delete(wdb_data);
     }
 
     return response;
@@ -202,13 +213,12 @@ STATIC cJSON* wm_task_manager_command_upgrade_get_status(wm_task_manager_upgrade
 STATIC cJSON* wm_task_manager_command_upgrade_update_status(wm_task_manager_upgrade_update_status *task, int *error_code) {
     cJSON *response = cJSON_CreateArray();
     int agent_it = 0;
-    int agent_id = 0;
 
-    while (agent_id = task->agent_ids[agent_it++], agent_id != OS_INVALID) {
+    while (task->agent_ids[agent_it] != OS_INVALID) {
         cJSON *parameters = cJSON_CreateObject();
-        cJSON *wdb_response = NULL;
+        cJSON *wdb_data = NULL;
+        cJSON *wdb_agent = NULL;
 
-        cJSON_AddNumberToObject(parameters, task_manager_json_keys[WM_TASK_AGENT_ID], agent_id);
         cJSON_AddStringToObject(parameters, task_manager_json_keys[WM_TASK_NODE], task->node);
         cJSON_AddStringToObject(parameters, task_manager_json_keys[WM_TASK_STATUS], task->status);
         if (task->error_msg) {
@@ -216,31 +226,34 @@ STATIC cJSON* wm_task_manager_command_upgrade_update_status(wm_task_manager_upgr
         }
 
         // Update upgrade task status
-        if (wdb_response = wm_task_manager_send_message_to_wdb(task_manager_commands_list[WM_TASK_UPGRADE_UPDATE_STATUS], parameters, error_code), wdb_response) {
+        wdb_data = wm_task_manager_send_bulk_to_wdb(task_manager_commands_list[WM_TASK_UPGRADE_UPDATE_STATUS], parameters, task->agent_ids, &agent_it, error_code);
+        cJSON_Delete(parameters);
 
-            cJSON *wdb_error = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_ERROR]);
+        if (!wdb_data) {
+            cJSON_Delete(response);
+            return NULL;
+        }
 
-            if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_SUCCESS)) {
-                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_id, OS_INVALID, NULL));
-            } else if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_NOTFOUND)) {
-                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_DATABASE_NO_TASK, agent_id, OS_INVALID, NULL));
-            } else {
+        cJSON_ArrayForEach(wdb_agent, wdb_data) {
+            cJSON *agent_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_AGENT_ID]);
+            cJSON *wdb_error = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_ERROR]);
+
+            if (!agent_json || (agent_json->type != cJSON_Number) || !wdb_error || (wdb_error->type != cJSON_Number) ||
+                ((wdb_error->valueint != OS_SUCCESS) && (wdb_error->valueint != OS_NOTFOUND))) {
                 *error_code = WM_TASK_DATABASE_ERROR;
-                cJSON_Delete(wdb_response);
-                cJSON_Delete(parameters);
+                cJSON_Delete(wdb_data);
                 cJSON_Delete(response);
                 return NULL;
             }
 
-            cJSON_Delete(wdb_response);
-
-        } else {
-            cJSON_Delete(parameters);
-            cJSON_Delete(response);
-            return NULL;
+            if (wdb_error->valueint == OS_SUCCESS) {
+                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_json->valueint, OS_INVALID, NULL));
+            } else {
+                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_DATABASE_NO_TASK, agent_json->valueint, OS_INVALID, NULL));
+            }
         }
 
-        cJSON_Delete(parameters);
+        cJSON_Delete(wdb_data);
     }
 
     return response;
@@ -249,20 +262,34 @@ STATIC cJSON* wm_task_manager_command_upgrade_update_status(wm_task_manager_upgr
 STATIC cJSON* wm_task_manager_command_upgrade_result(wm_task_manager_upgrade_result *task, int *error_code) {
     cJSON *response = cJSON_CreateArray();
     int agent_it = 0;
-    int agent_id = 0;
 
-    while (agent_id = task->agent_ids[agent_it++], agent_id != OS_INVALID) {
+    while (task->agent_ids[agent_it] != OS_INVALID) {
         cJSON *parameters = cJSON_CreateObject();
-        cJSON *wdb_response = NULL;
-
-        cJSON_AddNumberToObject(parameters, task_manager_json_keys[WM_TASK_AGENT_ID], agent_id);
+        cJSON *wdb_data = NULL;
+        cJSON *wdb_agent = NULL;
 
         // Upgrade result task
-        if (wdb_response = wm_task_manager_send_message_to_wdb(task_manager_commands_list[WM_TASK_UPGRADE_RESULT], parameters, error_code), wdb_response) {
+        wdb_data = wm_task_manager_send_bulk_to_wdb(task_manager_commands_list[WM_TASK_UPGRADE_RESULT], parameters, task->agent_ids, &agent_it, error_code);
+        cJSON_Delete(parameters);
 
-            cJSON *wdb_error = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_ERROR]);
+        if (!wdb_data) {
+            cJSON_Delete(response);
+            return NULL;
+        }
 
-            if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_SUCCESS)) {
+        cJSON_ArrayForEach(wdb_agent, wdb_data) {
+            cJSON *agent_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_AGENT_ID]);
+            cJSON *wdb_error = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_ERROR]);
+
+            if (!agent_json || (agent_json->type != cJSON_Number) || !wdb_error || (wdb_error->type != cJSON_Number) ||
+                ((wdb_error->valueint != OS_SUCCESS) && (wdb_error->valueint != OS_NOTFOUND))) {
+                *error_code = WM_TASK_DATABASE_ERROR;
+                cJSON_Delete(wdb_data);
+                cJSON_Delete(response);
+                return NULL;
+            }
+
+            if (wdb_error->valueint == OS_SUCCESS) {
                 int task_id = OS_INVALID;
                 char *node_result = NULL;
                 char *module_result = NULL;
@@ -272,14 +299,14 @@ STATIC cJSON* wm_task_manager_command_upgrade_result(wm_task_manager_upgrade_res
                 int create_time = OS_INVALID;
                 int last_update_time = OS_INVALID;
 
-                cJSON *task_id_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_TASK_ID]);
-                cJSON *node_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_NODE]);
-                cJSON *module_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_MODULE]);
-                cJSON *command_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_COMMAND]);
-                cJSON *status_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_STATUS]);
-                cJSON *error_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_ERROR_MSG]);
-                cJSON *create_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_CREATE_TIME]);
-                cJSON *update_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_LAST_UPDATE_TIME]);
+                cJSON *task_id_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_TASK_ID]);
+                cJSON *node_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_NODE]);
+                cJSON *module_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_MODULE]);
+                cJSON *command_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_COMMAND]);
+                cJSON *status_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_STATUS]);
+                cJSON *error_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_ERROR_MSG]);
+                cJSON *create_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_CREATE_TIME]);
+                cJSON *update_json = cJSON_GetObjectItem(wdb_agent, task_manager_json_keys[WM_TASK_LAST_UPDATE_TIME]);
 
                 if (task_id_json && (task_id_json->type == cJSON_Number)) {
                     task_id = task_id_json->valueint;
@@ -306,29 +333,15 @@ STATIC cJSON* wm_task_manager_command_upgrade_result(wm_task_manager_upgrade_res
                     last_update_time = update_json->valueint;
                 }
 
-                cJSON *tmp = wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_id, task_id, NULL);
+                cJSON *tmp = wm_task_manager_parse_data_response(WM_TASK_SUCCESS, agent_json->valueint, task_id, NULL);
                 wm_task_manager_parse_data_result(tmp, node_result, module_result, command_result, status, error, create_time, last_update_time, task_manager_commands_list[WM_TASK_UPGRADE_RESULT]);
                 cJSON_AddItemToArray(response, tmp);
-
-            } else if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_NOTFOUND)) {
-                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_DATABASE_NO_TASK, agent_id, OS_INVALID, NULL));
             } else {
-                *error_code = WM_TASK_DATABASE_ERROR;
-                cJSON_Delete(wdb_response);
-                cJSON_Delete(parameters);
-                cJSON_Delete(response);
-                return NULL;
+                cJSON_AddItemToArray(response, wm_task_manager_parse_data_response(WM_TASK_DATABASE_NO_TASK, agent_json->valueint, OS_INVALID, NULL));
             }
-
-            cJSON_Delete(wdb_response);
-
-        } else {
-            cJSON_Delete(parameters);
-            cJSON_Delete(response);
-            return NULL;
         }
 
-        cJSON_Delete(parameters);
+        cJSON_Delete(wdb_data);
     }
 
     return response;
@@ -407,11 +420,20 @@ void* wm_task_manager_clean_tasks(void *arg) {
             int error_code = WM_TASK_SUCCESS;
 
             cJSON_AddNumberToObject(parameters, task_manager_json_keys[WM_TASK_TIMESTAMP], (now - config->cleanup_time));
+            cJSON_AddNumberToObject(parameters, task_manager_json_keys[WM_TASK_LIMIT], WM_TASK_CLEANUP_DB_BATCH);
 
             // Set next clean time
             next_clean = now + WM_TASK_CLEANUP_DB_SLEEP_TIME;
 
             if (wdb_response = wm_task_manager_send_message_to_wdb(task_manager_commands_list[WM_TASK_DELETE_OLD], parameters, &error_code), wdb_response) {
+
+                cJSON *deleted_json = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_DELETED]);
+
+                // Delete the rest of the old tasks in small steps, so the tasks DB isn't locked for long
+                if (deleted_json && (deleted_json->type == cJSON_Number) && (deleted_json->valueint >= WM_TASK_CLEANUP_DB_BATCH)) {
+                    next_clean = now + WM_TASK_CLEANUP_DB_STEP_TIME;
+                }
+
                 cJSON_Delete(wdb_response);
             }
 
@@ -434,6 +456,35 @@ void* wm_task_manager_clean_tasks(void *arg) {
     return NULL;
 }
 
+STATIC cJSON* wm_task_manager_send_bulk_to_wdb(const char *command, cJSON *parameters, const int *agent_ids, int *agent_it, int *error_code) {
+    cJSON *agents = cJSON_CreateArray();
+    cJSON *wdb_response = NULL;
+    cJSON *wdb_data = NULL;
+    int agent_count = 0;
+
+    while ((agent_ids[*agent_it] != OS_INVALID) && (agent_count++ < WM_TASK_MAX_BULK_AGENTS)) {
+        cJSON_AddItemToArray(agents, cJSON_CreateNumber(agent_ids[(*agent_it)++]));
+    }
+
+    cJSON_AddItemToObject(parameters, task_manager_json_keys[WM_TASK_AGENTS], agents);
+
+    if (wdb_response = wm_task_manager_send_message_to_wdb(command, parameters, error_code), wdb_response) {
+
+        cJSON *wdb_error = cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_ERROR]);
+
+        if (wdb_error && (wdb_error->type == cJSON_Number) && (wdb_error->valueint == OS_SUCCESS) &&
+            cJSON_IsArray(cJSON_GetObjectItem(wdb_response, task_manager_json_keys[WM_TASK_DATA]))) {
+            wdb_data = cJSON_DetachItemFromObject(wdb_response, task_manager_json_keys[WM_TASK_DATA]);
+        } else {
+            *error_code = WM_TASK_DATABASE_ERROR;
+        }
+
+        cJSON_Delete(wdb_response);
+    }
+
+    return wdb_data;
+}
+
 STATIC cJSON* wm_task_manager_send_message_to_wdb(const char *command, cJSON *parameters, int *error_code) {
     cJSON *response = NULL;
     const char *json_err;
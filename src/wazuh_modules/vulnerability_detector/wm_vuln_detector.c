@@ -44,6 +44,19 @@ STATIC void *wm_vuldet_main(wm_vuldet_t * vuldet);
 STATIC void wm_vuldet_destroy(wm_vuldet_t * vuldet);
 STATIC int wm_vuldet_run_update(update_node **updates);
 STATIC char *wm_vuldet_oval_xml_preparser(char *path, vu_feed dist);
+
+/**
+ * @brief Parse a downloaded feed and store it in the CVE database.
+ *
+ * The feed is only stored in the SQL tables, there is no compiled image of it. Scans look up
+ * each agent package with the IN_VUL_PACK_TARGET index, refreshed by ANALYZE at the end of
+ * the update, and compare the versions through the cached keys of pkg_version_key().
+ * A compiled image would have to duplicate the OVAL variables, architectures and dependencies
+ * that the scans join in SQL.
+ *
+ * @param update Feed to index.
+ * @return 0 on success, OS_INVALID otherwise.
+ */
 STATIC int wm_vuldet_index_feed(update_node *update);
 STATIC int wm_vuldet_fetch_feed(update_node *update, int8_t *need_update);
 
@@ -179,6 +192,52 @@ STATIC int wm_vuldet_find_obsolete_vulnerabilities(scan_ctx_t* scan_ctx);
  */
 STATIC int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet);
 
+/**
+ * @brief Reorder the agents linked list so that the agents of the same OS feed are contiguous.
+ * The groups keep the order in which their first agent appears, and so do the agents inside them.
+ * @param agents The agents linked list.
+ * @return The head of the reordered list.
+ */
+STATIC scan_agent *wm_vuldet_group_agents_by_feed(scan_agent *agents);
+
+/**
+ * @brief Log the time taken to scan the agents of a feed group.
+ * @param dist_ver Feed of the group.
+ * @param scanned Number of agents scanned in the group.
+ * @param start Time when the group started.
+ */
+STATIC void wm_vuldet_log_feed_group(vu_feed dist_ver, int scanned, time_t start);
+
+/**
+ * @brief Compute the fingerprint of the inventory collected for an agent, the same fingerprint
+ * means that the same vulnerable packages will be found.
+ * @param db The CVE database.
+ * @param agent Agent being analyzed.
+ * @param fingerprint Resulting fingerprint.
+ * @return 0 on success, -1 otherwise.
+ */
+STATIC int wm_vuldet_get_inventory_fingerprint(sqlite3 *db, scan_agent *agent, os_sha1 fingerprint);
+
+/**
+ * @brief Copy the packages not discarded of a CVE table into another one.
+ * @param src The CVE table to copy.
+ * @param dst The CVE table to fill.
+ * @return 0 on success, -1 otherwise.
+ */
+STATIC int wm_vuldet_copy_cve_table(OSHash *src, OSHash *dst);
+
+/**
+ * @brief Create the table that keeps the vulnerable packages of each inventory fingerprint.
+ * @return The new table, NULL on error.
+ */
+STATIC OSHash *wm_vuldet_create_match_cache();
+
+/**
+ * @brief Free a CVE table stored in the match cache.
+ * @param data The CVE table.
+ */
+STATIC void wm_vuldet_free_match_cache_entry(void *data);
+
 /**
  * @brief Discard any installed Linux kernel package which is not running.
  * @param agent Agent being analyzed.
@@ -411,6 +470,17 @@ time_t wm_vuldet_get_last_full_scan(scan_ctx_t* scan_ctx);
  */
 time_t wm_vuldet_get_last_partial_scan(scan_ctx_t* scan_ctx);
 
+/**
+ * @brief Checks if the agent's inventory changed since the last scan: packages not
+ * triaged yet or vulnerabilities of removed packages.
+ *
+ * @param scan_ctx Context of the scan in progress.
+ * @return 1 if there are changes to scan.
+ *         0 if the inventory didn't change.
+ *         -1 on error.
+ */
+STATIC int wm_vuldet_agent_inventory_changed(scan_ctx_t* scan_ctx);
+
 /**
  * @brief Checks if the feed(s) for an agent changed since last scan.
  *
@@ -1465,9 +1535,7 @@ int wm_vuldet_process_agent_vulnerabilities(sqlite3 *db, OSHash *cve_table, scan
     sqlite3_stmt *stmt = NULL;
     vu_report *report = NULL;
     time_t start_time;
-    int vuln_reported = 0;
-    int vuln_reported_nvd = 0;
-    int vuln_reported_vendor = 0;
+    vu_report_batch batch = { .count = 0 };
 
     mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_START_VUL_AG_SEND, scan_ctx->agent_id);
 
@@ -1546,57 +1614,21 @@ int wm_vuldet_process_agent_vulnerabilities(sqlite3 *db, OSHash *cve_table, scan
 
             //Save the vulnerability in the agent database
             bool check_pkg_existence = pkg->type && !strcmp(pkg->type, VULN_CVES_TYPE_PACKAGE);
-            cJSON* j_result = wdb_insert_vuln_cves(scan_ctx->agent_id, report->software, report->version, report->arch, report->cve,
-                                                   report->severity, report->cvss2 ? report->cvss2->base_score : 0,
-                                                   report->cvss3 ? report->cvss3->base_score : 0, pkg->reference, pkg->type, VULN_CVES_STATUS_VALID,
-                                                   report->references, report->condition, report->title, report->published,
-                                                   report->updated, check_pkg_existence, &sock);
-
-            bool success = FALSE;
-            bool update = FALSE;
-
-            if (j_result) {
-                cJSON* j_status = cJSON_GetObjectItem(j_result, "status");
-                success = (cJSON_IsString(j_status) && 0 == strcmp(j_status->valuestring, "SUCCESS"));
-                cJSON* j_action = cJSON_GetObjectItem(j_result, "action");
-                update = (cJSON_IsString(j_action) && 0 == strcmp(j_action->valuestring, "UPDATE"));
-                cJSON_Delete(j_result);
-            }
-            if (!success) {
-                mtdebug1(WM_VULNDETECTOR_LOGTAG, "Failed to insert %s for package %s in the agent %.3d database",
-                        cve ? cve : "null",
-                        pkg->reference ? pkg->reference : "null",
-                        scan_ctx->agent_id);
-            }
-
-            if (report->is_hotfix) {
-                mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_HOTFIX_VUL,
-                    atoi(report->agent_id),
-                    report->cve,
-                    report->condition ? report->condition : "Hotfix is not installed.");
-            }
-            else if (report->software && report->version && report->agent_id && report->cve) {
-                mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_PACK_VER_VULN, report->software,
-                    report->version, atoi(report->agent_id), report->cve,
-                    report->condition && *report->condition != '\0' ? report->condition :
-                    "exists");
-            }
-
-            if (!update) {
-                // Sending CVE report
-                if (wm_vuldet_send_cve_report(report)) {
-                    mterror(WM_VULNDETECTOR_LOGTAG, VU_SEND_AGENT_REPORT_ERROR, report->cve ? report->cve : "", report->software ? report->software : "" , scan_ctx->agent_id);
-                } else {
-                    if (pkg->feed & VU_SRC_NVD) {
-                        vuln_reported_nvd++;
-                    }
-                    if (pkg->feed & VU_SRC_OVAL) {
-                        vuln_reported_vendor++;
-                    }
-                    vuln_reported++;
-                }
+            if (wdb_append_vuln_cves(&batch.items, report->software, report->version, report->arch, report->cve,
+                                     report->severity, report->cvss2 ? report->cvss2->base_score : 0,
+                                     report->cvss3 ? report->cvss3->base_score : 0, pkg->reference, pkg->type, VULN_CVES_STATUS_VALID,
+                                     report->references, report->condition, report->title, report->published,
+                                     report->updated, check_pkg_existence) == OS_SUCCESS) {
+                batch.reports[batch.count] = report;
+                batch.pkgs[batch.count++] = pkg;
+            } else {
+                wm_vuldet_process_report_result(report, pkg, NULL, &batch, scan_ctx->agent_id);
+            }
+            report = NULL;
+
+            if (batch.count == VU_REPORT_BATCH_SIZE) {
+                wm_vuldet_flush_report_batch(&batch, scan_ctx->agent_id, &sock);
             }
-            wm_vuldet_free_report(report);
 
             pkg = next;
         } while (pkg);
@@ -1604,13 +1636,15 @@ int wm_vuldet_process_agent_vulnerabilities(sqlite3 *db, OSHash *cve_table, scan
         hash_node = OSHash_Next(cve_table, &inode_it, hash_node);
     }
 
+    wm_vuldet_flush_report_batch(&batch, scan_ctx->agent_id, &sock);
+
     wdb_finalize(stmt);
 
     if (agents_it->dist != FEED_MAC) {
-        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG_FEED, vuln_reported_nvd, scan_ctx->agent_id, "NVD");
-        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG_FEED, vuln_reported_vendor, scan_ctx->agent_id, "vendor");
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG_FEED, batch.reported_nvd, scan_ctx->agent_id, "NVD");
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG_FEED, batch.reported_vendor, scan_ctx->agent_id, "vendor");
     }
-    mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG, vuln_reported, scan_ctx->agent_id);
+    mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_VULN_SEND_AG, batch.reported, scan_ctx->agent_id);
     mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_FUNCTION_TIME, time(NULL) - start_time, "report", scan_ctx->agent_id);
 
     return 0;
@@ -1620,9 +1654,80 @@ error:
     wm_vuldet_free_report(report);
     mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
     wdb_finalize(stmt);
+    // The vulnerabilities processed before the error are still inserted and reported
+    wm_vuldet_flush_report_batch(&batch, scan_ctx->agent_id, &sock);
     return OS_INVALID;
 }
 
+void wm_vuldet_process_report_result(vu_report *report, cve_vuln_pkg *pkg, cJSON *j_result, vu_report_batch *batch, int agent_id) {
+    bool success = FALSE;
+    bool update = FALSE;
+
+    if (j_result) {
+        cJSON* j_status = cJSON_GetObjectItem(j_result, "status");
+        success = (cJSON_IsString(j_status) && 0 == strcmp(j_status->valuestring, "SUCCESS"));
+        cJSON* j_action = cJSON_GetObjectItem(j_result, "action");
+        update = (cJSON_IsString(j_action) && 0 == strcmp(j_action->valuestring, "UPDATE"));
+    }
+    if (!success) {
+        mtdebug1(WM_VULNDETECTOR_LOGTAG, "Failed to insert %s for package %s in the agent %.3d database",
+                report->cve ? report->cve : "null",
+                pkg->reference ? pkg->reference : "null",
+                agent_id);
+    }
+
+    if (report->is_hotfix) {
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_HOTFIX_VUL,
+            atoi(report->agent_id),
+            report->cve,
+            report->condition ? report->condition : "Hotfix is not installed.");
+    }
+    else if (report->software && report->version && report->agent_id && report->cve) {
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, VU_PACK_VER_VULN, report->software,
+            report->version, atoi(report->agent_id), report->cve,
+            report->condition && *report->condition != '\0' ? report->condition :
+            "exists");
+    }
+
+    if (!update) {
+        // Sending CVE report
+        if (wm_vuldet_send_cve_report(report)) {
+            mterror(WM_VULNDETECTOR_LOGTAG, VU_SEND_AGENT_REPORT_ERROR, report->cve ? report->cve : "", report->software ? report->software : "" , agent_id);
+        } else {
+            if (pkg->feed & VU_SRC_NVD) {
+                batch->reported_nvd++;
+            }
+            if (pkg->feed & VU_SRC_OVAL) {
+                batch->reported_vendor++;
+            }
+            batch->reported++;
+        }
+    }
+    wm_vuldet_free_report(report);
+}
+
+void wm_vuldet_flush_report_batch(vu_report_batch *batch, int agent_id, int *sock) {
+    cJSON *j_results = NULL;
+    int i;
+
+    if (!batch->count) {
+        return;
+    }
+
+    j_results = wdb_insert_vuln_cves_batch(agent_id, &batch->items, sock);
+
+    for (i = 0; i < batch->count; i++) {
+        wm_vuldet_process_report_result(batch->reports[i], batch->pkgs[i], cJSON_GetArrayItem(j_results, i), batch, agent_id);
+        batch->reports[i] = NULL;
+        batch->pkgs[i] = NULL;
+    }
+    batch->count = 0;
+
+    if (j_results) {
+        cJSON_Delete(j_results);
+    }
+}
+
 int wm_vuldet_send_cve_report(vu_report *report) {
     cJSON *alert = NULL;
     cJSON *alert_cve = NULL;
@@ -2561,6 +2666,124 @@ int wm_vuldet_linux_oval_vulnerabilities(sqlite3 *db, scan_agent *agents_it, OSH
     return 0;
 }
 
+int wm_vuldet_get_inventory_fingerprint(sqlite3 *db, scan_agent *agent, os_sha1 fingerprint) {
+    sqlite3_stmt *stmt = NULL;
+    SHA_CTX ctx;
+    char header[OS_SIZE_64];
+    int result;
+
+    if (wm_vuldet_prepare(db, vu_queries[VU_AGENT_INVENTORY], -1, &stmt, NULL) != SQLITE_OK) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+        wdb_finalize(stmt);
+        return OS_INVALID;
+    }
+
+    sqlite3_bind_text(stmt, 1, agent->agent_id, -1, NULL);
+
+    SHA1_Init(&ctx);
+    snprintf(header, sizeof(header), "%d:%d:%d\n", agent->dist, agent->dist_ver, agent->flags.centos);
+    OS_SHA1_Stream(&ctx, NULL, header);
+
+    while (result = wm_vuldet_step(stmt), result == SQLITE_ROW) {
+        for (int i = 0; i < sqlite3_column_count(stmt); i++) {
+            char *value = (char *)sqlite3_column_text(stmt, i);
+            // NULL and empty columns must not produce the same fingerprint
+            OS_SHA1_Stream(&ctx, NULL, value ? "\x1e" : "\x1f");
+            OS_SHA1_Stream(&ctx, NULL, value);
+        }
+        OS_SHA1_Stream(&ctx, NULL, "\n");
+    }
+
+    wdb_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+        return OS_INVALID;
+    }
+
+    OS_SHA1_Stream(&ctx, fingerprint, NULL);
+
+    return 0;
+}
+
+int wm_vuldet_copy_cve_table(OSHash *src, OSHash *dst) {
+    OSHashNode *hash_node;
+    unsigned int inode_it = 0;
+
+    for (hash_node = OSHash_Begin(src, &inode_it); hash_node; hash_node = OSHash_Next(src, &inode_it, hash_node)) {
+        cve_vuln_pkg *first = NULL;
+        cve_vuln_pkg *last = NULL;
+
+        for (cve_vuln_pkg *pkg = hash_node->data; pkg; pkg = pkg->next) {
+            cve_vuln_pkg *copy;
+
+            if (pkg->discard) {
+                continue;
+            }
+
+            os_calloc(1, sizeof(cve_vuln_pkg), copy);
+            w_strdup(pkg->vendor, copy->vendor);
+            w_strdup(pkg->bin_name, copy->bin_name);
+            w_strdup(pkg->src_name, copy->src_name);
+            w_strdup(pkg->arch, copy->arch);
+            w_strdup(pkg->version, copy->version);
+            w_strdup(pkg->type, copy->type);
+            w_strdup(pkg->reference, copy->reference);
+            copy->feed = pkg->feed;
+
+            if (pkg->nvd_cond) {
+                os_calloc(1, sizeof(cve_vuln_cond_NVD), copy->nvd_cond);
+                memcpy(copy->nvd_cond, pkg->nvd_cond, sizeof(cve_vuln_cond_NVD));
+                w_strdup(pkg->nvd_cond->operator, copy->nvd_cond->operator);
+                w_strdup(pkg->nvd_cond->start_version, copy->nvd_cond->start_version);
+                w_strdup(pkg->nvd_cond->end_version, copy->nvd_cond->end_version);
+            }
+
+            if (pkg->vuln_cond) {
+                os_calloc(1, sizeof(cve_vuln_cond), copy->vuln_cond);
+                w_strdup(pkg->vuln_cond->state, copy->vuln_cond->state);
+                w_strdup(pkg->vuln_cond->operation, copy->vuln_cond->operation);
+                w_strdup(pkg->vuln_cond->operation_value, copy->vuln_cond->operation_value);
+                w_strdup(pkg->vuln_cond->condition, copy->vuln_cond->condition);
+            }
+
+            if (last) {
+                last->next = copy;
+            } else {
+                first = copy;
+            }
+            last = copy;
+        }
+
+        if (first && OSHash_Add(dst, hash_node->key, first) != OSHASH_SUCCESS) {
+            merror(LIST_ERROR);
+            wm_vuldet_free_cve_node(first);
+            return OS_INVALID;
+        }
+    }
+
+    return 0;
+}
+
+OSHash *wm_vuldet_create_match_cache() {
+    OSHash *match_cache = OSHash_Create();
+
+    if (!match_cache) {
+        merror(LIST_ERROR);
+        return NULL;
+    }
+
+    OSHash_SetFreeDataPointer(match_cache, wm_vuldet_free_match_cache_entry);
+
+    return match_cache;
+}
+
+void wm_vuldet_free_match_cache_entry(void *data) {
+    if (data) {
+        OSHash_Clean((OSHash *)data, wm_vuldet_free_cve_node);
+    }
+}
+
 int wm_vuldet_find_agent_vulnerabilities(sqlite3 *db, scan_agent *agent, wm_vuldet_flags *flags, scan_ctx_t* scan_ctx) {
 
     int retval = OS_INVALID;
@@ -2600,17 +2823,42 @@ int wm_vuldet_find_agent_vulnerabilities(sqlite3 *db, scan_agent *agent, wm_vuld
             merror(LIST_ERROR);
             goto end;
         }
-        if (agent->dist != FEED_MAC) {
-            if (wm_vuldet_linux_oval_vulnerabilities(db, agent, cve_table, scan_ctx)) {
+
+        // Agents with the same inventory have the same vulnerable packages, only the report step is repeated
+        os_sha1 fingerprint = "";
+        OSHash *cached_table = NULL;
+        if (scan_ctx->match_cache && !wm_vuldet_get_inventory_fingerprint(db, agent, fingerprint)) {
+            cached_table = OSHash_Get(scan_ctx->match_cache, fingerprint);
+        }
+
+        if (cached_table) {
+            mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_MATCH_CACHE_HIT, scan_ctx->agent_id);
+            if (wm_vuldet_copy_cve_table(cached_table, cve_table)) {
                 goto end;
             }
+        } else {
+            if (agent->dist != FEED_MAC) {
+                if (wm_vuldet_linux_oval_vulnerabilities(db, agent, cve_table, scan_ctx)) {
+                    goto end;
+                }
+            }
+            if (wm_vuldet_linux_nvd_vulnerabilities(db, agent, cve_table)) {
+                goto end;
+            }
+            if (wm_vuldet_linux_rm_false_positives(db, agent, cve_table)) {
+                goto end;
+            }
+
+            if (*fingerprint && scan_ctx->match_cache->elements < VU_MATCH_CACHE_SIZE) {
+                if (cached_table = OSHash_Create(), cached_table) {
+                    if (!OSHash_setSize(cached_table, VU_CVE_TABLE_SIZE) || wm_vuldet_copy_cve_table(cve_table, cached_table) ||
+                        OSHash_Add(scan_ctx->match_cache, fingerprint, cached_table) != OSHASH_SUCCESS) {
+                        wm_vuldet_free_match_cache_entry(cached_table);
+                    }
+                }
+            }
         }
-        if (wm_vuldet_linux_nvd_vulnerabilities(db, agent, cve_table)) {
-            goto end;
-        }
-        if (wm_vuldet_linux_rm_false_positives(db, agent, cve_table)) {
-            goto end;
-        }
+
         if (wm_vuldet_process_agent_vulnerabilities(db, cve_table, agent, scan_ctx)) {
             goto end;
         }
@@ -2668,6 +2916,49 @@ int wm_vuldet_find_obsolete_vulnerabilities(scan_ctx_t* scan_ctx) {
     return retval;
 }
 
+scan_agent *wm_vuldet_group_agents_by_feed(scan_agent *agents) {
+    scan_agent *grouped = NULL;
+    scan_agent *next;
+
+    for (; agents; agents = next) {
+        scan_agent *last_same_feed = NULL;
+        scan_agent *tail = NULL;
+        scan_agent *it;
+
+        next = agents->next;
+
+        for (it = grouped; it; it = it->next) {
+            if (it->dist == agents->dist && it->dist_ver == agents->dist_ver) {
+                last_same_feed = it;
+            }
+            tail = it;
+        }
+
+        if (last_same_feed) {
+            agents->next = last_same_feed->next;
+            last_same_feed->next = agents;
+        } else {
+            agents->next = NULL;
+            if (tail) {
+                tail->next = agents;
+            } else {
+                grouped = agents;
+            }
+        }
+    }
+
+    return grouped;
+}
+
+void wm_vuldet_log_feed_group(vu_feed dist_ver, int scanned, time_t start) {
+    time_t elapsed = time(NULL) - start;
+
+    if (scanned > 0) {
+        mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_FEED_GROUP_TIME, scanned, vu_feed_tag[dist_ver], elapsed,
+                 (double)scanned / (elapsed > 0 ? elapsed : 1));
+    }
+}
+
 int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
     scan_agent *agents_it;
     sqlite3 *db = NULL;
@@ -2684,10 +2975,18 @@ int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
         return wm_vuldet_sql_error(db, stmt);
     }
 
+    // Scanning the agents of a feed one after another keeps its data in the page cache
+    vuldet->scan_agents = wm_vuldet_group_agents_by_feed(vuldet->scan_agents);
+    OSHash *match_cache = NULL;
+
     // Iterate agents to look for vulnerabilities
     do {
         retry_agents = false;
         time_t first_fail_scan = 0;
+        scan_agent *group_it = NULL;
+        time_t group_start = 0;
+        int group_scanned = 0;
+
         for (agents_it = vuldet->scan_agents; agents_it; agents_it = agents_it->next) {
             scan_ctx_t scan_ctx = {0};
             scan_ctx.agent_id = atoi(agents_it->agent_id);
@@ -2698,6 +2997,22 @@ int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
 
             time_t start = time(NULL);
 
+            if (!group_it || group_it->dist != agents_it->dist || group_it->dist_ver != agents_it->dist_ver) {
+                if (group_it) {
+                    wm_vuldet_log_feed_group(group_it->dist_ver, group_scanned, group_start);
+                }
+                group_it = agents_it;
+                group_start = start;
+                group_scanned = 0;
+
+                // The inventories of another feed will never match the cached ones
+                if (match_cache) {
+                    OSHash_Free(match_cache);
+                }
+                match_cache = wm_vuldet_create_match_cache();
+            }
+            scan_ctx.match_cache = match_cache;
+
             // Check if there are available vulnerabilities for this agent
             if (agents_it->dist != FEED_WIN && agents_it->dist != FEED_MAC) {
                 result = wm_vuldet_db_empty(db, agents_it->dist_ver);
@@ -2732,6 +3047,14 @@ int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
             }
             else {
                 scan_ctx.scan_type = VU_PARTIAL_SCAN;
+
+                // A partial scan only looks at the inventory changes, skip the agent if there are none.
+                // If they can't be checked, the agent is scanned anyway.
+                if (agents_it->os_triaged && wm_vuldet_agent_inventory_changed(&scan_ctx) == 0) {
+                    mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_AG_NO_CHANGES, scan_ctx.agent_id);
+                    agents_it->pending_attempts = 0;
+                    continue;
+                }
                 mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_AG_PART_SCAN, scan_ctx.agent_id);
             }
 
@@ -2773,6 +3096,11 @@ int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
             mtinfo(WM_VULNDETECTOR_LOGTAG, VU_AGENT_FINISH, scan_ctx.agent_id);
             mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_FUNCTION_TIME, time(NULL) - start, "scan", scan_ctx.agent_id);
             agents_it->pending_attempts = 0;
+            group_scanned++;
+        }
+
+        if (group_it && !abort_scan) {
+            wm_vuldet_log_feed_group(group_it->dist_ver, group_scanned, group_start);
         }
 
         if (retry_agents) {
@@ -2786,6 +3114,10 @@ int wm_vuldet_check_agent_vulnerabilities(wm_vuldet_t *vuldet) {
 
     } while (retry_agents && !abort_scan);
 
+    if (match_cache) {
+        OSHash_Free(match_cache);
+    }
+
     // Reset the tables
     wm_vuldet_reset_tables(db);
 
@@ -2863,6 +3195,7 @@ int wm_vuldet_update_feed(update_node *upd, int8_t *updated) {
                 // Feed synchronization failed
                 if (upd->dist_ref == FEED_NVD) {
                     wm_vuldet_clean_nvd_year(NULL, upd->update_it);
+                    wm_vuldet_stop_nvd_prefetch();
                 } else if (upd->dist_ref == FEED_JREDHAT) {
                     wm_vuldet_clean_rh();
                 }
@@ -3585,6 +3918,12 @@ int wm_vuldet_insert(wm_vuldet_db *parsed_oval, update_node *update) {
     free(met_it->timestamp);
 
     sqlite3_exec(db, vu_queries[END_T], NULL, NULL, NULL);
+
+    // Refresh the planner statistics, so the scan looks up every agent package in the feed by its name
+    if (sqlite3_exec(db, vu_queries[VU_ANALYZE_FEEDS], NULL, NULL, NULL) != SQLITE_OK) {
+        mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+    }
+
     sqlite3_close_v2(db);
 
     return 0;
@@ -5437,16 +5776,16 @@ int wm_vuldet_json_parser(char *json_path, wm_vuldet_db *parsed_vulnerabilities,
     }
 
     if (update->dist_ref == FEED_NVD) {
-        char *json_feed;
-        if (json_feed = w_get_file_content(compress ? VU_FIT_TEMP_FILE : json_path, JSON_MAX_FSIZE), !json_feed) {
+        FILE *fp;
+        if (fp = fopen(compress ? VU_FIT_TEMP_FILE : json_path, "r"), !fp) {
             mterror(WM_VULNDETECTOR_LOGTAG, VU_CONTENT_FEED_ERROR, update->dist_ext, json_path);
             return retval;
         }
 
-        if (retval = wm_vuldet_json_nvd_parser(json_feed, parsed_vulnerabilities), retval == OS_INVALID) {
+        if (retval = wm_vuldet_json_nvd_parser(fp, parsed_vulnerabilities), retval == OS_INVALID) {
             mterror(WM_VULNDETECTOR_LOGTAG, VU_PARSED_FEED_ERROR, update->dist_ext, json_path);
         }
-        free(json_feed);
+        fclose(fp);
     }
     else {
         cJSON *json_feed;
@@ -5682,8 +6021,8 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
     scan_agent *agents = NULL;
     scan_agent *f_agent = NULL;
     int set_manager = 1;
-    int i = 0;
-    int *id_array = NULL;
+    cJSON *j_agents = NULL;
+    cJSON *j_agent = NULL;
     int sock = wm_vuldet_get_wdb_socket();
 
     if (sock < 0) {
@@ -5691,10 +6030,13 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
         return OS_INVALID;
     }
 
-    id_array = wdb_get_agents_by_connection_status(AGENT_CS_ACTIVE, &sock);
+    // The information of all the active agents is requested at once
+    j_agents = wdb_get_agents_info_by_connection_status(AGENT_CS_ACTIVE, &sock);
+    j_agent = j_agents ? j_agents->child : NULL;
 
-    while (set_manager || (id_array && id_array[i] != -1)) {
+    while (set_manager || j_agent) {
         cJSON *j_agent_info = NULL;
+        cJSON *j_info = NULL;
         cJSON *j_osinfo = NULL;
         cJSON *j_field = NULL;
         vu_feed agent_dist_ver = -1;
@@ -5706,19 +6048,27 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
 
         if (set_manager) {
             id = --set_manager;
+
+            // Getting agent-info data from global.db
+            j_agent_info = wdb_get_agent_info(id, &sock);
+            if (!j_agent_info) {
+                mdebug1("Failed to get agent '%d' information from Wazuh DB.", id);
+                goto next;
+            }
+            j_info = j_agent_info->child;
         }
         else {
-            id = id_array[i++];
-        }
+            j_info = j_agent;
+            j_agent = j_agent->next;
 
-        // Getting agent-info data from global.db
-        j_agent_info = wdb_get_agent_info(id, &sock);
-        if (!j_agent_info) {
-            mdebug1("Failed to get agent '%d' information from Wazuh DB.", id);
-            goto next;
+            j_field = cJSON_GetObjectItem(j_info, "id");
+            if (!cJSON_IsNumber(j_field)) {
+                goto next;
+            }
+            id = j_field->valueint;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "node_name");
+        j_field = cJSON_GetObjectItem(j_info, "node_name");
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             if (0 != strcmp(j_field->valuestring, vuldet->node_name)) {
                 mtdebug1(WM_VULNDETECTOR_LOGTAG, "Skipping agent '%.3d' because it reports to node '%s' and the current node is '%s'.", id, j_field->valuestring, vuldet->node_name);
@@ -5726,37 +6076,37 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
             }
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "os_name");
+        j_field = cJSON_GetObjectItem(j_info, "os_name");
         char *agti_os_name = NULL;
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             agti_os_name = j_field->valuestring;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "os_major");
+        j_field = cJSON_GetObjectItem(j_info, "os_major");
         char *agti_os_major = NULL;
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             agti_os_major = j_field->valuestring;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "name");
+        j_field = cJSON_GetObjectItem(j_info, "name");
         char *agti_name = NULL;
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             agti_name = j_field->valuestring;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "os_build");
+        j_field = cJSON_GetObjectItem(j_info, "os_build");
         int agti_build = 0;
         if(cJSON_IsNumber(j_field)){
             agti_build = j_field->valueint;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "version");
+        j_field = cJSON_GetObjectItem(j_info, "version");
         char *agti_version = NULL;
         if (cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             agti_version = j_field->valuestring;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "os_platform");
+        j_field = cJSON_GetObjectItem(j_info, "os_platform");
         char *agti_os_platform = NULL;
         if (cJSON_IsString(j_field) && j_field->valuestring != NULL) {
             agti_os_platform = j_field->valuestring;
@@ -5931,7 +6281,7 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
             }
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "register_ip");
+        j_field = cJSON_GetObjectItem(j_info, "register_ip");
         char *agti_register_ip = NULL;
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL){
             agti_register_ip = j_field->valuestring;
@@ -5942,7 +6292,7 @@ int wm_vuldet_collect_agents_to_scan(wm_vuldet_t *vuldet) {
             goto next;
         }
 
-        j_field = cJSON_GetObjectItem(j_agent_info->child, "os_arch");
+        j_field = cJSON_GetObjectItem(j_info, "os_arch");
         char *agti_arch = NULL;
         if(cJSON_IsString(j_field) && j_field->valuestring != NULL){
             agti_arch = j_field->valuestring;
@@ -6064,7 +6414,7 @@ next:
     }
 
     vuldet->scan_agents = f_agent;
-    os_free(id_array);
+    cJSON_Delete(j_agents);
     return OS_SUCCESS;
 }
 
@@ -7939,15 +8289,19 @@ int wm_vuldet_index_nvd(sqlite3 *db, update_node *upd, nvd_vulnerability *nvd_it
 
     // Clean everything only if there are still residues of an offline update
     // made by multi_path update. For the cases of multi_url or the online
-    // update, we just need to clean the NVD for the year being indexed.
+    // update, we just apply the differences with the year being indexed.
     if (result = wm_vuldet_has_offline_update(db), result == OS_INVALID) {
         goto error;
     }
 
     if (result == 1 && upd->multi_path && wm_vuldet_clean_nvd(db)) {
         goto error;
-    } else if (!upd->multi_path && wm_vuldet_clean_nvd_year(db, upd->update_it)) {
-        goto error;
+    } else if (!upd->multi_path) {
+        // Only the CVEs that changed since the last update are rewritten
+        if (wm_vuldet_index_nvd_delta(db, upd->update_it, nvd_it, &cve_count)) {
+            return OS_INVALID;
+        }
+        nvd_it = NULL;
     }
 
     while (nvd_it) {
@@ -8443,6 +8797,30 @@ time_t wm_vuldet_get_last_partial_scan(scan_ctx_t* scan_ctx) {
     return wm_vuldet_get_last_scan(scan_ctx, "LAST_PARTIAL_SCAN");
 }
 
+int wm_vuldet_agent_inventory_changed(scan_ctx_t* scan_ctx) {
+    int retval = OS_INVALID;
+    char request[OS_SIZE_6144];
+
+    snprintf(request, OS_SIZE_256, vu_queries[VU_GET_INVENTORY_CHANGES], scan_ctx->agent_id);
+
+    if (wm_vuldet_wdb_request(request, OS_SIZE_6144) || !wm_vuldet_wdb_valid_answ(request)) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_INV_WAZUHDB_RES, request);
+        return retval;
+    }
+
+    cJSON* response = cJSON_Parse(request+3);
+    cJSON* j_packages = NULL;
+    cJSON* j_obsolete = NULL;
+    if (response && response->child &&
+        (j_packages = cJSON_GetObjectItem(response->child, "PACKAGES")) &&
+        (j_obsolete = cJSON_GetObjectItem(response->child, "OBSOLETE"))) {
+        retval = (j_packages->valueint || j_obsolete->valueint) ? 1 : 0;
+    }
+    cJSON_Delete(response);
+
+    return retval;
+}
+
 bool wm_vuldet_feed_changed (update_node** feeds, scan_agent* agent, time_t last_scan) {
     update_node* target_feed = NULL;
     bool ret = FALSE;
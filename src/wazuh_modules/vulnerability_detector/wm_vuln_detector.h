@@ -36,6 +36,8 @@
 #define VU_TEMP_FILE_BZ2 VU_TEMP_FILE ".bz2"
 #define VU_FIT_TEMP_FILE VU_TEMP_FILE "-fitted"
 #define VU_TEMP_METADATA_FILE VU_TEMP_FILE "-metadata"
+#define VU_NVD_PREFETCH_FILE VU_TEMP_FILE "-prefetch"
+#define VU_NVD_PREFETCH_METADATA_FILE VU_NVD_PREFETCH_FILE "-metadata"
 #define VU_DEB_TEMP_FILE VU_TEMP_FILE "-deb"
 #define VU_DICTIONARIES "queue/vulnerabilities/dictionaries"
 #define VU_CPE_HELPER_FILE "queue/vulnerabilities/dictionaries/cpe_helper.json"
@@ -96,8 +98,11 @@
  * Must be a high number for better performance.
  */
 #define VU_CVE_TABLE_SIZE 4098
+#define VU_NVD_READ_SIZE 65536 // Initial size of the buffer used to read the NVD feeds.
+#define VU_MATCH_CACHE_SIZE 64 // Max number of distinct inventories whose vulnerable packages are kept per feed.
 #define VU_SRC_NVD 1 // CVE found using the NVD as source feed.
 #define VU_SRC_OVAL 2 // CVE found using an OVAL as source feed.
+#define VU_REPORT_BATCH_SIZE 100 // Max number of vulnerabilities inserted together in the agent database.
 #define MAX_RELATED_PKGS 5 // Max number of related packages (children, siblings...)
 #define MAX_PRODUCT_NAMES 4 // Max number of products available per vendor feed.
 
@@ -492,6 +497,18 @@ typedef struct update_node {
     unsigned int custom_location:1;
 } update_node;
 
+/**
+ * @brief Download of a year of the NVD feed, run in background while the previous year is indexed.
+ */
+typedef struct vu_nvd_prefetch {
+    pthread_t thread;
+    update_node *update;        // NVD update node, only its timeout and extension are read by the thread
+    int year;
+    char *stored_timestamp;     // Timestamp of the year in the database, NULL if it was never indexed
+    int result;                 // 0 if downloaded, VU_NOT_NEED_UPDATE or VU_INV_FEED
+    bool running;
+} vu_nvd_prefetch;
+
 typedef struct wm_vuldet_t {
     char *node_name;
     update_node *updates[OS_SUPP_SIZE];
@@ -789,6 +806,12 @@ struct nvd_vulnerability {
     struct nvd_vulnerability *next;
 };
 
+// CVE of an NVD year already indexed, used to apply only the changes of a new feed.
+typedef struct nvd_stored_cve {
+    int id;
+    char *last_modified;
+} nvd_stored_cve;
+
 typedef struct vu_nvd_report {
     int id;
     char *raw_product;
@@ -888,8 +911,22 @@ typedef struct scan_ctx_t {
     vu_scan_type_t  scan_type;
     bool            os_scan;
     bool            package_scan;
+    OSHash*         match_cache;    // Vulnerable packages of the inventories already scanned, by fingerprint.
 } scan_ctx_t;
 
+/**
+ * @brief Vulnerabilities of an agent pending to be inserted in its database and reported.
+ */
+typedef struct vu_report_batch {
+    vu_report      *reports[VU_REPORT_BATCH_SIZE];
+    cve_vuln_pkg   *pkgs[VU_REPORT_BATCH_SIZE];
+    cJSON          *items;              // Batch of wdb_append_vuln_cves().
+    int             count;
+    int             reported;
+    int             reported_nvd;
+    int             reported_vendor;
+} vu_report_batch;
+
 // Macros
 #define wm_vuldet_is_single_provider(x) (x == FEED_UBUNTU || x == FEED_DEBIAN || x == FEED_REDHAT || x == FEED_ALAS)
 #define wm_vuldet_silent_feed(x) (x == FEED_CPEW)
@@ -920,8 +957,12 @@ int wm_vuldet_get_min_cpe_index(sqlite3 *db, int *min_index);
 int wm_vuldet_add_cpe(cpe *ncpe, char *cpe_raw, cpe_list *node_list, int index);
 int wm_vuldet_generate_agent_cpes(sqlite3 *db, scan_agent *agent, char dic);
 int wm_vuldet_fetch_nvd_cve(update_node *update);
+/**
+ * @brief Waits for the background download of a NVD year, if any, and discards it.
+ */
+void wm_vuldet_stop_nvd_prefetch(void);
 int wm_vuldet_fetch_nvd_cpe(const long timeout, char *repo);
-int wm_vuldet_json_nvd_parser(char *json_feed, wm_vuldet_db *parsed_vulnerabilities);
+int wm_vuldet_json_nvd_parser(FILE *fp, wm_vuldet_db *parsed_vulnerabilities);
 int wm_vuldet_clean_nvd_metadata(sqlite3 *db, int year);
 int wm_vuldet_insert_nvd_cve(sqlite3 *db, nvd_vulnerability *nvd_data, int year);
 void wm_vuldet_free_nvd_node(nvd_vulnerability *data);
@@ -1092,6 +1133,25 @@ int wm_vuldet_fill_report_oval_data(sqlite3 *db, sqlite3_stmt *stmt, scan_agent
  */
 int wm_vuldet_process_agent_vulnerabilities(sqlite3 *db, OSHash *cve_table, scan_agent *agents_it, scan_ctx_t *scan_ctx);
 
+/**
+ * @brief Log and send the report of a vulnerability once inserted in the agent database, and free it.
+ * The report is only sent if the vulnerability wasn't already in the database.
+ * @param report Report of the vulnerability.
+ * @param pkg Vulnerable package.
+ * @param j_result Result of the insertion, see wdb_insert_vuln_cves(). NULL if it failed.
+ * @param batch Batch where the sent reports are counted.
+ * @param agent_id ID of the agent.
+ */
+void wm_vuldet_process_report_result(vu_report *report, cve_vuln_pkg *pkg, cJSON *j_result, vu_report_batch *batch, int agent_id);
+
+/**
+ * @brief Insert the vulnerabilities of a batch in the agent database and report them.
+ * @param batch Batch of vulnerabilities. It's emptied.
+ * @param agent_id ID of the agent.
+ * @param sock Wazuh DB socket.
+ */
+void wm_vuldet_flush_report_batch(vu_report_batch *batch, int agent_id, int *sock);
+
 /**
  * @brief Free a report.
  * @param report An already generated report that has to be freed.
@@ -1130,6 +1190,18 @@ int wm_vuldet_remove_table(sqlite3 *db, char *table);
 int wm_vuldet_clean_nvd(sqlite3 *db);
 int wm_vuldet_has_offline_update(sqlite3 *db);
 int wm_vuldet_clean_nvd_year(sqlite3 *db, int year);
+
+/**
+ * @brief Index an NVD year applying only the differences with the CVEs already stored:
+ *        new CVEs are inserted, CVEs whose last modified date changed are replaced and
+ *        CVEs no longer in the feed are removed.
+ * @param db The CVE database.
+ * @param year The year of the feed.
+ * @param nvd_it List of parsed CVEs. It is freed by this function.
+ * @param cve_count Number of CVEs of the feed.
+ * @return 0 on success, -1 otherwise.
+ */
+int wm_vuldet_index_nvd_delta(sqlite3 *db, int year, nvd_vulnerability *nvd_it, int *cve_count);
 int wm_vuldet_remove_sequence(sqlite3 *db, char *table);
 char *wm_vuldet_cpe_str(cpe *cpe_s);
 void wm_vuldet_free_cpe(cpe **node);
@@ -53,6 +53,7 @@ typedef enum vu_query {
     VU_INSERT_PKG_DEPS,
     VU_INSERT_DEPENDENCIES,
     VU_AGENT_PACKAGE_VERSION,
+    VU_AGENT_INVENTORY,
     VU_UPDATE_CVE,
     VU_UPDATE_CVE_NOT_FIXED,
     VU_UPDATE_CVE_VAL,
@@ -85,6 +86,7 @@ typedef enum vu_query {
     VU_SYSC_UPDATE_CPE,
     VU_SYSC_CLEAN_CPES,
     VU_GET_LAST_SCAN,
+    VU_GET_INVENTORY_CHANGES,
     VU_SET_LAST_FULL_SCAN,
     VU_SET_LAST_PARTIAL_SCAN,
     // CPE INDEX
@@ -120,6 +122,8 @@ typedef enum vu_query {
     VU_REMOVE_NVD_CPE,
     VU_REMOVE_NVD_CVE,
     VU_GET_NVD_CONFIG,
+    VU_GET_NVD_CVE_MODIFIED,
+    VU_REMOVE_NVD_CVE_ID,
     // NVD REPORT
     VU_GET_CVE_INFO,
     VU_GET_CVE_INFO_FILTER_CVE,
@@ -128,9 +132,7 @@ typedef enum vu_query {
     VU_GET_SCORING,
     // NVD VULNERABILITY CHECK
     VU_GET_DICT_CPE,
-    VU_GET_NVD_CPE,
-    VU_GET_NVD_MATCHES,
-    VU_GET_CONF,
+    VU_GET_NVD_CPE_MATCHES,
     VU_GET_CONF_AND,
     VU_GET_MATCHES_AND,
     VU_GET_CPE_AND,
@@ -168,6 +170,8 @@ typedef enum vu_query {
     VU_CHECK_AGENT_HOTFIX,
     //ARCHITECTURES
     VU_GET_ARCH_ID,
+    // STATISTICS
+    VU_ANALYZE_FEEDS,
     // TRANSACTIONS
     BEGIN_T,
     END_T
@@ -191,6 +195,7 @@ static const char *vu_queries[] = {
     [VU_INSERT_PKG_DEPS] = "INSERT INTO " PKG_DEPS_TABLE " VALUES(?,?,?);",
     [VU_INSERT_DEPENDENCIES] = "INSERT INTO " DEPENDENCIES_TABLE " VALUES(?,?,?,?,?,0);",
     [VU_AGENT_PACKAGE_VERSION] = "SELECT SOURCE, PACKAGE_NAME, VERSION, SRC_VERSION, ARCH, VENDOR, REFERENCE, TYPE FROM AGENTS WHERE AGENT_ID = ?;",
+    [VU_AGENT_INVENTORY] = "SELECT TARGET_MAJOR, TARGET_MINOR, CPE_INDEX_ID, VENDOR, PACKAGE_NAME, SOURCE, VERSION, SRC_VERSION, ARCH, REFERENCE, TYPE FROM AGENTS WHERE AGENT_ID = ? ORDER BY CPE_INDEX_ID, VENDOR, PACKAGE_NAME, VERSION, ARCH;",
     [VU_UPDATE_CVE] = "UPDATE " CVE_TABLE " SET PACKAGE = ?, OPERATION = ? WHERE OPERATION = ?;",
     [VU_UPDATE_CVE_NOT_FIXED] = "UPDATE " CVE_TABLE " SET PACKAGE = ?, OPERATION = ?, OPERATION_VALUE = ? WHERE OPERATION = ?;",
     [VU_UPDATE_CVE_VAL] = "UPDATE " CVE_TABLE " SET OPERATION = ?, OPERATION_VALUE = ?, ARCH_ID = ? WHERE OPERATION = ?;",
@@ -247,6 +252,7 @@ static const char *vu_queries[] = {
     [VU_SYSC_UPDATE_CPE] = "agent %s sql UPDATE SYS_PROGRAMS SET CPE = '%s:%s:%s:%s:%s:%s:%s:%s:%s:%s:%s', MSU_NAME = %Q WHERE VENDOR = %Q AND NAME = %Q AND VERSION = '%s' AND ARCHITECTURE = '%s';",
     [VU_SYSC_CLEAN_CPES] = "agent %s sql UPDATE SYS_PROGRAMS SET CPE = NULL, MSU_NAME = NULL;",
     [VU_GET_LAST_SCAN] = "agent %d sql SELECT LAST_PARTIAL_SCAN, LAST_FULL_SCAN FROM VULN_METADATA;",
+    [VU_GET_INVENTORY_CHANGES] = "agent %d sql SELECT (SELECT COUNT(*) FROM SYS_PROGRAMS WHERE TRIAGED != 1 OR TRIAGED IS NULL) AS PACKAGES, (SELECT COUNT(*) FROM VULN_CVES WHERE STATUS = 'OBSOLETE') AS OBSOLETE;",
     [VU_SET_LAST_FULL_SCAN] = "agent %d sql UPDATE VULN_METADATA SET LAST_FULL_SCAN='%u';",
     [VU_SET_LAST_PARTIAL_SCAN] = "agent %d sql UPDATE VULN_METADATA SET LAST_PARTIAL_SCAN='%u';",
     // CPE INDEX
@@ -282,6 +288,8 @@ static const char *vu_queries[] = {
     [VU_REMOVE_NVD_CPE] = "DELETE FROM NVD_CPE WHERE ID NOT IN (SELECT DISTINCT ID_CPE FROM NVD_CVE_MATCH);",
     [VU_REMOVE_NVD_CVE] = "DELETE FROM NVD_CVE WHERE NVD_METADATA_YEAR = ?;",
     [VU_GET_NVD_CONFIG] = "SELECT ID FROM NVD_CVE_CONFIGURATION WHERE NVD_CVE_ID = ?;",
+    [VU_GET_NVD_CVE_MODIFIED] = "SELECT ID, CVE_ID, LAST_MODIFIED FROM NVD_CVE WHERE NVD_METADATA_YEAR = ?;",
+    [VU_REMOVE_NVD_CVE_ID] = "DELETE FROM NVD_CVE WHERE ID = ?;",
     // NVD REPORT
     [VU_GET_CVE_INFO] = "SELECT CVE_ID, CWE_ID, ASSIGNER, DESCRIPTION, VERSION, PUBLISHED, LAST_MODIFIED FROM NVD_CVE WHERE ID = ?;",
     [VU_GET_CVE_INFO_FILTER_CVE] = "SELECT ID, CWE_ID, ASSIGNER, DESCRIPTION, VERSION, PUBLISHED, LAST_MODIFIED FROM NVD_CVE WHERE CVE_ID = ?;",
@@ -290,9 +298,7 @@ static const char *vu_queries[] = {
     [VU_GET_SCORING] = "SELECT VECTOR_STRING, BASE_SCORE, EXPLOITABILITY_SCORE, IMPACT_SCORE, VERSION FROM NVD_METRIC_CVSS WHERE NVD_CVE_ID = ?;",
     // NVD VULNERABILITY CHECK
     [VU_GET_DICT_CPE] = "SELECT CPE_INDEX.PART, CPE_INDEX.VENDOR, CPE_INDEX.PRODUCT, CPE_INDEX.VERSION, CPE_INDEX.UPDATEV, CPE_INDEX.EDITION, CPE_INDEX.LANGUAGE, CPE_INDEX.SW_EDITION, CPE_INDEX.TARGET_SW, CPE_INDEX.TARGET_HW, CPE_INDEX.MSU_NAME, AGENTS.PACKAGE_NAME, AGENTS.VERSION, AGENTS.ARCH, AGENTS.REFERENCE, AGENTS.TYPE FROM AGENTS INNER JOIN CPE_INDEX ON AGENTS.AGENT_ID = ? AND AGENTS.CPE_INDEX_ID < 0 AND CPE_INDEX.ID = AGENTS.CPE_INDEX_ID;",
-    [VU_GET_NVD_CPE] = "SELECT NVD_CPE.ID, NVD_CPE.VERSION FROM NVD_CPE WHERE NVD_CPE.PART = ? AND NVD_CPE.VENDOR = ? AND NVD_CPE.PRODUCT = ? AND (NVD_CPE.VERSION = ? OR NVD_CPE.VERSION = '*' OR NVD_CPE.VERSION = '-') AND (NVD_CPE.UPDATED = '*' OR NVD_CPE.UPDATED = ?) AND (NVD_CPE.EDITION = '*' OR NVD_CPE.EDITION = ? OR NVD_CPE.EDITION = '') AND (NVD_CPE.LANGUAGE = '*' OR NVD_CPE.LANGUAGE = ? OR NVD_CPE.LANGUAGE = '') AND (NVD_CPE.SW_EDITION = '*' OR NVD_CPE.SW_EDITION = ? OR NVD_CPE.SW_EDITION = '') AND (NVD_CPE.TARGET_SW = '*' OR NVD_CPE.TARGET_SW = '-' OR NVD_CPE.TARGET_SW = '') AND (NVD_CPE.TARGET_HW = '*' OR NVD_CPE.TARGET_HW = '-' OR NVD_CPE.TARGET_HW = ?);",
-    [VU_GET_NVD_MATCHES] = "SELECT NVD_CVE_MATCH.NVD_CVE_CONFIGURATION_ID, NVD_CVE_MATCH.URI, NVD_CVE_MATCH.VULNERABLE, NVD_CVE_MATCH.VERSION_START_INCLUDING, NVD_CVE_MATCH.VERSION_START_EXCLUDING, NVD_CVE_MATCH.VERSION_END_INCLUDING, NVD_CVE_MATCH.VERSION_END_EXCLUDING FROM NVD_CVE_MATCH WHERE NVD_CVE_MATCH.ID_CPE = ?;",
-    [VU_GET_CONF] = "SELECT NVD_CVE_CONFIGURATION.NVD_CVE_ID, NVD_CVE_CONFIGURATION.OPERATOR, NVD_CVE_CONFIGURATION.PARENT FROM NVD_CVE_CONFIGURATION WHERE NVD_CVE_CONFIGURATION.ID = ?;",
+    [VU_GET_NVD_CPE_MATCHES] = "SELECT NVD_CPE.ID, NVD_CPE.VERSION, NVD_CVE_MATCH.NVD_CVE_CONFIGURATION_ID, NVD_CVE_MATCH.URI, NVD_CVE_MATCH.VULNERABLE, NVD_CVE_MATCH.VERSION_START_INCLUDING, NVD_CVE_MATCH.VERSION_START_EXCLUDING, NVD_CVE_MATCH.VERSION_END_INCLUDING, NVD_CVE_MATCH.VERSION_END_EXCLUDING, NVD_CVE_CONFIGURATION.NVD_CVE_ID, NVD_CVE_CONFIGURATION.OPERATOR, NVD_CVE_CONFIGURATION.PARENT FROM NVD_CPE INNER JOIN NVD_CVE_MATCH ON NVD_CVE_MATCH.ID_CPE = NVD_CPE.ID INNER JOIN NVD_CVE_CONFIGURATION ON NVD_CVE_CONFIGURATION.ID = NVD_CVE_MATCH.NVD_CVE_CONFIGURATION_ID WHERE NVD_CPE.PART = ? AND NVD_CPE.VENDOR = ? AND NVD_CPE.PRODUCT = ? AND (NVD_CPE.VERSION = ? OR NVD_CPE.VERSION = '*' OR NVD_CPE.VERSION = '-') AND (NVD_CPE.UPDATED = '*' OR NVD_CPE.UPDATED = ?) AND (NVD_CPE.EDITION = '*' OR NVD_CPE.EDITION = ? OR NVD_CPE.EDITION = '') AND (NVD_CPE.LANGUAGE = '*' OR NVD_CPE.LANGUAGE = ? OR NVD_CPE.LANGUAGE = '') AND (NVD_CPE.SW_EDITION = '*' OR NVD_CPE.SW_EDITION = ? OR NVD_CPE.SW_EDITION = '') AND (NVD_CPE.TARGET_SW = '*' OR NVD_CPE.TARGET_SW = '-' OR NVD_CPE.TARGET_SW = '') AND (NVD_CPE.TARGET_HW = '*' OR NVD_CPE.TARGET_HW = '-' OR NVD_CPE.TARGET_HW = ?) ORDER BY NVD_CPE.ID, NVD_CVE_MATCH.NVD_CVE_CONFIGURATION_ID;",
     [VU_GET_CONF_AND] = "SELECT ID FROM NVD_CVE_CONFIGURATION WHERE PARENT=(SELECT ID FROM NVD_CVE_CONFIGURATION WHERE ID=? AND OPERATOR='AND') AND ID!=?;",
     [VU_GET_MATCHES_AND] = "SELECT ID FROM NVD_CVE_MATCH WHERE NVD_CVE_CONFIGURATION_ID = ?;",
     [VU_GET_CPE_AND] = "SELECT VENDOR, PRODUCT FROM NVD_CPE WHERE ID = ?;",
@@ -375,6 +381,8 @@ static const char *vu_queries[] = {
     [VU_CHECK_AGENT_HOTFIX] = "SELECT HOTFIX FROM AGENT_HOTFIXES WHERE AGENT_ID = ? AND HOTFIX LIKE ?;",
     //ARCHITECTURE
     [VU_GET_ARCH_ID] = "SELECT ARCH_ID FROM "CVE_TABLE" WHERE CVEID = ? AND TARGET = ? AND PACKAGE = ? AND OPERATION_VALUE = ?;",
+    // STATISTICS
+    [VU_ANALYZE_FEEDS] = "ANALYZE " CVE_TABLE "; ANALYZE " VARIABLES_TABLE "; ANALYZE " ARCHITECTURES_TABLE ";",
     // TRANSACTIONS
     [BEGIN_T] = "BEGIN TRANSACTION;",
     [END_T] = "END TRANSACTION;"};
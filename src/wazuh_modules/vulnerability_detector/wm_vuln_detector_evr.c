@@ -35,6 +35,17 @@
 
 static int (*comparator) (const char *, const char *, int);
 
+/* Key of the last version compared on the left side, which is the package
+ * compared against every feed condition. Not thread safe, as the comparator. */
+static struct {
+    version_type vertype;
+    int epoch;
+    char *version;
+    char *revision;
+    unsigned char key[PKG_VERSION_KEY_SIZE];
+    size_t size;
+} key_cache;
+
 static unsigned short int c_ctype[256] = {
 /** 0 **/
     /* \0 */ 0,
@@ -469,6 +480,198 @@ static int nvd_verrevcmp(const char *a, const char *b, int revision)
     return result;
 }
 
+/*
+* Build the key of a DEB version or revision. Every non-digit character is
+* stored as its order() weight in two bytes, followed by the end of the
+* non-digit part (the weight of the end of the string or a digit). Numbers
+* are stored without leading zeros, preceded by their length.
+* The key ends as an endless run of empty parts would, so that a shorter
+* version compares with the rest of the longer one as deb_verrevcmp() does.
+* return the size of the key, 0 if it doesn't fit.
+*/
+static size_t deb_verkey(const char *s, unsigned char *key, size_t size)
+{
+    static const unsigned char tail[] = { 0, 2, 0, 0, 2 };
+    size_t pos = 0;
+    size_t len;
+    const char *digits;
+    int weight;
+
+    if (s == NULL)
+        s = "";
+
+    while (*s) {
+        for (; *s && !c_isdigit(*s); s++) {
+            if (pos + 2 > size)
+                return 0;
+            weight = order(*s) + 2;
+            key[pos++] = weight >> 8;
+            key[pos++] = weight & 0xFF;
+        }
+
+        while (*s == '0')
+            s++;
+        for (digits = s; c_isdigit(*s); s++);
+        len = s - digits;
+
+        if (len > UCHAR_MAX || pos + 3 + len > size)
+            return 0;
+        key[pos++] = 0;
+        key[pos++] = 2;
+        key[pos++] = len;
+        memcpy(key + pos, digits, len);
+        pos += len;
+    }
+
+    // A version made only of zeros is an empty one
+    if (pos == 3 && !key[0] && key[1] == 2 && !key[2])
+        pos = 0;
+
+    if (pos + sizeof(tail) > size)
+        return 0;
+    memcpy(key + pos, tail, sizeof(tail));
+
+    return pos + sizeof(tail);
+}
+
+/*
+* Build the key of an RPM version or release. Separators are skipped and every
+* segment is stored after a tag that sorts as rpm_vercmp() does:
+* tilde < end < caret < alpha < numeric. Alpha segments end with a zero and
+* numbers are stored without leading zeros, preceded by their length.
+* return the size of the key, 0 if it doesn't fit.
+*/
+static size_t rpm_verkey(const char *s, unsigned char *key, size_t size)
+{
+    size_t pos = 0;
+    size_t len;
+    const char *segment;
+
+    if (s == NULL)
+        return 0;
+
+    while (*s) {
+        while (*s && !(c_isalpha(*s) || c_isdigit(*s)) && *s != '~' && *s != '^') s++;
+
+        if (!*s)
+            break;
+
+        if (pos + 2 > size)
+            return 0;
+
+        if (*s == '~' || *s == '^') {
+            key[pos++] = *s == '~' ? 1 : 3;
+            s++;
+        } else if (c_isdigit(*s)) {
+            while (*s == '0') s++;
+            for (segment = s; c_isdigit(*s); s++);
+            len = s - segment;
+
+            if (len > UCHAR_MAX || pos + 2 + len > size)
+                return 0;
+            key[pos++] = 5;
+            key[pos++] = len;
+            memcpy(key + pos, segment, len);
+            pos += len;
+        } else {
+            for (segment = s; c_isalpha(*s); s++);
+            len = s - segment;
+
+            if (pos + 2 + len > size)
+                return 0;
+            key[pos++] = 4;
+            memcpy(key + pos, segment, len);
+            pos += len;
+            key[pos++] = 0;
+        }
+    }
+
+    if (pos + 1 > size)
+        return 0;
+    key[pos++] = 2;
+
+    return pos;
+}
+
+/**
+ * Builds a key of a version whose byte order (memcmp) is the order of the
+ * comparator of its type, so it can be compared many times without parsing
+ * the version again.
+ *
+ * @param v The version.
+ * @param vertype The package type of the version.
+ * @param key Buffer for the key.
+ * @param size Size of the buffer.
+ *
+ * @return The size of the key, 0 if the version has no key: NVD versions,
+ * versions without epoch or versions too long for the buffer.
+ */
+size_t pkg_version_key(const struct pkg_version *v, version_type vertype, unsigned char *key, size_t size)
+{
+    size_t (*builder) (const char *, unsigned char *, size_t);
+    size_t pos;
+    size_t len;
+
+    switch (vertype)
+    {
+    case VER_TYPE_DEB:
+        builder = deb_verkey; break;
+    case VER_TYPE_RPM:
+    case VER_TYPE_RPM_CENTOS:
+    case VER_TYPE_RPM_ALAS:
+        builder = rpm_verkey; break;
+    default:
+        return 0;
+    }
+
+    if (v->epoch < 0 || size < 4)
+        return 0;
+
+    key[0] = (unsigned int)v->epoch >> 24;
+    key[1] = (unsigned int)v->epoch >> 16;
+    key[2] = (unsigned int)v->epoch >> 8;
+    key[3] = (unsigned int)v->epoch;
+    pos = 4;
+
+    if (len = builder(v->version, key + pos, size - pos), !len)
+        return 0;
+    pos += len;
+
+    if (len = builder(v->revision, key + pos, size - pos), !len)
+        return 0;
+
+    return pos + len;
+}
+
+/*
+* Get the key of the left version from the cache, building it if the version
+* is not the last one.
+* return the size of the key, 0 if the version has no key.
+*/
+static size_t pkg_version_cached_key(const struct pkg_version *v, version_type vertype)
+{
+    if (key_cache.version && key_cache.vertype == vertype && key_cache.epoch == v->epoch &&
+        v->version && !strcmp(key_cache.version, v->version) &&
+        v->revision && !strcmp(key_cache.revision, v->revision)) {
+        return key_cache.size;
+    }
+
+    os_free(key_cache.version);
+    os_free(key_cache.revision);
+    key_cache.size = 0;
+
+    if (!v->version || !v->revision)
+        return 0;
+
+    key_cache.vertype = vertype;
+    key_cache.epoch = v->epoch;
+    os_strdup(v->version, key_cache.version);
+    os_strdup(v->revision, key_cache.revision);
+    key_cache.size = pkg_version_key(v, vertype, key_cache.key, sizeof(key_cache.key));
+
+    return key_cache.size;
+}
+
 /**
  * Compares two packages versions.
  *
@@ -521,6 +724,9 @@ int pkg_version_compare(const struct pkg_version *a, const struct pkg_version *b
  */
 bool pkg_version_relate(const struct pkg_version *a, enum pkg_relation rel, const struct pkg_version *b, version_type vertype)
 {
+    unsigned char b_key[PKG_VERSION_KEY_SIZE];
+    size_t a_size;
+    size_t b_size;
     int rc;
 
     if (PKG_RELATION_NONE == rel || VER_TYPE_NONE == vertype)
@@ -544,7 +750,15 @@ bool pkg_version_relate(const struct pkg_version *a, enum pkg_relation rel, cons
         return false;
     }
 
-    rc = pkg_version_compare(a, b);
+    // The versions are compared by their keys when both have one
+    if (a_size = pkg_version_cached_key(a, vertype), a_size &&
+        (b_size = pkg_version_key(b, vertype, b_key, sizeof(b_key)), b_size)) {
+        rc = memcmp(key_cache.key, b_key, a_size < b_size ? a_size : b_size);
+        if (!rc)
+            rc = (a_size > b_size) - (a_size < b_size);
+    } else {
+        rc = pkg_version_compare(a, b);
+    }
 
     switch (rel) {
     case PKG_RELATION_EQ:
@@ -72,12 +72,16 @@ struct pkg_version {
     const char *revision;
 };
 
+/** Maximum size of a version key. Longer versions are compared as strings. */
+#define PKG_VERSION_KEY_SIZE 1024
+
 bool c_isbits(int c, enum c_ctype_bit bits);
 bool c_isdigit(int c);
 bool c_isalpha(int c);
 int order(int c);
 int pkg_version_compare(const struct pkg_version *a, const struct pkg_version *b);
 bool pkg_version_relate(const struct pkg_version *a, enum pkg_relation rel, const struct pkg_version *b, version_type vertype);
+size_t pkg_version_key(const struct pkg_version *v, version_type vertype, unsigned char *key, size_t size);
 
 #endif
 #endif
@@ -15,6 +15,7 @@
 #endif
 
 STATIC char *CPE_VER_TAG = "cpe:2.3:";
+STATIC vu_nvd_prefetch nvd_prefetch;
 
 STATIC char * wm_vuldet_decode_cpe_term(char *term);
 STATIC int wm_vuldet_extract_agent_cpes(scan_agent *agent, sqlite3 *db);
@@ -22,6 +23,11 @@ STATIC int wm_vuldet_update_agent_cpes(scan_agent *agent, sqlite3 *db);
 STATIC void wm_vuldet_free_search_terms(vu_search_terms *s_terms);
 STATIC vu_search_terms * wm_vuldet_extract_search_terms(char *vendor, char *product, char *version, char *arch);
 STATIC int wm_vuldet_insert_nvd_metadata(sqlite3 *db, int year, char *size, char *zip_size, char *g_size, char *sha256, char *last_mod, int cve_count, char alternative);
+STATIC int wm_vuldet_get_nvd_timestamp(int year, char **timestamp);
+STATIC int wm_vuldet_download_nvd_year(update_node *update, int year, const char *stored_timestamp, const char *metadata_path, const char *feed_path);
+STATIC void * wm_vuldet_prefetch_nvd_year(void *arg);
+STATIC void wm_vuldet_start_nvd_prefetch(update_node *update, int year);
+STATIC int wm_vuldet_take_nvd_prefetch(int year);
 STATIC int wm_vuldet_parse_nvd_configuration(cJSON *configuration, nvd_vulnerability *data);
 STATIC int wm_vuldet_parse_nvd_configuration_node(cJSON *config, const char *cve, nvd_configuration **data);
 STATIC int wm_vuldet_parse_nvd_impact(cJSON *impact, nvd_vulnerability *data);
@@ -50,6 +56,28 @@ STATIC int wm_vuldet_get_vuln_nvd_cpe(sqlite3 *db,
 STATIC vu_nvd_report *wm_vuldet_check_nvd_vulnerability(sqlite3 *db, scan_agent *agent, wm_vuldet_flags *flags, cpe *agent_cpe, int cve_id, int conf_id, int vulnerable, char *operator, int parent, char *uri_version, char *v_start_inc, char *v_start_exc, char *v_end_inc, char *v_end_exc);
 STATIC int wm_vuldet_process_agent_nvd_vulnerabilities(sqlite3 *db, vu_nvd_report **nvd_report, scan_agent *agent);
 
+/**
+ * @brief Remove the matches, configurations, references and metrics of an NVD CVE.
+ * @param db The CVE database.
+ * @param id ID from table NVD_CVE.
+ * @return 0 on success, -1 otherwise.
+ */
+STATIC int wm_vuldet_remove_nvd_cve_refs(sqlite3 *db, int id);
+
+/**
+ * @brief Remove an NVD CVE and all its related rows.
+ * @param db The CVE database.
+ * @param id ID from table NVD_CVE.
+ * @return 0 on success, -1 otherwise.
+ */
+STATIC int wm_vuldet_remove_nvd_cve(sqlite3 *db, int id);
+
+/**
+ * @brief Free a CVE loaded to compute the differences of an NVD feed.
+ * @param data The nvd_stored_cve node.
+ */
+STATIC void wm_vuldet_free_nvd_stored_cve(void *data);
+
 /**
  * @brief Clean a package's version by removing the epoch and revision (if available).
  * @param version Raw version to be cleaned.
@@ -852,117 +880,192 @@ int wm_vuldet_fetch_nvd_cpe(const long timeout, char *repo) {
     return 0;
 }
 
-int wm_vuldet_fetch_nvd_cve(update_node *update) {
-    int attempt;
-    int retval = VU_INV_FEED;
-    char buffer[OS_MAXSTR + 1];
-    FILE *fp = NULL;
-    FILE *fp_out = NULL;
-    char *found;
+int wm_vuldet_get_nvd_timestamp(int year, char **timestamp) {
     sqlite3_stmt *stmt = NULL;
     sqlite3 *db = NULL;
-    static char *feed_timestamp = "lastModifiedDate:";
-    char *timestamp = NULL;
-    int res_url_request;
 
-    if (update->multi_url) {
-        char tag[10 + 1];
-        char *repo;
+    *timestamp = NULL;
 
-        snprintf(tag, 10, "%d", update->update_it);
-        repo = wstr_replace(update->multi_url, MULTI_URL_TAG, tag);
+    if (sqlite3_open_v2(CVE_DB, &db, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+        sqlite3_close_v2(db);
+        return OS_INVALID;
+    }
 
-        for (attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
-            if (wurl_request_uncompress_bz2_gz(repo, VU_FIT_TEMP_FILE, NULL, NULL, update->timeout, NULL)) {
-                mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, attempt * DOWNLOAD_SLEEP_FACTOR);
-                sleep(attempt * DOWNLOAD_SLEEP_FACTOR);
-                continue;
-            }
-            break;
-        }
+    if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_TIMESTAMP], -1, &stmt, NULL) != SQLITE_OK) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+        wdb_finalize(stmt);
+        sqlite3_close_v2(db);
+        return OS_INVALID;
+    }
+    sqlite3_bind_int(stmt, 1, year);
 
-        if (attempt == NVD_REPO_MAX_ATTEMPTS) {
-            mtwarn(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, NVD_REPO_MAX_ATTEMPTS);
-            free(repo);
-            goto end;
+    if (wm_vuldet_step(stmt) == SQLITE_ROW) {
+        sqlite_strdup((const char *)sqlite3_column_text(stmt, 0), *timestamp);
+    }
+
+    wdb_finalize(stmt);
+    sqlite3_close_v2(db);
+
+    return 0;
+}
+
+/**
+ * @brief Downloads a year of the NVD feed unless the timestamp of its metadata matches the stored one.
+ * @return 0 if the feed was downloaded, VU_NOT_NEED_UPDATE if it didn't change or VU_INV_FEED on error.
+ */
+int wm_vuldet_download_nvd_year(update_node *update, int year, const char *stored_timestamp, const char *metadata_path, const char *feed_path) {
+    static char *feed_timestamp = "lastModifiedDate:";
+    char repo[OS_SIZE_2048 + 1];
+    char buffer[OS_MAXSTR + 1];
+    char str_it[21];
+    FILE *fp = NULL;
+    char *found;
+    int attempt;
+
+    // Check the metadata feed
+    snprintf(repo, OS_SIZE_2048, NVD_CVE_REPO_META, year);
+    for (attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
+        if (wurl_request(repo, metadata_path, NULL, NULL, update->timeout)) {
+            mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, attempt * DOWNLOAD_SLEEP_FACTOR);
+            sleep(attempt * DOWNLOAD_SLEEP_FACTOR);
+            continue;
         }
-        free(repo);
-    } else {
-        char repo[OS_SIZE_2048 + 1];
-        char str_it[21];
+        break;
+    }
+    if (attempt == NVD_REPO_MAX_ATTEMPTS) {
+        mtwarn(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, NVD_REPO_MAX_ATTEMPTS);
+        return VU_INV_FEED;
+    }
 
-        // Check the metadata feed
-        snprintf(repo, OS_SIZE_2048, NVD_CVE_REPO_META, update->update_it);
-        for (attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
-            if (wurl_request(repo, VU_TEMP_FILE, NULL, NULL, update->timeout)) {
-                mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, attempt * DOWNLOAD_SLEEP_FACTOR);
-                sleep(attempt * DOWNLOAD_SLEEP_FACTOR);
-                continue;
+    if (fp = fopen(metadata_path, "r"), !fp) {
+        return VU_INV_FEED;
+    }
+
+    while (fgets(buffer, OS_MAXSTR, fp)) {
+        if (found = strstr(buffer, feed_timestamp), found) {
+            found += strlen(feed_timestamp);
+
+            // Check if our feed is outdated
+            if (stored_timestamp && !strncmp(found, stored_timestamp, strlen(stored_timestamp))) {
+                w_fclose(fp);
+                if (remove(metadata_path) < 0 && errno != ENOENT) {
+                    mtdebug2(WM_VULNDETECTOR_LOGTAG, "remove(%s): %s", metadata_path, strerror(errno));
+                }
+                return VU_NOT_NEED_UPDATE;
             }
+            snprintf(str_it, 20, " (%d)", year);
+            mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_DB_TIMESTAMP_FEED, update->dist_ext, str_it);
             break;
         }
-        if (attempt == NVD_REPO_MAX_ATTEMPTS) {
-            mtwarn(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, NVD_REPO_MAX_ATTEMPTS);
-            goto end;
-        }
+    }
 
-        if (fp = fopen(VU_TEMP_FILE, "r"), !fp) {
-            goto end;
-        }
+    w_fclose(fp);
 
-        if (sqlite3_open_v2(CVE_DB, &db, SQLITE_OPEN_READWRITE, NULL)) {
-            mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
-            retval = VU_INV_FEED;
-            goto end;
+    // At this point we know that we must update the feed for this year
+    snprintf(repo, OS_SIZE_2048, NVD_CVE_REPO, year);
+    for (attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
+        if (wurl_request_uncompress_bz2_gz(repo, feed_path, NULL, NULL, update->timeout, NULL)) {
+            mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, attempt * DOWNLOAD_SLEEP_FACTOR);
+            sleep(attempt * DOWNLOAD_SLEEP_FACTOR);
+            continue;
         }
+        break;
+    }
 
-        while (fgets(buffer, OS_MAXSTR, fp)) {
-            if (found = strstr(buffer, feed_timestamp), found) {
-                timestamp = found + strlen(feed_timestamp);
+    if (attempt == NVD_REPO_MAX_ATTEMPTS) {
+        mtwarn(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, NVD_REPO_MAX_ATTEMPTS);
+        return VU_INV_FEED;
+    }
 
-                if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_TIMESTAMP], -1, &stmt, NULL) != SQLITE_OK) {
-                    mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
-                    wdb_finalize(stmt);
-                    retval = VU_INV_FEED;
-                    goto end;
-                }
-                sqlite3_bind_int(stmt, 1, update->update_it);
+    return 0;
+}
 
-                if (wm_vuldet_step(stmt) == SQLITE_ROW) {
-                    found = (char *)sqlite3_column_text(stmt, 0);
+void * wm_vuldet_prefetch_nvd_year(void *arg) {
+    vu_nvd_prefetch *prefetch = (vu_nvd_prefetch *)arg;
 
-                    // Check if our feed is outdated
-                    if (!strncmp(timestamp, found, strlen(found))) {
-                        wdb_finalize(stmt);
-                        retval = VU_NOT_NEED_UPDATE;
-                        goto end;
-                    }
-                }
-                snprintf(str_it, 20, " (%d)", update->update_it);
-                mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_DB_TIMESTAMP_FEED, update->dist_ext, str_it);
-                wdb_finalize(stmt);
-                break;
+    prefetch->result = wm_vuldet_download_nvd_year(prefetch->update, prefetch->year, prefetch->stored_timestamp,
+                                                   VU_NVD_PREFETCH_METADATA_FILE, VU_NVD_PREFETCH_FILE);
+
+    return NULL;
+}
+
+void wm_vuldet_start_nvd_prefetch(update_node *update, int year) {
+    char *timestamp = NULL;
+
+    // The stored timestamp is read here, the thread never touches the database being indexed
+    if (wm_vuldet_get_nvd_timestamp(year, &timestamp)) {
+        return;
+    }
+
+    nvd_prefetch.update = update;
+    nvd_prefetch.year = year;
+    nvd_prefetch.stored_timestamp = timestamp;
+    nvd_prefetch.result = VU_INV_FEED;
+
+    if (CreateThreadJoinable(&nvd_prefetch.thread, wm_vuldet_prefetch_nvd_year, &nvd_prefetch) < 0) {
+        os_free(nvd_prefetch.stored_timestamp);
+        return;
+    }
+
+    nvd_prefetch.running = true;
+    mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_NVD_PREFETCH, year);
+}
+
+int wm_vuldet_take_nvd_prefetch(int year) {
+    int retval = OS_INVALID;
+
+    if (!nvd_prefetch.running) {
+        return OS_INVALID;
+    }
+
+    pthread_join(nvd_prefetch.thread, NULL);
+    nvd_prefetch.running = false;
+    os_free(nvd_prefetch.stored_timestamp);
+
+    if (nvd_prefetch.year == year) {
+        if (nvd_prefetch.result == VU_NOT_NEED_UPDATE) {
+            retval = VU_NOT_NEED_UPDATE;
+        } else if (nvd_prefetch.result == 0) {
+            if (rename(VU_NVD_PREFETCH_METADATA_FILE, VU_TEMP_METADATA_FILE) < 0) {
+                mtdebug2(WM_VULNDETECTOR_LOGTAG, "rename(%s): %s", VU_NVD_PREFETCH_METADATA_FILE, strerror(errno));
+            } else if (rename(VU_NVD_PREFETCH_FILE, VU_FIT_TEMP_FILE) < 0) {
+                mtdebug2(WM_VULNDETECTOR_LOGTAG, "rename(%s): %s", VU_NVD_PREFETCH_FILE, strerror(errno));
+            } else {
+                mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_NVD_PREFETCH_USED, year);
+                retval = 0;
             }
         }
+    }
 
-        if (fp_out = fopen(VU_TEMP_METADATA_FILE, "w"), !fp_out) {
-            goto end;
-        }
+    // Leftovers of a failed or discarded prefetch
+    if (remove(VU_NVD_PREFETCH_METADATA_FILE) < 0 && errno != ENOENT) {
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, "remove(%s): %s", VU_NVD_PREFETCH_METADATA_FILE, strerror(errno));
+    }
+    if (remove(VU_NVD_PREFETCH_FILE) < 0 && errno != ENOENT) {
+        mtdebug2(WM_VULNDETECTOR_LOGTAG, "remove(%s): %s", VU_NVD_PREFETCH_FILE, strerror(errno));
+    }
 
-        fseek(fp, 0, SEEK_SET);
+    return retval;
+}
 
-        while (fgets(buffer, OS_MAXSTR, fp)) {
-            fwrite(buffer, 1, strlen(buffer), fp_out);
-        }
+void wm_vuldet_stop_nvd_prefetch(void) {
+    wm_vuldet_take_nvd_prefetch(-1);
+}
+
+int wm_vuldet_fetch_nvd_cve(update_node *update) {
+    int attempt;
+    int retval = VU_INV_FEED;
 
-        w_fclose(fp);
-        w_fclose(fp_out);
+    if (update->multi_url) {
+        char tag[10 + 1];
+        char *repo;
+
+        snprintf(tag, 10, "%d", update->update_it);
+        repo = wstr_replace(update->multi_url, MULTI_URL_TAG, tag);
 
-        // At this point we know that we must update the feed for this year
-        snprintf(repo, OS_SIZE_2048, NVD_CVE_REPO, update->update_it);
         for (attempt = 0; attempt < NVD_REPO_MAX_ATTEMPTS; attempt++) {
-            res_url_request = wurl_request_uncompress_bz2_gz(repo, VU_FIT_TEMP_FILE, NULL, NULL, update->timeout, NULL);
-            if (res_url_request) {
+            if (wurl_request_uncompress_bz2_gz(repo, VU_FIT_TEMP_FILE, NULL, NULL, update->timeout, NULL)) {
                 mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, attempt * DOWNLOAD_SLEEP_FACTOR);
                 sleep(attempt * DOWNLOAD_SLEEP_FACTOR);
                 continue;
@@ -972,21 +1075,33 @@ int wm_vuldet_fetch_nvd_cve(update_node *update) {
 
         if (attempt == NVD_REPO_MAX_ATTEMPTS) {
             mtwarn(WM_VULNDETECTOR_LOGTAG, VU_API_REQ_INV, repo, NVD_REPO_MAX_ATTEMPTS);
-            goto end;
+            free(repo);
+            return VU_INV_FEED;
         }
-    }
+        free(repo);
+        retval = 0;
+    } else {
+        time_t n_date = time(NULL);
+        struct tm t_date;
 
-    retval = 0;
-end:
-    if (db) {
-        sqlite3_close_v2(db);
-    }
-    if (fp) {
-        fclose(fp);
-        if (remove(VU_TEMP_FILE) < 0 && errno != ENOENT) {
-            mtdebug2(WM_VULNDETECTOR_LOGTAG, "remove(%s): %s", VU_TEMP_FILE, strerror(errno));
+        // The year may have been downloaded while the previous one was indexed
+        if (retval = wm_vuldet_take_nvd_prefetch(update->update_it), retval == OS_INVALID) {
+            char *timestamp = NULL;
+
+            if (wm_vuldet_get_nvd_timestamp(update->update_it, &timestamp)) {
+                return VU_INV_FEED;
+            }
+            retval = wm_vuldet_download_nvd_year(update, update->update_it, timestamp, VU_TEMP_METADATA_FILE, VU_FIT_TEMP_FILE);
+            os_free(timestamp);
+        }
+
+        // Download the next year while this one is parsed and indexed
+        gmtime_r(&n_date, &t_date);
+        if (retval == 0 && update->update_it < t_date.tm_year + 1900) {
+            wm_vuldet_start_nvd_prefetch(update, update->update_it + 1);
         }
     }
+
     return retval;
 }
 
@@ -1039,7 +1154,7 @@ int wm_vuldet_clean_nvd_metadata(sqlite3 *db, int year) {
     return 0;
 }
 
-int wm_vuldet_json_nvd_parser(char *json_feed, wm_vuldet_db *parsed_vulnerabilities) {
+int wm_vuldet_json_nvd_parser(FILE *fp, wm_vuldet_db *parsed_vulnerabilities) {
     cJSON *cve_content;
     nvd_vulnerability *nvd_it = NULL;
     nvd_vulnerability *nvd_first = NULL;
@@ -1055,46 +1170,95 @@ int wm_vuldet_json_nvd_parser(char *json_feed, wm_vuldet_db *parsed_vulnerabilit
     const char * cve;
     const char * next_cve;
     const char * match_cve = " {\r\n    \"cve\" : {\r\n";
+    const size_t match_len = strlen(match_cve);
+    char *buffer;
+    size_t size = VU_NVD_READ_SIZE;
+    size_t length = 0;
+    bool eof = false;
+
+    // The feed is read in chunks and every CVE is parsed as soon as it is complete,
+    // so only the CVE being read is kept in memory besides the parsed list.
+    os_malloc(size + 1, buffer);
+
+    while (!eof) {
+        const char *pending;
+        size_t read;
+
+        // The buffer is full with part of a single CVE
+        if (length == size) {
+            if (size >= JSON_MAX_FSIZE) {
+                goto error;
+            }
+            size *= 2;
+            os_realloc(buffer, size + 1, buffer);
+        }
 
-    for (cve = strstr(json_feed, match_cve); cve != NULL; cve = strstr(next_cve, match_cve)) {
+        if (read = fread(buffer + length, 1, size - length, fp), !read) {
+            if (ferror(fp)) {
+                goto error;
+            }
+            eof = true;
+        }
+        length += read;
+        buffer[length] = '\0';
+        pending = buffer;
 
-        cJSON * cve_list;
+        for (cve = strstr(buffer, match_cve); cve != NULL; cve = strstr(next_cve, match_cve)) {
 
-        if (cve_list = cJSON_ParseWithOpts(cve, &next_cve, 0), !cve_list) {
-            wm_vuldet_free_nvd_list(nvd_first);
-            return OS_INVALID;
-        }
+            cJSON * cve_list;
 
-        if (nvd_it) {
-            os_calloc(1, sizeof(nvd_vulnerability), nvd_it->next);
-            nvd_it = nvd_it->next;
-        } else {
-            os_calloc(1, sizeof(nvd_vulnerability), nvd_it);
-            nvd_first = nvd_it;
-        }
-        for (cve_content = cve_list->child; json_tagged_obj(cve_content); cve_content = cve_content->next) {
-            if (!strcmp(cve_content->string, JSON_CVE)) {
-                wm_vuldet_parse_nvd_cve(cve_content, nvd_it);
-            } else if (!strcmp(cve_content->string, JSON_CONFIGURATIONS)) {
-                wm_vuldet_parse_nvd_configuration(cve_content, nvd_it);
-            } else if (!strcmp(cve_content->string, JSON_IMPACT)) {
-                wm_vuldet_parse_nvd_impact(cve_content, nvd_it);
-            } else if (!strcmp(cve_content->string, JSON_PUBLISHED)) {
-                w_strdup(cve_content->valuestring, nvd_it->published);
-            } else if (!strcmp(cve_content->string, JSON_LAST_MOD)) {
-                w_strdup(cve_content->valuestring, nvd_it->last_modified);
-            } else if (strcmp(cve_content->string, JSON_DATA_TYPE) &&
-                        strcmp(cve_content->string, JSON_DATA_FORMAT) &&
-                        strcmp(cve_content->string, JSON_DATA_VERSION)) {
-                mtwarn(WM_VULNDETECTOR_LOGTAG, VU_UNKNOWN_NVD_CVE_TAG, cve_content->string);
+            if (cve_list = cJSON_ParseWithOpts(cve, &next_cve, 0), !cve_list) {
+                if (eof) {
+                    goto error;
+                }
+                // The rest of the CVE will come in the next chunk
+                break;
+            }
+
+            if (nvd_it) {
+                os_calloc(1, sizeof(nvd_vulnerability), nvd_it->next);
+                nvd_it = nvd_it->next;
             } else {
-                mtwarn(WM_VULNDETECTOR_LOGTAG, VU_UNKNOWN_NVD_TAG, cve_content->string);
+                os_calloc(1, sizeof(nvd_vulnerability), nvd_it);
+                nvd_first = nvd_it;
             }
+            for (cve_content = cve_list->child; json_tagged_obj(cve_content); cve_content = cve_content->next) {
+                if (!strcmp(cve_content->string, JSON_CVE)) {
+                    wm_vuldet_parse_nvd_cve(cve_content, nvd_it);
+                } else if (!strcmp(cve_content->string, JSON_CONFIGURATIONS)) {
+                    wm_vuldet_parse_nvd_configuration(cve_content, nvd_it);
+                } else if (!strcmp(cve_content->string, JSON_IMPACT)) {
+                    wm_vuldet_parse_nvd_impact(cve_content, nvd_it);
+                } else if (!strcmp(cve_content->string, JSON_PUBLISHED)) {
+                    w_strdup(cve_content->valuestring, nvd_it->published);
+                } else if (!strcmp(cve_content->string, JSON_LAST_MOD)) {
+                    w_strdup(cve_content->valuestring, nvd_it->last_modified);
+                } else if (strcmp(cve_content->string, JSON_DATA_TYPE) &&
+                            strcmp(cve_content->string, JSON_DATA_FORMAT) &&
+                            strcmp(cve_content->string, JSON_DATA_VERSION)) {
+                    mtwarn(WM_VULNDETECTOR_LOGTAG, VU_UNKNOWN_NVD_CVE_TAG, cve_content->string);
+                } else {
+                    mtwarn(WM_VULNDETECTOR_LOGTAG, VU_UNKNOWN_NVD_TAG, cve_content->string);
+                }
+            }
+
+            cJSON_Delete(cve_list);
+            pending = next_cve;
+        }
+
+        if (cve) {
+            pending = cve;
+        } else if ((size_t)(buffer + length - pending) >= match_len) {
+            // Keep the bytes that could be the beginning of the next CVE
+            pending = buffer + length - (match_len - 1);
         }
 
-        cJSON_Delete(cve_list);
+        length -= pending - buffer;
+        memmove(buffer, pending, length);
     }
 
+    os_free(buffer);
+
     if (nvd_it) {
         if (parsed_vulnerabilities->nvd_vulnerabilities) {
             nvd_it->next = parsed_vulnerabilities->nvd_vulnerabilities;
@@ -1103,6 +1267,11 @@ int wm_vuldet_json_nvd_parser(char *json_feed, wm_vuldet_db *parsed_vulnerabilit
     }
 
     return 0;
+
+error:
+    os_free(buffer);
+    wm_vuldet_free_nvd_list(nvd_first);
+    return OS_INVALID;
 }
 
 int wm_vuldet_parse_nvd_cve(cJSON *node, nvd_vulnerability *data) {
@@ -1956,15 +2125,12 @@ int wm_vuldet_get_vuln_nvd_cpe(sqlite3 *db,
                                char *raw_type,
                                vu_nvd_report **nvd_report_list) {
     sqlite3_stmt *stmt = NULL;
-    sqlite3_stmt *stmt2 = NULL;
-    sqlite3_stmt *stmt3 = NULL;
     int result;
-    int result2;
-    int result3;
     int nvd_cpe_id;
+    int prev_nvd_cpe_id = -1;
     int nvd_cve_conf;
     int cve_id;
-    int prev_nvd_cve_conf;
+    int prev_nvd_cve_conf = -1;
     int parent;
     char *uri;
     char *cpe_version;
@@ -1976,7 +2142,9 @@ int wm_vuldet_get_vuln_nvd_cpe(sqlite3 *db,
     char *v_end_exc;
     int retval = OS_INVALID;
 
-    if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_CPE], -1, &stmt, NULL) != SQLITE_OK) {
+    // A single indexed join returns every match of the CPEs that fit the agent CPE
+    // together with its configuration node, sorted by CPE and configuration.
+    if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_CPE_MATCHES], -1, &stmt, NULL) != SQLITE_OK) {
         mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
         wdb_finalize(stmt);
         return OS_INVALID;
@@ -1992,106 +2160,82 @@ int wm_vuldet_get_vuln_nvd_cpe(sqlite3 *db,
     sqlite3_bind_text(stmt, 9, agent_cpe->target_hw ? agent_cpe->target_hw : "", -1, NULL);
 
     while(result = wm_vuldet_step(stmt), result != SQLITE_DONE) {
-        if (result == SQLITE_ROW) {
+        cpe *cpe_node;
+        vu_nvd_report *nvd_report_node;
 
-            nvd_cpe_id = sqlite3_column_int(stmt, 0);
-            cpe_version = (char *) sqlite3_column_text(stmt, 1);
+        if (result != SQLITE_ROW) {
+            goto end;
+        }
 
-            wdb_finalize(stmt2);
+        nvd_cpe_id = sqlite3_column_int(stmt, 0);
+        cpe_version = (char *) sqlite3_column_text(stmt, 1);
+        nvd_cve_conf = sqlite3_column_int(stmt, 2);
 
-            // For a WIN10 O.S product with a valid product version, discard those
-            // CPE's that matched using '-' or '*'.
-            if (agent_cpe->part && (agent_cpe->part[0] == 'o') && cpe_version &&
-                agent_cpe->vendor && strcmp(cpe_version, agent_cpe->version) &&
-                agent->dist_ver == FEED_W10) {
-                continue;
-            }
+        if (nvd_cpe_id != prev_nvd_cpe_id) {
+            prev_nvd_cpe_id = nvd_cpe_id;
+            prev_nvd_cve_conf = -1;
+        }
 
-            if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_MATCHES], -1, &stmt2, NULL) != SQLITE_OK) {
-                goto end;
-            }
-            sqlite3_bind_int(stmt2, 1, nvd_cpe_id);
+        // For a WIN10 O.S product with a valid product version, discard those
+        // CPE's that matched using '-' or '*'.
+        if (agent_cpe->part && (agent_cpe->part[0] == 'o') && cpe_version &&
+            agent_cpe->vendor && strcmp(cpe_version, agent_cpe->version) &&
+            agent->dist_ver == FEED_W10) {
+            continue;
+        }
 
-            prev_nvd_cve_conf = -1;
-            while(result2 = wm_vuldet_step(stmt2), result2 != SQLITE_DONE) {
-                if (result2 == SQLITE_ROW) {
-                    nvd_cve_conf = sqlite3_column_int(stmt2, 0);
-                    // Skip if we have found a vulnerability for this configuration and program
-                    if (nvd_cve_conf == prev_nvd_cve_conf) {
-                        continue;
-                    }
-                    prev_nvd_cve_conf = -1;
+        // Skip if we have found a vulnerability for this configuration and program
+        if (nvd_cve_conf == prev_nvd_cve_conf) {
+            continue;
+        }
+        prev_nvd_cve_conf = -1;
 
-                    uri = (char *)sqlite3_column_text(stmt2, 1);
-                    vulnerable = sqlite3_column_int(stmt2, 2);
-                    v_start_inc = (char *)sqlite3_column_text(stmt2, 3);
-                    v_start_exc = (char *)sqlite3_column_text(stmt2, 4);
-                    v_end_inc = (char *)sqlite3_column_text(stmt2, 5);
-                    v_end_exc = (char *)sqlite3_column_text(stmt2, 6);
+        uri = (char *)sqlite3_column_text(stmt, 3);
+        vulnerable = sqlite3_column_int(stmt, 4);
 
-                    wdb_finalize(stmt3);
+        // Non-vulnerable matches never produce a report, so their URI is not decoded
+        if (!vulnerable || !uri || !strstr(uri, CPE_VER_TAG)) {
+            continue;
+        }
 
-                    if (wm_vuldet_prepare(db, vu_queries[VU_GET_CONF], -1, &stmt3, NULL) != SQLITE_OK) {
-                        goto end;
-                    }
-                    sqlite3_bind_int(stmt3, 1, nvd_cve_conf);
-
-                    while(result3 = wm_vuldet_step(stmt3), result3 != SQLITE_DONE) {
-                        if (result3 == SQLITE_ROW) {
-                            cpe *cpe_node;
-                            vu_nvd_report *nvd_report_node;
-                            cve_id = sqlite3_column_int(stmt3, 0);
-                            operator = (char *)sqlite3_column_text(stmt3, 1);
-                            parent = sqlite3_column_int(stmt3, 2);
-
-                            if (!strstr(uri, CPE_VER_TAG)) {
-                                continue;
-                            }
+        v_start_inc = (char *)sqlite3_column_text(stmt, 5);
+        v_start_exc = (char *)sqlite3_column_text(stmt, 6);
+        v_end_inc = (char *)sqlite3_column_text(stmt, 7);
+        v_end_exc = (char *)sqlite3_column_text(stmt, 8);
+        cve_id = sqlite3_column_int(stmt, 9);
+        operator = (char *)sqlite3_column_text(stmt, 10);
+        parent = sqlite3_column_int(stmt, 11);
 
-                            cpe_node = wm_vuldet_decode_cpe(uri + strlen(CPE_VER_TAG));
+        cpe_node = wm_vuldet_decode_cpe(uri + strlen(CPE_VER_TAG));
 
-                            if (cpe_node == NULL) {
-                                continue;
-                            }
+        if (cpe_node == NULL) {
+            continue;
+        }
 
-                            nvd_report_node = wm_vuldet_check_nvd_vulnerability(db, agent, flags, agent_cpe, cve_id, nvd_cve_conf, vulnerable,
-                                                                                operator, parent, cpe_node->version,
-                                                                                v_start_inc, v_start_exc, v_end_inc, v_end_exc);
-                            if (nvd_report_node) {
-                                if (nvd_report_node->vulnerable) {
-                                    nvd_report_node->id = cve_id;
-                                    if (*nvd_report_list) {
-                                        nvd_report_node->prev = *nvd_report_list;
-                                    }
-                                    *nvd_report_list = nvd_report_node;
-
-                                    if (nvd_report_node->vulnerable) {
-                                        nvd_report_node->id = cve_id;
-                                        os_strdup(raw_product, nvd_report_node->raw_product);
-                                        os_strdup(raw_version, nvd_report_node->raw_version);
-                                        os_strdup(raw_arch, nvd_report_node->raw_arch);
-                                        os_strdup(raw_reference, nvd_report_node->raw_reference);
-                                        os_strdup(raw_type, nvd_report_node->raw_type);
-                                        nvd_report_node->generated_cpe = wm_vuldet_cpe_str(agent_cpe);
-                                    }
-                                    prev_nvd_cve_conf = nvd_cve_conf;
-                                } else {
-                                    wm_vuldet_free_nvd_report(nvd_report_node);
-                                    free(nvd_report_node);
-                                }
-                            }
-                            wm_vuldet_free_cpe(&cpe_node);
-                        } else {
-                            goto end;
-                        }
-                    }
-                } else {
-                    goto end;
+        nvd_report_node = wm_vuldet_check_nvd_vulnerability(db, agent, flags, agent_cpe, cve_id, nvd_cve_conf, vulnerable,
+                                                            operator, parent, cpe_node->version,
+                                                            v_start_inc, v_start_exc, v_end_inc, v_end_exc);
+        if (nvd_report_node) {
+            if (nvd_report_node->vulnerable) {
+                nvd_report_node->id = cve_id;
+                if (*nvd_report_list) {
+                    nvd_report_node->prev = *nvd_report_list;
                 }
+                *nvd_report_list = nvd_report_node;
+
+                os_strdup(raw_product, nvd_report_node->raw_product);
+                os_strdup(raw_version, nvd_report_node->raw_version);
+                os_strdup(raw_arch, nvd_report_node->raw_arch);
+                os_strdup(raw_reference, nvd_report_node->raw_reference);
+                os_strdup(raw_type, nvd_report_node->raw_type);
+                nvd_report_node->generated_cpe = wm_vuldet_cpe_str(agent_cpe);
+                prev_nvd_cve_conf = nvd_cve_conf;
+            } else {
+                wm_vuldet_free_nvd_report(nvd_report_node);
+                free(nvd_report_node);
             }
-        } else {
-            goto end;
         }
+        wm_vuldet_free_cpe(&cpe_node);
     }
 
     retval = 0;
@@ -2101,8 +2245,6 @@ end:
     }
 
     wdb_finalize(stmt);
-    wdb_finalize(stmt2);
-    wdb_finalize(stmt3);
 
     return retval;
 }
@@ -3849,10 +3991,192 @@ int wm_vuldet_has_offline_update(sqlite3 *db) {
     return retval;
 }
 
+int wm_vuldet_remove_nvd_cve_refs(sqlite3 *db, int id) {
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_stmt *stmt2 = NULL;
+    const char *sql;
+    const char *tail;
+
+    // Clean matches
+    if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_CONFIG], -1, &stmt, NULL) != SQLITE_OK) {
+        wdb_finalize(stmt);
+        return OS_INVALID;
+    }
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    while (wm_vuldet_step(stmt) == SQLITE_ROW) {
+        if (wm_vuldet_prepare(db, vu_queries[VU_REMOVE_CVE_MATCHES], -1, &stmt2, NULL) != SQLITE_OK) {
+            wdb_finalize(stmt2);
+            wdb_finalize(stmt);
+            return OS_INVALID;
+        }
+
+        sqlite3_bind_int(stmt2, 1, sqlite3_column_int(stmt, 0));
+
+        if (wm_vuldet_step(stmt2) != SQLITE_DONE) {
+            wdb_finalize(stmt2);
+            wdb_finalize(stmt);
+            return OS_INVALID;
+        }
+        wdb_finalize(stmt2);
+    }
+    wdb_finalize(stmt);
+
+    // Clean configuration, references and metrics
+    for (sql = vu_queries[VU_REMOVE_CVE_TABLE_REFS]; sql && *sql; sql = tail) {
+        if (wm_vuldet_prepare(db, sql, -1, &stmt, &tail) != SQLITE_OK) {
+            wdb_finalize(stmt);
+            return OS_INVALID;
+        }
+        sqlite3_bind_int(stmt, 1, id);
+
+        if (wm_vuldet_step(stmt) != SQLITE_DONE) {
+            wdb_finalize(stmt);
+            return OS_INVALID;
+        }
+        wdb_finalize(stmt);
+    }
+
+    return 0;
+}
+
+int wm_vuldet_remove_nvd_cve(sqlite3 *db, int id) {
+    sqlite3_stmt *stmt = NULL;
+
+    if (wm_vuldet_remove_nvd_cve_refs(db, id)) {
+        return OS_INVALID;
+    }
+
+    if (wm_vuldet_prepare(db, vu_queries[VU_REMOVE_NVD_CVE_ID], -1, &stmt, NULL) != SQLITE_OK) {
+        wdb_finalize(stmt);
+        return OS_INVALID;
+    }
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    if (wm_vuldet_step(stmt) != SQLITE_DONE) {
+        wdb_finalize(stmt);
+        return OS_INVALID;
+    }
+    wdb_finalize(stmt);
+
+    return 0;
+}
+
+void wm_vuldet_free_nvd_stored_cve(void *data) {
+    nvd_stored_cve *node = (nvd_stored_cve *)data;
+
+    if (node) {
+        os_free(node->last_modified);
+        os_free(node);
+    }
+}
+
+int wm_vuldet_index_nvd_delta(sqlite3 *db, int year, nvd_vulnerability *nvd_it, int *cve_count) {
+    sqlite3_stmt *stmt = NULL;
+    OSHash *stored = NULL;
+    OSHashNode *hash_node;
+    unsigned int inode_it = 0;
+    nvd_stored_cve *node;
+    int inserted = 0;
+    int updated = 0;
+    int removed = 0;
+    int unchanged = 0;
+    int retval = OS_INVALID;
+
+    if (stored = OSHash_Create(), !stored) {
+        merror(LIST_ERROR);
+        wm_vuldet_free_nvd_list(nvd_it);
+        return OS_INVALID;
+    }
+
+    OSHash_SetFreeDataPointer(stored, wm_vuldet_free_nvd_stored_cve);
+
+    // Load the CVEs of the year already indexed
+    if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_CVE_MODIFIED], -1, &stmt, NULL) != SQLITE_OK) {
+        goto end;
+    }
+
+    sqlite3_bind_int(stmt, 1, year);
+
+    while (wm_vuldet_step(stmt) == SQLITE_ROW) {
+        const char *cve = (const char *)sqlite3_column_text(stmt, 1);
+        const char *last_modified = (const char *)sqlite3_column_text(stmt, 2);
+
+        os_calloc(1, sizeof(nvd_stored_cve), node);
+        node->id = sqlite3_column_int(stmt, 0);
+        w_strdup(last_modified, node->last_modified);
+
+        // A duplicated entry can't be matched with the feed, so it is removed
+        if (!cve || OSHash_Add(stored, cve, node) != OSHASH_SUCCESS) {
+            if (wm_vuldet_remove_nvd_cve(db, node->id)) {
+                wm_vuldet_free_nvd_stored_cve(node);
+                goto end;
+            }
+            wm_vuldet_free_nvd_stored_cve(node);
+            removed++;
+        }
+    }
+    wdb_finalize(stmt);
+
+    while (nvd_it) {
+        nvd_vulnerability *r_node = nvd_it;
+
+        if (node = nvd_it->id ? OSHash_Delete(stored, nvd_it->id) : NULL, node) {
+            if (node->last_modified && nvd_it->last_modified && !strcmp(node->last_modified, nvd_it->last_modified)) {
+                unchanged++;
+            } else if (wm_vuldet_remove_nvd_cve(db, node->id) || wm_vuldet_insert_nvd_cve(db, nvd_it, year)) {
+                wm_vuldet_free_nvd_stored_cve(node);
+                goto end;
+            } else {
+                updated++;
+            }
+            wm_vuldet_free_nvd_stored_cve(node);
+        } else if (wm_vuldet_insert_nvd_cve(db, nvd_it, year)) {
+            goto end;
+        } else {
+            inserted++;
+        }
+
+        nvd_it = nvd_it->next;
+        wm_vuldet_free_nvd_node(r_node);
+        (*cve_count)++;
+    }
+
+    // Remove the CVEs which are no longer in the feed
+    for (hash_node = OSHash_Begin(stored, &inode_it); hash_node; hash_node = OSHash_Next(stored, &inode_it, hash_node)) {
+        node = (nvd_stored_cve *)hash_node->data;
+
+        if (wm_vuldet_remove_nvd_cve(db, node->id)) {
+            goto end;
+        }
+        removed++;
+    }
+
+    if ((updated || removed) && sqlite3_exec(db, vu_queries[VU_REMOVE_NVD_CPE], NULL, NULL, NULL) != SQLITE_OK) {
+        goto end;
+    }
+
+    mtdebug1(WM_VULNDETECTOR_LOGTAG, VU_NVD_DELTA, year, inserted, updated, removed, unchanged);
+
+    retval = 0;
+end:
+    if (retval) {
+        mterror(WM_VULNDETECTOR_LOGTAG, VU_SQL_ERROR, sqlite3_errmsg(db));
+    }
+    wdb_finalize(stmt);
+    wm_vuldet_free_nvd_list(nvd_it);
+    if (stored) {
+        OSHash_Free(stored);
+    }
+
+    return retval;
+}
+
 int wm_vuldet_clean_nvd_year(sqlite3 *db, int year) {
     char open_db = 0;
     sqlite3_stmt *stmt = NULL;
-    sqlite3_stmt *stmt2 = NULL;
     char year_str[11];
     int result = -1;
 
@@ -3877,48 +4201,9 @@ int wm_vuldet_clean_nvd_year(sqlite3 *db, int year) {
     sqlite3_bind_int(stmt, 1, year);
 
     while (wm_vuldet_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        const char *sql;
-        const char *tail;
-
-        // Clean matches
-        if (wm_vuldet_prepare(db, vu_queries[VU_GET_NVD_CONFIG], -1, &stmt2, NULL) != SQLITE_OK) {
+        if (wm_vuldet_remove_nvd_cve_refs(db, sqlite3_column_int(stmt, 0))) {
             goto end;
         }
-
-        sqlite3_bind_int(stmt2, 1, id);
-
-        while (wm_vuldet_step(stmt2) == SQLITE_ROW) {
-            sqlite3_stmt *stmt3 = NULL;
-            int id_config = sqlite3_column_int(stmt2, 0);
-
-            if (wm_vuldet_prepare(db, vu_queries[VU_REMOVE_CVE_MATCHES], -1, &stmt3, NULL) != SQLITE_OK) {
-                wdb_finalize(stmt3);
-                goto end;
-            }
-
-            sqlite3_bind_int(stmt3, 1, id_config);
-
-            if (wm_vuldet_step(stmt3) != SQLITE_DONE) {
-                wdb_finalize(stmt3);
-                goto end;
-            }
-            wdb_finalize(stmt3);
-        }
-        wdb_finalize(stmt2);
-
-        // Clean configuration, references and metrics
-        for (sql = vu_queries[VU_REMOVE_CVE_TABLE_REFS]; sql && *sql; sql = tail) {
-            if (wm_vuldet_prepare(db, sql, -1, &stmt2, &tail) != SQLITE_OK) {
-                goto end;
-            }
-            sqlite3_bind_int(stmt2, 1, id);
-
-            if (wm_vuldet_step(stmt2) != SQLITE_DONE) {
-                goto end;
-            }
-            wdb_finalize(stmt2);
-        }
     }
     wdb_finalize(stmt);
 
@@ -3944,7 +4229,6 @@ end:
         sqlite3_close_v2(db);
     }
     wdb_finalize(stmt);
-    wdb_finalize(stmt2);
 
     return result;
 }
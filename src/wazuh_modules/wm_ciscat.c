@@ -181,6 +181,7 @@ void* wm_ciscat_main(wm_ciscat *ciscat) {
         }
 
         if (!ciscat->flags.error) {
+            sched_scan_job_begin(&(ciscat->scan_config), WM_CISCAT_LOGTAG, time_sleep > 0);
             mtinfo(WM_CISCAT_LOGTAG, "Starting evaluation.");
 
             // Set unique ID for each scan
@@ -226,6 +227,8 @@ void* wm_ciscat_main(wm_ciscat *ciscat) {
                     }
                 }
             }
+
+            sched_scan_job_end();
         }
 
         mtinfo(WM_CISCAT_LOGTAG, "Evaluation finished.");
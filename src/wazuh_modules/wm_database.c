@@ -84,6 +84,18 @@ static void wm_check_agents();
  */
 static void wm_sync_agents();
 
+// Insert an agent into the database from its key
+static int wm_insert_agent(const keyentry *entry);
+
+// Remove an agent without key from the database, and its artifacts
+static int wm_remove_agent(const char *id);
+
+// Keys of the last successful synchronization, NULL until the database is reconciled
+static keystore *synced_keys;
+
+// Synchronize the groups if the shared directory changed
+static void wm_check_groups();
+
 // Clean dangling database files
 static void wm_clean_dangling_wdb_dbs();
 
@@ -182,7 +194,7 @@ void* wm_database_main(wm_database *data) {
 #ifndef LOCAL
             if (data->sync_agents) {
                 wm_check_agents();
-                wdb_update_groups(SHAREDCFG_DIR, &wdb_wmdb_sock);
+                wm_check_groups();
             }
 #endif
             gettime(&spec1);
@@ -263,9 +275,25 @@ void wm_check_agents() {
     }
 }
 
+void wm_check_groups() {
+    static time_t timestamp = 0;
+    static ino_t inode = 0;
+    struct stat buffer;
+
+    // Adding or removing a group changes the directory, the files inside of the groups don't matter
+    if (stat(SHAREDCFG_DIR, &buffer) < 0) {
+        mterror(WM_DATABASE_LOGTAG, "Couldn't get '%s' stat: %s.", SHAREDCFG_DIR, strerror(errno));
+    } else if (buffer.st_mtime != timestamp || buffer.st_ino != inode) {
+        wdb_update_groups(SHAREDCFG_DIR, &wdb_wmdb_sock);
+        timestamp = buffer.st_mtime;
+        inode = buffer.st_ino;
+    }
+}
+
 // Synchronize agents
 void wm_sync_agents() {
-    keystore keys = KEYSTORE_INITIALIZER;
+    keystore *keys = NULL;
+    int result;
     clock_t clock0 = clock();
     struct timespec spec0;
     struct timespec spec1;
@@ -274,11 +302,26 @@ void wm_sync_agents() {
 
     mtdebug1(WM_DATABASE_LOGTAG, "Synchronizing agents.");
     OS_PassEmptyKeyfile();
-    OS_ReadKeys(&keys, W_RAW_KEY, 0);
+    os_calloc(1, sizeof(keystore), keys);
+    OS_ReadKeys(keys, W_RAW_KEY, 0);
+
+    // Apply the keys added and removed since the last synchronization, or reconcile the whole database
+    if (synced_keys) {
+        result = sync_keys_diff_with_wdb(synced_keys, keys);
+        OS_FreeKeys(synced_keys);
+        os_free(synced_keys);
+    } else {
+        result = sync_keys_with_wdb(keys);
+    }
 
-    sync_keys_with_wdb(&keys);
+    if (result == OS_SUCCESS) {
+        synced_keys = keys;
+    } else {
+        mtdebug1(WM_DATABASE_LOGTAG, "The next synchronization will reconcile the agents with the database.");
+        OS_FreeKeys(keys);
+        os_free(keys);
+    }
 
-    OS_FreeKeys(&keys);
     mtdebug1(WM_DATABASE_LOGTAG, "Agents synchronization completed.");
     gettime(&spec1);
     time_sub(&spec1, &spec0);
@@ -293,32 +336,28 @@ void wm_sync_agents() {
  *        agents.
  *
  * @param keys The keystore structure to be synchronized
+ * @return OS_SUCCESS if every agent was synchronized, OS_INVALID otherwise.
  */
-void sync_keys_with_wdb(keystore *keys) {
+int sync_keys_with_wdb(keystore *keys) {
     rb_tree *agents = NULL;
     char **ids = NULL;
     unsigned int i;
+    int result = OS_SUCCESS;
 
     agents = wdb_get_all_agents_rbtree(FALSE, &wdb_wmdb_sock);
 
     if (agents == NULL) {
         mterror(WM_DATABASE_LOGTAG, "Couldn't synchronize the keystore with the DB.");
-        return;
+        return OS_INVALID;
     }
 
     // Add new agents to the database
     for (i = 0; i < keys->keysize; i++) {
         keyentry *entry = keys->keyentries[i];
-        int agent_id = atoi(entry->id);
-
-        if (agent_id && (rbtree_get(agents, entry->id) == NULL)) {
-            char agent_cidr[IPSIZE + 1];
 
-            mtdebug2(WM_DATABASE_LOGTAG, "Synchronizing agent %s '%s'.", entry->id, entry->name);
-
-            if (wdb_insert_agent(agent_id, entry->name, NULL, OS_CIDRtoStr(entry->ip, agent_cidr, IPSIZE) ?
-                                entry->ip->ip : agent_cidr, entry->raw_key, NULL, 1, &wdb_wmdb_sock)) {
-                mtdebug1(WM_DATABASE_LOGTAG, "Couldn't insert agent '%s' in the database.", entry->id);
+        if (atoi(entry->id) && (rbtree_get(agents, entry->id) == NULL)) {
+            if (wm_insert_agent(entry) < 0) {
+                result = OS_INVALID;
             }
         }
     }
@@ -327,30 +366,96 @@ void sync_keys_with_wdb(keystore *keys) {
 
     // Delete from the database all the agents without a key and all its artifacts
     for (i = 0; ids[i] != NULL; i++) {
-        int agent_id = atoi(ids[i]);
+        if (atoi(ids[i]) && (OS_IsAllowedID(keys, ids[i]) == -1)) {
+            if (wm_remove_agent(ids[i]) < 0) {
+                result = OS_INVALID;
+            }
+        }
+    }
 
-        if (agent_id && (OS_IsAllowedID(keys, ids[i]) == -1)) {
-            char *agent_name = wdb_get_agent_name(agent_id, &wdb_wmdb_sock);
+    free_strarray(ids);
+    rbtree_destroy(agents);
 
-            if (wdb_remove_agent(agent_id, &wdb_wmdb_sock) < 0) {
-                mtdebug1(WM_DATABASE_LOGTAG, "Couldn't remove agent '%s' from the database.", ids[i]);
-                os_free(agent_name);
-                continue;
-            }
+    return result;
+}
+
+/**
+ * @brief Applies to global.db the agents added and removed between two keystores,
+ *        without reading the agent table. The keys kept by both are not checked.
+ *
+ * @param old_keys The keystore of the last synchronization
+ * @param keys The keystore structure to be synchronized
+ * @return OS_SUCCESS if every change was applied, OS_INVALID otherwise.
+ */
+int sync_keys_diff_with_wdb(keystore *old_keys, keystore *keys) {
+    unsigned int i;
+    unsigned int added = 0;
+    unsigned int removed = 0;
+    int result = OS_SUCCESS;
+
+    // Keys not synchronized before
+    for (i = 0; i < keys->keysize; i++) {
+        keyentry *entry = keys->keyentries[i];
 
-            // Agent not found. Removing agent artifacts
-            wm_clean_agent_artifacts(agent_id, agent_name);
+        if (atoi(entry->id) && (OS_IsAllowedID(old_keys, entry->id) == -1)) {
+            if (wm_insert_agent(entry) < 0) {
+                result = OS_INVALID;
+            }
+            added++;
+        }
+    }
 
-            // Remove agent-related files
-            OS_RemoveCounter(ids[i]);
-            OS_RemoveAgentTimestamp(ids[i]);
+    // Keys removed since the last synchronization
+    for (i = 0; i < old_keys->keysize; i++) {
+        keyentry *entry = old_keys->keyentries[i];
 
-            os_free(agent_name);
+        if (atoi(entry->id) && (OS_IsAllowedID(keys, entry->id) == -1)) {
+            if (wm_remove_agent(entry->id) < 0) {
+                result = OS_INVALID;
+            }
+            removed++;
         }
     }
 
-    free_strarray(ids);
-    rbtree_destroy(agents);
+    mtdebug1(WM_DATABASE_LOGTAG, "Agents synchronized: %u added, %u removed.", added, removed);
+
+    return result;
+}
+
+int wm_insert_agent(const keyentry *entry) {
+    char agent_cidr[IPSIZE + 1];
+
+    mtdebug2(WM_DATABASE_LOGTAG, "Synchronizing agent %s '%s'.", entry->id, entry->name);
+
+    if (wdb_insert_agent(atoi(entry->id), entry->name, NULL, OS_CIDRtoStr(entry->ip, agent_cidr, IPSIZE) ?
+                         entry->ip->ip : agent_cidr, entry->raw_key, NULL, 1, &wdb_wmdb_sock)) {
+        mtdebug1(WM_DATABASE_LOGTAG, "Couldn't insert agent '%s' in the database.", entry->id);
+        return OS_INVALID;
+    }
+
+    return OS_SUCCESS;
+}
+
+int wm_remove_agent(const char *id) {
+    int agent_id = atoi(id);
+    char *agent_name = wdb_get_agent_name(agent_id, &wdb_wmdb_sock);
+
+    if (wdb_remove_agent(agent_id, &wdb_wmdb_sock) < 0) {
+        mtdebug1(WM_DATABASE_LOGTAG, "Couldn't remove agent '%s' from the database.", id);
+        os_free(agent_name);
+        return OS_INVALID;
+    }
+
+    // Agent not found. Removing agent artifacts
+    wm_clean_agent_artifacts(agent_id, agent_name);
+
+    // Remove agent-related files
+    OS_RemoveCounter(id);
+    OS_RemoveAgentTimestamp(id);
+
+    os_free(agent_name);
+
+    return OS_SUCCESS;
 }
 
 /**
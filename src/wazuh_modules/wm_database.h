@@ -34,8 +34,19 @@ wmodule* wm_database_read();
  *        agents.
  *
  * @param keys The keystore structure to be synchronized
+ * @return OS_SUCCESS if every agent was synchronized, OS_INVALID otherwise.
  */
-void sync_keys_with_wdb(keystore *keys);
+int sync_keys_with_wdb(keystore *keys);
+
+/**
+ * @brief Applies to global.db the agents added and removed between two keystores,
+ *        without reading the agent table. The keys kept by both are not checked.
+ *
+ * @param old_keys The keystore of the last synchronization
+ * @param keys The keystore structure to be synchronized
+ * @return OS_SUCCESS if every change was applied, OS_INVALID otherwise.
+ */
+int sync_keys_diff_with_wdb(keystore *old_keys, keystore *keys);
 
 /**
  * @brief This function removes the wazuh-db agent DB and the diff folder of an agent.
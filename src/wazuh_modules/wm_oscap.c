@@ -74,12 +74,14 @@ void* wm_oscap_main(wm_oscap *oscap) {
             w_sleep_until(next_scan_time);
         }
 
+        sched_scan_job_begin(&(oscap->scan_config), WM_OSCAP_LOGTAG, time_sleep > 0);
         mtinfo(WM_OSCAP_LOGTAG, "Starting evaluation.");
 
         for (eval = oscap->evals; eval; eval = eval->next)
             if (!eval->flags.error)
                 wm_oscap_run(eval);
 
+        sched_scan_job_end();
         mtinfo(WM_OSCAP_LOGTAG, "Evaluation finished.");
 
     }  while (FOREVER());
@@ -17,6 +17,11 @@
 #include <signal.h>
 #include <stdio.h>
 
+#ifdef INOTIFY_ENABLED
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
+
 #define TMP_CONFIG_PATH "tmp/osquery.conf.tmp"
 
 #ifdef WIN32
@@ -44,6 +49,8 @@ static void *wm_osquery_monitor_main(wm_osquery_monitor_t *osquery_monitor);
 #endif
 static void wm_osquery_monitor_destroy(wm_osquery_monitor_t *osquery_monitor);
 static int wm_osquery_check_logfile(const char * path, FILE * fp);
+static void wm_osquery_wait_logfile(int notify_fd, int notify_wd);
+static int wm_osquery_send_result(const wm_osquery_monitor_t * osquery, const char * payload, struct timespec * window, int * sent);
 static int wm_osquery_packs(wm_osquery_monitor_t *osquery);
 static char * wm_osquery_already_running(char * text);
 cJSON *wm_osquery_dump(const wm_osquery_monitor_t *osquery_monitor);
@@ -72,6 +79,16 @@ void *Read_Log(wm_osquery_monitor_t * osquery)
     cJSON * name;
     cJSON * osquery_json;
     char * begin;
+    struct timespec window = { 0, 0 };
+    int window_sent = 0;
+    int notify_fd = -1;
+    int notify_wd = -1;
+
+#ifdef INOTIFY_ENABLED
+    if (notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC), notify_fd < 0) {
+        mdebug1("Cannot watch results file '%s', polling it instead: %s (%d)", osquery->log_path, strerror(errno), errno);
+    }
+#endif
 
     while (active) {
         // Wait to open log file
@@ -108,6 +125,18 @@ void *Read_Log(wm_osquery_monitor_t * osquery)
             continue;
         }
 
+#ifdef INOTIFY_ENABLED
+        // Follow the file just opened, the previous one may have been rotated
+
+        if (notify_fd >= 0) {
+            if (notify_wd >= 0) {
+                inotify_rm_watch(notify_fd, notify_wd);
+            }
+
+            notify_wd = inotify_add_watch(notify_fd, osquery->log_path, IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+        }
+#endif
+
         // Read the file
 
         while (active) {
@@ -153,7 +182,7 @@ void *Read_Log(wm_osquery_monitor_t * osquery)
                     payload = cJSON_PrintUnformatted(root);
                     mdebug2("Sending... '%s'", payload);
 
-                    if (wm_sendmsg(osquery->msg_delay, osquery->queue_fd, payload, "osquery", LOCALFILE_MQ) < 0) {
+                    if (wm_osquery_send_result(osquery, payload, &window, &window_sent) < 0) {
                         mterror(WM_OSQUERYMONITOR_LOGTAG, QUEUE_ERROR, DEFAULTQUEUE, strerror(errno));
                     }
 
@@ -182,7 +211,7 @@ void *Read_Log(wm_osquery_monitor_t * osquery)
                 goto endloop;
             case 0:
                 // File did not change
-                sleep(1);
+                wm_osquery_wait_logfile(notify_fd, notify_wd);
                 break;
             case 1:
                 minfo("Results file '%s' truncated. Reloading.", osquery->log_path);
@@ -203,9 +232,63 @@ endloop:
         fclose(result_log);
     }
 
+    if (notify_fd >= 0) {
+        close(notify_fd);
+    }
+
     return NULL;
 }
 
+/*
+ * Wait up to a second for the results file to change.
+ * Where inotify is available, the wait ends as soon as osquery writes.
+ */
+void wm_osquery_wait_logfile(int notify_fd, int notify_wd) {
+#ifdef INOTIFY_ENABLED
+    char buffer[OS_SIZE_1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd pfd = { .fd = notify_fd, .events = POLLIN };
+
+    if (notify_fd >= 0 && notify_wd >= 0) {
+        if (poll(&pfd, 1, 1000) > 0) {
+            // Events only wake us up, the data is read by Read_Log()
+            while (read(notify_fd, buffer, sizeof(buffer)) > 0);
+        }
+
+        return;
+    }
+#else
+    (void)notify_fd;
+    (void)notify_wd;
+#endif
+
+    sleep(1);
+}
+
+/*
+ * Send a result to the queue.
+ * Up to wm_max_eps results are sent each second without any delay between them,
+ * so a burst of results is forwarded at once instead of one every msg_delay.
+ */
+int wm_osquery_send_result(const wm_osquery_monitor_t * osquery, const char * payload, struct timespec * window, int * sent) {
+    struct timespec now;
+    double elapsed;
+
+    gettime(&now);
+    elapsed = time_diff(window, &now);
+
+    if (elapsed < 0 || elapsed >= 1) {
+        *window = now;
+        *sent = 0;
+    } else if (*sent >= wm_max_eps) {
+        w_time_delay((unsigned long)((1 - elapsed) * 1000) + 1);
+        gettime(window);
+        *sent = 0;
+    }
+
+    (*sent)++;
+    return SendMSG(osquery->queue_fd, payload, "osquery", LOCALFILE_MQ);
+}
+
 /*
  * Check if file changed.
  * -1: error, file no longer exists.
@@ -86,6 +86,10 @@ static int wm_sca_get_vars(const cJSON * const variables, OSStore * const vars);
 static void wm_sca_set_condition(const char * const c_cond, int *condition);
 static char * wm_sca_get_value(char *buf, int *type);
 static char * wm_sca_get_pattern(char *value);
+static void wm_sca_cache_init(void);
+static void wm_sca_cache_free(void);
+static char **wm_sca_cache_file(const char * const path, FILE *fp);
+static void wm_sca_free_command_output(wm_sca_command_output_t *output);
 static int wm_sca_check_file_contents(const char * const file, const char * const pattern, char **reason);
 static int wm_sca_check_file_list_for_contents(const char * const file_list, char * const pattern, char **reason);
 static int wm_sca_check_file_existence(const char * const file, char **reason);
@@ -134,6 +138,10 @@ static cis_db_hash_info_t *cis_db_for_hash;
 static w_queue_t * request_queue;
 static wm_sca_t * data_win;
 
+/* Files and command outputs read during the current scan */
+static OSHash *file_cache;
+static OSHash *command_cache;
+
 cJSON **last_summary_json = NULL;
 
 /* Multiple readers / one write mutex */
@@ -325,6 +333,8 @@ static int wm_sca_start(wm_sca_t * data) {
             os_free(timestamp);
             w_sleep_until(next_scan_time);
         }
+
+        sched_scan_job_begin(&(data->scan_config), WM_SCA_LOGTAG, time_sleep > 0);
         mtinfo(WM_SCA_LOGTAG,"Starting Security Configuration Assessment scan.");
         time_start = time(NULL);
 
@@ -334,6 +344,7 @@ static int wm_sca_start(wm_sca_t * data) {
         /* Send policies scanned for database purge on manager side */
         wm_sca_send_policies_scanned(data);
 
+        sched_scan_job_end();
         duration = time(NULL) - time_start;
         mtinfo(WM_SCA_LOGTAG, "Security Configuration Assessment scan finished. Duration: %d seconds.", (int)duration);
 
@@ -939,6 +950,7 @@ static int wm_sca_do_scan(cJSON *checks, OSStore *vars, wm_sca_t * data, int id,
     /* Initialize variables */
     memset(buf, '\0', sizeof(buf));
     memset(final_file, '\0', sizeof(final_file));
+    wm_sca_cache_init();
 
     int check_count = 0;
     cJSON *check = NULL;
@@ -1334,6 +1346,7 @@ static int wm_sca_do_scan(cJSON *checks, OSStore *vars, wm_sca_t * data, int id,
 clean_return:
     os_free(reason);
     w_del_plist(p_list);
+    wm_sca_cache_free();
 
     return ret_val;
 }
@@ -1475,6 +1488,80 @@ static int wm_sca_check_file_existence(const char * const file, char **reason)
     return RETURN_INVALID;
 }
 
+static void wm_sca_cache_init(void)
+{
+    if (!file_cache) {
+        file_cache = OSHash_Create();
+        OSHash_SetFreeDataPointer(file_cache, (void (*)(void *))free_strarray);
+    }
+
+    if (!command_cache) {
+        command_cache = OSHash_Create();
+        OSHash_SetFreeDataPointer(command_cache, (void (*)(void *))wm_sca_free_command_output);
+    }
+}
+
+static void wm_sca_cache_free(void)
+{
+    if (file_cache) {
+        OSHash_Free(file_cache);
+        file_cache = NULL;
+    }
+
+    if (command_cache) {
+        OSHash_Free(command_cache);
+        command_cache = NULL;
+    }
+}
+
+/* Read the lines of a file and keep them for the rest of the scan.
+ * Returns NULL, leaving the stream untouched, if the file can't be cached.
+ */
+static char **wm_sca_cache_file(const char * const path, FILE *fp)
+{
+    struct stat statbuf;
+
+    if (!file_cache || fstat(fileno(fp), &statbuf) != 0 || !S_ISREG(statbuf.st_mode)
+        || statbuf.st_size > WM_SCA_CACHE_FILE_MAX_SIZE) {
+        return NULL;
+    }
+
+    char **lines = NULL;
+    size_t count = 0;
+    size_t capacity = 16;
+    char buf[OS_SIZE_2048 + 1];
+
+    os_calloc(capacity, sizeof(char *), lines);
+
+    while (fgets(buf, OS_SIZE_2048, fp) != NULL) {
+        os_trimcrlf(buf);
+
+        if (count + 1 == capacity) {
+            capacity *= 2;
+            os_realloc(lines, capacity * sizeof(char *), lines);
+        }
+
+        os_strdup(buf, lines[count]);
+        lines[++count] = NULL;
+    }
+
+    if (OSHash_Add(file_cache, path, lines) != 2) {
+        free_strarray(lines);
+        rewind(fp);
+        return NULL;
+    }
+
+    return lines;
+}
+
+static void wm_sca_free_command_output(wm_sca_command_output_t *output)
+{
+    if (output) {
+        free_strarray(output->lines);
+        free(output);
+    }
+}
+
 static int wm_sca_check_file_contents(const char * const file, const char * const pattern, char **reason)
 {
     mdebug2("Checking contents of file '%s' against pattern '%s'", file, pattern);
@@ -1496,23 +1583,44 @@ static int wm_sca_check_file_contents(const char * const file, const char * cons
     }
     #endif
 
-    FILE *fp = fopen(realpath_buffer, "r");
-    const int fopen_errno = errno;
-    if (!fp) {
-        if (*reason == NULL) {
-            os_malloc(OS_MAXSTR, *reason);
-            sprintf(*reason, "Could not open file '%s': %s", file, strerror(fopen_errno));
+    int result = RETURN_NOT_FOUND;
+    char **lines = file_cache ? OSHash_Get(file_cache, realpath_buffer) : NULL;
+
+    if (lines) {
+        mdebug2("Using the cached contents of file '%s'", file);
+    } else {
+        FILE *fp = fopen(realpath_buffer, "r");
+        const int fopen_errno = errno;
+        if (!fp) {
+            if (*reason == NULL) {
+                os_malloc(OS_MAXSTR, *reason);
+                sprintf(*reason, "Could not open file '%s': %s", file, strerror(fopen_errno));
+            }
+            mdebug2("Could not open file '%s': %s", file, strerror(fopen_errno));
+            return RETURN_INVALID;
         }
-        mdebug2("Could not open file '%s': %s", file, strerror(fopen_errno));
-        return RETURN_INVALID;
+
+        /* Files that can't be cached are matched while reading them */
+        if (lines = wm_sca_cache_file(realpath_buffer, fp), !lines) {
+            char buf[OS_SIZE_2048 + 1];
+            while (fgets(buf, OS_SIZE_2048, fp) != NULL) {
+                os_trimcrlf(buf);
+                result = wm_sca_pattern_matches(buf, pattern, reason);
+                mdebug2("(%s)(%s) -> %d", pattern, *buf != '\0' ? buf : "EMPTY_LINE" , result);
+
+                if (result) {
+                    mdebug2("Match found. Skipping the rest.");
+                    break;
+                }
+            }
+        }
+
+        fclose(fp);
     }
 
-    int result = RETURN_NOT_FOUND;
-    char buf[OS_SIZE_2048 + 1];
-    while (fgets(buf, OS_SIZE_2048, fp) != NULL) {
-        os_trimcrlf(buf);
-        result = wm_sca_pattern_matches(buf, pattern, reason);
-        mdebug2("(%s)(%s) -> %d", pattern, *buf != '\0' ? buf : "EMPTY_LINE" , result);
+    for (int i = 0; lines && lines[i]; i++) {
+        result = wm_sca_pattern_matches(lines[i], pattern, reason);
+        mdebug2("(%s)(%s) -> %d", pattern, *lines[i] != '\0' ? lines[i] : "EMPTY_LINE" , result);
 
         if (result) {
             mdebug2("Match found. Skipping the rest.");
@@ -1520,7 +1628,6 @@ static int wm_sca_check_file_contents(const char * const file, const char * cons
         }
     }
 
-    fclose(fp);
     mdebug2("Result for (%s)(%s) -> %d", pattern, file, result);
     return result;
 }
@@ -1634,69 +1741,85 @@ static int wm_sca_read_command(char *command, char *pattern, wm_sca_t * data, ch
         return RETURN_FOUND;
     }
 
-    mdebug1("Executing command '%s', and testing output with pattern '%s'", command, pattern);
-    char *cmd_output = NULL;
-    int result_code;
+    wm_sca_command_output_t *output = command_cache ? OSHash_Get(command_cache, command) : NULL;
+    int cached = output != NULL;
+
+    if (cached) {
+        mdebug1("Testing the cached output of command '%s' with pattern '%s'", command, pattern);
+    } else {
+        mdebug1("Executing command '%s', and testing output with pattern '%s'", command, pattern);
+        char *cmd_output = NULL;
+
+        os_calloc(1, sizeof(wm_sca_command_output_t), output);
+        output->status = wm_exec(command, &cmd_output, &output->result_code, data->commands_timeout, NULL);
 
-    switch (wm_exec(command, &cmd_output, &result_code, data->commands_timeout, NULL)) {
+        if (output->status == 0 && cmd_output) {
+            if (output->lines = OS_StrBreak('\n', cmd_output, 256), !output->lines) {
+                mdebug1("Command output could not be processed. Output dump:\n%s", cmd_output);
+            }
+
+            for (int i = 0; output->lines && output->lines[i]; i++) {
+                os_trimcrlf(output->lines[i]);
+            }
+        }
+
+        os_free(cmd_output);
+
+        /* Failed and timed out commands are also kept, so that they are not run again */
+        cached = command_cache && OSHash_Add(command_cache, command, output) == 2;
+    }
+
+    int result = RETURN_NOT_FOUND;
+
+    switch (output->status) {
     case 0:
-        mdebug1("Command '%s' returned code %d", command, result_code);
+        mdebug1("Command '%s' returned code %d", command, output->result_code);
         break;
     case WM_ERROR_TIMEOUT:
-        os_free(cmd_output);
         mdebug1("Timeout overtaken running command '%s'", command);
         if (*reason == NULL) {
             os_malloc(OS_MAXSTR, *reason);
             sprintf(*reason, "Timeout overtaken running command '%s'", command);
         }
-        os_free(cmd_output);
-        return RETURN_INVALID;
+        result = RETURN_INVALID;
+        goto end;
     default:
-        if (result_code == EXECVE_ERROR) {
+        if (output->result_code == EXECVE_ERROR) {
             mdebug1("Invalid path or wrong permissions to run command '%s'", command);
             if (*reason == NULL) {
                 os_malloc(OS_MAXSTR, *reason);
                 sprintf(*reason, "Invalid path or wrong permissions to run command '%s'", command);
             }
         } else {
-            mdebug1("Failed to run command '%s'. Returned code %d", command, result_code);
+            mdebug1("Failed to run command '%s'. Returned code %d", command, output->result_code);
             if (*reason == NULL) {
                 os_malloc(OS_MAXSTR, *reason);
-                sprintf(*reason, "Failed to run command '%s'. Returned code %d", command, result_code);
+                sprintf(*reason, "Failed to run command '%s'. Returned code %d", command, output->result_code);
             }
         }
-        return RETURN_INVALID;
+        result = RETURN_INVALID;
+        goto end;
     }
 
-    if(!cmd_output) {
+    if (!output->lines) {
         mdebug2("Command yielded no output. Returning.");
-        return RETURN_NOT_FOUND;
-    }
-
-    char **output_line;
-    output_line = OS_StrBreak('\n', cmd_output, 256);
-
-    if(!output_line) {
-        mdebug1("Command output could not be processed. Output dump:\n%s", cmd_output);
-        os_free(cmd_output);
-        return RETURN_NOT_FOUND;
+        goto end;
     }
 
-    os_free(cmd_output);
-
-    int i;
-    int result = RETURN_NOT_FOUND;
-    for (i=0; output_line[i] != NULL; i++) {
-        char *buf = output_line[i];
-        os_trimcrlf(buf);
-        result = wm_sca_pattern_matches(buf, pattern, reason);
+    for (int i = 0; output->lines[i] != NULL; i++) {
+        result = wm_sca_pattern_matches(output->lines[i], pattern, reason);
         if (result == RETURN_FOUND){
             break;
         }
     }
 
-    free_strarray(output_line);
     mdebug2("Result for (%s)(%s) -> %d", pattern, command, result);
+
+end:
+    if (!cached) {
+        wm_sca_free_command_output(output);
+    }
+
     return result;
 }
 
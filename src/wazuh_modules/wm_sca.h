@@ -28,6 +28,7 @@
 #define WM_SCA_COND_INV       0x010
 #define WM_SCA_STAMP          "sca"
 #define WM_CONFIGURATION_ASSESSMENT_DB_DUMP                   "sca-dump"
+#define WM_SCA_CACHE_FILE_MAX_SIZE  (1024 * 1024)   // Bigger files are read again by every rule
 
 typedef struct wm_sca_policy_t {
     unsigned int enabled:1;
@@ -58,6 +59,13 @@ typedef struct cis_db_info_t {
     int id;
 } cis_db_info_t;
 
+/* Output of a command run during a scan, shared by every rule that runs it */
+typedef struct wm_sca_command_output_t {
+    int status;         // wm_exec() return value
+    int result_code;
+    char **lines;       // NULL if the command yielded no output
+} wm_sca_command_output_t;
+
 typedef struct cis_db_hash_info_t {
     cis_db_info_t **elem;
 } cis_db_hash_info_t;
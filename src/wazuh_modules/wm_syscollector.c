@@ -50,6 +50,7 @@ syscollector_stop_func syscollector_stop_ptr = NULL;
 syscollector_sync_message_func syscollector_sync_message_ptr = NULL;
 
 long syscollector_sync_max_eps = 10;    // Database syncrhonization number of events per seconds (default value)
+long syscollector_sync_max_bps = 0;     // Syscollector messages bytes per second (0 means no limit)
 int queue_fd = 0;                       // Output queue file descriptor
 
 static bool is_shutdown_process_started() {
@@ -59,7 +60,18 @@ static bool is_shutdown_process_started() {
 
 static void wm_sys_send_message(const void* data, const char queue_id) {
     if (!is_shutdown_process_started()) {
-        const int eps = 1000000/syscollector_sync_max_eps;
+        int eps = 1000000/syscollector_sync_max_eps;
+
+        if (syscollector_sync_max_bps > 0) {
+            // The whole message is counted: "<queue>:<location>:<data>".
+            const long long size = strlen((const char *)data) + strlen(WM_SYS_LOCATION) + 3;
+            const long long bytes_delay = size * 1000000 / syscollector_sync_max_bps;
+
+            if (bytes_delay > eps) {
+                eps = bytes_delay > INT_MAX ? INT_MAX : (int)bytes_delay;
+            }
+        }
+
         if (wm_sendmsg_ex(eps, queue_fd, data, WM_SYS_LOCATION, queue_id, &is_shutdown_process_started) < 0) {
     #ifdef CLIENT
             mterror(WM_SYS_LOGTAG, "Unable to send message to '%s' (wazuh-agentd might be down). Attempting to reconnect.", DEFAULTQUEUE);
@@ -151,6 +163,7 @@ void* wm_sys_main(wm_sys_t *sys) {
             syscollector_sync_max_eps = max_eps;
         }
         // else: if max_eps is 0 (from configuration) let's use the default max_eps value (10)
+        syscollector_sync_max_bps = sys->sync.sync_max_bps;
         wm_sys_log_config(sys);
         syscollector_start_ptr(sys->interval,
                                wm_sys_send_diff_message,
@@ -167,7 +180,8 @@ void* wm_sys_main(wm_sys_t *sys) {
                                sys->flags.portsinfo,
                                sys->flags.allports,
                                sys->flags.procinfo,
-                               sys->flags.hotfixinfo);
+                               sys->flags.hotfixinfo,
+                               sys->changes_interval);
     } else {
         mterror(WM_SYS_LOGTAG, "Can't get syscollector_start_ptr.");
         pthread_exit(NULL);
@@ -219,6 +233,7 @@ cJSON *wm_sys_dump(const wm_sys_t *sys) {
     if (sys->flags.enabled) cJSON_AddStringToObject(wm_sys,"disabled","no"); else cJSON_AddStringToObject(wm_sys,"disabled","yes");
     if (sys->flags.scan_on_start) cJSON_AddStringToObject(wm_sys,"scan-on-start","yes"); else cJSON_AddStringToObject(wm_sys,"scan-on-start","no");
     cJSON_AddNumberToObject(wm_sys,"interval",sys->interval);
+    cJSON_AddNumberToObject(wm_sys,"changes_interval",sys->changes_interval);
     if (sys->flags.netinfo) cJSON_AddStringToObject(wm_sys,"network","yes"); else cJSON_AddStringToObject(wm_sys,"network","no");
     if (sys->flags.osinfo) cJSON_AddStringToObject(wm_sys,"os","yes"); else cJSON_AddStringToObject(wm_sys,"os","no");
     if (sys->flags.hwinfo) cJSON_AddStringToObject(wm_sys,"hardware","yes"); else cJSON_AddStringToObject(wm_sys,"hardware","no");
@@ -231,6 +246,7 @@ cJSON *wm_sys_dump(const wm_sys_t *sys) {
 #endif
     // Database synchronization values
     cJSON_AddNumberToObject(wm_sys,"sync_max_eps",sys->sync.sync_max_eps);
+    cJSON_AddNumberToObject(wm_sys,"sync_max_bps",sys->sync.sync_max_bps);
 
     cJSON_AddItemToObject(root,"syscollector",wm_sys);
 
@@ -19,6 +19,7 @@ extern const wm_context WM_SYS_CONTEXT;     // Context
 
 #define WM_SYS_LOGTAG ARGV0 ":syscollector" // Tag for log messages
 #define WM_SYSCOLLECTOR_DEFAULT_INTERVAL W_HOUR_SECONDS
+#define WM_SYSCOLLECTOR_DEFAULT_CHANGES_INTERVAL W_MINUTE_SECONDS
 
 typedef struct wm_sys_flags_t {
     unsigned int enabled:1;                 // Main switch
@@ -39,10 +40,12 @@ typedef struct wm_sys_state_t {
 
 typedef struct wm_sys_db_sync_flags_t {
     long sync_max_eps;                      // Maximum events per second for synchronization messages.
+    long sync_max_bps;                      // Maximum bytes per second for syscollector messages (0 means no limit).
 } wm_sys_db_sync_flags_t;
 
 typedef struct wm_sys_t {
     unsigned int interval;                  // Time interval between cycles (seconds)
+    unsigned int changes_interval;          // Time interval between checks for package and network changes (seconds, 0 disables them)
     wm_sys_flags_t flags;                   // Flag bitfield
     wm_sys_state_t state;                   // Running state
     wm_sys_db_sync_flags_t sync;            // Database synchronization value
@@ -33,7 +33,9 @@ const char *task_manager_json_keys[] = {
     // Clean tasks request
     [WM_TASK_NOW] = "now",
     [WM_TASK_INTERVAL] = "interval",
-    [WM_TASK_TIMESTAMP] = "timestamp"
+    [WM_TASK_TIMESTAMP] = "timestamp",
+    [WM_TASK_LIMIT] = "limit",
+    [WM_TASK_DELETED] = "deleted"
 };
 
 const char *task_manager_commands_list[] = {
@@ -45,7 +45,9 @@ typedef enum _task_manager_json_key {
     // Clean tasks request
     WM_TASK_NOW,
     WM_TASK_INTERVAL,
-    WM_TASK_TIMESTAMP
+    WM_TASK_TIMESTAMP,
+    WM_TASK_LIMIT,
+    WM_TASK_DELETED
 } task_manager_json_key;
 
 /**
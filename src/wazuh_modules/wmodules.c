@@ -66,6 +66,9 @@ int wm_config() {
     wm_task_nice = getDefine_Int("wazuh_modules", "task_nice", -20, 19);
     wm_max_eps = getDefine_Int("wazuh_modules", "max_eps", 1, 1000);
     wm_kill_timeout = getDefine_Int("wazuh_modules", "kill_timeout", 0, 3600);
+    sched_scan_set_limits(getDefine_Int("wazuh_modules", "max_scheduled_jobs", 0, 64),
+                          getDefine_Int("wazuh_modules", "scheduled_jitter", 0, 3600),
+                          getDefine_Int("wazuh_modules", "scheduled_max_load", 0, 10000));
 
     if(wm_initialize_default_modules(&wmodules) < 0) {
         return OS_INVALID;
@@ -386,7 +389,8 @@ int wm_sendmsg(int usec, int queue, const char *message, const char *locmsg, cha
     int msec = usec / 1000;
     Sleep(msec);
 #else
-    struct timeval timeout = {0, usec};
+    // A delay of a second or more must not go to tv_usec.
+    struct timeval timeout = {usec / 1000000, usec % 1000000};
     select(0, NULL, NULL, NULL, &timeout);
 #endif
 